@@ -0,0 +1,50 @@
+#!/bin/bash
+### Example script to run weak- or strong-scaling benchmarks on cluster with SLURM,
+### using the "benchmark" problem generator (inputs/tests/benchmark.athinput).
+### Each run writes Bench_<mode>_<nranks>.bench with the timing breakdown per rank.
+###
+### MODE=weak keeps NMB_PER_RANK MeshBlocks of MB^3 cells on every rank, so the Mesh
+### grows with the number of ranks (which should then be a power of 2).  MODE=strong
+### keeps a Mesh of NX^3 cells.  Submit with e.g.
+###   sbatch --nodes=8 --export=ALL,MODE=weak run_scaling.sh
+
+#SBATCH --nodes=1                # node count
+#SBATCH --ntasks-per-node=4      # number of tasks per node (e.g. one per GPU)
+#SBATCH --cpus-per-task=1        # cpu-cores per task (>1 if multi-threaded tasks)
+#SBATCH --mem-per-cpu=4G         # memory per cpu-core (4G is default)
+#SBATCH --time=00:30:00          # total run time limit (HH:MM:SS)
+
+module purge
+module load rh/devtoolset/7
+module load openmpi/gcc/3.0.3/64
+
+ATHENA=${ATHENA:-$HOME/athenak/build/src/athena}
+INPUT=${INPUT:-$HOME/athenak/inputs/tests/benchmark.athinput}
+MODE=${MODE:-weak}
+NMB_PER_RANK=${NMB_PER_RANK:-8}
+MB=${MB:-64}
+NX=${NX:-256}
+NCYCLE=${NCYCLE:-100}
+NRANKS=${SLURM_NTASKS:-1}
+
+if [ "$MODE" == "weak" ]; then
+  # split NRANKS*NMB_PER_RANK MeshBlocks over the 3 directions, doubling the smallest
+  nmb=$((NRANKS*NMB_PER_RANK))
+  nb1=1; nb2=1; nb3=1
+  while [ $((nb1*nb2*nb3)) -lt $nmb ]; do
+    if [ $nb3 -lt $nb2 ]; then nb3=$((2*nb3));
+    elif [ $nb2 -lt $nb1 ]; then nb2=$((2*nb2));
+    else nb1=$((2*nb1)); fi
+  done
+  if [ $((nb1*nb2*nb3)) -ne $nmb ]; then
+    echo "NRANKS*NMB_PER_RANK=$nmb must be a power of 2 for weak scaling"
+    exit 1
+  fi
+  nx1=$((nb1*MB)); nx2=$((nb2*MB)); nx3=$((nb3*MB))
+else
+  nx1=$NX; nx2=$NX; nx3=$NX
+fi
+
+srun $ATHENA -i $INPUT job/basename=Bench_${MODE}_${NRANKS} time/nlim=$NCYCLE \
+  mesh/nx1=$nx1 mesh/nx2=$nx2 mesh/nx3=$nx3 \
+  meshblock/nx1=$MB meshblock/nx2=$MB meshblock/nx3=$MB "$@"
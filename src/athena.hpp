@@ -8,12 +8,14 @@
 //! \file athena.hpp
 //  \brief contains Athena++ general purpose types, structures, enums, etc.
 
+#include <algorithm>
 #include <string>
 
 #include <Kokkos_Core.hpp>
 #include <Kokkos_DualView.hpp>
 #include <Kokkos_Macros.hpp>
 #include "config.hpp"
+#include "utils/team_tuner.hpp"
 
 //----------------------------------------------------------------------------------------
 // type alias that allows code to run with either floats or doubles
@@ -90,6 +92,14 @@ using DevExeSpace = Kokkos::DefaultExecutionSpace;
 using DevMemSpace = Kokkos::DefaultExecutionSpace::memory_space;
 using HostMemSpace = Kokkos::HostSpace;
 using ScratchMemSpace = DevExeSpace::scratch_memory_space;
+// page-locked host memory used to stage MPI messages when MPI cannot access device memory
+#if defined(KOKKOS_ENABLE_CUDA)
+using HostPinnedMemSpace = Kokkos::CudaHostPinnedSpace;
+#elif defined(KOKKOS_ENABLE_HIP)
+using HostPinnedMemSpace = Kokkos::HIPHostPinnedSpace;
+#else
+using HostPinnedMemSpace = Kokkos::HostSpace;
+#endif
 using LayoutWrapper = Kokkos::LayoutRight;                // increments last index fastest
 using TeamMember_t = Kokkos::TeamPolicy<>::member_type;   // for Kokkos thread teams
 
@@ -123,6 +133,12 @@ using HostArray4D = Kokkos::View<T ****, LayoutWrapper, HostMemSpace>;
 template <typename T>
 using HostArray5D = Kokkos::View<T *****, LayoutWrapper, HostMemSpace>;
 
+// template declarations for construction of Kokkos::View in pinned host memory
+template <typename T>
+using PinnedArray1D = Kokkos::View<T *, LayoutWrapper, HostPinnedMemSpace>;
+template <typename T>
+using PinnedArray2D = Kokkos::View<T **, LayoutWrapper, HostPinnedMemSpace>;
+
 // template declarations for construction of Kokkos::DualViews
 template <typename T>
 using DualArray1D = Kokkos::DualView<T *, LayoutWrapper, DevMemSpace>;
@@ -336,6 +352,69 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
   });
 }
 
+//------------------------------------------
+// launch kernel over teams, used by all par_for_outer functions below.  With the team
+// tuner enabled, candidate team sizes and vector lengths are timed on the first calls
+// of each labelled kernel, after which the fastest is used.
+template <typename Function>
+inline void par_for_teams(const std::string &name, DevExeSpace exec_space,
+                          size_t scr_size, const int scr_level, const int nteams,
+                          const Function &function) {
+  if (!(team_tuner::enabled)) {
+    Kokkos::TeamPolicy<> policy(exec_space, nteams, Kokkos::AUTO);
+    policy.set_scratch_size(scr_level, Kokkos::PerTeam(scr_size));
+    Kokkos::parallel_for(name, policy, function);
+    return;
+  }
+  TeamTuneData &data = team_tuner::kernels[name];
+  // on first call, construct list of candidates: AUTO, and for each vector length the
+  // recommended, half the recommended, and maximum team size for this kernel
+  if (data.team_size.empty()) {
+    int vmax = std::min(Kokkos::TeamPolicy<>::vector_length_max(), 64);
+    auto cached = team_tuner::cache.find(name);
+    if (cached != team_tuner::cache.end()) {
+      int ts = cached->second[0], vl = cached->second[1];
+      bool valid = (ts == 0 && vl == 0);
+      if (!(valid) && (vl > 0) && (vl <= vmax)) {
+        Kokkos::TeamPolicy<> p(exec_space, nteams, Kokkos::AUTO, vl);
+        p.set_scratch_size(scr_level, Kokkos::PerTeam(scr_size));
+        valid = (ts > 0 && ts <= p.team_size_max(function, Kokkos::ParallelForTag()));
+      }
+      if (valid) {
+        data.AddCandidate(ts, vl);
+        data.choice = 0;
+      }
+    }
+    if (data.choice < 0) {
+      data.AddCandidate(0, 0);
+      for (int vl=1; vl<=vmax; vl*=2) {
+        Kokkos::TeamPolicy<> p(exec_space, nteams, Kokkos::AUTO, vl);
+        p.set_scratch_size(scr_level, Kokkos::PerTeam(scr_size));
+        int tmax = p.team_size_max(function, Kokkos::ParallelForTag());
+        int trec = p.team_size_recommended(function, Kokkos::ParallelForTag());
+        if (trec > 0) {data.AddCandidate(trec, vl);}
+        if (trec > 1) {data.AddCandidate(trec/2, vl);}
+        if (tmax > 0) {data.AddCandidate(tmax, vl);}
+      }
+    }
+  }
+  int c = data.NextCandidate();
+  bool tuning = (data.choice < 0);
+  Kokkos::TeamPolicy<> policy = (data.team_size[c] == 0)?
+      Kokkos::TeamPolicy<>(exec_space, nteams, Kokkos::AUTO) :
+      Kokkos::TeamPolicy<>(exec_space, nteams, data.team_size[c], data.vector_length[c]);
+  policy.set_scratch_size(scr_level, Kokkos::PerTeam(scr_size));
+  if (tuning) {
+    exec_space.fence();
+    Kokkos::Timer timer;
+    Kokkos::parallel_for(name, policy, function);
+    exec_space.fence();
+    data.RecordTime(c, timer.seconds(), team_tuner::ntrial);
+  } else {
+    Kokkos::parallel_for(name, policy, function);
+  }
+}
+
 //------------------------------------------
 // 1D outer parallel loop using Kokkos Teams
 template <typename Function>
@@ -343,8 +422,7 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
                           size_t scr_size, const int scr_level,
                           const int kl, const int ku, const Function &function) {
   const int nk = ku - kl + 1;
-  Kokkos::TeamPolicy<> policy(exec_space, nk, Kokkos::AUTO);
-  Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
+  par_for_teams(name, exec_space, scr_size, scr_level, nk,
   KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int k = tmember.league_rank() + kl;
     function(tmember, k);
@@ -361,8 +439,7 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
   const int nk = ku - kl + 1;
   const int nj = ju - jl + 1;
   const int nkj = nk*nj;
-  Kokkos::TeamPolicy<> policy(exec_space, nkj, Kokkos::AUTO);
-  Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
+  par_for_teams(name, exec_space, scr_size, scr_level, nkj,
   KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int k = tmember.league_rank()/nj + kl;
     const int j = tmember.league_rank()%nj + jl;
@@ -382,8 +459,7 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
   const int nj = ju - jl + 1;
   const int nkj  = nk*nj;
   const int nnkj = nn*nk*nj;
-  Kokkos::TeamPolicy<> policy(exec_space, nnkj, Kokkos::AUTO);
-  Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
+  par_for_teams(name, exec_space, scr_size, scr_level, nnkj,
   KOKKOS_LAMBDA(TeamMember_t tmember) {
     int n = (tmember.league_rank())/nkj;
     int k = (tmember.league_rank() - n*nkj)/nj;
@@ -409,8 +485,7 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
   const int nkj   = nk*nj;
   const int nnkj  = nn*nk*nj;
   const int nmnkj = nm*nn*nk*nj;
-  Kokkos::TeamPolicy<> policy(exec_space, nmnkj, Kokkos::AUTO);
-  Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
+  par_for_teams(name, exec_space, scr_size, scr_level, nmnkj,
   KOKKOS_LAMBDA(TeamMember_t tmember) {
     int m = (tmember.league_rank())/nnkj;
     int n = (tmember.league_rank() - m*nnkj)/nkj;
@@ -472,10 +547,10 @@ typedef array_type<Real,(NREDUCTION_VARIABLES)> GlobalSum;  // simplifies code b
 } // namespace array_sum
 
 namespace Kokkos { //reduction identity must be defined in Kokkos namespace
-template<>
-struct reduction_identity< array_sum::GlobalSum > {
-  KOKKOS_FORCEINLINE_FUNCTION static array_sum::GlobalSum sum() {
-    return array_sum::GlobalSum();
+template<class ScalarType, int N>
+struct reduction_identity< array_sum::array_type<ScalarType,N> > {
+  KOKKOS_FORCEINLINE_FUNCTION static array_sum::array_type<ScalarType,N> sum() {
+    return array_sum::array_type<ScalarType,N>();
   }
 };
 }
@@ -22,6 +22,100 @@ enum class TensorSymm {
   SYM22,    // symmetric in the last 2 pairs of indices
 };
 
+//----------------------------------------------------------------------------------------
+// Tensor degrees of freedom, base case assumes zero
+template<TensorSymm sym, int ndim, int rank>
+constexpr int TensorDOF = -1;
+
+//----------------------------------------------------------------------------------------
+// Rank 2 tensor degrees of freedom
+template<int ndim>
+constexpr int TensorDOF<TensorSymm::NONE, ndim, 2> = ndim*ndim;
+
+template<int ndim>
+constexpr int TensorDOF<TensorSymm::SYM2, ndim, 2> = ndim*(ndim+1)/2;
+
+template<int ndim>
+constexpr int TensorDOF<TensorSymm::ISYM2, ndim, 2> = ndim*(ndim+1)/2;
+
+//----------------------------------------------------------------------------------------
+// Rank 3 tensor degrees of freedom
+template<int ndim>
+constexpr int TensorDOF<TensorSymm::NONE, ndim, 3> = ndim*ndim*ndim;
+
+template<int ndim>
+constexpr int TensorDOF<TensorSymm::SYM2, ndim, 3> = ndim*ndim*(ndim+1)/2;
+
+template<int ndim>
+constexpr int TensorDOF<TensorSymm::ISYM2, ndim, 3> = ndim*ndim*(ndim+1)/2;
+
+//----------------------------------------------------------------------------------------
+// Rank 4 tensor degrees of freedom
+template<int ndim>
+constexpr int TensorDOF<TensorSymm::NONE, ndim, 4> = ndim*ndim*ndim*ndim;
+
+template<int ndim>
+constexpr int TensorDOF<TensorSymm::SYM2, ndim, 4> = ndim*ndim*ndim*(ndim+1)/2;
+
+template<int ndim>
+constexpr int TensorDOF<TensorSymm::ISYM2, ndim, 4> = ndim*ndim*ndim*(ndim+1)/2;
+
+template<int ndim>
+constexpr int TensorDOF<TensorSymm::SYM22, ndim, 4> = ndim*ndim*(ndim+1)*(ndim+1)/4;
+
+//----------------------------------------------------------------------------------------
+//! \fn int SymIndex()
+//! \brief Position of the symmetric index pair (a,b) in packed storage, which is ordered
+//! (0,0),(0,1),...,(0,ndim-1),(1,1),...  It is a constexpr function of the indices, so
+//! the offset is computed at compile time wherever the indices are constants (e.g. in
+//! loops over tensor indices unrolled by the compiler), and no lookup table is needed.
+template<int ndim>
+KOKKOS_INLINE_FUNCTION constexpr
+int SymIndex(int const a, int const b) {
+  return (a <= b) ? a*(2*ndim - a + 1)/2 + b - a : b*(2*ndim - b + 1)/2 + a - b;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int TensorIndex()
+//! \brief Offset of a component of a rank 2, 3 or 4 tensor with symmetry sym in packed
+//! storage of TensorDOF<sym,ndim,rank> components.
+template<TensorSymm sym, int ndim>
+KOKKOS_INLINE_FUNCTION constexpr
+int TensorIndex(int const a, int const b) {
+  if constexpr (sym == TensorSymm::NONE) {
+    return b + ndim*a;
+  } else {
+    return SymIndex<ndim>(a, b);
+  }
+}
+
+template<TensorSymm sym, int ndim>
+KOKKOS_INLINE_FUNCTION constexpr
+int TensorIndex(int const a, int const b, int const c) {
+  if constexpr (sym == TensorSymm::NONE) {
+    return c + ndim*(b + ndim*a);
+  } else if constexpr (sym == TensorSymm::SYM2) {
+    return SymIndex<ndim>(b, c) + TensorDOF<TensorSymm::SYM2, ndim, 2>*a;
+  } else {
+    return c + ndim*SymIndex<ndim>(a, b);
+  }
+}
+
+template<TensorSymm sym, int ndim>
+KOKKOS_INLINE_FUNCTION constexpr
+int TensorIndex(int const a, int const b, int const c, int const d) {
+  if constexpr (sym == TensorSymm::NONE) {
+    return d + ndim*(c + ndim*(b + ndim*a));
+  } else {
+    constexpr int ndof2 = TensorDOF<TensorSymm::SYM2, ndim, 2>;
+    return SymIndex<ndim>(c, d) + ndof2*SymIndex<ndim>(a, b);
+  }
+}
+
+static_assert(TensorIndex<TensorSymm::SYM2, 3>(1, 2) == 4, "bad SYM2 packing");
+static_assert(TensorIndex<TensorSymm::SYM2, 3>(2, 1) == 4, "bad SYM2 packing");
+static_assert(TensorIndex<TensorSymm::SYM22, 3>(2, 2, 0, 1) == 31, "bad SYM22 packing");
+
 
 using sub_DvceArray5D_2D = decltype(Kokkos::subview(
                            std::declval<DvceArray5D<Real>>(),
@@ -109,21 +203,22 @@ class AthenaHostTensor<T, sym, ndim, 1> {
 template<typename T, TensorSymm sym, int ndim>
 class AthenaHostTensor<T, sym, ndim, 2> {
  public:
-  AthenaHostTensor();
-  // the default destructor/copy operators are sufficient
+  // the default constructor/destructor/copy operators are sufficient
+  AthenaHostTensor() = default;
   ~AthenaHostTensor() = default;
   AthenaHostTensor(AthenaHostTensor<T, sym, ndim, 2> const &) = default;
   AthenaHostTensor<T, sym, ndim, 2> & operator=
   (AthenaHostTensor<T, sym, ndim, 2> const &) = default;
 
-  int idxmap(int const a, int const b) const {
-    return idxmap_[a][b];
+  KOKKOS_INLINE_FUNCTION
+  static constexpr int idxmap(int const a, int const b) {
+    return TensorIndex<sym, ndim>(a, b);
   }
   // operators to access the data
   KOKKOS_INLINE_FUNCTION
   decltype(auto) operator() (int const m, int const a, int const b,
                              int const k, int const j, int const i) const {
-    return data_(m,idxmap_[a][b],k,j,i);
+    return data_(m,TensorIndex<sym, ndim>(a, b),k,j,i);
   }
   //KOKKOS_INLINE_FUNCTION
   void InitWithShallowSlice(HostArray5D<Real> src, const int indx1, const int indx2) {
@@ -133,35 +228,8 @@ class AthenaHostTensor<T, sym, ndim, 2> {
 
  private:
   sub_HostArray5D_2D data_;
-  int idxmap_[3][3];
-  int ndof_;
 };
 
-//----------------------------------------------------------------------------------------
-// Implementation details
-// They are all duplicated to account for dim 0
-template<typename T, TensorSymm sym, int ndim>
-AthenaHostTensor<T, sym, ndim, 2>::AthenaHostTensor() {
-  switch(sym) {
-    case TensorSymm::NONE:
-      ndof_ = 0;
-      for(int a = 0; a < ndim; ++a)
-      for(int b = 0; b < ndim; ++b) {
-        idxmap_[a][b] = ndof_++;
-      }
-      break;
-    case TensorSymm::SYM2:
-    case TensorSymm::ISYM2:
-      ndof_ = 0;
-      for(int a = 0; a < ndim; ++a)
-      for(int b = a; b < ndim; ++b) {
-        idxmap_[a][b] = ndof_++;
-        idxmap_[b][a] = idxmap_[a][b];
-      }
-      break;
-  }
-}
-
 
 // this is the abstract base class
 // This now works only for spatially 3D data
@@ -225,21 +293,22 @@ class AthenaTensor<T, sym, ndim, 1> {
 template<typename T, TensorSymm sym, int ndim>
 class AthenaTensor<T, sym, ndim, 2> {
  public:
-  AthenaTensor();
-  // the default destructor/copy operators are sufficient
+  // the default constructor/destructor/copy operators are sufficient
+  AthenaTensor() = default;
   ~AthenaTensor() = default;
   AthenaTensor(AthenaTensor<T, sym, ndim, 2> const &) = default;
   AthenaTensor<T, sym, ndim, 2> & operator=
   (AthenaTensor<T, sym, ndim, 2> const &) = default;
 
-  int idxmap(int const a, int const b) const {
-    return idxmap_[a][b];
+  KOKKOS_INLINE_FUNCTION
+  static constexpr int idxmap(int const a, int const b) {
+    return TensorIndex<sym, ndim>(a, b);
   }
   // operators to access the data
   KOKKOS_INLINE_FUNCTION
   decltype(auto) operator() (int const m, int const a, int const b,
                              int const k, int const j, int const i) const {
-    return data_(m,idxmap_[a][b],k,j,i);
+    return data_(m,TensorIndex<sym, ndim>(a, b),k,j,i);
   }
   //KOKKOS_INLINE_FUNCTION
   void InitWithShallowSlice(DvceArray5D<Real> src, const int indx1, const int indx2) {
@@ -249,35 +318,8 @@ class AthenaTensor<T, sym, ndim, 2> {
 
  private:
   sub_DvceArray5D_2D data_;
-  int idxmap_[3][3];
-  int ndof_;
 };
 
-//----------------------------------------------------------------------------------------
-// Implementation details
-// They are all duplicated to account for dim 0
-template<typename T, TensorSymm sym, int ndim>
-AthenaTensor<T, sym, ndim, 2>::AthenaTensor() {
-  switch(sym) {
-    case TensorSymm::NONE:
-      ndof_ = 0;
-      for(int a = 0; a < ndim; ++a)
-      for(int b = 0; b < ndim; ++b) {
-        idxmap_[a][b] = ndof_++;
-      }
-      break;
-    case TensorSymm::SYM2:
-    case TensorSymm::ISYM2:
-      ndof_ = 0;
-      for(int a = 0; a < ndim; ++a)
-      for(int b = a; b < ndim; ++b) {
-        idxmap_[a][b] = ndof_++;
-        idxmap_[b][a] = idxmap_[a][b];
-      }
-      break;
-  }
-}
-
 
 // Here tensors are defined as static 1D arrays, with compile-time dimension calculated as
 // dim**rank
@@ -317,45 +359,6 @@ class AthenaPointTensor<T, sym, ndim, 1> {
   Real data_[3];
 };
 
-//----------------------------------------------------------------------------------------
-// Tensor degrees of freedom, base case assumes zero
-template<TensorSymm sym, int ndim, int rank>
-constexpr int TensorDOF = -1;
-
-//----------------------------------------------------------------------------------------
-// Rank 2 tensor degrees of freedom
-template<int ndim>
-constexpr int TensorDOF<TensorSymm::NONE, ndim, 2> = ndim*ndim;
-
-template<int ndim>
-constexpr int TensorDOF<TensorSymm::SYM2, ndim, 2> = ndim*(ndim+1)/2;
-
-//----------------------------------------------------------------------------------------
-// Rank 3 tensor degrees of freedom
-template<int ndim>
-constexpr int TensorDOF<TensorSymm::NONE, ndim, 3> = ndim*ndim*ndim;
-
-template<int ndim>
-constexpr int TensorDOF<TensorSymm::SYM2, ndim, 3> = ndim*ndim*(ndim+1)/2;
-
-template<int ndim>
-constexpr int TensorDOF<TensorSymm::ISYM2, ndim, 3> = ndim*ndim*(ndim+1)/2;
-
-//----------------------------------------------------------------------------------------
-// Rank 4 tensor degrees of freedom
-template<int ndim>
-constexpr int TensorDOF<TensorSymm::NONE, ndim, 4> = ndim*ndim*ndim*ndim;
-
-template<int ndim>
-constexpr int TensorDOF<TensorSymm::SYM2, ndim, 4> = ndim*ndim*ndim*(ndim+1)/2;
-
-template<int ndim>
-constexpr int TensorDOF<TensorSymm::ISYM2, ndim, 4> = ndim*ndim*ndim*(ndim+1)/2;
-
-template<int ndim>
-constexpr int TensorDOF<TensorSymm::SYM22, ndim, 4> = ndim*ndim*(ndim+1)*(ndim+1)/4;
-
-
 //----------------------------------------------------------------------------------------
 // rank 2 AthenaPointTensor
 // This is a 0D AthenaPointTensor
@@ -371,29 +374,11 @@ class AthenaPointTensor<T, sym, ndim, 2> {
   (AthenaPointTensor<T, sym, ndim, 2> const &) = default;
   KOKKOS_INLINE_FUNCTION
   Real operator()(int const a, int const b) const {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_[b + ndim*a];
-    } else if (sym == TensorSymm::SYM2) {
-      if (b < a) {
-        return data_[b*(2*ndim - b + 1)/2+a-b];
-      } else {
-        return data_[a*(2*ndim - a + 1)/2+b-a];
-      }
-    }
-    //return data_[idxmap_[a][b]];
+    return data_[TensorIndex<sym, ndim>(a, b)];
   }
   KOKKOS_INLINE_FUNCTION
   Real & operator()(int const a, int const b) {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_[b + ndim*a];
-    } else if (sym == TensorSymm::SYM2) {
-      if (b < a) {
-        return data_[b*(2*ndim - b + 1)/2+a-b];
-      } else {
-        return data_[a*(2*ndim - a + 1)/2+b-a];
-      }
-    }
-    //return data_[idxmap_[a][b]];
+    return data_[TensorIndex<sym, ndim>(a, b)];
   }
   KOKKOS_INLINE_FUNCTION
   void ZeroClear() {
@@ -421,41 +406,11 @@ class AthenaPointTensor<T, sym, ndim, 3> {
   (AthenaPointTensor<T, sym, ndim, 3> const &) = default;
   KOKKOS_INLINE_FUNCTION
   Real operator()(int const a, int const b, int const c) const {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_[c + ndim*(b + ndim*a)];
-    } else if (sym == TensorSymm::SYM2) {
-      constexpr int ndof2_ = TensorDOF<TensorSymm::SYM2, ndim, 2>;
-      if (c < b) {
-        return data_[c*(2*ndim - c + 1)/2 + b - c + ndof2_*a];
-      } else {
-        return data_[b*(2*ndim - b + 1)/2 + c - b + ndof2_*a];
-      }
-    } else if (sym == TensorSymm::ISYM2) {
-      if (b < a) {
-        return data_[c + ndim*(b*(2*ndim - b + 1)/2 + a - b)];
-      } else {
-        return data_[c + ndim*(a*(2*ndim - a + 1)/2 + b - a)];
-      }
-    }
+    return data_[TensorIndex<sym, ndim>(a, b, c)];
   }
   KOKKOS_INLINE_FUNCTION
   Real & operator()(int const a, int const b, int const c) {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_[c + ndim*(b + ndim*a)];
-    } else if (sym == TensorSymm::SYM2) {
-      constexpr int ndof2_ = TensorDOF<TensorSymm::SYM2, ndim, 2>;
-      if (c < b) {
-        return data_[c*(2*ndim - c + 1)/2 + b - c + ndof2_*a];
-      } else {
-        return data_[b*(2*ndim - b + 1)/2 + c - b + ndof2_*a];
-      }
-    } else if (sym == TensorSymm::ISYM2) {
-      if (b < a) {
-        return data_[c + ndim*(b*(2*ndim - b + 1)/2 + a - b)];
-      } else {
-        return data_[c + ndim*(a*(2*ndim - a + 1)/2 + b - a)];
-      }
-    }
+    return data_[TensorIndex<sym, ndim>(a, b, c)];
   }
   KOKKOS_INLINE_FUNCTION
   void ZeroClear() {
@@ -475,16 +430,7 @@ template<typename T, TensorSymm sym, int ndim>
 class AthenaPointTensor<T, sym, ndim, 4> {
  public:
   KOKKOS_INLINE_FUNCTION
-  AthenaPointTensor() {
-    switch(sym) {
-      case TensorSymm::NONE:
-        ndof_ = ndim*ndim*ndim*ndim;
-        break;
-      case TensorSymm::SYM22:
-        ndof_ = (ndim + 1)*ndim/2 * (ndim + 1)*ndim/2;
-        break;
-    }
-  }
+  AthenaPointTensor() = default;
   // the default destructor/copy operators are sufficient
   ~AthenaPointTensor() = default;
   AthenaPointTensor(AthenaPointTensor<T, sym, ndim, 4> const &) = default;
@@ -492,36 +438,12 @@ class AthenaPointTensor<T, sym, ndim, 4> {
   (AthenaPointTensor<T, sym, ndim, 4> const &) = default;
 
   KOKKOS_INLINE_FUNCTION
-  Real operator()(int a, int b, int c, int d) const {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_[ndim * ndim * ndim * a + ndim * ndim * b + ndim * c + d];
-    } else if constexpr (sym == TensorSymm::SYM22) {
-      constexpr int ndof2_ = TensorDOF<TensorSymm::SYM2, ndim, 2>;
-      if (a < b) {
-        Kokkos::kokkos_swap(a, b);
-      }
-      if (c < d) {
-        Kokkos::kokkos_swap(c, d);
-      }
-      return data_[(b*( 2*ndim - b +1)/2 + a - b)*ndof2_ + d*( 2*ndim - d +1)/2 + c - d];
-    }
+  Real operator()(int const a, int const b, int const c, int const d) const {
+    return data_[TensorIndex<sym, ndim>(a, b, c, d)];
   }
-
-
   KOKKOS_INLINE_FUNCTION
-  Real & operator()(int a, int b, int c, int d) {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_[ndim * ndim * ndim * a + ndim * ndim * b + ndim * c + d];
-    } else if constexpr (sym == TensorSymm::SYM22) {
-      constexpr int ndof2_ = TensorDOF<TensorSymm::SYM2, ndim, 2>;
-      if (a < b) {
-        Kokkos::kokkos_swap(a, b);
-      }
-      if (c < d) {
-        Kokkos::kokkos_swap(c, d);
-      }
-      return data_[(b*( 2*ndim - b +1)/2 + a - b)*ndof2_ + d*( 2*ndim - d +1)/2 + c - d];
-    }
+  Real & operator()(int const a, int const b, int const c, int const d) {
+    return data_[TensorIndex<sym, ndim>(a, b, c, d)];
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -533,7 +455,6 @@ class AthenaPointTensor<T, sym, ndim, 4> {
 
  private:
   Real data_[TensorDOF<sym,ndim,4>];
-  int ndof_;
 };
 
 // Here tensors are defined as static 1D arrays, with compile-time dimension calculated as
@@ -606,38 +527,20 @@ class AthenaScratchTensor<T, sym, ndim, 1> {
 template<typename T, TensorSymm sym, int ndim>
 class AthenaScratchTensor<T, sym, ndim, 2> {
  public:
-  KOKKOS_INLINE_FUNCTION
-  AthenaScratchTensor() {
-    switch(sym) {
-      case TensorSymm::NONE:
-        ndof_ = ndim * ndim;
-        break;
-      case TensorSymm::SYM2:
-      case TensorSymm::ISYM2:
-        ndof_ = (ndim + 1)*ndim/2;
-        break;
-    }
-  }
-  // the default destructor/copy operators are sufficient
+  // the default constructor/destructor/copy operators are sufficient
+  AthenaScratchTensor() = default;
   ~AthenaScratchTensor() = default;
   AthenaScratchTensor(AthenaScratchTensor<T, sym, ndim, 2> const &) = default;
   AthenaScratchTensor<T, sym, ndim, 2> & operator=
   (AthenaScratchTensor<T, sym, ndim, 2> const &) = default;
 
   KOKKOS_INLINE_FUNCTION
-  decltype(auto) operator()(int a, int b, int i) const {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_(ndim * a + b, i);
-    } else {
-      if (a < b) {
-        Kokkos::kokkos_swap(a, b);
-      }
-      return data_(b*( 2*ndim - b +1)/2 + a - b, i);
-    }
+  decltype(auto) operator()(int const a, int const b, int const i) const {
+    return data_(TensorIndex<sym, ndim>(a, b), i);
   }
   KOKKOS_INLINE_FUNCTION
   void NewAthenaScratchTensor(const TeamMember_t & member, int scr_level, int nx) {
-    data_ = ScrArray2D<T>(member.team_scratch(scr_level), ndof_, nx);
+    data_ = ScrArray2D<T>(member.team_scratch(scr_level), TensorDOF<sym, ndim, 2>, nx);
   }
   KOKKOS_INLINE_FUNCTION
   void ZeroClear() {
@@ -646,7 +549,6 @@ class AthenaScratchTensor<T, sym, ndim, 2> {
 
  private:
   ScrArray2D<T> data_;
-  int ndof_;
 };
 
 //----------------------------------------------------------------------------------------
@@ -655,43 +557,20 @@ class AthenaScratchTensor<T, sym, ndim, 2> {
 template<typename T, TensorSymm sym, int ndim>
 class AthenaScratchTensor<T, sym, ndim, 3> {
  public:
-  KOKKOS_INLINE_FUNCTION
-  AthenaScratchTensor() {
-    switch(sym) {
-      case TensorSymm::NONE:
-        ndof_ = ndim * ndim * ndim;
-        break;
-      case TensorSymm::SYM2:
-      case TensorSymm::ISYM2:
-        ndof_ = ndim * (ndim + 1)*ndim/2;
-        break;
-    }
-  }
-  // the default destructor/copy operators are sufficient
+  // the default constructor/destructor/copy operators are sufficient
+  AthenaScratchTensor() = default;
   ~AthenaScratchTensor() = default;
   AthenaScratchTensor(AthenaScratchTensor<T, sym, ndim, 3> const &) = default;
   AthenaScratchTensor<T, sym, ndim, 3> & operator=
   (AthenaScratchTensor<T, sym, ndim, 3> const &) = default;
 
   KOKKOS_INLINE_FUNCTION
-  decltype(auto) operator()(int a, int b, int c, int const i) const {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_(ndim * ndim * a + ndim * b + c, i);
-    } else if constexpr (sym == TensorSymm::SYM2) {
-      if (b < c) {
-        Kokkos::kokkos_swap(b, c);
-      }
-      return data_(a*(ndim + 1)*ndim/2 + c*( 2*ndim - c +1)/2 + b - c,i);
-    } else if constexpr (sym == TensorSymm::ISYM2) {
-      if (a < b) {
-        Kokkos::kokkos_swap(a, b);
-      }
-      return data_((b*(2*ndim - b +1)/2 + a - b)*ndim + c,i);
-    }
+  decltype(auto) operator()(int const a, int const b, int const c, int const i) const {
+    return data_(TensorIndex<sym, ndim>(a, b, c), i);
   }
   KOKKOS_INLINE_FUNCTION
   void NewAthenaScratchTensor(const TeamMember_t & member, int scr_level, int nx) {
-    data_ = ScrArray2D<T>(member.team_scratch(scr_level), ndof_, nx);
+    data_ = ScrArray2D<T>(member.team_scratch(scr_level), TensorDOF<sym, ndim, 3>, nx);
   }
   KOKKOS_INLINE_FUNCTION
   void ZeroClear() {
@@ -700,7 +579,6 @@ class AthenaScratchTensor<T, sym, ndim, 3> {
 
  private:
   ScrArray2D<T> data_;
-  int ndof_;
 };
 
 //----------------------------------------------------------------------------------------
@@ -709,43 +587,21 @@ class AthenaScratchTensor<T, sym, ndim, 3> {
 template<typename T, TensorSymm sym, int ndim>
 class AthenaScratchTensor<T, sym, ndim, 4> {
  public:
-  KOKKOS_INLINE_FUNCTION
-  AthenaScratchTensor() {
-    switch(sym) {
-      case TensorSymm::NONE:
-        ndof_ = ndim*ndim*ndim*ndim;
-        break;
-      case TensorSymm::SYM22:
-        ndof_ = (ndim + 1)*ndim/2 * (ndim + 1)*ndim/2;
-        break;
-    }
-  }
-  // the default destructor/copy operators are sufficient
+  // the default constructor/destructor/copy operators are sufficient
+  AthenaScratchTensor() = default;
   ~AthenaScratchTensor() = default;
   AthenaScratchTensor(AthenaScratchTensor<T, sym, ndim, 4> const &) = default;
   AthenaScratchTensor<T, sym, ndim, 4> & operator=
   (AthenaScratchTensor<T, sym, ndim, 4> const &) = default;
 
   KOKKOS_INLINE_FUNCTION
-  decltype(auto) operator()(int a, int b,
-                            int c, int d, int const i) const {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_(ndim * ndim * ndim * a + ndim * ndim * b + ndim * c + d, i);
-    } else if constexpr (sym == TensorSymm::SYM22) {
-      if (a < b) {
-        Kokkos::kokkos_swap(a, b);
-      }
-      if (c < d) {
-        Kokkos::kokkos_swap(c, d);
-      }
-      return data_((b*( 2*ndim - b +1)/2 + a - b)*(ndim + 1)*ndim/2 +
-                    d*( 2*ndim - d +1)/2 + c - d,i);
-    }
+  decltype(auto) operator()(int const a, int const b,
+                            int const c, int const d, int const i) const {
+    return data_(TensorIndex<sym, ndim>(a, b, c, d), i);
   }
-
   KOKKOS_INLINE_FUNCTION
   void NewAthenaScratchTensor(const TeamMember_t & member, int scr_level, int nx) {
-    data_ = ScrArray2D<T>(member.team_scratch(scr_level), ndof_, nx);
+    data_ = ScrArray2D<T>(member.team_scratch(scr_level), TensorDOF<sym, ndim, 4>, nx);
   }
   KOKKOS_INLINE_FUNCTION
   void ZeroClear() {
@@ -754,7 +610,6 @@ class AthenaScratchTensor<T, sym, ndim, 4> {
 
  private:
   ScrArray2D<T> data_;
-  int ndof_;
 };
 
 #endif // ATHENA_TENSOR_HPP_
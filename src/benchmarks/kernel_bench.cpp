@@ -0,0 +1,655 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file kernel_bench.cpp
+//! \brief Standalone microbenchmark of the inline kernels in reconstruct/*.hpp,
+//! hydro/rsolvers/*.hpp, mhd/rsolvers/*.hpp and eos/ideal_c2p_*.hpp.  Each kernel is run
+//! nrep times over a single synthetic MeshBlock of nx^3 active cells filled with random
+//! primitives, for a list of block sizes, and the throughput (cells updated per second)
+//! of each is written as JSON, so that results can be compared across Kokkos versions,
+//! compilers and hardware.  Built with -D Athena_ENABLE_KERNEL_BENCH=ON.  Usage:
+//!
+//!   kernel_bench [-n nrep] [-s nx,nx,...] [-o file.json]
+//!
+//! The defaults are nrep=10, block sizes 16,32,64, and output to stdout.  Reconstruction
+//! and Riemann solvers are swept in the x1-direction (Riemann solvers use donor-cell
+//! states, so their cost is measured separately from the reconstruction).  The c2p of
+//! the PrimitiveSolver EOS used by dynamical GRMHD is benchmarked by the c2p_bench pgen.
+//! The GR solvers are also timed in a Kerr-Schild background, with the metric computed
+//! at each face (*_ks) or read from the <coord>/metric_cache arrays (*_ks_cached).
+
+#include <Kokkos_Random.hpp>
+
+#include <cstdio>     // fprintf(), fopen()
+#include <cstdlib>    // atoi(), exit()
+#include <iostream>   // cout, endl
+#include <limits>     // numeric_limits
+#include <string>     // string
+#include <vector>     // vector
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/coordinates.hpp"
+#include "eos/eos.hpp"
+#include "eos/ideal_c2p_hyd.hpp"
+#include "eos/ideal_c2p_mhd.hpp"
+#include "reconstruct/dc.hpp"
+#include "reconstruct/plm.hpp"
+#include "reconstruct/ppm.hpp"
+#include "reconstruct/wenoz.hpp"
+#include "hydro/rsolvers/advect_hyd.hpp"
+#include "hydro/rsolvers/llf_hyd.hpp"
+#include "hydro/rsolvers/hlle_hyd.hpp"
+#include "hydro/rsolvers/hllc_hyd.hpp"
+#include "hydro/rsolvers/roe_hyd.hpp"
+#include "hydro/rsolvers/llf_srhyd.hpp"
+#include "hydro/rsolvers/hlle_srhyd.hpp"
+#include "hydro/rsolvers/hllc_srhyd.hpp"
+#include "hydro/rsolvers/llf_grhyd.hpp"
+#include "hydro/rsolvers/hlle_grhyd.hpp"
+#include "mhd/rsolvers/advect_mhd.hpp"
+#include "mhd/rsolvers/llf_mhd.hpp"
+#include "mhd/rsolvers/hlle_mhd.hpp"
+#include "mhd/rsolvers/hlld_mhd.hpp"
+#include "mhd/rsolvers/llf_srmhd.hpp"
+#include "mhd/rsolvers/hlle_srmhd.hpp"
+#include "mhd/rsolvers/llf_grmhd.hpp"
+#include "mhd/rsolvers/hlle_grmhd.hpp"
+
+namespace {
+
+enum class BenchRecon {dc, plm, ppm4, ppmx, wenoz};
+enum class BenchHydRS {advect, llf, hlle, hllc, roe, llf_sr, hlle_sr, hllc_sr, llf_gr,
+                       hlle_gr};
+enum class BenchMHDRS {advect, llf, hlle, hlld, llf_sr, hlle_sr, llf_gr, hlle_gr};
+enum class BenchC2P {hyd, mhd, srhyd, srmhd};
+
+//----------------------------------------------------------------------------------------
+//! \struct BenchBlock
+//! \brief indices, size, EOS and arrays of the single synthetic MeshBlock used by every
+//! kernel.  The flx array is used to store the output of each kernel so that it cannot
+//! be optimized away.
+
+struct BenchBlock {
+  RegionIndcs indcs;
+  DualArray1D<RegionSize> size;
+  CoordData coord;
+  EOS_Data eos;
+  DvceArray5D<Real> w, u, bcc, flx;
+  DvceArray4D<Real> bx, ey, ez;
+};
+
+struct BenchResult {
+  std::string kernel;
+  int nx;
+  Real seconds;
+  Real cells_per_sec;
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn BenchBlock MakeBlock()
+//! \brief allocates a MeshBlock of nx^3 active cells on the unit cube with three ghost
+//! cells, and fills the primitives and magnetic fields (including ghost zones) with
+//! random values.  Densities and internal energies are in [0.5,1.5], velocity components
+//! in [-0.5,0.5]/sqrt(3), and field components in [-0.5,0.5].
+
+BenchBlock MakeBlock(const int nx) {
+  BenchBlock b;
+  int ng = 3;
+  b.indcs.ng = ng;
+  b.indcs.nx1 = nx; b.indcs.nx2 = nx; b.indcs.nx3 = nx;
+  b.indcs.is = ng; b.indcs.ie = ng + nx - 1;
+  b.indcs.js = ng; b.indcs.je = ng + nx - 1;
+  b.indcs.ks = ng; b.indcs.ke = ng + nx - 1;
+  b.indcs.cnx1 = nx/2; b.indcs.cnx2 = nx/2; b.indcs.cnx3 = nx/2;
+  b.indcs.cis = ng; b.indcs.cie = ng + nx/2 - 1;
+  b.indcs.cjs = ng; b.indcs.cje = ng + nx/2 - 1;
+  b.indcs.cks = ng; b.indcs.cke = ng + nx/2 - 1;
+
+  b.size = DualArray1D<RegionSize>("size", 1);
+  auto &s = b.size.h_view(0);
+  s.x1min = 0.0; s.x2min = 0.0; s.x3min = 0.0;
+  s.x1max = 1.0; s.x2max = 1.0; s.x3max = 1.0;
+  s.dx1 = 1.0/nx; s.dx2 = 1.0/nx; s.dx3 = 1.0/nx;
+  b.size.template modify<HostMemSpace>();
+  b.size.template sync<DevExeSpace>();
+
+  // flat space, no excision: the GR solvers then reduce to SR with a lapse of one
+  b.coord.is_minkowski = true;
+  b.coord.bh_spin = 0.0;
+  b.coord.bh_excise = false;
+  b.coord.rexcise = 0.0;
+  b.coord.dexcise = 0.0;
+  b.coord.pexcise = 0.0;
+  b.coord.flux_excise_r = 0.0;
+  b.coord.excision_scheme = ExcisionScheme::fixed;
+  b.coord.excise_lapse = 0.0;
+  b.coord.excise_update_dx = 0.0;
+  b.coord.metric_cache = false;
+
+  b.eos.gamma = 5.0/3.0;
+  b.eos.iso_cs = 1.0;
+  b.eos.is_ideal = true;
+  b.eos.use_e = true;
+  b.eos.use_t = false;
+  b.eos.dfloor = static_cast<Real>(std::numeric_limits<float>::min());
+  b.eos.pfloor = static_cast<Real>(std::numeric_limits<float>::min());
+  b.eos.tfloor = static_cast<Real>(std::numeric_limits<float>::min());
+  b.eos.sfloor = static_cast<Real>(std::numeric_limits<float>::min());
+  b.eos.gamma_max = 20.0;
+
+  int ncells = nx + 2*ng;
+  Kokkos::realloc(b.w, 1, 5, ncells, ncells, ncells);
+  Kokkos::realloc(b.u, 1, 5, ncells, ncells, ncells);
+  Kokkos::realloc(b.bcc, 1, 3, ncells, ncells, ncells);
+  Kokkos::realloc(b.flx, 1, 5, ncells, ncells, ncells);
+  Kokkos::realloc(b.bx, 1, ncells, ncells, ncells+1);
+  Kokkos::realloc(b.ey, 1, ncells, ncells, ncells+1);
+  Kokkos::realloc(b.ez, 1, ncells, ncells, ncells+1);
+
+  auto w = b.w;
+  auto bcc = b.bcc;
+  auto bx = b.bx;
+  Real vfac = 0.5/sqrt(3.0);
+  Kokkos::Random_XorShift64_Pool<> rand_pool64(nx);
+  par_for("kbench_init", DevExeSpace(), 0, 0, 0, (ncells-1), 0, (ncells-1),
+          0, (ncells-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    auto rand_gen = rand_pool64.get_state();  // get random number state this thread
+    w(m,IDN,k,j,i) = 0.5 + rand_gen.frand();
+    w(m,IVX,k,j,i) = vfac*(2.0*rand_gen.frand() - 1.0);
+    w(m,IVY,k,j,i) = vfac*(2.0*rand_gen.frand() - 1.0);
+    w(m,IVZ,k,j,i) = vfac*(2.0*rand_gen.frand() - 1.0);
+    w(m,IEN,k,j,i) = 0.5 + rand_gen.frand();
+    bcc(m,IBX,k,j,i) = rand_gen.frand() - 0.5;
+    bcc(m,IBY,k,j,i) = rand_gen.frand() - 0.5;
+    bcc(m,IBZ,k,j,i) = rand_gen.frand() - 0.5;
+    bx(m,k,j,i) = bcc(m,IBX,k,j,i);
+    if (i == ncells-1) {bx(m,k,j,i+1) = bcc(m,IBX,k,j,i);}
+    rand_pool64.free_state(rand_gen);  // free state for use by other threads
+  });
+  return b;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn BenchBlock MakeKSBlock()
+//! \brief copy of the block b (sharing its arrays) moved to [4,5]^3 about a black hole of
+//! spin 0.9, so the GR solvers evaluate the full Kerr-Schild metric.  With cached, the
+//! metric at cell centers and faces is stored as in Coordinates::UpdateMetricCache().
+
+BenchBlock MakeKSBlock(const BenchBlock &b, const bool cached) {
+  BenchBlock bks = b;
+  bks.size = DualArray1D<RegionSize>("size_ks", 1);
+  auto &s = bks.size.h_view(0);
+  s = b.size.h_view(0);
+  s.x1min += 4.0; s.x2min += 4.0; s.x3min += 4.0;
+  s.x1max += 4.0; s.x2max += 4.0; s.x3max += 4.0;
+  bks.size.template modify<HostMemSpace>();
+  bks.size.template sync<DevExeSpace>();
+
+  bks.coord.is_minkowski = false;
+  bks.coord.bh_spin = 0.9;
+  bks.coord.metric_cache = cached;
+  if (cached) {
+    SetMetricCache(bks.indcs, bks.size, 1, bks.coord);
+  }
+  return bks;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real TimeKernel()
+//! \brief returns wall-clock time for nrep calls to kernel(), after one untimed call to
+//! warm up caches
+
+template <typename Kernel>
+Real TimeKernel(const int nrep, const Kernel &kernel) {
+  kernel();
+  Kokkos::fence();
+  Kokkos::Timer timer;
+  for (int r=0; r<nrep; ++r) {
+    kernel();
+  }
+  Kokkos::fence();
+  return timer.seconds();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ReconSweep()
+//! \brief reconstruction of all primitives in the x1-direction over the active cells.
+//! The sum of the L/R states at each face is stored in flx.
+
+template <BenchRecon method>
+void ReconSweep(const BenchBlock &b) {
+  int is = b.indcs.is, ie = b.indcs.ie;
+  int js = b.indcs.js, je = b.indcs.je;
+  int ks = b.indcs.ks, ke = b.indcs.ke;
+  int ncells1 = b.indcs.nx1 + 2*(b.indcs.ng);
+  int nvar = b.w.extent_int(1);
+  int il = is-1, iu = ie+1;
+  auto w_ = b.w;
+  auto eos_ = b.eos;
+  auto out = b.flx;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvar, ncells1) * 2;
+  int scr_level = 0;
+
+  par_for_outer("kbench_recon", DevExeSpace(), scr_size, scr_level, 0, 0, ks, ke, js, je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> ql(member.team_scratch(scr_level), nvar, ncells1);
+    ScrArray2D<Real> qr(member.team_scratch(scr_level), nvar, ncells1);
+    // Capture variables prior to if constexpr.
+    auto w = w_;
+    auto eos = eos_;
+    if constexpr (method == BenchRecon::dc) {
+      DonorCellX1(member, m, k, j, il, iu, w, ql, qr);
+    } else if constexpr (method == BenchRecon::plm) {
+      PiecewiseLinearX1(member, m, k, j, il, iu, w, ql, qr);
+    } else if constexpr (method == BenchRecon::ppm4) {
+      PiecewiseParabolicX1(member, eos, false, false, m, k, j, il, iu, w, ql, qr);
+    } else if constexpr (method == BenchRecon::ppmx) {
+      PiecewiseParabolicX1(member, eos, true, false, m, k, j, il, iu, w, ql, qr);
+    } else {
+      WENOZX1(member, eos, false, m, k, j, il, iu, w, ql, qr);
+    }
+    member.team_barrier();
+
+    for (int n=0; n<nvar; ++n) {
+      par_for_inner(member, is, ie+1, [&](const int i) {
+        out(m,n,k,j,i) = ql(n,i) + qr(n,i);
+      });
+    }
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HydroFluxSweep()
+//! \brief hydro fluxes in the x1-direction over the active cells, using donor-cell states
+
+template <BenchHydRS rsolver>
+void HydroFluxSweep(const BenchBlock &b) {
+  int is = b.indcs.is, ie = b.indcs.ie;
+  int js = b.indcs.js, je = b.indcs.je;
+  int ks = b.indcs.ks, ke = b.indcs.ke;
+  int ncells1 = b.indcs.nx1 + 2*(b.indcs.ng);
+  int nvar = b.w.extent_int(1);
+  auto indcs_ = b.indcs;
+  auto size_ = b.size;
+  auto coord_ = b.coord;
+  auto eos_ = b.eos;
+  auto w_ = b.w;
+  auto flx_ = b.flx;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvar, ncells1) * 2;
+  int scr_level = 0;
+
+  par_for_outer("kbench_hydflx", DevExeSpace(), scr_size, scr_level, 0, 0, ks, ke, js, je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> wl(member.team_scratch(scr_level), nvar, ncells1);
+    ScrArray2D<Real> wr(member.team_scratch(scr_level), nvar, ncells1);
+    // Capture variables prior to if constexpr.
+    auto indcs = indcs_;
+    auto size = size_;
+    auto coord = coord_;
+    auto eos = eos_;
+    auto w = w_;
+    auto flx = flx_;
+    DonorCellX1(member, m, k, j, is-1, ie+1, w, wl, wr);
+    member.team_barrier();
+
+    int il = is, iu = ie+1;
+    if constexpr (rsolver == BenchHydRS::advect) {
+      hydro::Advect(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,flx);
+    } else if constexpr (rsolver == BenchHydRS::llf) {
+      hydro::LLF(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,flx);
+    } else if constexpr (rsolver == BenchHydRS::hlle) {
+      hydro::HLLE(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,flx);
+    } else if constexpr (rsolver == BenchHydRS::hllc) {
+      hydro::HLLC(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,flx);
+    } else if constexpr (rsolver == BenchHydRS::roe) {
+      hydro::Roe(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,flx);
+    } else if constexpr (rsolver == BenchHydRS::llf_sr) {
+      hydro::LLF_SR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,flx);
+    } else if constexpr (rsolver == BenchHydRS::hlle_sr) {
+      hydro::HLLE_SR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,flx);
+    } else if constexpr (rsolver == BenchHydRS::hllc_sr) {
+      hydro::HLLC_SR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,flx);
+    } else if constexpr (rsolver == BenchHydRS::llf_gr) {
+      hydro::LLF_GR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,flx);
+    } else {
+      hydro::HLLE_GR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,flx);
+    }
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MHDFluxSweep()
+//! \brief MHD fluxes and face-centered EMFs in the x1-direction over the active cells,
+//! using donor-cell states
+
+template <BenchMHDRS rsolver>
+void MHDFluxSweep(const BenchBlock &b) {
+  int is = b.indcs.is, ie = b.indcs.ie;
+  int js = b.indcs.js, je = b.indcs.je;
+  int ks = b.indcs.ks, ke = b.indcs.ke;
+  int ncells1 = b.indcs.nx1 + 2*(b.indcs.ng);
+  int nvar = b.w.extent_int(1);
+  auto indcs_ = b.indcs;
+  auto size_ = b.size;
+  auto coord_ = b.coord;
+  auto eos_ = b.eos;
+  auto w_ = b.w;
+  auto bcc_ = b.bcc;
+  auto bx_ = b.bx;
+  auto flx_ = b.flx;
+  auto ey_ = b.ey;
+  auto ez_ = b.ez;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvar, ncells1) * 2
+                  + ScrArray2D<Real>::shmem_size(3, ncells1) * 2;
+  int scr_level = 0;
+
+  par_for_outer("kbench_mhdflx", DevExeSpace(), scr_size, scr_level, 0, 0, ks, ke, js, je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> wl(member.team_scratch(scr_level), nvar, ncells1);
+    ScrArray2D<Real> wr(member.team_scratch(scr_level), nvar, ncells1);
+    ScrArray2D<Real> bl(member.team_scratch(scr_level), 3, ncells1);
+    ScrArray2D<Real> br(member.team_scratch(scr_level), 3, ncells1);
+    // Capture variables prior to if constexpr.
+    auto indcs = indcs_;
+    auto size = size_;
+    auto coord = coord_;
+    auto eos = eos_;
+    auto w = w_;
+    auto bcc = bcc_;
+    auto bx = bx_;
+    auto flx = flx_;
+    auto ey = ey_;
+    auto ez = ez_;
+    DonorCellX1(member, m, k, j, is-1, ie+1, w, wl, wr);
+    DonorCellX1(member, m, k, j, is-1, ie+1, bcc, bl, br);
+    member.team_barrier();
+
+    int il = is, iu = ie+1;
+    if constexpr (rsolver == BenchMHDRS::advect) {
+      mhd::Advect(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+    } else if constexpr (rsolver == BenchMHDRS::llf) {
+      mhd::LLF(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+    } else if constexpr (rsolver == BenchMHDRS::hlle) {
+      mhd::HLLE(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+    } else if constexpr (rsolver == BenchMHDRS::hlld) {
+      mhd::HLLD(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+    } else if constexpr (rsolver == BenchMHDRS::llf_sr) {
+      mhd::LLF_SR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+    } else if constexpr (rsolver == BenchMHDRS::hlle_sr) {
+      mhd::HLLE_SR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+    } else if constexpr (rsolver == BenchMHDRS::llf_gr) {
+      mhd::LLF_GR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+    } else {
+      mhd::HLLE_GR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+    }
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PrimToCons()
+//! \brief sets the conserved variables in u from the primitives (and cell-centered
+//! fields) for the given c2p, so that every inversion starts from a physical state
+
+template <BenchC2P c2p>
+void PrimToCons(const BenchBlock &b) {
+  int ncells = b.w.extent_int(4);
+  auto w = b.w;
+  auto bcc = b.bcc;
+  auto u = b.u;
+  Real gamma = b.eos.gamma;
+  par_for("kbench_p2c", DevExeSpace(), 0, 0, 0, (ncells-1), 0, (ncells-1), 0, (ncells-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    MHDPrim1D wi;
+    wi.d  = w(m,IDN,k,j,i);
+    wi.vx = w(m,IVX,k,j,i);
+    wi.vy = w(m,IVY,k,j,i);
+    wi.vz = w(m,IVZ,k,j,i);
+    wi.e  = w(m,IEN,k,j,i);
+    wi.bx = bcc(m,IBX,k,j,i);
+    wi.by = bcc(m,IBY,k,j,i);
+    wi.bz = bcc(m,IBZ,k,j,i);
+    HydPrim1D whi;
+    whi.d = wi.d; whi.vx = wi.vx; whi.vy = wi.vy; whi.vz = wi.vz; whi.e = wi.e;
+
+    HydCons1D ui;
+    if constexpr (c2p == BenchC2P::hyd) {
+      SingleP2C_IdealHyd(whi, ui);
+    } else if constexpr (c2p == BenchC2P::mhd) {
+      SingleP2C_IdealMHD(wi, ui);
+    } else if constexpr (c2p == BenchC2P::srhyd) {
+      SingleP2C_IdealSRHyd(whi, gamma, ui);
+    } else {
+      SingleP2C_IdealSRMHD(wi, gamma, ui);
+    }
+    u(m,IDN,k,j,i) = ui.d;
+    u(m,IM1,k,j,i) = ui.mx;
+    u(m,IM2,k,j,i) = ui.my;
+    u(m,IM3,k,j,i) = ui.mz;
+    u(m,IEN,k,j,i) = ui.e;
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ConsToPrimSweep()
+//! \brief conserved-to-primitive inversion over the active cells.  The conserved
+//! variables are not modified, and the primitives are stored in flx.
+
+template <BenchC2P c2p>
+void ConsToPrimSweep(const BenchBlock &b) {
+  int is = b.indcs.is, ie = b.indcs.ie;
+  int js = b.indcs.js, je = b.indcs.je;
+  int ks = b.indcs.ks, ke = b.indcs.ke;
+  auto eos = b.eos;
+  auto u = b.u;
+  auto bcc = b.bcc;
+  auto out = b.flx;
+  par_for("kbench_c2p", DevExeSpace(), 0, 0, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    MHDCons1D ui;
+    ui.d  = u(m,IDN,k,j,i);
+    ui.mx = u(m,IM1,k,j,i);
+    ui.my = u(m,IM2,k,j,i);
+    ui.mz = u(m,IM3,k,j,i);
+    ui.e  = u(m,IEN,k,j,i);
+    ui.bx = bcc(m,IBX,k,j,i);
+    ui.by = bcc(m,IBY,k,j,i);
+    ui.bz = bcc(m,IBZ,k,j,i);
+
+    HydPrim1D wi;
+    bool dfloor_used=false, efloor_used=false, tfloor_used=false, c2p_failure=false;
+    int iter_used=0;
+    if constexpr (c2p == BenchC2P::hyd) {
+      HydCons1D uh;
+      uh.d = ui.d; uh.mx = ui.mx; uh.my = ui.my; uh.mz = ui.mz; uh.e = ui.e;
+      SingleC2P_IdealHyd(uh, eos, wi, dfloor_used, efloor_used, tfloor_used);
+    } else if constexpr (c2p == BenchC2P::mhd) {
+      SingleC2P_IdealMHD(ui, eos, wi, dfloor_used, efloor_used, tfloor_used);
+    } else if constexpr (c2p == BenchC2P::srhyd) {
+      HydCons1D uh;
+      uh.d = ui.d; uh.mx = ui.mx; uh.my = ui.my; uh.mz = ui.mz; uh.e = ui.e;
+      Real s2 = SQR(uh.mx) + SQR(uh.my) + SQR(uh.mz);
+      SingleC2P_IdealSRHyd(uh, eos, s2, wi, dfloor_used, efloor_used, c2p_failure,
+                           iter_used);
+    } else {
+      Real s2 = SQR(ui.mx) + SQR(ui.my) + SQR(ui.mz);
+      Real b2 = SQR(ui.bx) + SQR(ui.by) + SQR(ui.bz);
+      Real rpar = (ui.bx*ui.mx + ui.by*ui.my + ui.bz*ui.mz)/ui.d;
+      SingleC2P_IdealSRMHD(ui, eos, s2, b2, rpar, wi, dfloor_used, efloor_used,
+                           c2p_failure, iter_used);
+    }
+    out(m,IDN,k,j,i) = wi.d;
+    out(m,IVX,k,j,i) = wi.vx;
+    out(m,IVY,k,j,i) = wi.vy;
+    out(m,IVZ,k,j,i) = wi.vz;
+    out(m,IEN,k,j,i) = wi.e;
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RunAll()
+//! \brief times every kernel on a block of nx^3 active cells, and appends the results
+
+void RunAll(const int nx, const int nrep, std::vector<BenchResult> &results) {
+  BenchBlock b = MakeBlock(nx);
+  Real ncells = static_cast<Real>(nrep)*nx*nx*nx;
+  auto add = [&](const char *name, const Real t) {
+    results.push_back({std::string(name), nx, t, ncells/t});
+  };
+
+  add("recon_dc",    TimeKernel(nrep, [&]() {ReconSweep<BenchRecon::dc>(b);}));
+  add("recon_plm",   TimeKernel(nrep, [&]() {ReconSweep<BenchRecon::plm>(b);}));
+  add("recon_ppm4",  TimeKernel(nrep, [&]() {ReconSweep<BenchRecon::ppm4>(b);}));
+  add("recon_ppmx",  TimeKernel(nrep, [&]() {ReconSweep<BenchRecon::ppmx>(b);}));
+  add("recon_wenoz", TimeKernel(nrep, [&]() {ReconSweep<BenchRecon::wenoz>(b);}));
+
+  add("hydro_advect",
+      TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::advect>(b);}));
+  add("hydro_llf",  TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::llf>(b);}));
+  add("hydro_hlle", TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::hlle>(b);}));
+  add("hydro_hllc", TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::hllc>(b);}));
+  add("hydro_roe",  TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::roe>(b);}));
+  add("hydro_llf_sr",
+      TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::llf_sr>(b);}));
+  add("hydro_hlle_sr",
+      TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::hlle_sr>(b);}));
+  add("hydro_hllc_sr",
+      TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::hllc_sr>(b);}));
+  add("hydro_llf_gr",
+      TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::llf_gr>(b);}));
+  add("hydro_hlle_gr",
+      TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::hlle_gr>(b);}));
+
+  add("mhd_advect", TimeKernel(nrep, [&]() {MHDFluxSweep<BenchMHDRS::advect>(b);}));
+  add("mhd_llf",    TimeKernel(nrep, [&]() {MHDFluxSweep<BenchMHDRS::llf>(b);}));
+  add("mhd_hlle",   TimeKernel(nrep, [&]() {MHDFluxSweep<BenchMHDRS::hlle>(b);}));
+  add("mhd_hlld",   TimeKernel(nrep, [&]() {MHDFluxSweep<BenchMHDRS::hlld>(b);}));
+  add("mhd_llf_sr", TimeKernel(nrep, [&]() {MHDFluxSweep<BenchMHDRS::llf_sr>(b);}));
+  add("mhd_hlle_sr",
+      TimeKernel(nrep, [&]() {MHDFluxSweep<BenchMHDRS::hlle_sr>(b);}));
+  add("mhd_llf_gr", TimeKernel(nrep, [&]() {MHDFluxSweep<BenchMHDRS::llf_gr>(b);}));
+  add("mhd_hlle_gr",
+      TimeKernel(nrep, [&]() {MHDFluxSweep<BenchMHDRS::hlle_gr>(b);}));
+
+  // Kerr-Schild metric computed at every face, or read from the metric cache
+  BenchBlock bks = MakeKSBlock(b, false);
+  BenchBlock bks_cached = MakeKSBlock(b, true);
+  add("hydro_hlle_gr_ks",
+      TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::hlle_gr>(bks);}));
+  add("hydro_hlle_gr_ks_cached",
+      TimeKernel(nrep, [&]() {HydroFluxSweep<BenchHydRS::hlle_gr>(bks_cached);}));
+  add("mhd_hlle_gr_ks",
+      TimeKernel(nrep, [&]() {MHDFluxSweep<BenchMHDRS::hlle_gr>(bks);}));
+  add("mhd_hlle_gr_ks_cached",
+      TimeKernel(nrep, [&]() {MHDFluxSweep<BenchMHDRS::hlle_gr>(bks_cached);}));
+
+  PrimToCons<BenchC2P::hyd>(b);
+  add("c2p_ideal_hyd", TimeKernel(nrep, [&]() {ConsToPrimSweep<BenchC2P::hyd>(b);}));
+  PrimToCons<BenchC2P::mhd>(b);
+  add("c2p_ideal_mhd", TimeKernel(nrep, [&]() {ConsToPrimSweep<BenchC2P::mhd>(b);}));
+  PrimToCons<BenchC2P::srhyd>(b);
+  add("c2p_ideal_srhyd",
+      TimeKernel(nrep, [&]() {ConsToPrimSweep<BenchC2P::srhyd>(b);}));
+  PrimToCons<BenchC2P::srmhd>(b);
+  add("c2p_ideal_srmhd",
+      TimeKernel(nrep, [&]() {ConsToPrimSweep<BenchC2P::srmhd>(b);}));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WriteJSON()
+//! \brief writes the configuration and results to fp
+
+void WriteJSON(std::FILE *fp, const int nrep, const std::vector<BenchResult> &results) {
+  std::fprintf(fp, "{\n");
+  std::fprintf(fp, "  \"exe_space\": \"%s\",\n", DevExeSpace::name());
+  std::fprintf(fp, "  \"precision\": \"%s\",\n",
+               (SINGLE_PRECISION_ENABLED)? "single" : "double");
+  std::fprintf(fp, "  \"simd_recon\": %s,\n", (SIMD_RECON_ENABLED)? "true" : "false");
+  std::fprintf(fp, "  \"nrep\": %d,\n", nrep);
+  std::fprintf(fp, "  \"results\": [\n");
+  for (std::size_t n=0; n<results.size(); ++n) {
+    auto &r = results[n];
+    std::fprintf(fp, "    {\"kernel\": \"%s\", \"nx\": %d, \"seconds\": %.6e, "
+                 "\"cells_per_sec\": %.6e}%s\n", r.kernel.c_str(), r.nx, r.seconds,
+                 r.cells_per_sec, (n+1 < results.size())? "," : "");
+  }
+  std::fprintf(fp, "  ]\n}\n");
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn int main()
+//! \brief parses the command line, runs the benchmarks for each block size, and writes
+//! the results
+
+int main(int argc, char *argv[]) {
+  // Kokkos removes the --kokkos-* arguments it recognizes from argv
+  Kokkos::initialize(argc, argv);
+  int nrep = 10;
+  std::vector<int> sizes = {16, 32, 64};
+  std::string outfile;
+  for (int i=1; i<argc; ++i) {
+    std::string arg(argv[i]);
+    if ((arg == "-n" || arg == "-s" || arg == "-o") && (i+1 >= argc)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Option " << arg << " requires an argument" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (arg == "-n") {
+      nrep = std::atoi(argv[++i]);
+    } else if (arg == "-s") {
+      sizes.clear();
+      std::string list(argv[++i]);
+      std::size_t pos = 0;
+      while (pos < list.size()) {
+        std::size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        sizes.push_back(std::atoi(list.substr(pos, end - pos).c_str()));
+        pos = end + 1;
+      }
+    } else if (arg == "-o") {
+      outfile = argv[++i];
+    } else {
+      std::cout << "Usage: " << argv[0] << " [-n nrep] [-s nx,nx,...] [-o file.json]"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  if (nrep < 1 || sizes.empty()) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "nrep must be positive and at least one block size given" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  for (int nx : sizes) {
+    if (nx < 2) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Block size nx=" << nx << " must be >= 2" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
+  {
+    std::vector<BenchResult> results;
+    for (int nx : sizes) {
+      RunAll(nx, nrep, results);
+    }
+
+    std::FILE *fp = stdout;
+    if (!outfile.empty()) {
+      fp = std::fopen(outfile.c_str(), "w");
+      if (fp == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Could not open file '" << outfile << "'" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+    WriteJSON(fp, nrep, results);
+    if (fp != stdout) std::fclose(fp);
+  }
+  Kokkos::finalize();
+  return 0;
+}
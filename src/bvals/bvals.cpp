@@ -7,8 +7,10 @@
 //! \brief constructors and initializers for both particle and Mesh variable boundary
 //! classes.
 
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <string>
 #include <utility>
 #include <algorithm> // max
 
@@ -19,6 +21,10 @@
 #include "mesh/mesh.hpp"
 #include "particles/particles.hpp"
 #include "bvals.hpp"
+#include "utils/memory_tracker.hpp"
+
+std::uint64_t MeshBoundaryValues::nmsg_sent = 0;
+std::uint64_t MeshBoundaryValues::nbytes_sent = 0;
 
 //----------------------------------------------------------------------------------------
 // MeshBoundaryValues constructor:
@@ -28,7 +34,10 @@ MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, b
   is_z4c_(z4c),
   u_in("uin",1,1),
   b_in("bin",1,1),
-  i_in("iin",1,1) {
+  i_in("iin",1,1),
+  coar_list("coar_list",1,2),
+  same_list("same_list",1,2),
+  fine_list("fine_list",1,2) {
   // allocate vector of status flags and MPI requests (if needed)
   int nnghbr = pmy_pack->pmb->nnghbr;
 
@@ -69,6 +78,35 @@ MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, b
   // create unique communicators for variables and fluxes in this BoundaryValues object
   MPI_Comm_dup(MPI_COMM_WORLD, &comm_vars);
   MPI_Comm_dup(MPI_COMM_WORLD, &comm_flux);
+  persistent_mpi = pin->GetOrAddBoolean("mesh", "persistent_mpi", false);
+  aggregate_mpi = pin->GetOrAddBoolean("mesh", "aggregate_mpi", false);
+  if (persistent_mpi && aggregate_mpi) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<mesh>/persistent_mpi and <mesh>/aggregate_mpi cannot both be true"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  shm_mpi = pin->GetOrAddBoolean("mesh", "shm_mpi", false);
+  if (shm_mpi) {
+    if (!(aggregate_mpi)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mesh>/shm_mpi=true requires <mesh>/aggregate_mpi=true"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    // vars are gathered into (and scattered from) the shared window by kernels on the
+    // device, so it must be able to access host memory directly
+    if (!(Kokkos::SpaceAccessibility<DevExeSpace, HostMemSpace>::accessible) ||
+        pmy_pack->pmesh->mpi_host_staging) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mesh>/shm_mpi=true requires device that can access "
+                << "host memory, and cannot be used with <mesh>/mpi_transport=host"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    MPI_Comm_split_type(comm_vars, MPI_COMM_TYPE_SHARED, global_variable::my_rank,
+                        MPI_INFO_NULL, &comm_node_);
+  }
 #endif
 }
 
@@ -77,6 +115,9 @@ MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, b
 
 MeshBoundaryValues::~MeshBoundaryValues() {
 #if MPI_PARALLEL_ENABLED
+  FreePersistentReqs();
+  FreeShmWindow();
+  if (comm_node_ != MPI_COMM_NULL) {MPI_Comm_free(&comm_node_);}
   int nnghbr = pmy_pack->pmb->nnghbr;
   for (int n=0; n<nnghbr; ++n) {
     delete [] sendbuf[n].vars_req;
@@ -87,6 +128,58 @@ MeshBoundaryValues::~MeshBoundaryValues() {
 #endif
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::ReportHaloError
+//! \brief With <block>/halo_check=true, prints the max error introduced by single
+//! precision messages over all ranks.  Collective over all ranks, so it is called
+//! explicitly at the end of the run (from Driver::Finalize()) rather than from the
+//! destructor.
+
+void MeshBoundaryValues::ReportHaloError() {
+#if MPI_PARALLEL_ENABLED
+  if (halo_check) {
+    Real maxerr[2] = {halo_maxerr_[0], halo_maxerr_[1]};
+    MPI_Allreduce(MPI_IN_PLACE, maxerr, 2, MPI_ATHENA_REAL, MPI_MAX, comm_vars);
+    if (global_variable::my_rank == 0) {
+      std::cout << "Max error in single precision halo exchange of <" << halo_block_
+                << ">: absolute = " << maxerr[0] << ", relative = " << maxerr[1]
+                << std::endl;
+    }
+  }
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::SetHaloPrecision
+//! \brief Reads precision of boundary messages from input block of the physics module
+//! that owns this BoundaryValues object.  With <block>/halo_precision=float, aggregated
+//! messages to other ranks are converted to single precision before they are sent,
+//! halving their size.  With <block>/halo_check=true the max error introduced by the
+//! conversion is also tracked, and reported at the end of the run.  Has no effect
+//! without MPI, or if Real is already single precision.
+
+void MeshBoundaryValues::SetHaloPrecision(ParameterInput *pin, const std::string &block) {
+  std::string prec = pin->GetOrAddString(block, "halo_precision", "double");
+  if ((prec != "double") && (prec != "float")) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<" << block << ">/halo_precision = '" << prec << "' not implemented, "
+              << "must be 'double' or 'float'" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#if MPI_PARALLEL_ENABLED
+  halo_float = (prec == "float") && (sizeof(Real) > sizeof(float));
+  halo_check = halo_float && pin->GetOrAddBoolean(block, "halo_check", false);
+  halo_block_ = block;
+  if (halo_float && !(aggregate_mpi)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<" << block << ">/halo_precision=float requires "
+              << "<mesh>/aggregate_mpi=true" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBoundaryValues::InitializeBuffers
 //! \brief initialize each element of send/recv MeshBoundaryBuffers fixed-length arrays
@@ -97,6 +190,7 @@ MeshBoundaryValues::~MeshBoundaryValues() {
 //! virtual functions that only get instantiated when the derived classes are constructed
 
 void MeshBoundaryValues::InitializeBuffers(const int nvar) {
+  memory_tracker::Scope scope(memory_tracker::Owner::buffers);
   // allocate memory for inflow BCs (but only if domain not strictly periodic)
   if (!(pmy_pack->pmesh->strictly_periodic)) {
     Kokkos::realloc(u_in, nvar, 6);
@@ -218,6 +312,75 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
     }
   }
 
+#if MPI_PARALLEL_ENABLED
+  // allocate host copies of buffers used to stage MPI messages
+  if (pmy_pack->pmesh->mpi_host_staging) {
+    for (int n=0; n<pmy_pack->pmb->nnghbr; ++n) {
+      Kokkos::realloc(sendbuf[n].vars_h, nmb, sendbuf[n].vars.extent(1));
+      Kokkos::realloc(sendbuf[n].flux_h, nmb, sendbuf[n].flux.extent(1));
+      Kokkos::realloc(recvbuf[n].vars_h, nmb, recvbuf[n].vars.extent(1));
+      Kokkos::realloc(recvbuf[n].flux_h, nmb, recvbuf[n].flux.extent(1));
+    }
+  }
+#endif
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::InitInterfaceLists()
+//! \brief Builds lists of the (m,n) indices of all buffers with a neighbor at a coarser,
+//! the same, or a finer level than the MeshBlock.  Lists are only rebuilt when the Mesh
+//! has changed since they were last built (signalled by a change in Mesh::ngeneration).
+
+void MeshBoundaryValues::InitInterfaceLists() {
+  if (iface_generation_ == pmy_pack->pmesh->ngeneration) {return;}
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &mblev = pmy_pack->pmb->mb_lev;
+
+  // count interfaces of each type, then fill lists
+  int ncoar = 0, nsame = 0, nfine = 0;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid < 0) {continue;}
+      if (nghbr.h_view(m,n).lev < mblev.h_view(m)) {ncoar++;}
+      else if (nghbr.h_view(m,n).lev == mblev.h_view(m)) {nsame++;}
+      else {nfine++;}
+    }
+  }
+  // only reallocate lists that have grown, so allocations are reused across AMR
+  if (coar_list.extent_int(0) < ncoar) {Kokkos::realloc(coar_list, ncoar, 2);}
+  if (same_list.extent_int(0) < nsame) {Kokkos::realloc(same_list, nsame, 2);}
+  if (fine_list.extent_int(0) < nfine) {Kokkos::realloc(fine_list, nfine, 2);}
+  ncoar = 0, nsame = 0, nfine = 0;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid < 0) {continue;}
+      if (nghbr.h_view(m,n).lev < mblev.h_view(m)) {
+        coar_list.h_view(ncoar,0) = m;
+        coar_list.h_view(ncoar,1) = n;
+        ncoar++;
+      } else if (nghbr.h_view(m,n).lev == mblev.h_view(m)) {
+        same_list.h_view(nsame,0) = m;
+        same_list.h_view(nsame,1) = n;
+        nsame++;
+      } else {
+        fine_list.h_view(nfine,0) = m;
+        fine_list.h_view(nfine,1) = n;
+        nfine++;
+      }
+    }
+  }
+  ncoar_ = ncoar, nsame_ = nsame, nfine_ = nfine;
+  coar_list.template modify<HostMemSpace>();
+  coar_list.template sync<DevExeSpace>();
+  same_list.template modify<HostMemSpace>();
+  same_list.template sync<DevExeSpace>();
+  fine_list.template modify<HostMemSpace>();
+  fine_list.template sync<DevExeSpace>();
+  iface_generation_ = pmy_pack->pmesh->ngeneration;
   return;
 }
 
@@ -227,6 +390,8 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
 particles::ParticlesBoundaryValues::ParticlesBoundaryValues(
   particles::Particles *pp, ParameterInput *pin) :
     sendlist("sendlist",1),
+    send_counter("send_counter",1),
+    nprtcl_rank("nprtcl_rank",global_variable::nranks),
 #if MPI_PARALLEL_ENABLED
     prtcl_rsendbuf("rsend",1),
     prtcl_rrecvbuf("rrecv",1),
@@ -235,12 +400,6 @@ particles::ParticlesBoundaryValues::ParticlesBoundaryValues(
 #endif
     pmy_part(pp) {
 #if MPI_PARALLEL_ENABLED
-  // Guess that no more than 10% of particles will be communicated to set size of buffer
-  int npart = pmy_part->nprtcl_thispack;
-
-  //resize vectors over number of ranks
-  nsends_eachrank.resize(global_variable::nranks);
-
   // create unique communicator for particles
   MPI_Comm_dup(MPI_COMM_WORLD, &mpi_comm_part);
 #endif
@@ -250,4 +409,7 @@ particles::ParticlesBoundaryValues::ParticlesBoundaryValues(
 // destructor
 
 particles::ParticlesBoundaryValues::~ParticlesBoundaryValues() {
+#if MPI_PARALLEL_ENABLED
+  if (mpi_comm_nghbr != MPI_COMM_NULL) {MPI_Comm_free(&mpi_comm_nghbr);}
+#endif
 }
@@ -20,6 +20,8 @@ enum class BoundaryFlag {undef=-1,block, reflect, inflow, outflow, diode, user,
                          shear_periodic, vacuum};
 
 #include <algorithm>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include "athena.hpp"
@@ -82,6 +84,19 @@ struct MeshBoundaryBuffer {
   // vectors of length (number of MBs) to hold MPI requests
   // Using STL vector causes problems with some GPU compilers, so just use plain C array
   MPI_Request *vars_req, *flux_req;
+  // host copies of vars and flux, only allocated when Mesh::mpi_host_staging is true
+  PinnedArray2D<Real> vars_h, flux_h;
+
+  // pointers to data for MeshBlock m passed to MPI, which are in vars_h/flux_h (rather
+  // than device memory) if messages are staged through host
+  Real *VarsPtr(int m, bool staged) {
+    return (staged)? (vars_h.data() + m*vars_h.extent(1)) :
+                     (vars.data() + m*vars.extent(1));
+  }
+  Real *FluxPtr(int m, bool staged) {
+    return (staged)? (flux_h.data() + m*flux_h.extent(1)) :
+                     (flux.data() + m*flux.extent(1));
+  }
 #endif
 
   // function to allocate memory for buffers for variables and their fluxes
@@ -100,6 +115,41 @@ struct MeshBoundaryBuffer {
   }
 };
 
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \struct AggregateMessages
+//! \brief Data for exchanging all the vars buffers shared with each neighboring rank in a
+//! single MPI message (used with <mesh>/aggregate_mpi=true).  Within each message the
+//! buffers are stored contiguously, ordered by (local ID, buffer index) of the receiving
+//! MeshBlock, so that both sender and receiver can compute the same offset table.
+
+struct AggregateMessages {
+  DvceArray1D<Real> data;         // contiguous data for all messages
+  DualArray2D<int> bufs;          // (m, n, offset, size) of each MeshBoundaryBuffer
+  std::vector<int> rank;          // neighboring rank of each message
+  std::vector<int> offset, size;  // offset into data and size of each message
+  std::vector<MPI_Request> req;   // requests for each message
+  PinnedArray1D<Real> data_h;     // host copy of data (with Mesh::mpi_host_staging)
+  std::vector<int> ibuf;          // index in bufs of first buffer in each message
+  // with <mesh>/shm_mpi=true, messages to/from ranks on the same node are exchanged
+  // through a shared memory window.  For such messages flag points to the (posted,
+  // consumed) counters of the message in the window of the sender, and nseq counts the
+  // messages posted (sender) or consumed (receiver).  Otherwise flag=nullptr.
+  std::vector<volatile std::int64_t*> flag;
+  std::vector<std::int64_t> nseq;
+  std::vector<DvceArray1D<Real>> peer;  // receiver: view of message in sender's window
+  // single precision copies of data sent to other nodes (with halo_precision=float)
+  DvceArray1D<float> data_f;
+  PinnedArray1D<float> data_fh;
+
+  // pointer to message i passed to MPI (see MeshBoundaryBuffer::VarsPtr())
+  void *MsgPtr(int i, bool staged, bool single) {
+    if (single) {return ((staged)? data_fh.data() : data_f.data()) + offset[i];}
+    return ((staged)? data_h.data() : data.data()) + offset[i];
+  }
+};
+#endif
+
 // Forward declarations
 class MeshBlockPack;
 
@@ -120,15 +170,41 @@ class MeshBoundaryValues {
   // constant inflow states at each face, initialized in problem generator
   DualArray2D<Real> u_in, b_in, i_in;
 
+  // number of MPI messages (and bytes) of variables and fluxes sent to other ranks by
+  // all MeshBoundaryValues objects on this rank, accumulated over the run
+  static std::uint64_t nmsg_sent, nbytes_sent;
+
+  // (m,n) indices of all buffers whose neighbor is at a coarser/same/finer level.  Used
+  // to launch prolongation and flux-correction kernels only over the buffers they act
+  // on, rather than over all nmb*nnghbr buffers (see InitInterfaceLists())
+  DualArray2D<int> coar_list, same_list, fine_list;
+
 #if MPI_PARALLEL_ENABLED
   // unique MPI communicators for each case (variables/fluxes)
   MPI_Comm comm_vars, comm_flux;
+  // with <mesh>/persistent_mpi=true, vars_req in send/recv buffers are persistent
+  // requests that are only rebuilt when the Mesh changes (see InitPersistentReqs())
+  bool persistent_mpi;
+  // with <mesh>/aggregate_mpi=true, vars are exchanged in one message per neighboring
+  // rank rather than one per MeshBlock buffer (see bvals_aggregate.cpp)
+  bool aggregate_mpi;
+  AggregateMessages agg_send, agg_recv;
+  // with <mesh>/shm_mpi=true, aggregated messages between ranks on the same node are
+  // written into an MPI-3 shared memory window and read directly by the receiver
+  bool shm_mpi;
+  // with halo_precision=float in the input block of the parent physics module (see
+  // SetHaloPrecision()), aggregated messages to other ranks are sent in single precision
+  bool halo_float = false;
+  bool halo_check = false;  // track max error introduced by single precision messages
 #endif
 
   //functions
   virtual void InitSendIndices(MeshBoundaryBuffer &buf,int x,int y,int z,int a,int b)=0;
   virtual void InitRecvIndices(MeshBoundaryBuffer &buf,int x,int y,int z,int a,int b)=0;
   void InitializeBuffers(const int nvar);
+  void SetHaloPrecision(ParameterInput *pin, const std::string &block);
+  void ReportHaloError();
+  void InitInterfaceLists();
 
   TaskStatus InitRecv(const int nvar);
   virtual TaskStatus InitFluxRecv(const int nvar)=0;
@@ -149,6 +225,34 @@ class MeshBoundaryValues {
   // many types (Hydro, MHD, Radiation, Z4c, etc.)
   MeshBlockPack* pmy_pack;
   bool is_z4c_;   // flag to denote if this BoundaryValues is for Z4c module
+  // BoundaryValues object whose ncomb_ vars are packed into (and exchanged with) the
+  // buffers of this one, or nullptr (see MeshBoundaryValuesFC::CombineWithCC())
+  MeshBoundaryValues *pcomb_ = nullptr;
+  int ncomb_ = 0;
+  int iface_generation_ = -1;  // Mesh::ngeneration when interface lists built
+  int ncoar_ = 0, nsame_ = 0, nfine_ = 0;  // number of elements used in interface lists
+#if MPI_PARALLEL_ENABLED
+  int comm_generation_ = -1;  // Mesh::ngeneration when persistent/aggregate msgs built
+  int comm_nvar_ = 0;         // number of variables persistent/aggregate msgs built for
+  int preq_nmb_ = 0;          // number of MeshBlocks persistent reqs were built for
+  int VarsSize(bool send, int m, int n, int nvar);
+  void InitPersistentReqs(const int nvar);
+  void FreePersistentReqs();
+  void CopySendToHost(bool flux);
+  void CopyRecvToDvce(bool flux);
+  void InitAggregateMsgs(const int nvar);
+  void PostAggregateRecvs();
+  void SendAggregateMsgs();
+  bool RecvAggregateMsgs();
+  void ScatterAggregate(int b0, int b1, DvceArray1D<Real> data, int moff);
+  MPI_Comm comm_node_ = MPI_COMM_NULL;  // ranks sharing memory on this node (shm_mpi)
+  MPI_Win shm_win_ = MPI_WIN_NULL;      // window holding counters and send data
+  void InitShmWindow(const int ntot);
+  void FreeShmWindow();
+  void WaitShmConsumed();
+  std::string halo_block_;         // input block of parent physics module
+  Real halo_maxerr_[2] = {0.0, 0.0};  // max absolute/relative error with halo_check
+#endif
 };
 
 //----------------------------------------------------------------------------------------
@@ -170,6 +274,10 @@ class MeshBoundaryValuesCC : public MeshBoundaryValues {
   // functions to communicate fluxes of CC data
   TaskStatus PackAndSendFluxCC(DvceFaceFld5D<Real> &flx);
   TaskStatus RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx);
+  // functions to sum CC data in ghost cells into active cells of neighbors (reverse of
+  // the usual exchange, only between MeshBlocks at the same level)
+  TaskStatus PackAndSendGhostSumCC(DvceArray5D<Real> &a);
+  TaskStatus RecvAndUnpackGhostSumCC(DvceArray5D<Real> &a);
 
   // functions to prolongate conserved and primitive CC variables
   void FillCoarseInBndryCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca,
@@ -181,6 +289,10 @@ class MeshBoundaryValuesCC : public MeshBoundaryValues {
                              DvceArray5D<Real> &prim);
   void PrimToConsFineBndry(const DvceArray5D<Real> &prim, const DvceFaceFld4D<Real> &b,
                            DvceArray5D<Real> &cons);
+
+ private:
+  TaskStatus SendVarsCC(const int nvar);
+  TaskStatus TestRecvVarsCC();
 };
 
 //----------------------------------------------------------------------------------------
@@ -198,6 +310,12 @@ class MeshBoundaryValuesFC : public MeshBoundaryValues {
 
   TaskStatus PackAndSendFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
   TaskStatus RecvAndUnpackFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
+  // combined exchange of face-fields and cell-centered vars (see bvals_ub.cpp)
+  void CombineWithCC(MeshBoundaryValuesCC *pcc, int nvar);
+  TaskStatus PackAndSendUB(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
+                           DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
+  TaskStatus RecvAndUnpackUB(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
+                             DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
   void FillCoarseInBndryFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
   void ProlongateFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
 
@@ -207,6 +325,10 @@ class MeshBoundaryValuesFC : public MeshBoundaryValues {
                          DvceArray2D<int> &nflx);
   void ZeroFluxesAtBoundaryWithFiner(DvceEdgeFld4D<Real> &flx, DvceArray2D<int> &nflx);
   void AverageBoundaryFluxes(DvceEdgeFld4D<Real> &flx, DvceArray2D<int> &nflx);
+
+ private:
+  void SendFC();
+  bool RecvFC();
 };
 
 //----------------------------------------------------------------------------------------
@@ -219,16 +341,6 @@ struct ParticleLocationData {
   int dest_rank;    // rank of target MeshBlock
 };
 
-// Custom operators to sort ParticleLocationData array by dest_rank or prtcl_indx
-struct {
-  bool operator()(ParticleLocationData a, ParticleLocationData b)
-    const { return a.dest_rank < b.dest_rank; }
-} SortByRank;
-struct {
-  bool operator()(ParticleLocationData a, ParticleLocationData b)
-    const { return a.prtcl_indx < b.prtcl_indx; }
-} SortByIndex;
-
 //----------------------------------------------------------------------------------------
 //! \struct ParticleMessageData
 //! \brief Data describing MPI messages containing particles
@@ -237,8 +349,10 @@ struct ParticleMessageData {
   int sendrank;  // rank of sender
   int recvrank;  // rank of receiver
   int nprtcls;   // number of particles in message
-  ParticleMessageData(int a, int b, int c) :
-    sendrank(a), recvrank(b), nprtcls(c) {}
+  int tag;       // MPI tag (only used with AMR, that of the MeshBlock message)
+  int gid;       // GID of receiving MeshBlock (only used with AMR)
+  ParticleMessageData(int a, int b, int c, int d=0, int e=-1) :
+    sendrank(a), recvrank(b), nprtcls(c), tag(d), gid(e) {}
 };
 
 //----------------------------------------------------------------------------------------
@@ -252,22 +366,35 @@ class ParticlesBoundaryValues {
   ~ParticlesBoundaryValues();
 
   int nprtcl_send, nprtcl_recv;
-  DualArray1D<ParticleLocationData> sendlist;
+  DvceArray1D<ParticleLocationData> sendlist;  // only stored (and sorted) on device
+  // Capacity of sendlist, scratch arrays and buffers below is only ever grown, so that
+  // in steady state particle communication performs no device allocations.
+  DvceArray1D<ParticleLocationData> sendlist_tmp;  // scratch for sorting sendlist
+  DvceArray1D<std::int64_t> sort_keys;             // keys for sorting sendlist
+  DvceArray1D<int> send_counter;                   // number of particles to send
+  DualArray1D<int> nprtcl_rank;                    // number of prtcls sent to each rank
+  DvceArray1D<int> tail_hole, move_indx;           // scratch for filling holes
 
   // Data needed to count number of messages and particles to send between ranks
   int nsends; // number of MPI sends to neighboring ranks on this rank
   int nrecvs; // number of MPI recvs from neighboring ranks on this rank
-  std::vector<int> nsends_eachrank;                // length nranks
   std::vector<ParticleMessageData> sends_thisrank; // length nsends
   std::vector<ParticleMessageData> recvs_thisrank; // length nrecvs
-  std::vector<ParticleMessageData> sends_allranks; // length ncounts summed over ranks
 
 #if MPI_PARALLEL_ENABLED
   DvceArray1D<Real> prtcl_rsendbuf, prtcl_rrecvbuf;
   DvceArray1D<int>  prtcl_isendbuf, prtcl_irecvbuf;
+  // host copies of buffers, only used when Mesh::mpi_host_staging is true
+  PinnedArray1D<Real> prtcl_rsendbuf_h, prtcl_rrecvbuf_h;
+  PinnedArray1D<int>  prtcl_isendbuf_h, prtcl_irecvbuf_h;
   std::vector<MPI_Request> rrecv_req, rsend_req;  // vectors of requests for Reals
   std::vector<MPI_Request> irecv_req, isend_req;  // vectors of requests for ints
   MPI_Comm mpi_comm_part;                       // unique MPI communicators for particles
+  // distributed graph communicator over ranks owning neighbors of MeshBlocks on this
+  // rank, used to exchange particle counts only with ranks particles can move to/from
+  MPI_Comm mpi_comm_nghbr = MPI_COMM_NULL;
+  std::vector<int> nghbr_dests, nghbr_srcs;     // out/in neighbors in mpi_comm_nghbr
+  int nghbr_generation = -1;                    // Mesh::ngeneration of mpi_comm_nghbr
 #endif
 
   //functions
@@ -278,9 +405,23 @@ class ParticlesBoundaryValues {
   TaskStatus PackAndSendPrtcls();
   TaskStatus ClearPrtclSend();
   TaskStatus RecvAndUnpackPrtcls();
+  // move particles with their MeshBlocks when MeshBlocks are redistributed
+  void SetNewMeshPrtclGID(const int *oldtonew, const int *new_rank_eachmb, int nmb_new,
+                          DualArray1D<int> &refine_flag);
+  void PackAndSendPrtclsAMR(std::vector<ParticleMessageData> &msgs);
+  void RecvAndUnpackPrtclsAMR(std::vector<ParticleMessageData> &msgs);
 
  protected:
   particles::Particles* pmy_part;
+
+ private:
+  void SortSendList(bool by_rank);
+#if MPI_PARALLEL_ENABLED
+  void CountSends();
+  void PackPrtcls();
+  void UnpackPrtcls();
+  void SetNeighborComm();
+#endif
 };
 } // namespace particles
 
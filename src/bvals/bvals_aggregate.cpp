@@ -0,0 +1,480 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file bvals_aggregate.cpp
+//! \brief functions to exchange boundary buffers of vars with one MPI message per
+//! neighboring rank (rather than one per MeshBoundaryBuffer per MeshBlock), enabled with
+//! <mesh>/aggregate_mpi=true.  Buffers are still packed/unpacked into sendbuf/recvbuf by
+//! the CC/FC functions; the functions below gather them into (and scatter them from) one
+//! contiguous device array, using an offset table rebuilt whenever the Mesh changes.
+//!
+//! Since messages are identified only by the ranks of the sender and receiver, the tags
+//! used here do not encode the local ID of MeshBlocks.
+//!
+//! With <mesh>/shm_mpi=true, the send data is allocated in an MPI-3 shared memory window
+//! (MPI_Win_allocate_shared) on the ranks of each node, and messages to ranks on the same
+//! node are not sent with MPI at all.  Instead the sender increments a "posted" counter
+//! for the message in its window once the data is gathered, the receiver scatters the
+//! data directly from the window of the sender once it sees the counter change, and then
+//! increments a "consumed" counter.  The sender waits for the consumed counter in
+//! ClearSend() before the data can be overwritten.  Messages to other nodes use MPI.
+//!
+//! With halo_precision=float in the input block of the parent physics module, the data
+//! sent with MPI is converted to single precision (data_f) before sending, and back to
+//! Real after receiving.  Data exchanged on the same rank or through the shared window
+//! is not converted.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals.hpp"
+
+#if MPI_PARALLEL_ENABLED
+// MPI tags used for the message sizes (sent once per Mesh generation) and the data
+namespace {
+const int agg_size_tag = 0;
+const int agg_data_tag = 1;
+const int agg_shm_tag = 2;
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::InitAggregateMsgs()
+//! \brief Builds the offset tables for aggregated messages.  Each buffer sent to another
+//! rank is labelled by the rank, and by the local ID and buffer index of the *receiving*
+//! MeshBlock, and the same labels are computed by the receiver, so sorting on them gives
+//! the same order on both ranks.  Sizes of buffers are computed by the sender and passed
+//! to the receiver, so that offsets agree even if the receive buffers are larger.
+
+void MeshBoundaryValues::InitAggregateMsgs(const int nvars) {
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  int my_rank = global_variable::my_rank;
+  bool staged = pmy_pack->pmesh->mpi_host_staging;
+
+  // rank, label, and (m,n,size) of each buffer sent to/received from another rank
+  struct AggBuf {int rank, label, m, n, size;};
+  std::vector<AggBuf> sends, recvs;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      int drank = nghbr.h_view(m,n).rank;
+      if ((nghbr.h_view(m,n).gid >= 0) && (drank != my_rank)) {
+        int size = VarsSize(true, m, n, nvars);
+        int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
+        int dn = nghbr.h_view(m,n).dest;
+        sends.push_back({drank, lid*nnghbr + dn, m, n, size});
+        recvs.push_back({drank, m*nnghbr + n, m, n, 0});
+      }
+    }
+  }
+  auto by_label = [](const AggBuf &a, const AggBuf &b) {
+    return (a.rank < b.rank) || ((a.rank == b.rank) && (a.label < b.label));
+  };
+  std::sort(sends.begin(), sends.end(), by_label);
+  std::sort(recvs.begin(), recvs.end(), by_label);
+
+  // set ranks and number of buffers in each message.  Every buffer sent to a neighbor is
+  // matched by one received from it, so messages go to and come from the same ranks.
+  std::vector<int> nbuf;
+  agg_send.rank.clear();
+  for (std::size_t b=0; b<sends.size(); ++b) {
+    if ((b == 0) || (sends[b].rank != sends[b-1].rank)) {
+      agg_send.rank.push_back(sends[b].rank);
+      nbuf.push_back(0);
+    }
+    nbuf.back()++;
+  }
+  agg_recv.rank = agg_send.rank;
+  int nmsg = static_cast<int>(agg_send.rank.size());
+
+  // exchange sizes of buffers in each message
+  std::vector<int> send_sizes(sends.size()), recv_sizes(recvs.size());
+  for (std::size_t b=0; b<sends.size(); ++b) {send_sizes[b] = sends[b].size;}
+  std::vector<MPI_Request> size_req(2*nmsg, MPI_REQUEST_NULL);
+  bool no_errors=true;
+  for (int i=0, b=0; i<nmsg; b += nbuf[i], ++i) {
+    int ierr = MPI_Irecv(&(recv_sizes[b]), nbuf[i], MPI_INT, agg_recv.rank[i],
+                         agg_size_tag, comm_vars, &(size_req[i]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    ierr = MPI_Isend(&(send_sizes[b]), nbuf[i], MPI_INT, agg_send.rank[i],
+                     agg_size_tag, comm_vars, &(size_req[nmsg+i]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+  }
+  if (MPI_Waitall(2*nmsg, size_req.data(), MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
+    no_errors=false;
+  }
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in exchanging sizes of aggregated messages"
+       << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  for (std::size_t b=0; b<recvs.size(); ++b) {
+    recvs[b].size = recv_sizes[b];
+    if (recvs[b].size > recvbuf[recvs[b].n].vars.extent_int(1)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "Aggregated message from rank " << recvs[b].rank
+         << " exceeds size of receive buffer " << recvs[b].n << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
+  // build offset tables and allocate contiguous arrays
+  bool single = halo_float;
+  // only reallocate arrays whose size has changed, so allocations are reused across AMR
+  auto resize = [](auto &v, int n) {if (v.extent_int(0) != n) {Kokkos::realloc(v, n);}};
+  auto build = [nmsg, staged, single, &nbuf, &resize](const std::vector<AggBuf> &list,
+                                                      AggregateMessages &agg) {
+    int nlist = static_cast<int>(list.size());
+    if (agg.bufs.extent_int(0) != nlist) {Kokkos::realloc(agg.bufs, nlist, 4);}
+    agg.offset.assign(nmsg, 0);
+    agg.size.assign(nmsg, 0);
+    agg.req.assign(nmsg, MPI_REQUEST_NULL);
+    agg.ibuf.assign(nmsg+1, 0);
+    agg.flag.assign(nmsg, nullptr);
+    agg.nseq.assign(nmsg, 0);
+    agg.peer.assign(nmsg, DvceArray1D<Real>());
+    int offset = 0;
+    for (int i=0, b=0; i<nmsg; ++i) {
+      agg.offset[i] = offset;
+      agg.ibuf[i] = b;
+      for (int l=0; l<nbuf[i]; ++l, ++b) {
+        agg.bufs.h_view(b,0) = list[b].m;
+        agg.bufs.h_view(b,1) = list[b].n;
+        agg.bufs.h_view(b,2) = offset;
+        agg.bufs.h_view(b,3) = list[b].size;
+        offset += list[b].size;
+      }
+      agg.size[i] = offset - agg.offset[i];
+    }
+    agg.ibuf[nmsg] = nlist;
+    agg.bufs.template modify<HostMemSpace>();
+    agg.bufs.template sync<DevExeSpace>();
+    resize(agg.data, offset);
+    if (staged) {resize(agg.data_h, offset);}
+    if (single) {
+      resize(agg.data_f, offset);
+      if (staged) {resize(agg.data_fh, offset);}
+    }
+  };
+  build(sends, agg_send);
+  build(recvs, agg_recv);
+  if (shm_mpi) {InitShmWindow(agg_send.data.extent_int(0));}
+
+  comm_generation_ = pmy_pack->pmesh->ngeneration;
+  comm_nvar_ = nvars;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::PostAggregateRecvs()
+//! \brief Posts one non-blocking receive for aggregated message from each neighboring
+//! rank.  Called by InitRecv(), which rebuilds offset tables first if needed.
+
+void MeshBoundaryValues::PostAggregateRecvs() {
+  bool staged = pmy_pack->pmesh->mpi_host_staging;
+  MPI_Datatype dtype = (halo_float)? MPI_FLOAT : MPI_ATHENA_REAL;
+  bool no_errors=true;
+  for (std::size_t i=0; i<agg_recv.rank.size(); ++i) {
+    if (agg_recv.flag[i] != nullptr) {continue;}  // read from shared window instead
+    int ierr = MPI_Irecv(agg_recv.MsgPtr(i, staged, halo_float), agg_recv.size[i],
+                         dtype, agg_recv.rank[i], agg_data_tag, comm_vars,
+                         &(agg_recv.req[i]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in posting aggregated receives" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::SendAggregateMsgs()
+//! \brief Gathers packed send buffers into contiguous array, and sends one message to
+//! each neighboring rank.  Called by PackAndSendCC/FC() after packing kernel.
+
+void MeshBoundaryValues::SendAggregateMsgs() {
+  // data in shared window cannot be overwritten until read by all receivers on node
+  if (shm_win_ != MPI_WIN_NULL) {WaitShmConsumed();}
+  int nbuf = agg_send.bufs.extent_int(0);
+  if (nbuf > 0) {
+    auto &sbuf = sendbuf;
+    auto &bufs = agg_send.bufs;
+    auto &data = agg_send.data;
+    par_for_outer("AggGather", DevExeSpace(), 0, 0, 0, (nbuf-1),
+    KOKKOS_LAMBDA(TeamMember_t tmember, const int b) {
+      const int m = bufs.d_view(b,0);
+      const int n = bufs.d_view(b,1);
+      const int offset = bufs.d_view(b,2);
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(tmember, bufs.d_view(b,3)),
+      [&](const int i) {
+        data(offset + i) = sbuf[n].vars(m,i);
+      });
+    });
+  }
+
+  // convert to single precision, tracking the error introduced if requested
+  int ntot = agg_send.data.extent_int(0);
+  if (halo_float && (ntot > 0)) {
+    auto &data = agg_send.data;
+    auto &data_f = agg_send.data_f;
+    if (halo_check) {
+      Real err_abs = 0.0, err_rel = 0.0;
+      Kokkos::parallel_reduce("AggToFloat",
+      Kokkos::RangePolicy<>(DevExeSpace(), 0, ntot),
+      KOKKOS_LAMBDA(const int i, Real &max_abs, Real &max_rel) {
+        data_f(i) = static_cast<float>(data(i));
+        Real err = fabs(data(i) - static_cast<Real>(data_f(i)));
+        max_abs = fmax(err, max_abs);
+        if (data(i) != 0.0) {max_rel = fmax(err/fabs(data(i)), max_rel);}
+      }, Kokkos::Max<Real>(err_abs), Kokkos::Max<Real>(err_rel));
+      halo_maxerr_[0] = std::max(halo_maxerr_[0], err_abs);
+      halo_maxerr_[1] = std::max(halo_maxerr_[1], err_rel);
+    } else {
+      par_for("AggToFloat", DevExeSpace(), 0, (ntot-1),
+      KOKKOS_LAMBDA(const int i) {
+        data_f(i) = static_cast<float>(data(i));
+      });
+    }
+  }
+  bool staged = pmy_pack->pmesh->mpi_host_staging;
+  if (staged) {
+    if (halo_float) {
+      Kokkos::deep_copy(DevExeSpace(), agg_send.data_fh, agg_send.data_f);
+    } else {
+      Kokkos::deep_copy(DevExeSpace(), agg_send.data_h, agg_send.data);
+    }
+  }
+  // wait only for packing kernels on the default execution space instance
+  DevExeSpace().fence();
+
+  // messages to ranks on this node are posted by incrementing counter in shared window
+  if (shm_win_ != MPI_WIN_NULL) {
+    MPI_Win_sync(shm_win_);
+    for (std::size_t i=0; i<agg_send.rank.size(); ++i) {
+      if (agg_send.flag[i] != nullptr) {agg_send.flag[i][0] = ++agg_send.nseq[i];}
+    }
+    MPI_Win_sync(shm_win_);
+  }
+
+  MPI_Datatype dtype = (halo_float)? MPI_FLOAT : MPI_ATHENA_REAL;
+  bool no_errors=true;
+  for (std::size_t i=0; i<agg_send.rank.size(); ++i) {
+    if (agg_send.flag[i] != nullptr) {continue;}
+    int ierr = MPI_Isend(agg_send.MsgPtr(i, staged, halo_float), agg_send.size[i],
+                         dtype, agg_send.rank[i], agg_data_tag, comm_vars,
+                         &(agg_send.req[i]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    nmsg_sent++;
+    nbytes_sent += static_cast<std::uint64_t>(agg_send.size[i])*
+                   ((halo_float)? sizeof(float) : sizeof(Real));
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in posting aggregated sends" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool MeshBoundaryValues::RecvAggregateMsgs()
+//! \brief Tests whether aggregated messages from all neighboring ranks have arrived.  If
+//! so, scatters them into recv buffers and returns true.  Called by RecvAndUnpackCC/FC()
+//! before unpacking kernel.
+
+bool MeshBoundaryValues::RecvAggregateMsgs() {
+  bool bflag = false;
+  bool no_errors=true;
+  for (std::size_t i=0; i<agg_recv.req.size(); ++i) {
+    int test;
+    int ierr = MPI_Test(&(agg_recv.req[i]), &test, MPI_STATUS_IGNORE);
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    if (!(static_cast<bool>(test))) {
+      bflag = true;
+    }
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in testing aggregated receives" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // messages from ranks on this node have arrived once their counter has changed
+  if (shm_win_ != MPI_WIN_NULL) {
+    MPI_Win_sync(shm_win_);
+    for (std::size_t i=0; i<agg_recv.rank.size(); ++i) {
+      if ((agg_recv.flag[i] != nullptr) && (agg_recv.flag[i][0] <= agg_recv.nseq[i])) {
+        bflag = true;
+      }
+    }
+  }
+  if (bflag) {return false;}
+  if (pmy_pack->pmesh->mpi_host_staging) {
+    if (halo_float) {
+      Kokkos::deep_copy(DevExeSpace(), agg_recv.data_f, agg_recv.data_fh);
+    } else {
+      Kokkos::deep_copy(DevExeSpace(), agg_recv.data, agg_recv.data_h);
+    }
+  }
+  int ntot = agg_recv.data.extent_int(0);
+  if (halo_float && (ntot > 0)) {
+    auto &data = agg_recv.data;
+    auto &data_f = agg_recv.data_f;
+    par_for("AggFromFloat", DevExeSpace(), 0, (ntot-1),
+    KOKKOS_LAMBDA(const int i) {
+      data(i) = static_cast<Real>(data_f(i));
+    });
+  }
+
+  if (shm_win_ == MPI_WIN_NULL) {
+    ScatterAggregate(0, agg_recv.bufs.extent_int(0), agg_recv.data, 0);
+    return true;
+  }
+
+  // with shared window, scatter each message from the window of the sender or from the
+  // received data, then flag messages from ranks on this node as consumed
+  for (std::size_t i=0; i<agg_recv.rank.size(); ++i) {
+    if (agg_recv.flag[i] != nullptr) {
+      ScatterAggregate(agg_recv.ibuf[i], agg_recv.ibuf[i+1], agg_recv.peer[i],
+                       agg_recv.offset[i]);
+    } else {
+      ScatterAggregate(agg_recv.ibuf[i], agg_recv.ibuf[i+1], agg_recv.data, 0);
+    }
+  }
+  DevExeSpace().fence();
+  MPI_Win_sync(shm_win_);
+  for (std::size_t i=0; i<agg_recv.rank.size(); ++i) {
+    if (agg_recv.flag[i] != nullptr) {agg_recv.flag[i][1] = ++agg_recv.nseq[i];}
+  }
+  MPI_Win_sync(shm_win_);
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::ScatterAggregate()
+//! \brief Scatters buffers [b0,b1) in offset table of agg_recv into recv buffers.  The
+//! offsets in the table are shifted by moff to index data.
+
+void MeshBoundaryValues::ScatterAggregate(int b0, int b1, DvceArray1D<Real> data,
+                                          int moff) {
+  if (b1 <= b0) {return;}
+  auto &rbuf = recvbuf;
+  auto &bufs = agg_recv.bufs;
+  par_for_outer("AggScatter", DevExeSpace(), 0, 0, b0, (b1-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int b) {
+    const int m = bufs.d_view(b,0);
+    const int n = bufs.d_view(b,1);
+    const int offset = bufs.d_view(b,2) - moff;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(tmember, bufs.d_view(b,3)),
+    [&](const int i) {
+      rbuf[n].vars(m,i) = data(offset + i);
+    });
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::InitShmWindow()
+//! \brief Allocates shared memory window holding the (posted, consumed) counters of each
+//! message followed by ntot values of send data, and makes agg_send.data a view of it.
+//! Then exchanges the location of each message with the receivers on this node, which
+//! store pointers into the window of the sender.  Collective over ranks on the node, so
+//! must be called on all ranks (also those with no neighbors).
+
+void MeshBoundaryValues::InitShmWindow(const int ntot) {
+  FreeShmWindow();
+  int nmsg = static_cast<int>(agg_send.rank.size());
+
+  // rank of each neighbor in node communicator (MPI_UNDEFINED if on another node)
+  std::vector<int> node_rank(nmsg);
+  MPI_Group world_group, node_group;
+  MPI_Comm_group(comm_vars, &world_group);
+  MPI_Comm_group(comm_node_, &node_group);
+  MPI_Group_translate_ranks(world_group, nmsg, agg_send.rank.data(), node_group,
+                            node_rank.data());
+  MPI_Group_free(&world_group);
+  MPI_Group_free(&node_group);
+
+  bool no_errors=true;
+  MPI_Aint nhdr = 2*nmsg*sizeof(std::int64_t);
+  MPI_Aint nbytes = nhdr + static_cast<MPI_Aint>(ntot)*sizeof(Real);
+  char *base = nullptr;
+  if (MPI_Win_allocate_shared(nbytes, 1, MPI_INFO_NULL, comm_node_, &base, &shm_win_)
+      != MPI_SUCCESS) {no_errors=false;}
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, shm_win_);
+  std::int64_t *counters = reinterpret_cast<std::int64_t*>(base);
+  for (int i=0; i<2*nmsg; ++i) {counters[i] = 0;}
+  agg_send.data = DvceArray1D<Real>(reinterpret_cast<Real*>(base + nhdr), ntot);
+
+  // send location (index of counters, and of data in units of Real) of each message
+  std::vector<int> send_loc(2*nmsg), recv_loc(2*nmsg);
+  std::vector<MPI_Request> loc_req(2*nmsg, MPI_REQUEST_NULL);
+  for (int i=0; i<nmsg; ++i) {
+    if (node_rank[i] == MPI_UNDEFINED) {continue;}
+    agg_send.flag[i] = counters + 2*i;
+    send_loc[2*i] = 2*i;
+    send_loc[2*i+1] = static_cast<int>(nhdr/sizeof(Real)) + agg_send.offset[i];
+    int ierr = MPI_Irecv(&(recv_loc[2*i]), 2, MPI_INT, agg_recv.rank[i], agg_shm_tag,
+                         comm_vars, &(loc_req[i]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    ierr = MPI_Isend(&(send_loc[2*i]), 2, MPI_INT, agg_send.rank[i], agg_shm_tag,
+                     comm_vars, &(loc_req[nmsg+i]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+  }
+  if (MPI_Waitall(2*nmsg, loc_req.data(), MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
+    no_errors=false;
+  }
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in building shared memory window" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // counters on all ranks must be zeroed before they are read by neighbors
+  MPI_Win_sync(shm_win_);
+  MPI_Barrier(comm_node_);
+  MPI_Win_sync(shm_win_);
+
+  for (int i=0; i<nmsg; ++i) {
+    if (node_rank[i] == MPI_UNDEFINED) {continue;}
+    MPI_Aint peer_size;
+    int peer_disp;
+    char *peer_base = nullptr;
+    MPI_Win_shared_query(shm_win_, node_rank[i], &peer_size, &peer_disp, &peer_base);
+    agg_recv.flag[i] = reinterpret_cast<std::int64_t*>(peer_base) + recv_loc[2*i];
+    agg_recv.peer[i] = DvceArray1D<Real>(reinterpret_cast<Real*>(peer_base) +
+                                         recv_loc[2*i+1], agg_recv.size[i]);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::FreeShmWindow()
+//! \brief Frees shared memory window, if allocated.  Collective over ranks on the node.
+
+void MeshBoundaryValues::FreeShmWindow() {
+  if (shm_win_ == MPI_WIN_NULL) {return;}
+  MPI_Win_unlock_all(shm_win_);
+  MPI_Win_free(&shm_win_);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::WaitShmConsumed()
+//! \brief Waits until all messages posted in the shared window have been read by the
+//! receivers on this node.
+
+void MeshBoundaryValues::WaitShmConsumed() {
+  for (std::size_t i=0; i<agg_send.rank.size(); ++i) {
+    if (agg_send.flag[i] == nullptr) {continue;}
+    MPI_Win_sync(shm_win_);
+    while (agg_send.flag[i][1] < agg_send.nseq[i]) {MPI_Win_sync(shm_win_);}
+  }
+}
+#endif
@@ -207,54 +207,7 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
   }); // end par_for_outer
   }
 
-#if MPI_PARALLEL_ENABLED
-  // Send boundary buffer to neighboring MeshBlocks using MPI
-  Kokkos::fence();
-  auto &is_z4c = is_z4c_;
-  int my_rank = global_variable::my_rank;
-  auto &nghbr = pmy_pack->pmb->nghbr;
-  bool no_errors=true;
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if (nghbr.h_view(m,n).gid >= 0) {  // neighbor exists and not a physical boundary
-        // index and rank of destination Neighbor
-        int dn = nghbr.h_view(m,n).dest;
-        int drank = nghbr.h_view(m,n).rank;
-        if (drank != my_rank) {
-          // create tag using local ID and buffer index of *receiving* MeshBlock
-          int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
-          int tag = CreateBvals_MPI_Tag(lid, dn);
-
-          // get ptr to send buffer when neighbor is at coarser/same/fine level
-          int data_size = nvar;
-          if ( nghbr.h_view(m,n).lev < pmy_pack->pmb->mb_lev.h_view(m) ) {
-            data_size *= sendbuf[n].icoar_ndat;
-          } else if ( nghbr.h_view(m,n).lev == pmy_pack->pmb->mb_lev.h_view(m) ) {
-            if (is_z4c) {
-              data_size *= sendbuf[n].isame_z4c_ndat;
-            } else {
-              data_size *= sendbuf[n].isame_ndat;
-            }
-          } else {
-            data_size *= sendbuf[n].ifine_ndat;
-          }
-          auto send_ptr = Kokkos::subview(sendbuf[n].vars, m, Kokkos::ALL);
-
-          int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
-                               comm_vars, &(sendbuf[n].vars_req[m]));
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
-        }
-      }
-    }
-  }
-  // Quit if MPI error detected
-  if (!(no_errors)) {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-       << std::endl << "MPI error in posting sends" << std::endl;
-    std::exit(EXIT_FAILURE);
-  }
-#endif
-  return TaskStatus::complete;
+  return SendVarsCC(nvar);
 }
 
 //----------------------------------------------------------------------------------------
@@ -270,35 +223,8 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
   auto &rbuf = recvbuf;
   auto &is_z4c = is_z4c_;
   auto &multilevel = pmy_pack->pmesh->multilevel;
-#if MPI_PARALLEL_ENABLED
   //----- STEP 1: check that recv boundary buffer communications have all completed
-
-  bool bflag = false;
-  bool no_errors=true;
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if (nghbr.h_view(m,n).gid >= 0) { // neighbor exists and not a physical boundary
-        if (nghbr.h_view(m,n).rank != global_variable::my_rank) {
-          int test;
-          int ierr = MPI_Test(&(rbuf[n].vars_req[m]), &test, MPI_STATUS_IGNORE);
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
-          if (!(static_cast<bool>(test))) {
-            bflag = true;
-          }
-        }
-      }
-    }
-  }
-  // Quit if MPI error detected
-  if (!(no_errors)) {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl << "MPI error in testing non-blocking receives"
-              << std::endl;
-    std::exit(EXIT_FAILURE);
-  }
-  // exit if recv boundary buffer communications have not completed
-  if (bflag) {return TaskStatus::incomplete;}
-#endif
+  if (TestRecvVarsCC() == TaskStatus::incomplete) {return TaskStatus::incomplete;}
 
   //----- STEP 2: buffers have all completed, so unpack
 
@@ -413,3 +339,218 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
 
   return TaskStatus::complete;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesCC::PackAndSendGhostSumCC()
+//! \brief Pack ghost cells of cell-centered variables into boundary buffers and send to
+//! neighbors, which add them to their active cells in RecvAndUnpackGhostSumCC().  This is
+//! the reverse of the usual exchange, and is used to sum quantities (such as particle
+//! moments) deposited into ghost cells.  Only supported between MeshBlocks at the same
+//! level: the ghost cells of a MeshBlock facing a neighbor then have the same shape as
+//! the active cells of the neighbor sent in the usual exchange.
+
+TaskStatus MeshBoundaryValuesCC::PackAndSendGhostSumCC(DvceArray5D<Real> &a) {
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  int nvar = a.extent_int(1);
+
+  {int my_rank = global_variable::my_rank;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &mbgid = pmy_pack->pmb->mb_gid;
+  auto &sbuf = sendbuf;
+  auto &rbuf = recvbuf;
+  // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), nmb*nnghbr*nvar, Kokkos::AUTO);
+  Kokkos::parallel_for("SendGhostSum", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int m = (tmember.league_rank())/(nnghbr*nvar);
+    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
+    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+
+    // only load buffers when neighbor exists
+    if (nghbr.d_view(m,n).gid >= 0) {
+      // ghost cells facing neighbor are given by recv indices
+      int il = rbuf[n].isame[0].bis;
+      int iu = rbuf[n].isame[0].bie;
+      int jl = rbuf[n].isame[0].bjs;
+      int ju = rbuf[n].isame[0].bje;
+      int kl = rbuf[n].isame[0].bks;
+      int ku = rbuf[n].isame[0].bke;
+      int ni = iu - il + 1;
+      int nj = ju - jl + 1;
+      int nk = ku - kl + 1;
+      int nkj  = nk*nj;
+      int dm = nghbr.d_view(m,n).gid - mbgid.d_view(0);
+      int dn = nghbr.d_view(m,n).dest;
+
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
+        int k = idx / nj;
+        int j = (idx - k * nj) + jl;
+        k += kl;
+        // copy directly into recv buffer if MeshBlocks on same rank
+        if (nghbr.d_view(m,n).rank == my_rank) {
+          Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+          [&](const int i) {
+            rbuf[dn].vars(dm, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) = a(m,v,k,j,i);
+          });
+        } else {
+          Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+          [&](const int i) {
+            sbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) = a(m,v,k,j,i);
+          });
+        }
+        tmember.team_barrier();
+      });
+    }
+  });
+  }
+
+  return SendVarsCC(nvar);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesCC::RecvAndUnpackGhostSumCC()
+//! \brief Add ghost cells of neighbors received in boundary buffers to active cells.
+//! Buffers are summed in a fixed order within each cell, so results do not depend on the
+//! order in which messages arrive.
+
+TaskStatus MeshBoundaryValuesCC::RecvAndUnpackGhostSumCC(DvceArray5D<Real> &a) {
+  if (TestRecvVarsCC() == TaskStatus::incomplete) {return TaskStatus::incomplete;}
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  int nvar = a.extent_int(1);
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &sbuf = sendbuf;
+  auto &rbuf = recvbuf;
+  // Loop over active cells, adding every buffer that overlaps each cell, so that no two
+  // threads update the same cell
+  par_for("RecvGhostSum", DevExeSpace(), 0, (nmb-1), 0, (nvar-1), indcs.ks, indcs.ke,
+          indcs.js, indcs.je, indcs.is, indcs.ie,
+  KOKKOS_LAMBDA(const int m, const int v, const int k, const int j, const int i) {
+    Real sum = 0.0;
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.d_view(m,n).gid < 0) continue;
+      // active cells facing neighbor are given by send indices
+      int il = sbuf[n].isame[0].bis, iu = sbuf[n].isame[0].bie;
+      int jl = sbuf[n].isame[0].bjs, ju = sbuf[n].isame[0].bje;
+      int kl = sbuf[n].isame[0].bks, ku = sbuf[n].isame[0].bke;
+      if (i < il || i > iu || j < jl || j > ju || k < kl || k > ku) continue;
+      int ni = iu - il + 1;
+      int nj = ju - jl + 1;
+      int nk = ku - kl + 1;
+      sum += rbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) );
+    }
+    a(m,v,k,j,i) += sum;
+  });
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesCC::SendVarsCC()
+//! \brief Send packed boundary buffers of nvar variables to neighbors on other ranks.
+
+TaskStatus MeshBoundaryValuesCC::SendVarsCC(const int nvar) {
+#if MPI_PARALLEL_ENABLED
+  // Send boundary buffers in one message per neighboring rank
+  if (aggregate_mpi) {
+    SendAggregateMsgs();
+    return TaskStatus::complete;
+  }
+
+  // Send boundary buffer to neighboring MeshBlocks using MPI
+  CopySendToHost(false);
+  // wait only for packing kernels on the default execution space instance
+  DevExeSpace().fence();
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  int my_rank = global_variable::my_rank;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  bool no_errors=true;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid >= 0) {  // neighbor exists and not a physical boundary
+        // index and rank of destination Neighbor
+        int dn = nghbr.h_view(m,n).dest;
+        int drank = nghbr.h_view(m,n).rank;
+        if (drank != my_rank) {
+          // create tag using local ID and buffer index of *receiving* MeshBlock
+          int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
+          int tag = CreateBvals_MPI_Tag(lid, dn);
+
+          // get ptr to send buffer when neighbor is at coarser/same/fine level
+          int data_size = VarsSize(true, m, n, nvar);
+          Real *send_ptr = sendbuf[n].VarsPtr(m, pmy_pack->pmesh->mpi_host_staging);
+
+          int ierr;
+          if (persistent_mpi) {
+            // persistent request built in InitRecv() with same tag and size
+            ierr = MPI_Start(&(sendbuf[n].vars_req[m]));
+          } else {
+            ierr = MPI_Isend(send_ptr, data_size, MPI_ATHENA_REAL, drank, tag,
+                             comm_vars, &(sendbuf[n].vars_req[m]));
+          }
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+          nmsg_sent++;
+          nbytes_sent += static_cast<std::uint64_t>(data_size)*sizeof(Real);
+        }
+      }
+    }
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in posting sends" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesCC::TestRecvVarsCC()
+//! \brief Check that all receives of boundary buffers have completed, and copy them to
+//! the device if messages are staged through the host.
+
+TaskStatus MeshBoundaryValuesCC::TestRecvVarsCC() {
+#if MPI_PARALLEL_ENABLED
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &rbuf = recvbuf;
+  bool bflag = false;
+  bool no_errors=true;
+  if (aggregate_mpi) {
+    // test messages from all neighboring ranks, and scatter them into buffers
+    bflag = !(RecvAggregateMsgs());
+  } else {
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if (nghbr.h_view(m,n).gid >= 0) { // neighbor exists and not a physical boundary
+          if (nghbr.h_view(m,n).rank != global_variable::my_rank) {
+            int test;
+            int ierr = MPI_Test(&(rbuf[n].vars_req[m]), &test, MPI_STATUS_IGNORE);
+            if (ierr != MPI_SUCCESS) {no_errors=false;}
+            if (!(static_cast<bool>(test))) {
+              bflag = true;
+            }
+          }
+        }
+      }
+    }
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in testing non-blocking receives"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // exit if recv boundary buffer communications have not completed
+  if (bflag) {return TaskStatus::incomplete;}
+  if (!(aggregate_mpi)) {CopyRecvToDvce(false);}
+#endif
+
+  return TaskStatus::complete;
+}
@@ -186,48 +186,7 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
   }); // end par_for_outer
   }
 
-#if MPI_PARALLEL_ENABLED
-  // Send boundary buffer to neighboring MeshBlocks using MPI
-  Kokkos::fence();
-  int my_rank = global_variable::my_rank;
-  auto &nghbr = pmy_pack->pmb->nghbr;
-  bool no_errors=true;
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if (nghbr.h_view(m,n).gid >= 0) {  // neighbor exists and not a physical boundary
-        // index and rank of destination Neighbor
-        int dn = nghbr.h_view(m,n).dest;
-        int drank = nghbr.h_view(m,n).rank;
-        if (drank != my_rank) {
-          // create tag using local ID and buffer index of *receiving* MeshBlock
-          int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
-          int tag = CreateBvals_MPI_Tag(lid, dn);
-
-          // get ptr to send buffer when neighbor is at coarser/same/fine level
-          int data_size = 3;
-          if ( nghbr.h_view(m,n).lev < pmy_pack->pmb->mb_lev.h_view(m) ) {
-            data_size *= sendbuf[n].icoar_ndat;
-          } else if ( nghbr.h_view(m,n).lev == pmy_pack->pmb->mb_lev.h_view(m) ) {
-            data_size *= sendbuf[n].isame_ndat;
-          } else {
-            data_size *= sendbuf[n].ifine_ndat;
-          }
-          auto send_ptr = Kokkos::subview(sendbuf[n].vars, m, Kokkos::ALL);
-
-          int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
-                               comm_vars, &(sendbuf[n].vars_req[m]));
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
-        }
-      }
-    }
-  }
-  // Quit if MPI error detected
-  if (!(no_errors)) {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-       << std::endl << "MPI error in posting sends" << std::endl;
-    std::exit(EXIT_FAILURE);
-  }
-#endif
+  SendFC();
   return TaskStatus::complete;
 }
 
@@ -242,35 +201,8 @@ TaskStatus MeshBoundaryValuesFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b,
   int nnghbr = pmy_pack->pmb->nnghbr;
   auto &nghbr = pmy_pack->pmb->nghbr;
   auto &rbuf = recvbuf;
-#if MPI_PARALLEL_ENABLED
   //----- STEP 1: check that recv boundary buffer communications have all completed
-
-  bool bflag = false;
-  bool no_errors=true;
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if (nghbr.h_view(m,n).gid >= 0) { // ID != -1, so not a physical boundary
-        if (nghbr.h_view(m,n).rank != global_variable::my_rank) {
-          int test;
-          int ierr = MPI_Test(&(rbuf[n].vars_req[m]), &test, MPI_STATUS_IGNORE);
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
-          if (!(static_cast<bool>(test))) {
-            bflag = true;
-          }
-        }
-      }
-    }
-  }
-  // Quit if MPI error detected
-  if (!(no_errors)) {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl << "MPI error in testing non-blocking receives"
-              << std::endl;
-    std::exit(EXIT_FAILURE);
-  }
-  // exit if recv boundary buffer communications have not completed
-  if (bflag) {return TaskStatus::incomplete;}
-#endif
+  if (!(RecvFC())) {return TaskStatus::incomplete;}
 
   //----- STEP 2: buffers have all completed, so unpack 3-components of field
 
@@ -363,3 +295,112 @@ TaskStatus MeshBoundaryValuesFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b,
 
   return TaskStatus::complete;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesFC::SendFC()
+//! \brief Sends packed boundary buffers to neighbors on other ranks (with MPI).  Called
+//! by PackAndSendFC() and PackAndSendUB() after packing kernel.
+
+void MeshBoundaryValuesFC::SendFC() {
+#if MPI_PARALLEL_ENABLED
+  // Send boundary buffers in one message per neighboring rank
+  if (aggregate_mpi) {
+    SendAggregateMsgs();
+    return;
+  }
+
+  // Send boundary buffer to neighboring MeshBlocks using MPI
+  CopySendToHost(false);
+  // wait only for packing kernels on the default execution space instance
+  DevExeSpace().fence();
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  int my_rank = global_variable::my_rank;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  bool no_errors=true;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid >= 0) {  // neighbor exists and not a physical boundary
+        // index and rank of destination Neighbor
+        int dn = nghbr.h_view(m,n).dest;
+        int drank = nghbr.h_view(m,n).rank;
+        if (drank != my_rank) {
+          // create tag using local ID and buffer index of *receiving* MeshBlock
+          int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
+          int tag = CreateBvals_MPI_Tag(lid, dn);
+
+          // get ptr to send buffer when neighbor is at coarser/same/fine level
+          int data_size = VarsSize(true, m, n, 3);
+          Real *send_ptr = sendbuf[n].VarsPtr(m, pmy_pack->pmesh->mpi_host_staging);
+
+          int ierr;
+          if (persistent_mpi) {
+            // persistent request built in InitRecv() with same tag and size
+            ierr = MPI_Start(&(sendbuf[n].vars_req[m]));
+          } else {
+            ierr = MPI_Isend(send_ptr, data_size, MPI_ATHENA_REAL, drank, tag,
+                             comm_vars, &(sendbuf[n].vars_req[m]));
+          }
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+          nmsg_sent++;
+          nbytes_sent += static_cast<std::uint64_t>(data_size)*sizeof(Real);
+        }
+      }
+    }
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in posting sends" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool MeshBoundaryValuesFC::RecvFC()
+//! \brief Tests whether boundary buffers from neighbors on other ranks (with MPI) have
+//! all arrived.  Returns true when they have (and always without MPI).  Called by
+//! RecvAndUnpackFC() and RecvAndUnpackUB() before unpacking kernel.
+
+bool MeshBoundaryValuesFC::RecvFC() {
+#if MPI_PARALLEL_ENABLED
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &rbuf = recvbuf;
+  bool bflag = false;
+  bool no_errors=true;
+  if (aggregate_mpi) {
+    // test messages from all neighboring ranks, and scatter them into buffers
+    bflag = !(RecvAggregateMsgs());
+  } else {
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if (nghbr.h_view(m,n).gid >= 0) { // ID != -1, so not a physical boundary
+          if (nghbr.h_view(m,n).rank != global_variable::my_rank) {
+            int test;
+            int ierr = MPI_Test(&(rbuf[n].vars_req[m]), &test, MPI_STATUS_IGNORE);
+            if (ierr != MPI_SUCCESS) {no_errors=false;}
+            if (!(static_cast<bool>(test))) {
+              bflag = true;
+            }
+          }
+        }
+      }
+    }
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in testing non-blocking receives"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // exit if recv boundary buffer communications have not completed
+  if (bflag) {return false;}
+  if (!(aggregate_mpi)) {CopyRecvToDvce(false);}
+#endif
+  return true;
+}
@@ -6,13 +6,14 @@
 //! \file bvals_part.cpp
 //! \brief
 
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <utility>
 #include <vector>
 #include <algorithm>
 #include <Kokkos_Core.hpp>
-#include <Kokkos_StdAlgorithms.hpp>
+#include <Kokkos_Sort.hpp>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -23,6 +24,18 @@
 #include "bvals.hpp"
 
 namespace particles {
+//----------------------------------------------------------------------------------------
+//! \fn void GrowView()
+//! \brief Reallocates 1D view v to hold at least n entries (with 25% slack) if it is too
+//! small.  Views are never shrunk, so in steady state no allocations are performed.
+
+template <typename ViewType>
+void GrowView(ViewType &v, int n) {
+  if (v.extent_int(0) < n) {
+    Kokkos::realloc(v, n + n/4);
+  }
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void ParticlesBoundaryValues::UpdateGID()
 //! \brief Updates GID of particles that cross boundary of their parent MeshBlock.  If
@@ -31,14 +44,16 @@ namespace particles {
 
 KOKKOS_INLINE_FUNCTION
 void UpdateGID(int &newgid, NeighborBlock nghbr, int myrank, int *pcounter,
-               DualArray1D<ParticleLocationData> slist, int p) {
+               DvceArray1D<ParticleLocationData> slist, int p) {
   newgid = nghbr.gid;
 #if MPI_PARALLEL_ENABLED
   if (nghbr.rank != myrank) {
     int index = Kokkos::atomic_fetch_add(pcounter,1);
-    slist.d_view(index).prtcl_indx = p;
-    slist.d_view(index).dest_gid   = nghbr.gid;
-    slist.d_view(index).dest_rank  = nghbr.rank;
+    if (index < slist.extent_int(0)) {
+      slist(index).prtcl_indx = p;
+      slist(index).dest_gid   = nghbr.gid;
+      slist(index).dest_rank  = nghbr.rank;
+    }
   }
 #endif
   return;
@@ -59,13 +74,16 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
   auto &meshsize = pmy_part->pmy_pack->pmesh->mesh_size;
   auto myrank = global_variable::my_rank;
   auto &nghbr = pmy_part->pmy_pack->pmb->nghbr;
-  auto &psendl = sendlist;
-  int counter=0;
-  int *pcounter = &counter;
+  // counter of particles to send lives on the device
+  Kokkos::deep_copy(send_counter, 0);
+  int *pcounter = send_counter.data();
   bool &multi_d = pmy_part->pmy_pack->pmesh->multi_d;
   bool &three_d = pmy_part->pmy_pack->pmesh->three_d;
 
-  Kokkos::realloc(sendlist, static_cast<int>(0.1*npart));
+  // Guess that no more than 10% of particles leave this rank on first call.  The capacity
+  // of sendlist is kept between calls, and only grown when it overflows.
+  GrowView(sendlist, static_cast<int>(0.1*npart));
+  auto &psendl = sendlist;
   par_for("part_update",DevExeSpace(),0,(npart-1), KOKKOS_LAMBDA(const int p) {
     int m = pi(PGID,p) - gids;
     int mylevel = mblev.d_view(m);
@@ -170,11 +188,33 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
       }
     }
   });
-  nprtcl_send = counter;
-  Kokkos::resize(sendlist, nprtcl_send);
-  // sync sendlist device array with host
-  sendlist.template modify<DevExeSpace>();
-  sendlist.template sync<HostMemSpace>();
+  Kokkos::deep_copy(nprtcl_send, Kokkos::subview(send_counter, 0));
+
+#if MPI_PARALLEL_ENABLED
+  // If sendlist overflowed, grow it and rebuild it from the (already updated) GIDs of
+  // particles that no longer belong to a MeshBlock in this pack.
+  if (nprtcl_send > sendlist.extent_int(0)) {
+    GrowView(sendlist, nprtcl_send);
+    Mesh *pm = pmy_part->pmy_pack->pmesh;
+    HostArray1D<int> rank_h("rank_eachmb", pm->nmb_total);
+    for (int n=0; n<pm->nmb_total; ++n) {
+      rank_h(n) = pm->rank_eachmb[n];
+    }
+    auto rank_eachmb = Kokkos::create_mirror_view_and_copy(DevExeSpace(), rank_h);
+    int gide = pmy_part->pmy_pack->gide;
+    Kokkos::deep_copy(send_counter, 0);
+    auto &slist = sendlist;
+    par_for("part_sendlist",DevExeSpace(),0,(npart-1), KOKKOS_LAMBDA(const int p) {
+      int gid = pi(PGID,p);
+      if (gid < gids || gid > gide) {
+        int index = Kokkos::atomic_fetch_add(pcounter,1);
+        slist(index).prtcl_indx = p;
+        slist(index).dest_gid   = gid;
+        slist(index).dest_rank  = rank_eachmb(gid);
+      }
+    });
+  }
+#endif
 
   return TaskStatus::complete;
 }
@@ -185,63 +225,110 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
 
 TaskStatus ParticlesBoundaryValues::CountSendsAndRecvs() {
 #if MPI_PARALLEL_ENABLED
-  // Sort sendlist on host by destrank.
-  namespace KE = Kokkos::Experimental;
-  std::sort(KE::begin(sendlist.h_view), KE::end(sendlist.h_view), SortByRank);
-  // sync sendlist host array with device.  This results in sorted array on device
-  sendlist.template modify<HostMemSpace>();
-  sendlist.template sync<DevExeSpace>();
+  CountSends();
+
+  // Exchange number of particles with ranks owning neighboring MeshBlocks only, since
+  // particles can only move to neighbors.  This replaces global collectives over all
+  // ranks, so cost per rank is independent of the number of ranks.
+  int &myrank = global_variable::my_rank;
+  SetNeighborComm();
+  int ndests = static_cast<int>(nghbr_dests.size());
+  int nsrcs = static_cast<int>(nghbr_srcs.size());
+  std::vector<int> nsend_nghbr(std::max(1, ndests)), nrecv_nghbr(std::max(1, nsrcs));
+  for (int n=0; n<ndests; ++n) {
+    nsend_nghbr[n] = nprtcl_rank.h_view(nghbr_dests[n]);
+  }
+  MPI_Neighbor_alltoall(nsend_nghbr.data(), 1, MPI_INT, nrecv_nghbr.data(), 1, MPI_INT,
+                        mpi_comm_nghbr);
 
-  // load STL::vector of ParticleMessageData with <sendrank, recvrank, nprtcls> for sends
-  // from this rank. Length will be nsends; initially this length is unknown
-  sends_thisrank.clear();
+  // load STL::vector of ParticleMessageData with <sendrank,recvrank,nprtcl_recv> for
+  // receives on this rank
+  recvs_thisrank.clear();
+  for (int n=0; n<nsrcs; ++n) {
+    if (nrecv_nghbr[n] > 0) {
+      recvs_thisrank.emplace_back(ParticleMessageData(nghbr_srcs[n],myrank,
+                                                      nrecv_nghbr[n]));
+    }
+  }
+#endif
+  return TaskStatus::complete;
+}
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::CountSends()
+//! \brief sorts sendlist by destination rank, and counts particles sent to each rank
+
+void ParticlesBoundaryValues::CountSends() {
+  // Sort sendlist on device by destrank.
+  SortSendList(true);
+
+  // count particles sent to each rank on device, only the counts are copied to host
+  Kokkos::deep_copy(nprtcl_rank.d_view, 0);
   if (nprtcl_send > 0) {
-    int &myrank = global_variable::my_rank;
-    int rank = sendlist.h_view(0).dest_rank;
-    int nprtcl = 1;
+    auto &slist = sendlist;
+    auto &count = nprtcl_rank;
+    par_for("pcount",DevExeSpace(),0,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
+      Kokkos::atomic_increment(&count.d_view(slist(n).dest_rank));
+    });
+  }
+  nprtcl_rank.template modify<DevExeSpace>();
+  nprtcl_rank.template sync<HostMemSpace>();
 
-    for (int n=1; n<nprtcl_send; ++n) {
-      if (sendlist.h_view(n).dest_rank == rank) {
-        ++nprtcl;
-      } else {
-        sends_thisrank.emplace_back(ParticleMessageData(myrank,rank,nprtcl));
-        rank = sendlist.h_view(n).dest_rank;
-        nprtcl = 1;
-      }
+  // load STL::vector of ParticleMessageData with <sendrank, recvrank, nprtcls> for sends
+  // from this rank, in the same (rank) order as sendlist. Length will be nsends.
+  sends_thisrank.clear();
+  int &myrank = global_variable::my_rank;
+  for (int rank=0; rank<global_variable::nranks; ++rank) {
+    if (nprtcl_rank.h_view(rank) > 0) {
+      sends_thisrank.emplace_back(ParticleMessageData(myrank,rank,
+                                                      nprtcl_rank.h_view(rank)));
     }
-    sends_thisrank.emplace_back(ParticleMessageData(myrank,rank,nprtcl));
   }
   nsends = sends_thisrank.size();
+}
 
-  // Share number of ranks to send to amongst all ranks
-  nsends_eachrank[global_variable::my_rank] = nsends;
-  MPI_Allgather(&nsends, 1, MPI_INT, nsends_eachrank.data(), 1, MPI_INT, mpi_comm_part);
-
-  // Now share ParticleMessageData amongst all ranks
-  // First create vector of starting indices in full vector
-  std::vector<int> nsends_displ;
-  nsends_displ.resize(global_variable::nranks);
-  nsends_displ[0] = 0;
-  for (int n=1; n<(global_variable::nranks); ++n) {
-    nsends_displ[n] = nsends_displ[n-1] + nsends_eachrank[n-1];
-  }
-  int nsends_allranks = nsends_displ[global_variable::nranks - 1] +
-                        nsends_eachrank[global_variable::nranks - 1];
-  // Load ParticleMessageData on this rank into full vector
-  sends_allranks.resize(nsends_allranks, ParticleMessageData(0,0,0));
-  for (int n=0; n<nsends_eachrank[global_variable::my_rank]; ++n) {
-    sends_allranks[n + nsends_displ[global_variable::my_rank]] = sends_thisrank[n];
-  }
-
-  // Share tuples using MPI derived data type for tuple of 3*int
-  MPI_Datatype mpi_ituple;
-  MPI_Type_contiguous(3, MPI_INT, &mpi_ituple);
-  MPI_Allgatherv(MPI_IN_PLACE, nsends_eachrank[global_variable::my_rank],
-                   mpi_ituple, sends_allranks.data(), nsends_eachrank.data(),
-                   nsends_displ.data(), mpi_ituple, mpi_comm_part);
-#endif
-  return TaskStatus::complete;
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::SetNeighborComm()
+//! \brief (re)builds the distributed graph communicator whose out-edges are the ranks
+//! owning neighbors of MeshBlocks on this rank.  In-edges are computed by MPI, so the
+//! graph need not be symmetric.  Only rebuilt when the Mesh changes.
+
+void ParticlesBoundaryValues::SetNeighborComm() {
+  Mesh *pm = pmy_part->pmy_pack->pmesh;
+  if (mpi_comm_nghbr != MPI_COMM_NULL && nghbr_generation == pm->ngeneration) return;
+  if (mpi_comm_nghbr != MPI_COMM_NULL) {MPI_Comm_free(&mpi_comm_nghbr);}
+
+  int &myrank = global_variable::my_rank;
+  int nmb = pmy_part->pmy_pack->nmb_thispack;
+  int nnghbr = pmy_part->pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_part->pmy_pack->pmb->nghbr;
+  nghbr_dests.clear();
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid >= 0 && nghbr.h_view(m,n).rank != myrank) {
+        nghbr_dests.push_back(nghbr.h_view(m,n).rank);
+      }
+    }
+  }
+  std::sort(nghbr_dests.begin(), nghbr_dests.end());
+  nghbr_dests.erase(std::unique(nghbr_dests.begin(), nghbr_dests.end()),
+                    nghbr_dests.end());
+
+  int ndests = static_cast<int>(nghbr_dests.size());
+  MPI_Dist_graph_create(mpi_comm_part, 1, &myrank, &ndests, nghbr_dests.data(),
+                        MPI_UNWEIGHTED, MPI_INFO_NULL, 0, &mpi_comm_nghbr);
+
+  // in-neighbors, and out-neighbors in the order used by neighborhood collectives
+  int nsrcs, nout, weighted;
+  MPI_Dist_graph_neighbors_count(mpi_comm_nghbr, &nsrcs, &nout, &weighted);
+  nghbr_srcs.resize(nsrcs);
+  nghbr_dests.resize(nout);
+  MPI_Dist_graph_neighbors(mpi_comm_nghbr, nsrcs, nghbr_srcs.data(), MPI_UNWEIGHTED,
+                           nout, nghbr_dests.data(), MPI_UNWEIGHTED);
+  nghbr_generation = pm->ngeneration;
 }
+#endif
 
 //----------------------------------------------------------------------------------------
 //! \fn void ParticlesBoundaryValues::InitPrtclRecv()
@@ -249,16 +336,7 @@ TaskStatus ParticlesBoundaryValues::CountSendsAndRecvs() {
 
 TaskStatus ParticlesBoundaryValues::InitPrtclRecv() {
 #if MPI_PARALLEL_ENABLED
-  // load STL::vector of ParticleMessageData with <sendrank,recvrank,nprtcl_recv> for
-  // receives // on this rank. Length will be nrecvs, initially this length is unknown
-  recvs_thisrank.clear();
-
-  int nsends_allranks = sends_allranks.size();
-  for (int n=0; n<nsends_allranks; ++n) {
-    if (sends_allranks[n].recvrank == global_variable::my_rank) {
-      recvs_thisrank.emplace_back(sends_allranks[n]);
-    }
-  }
+  // receives on this rank were found in CountSendsAndRecvs()
   nrecvs = recvs_thisrank.size();
 
   // Figure out how many particles will be received from all ranks
@@ -267,9 +345,17 @@ TaskStatus ParticlesBoundaryValues::InitPrtclRecv() {
     nprtcl_recv += recvs_thisrank[n].nprtcls;
   }
 
-  // Allocate receive buffer
-  Kokkos::realloc(prtcl_rrecvbuf, (pmy_part->nrdata)*nprtcl_recv);
-  Kokkos::realloc(prtcl_irecvbuf, (pmy_part->nidata)*nprtcl_recv);
+  // Grow receive buffer if needed
+  GrowView(prtcl_rrecvbuf, (pmy_part->nrdata)*nprtcl_recv);
+  GrowView(prtcl_irecvbuf, (pmy_part->nidata)*nprtcl_recv);
+  // receive into host copies of buffers if MPI messages are staged through host
+  bool staged = pmy_part->pmy_pack->pmesh->mpi_host_staging;
+  if (staged) {
+    GrowView(prtcl_rrecvbuf_h, (pmy_part->nrdata)*nprtcl_recv);
+    GrowView(prtcl_irecvbuf_h, (pmy_part->nidata)*nprtcl_recv);
+  }
+  Real *rrecv_ptr = (staged)? prtcl_rrecvbuf_h.data() : prtcl_rrecvbuf.data();
+  int *irecv_ptr = (staged)? prtcl_irecvbuf_h.data() : prtcl_irecvbuf.data();
 
   // Post non-blocking receives
   bool no_errors=true;
@@ -285,13 +371,11 @@ TaskStatus ParticlesBoundaryValues::InitPrtclRecv() {
   for (int n=0; n<nrecvs; ++n) {
     // calculate amount of data to be passed, get pointer to variables
     int data_size = (pmy_part->nrdata)*(recvs_thisrank[n].nprtcls);
-    int data_end = data_start + (pmy_part->nrdata)*(recvs_thisrank[n].nprtcls - 1);
-    auto recv_ptr = Kokkos::subview(prtcl_rrecvbuf, std::make_pair(data_start, data_end));
     int drank = recvs_thisrank[n].sendrank;
     int tag = 0; // 0 for Reals, 1 for ints
 
     // Post non-blocking receive
-    int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+    int ierr = MPI_Irecv(rrecv_ptr + data_start, data_size, MPI_ATHENA_REAL, drank, tag,
                          mpi_comm_part, &(rrecv_req[n]));
     if (ierr != MPI_SUCCESS) {no_errors=false;}
     data_start += data_size;
@@ -301,13 +385,11 @@ TaskStatus ParticlesBoundaryValues::InitPrtclRecv() {
   for (int n=0; n<nrecvs; ++n) {
     // calculate amount of data to be passed, get pointer to variables
     int data_size = (pmy_part->nidata)*(recvs_thisrank[n].nprtcls);
-    int data_end = data_start + (pmy_part->nidata)*(recvs_thisrank[n].nprtcls - 1);
-    auto recv_ptr = Kokkos::subview(prtcl_irecvbuf, std::make_pair(data_start, data_end));
     int drank = recvs_thisrank[n].sendrank;
     int tag = 1; // 0 for Reals, 1 for ints
 
     // Post non-blocking receive
-    int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_INT, drank, tag,
+    int ierr = MPI_Irecv(irecv_ptr + data_start, data_size, MPI_INT, drank, tag,
                          mpi_comm_part, &(irecv_req[n]));
     if (ierr != MPI_SUCCESS) {no_errors=false;}
     data_start += data_size;
@@ -337,27 +419,14 @@ TaskStatus ParticlesBoundaryValues::PackAndSendPrtcls() {
 
   bool no_errors=true;
   if (nprtcl_send > 0) {
-    // Allocate send buffer
-    Kokkos::realloc(prtcl_rsendbuf, (pmy_part->nrdata)*nprtcl_send);
-    Kokkos::realloc(prtcl_isendbuf, (pmy_part->nidata)*nprtcl_send);
-
-    // sendlist on device is already sorted by destrank in CountSendAndRecvs()
-    // Use sendlist on device to load particles into send buffer ordered by dest_rank
+    // sendlist on device is already sorted by destrank in CountSendAndRecvs(), so
+    // particles are loaded into send buffers ordered by dest_rank
+    PackPrtcls();
     int nrdata = pmy_part->nrdata;
     int nidata = pmy_part->nidata;
-    auto &pr = pmy_part->prtcl_rdata;
-    auto &pi = pmy_part->prtcl_idata;
-    auto &rsendbuf = prtcl_rsendbuf;
-    auto &isendbuf = prtcl_isendbuf;
-    par_for("ppack",DevExeSpace(),0,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
-      int p = sendlist.d_view(n).prtcl_indx;
-      for (int i=0; i<nidata; ++i) {
-        isendbuf(nidata*n + i) = pi(i,p);
-      }
-      for (int i=0; i<nrdata; ++i) {
-        rsendbuf(nrdata*n + i) = pr(i,p);
-      }
-    });
+    bool staged = pmy_part->pmy_pack->pmesh->mpi_host_staging;
+    Real *rsend_ptr = (staged)? prtcl_rsendbuf_h.data() : prtcl_rsendbuf.data();
+    int *isend_ptr = (staged)? prtcl_isendbuf_h.data() : prtcl_isendbuf.data();
 
     // Post non-blocking sends
     Kokkos::fence();
@@ -373,13 +442,11 @@ TaskStatus ParticlesBoundaryValues::PackAndSendPrtcls() {
     for (int n=0; n<nsends; ++n) {
       // calculate amount of data to be passed, get pointer to variables
       int data_size = nrdata*(sends_thisrank[n].nprtcls);
-      int data_end = data_start + nrdata*(sends_thisrank[n].nprtcls - 1);
-      auto send_ptr = Kokkos::subview(prtcl_rsendbuf,std::make_pair(data_start,data_end));
       int drank = sends_thisrank[n].recvrank;
       int tag = 0; // 0 for Reals, 1 for ints
 
       // Post non-blocking sends
-      int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+      int ierr = MPI_Isend(rsend_ptr + data_start, data_size, MPI_ATHENA_REAL, drank, tag,
                            mpi_comm_part, &(rsend_req[n]));
       if (ierr != MPI_SUCCESS) {no_errors=false;}
       data_start += data_size;
@@ -389,13 +456,11 @@ TaskStatus ParticlesBoundaryValues::PackAndSendPrtcls() {
     for (int n=0; n<nsends; ++n) {
       // calculate amount of data to be passed, get pointer to variables
       int data_size = nidata*(sends_thisrank[n].nprtcls);
-      int data_end = data_start + nidata*(sends_thisrank[n].nprtcls - 1);
-      auto send_ptr = Kokkos::subview(prtcl_isendbuf,std::make_pair(data_start,data_end));
       int drank = sends_thisrank[n].recvrank;
       int tag = 1; // 0 for Reals, 1 for ints
 
       // Post non-blocking sends
-      int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_INT, drank, tag,
+      int ierr = MPI_Isend(isend_ptr + data_start, data_size, MPI_INT, drank, tag,
                            mpi_comm_part, &(isend_req[n]));
       if (ierr != MPI_SUCCESS) {no_errors=false;}
       data_start += data_size;
@@ -418,20 +483,6 @@ TaskStatus ParticlesBoundaryValues::PackAndSendPrtcls() {
 
 TaskStatus ParticlesBoundaryValues::RecvAndUnpackPrtcls() {
 #if MPI_PARALLEL_ENABLED
-  // Sort sendlist on host by index in particle array
-  namespace KE = Kokkos::Experimental;
-  std::sort(KE::begin(sendlist.h_view), KE::end(sendlist.h_view), SortByIndex);
-  // sync sendlist host array with device.  This results in sorted array on device
-  sendlist.template modify<HostMemSpace>();
-  sendlist.template sync<DevExeSpace>();
-
-  // increase size of particle arrays if needed
-  int new_npart = pmy_part->nprtcl_thispack + (nprtcl_recv - nprtcl_send);
-  if (nprtcl_recv > nprtcl_send) {
-    Kokkos::resize(pmy_part->prtcl_idata, pmy_part->nidata, new_npart);
-    Kokkos::resize(pmy_part->prtcl_rdata, pmy_part->nrdata, new_npart);
-  }
-
   // check that particle communications have all completed
   bool bflag = false;
   bool no_errors=true;
@@ -458,8 +509,77 @@ TaskStatus ParticlesBoundaryValues::RecvAndUnpackPrtcls() {
   // exit if particle communications have not completed
   if (bflag) {return TaskStatus::incomplete;}
 
+  UnpackPrtcls();
+#endif
+  return TaskStatus::complete;
+}
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::PackPrtcls()
+//! \brief loads the nprtcl_send particles in sendlist, in order, into the send buffers
+//! (and host copies of them if MPI messages are staged through host)
+
+void ParticlesBoundaryValues::PackPrtcls() {
+  if (nprtcl_send == 0) return;
+  // Grow send buffer if needed
+  GrowView(prtcl_rsendbuf, (pmy_part->nrdata)*nprtcl_send);
+  GrowView(prtcl_isendbuf, (pmy_part->nidata)*nprtcl_send);
+
+  int nrdata = pmy_part->nrdata;
+  int nidata = pmy_part->nidata;
+  auto &pr = pmy_part->prtcl_rdata;
+  auto &pi = pmy_part->prtcl_idata;
+  auto &rsendbuf = prtcl_rsendbuf;
+  auto &isendbuf = prtcl_isendbuf;
+  auto &slist = sendlist;
+  par_for("ppack",DevExeSpace(),0,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
+    int p = slist(n).prtcl_indx;
+    for (int i=0; i<nidata; ++i) {
+      isendbuf(nidata*n + i) = pi(i,p);
+    }
+    for (int i=0; i<nrdata; ++i) {
+      rsendbuf(nrdata*n + i) = pr(i,p);
+    }
+  });
+
+  // Copy send buffers to host if MPI messages are staged through host
+  if (pmy_part->pmy_pack->pmesh->mpi_host_staging) {
+    GrowView(prtcl_rsendbuf_h, nrdata*nprtcl_send);
+    GrowView(prtcl_isendbuf_h, nidata*nprtcl_send);
+    auto rrange = std::make_pair(0, nrdata*nprtcl_send);
+    auto irange = std::make_pair(0, nidata*nprtcl_send);
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(prtcl_rsendbuf_h, rrange),
+                      Kokkos::subview(prtcl_rsendbuf, rrange));
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(prtcl_isendbuf_h, irange),
+                      Kokkos::subview(prtcl_isendbuf, irange));
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::UnpackPrtcls()
+//! \brief unpacks the nprtcl_recv received particles into the holes left by the
+//! nprtcl_send sent particles (or at the end of the particle arrays), then compacts the
+//! arrays.  Receives must have completed.
+
+void ParticlesBoundaryValues::UnpackPrtcls() {
+  // Sort sendlist on device by index in particle array
+  SortSendList(false);
+
+  // increase capacity of particle arrays if needed
+  int new_npart = pmy_part->nprtcl_thispack + (nprtcl_recv - nprtcl_send);
+  pmy_part->ReserveParticles(new_npart);
+
   // unpack particles into positions of sent particles
   if (nprtcl_recv > 0) {
+    if (pmy_part->pmy_pack->pmesh->mpi_host_staging) {
+      auto rrange = std::make_pair(0, (pmy_part->nrdata)*nprtcl_recv);
+      auto irange = std::make_pair(0, (pmy_part->nidata)*nprtcl_recv);
+      Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(prtcl_rrecvbuf, rrange),
+                        Kokkos::subview(prtcl_rrecvbuf_h, rrange));
+      Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(prtcl_irecvbuf, irange),
+                        Kokkos::subview(prtcl_irecvbuf_h, irange));
+    }
     int nrdata = pmy_part->nrdata;
     int nidata = pmy_part->nidata;
     auto &pr = pmy_part->prtcl_rdata;
@@ -467,12 +587,14 @@ TaskStatus ParticlesBoundaryValues::RecvAndUnpackPrtcls() {
     auto &rrecvbuf = prtcl_rrecvbuf;
     auto &irecvbuf = prtcl_irecvbuf;
     int &npart = pmy_part->nprtcl_thispack;
+    int nsend = nprtcl_send;
+    auto &slist = sendlist;
     par_for("punpack",DevExeSpace(),0,(nprtcl_recv-1), KOKKOS_LAMBDA(const int n) {
       int p;
-      if (n < nprtcl_send) {
-        p = sendlist.d_view(n).prtcl_indx; // place particles in holes created by sends
+      if (n < nsend) {
+        p = slist(n).prtcl_indx;           // place particles in holes created by sends
       } else {
-        p = npart + (n - nprtcl_send);     // place particle at end of arrays
+        p = npart + (n - nsend);           // place particle at end of arrays
       }
       for (int i=0; i<nidata; ++i) {
         pi(i,p) = irecvbuf(nidata*n + i);
@@ -485,42 +607,284 @@ TaskStatus ParticlesBoundaryValues::RecvAndUnpackPrtcls() {
 
   // At this point have filled npart_recv holes in particle arrays from sends
   // If (nprtcl_recv < nprtcl_send), have to move particles from end of arrays to fill
-  // remaining holes
+  // remaining holes.  The remaining holes are sendlist(nprtcl_recv:nprtcl_send-1),
+  // sorted by index.  The particles in the last nremain slots of the arrays that are not
+  // holes are moved, in order, into the remaining holes below new_npart (there are
+  // exactly as many of each).  All of this is done on the device.
   int nremain = nprtcl_send - nprtcl_recv;
   if (nremain > 0) {
-    int &npart = pmy_part->nprtcl_thispack;
-    int i_last_hole = nprtcl_send-1;
-    int i_next_hole = nprtcl_recv;
-    for (int n=1; n<=nremain; ++n) {
-      int nend = npart-n;
-      if (nend > sendlist.h_view(i_last_hole).prtcl_indx) {
-        // copy particle from end into hole
-        int next_hole = sendlist.h_view(i_next_hole).prtcl_indx;
-        auto rdest = Kokkos::subview(pmy_part->prtcl_rdata, Kokkos::ALL, next_hole);
-        auto rsrc  = Kokkos::subview(pmy_part->prtcl_rdata, Kokkos::ALL, nend);
-        Kokkos::deep_copy(rdest, rsrc);
-        auto idest = Kokkos::subview(pmy_part->prtcl_idata, Kokkos::ALL, next_hole);
-        auto isrc  = Kokkos::subview(pmy_part->prtcl_idata, Kokkos::ALL, nend);
-        Kokkos::deep_copy(idest, isrc);
-        i_next_hole += 1;
-      } else {
-        // this index contains a hole, so do nothing except find new index of last hole
-        i_last_hole -= 1;
-      }
-    }
+    int nrdata = pmy_part->nrdata;
+    int nidata = pmy_part->nidata;
+    int nrecv = nprtcl_recv;
+    auto &pr = pmy_part->prtcl_rdata;
+    auto &pi = pmy_part->prtcl_idata;
+    auto &slist = sendlist;
+
+    // flag holes in the last nremain slots
+    GrowView(tail_hole, nremain);
+    GrowView(move_indx, nremain);
+    auto &hole = tail_hole;
+    auto &indx = move_indx;
+    Kokkos::deep_copy(Kokkos::subview(hole, std::make_pair(0, nremain)), 0);
+    par_for("pholes",DevExeSpace(),nrecv,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
+      int p = slist(n).prtcl_indx;
+      if (p >= new_npart) {hole(p - new_npart) = 1;}
+    });
+
+    // index of each particle to be moved among all particles to be moved
+    Kokkos::parallel_scan("pscan", Kokkos::RangePolicy<>(DevExeSpace(), 0, nremain),
+    KOKKOS_LAMBDA(const int i, int &sum, const bool final) {
+      if (final) {indx(i) = sum;}
+      sum += 1 - hole(i);
+    });
 
-    // shrink size of particle data arrays
-    Kokkos::resize(pmy_part->prtcl_idata, pmy_part->nidata, new_npart);
-    Kokkos::resize(pmy_part->prtcl_rdata, pmy_part->nrdata, new_npart);
+    // copy particles from end into holes
+    par_for("pfill",DevExeSpace(),0,(nremain-1), KOKKOS_LAMBDA(const int i) {
+      if (hole(i) == 0) {
+        int dest = slist(nrecv + indx(i)).prtcl_indx;
+        int src = new_npart + i;
+        for (int v=0; v<nidata; ++v) {
+          pi(v,dest) = pi(v,src);
+        }
+        for (int v=0; v<nrdata; ++v) {
+          pr(v,dest) = pr(v,src);
+        }
+      }
+    });
   }
+  // particle arrays keep their capacity, unless they are now mostly empty
+  pmy_part->ReserveParticles(new_npart, true);
 
   // Update nparticles_thisrank.  Update cost array (use npart_thismb[nmb]?)
   pmy_part->nprtcl_thispack = new_npart;
   pmy_part->pmy_pack->pmesh->nprtcl_thisrank = new_npart;
   MPI_Allgather(&new_npart,1,MPI_INT,(pmy_part->pmy_pack->pmesh->nprtcl_eachrank),1,
                 MPI_INT,MPI_COMM_WORLD);
+}
 #endif
-  return TaskStatus::complete;
+
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::SetNewMeshPrtclGID()
+//! \brief Sets GID of all particles to that of the MeshBlock containing them in the new
+//! Mesh created by MeshRefinement::RedistAndRefineMeshBlocks(), and stores particles that
+//! move to other ranks with their MeshBlock in sendlist.  Must be called while the old
+//! MeshBlocks (sizes and GIDs) are still stored in the MeshBlockPack.  oldtonew maps old
+//! to new GIDs (to the first child of refined MeshBlocks, whose children are in Z-order).
+
+void ParticlesBoundaryValues::SetNewMeshPrtclGID(const int *oldtonew,
+                                                 const int *new_rank_eachmb,
+                                                 int nmb_new,
+                                                 DualArray1D<int> &refine_flag) {
+  Mesh *pm = pmy_part->pmy_pack->pmesh;
+  int nmb_old = pm->nmb_total;
+
+  DualArray1D<int> old_to_new("oldtonew", nmb_old);
+  DualArray1D<int> new_rank("new_rank", nmb_new);
+  for (int m=0; m<nmb_old; ++m) {old_to_new.h_view(m) = oldtonew[m];}
+  for (int m=0; m<nmb_new; ++m) {new_rank.h_view(m) = new_rank_eachmb[m];}
+  old_to_new.template modify<HostMemSpace>();
+  old_to_new.template sync<DevExeSpace>();
+  new_rank.template modify<HostMemSpace>();
+  new_rank.template sync<DevExeSpace>();
+  refine_flag.template modify<HostMemSpace>();
+  refine_flag.template sync<DevExeSpace>();
+
+  int npart = pmy_part->nprtcl_thispack;
+  GrowView(sendlist, npart);
+  Kokkos::deep_copy(send_counter, 0);
+  int *pcounter = send_counter.data();
+  auto gids = pmy_part->pmy_pack->gids;
+  auto &pr = pmy_part->prtcl_rdata;
+  auto &pi = pmy_part->prtcl_idata;
+  auto &mbsize = pmy_part->pmy_pack->pmb->mb_size;
+  auto &rflag = refine_flag;
+  auto &slist = sendlist;
+  int myrank = global_variable::my_rank;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  par_for("part_newmesh",DevExeSpace(),0,(npart-1), KOKKOS_LAMBDA(const int p) {
+    int oldgid = pi(PGID,p);
+    int m = oldgid - gids;
+    int newgid = old_to_new.d_view(oldgid);
+    // particles in refined MeshBlocks go to the child containing them
+    if (rflag.d_view(oldgid) > 0) {
+      Real x1mid = 0.5*(mbsize.d_view(m).x1min + mbsize.d_view(m).x1max);
+      Real x2mid = 0.5*(mbsize.d_view(m).x2min + mbsize.d_view(m).x2max);
+      Real x3mid = 0.5*(mbsize.d_view(m).x3min + mbsize.d_view(m).x3max);
+      if (pr(IPX,p) >= x1mid) {newgid += 1;}
+      if (multi_d && pr(IPY,p) >= x2mid) {newgid += 2;}
+      if (three_d && pr(IPZ,p) >= x3mid) {newgid += 4;}
+    }
+    pi(PGID,p) = newgid;
+    int dest_rank = new_rank.d_view(newgid);
+    if (dest_rank != myrank) {
+      int index = Kokkos::atomic_fetch_add(pcounter,1);
+      slist(index).prtcl_indx = p;
+      slist(index).dest_gid   = newgid;
+      slist(index).dest_rank  = dest_rank;
+    }
+  });
+  Kokkos::deep_copy(nprtcl_send, Kokkos::subview(send_counter, 0));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::PackAndSendPrtclsAMR()
+//! \brief Sends particles listed in sendlist by SetNewMeshPrtclGID() along with the
+//! messages carrying their MeshBlocks during AMR/load balancing.  msgs lists the
+//! MeshBlock messages sent by this rank (receiving rank, MPI tag, and new GID of the
+//! MeshBlock), and each is accompanied by one message of particles with the same tag on
+//! the particle communicator (Reals, then ints).  All particles sent to one MeshBlock go
+//! with the first message to it; others (e.g. from the other leaves of a de-refined
+//! MeshBlock on this rank) carry no particles.
+
+void ParticlesBoundaryValues::PackAndSendPrtclsAMR(
+    std::vector<ParticleMessageData> &msgs) {
+#if MPI_PARALLEL_ENABLED
+  // sort sendlist by destination MeshBlock, and count particles sent to each MeshBlock
+  SortSendList(true);
+  int ngid = 1;
+  for (auto &msg : msgs) {ngid = std::max(ngid, msg.gid + 1);}
+  DualArray1D<int> nprtcl_gid("nprtcl_gid", ngid);
+  Kokkos::deep_copy(nprtcl_gid.d_view, 0);
+  if (nprtcl_send > 0) {
+    auto &slist = sendlist;
+    par_for("pcount_amr",DevExeSpace(),0,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
+      Kokkos::atomic_increment(&nprtcl_gid.d_view(slist(n).dest_gid));
+    });
+  }
+  nprtcl_gid.template modify<DevExeSpace>();
+  nprtcl_gid.template sync<HostMemSpace>();
+
+  // index in sorted sendlist of first particle sent to each MeshBlock
+  std::vector<int> first(ngid+1, 0);
+  for (int g=0; g<ngid; ++g) {
+    first[g+1] = first[g] + nprtcl_gid.h_view(g);
+  }
+  for (auto &msg : msgs) {
+    msg.nprtcls = nprtcl_gid.h_view(msg.gid);
+    nprtcl_gid.h_view(msg.gid) = 0;
+  }
+
+  PackPrtcls();
+  int nrdata = pmy_part->nrdata;
+  int nidata = pmy_part->nidata;
+  bool staged = pmy_part->pmy_pack->pmesh->mpi_host_staging;
+  Real *rsend_ptr = (staged)? prtcl_rsendbuf_h.data() : prtcl_rsendbuf.data();
+  int *isend_ptr = (staged)? prtcl_isendbuf_h.data() : prtcl_isendbuf.data();
+
+  // Post non-blocking sends.  Reals and ints share the tag of the MeshBlock message, and
+  // are matched in order by the receiver since MPI messages do not overtake each other.
+  Kokkos::fence();
+  sends_thisrank = msgs;
+  nsends = sends_thisrank.size();
+  rsend_req.assign(nsends, MPI_REQUEST_NULL);
+  isend_req.assign(nsends, MPI_REQUEST_NULL);
+  bool no_errors=true;
+  for (int n=0; n<nsends; ++n) {
+    int start = first[msgs[n].gid];
+    int ierr = MPI_Isend(rsend_ptr + nrdata*start, nrdata*msgs[n].nprtcls,
+                         MPI_ATHENA_REAL, msgs[n].recvrank, msgs[n].tag, mpi_comm_part,
+                         &(rsend_req[n]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    ierr = MPI_Isend(isend_ptr + nidata*start, nidata*msgs[n].nprtcls, MPI_INT,
+                     msgs[n].recvrank, msgs[n].tag, mpi_comm_part, &(isend_req[n]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+  }
+
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in posting non-blocking sends with AMR"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::RecvAndUnpackPrtclsAMR()
+//! \brief Receives particles sent with MeshBlocks by PackAndSendPrtclsAMR(), and unpacks
+//! them.  msgs lists the MeshBlock messages received by this rank (sending rank and MPI
+//! tag).  Number of particles in each message is found by probing.  Blocking, and
+//! collective over all ranks (must be called on every rank, even if msgs is empty).
+
+void ParticlesBoundaryValues::RecvAndUnpackPrtclsAMR(
+    std::vector<ParticleMessageData> &msgs) {
+#if MPI_PARALLEL_ENABLED
+  int nrdata = pmy_part->nrdata;
+  int nidata = pmy_part->nidata;
+  bool no_errors=true;
+  nprtcl_recv = 0;
+  for (auto &msg : msgs) {
+    MPI_Status status;
+    int ierr = MPI_Probe(msg.sendrank, msg.tag, mpi_comm_part, &status);
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    int cnt;
+    MPI_Get_count(&status, MPI_ATHENA_REAL, &cnt);
+    msg.nprtcls = cnt/nrdata;
+    nprtcl_recv += msg.nprtcls;
+  }
+
+  // Grow receive buffer if needed, receive into host copies if messages are staged
+  GrowView(prtcl_rrecvbuf, nrdata*nprtcl_recv);
+  GrowView(prtcl_irecvbuf, nidata*nprtcl_recv);
+  bool staged = pmy_part->pmy_pack->pmesh->mpi_host_staging;
+  if (staged) {
+    GrowView(prtcl_rrecvbuf_h, nrdata*nprtcl_recv);
+    GrowView(prtcl_irecvbuf_h, nidata*nprtcl_recv);
+  }
+  Real *rrecv_ptr = (staged)? prtcl_rrecvbuf_h.data() : prtcl_rrecvbuf.data();
+  int *irecv_ptr = (staged)? prtcl_irecvbuf_h.data() : prtcl_irecvbuf.data();
+
+  int data_start=0;
+  for (auto &msg : msgs) {
+    int ierr = MPI_Recv(rrecv_ptr + nrdata*data_start, nrdata*msg.nprtcls,
+                        MPI_ATHENA_REAL, msg.sendrank, msg.tag, mpi_comm_part,
+                        MPI_STATUS_IGNORE);
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    ierr = MPI_Recv(irecv_ptr + nidata*data_start, nidata*msg.nprtcls, MPI_INT,
+                    msg.sendrank, msg.tag, mpi_comm_part, MPI_STATUS_IGNORE);
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    data_start += msg.nprtcls;
+  }
+
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in receiving particles with AMR" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  recvs_thisrank = msgs;
+  nrecvs = 0;   // no outstanding receives
+  UnpackPrtcls();
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::SortSendList()
+//! \brief sorts sendlist on the device by destination MeshBlock (by_rank=true), and hence
+//! by destination rank since GIDs on each rank are contiguous, or by index in the
+//! particle arrays.  Entries are sorted by 64-bit keys (sort value, position in
+//! sendlist), so that the order within each MeshBlock is deterministic, then gathered.
+
+void ParticlesBoundaryValues::SortSendList(bool by_rank) {
+  if (nprtcl_send < 2) return;
+  GrowView(sort_keys, nprtcl_send);
+  GrowView(sendlist_tmp, nprtcl_send);
+  auto &slist = sendlist;
+  auto keys = Kokkos::subview(sort_keys, std::make_pair(0, nprtcl_send));
+  par_for("psort_keys",DevExeSpace(),0,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
+    std::int64_t key = (by_rank)? slist(n).dest_gid : slist(n).prtcl_indx;
+    keys(n) = (key << 32) | static_cast<std::int64_t>(n);
+  });
+  Kokkos::sort(keys);
+
+  auto &sorted = sendlist_tmp;
+  par_for("psort_gather",DevExeSpace(),0,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
+    sorted(n) = slist(static_cast<int>(keys(n) & 0xffffffff));
+  });
+  std::swap(sendlist, sendlist_tmp);
 }
 
 //----------------------------------------------------------------------------------------
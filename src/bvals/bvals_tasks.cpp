@@ -34,6 +34,40 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
   int &nnghbr = pmy_pack->pmb->nnghbr;
   auto &nghbr = pmy_pack->pmb->nghbr;
 
+  // With aggregated messages, rebuild offset tables if Mesh has changed since they were
+  // built, then post one receive per neighboring rank
+  if (aggregate_mpi) {
+    if ((comm_generation_ != pmy_pack->pmesh->ngeneration) || (comm_nvar_ != nvars)) {
+      InitAggregateMsgs(nvars);
+    }
+    PostAggregateRecvs();
+    return TaskStatus::complete;
+  }
+
+  // With persistent requests, (re)build them if Mesh has changed since they were built,
+  // then start all receives.  Sends are started in PackAndSendCC/FC().
+  if (persistent_mpi) {
+    if ((comm_generation_ != pmy_pack->pmesh->ngeneration) || (comm_nvar_ != nvars)) {
+      InitPersistentReqs(nvars);
+    }
+    bool no_errors=true;
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if ((nghbr.h_view(m,n).gid >= 0) &&
+            (nghbr.h_view(m,n).rank != global_variable::my_rank)) {
+          int ierr = MPI_Start(&(recvbuf[n].vars_req[m]));
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+        }
+      }
+    }
+    if (!(no_errors)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "MPI error in starting persistent receives" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    return TaskStatus::complete;
+  }
+
   // Initialize communications of variables
   bool no_errors=true;
   for (int m=0; m<nmb; ++m) {
@@ -48,22 +82,11 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
           int tag = CreateBvals_MPI_Tag(m, n);
 
           // calculate amount of data to be passed, get pointer to variables
-          int data_size = nvars;
-          if ( nghbr.h_view(m,n).lev < pmy_pack->pmb->mb_lev.h_view(m) ) {
-            data_size *= recvbuf[n].icoar_ndat;
-          } else if ( nghbr.h_view(m,n).lev == pmy_pack->pmb->mb_lev.h_view(m) ) {
-            if (is_z4c_) {
-              data_size *= recvbuf[n].isame_z4c_ndat;
-            } else {
-              data_size *= recvbuf[n].isame_ndat;
-            }
-          } else {
-            data_size *= recvbuf[n].ifine_ndat;
-          }
-          auto recv_ptr = Kokkos::subview(recvbuf[n].vars, m, Kokkos::ALL);
+          int data_size = VarsSize(false, m, n, nvars);
+          Real *recv_ptr = recvbuf[n].VarsPtr(m, pmy_pack->pmesh->mpi_host_staging);
 
           // Post non-blocking receive for this buffer on this MeshBlock
-          int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+          int ierr = MPI_Irecv(recv_ptr, data_size, MPI_ATHENA_REAL, drank, tag,
                                comm_vars, &(recvbuf[n].vars_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
         }
@@ -80,6 +103,163 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
   return TaskStatus::complete;
 }
 
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn  int MeshBoundaryValues::VarsSize
+//! \brief Returns number of values in send (send=true) or recv buffer n of MeshBlock m
+//! for nvars variables, which depends on level of neighbor.  Includes the variables of
+//! any BoundaryValues object combined with this one (see CombineWithCC()).
+
+int MeshBoundaryValues::VarsSize(bool send, int m, int n, int nvars) {
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &mblev = pmy_pack->pmb->mb_lev;
+  MeshBoundaryBuffer &buf = (send)? sendbuf[n] : recvbuf[n];
+  int size = nvars;
+  if (nghbr.h_view(m,n).lev < mblev.h_view(m)) {
+    size *= buf.icoar_ndat;
+  } else if (nghbr.h_view(m,n).lev == mblev.h_view(m)) {
+    size *= (is_z4c_)? buf.isame_z4c_ndat : buf.isame_ndat;
+  } else {
+    size *= buf.ifine_ndat;
+  }
+  if (pcomb_ != nullptr) {size += pcomb_->VarsSize(send, m, n, ncomb_);}
+  return size;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::CopySendToHost
+//! \brief With Mesh::mpi_host_staging, copies send buffers (vars, or fluxes if flux=true)
+//! of all MeshBlocks with neighbors on other ranks from device to host.  Copies are
+//! asynchronous on the default execution space instance, so they are queued behind
+//! the packing kernels, and must be followed by a fence before messages are sent.  Whole
+//! rows of each buffer are copied, which is simpler than copying only the data sent.
+
+void MeshBoundaryValues::CopySendToHost(bool flux) {
+  if (!(pmy_pack->pmesh->mpi_host_staging)) {return;}
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if ((nghbr.h_view(m,n).gid >= 0) &&
+          (nghbr.h_view(m,n).rank != global_variable::my_rank)) {
+        if (flux) {
+          auto dst = Kokkos::subview(sendbuf[n].flux_h, m, Kokkos::ALL);
+          auto src = Kokkos::subview(sendbuf[n].flux, m, Kokkos::ALL);
+          Kokkos::deep_copy(DevExeSpace(), dst, src);
+        } else {
+          auto dst = Kokkos::subview(sendbuf[n].vars_h, m, Kokkos::ALL);
+          auto src = Kokkos::subview(sendbuf[n].vars, m, Kokkos::ALL);
+          Kokkos::deep_copy(DevExeSpace(), dst, src);
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::CopyRecvToDvce
+//! \brief With Mesh::mpi_host_staging, copies receive buffers of all MeshBlocks with
+//! neighbors on other ranks from host to device.  Must only be called after all receives
+//! have completed.  Copies are queued ahead of the unpacking kernels on the execution
+//! space instance of the pack, so no fence is needed.
+
+void MeshBoundaryValues::CopyRecvToDvce(bool flux) {
+  if (!(pmy_pack->pmesh->mpi_host_staging)) {return;}
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if ((nghbr.h_view(m,n).gid >= 0) &&
+          (nghbr.h_view(m,n).rank != global_variable::my_rank)) {
+        if (flux) {
+          auto dst = Kokkos::subview(recvbuf[n].flux, m, Kokkos::ALL);
+          auto src = Kokkos::subview(recvbuf[n].flux_h, m, Kokkos::ALL);
+          Kokkos::deep_copy(DevExeSpace(), dst, src);
+        } else {
+          auto dst = Kokkos::subview(recvbuf[n].vars, m, Kokkos::ALL);
+          auto src = Kokkos::subview(recvbuf[n].vars_h, m, Kokkos::ALL);
+          Kokkos::deep_copy(DevExeSpace(), dst, src);
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::InitPersistentReqs
+//! \brief Creates persistent MPI requests (with MPI_Send_init/MPI_Recv_init) for the
+//! boundary communication of vars.  Tags, sizes, and buffers are the same as used by the
+//! non-blocking calls in InitRecv() and PackAndSendCC/FC().  Since message sizes depend
+//! on the levels of neighbors, requests must be rebuilt whenever the Mesh is refined or
+//! load balanced, which is signalled by a change in Mesh::ngeneration.  Must only be
+//! called when all previous communications of vars have been cleared.
+
+void MeshBoundaryValues::InitPersistentReqs(const int nvars) {
+  FreePersistentReqs();
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+
+  bool no_errors=true;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      int drank = nghbr.h_view(m,n).rank;
+      if ((nghbr.h_view(m,n).gid >= 0) && (drank != global_variable::my_rank)) {
+        // calculate amount of data to be passed in each direction
+        int send_size = VarsSize(true, m, n, nvars);
+        int recv_size = VarsSize(false, m, n, nvars);
+
+        // receive tag uses local ID and buffer index of this (receiving) MeshBlock
+        Real *recv_ptr = recvbuf[n].VarsPtr(m, pmy_pack->pmesh->mpi_host_staging);
+        int ierr = MPI_Recv_init(recv_ptr, recv_size, MPI_ATHENA_REAL, drank,
+                                 CreateBvals_MPI_Tag(m, n), comm_vars,
+                                 &(recvbuf[n].vars_req[m]));
+        if (ierr != MPI_SUCCESS) {no_errors=false;}
+
+        // send tag uses local ID and buffer index of *receiving* MeshBlock
+        int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
+        int dn = nghbr.h_view(m,n).dest;
+        Real *send_ptr = sendbuf[n].VarsPtr(m, pmy_pack->pmesh->mpi_host_staging);
+        ierr = MPI_Send_init(send_ptr, send_size, MPI_ATHENA_REAL, drank,
+                             CreateBvals_MPI_Tag(lid, dn), comm_vars,
+                             &(sendbuf[n].vars_req[m]));
+        if (ierr != MPI_SUCCESS) {no_errors=false;}
+      }
+    }
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in creating persistent requests" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  comm_generation_ = pmy_pack->pmesh->ngeneration;
+  comm_nvar_ = nvars;
+  preq_nmb_ = nmb;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::FreePersistentReqs
+//! \brief Frees any (inactive) persistent MPI requests created by InitPersistentReqs()
+
+void MeshBoundaryValues::FreePersistentReqs() {
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  for (int m=0; m<preq_nmb_; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (sendbuf[n].vars_req[m] != MPI_REQUEST_NULL) {
+        MPI_Request_free(&(sendbuf[n].vars_req[m]));
+      }
+      if (recvbuf[n].vars_req[m] != MPI_REQUEST_NULL) {
+        MPI_Request_free(&(recvbuf[n].vars_req[m]));
+      }
+    }
+  }
+  preq_nmb_ = 0;
+}
+#endif
+
 //----------------------------------------------------------------------------------------
 //! \fn  void MeshBoundaryValues::ClearRecv
 //! \brief Waits for all MPI receives associated with communcation of boundary variables
@@ -93,12 +273,19 @@ TaskStatus MeshBoundaryValues::ClearRecv() {
   auto &nghbr = pmy_pack->pmb->nghbr;
 
   // wait for all non-blocking receives for vars to finish before continuing
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if ( (nghbr.h_view(m,n).gid >= 0) &&
-           (nghbr.h_view(m,n).rank != global_variable::my_rank) ) {
-        int ierr = MPI_Wait(&(recvbuf[n].vars_req[m]), MPI_STATUS_IGNORE);
-        if (ierr != MPI_SUCCESS) {no_errors=false;}
+  if (aggregate_mpi) {
+    int nmsg = static_cast<int>(agg_recv.req.size());
+    if (MPI_Waitall(nmsg, agg_recv.req.data(), MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
+      no_errors=false;
+    }
+  } else {
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if ( (nghbr.h_view(m,n).gid >= 0) &&
+             (nghbr.h_view(m,n).rank != global_variable::my_rank) ) {
+          int ierr = MPI_Wait(&(recvbuf[n].vars_req[m]), MPI_STATUS_IGNORE);
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+        }
       }
     }
   }
@@ -125,12 +312,22 @@ TaskStatus MeshBoundaryValues::ClearSend() {
   auto &nghbr = pmy_pack->pmb->nghbr;
 
   // wait for all non-blocking sends for vars to finish before continuing
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if ( (nghbr.h_view(m,n).gid >= 0) &&
-           (nghbr.h_view(m,n).rank != global_variable::my_rank) ) {
-        int ierr = MPI_Wait(&(sendbuf[n].vars_req[m]), MPI_STATUS_IGNORE);
-        if (ierr != MPI_SUCCESS) {no_errors=false;}
+  if (aggregate_mpi) {
+    int nmsg = static_cast<int>(agg_send.req.size());
+    if (MPI_Waitall(nmsg, agg_send.req.data(), MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
+      no_errors=false;
+    }
+    // then wait for receivers on this node to read data from shared window (only after
+    // sends with MPI have completed, so that they can progress)
+    if (shm_win_ != MPI_WIN_NULL) {WaitShmConsumed();}
+  } else {
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if ( (nghbr.h_view(m,n).gid >= 0) &&
+             (nghbr.h_view(m,n).rank != global_variable::my_rank) ) {
+          int ierr = MPI_Wait(&(sendbuf[n].vars_req[m]), MPI_STATUS_IGNORE);
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+        }
       }
     }
   }
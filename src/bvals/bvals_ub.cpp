@@ -0,0 +1,313 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file bvals_ub.cpp
+//! \brief functions to pack/send and recv/unpack boundary values of cell-centered
+//! variables (e.g. conserved variables of MHD) together with face-centered fields, in
+//! one buffer per neighbor.  Enabled in MHD with <mhd>/combined_ub=true.
+//!
+//! The buffers of the MeshBoundaryValuesFC object are enlarged to hold the CC variables
+//! after the three field components, so that a buffer n for MeshBlock m contains:
+//!   [0, 3*ndat_fc)                      -> x1f, x2f, x3f (as in PackAndSendFC())
+//!   [3*ndat_fc, 3*ndat_fc+nvar*ndat_cc) -> CC variables (as in PackAndSendCC())
+//! where ndat_fc/ndat_cc are the buffer sizes for the level of the neighbor.  Index
+//! ranges for the CC variables are taken from the buffers of the MeshBoundaryValuesCC
+//! object, which are otherwise unused.  All MPI communication (including sizes of
+//! messages, see VarsSize()) is handled by the FC object.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesFC::CombineWithCC()
+//! \brief Enlarges buffers of this FC object so they also hold nvar variables of the CC
+//! object pcc.  Must be called after InitializeBuffers() of both objects.  The coarse
+//! data appended to same-level buffers with Z4c is not supported, so pcc must not be a
+//! Z4c object.
+
+void MeshBoundaryValuesFC::CombineWithCC(MeshBoundaryValuesCC *pcc, int nvar) {
+  pcomb_ = pcc;
+  ncomb_ = nvar;
+  int nmb = std::max((pmy_pack->nmb_thispack), (pmy_pack->pmesh->nmb_maxperrank));
+  for (int n=0; n<pmy_pack->pmb->nnghbr; ++n) {
+    int nsend = sendbuf[n].vars.extent_int(1) + pcc->sendbuf[n].vars.extent_int(1);
+    int nrecv = recvbuf[n].vars.extent_int(1) + pcc->recvbuf[n].vars.extent_int(1);
+    Kokkos::realloc(sendbuf[n].vars, nmb, nsend);
+    Kokkos::realloc(recvbuf[n].vars, nmb, nrecv);
+#if MPI_PARALLEL_ENABLED
+    if (pmy_pack->pmesh->mpi_host_staging) {
+      Kokkos::realloc(sendbuf[n].vars_h, nmb, nsend);
+      Kokkos::realloc(recvbuf[n].vars_h, nmb, nrecv);
+    }
+#endif
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesFC::PackAndSendUB()
+//! \brief Packs face-centered fields b (or cb) and cell-centered variables u (or cu) into
+//! boundary buffers with a single kernel, and sends them to neighbors.
+//!
+//! The outer loop is over (# of MeshBlocks)*(3 + (# of buffers)*(# of CC variables)).
+//! The first three teams of each MeshBlock pack one field component each, with a scalar
+//! loop over neighbors as in PackAndSendFC().  The remaining teams each pack one CC
+//! variable into one buffer, as in PackAndSendCC().
+
+TaskStatus MeshBoundaryValuesFC::PackAndSendUB(DvceArray5D<Real> &u,
+                                               DvceArray5D<Real> &cu,
+                                               DvceFaceFld4D<Real> &b,
+                                               DvceFaceFld4D<Real> &cb) {
+  // create local references for variables in kernel
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  int nvar = ncomb_;
+
+  {int my_rank = global_variable::my_rank;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &mbgid = pmy_pack->pmb->mb_gid;
+  auto &mblev = pmy_pack->pmb->mb_lev;
+  auto &sbuf = sendbuf;
+  auto &rbuf = recvbuf;
+  auto &csbuf = pcomb_->sendbuf;
+  const int nteam = 3 + nnghbr*nvar;
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nteam), Kokkos::AUTO);
+  Kokkos::parallel_for("SendBuffUB", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int m = tmember.league_rank()/nteam;
+    const int t = tmember.league_rank() - m*nteam;
+
+    // pack one component of face-centered field for all neighbors
+    if (t < 3) {
+      const int v = t;
+      for (int n=0; n<nnghbr; ++n) {
+        if (nghbr.d_view(m,n).gid >= 0) {
+          int il, iu, jl, ju, kl, ku, ndat;
+          if (nghbr.d_view(m,n).lev < mblev.d_view(m)) {
+            il = sbuf[n].icoar[v].bis; iu = sbuf[n].icoar[v].bie;
+            jl = sbuf[n].icoar[v].bjs; ju = sbuf[n].icoar[v].bje;
+            kl = sbuf[n].icoar[v].bks; ku = sbuf[n].icoar[v].bke;
+            ndat = sbuf[n].icoar_ndat;
+          } else if (nghbr.d_view(m,n).lev == mblev.d_view(m)) {
+            il = sbuf[n].isame[v].bis; iu = sbuf[n].isame[v].bie;
+            jl = sbuf[n].isame[v].bjs; ju = sbuf[n].isame[v].bje;
+            kl = sbuf[n].isame[v].bks; ku = sbuf[n].isame[v].bke;
+            ndat = sbuf[n].isame_ndat;
+          } else {
+            il = sbuf[n].ifine[v].bis; iu = sbuf[n].ifine[v].bie;
+            jl = sbuf[n].ifine[v].bjs; ju = sbuf[n].ifine[v].bje;
+            kl = sbuf[n].ifine[v].bks; ku = sbuf[n].ifine[v].bke;
+            ndat = sbuf[n].ifine_ndat;
+          }
+          const int ni = iu - il + 1;
+          const int nj = ju - jl + 1;
+          const int nk = ku - kl + 1;
+          const int nkji = nk*nj*ni;
+          const int nji  = nj*ni;
+          const bool coarse = (nghbr.d_view(m,n).lev < mblev.d_view(m));
+          const DvceFaceFld4D<Real> &src = (coarse)? cb : b;
+
+          // copy directly into recv buffer if MeshBlocks on same rank
+          const bool local = (nghbr.d_view(m,n).rank == my_rank);
+          int dm = (local)? (nghbr.d_view(m,n).gid - mbgid.d_view(0)) : m;
+          int dn = (local)? nghbr.d_view(m,n).dest : n;
+          DvceArray2D<Real> buf = (local)? rbuf[dn].vars : sbuf[n].vars;
+          Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkji),
+          [&](const int idx) {
+            int k = (idx)/nji;
+            int j = (idx - k*nji)/ni;
+            int i = (idx - k*nji - j*ni) + il;
+            k += kl;
+            j += jl;
+            if (v==0) {
+              buf(dm,i-il + ni*(j-jl + nj*(k-kl))) = src.x1f(m,k,j,i);
+            } else if (v==1) {
+              buf(dm,ndat*v + i-il + ni*(j-jl + nj*(k-kl))) = src.x2f(m,k,j,i);
+            } else if (v==2) {
+              buf(dm,ndat*v + i-il + ni*(j-jl + nj*(k-kl))) = src.x3f(m,k,j,i);
+            }
+          });
+          tmember.team_barrier();
+        }
+      }
+
+    // pack one cell-centered variable into one buffer
+    } else {
+      const int n = (t - 3)/nvar;
+      const int v = (t - 3) - n*nvar;
+      if (nghbr.d_view(m,n).gid >= 0) {
+        int il, iu, jl, ju, kl, ku, offset;
+        if (nghbr.d_view(m,n).lev < mblev.d_view(m)) {
+          il = csbuf[n].icoar[0].bis; iu = csbuf[n].icoar[0].bie;
+          jl = csbuf[n].icoar[0].bjs; ju = csbuf[n].icoar[0].bje;
+          kl = csbuf[n].icoar[0].bks; ku = csbuf[n].icoar[0].bke;
+          offset = 3*sbuf[n].icoar_ndat;
+        } else if (nghbr.d_view(m,n).lev == mblev.d_view(m)) {
+          il = csbuf[n].isame[0].bis; iu = csbuf[n].isame[0].bie;
+          jl = csbuf[n].isame[0].bjs; ju = csbuf[n].isame[0].bje;
+          kl = csbuf[n].isame[0].bks; ku = csbuf[n].isame[0].bke;
+          offset = 3*sbuf[n].isame_ndat;
+        } else {
+          il = csbuf[n].ifine[0].bis; iu = csbuf[n].ifine[0].bie;
+          jl = csbuf[n].ifine[0].bjs; ju = csbuf[n].ifine[0].bje;
+          kl = csbuf[n].ifine[0].bks; ku = csbuf[n].ifine[0].bke;
+          offset = 3*sbuf[n].ifine_ndat;
+        }
+        const int ni = iu - il + 1;
+        const int nj = ju - jl + 1;
+        const int nk = ku - kl + 1;
+        const int nkj  = nk*nj;
+        const bool coarse = (nghbr.d_view(m,n).lev < mblev.d_view(m));
+        const DvceArray5D<Real> &src = (coarse)? cu : u;
+
+        // copy directly into recv buffer if MeshBlocks on same rank
+        const bool local = (nghbr.d_view(m,n).rank == my_rank);
+        int dm = (local)? (nghbr.d_view(m,n).gid - mbgid.d_view(0)) : m;
+        int dn = (local)? nghbr.d_view(m,n).dest : n;
+        DvceArray2D<Real> buf = (local)? rbuf[dn].vars : sbuf[n].vars;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj),
+        [&](const int idx) {
+          int k = idx / nj;
+          int j = (idx - k * nj) + jl;
+          k += kl;
+          Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+          [&](const int i) {
+            buf(dm, offset + (i-il + ni*(j-jl + nj*(k-kl + nk*v)))) = src(m,v,k,j,i);
+          });
+        });
+      }
+    }
+  }); // end par_for_outer
+  }
+
+  SendFC();
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesFC::RecvAndUnpackUB()
+//! \brief Unpacks face-centered fields and cell-centered variables from boundary buffers
+//! filled by PackAndSendUB(), with a single kernel organized as in PackAndSendUB().
+
+TaskStatus MeshBoundaryValuesFC::RecvAndUnpackUB(DvceArray5D<Real> &u,
+                                                 DvceArray5D<Real> &cu,
+                                                 DvceFaceFld4D<Real> &b,
+                                                 DvceFaceFld4D<Real> &cb) {
+  //----- STEP 1: check that recv boundary buffer communications have all completed
+  if (!(RecvFC())) {return TaskStatus::incomplete;}
+
+  //----- STEP 2: buffers have all completed, so unpack
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  int nvar = ncomb_;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &mblev = pmy_pack->pmb->mb_lev;
+  auto &rbuf = recvbuf;
+  auto &crbuf = pcomb_->recvbuf;
+  const int nteam = 3 + nnghbr*nvar;
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nteam), Kokkos::AUTO);
+  Kokkos::parallel_for("RecvBuffUB", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int m = tmember.league_rank()/nteam;
+    const int t = tmember.league_rank() - m*nteam;
+
+    // unpack one component of face-centered field for all neighbors.  Scalar loop over
+    // neighbors prevents race condition in overlapping assignments
+    if (t < 3) {
+      const int v = t;
+      for (int n=0; n<nnghbr; ++n) {
+        if (nghbr.d_view(m,n).gid >= 0) {
+          int il, iu, jl, ju, kl, ku, ndat;
+          if (nghbr.d_view(m,n).lev < mblev.d_view(m)) {
+            il = rbuf[n].icoar[v].bis; iu = rbuf[n].icoar[v].bie;
+            jl = rbuf[n].icoar[v].bjs; ju = rbuf[n].icoar[v].bje;
+            kl = rbuf[n].icoar[v].bks; ku = rbuf[n].icoar[v].bke;
+            ndat = rbuf[n].icoar_ndat;
+          } else if (nghbr.d_view(m,n).lev == mblev.d_view(m)) {
+            il = rbuf[n].isame[v].bis; iu = rbuf[n].isame[v].bie;
+            jl = rbuf[n].isame[v].bjs; ju = rbuf[n].isame[v].bje;
+            kl = rbuf[n].isame[v].bks; ku = rbuf[n].isame[v].bke;
+            ndat = rbuf[n].isame_ndat;
+          } else {
+            il = rbuf[n].ifine[v].bis; iu = rbuf[n].ifine[v].bie;
+            jl = rbuf[n].ifine[v].bjs; ju = rbuf[n].ifine[v].bje;
+            kl = rbuf[n].ifine[v].bks; ku = rbuf[n].ifine[v].bke;
+            ndat = rbuf[n].ifine_ndat;
+          }
+          const int ni = iu - il + 1;
+          const int nj = ju - jl + 1;
+          const int nk = ku - kl + 1;
+          const int nkji = nk*nj*ni;
+          const int nji  = nj*ni;
+          // if neighbor is at coarser level, load data into coarse_b0
+          const bool coarse = (nghbr.d_view(m,n).lev < mblev.d_view(m));
+          const DvceFaceFld4D<Real> &dst = (coarse)? cb : b;
+          Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkji),
+          [&](const int idx) {
+            int k = (idx)/nji;
+            int j = (idx - k*nji)/ni;
+            int i = (idx - k*nji - j*ni) + il;
+            k += kl;
+            j += jl;
+            if (v==0) {
+              dst.x1f(m,k,j,i) = rbuf[n].vars(m,i-il + ni*(j-jl + nj*(k-kl)));
+            } else if (v==1) {
+              dst.x2f(m,k,j,i) = rbuf[n].vars(m,ndat*v + i-il + ni*(j-jl + nj*(k-kl)));
+            } else if (v==2) {
+              dst.x3f(m,k,j,i) = rbuf[n].vars(m,ndat*v + i-il + ni*(j-jl + nj*(k-kl)));
+            }
+          });
+          tmember.team_barrier();
+        }
+      }
+
+    // unpack one cell-centered variable from one buffer
+    } else {
+      const int n = (t - 3)/nvar;
+      const int v = (t - 3) - n*nvar;
+      if (nghbr.d_view(m,n).gid >= 0) {
+        int il, iu, jl, ju, kl, ku, offset;
+        if (nghbr.d_view(m,n).lev < mblev.d_view(m)) {
+          il = crbuf[n].icoar[0].bis; iu = crbuf[n].icoar[0].bie;
+          jl = crbuf[n].icoar[0].bjs; ju = crbuf[n].icoar[0].bje;
+          kl = crbuf[n].icoar[0].bks; ku = crbuf[n].icoar[0].bke;
+          offset = 3*rbuf[n].icoar_ndat;
+        } else if (nghbr.d_view(m,n).lev == mblev.d_view(m)) {
+          il = crbuf[n].isame[0].bis; iu = crbuf[n].isame[0].bie;
+          jl = crbuf[n].isame[0].bjs; ju = crbuf[n].isame[0].bje;
+          kl = crbuf[n].isame[0].bks; ku = crbuf[n].isame[0].bke;
+          offset = 3*rbuf[n].isame_ndat;
+        } else {
+          il = crbuf[n].ifine[0].bis; iu = crbuf[n].ifine[0].bie;
+          jl = crbuf[n].ifine[0].bjs; ju = crbuf[n].ifine[0].bje;
+          kl = crbuf[n].ifine[0].bks; ku = crbuf[n].ifine[0].bke;
+          offset = 3*rbuf[n].ifine_ndat;
+        }
+        const int ni = iu - il + 1;
+        const int nj = ju - jl + 1;
+        const int nk = ku - kl + 1;
+        const int nkj  = nk*nj;
+        // if neighbor is at coarser level, load data into coarse_u0
+        const bool coarse = (nghbr.d_view(m,n).lev < mblev.d_view(m));
+        const DvceArray5D<Real> &dst = (coarse)? cu : u;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj),
+        [&](const int idx) {
+          int k = idx / nj;
+          int j = (idx - k * nj) + jl;
+          k += kl;
+          Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+          [&](const int i) {
+            dst(m,v,k,j,i) = rbuf[n].vars(m, offset + i-il + ni*(j-jl + nj*(k-kl+nk*v)));
+          });
+        });
+      }
+    }
+  });  // end par_for_outer
+
+  return TaskStatus::complete;
+}
@@ -44,13 +44,17 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
   auto &rbuf = recvbuf;
   auto &one_d = pmy_pack->pmesh->one_d;
   auto &two_d = pmy_pack->pmesh->two_d;
+  InitInterfaceLists();
+  auto &ilist = coar_list;
 
-  // Outer loop over (# of MeshBlocks)*(# of neighbors)*(# of variables)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
+  // Outer loop over (# of buffers with neighbor at coarser level)*(# of variables), since
+  // buffers are only packed when neighbor is at coarser level
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (ncoar_*nvar), Kokkos::AUTO);
   Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(nnghbr*nvar);
-    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
-    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+    const int l = (tmember.league_rank())/nvar;
+    const int v = (tmember.league_rank() - l*nvar);
+    const int m = ilist.d_view(l,0);
+    const int n = ilist.d_view(l,1);
 
     // Note send buffer flux indices are for the coarse mesh
     int il = sbuf[n].iflux_coar[0].bis;
@@ -71,93 +75,92 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
     int dm = nghbr.d_view(m,n).gid - mbgid.d_view(0);
     int dn = nghbr.d_view(m,n).dest;
 
-    // only pack buffers when neighbor is at coarser level
-    if ((nghbr.d_view(m,n).gid >=0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
-      // x1faces
-      if (n<8) {
-        // i-index is fixed for flux correction on x1faces
-        int fi = 2*il - cis;
-        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
-          int k = idx / nj;
-          int j = (idx - k * nj) + jl;
-          k += kl;
-          int fj = 2*j - cjs;
-          int fk = 2*k - cks;
-          Real rflx;
-          if (one_d) {
-            rflx = flx.x1f(m,v,0,0,fi);
-          } else if (two_d) {
-            rflx = 0.5*(flx.x1f(m,v,0,fj,fi) + flx.x1f(m,v,0,fj+1,fi));
-          } else {
-            rflx = 0.25*(flx.x1f(m,v,fk  ,fj,fi) + flx.x1f(m,v,fk  ,fj+1,fi) +
-                         flx.x1f(m,v,fk+1,fj,fi) + flx.x1f(m,v,fk+1,fj+1,fi));
-          }
-          // copy directly into recv buffer if MeshBlocks on same rank
-          if (nghbr.d_view(m,n).rank == my_rank) {
-            rbuf[dn].flux(dm, (j-jl + nj*(k-kl + nk*v)) ) = rflx;
-          // else copy into send buffer for MPI communication below
-          } else {
-            sbuf[n].flux(m, (j-jl + nj*(k-kl + nk*v)) ) = rflx;
-          }
-        });
-        tmember.team_barrier();
+    // x1faces
+    if (n<8) {
+      // i-index is fixed for flux correction on x1faces
+      int fi = 2*il - cis;
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
+        int k = idx / nj;
+        int j = (idx - k * nj) + jl;
+        k += kl;
+        int fj = 2*j - cjs;
+        int fk = 2*k - cks;
+        Real rflx;
+        if (one_d) {
+          rflx = flx.x1f(m,v,0,0,fi);
+        } else if (two_d) {
+          rflx = 0.5*(flx.x1f(m,v,0,fj,fi) + flx.x1f(m,v,0,fj+1,fi));
+        } else {
+          rflx = 0.25*(flx.x1f(m,v,fk  ,fj,fi) + flx.x1f(m,v,fk  ,fj+1,fi) +
+                       flx.x1f(m,v,fk+1,fj,fi) + flx.x1f(m,v,fk+1,fj+1,fi));
+        }
+        // copy directly into recv buffer if MeshBlocks on same rank
+        if (nghbr.d_view(m,n).rank == my_rank) {
+          rbuf[dn].flux(dm, (j-jl + nj*(k-kl + nk*v)) ) = rflx;
+        // else copy into send buffer for MPI communication below
+        } else {
+          sbuf[n].flux(m, (j-jl + nj*(k-kl + nk*v)) ) = rflx;
+        }
+      });
+      tmember.team_barrier();
 
-      // x2faces
-      } else if (n<16) {
-        // j-index is fixed for flux correction on x2faces
-        int fj = 2*jl - cjs;
-        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nki), [&](const int idx) {
-          int k = idx / ni;
-          int i = (idx - k * ni) + il;
-          k += kl;
-          int fi = 2*i - cis;
-          int fk = 2*k - cks;
-          Real rflx;
-          if (two_d) {
-            rflx = 0.5*(flx.x2f(m,v,0,fj,fi) + flx.x2f(m,v,0,fj,fi+1));
-          } else {
-            rflx = 0.25*(flx.x2f(m,v,fk  ,fj,fi) + flx.x2f(m,v,fk  ,fj,fi+1) +
-                         flx.x2f(m,v,fk+1,fj,fi) + flx.x2f(m,v,fk+1,fj,fi+1));
-          }
-          // copy directly into recv buffer if MeshBlocks on same rank
-          if (nghbr.d_view(m,n).rank == my_rank) {
-            rbuf[dn].flux(dm, (i-il + ni*(k-kl + nk*v)) ) = rflx;
-          // else copy into send buffer for MPI communication below
-          } else {
-            sbuf[n].flux(m, (i-il + ni*(k-kl + nk*v)) ) = rflx;
-          }
-        });
-        tmember.team_barrier();
+    // x2faces
+    } else if (n<16) {
+      // j-index is fixed for flux correction on x2faces
+      int fj = 2*jl - cjs;
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nki), [&](const int idx) {
+        int k = idx / ni;
+        int i = (idx - k * ni) + il;
+        k += kl;
+        int fi = 2*i - cis;
+        int fk = 2*k - cks;
+        Real rflx;
+        if (two_d) {
+          rflx = 0.5*(flx.x2f(m,v,0,fj,fi) + flx.x2f(m,v,0,fj,fi+1));
+        } else {
+          rflx = 0.25*(flx.x2f(m,v,fk  ,fj,fi) + flx.x2f(m,v,fk  ,fj,fi+1) +
+                       flx.x2f(m,v,fk+1,fj,fi) + flx.x2f(m,v,fk+1,fj,fi+1));
+        }
+        // copy directly into recv buffer if MeshBlocks on same rank
+        if (nghbr.d_view(m,n).rank == my_rank) {
+          rbuf[dn].flux(dm, (i-il + ni*(k-kl + nk*v)) ) = rflx;
+        // else copy into send buffer for MPI communication below
+        } else {
+          sbuf[n].flux(m, (i-il + ni*(k-kl + nk*v)) ) = rflx;
+        }
+      });
+      tmember.team_barrier();
 
-      // x3faces
-      } else if ((n>=24) && (n<32)) {
-        // k-index is fixed for flux correction on x3faces
-        int fk = 2*kl - cks;
-        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nji), [&](const int idx) {
-          int j = idx / ni;
-          int i = (idx - j * ni) + il;
-          j += jl;
-          int fi = 2*i - cis;
-          int fj = 2*j - cjs;
-          Real rflx = 0.25*(flx.x3f(m,v,fk,fj  ,fi) + flx.x3f(m,v,fk,fj  ,fi+1) +
-                            flx.x3f(m,v,fk,fj+1,fi) + flx.x3f(m,v,fk,fj+1,fi+1));
-          // copy directly into recv buffer if MeshBlocks on same rank
-          if (nghbr.d_view(m,n).rank == my_rank) {
-            rbuf[dn].flux(dm, (i-il + ni*(j-jl + nj*v)) ) = rflx;
-          // else copy into send buffer for MPI communication below
-          } else {
-            sbuf[n].flux(m, (i-il + ni*(j-jl + nj*v)) ) = rflx;
-          }
-        });
-        tmember.team_barrier();
-      }
-    }  // end if-neighbor-exists block
+    // x3faces
+    } else if ((n>=24) && (n<32)) {
+      // k-index is fixed for flux correction on x3faces
+      int fk = 2*kl - cks;
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nji), [&](const int idx) {
+        int j = idx / ni;
+        int i = (idx - j * ni) + il;
+        j += jl;
+        int fi = 2*i - cis;
+        int fj = 2*j - cjs;
+        Real rflx = 0.25*(flx.x3f(m,v,fk,fj  ,fi) + flx.x3f(m,v,fk,fj  ,fi+1) +
+                          flx.x3f(m,v,fk,fj+1,fi) + flx.x3f(m,v,fk,fj+1,fi+1));
+        // copy directly into recv buffer if MeshBlocks on same rank
+        if (nghbr.d_view(m,n).rank == my_rank) {
+          rbuf[dn].flux(dm, (i-il + ni*(j-jl + nj*v)) ) = rflx;
+        // else copy into send buffer for MPI communication below
+        } else {
+          sbuf[n].flux(m, (i-il + ni*(j-jl + nj*v)) ) = rflx;
+        }
+      });
+      tmember.team_barrier();
+    }
   });  // end par_for_outer
 
 #if MPI_PARALLEL_ENABLED
   // Send boundary buffer to neighboring MeshBlocks using MPI
   // Sends only occur to neighbors on FACES at a COARSER level
-  Kokkos::fence();
+  CopySendToHost(true);
+  // wait only for packing kernels on the default execution space instance
+  DevExeSpace().fence();
   bool no_errors=true;
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<nnghbr; ++n) {
@@ -175,11 +178,13 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
 
           // get ptr to send buffer for fluxes
           int data_size = nvar*(sendbuf[n].iflxc_ndat);
-          auto send_ptr = Kokkos::subview(sendbuf[n].flux, m, Kokkos::ALL);
+          Real *send_ptr = sendbuf[n].FluxPtr(m, pmy_pack->pmesh->mpi_host_staging);
 
-          int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+          int ierr = MPI_Isend(send_ptr, data_size, MPI_ATHENA_REAL, drank, tag,
                                comm_flux, &(sendbuf[n].flux_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          nmsg_sent++;
+          nbytes_sent += static_cast<std::uint64_t>(data_size)*sizeof(Real);
         }
       }
     }
@@ -236,18 +241,23 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
   }
   // exit if recv boundary buffer communications have not completed
   if (bflag) {return TaskStatus::incomplete;}
+  CopyRecvToDvce(true);
 #endif
 
   //----- STEP 2: buffers have all completed, so unpack
 
   int nvar = flx.x1f.extent_int(1); // TODO(@user): 2nd idx from L of in arr must be NVAR
+  InitInterfaceLists();
+  auto &ilist = fine_list;
 
-  // Outer loop over (# of MeshBlocks)*(# of neighbors)*(# of variables)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
+  // Outer loop over (# of buffers with neighbor at finer level)*(# of variables), since
+  // buffers are only unpacked for faces when neighbor is at finer level
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nfine_*nvar), Kokkos::AUTO);
   Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(nnghbr*nvar);
-    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
-    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+    const int l = (tmember.league_rank())/nvar;
+    const int v = (tmember.league_rank() - l*nvar);
+    const int m = ilist.d_view(l,0);
+    const int n = ilist.d_view(l,1);
 
     // Recv buffer flux indices are for the regular mesh
     int il = rbuf[n].iflux_coar[0].bis;
@@ -263,37 +273,34 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
     const int nkj  = nk*nj;
     const int nki  = nk*ni;
 
-    // only unpack buffers for faces when neighbor is at finer level
-    if ((nghbr.d_view(m,n).gid >=0) && (nghbr.d_view(m,n).lev > mblev.d_view(m))) {
-      //x1 faces
-      if (n<8) {
-        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
-          int k = idx / nj;
-          int j = (idx - k * nj) + jl;
-          k += kl;
-          flx.x1f(m,v,k,j,il) = rbuf[n].flux(m,(j-jl + nj*(k-kl + nk*v)));
-        });
-        tmember.team_barrier();
-      // x2faces
-      } else if (n<16) {
-        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nki), [&](const int idx) {
-          int k = idx / ni;
-          int i = (idx - k * ni) + il;
-          k += kl;
-          flx.x2f(m,v,k,jl,i) = rbuf[n].flux(m,(i-il + ni*(k-kl + nk*v)));
-        });
-        tmember.team_barrier();
-      // x3faces
-      } else if ((n>=24) && (n<32)) {
-        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nji), [&](const int idx) {
-          int j = idx / ni;
-          int i = (idx - j * ni) + il;
-          j += jl;
-          flx.x3f(m,v,kl,j,i) = rbuf[n].flux(m,(i-il + ni*(j-jl + nj*v)));
-        });
-        tmember.team_barrier();
-      }
-    }  // end if-neighbor-exists block
+    //x1 faces
+    if (n<8) {
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
+        int k = idx / nj;
+        int j = (idx - k * nj) + jl;
+        k += kl;
+        flx.x1f(m,v,k,j,il) = rbuf[n].flux(m,(j-jl + nj*(k-kl + nk*v)));
+      });
+      tmember.team_barrier();
+    // x2faces
+    } else if (n<16) {
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nki), [&](const int idx) {
+        int k = idx / ni;
+        int i = (idx - k * ni) + il;
+        k += kl;
+        flx.x2f(m,v,k,jl,i) = rbuf[n].flux(m,(i-il + ni*(k-kl + nk*v)));
+      });
+      tmember.team_barrier();
+    // x3faces
+    } else if ((n>=24) && (n<32)) {
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nji), [&](const int idx) {
+        int j = idx / ni;
+        int i = (idx - j * ni) + il;
+        j += jl;
+        flx.x3f(m,v,kl,j,i) = rbuf[n].flux(m,(i-il + ni*(j-jl + nj*v)));
+      });
+      tmember.team_barrier();
+    }
   });  // end par_for_outer
 
   return TaskStatus::complete;
@@ -330,10 +337,10 @@ TaskStatus MeshBoundaryValuesCC::InitFluxRecv(const int nvars) {
 
           // calculate amount of data to be passed, get pointer to variables
           int data_size = nvars*(recvbuf[n].iflxc_ndat);
-          auto recv_ptr = Kokkos::subview(recvbuf[n].flux, m, Kokkos::ALL);
+          Real *recv_ptr = recvbuf[n].FluxPtr(m, pmy_pack->pmesh->mpi_host_staging);
 
           // Post non-blocking receive for this buffer on this MeshBlock
-          int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+          int ierr = MPI_Irecv(recv_ptr, data_size, MPI_ATHENA_REAL, drank, tag,
                                comm_flux, &(recvbuf[n].flux_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
         }
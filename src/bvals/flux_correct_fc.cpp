@@ -14,6 +14,7 @@
 #include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
+#include "utils/transient_pool.hpp"
 #include "bvals.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -328,7 +329,9 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFluxFC(DvceEdgeFld4D<Real> &flx) {
 #if MPI_PARALLEL_ENABLED
   // Send boundary buffer to neighboring MeshBlocks using MPI
   // Sends only occur to neighbors on FACES and EDGES at COARSER or SAME level
-  Kokkos::fence();
+  CopySendToHost(true);
+  // wait only for packing kernels on the default execution space instance
+  DevExeSpace().fence();
   bool no_errors=true;
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<nnghbr; ++n) {
@@ -351,11 +354,13 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFluxFC(DvceEdgeFld4D<Real> &flx) {
           } else if ( nghbr.h_view(m,n).lev == pmy_pack->pmb->mb_lev.h_view(m) ) {
             data_size *= sendbuf[n].iflxs_ndat;
           }
-          auto send_ptr = Kokkos::subview(sendbuf[n].flux, m, Kokkos::ALL);
+          Real *send_ptr = sendbuf[n].FluxPtr(m, pmy_pack->pmesh->mpi_host_staging);
 
-          int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+          int ierr = MPI_Isend(send_ptr, data_size, MPI_ATHENA_REAL, drank, tag,
                                comm_flux, &(sendbuf[n].flux_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          nmsg_sent++;
+          nbytes_sent += static_cast<std::uint64_t>(data_size)*sizeof(Real);
         }
       }
     }
@@ -414,12 +419,13 @@ TaskStatus MeshBoundaryValuesFC::RecvAndUnpackFluxFC(DvceEdgeFld4D<Real> &flx) {
   }
   // exit if recv boundary buffer communications have not completed
   if (bflag) {return TaskStatus::incomplete;}
+  CopyRecvToDvce(true);
 #endif
 
   //----- STEP 2: buffers have all completed, so unpack and perform appropriate averaging
 
   // 2D array to store number of fluxes summed into corner buffers
-  DvceArray2D<int> nflx("nflx",nmb,48);
+  auto nflx = transient_pool::Get<DvceArray2D<int>>("nflx",nmb,48);
   par_for("init_nflx", DevExeSpace(), 0, (nmb-1), 0, 47,
   KOKKOS_LAMBDA(const int m, const int n) {
     nflx(m,n) = 1;
@@ -652,147 +658,144 @@ void MeshBoundaryValuesFC::SumBoundaryFluxes(DvceEdgeFld4D<Real> &flx,
 void MeshBoundaryValuesFC::ZeroFluxesAtBoundaryWithFiner(DvceEdgeFld4D<Real> &flx,
                                                          DvceArray2D<int> &nflx) {
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
-  int nnghbr = pmy_pack->pmb->nnghbr;
-  auto &nghbr = pmy_pack->pmb->nghbr;
   auto &rbuf = recvbuf;
-  auto &mblev = pmy_pack->pmb->mb_lev;
+  InitInterfaceLists();
+  auto &ilist = fine_list;
 
-  // Outer loop over (# of MeshBlocks)*(# of neighbors)*(3 field components)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (3*nmb*nnghbr), Kokkos::AUTO);
+  // Outer loop over (# of buffers with neighbor at finer level)*(3 field components),
+  // since EMFs are only zeroed when neighbor is at finer level
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (3*nfine_), Kokkos::AUTO);
   Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(3*nnghbr);
-    const int n = (tmember.league_rank() - m*(3*nnghbr))/3;
-    const int v = (tmember.league_rank() - m*(3*nnghbr) - 3*n);
+    const int l = (tmember.league_rank())/3;
+    const int v = (tmember.league_rank() - 3*l);
+    const int m = ilist.d_view(l,0);
+    const int n = ilist.d_view(l,1);
 
-    // only zero EMFs when neighbor exists and is at finer level
-    if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev > mblev.d_view(m))) {
-      int il, iu, jl, ju, kl, ku;
-      il = rbuf[n].iflux_coar[v].bis;
-      iu = rbuf[n].iflux_coar[v].bie;
-      jl = rbuf[n].iflux_coar[v].bjs;
-      ju = rbuf[n].iflux_coar[v].bje;
-      kl = rbuf[n].iflux_coar[v].bks;
-      ku = rbuf[n].iflux_coar[v].bke;
-      const int ni = iu - il + 1;
-      const int nj = ju - jl + 1;
-      const int nk = ku - kl + 1;
-      const int nji  = nj*ni;
-      const int nkj  = nk*nj;
-      const int nki  = nk*ni;
+    int il, iu, jl, ju, kl, ku;
+    il = rbuf[n].iflux_coar[v].bis;
+    iu = rbuf[n].iflux_coar[v].bie;
+    jl = rbuf[n].iflux_coar[v].bjs;
+    ju = rbuf[n].iflux_coar[v].bje;
+    kl = rbuf[n].iflux_coar[v].bks;
+    ku = rbuf[n].iflux_coar[v].bke;
+    const int ni = iu - il + 1;
+    const int nj = ju - jl + 1;
+    const int nk = ku - kl + 1;
+    const int nji  = nj*ni;
+    const int nkj  = nk*nj;
+    const int nki  = nk*ni;
 
-      // x1faces
-      if (n<8) {
-        // use idle thread index to zero number of fluxes at corners of x1faces
-        if (v==0) {
-          if (n==0) {
-            nflx(m,16) = 0; nflx(m,20) = 0; nflx(m,32) = 0; nflx(m,36) = 0;
-          }
-          if (n==4) {
-            nflx(m,18) = 0; nflx(m,22) = 0; nflx(m,34) = 0; nflx(m,38) = 0;
-          }
-          tmember.team_barrier();
-        // else zero fluxes
-        } else {
-          Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,nkj),[&](const int idx){
-            int k = idx / nj;
-            int j = (idx - k * nj) + jl;
-            k += kl;
-            if (v==1) {
-              flx.x2e(m,k,j,il) = 0.0;
-            } else if (v==2) {
-              flx.x3e(m,k,j,il) = 0.0;
-            }
-          });
-          tmember.team_barrier();
+    // x1faces
+    if (n<8) {
+      // use idle thread index to zero number of fluxes at corners of x1faces
+      if (v==0) {
+        if (n==0) {
+          nflx(m,16) = 0; nflx(m,20) = 0; nflx(m,32) = 0; nflx(m,36) = 0;
         }
-
-      // x2faces
-      } else if (n<16) {
-        // use idle thread index to zero number of fluxes at corners of x2faces
-        if (v==1) {
-          if (n==8) {
-            nflx(m,16) = 0; nflx(m,18) = 0; nflx(m,40) = 0; nflx(m,44) = 0;
-          }
-          if (n==12) {
-            nflx(m,20) = 0; nflx(m,22) = 0; nflx(m,42) = 0; nflx(m,46) = 0;
-          }
-          tmember.team_barrier();
-        // else zero fluxes
-        } else {
-          Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,nki),[&](const int idx){
-            int k = idx/ni;
-            int i = (idx - k * ni) + il;
-            k += kl;
-            if (v==0) {
-              flx.x1e(m,k,jl,i) = 0.0;
-            } else if (v==2) {
-              flx.x3e(m,k,jl,i) = 0.0;
-            }
-          });
-          tmember.team_barrier();
+        if (n==4) {
+          nflx(m,18) = 0; nflx(m,22) = 0; nflx(m,34) = 0; nflx(m,38) = 0;
         }
+        tmember.team_barrier();
+      // else zero fluxes
+      } else {
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,nkj),[&](const int idx){
+          int k = idx / nj;
+          int j = (idx - k * nj) + jl;
+          k += kl;
+          if (v==1) {
+            flx.x2e(m,k,j,il) = 0.0;
+          } else if (v==2) {
+            flx.x3e(m,k,j,il) = 0.0;
+          }
+        });
+        tmember.team_barrier();
+      }
 
-      // x1x2 edges
-      } else if (n<24) {
-        if (v==2) {
-          nflx(m,n) = 0;
-          Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,nk),[&](const int idx) {
-            int k = idx + kl;
-            flx.x3e(m,k,jl,il) = 0.0;
-          });
-          tmember.team_barrier();
+    // x2faces
+    } else if (n<16) {
+      // use idle thread index to zero number of fluxes at corners of x2faces
+      if (v==1) {
+        if (n==8) {
+          nflx(m,16) = 0; nflx(m,18) = 0; nflx(m,40) = 0; nflx(m,44) = 0;
         }
-
-      // x3faces
-      } else if (n<32)  {
-        // use idle thread index to zero number of fluxes at corners of x2faces
-        if (v==2) {
-          if (n==24) {
-            nflx(m,32) = 0; nflx(m,34) = 0; nflx(m,40) = 0; nflx(m,42) = 0;
-          }
-          if (n==28) {
-            nflx(m,36) = 0; nflx(m,38) = 0; nflx(m,44) = 0; nflx(m,46) = 0;
-          }
-          tmember.team_barrier();
-        // else zero fluxes
-        } else {
-          Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,nji),[&](const int idx){
-            int j = idx / ni;
-            int i = (idx - j * ni) + il;
-            j += jl;
-            if (v==0) {
-              flx.x1e(m,kl,j,i) = 0.0;
-            } else if (v==1) {
-              flx.x2e(m,kl,j,i) = 0.0;
-            }
-          });
-          tmember.team_barrier();
+        if (n==12) {
+          nflx(m,20) = 0; nflx(m,22) = 0; nflx(m,42) = 0; nflx(m,46) = 0;
         }
+        tmember.team_barrier();
+      // else zero fluxes
+      } else {
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,nki),[&](const int idx){
+          int k = idx/ni;
+          int i = (idx - k * ni) + il;
+          k += kl;
+          if (v==0) {
+            flx.x1e(m,k,jl,i) = 0.0;
+          } else if (v==2) {
+            flx.x3e(m,k,jl,i) = 0.0;
+          }
+        });
+        tmember.team_barrier();
+      }
 
-      // x3x1 edges
-      } else if (n<40) {
-        if (v==1) {
-          nflx(m,n) = 0;
-          Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,nj),[&](const int idx){
-            int j = idx + jl;
-              flx.x2e(m,kl,j,il) = 0.0;
-          });
-          tmember.team_barrier();
-        }
+    // x1x2 edges
+    } else if (n<24) {
+      if (v==2) {
+        nflx(m,n) = 0;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,nk),[&](const int idx) {
+          int k = idx + kl;
+          flx.x3e(m,k,jl,il) = 0.0;
+        });
+        tmember.team_barrier();
+      }
 
-      // x2x3 edges
-      } else if (n<48) {
-        if (v==0) {
-          nflx(m,n) = 0;
-          Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,ni),[&](const int idx){
-            int i = idx + il;
-              flx.x1e(m,kl,jl,i) = 0.0;
-          });
-          tmember.team_barrier();
+    // x3faces
+    } else if (n<32)  {
+      // use idle thread index to zero number of fluxes at corners of x2faces
+      if (v==2) {
+        if (n==24) {
+          nflx(m,32) = 0; nflx(m,34) = 0; nflx(m,40) = 0; nflx(m,42) = 0;
         }
+        if (n==28) {
+          nflx(m,36) = 0; nflx(m,38) = 0; nflx(m,44) = 0; nflx(m,46) = 0;
+        }
+        tmember.team_barrier();
+      // else zero fluxes
+      } else {
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,nji),[&](const int idx){
+          int j = idx / ni;
+          int i = (idx - j * ni) + il;
+          j += jl;
+          if (v==0) {
+            flx.x1e(m,kl,j,i) = 0.0;
+          } else if (v==1) {
+            flx.x2e(m,kl,j,i) = 0.0;
+          }
+        });
+        tmember.team_barrier();
       }
-    }  // end if-neighbor-exists block
+
+    // x3x1 edges
+    } else if (n<40) {
+      if (v==1) {
+        nflx(m,n) = 0;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,nj),[&](const int idx){
+          int j = idx + jl;
+            flx.x2e(m,kl,j,il) = 0.0;
+        });
+        tmember.team_barrier();
+      }
+
+    // x2x3 edges
+    } else if (n<48) {
+      if (v==0) {
+        nflx(m,n) = 0;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember,ni),[&](const int idx){
+          int i = idx + il;
+            flx.x1e(m,kl,jl,i) = 0.0;
+        });
+        tmember.team_barrier();
+      }
+    }
   });  // end par_for_outer
 
   return;
@@ -1069,10 +1072,10 @@ TaskStatus MeshBoundaryValuesFC::InitFluxRecv(const int nvars) {
           } else if ( nghbr.h_view(m,n).lev == pmy_pack->pmb->mb_lev.h_view(m) ) {
             data_size *= recvbuf[n].iflxs_ndat;
           }
-          auto recv_ptr = Kokkos::subview(recvbuf[n].flux, m, Kokkos::ALL);
+          Real *recv_ptr = recvbuf[n].FluxPtr(m, pmy_pack->pmesh->mpi_host_staging);
 
           // Post non-blocking receive for this buffer on this MeshBlock
-          int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+          int ierr = MPI_Irecv(recv_ptr, data_size, MPI_ATHENA_REAL, drank, tag,
                                comm_flux, &(recvbuf[n].flux_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
         }
@@ -26,20 +26,21 @@ void MeshBoundaryValues::HydroBCs(MeshBlockPack *ppack, DualArray2D<Real> u_in,
   auto &indcs = ppack->pmesh->mb_indcs;
   int &ng = indcs.ng;
   auto &mb_bcs = ppack->pmb->mb_bcs;
+  auto &bc_mblist = ppack->pmb->bc_mblist;
+  auto &nbc_mb = ppack->pmb->nbc_mb;
 
   int n1 = indcs.nx1 + 2*ng;
   int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
   int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
   int nvar = u0.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
-  int nmb = ppack->nmb_thispack;
 
-  // only apply BCs unless periodic or shear_periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::periodic &&
-      pm->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::shear_periodic) {
+  // only apply BCs on MeshBlocks with physical boundaries in x1
+  if (nbc_mb[0] > 0) {
     int &is = indcs.is;
     int &ie = indcs.ie;
-    par_for("hydrobc_x1", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n3-1),0,(n2-1),
-    KOKKOS_LAMBDA(int m, int n, int k, int j) {
+    par_for("hydrobc_x1", DevExeSpace(), 0,(nbc_mb[0]-1),0,(nvar-1),0,(n3-1),0,(n2-1),
+    KOKKOS_LAMBDA(int b, int n, int k, int j) {
+      int m = bc_mblist.d_view(0,b);
       // apply physical boundaries to inner_x1
       switch (mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
         case BoundaryFlag::reflect:
@@ -122,12 +123,13 @@ void MeshBoundaryValues::HydroBCs(MeshBlockPack *ppack, DualArray2D<Real> u_in,
 
   if (pm->one_d) return;
 
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x2] != BoundaryFlag::periodic) {
+  // only apply BCs on MeshBlocks with physical boundaries in x2
+  if (nbc_mb[1] > 0) {
     int &js = indcs.js;
     int &je = indcs.je;
-    par_for("hydrobc_x2", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n3-1),0,(n1-1),
-    KOKKOS_LAMBDA(int m, int n, int k, int i) {
+    par_for("hydrobc_x2", DevExeSpace(), 0,(nbc_mb[1]-1),0,(nvar-1),0,(n3-1),0,(n1-1),
+    KOKKOS_LAMBDA(int b, int n, int k, int i) {
+      int m = bc_mblist.d_view(1,b);
       // apply physical boundaries to inner_x2
       switch (mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
         case BoundaryFlag::reflect:
@@ -209,12 +211,13 @@ void MeshBoundaryValues::HydroBCs(MeshBlockPack *ppack, DualArray2D<Real> u_in,
   }
   if (pm->two_d) return;
 
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic) return;
+  // only apply BCs on MeshBlocks with physical boundaries in x3
+  if (nbc_mb[2] == 0) return;
   int &ks = indcs.ks;
   int &ke = indcs.ke;
-  par_for("hydrobc_x3", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n2-1),0,(n1-1),
-  KOKKOS_LAMBDA(int m, int n, int j, int i) {
+  par_for("hydrobc_x3", DevExeSpace(), 0,(nbc_mb[2]-1),0,(nvar-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int b, int n, int j, int i) {
+    int m = bc_mblist.d_view(2,b);
     // apply physical boundaries to inner_x3
     switch (mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
       case BoundaryFlag::reflect:
@@ -134,15 +134,16 @@ void BCHelper(MeshBlockPack *ppack, DualArray2D<Real> u_in, DvceArray5D<Real> u0
   auto &pm = ppack->pmesh;
   int &ng = ppack->pmesh->mb_indcs.ng;
   auto &mb_bcs = ppack->pmb->mb_bcs;
+  auto &bc_mblist = ppack->pmb->bc_mblist;
+  auto &nbc_mb = ppack->pmb->nbc_mb;
 
   int nvar = u0.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
-  int nmb = ppack->nmb_thispack;
 
-  // only apply BCs unless periodic or shear_periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::periodic
-      && pm->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::shear_periodic) {
-    par_for("z4cbc_x1", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n3-1),0,(n2-1),
-    KOKKOS_LAMBDA(int m, int n, int k, int j) {
+  // only apply BCs on MeshBlocks with physical boundaries in x1
+  if (nbc_mb[0] > 0) {
+    par_for("z4cbc_x1", DevExeSpace(), 0,(nbc_mb[0]-1),0,(nvar-1),0,(n3-1),0,(n2-1),
+    KOKKOS_LAMBDA(int b, int n, int k, int j) {
+      int m = bc_mblist.d_view(0,b);
       // apply physical boundaries to inner_x1
       switch (mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
         case BoundaryFlag::reflect:
@@ -207,10 +208,11 @@ void BCHelper(MeshBlockPack *ppack, DualArray2D<Real> u_in, DvceArray5D<Real> u0
 
   if (pm->one_d) return;
 
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x2] != BoundaryFlag::periodic) {
-    par_for("z4cbc_x2", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n3-1),0,(n1-1),
-    KOKKOS_LAMBDA(int m, int n, int k, int i) {
+  // only apply BCs on MeshBlocks with physical boundaries in x2
+  if (nbc_mb[1] > 0) {
+    par_for("z4cbc_x2", DevExeSpace(), 0,(nbc_mb[1]-1),0,(nvar-1),0,(n3-1),0,(n1-1),
+    KOKKOS_LAMBDA(int b, int n, int k, int i) {
+      int m = bc_mblist.d_view(1,b);
       // apply physical boundaries to inner_x2
       switch (mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
         case BoundaryFlag::reflect:
@@ -274,10 +276,11 @@ void BCHelper(MeshBlockPack *ppack, DualArray2D<Real> u_in, DvceArray5D<Real> u0
   }
   if (pm->two_d) return;
 
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic) return;
-  par_for("z4cbc_x3", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n2-1),0,(n1-1),
-  KOKKOS_LAMBDA(int m, int n, int j, int i) {
+  // only apply BCs on MeshBlocks with physical boundaries in x3
+  if (nbc_mb[2] == 0) return;
+  par_for("z4cbc_x3", DevExeSpace(), 0,(nbc_mb[2]-1),0,(nvar-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int b, int n, int j, int i) {
+    int m = bc_mblist.d_view(2,b);
     // apply physical boundaries to inner_x3
     switch (mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
       case BoundaryFlag::reflect:
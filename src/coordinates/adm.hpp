@@ -56,6 +56,9 @@ class ADM {
 
   DvceArray5D<Real> u_adm;                                // adm variables
   bool is_dynamic;                                        // is the metric time dependent?
+  // incremented every time alpha, beta_u or g_dd change, so that quantities derived from
+  // them (e.g. the face metric cached by DynGRMHD) know when to be recomputed
+  int metric_version = 0;
 
   void (*SetADMVariables)(MeshBlockPack *pm);
 
@@ -256,6 +259,25 @@ void Face3Metric(const int m, const int k, const int j, const int i,
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void CachedFaceMetric
+//! \brief loads 3-metric, shift and lapse at a face from an array of values previously
+//! computed with Face1Metric(), Face2Metric() or Face3Metric().  Components of the array
+//! are stored in the order g_dd[NSPMETRIC], beta_u[3], alpha.
+
+KOKKOS_INLINE_FUNCTION
+void CachedFaceMetric(const int m, const int k, const int j, const int i,
+     const DvceArray5D<Real> &face_metric,
+     Real gface_dd[NSPMETRIC], Real betaface_u[3], Real &alphaface) {
+  for (int n = 0; n < NSPMETRIC; ++n) {
+    gface_dd[n] = face_metric(m,n,k,j,i);
+  }
+  for (int a = 0; a < 3; ++a) {
+    betaface_u[a] = face_metric(m,NSPMETRIC+a,k,j,i);
+  }
+  alphaface = face_metric(m,NSPMETRIC+3,k,j,i);
+  return;
+}
 
 } // namespace adm
 #endif // COORDINATES_ADM_HPP_
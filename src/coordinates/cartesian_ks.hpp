@@ -15,17 +15,19 @@
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "coordinates/adm.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "coordinates/coordinates.hpp"
 
 // #define SMALL_NUMBER 1.0e-5
 
 //----------------------------------------------------------------------------------------
-//! \fn void ComputeMetricAndInverse
-//! \brief computes 10 covariant and contravariant components of metric in
-//!  Cartesian Kerr-Schild coordinates
+//! \fn void ComputeNullVector
+//! \brief computes the scalar f and spatial components of the null covector l_i that
+//!  fully determine the Kerr-Schild metric, g_nm = f*l_n*l_m + eta_nm with l_0 = 1
 
 KOKKOS_INLINE_FUNCTION
-void ComputeMetricAndInverse(Real x, Real y, Real z, bool minkowski, Real a,
-                             Real glower[][4], Real gupper[][4]) {
+void ComputeNullVector(Real x, Real y, Real z, bool minkowski, Real a,
+                       Real &f, Real l[3]) {
   // NOTE(@pdmullen): The following commented out floor on z dealt with the metric
   // singularity encountered for small z near the horizon (e.g., see g_00). However, this
   // floor was operating on z even for r_ks > 1.0, where (I believe) the metric should be
@@ -41,17 +43,32 @@ void ComputeMetricAndInverse(Real x, Real y, Real z, bool minkowski, Real a,
   }
   //r = fmax(r, 1.0);  // floor r_ks to 0.5*(r_inner + r_outer)
 
+  // spatial components of null vector l
+  l[0] = (r*x + (a)*y)/( SQR(r) + SQR(a) );
+  l[1] = (r*y - (a)*x)/( SQR(r) + SQR(a) );
+  l[2] = z/r;
+
+  f = 2.0 * SQR(r)*r / (SQR(SQR(r)) + SQR(a)*SQR(z));
+  if (minkowski) {f=0.0;}
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MetricFromNullVector
+//! \brief computes 10 covariant and contravariant components of metric in
+//!  Cartesian Kerr-Schild coordinates from f and l_i (see ComputeNullVector)
+
+KOKKOS_INLINE_FUNCTION
+void MetricFromNullVector(Real f, const Real l[3], Real glower[][4], Real gupper[][4]) {
   // Set covariant components
   // null vector l
   Real l_lower[4];
   l_lower[0] = 1.0;
-  l_lower[1] = (r*x + (a)*y)/( SQR(r) + SQR(a) );
-  l_lower[2] = (r*y - (a)*x)/( SQR(r) + SQR(a) );
-  l_lower[3] = z/r;
+  l_lower[1] = l[0];
+  l_lower[2] = l[1];
+  l_lower[3] = l[2];
 
   // g_nm = f*l_n*l_m + eta_nm, where eta_nm is Minkowski metric
-  Real f = 2.0 * SQR(r)*r / (SQR(SQR(r)) + SQR(a)*SQR(z));
-  if (minkowski) {f=0.0;}
   glower[0][0] = f * l_lower[0]*l_lower[0] - 1.0;
   glower[0][1] = f * l_lower[0]*l_lower[1];
   glower[0][2] = f * l_lower[0]*l_lower[2];
@@ -98,6 +115,98 @@ void ComputeMetricAndInverse(Real x, Real y, Real z, bool minkowski, Real a,
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void ComputeMetricAndInverse
+//! \brief computes 10 covariant and contravariant components of metric in
+//!  Cartesian Kerr-Schild coordinates
+
+KOKKOS_INLINE_FUNCTION
+void ComputeMetricAndInverse(Real x, Real y, Real z, bool minkowski, Real a,
+                             Real glower[][4], Real gupper[][4]) {
+  Real f, l[3];
+  ComputeNullVector(x, y, z, minkowski, a, f, l);
+  MetricFromNullVector(f, l, glower, gupper);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CachedMetricAndInverse
+//! \brief metric and inverse at cell (m,k,j,i) of an array of (f, l_x, l_y, l_z) filled
+//!  by SetMetricCache(), e.g. one of CoordData::ks_cc, ks_x1f, ks_x2f or ks_x3f
+
+KOKKOS_INLINE_FUNCTION
+void CachedMetricAndInverse(const DvceArray5D<Real> &ks, const int m, const int k,
+                            const int j, const int i, Real glower[][4],
+                            Real gupper[][4]) {
+  Real l[3] = {ks(m,1,k,j,i), ks(m,2,k,j,i), ks(m,3,k,j,i)};
+  MetricFromNullVector(ks(m,0,k,j,i), l, glower, gupper);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SetMetricCache()
+//! \brief (re)allocates and fills the per-MeshBlock arrays of (f, l_x, l_y, l_z) at cell
+//!  centers and faces of CoordData, including ghost cells, for nmb MeshBlocks.  The
+//!  arrays use 16 Reals per cell in total, and replace the evaluation of the analytic
+//!  metric (a few square roots and divisions) with four loads.
+
+inline void SetMetricCache(const RegionIndcs &indcs, const DualArray1D<RegionSize> &size,
+                           const int nmb, CoordData &coord) {
+  int n1 = indcs.nx1 + 2*indcs.ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*indcs.ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*indcs.ng) : 1;
+  Kokkos::realloc(coord.ks_cc,  nmb, 4, n3,   n2,   n1);
+  Kokkos::realloc(coord.ks_x1f, nmb, 4, n3,   n2,   n1+1);
+  Kokkos::realloc(coord.ks_x2f, nmb, 4, n3,   n2+1, n1);
+  Kokkos::realloc(coord.ks_x3f, nmb, 4, n3+1, n2,   n1);
+
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  bool flat = coord.is_minkowski;
+  Real spin = coord.bh_spin;
+  auto ks_cc = coord.ks_cc;
+  auto ks_x1f = coord.ks_x1f;
+  auto ks_x2f = coord.ks_x2f;
+  auto ks_x3f = coord.ks_x3f;
+  par_for("ks_cache", DevExeSpace(), 0, (nmb-1), 0, n3, 0, n2, 0, n1,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    Real &x2min = size.d_view(m).x2min;
+    Real &x2max = size.d_view(m).x2max;
+    Real &x3min = size.d_view(m).x3min;
+    Real &x3max = size.d_view(m).x3max;
+    Real x1v = CellCenterX(i-is, nx1, x1min, x1max);
+    Real x2v = CellCenterX(j-js, nx2, x2min, x2max);
+    Real x3v = CellCenterX(k-ks, nx3, x3min, x3max);
+    Real x1f = LeftEdgeX(i-is, nx1, x1min, x1max);
+    Real x2f = LeftEdgeX(j-js, nx2, x2min, x2max);
+    Real x3f = LeftEdgeX(k-ks, nx3, x3min, x3max);
+    Real f, l[3];
+    if (k < n3 && j < n2 && i < n1) {
+      ComputeNullVector(x1v, x2v, x3v, flat, spin, f, l);
+      ks_cc(m,0,k,j,i) = f;
+      for (int n=0; n<3; ++n) {ks_cc(m,n+1,k,j,i) = l[n];}
+    }
+    if (k < n3 && j < n2) {
+      ComputeNullVector(x1f, x2v, x3v, flat, spin, f, l);
+      ks_x1f(m,0,k,j,i) = f;
+      for (int n=0; n<3; ++n) {ks_x1f(m,n+1,k,j,i) = l[n];}
+    }
+    if (k < n3 && i < n1) {
+      ComputeNullVector(x1v, x2f, x3v, flat, spin, f, l);
+      ks_x2f(m,0,k,j,i) = f;
+      for (int n=0; n<3; ++n) {ks_x2f(m,n+1,k,j,i) = l[n];}
+    }
+    if (j < n2 && i < n1) {
+      ComputeNullVector(x1v, x2v, x3f, flat, spin, f, l);
+      ks_x3f(m,0,k,j,i) = f;
+      for (int n=0; n<3; ++n) {ks_x3f(m,n+1,k,j,i) = l[n];}
+    }
+  });
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void ComputeADMDecomposition
 //! \brief computes ADM quantitiese in Cartesian Kerr-Schild coordinates
@@ -22,8 +22,8 @@
 
 Coordinates::Coordinates(ParameterInput *pin, MeshBlockPack *ppack) :
     pmy_pack(ppack),
-    excision_floor("excision_floor",1,1,1,1),
-    excision_flux("excision_flux",1,1,1,1) {
+    excise_generation(-1),
+    metric_generation(-1) {
   // Check for relativistic dynamics
   // WGC: idea for handling new EOS
   is_dynamical_relativistic = (pin->DoesBlockExist("adm") || pin->DoesBlockExist("z4c"))
@@ -63,6 +63,7 @@ Coordinates::Coordinates(ParameterInput *pin, MeshBlockPack *ppack) :
         (pin->DoesBlockExist("radiation")) ? 1.0+sqrt(1.0-SQR(coord_data.bh_spin)) : 1.0;
 
       coord_data.excision_scheme = ExcisionScheme::fixed;
+      coord_data.excise_update_dx = 0.0;
       if (is_dynamical_relativistic) {
         std::string emethod = pin->GetOrAddString("coord","excision_scheme","fixed");
         if (emethod.compare("fixed") == 0) {
@@ -70,6 +71,8 @@ Coordinates::Coordinates(ParameterInput *pin, MeshBlockPack *ppack) :
         } else if (emethod.compare("lapse") == 0) {
           coord_data.excision_scheme = ExcisionScheme::lapse;
           coord_data.excise_lapse = pin->GetOrAddReal("coord","excise_lapse", 0.25);
+          coord_data.excise_update_dx =
+            pin->GetOrAddReal("coord","excise_update_dx", 0.0);
         } else {
           std::cout << "### FATAL ERROR in " << __FILE__ << " at line "
                     << __LINE__ << std::endl
@@ -78,21 +81,37 @@ Coordinates::Coordinates(ParameterInput *pin, MeshBlockPack *ppack) :
         }
       }
 
-      // boolean masks allocation
-      int nmb = ppack->nmb_thispack;
-      auto &indcs = pmy_pack->pmesh->mb_indcs;
-      int ncells1 = indcs.nx1 + 2*(indcs.ng);
-      int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
-      int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-      Kokkos::realloc(excision_floor, nmb, ncells3, ncells2, ncells1);
-      Kokkos::realloc(excision_flux, nmb, ncells3, ncells2, ncells1);
+      // bit-packed masks allocation
+      AllocateExcisionMasks();
       if (coord_data.excision_scheme == ExcisionScheme::fixed) {
-        SetExcisionMasks(excision_floor, excision_flux);
+        SetExcisionMasks();
       }
     }
+
+    // Cache of the metric at cell centers and faces.  Only possible with a fixed
+    // (analytic) background, and trades 16 Reals of memory per cell for the evaluation
+    // of the metric in every flux, source term and primitive-conserved conversion.
+    if (is_general_relativistic) {
+      coord_data.metric_cache = pin->GetOrAddBoolean("coord","metric_cache",false);
+      UpdateMetricCache();
+    }
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::UpdateMetricCache()
+//! \brief fills the metric cache (if enabled) when the MeshBlocks on this rank have
+//! changed since it was last filled. Called before every kernel that reads the cache.
+
+void Coordinates::UpdateMetricCache() {
+  if (!(coord_data.metric_cache) || metric_generation == pmy_pack->pmesh->ngeneration) {
+    return;
+  }
+  SetMetricCache(pmy_pack->pmesh->mb_indcs, pmy_pack->pmb->mb_size,
+                 pmy_pack->nmb_thispack, coord_data);
+  metric_generation = pmy_pack->pmesh->ngeneration;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn
 // Coordinate (geometric) source term function for GR hydrodynamics
@@ -105,8 +124,11 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim, const EOS_Data &e
   int js = indcs.js; int je = indcs.je;
   int ks = indcs.ks; int ke = indcs.ke;
   auto &size = pmy_pack->pmb->mb_size;
+  UpdateMetricCache();
   auto &flat = coord_data.is_minkowski;
   auto &spin = coord_data.bh_spin;
+  auto &use_cache = coord_data.metric_cache;
+  auto &ks_cc = coord_data.ks_cc;
 
   Real gamma_prime = eos.gamma / (eos.gamma - 1.0);
 
@@ -127,7 +149,11 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim, const EOS_Data &e
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    if (use_cache) {
+      CachedMetricAndInverse(ks_cc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    }
 
     // Extract primitives
     const Real &rho  = prim(m,IDN,k,j,i);
@@ -228,8 +254,11 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim,
   int js = indcs.js; int je = indcs.je;
   int ks = indcs.ks; int ke = indcs.ke;
   auto &size = pmy_pack->pmb->mb_size;
+  UpdateMetricCache();
   auto &flat = coord_data.is_minkowski;
   auto &spin = coord_data.bh_spin;
+  auto &use_cache = coord_data.metric_cache;
+  auto &ks_cc = coord_data.ks_cc;
 
   Real gamma_prime = eos.gamma / (eos.gamma - 1.0);
 
@@ -250,7 +279,11 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim,
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    if (use_cache) {
+      CachedMetricAndInverse(ks_cc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    }
 
     // Extract primitives
     const Real &rho  = prim(m,IDN,k,j,i);
@@ -11,6 +11,9 @@
 //! computing positions.  In GR, also provides inline metric functions (currently only
 //! Cartesian Kerr-Schild)
 
+#include <cstdint>
+#include <vector>
+
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
@@ -24,6 +27,33 @@ enum class ExcisionScheme {
   lapse
 };
 
+// Summary of an excision mask over one MeshBlock
+enum class ExcisionState {
+  none,   // no cell excised
+  full,   // all cells excised
+  mixed   // some cells excised, must read bits
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct ExcisionMask
+//! \brief cell-centered boolean mask stored as bits (32 cells along x1 per word) plus a
+//! summary of each MeshBlock, so kernels only read bits in MeshBlocks that are partially
+//! excised.  Indexed like a DvceArray4D<bool> inside kernels.
+
+struct ExcisionMask {
+  DvceArray4D<uint32_t> bits;         // mask bits, indexed (m,k,j,i/32)
+  DvceArray1D<ExcisionState> state;   // summary of each MeshBlock
+
+  KOKKOS_INLINE_FUNCTION
+  bool operator()(const int m, const int k, const int j, const int i) const {
+    ExcisionState s = state(m);
+    if (s == ExcisionState::mixed) {
+      return ((bits(m,k,j,(i >> 5)) >> (i & 31)) & 1u) != 0;
+    }
+    return (s == ExcisionState::full);
+  }
+};
+
 //----------------------------------------------------------------------------------------
 //! \struct CoordData
 //! \brief container for Coordinate variables and functions needed inside kernels. Storing
@@ -41,6 +71,12 @@ struct CoordData {
   Real flux_excise_r;              // reduce to first-order inside this radius
   ExcisionScheme excision_scheme;  // excision method
   Real excise_lapse;               // if excision_scheme = lapse, excise under this lapse
+  Real excise_update_dx;           // if excision_scheme = lapse, only update masks once
+                                   // a compact object has moved this far (0 = always)
+  // optional cache of the analytic (fixed) metric, see SetMetricCache() in cartesian_ks
+  bool metric_cache = false;       // flag to read metric from arrays below
+  DvceArray5D<Real> ks_cc;         // (f,l_x,l_y,l_z) at cell centers
+  DvceArray5D<Real> ks_x1f, ks_x2f, ks_x3f;  // (f,l_x,l_y,l_z) at x1/x2/x3-faces
 };
 
 //----------------------------------------------------------------------------------------
@@ -61,20 +97,28 @@ class Coordinates {
   CoordData coord_data;
 
   // excision masks
-  DvceArray4D<bool> excision_floor;  // cell-centered mask for C2P flooring about horizon
-  DvceArray4D<bool> excision_flux;   // cell-centered mask for FOFC about horizon
+  ExcisionMask excision_floor;  // cell-centered mask for C2P flooring about horizon
+  ExcisionMask excision_flux;   // cell-centered mask for FOFC about horizon
 
   // functions
   void CoordSrcTerms(const DvceArray5D<Real> &w0, const EOS_Data &eos, const Real dt,
                      DvceArray5D<Real> &u0);
   void CoordSrcTerms(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc,
                      const EOS_Data &eos, const Real dt, DvceArray5D<Real> &u0);
-  void SetExcisionMasks(DvceArray4D<bool> &floor, DvceArray4D<bool> &flux);
+  void SetExcisionMasks();
 
   void UpdateExcisionMasks();
+  void UpdateMetricCache();
 
  private:
   MeshBlockPack* pmy_pack;
+  int excise_generation;              // Mesh::ngeneration when masks were allocated
+  std::vector<Real> excise_track_pos; // compact object positions at last mask update
+  int metric_generation;              // Mesh::ngeneration when metric cache was filled
+
+  void AllocateExcisionMasks();
+  void PackExcisionMask(const DvceArray4D<bool> &mask, ExcisionMask &packed);
+  void SummarizeExcisionMask(ExcisionMask &mask);
 };
 
 #endif // COORDINATES_COORDINATES_HPP_
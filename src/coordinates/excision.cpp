@@ -4,15 +4,20 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file excision.cpp
-//! \brief sets boolean masks for horizon excision
+//! \brief sets boolean masks for horizon excision.  Masks are stored as bits with a
+//! summary of each MeshBlock (see ExcisionMask in coordinates.hpp).
 
 #include <float.h>
 
+#include <algorithm>
+
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "coordinates.hpp"
 #include "cell_locations.hpp"
 #include "coordinates/adm.hpp"
+#include "z4c/compact_object_tracker.hpp"
+#include "z4c/z4c.hpp"
 
 // inlined spherical Kerr-Schild r evaluated at CKS x1, x2, x3
 KOKKOS_INLINE_FUNCTION
@@ -23,10 +28,10 @@ Real KSRX(const Real x1, const Real x2, const Real x3, const Real a) {
 
 //----------------------------------------------------------------------------------------
 //! \fn void Coordinates::SetExcisionMasks()
-//  \brief Sets boolean masks for the excision in CKS
+//  \brief Sets boolean masks for the excision in CKS.  Masks are evaluated cell by cell
+//  into temporary arrays, then packed into bits.
 
-void Coordinates::SetExcisionMasks(DvceArray4D<bool> &excision_floor,
-                                   DvceArray4D<bool> &excision_flux) {
+void Coordinates::SetExcisionMasks() {
   // capture variables for kernel
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is; int js = indcs.js; int ks = indcs.ks;
@@ -41,6 +46,9 @@ void Coordinates::SetExcisionMasks(DvceArray4D<bool> &excision_floor,
 
   auto &flux_excise_r = coord_data.flux_excise_r;
 
+  DvceArray4D<bool> excision_floor("excision_floor", nmb1+1, n3, n2, n1);
+  DvceArray4D<bool> excision_flux("excision_flux", nmb1+1, n3, n2, n1);
+
   // NOTE(@pdmullen):
   // excision_floor: - if r_ks evaluated at this CC is <= excision_radius, mask the cell.
   // excision_flux:  - if r_ks evaluated at any portion of the two cells connecting
@@ -163,29 +171,164 @@ void Coordinates::SetExcisionMasks(DvceArray4D<bool> &excision_floor,
     if (KSRX(x1,x2,x3,spin) <= flux_excise_r) excision_flux(m,k,j,i) = true;
   });
 
+  PackExcisionMask(excision_floor, this->excision_floor);
+  PackExcisionMask(excision_flux, this->excision_flux);
+  excise_generation = pmy_pack->pmesh->ngeneration;
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::UpdateExcisionMasks()
+//  \brief Updates masks during dynamical runs.  Masks are reallocated (and for fixed
+//  excision recomputed) when the Mesh has changed.  With lapse excision, masks are
+//  recomputed from the lapse, but only once a compact object has moved further than
+//  excise_update_dx since the last update (if set and trackers are present).
+
 void Coordinates::UpdateExcisionMasks() {
-  if (coord_data.excision_scheme == ExcisionScheme::lapse) {
-    // capture variables for kernel
-    auto &indcs = pmy_pack->pmesh->mb_indcs;
-    int &ng = indcs.ng;
-    int n1 = indcs.nx1 + 2*ng;
-    int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
-    int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
-    int nmb1 = pmy_pack->nmb_thispack - 1;
-    auto &adm = pmy_pack->padm->adm;
-    auto &floor = excision_floor;
-    auto &flux = excision_flux;
-
-    Real &excise_lapse = coord_data.excise_lapse;
-
-    par_for("set_excision", DevExeSpace(), 0, nmb1, 0, (n3-1), 0, (n2-1), 0, (n1-1),
-    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-      bool excise = (adm.alpha(m,k,j,i) < excise_lapse);
-      floor(m,k,j,i) = excise;
-      flux(m,k,j,i) = excise;
-    });
+  bool remesh = (excise_generation != pmy_pack->pmesh->ngeneration);
+  if (remesh) {
+    AllocateExcisionMasks();
   }
+  if (coord_data.excision_scheme == ExcisionScheme::fixed) {
+    if (remesh) {SetExcisionMasks();}
+    return;
+  }
+
+  // only update lapse masks once any compact object has moved far enough
+  if (coord_data.excise_update_dx > 0.0 && pmy_pack->pz4c != nullptr) {
+    auto &ptracker = pmy_pack->pz4c->ptracker;
+    bool moved = remesh || (excise_track_pos.size() != 3*ptracker.size());
+    if (!moved) {
+      for (std::size_t n = 0; n < ptracker.size(); ++n) {
+        Real d2 = 0.0;
+        for (int a = 0; a < 3; ++a) {
+          d2 += SQR(ptracker[n]->GetPos(a) - excise_track_pos[3*n + a]);
+        }
+        if (d2 > SQR(coord_data.excise_update_dx)) {moved = true;}
+      }
+    }
+    if (!moved) return;
+    excise_track_pos.resize(3*ptracker.size());
+    for (std::size_t n = 0; n < ptracker.size(); ++n) {
+      for (int a = 0; a < 3; ++a) {
+        excise_track_pos[3*n + a] = ptracker[n]->GetPos(a);
+      }
+    }
+  }
+
+  // capture variables for kernel
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  int nw = excision_floor.bits.extent_int(3);
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto &adm = pmy_pack->padm->adm;
+  auto &floor = excision_floor.bits;
+  auto &flux = excision_flux.bits;
+
+  Real &excise_lapse = coord_data.excise_lapse;
+
+  // each thread sets one word of 32 cells, so no atomics are needed
+  par_for("set_excision", DevExeSpace(), 0, nmb1, 0, (n3-1), 0, (n2-1), 0, (nw-1),
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int w) {
+    uint32_t word = 0;
+    int il = 32*w;
+    int iu = (il + 32 < n1)? il + 32 : n1;
+    for (int i=il; i<iu; ++i) {
+      if (adm.alpha(m,k,j,i) < excise_lapse) {word |= (1u << (i - il));}
+    }
+    floor(m,k,j,w) = word;
+    flux(m,k,j,w) = word;
+  });
+  SummarizeExcisionMask(excision_floor);
+  SummarizeExcisionMask(excision_flux);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::AllocateExcisionMasks()
+//  \brief (Re)allocates bit-packed masks for the MeshBlocks in this pack.  Masks are
+//  empty until set.
+
+void Coordinates::AllocateExcisionMasks() {
+  int nmb = pmy_pack->nmb_thispack;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nwords = (ncells1 + 31)/32;
+  for (auto *mask : {&excision_floor, &excision_flux}) {
+    Kokkos::realloc(mask->bits, nmb, ncells3, ncells2, nwords);
+    Kokkos::realloc(mask->state, nmb);
+    Kokkos::deep_copy(mask->state, ExcisionState::none);
+  }
+  excise_generation = pmy_pack->pmesh->ngeneration;
+  excise_track_pos.clear();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::PackExcisionMask()
+//  \brief Packs cell-by-cell boolean mask into bits, and summarizes each MeshBlock
+
+void Coordinates::PackExcisionMask(const DvceArray4D<bool> &mask, ExcisionMask &packed) {
+  int nmb1 = mask.extent_int(0) - 1;
+  int n3 = mask.extent_int(1);
+  int n2 = mask.extent_int(2);
+  int n1 = mask.extent_int(3);
+  int nw = packed.bits.extent_int(3);
+  auto &bits = packed.bits;
+  par_for("pack_excision", DevExeSpace(), 0, nmb1, 0, (n3-1), 0, (n2-1), 0, (nw-1),
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int w) {
+    uint32_t word = 0;
+    int il = 32*w;
+    int iu = (il + 32 < n1)? il + 32 : n1;
+    for (int i=il; i<iu; ++i) {
+      if (mask(m,k,j,i)) {word |= (1u << (i - il));}
+    }
+    bits(m,k,j,w) = word;
+  });
+  SummarizeExcisionMask(packed);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::SummarizeExcisionMask()
+//  \brief Sets state of each MeshBlock (none, full or mixed) from the mask bits
+
+void Coordinates::SummarizeExcisionMask(ExcisionMask &mask) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int n1 = indcs.nx1 + 2*(indcs.ng);
+  int nmb1 = mask.bits.extent_int(0) - 1;
+  int n3 = mask.bits.extent_int(1);
+  int n2 = mask.bits.extent_int(2);
+  int nw = mask.bits.extent_int(3);
+  const int nkjw = n3*n2*nw;
+  // bits set in the last (partially filled) word of each row when all cells are excised
+  uint32_t last_full = (n1 % 32 == 0)? 0xffffffffu : ((1u << (n1 % 32)) - 1u);
+  auto &bits = mask.bits;
+  auto &state = mask.state;
+  par_for_outer("excision_summary",DevExeSpace(), 0, 0, 0, nmb1,
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
+    int nset = 0, nfull = 0;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkjw),
+    [=](const int idx, int &sum_set) {
+      uint32_t word = bits(m, idx/(n2*nw), (idx/nw) % n2, idx % nw);
+      if (word != 0) {sum_set++;}
+    }, Kokkos::Sum<int>(nset));
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkjw),
+    [=](const int idx, int &sum_full) {
+      int w = idx % nw;
+      uint32_t full = (w == nw-1)? last_full : 0xffffffffu;
+      if (bits(m, idx/(n2*nw), (idx/nw) % n2, w) == full) {sum_full++;}
+    }, Kokkos::Sum<int>(nfull));
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {
+      if (nset == 0) {
+        state(m) = ExcisionState::none;
+      } else if (nfull == nkjw) {
+        state(m) = ExcisionState::full;
+      } else {
+        state(m) = ExcisionState::mixed;
+      }
+    });
+  });
 }
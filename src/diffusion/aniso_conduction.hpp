@@ -0,0 +1,140 @@
+#ifndef DIFFUSION_ANISO_CONDUCTION_HPP_
+#define DIFFUSION_ANISO_CONDUCTION_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file aniso_conduction.hpp
+//! \brief Inline functions that compute the anisotropic (Braginskii) heat flux along the
+//! magnetic field on a single cell face, q = -kappa_aniso b (b.grad T) with b = B/|B|.
+//! Transverse temperature gradients are the monotonised (van Leer) averages of the four
+//! gradients adjacent to the face, following Sharma & Hammett (2007), so that heat
+//! never flows from cold to hot.  These are called both by Conduction::AddAnisoHeatFlux()
+//! and inside the flux kernels in MHD::CalculateFluxes().
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+
+KOKKOS_INLINE_FUNCTION
+Real VanLeerLimiter(const Real a, const Real b) {
+  if (a*b > 0) {
+    return 2.0*a*b/(a+b);
+  } else {
+    return 0.0;
+  }
+}
+
+KOKKOS_INLINE_FUNCTION
+Real VL4Limiter(const Real a, const Real b, const Real c, const Real d) {
+  return VanLeerLimiter(VanLeerLimiter(a,b),VanLeerLimiter(c,d));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real CondTemp()
+//! \brief Temperature in cell (m,k,j,i), from internal energy or temperature primitive
+
+KOKKOS_INLINE_FUNCTION
+Real CondTemp(const DvceArray5D<Real> &w, const int m, const int k, const int j,
+              const int i, const bool use_e, const Real gm1) {
+  if (use_e) {
+    return gm1*w(m,IEN,k,j,i)/w(m,IDN,k,j,i);
+  } else {
+    return w(m,ITM,k,j,i);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real AnisoHeatFluxX1()
+//! \brief Anisotropic heat flux (energy flux) on x1-face (k,j,i-1/2).  The normal field
+//! is the face-centered B, while transverse fields are averages of the adjacent bcc.
+
+KOKKOS_INLINE_FUNCTION
+Real AnisoHeatFluxX1(const int m, const int k, const int j, const int i,
+                     const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc,
+                     const DvceArray4D<Real> &bx, const bool use_e, const Real gm1,
+                     const RegionSize &size, const bool multi_d, const bool three_d,
+                     const Real kappa) {
+  Real tl = CondTemp(w,m,k,j,i-1,use_e,gm1);
+  Real tr = CondTemp(w,m,k,j,i  ,use_e,gm1);
+  Real dtdx1 = (tr - tl)/size.dx1;
+  Real dtdx2 = 0.0, dtdx3 = 0.0;
+  if (multi_d) {
+    dtdx2 = VL4Limiter(CondTemp(w,m,k,j+1,i,use_e,gm1) - tr,
+                       tr - CondTemp(w,m,k,j-1,i,use_e,gm1),
+                       CondTemp(w,m,k,j+1,i-1,use_e,gm1) - tl,
+                       tl - CondTemp(w,m,k,j-1,i-1,use_e,gm1))/size.dx2;
+  }
+  if (three_d) {
+    dtdx3 = VL4Limiter(CondTemp(w,m,k+1,j,i,use_e,gm1) - tr,
+                       tr - CondTemp(w,m,k-1,j,i,use_e,gm1),
+                       CondTemp(w,m,k+1,j,i-1,use_e,gm1) - tl,
+                       tl - CondTemp(w,m,k-1,j,i-1,use_e,gm1))/size.dx3;
+  }
+  Real b1 = bx(m,k,j,i);
+  Real b2 = 0.5*(bcc(m,IBY,k,j,i-1) + bcc(m,IBY,k,j,i));
+  Real b3 = 0.5*(bcc(m,IBZ,k,j,i-1) + bcc(m,IBZ,k,j,i));
+  Real bsq = b1*b1 + b2*b2 + b3*b3;
+  if (bsq <= 0.0) {return 0.0;}
+  return -kappa*b1*(b1*dtdx1 + b2*dtdx2 + b3*dtdx3)/bsq;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real AnisoHeatFluxX2()
+//! \brief Anisotropic heat flux (energy flux) on x2-face (k,j-1/2,i)
+
+KOKKOS_INLINE_FUNCTION
+Real AnisoHeatFluxX2(const int m, const int k, const int j, const int i,
+                     const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc,
+                     const DvceArray4D<Real> &by, const bool use_e, const Real gm1,
+                     const RegionSize &size, const bool three_d, const Real kappa) {
+  Real tl = CondTemp(w,m,k,j-1,i,use_e,gm1);
+  Real tr = CondTemp(w,m,k,j  ,i,use_e,gm1);
+  Real dtdx2 = (tr - tl)/size.dx2;
+  Real dtdx1 = VL4Limiter(CondTemp(w,m,k,j,i+1,use_e,gm1) - tr,
+                          tr - CondTemp(w,m,k,j,i-1,use_e,gm1),
+                          CondTemp(w,m,k,j-1,i+1,use_e,gm1) - tl,
+                          tl - CondTemp(w,m,k,j-1,i-1,use_e,gm1))/size.dx1;
+  Real dtdx3 = 0.0;
+  if (three_d) {
+    dtdx3 = VL4Limiter(CondTemp(w,m,k+1,j,i,use_e,gm1) - tr,
+                       tr - CondTemp(w,m,k-1,j,i,use_e,gm1),
+                       CondTemp(w,m,k+1,j-1,i,use_e,gm1) - tl,
+                       tl - CondTemp(w,m,k-1,j-1,i,use_e,gm1))/size.dx3;
+  }
+  Real b1 = 0.5*(bcc(m,IBX,k,j-1,i) + bcc(m,IBX,k,j,i));
+  Real b2 = by(m,k,j,i);
+  Real b3 = 0.5*(bcc(m,IBZ,k,j-1,i) + bcc(m,IBZ,k,j,i));
+  Real bsq = b1*b1 + b2*b2 + b3*b3;
+  if (bsq <= 0.0) {return 0.0;}
+  return -kappa*b2*(b1*dtdx1 + b2*dtdx2 + b3*dtdx3)/bsq;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real AnisoHeatFluxX3()
+//! \brief Anisotropic heat flux (energy flux) on x3-face (k-1/2,j,i)
+
+KOKKOS_INLINE_FUNCTION
+Real AnisoHeatFluxX3(const int m, const int k, const int j, const int i,
+                     const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc,
+                     const DvceArray4D<Real> &bz, const bool use_e, const Real gm1,
+                     const RegionSize &size, const Real kappa) {
+  Real tl = CondTemp(w,m,k-1,j,i,use_e,gm1);
+  Real tr = CondTemp(w,m,k  ,j,i,use_e,gm1);
+  Real dtdx3 = (tr - tl)/size.dx3;
+  Real dtdx1 = VL4Limiter(CondTemp(w,m,k,j,i+1,use_e,gm1) - tr,
+                          tr - CondTemp(w,m,k,j,i-1,use_e,gm1),
+                          CondTemp(w,m,k-1,j,i+1,use_e,gm1) - tl,
+                          tl - CondTemp(w,m,k-1,j,i-1,use_e,gm1))/size.dx1;
+  Real dtdx2 = VL4Limiter(CondTemp(w,m,k,j+1,i,use_e,gm1) - tr,
+                          tr - CondTemp(w,m,k,j-1,i,use_e,gm1),
+                          CondTemp(w,m,k-1,j+1,i,use_e,gm1) - tl,
+                          tl - CondTemp(w,m,k-1,j-1,i,use_e,gm1))/size.dx2;
+  Real b1 = 0.5*(bcc(m,IBX,k-1,j,i) + bcc(m,IBX,k,j,i));
+  Real b2 = 0.5*(bcc(m,IBY,k-1,j,i) + bcc(m,IBY,k,j,i));
+  Real b3 = bz(m,k,j,i);
+  Real bsq = b1*b1 + b2*b2 + b3*b3;
+  if (bsq <= 0.0) {return 0.0;}
+  return -kappa*b3*(b1*dtdx1 + b2*dtdx2 + b3*dtdx3)/bsq;
+}
+#endif // DIFFUSION_ANISO_CONDUCTION_HPP_
@@ -6,7 +6,8 @@
 //! \file conduction.cpp
 //! \brief Implements functions for Conduction class. This includes isotropic thermal
 //! conduction, in which heat flux is proportional to negative local temperature gradient.
-//! Conduction may be added to Hydro and/or MHD independently.
+//! Conduction may be added to Hydro and/or MHD independently.  In MHD, anisotropic
+//! conduction along the magnetic field may also be added.
 
 #include <float.h>
 #include <algorithm>
@@ -22,22 +23,9 @@
 #include "mhd/mhd.hpp"
 #include "eos/eos.hpp"
 #include "conduction.hpp"
+#include "aniso_conduction.hpp"
 #include "units/units.hpp"
 
-KOKKOS_INLINE_FUNCTION
-Real VanLeerLimiter(const Real a, const Real b) {
-  if (a*b > 0) {
-    return 2.0*a*b/(a+b);
-  } else {
-    return 0.0;
-  }
-}
-
-KOKKOS_INLINE_FUNCTION
-Real VL4Limiter(const Real a, const Real b, const Real c, const Real d) {
-  return VanLeerLimiter(VanLeerLimiter(a,b),VanLeerLimiter(c,d));
-}
-
 //----------------------------------------------------------------------------------------
 //! \fn Real KappaTemp()
 //! \brief Temperature-dependent conductivity given by Parker (1953) and Spitzer (1962)
@@ -81,6 +69,12 @@ Conduction::Conduction(std::string block, MeshBlockPack *pp, ParameterInput *pin
   kappa_ceiling = pin->GetOrAddReal(block,"cond_ceiling",
                   static_cast<Real>(std::numeric_limits<float>::max()));
   sat_hflux = pin->GetOrAddBoolean(block,"sat_hflux",false);
+  kappa_aniso = pin->GetOrAddReal(block,"aniso_conductivity",0.0);
+  if ((kappa_aniso > 0.0) && (block.compare("mhd") != 0)) {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "Anisotropic conduction can only be used in <mhd> block" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -399,6 +393,56 @@ void Conduction::TempDependentHeatFlux(const DvceArray5D<Real> &w0, const EOS_Da
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void AddAnisoHeatFlux()
+//! \brief Adds anisotropic heat flux along B to face-centered fluxes of conserved
+//! variables in a separate pass over all faces.  Used when the heat flux is not computed
+//! inside the MHD flux kernels (see MHD::use_fused_aniso_cond)
+
+void Conduction::AddAnisoHeatFlux(const DvceArray5D<Real> &w0,
+  const DvceArray5D<Real> &bcc0, const DvceFaceFld4D<Real> &b0, const EOS_Data &eos,
+  DvceFaceFld5D<Real> &flx) {
+  if (kappa_aniso <= 0.0) {return;}
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto size = pmy_pack->pmb->mb_size;
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  const bool &use_e = eos.use_e;
+  Real gm1 = eos.gamma-1.0;
+  Real kappa_ = kappa_aniso;
+
+  auto &flx1 = flx.x1f;
+  auto &b1 = b0.x1f;
+  par_for("aniso_conduct1", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie+1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    flx1(m,IEN,k,j,i) += AnisoHeatFluxX1(m,k,j,i,w0,bcc0,b1,use_e,gm1,size.d_view(m),
+                                         multi_d,three_d,kappa_);
+  });
+  if (pmy_pack->pmesh->one_d) {return;}
+
+  auto &flx2 = flx.x2f;
+  auto &b2 = b0.x2f;
+  par_for("aniso_conduct2", DevExeSpace(), 0, nmb1, ks, ke, js, je+1, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    flx2(m,IEN,k,j,i) += AnisoHeatFluxX2(m,k,j,i,w0,bcc0,b2,use_e,gm1,size.d_view(m),
+                                         three_d,kappa_);
+  });
+  if (pmy_pack->pmesh->two_d) {return;}
+
+  auto &flx3 = flx.x3f;
+  auto &b3 = b0.x3f;
+  par_for("aniso_conduct3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    flx3(m,IEN,k,j,i) += AnisoHeatFluxX3(m,k,j,i,w0,bcc0,b3,use_e,gm1,size.d_view(m),
+                                         kappa_);
+  });
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Conduction::NewTimeStep()
 //! \brief Compute new time step for thermal conduction.
@@ -421,7 +465,9 @@ void Conduction::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
   auto &size = pmy_pack->pmb->mb_size;
   const bool &use_e = eos_data.use_e;
   Real gm1 = eos_data.gamma-1.0;
+  // anisotropic conduction is limited by the same condition, with its coefficient
   Real kappa0 = kappa;
+  Real kappa_aniso_ = kappa_aniso;
   bool tdepkappa = tdep_kappa;
   Real kappaceil = kappa_ceiling;
   Real fac;
@@ -450,7 +496,7 @@ void Conduction::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
     k += ks;
     j += js;
 
-    Real kappa_ = kappa0;
+    Real kappa_ = kappa0 + kappa_aniso_;
     if (tdepkappa) {
       Real temp = 1.0;
       if (use_e) {
@@ -458,7 +504,7 @@ void Conduction::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
       } else {
         temp = w0(m,ITM,k,j,i);
       }
-      kappa_ = KappaTemp(temp*temp_unit,kappaceil)/kappa_unit;
+      kappa_ = KappaTemp(temp*temp_unit,kappaceil)/kappa_unit + kappa_aniso_;
     }
 
     min_dt = fmin(min_dt, SQR(size.d_view(m).dx1)/kappa_*w0_(m,IDN,k,j,i)/gm1);
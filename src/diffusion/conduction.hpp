@@ -7,7 +7,8 @@
 //========================================================================================
 //! \file conduction.hpp
 //! \brief Contains data and functions that implement various formulations for conduction.
-//  Currently only isotropic conduction implemented
+//  Isotropic (constant or temperature-dependent) conduction, and in MHD anisotropic
+//  conduction along the magnetic field, are implemented
 
 #include <string>
 
@@ -29,6 +30,7 @@ class Conduction {
   bool tdep_kappa;    // temperature-dependent conductivity
   Real kappa_ceiling; // ceiling of thermal conductivity
   bool sat_hflux;     // saturtion of heat flux
+  Real kappa_aniso;   // conductivity parallel to B (MHD only)
 
   // function to add heat fluxes to Hydro and/or MHD fluxes
   void AddHeatFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
@@ -37,6 +39,9 @@ class Conduction {
                          DvceFaceFld5D<Real> &f);
   void TempDependentHeatFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
                              DvceFaceFld5D<Real> &f);
+  void AddAnisoHeatFlux(const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc,
+                        const DvceFaceFld4D<Real> &b, const EOS_Data &eos,
+                        DvceFaceFld5D<Real> &f);
   void NewTimeStep(const DvceArray5D<Real> &w, const EOS_Data &eos_data);
 
  private:
@@ -9,8 +9,13 @@
 #include <iostream>
 #include <iomanip>    // std::setprecision()
 #include <limits>
+#include <map>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <string> // string
+#include <thread>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -22,7 +27,10 @@
 #include "z4c/z4c.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
 #include "ion-neutral/ion-neutral.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
 #include "radiation/radiation.hpp"
+#include "utils/memory_tracker.hpp"
+#include "utils/transient_pool.hpp"
 #include "driver.hpp"
 
 #if MPI_PARALLEL_ENABLED
@@ -62,8 +70,16 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
   nmb_updated_(0),
   npart_updated_(0),
   lb_efficiency_(0),
+  io_time_start_(0.0),
   pwall_clock_(ptimer),
   wall_time(wtlim),
+  tl_scheduler(TaskListScheduler::poll),
+  tl_stall_wait_us(0),
+  tl_profile(false),
+  tl_profile_diag(false),
+  tl_regions(false),
+  async_dt(false),
+  io_budget(0.0),
   impl_src("ru",1,1,1,1,1,1) {
   // set time-evolution option (no default)
   {
@@ -81,12 +97,54 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
     }
   } // extra brace to limit scope of string
 
+  // set TaskList scheduler (default is poll, which sweeps all Tasks on each pass)
+  {
+    std::string sched = pin->GetOrAddString("tasks", "scheduler", "poll");
+    if (sched.compare("poll") == 0) {
+      tl_scheduler = TaskListScheduler::poll;
+    } else if (sched.compare("queue") == 0) {
+      tl_scheduler = TaskListScheduler::queue;
+    } else {
+      std::cout<<"### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+               <<"<tasks> scheduler = '"<< sched <<"' not implemented"<< std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    tl_stall_wait_us = pin->GetOrAddInteger("tasks", "stall_wait_us", 0);
+  } // extra brace to limit scope of string
+
+  // enable timing of each Task in all TaskLists.  With profile_fence=true the device is
+  // synchronized after each Task so kernel execution time is attributed to the Task.
+  tl_profile = pin->GetOrAddBoolean("tasks", "profile", false);
+  if (tl_profile) {
+    bool fence = pin->GetOrAddBoolean("tasks", "profile_fence", false);
+    for (auto &it : pmesh->pmb_pack->tl_map) {
+      it.second->SetProfiling(true, fence);
+      tl_time_[it.first] = 0.0;
+      tl_stall_time_[it.first] = 0.0;
+    }
+    // also print time spent in each physics module with the cycle diagnostics
+    tl_profile_diag = pin->GetOrAddBoolean("tasks", "profile_diag", false);
+  }
+
+  // enable Kokkos Tools regions (seen by e.g. Nsight Systems or rocprof) around each
+  // Task, TaskList, output write, and AMR step.  Regions cost nothing without a tool.
+  tl_regions = pin->GetOrAddBoolean("tasks", "regions", false);
+  if (tl_regions) {
+    for (auto &it : pmesh->pmb_pack->tl_map) {it.second->SetRegions(true);}
+  }
+
+  // maximum fraction of wall time spent in outputs, beyond which outputs not marked
+  // essential are skipped (see Outputs class)
+  io_budget = pin->GetOrAddReal("time", "io_budget", 0.0);
+
   // read <time> parameters controlling driver if run requires time-evolution
   if (time_evolution != TimeEvolution::tstatic) {
     integrator = pin->GetOrAddString("time", "integrator", "rk2");
     tlim = pin->GetReal("time", "tlim");
     nlim = pin->GetOrAddInteger("time", "nlim", -1);
     ndiag = pin->GetOrAddInteger("time", "ndiag", 1);
+    // start reduction of new timestep over ranks before outputs/AMR (see Execute())
+    async_dt = pin->GetOrAddBoolean("time", "async_dt", false);
 
     if (integrator == "rk1") {
       // RK1: first-order Runge-Kutta / the forward Euler (FE) method
@@ -276,6 +334,42 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
          << "Valid choices are [rk1,rk2,rk3,rk4,imex2,imex3]." << std::endl;
       exit(EXIT_FAILURE);
     }
+
+    // Operator-split super-time-stepping of viscosity, resistivity, and conduction with
+    // Runge-Kutta-Legendre integrators, Meyer, Balsara & Aslam (2014) JCP 257 594.
+    // Nothing is done if no physics module has diffusion (the "sts" TaskList is empty).
+    sts_integrator = pin->GetOrAddString("time", "sts_integrator", "none");
+    if ((sts_integrator != "none") && (sts_integrator != "rkl1") &&
+        (sts_integrator != "rkl2")) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "sts_integrator=" << sts_integrator << " not implemented. "
+         << "Valid choices are [none,rkl1,rkl2]." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (pmesh->pmb_pack->tl_map["sts"]->Empty()) {sts_integrator = "none";}
+  }
+
+  // With ImEx integrators, the stiff source term R(U) computed at the end of implicit
+  // stage s is stored in impl_src and added back (with weights in row r of a_twid) at
+  // the start of later stages r+2, r>=s.  Terms that are never read back with a non-zero
+  // weight are not stored (imp_slot=-1), and a slot is reused once the last stage
+  // reading its current term has started, so only as many slots as are simultaneously
+  // live are allocated.
+  nimp_slots = 0;
+  for (int s=0; s<4; ++s) {imp_slot[s] = -1;}
+  int slot_last[4];
+  for (int s=0; s<nimp_stages; ++s) {
+    int last_use = -1;
+    for (int r=s; r<nimp_stages; ++r) {
+      if (a_twid[r][s] != 0.0) {last_use = r;}
+    }
+    if (last_use < 0) {continue;}
+    // R(U) of stage s is written after row s-1 of a_twid has been applied
+    for (int n=0; n<nimp_slots; ++n) {
+      if (slot_last[n] < s) {imp_slot[s] = n; break;}
+    }
+    if (imp_slot[s] < 0) {imp_slot[s] = nimp_slots++;}
+    slot_last[imp_slot[s]] = last_use;
   }
 }
 
@@ -284,23 +378,133 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
 //! \brief Perform tasks over all MeshBlocks for the TaskList specified by string "tl".
 //! Integer argument "stage" can be used to indicate at which step in overall algorithm
 //! these tasks are to be performed, e.g. which stage of a multi-stage RK integrator.
+//!
+//! With the queue scheduler, only Tasks whose dependencies are complete are executed.
+//! When every remaining Task in every pack is waiting (e.g. on MPI receives), the host
+//! thread yields (or sleeps for <tasks>/stall_wait_us) rather than spinning.  With
+//! <tasks>/profile=true the wall time of the TaskList, and the time spent stalled, are
+//! accumulated for the summary printed by OutputTaskProfile().
+//!
+//! Each rank holds a single MeshBlockPack (Mesh::pmb_pack), whose TaskList is executed
+//! until complete.
 
 void Driver::ExecuteTaskList(Mesh *pm, std::string tl, int stage) {
-  MeshBlockPack* pmbp = pm->pmb_pack;
-  for (int p=0; p<(pm->nmb_packs_thisrank); ++p) {
-    if (!(pmbp->tl_map[tl]->Empty())) {pmbp->tl_map[tl]->Reset();}
-  }
-  int npack_left = (pm->nmb_packs_thisrank);
-  while (npack_left > 0) {
-    if (pmbp->tl_map[tl]->Empty()) {
-      npack_left--;
+  if (tl_regions) {Kokkos::Profiling::pushRegion(tl + "_" + std::to_string(stage));}
+  auto tl_start = std::chrono::steady_clock::now();
+  auto &tlist = pm->pmb_pack->tl_map[tl];
+  if (!(tlist->Empty())) {tlist->Reset();}
+  bool done = tlist->Empty();
+  while (!(done)) {
+    TaskListStatus status;
+    if (tl_scheduler == TaskListScheduler::queue) {
+      status = tlist->DoReady(this, stage);
     } else {
-      if (!pmbp->tl_map[tl]->IsComplete()) {
-        auto status = pmbp->tl_map[tl]->DoAvailable(this, stage);
-        if (status == TaskListStatus::complete) { npack_left--; }
+      status = tlist->DoAvailable(this, stage);
+    }
+    done = (status == TaskListStatus::complete);
+    // release host core while all Tasks are waiting on communications
+    if ((status == TaskListStatus::stuck) && (tl_scheduler == TaskListScheduler::queue)) {
+      auto t0 = std::chrono::steady_clock::now();
+      if (tl_stall_wait_us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(tl_stall_wait_us));
+      } else {
+        std::this_thread::yield();
+      }
+      if (tl_profile) {
+        tl_stall_time_[tl] += std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - t0).count();
       }
     }
   }
+  if (tl_profile) {
+    tl_time_[tl] += std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - tl_start).count();
+  }
+  if (tl_regions) {Kokkos::Profiling::popRegion();}
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::MakeOutput()
+//! \brief Load data and write file for one output type, within a profiling region named
+//! after the <output> block if <tasks>/regions=true.
+
+void Driver::MakeOutput(Mesh *pm, ParameterInput *pin, BaseTypeOutput *pout) {
+  if (tl_regions) {
+    Kokkos::Profiling::pushRegion("Output_" + pout->out_params.block_name);
+  }
+  memory_tracker::Scope scope(memory_tracker::Owner::outputs);
+  // time loading data (including the copy to host, so kernels are fenced) and writing
+  Kokkos::Timer timer;
+  double io_time0 = pout->load_time + pout->write_time;
+  pout->LoadOutputData(pm);
+  Kokkos::fence();
+  pout->load_time += timer.seconds();
+  timer.reset();
+  IOWrapperSizeT nbytes0 = IOWrapper::nbytes_written;
+  pout->WriteOutputFile(pm, pin);
+  pout->write_time += timer.seconds();
+  BaseTypeOutput::io_time += pout->load_time + pout->write_time - io_time0;
+  pout->nbytes += IOWrapper::nbytes_written - nbytes0;
+  pout->ncalls++;
+  if (tl_regions) {Kokkos::Profiling::popRegion();}
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::ExecuteSTS()
+//! \brief Integrates diffusion terms over timestep dt with RKL1 or RKL2 super-time-
+//! stepping, Meyer, Balsara & Aslam (2014) JCP 257 594.  Each stage j=1..s computes
+//!
+//!    U^{j} = mu_j*U^{j-1} + nu_j*U^{j-2} + (1-mu_j-nu_j)*U^{0}
+//!          + mu_tilde_j*dt*L(U^{j-1}) + gam_tilde_j*dt*L(U^{0}),
+//!
+//! where L(U) is the divergence of the diffusive fluxes.  The number of stages s is the
+//! smallest for which the scheme is stable with the explicit diffusion timestep (dt_diff)
+//! i.e. dt <= dt_diff*(s^2+s)/2 with RKL1 and dt <= dt_diff*(s^2+s-2)/4 with RKL2.
+
+void Driver::ExecuteSTS(Mesh *pm, Real dt) {
+  Real ratio = dt/(pm->DiffusionTimeStep());
+  bool rkl2 = (sts_integrator == "rkl2");
+  if (rkl2) {
+    nsts_stages = static_cast<int>(std::ceil(0.5*(std::sqrt(9.0 + 16.0*ratio) - 1.0)));
+    nsts_stages = std::max(nsts_stages, 2);
+  } else {
+    nsts_stages = static_cast<int>(std::ceil(0.5*(std::sqrt(1.0 + 8.0*ratio) - 1.0)));
+    nsts_stages = std::max(nsts_stages, 1);
+  }
+  sts_dt = dt;
+
+  Real s = static_cast<Real>(nsts_stages);
+  Real w1 = (rkl2)? 4.0/(s*s + s - 2.0) : 2.0/(s*s + s);
+  // coefficients b_j of RKL2, Meyer et al. (2014) eq. 16
+  auto b = [](int j) -> Real {
+    return (j <= 2)? (1.0/3.0) : static_cast<Real>(j*j + j - 2)/(2.0*j*(j + 1));
+  };
+  for (int stage=1; stage<=nsts_stages; ++stage) {
+    if (stage == 1) {
+      sts_mu = 1.0;
+      sts_nu = 0.0;
+      sts_mu_tilde = (rkl2)? b(1)*w1 : w1;
+      sts_gam_tilde = 0.0;
+    } else {
+      Real j = static_cast<Real>(stage);
+      if (rkl2) {
+        sts_mu = ((2.0*j - 1.0)/j)*b(stage)/b(stage-1);
+        sts_nu = -((j - 1.0)/j)*b(stage)/b(stage-2);
+        sts_mu_tilde = sts_mu*w1;
+        sts_gam_tilde = -(1.0 - b(stage-1))*sts_mu_tilde;
+      } else {
+        sts_mu = (2.0*j - 1.0)/j;
+        sts_nu = -(j - 1.0)/j;
+        sts_mu_tilde = sts_mu*w1;
+        sts_gam_tilde = 0.0;
+      }
+    }
+    ExecuteTaskList(pm, "before_sts", stage);
+    ExecuteTaskList(pm, "sts", stage);
+    ExecuteTaskList(pm, "after_sts", stage);
+  }
   return;
 }
 
@@ -325,9 +529,11 @@ void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool re
     if (pmhd != nullptr) {
       (void) pmesh->pmb_pack->pmhd->NewTimeStep(this, nexp_stages);
     }
+#if RADIATION_ENABLED
     if (prad != nullptr) {
       (void) pmesh->pmb_pack->prad->NewTimeStep(this, nexp_stages);
     }
+#endif
     if (pz4c != nullptr) {
       (void) pmesh->pmb_pack->pz4c->NewTimeStep(this, nexp_stages);
     }
@@ -338,14 +544,19 @@ void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool re
   //---- Step 3.  Cycle through output Types and load data / write files.
   if (!res_flag) { // only write outputs at the beginning of the run
     for (auto &out : pout->pout_list) {
-      out->LoadOutputData(pmesh);
-      out->WriteOutputFile(pmesh, pin);
+      MakeOutput(pmesh, pin, out);
     }
   }
 
   //---- Step 4.  Initialize various counters, timers, etc.
   run_time_.reset();
+  io_time_start_ = BaseTypeOutput::io_time;
   nmb_updated_ = 0;
+  if (tl_profile) {
+    for (auto &it : pmesh->pmb_pack->tl_map) {it.second->ResetProfile();}
+    for (auto &it : tl_time_) {it.second = 0.0;}
+    for (auto &it : tl_stall_time_) {it.second = 0.0;}
+  }
 
   // allocate memory for stiff source terms with ImEx integrators
   // only implemented for ion-neutral two fluid for now
@@ -362,7 +573,7 @@ void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool re
     int ncells1 = indcs.nx1 + 2*(indcs.ng);
     int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
     int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(impl_src, nimp_stages, nmb, 8, ncells3, ncells2, ncells1);
+    Kokkos::realloc(impl_src, nimp_slots, nmb, 8, ncells3, ncells2, ncells1);
   }
 
   return;
@@ -383,70 +594,157 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
   if (time_evolution == TimeEvolution::tstatic) {
     // TODO(@user): add work for time static problems here
   } else {
-    Real elapsed_time = -1.;
-    if (wall_time > 0.) {
-      elapsed_time = UpdateWallClock();
-    }
-    while ((pmesh->time < tlim) && (pmesh->ncycle < nlim || nlim < 0) &&
-           (elapsed_time < wall_time)) {
-      if (global_variable::my_rank == 0) {OutputCycleDiagnostics(pmesh);}
-
-      // Execute TaskLists
-      // Work before time integrator indicated by "0" in stage
-      ExecuteTaskList(pmesh, "before_timeintegrator", 0);
-
-      // time-integrator tasks for each stage of integrator
-      for (int stage=1; stage<=(nexp_stages); ++stage) {
-        ExecuteTaskList(pmesh, "before_stagen", stage);
-        ExecuteTaskList(pmesh, "stagen", stage);
-        ExecuteTaskList(pmesh, "after_stagen", stage);
-      }
+    while (KeepRunning(pmesh)) {
+      ExecuteCycle(pmesh, pin, pout);
+    }
+  }
+  return;
+}
 
-      // Work after time integrator indicated by "1" in stage
-      ExecuteTaskList(pmesh, "after_timeintegrator", 1);
-
-      // Work outside of TaskLists:
-      // increment time, ncycle, etc.
-      pmesh->time = pmesh->time + pmesh->dt;
-      pmesh->ncycle++;
-      nmb_updated_ += pmesh->nmb_total;
-      npart_updated_ += pmesh->nprtcl_total;
-      // load balancing efficiency
-      if (global_variable::nranks > 1) {
-        int minnmb = std::numeric_limits<int>::max();
-        for (int i=0; i<global_variable::nranks; ++i) {
-          minnmb = std::min(minnmb, pmesh->nmb_eachrank[i]);
-        }
-        lb_efficiency_ += static_cast<float>(minnmb*(global_variable::nranks))/
-            static_cast<float>(pmesh->nmb_total);
-      }
+//----------------------------------------------------------------------------------------
+//! \fn Driver::KeepRunning()
+//! \brief Returns true while the time and cycle limits and wall clock limit of a time
+//! evolution have not been reached.  Must be called by all ranks.
+
+bool Driver::KeepRunning(Mesh *pmesh) {
+  if (time_evolution == TimeEvolution::tstatic) {return false;}
+  Real elapsed_time = -1.;
+  if (wall_time > 0.) {
+    elapsed_time = UpdateWallClock();
+  }
+  return ((pmesh->time < tlim) && (pmesh->ncycle < nlim || nlim < 0) &&
+          (elapsed_time < wall_time));
+}
 
-      // Test for/make outputs
-      for (auto &out : pout->pout_list) {
-        // compare at floating point (32-bit) precision to reduce effect of round off
-        float time_32 = static_cast<float>(pmesh->time);
-        float next_32 = static_cast<float>(out->out_params.last_time+out->out_params.dt);
-        float tlim_32 = static_cast<float>(tlim);
-        int &dcycle_ = out->out_params.dcycle;
-
-        if (((out->out_params.dt > 0.0) && ((time_32 >= next_32) && (time_32<tlim_32))) ||
-            ((dcycle_ > 0) && ((pmesh->ncycle)%(dcycle_) == 0)) ) {
-          out->LoadOutputData(pmesh);
-          out->WriteOutputFile(pmesh, pin);
-        }
-      }
+//----------------------------------------------------------------------------------------
+//! \fn Driver::ExecuteCycle()
+//! \brief Advances the Mesh over one timestep, makes outputs due this cycle, refines the
+//! Mesh (with AMR) and computes the next timestep.
+
+void Driver::ExecuteCycle(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
+  if (global_variable::my_rank == 0) {OutputCycleDiagnostics(pmesh);}
+
+  // Execute TaskLists
+  // Work before time integrator indicated by "0" in stage
+  ExecuteTaskList(pmesh, "before_timeintegrator", 0);
+
+  // operator-split diffusion: over whole timestep before time-integrator with RKL1,
+  // and over half timesteps before and after (Strang splitting) with RKL2
+  if (sts_integrator == "rkl1") {
+    ExecuteSTS(pmesh, pmesh->dt);
+  } else if (sts_integrator == "rkl2") {
+    ExecuteSTS(pmesh, 0.5*(pmesh->dt));
+  }
 
-      // AMR
-      if (pmesh->adaptive) {pmesh->pmr->AdaptiveMeshRefinement(this, pin);}
-      // compute new timestep AFTER all Meshblocks refined/derefined
-      pmesh->NewTimeStep(tlim);
+  // time-integrator tasks for each stage of integrator
+  for (int stage=1; stage<=(nexp_stages); ++stage) {
+    ExecuteTaskList(pmesh, "before_stagen", stage);
+    ExecuteTaskList(pmesh, "stagen", stage);
+    // timesteps of all physics are computed in last stage, so reduction over ranks
+    // can be started here and overlapped with the work below
+    if (async_dt && (stage == nexp_stages)) {pmesh->StartNewTimeStep();}
+    ExecuteTaskList(pmesh, "after_stagen", stage);
+  }
+
+  if (sts_integrator == "rkl2") {
+    ExecuteSTS(pmesh, 0.5*(pmesh->dt));
+  }
+
+  // Work after time integrator indicated by "1" in stage
+  ExecuteTaskList(pmesh, "after_timeintegrator", 1);
+
+  // Work outside of TaskLists:
+  // increment time, ncycle, etc.
+  pmesh->time = pmesh->time + pmesh->dt;
+  pmesh->ncycle++;
+  nmb_updated_ += pmesh->nmb_total;
+  npart_updated_ += pmesh->nprtcl_total;
+  // load balancing efficiency
+  if (global_variable::nranks > 1) {
+    int minnmb = std::numeric_limits<int>::max();
+    for (int i=0; i<global_variable::nranks; ++i) {
+      minnmb = std::min(minnmb, pmesh->nmb_eachrank[i]);
+    }
+    lb_efficiency_ += static_cast<float>(minnmb*(global_variable::nranks))/
+        static_cast<float>(pmesh->nmb_total);
+  }
 
-      // Update wall clock time if needed.
-      if (wall_time > 0.) {
-        elapsed_time = UpdateWallClock();
+  // Test for/make outputs
+  for (auto &out : pout->pout_list) {
+    // compare at floating point (32-bit) precision to reduce effect of round off
+    float time_32 = static_cast<float>(pmesh->time);
+    float next_32 = static_cast<float>(out->out_params.last_time+out->out_params.dt);
+    float tlim_32 = static_cast<float>(tlim);
+    int &dcycle_ = out->out_params.dcycle;
+
+    if (((out->out_params.dt > 0.0) && ((time_32 >= next_32) && (time_32<tlim_32))) ||
+        ((dcycle_ > 0) && ((pmesh->ncycle)%(dcycle_) == 0)) ) {
+      // with a wall time budget for outputs, skip non-essential outputs when exceeded
+      Real io_frac = 0.0;
+      if (io_budget > 0.0 && !(out->out_params.essential)) {io_frac = IOFraction();}
+      if (io_frac > io_budget) {
+        SkipOutput(pmesh, pin, out, io_frac);
+      } else {
+        MakeOutput(pmesh, pin, out);
       }
-    }  // end while
-  }    // end of (time_evolution != tstatic) clause
+    }
+  }
+
+  // AMR
+  if (pmesh->adaptive) {
+    if (tl_regions) {Kokkos::Profiling::pushRegion("AdaptiveMeshRefinement");}
+    Kokkos::Timer amr_timer;
+    pmesh->pmr->AdaptiveMeshRefinement(this, pin);
+    pmesh->pmr->amr_time += amr_timer.seconds();
+    if (tl_regions) {Kokkos::Profiling::popRegion();}
+  }
+  // compute new timestep AFTER all Meshblocks refined/derefined
+  pmesh->NewTimeStep(tlim);
+  // scratch arrays taken from the pool this cycle are all out of scope by now
+  transient_pool::Reset();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::IOFraction()
+//! \brief Returns the largest fraction of wall time since the start of the run spent in
+//! outputs on any rank.  Collective over all ranks.
+
+Real Driver::IOFraction() {
+  double elapsed = run_time_.seconds();
+  double frac = (elapsed > 0.0)? (BaseTypeOutput::io_time - io_time_start_)/elapsed : 0.0;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &frac, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  return static_cast<Real>(frac);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::SkipOutput()
+//! \brief Skips an output that is due, advancing its time and file number as if it had
+//! been written so that the next output is made at the usual time.
+
+void Driver::SkipOutput(Mesh *pm, ParameterInput *pin, BaseTypeOutput *pout,
+                        Real fraction) {
+  auto &op = pout->out_params;
+  // increment counters exactly as the writers do, so the file numbers of the outputs
+  // that are made match the times at which they would have been made without skipping
+  op.file_number++;
+  pin->SetInteger(op.block_name, "file_number", op.file_number);
+  if (op.dt > 0.0) {
+    if (op.last_time < 0.0) {
+      op.last_time = pm->time;
+    } else {
+      op.last_time += op.dt;
+    }
+    pin->SetReal(op.block_name, "last_time", op.last_time);
+  }
+  pout->nskipped++;
+  if (global_variable::my_rank == 0) {
+    std::cout << "Output " << op.block_name << " skipped at cycle=" << pm->ncycle
+              << " time=" << pm->time << ", outputs used " << 100.0*fraction
+              << "% of wall time (io_budget=" << 100.0*io_budget << "%)" << std::endl;
+  }
   return;
 }
 
@@ -456,11 +754,18 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
 //!  and printing diagnostic messages
 
 void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
-  // cycle through output Types and load data / write files
-  //  This design allows for asynchronous outputs to implemented in the future.
+  // cycle through output Types and load data / write files, then complete any
+  // asynchronous writes still in flight
+  for (auto &out : pout->pout_list) {
+    MakeOutput(pmesh, pin, out);
+  }
   for (auto &out : pout->pout_list) {
-    out->LoadOutputData(pmesh);
-    out->WriteOutputFile(pmesh, pin);
+    Kokkos::Timer timer;
+    IOWrapperSizeT nbytes0 = IOWrapper::nbytes_written;
+    out->CompleteWrites();
+    out->write_time += timer.seconds();
+    BaseTypeOutput::io_time += timer.seconds();
+    out->nbytes += IOWrapper::nbytes_written - nbytes0;
   }
 
   // call any problem specific functions to do work after main loop
@@ -468,6 +773,19 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
     (pmesh->pgen->pgen_final_func)(pin, pmesh);
   }
 
+  // report error of single precision halo exchanges (collective over all ranks)
+  MeshBlockPack *pmbp = pmesh->pmb_pack;
+  if (pmbp->phydro != nullptr) {pmbp->phydro->pbval_u->ReportHaloError();}
+  if (pmbp->pmhd != nullptr) {
+    pmbp->pmhd->pbval_u->ReportHaloError();
+    pmbp->pmhd->pbval_b->ReportHaloError();
+  }
+  if (pmbp->pz4c != nullptr) {
+    pmbp->pz4c->pbval_u->ReportHaloError();
+    pmbp->pz4c->pbval_weyl->ReportHaloError();
+  }
+  if (pmbp->prad != nullptr) {pmbp->prad->pbval_i->ReportHaloError();}
+
   float exe_time = run_time_.seconds();
 
   if (time_evolution != TimeEvolution::tstatic) {
@@ -496,6 +814,10 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
         std::cout << std::endl << "Current number of MeshBlocks = " << pmesh->nmb_total
           << std::endl << pmesh->pmr->nmb_created << " MeshBlocks created, "
           << pmesh->pmr->nmb_deleted << " deleted by AMR" << std::endl;
+        if (pmesh->pmr->nref_deferred > 0) {
+          std::cout << "Refinement deferred " << pmesh->pmr->nref_deferred
+            << " times by <mesh_refinement>/max_nmb_per_rank" << std::endl;
+        }
 #if MPI_PARALLEL_ENABLED
         std::cout << pmesh->pmr->nmb_sent_thisrank << " communicated for load balancing, "
           <<"load balancing efficiency = " << (lb_efficiency_/pmesh->ncycle) << std::endl;
@@ -514,6 +836,266 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
       std::cout << "zone-cycles/cpu_second = " << zcps << std::endl;
       std::cout << "particle-updates/cpu_second = " << pups << std::endl;
     }
+    OutputIOProfile(pout);
+    if (tl_profile) {OutputTaskProfile(pmesh, exe_time);}
+    if (tl_profile && pmesh->pmb_pack->prad != nullptr) {
+      OutputRadiationProfile(pmesh, exe_time);
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::OutputIOProfile()
+//! \brief Prints the number of outputs made by each output block, the time spent loading
+//! data (computing derived variables, gathering and copying data to host) and writing
+//! files, and the data written and effective write bandwidth.  Times are the maximum over
+//! MPI ranks, bytes the sum over ranks.  Bytes are only counted for outputs written
+//! through IOWrapper or HDF5 (i.e. not for formatted text outputs such as tab or hst).
+
+void Driver::OutputIOProfile(Outputs *pout) {
+  std::vector<double> stats;
+  Outputs::ReduceIOProfile(pout->pout_list, stats);
+  if (global_variable::my_rank == 0) {
+    std::cout << std::endl << "Output profile (times in seconds, maximum over "
+              << global_variable::nranks << " ranks)" << std::endl;
+    std::cout << std::left << std::setw(16) << "output" << std::setw(8) << "type"
+              << std::right << std::setw(8) << "calls" << std::setw(13) << "load_time"
+              << std::setw(13) << "write_time" << std::setw(13) << "GB"
+              << std::setw(13) << "GB/s" << std::endl;
+    for (std::size_t n=0; n<pout->pout_list.size(); ++n) {
+      auto &op = pout->pout_list[n]->out_params;
+      double gbytes = 1.0e-9*stats[4*n+3];
+      double gbps = (stats[4*n+2] > 0.0)? gbytes/stats[4*n+2] : 0.0;
+      std::cout << std::left << std::setw(16) << op.block_name << std::setw(8)
+                << op.file_type << std::right << std::setw(8)
+                << static_cast<int>(stats[4*n]) << std::scientific
+                << std::setprecision(4) << std::setw(13) << stats[4*n+1]
+                << std::setw(13) << stats[4*n+2] << std::setw(13) << gbytes
+                << std::setw(13) << gbps << std::endl;
+    }
+    std::cout << std::defaultfloat;
+    for (auto &out : pout->pout_list) {
+      if (out->nskipped > 0) {
+        std::cout << out->out_params.block_name << ": " << out->nskipped
+                  << " outputs skipped to keep within io_budget" << std::endl;
+      }
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::OutputTaskProfile()
+//! \brief Prints timing statistics of every Task in every TaskList accumulated over the
+//! run. Times are summed (and maximum taken) over all MPI ranks.  All ranks hold the same
+//! TaskLists, so statistics can be reduced element-by-element.
+//!
+//! Then prints the time, communication wait time, and throughput (zone-cycles per second
+//! spent in it) of each physics module and of each TaskList.  Tasks are assigned to a
+//! module by the prefix of their name (e.g. "Hydro" for "Hydro_Fluxes").  Communication
+//! wait time is the time spent in Task calls that returned incomplete, plus (for
+//! TaskLists) the time the host was stalled with every Task waiting.
+
+void Driver::OutputTaskProfile(Mesh *pm, float exe_time) {
+  std::vector<std::string> names;
+  std::vector<double> tsum, tmax, dsum;
+  std::vector<int> ncall, nincomp;
+  for (auto &it : pm->pmb_pack->tl_map) {
+    int n = 0;
+    for (auto &task : it.second->GetTasks()) {
+      std::string tname = task.GetName();
+      if (tname.empty()) {tname = "task" + std::to_string(n);}
+      names.push_back(it.first + "/" + tname);
+      tsum.push_back(task.host_time);
+      dsum.push_back(task.dvce_time);
+      ncall.push_back(task.ncalls);
+      nincomp.push_back(task.nincomplete);
+      n++;
+    }
+  }
+  tmax = tsum;
+  int ntask = names.size();
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, tsum.data(), ntask, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(MPI_IN_PLACE, tmax.data(), ntask, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(MPI_IN_PLACE, dsum.data(), ntask, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(MPI_IN_PLACE, nincomp.data(), ntask, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  } else {
+    // receive buffers are not significant on non-root ranks
+    MPI_Reduce(tsum.data(), nullptr, ntask, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(tmax.data(), nullptr, ntask, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(dsum.data(), nullptr, ntask, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(nincomp.data(), nullptr, ntask, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  }
+#endif
+  if (global_variable::my_rank == 0) {
+    double nr = static_cast<double>(global_variable::nranks);
+    std::cout << std::endl << "Task profile (times in seconds, averaged over "
+              << global_variable::nranks << " ranks)" << std::endl;
+    std::cout << std::left << std::setw(40) << "tasklist/task" << std::right
+              << std::setw(10) << "calls" << std::setw(13) << "host_time"
+              << std::setw(13) << "max_host" << std::setw(13) << "dvce_time"
+              << std::setw(8) << "%run" << std::setw(12) << "incomplete" << std::endl;
+    for (int n=0; n<ntask; ++n) {
+      if (ncall[n] == 0) continue;
+      double frac = (exe_time > 0.0)? 100.0*dsum[n]/(nr*exe_time) : 0.0;
+      std::cout << std::left << std::setw(40) << names[n] << std::right
+                << std::setw(10) << ncall[n] << std::scientific << std::setprecision(4)
+                << std::setw(13) << tsum[n]/nr << std::setw(13) << tmax[n]
+                << std::setw(13) << dsum[n]/nr << std::fixed << std::setprecision(2)
+                << std::setw(8) << frac << std::setw(12) << nincomp[n] << std::endl;
+    }
+    std::cout << std::defaultfloat;
+  }
+
+  // time per module and per TaskList, stored as [times..., wait times...]
+  std::map<std::string, double> mod_time, mod_wait;
+  ModuleTimes(pm, mod_time, mod_wait);
+  std::vector<std::string> mnames, tlnames;
+  std::vector<double> msum, tlsum;
+  for (auto &it : mod_time) {
+    mnames.push_back(it.first);
+    msum.push_back(it.second);
+  }
+  for (auto &it : mod_wait) {msum.push_back(it.second);}
+  for (auto &it : tl_time_) {
+    tlnames.push_back(it.first);
+    tlsum.push_back(it.second);
+  }
+  for (auto &it : tl_time_) {
+    double wait = tl_stall_time_[it.first];
+    for (auto &task : pm->pmb_pack->tl_map[it.first]->GetTasks()) {
+      wait += task.wait_time;
+    }
+    tlsum.push_back(wait);
+  }
+  int nmod = mnames.size(), ntl = tlnames.size();
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, msum.data(), 2*nmod, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(MPI_IN_PLACE, tlsum.data(), 2*ntl, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(msum.data(), nullptr, 2*nmod, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(tlsum.data(), nullptr, 2*ntl, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  }
+#endif
+  if (global_variable::my_rank == 0) {
+    double nr = static_cast<double>(global_variable::nranks);
+    double zonecycles = static_cast<double>(nmb_updated_)*
+                        static_cast<double>(pm->NumberOfMeshBlockCells());
+    auto print_row = [&](const std::string &name, double time, double wait) {
+      double frac = (exe_time > 0.0)? 100.0*time/exe_time : 0.0;
+      double zcps = (time > 0.0)? zonecycles/time : 0.0;
+      std::cout << std::left << std::setw(24) << name << std::right << std::scientific
+                << std::setprecision(4) << std::setw(13) << time << std::setw(13) << wait
+                << std::fixed << std::setprecision(2) << std::setw(8) << frac
+                << std::scientific << std::setprecision(4) << std::setw(16) << zcps
+                << std::endl;
+    };
+    std::cout << std::endl << "Module profile (times in seconds, averaged over "
+              << global_variable::nranks << " ranks)" << std::endl;
+    std::cout << std::left << std::setw(24) << "module" << std::right
+              << std::setw(13) << "time" << std::setw(13) << "comm_wait"
+              << std::setw(8) << "%run" << std::setw(16) << "zone-cycles/s" << std::endl;
+    for (int n=0; n<nmod; ++n) {
+      print_row(mnames[n], msum[n]/nr, msum[nmod+n]/nr);
+    }
+    std::cout << std::endl << std::left << std::setw(24) << "tasklist" << std::right
+              << std::setw(13) << "time" << std::setw(13) << "comm_wait"
+              << std::setw(8) << "%run" << std::setw(16) << "zone-cycles/s" << std::endl;
+    for (int n=0; n<ntl; ++n) {
+      print_row(tlnames[n], tlsum[n]/nr, tlsum[ntl+n]/nr);
+    }
+    std::cout << std::defaultfloat;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::ModuleTimes()
+//! \brief Sums the time (dvce_time) and communication wait time of the Tasks on this rank
+//! over each physics module, identified by the prefix of Task names before the first
+//! underscore.  Unnamed Tasks are assigned to "other".
+
+void Driver::ModuleTimes(Mesh *pm, std::map<std::string, double> &time,
+                         std::map<std::string, double> &wait) {
+  for (auto &it : pm->pmb_pack->tl_map) {
+    for (auto &task : it.second->GetTasks()) {
+      const std::string &tname = task.GetName();
+      std::string module = tname.substr(0, tname.find('_'));
+      if (module.empty()) {module = "other";}
+      time[module] += task.dvce_time;
+      wait[module] += task.wait_time;
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::OutputRadiationProfile()
+//! \brief Prints the throughput of the radiation module in angle-zone-cycles per second,
+//! both over the whole run and split into the time spent in the flux and update Tasks,
+//! the source term, and in communication (every Rad_ Task that sends or receives).  The
+//! remaining Rad_ Tasks (copies, restriction, prolongation) are reported as "other".
+//! Times are averaged over MPI ranks, so throughputs are for the whole Mesh.
+
+void Driver::OutputRadiationProfile(Mesh *pm, float exe_time) {
+  // time in flux, source, comm, and other radiation Tasks, then the comm wait time
+  std::vector<double> rsum(5, 0.0);
+  for (auto &it : pm->pmb_pack->tl_map) {
+    for (auto &task : it.second->GetTasks()) {
+      const std::string &tname = task.GetName();
+      if (tname.compare(0, 4, "Rad_") != 0) continue;
+      if (tname == "Rad_CalculateFluxes" || tname == "Rad_RKUpdate") {
+        rsum[0] += task.dvce_time;
+      } else if (tname == "Rad_SourceTerm") {
+        rsum[1] += task.dvce_time;
+      } else if (tname.find("Send") != std::string::npos ||
+                 tname.find("Recv") != std::string::npos) {
+        rsum[2] += task.dvce_time;
+        rsum[4] += task.wait_time;
+      } else {
+        rsum[3] += task.dvce_time;
+      }
+    }
+  }
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, rsum.data(), 5, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(rsum.data(), nullptr, 5, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  }
+#endif
+  if (global_variable::my_rank == 0) {
+    double nr = static_cast<double>(global_variable::nranks);
+    for (auto &t : rsum) {t /= nr;}
+    double azc = static_cast<double>(nmb_updated_)*
+                 static_cast<double>(pm->NumberOfMeshBlockCells())*
+                 static_cast<double>(pm->pmb_pack->prad->prgeo->nangles);
+    auto print_row = [&](const std::string &name, double time) {
+      double frac = (exe_time > 0.0)? 100.0*time/exe_time : 0.0;
+      double azcps = (time > 0.0)? azc/time : 0.0;
+      std::cout << std::left << std::setw(24) << name << std::right << std::scientific
+                << std::setprecision(4) << std::setw(13) << time << std::fixed
+                << std::setprecision(2) << std::setw(8) << frac << std::scientific
+                << std::setprecision(4) << std::setw(22) << azcps << std::endl;
+    };
+    std::cout << std::endl << "Radiation profile (" << pm->pmb_pack->prad->prgeo->nangles
+              << " angles, times in seconds averaged over " << global_variable::nranks
+              << " ranks)" << std::endl;
+    std::cout << std::left << std::setw(24) << "part" << std::right << std::setw(13)
+              << "time" << std::setw(8) << "%run" << std::setw(22)
+              << "angle-zone-cycles/s" << std::endl;
+    print_row("flux", rsum[0]);
+    print_row("source", rsum[1]);
+    print_row("comm", rsum[2]);
+    print_row("other", rsum[3]);
+    print_row("total", rsum[0] + rsum[1] + rsum[2] + rsum[3]);
+    print_row("run", exe_time);
+    std::cout << "comm wait time = " << std::scientific << std::setprecision(4)
+              << rsum[4] << std::defaultfloat << std::endl;
   }
   return;
 }
@@ -530,6 +1112,18 @@ void Driver::OutputCycleDiagnostics(Mesh *pm) {
     std::cout << "elapsed=" << std::scientific << std::setprecision(dtprcsn) << elapsed
               << " cycle=" << pm->ncycle
               << " time=" << pm->time << " dt=" << pm->dt << std::endl;
+    // cumulative time in each module on this rank (no reduction, since only called on
+    // rank 0), and total communication wait time
+    if (tl_profile_diag) {
+      std::map<std::string, double> mod_time, mod_wait;
+      ModuleTimes(pm, mod_time, mod_wait);
+      double wait = 0.0;
+      for (auto &it : mod_wait) {wait += it.second;}
+      for (auto &it : tl_stall_time_) {wait += it.second;}
+      std::cout << "  task_time:" << std::setprecision(3);
+      for (auto &it : mod_time) {std::cout << " " << it.first << "=" << it.second;}
+      std::cout << " comm_wait=" << wait << std::endl;
+    }
   }
   return;
 }
@@ -629,6 +1223,7 @@ void Driver::InitBoundaryValuesAndPrimitives(Mesh *pm) {
 
   // Initialize radiation: ghost zones and intensity (everywhere)
   // DOES NOT include communications for shearing box boundaries
+#if RADIATION_ENABLED
   radiation::Radiation *prad = pm->pmb_pack->prad;
   if (prad != nullptr) {
     (void) prad->RestrictI(this, 0);
@@ -640,6 +1235,7 @@ void Driver::InitBoundaryValuesAndPrimitives(Mesh *pm) {
     (void) prad->ApplyPhysicalBCs(this, 0);
     (void) prad->Prolongate(this, 0);
   }
+#endif
 
   return;
 }
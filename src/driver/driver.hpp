@@ -13,6 +13,7 @@
 // called in Finalize().
 
 #include <ctime>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -43,15 +44,33 @@ class Driver {
   Real gam0[4], gam1[4], beta[4];  // weights and fractional timestep per explicit stage
   Real delta[4];                   // weights for updating the intermediate stage (u1)
   Real a_twid[4][4], a_impl;       // matrix elements for implicit stages in ImEx
+  int imp_slot[4];                 // slot in impl_src of R(U) from each implicit stage
+  int nimp_slots;                  // number of slots in impl_src (<= nimp_stages)
   Real cfl_limit;                  // maximum CFL number for integrator
   Real gamma;                      // gamma value for the IMEX_new integrator
+  // variables for operator-split super-time-stepping (STS) of diffusion
+  std::string sts_integrator;      // STS integrator name (none, rkl1, rkl2)
+  int nsts_stages;                 // number of stages in current STS step
+  Real sts_dt;                     // timestep of current STS step
+  Real sts_mu, sts_nu;             // weights of U^{j-1} and U^{j-2} in current STS stage
+  Real sts_mu_tilde, sts_gam_tilde;  // weights of dt*L(U^{j-1}) and dt*L(U^{0})
   Kokkos::Timer* pwall_clock_;     // timer for tracking the wall clock
   Real wall_time;
+  // parameters controlling execution of TaskLists
+  TaskListScheduler tl_scheduler;  // poll (sweep all Tasks) or queue (ready queue)
+  int tl_stall_wait_us;            // microseconds to sleep when all Tasks are waiting
+  bool tl_profile;                 // accumulate timing statistics of each Task
+  bool tl_profile_diag;            // print time per module with cycle diagnostics
+  bool tl_regions;                 // annotate Tasks, outputs, AMR with profiling regions
+  bool async_dt;                   // use non-blocking reduction of new timestep
+  Real io_budget;                  // max fraction of wall time in outputs (0 = no limit)
 
   // functions
   void ExecuteTaskList(Mesh *pm, std::string tl, int stage);
   void Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool rflag);
   void Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout);
+  bool KeepRunning(Mesh *pmesh);
+  void ExecuteCycle(Mesh *pmesh, ParameterInput *pin, Outputs *pout);
   void Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout);
   void InitBoundaryValuesAndPrimitives(Mesh *pm);
 
@@ -60,7 +79,20 @@ class Driver {
   std::uint64_t nmb_updated_;   // running total of MB updated during run
   std::uint64_t npart_updated_; // running total of particles updated during run
   float lb_efficiency_;         // measure of how efficient was load balancing
+  double io_time_start_;        // BaseTypeOutput::io_time when run_time_ was reset
+  // wall time in each TaskList, and time host was stalled waiting on communications in
+  // each TaskList (only accumulated with <tasks>/profile=true)
+  std::map<std::string, double> tl_time_, tl_stall_time_;
   void OutputCycleDiagnostics(Mesh *pm);
+  void OutputIOProfile(Outputs *pout);
+  void OutputTaskProfile(Mesh *pm, float exe_time);
+  void OutputRadiationProfile(Mesh *pm, float exe_time);
+  void ModuleTimes(Mesh *pm, std::map<std::string, double> &time,
+                   std::map<std::string, double> &wait);
+  void MakeOutput(Mesh *pm, ParameterInput *pin, BaseTypeOutput *pout);
+  void SkipOutput(Mesh *pm, ParameterInput *pin, BaseTypeOutput *pout, Real fraction);
+  Real IOFraction();
+  void ExecuteSTS(Mesh *pm, Real dt);
   Real UpdateWallClock();
 };
 #endif // DRIVER_DRIVER_HPP_
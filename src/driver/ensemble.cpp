@@ -0,0 +1,142 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file ensemble.cpp
+//! \brief implementation of functions in Ensemble class
+
+#include <algorithm>
+#include <cstdio>   // snprintf
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+#include "pgen/pgen.hpp"
+#include "driver.hpp"
+#include "ensemble.hpp"
+
+//----------------------------------------------------------------------------------------
+// Ensemble constructor: builds every member, sets its initial conditions and calls
+// Driver::Initialize(), exactly as is done for a single new run in main().
+
+Ensemble::Ensemble(ParameterInput *pin, Real wtlim, Kokkos::Timer* ptimer) {
+  nmember = pin->GetInteger("ensemble", "nmember");
+  std::stringstream dump;
+  pin->ParameterDump(dump);
+  std::string basename = pin->GetString("job", "basename");
+  int width = std::max(3, static_cast<int>(std::to_string(nmember - 1).length()));
+
+  for (int n=0; n<nmember; ++n) {
+    // copy of input parameters, modified by <ensemble>/member<n>
+    ParameterInput *pmem = new ParameterInput;
+    std::istringstream is(dump.str());
+    pmem->LoadFromStream(is);
+    std::string mname = "member" + std::to_string(n);
+    std::string mods;
+    if (pin->DoesParameterExist("ensemble", mname)) {
+      mods = pin->GetString("ensemble", mname);
+    }
+    std::istringstream mod_stream(mods);
+    std::string entry;
+    while (mod_stream >> entry) {
+      std::size_t slash_posn = entry.find_first_of("/");
+      std::size_t equal_posn = entry.find_first_of("=");
+      if ((slash_posn == std::string::npos) || (equal_posn == std::string::npos) ||
+          (equal_posn < slash_posn)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Entry '" << entry << "' in <ensemble>/" << mname
+                  << " is not of the form block/par=value" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      pmem->SetString(entry.substr(0, slash_posn),
+                      entry.substr(slash_posn+1, (equal_posn - slash_posn - 1)),
+                      entry.substr(equal_posn+1, std::string::npos));
+    }
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "_m%0*d", width, n);
+    pmem->SetString("job", "basename", basename + suffix);
+    // restart files of each member contain its own parameters, and restart as a single
+    // simulation
+    pmem->SetInteger("ensemble", "nmember", 1);
+    if (global_variable::my_rank == 0) {
+      std::cout << "Ensemble member " << n << ": " << basename + suffix
+                << (mods.empty()? "" : ", ") << mods << std::endl;
+    }
+
+    Mesh *pm = new Mesh(pmem);
+    pm->BuildTreeFromScratch(pmem);
+    if (n > 0 && (pm->one_d != pmesh_[0]->one_d || pm->two_d != pmesh_[0]->two_d)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Ensemble member " << n << " has a different number of "
+                << "dimensions than member 0" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    pm->AddCoordinatesAndPhysics(pmem);
+    pm->pgen = std::make_unique<ProblemGenerator>(pmem, pm);
+    Driver *pd = new Driver(pmem, pm, wtlim, ptimer);
+    Outputs *po = new Outputs(pmem, pm);
+    pd->Initialize(pm, pmem, po, false);
+
+    pin_.push_back(pmem);
+    pmesh_.push_back(pm);
+    pdriver_.push_back(pd);
+    pout_.push_back(po);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+
+Ensemble::~Ensemble() {
+  for (int n=0; n<nmember; ++n) {
+    delete pout_[n];
+    delete pdriver_[n];
+    delete pmesh_[n];
+    delete pin_[n];
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Ensemble::Execute()
+//! \brief Advances all members one cycle at a time in turn, until every member has
+//! reached its time, cycle or wall clock limit.
+
+void Ensemble::Execute() {
+  if (global_variable::my_rank == 0) {
+    std::cout << "\nSetup of " << nmember << " ensemble members complete, executing "
+              << "task list(s)...\n" << std::endl;
+  }
+  std::vector<bool> running(nmember, true);
+  int nrunning = nmember;
+  while (nrunning > 0) {
+    for (int n=0; n<nmember; ++n) {
+      if (!(running[n])) continue;
+      if (pdriver_[n]->KeepRunning(pmesh_[n])) {
+        pdriver_[n]->ExecuteCycle(pmesh_[n], pin_[n], pout_[n]);
+      } else {
+        running[n] = false;
+        nrunning--;
+      }
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Ensemble::Finalize()
+//! \brief Makes final outputs and prints diagnostics of each member
+
+void Ensemble::Finalize() {
+  for (int n=0; n<nmember; ++n) {
+    pdriver_[n]->Finalize(pmesh_[n], pin_[n], pout_[n]);
+  }
+  return;
+}
@@ -0,0 +1,62 @@
+#ifndef DRIVER_ENSEMBLE_HPP_
+#define DRIVER_ENSEMBLE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file ensemble.hpp
+//! \brief definitions for Ensemble class, which runs many small independent simulations
+//! in one process.
+//!
+//! With <ensemble>/nmember = N > 1 in the input file, N members are constructed, each
+//! with its own copy of the input parameters, Mesh, Driver and Outputs.  Parameters of
+//! member n are modified by <ensemble>/member<n> (n = 0...N-1), a space-separated list
+//! of block/par=value entries in the same format as on the command line, e.g.
+//!
+//!   <ensemble>
+//!   nmember = 3
+//!   member1 = problem/amp=0.02
+//!   member2 = problem/amp=0.04  problem/drat=4.0
+//!
+//! Members are advanced in lock-step, one cycle of each in turn, each with its own
+//! timestep, time and cycle limits, and outputs written with job/basename followed by
+//! "_m" and the member number.  Startup costs (Kokkos and MPI initialization, kernel
+//! tuning) are paid once, and the kernels of small members run back-to-back on the
+//! device.  All members must have the same number of dimensions.  Restarts of ensembles
+//! are not supported; each member writes its own restart files, which can be restarted
+//! individually as normal runs.
+
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+
+class Mesh;
+class Driver;
+class Outputs;
+
+//----------------------------------------------------------------------------------------
+//! \class Ensemble
+
+class Ensemble {
+ public:
+  Ensemble(ParameterInput *pin, Real wtlim, Kokkos::Timer* ptimer);
+  ~Ensemble();
+
+  // data
+  int nmember;     // number of members in ensemble
+
+  // functions
+  void Execute();
+  void Finalize();
+
+ private:
+  std::vector<ParameterInput*> pin_;
+  std::vector<Mesh*> pmesh_;
+  std::vector<Driver*> pdriver_;
+  std::vector<Outputs*> pout_;
+};
+
+#endif // DRIVER_ENSEMBLE_HPP_
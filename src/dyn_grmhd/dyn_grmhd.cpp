@@ -94,7 +94,9 @@ DynGRMHD* BuildDynGRMHD(MeshBlockPack *ppack, ParameterInput *pin) {
   return dyn_gr;
 }
 
-DynGRMHD::DynGRMHD(MeshBlockPack *pp, ParameterInput *pin) : pmy_pack(pp) {
+DynGRMHD::DynGRMHD(MeshBlockPack *pp, ParameterInput *pin) :
+    pmy_pack(pp),
+    face_metric("face_metric",1,1,1,1,1) {
   std::string rsolver = pin->GetString("mhd", "rsolver");
   if (rsolver.compare("llf") == 0) {
     rsolver_method = DynGRMHD_RSolver::llf_dyngr;
@@ -122,6 +124,14 @@ DynGRMHD::DynGRMHD(MeshBlockPack *pp, ParameterInput *pin) : pmy_pack(pp) {
   dmp_M = pin->GetOrAddReal("mhd", "dmp_M", 1.2);
 
   fixed_evolution = pin->GetOrAddBoolean("mhd", "fixed", false);
+
+  // stress-energy tensor computed in c2p kernel rather than a separate pass
+  fused_tmunu = pin->GetOrAddBoolean("mhd", "fused_tmunu", false);
+  tmunu_stale = true;
+
+  // cache of metric at faces is allocated when first computed
+  cache_face_metric = pin->GetOrAddBoolean("mhd", "cache_face_metric", false);
+  face_metric_version = -1;
 }
 
 DynGRMHD::~DynGRMHD() {
@@ -218,6 +228,7 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::PrimToConInit(int is, int ie, int js, i
   if (pmy_pack->ptmunu != nullptr) {
     bool fixed = fixed_evolution;
     fixed_evolution = false;
+    tmunu_stale = true;
     SetTmunu(nullptr, 0);
     fixed_evolution = fixed;
   }
@@ -265,8 +276,15 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::ConToPrim(Driver *pdrive, int sta
   int n1m1 = indcs.nx1 + 2*ng - 1;
   int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
   int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
-  eos.ConsToPrim(pmy_pack->pmhd->u0, pmy_pack->pmhd->b0, pmy_pack->pmhd->bcc0,
-                 pmy_pack->pmhd->w0, 0, n1m1, 0, n2m1, 0, n3m1, false);
+  if (fused_tmunu && pmy_pack->ptmunu != nullptr) {
+    eos.ConsToPrim(pmy_pack->pmhd->u0, pmy_pack->pmhd->b0, pmy_pack->pmhd->bcc0,
+                   pmy_pack->pmhd->w0, 0, n1m1, 0, n2m1, 0, n3m1, false,
+                   &(pmy_pack->ptmunu->tmunu));
+    tmunu_stale = false;
+  } else {
+    eos.ConsToPrim(pmy_pack->pmhd->u0, pmy_pack->pmhd->b0, pmy_pack->pmhd->bcc0,
+                   pmy_pack->pmhd->w0, 0, n1m1, 0, n2m1, 0, n3m1, false);
+  }
   return TaskStatus::complete;
 }
 
@@ -363,11 +381,15 @@ TaskStatus DynGRMHD::ApplyPhysicalBCs(Driver *pdrive, int stage) {
 //----------------------------------------------------------------------------------------
 //! \fn  TaskStatus DynGRMHD::SetTmunu(Driver *pdrive, int stage)
 //! \brief Add the perfect fluid contribution to the stress-energy tensor. This is assumed
-//!  to be the first contribution, so it sets the values rather than adding.
+//!  to be the first contribution, so it sets the values rather than adding.  With
+//!  <mhd>/fused_tmunu the values left by the last ConToPrim() are used unless stale.
 TaskStatus DynGRMHD::SetTmunu(Driver *pdrive, int stage) {
   if (fixed_evolution) {
     return TaskStatus::complete;
   }
+  if (fused_tmunu && !tmunu_stale) {
+    return TaskStatus::complete;
+  }
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   //auto &size  = pmy_pack->pmb->mb_size;
   int &is = indcs.is; int &ie = indcs.ie;
@@ -425,6 +447,7 @@ TaskStatus DynGRMHD::SetTmunu(Driver *pdrive, int stage) {
       }
     }
   });
+  tmunu_stale = false;
   return TaskStatus::complete;
 }
 
@@ -434,9 +457,85 @@ TaskStatus DynGRMHD::SetTmunu(Driver *pdrive, int stage) {
 
 TaskStatus DynGRMHD::SetADMVariables(Driver *pdrive, int stage) {
   pmy_pack->padm->SetADMVariables(pmy_pack);
+  pmy_pack->padm->metric_version++;
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void StoreFaceMetric
+//! \brief stores 3-metric, shift and lapse at a face in the cache used by
+//! adm::CachedFaceMetric()
+
+KOKKOS_INLINE_FUNCTION
+void StoreFaceMetric(const int m, const int k, const int j, const int i,
+                     const Real g3d[NSPMETRIC], const Real beta_u[3], const Real alpha,
+                     const DvceArray5D<Real> &face_metric) {
+  for (int n = 0; n < NSPMETRIC; ++n) {
+    face_metric(m,n,k,j,i) = g3d[n];
+  }
+  for (int a = 0; a < 3; ++a) {
+    face_metric(m,NSPMETRIC+a,k,j,i) = beta_u[a];
+  }
+  face_metric(m,NSPMETRIC+3,k,j,i) = alpha;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void DynGRMHD::UpdateFaceMetric
+//! \brief Recomputes the cache of the 3-metric, shift and lapse at cell faces if the ADM
+//! variables have changed since it was last computed, as tracked by ADM::metric_version.
+//! With a fixed spacetime the cache is computed only once, and when the ADM variables are
+//! updated once per step it is reused by every direction and stage until the next update.
+
+void DynGRMHD::UpdateFaceMetric() {
+  adm::ADM *padm = pmy_pack->padm;
+  if (!(cache_face_metric) || face_metric_version == padm->metric_version) {return;}
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb = pmy_pack->nmb_thispack;
+  if (face_metric.x1f.extent_int(0) != nmb ||
+      face_metric.x1f.extent_int(4) != ncells1+1) {
+    face_metric = DvceFaceFld5D<Real>("face_metric", nmb, NSPMETRIC+4,
+                                      ncells3, ncells2, ncells1);
+  }
+  auto &adm = padm->adm;
+
+  auto fmet1 = face_metric.x1f;
+  par_for("face_metric_x1", DevExeSpace(), 0, nmb-1, 0, ncells3-1, 0, ncells2-1,
+          1, ncells1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real g3d[NSPMETRIC], beta_u[3], alpha;
+    adm::Face1Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+    StoreFaceMetric(m, k, j, i, g3d, beta_u, alpha, fmet1);
+  });
+
+  if (pmy_pack->pmesh->multi_d) {
+    auto fmet2 = face_metric.x2f;
+    par_for("face_metric_x2", DevExeSpace(), 0, nmb-1, 0, ncells3-1, 1, ncells2-1,
+            0, ncells1-1,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      Real g3d[NSPMETRIC], beta_u[3], alpha;
+      adm::Face2Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+      StoreFaceMetric(m, k, j, i, g3d, beta_u, alpha, fmet2);
+    });
+  }
+
+  if (pmy_pack->pmesh->three_d) {
+    auto fmet3 = face_metric.x3f;
+    par_for("face_metric_x3", DevExeSpace(), 0, nmb-1, 1, ncells3-1, 0, ncells2-1,
+            0, ncells1-1,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      Real g3d[NSPMETRIC], beta_u[3], alpha;
+      adm::Face3Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+      StoreFaceMetric(m, k, j, i, g3d, beta_u, alpha, fmet3);
+    });
+  }
+  face_metric_version = padm->metric_version;
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Z4c::UpdateExcisionMasks
 //! \brief
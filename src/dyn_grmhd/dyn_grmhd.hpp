@@ -100,12 +100,24 @@ class DynGRMHD {
   DynGRMHD_EOS eos_policy;
   DynGRMHD_Error error_policy;
 
+  // If fused_tmunu is set, the stress-energy tensor is written by the c2p kernel in
+  // ConToPrim() and the SetTmunu task only recomputes it when tmunu_stale (e.g. after
+  // the MeshBlocks have been refined).
+  bool fused_tmunu;
+  bool tmunu_stale;
+
  protected:
   MeshBlockPack *pmy_pack;  // ptr to MeshBlockPack containing this Hydro
   int scratch_level;        // GPU scratch level for flux and source calculations
   bool enforce_maximum;     // enforce local maximum principle during FOFC
   Real dmp_M;               // threshold multiplier for discrete maximum principle.
   bool fixed_evolution;     // Disable mhd evolution
+
+  // cache of 3-metric, shift and lapse at faces (see UpdateFaceMetric())
+  bool cache_face_metric;           // use cached values in Riemann solvers
+  int face_metric_version;          // ADM::metric_version when cache last computed
+  DvceFaceFld5D<Real> face_metric;  // g_dd[NSPMETRIC], beta_u[3], alpha at faces
+  void UpdateFaceMetric();
 };
 
 template<class EOSPolicy, class ErrorPolicy>
@@ -64,6 +64,13 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
     return TaskStatus::complete;
   }
 
+  // metric at faces is read from the cache (if enabled) or interpolated in the solvers
+  UpdateFaceMetric();
+  const bool use_fmet = cache_face_metric;
+  auto &fmet1_ = face_metric.x1f;
+  auto &fmet2_ = face_metric.x2f;
+  auto &fmet3_ = face_metric.x3f;
+
   //--------------------------------------------------------------------------------------
   // i-direction
 
@@ -137,11 +144,11 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
     //int il = is; int iu = ie+1;
     if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
       LLF_DYNGR<IVX>(member, dyn_eos, indcs, size, coord, m, k, j, il, iu,
-                wl, wr, bl, br, bx, nhyd_, nscal_, adm_,
+                wl, wr, bl, br, bx, nhyd_, nscal_, adm_, fmet1_, use_fmet,
                 flx1, e31, e21);
     } else if constexpr (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
       HLLE_DYNGR<IVX>(member, dyn_eos, indcs, size, coord, m, k, j, il, iu,
-                wl, wr, bl, br, bx, nhyd_, nscal_, adm_,
+                wl, wr, bl, br, bx, nhyd_, nscal_, adm_, fmet1_, use_fmet,
                 flx1, e31, e21);
     }
     member.team_barrier();
@@ -250,10 +257,12 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
         if (j>(jl)) {
           if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
             LLF_DYNGR<IVY>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, by, nhyd_, nscal_, adm_, flx2, e12, e32);
+                      wl, wr, bl, br, by, nhyd_, nscal_, adm_, fmet2_, use_fmet,
+                      flx2, e12, e32);
           } else if constexpr (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
             HLLE_DYNGR<IVY>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, by, nhyd_, nscal_, adm_, flx2, e12, e32);
+                      wl, wr, bl, br, by, nhyd_, nscal_, adm_, fmet2_, use_fmet,
+                      flx2, e12, e32);
           }
         }
         member.team_barrier();
@@ -358,10 +367,12 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
         if (k>(kl)) {
           if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
             LLF_DYNGR<IVZ>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, bz, nhyd_, nscal_, adm_, flx3, e23, e13);
+                      wl, wr, bl, br, bz, nhyd_, nscal_, adm_, fmet3_, use_fmet,
+                      flx3, e23, e13);
           } else if constexpr (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
             HLLE_DYNGR<IVZ>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, bz, nhyd_, nscal_, adm_, flx3, e23, e13);
+                      wl, wr, bl, br, bz, nhyd_, nscal_, adm_, fmet3_, use_fmet,
+                      flx3, e23, e13);
           }
         }
         member.team_barrier();
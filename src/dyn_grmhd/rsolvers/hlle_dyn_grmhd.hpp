@@ -130,6 +130,7 @@ void HLLE_DYNGR(TeamMember_t const &member,
      const ScrArray2D<Real> &bl, const ScrArray2D<Real> &br, const DvceArray4D<Real> &bx,
      const int& nhyd, const int& nscal,
      const adm::ADM::ADM_vars& adm,
+     const DvceArray5D<Real> &face_metric, const bool use_face_metric,
      DvceArray5D<Real> flx, DvceArray4D<Real> ey, DvceArray4D<Real> ez) {
   par_for_inner(member, il, iu, [&](const int i) {
     constexpr int ibx = ivx - IVX;
@@ -147,7 +148,9 @@ void HLLE_DYNGR(TeamMember_t const &member,
     Real g3d[NSPMETRIC];
     Real beta_u[3];
     Real alpha;
-    if constexpr (ivx == IVX) {
+    if (use_face_metric) {
+      adm::CachedFaceMetric(m, k, j, i, face_metric, g3d, beta_u, alpha);
+    } else if constexpr (ivx == IVX) {
       adm::Face1Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
     } else if (ivx == IVY) {
       adm::Face2Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
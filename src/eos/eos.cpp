@@ -23,6 +23,12 @@ EquationOfState::EquationOfState(std::string bk, MeshBlockPack* pp, ParameterInp
   eos_data.pfloor = pin->GetOrAddReal(bk,"pfloor",(FLT_MIN));
   eos_data.tfloor = pin->GetOrAddReal(bk,"tfloor",(FLT_MIN));
   eos_data.sfloor = pin->GetOrAddReal(bk,"sfloor",(FLT_MIN));
+
+  use_tiled_c2p = pin->GetOrAddBoolean(bk,"c2p_tiled",false);
+  use_c2p_hist = pin->GetOrAddBoolean(bk,"c2p_iter_histogram",false);
+  if (use_c2p_hist) {
+    pp->pmesh->ecounter.c2p_hist_used = true;
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -43,6 +49,25 @@ void EquationOfState::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Re
                                  const int kl, const int ku) {
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void ConsToPrimNewDt()
+//! \brief No-Op versions of hydro and MHD conservative to primitive functions which also
+//! compute the timestep.  Only overridden by non-relativistic ideal gas EOS.
+
+void EquationOfState::ConsToPrimNewDt(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
+                                      const int il, const int iu, const int jl,
+                                      const int ju, const int kl, const int ku,
+                                      Real dt[3]) {
+}
+
+void EquationOfState::ConsToPrimNewDt(DvceArray5D<Real> &cons,
+                                      const DvceFaceFld4D<Real> &b,
+                                      DvceArray5D<Real> &prim, DvceArray5D<Real> &bcc,
+                                      const int il, const int iu, const int jl,
+                                      const int ju, const int kl, const int ku,
+                                      Real dt[3]) {
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void PrimToCon()
 //! \brief No-Op versions of hydro and MHD primitive to conservative functions.
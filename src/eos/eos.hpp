@@ -203,6 +203,13 @@ class EquationOfState {
   MeshBlockPack* pmy_pack;
   EOS_Data eos_data;
 
+  // optional tiled c2p (only used by non-relativistic ideal gas EOS), in which each team
+  // streams a row of cells into scratch in SoA form before solving.
+  bool use_tiled_c2p = false;
+  // optional histogram of iterations used by the c2p solver in each cell (SR/GR only),
+  // accumulated with the other event counters on the device
+  bool use_c2p_hist = false;
+
   // virtual functions to convert cons to prim in either Hydro or MHD (depending on
   // arguments), overwritten in derived eos classes
   virtual void ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
@@ -214,6 +221,16 @@ class EquationOfState {
                           const bool only_testfloors,
                           const int il, const int iu, const int jl, const int ju,
                           const int kl, const int ku);
+  // versions which also return the minimum of dx/(|v|+c) in each direction over the
+  // active zone (c the sound or fast speed), used with <hydro>/c2p_dt or <mhd>/c2p_dt.
+  // Only implemented for the non-relativistic ideal gas EOS.
+  virtual void ConsToPrimNewDt(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
+                               const int il, const int iu, const int jl, const int ju,
+                               const int kl, const int ku, Real dt[3]);
+  virtual void ConsToPrimNewDt(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
+                               DvceArray5D<Real> &prim, DvceArray5D<Real> &bcc,
+                               const int il, const int iu, const int jl, const int ju,
+                               const int kl, const int ku, Real dt[3]);
 
   // virtual functions to convert prim to cons in either Hydro or MHD (depending on
   // arguments), overwritten in derived eos classes.
@@ -253,6 +270,7 @@ class IdealHydro : public EquationOfState {
  public:
   // Following suppress warnings that MHD versions are not over-ridden
   using EquationOfState::ConsToPrim;
+  using EquationOfState::ConsToPrimNewDt;
   using EquationOfState::PrimToCons;
 
   IdealHydro(MeshBlockPack *pp, ParameterInput *pin);
@@ -260,6 +278,13 @@ class IdealHydro : public EquationOfState {
                   const bool only_testfloors,
                   const int il, const int iu, const int jl, const int ju,
                   const int kl, const int ku) override;
+  void ConsToPrimNewDt(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
+                       const int il, const int iu, const int jl, const int ju,
+                       const int kl, const int ku, Real dt[3]) override;
+  void ConsToPrimTiled(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
+                       const bool only_testfloors,
+                       const int il, const int iu, const int jl, const int ju,
+                       const int kl, const int ku);
   void PrimToCons(const DvceArray5D<Real> &prim, DvceArray5D<Real> &cons,
                   const int il, const int iu, const int jl, const int ju,
                   const int kl, const int ku) override;
@@ -334,6 +359,7 @@ class IdealMHD : public EquationOfState {
  public:
   // Following suppress warnings that Hydro versions are not over-ridden
   using EquationOfState::ConsToPrim;
+  using EquationOfState::ConsToPrimNewDt;
   using EquationOfState::PrimToCons;
 
   IdealMHD(MeshBlockPack *pp, ParameterInput *pin);
@@ -342,6 +368,15 @@ class IdealMHD : public EquationOfState {
                   const bool only_testfloors,
                   const int il, const int iu, const int jl, const int ju,
                   const int kl, const int ku) override;
+  void ConsToPrimNewDt(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
+                       DvceArray5D<Real> &prim, DvceArray5D<Real> &bcc,
+                       const int il, const int iu, const int jl, const int ju,
+                       const int kl, const int ku, Real dt[3]) override;
+  void ConsToPrimTiled(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
+                       DvceArray5D<Real> &prim, DvceArray5D<Real> &bcc,
+                       const bool only_testfloors,
+                       const int il, const int iu, const int jl, const int ju,
+                       const int kl, const int ku);
   void PrimToCons(const DvceArray5D<Real> &prim, const DvceArray5D<Real> &bcc,
                   DvceArray5D<Real> &cons, const int il, const int iu,
                   const int jl, const int ju, const int kl, const int ku) override;
@@ -379,6 +414,14 @@ class IdealGRMHD : public EquationOfState {
   using EquationOfState::PrimToCons;
 
   IdealGRMHD(MeshBlockPack *pp, ParameterInput *pin);
+
+  // optional two-pass c2p: cells that fail to converge in fast_iter_c2p iterations are
+  // compacted into c2p_list and solved again in a second pass
+  bool two_pass_c2p;
+  int fast_iter_c2p;
+  DvceArray1D<int> c2p_list;
+  DualArray1D<int> c2p_nlist;
+
   void ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
                   DvceArray5D<Real> &prim, DvceArray5D<Real> &bcc,
                   const bool only_testfloors,
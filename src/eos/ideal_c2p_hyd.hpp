@@ -82,6 +82,18 @@ void SingleP2C_IdealHyd(const HydPrim1D &w, HydCons1D &u) {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \struct SRHydC2PInvariants
+//! \brief Quantities that are constant during the root find in a single cell, computed
+//! once before iterating rather than in every evaluation of EquationC22()
+
+struct SRHydC2PInvariants {
+  Real ud, q, r;     // D, and q and r of eq. C2
+  Real gam, gm1;
+  Real pfloor_d;     // pfloor/(D*gm1), so the pressure floor on eps is pfloor_d*W
+  Real sfloor_gm1;   // sfloor/gm1, entropy floor (pow() is skipped when zero)
+};
+
 //----------------------------------------------------------------------------------------
 //! \fn Real EquationC22()
 //! \brief Inline function to compute function f(z) defined in eq. C22 of Galeazzi et al.
@@ -89,15 +101,16 @@ void SingleP2C_IdealHyd(const HydPrim1D &w, HydCons1D &u) {
 //! The ConsToPrim algorithm finds the root of this function f(z)=0
 
 KOKKOS_INLINE_FUNCTION
-Real EquationC22(Real z, Real &u_d, Real q, Real r, EOS_Data eos) {
-  Real const gm1 = eos.gamma - 1.0;
-  Real const w = sqrt(1.0 + z*z);         // (C15)
-  Real const wd = u_d/w;                  // (C15)
-  Real eps = w*q - z*r + (z*z)/(1.0 + w); // (C16)
-  Real epsmin = fmax(eos.pfloor/(wd*gm1), eos.sfloor*pow(wd, gm1)/gm1);
-  eps = fmax(eps, epsmin);                // (C18)
-  Real const h = 1.0 + eos.gamma*eps;     // (C1) & (C21)
-  return (z - r/h); // (C22)
+Real EquationC22(const Real z, const SRHydC2PInvariants &c) {
+  Real const w = sqrt(1.0 + z*z);             // (C15)
+  Real eps = w*c.q - z*c.r + (z*z)/(1.0 + w); // (C16)
+  Real epsmin = c.pfloor_d*w;
+  if (c.sfloor_gm1 > 0.0) {
+    epsmin = fmax(epsmin, c.sfloor_gm1*pow(c.ud/w, c.gm1));  // W*rho = D (C15)
+  }
+  eps = fmax(eps, epsmin);                    // (C18)
+  Real const h = 1.0 + c.gam*eps;             // (C1) & (C21)
+  return (z - c.r/h); // (C22)
 }
 
 //----------------------------------------------------------------------------------------
@@ -132,6 +145,14 @@ void SingleC2P_IdealSRHyd(HydCons1D &u, const EOS_Data &eos, const Real s2, HydP
   Real q = u.e/u.d;
   Real r = sqrt(s2)/u.d;
   Real kk = r/(1.+q);
+  SRHydC2PInvariants c;
+  c.ud = u.d;
+  c.q = q;
+  c.r = r;
+  c.gam = eos.gamma;
+  c.gm1 = gm1;
+  c.pfloor_d = eos.pfloor/(u.d*gm1);
+  c.sfloor_gm1 = eos.sfloor/gm1;
 
   // Enforce lower velocity bound (eq. C13). This bound combined with a floor on
   // the value of p will guarantee "some" result of the inversion
@@ -142,8 +163,8 @@ void SingleC2P_IdealSRHyd(HydCons1D &u, const EOS_Data &eos, const Real s2, HydP
   Real zp = kk/sqrt(1.0 - kk*kk);
 
   // Evaluate master function (eq C22) at bracket values
-  Real fm = EquationC22(zm, u.d, q, r, eos);
-  Real fp = EquationC22(zp, u.d, q, r, eos);
+  Real fm = EquationC22(zm, c);
+  Real fp = EquationC22(zp, c);
 
   // For simplicity on the GPU, find roots using the false position method
   int iterations = max_iterations;
@@ -155,7 +176,7 @@ void SingleC2P_IdealSRHyd(HydCons1D &u, const EOS_Data &eos, const Real s2, HydP
 
   for (iter_used=0; iter_used < iterations; ++iter_used) {
     z =  (zm*fp - zp*fm)/(fp-fm);  // linear interpolation to point f(z)=0
-    Real f = EquationC22(z, u.d, q, r, eos);
+    Real f = EquationC22(z, c);
 
     // Quit if convergence reached
     // NOTE: both z and f are of order unity
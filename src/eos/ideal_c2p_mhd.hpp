@@ -82,6 +82,19 @@ void SingleP2C_IdealMHD(const MHDPrim1D &w, HydCons1D &u) {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \struct SRMHDC2PInvariants
+//! \brief Quantities that are constant during both root finds in a single cell,
+//! computed once before iterating rather than in every evaluation of Equation44/49()
+
+struct SRMHDC2PInvariants {
+  Real b2, r2, rpar2;  // b^2, r^2 and r_par^2, normalized by D (eq. 22-25)
+  Real qb;             // q - b^2/2, see eq. 31
+  Real ud, gam, gm1;
+  Real pfloor_d;       // pfloor/(D*gm1), so the pressure floor on eps is pfloor_d*W
+  Real sfloor_gm1;     // sfloor/gm1, entropy floor (pow() is skipped when zero)
+};
+
 //----------------------------------------------------------------------------------------
 //! \fn Real Equation49()
 //! \brief Inline function to compute function fa(mu) defined in eq. 49 of Kastaun et al.
@@ -89,9 +102,9 @@ void SingleP2C_IdealMHD(const MHDPrim1D &w, HydCons1D &u) {
 //! solving Equation44
 
 KOKKOS_INLINE_FUNCTION
-Real Equation49(const Real mu, const Real b2, const Real rp, const Real r, const Real q) {
-  Real const x = 1.0/(1.0 + mu*b2);             // (26)
-  Real rbar = (x*x*r*r + mu*x*(1.0 + x)*rp*rp); // (38)
+Real Equation49(const Real mu, const SRMHDC2PInvariants &c) {
+  Real const x = 1.0/(1.0 + mu*c.b2);                // (26)
+  Real rbar = (x*x*c.r2 + mu*x*(1.0 + x)*c.rpar2);   // (38)
   return mu*sqrt(1.0 + rbar) - 1.0;
 }
 
@@ -101,20 +114,21 @@ Real Equation49(const Real mu, const Real b2, const Real rp, const Real r, const
 //! The ConsToPrim algorithms finds the root of this function f(mu)=0
 
 KOKKOS_INLINE_FUNCTION
-Real Equation44(const Real mu, const Real b2, const Real rpar, const Real r, const Real q,
-                const Real u_d,  EOS_Data eos) {
-  Real const x = 1./(1.+mu*b2);                    // (26)
-  Real rbar = (x*x*r*r + mu*x*(1.+x)*rpar*rpar);   // (38)
-  Real qbar = q - 0.5*b2 - 0.5*(mu*mu*(b2*rbar- rpar*rpar)); // (31)
-  Real z2 = (mu*mu*rbar/(fabs(1.- SQR(mu)*rbar))); // (32)
+Real Equation44(const Real mu, const SRMHDC2PInvariants &c) {
+  Real const x = 1./(1.+mu*c.b2);                    // (26)
+  Real rbar = (x*x*c.r2 + mu*x*(1.+x)*c.rpar2);      // (38)
+  Real const mu2 = mu*mu;
+  Real qbar = c.qb - 0.5*(mu2*(c.b2*rbar - c.rpar2)); // (31)
+  Real z2 = (mu2*rbar/(fabs(1.- mu2*rbar)));         // (32)
   Real w = sqrt(1.+z2);
-  Real const wd = u_d/w;                           // (34)
   Real eps = w*(qbar - mu*rbar) + z2/(w+1.);
-  Real const gm1 = eos.gamma - 1.0;
-  Real epsmin = fmax(eos.pfloor/(wd*gm1), eos.sfloor*pow(wd, gm1)/gm1);
+  Real epsmin = c.pfloor_d*w;
+  if (c.sfloor_gm1 > 0.0) {
+    epsmin = fmax(epsmin, c.sfloor_gm1*pow(c.ud/w, c.gm1));  // W*rho = D (34)
+  }
   eps = fmax(eps, epsmin);
-  Real const h = 1.0 + eos.gamma*eps;              // (43)
-  return mu - 1./(h/w + rbar*mu);                  // (45)
+  Real const h = 1.0 + c.gam*eps;                    // (43)
+  return mu - 1./(h/w + rbar*mu);                    // (45)
 }
 
 //----------------------------------------------------------------------------------------
@@ -122,13 +136,14 @@ Real Equation44(const Real mu, const Real b2, const Real rpar, const Real r, con
 //! \brief Converts single state of conserved variables into primitive variables for
 //! special relativistic MHD with an ideal gas EOS. Note input CONSERVED state contains
 //! cell-centered magnetic fields, but PRIMITIVE state returned via arguments does not.
+//! A C2P failure is returned if either root find does not converge in max_iterations.
 
 KOKKOS_INLINE_FUNCTION
 void SingleC2P_IdealSRMHD(MHDCons1D &u, const EOS_Data &eos, Real s2, Real b2, Real rpar,
                           HydPrim1D &w, bool &dfloor_used, bool &efloor_used,
-                          bool &c2p_failure, int &max_iter) {
+                          bool &c2p_failure, int &max_iter,
+                          const int max_iterations = 25) {
   // Parameters
-  const int max_iterations = 25;
   const Real tol = 1.0e-12;
   const Real gm1 = eos.gamma - 1.0;
 
@@ -155,14 +170,24 @@ void SingleC2P_IdealSRMHD(MHDCons1D &u, const EOS_Data &eos, Real s2, Real b2, R
   // normalize b2 and rpar as well since they contain b
   b2 /= u.d;
   rpar *= isqrtd;
+  SRMHDC2PInvariants c;
+  c.b2 = b2;
+  c.r2 = r*r;
+  c.rpar2 = rpar*rpar;
+  c.qb = q - 0.5*b2;
+  c.ud = u.d;
+  c.gam = eos.gamma;
+  c.gm1 = gm1;
+  c.pfloor_d = eos.pfloor/(u.d*gm1);
+  c.sfloor_gm1 = eos.sfloor/gm1;
 
   // Need to find initial bracket. Requires separate solve
   Real zm=0.;
   Real zp=1.; // This is the lowest specific enthalpy admitted by the EOS
 
   // Evaluate master function (eq 49) at bracket values
-  Real fm = Equation49(zm, b2, rpar, r, q);
-  Real fp = Equation49(zp, b2, rpar, r, q);
+  Real fm = Equation49(zm, c);
+  Real fp = Equation49(zp, c);
 
   // For simplicity on the GPU, find roots using the false position method
   int iterations = max_iterations;
@@ -175,7 +200,7 @@ void SingleC2P_IdealSRMHD(MHDCons1D &u, const EOS_Data &eos, Real s2, Real b2, R
   int iter;
   for (iter=0; iter<iterations; ++iter) {
     z =  (zm*fp - zp*fm)/(fp-fm);  // linear interpolation to point f(z)=0
-    Real f = Equation49(z, b2, rpar, r, q);
+    Real f = Equation49(z, c);
     // Quit if convergence reached
     // NOTE(@ermost): both z and f are of order unity
     if ((fabs(zm-zp) < tol) || (fabs(f) < tol)) {
@@ -201,8 +226,8 @@ void SingleC2P_IdealSRMHD(MHDCons1D &u, const EOS_Data &eos, Real s2, Real b2, R
   zp= z;
 
   // Evaluate master function (eq 44) at bracket values
-  fm = Equation44(zm, b2, rpar, r, q, u.d, eos);
-  fp = Equation44(zp, b2, rpar, r, q, u.d, eos);
+  fm = Equation44(zm, c);
+  fp = Equation44(zp, c);
 
   iterations = max_iterations;
   if ((fabs(zm-zp) < tol) || ((fabs(fm) + fabs(fp)) < 2.0*tol)) {
@@ -212,7 +237,7 @@ void SingleC2P_IdealSRMHD(MHDCons1D &u, const EOS_Data &eos, Real s2, Real b2, R
 
   for (iter=0; iter<iterations; ++iter) {
     z = (zm*fp - zp*fm)/(fp-fm);  // linear interpolation to point f(z)=0
-    Real f = Equation44(z, b2, rpar, r, q, u.d, eos);
+    Real f = Equation44(z, c);
     // Quit if convergence reached
     // NOTE: both z and f are of order unity
     if ((fabs(zm-zp) < tol) || (fabs(f) < tol)) {
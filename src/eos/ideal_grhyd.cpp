@@ -49,10 +49,16 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   int &nmb = pmy_pack->nmb_thispack;
   auto &fofc_ = pmy_pack->phydro->fofc;
   auto eos = eos_data;
+  // c2p iterations are counted on each MeshBlock for measured load balancing
+  auto &mb_work_ = pmy_pack->pmb->mb_work;
+  const bool count_work = (pmy_pack->pmesh->count_mb_work) && !(only_testfloors);
   Real gm1 = eos_data.gamma - 1.0;
 
+  pmy_pack->pcoord->UpdateMetricCache();
   auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
   auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+  auto &use_cache = pmy_pack->pcoord->coord_data.metric_cache;
+  auto &ks_cc = pmy_pack->pcoord->coord_data.ks_cc;
   auto &use_excise = pmy_pack->pcoord->coord_data.bh_excise;
   auto &excision_floor_ = pmy_pack->pcoord->excision_floor;
   auto &excision_flux_ = pmy_pack->pcoord->excision_flux;
@@ -64,9 +70,14 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   const int nkji = (ku - kl + 1)*nji;
   const int nmkji = nmb*nkji;
 
-  int nfloord_=0, nfloore_=0, nceilv_=0, nfail_=0, maxit_=0;
-  Kokkos::parallel_reduce("grhyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumv, int &sumf, int &max_it) {
+  // event counters on the device, including histogram of iterations used in each cell
+  // (if requested)
+  auto &counts_ = pmy_pack->pmesh->ecounter.dcounts;
+  const bool count_hist = use_c2p_hist && !(only_testfloors);
+  const int nhist = EventCounters::nc2p_hist;
+
+  Kokkos::parallel_for("grhyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx) {
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
     int j = (idx - m*nkji - k*nji)/ni;
@@ -96,7 +107,11 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    if (use_cache) {
+      CachedMetricAndInverse(ks_cc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    }
 
     HydPrim1D w;
     bool dfloor_used=false, efloor_used=false;
@@ -152,14 +167,29 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
     if (only_testfloors) {
       if (dfloor_used || efloor_used || vceiling_used || c2p_failure) {
         fofc_(m,k,j,i) = true;
-        sumd++;  // use dfloor as counter for when either is true
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::ifofc));
       }
     } else {
-      if (dfloor_used) {sumd++;}
-      if (efloor_used) {sume++;}
-      if (vceiling_used) {sumv++;}
-      if (c2p_failure) {sumf++;}
-      max_it = (iter_used > max_it) ? iter_used : max_it;
+      if (dfloor_used) {
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::idfloor));
+      }
+      if (efloor_used) {
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::iefloor));
+      }
+      if (vceiling_used) {
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::ivceil));
+      }
+      if (c2p_failure) {
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::ifail));
+      }
+      Kokkos::atomic_max(&counts_.d_view(EventCounters::imaxit), iter_used);
+      if (count_hist) {
+        int nbin = (iter_used < nhist)? iter_used : nhist-1;
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::ic2p_hist + nbin));
+      }
+      if (count_work && (iter_used > 0)) {
+        Kokkos::atomic_add(&mb_work_.d_view(m), static_cast<Real>(iter_used));
+      }
 
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
@@ -183,19 +213,7 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
         prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
       }
     }
-  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nceilv_),
-     Kokkos::Sum<int>(nfail_), Kokkos::Max<int>(maxit_));
-
-  // store appropriate counters
-  if (only_testfloors) {
-    pmy_pack->pmesh->ecounter.nfofc += nfloord_;
-  } else {
-    pmy_pack->pmesh->ecounter.neos_dfloor += nfloord_;
-    pmy_pack->pmesh->ecounter.neos_efloor += nfloore_;
-    pmy_pack->pmesh->ecounter.neos_vceil  += nceilv_;
-    pmy_pack->pmesh->ecounter.neos_fail   += nfail_;
-    pmy_pack->pmesh->ecounter.maxit_c2p = maxit_;
-  }
+  });
 
   return;
 }
@@ -211,8 +229,11 @@ void IdealGRHydro::PrimToCons(const DvceArray5D<Real> &prim, DvceArray5D<Real> &
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &js = indcs.js, &ks = indcs.ks;
   auto &size = pmy_pack->pmb->mb_size;
+  pmy_pack->pcoord->UpdateMetricCache();
   auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
   auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+  auto &use_cache = pmy_pack->pcoord->coord_data.metric_cache;
+  auto &ks_cc = pmy_pack->pcoord->coord_data.ks_cc;
   int &nhyd  = pmy_pack->phydro->nhydro;
   int &nscal = pmy_pack->phydro->nscalars;
   int &nmb = pmy_pack->nmb_thispack;
@@ -234,7 +255,11 @@ void IdealGRHydro::PrimToCons(const DvceArray5D<Real> &prim, DvceArray5D<Real> &
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    if (use_cache) {
+      CachedMetricAndInverse(ks_cc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    }
 
     // Load single state of primitive variables
     HydPrim1D w;
@@ -28,6 +28,12 @@ IdealGRMHD::IdealGRMHD(MeshBlockPack *pp, ParameterInput *pin) :
   eos_data.use_e = true;  // ideal gas EOS always uses internal energy
   eos_data.use_t = false;
   eos_data.gamma_max = pin->GetOrAddReal("mhd","gamma_max",(FLT_MAX));  // gamma ceiling
+  two_pass_c2p = pin->GetOrAddBoolean("mhd","c2p_two_pass",false);
+  fast_iter_c2p = pin->GetOrAddInteger("mhd","c2p_fast_iter",8);
+  if (two_pass_c2p) {
+    c2p_list = DvceArray1D<int>("c2p_list", 1);
+    c2p_nlist = DualArray1D<int>("c2p_nlist", 1);
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -48,10 +54,16 @@ void IdealGRMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &
   int &nmb = pmy_pack->nmb_thispack;
   auto &fofc_ = pmy_pack->pmhd->fofc;
   auto eos = eos_data;
+  // c2p iterations are counted on each MeshBlock for measured load balancing
+  auto &mb_work_ = pmy_pack->pmb->mb_work;
+  const bool count_work = (pmy_pack->pmesh->count_mb_work) && !(only_testfloors);
   Real gm1 = eos_data.gamma - 1.0;
 
+  pmy_pack->pcoord->UpdateMetricCache();
   auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
   auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+  auto &use_cache = pmy_pack->pcoord->coord_data.metric_cache;
+  auto &ks_cc = pmy_pack->pcoord->coord_data.ks_cc;
   auto &use_excise = pmy_pack->pcoord->coord_data.bh_excise;
   auto &excision_floor_ = pmy_pack->pcoord->excision_floor;
   auto &excision_flux_ = pmy_pack->pcoord->excision_flux;
@@ -63,167 +75,215 @@ void IdealGRMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &
   const int nkji = (ku - kl + 1)*nji;
   const int nmkji = nmb*nkji;
 
-  int nfloord_=0, nfloore_=0, nceilv_=0, nfail_=0, maxit_=0;
-  Kokkos::parallel_reduce("grmhd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumv, int &sumf, int &max_it) {
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/ni;
-    int i = (idx - m*nkji - k*nji - j*ni) + il;
-    j += jl;
-    k += kl;
-
-    // load single state conserved variables
-    MHDCons1D u;
-    u.d  = cons(m,IDN,k,j,i);
-    u.mx = cons(m,IM1,k,j,i);
-    u.my = cons(m,IM2,k,j,i);
-    u.mz = cons(m,IM3,k,j,i);
-    u.e  = cons(m,IEN,k,j,i);
-
-    // load cell-centered fields into conserved state
-    // use input CC fields if only testing floors with FOFC
-    if (only_testfloors) {
-      u.bx = bcc(m,IBX,k,j,i);
-      u.by = bcc(m,IBY,k,j,i);
-      u.bz = bcc(m,IBZ,k,j,i);
-    // else use simple linear average of face-centered fields
-    } else {
-      u.bx = 0.5*(b.x1f(m,k,j,i) + b.x1f(m,k,j,i+1));
-      u.by = 0.5*(b.x2f(m,k,j,i) + b.x2f(m,k,j+1,i));
-      u.bz = 0.5*(b.x3f(m,k,j,i) + b.x3f(m,k+1,j,i));
+  // event counters on the device, including histogram of iterations used in each cell
+  // (if requested)
+  auto &counts_ = pmy_pack->pmesh->ecounter.dcounts;
+  const bool count_hist = use_c2p_hist && !(only_testfloors);
+  const int nhist = EventCounters::nc2p_hist;
+
+  // With the two-pass c2p, the first pass uses at most fast_iter_c2p iterations, and
+  // cells that fail to converge are compacted into a work list and solved in a second
+  // pass with the default iteration limit.  This avoids warps on GPUs waiting for the
+  // few slow (atmosphere, near-horizon) cells in each warp.
+  const int npass = (two_pass_c2p)? 2 : 1;
+  const int max_iter_default = 25;  // default in SingleC2P_IdealSRMHD()
+  if (two_pass_c2p) {
+    if (c2p_list.extent_int(0) < nmkji) {
+      Kokkos::realloc(c2p_list, nmkji);
     }
+    Kokkos::deep_copy(c2p_nlist.d_view, 0);
+  }
+  auto &list_ = c2p_list;
+  auto &nlist_ = c2p_nlist;
+
+  for (int pass=0; pass<npass; ++pass) {
+    int ncells = nmkji;
+    if (pass == 1) {
+      nlist_.template modify<DevExeSpace>();
+      nlist_.template sync<HostMemSpace>();
+      ncells = nlist_.h_view(0);
+    }
+    const bool use_list = (pass == 1);
+    const bool defer = (pass == 0) && two_pass_c2p;
+    const int maxit_pass = (defer)? fast_iter_c2p : max_iter_default;
+
+    Kokkos::parallel_for((use_list)? "grmhd_c2p_retry" : "grmhd_c2p",
+    Kokkos::RangePolicy<>(DevExeSpace(), 0, ncells),
+    KOKKOS_LAMBDA(const int &lidx) {
+      const int idx = (use_list)? list_(lidx) : lidx;
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/ni;
+      int i = (idx - m*nkji - k*nji - j*ni) + il;
+      j += jl;
+      k += kl;
+
+      // load single state conserved variables
+      MHDCons1D u;
+      u.d  = cons(m,IDN,k,j,i);
+      u.mx = cons(m,IM1,k,j,i);
+      u.my = cons(m,IM2,k,j,i);
+      u.mz = cons(m,IM3,k,j,i);
+      u.e  = cons(m,IEN,k,j,i);
+
+      // load cell-centered fields into conserved state
+      // use input CC fields if only testing floors with FOFC
+      if (only_testfloors) {
+        u.bx = bcc(m,IBX,k,j,i);
+        u.by = bcc(m,IBY,k,j,i);
+        u.bz = bcc(m,IBZ,k,j,i);
+      // else use simple linear average of face-centered fields
+      } else {
+        u.bx = 0.5*(b.x1f(m,k,j,i) + b.x1f(m,k,j,i+1));
+        u.by = 0.5*(b.x2f(m,k,j,i) + b.x2f(m,k,j+1,i));
+        u.bz = 0.5*(b.x3f(m,k,j,i) + b.x3f(m,k+1,j,i));
+      }
 
-    // Extract components of metric
-    Real &x1min = size.d_view(m).x1min;
-    Real &x1max = size.d_view(m).x1max;
-    Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+      // Extract components of metric
+      Real &x1min = size.d_view(m).x1min;
+      Real &x1max = size.d_view(m).x1max;
+      Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
 
-    Real &x2min = size.d_view(m).x2min;
-    Real &x2max = size.d_view(m).x2max;
-    Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+      Real &x2min = size.d_view(m).x2min;
+      Real &x2max = size.d_view(m).x2max;
+      Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
 
-    Real &x3min = size.d_view(m).x3min;
-    Real &x3max = size.d_view(m).x3max;
-    Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+      Real &x3min = size.d_view(m).x3min;
+      Real &x3max = size.d_view(m).x3max;
+      Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
-    Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
-
-    HydPrim1D w;
-    bool dfloor_used=false, efloor_used=false;
-    bool vceiling_used=false, c2p_failure=false;
-    int iter_used=0;
-
-    // Only execute cons2prim if outside excised region
-    bool excised = false;
-    if (use_excise) {
-      if (excision_floor_(m,k,j,i)) {
-        w.d = dexcise_;
-        w.vx = 0.0;
-        w.vy = 0.0;
-        w.vz = 0.0;
-        w.e = pexcise_/gm1;
-        excised = true;
+      Real glower[4][4], gupper[4][4];
+      if (use_cache) {
+        CachedMetricAndInverse(ks_cc, m, k, j, i, glower, gupper);
+      } else {
+        ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
       }
-      if (only_testfloors) {
-        if (excision_flux_(m,k,j,i)) {
+
+      HydPrim1D w;
+      bool dfloor_used=false, efloor_used=false;
+      bool vceiling_used=false, c2p_failure=false;
+      int iter_used=0;
+
+      // Only execute cons2prim if outside excised region
+      bool excised = false;
+      if (use_excise) {
+        if (excision_floor_(m,k,j,i)) {
+          w.d = dexcise_;
+          w.vx = 0.0;
+          w.vy = 0.0;
+          w.vz = 0.0;
+          w.e = pexcise_/gm1;
           excised = true;
         }
+        if (only_testfloors) {
+          if (excision_flux_(m,k,j,i)) {
+            excised = true;
+          }
+        }
       }
-    }
 
-    if (!(excised)) {
-      // calculate SR conserved quantities
-      MHDCons1D u_sr;
-      Real s2, b2, rpar;
-      TransformToSRMHD(u,glower,gupper,s2,b2,rpar,u_sr);
-
-      // call c2p function
-      // (inline function in ideal_c2p_mhd.hpp file)
-      SingleC2P_IdealSRMHD(u_sr, eos, s2, b2, rpar, w,
-                           dfloor_used, efloor_used, c2p_failure, iter_used);
-
-      // apply velocity ceiling if necessary
-      Real tmp = glower[1][1]*SQR(w.vx)
-               + glower[2][2]*SQR(w.vy)
-               + glower[3][3]*SQR(w.vz)
-               + 2.0*glower[1][2]*w.vx*w.vy + 2.0*glower[1][3]*w.vx*w.vz
-               + 2.0*glower[2][3]*w.vy*w.vz;
-      Real lor = sqrt(1.0+tmp);
-      if (lor > eos.gamma_max) {
-        vceiling_used = true;
-        Real factor = sqrt((SQR(eos.gamma_max)-1.0)/(SQR(lor)-1.0));
-        w.vx *= factor;
-        w.vy *= factor;
-        w.vz *= factor;
+      if (!(excised)) {
+        // calculate SR conserved quantities
+        MHDCons1D u_sr;
+        Real s2, b2, rpar;
+        TransformToSRMHD(u,glower,gupper,s2,b2,rpar,u_sr);
+
+        // call c2p function
+        // (inline function in ideal_c2p_mhd.hpp file)
+        SingleC2P_IdealSRMHD(u_sr, eos, s2, b2, rpar, w,
+                             dfloor_used, efloor_used, c2p_failure, iter_used,
+                             maxit_pass);
+
+        // apply velocity ceiling if necessary
+        Real tmp = glower[1][1]*SQR(w.vx)
+                 + glower[2][2]*SQR(w.vy)
+                 + glower[3][3]*SQR(w.vz)
+                 + 2.0*glower[1][2]*w.vx*w.vy + 2.0*glower[1][3]*w.vx*w.vz
+                 + 2.0*glower[2][3]*w.vy*w.vz;
+        Real lor = sqrt(1.0+tmp);
+        if (lor > eos.gamma_max) {
+          vceiling_used = true;
+          Real factor = sqrt((SQR(eos.gamma_max)-1.0)/(SQR(lor)-1.0));
+          w.vx *= factor;
+          w.vy *= factor;
+          w.vz *= factor;
+        }
       }
-    }
 
-    // set FOFC flag and quit loop if this function called only to check floors
-    if (only_testfloors) {
-      if (dfloor_used || efloor_used || vceiling_used || c2p_failure) {
-        fofc_(m,k,j,i) = true;
-        sumd++;  // use dfloor as counter for when either is true
-      }
-    } else {
-      if (dfloor_used) {sumd++;}
-      if (efloor_used) {sume++;}
-      if (vceiling_used) {sumv++;}
-      if (c2p_failure) {sumf++;}
-      max_it = (iter_used > max_it) ? iter_used : max_it;
-
-      // store primitive state in 3D array
-      prim(m,IDN,k,j,i) = w.d;
-      prim(m,IVX,k,j,i) = w.vx;
-      prim(m,IVY,k,j,i) = w.vy;
-      prim(m,IVZ,k,j,i) = w.vz;
-      prim(m,IEN,k,j,i) = w.e;
-
-      // store cell-centered fields in 3D array
-      bcc(m,IBX,k,j,i) = u.bx;
-      bcc(m,IBY,k,j,i) = u.by;
-      bcc(m,IBZ,k,j,i) = u.bz;
-
-      // reset conserved variables if floor, ceiling, failure, or excision encountered
-      if (dfloor_used || efloor_used || vceiling_used || c2p_failure || excised) {
-        MHDPrim1D w_in;
-        w_in.d  = w.d;
-        w_in.vx = w.vx;
-        w_in.vy = w.vy;
-        w_in.vz = w.vz;
-        w_in.e  = w.e;
-        w_in.bx = u.bx;
-        w_in.by = u.by;
-        w_in.bz = u.bz;
-
-        HydCons1D u_out;
-        SingleP2C_IdealGRMHD(glower, gupper, w_in, eos.gamma, u_out);
-        cons(m,IDN,k,j,i) = u_out.d;
-        cons(m,IM1,k,j,i) = u_out.mx;
-        cons(m,IM2,k,j,i) = u_out.my;
-        cons(m,IM3,k,j,i) = u_out.mz;
-        cons(m,IEN,k,j,i) = u_out.e;
-        u.d = u_out.d;  // (needed if there are scalars below)
+      // in fast pass of two-pass c2p, add failed cells to work list of second pass
+      if (defer && c2p_failure) {
+        list_(Kokkos::atomic_fetch_add(&nlist_.d_view(0), 1)) = idx;
+        return;
       }
 
-      // convert scalars (if any)
-      for (int n=nmhd; n<(nmhd+nscal); ++n) {
-        prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
+      // set FOFC flag and quit loop if this function called only to check floors
+      if (only_testfloors) {
+        if (dfloor_used || efloor_used || vceiling_used || c2p_failure) {
+          fofc_(m,k,j,i) = true;
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::ifofc));
+        }
+      } else {
+        if (dfloor_used) {
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::idfloor));
+        }
+        if (efloor_used) {
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::iefloor));
+        }
+        if (vceiling_used) {
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::ivceil));
+        }
+        if (c2p_failure) {
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::ifail));
+        }
+        Kokkos::atomic_max(&counts_.d_view(EventCounters::imaxit), iter_used);
+        if (count_hist) {
+          int nbin = (iter_used < nhist)? iter_used : nhist-1;
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::ic2p_hist + nbin));
+        }
+        if (count_work && (iter_used > 0)) {
+          Kokkos::atomic_add(&mb_work_.d_view(m), static_cast<Real>(iter_used));
+        }
+
+        // store primitive state in 3D array
+        prim(m,IDN,k,j,i) = w.d;
+        prim(m,IVX,k,j,i) = w.vx;
+        prim(m,IVY,k,j,i) = w.vy;
+        prim(m,IVZ,k,j,i) = w.vz;
+        prim(m,IEN,k,j,i) = w.e;
+
+        // store cell-centered fields in 3D array
+        bcc(m,IBX,k,j,i) = u.bx;
+        bcc(m,IBY,k,j,i) = u.by;
+        bcc(m,IBZ,k,j,i) = u.bz;
+
+        // reset conserved variables if floor, ceiling, failure, or excision encountered
+        if (dfloor_used || efloor_used || vceiling_used || c2p_failure || excised) {
+          MHDPrim1D w_in;
+          w_in.d  = w.d;
+          w_in.vx = w.vx;
+          w_in.vy = w.vy;
+          w_in.vz = w.vz;
+          w_in.e  = w.e;
+          w_in.bx = u.bx;
+          w_in.by = u.by;
+          w_in.bz = u.bz;
+
+          HydCons1D u_out;
+          SingleP2C_IdealGRMHD(glower, gupper, w_in, eos.gamma, u_out);
+          cons(m,IDN,k,j,i) = u_out.d;
+          cons(m,IM1,k,j,i) = u_out.mx;
+          cons(m,IM2,k,j,i) = u_out.my;
+          cons(m,IM3,k,j,i) = u_out.mz;
+          cons(m,IEN,k,j,i) = u_out.e;
+          u.d = u_out.d;  // (needed if there are scalars below)
+        }
+
+        // convert scalars (if any)
+        for (int n=nmhd; n<(nmhd+nscal); ++n) {
+          prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
+        }
       }
-    }
-  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nceilv_),
-     Kokkos::Sum<int>(nfail_), Kokkos::Max<int>(maxit_));
-
-  // store appropriate counters
-  if (only_testfloors) {
-    pmy_pack->pmesh->ecounter.nfofc += nfloord_;
-  } else {
-    pmy_pack->pmesh->ecounter.neos_dfloor += nfloord_;
-    pmy_pack->pmesh->ecounter.neos_efloor += nfloore_;
-    pmy_pack->pmesh->ecounter.neos_vceil  += nceilv_;
-    pmy_pack->pmesh->ecounter.neos_fail   += nfail_;
-    pmy_pack->pmesh->ecounter.maxit_c2p = maxit_;
+    });
   }
 
   return;
@@ -240,8 +300,11 @@ void IdealGRMHD::PrimToCons(const DvceArray5D<Real> &prim, const DvceArray5D<Rea
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &js = indcs.js, &ks = indcs.ks;
   auto &size = pmy_pack->pmb->mb_size;
+  pmy_pack->pcoord->UpdateMetricCache();
   auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
   auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+  auto &use_cache = pmy_pack->pcoord->coord_data.metric_cache;
+  auto &ks_cc = pmy_pack->pcoord->coord_data.ks_cc;
   int &nmhd  = pmy_pack->pmhd->nmhd;
   int &nscal = pmy_pack->pmhd->nscalars;
   int &nmb = pmy_pack->nmb_thispack;
@@ -263,7 +326,11 @@ void IdealGRMHD::PrimToCons(const DvceArray5D<Real> &prim, const DvceArray5D<Rea
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    if (use_cache) {
+      CachedMetricAndInverse(ks_cc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    }
 
     // Load single state of primitive variables
     MHDPrim1D w;
@@ -6,7 +6,10 @@
 //! \file ideal_hyd.cpp
 //! \brief derived class that implements ideal gas EOS in nonrelativistic hydro
 
+#include <limits>
+
 #include "athena.hpp"
+#include "mesh/mesh.hpp"
 #include "hydro/hydro.hpp"
 #include "eos/eos.hpp"
 #include "eos/ideal_c2p_hyd.hpp"
@@ -32,20 +35,24 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
                             const bool only_testfloors,
                             const int il, const int iu, const int jl, const int ju,
                             const int kl, const int ku) {
+  if (use_tiled_c2p) {
+    ConsToPrimTiled(cons, prim, only_testfloors, il, iu, jl, ju, kl, ku);
+    return;
+  }
   int &nhyd  = pmy_pack->phydro->nhydro;
   int &nscal = pmy_pack->phydro->nscalars;
   int &nmb = pmy_pack->nmb_thispack;
   auto &eos = eos_data;
   auto &fofc_ = pmy_pack->phydro->fofc;
+  auto &counts_ = pmy_pack->pmesh->ecounter.dcounts;
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
   const int nkji = (ku - kl + 1)*nji;
   const int nmkji = nmb*nkji;
 
-  int nfloord_=0, nfloore_=0, nfloort_=0;
-  Kokkos::parallel_reduce("hyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumt) {
+  Kokkos::parallel_for("hyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx) {
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
     int j = (idx - m*nkji - k*nji)/ni;
@@ -71,21 +78,21 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
     if (only_testfloors) {
       if (dfloor_used || efloor_used || tfloor_used) {
         fofc_(m,k,j,i) = true;
-        sumd++;  // use dfloor as counter for when either is true
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::ifofc));
       }
     } else {
       // update counter, reset conserved if floor was hit
       if (dfloor_used) {
         cons(m,IDN,k,j,i) = u.d;
-        sumd++;
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::idfloor));
       }
       if (efloor_used) {
         cons(m,IEN,k,j,i) = u.e;
-        sume++;
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::iefloor));
       }
       if (tfloor_used) {
         cons(m,IEN,k,j,i) = u.e;
-        sumt++;
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::itfloor));
       }
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
@@ -102,16 +109,173 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
         prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
       }
     }
-  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nfloort_));
-
-  // store appropriate counters
-  if (only_testfloors) {
-    pmy_pack->pmesh->ecounter.nfofc += nfloord_;
-  } else {
-    pmy_pack->pmesh->ecounter.neos_dfloor += nfloord_;
-    pmy_pack->pmesh->ecounter.neos_efloor += nfloore_;
-    pmy_pack->pmesh->ecounter.neos_tfloor += nfloort_;
-  }
+  });
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ConsToPrimNewDt()
+//! \brief Same as ConsToPrim() (without only_testfloors), but also reduces the minimum
+//! of dx/(|v|+cs) in each direction over cells in the active zone into dt[], using the
+//! same expression as Hydro::NewTimeStep().  Saves a separate pass over W and a kernel
+//! launch in the last stage with <hydro>/c2p_dt=true.
+
+void IdealHydro::ConsToPrimNewDt(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
+                                 const int il, const int iu, const int jl, const int ju,
+                                 const int kl, const int ku, Real dt[3]) {
+  int &nhyd  = pmy_pack->phydro->nhydro;
+  int &nscal = pmy_pack->phydro->nscalars;
+  int &nmb = pmy_pack->nmb_thispack;
+  auto &eos = eos_data;
+  auto &counts_ = pmy_pack->pmesh->ecounter.dcounts;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+
+  const int ni   = (iu - il + 1);
+  const int nji  = (ju - jl + 1)*ni;
+  const int nkji = (ku - kl + 1)*nji;
+  const int nmkji = nmb*nkji;
+
+  dt[0] = std::numeric_limits<float>::max();
+  dt[1] = std::numeric_limits<float>::max();
+  dt[2] = std::numeric_limits<float>::max();
+  Kokkos::parallel_reduce("hyd_c2p_dt",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/ni;
+    int i = (idx - m*nkji - k*nji - j*ni) + il;
+    j += jl;
+    k += kl;
+
+    HydCons1D u;
+    u.d  = cons(m,IDN,k,j,i);
+    u.mx = cons(m,IM1,k,j,i);
+    u.my = cons(m,IM2,k,j,i);
+    u.mz = cons(m,IM3,k,j,i);
+    u.e  = cons(m,IEN,k,j,i);
+
+    HydPrim1D w;
+    bool dfloor_used=false, efloor_used=false, tfloor_used=false;
+    SingleC2P_IdealHyd(u, eos, w, dfloor_used, efloor_used, tfloor_used);
+
+    if (dfloor_used) {
+      cons(m,IDN,k,j,i) = u.d;
+      Kokkos::atomic_increment(&counts_.d_view(EventCounters::idfloor));
+    }
+    if (efloor_used) {
+      cons(m,IEN,k,j,i) = u.e;
+      Kokkos::atomic_increment(&counts_.d_view(EventCounters::iefloor));
+    }
+    if (tfloor_used) {
+      cons(m,IEN,k,j,i) = u.e;
+      Kokkos::atomic_increment(&counts_.d_view(EventCounters::itfloor));
+    }
+    prim(m,IDN,k,j,i) = w.d;
+    prim(m,IVX,k,j,i) = w.vx;
+    prim(m,IVY,k,j,i) = w.vy;
+    prim(m,IVZ,k,j,i) = w.vz;
+    prim(m,IEN,k,j,i) = w.e;
+    for (int n=nhyd; n<(nhyd+nscal); ++n) {
+      if (cons(m,n,k,j,i) < 0.0) {
+        cons(m,n,k,j,i) = 0.0;
+      }
+      prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
+    }
+
+    // timestep from cells in active zone only
+    if (i >= is && i <= ie && j >= js && j <= je && k >= ks && k <= ke) {
+      Real p = eos.IdealGasPressure(w.e);
+      Real cs = eos.IdealHydroSoundSpeed(w.d, p);
+      min_dt1 = fmin((mbsize.d_view(m).dx1/(fabs(w.vx) + cs)), min_dt1);
+      min_dt2 = fmin((mbsize.d_view(m).dx2/(fabs(w.vy) + cs)), min_dt2);
+      min_dt3 = fmin((mbsize.d_view(m).dx3/(fabs(w.vz) + cs)), min_dt3);
+    }
+  }, Kokkos::Min<Real>(dt[0]), Kokkos::Min<Real>(dt[1]), Kokkos::Min<Real>(dt[2]));
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ConsToPrimTiled()
+//! \brief Same as ConsToPrim(), but each team first streams a row of conserved variables
+//! into scratch in SoA form, one variable at a time, and then computes the c2p for all
+//! cells in the row from scratch.  See IdealMHD::ConsToPrimTiled().
+
+void IdealHydro::ConsToPrimTiled(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
+                                 const bool only_testfloors,
+                                 const int il, const int iu, const int jl, const int ju,
+                                 const int kl, const int ku) {
+  int &nhyd  = pmy_pack->phydro->nhydro;
+  int &nscal = pmy_pack->phydro->nscalars;
+  int &nmb = pmy_pack->nmb_thispack;
+  auto &eos = eos_data;
+  auto &fofc_ = pmy_pack->phydro->fofc;
+  auto &counts_ = pmy_pack->pmesh->ecounter.dcounts;
+
+  const int ni = (iu - il + 1);
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nhyd, ni);
+  int scr_level = 0;
+  par_for_outer("hyd_c2p_tiled", DevExeSpace(), scr_size, scr_level, 0, (nmb-1),
+                kl, ku, jl, ju,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> ut(member.team_scratch(scr_level), nhyd, ni);
+    for (int n=0; n<nhyd; ++n) {
+      par_for_inner(member, il, iu, [&](const int i) {
+        ut(n,i-il) = cons(m,n,k,j,i);
+      });
+    }
+    member.team_barrier();
+
+    par_for_inner(member, il, iu, [&](const int i) {
+      const int ii = i - il;
+      HydCons1D u;
+      u.d  = ut(IDN,ii);
+      u.mx = ut(IM1,ii);
+      u.my = ut(IM2,ii);
+      u.mz = ut(IM3,ii);
+      u.e  = ut(IEN,ii);
+
+      HydPrim1D w;
+      bool dfloor_used=false, efloor_used=false, tfloor_used=false;
+      SingleC2P_IdealHyd(u, eos, w, dfloor_used, efloor_used, tfloor_used);
+
+      if (only_testfloors) {
+        if (dfloor_used || efloor_used || tfloor_used) {
+          fofc_(m,k,j,i) = true;
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::ifofc));
+        }
+      } else {
+        if (dfloor_used) {
+          cons(m,IDN,k,j,i) = u.d;
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::idfloor));
+        }
+        if (efloor_used) {
+          cons(m,IEN,k,j,i) = u.e;
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::iefloor));
+        }
+        if (tfloor_used) {
+          cons(m,IEN,k,j,i) = u.e;
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::itfloor));
+        }
+        prim(m,IDN,k,j,i) = w.d;
+        prim(m,IVX,k,j,i) = w.vx;
+        prim(m,IVY,k,j,i) = w.vy;
+        prim(m,IVZ,k,j,i) = w.vz;
+        prim(m,IEN,k,j,i) = w.e;
+        for (int n=nhyd; n<(nhyd+nscal); ++n) {
+          if (cons(m,n,k,j,i) < 0.0) {
+            cons(m,n,k,j,i) = 0.0;
+          }
+          prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
+        }
+      }
+    });
+  });
 
   return;
 }
@@ -67,9 +67,14 @@ void IdealSRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   const int nkji = (ku - kl + 1)*nji;
   const int nmkji = nmb*nkji;
 
-  int nfloord_=0, nfloore_=0, nceilv_=0, nfail_=0, maxit_=0;
-  Kokkos::parallel_reduce("srhyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumv, int &sumf, int &max_it) {
+  // event counters on the device, including histogram of iterations used in each cell
+  // (if requested)
+  auto &counts_ = pmy_pack->pmesh->ecounter.dcounts;
+  const bool count_hist = use_c2p_hist && !(only_testfloors);
+  const int nhist = EventCounters::nc2p_hist;
+
+  Kokkos::parallel_for("srhyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx) {
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
     int j = (idx - m*nkji - k*nji)/ni;
@@ -110,14 +115,26 @@ void IdealSRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
     if (only_testfloors) {
       if (dfloor_used || efloor_used || vceiling_used || c2p_failure) {
         fofc_(m,k,j,i) = true;
-        sumd++;  // use dfloor as counter for when either is true
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::ifofc));
       }
     } else {
-      if (dfloor_used) {sumd++;}
-      if (efloor_used) {sume++;}
-      if (vceiling_used) {sumv++;}
-      if (c2p_failure) {sumf++;}
-      max_it = (iter_used > max_it) ? iter_used : max_it;
+      if (dfloor_used) {
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::idfloor));
+      }
+      if (efloor_used) {
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::iefloor));
+      }
+      if (vceiling_used) {
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::ivceil));
+      }
+      if (c2p_failure) {
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::ifail));
+      }
+      Kokkos::atomic_max(&counts_.d_view(EventCounters::imaxit), iter_used);
+      if (count_hist) {
+        int nbin = (iter_used < nhist)? iter_used : nhist-1;
+        Kokkos::atomic_increment(&counts_.d_view(EventCounters::ic2p_hist + nbin));
+      }
 
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
@@ -140,19 +157,7 @@ void IdealSRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
         prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
       }
     }
-  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nceilv_),
-     Kokkos::Sum<int>(nfail_), Kokkos::Max<int>(maxit_));
-
-  // store appropriate counters
-  if (only_testfloors) {
-    pmy_pack->pmesh->ecounter.nfofc += nfloord_;
-  } else {
-    pmy_pack->pmesh->ecounter.neos_dfloor += nfloord_;
-    pmy_pack->pmesh->ecounter.neos_efloor += nfloore_;
-    pmy_pack->pmesh->ecounter.neos_vceil  += nceilv_;
-    pmy_pack->pmesh->ecounter.neos_fail   += nfail_;
-    pmy_pack->pmesh->ecounter.maxit_c2p = maxit_;
-  }
+  });
 
   return;
 }
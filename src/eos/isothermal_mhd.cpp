@@ -77,15 +77,17 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
   int &nmb = pmy_pack->nmb_thispack;
   auto &fofc_ = pmy_pack->pmhd->fofc;
   Real dfloor = eos_data.dfloor;
+  auto &counts_ = pmy_pack->pmesh->ecounter.dcounts;
+  // floors are counted as FOFC events if this function called only to check floors
+  const int icount = (only_testfloors)? EventCounters::ifofc : EventCounters::idfloor;
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
   const int nkji = (ku - kl + 1)*nji;
   const int nmkji = nmb*nkji;
 
-  int nfloord_=0;
-  Kokkos::parallel_reduce("isomhd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd) {
+  Kokkos::parallel_for("isomhd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx) {
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
     int j = (idx - m*nkji - k*nji)/ni;
@@ -113,7 +115,7 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
     // update counter, reset conserved if floor was hit
     if (dfloor_used) {
       cons(m,IDN,k,j,i) = u.d;
-      sumd++;
+      Kokkos::atomic_increment(&counts_.d_view(icount));
     }
 
     // set FOFC flag and quit loop if this function called only to check floors
@@ -134,14 +136,7 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
         prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
       }
     }
-  }, Kokkos::Sum<int>(nfloord_));
-
-  // store appropriate counters
-  if (only_testfloors) {
-    pmy_pack->pmesh->ecounter.nfofc += nfloord_;
-  } else {
-    pmy_pack->pmesh->ecounter.neos_dfloor += nfloord_;
-  }
+  });
 
   return;
 }
@@ -102,6 +102,9 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   using EOSPolicy::code_units;
   // EOS unit system
   using EOSPolicy::eos_units;
+  // Cached unit conversion factors
+  using EOSPolicy::conv;
+  using EOSPolicy::UpdateUnitConversions;
 
   // ErrorPolicy member functions
   using ErrorPolicy::PrimitiveFloor;
@@ -138,6 +141,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
     v_max = 1.0 - 1e-15;
     max_bsq = std::numeric_limits<Real>::max();
     code_units = eos_units;
+    UpdateUnitConversions();
     for (int i = 0; i < MAX_SPECIES; i++) {
       Y_atm[i] = 0.0;
     }
@@ -152,8 +156,18 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   //  \param[in] Y  An array of particle fractions, expected to be of size n_species.
   //  \return The temperature according to the EOS.
   KOKKOS_INLINE_FUNCTION Real GetTemperatureFromE(Real n, Real e, Real *Y) const {
-    return TemperatureFromE(n, e*code_units.PressureConversion(eos_units), Y) *
-           eos_units.TemperatureConversion(code_units);
+    return TemperatureFromE(n, e*conv.pressure_to_eos, Y)*conv.temperature_to_code;
+  }
+
+  //! \fn Real GetTemperatureFromE(Real n, Real e, Real *Y, Real T_guess)
+  //  \brief As above, but with an initial guess for the temperature which tabulated
+  //         EOSPolicies use to narrow the search for the root.
+  //
+  //  \param[in] T_guess  The temperature guess; ignored if not positive.
+  KOKKOS_INLINE_FUNCTION Real GetTemperatureFromE(Real n, Real e, Real *Y,
+                                                  Real T_guess) const {
+    return TemperatureFromE(n, e*conv.pressure_to_eos, Y,
+                            T_guess*conv.temperature_to_eos)*conv.temperature_to_code;
   }
 
   //! \fn Real GetTemperatureFromP(Real n, Real p, Real *Y)
@@ -164,8 +178,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   //  \param[in] Y  An array of particle fractions, expected to be of size n_species.
   //  \return The temperature according to the EOS.
   KOKKOS_INLINE_FUNCTION Real GetTemperatureFromP(Real n, Real p, Real *Y) const {
-    return TemperatureFromP(n, p*code_units.PressureConversion(eos_units), Y) *
-           eos_units.TemperatureConversion(code_units);
+    return TemperatureFromP(n, p*conv.pressure_to_eos, Y)*conv.temperature_to_code;
   }
 
   //! \fn Real GetEnergy(Real n, Real T, Real *Y)
@@ -177,8 +190,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   //  \param[in] Y  An array of size n_species of the particle fractions.
   //  \return The energy density according to the EOS.
   KOKKOS_INLINE_FUNCTION Real GetEnergy(Real n, Real T, const Real *Y) const {
-    return Energy(n, T*code_units.TemperatureConversion(eos_units), Y) *
-           eos_units.PressureConversion(code_units);
+    return Energy(n, T*conv.temperature_to_eos, Y)*conv.pressure_to_code;
   }
 
   //! \fn Real GetPressure(Real n, Real T, Real *Y)
@@ -190,8 +202,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   //  \param[in] Y  An array of size n_species of the particle fractions.
   //  \return The pressure according to the EOS.
   KOKKOS_INLINE_FUNCTION Real GetPressure(Real n, Real T, Real *Y) const {
-    return Pressure(n, T*code_units.TemperatureConversion(eos_units), Y) *
-           eos_units.PressureConversion(code_units);
+    return Pressure(n, T*conv.temperature_to_eos, Y)*conv.pressure_to_code;
   }
 
   //! \fn Real GetEntropy(Real n, Real T, Real *Y)
@@ -203,8 +214,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   //  \param[in] Y  An array of size n_species of the particle fractions.
   //  \return The entropy per baryon for this EOS.
   KOKKOS_INLINE_FUNCTION Real GetEntropy(Real n, Real T, Real *Y) const {
-    return Entropy(n, T*code_units.TemperatureConversion(eos_units), Y)/mb *
-           eos_units.EntropyConversion(code_units)/eos_units.MassConversion(code_units);
+    return Entropy(n, T*conv.temperature_to_eos, Y)/mb*conv.entropy_to_code;
   }
 
   //! \fn Real GetEnthalpy(Real n, Real T, Real *Y)
@@ -216,8 +226,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   //  \param[in] Y  An array of size n_species of the particle fractions.
   //  \return The enthalpy per baryon for this EOS.
   KOKKOS_INLINE_FUNCTION Real GetEnthalpy(Real n, Real T, Real *Y) const {
-    return Enthalpy(n, T*code_units.TemperatureConversion(eos_units), Y)/mb *
-           (eos_units.EnergyConversion(code_units)/eos_units.MassConversion(code_units));
+    return Enthalpy(n, T*conv.temperature_to_eos, Y)/mb*conv.specific_to_code;
   }
 
   //! \fn Real GetMinimumEnthalpy()
@@ -225,8 +234,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   //
   //  \return the minimum enthalpy per mass.
   KOKKOS_INLINE_FUNCTION Real GetMinimumEnthalpy() const {
-    return MinimumEnthalpy()/mb *
-           eos_units.EnergyConversion(code_units)/eos_units.MassConversion(code_units);
+    return MinimumEnthalpy()/mb*conv.specific_to_code;
   }
 
   //! \fn Real GetSoundSpeed(Real n, Real T, Real *Y)
@@ -238,8 +246,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   //  \param[in] Y  An array of size n_species of the particle fractions.
   //  \return The sound speed for this EOS.
   KOKKOS_INLINE_FUNCTION Real GetSoundSpeed(Real n, Real T, Real *Y) const {
-    return SoundSpeed(n, T*code_units.TemperatureConversion(eos_units), Y) *
-           eos_units.VelocityConversion(code_units);
+    return SoundSpeed(n, T*conv.temperature_to_eos, Y)*conv.velocity_to_code;
   }
 
   //! \fn Real GetSpecificInternalEnergy(Real n, Real T, Real *Y)
@@ -251,8 +258,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   //  \param[in] Y  An array of size n_species of the particle fractions.
   //  \return The specific energy for the EOS.
   KOKKOS_INLINE_FUNCTION Real GetSpecificInternalEnergy(Real n, Real T, Real *Y) const {
-    return SpecificInternalEnergy(n, T*code_units.TemperatureConversion(eos_units), Y) *
-           eos_units.EnergyConversion(code_units)/eos_units.MassConversion(code_units);
+    return SpecificInternalEnergy(n, T*conv.temperature_to_eos, Y)*conv.specific_to_code;
   }
 
   //! \fn int GetNSpecies() const
@@ -265,8 +271,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   //  \brief Get the baryon mass used by this EOS. Note that
   //         this factor also converts the density.
   KOKKOS_INLINE_FUNCTION Real GetBaryonMass() const {
-    return mb*eos_units.MassConversion(code_units) *
-              eos_units.DensityConversion(code_units);
+    return mb*conv.mass_density_to_code;
   }
 
   //! \fn bool ApplyPrimitiveFloor(Real& n, Real& vu[3], Real& p, Real& T)
@@ -460,9 +465,9 @@ class EOS : public EOSPolicy, public ErrorPolicy {
 
   //! \brief Limit the temperature to a physical range
   KOKKOS_INLINE_FUNCTION void ApplyTemperatureLimits(Real& T) const {
-    Real T_eos = T*code_units.TemperatureConversion(eos_units);
+    Real T_eos = T*conv.temperature_to_eos;
     TemperatureLimits(T_eos, min_T, max_T);
-    T = T_eos*eos_units.TemperatureConversion(code_units);
+    T = T_eos*conv.temperature_to_code;
   }
 
   //! \brief Limit Y to a specified range
@@ -472,17 +477,17 @@ class EOS : public EOSPolicy, public ErrorPolicy {
 
   //! \brief Limit the pressure to a specified range at a given density and composition
   KOKKOS_INLINE_FUNCTION void ApplyPressureLimits(Real& P, Real n, Real* Y) const {
-    Real P_eos = P*code_units.PressureConversion(eos_units);
+    Real P_eos = P*conv.pressure_to_eos;
     PressureLimits(P_eos, MinimumPressure(n, Y), MaximumPressure(n, Y));
-    P = P_eos*eos_units.PressureConversion(code_units);
+    P = P_eos*conv.pressure_to_code;
   }
 
   //! \brief Limit the energy density to a specified range at a given density and
   //  composition
   KOKKOS_INLINE_FUNCTION void ApplyEnergyLimits(Real& e, Real n, Real* Y) const {
-    Real e_eos = e*code_units.PressureConversion(eos_units);
+    Real e_eos = e*conv.pressure_to_eos;
     EnergyLimits(e_eos, MinimumEnergy(n, Y), MaximumEnergy(n, Y));
-    e = e_eos*eos_units.PressureConversion(code_units);
+    e = e_eos*conv.pressure_to_code;
   }
 
   //! \brief Respond to a failed solve.
@@ -497,6 +502,7 @@ class EOS : public EOSPolicy, public ErrorPolicy {
 
   KOKKOS_INLINE_FUNCTION void SetCodeUnitSystem(UnitSystem units) {
     code_units = units;
+    UpdateUnitConversions();
   }
 
   KOKKOS_INLINE_FUNCTION UnitSystem& GetCodeUnitSystem() const {
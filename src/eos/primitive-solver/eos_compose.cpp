@@ -8,188 +8,271 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <limits>
 #include <iostream>
 #include <cstddef>
 #include <string>
+#include <vector>
 
 #include "eos_compose.hpp"
+#include "globals.hpp"
 #include "utils/tr_table.hpp"
 
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
 using namespace Primitive; // NOLINT
 
+//----------------------------------------------------------------------------------------
+//! \fn void EOSCompOSE::ReadTableFromFile(std::string fname)
+//  \brief Reads the table and copies it to the device.  With MPI, the file is read and
+//  preprocessed only by the first rank on each node, which writes the processed arrays
+//  into a buffer in an MPI shared-memory window.  Every rank on the node then copies
+//  from that buffer to its own device storage, so each node reads the file once and
+//  holds a single host copy of the table.
+
 void EOSCompOSE::ReadTableFromFile(std::string fname) {
   if (m_initialized==false) {
+    int node_rank = 0;
+#if MPI_PARALLEL_ENABLED
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, global_variable::my_rank,
+                        MPI_INFO_NULL, &node_comm);
+    MPI_Comm_rank(node_comm, &node_rank);
+#endif
+
     TableReader::Table table;
-    auto read_result = table.ReadTable(fname);
-    if (read_result.error != TableReader::ReadResult::SUCCESS) {
-      std::cout << "Table could not be read.\n";
-      assert (false);
+    int dims[3] = {0, 0, 0};
+    if (node_rank == 0) {
+      auto read_result = table.ReadTable(fname);
+      if (read_result.error != TableReader::ReadResult::SUCCESS) {
+        std::cout << "Table could not be read.\n";
+        assert (false);
+      }
+      // Make sure table has correct dimentions
+      assert(table.GetNDimensions()==3);
+      // TODO(PH) check that required fields are present?
+
+      // Read baryon (neutron) mass
+      auto& table_scalars = table.GetScalars();
+      mb = table_scalars.at("mn");
+
+      // Get table dimesnions
+      auto& point_info = table.GetPointInfo();
+      dims[0] = point_info[0].second;
+      dims[1] = point_info[1].second;
+      dims[2] = point_info[2].second;
     }
-    // Make sure table has correct dimentions
-    assert(table.GetNDimensions()==3);
-    // TODO(PH) check that required fields are present?
+#if MPI_PARALLEL_ENABLED
+    MPI_Bcast(dims, 3, MPI_INT, 0, node_comm);
+#endif
+    m_nn = dims[0];
+    m_ny = dims[1];
+    m_nt = dims[2];
 
-    // Read baryon (neutron) mass
-    auto& table_scalars = table.GetScalars();
-    mb = table_scalars.at("mn");
+    // Host buffer holding log nb, yq, log T and the table, shared by the node
+    size_t ntable = static_cast<size_t>(ECNVARS)*m_nn*m_ny*m_nt;
+    size_t nbuf = m_nn + m_ny + m_nt + ntable;
+    Real *buf = nullptr;
+#if MPI_PARALLEL_ENABLED
+    MPI_Win win;
+    MPI_Aint nbytes = (node_rank == 0) ? static_cast<MPI_Aint>(nbuf*sizeof(Real)) : 0;
+    MPI_Win_allocate_shared(nbytes, sizeof(Real), MPI_INFO_NULL, node_comm, &buf, &win);
+    if (node_rank != 0) {
+      MPI_Aint size;
+      int disp_unit;
+      MPI_Win_shared_query(win, 0, &size, &disp_unit, &buf);
+    }
+    MPI_Win_fence(0, win);
+#else
+    std::vector<Real> buf_vec(nbuf);
+    buf = buf_vec.data();
+#endif
+    using HostUnmanaged1D = Kokkos::View<Real *, LayoutWrapper, HostMemSpace,
+                                         Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+    using HostUnmanaged4D = Kokkos::View<Real ****, LayoutWrapper, HostMemSpace,
+                                         Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+    HostUnmanaged1D host_log_nb(buf, m_nn);
+    HostUnmanaged1D host_yq(buf + m_nn, m_ny);
+    HostUnmanaged1D host_log_t(buf + m_nn + m_ny, m_nt);
+    HostUnmanaged4D host_table(buf + m_nn + m_ny + m_nt, m_nn, m_ny, m_nt, ECNVARS);
 
-    // Get table dimesnions
-    auto& point_info = table.GetPointInfo();
-    m_nn = point_info[0].second;
-    m_ny = point_info[1].second;
-    m_nt = point_info[2].second;
+    // scalars computed by the reading rank: mb, density, composition and temperature
+    // limits, and minimum enthalpy
+    Real scalars[8];
+    if (node_rank == 0) {
+      std::fill(buf, buf + nbuf, 0.0);
+      { // read nb
+        Real * table_nb = table["nb"];
+        for (size_t in=0; in<m_nn; ++in) {
+          host_log_nb(in) = log(table_nb[in]);
+        }
+        min_n = table_nb[0];
+        max_n = table_nb[m_nn-1];
+      }
 
-    // (Re)Allocate device storage
-    Kokkos::realloc(m_log_nb, m_nn);
-    Kokkos::realloc(m_yq,     m_ny);
-    Kokkos::realloc(m_log_t,  m_nt);
-    Kokkos::realloc(m_table, ECNVARS, m_nn, m_ny, m_nt);
-
-    // Create host storage to read into
-    HostArray1D<Real>::HostMirror host_log_nb = create_mirror_view(m_log_nb);
-    HostArray1D<Real>::HostMirror host_yq =     create_mirror_view(m_yq);
-    HostArray1D<Real>::HostMirror host_log_t =  create_mirror_view(m_log_t);
-    HostArray4D<Real>::HostMirror host_table =  create_mirror_view(m_table);
-
-    { // read nb
-      Real * table_nb = table["nb"];
-      for (size_t in=0; in<m_nn; ++in) {
-        host_log_nb(in) = log(table_nb[in]);
+      { // read yq
+        Real * table_yq = table["yq"];
+        for (size_t iy=0; iy<m_ny; ++iy) {
+          host_yq(iy) = table_yq[iy];
+        }
+        min_Y[0] = table_yq[0];
+        max_Y[0] = table_yq[m_ny-1];
       }
-      m_id_log_nb = 1.0/(host_log_nb(1) - host_log_nb(0));
-      min_n = table_nb[0];
-      max_n = table_nb[m_nn-1];
-    }
 
-    { // read yq
-      Real * table_yq = table["yq"];
-      for (size_t iy=0; iy<m_ny; ++iy) {
-        host_yq(iy) = table_yq[iy];
+      { // read T
+        Real * table_t = table["t"];
+        for (size_t it=0; it<m_nt; ++it) {
+          host_log_t(it) = log(table_t[it]);
+        }
+        min_T = table_t[1];      // These are different
+        max_T = table_t[m_nt-2]; // on purpose
       }
-      m_id_yq = 1.0/(host_yq(1) - host_yq(0));
-      min_Y[0] = table_yq[0];
-      max_Y[0] = table_yq[m_ny-1];
-    }
 
-    { // read T
-      Real * table_t = table["t"];
-      for (size_t it=0; it<m_nt; ++it) {
-        host_log_t(it) = log(table_t[it]);
+      { // Read Q1 -> log(P)
+        Real * table_Q1 = table["Q1"];
+        for (size_t in=0; in<m_nn; ++in) {
+          for (size_t iy=0; iy<m_ny; ++iy) {
+            for (size_t it=0; it<m_nt; ++it) {
+              size_t iflat = it + m_nt*(iy + m_ny*in);
+              host_table(in,iy,it,ECLOGP) = log(table_Q1[iflat]) + host_log_nb(in);
+            }
+          }
+        }
       }
-      m_id_log_t = 1.0/(host_log_t(1) - host_log_t(0));
-      min_T = table_t[1];      // These are different
-      max_T = table_t[m_nt-2]; // on purpose
-    }
 
-    { // Read Q1 -> log(P)
-      Real * table_Q1 = table["Q1"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECLOGP,in,iy,it) = log(table_Q1[iflat]) + host_log_nb(in);
+      { // Read Q2 -> S
+        Real * table_Q2 = table["Q2"];
+        for (size_t in=0; in<m_nn; ++in) {
+          for (size_t iy=0; iy<m_ny; ++iy) {
+            for (size_t it=0; it<m_nt; ++it) {
+              size_t iflat = it + m_nt*(iy + m_ny*in);
+              host_table(in,iy,it,ECENT) = table_Q2[iflat];
+            }
           }
         }
       }
-    }
 
-    { // Read Q2 -> S
-      Real * table_Q2 = table["Q2"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECENT,in,iy,it) = table_Q2[iflat];
+      { // Read Q3-> mu_b
+        Real * table_Q3 = table["Q3"];
+        for (size_t in=0; in<m_nn; ++in) {
+          for (size_t iy=0; iy<m_ny; ++iy) {
+            for (size_t it=0; it<m_nt; ++it) {
+              size_t iflat = it + m_nt*(iy + m_ny*in);
+              host_table(in,iy,it,ECMUB) = (table_Q3[iflat]+1)*mb;
+            }
           }
         }
       }
-    }
 
-    { // Read Q3-> mu_b
-      Real * table_Q3 = table["Q3"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECMUB,in,iy,it) = (table_Q3[iflat]+1)*mb;
+      { // Read Q4-> mu_q
+        Real * table_Q4 = table["Q4"];
+        for (size_t in=0; in<m_nn; ++in) {
+          for (size_t iy=0; iy<m_ny; ++iy) {
+            for (size_t it=0; it<m_nt; ++it) {
+              size_t iflat = it + m_nt*(iy + m_ny*in);
+              host_table(in,iy,it,ECMUB) = table_Q4[iflat]*mb;
+            }
           }
         }
       }
-    }
 
-    { // Read Q4-> mu_q
-      Real * table_Q4 = table["Q4"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECMUB,in,iy,it) = table_Q4[iflat]*mb;
+      { // Read Q5-> mu_le
+        Real * table_Q5 = table["Q5"];
+        for (size_t in=0; in<m_nn; ++in) {
+          for (size_t iy=0; iy<m_ny; ++iy) {
+            for (size_t it=0; it<m_nt; ++it) {
+              size_t iflat = it + m_nt*(iy + m_ny*in);
+              host_table(in,iy,it,ECMUL) = table_Q5[iflat]*mb;
+            }
           }
         }
       }
-    }
 
-    { // Read Q5-> mu_le
-      Real * table_Q5 = table["Q5"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECMUL,in,iy,it) = table_Q5[iflat]*mb;
+      { // Read Q7-> log(e)
+        Real * table_Q7 = table["Q7"];
+        for (size_t in=0; in<m_nn; ++in) {
+          for (size_t iy=0; iy<m_ny; ++iy) {
+            for (size_t it=0; it<m_nt; ++it) {
+              size_t iflat = it + m_nt*(iy + m_ny*in);
+              host_table(in,iy,it,ECLOGE) = log(mb*(table_Q7[iflat] + 1)) +
+                                            host_log_nb(in);
+            }
           }
         }
       }
-    }
 
-    { // Read Q7-> log(e)
-      Real * table_Q7 = table["Q7"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECLOGE,in,iy,it) = log(mb*(table_Q7[iflat] + 1)) + host_log_nb(in);
+      { // Read cs2-> cs
+        Real * table_cs2 = table["cs2"];
+        for (size_t in=0; in<m_nn; ++in) {
+          for (size_t iy=0; iy<m_ny; ++iy) {
+            for (size_t it=0; it<m_nt; ++it) {
+              size_t iflat = it + m_nt*(iy + m_ny*in);
+              host_table(in,iy,it,ECCS) = sqrt(table_cs2[iflat]);
+            }
           }
         }
       }
-    }
 
-    { // Read cs2-> cs
-      Real * table_cs2 = table["cs2"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECCS,in,iy,it) = sqrt(table_cs2[iflat]);
+      m_min_h = std::numeric_limits<Real>::max();
+      // Compute minimum enthalpy
+      for (int in = 0; in < m_nn; ++in) {
+        Real const nb = exp(host_log_nb(in));
+        for (int it = 0; it < m_nt; ++it) {
+          for (int iy = 0; iy < m_ny; ++iy) {
+            // This would use GPU memory, and we are currently on the CPU, so Enthalpy is
+            // hardcoded
+            Real e = exp(host_table(in,iy,it,ECLOGE));
+            Real p = exp(host_table(in,iy,it,ECLOGP));
+            Real h = (e + p) / nb;
+            m_min_h = fmin(m_min_h, h);
           }
         }
       }
+      scalars[0] = mb;
+      scalars[1] = min_n;
+      scalars[2] = max_n;
+      scalars[3] = min_Y[0];
+      scalars[4] = max_Y[0];
+      scalars[5] = min_T;
+      scalars[6] = max_T;
+      scalars[7] = m_min_h;
     }
+#if MPI_PARALLEL_ENABLED
+    MPI_Win_fence(0, win);
+    MPI_Bcast(scalars, 8, MPI_ATHENA_REAL, 0, node_comm);
+#endif
+    mb = scalars[0];
+    min_n = scalars[1];
+    max_n = scalars[2];
+    min_Y[0] = scalars[3];
+    max_Y[0] = scalars[4];
+    min_T = scalars[5];
+    max_T = scalars[6];
+    m_min_h = scalars[7];
+    m_id_log_nb = 1.0/(host_log_nb(1) - host_log_nb(0));
+    m_id_yq = 1.0/(host_yq(1) - host_yq(0));
+    m_id_log_t = 1.0/(host_log_t(1) - host_log_t(0));
 
-    // Copy from host to device
+    // (Re)Allocate device storage and copy from host
+    Kokkos::realloc(m_log_nb, m_nn);
+    Kokkos::realloc(m_yq,     m_ny);
+    Kokkos::realloc(m_log_t,  m_nt);
+    Kokkos::realloc(m_table, m_nn, m_ny, m_nt, ECNVARS);
     Kokkos::deep_copy(m_log_nb, host_log_nb);
     Kokkos::deep_copy(m_yq,     host_yq);
     Kokkos::deep_copy(m_log_t,  host_log_t);
     Kokkos::deep_copy(m_table,  host_table);
+    Kokkos::fence();
 
+#if MPI_PARALLEL_ENABLED
+    MPI_Win_free(&win);
+    MPI_Comm_free(&node_comm);
+#endif
     m_initialized = true;
-
-    m_min_h = std::numeric_limits<Real>::max();
-    // Compute minimum enthalpy
-    for (int in = 0; in < m_nn; ++in) {
-      Real const nb = exp(host_log_nb(in));
-      for (int it = 0; it < m_nt; ++it) {
-        for (int iy = 0; iy < m_ny; ++iy) {
-          // This would use GPU memory, and we are currently on the CPU, so Enthalpy is
-          // hardcoded
-          Real e = exp(host_table(ECLOGE,in,iy,it));
-          Real p = exp(host_table(ECLOGP,in,iy,it));
-          Real h = (e + p) / nb;
-          m_min_h = fmin(m_min_h, h);
-        }
-      }
-    }
   } // if (m_initialized==false)
 }
@@ -14,6 +14,10 @@
 
 ///  \warning This code assumes the table to be uniformly spaced in
 ///           log nb, log t, and yq
+///
+///  The table is stored with the variable index innermost, m_table(in, iy, it, iv), so
+///  that all variables at one (nb, yq, T) node share a cache line and the 8 corners
+///  needed to interpolate several variables at one point are gathered only once.
 
 #include <string>
 #include <limits>
@@ -44,7 +48,7 @@ class EOSCompOSE : public EOSPolicyInterface {
       m_log_nb("log nb",1),
       m_log_t("log T",1),
       m_yq("yq",1),
-      m_table("EoS table",1,1,1,1) {
+      m_table("EoS table",1,1,1,ECNVARS) {
     n_species = 1;
     eos_units = MakeNuclear();
     m_initialized = false;
@@ -79,6 +83,14 @@ class EOSCompOSE : public EOSPolicyInterface {
     return temperature_from_var(ECLOGE, log(e), n, Y[0]);
   }
 
+  /// Temperature from energy density, searching for the root first in the table
+  /// interval containing T_guess (e.g. the temperature from the previous c2p).
+  KOKKOS_INLINE_FUNCTION Real TemperatureFromE(Real n, Real e, Real *Y,
+                                               Real T_guess) const {
+    assert (m_initialized);
+    return temperature_from_var(ECLOGE, log(e), n, Y[0], T_guess);
+  }
+
   /// Calculate the temperature using.
   KOKKOS_INLINE_FUNCTION Real TemperatureFromP(Real n, Real p, Real *Y) const {
     assert (m_initialized);
@@ -111,9 +123,11 @@ class EOSCompOSE : public EOSPolicyInterface {
 
   /// Calculate the enthalpy per baryon using.
   KOKKOS_INLINE_FUNCTION Real Enthalpy(Real n, Real T, Real *Y) const {
-    Real const P = Pressure(n, T, Y);
-    Real const e = Energy(n, T, Y);
-    return (P + e)/n;
+    assert (m_initialized);
+    const int ivs[2] = {ECLOGP, ECLOGE};
+    Real vals[2];
+    EvalAtNTY(2, ivs, n, T, Y, vals);
+    return (exp(vals[0]) + exp(vals[1]))/n;
   }
 
   /// Calculate the sound speed.
@@ -190,14 +204,23 @@ class EOSCompOSE : public EOSPolicyInterface {
   KOKKOS_INLINE_FUNCTION DvceArray1D<Real> const GetRawLogTemperature() const {
     return m_log_t;
   }
-  /// Get the raw table data
+  /// Get the raw table data, indexed (in, iy, it, iv)
   KOKKOS_INLINE_FUNCTION DvceArray4D<Real> const GetRawTable() const {
     return m_table;
   }
 
   // Indexing used to access the data
   KOKKOS_INLINE_FUNCTION ptrdiff_t index(int iv, int in, int iy, int it) const {
-    return it + m_nt*(iy + m_ny*(in + m_nn*iv));
+    return iv + ECNVARS*(it + m_nt*(iy + m_ny*in));
+  }
+
+  /// Evaluate the nv table variables listed in ivs at (n, T, Y) in EOS units, storing
+  /// the raw (e.g. log) table values in vals.  The interpolation weights and corner
+  /// indices are computed once for all variables.
+  KOKKOS_INLINE_FUNCTION void EvalAtNTY(const int nv, const int *ivs, Real n, Real T,
+                                        const Real *Y, Real *vals) const {
+    assert (m_initialized);
+    eval_at_lnty(nv, ivs, log(n), log(T), Y[0], vals);
   }
 
   /// Check if the EOS has been initialized properly.
@@ -221,6 +244,7 @@ class EOSCompOSE : public EOSPolicyInterface {
   /// Set the EOS unit system.
   KOKKOS_INLINE_FUNCTION void SetEOSUnitSystem(UnitSystem units) {
     eos_units = units;
+    UpdateUnitConversions();
   }
 
  private:
@@ -231,6 +255,13 @@ class EOSCompOSE : public EOSPolicyInterface {
   /// Low level evaluation function, not intended for outside use
   KOKKOS_INLINE_FUNCTION Real eval_at_lnty(int iv, Real log_n, Real log_t, Real yq)
       const {
+    Real val;
+    eval_at_lnty(1, &iv, log_n, log_t, yq, &val);
+    return val;
+  }
+  /// Low level evaluation of several variables, not intended for outside use
+  KOKKOS_INLINE_FUNCTION void eval_at_lnty(const int nv, const int *ivs, Real log_n,
+                                           Real log_t, Real yq, Real *vals) const {
     int in, iy, it;
     Real wn0, wn1, wy0, wy1, wt0, wt1;
 
@@ -238,15 +269,18 @@ class EOSCompOSE : public EOSPolicyInterface {
     weight_idx_yq(&wy0, &wy1, &iy, yq);
     weight_idx_lt(&wt0, &wt1, &it, log_t);
 
-    return
-      wn0 * (wy0 * (wt0 * m_table(iv, in+0, iy+0, it+0)   +
-                    wt1 * m_table(iv, in+0, iy+0, it+1))  +
-             wy1 * (wt0 * m_table(iv, in+0, iy+1, it+0)   +
-                    wt1 * m_table(iv, in+0, iy+1, it+1))) +
-      wn1 * (wy0 * (wt0 * m_table(iv, in+1, iy+0, it+0)   +
-                    wt1 * m_table(iv, in+1, iy+0, it+1))  +
-             wy1 * (wt0 * m_table(iv, in+1, iy+1, it+0)   +
-                    wt1 * m_table(iv, in+1, iy+1, it+1)));
+    for (int v = 0; v < nv; ++v) {
+      const int iv = ivs[v];
+      vals[v] =
+        wn0 * (wy0 * (wt0 * m_table(in+0, iy+0, it+0, iv)   +
+                      wt1 * m_table(in+0, iy+0, it+1, iv))  +
+               wy1 * (wt0 * m_table(in+0, iy+1, it+0, iv)   +
+                      wt1 * m_table(in+0, iy+1, it+1, iv))) +
+        wn1 * (wy0 * (wt0 * m_table(in+1, iy+0, it+0, iv)   +
+                      wt1 * m_table(in+1, iy+0, it+1, iv))  +
+               wy1 * (wt0 * m_table(in+1, iy+1, it+0, iv)   +
+                      wt1 * m_table(in+1, iy+1, it+1, iv)));
+    }
   }
 
   /// Evaluate interpolation weight for density
@@ -275,9 +309,11 @@ class EOSCompOSE : public EOSPolicyInterface {
   }
 
   // TODO(PH)
-  /// Low level function, not intended for outside use
-  KOKKOS_INLINE_FUNCTION Real temperature_from_var(int iv, Real var, Real n, Real Yq)
-      const {
+  /// Low level function, not intended for outside use.  If T_guess > 0, the bracket
+  /// for the root is first sought in the table interval containing T_guess, widened by
+  /// doubling on both sides, before falling back to the search over the full table.
+  KOKKOS_INLINE_FUNCTION Real temperature_from_var(int iv, Real var, Real n, Real Yq,
+                                                   Real T_guess = 0.0) const {
     int in, iy;
     Real wn0, wn1, wy0, wy1;
     weight_idx_ln(&wn0, &wn1, &in, log(n));
@@ -285,24 +321,45 @@ class EOSCompOSE : public EOSPolicyInterface {
 
     auto f = [=](int it){
       Real var_pt =
-        wn0 * (wy0 * m_table(iv, in+0, iy+0, it)  +
-               wy1 * m_table(iv, in+0, iy+1, it)) +
-        wn1 * (wy0 * m_table(iv, in+1, iy+0, it)  +
-               wy1 * m_table(iv, in+1, iy+1, it));
+        wn0 * (wy0 * m_table(in+0, iy+0, it, iv)  +
+               wy1 * m_table(in+0, iy+1, it, iv)) +
+        wn1 * (wy0 * m_table(in+1, iy+0, it, iv)  +
+               wy1 * m_table(in+1, iy+1, it, iv));
 
       return var - var_pt;
     };
 
     int ilo = 0;
     int ihi = m_nt-1;
-    Real flo = f(ilo);
-    Real fhi = f(ihi);
-    while (flo*fhi>0) {
-      if (ilo == ihi - 1) {
-        break;
-      } else {
-        ilo += 1;
+    Real flo, fhi;
+    bool bracketed = false;
+    if (T_guess > 0.0) {
+      // clamp before the conversion to int, so out-of-range guesses are safe
+      Real x = (log(T_guess) - m_log_t(0))*m_id_log_t;
+      int it0 = static_cast<int>(fmin(fmax(x, 0.0), static_cast<Real>(m_nt - 2)));
+      int width = 0;
+      while (!bracketed) {
+        ilo = (it0 - width > 0) ? (it0 - width) : 0;
+        ihi = (it0 + 1 + width < m_nt - 1) ? (it0 + 1 + width) : (m_nt - 1);
         flo = f(ilo);
+        fhi = f(ihi);
+        bracketed = (flo*fhi <= 0);
+        if (ilo == 0 && ihi == m_nt - 1) break;
+        width = (width == 0) ? 1 : 2*width;
+      }
+    }
+    if (!bracketed) {
+      ilo = 0;
+      ihi = m_nt-1;
+      flo = f(ilo);
+      fhi = f(ihi);
+      while (flo*fhi>0) {
+        if (ilo == ihi - 1) {
+          break;
+        } else {
+          ilo += 1;
+          flo = f(ilo);
+        }
       }
     }
     /* DEBUG
@@ -361,7 +418,7 @@ class EOSCompOSE : public EOSPolicyInterface {
   // of table
   bool m_initialized;
 
-  // Table storage on DEVICE.
+  // Table storage on DEVICE, with the variable index innermost in m_table.
   DvceArray1D<Real> m_log_nb;
   DvceArray1D<Real> m_yq;
   DvceArray1D<Real> m_log_t;
@@ -41,6 +41,34 @@ class EOSPolicyInterface {
   UnitSystem code_units;
   /// EOS unit system
   UnitSystem eos_units;
+
+  /// Conversion factors between code_units and eos_units.  These are evaluated once by
+  /// UpdateUnitConversions() whenever either unit system changes, rather than in every
+  /// call to the EOS from inside the primitive solver.
+  struct UnitConversions {
+    Real pressure_to_eos;      //! pressure and energy density, code to EOS units
+    Real pressure_to_code;     //! pressure and energy density, EOS to code units
+    Real temperature_to_eos;   //! temperature, code to EOS units
+    Real temperature_to_code;  //! temperature, EOS to code units
+    Real specific_to_code;     //! energy (or enthalpy) per mass, EOS to code units
+    Real entropy_to_code;      //! entropy per mass, EOS to code units
+    Real velocity_to_code;     //! velocity, EOS to code units
+    Real mass_density_to_code; //! number density times mass, EOS to code units
+  } conv;
+
+  KOKKOS_INLINE_FUNCTION void UpdateUnitConversions() {
+    conv.pressure_to_eos = code_units.PressureConversion(eos_units);
+    conv.pressure_to_code = eos_units.PressureConversion(code_units);
+    conv.temperature_to_eos = code_units.TemperatureConversion(eos_units);
+    conv.temperature_to_code = eos_units.TemperatureConversion(code_units);
+    conv.specific_to_code = eos_units.EnergyConversion(code_units)/
+                            eos_units.MassConversion(code_units);
+    conv.entropy_to_code = eos_units.EntropyConversion(code_units)/
+                           eos_units.MassConversion(code_units);
+    conv.velocity_to_code = eos_units.VelocityConversion(code_units);
+    conv.mass_density_to_code = eos_units.MassConversion(code_units)*
+                                eos_units.DensityConversion(code_units);
+  }
 };
 
 } // namespace Primitive
@@ -53,6 +53,12 @@ class IdealGas : public EOSPolicyInterface {
     return gammam1*(e - mb*n)/n;
   }
 
+  /// The temperature is found analytically, so the guess is not used.
+  KOKKOS_INLINE_FUNCTION Real TemperatureFromE(Real n, Real e, Real *Y,
+                                               Real T_guess) const {
+    return TemperatureFromE(n, e, Y);
+  }
+
   /// Calculate the temperature using the ideal gas law.
   KOKKOS_INLINE_FUNCTION Real TemperatureFromP(Real n, Real p, Real *Y) const {
     return p/n;
@@ -149,6 +155,7 @@ class IdealGas : public EOSPolicyInterface {
   /// Set the EOS unit system.
   KOKKOS_INLINE_FUNCTION void SetEOSUnitSystem(UnitSystem units) {
     eos_units = units;
+    UpdateUnitConversions();
   }
 };
 
@@ -68,6 +68,12 @@ class PiecewisePolytrope : public EOSPolicyInterface {
     return (e - e_cold)*(gamma_thermal - 1.0)/n;
   }
 
+  /// The temperature is found analytically, so the guess is not used.
+  KOKKOS_INLINE_FUNCTION Real TemperatureFromE(Real n, Real e, Real *Y,
+                                               Real T_guess) const {
+    return TemperatureFromE(n, e, Y);
+  }
+
   /// Calculate the temperature using the ideal gas law.
   KOKKOS_INLINE_FUNCTION Real TemperatureFromP(Real n, Real p, Real *Y) const {
     int i = FindPiece(n);
@@ -305,6 +311,7 @@ class PiecewisePolytrope : public EOSPolicyInterface {
   /// Set the EOS unit system
   KOKKOS_INLINE_FUNCTION void SetEOSUnitSystem(UnitSystem units) {
     eos_units = units;
+    UpdateUnitConversions();
   }
 
   /// Get the maximum number of allowed polytropes
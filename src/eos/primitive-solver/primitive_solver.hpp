@@ -89,7 +89,8 @@ class PrimitiveSolver {
    public:
     KOKKOS_INLINE_FUNCTION
     Real operator()(Real mu, Real D, Real q, Real bsq, Real rsq, Real rbsq, Real *Y,
-        const EOS<EOSPolicy, ErrorPolicy> * peos, Real* n, Real* T, Real* P) const {
+        const EOS<EOSPolicy, ErrorPolicy> * peos, Real* n, Real* T, Real* P,
+        bool warm_T) const {
       // We need to get some utility quantities first.
       const Real x = 1.0/(1.0 + mu*bsq);
       const Real xsq = x*x;
@@ -132,7 +133,10 @@ class PrimitiveSolver {
 
       // Now we can get an estimate of the temperature, and from that, the pressure and
       // enthalpy.
-      Real That = peos->GetTemperatureFromE(nhat, ehat, Y);
+      // If warm_T is set, the temperature from the previous evaluation (or the initial
+      // guess passed to ConToPrim) is used to narrow the search in tabulated EOS.
+      Real That = (warm_T) ? peos->GetTemperatureFromE(nhat, ehat, Y, *T) :
+                             peos->GetTemperatureFromE(nhat, ehat, Y);
       peos->ApplyTemperatureLimits(That);
       //ehat = peos->GetEnergy(nhat, That, Y);
       Real Phat = peos->GetPressure(nhat, That, Y);
@@ -220,11 +224,14 @@ class PrimitiveSolver {
   //  \param[in,out] bu    The magnetic field
   //  \param[in]     g3d   The 3x3 spatial metric
   //  \param[in]     g3u   The 3x3 inverse spatial metric
+  //  \param[in]     T_guess An initial guess for the temperature, e.g. from the
+  //                        previous c2p; not used if not positive
   //
   //  \return information about the solve
   KOKKOS_INLINE_FUNCTION
   SolverResult ConToPrim(Real prim[NPRIM], Real cons[NCONS], Real b[NMAG],
-                         Real g3d[NSPMETRIC], Real g3u[NSPMETRIC]) const;
+                         Real g3d[NSPMETRIC], Real g3u[NSPMETRIC],
+                         Real T_guess = 0.0) const;
 
   //! \brief Get the conserved variables from the primitive variables.
   //
@@ -364,7 +371,8 @@ Error PrimitiveSolver<EOSPolicy, ErrorPolicy>::CheckDensityValid(Real& mul, Real
 template<typename EOSPolicy, typename ErrorPolicy>
 KOKKOS_INLINE_FUNCTION
 SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM],
-      Real cons[NCONS], Real b[NMAG], Real g3d[NSPMETRIC], Real g3u[NSPMETRIC]) const {
+      Real cons[NCONS], Real b[NMAG], Real g3d[NSPMETRIC], Real g3u[NSPMETRIC],
+      Real T_guess) const {
   SolverResult solver_result{Error::SUCCESS, 0, false, false, false};
 
   // Extract the undensitized conserved variables.
@@ -513,9 +521,11 @@ SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM]
 
 
   // Do the root solve.
-  Real n, P, T, mu;
+  Real n, P, mu;
+  Real T = T_guess;
   bool result = root.FalsePosition(RootFunction, mul, muh, mu, tol,
-                                   D, q, bsqr, rsqr, rbsqr, Y, &eos, &n, &T, &P);
+                                   D, q, bsqr, rsqr, rbsqr, Y, &eos, &n, &T, &P,
+                                   (T_guess > 0.0));
   // WARNING: the reported number of iterations is not thread-safe and should only be
   // trusted on single-thread benchmarks.
   solver_result.iterations = root.iterations;
@@ -36,6 +36,7 @@
 #include "mhd/mhd.hpp"
 #include "coordinates/coordinates.hpp"
 #include "coordinates/cell_locations.hpp"
+#include "z4c/tmunu.hpp"
 
 template<class EOSPolicy, class ErrorPolicy>
 class PrimitiveSolverHydro {
@@ -90,10 +91,15 @@ class PrimitiveSolverHydro {
   MeshBlockPack* pmy_pack;
   unsigned int nerrs;
   unsigned int errcap;
+  // Temperature from the last c2p in each cell, used as the initial guess for the next
+  // c2p if c2p_temperature_guess is set.  It is only a guess, so stale values (e.g.
+  // after refinement) cost extra iterations but do not change the solution.
+  bool c2p_temperature_guess;
+  DvceArray4D<Real> temperature;
 
   PrimitiveSolverHydro(std::string block, MeshBlockPack *pp, ParameterInput *pin) :
 //        pmy_pack(pp), ps{&eos} {
-        pmy_pack(pp), nerrs(0) {
+        pmy_pack(pp), nerrs(0), temperature("c2p_temperature",1,1,1,1) {
     SetPolicyParams(block, pin);
     Real mb = ps.GetEOS().GetBaryonMass();
     ps.GetEOSMutable().SetDensityFloor(pin->GetOrAddReal(block, "dfloor", (FLT_MIN))/mb);
@@ -102,6 +108,7 @@ class PrimitiveSolverHydro {
     ps.tol = pin->GetOrAddReal(block, "c2p_tol", 1e-15);
     ps.GetRootSolverMutable().iterations = pin->GetOrAddInteger(block, "c2p_iter", 50);
     errcap = pin->GetOrAddInteger(block, "c2perrs", 1000);
+    c2p_temperature_guess = pin->GetOrAddBoolean(block, "c2p_temperature_guess", false);
 
     // Calculate maximum allowed velocity
     Real Wmax = pin->GetOrAddReal(block, "gamma_max", 50.0);
@@ -271,7 +278,8 @@ class PrimitiveSolverHydro {
   void ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &bfc,
                   DvceArray5D<Real> &bcc0, DvceArray5D<Real> &prim,
                   const int il, const int iu, const int jl, const int ju,
-                  const int kl, const int ku, bool floors_only=false) {
+                  const int kl, const int ku, bool floors_only=false,
+                  Tmunu::Tmunu_vars *ptmunu=nullptr) {
     int &nhyd = pmy_pack->pmhd->nmhd;
     int &nscal = pmy_pack->pmhd->nscalars;
     int &nmb = pmy_pack->nmb_thispack;
@@ -299,6 +307,30 @@ class PrimitiveSolverHydro {
 
     Real mb = eos_.GetBaryonMass();
 
+    // (Re)allocate the temperature cache if needed; new entries are zero, i.e. no guess
+    const bool use_tguess = c2p_temperature_guess;
+    if (use_tguess && (temperature.extent_int(0) != nmb ||
+                       temperature.extent_int(1) != cons.extent_int(2) ||
+                       temperature.extent_int(2) != cons.extent_int(3) ||
+                       temperature.extent_int(3) != cons.extent_int(4))) {
+      Kokkos::realloc(temperature, nmb, cons.extent_int(2), cons.extent_int(3),
+                      cons.extent_int(4));
+    }
+    auto &temperature_ = temperature;
+
+    // If ptmunu is given, the stress-energy tensor of the new state is written by the
+    // same kernel (see DynGRMHD::SetTmunu).  Only used for a full c2p.
+    const bool set_tmunu = (ptmunu != nullptr) && !floors_only;
+    Tmunu::Tmunu_vars tmunu_;
+    if (set_tmunu) {
+      tmunu_ = *ptmunu;
+    }
+    const int imap[3][3] = {
+      {S11, S12, S13},
+      {S12, S22, S23},
+      {S13, S23, S33}
+    };
+
     // FIXME: This only works for a flooring policy that has these functions!
     bool prim_failure, cons_failure;
     if (floors_only) {
@@ -395,10 +427,15 @@ class PrimitiveSolverHydro {
           result.cons_adjusted = true;
           ps_.PrimToCon(prim_pt, cons_pt, b3u, g3d);
         } else {
-          result = ps_.ConToPrim(prim_pt, cons_pt, b3u, g3d, g3u);
+          result = ps_.ConToPrim(prim_pt, cons_pt, b3u, g3d, g3u,
+                                 (use_tguess) ? temperature_(m,k,j,i) : 0.0);
         }
       } else {
-        result = ps_.ConToPrim(prim_pt, cons_pt, b3u, g3d, g3u);
+        result = ps_.ConToPrim(prim_pt, cons_pt, b3u, g3d, g3u,
+                               (use_tguess) ? temperature_(m,k,j,i) : 0.0);
+      }
+      if (use_tguess && result.error == Primitive::Error::SUCCESS) {
+        temperature_(m,k,j,i) = prim_pt[PTM];
       }
 
       if (result.error != Primitive::Error::SUCCESS && floors_only) {
@@ -494,6 +531,38 @@ class PrimitiveSolverHydro {
             cons(m, nhyd + n, k, j, i) = cons_pt[CYD + n]*sdetg;
           }
         }
+
+        // Stress-energy tensor from the undensitized variables already in registers
+        if (set_tmunu) {
+          Real v_d[3] = {0.0};
+          Real B_d[3] = {0.0};
+          Real iW = 0.0;
+          for (int a = 0; a < 3; ++a) {
+            for (int b = 0; b < 3; ++b) {
+              v_d[a] += prim_pt[PVX + b]*g3d[imap[a][b]];
+              B_d[a] += b3u[IBX + b]*g3d[imap[a][b]];
+            }
+            iW += prim_pt[PVX + a]*v_d[a];
+          }
+          iW = 1.0/sqrt(1.0 + iW);
+          Real Bv = 0.0;
+          Real Bsq = 0.0;
+          for (int a = 0; a < 3; ++a) {
+            Bv += b3u[IBX + a]*v_d[a];
+            Bsq += b3u[IBX + a]*B_d[a];
+          }
+          Real bsq = (Bsq + Bv*Bv)*(iW*iW);
+
+          tmunu_.E(m, k, j, i) = cons_pt[CTA] + cons_pt[CDN];
+          for (int a = 0; a < 3; ++a) {
+            tmunu_.S_d(m, a, k, j, i) = cons_pt[CSX + a];
+            for (int b = a; b < 3; ++b) {
+              tmunu_.S_dd(m, a, b, k, j, i) = cons_pt[CSX + a]*v_d[b]*iW
+                  - (B_d[a] + Bv*v_d[a])*SQR(iW)*B_d[b]
+                  + (prim_pt[PPR] + 0.5*bsq)*g3d[imap[a][b]];
+            }
+          }
+        }
       }
     }, Kokkos::Sum<int>(count_errs));
 
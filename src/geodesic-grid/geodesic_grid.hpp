@@ -8,6 +8,10 @@
 //! \file geodesic_grid.hpp
 //  \brief definitions for GeodesicGrid class
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "athena.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -15,7 +19,9 @@
 
 class GeodesicGrid {
  public:
-  GeodesicGrid(int nlev, bool rotate, bool fluxes);
+  // With a non-empty cache_dir the mesh is read from (or saved to) a binary file in that
+  // directory by rank 0 and broadcast to all ranks, rather than constructed on each rank
+  GeodesicGrid(int nlev, bool rotate, bool fluxes, const std::string &cache_dir = "");
   ~GeodesicGrid();
 
   int nangles;  // number of angles (derived from nlevel, 5*(2*nlevel^2) + 2)
@@ -51,6 +57,11 @@ class GeodesicGrid {
   HostArray2D<Real> ameshp_normals;  // normal components (at poles)
   HostArray3D<Real> amesh_indices;   // indexing (regular faces)
   HostArray1D<Real> ameshp_indices;  // indexing (at poles)
+
+  void BuildGrid();
+  std::vector<std::pair<char*, std::size_t>> GridData();
+  bool ReadGrid(const std::string &fname);
+  void WriteGrid(const std::string &fname);
 };
 
 #endif // GEODESIC_GRID_GEODESIC_GRID_HPP_
@@ -18,6 +18,7 @@
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "coordinates/coordinates.hpp"
+#include "utils/mb_locator.hpp"
 #include "spherical_grid.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -93,51 +94,12 @@ void SphericalGrid::SetInterpolationCoordinates() {
 //         interpolation onto the sphere
 
 void SphericalGrid::SetInterpolationIndices() {
-  auto &size = pmy_pack->pmb->mb_size;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-  int nang1 = nangles - 1;
+  // indices are -1 if angle does not reside in this MeshBlockPack
+  pmy_pack->plocator->Locate(interp_coord.d_view, interp_indcs.d_view, nangles);
 
-  auto &rcoord = interp_coord;
-  auto &iindcs = interp_indcs;
-  for (int n=0; n<=nang1; ++n) {
-    // indices default to -1 if angle does not reside in this MeshBlockPack
-    iindcs.h_view(n,0) = -1;
-    iindcs.h_view(n,1) = -1;
-    iindcs.h_view(n,2) = -1;
-    iindcs.h_view(n,3) = -1;
-    for (int m=0; m<=nmb1; ++m) {
-      // extract MeshBlock bounds
-      Real &x1min = size.h_view(m).x1min;
-      Real &x1max = size.h_view(m).x1max;
-      Real &x2min = size.h_view(m).x2min;
-      Real &x2max = size.h_view(m).x2max;
-      Real &x3min = size.h_view(m).x3min;
-      Real &x3max = size.h_view(m).x3max;
-
-      // extract MeshBlock grid cell spacings
-      Real &dx1 = size.h_view(m).dx1;
-      Real &dx2 = size.h_view(m).dx2;
-      Real &dx3 = size.h_view(m).dx3;
-
-      // save MeshBlock and zone indicies for nearest position to spherical patch center
-      // if this angle position resides in this MeshBlock
-      if ((rcoord.h_view(n,0) >= x1min && rcoord.h_view(n,0) <= x1max) &&
-          (rcoord.h_view(n,1) >= x2min && rcoord.h_view(n,1) <= x2max) &&
-          (rcoord.h_view(n,2) >= x3min && rcoord.h_view(n,2) <= x3max)) {
-        iindcs.h_view(n,0) = m;
-        iindcs.h_view(n,1) = static_cast<int>(std::floor((rcoord.h_view(n,0)-
-                                                          (x1min+dx1/2.0))/dx1));
-        iindcs.h_view(n,2) = static_cast<int>(std::floor((rcoord.h_view(n,1)-
-                                                          (x2min+dx2/2.0))/dx2));
-        iindcs.h_view(n,3) = static_cast<int>(std::floor((rcoord.h_view(n,2)-
-                                                          (x3min+dx3/2.0))/dx3));
-      }
-    }
-  }
-
-  // sync dual arrays
-  interp_indcs.template modify<HostMemSpace>();
-  interp_indcs.template sync<DevExeSpace>();
+  // sync dual arrays (weights are computed on host)
+  interp_indcs.template modify<DevExeSpace>();
+  interp_indcs.template sync<HostMemSpace>();
 
   return;
 }
@@ -153,7 +115,9 @@ void SphericalGrid::SetInterpolationWeights() {
 
   auto &iindcs = interp_indcs;
   auto &iwghts = interp_wghts;
-  for (int n=0; n<nangles; ++n) {
+  // each angle is independent, so weights are computed in parallel on the host
+  using HostRange = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>;
+  Kokkos::parallel_for("SetInterpWghts", HostRange(0, nangles), [&](const int n) {
     // extract indices
     int &ii0 = iindcs.h_view(n,0);
     int &ii1 = iindcs.h_view(n,1);
@@ -200,7 +164,7 @@ void SphericalGrid::SetInterpolationWeights() {
         }
       }
     }
-  }
+  });
 
   // sync dual arrays
   interp_wghts.template modify<HostMemSpace>();
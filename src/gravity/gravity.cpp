@@ -0,0 +1,245 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file gravity.cpp
+//! \brief implementation of Gravity class constructor, task list, and the gravitational
+//! source terms added to Hydro/MHD.  The multigrid solver is in multigrid.cpp.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/coordinates.hpp"
+#include "bvals/bvals.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "gravity/gravity.hpp"
+
+namespace gravity {
+//----------------------------------------------------------------------------------------
+// constructor, initializes data structures and parameters
+
+Gravity::Gravity(MeshBlockPack *ppack, ParameterInput *pin) :
+    phi("phi",1,1,1,1,1),
+    mg_ncycle_last(0),
+    mg_resid_last(0.0),
+    pmy_pack(ppack),
+    root_loc_("root_loc",1),
+    sbuf_("mg_sbuf",1,1,1),
+    rbuf_("mg_rbuf",1,1,1) {
+  Mesh *pm = ppack->pmesh;
+  four_pi_gee = pin->GetReal("gravity","four_pi_G");
+  mg_threshold = pin->GetOrAddReal("gravity","threshold",1.0e-8);
+  mg_ncycle_max = pin->GetOrAddInteger("gravity","ncycle_max",20);
+  mg_npresmooth = pin->GetOrAddInteger("gravity","npresmooth",2);
+  mg_npostsmooth = pin->GetOrAddInteger("gravity","npostsmooth",2);
+  reuse_phi = pin->GetOrAddBoolean("gravity","reuse_phi",true);
+
+  // The solver requires a uniform, strictly periodic Mesh and Newtonian fluids
+  if (pm->multilevel) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Self-gravity currently requires a uniform Mesh (no SMR/AMR)"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (!(pm->strictly_periodic)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Self-gravity currently requires periodic boundaries in all directions"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (ppack->phydro == nullptr && ppack->pmhd == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Self-gravity requires a <hydro> and/or <mhd> block" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (ppack->pcoord->is_special_relativistic || ppack->pcoord->is_general_relativistic) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Self-gravity cannot be used with SR/GR" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // allocate potential, which is level 0 of the multigrid hierarchy
+  int nmb = std::max((ppack->nmb_thispack), (pm->nmb_maxperrank));
+  auto &indcs = pm->mb_indcs;
+  {
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(phi, nmb, 1, ncells3, ncells2, ncells1);
+
+    MGLevel l0;
+    l0.nx1 = indcs.nx1; l0.nx2 = indcs.nx2; l0.nx3 = indcs.nx3;
+    l0.is = indcs.is; l0.ie = indcs.ie;
+    l0.js = indcs.js; l0.je = indcs.je;
+    l0.ks = indcs.ks; l0.ke = indcs.ke;
+    auto &size = ppack->pmb->mb_size.h_view(0);
+    l0.dx1 = size.dx1; l0.dx2 = size.dx2; l0.dx3 = size.dx3;
+    l0.u = phi;
+    l0.src = DvceArray5D<Real>("mg_src0", nmb, 1, ncells3, ncells2, ncells1);
+    l0.def = DvceArray5D<Real>("mg_def0", nmb, 1, ncells3, ncells2, ncells1);
+    lev_.push_back(l0);
+  }
+
+  // coarser levels within each MeshBlock, until one active direction has an odd number
+  // of cells (one cell per MeshBlock when the MeshBlock size is a power of two)
+  bool &multi_d = pm->multi_d;
+  bool &three_d = pm->three_d;
+  int nfmax = 1;
+  while ((lev_.back().nx1 % 2 == 0) && (!(multi_d) || (lev_.back().nx2 % 2 == 0)) &&
+         (!(three_d) || (lev_.back().nx3 % 2 == 0))) {
+    MGLevel &lf = lev_.back();
+    MGLevel lc;
+    lc.nx1 = lf.nx1/2;
+    lc.nx2 = (multi_d)? lf.nx2/2 : 1;
+    lc.nx3 = (three_d)? lf.nx3/2 : 1;
+    lc.is = 1; lc.ie = lc.nx1;
+    lc.js = (multi_d)? 1 : 0; lc.je = (multi_d)? lc.nx2 : 0;
+    lc.ks = (three_d)? 1 : 0; lc.ke = (three_d)? lc.nx3 : 0;
+    lc.dx1 = 2.0*lf.dx1;
+    lc.dx2 = (multi_d)? 2.0*lf.dx2 : lf.dx2;
+    lc.dx3 = (three_d)? 2.0*lf.dx3 : lf.dx3;
+    int ncells1 = lc.nx1 + 2;
+    int ncells2 = (multi_d)? lc.nx2 + 2 : 1;
+    int ncells3 = (three_d)? lc.nx3 + 2 : 1;
+    std::string lstr = std::to_string(lev_.size());
+    lc.u = DvceArray5D<Real>("mg_u"+lstr, nmb, 1, ncells3, ncells2, ncells1);
+    lc.src = DvceArray5D<Real>("mg_src"+lstr, nmb, 1, ncells3, ncells2, ncells1);
+    lc.def = DvceArray5D<Real>("mg_def"+lstr, nmb, 1, ncells3, ncells2, ncells1);
+    nfmax = std::max(nfmax, std::max(lc.nx2*lc.nx3, lc.nx1*std::max(lc.nx2, lc.nx3)));
+    lev_.push_back(lc);
+  }
+
+  // global grid formed by the coarsest level of every MeshBlock, solved on each rank
+  {
+    MGLevel &lc = lev_.back();
+    nroot1_ = (pm->nmb_rootx1)*lc.nx1;
+    nroot2_ = (pm->nmb_rootx2)*lc.nx2;
+    nroot3_ = (pm->nmb_rootx3)*lc.nx3;
+    root_src_.resize(nroot1_*nroot2_*nroot3_);
+    root_u_.resize(nroot1_*nroot2_*nroot3_);
+    Kokkos::realloc(root_loc_, nmb*(lc.nx1*lc.nx2*lc.nx3));
+  }
+  Kokkos::realloc(sbuf_, nmb, 6, nfmax);
+  Kokkos::realloc(rbuf_, nmb, 6, nfmax);
+
+  // boundary buffers for the potential
+  pbval_phi = new MeshBoundaryValuesCC(ppack, pin, false);
+  pbval_phi->InitializeBuffers(1);
+
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_dup(MPI_COMM_WORLD, &comm_mg_);
+  send_req_.assign(6*nmb, MPI_REQUEST_NULL);
+  recv_req_.assign(6*nmb, MPI_REQUEST_NULL);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+
+Gravity::~Gravity() {
+  delete pbval_phi;
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_free(&comm_mg_);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Gravity::AssembleGravityTasks
+//! \brief Adds the Poisson solve to the "before_stagen" task list, so that the potential
+//! is computed from the density at the start of every stage, before the fluid tasks in
+//! the "stagen" list add the gravitational source terms.
+
+void Gravity::AssembleGravityTasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
+  TaskID none(0);
+  tl["before_stagen"]->AddTask(&Gravity::SolvePoisson, this, none, "Gravity_Solve");
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Gravity::SolvePoisson
+//! \brief Solves the Poisson equation for the potential with V-cycles until the defect
+//! relative to the source drops below mg_threshold.  With reuse_phi=true the potential
+//! at the previous stage is the initial guess, so that typically only 1-2 V-cycles are
+//! needed per stage once the first solve has converged.
+
+TaskStatus Gravity::SolvePoisson(Driver *pdrive, int stage) {
+  Real src_norm = SetSource();
+  if (!(reuse_phi)) {
+    Kokkos::deep_copy(DevExeSpace(), phi, 0.0);
+  }
+  if (src_norm <= 0.0) {
+    // uniform density, no gravitational acceleration
+    Kokkos::deep_copy(DevExeSpace(), phi, 0.0);
+    mg_ncycle_last = 0;
+    mg_resid_last = 0.0;
+    return TaskStatus::complete;
+  }
+
+  FillGhosts(0);
+  Real resid = CalculateDefect(0, true)/src_norm;
+  int ncycle = 0;
+  while ((ncycle < mg_ncycle_max) && (resid > mg_threshold)) {
+    VCycle();
+    FillGhosts(0);
+    resid = CalculateDefect(0, true)/src_norm;
+    ++ncycle;
+  }
+  mg_ncycle_last = ncycle;
+  mg_resid_last = resid;
+#if MPI_PARALLEL_ENABLED
+  // complete coarse level sends still outstanding from the last FillGhosts()
+  MPI_Waitall(send_req_.size(), send_req_.data(), MPI_STATUSES_IGNORE);
+#endif
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::AddSrcTerms
+//! \brief Adds gravitational acceleration g = -grad(phi) to momentum and, with an ideal
+//! gas EOS, the work rho v.g to the total energy.  The potential (including its ghost
+//! zones) is set by SolvePoisson() at the start of the stage.
+
+void Gravity::AddSrcTerms(const DvceArray5D<Real> &w0, const Real bdt, const bool ener,
+                          DvceArray5D<Real> &u0) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto phi_ = phi;
+
+  par_for("grav_src", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real g1 = (phi_(m,0,k,j,i-1) - phi_(m,0,k,j,i+1))/(2.0*size.d_view(m).dx1);
+    Real g2 = 0.0, g3 = 0.0;
+    if (multi_d) {
+      g2 = (phi_(m,0,k,j-1,i) - phi_(m,0,k,j+1,i))/(2.0*size.d_view(m).dx2);
+    }
+    if (three_d) {
+      g3 = (phi_(m,0,k-1,j,i) - phi_(m,0,k+1,j,i))/(2.0*size.d_view(m).dx3);
+    }
+    Real bdt_rho = bdt*w0(m,IDN,k,j,i);
+    u0(m,IM1,k,j,i) += bdt_rho*g1;
+    u0(m,IM2,k,j,i) += bdt_rho*g2;
+    u0(m,IM3,k,j,i) += bdt_rho*g3;
+    if (ener) {
+      u0(m,IEN,k,j,i) += bdt_rho*(w0(m,IVX,k,j,i)*g1 + w0(m,IVY,k,j,i)*g2 +
+                                  w0(m,IVZ,k,j,i)*g3);
+    }
+  });
+  return;
+}
+
+} // namespace gravity
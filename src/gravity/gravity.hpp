@@ -0,0 +1,92 @@
+#ifndef GRAVITY_GRAVITY_HPP_
+#define GRAVITY_GRAVITY_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file gravity.hpp
+//  \brief definitions for Gravity class, which computes the gravitational potential of
+//  the gas by solving the Poisson equation with a multigrid method, and adds the
+//  corresponding source terms to Hydro and/or MHD.
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "tasklist/task_list.hpp"
+#include "driver/driver.hpp"
+
+// Forward declarations
+class MeshBoundaryValuesCC;
+
+namespace gravity {
+
+//----------------------------------------------------------------------------------------
+//! \struct MGLevel
+//! \brief data for one level of the multigrid hierarchy within each MeshBlock.  Level 0
+//! is the MeshBlock itself (so that u is the potential, with ng ghost zones), while each
+//! coarser level has half as many cells in every active direction and one ghost zone.
+
+struct MGLevel {
+  int nx1, nx2, nx3;             // number of active cells per MeshBlock in each dir
+  int is, ie, js, je, ks, ke;    // indices of active cells
+  Real dx1, dx2, dx3;            // cell size (same for every MeshBlock on uniform Mesh)
+  DvceArray5D<Real> u, src, def; // solution (correction), source, and defect
+};
+
+//----------------------------------------------------------------------------------------
+//! \class Gravity
+
+class Gravity {
+ public:
+  Gravity(MeshBlockPack *ppack, ParameterInput *pin);
+  ~Gravity();
+
+  // solves Lap(phi) = four_pi_gee*(rho - <rho>), with <rho> the mean density
+  Real four_pi_gee;
+  DvceArray5D<Real> phi;            // gravitational potential
+  MeshBoundaryValuesCC *pbval_phi;  // exchange of phi between MeshBlocks
+
+  // parameters of the multigrid solver
+  Real mg_threshold;  // V-cycles stop when |defect|/|source| drops below this value
+  int mg_ncycle_max;  // maximum number of V-cycles per solve
+  int mg_npresmooth, mg_npostsmooth;  // number of smoothing sweeps on each level
+  bool reuse_phi;     // potential at previous solve is used as initial guess
+  int mg_ncycle_last;   // number of V-cycles taken by most recent solve
+  Real mg_resid_last;   // relative defect at end of most recent solve
+
+  // functions
+  void AssembleGravityTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  TaskStatus SolvePoisson(Driver *pdrive, int stage);
+  void AddSrcTerms(const DvceArray5D<Real> &w0, const Real bdt, const bool ener,
+                   DvceArray5D<Real> &u0);
+
+ private:
+  MeshBlockPack* pmy_pack;        // ptr to MeshBlockPack containing this Gravity
+  std::vector<MGLevel> lev_;      // levels of block multigrid, coarsest last
+  int nroot1_, nroot2_, nroot3_;  // size of global grid solved on coarsest level
+  std::vector<Real> root_src_, root_u_;  // (host) global source/solution on that grid
+  DualArray1D<Real> root_loc_;    // values of coarsest level on MeshBlocks of this rank
+  DualArray3D<Real> sbuf_, rbuf_; // buffers for faces of coarse levels shared with
+                                  // MeshBlocks on other ranks, (m, face, cell)
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm comm_mg_;              // unique communicator for coarse level messages
+  std::vector<MPI_Request> send_req_, recv_req_;
+#endif
+
+  Real SetSource();
+  void FillGhosts(const int l);
+  void Smooth(const int l, const int color);
+  Real CalculateDefect(const int l, const bool norm);
+  void Restrict(const int l);
+  void ProlongateAndCorrect(const int l);
+  void SolveRoot();
+  void VCycle();
+};
+
+} // namespace gravity
+#endif // GRAVITY_GRAVITY_HPP_
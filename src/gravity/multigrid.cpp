@@ -0,0 +1,537 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file multigrid.cpp
+//! \brief Multigrid solver for the Poisson equation of self-gravity.  Each MeshBlock is
+//! coarsened (by volume averages, as in MeshRefinement) down to the coarsest level
+//! allowed by its size, and the global problem on the grid formed by the coarsest level
+//! of all MeshBlocks is solved on every rank with conjugate gradients.  The potential on
+//! the finest level is exchanged between MeshBlocks with MeshBoundaryValuesCC, while the
+//! coarse levels (which only need face neighbors for the 2nd-order Laplacian) exchange
+//! a single layer of ghost cells through the face buffers sbuf_/rbuf_.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "mesh/nghbr_index.hpp"
+#include "mesh/restriction.hpp"
+#include "bvals/bvals.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "gravity/gravity.hpp"
+
+namespace gravity {
+//----------------------------------------------------------------------------------------
+//! \fn Real Gravity::SetSource
+//! \brief Sets the source on level 0 to four_pi_gee*(rho - <rho>), where rho is the sum
+//! of the Hydro and MHD densities, and returns its L2-norm over the whole Mesh.
+
+Real Gravity::SetSource() {
+  MGLevel &l0 = lev_[0];
+  int is = l0.is, js = l0.js, ks = l0.ks;
+  int nx1 = l0.nx1, nx2 = l0.nx2, nx3 = l0.nx3;
+  const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  bool use_hyd = (pmy_pack->phydro != nullptr);
+  bool use_mhd = (pmy_pack->pmhd != nullptr);
+  DvceArray5D<Real> uh, um;
+  if (use_hyd) {uh = pmy_pack->phydro->u0;}
+  if (use_mhd) {um = pmy_pack->pmhd->u0;}
+  auto src = l0.src;
+
+  Real sum_rho = 0.0;
+  Kokkos::parallel_reduce("grav_mass",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real rho = 0.0;
+    if (use_hyd) {rho += uh(m,IDN,k,j,i);}
+    if (use_mhd) {rho += um(m,IDN,k,j,i);}
+    src(m,0,k,j,i) = rho;
+    sum += rho;
+  }, Kokkos::Sum<Real>(sum_rho));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &sum_rho, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  Real rho_mean = sum_rho/(static_cast<Real>(pmy_pack->pmesh->nmb_total)*nkji);
+  Real four_pi_gee_ = four_pi_gee;
+
+  Real sum_sq = 0.0;
+  Kokkos::parallel_reduce("grav_src",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    src(m,0,k,j,i) = four_pi_gee_*(src(m,0,k,j,i) - rho_mean);
+    sum += SQR(src(m,0,k,j,i));
+  }, Kokkos::Sum<Real>(sum_sq));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &sum_sq, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  return std::sqrt(sum_sq);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::FillGhosts
+//! \brief Fills ghost cells of the solution u on level l from neighboring MeshBlocks.
+//! On coarse levels, ghost cells copied from MeshBlocks on this rank are filled while
+//! messages from other ranks are in flight.  Only the receives are waited for; sends are
+//! completed before their buffers are packed again, or at the end of SolvePoisson().
+
+void Gravity::FillGhosts(const int l) {
+  // finest level: potential is exchanged like any other cell-centered variable
+  if (l == 0) {
+    pbval_phi->InitRecv(1);
+    pbval_phi->PackAndSendCC(phi, phi);
+    while (pbval_phi->RecvAndUnpackCC(phi, phi) == TaskStatus::incomplete) {}
+    pbval_phi->ClearSend();
+    pbval_phi->ClearRecv();
+    return;
+  }
+
+  // coarse levels: one layer of ghost cells at each face
+  MGLevel &lv = lev_[l];
+  int is = lv.is, ie = lv.ie, js = lv.js, je = lv.je, ks = lv.ks, ke = lv.ke;
+  int nx1 = lv.nx1, nx2 = lv.nx2, nx3 = lv.nx3;
+  int nfmax = std::max(nx2*nx3, nx1*std::max(nx2, nx3));
+  int nmb = pmy_pack->nmb_thispack;
+  int nmb1 = nmb - 1;
+  int nface = (pmy_pack->pmesh->three_d)? 6 : ((pmy_pack->pmesh->multi_d)? 4 : 2);
+  int my_rank = global_variable::my_rank;
+  int mygids = pmy_pack->gids;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto u = lv.u;
+
+#if MPI_PARALLEL_ENABLED
+  bool remote = false;
+  for (int m=0; m<nmb; ++m) {
+    for (int f=0; f<nface; ++f) {
+      int n = NeighborIndex((f<2)? (2*f-1) : 0, (f/2==1)? (2*f-5) : 0,
+                            (f/2==2)? (2*f-9) : 0, 0, 0);
+      if (nghbr.h_view(m,n).rank != my_rank) {remote = true;}
+    }
+  }
+  // post receives, then pack and send the layer of active cells adjacent to each face
+  if (remote) {
+    int nf[3] = {nx2*nx3, nx1*nx3, nx1*nx2};
+    // send buffers may still be in use by messages sent by the previous call
+    MPI_Waitall(send_req_.size(), send_req_.data(), MPI_STATUSES_IGNORE);
+    for (int m=0; m<nmb; ++m) {
+      for (int f=0; f<nface; ++f) {
+        int n = NeighborIndex((f<2)? (2*f-1) : 0, (f/2==1)? (2*f-5) : 0,
+                              (f/2==2)? (2*f-9) : 0, 0, 0);
+        auto &nb = nghbr.h_view(m,n);
+        if (nb.rank != my_rank) {
+          int tag = CreateBvals_MPI_Tag(m, f);
+          MPI_Irecv(&(rbuf_.h_view(m,f,0)), nf[f/2], MPI_ATHENA_REAL, nb.rank, tag,
+                    comm_mg_, &(recv_req_[6*m+f]));
+        }
+      }
+    }
+    auto sbuf = sbuf_.d_view;
+    par_for("mg_pack", DevExeSpace(), 0, nmb1, 0, nface-1, 0, nfmax-1,
+    KOKKOS_LAMBDA(const int m, const int f, const int c) {
+      if (f < 2) {
+        if (c < nx2*nx3) {
+          sbuf(m,f,c) = u(m,0,ks+c/nx2,js+c%nx2,(f==0)? is : ie);
+        }
+      } else if (f < 4) {
+        if (c < nx1*nx3) {
+          sbuf(m,f,c) = u(m,0,ks+c/nx1,(f==2)? js : je,is+c%nx1);
+        }
+      } else {
+        if (c < nx1*nx2) {
+          sbuf(m,f,c) = u(m,0,(f==4)? ks : ke,js+c/nx1,is+c%nx1);
+        }
+      }
+    });
+    sbuf_.template modify<DevExeSpace>();
+    sbuf_.template sync<HostMemSpace>();
+    for (int m=0; m<nmb; ++m) {
+      for (int f=0; f<nface; ++f) {
+        int n = NeighborIndex((f<2)? (2*f-1) : 0, (f/2==1)? (2*f-5) : 0,
+                              (f/2==2)? (2*f-9) : 0, 0, 0);
+        auto &nb = nghbr.h_view(m,n);
+        if (nb.rank != my_rank) {
+          // tag uses local ID of the receiving MeshBlock, and the face it receives on
+          int lid = nb.gid - pmy_pack->pmesh->gids_eachrank[nb.rank];
+          int tag = CreateBvals_MPI_Tag(lid, (f ^ 1));
+          MPI_Isend(&(sbuf_.h_view(m,f,0)), nf[f/2], MPI_ATHENA_REAL, nb.rank, tag,
+                    comm_mg_, &(send_req_[6*m+f]));
+        }
+      }
+    }
+  }
+#endif
+
+  // fill ghost cells directly from MeshBlocks on this rank in the first pass, while
+  // messages are in flight, then from the receive buffers in the second pass
+  auto rbuf = rbuf_.d_view;
+  for (int pass=0; pass<2; ++pass) {
+    bool remote_faces = (pass == 1);
+    if (remote_faces) {
+#if MPI_PARALLEL_ENABLED
+      if (!(remote)) {break;}
+      MPI_Waitall(recv_req_.size(), recv_req_.data(), MPI_STATUSES_IGNORE);
+      rbuf_.template modify<HostMemSpace>();
+      rbuf_.template sync<DevExeSpace>();
+#else
+      break;
+#endif
+    }
+    par_for("mg_ghosts", DevExeSpace(), 0, nmb1, 0, nface-1, 0, nfmax-1,
+    KOKKOS_LAMBDA(const int m, const int f, const int c) {
+      int n = NeighborIndex((f<2)? (2*f-1) : 0, (f/2==1)? (2*f-5) : 0,
+                            (f/2==2)? (2*f-9) : 0, 0, 0);
+      int gid = nghbr.d_view(m,n).gid;
+      bool local = (nghbr.d_view(m,n).rank == my_rank);
+      int mn = gid - mygids;
+      if (gid < 0 || local == remote_faces) {return;}
+      if (f < 2) {
+        if (c < nx2*nx3) {
+          int k = ks + c/nx2, j = js + c%nx2;
+          u(m,0,k,j,(f==0)? is-1 : ie+1) = (local)? u(mn,0,k,j,(f==0)? ie : is) :
+                                                    rbuf(m,f,c);
+        }
+      } else if (f < 4) {
+        if (c < nx1*nx3) {
+          int k = ks + c/nx1, i = is + c%nx1;
+          u(m,0,k,(f==2)? js-1 : je+1,i) = (local)? u(mn,0,k,(f==2)? je : js,i) :
+                                                    rbuf(m,f,c);
+        }
+      } else {
+        if (c < nx1*nx2) {
+          int j = js + c/nx1, i = is + c%nx1;
+          u(m,0,(f==4)? ks-1 : ke+1,j,i) = (local)? u(mn,0,(f==4)? ke : ks,j,i) :
+                                                    rbuf(m,f,c);
+        }
+      }
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::Smooth
+//! \brief One red (color=0) or black (color=1) Gauss-Seidel sweep on level l.  Ghost
+//! cells must be filled before each sweep.
+
+void Gravity::Smooth(const int l, const int color) {
+  MGLevel &lv = lev_[l];
+  int is = lv.is, ie = lv.ie, js = lv.js, je = lv.je, ks = lv.ks, ke = lv.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  Real idx1sq = 1.0/SQR(lv.dx1);
+  Real idx2sq = (multi_d)? 1.0/SQR(lv.dx2) : 0.0;
+  Real idx3sq = (three_d)? 1.0/SQR(lv.dx3) : 0.0;
+  Real diag = 2.0*(idx1sq + idx2sq + idx3sq);
+  auto u = lv.u;
+  auto src = lv.src;
+
+  par_for("mg_smooth", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    if ((((i - is) + (j - js) + (k - ks)) & 1) != color) {return;}
+    Real sum = (u(m,0,k,j,i+1) + u(m,0,k,j,i-1))*idx1sq;
+    if (multi_d) {sum += (u(m,0,k,j+1,i) + u(m,0,k,j-1,i))*idx2sq;}
+    if (three_d) {sum += (u(m,0,k+1,j,i) + u(m,0,k-1,j,i))*idx3sq;}
+    u(m,0,k,j,i) = (sum - src(m,0,k,j,i))/diag;
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real Gravity::CalculateDefect
+//! \brief Computes defect = src - Lap(u) on level l, and (with norm=true) returns its
+//! L2-norm over the whole Mesh.  Ghost cells of u must be filled.
+
+Real Gravity::CalculateDefect(const int l, const bool norm) {
+  MGLevel &lv = lev_[l];
+  int is = lv.is, js = lv.js, ks = lv.ks;
+  int nx1 = lv.nx1, nx2 = lv.nx2, nx3 = lv.nx3;
+  const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  Real idx1sq = 1.0/SQR(lv.dx1);
+  Real idx2sq = 1.0/SQR(lv.dx2);
+  Real idx3sq = 1.0/SQR(lv.dx3);
+  auto u = lv.u;
+  auto src = lv.src;
+  auto def = lv.def;
+
+  Real sum_sq = 0.0;
+  Kokkos::parallel_reduce("mg_defect",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real lap = (u(m,0,k,j,i+1) - 2.0*u(m,0,k,j,i) + u(m,0,k,j,i-1))*idx1sq;
+    if (multi_d) {
+      lap += (u(m,0,k,j+1,i) - 2.0*u(m,0,k,j,i) + u(m,0,k,j-1,i))*idx2sq;
+    }
+    if (three_d) {
+      lap += (u(m,0,k+1,j,i) - 2.0*u(m,0,k,j,i) + u(m,0,k-1,j,i))*idx3sq;
+    }
+    def(m,0,k,j,i) = src(m,0,k,j,i) - lap;
+    sum += SQR(def(m,0,k,j,i));
+  }, Kokkos::Sum<Real>(sum_sq));
+  if (!(norm)) {return 0.0;}
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &sum_sq, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  return std::sqrt(sum_sq);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::Restrict
+//! \brief Restricts the defect on level l to the source on level l+1, and zeros the
+//! solution (correction) on level l+1.
+
+void Gravity::Restrict(const int l) {
+  MGLevel &lf = lev_[l];
+  MGLevel &lc = lev_[l+1];
+  int is = lc.is, ie = lc.ie, js = lc.js, je = lc.je, ks = lc.ks, ke = lc.ke;
+  int fis = lf.is, fjs = lf.js, fks = lf.ks;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int dj = (pmy_pack->pmesh->multi_d)? 1 : 0;
+  int dk = (pmy_pack->pmesh->three_d)? 1 : 0;
+  auto def = lf.def;
+  auto src = lc.src;
+
+  par_for("mg_restrict", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int fi = fis + 2*(i - is);
+    int fj = fjs + (1+dj)*(j - js);
+    int fk = fks + (1+dk)*(k - ks);
+    src(m,0,k,j,i) = RestrictAverage(m, 0, fk, fj, fi, dk, dj, 1, def);
+  });
+  Kokkos::deep_copy(DevExeSpace(), lc.u, 0.0);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::ProlongateAndCorrect
+//! \brief Adds the correction on level l+1, prolongated with (unlimited) piecewise-linear
+//! interpolation, to the solution on level l.  Ghost cells on level l+1 must be filled.
+
+void Gravity::ProlongateAndCorrect(const int l) {
+  MGLevel &lf = lev_[l];
+  MGLevel &lc = lev_[l+1];
+  int is = lf.is, ie = lf.ie, js = lf.js, je = lf.je, ks = lf.ks, ke = lf.ke;
+  int cis = lc.is, cjs = lc.js, cks = lc.ks;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto uf = lf.u;
+  auto uc = lc.u;
+
+  par_for("mg_prolong", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int fk, const int fj, const int fi) {
+    int i = cis + (fi - is)/2;
+    Real si = ((fi - is) & 1)? 0.125 : -0.125;
+    int j = cjs, k = cks;
+    Real sj = 0.0, sk = 0.0;
+    if (multi_d) {
+      j += (fj - js)/2;
+      sj = ((fj - js) & 1)? 0.125 : -0.125;
+    }
+    if (three_d) {
+      k += (fk - ks)/2;
+      sk = ((fk - ks) & 1)? 0.125 : -0.125;
+    }
+    Real corr = uc(m,0,k,j,i) + si*(uc(m,0,k,j,i+1) - uc(m,0,k,j,i-1));
+    if (multi_d) {corr += sj*(uc(m,0,k,j+1,i) - uc(m,0,k,j-1,i));}
+    if (three_d) {corr += sk*(uc(m,0,k+1,j,i) - uc(m,0,k-1,j,i));}
+    uf(m,0,fk,fj,fi) += corr;
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::SolveRoot
+//! \brief Solves Lap(e) = rhs on the global periodic grid formed by the coarsest level of
+//! all MeshBlocks with conjugate gradients, and adds e to the solution on that level.
+//! The rhs is the source of the coarsest level, or the defect if the MeshBlocks cannot be
+//! coarsened at all.  The (small) grid is gathered onto, and solved by, every rank.
+
+void Gravity::SolveRoot() {
+  int lr = static_cast<int>(lev_.size()) - 1;
+  MGLevel &lv = lev_[lr];
+  int is = lv.is, js = lv.js, ks = lv.ks;
+  int nx1 = lv.nx1, nx2 = lv.nx2, nx3 = lv.nx3;
+  int ncell = nx1*nx2*nx3;
+  int nmb = pmy_pack->nmb_thispack;
+  int nmb1 = nmb - 1;
+  auto rhs = (lr == 0)? lv.def : lv.src;
+  auto u = lv.u;
+  auto loc = root_loc_.d_view;
+
+  // gather rhs of every MeshBlock, ordered by gid
+  par_for("mg_root_pack", DevExeSpace(), 0, nmb1, 0, nx3-1, 0, nx2-1, 0, nx1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    loc(m*ncell + (k*nx2 + j)*nx1 + i) = rhs(m,0,k+ks,j+js,i+is);
+  });
+  root_loc_.template modify<DevExeSpace>();
+  root_loc_.template sync<HostMemSpace>();
+  Mesh *pm = pmy_pack->pmesh;
+  std::vector<Real> gathered(pm->nmb_total*ncell);
+#if MPI_PARALLEL_ENABLED
+  std::vector<int> counts(global_variable::nranks), displs(global_variable::nranks);
+  for (int n=0; n<global_variable::nranks; ++n) {
+    counts[n] = pm->nmb_eachrank[n]*ncell;
+    displs[n] = pm->gids_eachrank[n]*ncell;
+  }
+  MPI_Allgatherv(root_loc_.h_view.data(), nmb*ncell, MPI_ATHENA_REAL, gathered.data(),
+                 counts.data(), displs.data(), MPI_ATHENA_REAL, MPI_COMM_WORLD);
+#else
+  for (int n=0; n<nmb*ncell; ++n) {gathered[n] = root_loc_.h_view(n);}
+#endif
+
+  // map to global grid using logical locations of MeshBlocks, and remove mean of rhs so
+  // the periodic problem is solvable
+  int n1 = nroot1_, n2 = nroot2_, n3 = nroot3_;
+  int ntot = n1*n2*n3;
+  Real mean = 0.0;
+  for (int g=0; g<pm->nmb_total; ++g) {
+    auto &lloc = pm->lloc_eachmb[g];
+    for (int k=0; k<nx3; ++k) {
+      for (int j=0; j<nx2; ++j) {
+        for (int i=0; i<nx1; ++i) {
+          int gi = lloc.lx1*nx1 + i, gj = lloc.lx2*nx2 + j, gk = lloc.lx3*nx3 + k;
+          Real val = gathered[g*ncell + (k*nx2 + j)*nx1 + i];
+          root_src_[(gk*n2 + gj)*n1 + gi] = val;
+          mean += val;
+        }
+      }
+    }
+  }
+  mean /= static_cast<Real>(ntot);
+
+  // CG for -Lap(e) = -rhs, which is symmetric positive semi-definite
+  Real idx1sq = 1.0/SQR(lv.dx1);
+  Real idx2sq = (pm->multi_d)? 1.0/SQR(lv.dx2) : 0.0;
+  Real idx3sq = (pm->three_d)? 1.0/SQR(lv.dx3) : 0.0;
+  auto neg_lap = [&](const std::vector<Real> &x, std::vector<Real> &ax) {
+    for (int k=0; k<n3; ++k) {
+      int kp = (k+1)%n3, km = (k+n3-1)%n3;
+      for (int j=0; j<n2; ++j) {
+        int jp = (j+1)%n2, jm = (j+n2-1)%n2;
+        for (int i=0; i<n1; ++i) {
+          int ip = (i+1)%n1, im = (i+n1-1)%n1;
+          Real xc = x[(k*n2 + j)*n1 + i];
+          ax[(k*n2 + j)*n1 + i] =
+            (2.0*xc - x[(k*n2 + j)*n1 + ip] - x[(k*n2 + j)*n1 + im])*idx1sq +
+            (2.0*xc - x[(k*n2 + jp)*n1 + i] - x[(k*n2 + jm)*n1 + i])*idx2sq +
+            (2.0*xc - x[(kp*n2 + j)*n1 + i] - x[(km*n2 + j)*n1 + i])*idx3sq;
+        }
+      }
+    }
+  };
+  std::vector<Real> r(ntot), p(ntot), ap(ntot);
+  Real rr = 0.0;
+  for (int n=0; n<ntot; ++n) {
+    root_u_[n] = 0.0;
+    r[n] = mean - root_src_[n];
+    p[n] = r[n];
+    rr += r[n]*r[n];
+  }
+  Real tol = 1.0e-24*rr;
+  for (int iter=0; (iter<ntot) && (rr > tol); ++iter) {
+    neg_lap(p, ap);
+    Real pap = 0.0;
+    for (int n=0; n<ntot; ++n) {pap += p[n]*ap[n];}
+    if (pap <= 0.0) {break;}
+    Real alpha = rr/pap;
+    Real rr_new = 0.0;
+    for (int n=0; n<ntot; ++n) {
+      root_u_[n] += alpha*p[n];
+      r[n] -= alpha*ap[n];
+      rr_new += r[n]*r[n];
+    }
+    Real beta = rr_new/rr;
+    for (int n=0; n<ntot; ++n) {p[n] = r[n] + beta*p[n];}
+    rr = rr_new;
+  }
+
+  // scatter solution back to MeshBlocks on this rank and add to solution
+  for (int m=0; m<nmb; ++m) {
+    auto &lloc = pm->lloc_eachmb[pmy_pack->gids + m];
+    for (int k=0; k<nx3; ++k) {
+      for (int j=0; j<nx2; ++j) {
+        for (int i=0; i<nx1; ++i) {
+          int gi = lloc.lx1*nx1 + i, gj = lloc.lx2*nx2 + j, gk = lloc.lx3*nx3 + k;
+          root_loc_.h_view(m*ncell + (k*nx2 + j)*nx1 + i) =
+            root_u_[(gk*n2 + gj)*n1 + gi];
+        }
+      }
+    }
+  }
+  root_loc_.template modify<HostMemSpace>();
+  root_loc_.template sync<DevExeSpace>();
+  par_for("mg_root_unpack", DevExeSpace(), 0, nmb1, 0, nx3-1, 0, nx2-1, 0, nx1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    u(m,0,k+ks,j+js,i+is) += loc(m*ncell + (k*nx2 + j)*nx1 + i);
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::VCycle
+//! \brief One V-cycle of the correction scheme, starting from the current potential.
+
+void Gravity::VCycle() {
+  int nlev = static_cast<int>(lev_.size());
+  auto smooth = [&](const int l, const int nsweep) {
+    for (int s=0; s<nsweep; ++s) {
+      FillGhosts(l);
+      Smooth(l, 0);
+      FillGhosts(l);
+      Smooth(l, 1);
+    }
+  };
+
+  // down: smooth, and restrict defect to source of next coarser level
+  for (int l=0; l<nlev-1; ++l) {
+    smooth(l, mg_npresmooth);
+    FillGhosts(l);
+    CalculateDefect(l, false);
+    Restrict(l);
+  }
+
+  // exact solution on coarsest level
+  if (nlev == 1) {
+    FillGhosts(0);
+    CalculateDefect(0, false);
+  }
+  SolveRoot();
+
+  // up: prolongate and add correction, then smooth
+  for (int l=nlev-2; l>=0; --l) {
+    FillGhosts(l+1);
+    ProlongateAndCorrect(l);
+    smooth(l, mg_npostsmooth);
+  }
+  return;
+}
+
+} // namespace gravity
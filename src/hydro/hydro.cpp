@@ -32,9 +32,13 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
     coarse_u0("ccons",1,1,1,1,1),
     coarse_w0("cprim",1,1,1,1,1),
     u1("cons1",1,1,1,1,1),
+    u_sts0("u_sts0",1,1,1,1,1),
+    du_sts0("du_sts0",1,1,1,1,1),
     uflx("uflx",1,1,1,1,1),
     utest("utest",1,1,1,1,1),
-    fofc("fofc",1,1,1,1) {
+    fofc("fofc",1,1,1,1),
+    fofc_list("fofc_list",1),
+    fofc_nlist("fofc_nlist",1) {
   // Total number of MeshBlocks on this rank to be used in array dimensioning
   int nmb = std::max((ppack->nmb_thispack), (ppack->pmesh->nmb_maxperrank));
 
@@ -105,19 +109,23 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
     Kokkos::realloc(w0, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
   }
 
-  // allocate memory for conserved variables on coarse mesh
+  // allocate memory for conserved variables on coarse mesh.  Primitive variables on the
+  // coarse mesh are only used when primitives are prolongated.
   if (ppack->pmesh->multilevel) {
     auto &indcs = pmy_pack->pmesh->mb_indcs;
     int n_ccells1 = indcs.cnx1 + 2*(indcs.ng);
     int n_ccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
     int n_ccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
     Kokkos::realloc(coarse_u0, nmb, (nhydro+nscalars), n_ccells3, n_ccells2, n_ccells1);
-    Kokkos::realloc(coarse_w0, nmb, (nhydro+nscalars), n_ccells3, n_ccells2, n_ccells1);
+    if (ppack->pmesh->pmr->prolong_prims) {
+      Kokkos::realloc(coarse_w0, nmb, (nhydro+nscalars), n_ccells3, n_ccells2, n_ccells1);
+    }
   }
 
   // allocate boundary buffers for conserved (cell-centered) variables
   pbval_u = new MeshBoundaryValuesCC(ppack, pin, false);
   pbval_u->InitializeBuffers((nhydro+nscalars));
+  pbval_u->SetHaloPrecision(pin, "hydro");
 
   // Orbital advection and shearing box BCs (if requested in input file)
   if (pin->DoesBlockExist("shearing_box")) {
@@ -179,6 +187,25 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
       std::exit(EXIT_FAILURE);
     }
 
+    // select reconstruction of passive scalars: "same" as the hydro variables (default),
+    // or lower order in a separate kernel
+    std::string sorder = pin->GetOrAddString("hydro","scalar_reconstruct","same");
+    if (sorder.compare("dc") == 0 || sorder.compare("plm") == 0) {
+      scalar_plm = (sorder.compare("plm") == 0);
+      use_scalar_fluxes = (nscalars > 0);
+      if (scalar_plm && (recon_method == ReconstructionMethod::dc)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/scalar_reconstruct=plm requires <hydro>/reconstruct "
+          << "of at least the same order" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    } else if (sorder.compare("same") != 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<hydro> scalar_reconstruct = '" << sorder
+                << "' not implemented" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
     // select Riemann solver (no default).  Test for compatibility of options
     std::string rsolver = pin->GetString("hydro","rsolver");
     // Special relativistic dynamic solvers
@@ -265,17 +292,118 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
       }
     }
 
+    // determine if fused flux+update kernel is enabled.  Fluxes are not stored, so it
+    // cannot be used with options that correct or add to the fluxes.
+    use_fused = pin->GetOrAddBoolean("hydro","fused",false);
+    if (use_fused) {
+      bool excise = (pmy_pack->pcoord->is_general_relativistic &&
+                     pmy_pack->pcoord->coord_data.bh_excise);
+      if (use_fofc || excise || pmy_pack->pmesh->multilevel || (pvisc != nullptr) ||
+          (pcond != nullptr) || use_scalar_fluxes) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/fused=true cannot be used with FOFC, BH excision, "
+          << "SMR/AMR, viscosity, conduction, or <hydro>/scalar_reconstruct"
+          << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // select specialisation of CalculateFluxes() for this rsolver and reconstruction
+    SelectFluxFunction();
+
+    // determine number of ghost layers of primitives computed every stage.  By default
+    // all ng layers are converted.  Optionally only the layers used by the reconstruction
+    // stencil (plus one with FOFC or excision) are converted, in which case primitives
+    // in the remaining ghost layers are not updated (so should not be used in outputs
+    // or user functions).
+    c2p_ng = pmy_pack->pmesh->mb_indcs.ng;
+    if (pin->GetOrAddBoolean("hydro","c2p_min_ghosts",false)) {
+      bool excise = (pmy_pack->pcoord->is_general_relativistic &&
+                     pmy_pack->pcoord->coord_data.bh_excise);
+      int nb = FluxStencilWidth(recon_method) + ((use_fofc || excise)? 1 : 0);
+      c2p_ng = std::min(c2p_ng, nb);
+    }
+
+    // determine if fluxes are split into interior/boundary passes.  Fluxes for the next
+    // stage are computed at the end of each stage, so they cannot be used with options
+    // that correct the fluxes after the RK update.
+    use_split_fluxes = pin->GetOrAddBoolean("hydro","split_fluxes",false);
+    if (use_split_fluxes) {
+      bool excise = (pmy_pack->pcoord->is_general_relativistic &&
+                     pmy_pack->pcoord->coord_data.bh_excise);
+      if (use_fofc || excise || use_fused) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/split_fluxes=true cannot be used with FOFC, BH "
+          << "excision, or <hydro>/fused=true" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // determine if viscosity and conduction are integrated with operator-split
+    // super-time-stepping, in which case they do not limit the timestep.  The
+    // <time>/sts_integrator parameter is error checked in the Driver constructor.
+    std::string sts = pin->GetOrAddString("time","sts_integrator","none");
+    use_sts = (sts.compare("none") != 0) && ((pvisc != nullptr) || (pcond != nullptr));
+    if (use_sts && (psrc->shearing_box)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<time>/sts_integrator cannot be used with shearing box"
+        << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // determine if timestep is computed from the signal speeds saved by the flux kernels
+    // in the last stage, instead of in a separate pass over the primitives.  The speeds
+    // are from the L/R states of the last stage, so the timestep lags by one stage.
+    use_cached_dt = pin->GetOrAddBoolean("hydro","cached_dt",false);
+    if (use_cached_dt) {
+      if (use_fused || pmy_pack->pcoord->is_special_relativistic ||
+          pmy_pack->pcoord->is_general_relativistic ||
+          pmy_pack->pcoord->is_dynamical_relativistic) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/cached_dt=true can only be used for non-relativistic "
+          << "hydrodynamics without <hydro>/fused=true" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      Kokkos::realloc(max_speed, nmb, 3);
+    }
+
+    // determine if timestep is reduced in the c2p kernel of the last stage, which saves
+    // a pass over the primitives.  The timestep is the same as computed by NewTimeStep().
+    use_c2p_dt = pin->GetOrAddBoolean("hydro","c2p_dt",false);
+    if (use_c2p_dt) {
+      if (!(peos->eos_data.is_ideal) || use_cached_dt ||
+          pmy_pack->pcoord->is_special_relativistic ||
+          pmy_pack->pcoord->is_general_relativistic ||
+          pmy_pack->pcoord->is_dynamical_relativistic) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/c2p_dt=true can only be used for non-relativistic "
+          << "hydrodynamics with an ideal gas EOS, without <hydro>/cached_dt=true"
+          << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
     // Final memory allocations
     {
-      // allocate second registers, fluxes
+      // allocate second registers, fluxes (not needed with fused update)
       auto &indcs = pmy_pack->pmesh->mb_indcs;
       int ncells1 = indcs.nx1 + 2*(indcs.ng);
       int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
       int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
       Kokkos::realloc(u1,       nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
-      Kokkos::realloc(uflx.x1f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
-      Kokkos::realloc(uflx.x2f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
-      Kokkos::realloc(uflx.x3f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      if (!(use_fused)) {
+        Kokkos::realloc(uflx.x1f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+        Kokkos::realloc(uflx.x2f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+        Kokkos::realloc(uflx.x3f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      }
+
+      // allocate registers used by super-time-stepping
+      if (use_sts) {
+        Kokkos::realloc(u_sts0, nmb, nhydro, ncells3, ncells2, ncells1);
+        if (sts.compare("rkl2") == 0) {
+          Kokkos::realloc(du_sts0, nmb, nhydro, ncells3, ncells2, ncells1);
+        }
+      }
 
       // allocate array of flags used with FOFC
       if (use_fofc) {
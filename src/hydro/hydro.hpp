@@ -16,6 +16,7 @@
 #include "parameter_input.hpp"
 #include "tasklist/task_list.hpp"
 #include "bvals/bvals.hpp"
+#include "reconstruct/flux_region.hpp"
 
 // forward declarations
 class EquationOfState;
@@ -48,12 +49,14 @@ struct HydroTaskIDs {
   TaskID recvu_oa;
   TaskID restu;
   TaskID sendu;
+  TaskID iflux;
   TaskID recvu;
   TaskID sendu_shr;
   TaskID recvu_shr;
   TaskID bcs;
   TaskID prol;
   TaskID c2p;
+  TaskID bflux;
   TaskID newdt;
   TaskID csend;
   TaskID crecv;
@@ -76,6 +79,10 @@ class Hydro {
 
   int nhydro;             // number of hydro variables (5/4 for ideal/isothermal EOS)
   int nscalars;           // number of passive scalars
+  // with <hydro>/scalar_reconstruct=dc/plm, fluxes of scalars are computed in a separate
+  // kernel from the mass flux, see reconstruct/scalar_fluxes.hpp
+  bool use_scalar_fluxes = false;
+  bool scalar_plm = false;  // PLM (otherwise donor cell) upwind states of scalars
   DvceArray5D<Real> u0;   // conserved variables
   DvceArray5D<Real> w0;   // primitive variables
 
@@ -103,6 +110,32 @@ class Hydro {
   DvceArray4D<bool> fofc;  // flag for each cell to indicate if FOFC is needed
   bool use_fofc = false;   // flag to enable FOFC
   DvceArray5D<Real> utest;  // scratch array for FOFC
+  DvceArray1D<int> fofc_list;   // compacted list of cells flagged for FOFC/excision
+  DualArray1D<int> fofc_nlist;  // number of cells in fofc_list
+
+  // fused flux + update kernel (fluxes are not stored in uflx)
+  bool use_fused = false;
+
+  // split fluxes: fluxes for next stage on interior faces are computed while boundary
+  // values of U are communicated, and on boundary faces after they are received
+  bool use_split_fluxes = false;
+
+  // operator-split super-time-stepping (RKL1/RKL2) of viscosity and conduction
+  bool use_sts = false;
+  DvceArray5D<Real> u_sts0;   // conserved variables at start of STS step
+  DvceArray5D<Real> du_sts0;  // dt*L(U) at start of STS step (only used with RKL2)
+
+  // number of ghost layers converted to primitives in ConToPrim() every stage, which is
+  // reduced to the depth used by the flux stencil when <hydro>/c2p_min_ghosts=true
+  int c2p_ng;
+
+  // cached timestep: max signal speed in each direction on the faces of each MeshBlock,
+  // saved by the flux kernels in the last stage and used by NewTimeStep()
+  bool use_cached_dt = false;
+  DvceArray2D<Real> max_speed;
+
+  // timestep reduced in the c2p kernel of the last stage, see ConsToPrimNewDt()
+  bool use_c2p_dt = false;
 
   // container to hold names of TaskIDs
   HydroTaskIDs id;
@@ -122,26 +155,45 @@ class Hydro {
   TaskStatus RecvU_OA(Driver *d, int stage);
   TaskStatus RestrictU(Driver *d, int stage);
   TaskStatus SendU(Driver *d, int stage);
+  TaskStatus InteriorFluxes(Driver *d, int stage);
   TaskStatus RecvU(Driver *d, int stage);
   TaskStatus SendU_Shr(Driver *d, int stage);
   TaskStatus RecvU_Shr(Driver *d, int stage);
   TaskStatus ApplyPhysicalBCs(Driver* pdrive, int stage);
   TaskStatus Prolongate(Driver* pdrive, int stage);
   TaskStatus ConToPrim(Driver *d, int stage);
+  TaskStatus BoundaryFluxes(Driver *d, int stage);
   TaskStatus NewTimeStep(Driver *d, int stage);
   // ...in "after_stagen_tl" list
   TaskStatus ClearSend(Driver *d, int stage);
   TaskStatus ClearRecv(Driver *d, int stage);  // also in Driver::Initialize
+  // ...in "sts" list (along with many of the functions above)
+  void AssembleSTSTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  TaskStatus STSFluxes(Driver *d, int stage);
+  TaskStatus STSUpdate(Driver *d, int stage);
+
+  // CalculateFluxes function templated over Riemann Solvers and reconstruction methods
+  template <Hydro_RSolver T, ReconstructionMethod R>
+  void CalculateFluxes(Driver *d, int stage, FluxRegion region=FluxRegion::all);
+  using FluxFunction = void (Hydro::*)(Driver *d, int stage, FluxRegion region);
 
-  // CalculateFluxes function templated over Riemann Solvers
+  // fused reconstruction, RS, flux divergence and RK update, templated over RSolvers
   template <Hydro_RSolver T>
-  void CalculateFluxes(Driver *d, int stage);
+  void FusedUpdate(Driver *d, int stage);
 
   // first-order flux correction
   void FOFC(Driver *d, int stage);
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
+  bool interior_c2p_done_ = false;  // interior W computed in InteriorFluxes()
+  bool fluxes_done_ = false;        // fluxes for next stage computed in BoundaryFluxes()
+  bool speeds_cached_ = false;      // max_speed saved by last-stage flux calculation
+  bool dt_c2p_ready_ = false;       // dt_c2p_ computed by last-stage ConToPrim()
+  Real dt_c2p_[3];                  // min dx/(|v|+cs) in each direction from c2p
+  void CalculateFluxesInRegion(Driver *d, int stage, FluxRegion region);
+  FluxFunction calc_fluxes_ = nullptr;  // CalculateFluxes() specialisation for this run
+  void SelectFluxFunction();
 };
 
 } // namespace hydro
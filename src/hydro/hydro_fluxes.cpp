@@ -17,6 +17,8 @@
 #include "reconstruct/plm.hpp"
 #include "reconstruct/ppm.hpp"
 #include "reconstruct/wenoz.hpp"
+#include "reconstruct/flux_region.hpp"
+#include "reconstruct/scalar_fluxes.hpp"
 #include "hydro/rsolvers/advect_hyd.hpp"
 #include "hydro/rsolvers/llf_hyd.hpp"
 #include "hydro/rsolvers/hlle_hyd.hpp"
@@ -27,39 +29,120 @@
 #include "hydro/rsolvers/hllc_srhyd.hpp"
 #include "hydro/rsolvers/llf_grhyd.hpp"
 #include "hydro/rsolvers/hlle_grhyd.hpp"
+#include "utils/roofline.hpp"
 
 namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \fn void MaxSignalSpeed()
+//! \brief Reduces the maximum signal speed |v|+cs (or |v| for advection) over the L/R
+//! states on faces [il,iu] across the team, and accumulates it into smax(m,dir).  Used
+//! to save the speeds for the timestep with <hydro>/cached_dt=true.
+
+template <bool advect>
+KOKKOS_INLINE_FUNCTION
+void MaxSignalSpeed(TeamMember_t const &member, const EOS_Data &eos, const int m,
+                    const int dir, const int ivx, const int il, const int iu,
+                    const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr,
+                    const DvceArray2D<Real> &smax) {
+  Real vmax = 0.0;
+  Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, il, iu+1),
+  [&](const int i, Real &lmax) {
+    Real sl = fabs(wl(ivx,i)), sr = fabs(wr(ivx,i));
+    if constexpr (!advect) {
+      if (eos.is_ideal) {
+        sl += eos.IdealHydroSoundSpeed(wl(IDN,i), eos.IdealGasPressure(wl(IEN,i)));
+        sr += eos.IdealHydroSoundSpeed(wr(IDN,i), eos.IdealGasPressure(wr(IEN,i)));
+      } else {
+        sl += eos.iso_cs;
+        sr += eos.iso_cs;
+      }
+    }
+    lmax = fmax(lmax, fmax(sl, sr));
+  }, Kokkos::Max<Real>(vmax));
+  Kokkos::single(Kokkos::PerTeam(member), [&]() {
+    Kokkos::atomic_max(&smax(m,dir), vmax);
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real RSolverFlops()
+//! \brief Rough number of floating point operations of the Riemann solver at one face,
+//! used for the estimates in utils/roofline.hpp.
+
+constexpr Real RSolverFlops(Hydro_RSolver rs) {
+  switch (rs) {
+    case Hydro_RSolver::advect: return 10.0;
+    case Hydro_RSolver::llf: return 60.0;
+    case Hydro_RSolver::hlle: return 100.0;
+    case Hydro_RSolver::hllc: return 150.0;
+    case Hydro_RSolver::roe: return 250.0;
+    case Hydro_RSolver::llf_sr: case Hydro_RSolver::hlle_sr: return 200.0;
+    case Hydro_RSolver::hllc_sr: return 300.0;
+    default: return 400.0;  // GR
+  }
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Hydro::CalculateFluxes
 //! \brief Calls reconstruction and Riemann solver functions to compute hydro fluxes
-//! Note this function is templated over RS for better performance on GPUs.
-
-template <Hydro_RSolver rsolver_method_>
-void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
+//! Note this function is templated over RS and reconstruction method, so that a fully
+//! specialised kernel without branches in the inner loops is compiled for each pair.
+//! The instantiation to use is selected once in SelectFluxFunction().
+//! With region=interior (boundary) only fluxes on faces which do not (do) depend on
+//! ghost zones are computed, see reconstruct/flux_region.hpp
+
+template <Hydro_RSolver rsolver_method_, ReconstructionMethod recon_method_>
+void Hydro::CalculateFluxes(Driver *pdriver, int stage, FluxRegion region) {
   RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
   int is = indcs_.is, ie = indcs_.ie;
   int js = indcs_.js, je = indcs_.je;
   int ks = indcs_.ks, ke = indcs_.ke;
   int ncells1 = indcs_.nx1 + 2*(indcs_.ng);
+  // indices used inside kernels, constexpr if MeshBlock size is fixed at compile time
+  const KernelIndcs ki(indcs_);
 
   int &nhyd_  = nhydro;
   int nvars = nhydro + nscalars;
+  // number of variables reconstructed here (scalars done later with scalar_reconstruct)
+  int nrecon = (use_scalar_fluxes)? nhydro : nvars;
   int nmb1 = pmy_pack->nmb_thispack - 1;
-  const auto recon_method_ = recon_method;
-  bool extrema = false;
-  if (recon_method == ReconstructionMethod::ppmx) {
-    extrema = true;
-  }
+  constexpr bool extrema = (recon_method_ == ReconstructionMethod::ppmx);
 
   auto &eos_ = peos->eos_data;
   auto &size_ = pmy_pack->pmb->mb_size;
+  pmy_pack->pcoord->UpdateMetricCache();
   auto &coord_ = pmy_pack->pcoord->coord_data;
   auto &w0_ = w0;
+  int nb = FluxStencilWidth(recon_method_);
+
+  // with <hydro>/cached_dt, save max signal speeds on faces when computing fluxes for
+  // the last stage.  With split fluxes these are computed in the previous stage.
+  constexpr bool advect = (rsolver_method_ == Hydro_RSolver::advect);
+  bool save_speeds = use_cached_dt &&
+      (((region == FluxRegion::all)? stage : stage+1) == pdriver->nexp_stages);
+  if (save_speeds) {
+    if (max_speed.extent_int(0) < (nmb1+1)) {
+      Kokkos::realloc(max_speed, (nmb1+1), 3);
+    }
+    if (region != FluxRegion::boundary) {
+      Kokkos::deep_copy(DevExeSpace(), max_speed, 0.0);
+    }
+    speeds_cached_ = true;
+  }
+  auto &max_speed_ = max_speed;
+
+  // estimated work per face for roofline analysis: W loaded and flux stored once.  The
+  // interior and boundary passes together cover each face once, so count it in one.
+  Real ncells = (region == FluxRegion::boundary)? 0.0 :
+      static_cast<Real>(nmb1 + 1)*indcs_.nx1*indcs_.nx2*indcs_.nx3;
+  Real face_bytes = 2.0*nvars*sizeof(Real);
+  Real face_flops = nrecon*roofline::ReconFlops(recon_method_) +
+                    RSolverFlops(rsolver_method_);
 
   //--------------------------------------------------------------------------------------
   // i-direction
 
-  size_t scr_size = ScrArray2D<Real>::shmem_size(nvars, ncells1) * 2;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nrecon, ncells1) * 2;
   int scr_level = 0;
   auto &flx1_ = uflx.x1f;
 
@@ -73,73 +156,84 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
       jl = js-1, ju = je+1, kl = ks-1, ku = ke+1;
     }
   }
+  // rows in transverse ghost zones (only computed with FOFC) contain only boundary faces
+  FaceRanges rng1  = FluxFaceRanges(region, nb, false, il, iu, is, ie, 0, 0, 0, 0);
+  FaceRanges rng1g = FluxFaceRanges(region, nb, true,  il, iu, is, ie, 0, 0, 0, 0);
 
-  par_for_outer("hflux_x1",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku, jl, ju,
+  roofline::AddWork("hflux_x1", ncells, face_bytes, face_flops);
+  par_for_outer("hflux_x1",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku,
+                jl, ju,
   KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
-    ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
-    ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
-
-    // Reconstruct qR[i] and qL[i+1]
-    switch (recon_method_) {
-      case ReconstructionMethod::dc:
-        DonorCellX1(member, m, k, j, il-1, iu, w0_, wl, wr);
-        break;
-      case ReconstructionMethod::plm:
-        PiecewiseLinearX1(member, m, k, j, il-1, iu, w0_, wl, wr);
-        break;
-      case ReconstructionMethod::ppm4:
-      case ReconstructionMethod::ppmx:
-        PiecewiseParabolicX1(member,eos_,extrema,true, m, k, j, il-1, iu, w0_, wl, wr);
-        break;
-      case ReconstructionMethod::wenoz:
-        WENOZX1(member, eos_, true, m, k, j, il-1, iu, w0_, wl, wr);
-        break;
-      default:
-        break;
-    }
-    // Sync all threads in the team so that scratch memory is consistent
-    member.team_barrier();
-
-    // compute fluxes over [is,ie+1]
-    // NOTE(@pdmullen): Capture variables prior to if constexpr.  Required for cuda 11.6+.
-    auto eos = eos_;
-    auto indcs = indcs_;
-    auto size = size_;
-    auto coord = coord_;
-    auto flx1 = flx1_;
-    if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
-      Advect(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
-      LLF(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
-      HLLE(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
-      HLLC(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
-      Roe(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
-      LLF_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
-      HLLE_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
-      HLLC_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
-      LLF_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
-      HLLE_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    }
-    member.team_barrier();
-
-    // calculate fluxes of scalars (if any)
-    if (nvars > nhyd_) {
-      for (int n=nhyd_; n<nvars; ++n) {
-        par_for_inner(member, is, ie+1, [&](const int i) {
-          if (flx1_(m,IDN,k,j,i) >= 0.0) {
-            flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wl(n,i);
-          } else {
-            flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wr(n,i);
-          }
-        });
+    ScrArray2D<Real> wl(member.team_scratch(scr_level), nrecon, ki.ncells1);
+    ScrArray2D<Real> wr(member.team_scratch(scr_level), nrecon, ki.ncells1);
+    const FaceRanges &rng_ =
+        ((j<ki.js) || (j>ki.je) || (k<ki.ks) || (k>ki.ke))? rng1g : rng1;
+
+    for (int r=0; r<rng_.n; ++r) {
+      int fl = rng_.fl[r], fu = rng_.fu[r];
+      int sl = (fl > ki.is)? fl : ki.is, su = (fu < ki.ie+1)? fu : ki.ie+1;
+
+      // Reconstruct qR[i] and qL[i+1]
+      // Capture views prior to if constexpr.
+      auto w = w0_;
+      if constexpr (recon_method_ == ReconstructionMethod::dc) {
+        DonorCellX1(member, m, k, j, fl-1, fu, w, wl, wr, nrecon);
+      } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+        PiecewiseLinearX1(member, m, k, j, fl-1, fu, w, wl, wr, nrecon);
+      } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                           recon_method_ == ReconstructionMethod::ppmx) {
+        PiecewiseParabolicX1(member,eos_,extrema,true, m, k, j, fl-1, fu, w, wl, wr,
+                             nrecon);
+      } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+        WENOZX1(member, eos_, true, m, k, j, fl-1, fu, w, wl, wr, nrecon);
+      }
+      // Sync all threads in the team so that scratch memory is consistent
+      member.team_barrier();
+
+      // compute fluxes over [fl,fu]
+      // NOTE(@pdmullen): Capture variables prior to if constexpr.
+      auto eos = eos_;
+      auto indcs = indcs_;
+      auto size = size_;
+      auto coord = coord_;
+      auto flx1 = flx1_;
+      if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
+        Advect(member, eos, indcs, size, coord, m, k, j, fl, fu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
+        LLF(member, eos, indcs, size, coord, m, k, j, fl, fu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
+        HLLE(member, eos, indcs, size, coord, m, k, j, fl, fu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
+        HLLC(member, eos, indcs, size, coord, m, k, j, fl, fu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
+        Roe(member, eos, indcs, size, coord, m, k, j, fl, fu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
+        LLF_SR(member, eos, indcs, size, coord, m, k, j, fl, fu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
+        HLLE_SR(member, eos, indcs, size, coord, m, k, j, fl, fu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
+        HLLC_SR(member, eos, indcs, size, coord, m, k, j, fl, fu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
+        LLF_GR(member, eos, indcs, size, coord, m, k, j, fl, fu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
+        HLLE_GR(member, eos, indcs, size, coord, m, k, j, fl, fu, IVX, wl, wr, flx1);
+      }
+      member.team_barrier();
+      if (save_speeds) {
+        MaxSignalSpeed<advect>(member, eos, m, 0, IVX, fl, fu, wl, wr, max_speed_);
+      }
+
+      // calculate fluxes of scalars (if any)
+      if (nrecon > nhyd_) {
+        for (int n=nhyd_; n<nrecon; ++n) {
+          par_for_inner(member, sl, su, [&](const int i) {
+            if (flx1_(m,IDN,k,j,i) >= 0.0) {
+              flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wl(n,i);
+            } else {
+              flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wr(n,i);
+            }
+          });
+        }
       }
     }
   });
@@ -148,7 +242,7 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
   // j-direction
 
   if (pmy_pack->pmesh->multi_d) {
-    scr_size = ScrArray2D<Real>::shmem_size(nvars, ncells1) * 3;
+    scr_size = ScrArray2D<Real>::shmem_size(nrecon, ncells1) * 3;
     auto &flx2_ = uflx.x2f;
 
     // set the loop limits for 1D/2D/3D problems
@@ -162,87 +256,99 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
       }
     }
 
+    // planes in transverse ghost zones contain only boundary faces
+    FaceRanges rng2  = FluxFaceRanges(region, nb, false, jl+1,ju,js,je,il,iu,is,ie);
+    FaceRanges rng2g = FluxFaceRanges(region, nb, true,  jl+1,ju,js,je,il,iu,is,ie);
+
+    roofline::AddWork("hflux_x2", ncells, face_bytes, face_flops);
     par_for_outer("hflux_x2",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku,
     KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
-      ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
-      ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
-      ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
-
-      for (int j=jl; j<=ju; ++j) {
-        // Permute scratch arrays.
-        auto wl     = scr1;
-        auto wl_jp1 = scr2;
-        auto wr     = scr3;
-        if ((j%2) == 0) {
-          wl     = scr2;
-          wl_jp1 = scr1;
-        }
+      ScrArray2D<Real> scr1(member.team_scratch(scr_level), nrecon, ki.ncells1);
+      ScrArray2D<Real> scr2(member.team_scratch(scr_level), nrecon, ki.ncells1);
+      ScrArray2D<Real> scr3(member.team_scratch(scr_level), nrecon, ki.ncells1);
+
+      const FaceRanges &rng_ = ((k<ki.ks) || (k>ki.ke))? rng2g : rng2;
+
+      for (int r=0; r<rng_.n; ++r) {
+        int fl = rng_.fl[r], fu = rng_.fu[r];
+        int tl = rng_.tl[r], tu = rng_.tu[r];
+        int sl = (tl > ki.is)? tl : ki.is, su = (tu < ki.ie)? tu : ki.ie;
+
+        for (int j=fl-1; j<=fu; ++j) {
+          // Permute scratch arrays.
+          auto wl     = scr1;
+          auto wl_jp1 = scr2;
+          auto wr     = scr3;
+          if ((j%2) == 0) {
+            wl     = scr2;
+            wl_jp1 = scr1;
+          }
 
-        // Reconstruct qR[j] and qL[j+1]
-        switch (recon_method_) {
-          case ReconstructionMethod::dc:
-            DonorCellX2(member, m, k, j, il, iu, w0_, wl_jp1, wr);
-            break;
-          case ReconstructionMethod::plm:
-            PiecewiseLinearX2(member, m, k, j, il, iu, w0_, wl_jp1, wr);
-            break;
-          case ReconstructionMethod::ppm4:
-          case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX2(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_jp1, wr);
-            break;
-          case ReconstructionMethod::wenoz:
-            WENOZX2(member, eos_, true, m, k, j, il, iu, w0_, wl_jp1, wr);
-            break;
-          default:
-            break;
-        }
-        member.team_barrier();
-
-        // compute fluxes over [js,je+1].  RS returns flux in input wr array
-        if (j>jl) {
-          // NOTE(@pdmullen): Capture variables prior to if constexpr.
-          auto eos = eos_;
-          auto indcs = indcs_;
-          auto size = size_;
-          auto coord = coord_;
-          auto flx2 = flx2_;
-          if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
-            Advect(member, eos, indcs, size, coord, m, k, j, il, iu, IVY, wl, wr, flx2);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
-            LLF(member, eos, indcs, size, coord, m, k, j, il, iu, IVY, wl, wr, flx2);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
-            HLLE(member, eos, indcs, size, coord, m, k, j, il, iu, IVY, wl, wr, flx2);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
-            HLLC(member, eos, indcs, size, coord, m, k, j, il, iu, IVY, wl, wr, flx2);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
-            Roe(member, eos, indcs, size, coord, m, k, j, il, iu, IVY, wl, wr, flx2);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
-            LLF_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVY, wl, wr, flx2);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
-            HLLE_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVY, wl, wr, flx2);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
-            HLLC_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVY, wl, wr, flx2);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
-            LLF_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVY, wl, wr, flx2);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
-            HLLE_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVY, wl, wr, flx2);
+          // Reconstruct qR[j] and qL[j+1]
+          // Capture views prior to if constexpr.
+          auto w = w0_;
+          if constexpr (recon_method_ == ReconstructionMethod::dc) {
+            DonorCellX2(member, m, k, j, tl, tu, w, wl_jp1, wr, nrecon);
+          } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+            PiecewiseLinearX2(member, m, k, j, tl, tu, w, wl_jp1, wr, nrecon);
+          } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                               recon_method_ == ReconstructionMethod::ppmx) {
+            PiecewiseParabolicX2(member,eos_,extrema,true,m,k,j,tl,tu, w, wl_jp1, wr,
+                                 nrecon);
+          } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+            WENOZX2(member, eos_, true, m, k, j, tl, tu, w, wl_jp1, wr, nrecon);
           }
           member.team_barrier();
-        }
 
-        // calculate fluxes of scalars (if any)
-        if (nvars > nhyd_) {
-          for (int n=nhyd_; n<nvars; ++n) {
-            par_for_inner(member, is, ie, [&](const int i) {
-              if (flx2_(m,IDN,k,j,i) >= 0.0) {
-                flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wl(n,i);
-              } else {
-                flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wr(n,i);
-              }
-            });
+          // compute fluxes over [fl,fu].  RS returns flux in input wr array
+          if (j>=fl) {
+            // NOTE(@pdmullen): Capture variables prior to if constexpr.
+            auto eos = eos_;
+            auto indcs = indcs_;
+            auto size = size_;
+            auto coord = coord_;
+            auto flx2 = flx2_;
+            if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
+              Advect(member,eos,indcs,size,coord,m,k,j,tl,tu,IVY,wl,wr,flx2);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
+              LLF(member,eos,indcs,size,coord,m,k,j,tl,tu,IVY,wl,wr,flx2);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
+              HLLE(member,eos,indcs,size,coord,m,k,j,tl,tu,IVY,wl,wr,flx2);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
+              HLLC(member,eos,indcs,size,coord,m,k,j,tl,tu,IVY,wl,wr,flx2);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
+              Roe(member,eos,indcs,size,coord,m,k,j,tl,tu,IVY,wl,wr,flx2);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
+              LLF_SR(member,eos,indcs,size,coord,m,k,j,tl,tu,IVY,wl,wr,flx2);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
+              HLLE_SR(member,eos,indcs,size,coord,m,k,j,tl,tu,IVY,wl,wr,flx2);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
+              HLLC_SR(member,eos,indcs,size,coord,m,k,j,tl,tu,IVY,wl,wr,flx2);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
+              LLF_GR(member,eos,indcs,size,coord,m,k,j,tl,tu,IVY,wl,wr,flx2);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
+              HLLE_GR(member,eos,indcs,size,coord,m,k,j,tl,tu,IVY,wl,wr,flx2);
+            }
+            member.team_barrier();
+            if (save_speeds) {
+              MaxSignalSpeed<advect>(member,eos,m,1,IVY,tl,tu,wl,wr,max_speed_);
+            }
           }
-        }
-      } // end of loop over j
+
+          // calculate fluxes of scalars (if any)
+          if ((nrecon > nhyd_) && (j>=fl)) {
+            for (int n=nhyd_; n<nrecon; ++n) {
+              par_for_inner(member, sl, su, [&](const int i) {
+                if (flx2_(m,IDN,k,j,i) >= 0.0) {
+                  flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wl(n,i);
+                } else {
+                  flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wr(n,i);
+                }
+              });
+            }
+          }
+        } // end of loop over j
+      }
     });
   }
 
@@ -250,110 +356,170 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
   // k-direction. Note order of k,j loops switched
 
   if (pmy_pack->pmesh->three_d) {
-    scr_size = ScrArray2D<Real>::shmem_size(nvars, ncells1) * 3;
+    scr_size = ScrArray2D<Real>::shmem_size(nrecon, ncells1) * 3;
     auto &flx3_ = uflx.x3f;
 
     // set the loop limits
     il = is, iu = ie, jl = js, ju = je, kl = ks-1, ku = ke+1;
     if (use_fofc) { il = is-1, iu = ie+1, jl = js-1, ju = je+1, kl = ks-2, ku = ke+2; }
 
+    // planes in transverse ghost zones contain only boundary faces
+    FaceRanges rng3  = FluxFaceRanges(region, nb, false, kl+1,ku,ks,ke,il,iu,is,ie);
+    FaceRanges rng3g = FluxFaceRanges(region, nb, true,  kl+1,ku,ks,ke,il,iu,is,ie);
+
+    roofline::AddWork("hflux_x3", ncells, face_bytes, face_flops);
     par_for_outer("hflux_x3",DevExeSpace(), scr_size, scr_level, 0, nmb1, jl, ju,
     KOKKOS_LAMBDA(TeamMember_t member, const int m, const int j) {
-      ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
-      ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
-      ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
-
-      for (int k=kl; k<=ku; ++k) {
-        // Permute scratch arrays.
-        auto wl     = scr1;
-        auto wl_kp1 = scr2;
-        auto wr     = scr3;
-        if ((k%2) == 0) {
-          wl     = scr2;
-          wl_kp1 = scr1;
-        }
+      ScrArray2D<Real> scr1(member.team_scratch(scr_level), nrecon, ki.ncells1);
+      ScrArray2D<Real> scr2(member.team_scratch(scr_level), nrecon, ki.ncells1);
+      ScrArray2D<Real> scr3(member.team_scratch(scr_level), nrecon, ki.ncells1);
+
+      const FaceRanges &rng_ = ((j<ki.js) || (j>ki.je))? rng3g : rng3;
+
+      for (int r=0; r<rng_.n; ++r) {
+        int fl = rng_.fl[r], fu = rng_.fu[r];
+        int tl = rng_.tl[r], tu = rng_.tu[r];
+        int sl = (tl > ki.is)? tl : ki.is, su = (tu < ki.ie)? tu : ki.ie;
+
+        for (int k=fl-1; k<=fu; ++k) {
+          // Permute scratch arrays.
+          auto wl     = scr1;
+          auto wl_kp1 = scr2;
+          auto wr     = scr3;
+          if ((k%2) == 0) {
+            wl     = scr2;
+            wl_kp1 = scr1;
+          }
 
-        // Reconstruct qR[k] and qL[k+1]
-        switch (recon_method_) {
-          case ReconstructionMethod::dc:
-            DonorCellX3(member, m, k, j, il, iu, w0_, wl_kp1, wr);
-            break;
-          case ReconstructionMethod::plm:
-            PiecewiseLinearX3(member, m, k, j, il, iu, w0_, wl_kp1, wr);
-            break;
-          case ReconstructionMethod::ppm4:
-          case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX3(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_kp1, wr);
-            break;
-          case ReconstructionMethod::wenoz:
-            WENOZX3(member, eos_, true, m, k, j, il, iu, w0_, wl_kp1, wr);
-            break;
-          default:
-            break;
-        }
-        member.team_barrier();
-
-        // compute fluxes over [ks,ke+1].  RS returns flux in input wr array
-        if (k>kl) {
-          // NOTE(@pdmullen): Capture variables prior to if constexpr.
-          auto eos = eos_;
-          auto indcs = indcs_;
-          auto size = size_;
-          auto coord = coord_;
-          auto flx3 = flx3_;
-          if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
-            Advect(member, eos, indcs, size, coord, m, k, j, il, iu, IVZ, wl, wr, flx3);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
-            LLF(member, eos, indcs, size, coord, m, k, j, il, iu, IVZ, wl, wr, flx3);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
-            HLLE(member, eos, indcs, size, coord, m, k, j, il, iu, IVZ, wl, wr, flx3);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
-            HLLC(member, eos, indcs, size, coord, m, k, j, il, iu, IVZ, wl, wr, flx3);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
-            Roe(member, eos, indcs, size, coord, m, k, j, il, iu, IVZ, wl, wr, flx3);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
-            LLF_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVZ, wl, wr, flx3);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
-            HLLE_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVZ, wl, wr, flx3);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
-            HLLC_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVZ, wl, wr, flx3);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
-            LLF_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVZ, wl, wr, flx3);
-          } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
-            HLLE_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVZ, wl, wr, flx3);
+          // Reconstruct qR[k] and qL[k+1]
+          // Capture views prior to if constexpr.
+          auto w = w0_;
+          if constexpr (recon_method_ == ReconstructionMethod::dc) {
+            DonorCellX3(member, m, k, j, tl, tu, w, wl_kp1, wr, nrecon);
+          } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+            PiecewiseLinearX3(member, m, k, j, tl, tu, w, wl_kp1, wr, nrecon);
+          } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                               recon_method_ == ReconstructionMethod::ppmx) {
+            PiecewiseParabolicX3(member,eos_,extrema,true,m,k,j,tl,tu, w, wl_kp1, wr,
+                                 nrecon);
+          } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+            WENOZX3(member, eos_, true, m, k, j, tl, tu, w, wl_kp1, wr, nrecon);
           }
           member.team_barrier();
-        }
 
-        // calculate fluxes of scalars (if any)
-        if (nvars > nhyd_) {
-          for (int n=nhyd_; n<nvars; ++n) {
-            par_for_inner(member, is, ie, [&](const int i) {
-              if (flx3_(m,IDN,k,j,i) >= 0.0) {
-                flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wl(n,i);
-              } else {
-                flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wr(n,i);
-              }
-            });
+          // compute fluxes over [fl,fu].  RS returns flux in input wr array
+          if (k>=fl) {
+            // NOTE(@pdmullen): Capture variables prior to if constexpr.
+            auto eos = eos_;
+            auto indcs = indcs_;
+            auto size = size_;
+            auto coord = coord_;
+            auto flx3 = flx3_;
+            if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
+              Advect(member,eos,indcs,size,coord,m,k,j,tl,tu,IVZ,wl,wr,flx3);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
+              LLF(member,eos,indcs,size,coord,m,k,j,tl,tu,IVZ,wl,wr,flx3);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
+              HLLE(member,eos,indcs,size,coord,m,k,j,tl,tu,IVZ,wl,wr,flx3);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
+              HLLC(member,eos,indcs,size,coord,m,k,j,tl,tu,IVZ,wl,wr,flx3);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
+              Roe(member,eos,indcs,size,coord,m,k,j,tl,tu,IVZ,wl,wr,flx3);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
+              LLF_SR(member,eos,indcs,size,coord,m,k,j,tl,tu,IVZ,wl,wr,flx3);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
+              HLLE_SR(member,eos,indcs,size,coord,m,k,j,tl,tu,IVZ,wl,wr,flx3);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
+              HLLC_SR(member,eos,indcs,size,coord,m,k,j,tl,tu,IVZ,wl,wr,flx3);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
+              LLF_GR(member,eos,indcs,size,coord,m,k,j,tl,tu,IVZ,wl,wr,flx3);
+            } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
+              HLLE_GR(member,eos,indcs,size,coord,m,k,j,tl,tu,IVZ,wl,wr,flx3);
+            }
+            member.team_barrier();
+            if (save_speeds) {
+              MaxSignalSpeed<advect>(member,eos,m,2,IVZ,tl,tu,wl,wr,max_speed_);
+            }
           }
-        }
-      } // end loop over k
+
+          // calculate fluxes of scalars (if any)
+          if ((nrecon > nhyd_) && (k>=fl)) {
+            for (int n=nhyd_; n<nrecon; ++n) {
+              par_for_inner(member, sl, su, [&](const int i) {
+                if (flx3_(m,IDN,k,j,i) >= 0.0) {
+                  flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wl(n,i);
+                } else {
+                  flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wr(n,i);
+                }
+              });
+            }
+          }
+        } // end loop over k
+      }
     });
   }
 
+  // fluxes of scalars from the mass flux, over all faces once ghost zones are received
+  if (use_scalar_fluxes && region != FluxRegion::interior) {
+    if (scalar_plm) {
+      ScalarFluxes<true>(pmy_pack, nhydro, nscalars, use_fofc, w0, uflx);
+    } else {
+      ScalarFluxes<false>(pmy_pack, nhydro, nscalars, use_fofc, w0, uflx);
+    }
+  }
   return;
 }
 
-// function definitions for each template parameter
-template void Hydro::CalculateFluxes<Hydro_RSolver::advect>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::llf>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hlle>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hllc>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::roe>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::llf_sr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hlle_sr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hllc_sr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::llf_gr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hlle_gr>(Driver *pdriver, int stage);
+//----------------------------------------------------------------------------------------
+//! \fn FluxFunction FluxFunctionForRecon
+//! \brief Returns the instantiation of CalculateFluxes() for Riemann solver T and the
+//! input reconstruction method.  Taking the address also instantiates the template.
+
+template <Hydro_RSolver T>
+Hydro::FluxFunction FluxFunctionForRecon(ReconstructionMethod recon) {
+  if (recon == ReconstructionMethod::dc) {
+    return &Hydro::CalculateFluxes<T, ReconstructionMethod::dc>;
+  } else if (recon == ReconstructionMethod::plm) {
+    return &Hydro::CalculateFluxes<T, ReconstructionMethod::plm>;
+  } else if (recon == ReconstructionMethod::ppm4) {
+    return &Hydro::CalculateFluxes<T, ReconstructionMethod::ppm4>;
+  } else if (recon == ReconstructionMethod::ppmx) {
+    return &Hydro::CalculateFluxes<T, ReconstructionMethod::ppmx>;
+  } else if (recon == ReconstructionMethod::wenoz) {
+    return &Hydro::CalculateFluxes<T, ReconstructionMethod::wenoz>;
+  }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::SelectFluxFunction
+//! \brief Selects specialisation of CalculateFluxes() for the (Riemann solver,
+//! reconstruction method) pair of this run.  Called once in the constructor, so that no
+//! branches on either remain when fluxes are computed.
+
+void Hydro::SelectFluxFunction() {
+  if (rsolver_method == Hydro_RSolver::advect) {
+    calc_fluxes_ = FluxFunctionForRecon<Hydro_RSolver::advect>(recon_method);
+  } else if (rsolver_method == Hydro_RSolver::llf) {
+    calc_fluxes_ = FluxFunctionForRecon<Hydro_RSolver::llf>(recon_method);
+  } else if (rsolver_method == Hydro_RSolver::hlle) {
+    calc_fluxes_ = FluxFunctionForRecon<Hydro_RSolver::hlle>(recon_method);
+  } else if (rsolver_method == Hydro_RSolver::hllc) {
+    calc_fluxes_ = FluxFunctionForRecon<Hydro_RSolver::hllc>(recon_method);
+  } else if (rsolver_method == Hydro_RSolver::roe) {
+    calc_fluxes_ = FluxFunctionForRecon<Hydro_RSolver::roe>(recon_method);
+  } else if (rsolver_method == Hydro_RSolver::llf_sr) {
+    calc_fluxes_ = FluxFunctionForRecon<Hydro_RSolver::llf_sr>(recon_method);
+  } else if (rsolver_method == Hydro_RSolver::hlle_sr) {
+    calc_fluxes_ = FluxFunctionForRecon<Hydro_RSolver::hlle_sr>(recon_method);
+  } else if (rsolver_method == Hydro_RSolver::hllc_sr) {
+    calc_fluxes_ = FluxFunctionForRecon<Hydro_RSolver::hllc_sr>(recon_method);
+  } else if (rsolver_method == Hydro_RSolver::llf_gr) {
+    calc_fluxes_ = FluxFunctionForRecon<Hydro_RSolver::llf_gr>(recon_method);
+  } else if (rsolver_method == Hydro_RSolver::hlle_gr) {
+    calc_fluxes_ = FluxFunctionForRecon<Hydro_RSolver::hlle_gr>(recon_method);
+  }
+  return;
+}
 
 } // namespace hydro
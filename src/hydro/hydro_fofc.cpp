@@ -26,6 +26,8 @@ namespace hydro {
 //! Often this is enough to prevent floors from being needed. The FOFC infrastructure is
 //! also exploited for BH excision. If a cell is about the horizon, FOFC is automatically
 //! triggered (without estimating updated conserved variables).
+//! Flagged cells are first compacted into a work list, so the cost of recomputing
+//! fluxes scales with the number of flagged cells rather than the size of the MeshBlocks.
 
 void Hydro::FOFC(Driver *pdriver, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
@@ -97,10 +99,47 @@ void Hydro::FOFC(Driver *pdriver, int stage) {
   if (multi_d) { jl = js-1, ju = je+1; }
   if (three_d) { kl = ks-1, ku = ke+1; }
 
+  // Compact cells that need FOFC and/or excision into a work list, so that first-order
+  // fluxes are only recomputed for the (usually very few) flagged cells
+  const int ni = iu - il + 1;
+  const int nji = (ju - jl + 1)*ni;
+  const int nkji = (ku - kl + 1)*nji;
+  const int nmkji = nmb*nkji;
+  if (fofc_list.extent_int(0) < nmkji) {
+    Kokkos::realloc(fofc_list, nmkji);
+  }
+  Kokkos::deep_copy(fofc_nlist.d_view, 0);
+  auto &list_ = fofc_list;
+  auto &nlist_ = fofc_nlist;
+  par_for("FOFC-list", DevExeSpace(), 0, nmb-1, kl, ku, jl, ju, il, iu,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    bool flag = false;
+    if (use_fofc_) { flag = fofc_(m,k,j,i); }
+    if (is_gr) {
+      if (use_excise) { flag = flag || excision_flux_(m,k,j,i); }
+    }
+    if (flag) {
+      int idx = m*nkji + (k-kl)*nji + (j-jl)*ni + (i-il);
+      list_(Kokkos::atomic_fetch_add(&nlist_.d_view(0), 1)) = idx;
+    }
+  });
+  nlist_.template modify<DevExeSpace>();
+  nlist_.template sync<HostMemSpace>();
+  const int nlist = nlist_.h_view(0);
+  if (nlist == 0) {return;}
+
   // Now replace fluxes with first-order LLF fluxes for any cell where floors needed (if
   // using FOFC) and/or for any cell about the excision (if GR+excising)
-  par_for("FOFC-flx", DevExeSpace(), 0, nmb-1, kl, ku, jl, ju, il, iu,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+  par_for("FOFC-flx", DevExeSpace(), 0, nlist-1,
+  KOKKOS_LAMBDA(const int lidx) {
+    const int idx = list_(lidx);
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/ni;
+    int i = (idx - m*nkji - k*nji - j*ni) + il;
+    j += jl;
+    k += kl;
+
     // Check for FOFC flag
     bool fofc_flag = false;
     if (use_fofc_) { fofc_flag = fofc_(m,k,j,i); }
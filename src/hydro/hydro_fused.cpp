@@ -0,0 +1,280 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hydro_fused.cpp
+//! \brief Fused stage update for Hydro: reconstruction, Riemann solver, flux divergence
+//! and explicit RK update performed in a single kernel.  Face fluxes are kept in team
+//! scratch memory and are never written to (or read back from) global memory, which
+//! roughly halves the memory traffic per stage compared to CalculateFluxes()+RKUpdate().
+//! The price is that each x2- and x3-face flux is computed twice (once by each of the
+//! two cells sharing the face), so the fused update is most useful on GPUs with large
+//! MeshBlocks where the separate kernels are memory-bandwidth bound.
+//!
+//! Since fluxes are not stored, the fused update cannot be used with FOFC, flux
+//! correction at fine/coarse boundaries (SMR/AMR), viscosity or conduction.  These
+//! restrictions are enforced in the Hydro constructor.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/coordinates.hpp"
+#include "driver/driver.hpp"
+#include "hydro.hpp"
+#include "eos/eos.hpp"
+#include "reconstruct/dc.hpp"
+#include "reconstruct/plm.hpp"
+#include "reconstruct/ppm.hpp"
+#include "reconstruct/wenoz.hpp"
+#include "hydro/rsolvers/advect_hyd.hpp"
+#include "hydro/rsolvers/llf_hyd.hpp"
+#include "hydro/rsolvers/hlle_hyd.hpp"
+#include "hydro/rsolvers/hllc_hyd.hpp"
+#include "hydro/rsolvers/roe_hyd.hpp"
+#include "hydro/rsolvers/llf_srhyd.hpp"
+#include "hydro/rsolvers/hlle_srhyd.hpp"
+#include "hydro/rsolvers/hllc_srhyd.hpp"
+#include "hydro/rsolvers/llf_grhyd.hpp"
+#include "hydro/rsolvers/hlle_grhyd.hpp"
+
+namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \struct ScrFlux
+//! \brief Wraps a 2D scratch array (n,i) so that it can be passed to the Riemann solvers
+//! in place of the 5D flux array (m,n,k,j,i).  Indices m,k,j are ignored.
+
+struct ScrFlux {
+  ScrArray2D<Real> f;
+  KOKKOS_INLINE_FUNCTION
+  Real &operator()(const int m, const int n, const int k, const int j,
+                   const int i) const {
+    return f(n,i);
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void Reconstruct
+//! \brief Calls reconstruction function in direction dir=1,2,3 for one row of cells.
+
+KOKKOS_INLINE_FUNCTION
+void Reconstruct(TeamMember_t const &member, const ReconstructionMethod recon_method,
+     const EOS_Data &eos, const bool extrema, const int dir, const int m, const int k,
+     const int j, const int il, const int iu, const DvceArray5D<Real> &w0,
+     ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
+  switch (recon_method) {
+    case ReconstructionMethod::dc:
+      if (dir == 1) {DonorCellX1(member, m, k, j, il, iu, w0, ql, qr);}
+      if (dir == 2) {DonorCellX2(member, m, k, j, il, iu, w0, ql, qr);}
+      if (dir == 3) {DonorCellX3(member, m, k, j, il, iu, w0, ql, qr);}
+      break;
+    case ReconstructionMethod::plm:
+      if (dir == 1) {PiecewiseLinearX1(member, m, k, j, il, iu, w0, ql, qr);}
+      if (dir == 2) {PiecewiseLinearX2(member, m, k, j, il, iu, w0, ql, qr);}
+      if (dir == 3) {PiecewiseLinearX3(member, m, k, j, il, iu, w0, ql, qr);}
+      break;
+    case ReconstructionMethod::ppm4:
+    case ReconstructionMethod::ppmx:
+      if (dir == 1) {
+        PiecewiseParabolicX1(member, eos, extrema, true, m, k, j, il, iu, w0, ql, qr);
+      }
+      if (dir == 2) {
+        PiecewiseParabolicX2(member, eos, extrema, true, m, k, j, il, iu, w0, ql, qr);
+      }
+      if (dir == 3) {
+        PiecewiseParabolicX3(member, eos, extrema, true, m, k, j, il, iu, w0, ql, qr);
+      }
+      break;
+    case ReconstructionMethod::wenoz:
+      if (dir == 1) {WENOZX1(member, eos, true, m, k, j, il, iu, w0, ql, qr);}
+      if (dir == 2) {WENOZX2(member, eos, true, m, k, j, il, iu, w0, ql, qr);}
+      if (dir == 3) {WENOZX3(member, eos, true, m, k, j, il, iu, w0, ql, qr);}
+      break;
+    default:
+      break;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RiemannSolve
+//! \brief Calls Riemann solver selected by template parameter, then computes upwinded
+//! fluxes of passive scalars (if any).  Fluxes over [il,iu] are returned in flx(n,i).
+
+template <Hydro_RSolver rsolver_method_>
+KOKKOS_INLINE_FUNCTION
+void RiemannSolve(TeamMember_t const &member, const EOS_Data &eos,
+     const RegionIndcs &indcs,const DualArray1D<RegionSize> &size,const CoordData &coord,
+     const int m, const int k, const int j, const int il, const int iu, const int ivx,
+     const int nhyd, const int nvars, const ScrArray2D<Real> &wl,
+     const ScrArray2D<Real> &wr, const ScrArray2D<Real> &flx) {
+  ScrFlux f{flx};
+  if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
+    Advect(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, f);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
+    LLF(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, f);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
+    HLLE(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, f);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
+    HLLC(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, f);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
+    Roe(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, f);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
+    LLF_SR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, f);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
+    HLLE_SR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, f);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
+    HLLC_SR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, f);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
+    LLF_GR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, f);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
+    HLLE_GR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, f);
+  }
+  member.team_barrier();
+
+  // calculate fluxes of scalars (if any)
+  for (int n=nhyd; n<nvars; ++n) {
+    par_for_inner(member, il, iu, [&](const int i) {
+      if (flx(IDN,i) >= 0.0) {
+        flx(n,i) = flx(IDN,i)*wl(n,i);
+      } else {
+        flx(n,i) = flx(IDN,i)*wr(n,i);
+      }
+    });
+  }
+  member.team_barrier();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::FusedUpdate
+//! \brief Explicit RK update of u0 with flux divergence computed in the same kernel as
+//! the fluxes.  Each team updates one (m,k,j) row of cells.  Results are identical to
+//! CalculateFluxes() followed by RKUpdate(), since the same fluxes are differenced in
+//! the same order.  Templated over RS like CalculateFluxes().
+
+template <Hydro_RSolver rsolver_method_>
+void Hydro::FusedUpdate(Driver *pdriver, int stage) {
+  RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
+  int is = indcs_.is, ie = indcs_.ie;
+  int js = indcs_.js, je = indcs_.je;
+  int ks = indcs_.ks, ke = indcs_.ke;
+  int ncells1 = indcs_.nx1 + 2*(indcs_.ng);
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  int nhyd_  = nhydro;
+  int nvars = nhydro + nscalars;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  const auto recon_ = recon_method;
+  bool extrema = false;
+  if (recon_method == ReconstructionMethod::ppmx) {
+    extrema = true;
+  }
+
+  auto &eos_ = peos->eos_data;
+  auto &size_ = pmy_pack->pmb->mb_size;
+  pmy_pack->pcoord->UpdateMetricCache();
+  auto &coord_ = pmy_pack->pcoord->coord_data;
+  auto &w0_ = w0;
+  auto u0_ = u0;
+  auto u1_ = u1;
+
+  // scratch for three rows of reconstructed states, two rows of fluxes, and divergence.
+  // With many passive scalars or long rows this can exceed the level 0 (shared memory)
+  // limit of the device, in which case slower level 1 scratch is used.
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvars, ncells1) * 6;
+  int scr_level = 0;
+  if (scr_size > static_cast<size_t>(Kokkos::TeamPolicy<>::scratch_size_max(0))) {
+    scr_level = 1;
+  }
+
+  par_for_outer("h_fused",DevExeSpace(), scr_size, scr_level, 0, nmb1, ks, ke,
+                js, je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> q1(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> q2(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> q3(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> flo(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> fhi(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> divf(member.team_scratch(scr_level), nvars, ncells1);
+    Real dx1 = size_.d_view(m).dx1;
+    Real dx2 = size_.d_view(m).dx2;
+    Real dx3 = size_.d_view(m).dx3;
+
+    // compute fluxes over [is,ie+1] and dF1/dx1
+    Reconstruct(member, recon_, eos_, extrema, 1, m, k, j, is-1, ie+1, w0_, q1, q2);
+    member.team_barrier();
+    RiemannSolve<rsolver_method_>(member, eos_, indcs_, size_, coord_, m, k, j, is, ie+1,
+                                  IVX, nhyd_, nvars, q1, q2, flo);
+    for (int n=0; n<nvars; ++n) {
+      par_for_inner(member, is, ie, [&](const int i) {
+        divf(n,i) = (flo(n,i+1) - flo(n,i))/dx1;
+      });
+    }
+    member.team_barrier();
+
+    // Add dF2/dx2, with fluxes on faces j and j+1.  Sequence of reconstructions over
+    // cells j-1, j, j+1 re-uses scratch so that only three rows of states are stored.
+    if (multi_d) {
+      Reconstruct(member, recon_, eos_, extrema, 2, m, k, j-1, is, ie, w0_, q1, q3);
+      member.team_barrier();
+      Reconstruct(member, recon_, eos_, extrema, 2, m, k, j, is, ie, w0_, q2, q3);
+      member.team_barrier();
+      RiemannSolve<rsolver_method_>(member, eos_, indcs_, size_, coord_, m, k, j, is, ie,
+                                    IVY, nhyd_, nvars, q1, q3, flo);
+      Reconstruct(member, recon_, eos_, extrema, 2, m, k, j+1, is, ie, w0_, q1, q3);
+      member.team_barrier();
+      RiemannSolve<rsolver_method_>(member, eos_, indcs_, size_, coord_, m, k, j+1, is,
+                                    ie, IVY, nhyd_, nvars, q2, q3, fhi);
+      // Fluxes must be summed in pairs to symmetrize round-off error in each dir
+      for (int n=0; n<nvars; ++n) {
+        par_for_inner(member, is, ie, [&](const int i) {
+          divf(n,i) += (fhi(n,i) - flo(n,i))/dx2;
+        });
+      }
+      member.team_barrier();
+    }
+
+    // Add dF3/dx3, with fluxes on faces k and k+1
+    if (three_d) {
+      Reconstruct(member, recon_, eos_, extrema, 3, m, k-1, j, is, ie, w0_, q1, q3);
+      member.team_barrier();
+      Reconstruct(member, recon_, eos_, extrema, 3, m, k, j, is, ie, w0_, q2, q3);
+      member.team_barrier();
+      RiemannSolve<rsolver_method_>(member, eos_, indcs_, size_, coord_, m, k, j, is, ie,
+                                    IVZ, nhyd_, nvars, q1, q3, flo);
+      Reconstruct(member, recon_, eos_, extrema, 3, m, k+1, j, is, ie, w0_, q1, q3);
+      member.team_barrier();
+      RiemannSolve<rsolver_method_>(member, eos_, indcs_, size_, coord_, m, k+1, j, is,
+                                    ie, IVZ, nhyd_, nvars, q2, q3, fhi);
+      for (int n=0; n<nvars; ++n) {
+        par_for_inner(member, is, ie, [&](const int i) {
+          divf(n,i) += (fhi(n,i) - flo(n,i))/dx3;
+        });
+      }
+      member.team_barrier();
+    }
+
+    for (int n=0; n<nvars; ++n) {
+      par_for_inner(member, is, ie, [&](const int i) {
+        u0_(m,n,k,j,i) = gam0*u0_(m,n,k,j,i) + gam1*u1_(m,n,k,j,i) - beta_dt*divf(n,i);
+      });
+    }
+  });
+  return;
+}
+
+// function definitions for each template parameter
+template void Hydro::FusedUpdate<Hydro_RSolver::advect>(Driver *pdriver, int stage);
+template void Hydro::FusedUpdate<Hydro_RSolver::llf>(Driver *pdriver, int stage);
+template void Hydro::FusedUpdate<Hydro_RSolver::hlle>(Driver *pdriver, int stage);
+template void Hydro::FusedUpdate<Hydro_RSolver::hllc>(Driver *pdriver, int stage);
+template void Hydro::FusedUpdate<Hydro_RSolver::roe>(Driver *pdriver, int stage);
+template void Hydro::FusedUpdate<Hydro_RSolver::llf_sr>(Driver *pdriver, int stage);
+template void Hydro::FusedUpdate<Hydro_RSolver::hlle_sr>(Driver *pdriver, int stage);
+template void Hydro::FusedUpdate<Hydro_RSolver::hllc_sr>(Driver *pdriver, int stage);
+template void Hydro::FusedUpdate<Hydro_RSolver::llf_gr>(Driver *pdriver, int stage);
+template void Hydro::FusedUpdate<Hydro_RSolver::hlle_gr>(Driver *pdriver, int stage);
+
+} // namespace hydro
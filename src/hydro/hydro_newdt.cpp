@@ -51,7 +51,24 @@ TaskStatus Hydro::NewTimeStep(Driver *pdrive, int stage) {
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
 
-  if (pdrive->time_evolution == TimeEvolution::kinematic) {
+  if (use_c2p_dt && dt_c2p_ready_) {
+    // use timestep reduced by the c2p kernel in the last stage
+    dt1 = dt_c2p_[0];
+    dt2 = dt_c2p_[1];
+    dt3 = dt_c2p_[2];
+    dt_c2p_ready_ = false;
+  } else if (use_cached_dt && speeds_cached_) {
+    // use max signal speeds saved by the flux kernels in the last stage
+    auto &max_speed_ = max_speed;
+    Kokkos::parallel_reduce("HydroNudt0",
+    Kokkos::RangePolicy<>(DevExeSpace(), 0, (pmy_pack->nmb_thispack)),
+    KOKKOS_LAMBDA(const int &m, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
+      min_dt1 = fmin((mbsize.d_view(m).dx1/max_speed_(m,0)), min_dt1);
+      min_dt2 = fmin((mbsize.d_view(m).dx2/max_speed_(m,1)), min_dt2);
+      min_dt3 = fmin((mbsize.d_view(m).dx3/max_speed_(m,2)), min_dt3);
+    }, Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2),Kokkos::Min<Real>(dt3));
+    speeds_cached_ = false;
+  } else if (pdrive->time_evolution == TimeEvolution::kinematic) {
     // find smallest (dx/v) in each direction for advection problems
     Kokkos::parallel_reduce("HydroNudt1",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
     KOKKOS_LAMBDA(const int &idx, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
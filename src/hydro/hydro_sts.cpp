@@ -0,0 +1,157 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hydro_sts.cpp
+//! \brief Operator-split super-time-stepping (STS) of viscosity and thermal conduction in
+//! Hydro, using the RKL1/RKL2 integrators implemented in Driver::ExecuteSTS().  Each STS
+//! stage computes only diffusive fluxes, updates U with the weights of the stage, and
+//! communicates boundary values, so that many stages can be taken per timestep.
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "eos/eos.hpp"
+#include "diffusion/viscosity.hpp"
+#include "diffusion/conduction.hpp"
+#include "hydro/hydro.hpp"
+
+namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \fn  void Hydro::AssembleSTSTasks
+//! \brief Adds hydro tasks to the "before_sts", "sts" and "after_sts" task lists executed
+//! for each STS stage.  Called by MeshBlockPack::AddPhysics() when use_sts=true.
+
+void Hydro::AssembleSTSTasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
+  TaskID none(0);
+
+  // assemble "before_sts" task list
+  tl["before_sts"]->AddTask(&Hydro::InitRecv, this, none, "Hydro_InitRecv");
+
+  // assemble "sts" task list
+  auto flux  = tl["sts"]->AddTask(&Hydro::STSFluxes, this, none, "Hydro_STSFluxes");
+  auto sendf = tl["sts"]->AddTask(&Hydro::SendFlux, this, flux, "Hydro_SendFlux");
+  auto recvf = tl["sts"]->AddTask(&Hydro::RecvFlux, this, sendf, "Hydro_RecvFlux");
+  auto updt  = tl["sts"]->AddTask(&Hydro::STSUpdate, this, recvf, "Hydro_STSUpdate");
+  auto restu = tl["sts"]->AddTask(&Hydro::RestrictU, this, updt, "Hydro_RestrictU");
+  auto sendu = tl["sts"]->AddTask(&Hydro::SendU, this, restu, "Hydro_SendU");
+  auto recvu = tl["sts"]->AddTask(&Hydro::RecvU, this, sendu, "Hydro_RecvU");
+  auto bcs   = tl["sts"]->AddTask(&Hydro::ApplyPhysicalBCs, this, recvu,
+                                  "Hydro_ApplyPhysicalBCs");
+  auto prol  = tl["sts"]->AddTask(&Hydro::Prolongate, this, bcs, "Hydro_Prolongate");
+  tl["sts"]->AddTask(&Hydro::ConToPrim, this, prol, "Hydro_ConToPrim");
+
+  // assemble "after_sts" task list
+  auto csend = tl["after_sts"]->AddTask(&Hydro::ClearSend, this, none, "Hydro_ClearSend");
+  tl["after_sts"]->AddTask(&Hydro::ClearRecv, this, csend, "Hydro_ClearRecv");
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::STSFluxes
+//! \brief Wrapper task list function that computes only the diffusive (viscous and heat)
+//! fluxes of conserved variables, from the primitives of the previous STS stage
+
+TaskStatus Hydro::STSFluxes(Driver *pdrive, int stage) {
+  Kokkos::deep_copy(DevExeSpace(), uflx.x1f, 0.0);
+  if (pmy_pack->pmesh->multi_d) {Kokkos::deep_copy(DevExeSpace(), uflx.x2f, 0.0);}
+  if (pmy_pack->pmesh->three_d) {Kokkos::deep_copy(DevExeSpace(), uflx.x3f, 0.0);}
+
+  if (pvisc != nullptr) {
+    pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
+  }
+  if (pcond != nullptr) {
+    pcond->AddHeatFlux(w0, peos->eos_data, uflx);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::STSUpdate
+//! \brief Update of conserved variables in each stage of the RKL1/RKL2 integrators (see
+//! Driver::ExecuteSTS()).  On entry u0 holds U^{j-1} and u1 holds U^{j-2}; on exit u0
+//! holds U^{j} and u1 holds U^{j-1}.  Passive scalars do not diffuse and are unchanged.
+
+TaskStatus Hydro::STSUpdate(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  // save U^{0} in first stage
+  if (stage == 1) {
+    Kokkos::deep_copy(DevExeSpace(), u_sts0, Kokkos::subview(u0, Kokkos::ALL,
+                      std::make_pair(0, nhydro), Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
+  }
+
+  Real mu = pdrive->sts_mu;
+  Real nu = pdrive->sts_nu;
+  Real mu_tilde_dt = (pdrive->sts_mu_tilde)*(pdrive->sts_dt);
+  Real gam_tilde = pdrive->sts_gam_tilde;
+  bool rkl2 = (pdrive->sts_integrator == "rkl2");
+  bool first_stage = (stage == 1);
+  Real dt = pdrive->sts_dt;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nvar = nhydro;
+  auto u0_ = u0;
+  auto u1_ = u1;
+  auto us0 = u_sts0;
+  auto dus0 = du_sts0;
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+
+  int scr_level = 0;
+  size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1);
+
+  par_for_outer("h_sts_update",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nvar-1,ks,ke,
+                js,je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k, const int j) {
+    ScrArray1D<Real> divf(member.team_scratch(scr_level), ncells1);
+
+    par_for_inner(member, is, ie, [&](const int i) {
+      divf(i) = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
+    });
+    member.team_barrier();
+
+    // Fluxes must be summed in pairs to symmetrize round-off error in each dir
+    if (multi_d) {
+      par_for_inner(member, is, ie, [&](const int i) {
+        divf(i) += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
+      });
+      member.team_barrier();
+    }
+    if (three_d) {
+      par_for_inner(member, is, ie, [&](const int i) {
+        divf(i) += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
+      });
+      member.team_barrier();
+    }
+
+    par_for_inner(member, is, ie, [&](const int i) {
+      // dt*L(U^{0}) is saved in first stage for use in later stages with RKL2
+      Real dul0 = 0.0;
+      if (rkl2) {
+        if (first_stage) {dus0(m,n,k,j,i) = -dt*divf(i);}
+        dul0 = dus0(m,n,k,j,i);
+      }
+      Real uold = u0_(m,n,k,j,i);
+      u0_(m,n,k,j,i) = mu*uold + nu*u1_(m,n,k,j,i) + (1.0 - mu - nu)*us0(m,n,k,j,i)
+                     - mu_tilde_dt*divf(i) + gam_tilde*dul0;
+      u1_(m,n,k,j,i) = uold;
+    });
+  });
+  return TaskStatus::complete;
+}
+} // namespace hydro
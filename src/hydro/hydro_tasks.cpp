@@ -23,6 +23,7 @@
 #include "srcterms/srcterms.hpp"
 #include "bvals/bvals.hpp"
 #include "shearing_box/shearing_box.hpp"
+#include "gravity/gravity.hpp"
 #include "hydro/hydro.hpp"
 
 namespace hydro {
@@ -48,32 +49,59 @@ void Hydro::AssembleHydroTasks(std::map<std::string, std::shared_ptr<TaskList>>
   TaskID none(0);
 
   // assemble "before_stagen" task list
-  id.irecv = tl["before_stagen"]->AddTask(&Hydro::InitRecv, this, none);
+  id.irecv = tl["before_stagen"]->AddTask(&Hydro::InitRecv, this, none, "Hydro_InitRecv");
 
   // assemble "stagen" task list
-  id.copyu     = tl["stagen"]->AddTask(&Hydro::CopyCons, this, none);
-  id.flux      = tl["stagen"]->AddTask(&Hydro::Fluxes,this,id.copyu);
-  id.sendf     = tl["stagen"]->AddTask(&Hydro::SendFlux, this, id.flux);
-  id.recvf     = tl["stagen"]->AddTask(&Hydro::RecvFlux, this, id.sendf);
-  id.rkupdt    = tl["stagen"]->AddTask(&Hydro::RKUpdate, this, id.recvf);
-  id.srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, this, id.rkupdt);
-  id.sendu_oa  = tl["stagen"]->AddTask(&Hydro::SendU_OA, this, id.srctrms);
-  id.recvu_oa  = tl["stagen"]->AddTask(&Hydro::RecvU_OA, this, id.sendu_oa);
-  id.restu     = tl["stagen"]->AddTask(&Hydro::RestrictU, this, id.recvu_oa);
-  id.sendu     = tl["stagen"]->AddTask(&Hydro::SendU, this, id.restu);
-  id.recvu     = tl["stagen"]->AddTask(&Hydro::RecvU, this, id.sendu);
-  id.sendu_shr = tl["stagen"]->AddTask(&Hydro::SendU_Shr, this, id.recvu);
-  id.recvu_shr = tl["stagen"]->AddTask(&Hydro::RecvU_Shr, this, id.sendu_shr);
-  id.bcs       = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, this, id.recvu_shr);
-  id.prol      = tl["stagen"]->AddTask(&Hydro::Prolongate, this, id.bcs);
-  id.c2p       = tl["stagen"]->AddTask(&Hydro::ConToPrim, this, id.prol);
-  id.newdt     = tl["stagen"]->AddTask(&Hydro::NewTimeStep, this, id.c2p);
+  id.copyu     = tl["stagen"]->AddTask(&Hydro::CopyCons, this, none, "Hydro_CopyCons");
+  id.flux      = tl["stagen"]->AddTask(&Hydro::Fluxes,this,id.copyu, "Hydro_Fluxes");
+  id.sendf     = tl["stagen"]->AddTask(&Hydro::SendFlux, this, id.flux, "Hydro_SendFlux");
+  id.recvf     = tl["stagen"]->AddTask(&Hydro::RecvFlux, this, id.sendf,
+                                       "Hydro_RecvFlux");
+  id.rkupdt    = tl["stagen"]->AddTask(&Hydro::RKUpdate, this, id.recvf,
+                                       "Hydro_RKUpdate");
+  id.srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, this, id.rkupdt,
+                                       "Hydro_HydroSrcTerms");
+  id.sendu_oa  = tl["stagen"]->AddTask(&Hydro::SendU_OA, this, id.srctrms,
+                                       "Hydro_SendU_OA");
+  id.recvu_oa  = tl["stagen"]->AddTask(&Hydro::RecvU_OA, this, id.sendu_oa,
+                                       "Hydro_RecvU_OA");
+  id.restu     = tl["stagen"]->AddTask(&Hydro::RestrictU, this, id.recvu_oa,
+                                       "Hydro_RestrictU");
+  id.sendu     = tl["stagen"]->AddTask(&Hydro::SendU, this, id.restu, "Hydro_SendU");
+  if (use_split_fluxes) {
+    id.iflux   = tl["stagen"]->AddTask(&Hydro::InteriorFluxes, this, id.sendu,
+                                       "Hydro_InteriorFluxes");
+  }
+  id.recvu     = tl["stagen"]->AddTask(&Hydro::RecvU, this, id.sendu, "Hydro_RecvU");
+  id.sendu_shr = tl["stagen"]->AddTask(&Hydro::SendU_Shr, this, id.recvu,
+                                       "Hydro_SendU_Shr");
+  id.recvu_shr = tl["stagen"]->AddTask(&Hydro::RecvU_Shr, this, id.sendu_shr,
+                                       "Hydro_RecvU_Shr");
+  id.bcs       = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, this, id.recvu_shr,
+                                       "Hydro_ApplyPhysicalBCs");
+  id.prol      = tl["stagen"]->AddTask(&Hydro::Prolongate, this, id.bcs,
+                                       "Hydro_Prolongate");
+  if (use_split_fluxes) {
+    TaskID dep = id.prol | id.iflux;
+    id.c2p     = tl["stagen"]->AddTask(&Hydro::ConToPrim, this, dep, "Hydro_ConToPrim");
+  } else {
+    id.c2p     = tl["stagen"]->AddTask(&Hydro::ConToPrim, this, id.prol,
+                                       "Hydro_ConToPrim");
+  }
+  id.newdt     = tl["stagen"]->AddTask(&Hydro::NewTimeStep, this, id.c2p,
+                                       "Hydro_NewTimeStep");
+  if (use_split_fluxes) {
+    id.bflux   = tl["stagen"]->AddTask(&Hydro::BoundaryFluxes, this, id.c2p,
+                                       "Hydro_BoundaryFluxes");
+  }
 
   // assemble "after_stagen" task list
-  id.csend = tl["after_stagen"]->AddTask(&Hydro::ClearSend, this, none);
+  id.csend = tl["after_stagen"]->AddTask(&Hydro::ClearSend, this, none,
+                                         "Hydro_ClearSend");
   // although RecvFlux/U functions check that all recvs complete, add ClearRecv to
   // task list anyways to catch potential bugs in MPI communication logic
-  id.crecv = tl["after_stagen"]->AddTask(&Hydro::ClearRecv, this, id.csend);
+  id.crecv = tl["after_stagen"]->AddTask(&Hydro::ClearRecv, this, id.csend,
+                                         "Hydro_ClearRecv");
 
   return;
 }
@@ -138,7 +166,8 @@ TaskStatus Hydro::CopyCons(Driver *pdrive, int stage) {
       auto &u0 = pmy_pack->phydro->u0;
       auto &u1 = pmy_pack->phydro->u1;
       Real &delta = pdrive->delta[stage-1];
-      par_for("rk4_copy_cons", DevExeSpace(),0, nmb1, 0, nvar-1, ks, ke, js, je, is, ie,
+      par_for("rk4_copy_cons", DevExeSpace(), 0, nmb1, 0, nvar-1, ks, ke, js, je,
+              is, ie,
       KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
         u1(m,n,k,j,i) += delta*u0(m,n,k,j,i);
       });
@@ -153,34 +182,22 @@ TaskStatus Hydro::CopyCons(Driver *pdrive, int stage) {
 //! of conserved variables
 
 TaskStatus Hydro::Fluxes(Driver *pdrive, int stage) {
-  // select which calculate_flux function to call based on rsolver_method
-  if (rsolver_method == Hydro_RSolver::advect) {
-    CalculateFluxes<Hydro_RSolver::advect>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::llf) {
-    CalculateFluxes<Hydro_RSolver::llf>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hlle) {
-    CalculateFluxes<Hydro_RSolver::hlle>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hllc) {
-    CalculateFluxes<Hydro_RSolver::hllc>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::roe) {
-    CalculateFluxes<Hydro_RSolver::roe>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::llf_sr) {
-    CalculateFluxes<Hydro_RSolver::llf_sr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hlle_sr) {
-    CalculateFluxes<Hydro_RSolver::hlle_sr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hllc_sr) {
-    CalculateFluxes<Hydro_RSolver::hllc_sr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::llf_gr) {
-    CalculateFluxes<Hydro_RSolver::llf_gr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hlle_gr) {
-    CalculateFluxes<Hydro_RSolver::hlle_gr>(pdrive, stage);
-  }
-
-  // Add viscous, heat-flux, etc fluxes
-  if (pvisc != nullptr) {
+  // with fused update, fluxes are computed in RKUpdate() and never stored
+  if (use_fused) {return TaskStatus::complete;}
+
+  // with split fluxes, fluxes for this stage were computed at end of previous stage
+  if (fluxes_done_) {
+    fluxes_done_ = false;
+    return TaskStatus::complete;
+  }
+
+  CalculateFluxesInRegion(pdrive, stage, FluxRegion::all);
+
+  // Add viscous, heat-flux, etc fluxes (unless integrated with super-time-stepping)
+  if ((pvisc != nullptr) && !(use_sts)) {
     pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
   }
-  if (pcond != nullptr) {
+  if ((pcond != nullptr) && !(use_sts)) {
     pcond->AddHeatFlux(w0, peos->eos_data, uflx);
   }
 
@@ -196,6 +213,16 @@ TaskStatus Hydro::Fluxes(Driver *pdrive, int stage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateFluxesInRegion
+//! \brief Calls the CalculateFluxes function selected by SelectFluxFunction() for the
+//! Riemann solver and reconstruction method of this run
+
+void Hydro::CalculateFluxesInRegion(Driver *pdrive, int stage, FluxRegion region) {
+  (this->*calc_fluxes_)(pdrive, stage, region);
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskList Hydro::SendFlux
 //! \brief Wrapper task list function to pack/send restricted values of fluxes of
@@ -238,6 +265,9 @@ TaskStatus Hydro::HydroSrcTerms(Driver *pdrive, int stage) {
   if (psrc->ism_cooling)  psrc->ISMCooling(w0, peos->eos_data, beta_dt, u0);
   if (psrc->rel_cooling)  psrc->RelCooling(w0, peos->eos_data, beta_dt, u0);
   if (psrc->shearing_box) psrc->ShearingBox(w0, peos->eos_data, beta_dt, u0);
+  if (pmy_pack->pgrav != nullptr) {
+    pmy_pack->pgrav->AddSrcTerms(w0, beta_dt, peos->eos_data.is_ideal, u0);
+  }
 
   // Add coordinate source terms in GR.  Again, must be computed with only primitives.
   if (pmy_pack->pcoord->is_general_relativistic) {
@@ -245,8 +275,14 @@ TaskStatus Hydro::HydroSrcTerms(Driver *pdrive, int stage) {
   }
 
   // Add user source terms
-  if (pmy_pack->pmesh->pgen->user_srcs) {
-    (pmy_pack->pmesh->pgen->user_srcs_func)(pmy_pack->pmesh, beta_dt);
+  auto &pgen = pmy_pack->pmesh->pgen;
+  if (pgen->user_srcs) {
+    if (pgen->user_srcs_kernel) {
+      pgen->user_srcs_kernel(pmy_pack, w0, DvceArray5D<Real>(), beta_dt, u0);
+    }
+    if (pgen->user_srcs_func != nullptr) {
+      (pgen->user_srcs_func)(pmy_pack->pmesh, beta_dt);
+    }
   }
 
   return TaskStatus::complete;
@@ -303,6 +339,24 @@ TaskStatus Hydro::SendU(Driver *pdrive, int stage) {
   return tstat;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::InteriorFluxes
+//! \brief Wrapper task list function used with split fluxes.  Computes primitives in the
+//! active zone, and fluxes for the next stage on faces that do not depend on ghost zones,
+//! while boundary values of U are being communicated.  Nothing is done in the last
+//! stage, since the fluxes at the start of the next cycle are computed in Fluxes() after
+//! any operator-split updates and mesh refinement.
+
+TaskStatus Hydro::InteriorFluxes(Driver *pdrive, int stage) {
+  if (stage == pdrive->nexp_stages) {return TaskStatus::complete;}
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  peos->ConsToPrim(u0, w0, false, indcs.is, indcs.ie, indcs.js, indcs.je,
+                   indcs.ks, indcs.ke);
+  interior_c2p_done_ = true;
+  CalculateFluxesInRegion(pdrive, stage, FluxRegion::interior);
+  return TaskStatus::complete;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskList Hydro::RecvU
 //! \brief Wrapper task list function to receive/unpack cell-centered conserved variables
@@ -378,15 +432,59 @@ TaskStatus Hydro::Prolongate(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn TaskList Hydro::ConToPrim
-//! \brief Wrapper task list function to call ConsToPrim over entire mesh (including gz)
+//! \brief Wrapper task list function to call ConsToPrim over active zone and c2p_ng
+//! layers of ghost zones
 
 TaskStatus Hydro::ConToPrim(Driver *pdrive, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
-  int &ng = indcs.ng;
-  int n1m1 = indcs.nx1 + 2*ng - 1;
-  int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
-  int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
-  peos->ConsToPrim(u0, w0, false, 0, n1m1, 0, n2m1, 0, n3m1);
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  // convert only c2p_ng ghost layers (all ng layers by default)
+  int il = is - c2p_ng, iu = ie + c2p_ng;
+  int jl = js, ju = je, kl = ks, ku = ke;
+  if (indcs.nx2 > 1) {jl -= c2p_ng; ju += c2p_ng;}
+  if (indcs.nx3 > 1) {kl -= c2p_ng; ku += c2p_ng;}
+  if (interior_c2p_done_) {
+    // active zone already converted in InteriorFluxes(), so only convert ghost zones
+    if (pmy_pack->pmesh->three_d) {
+      peos->ConsToPrim(u0, w0, false, il, iu, jl, ju, kl, ks-1);
+      peos->ConsToPrim(u0, w0, false, il, iu, jl, ju, ke+1, ku);
+    }
+    if (pmy_pack->pmesh->multi_d) {
+      peos->ConsToPrim(u0, w0, false, il, iu, jl, js-1, ks, ke);
+      peos->ConsToPrim(u0, w0, false, il, iu, je+1, ju, ks, ke);
+    }
+    peos->ConsToPrim(u0, w0, false, il, is-1, js, je, ks, ke);
+    peos->ConsToPrim(u0, w0, false, ie+1, iu, js, je, ks, ke);
+    interior_c2p_done_ = false;
+  } else if (use_c2p_dt && (stage == pdrive->nexp_stages) &&
+             (pdrive->time_evolution == TimeEvolution::dynamic)) {
+    // timestep for next cycle computed in same kernel, and used in NewTimeStep()
+    peos->ConsToPrimNewDt(u0, w0, il, iu, jl, ju, kl, ku, dt_c2p_);
+    dt_c2p_ready_ = true;
+  } else {
+    peos->ConsToPrim(u0, w0, false, il, iu, jl, ju, kl, ku);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::BoundaryFluxes
+//! \brief Wrapper task list function used with split fluxes.  Computes fluxes for the
+//! next stage on faces that depend on ghost zones, once they have been received and
+//! converted to primitives.  Diffusive fluxes are added over all faces.
+
+TaskStatus Hydro::BoundaryFluxes(Driver *pdrive, int stage) {
+  if (stage == pdrive->nexp_stages) {return TaskStatus::complete;}
+  CalculateFluxesInRegion(pdrive, stage, FluxRegion::boundary);
+  if ((pvisc != nullptr) && !(use_sts)) {
+    pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
+  }
+  if ((pcond != nullptr) && !(use_sts)) {
+    pcond->AddHeatFlux(w0, peos->eos_data, uflx);
+  }
+  fluxes_done_ = true;
   return TaskStatus::complete;
 }
 
@@ -18,9 +18,35 @@
 namespace hydro {
 //----------------------------------------------------------------------------------------
 //! \fn  void Hydro::Update
-//  \brief Explicit RK update including flux divergence terms
+//  \brief Explicit RK update including flux divergence terms.  With <hydro>/fused=true
+//  the fluxes are computed here by FusedUpdate(), rather than in Fluxes().
 
 TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
+  if (use_fused) {
+    if (rsolver_method == Hydro_RSolver::advect) {
+      FusedUpdate<Hydro_RSolver::advect>(pdriver, stage);
+    } else if (rsolver_method == Hydro_RSolver::llf) {
+      FusedUpdate<Hydro_RSolver::llf>(pdriver, stage);
+    } else if (rsolver_method == Hydro_RSolver::hlle) {
+      FusedUpdate<Hydro_RSolver::hlle>(pdriver, stage);
+    } else if (rsolver_method == Hydro_RSolver::hllc) {
+      FusedUpdate<Hydro_RSolver::hllc>(pdriver, stage);
+    } else if (rsolver_method == Hydro_RSolver::roe) {
+      FusedUpdate<Hydro_RSolver::roe>(pdriver, stage);
+    } else if (rsolver_method == Hydro_RSolver::llf_sr) {
+      FusedUpdate<Hydro_RSolver::llf_sr>(pdriver, stage);
+    } else if (rsolver_method == Hydro_RSolver::hlle_sr) {
+      FusedUpdate<Hydro_RSolver::hlle_sr>(pdriver, stage);
+    } else if (rsolver_method == Hydro_RSolver::hllc_sr) {
+      FusedUpdate<Hydro_RSolver::hllc_sr>(pdriver, stage);
+    } else if (rsolver_method == Hydro_RSolver::llf_gr) {
+      FusedUpdate<Hydro_RSolver::llf_gr>(pdriver, stage);
+    } else if (rsolver_method == Hydro_RSolver::hlle_gr) {
+      FusedUpdate<Hydro_RSolver::hlle_gr>(pdriver, stage);
+    }
+    return TaskStatus::complete;
+  }
+
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
@@ -47,7 +73,8 @@ TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
   int scr_level = 0;
   size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1);
 
-  par_for_outer("h_update",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nvar-1,ks,ke,js,je,
+  par_for_outer("h_update",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nvar-1,ks,ke,
+                js,je,
   KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k, const int j) {
     ScrArray1D<Real> divf(member.team_scratch(scr_level), ncells1);
 
@@ -22,11 +22,12 @@ namespace hydro {
 //! \fn void HLLE_GR
 //! \brief HLLE for GR hydrodynamics
 
+template <typename FluxArray>
 KOKKOS_INLINE_FUNCTION
 void HLLE_GR(TeamMember_t const &member, const EOS_Data &eos,
      const RegionIndcs &indcs,const DualArray1D<RegionSize> &size,const CoordData &coord,
      const int m, const int k, const int j, const int il, const int iu, const int ivx,
-     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr, DvceArray5D<Real> flx) {
+     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr, const FluxArray &flx) {
   int ivy = IVX + ((ivx-IVX)+1)%3;
   int ivz = IVX + ((ivx-IVX)+2)%3;
   const Real gamma_prime = eos.gamma/(eos.gamma - 1.0);
@@ -53,29 +54,35 @@ void HLLE_GR(TeamMember_t const &member, const EOS_Data &eos,
     wl_ipr = eos.IdealGasPressure(wl(IEN,i));
     wr_ipr = eos.IdealGasPressure(wr(IEN,i));
 
-    // Extract components of metric
-    Real &x1min = size.d_view(m).x1min;
-    Real &x1max = size.d_view(m).x1max;
-    Real &x2min = size.d_view(m).x2min;
-    Real &x2max = size.d_view(m).x2max;
-    Real &x3min = size.d_view(m).x3min;
-    Real &x3max = size.d_view(m).x3max;
-    Real x1v,x2v,x3v;
-    if (ivx == IVX) {
-      x1v = LeftEdgeX  (i-is, indcs.nx1, x1min, x1max);
-      x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
-      x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
-    } else if (ivx == IVY) {
-      x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
-      x2v = LeftEdgeX  (j-js, indcs.nx2, x2min, x2max);
-      x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+    // Extract components of metric, either from the cache or computed at the face
+    Real glower[4][4], gupper[4][4];
+    if (coord.metric_cache) {
+      const auto &ks_face = (ivx == IVX)? coord.ks_x1f :
+                            ((ivx == IVY)? coord.ks_x2f : coord.ks_x3f);
+      CachedMetricAndInverse(ks_face, m, k, j, i, glower, gupper);
     } else {
-      x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
-      x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
-      x3v = LeftEdgeX  (k-ks, indcs.nx3, x3min, x3max);
+      Real &x1min = size.d_view(m).x1min;
+      Real &x1max = size.d_view(m).x1max;
+      Real &x2min = size.d_view(m).x2min;
+      Real &x2max = size.d_view(m).x2max;
+      Real &x3min = size.d_view(m).x3min;
+      Real &x3max = size.d_view(m).x3max;
+      Real x1v,x2v,x3v;
+      if (ivx == IVX) {
+        x1v = LeftEdgeX  (i-is, indcs.nx1, x1min, x1max);
+        x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+        x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+      } else if (ivx == IVY) {
+        x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+        x2v = LeftEdgeX  (j-js, indcs.nx2, x2min, x2max);
+        x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+      } else {
+        x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+        x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+        x3v = LeftEdgeX  (k-ks, indcs.nx3, x3min, x3max);
+      }
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
     }
-    Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
 
     // Calculate 4-velocity in left state (contravariant compt)
     Real q = glower[ivx][ivx] * SQR(wl_ivx) + glower[ivy][ivy] * SQR(wl_ivy) +
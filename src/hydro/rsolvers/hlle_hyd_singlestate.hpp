@@ -0,0 +1,139 @@
+#ifndef HYDRO_RSOLVERS_HLLE_HYD_SINGLESTATE_HPP_
+#define HYDRO_RSOLVERS_HLLE_HYD_SINGLESTATE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hlle_hyd_singlestate.hpp
+//! \brief HLLE Riemann solver for non-relativistic hydrodynamics (both ideal gas and
+//! isothermal) for a single L/R state.  Used by HLLE() in hlle_hyd.hpp for each face of
+//! a pencil, and can be called directly by kernels that need the flux on a few faces.
+//!
+//! REFERENCES:
+//! - E.F. Toro, "Riemann Solvers and numerical methods for fluid dynamics", 2nd ed.,
+//!   Springer-Verlag, Berlin, (1999) chpt. 10.
+//! - Einfeldt et al., "On Godunov-type methods near low densities", JCP, 92, 273 (1991)
+
+#include "athena.hpp"
+#include "eos/eos.hpp"
+
+namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \fn void SingleStateHLLE_Hyd
+//! \brief The HLLE Riemann solver for hydrodynamics for a single L/R state.  The
+//! components of the velocity in wl/wr (and of the momentum in flux) are ordered
+//! (normal, transverse1, transverse2) with respect to the face.
+
+KOKKOS_INLINE_FUNCTION
+void SingleStateHLLE_Hyd(const HydPrim1D &wl, const HydPrim1D &wr, const EOS_Data &eos,
+                         HydCons1D &flux) {
+  Real gm1 = eos.gamma - 1.0;
+  Real igm1 = 1.0/gm1;
+  Real iso_cs = eos.iso_cs;
+
+  //--- Step 1.  Create local references for L/R states
+
+  const Real &wl_idn = wl.d;
+  const Real &wl_ivx = wl.vx;
+  const Real &wl_ivy = wl.vy;
+  const Real &wl_ivz = wl.vz;
+
+  const Real &wr_idn = wr.d;
+  const Real &wr_ivx = wr.vx;
+  const Real &wr_ivy = wr.vy;
+  const Real &wr_ivz = wr.vz;
+
+  Real wl_ipr, wr_ipr;
+  if (eos.is_ideal) {
+    wl_ipr = eos.IdealGasPressure(wl.e);
+    wr_ipr = eos.IdealGasPressure(wr.e);
+  }
+
+  //--- Step 2.  Compute Roe-averaged state
+
+  Real sqrtdl = sqrt(wl_idn);
+  Real sqrtdr = sqrt(wr_idn);
+  Real isdlpdr = 1.0/(sqrtdl + sqrtdr);
+
+  Real wroe_ivx = (sqrtdl*wl_ivx + sqrtdr*wr_ivx)*isdlpdr;
+  Real wroe_ivy = (sqrtdl*wl_ivy + sqrtdr*wr_ivy)*isdlpdr;
+  Real wroe_ivz = (sqrtdl*wl_ivz + sqrtdr*wr_ivz)*isdlpdr;
+
+  // Following Roe(1981), the enthalpy H=(E+P)/d is averaged for ideal gas EOS,
+  // rather than E or P directly.  sqrtdl*hl = sqrtdl*(el+pl)/dl = (el+pl)/sqrtdl
+  Real el,er,hroe;
+  if (eos.is_ideal) {
+    el = wl_ipr*igm1 + 0.5*wl_idn*(SQR(wl_ivx) + SQR(wl_ivy) + SQR(wl_ivz));
+    er = wr_ipr*igm1 + 0.5*wr_idn*(SQR(wr_ivx) + SQR(wr_ivy) + SQR(wr_ivz));
+    hroe = ((el + wl_ipr)/sqrtdl + (er + wr_ipr)/sqrtdr)*isdlpdr;
+  }
+
+  //--- Step 3.  Compute sound speed in L,R, and Roe-averaged states
+
+  Real qa,qb;
+  Real a  = iso_cs;
+  if (eos.is_ideal) {
+    qa = eos.IdealHydroSoundSpeed(wl_idn, wl_ipr);
+    qb = eos.IdealHydroSoundSpeed(wr_idn, wr_ipr);
+    a = hroe - 0.5*(SQR(wroe_ivx) + SQR(wroe_ivy) + SQR(wroe_ivz));
+    a = (a < 0.0) ? 0.0 : sqrt(gm1*a);
+  } else {
+    qa = iso_cs;
+    qb = iso_cs;
+  }
+
+  //--- Step 4. Compute the L/R wave speeds based on L/R and Roe-averaged values
+
+  Real al = fmin((wroe_ivx - a),(wl_ivx - qa));
+  Real ar = fmax((wroe_ivx + a),(wr_ivx + qb));
+
+  // following min/max set to TINY_NUMBER to fix bug found in converging supersonic flow
+  Real bp = (ar > 0.0) ? ar : 1.0e-20;
+  Real bm = (al < 0.0) ? al : -1.0e-20;
+
+  //-- Step 5. Compute L/R fluxes along lines bm/bp: F_L - (S_L)U_L; F_R - (S_R)U_R
+
+  qa = wl_ivx - bm;
+  qb = wr_ivx - bp;
+
+  HydCons1D fl, fr;
+  fl.d  = wl_idn*qa;
+  fr.d  = wr_idn*qb;
+
+  fl.mx = wl_idn*wl_ivx*qa;
+  fr.mx = wr_idn*wr_ivx*qb;
+
+  fl.my = wl_idn*wl_ivy*qa;
+  fr.my = wr_idn*wr_ivy*qb;
+
+  fl.mz = wl_idn*wl_ivz*qa;
+  fr.mz = wr_idn*wr_ivz*qb;
+
+  if (eos.is_ideal) {
+    fl.mx += wl_ipr;
+    fr.mx += wr_ipr;
+    fl.e  = el*qa + wl_ipr*wl_ivx;
+    fr.e  = er*qb + wr_ipr*wr_ivx;
+  } else {
+    fl.mx += (iso_cs*iso_cs)*wl_idn;
+    fr.mx += (iso_cs*iso_cs)*wr_idn;
+  }
+
+  //--- Step 6. Compute the HLLE flux at interface. Formulae below equivalent to
+  // Toro eq. 10.20, or Einfeldt et al. (1991) eq. 4.4b
+
+  qa = 0.0;
+  if (bp != bm) qa = 0.5*(bp + bm)/(bp - bm);
+
+  flux.d  = 0.5*(fl.d  + fr.d ) + qa*(fl.d  - fr.d );
+  flux.mx = 0.5*(fl.mx + fr.mx) + qa*(fl.mx - fr.mx);
+  flux.my = 0.5*(fl.my + fr.my) + qa*(fl.my - fr.my);
+  flux.mz = 0.5*(fl.mz + fr.mz) + qa*(fl.mz - fr.mz);
+  if (eos.is_ideal) {flux.e = 0.5*(fl.e + fr.e) + qa*(fl.e - fr.e);}
+
+  return;
+}
+
+} // namespace hydro
+#endif // HYDRO_RSOLVERS_HLLE_HYD_SINGLESTATE_HPP_
@@ -84,6 +84,7 @@ class IonNeutral {
   void AssembleIonNeutralTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
   TaskStatus FirstTwoImpRK(Driver* pdrive, int stage);
   TaskStatus ImpRKUpdate(Driver* pdrive, int stage);
+  void ImpRKStages(Driver* pdrive, int estage_first, int estage_last);
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
@@ -6,6 +6,7 @@
 //! \file ion-neutral_tasks.cpp
 //  \brief
 
+#include <cstdlib>
 #include <map>
 #include <memory>
 #include <string>
@@ -36,54 +37,70 @@ void IonNeutral::AssembleIonNeutralTasks(
   Hydro *phyd = pmy_pack->phydro;
 
   // assemble "before_stagen_tl" task list
-  id.i_irecv = tl["before_stagen"]->AddTask(&MHD::InitRecv, pmhd, none);
-  id.n_irecv = tl["before_stagen"]->AddTask(&Hydro::InitRecv, phyd, none);
+  id.i_irecv = tl["before_stagen"]->AddTask(&MHD::InitRecv, pmhd, none, "MHD_InitRecv");
+  id.n_irecv = tl["before_stagen"]->AddTask(&Hydro::InitRecv, phyd, none,
+                                            "Hydro_InitRecv");
 
   // assemble "stagen_tl" task list
   // FirstTwoImpRK task does CopyCons
-  id.impl_2x = tl["stagen"]->AddTask(&IonNeutral::FirstTwoImpRK, this, none);
-
-  id.i_flux   = tl["stagen"]->AddTask(&MHD::Fluxes, pmhd, id.impl_2x);
-  id.i_sendf  = tl["stagen"]->AddTask(&MHD::SendFlux, pmhd, id.i_flux);
-  id.i_recvf  = tl["stagen"]->AddTask(&MHD::RecvFlux, pmhd, id.i_sendf);
-  id.i_rkupdt = tl["stagen"]->AddTask(&MHD::RKUpdate, pmhd, id.i_recvf);
-  id.i_srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, pmhd, id.i_rkupdt);
-
-  id.n_flux   = tl["stagen"]->AddTask(&Hydro::Fluxes, phyd, id.i_srctrms);
-  id.n_sendf  = tl["stagen"]->AddTask(&Hydro::SendFlux, phyd, id.n_flux);
-  id.n_recvf  = tl["stagen"]->AddTask(&Hydro::RecvFlux, phyd, id.n_sendf);
-  id.n_rkupdt = tl["stagen"]->AddTask(&Hydro::RKUpdate, phyd, id.n_recvf);
-  id.n_srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, phyd, id.n_rkupdt);
-
-  id.impl     = tl["stagen"]->AddTask(&IonNeutral::ImpRKUpdate, this, id.n_srctrms);
-  id.i_restu  = tl["stagen"]->AddTask(&MHD::RestrictU, pmhd, id.impl);
-  id.n_restu  = tl["stagen"]->AddTask(&Hydro::RestrictU, phyd, id.i_restu);
-
-  id.i_sendu  = tl["stagen"]->AddTask(&MHD::SendU, pmhd, id.n_restu);
-  id.n_sendu  = tl["stagen"]->AddTask(&Hydro::SendU, phyd, id.n_restu);
-  id.i_recvu  = tl["stagen"]->AddTask(&MHD::RecvU, pmhd, id.i_sendu);
-  id.n_recvu  = tl["stagen"]->AddTask(&Hydro::RecvU, phyd, id.n_sendu);
-
-  id.efld     = tl["stagen"]->AddTask(&MHD::CornerE, pmhd, id.i_recvu);
-  id.sende    = tl["stagen"]->AddTask(&MHD::SendE, pmhd, id.efld);
-  id.recve    = tl["stagen"]->AddTask(&MHD::RecvE, pmhd, id.sende);
-  id.ct       = tl["stagen"]->AddTask(&MHD::CT, pmhd, id.recve);
-  id.restb    = tl["stagen"]->AddTask(&MHD::RestrictB, pmhd, id.ct);
-  id.sendb    = tl["stagen"]->AddTask(&MHD::SendB, pmhd, id.restb);
-  id.recvb    = tl["stagen"]->AddTask(&MHD::RecvB, pmhd, id.sendb);
-
-  id.i_bcs    = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, pmhd, id.recvb);
-  id.n_bcs    = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, phyd, id.n_recvu);
-  id.i_prol   = tl["stagen"]->AddTask(&MHD::Prolongate, pmhd, id.i_bcs);
-  id.n_prol   = tl["stagen"]->AddTask(&Hydro::Prolongate, phyd, id.n_bcs);
-  id.i_c2p    = tl["stagen"]->AddTask(&MHD::ConToPrim, pmhd, id.i_prol);
-  id.n_c2p    = tl["stagen"]->AddTask(&Hydro::ConToPrim, phyd, id.n_prol);
-  id.i_newdt  = tl["stagen"]->AddTask(&MHD::NewTimeStep, pmhd, id.i_c2p);
-  id.n_newdt  = tl["stagen"]->AddTask(&Hydro::NewTimeStep, phyd, id.n_c2p);
+  id.impl_2x = tl["stagen"]->AddTask(&IonNeutral::FirstTwoImpRK, this, none,
+                                     "IonNeutral_FirstTwoImpRK");
+
+  id.i_flux   = tl["stagen"]->AddTask(&MHD::Fluxes, pmhd, id.impl_2x, "MHD_Fluxes");
+  id.i_sendf  = tl["stagen"]->AddTask(&MHD::SendFlux, pmhd, id.i_flux, "MHD_SendFlux");
+  id.i_recvf  = tl["stagen"]->AddTask(&MHD::RecvFlux, pmhd, id.i_sendf, "MHD_RecvFlux");
+  id.i_rkupdt = tl["stagen"]->AddTask(&MHD::RKUpdate, pmhd, id.i_recvf, "MHD_RKUpdate");
+  id.i_srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, pmhd, id.i_rkupdt,
+                                         "MHD_MHDSrcTerms");
+
+  id.n_flux   = tl["stagen"]->AddTask(&Hydro::Fluxes, phyd, id.i_srctrms, "Hydro_Fluxes");
+  id.n_sendf  = tl["stagen"]->AddTask(&Hydro::SendFlux, phyd, id.n_flux,
+                                      "Hydro_SendFlux");
+  id.n_recvf  = tl["stagen"]->AddTask(&Hydro::RecvFlux, phyd, id.n_sendf,
+                                      "Hydro_RecvFlux");
+  id.n_rkupdt = tl["stagen"]->AddTask(&Hydro::RKUpdate, phyd, id.n_recvf,
+                                      "Hydro_RKUpdate");
+  id.n_srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, phyd, id.n_rkupdt,
+                                         "Hydro_HydroSrcTerms");
+
+  id.impl     = tl["stagen"]->AddTask(&IonNeutral::ImpRKUpdate, this, id.n_srctrms,
+                                      "IonNeutral_ImpRKUpdate");
+  id.i_restu  = tl["stagen"]->AddTask(&MHD::RestrictU, pmhd, id.impl, "MHD_RestrictU");
+  id.n_restu  = tl["stagen"]->AddTask(&Hydro::RestrictU, phyd, id.i_restu,
+                                      "Hydro_RestrictU");
+
+  id.i_sendu  = tl["stagen"]->AddTask(&MHD::SendU, pmhd, id.n_restu, "MHD_SendU");
+  id.n_sendu  = tl["stagen"]->AddTask(&Hydro::SendU, phyd, id.n_restu, "Hydro_SendU");
+  id.i_recvu  = tl["stagen"]->AddTask(&MHD::RecvU, pmhd, id.i_sendu, "MHD_RecvU");
+  id.n_recvu  = tl["stagen"]->AddTask(&Hydro::RecvU, phyd, id.n_sendu, "Hydro_RecvU");
+
+  id.efld     = tl["stagen"]->AddTask(&MHD::CornerE, pmhd, id.i_recvu, "MHD_CornerE");
+  id.sende    = tl["stagen"]->AddTask(&MHD::SendE, pmhd, id.efld, "MHD_SendE");
+  id.recve    = tl["stagen"]->AddTask(&MHD::RecvE, pmhd, id.sende, "MHD_RecvE");
+  id.ct       = tl["stagen"]->AddTask(&MHD::CT, pmhd, id.recve, "MHD_CT");
+  id.restb    = tl["stagen"]->AddTask(&MHD::RestrictB, pmhd, id.ct, "MHD_RestrictB");
+  id.sendb    = tl["stagen"]->AddTask(&MHD::SendB, pmhd, id.restb, "MHD_SendB");
+  id.recvb    = tl["stagen"]->AddTask(&MHD::RecvB, pmhd, id.sendb, "MHD_RecvB");
+
+  id.i_bcs    = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, pmhd, id.recvb,
+                                      "MHD_ApplyPhysicalBCs");
+  id.n_bcs    = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, phyd, id.n_recvu,
+                                      "Hydro_ApplyPhysicalBCs");
+  id.i_prol   = tl["stagen"]->AddTask(&MHD::Prolongate, pmhd, id.i_bcs, "MHD_Prolongate");
+  id.n_prol   = tl["stagen"]->AddTask(&Hydro::Prolongate, phyd, id.n_bcs,
+                                      "Hydro_Prolongate");
+  id.i_c2p    = tl["stagen"]->AddTask(&MHD::ConToPrim, pmhd, id.i_prol, "MHD_ConToPrim");
+  id.n_c2p    = tl["stagen"]->AddTask(&Hydro::ConToPrim, phyd, id.n_prol,
+                                      "Hydro_ConToPrim");
+  id.i_newdt  = tl["stagen"]->AddTask(&MHD::NewTimeStep, pmhd, id.i_c2p,
+                                      "MHD_NewTimeStep");
+  id.n_newdt  = tl["stagen"]->AddTask(&Hydro::NewTimeStep, phyd, id.n_c2p,
+                                      "Hydro_NewTimeStep");
 
   // assemble "after_stagen_tl" task list
-  id.i_clear = tl["after_stagen"]->AddTask(&MHD::ClearSend, pmhd, none);
-  id.n_clear = tl["after_stagen"]->AddTask(&Hydro::ClearSend, phyd, none);
+  id.i_clear = tl["after_stagen"]->AddTask(&MHD::ClearSend, pmhd, none, "MHD_ClearSend");
+  id.n_clear = tl["after_stagen"]->AddTask(&Hydro::ClearSend, phyd, none,
+                                           "Hydro_ClearSend");
 
   return;
 }
@@ -106,11 +123,9 @@ TaskStatus IonNeutral::FirstTwoImpRK(Driver *pdrive, int stage) {
   Kokkos::deep_copy(DevExeSpace(), pmhd->b1.x2f, pmhd->b0.x2f);
   Kokkos::deep_copy(DevExeSpace(), pmhd->b1.x3f, pmhd->b0.x3f);
 
-  // Solve implicit equations first time (nexp_stage = -1)
-  auto status = ImpRKUpdate(pdrive, -1);
-
-  // Solve implicit equations second time (nexp_stage = 0)
-  status = ImpRKUpdate(pdrive, 0);
+  // Solve implicit equations first (nexp_stage = -1) and second (nexp_stage = 0) time
+  // in a single pass over the grid
+  ImpRKStages(pdrive, -1, 0);
 
   // update primitive variables for both hydro and MHD
   auto &indcs = pmy_pack->pmesh->mb_indcs;
@@ -132,6 +147,46 @@ TaskStatus IonNeutral::FirstTwoImpRK(Driver *pdrive, int stage) {
 //  source terms are evaluated using partially updated values (including explicit terms
 //  such as flux divergence).  This means soure terms must only be evaluated using
 //  conserved variables (u0), as primitives (w0) are not updated until end of TaskList.
+
+TaskStatus IonNeutral::ImpRKUpdate(Driver *pdriver, int estage) {
+  ImpRKStages(pdriver, estage, estage);
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \struct ImexStageCoeffs
+//  \brief coefficients of one implicit stage, set on host and captured by value in the
+//  fused kernel in ImpRKStages()
+
+struct ImexStageCoeffs {
+  int nsrc;                // number of R(U) terms from previous stages added
+  Real adt[4];             // weights (times dt) of these terms
+  int src_slot[4];         // slots of these terms in impl_src
+  bool solve;              // solve implicit equations in this stage
+  Real gamma_adt, xi_adt, alpha_adt;
+  int rup_slot;            // slot in impl_src to store R(U) of this stage, or -1
+};
+
+struct ImexCoeffs {
+  int nstage;              // number of fused stages (1 or 2)
+  ImexStageCoeffs st[2];
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn  void IonNeutral::ImpRKStages
+//  \brief Performs implicit stages (estage_first ... estage_last) of the ImEx integrator
+//  for the ion-neutral terms in a single fused kernel.  The ion and neutral densities and
+//  momenta of each cell are read once, and in each stage the kernel
+//    (1) adds the stiff source terms evaluated in previous stages, i.e. the R(U^1),
+//        R(U^2), etc. terms, to the partially updated conserved variables.  Only
+//        required for istage = (2,3,4,[5]);
+//    (2) updates the ion/neutral densities and momenta with the analytic solution of the
+//        implicit difference equations.  Only required for istage = (1,2,3,[4]);
+//    (3) computes the stiff source terms R(U^n) with the updated variables, for use in
+//        later stages.  Only required for istage = (1,2,3,[4]), and only stored if a
+//        later stage uses it.
+//  before the updated variables are written back once.  At most two stages (the first
+//  two fully implicit stages) are fused.
 //
 //  Note indices of source term array correspond to:
 //     ru(0) -> ui(IM1)     ru(3) -> un(IM1)
@@ -140,155 +195,130 @@ TaskStatus IonNeutral::FirstTwoImpRK(Driver *pdrive, int stage) {
 //     ru(6) -> ui(IDN)     ru(7) -> un(IDN)
 //  where ui=pmhd->u0 and un=phydro->u0
 
+void IonNeutral::ImpRKStages(Driver *pdriver, int estage_first, int estage_last) {
+  ImexCoeffs c;
+  c.nstage = estage_last - estage_first + 1;
+  if (c.nstage < 1 || c.nstage > 2) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "At most two implicit stages can be fused" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
 
-TaskStatus IonNeutral::ImpRKUpdate(Driver *pdriver, int estage) {
-  // # of implicit stage (1,2,3,4,[5]).  Note estage=(# of explicit stage)=(1,2,[3])
-  // estage <= 0 corresponds to first two fully implicit stages
-  int istage = estage + 2;
-
-  auto &indcs = pmy_pack->pmesh->mb_indcs;
-  int n1 = indcs.nx1 + 2*indcs.ng;
-  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*indcs.ng) : 1;
-  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*indcs.ng) : 1;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-
-  // Add stiff source term (ion-neutral drag) evaluated with values from previous stages,
-  // i.e. the R(U^1), R(U^2), etc. terms, to partially updated conserved variables.
-  // Only required for istage = (2,3,4,[5])
-  mhd::MHD *pmhd = pmy_pack->pmhd;
-  hydro::Hydro *phyd = pmy_pack->phydro;
-  if (istage > 1) {
-    int scr_level = 0;
-    size_t scr_size = 0;
-    auto ui = pmhd->u0;
-    auto un = phyd->u0;
-    auto &a_twid = pdriver->a_twid;
-    Real dt = pmy_pack->pmesh->dt;
-    auto ru_ = pdriver->impl_src;
-    par_for_outer("imex_exp",DevExeSpace(),scr_size,scr_level,0,nmb1,0,(n3-1),0,(n2-1),
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+  Real dt = pmy_pack->pmesh->dt;
+  for (int l=0; l<c.nstage; ++l) {
+    // # of implicit stage (1,2,3,4,[5]).  Note estage=(# of explicit stage)=(1,2,[3])
+    // estage <= 0 corresponds to first two fully implicit stages
+    int estage = estage_first + l;
+    int istage = estage + 2;
+    auto &st = c.st[l];
+
+    // terms with zero weight are skipped, as their slot may have been reused
+    st.nsrc = 0;
+    if (istage > 1) {
       for (int s=0; s<=(istage-2); ++s) {
-        Real adt = a_twid[istage-2][s]*dt;
-        par_for_inner(member, 0, (n1-1), [&](const int i) {
-          ui(m,IM1,k,j,i) += adt*ru_(s,m,0,k,j,i);
-          ui(m,IM2,k,j,i) += adt*ru_(s,m,1,k,j,i);
-          ui(m,IM3,k,j,i) += adt*ru_(s,m,2,k,j,i);
-          un(m,IM1,k,j,i) += adt*ru_(s,m,3,k,j,i);
-          un(m,IM2,k,j,i) += adt*ru_(s,m,4,k,j,i);
-          un(m,IM3,k,j,i) += adt*ru_(s,m,5,k,j,i);
-          ui(m,IDN,k,j,i) += adt*ru_(s,m,6,k,j,i);
-          un(m,IDN,k,j,i) += adt*ru_(s,m,7,k,j,i);
-        });
+        Real adt = pdriver->a_twid[istage-2][s]*dt;
+        int n = pdriver->imp_slot[s];
+        if (adt == 0.0 || n < 0) continue;
+        st.adt[st.nsrc] = adt;
+        st.src_slot[st.nsrc] = n;
+        st.nsrc++;
       }
-    });
-  }
-
-  // Update ion/neutral momentum equations with analytic solution of implicit difference
-  // equations for ion-neutral drag.
-  // Only required for istage = (1,2,3,[4])
-  if (estage < pdriver->nexp_stages) {
-    Real gamma_adt;
-    Real xi_adt;
-    Real alpha_adt;
+    }
 
+    st.solve = (estage < pdriver->nexp_stages);
     // Condition to set gamma_adt, xi_adt, and alpha_adt to zero
     if (istage < 3 && pdriver->integrator == "imex2+") {
-      gamma_adt = 0.0;
-      xi_adt = 0.0;
-      alpha_adt = 0.0;
+      st.gamma_adt = 0.0;
+      st.xi_adt = 0.0;
+      st.alpha_adt = 0.0;
     } else {
-      gamma_adt = drag_coeff * (pdriver->a_impl) * (pmy_pack->pmesh->dt);
-      xi_adt = ionization_coeff * (pdriver->a_impl) * (pmy_pack->pmesh->dt);
-      alpha_adt = recombination_coeff * (pdriver->a_impl) * (pmy_pack->pmesh->dt);
+      st.gamma_adt = drag_coeff * (pdriver->a_impl) * dt;
+      st.xi_adt = ionization_coeff * (pdriver->a_impl) * dt;
+      st.alpha_adt = recombination_coeff * (pdriver->a_impl) * dt;
+    }
+    st.rup_slot = (st.solve)? pdriver->imp_slot[istage-1] : -1;
+  }
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int n1 = indcs.nx1 + 2*indcs.ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*indcs.ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*indcs.ng) : 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto ui = pmy_pack->pmhd->u0;
+  auto un = pmy_pack->phydro->u0;
+  auto ru_ = pdriver->impl_src;
+  Real drag = drag_coeff;
+  Real xi = ionization_coeff;
+  Real alpha = recombination_coeff;
+  par_for("imex_fused",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    // ion/neutral momenta and densities, ordered as in impl_src
+    Real q[8];
+    for (int d=0; d<3; ++d) {
+      q[d]   = ui(m,IM1+d,k,j,i);
+      q[3+d] = un(m,IM1+d,k,j,i);
     }
+    q[6] = ui(m,IDN,k,j,i);
+    q[7] = un(m,IDN,k,j,i);
+
+    for (int l=0; l<c.nstage; ++l) {
+      const auto &st = c.st[l];
+      // (1) add stiff source terms from previous stages
+      for (int s=0; s<st.nsrc; ++s) {
+        for (int v=0; v<8; ++v) {
+          q[v] += st.adt[s]*ru_(st.src_slot[s],m,v,k,j,i);
+        }
+      }
+      if (!(st.solve)) continue;
 
-    //Real gamma_adt = drag_coeff*(pdriver->a_impl)*(pmy_pack->pmesh->dt);
-    //Real xi_adt = ionization_coeff*(pdriver->a_impl)*(pmy_pack->pmesh->dt);
-    //Real alpha_adt = recombination_coeff*(pdriver->a_impl)*(pmy_pack->pmesh->dt)
-    auto ui = pmhd->u0;
-    auto un = phyd->u0;
-    par_for("imex_imp",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
-    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-      Real rho_i = ui(m,IDN,k,j,i);
+      // (2) analytic solution of implicit difference equations
+      Real gamma_adt = st.gamma_adt;
+      Real xi_adt = st.xi_adt;
+      Real alpha_adt = st.alpha_adt;
+      Real rho_i = q[6];
       if (alpha_adt > 0) { // to avoid division by zero
         Real d = 1./4./alpha_adt/alpha_adt + xi_adt/2./alpha_adt/alpha_adt
-                 + xi_adt*xi_adt/4./alpha_adt/alpha_adt + ui(m,IDN,k,j,i)/alpha_adt +
-                 xi_adt/alpha_adt * (ui(m,IDN,k,j,i)+un(m,IDN,k,j,i));
+                 + xi_adt*xi_adt/4./alpha_adt/alpha_adt + q[6]/alpha_adt +
+                 xi_adt/alpha_adt * (q[6]+q[7]);
         rho_i = -1./2./alpha_adt - xi_adt/2./alpha_adt + sqrt(d);
       }
-      Real rho_n = ui(m,IDN,k,j,i) + un(m,IDN,k,j,i) - rho_i;
-      ui(m,IDN,k,j,i) = rho_i;
-      un(m,IDN,k,j,i) = rho_n;
+      Real rho_n = q[6] + q[7] - rho_i;
+      q[6] = rho_i;
+      q[7] = rho_n;
 
       Real denom = 1.0 + gamma_adt*(rho_i+rho_n) + xi_adt + alpha_adt*rho_i;
-      // compute new ion/neutral momenta in x1
-      Real sum = (ui(m,IM1,k,j,i) + un(m,IM1,k,j,i));
-      Real u_i = (ui(m,IM1,k,j,i) +
-                 (gamma_adt*rho_i + xi_adt)*sum)/denom;
-      Real u_n = sum - u_i;
-      ui(m,IM1,k,j,i) = u_i;
-      un(m,IM1,k,j,i) = u_n;
-      // compute new ion/neutral momenta in x2
-      sum = (ui(m,IM2,k,j,i) + un(m,IM2,k,j,i));
-      u_i = (ui(m,IM2,k,j,i) +
-                 (gamma_adt*rho_i + xi_adt)*sum)/denom;
-      u_n = sum - u_i;
-      ui(m,IM2,k,j,i) = u_i;
-      un(m,IM2,k,j,i) = u_n;
-      // compute new ion/neutral momenta in x3
-      sum = (ui(m,IM3,k,j,i) + un(m,IM3,k,j,i));
-      u_i = (ui(m,IM3,k,j,i) +
-                 (gamma_adt*rho_i + xi_adt)*sum)/denom;
-      u_n = sum - u_i;
-      ui(m,IM3,k,j,i) = u_i;
-      un(m,IM3,k,j,i) = u_n;
-    });
-  }
+      // compute new ion/neutral momenta in x1, x2, x3
+      for (int d=0; d<3; ++d) {
+        Real sum = (q[d] + q[3+d]);
+        Real u_i = (q[d] + (gamma_adt*rho_i + xi_adt)*sum)/denom;
+        q[d] = u_i;
+        q[3+d] = sum - u_i;
+      }
 
-  // Compute stiff source term (ion-neutral drag) using variables updated in this stage,
-  // i.e R(U^n), for use in later stages.  Only required for istage = (1,2,3,[4])
-  if (estage < pdriver->nexp_stages) {
-    int s = istage-1;
-    auto ui = pmhd->u0;
-    auto un = phyd->u0;
-    auto drag = drag_coeff;
-    auto xi = ionization_coeff;
-    auto alpha = recombination_coeff;
-    auto ru_ = pdriver->impl_src;
-    par_for("imex_rup",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
-    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-      // drag term in IM1 component of ion momentum
-      ru_(s,m,0,k,j,i) = drag*(ui(m,IDN,k,j,i)*un(m,IM1,k,j,i) -
-                              un(m,IDN,k,j,i)*ui(m,IM1,k,j,i)) +
-                              xi*un(m,IM1,k,j,i) - alpha*ui(m,IDN,k,j,i)*ui(m,IM1,k,j,i);
-      // drag term in IM2 component of ion momentum
-      ru_(s,m,1,k,j,i) = drag*(ui(m,IDN,k,j,i)*un(m,IM2,k,j,i) -
-                              un(m,IDN,k,j,i)*ui(m,IM2,k,j,i)) +
-                              xi*un(m,IM2,k,j,i) - alpha*ui(m,IDN,k,j,i)*ui(m,IM2,k,j,i);
-      // drag term in IM3 component of ion momentum
-      ru_(s,m,2,k,j,i) = drag*(ui(m,IDN,k,j,i)*un(m,IM3,k,j,i) -
-                              un(m,IDN,k,j,i)*ui(m,IM3,k,j,i)) +
-                              xi*un(m,IM3,k,j,i) - alpha*ui(m,IDN,k,j,i)*ui(m,IM3,k,j,i);
-      // drag term in IM1 component of neutral momentum
-      ru_(s,m,3,k,j,i) = drag*(un(m,IDN,k,j,i)*ui(m,IM1,k,j,i) -
-                              ui(m,IDN,k,j,i)*un(m,IM1,k,j,i)) -
-                              xi*un(m,IM1,k,j,i) + alpha*ui(m,IDN,k,j,i)*ui(m,IM1,k,j,i);
-      // drag term in IM2 component of neutral momentum
-      ru_(s,m,4,k,j,i) = drag*(un(m,IDN,k,j,i)*ui(m,IM2,k,j,i) -
-                              ui(m,IDN,k,j,i)*un(m,IM2,k,j,i)) -
-                              xi*un(m,IM2,k,j,i) + alpha*ui(m,IDN,k,j,i)*ui(m,IM2,k,j,i);
-      // drag term in IM3 component of neutral momentum
-      ru_(s,m,5,k,j,i) = drag*(un(m,IDN,k,j,i)*ui(m,IM3,k,j,i) -
-                              ui(m,IDN,k,j,i)*un(m,IM3,k,j,i)) -
-                              xi*un(m,IM3,k,j,i) + alpha*ui(m,IDN,k,j,i)*ui(m,IM3,k,j,i);
-      // drag term in IDN component of ion momentum
-      ru_(s,m,6,k,j,i) = xi*un(m,IDN,k,j,i) - alpha*ui(m,IDN,k,j,i)*ui(m,IDN,k,j,i);
-      // drag term in IDN component of neutral momentum
-      ru_(s,m,7,k,j,i) =-xi*un(m,IDN,k,j,i) + alpha*ui(m,IDN,k,j,i)*ui(m,IDN,k,j,i);
-    });
-  }
+      // (3) stiff source terms R(U^n) for use in later stages
+      int s = st.rup_slot;
+      if (s >= 0) {
+        for (int d=0; d<3; ++d) {
+          // drag term in IM1+d component of ion and neutral momentum
+          ru_(s,m,d,k,j,i) = drag*(q[6]*q[3+d] - q[7]*q[d]) +
+                             xi*q[3+d] - alpha*q[6]*q[d];
+          ru_(s,m,3+d,k,j,i) = drag*(q[7]*q[d] - q[6]*q[3+d]) -
+                               xi*q[3+d] + alpha*q[6]*q[d];
+        }
+        // drag term in IDN component of ion and neutral momentum
+        ru_(s,m,6,k,j,i) = xi*q[7] - alpha*q[6]*q[6];
+        ru_(s,m,7,k,j,i) =-xi*q[7] + alpha*q[6]*q[6];
+      }
+    }
 
-  return TaskStatus::complete;
+    for (int d=0; d<3; ++d) {
+      ui(m,IM1+d,k,j,i) = q[d];
+      un(m,IM1+d,k,j,i) = q[3+d];
+    }
+    ui(m,IDN,k,j,i) = q[6];
+    un(m,IDN,k,j,i) = q[7];
+  });
+  return;
 }
 
 } // namespace ion_neutral
@@ -29,15 +29,22 @@
 #include <string>
 #include <memory>
 #include <cstdio> // sscanf
+#include <utility>
+#include <vector>
 
 // Athena headers
 #include "athena.hpp"
 #include "globals.hpp"
 #include "utils/utils.hpp"
+#include "utils/memory_tracker.hpp"
+#include "utils/transient_pool.hpp"
+#include "utils/roofline.hpp"
+#include "utils/affinity.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs/outputs.hpp"
 #include "driver/driver.hpp"
+#include "driver/ensemble.hpp"
 
 // MPI/OpenMP headers
 #if MPI_PARALLEL_ENABLED
@@ -52,6 +59,54 @@
 #include <hip/hip_runtime.h>
 #endif
 
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void StartupPhase()
+//! \brief Records the wall time since the previous call as the duration of the startup
+//! phase given by name.  Waits for all kernels to finish so they are charged to the
+//! phase that launched them.
+
+std::vector<std::pair<std::string, double>> startup_phases;
+
+void StartupPhase(Kokkos::Timer &t, const std::string &name) {
+  Kokkos::fence();
+  startup_phases.emplace_back(name, t.seconds());
+  t.reset();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ReportStartupPhases()
+//! \brief Prints the time taken by each startup phase (maximum over all ranks).  With
+//! MPI this must be called by every rank.
+
+void ReportStartupPhases() {
+  int nphase = startup_phases.size();
+  std::vector<double> times(nphase);
+  for (int n=0; n<nphase; ++n) {times[n] = startup_phases[n].second;}
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, times.data(), nphase, MPI_DOUBLE, MPI_MAX, 0,
+               MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(times.data(), times.data(), nphase, MPI_DOUBLE, MPI_MAX, 0,
+               MPI_COMM_WORLD);
+  }
+#endif
+  if (global_variable::my_rank != 0) {return;}
+  double total = 0.0;
+  std::cout << std::endl << "Startup time (seconds, max over ranks):" << std::endl;
+  char buf[80];
+  for (int n=0; n<nphase; ++n) {
+    std::snprintf(buf, sizeof(buf), "  %-32s %10.3f", startup_phases[n].first.c_str(),
+                  times[n]);
+    std::cout << buf << std::endl;
+    total += times[n];
+  }
+  std::snprintf(buf, sizeof(buf), "  %-32s %10.3f", "Total", total);
+  std::cout << buf << std::endl;
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 //! \fn int main(int argc, char *argv[])
 //! \brief Athena main program
@@ -116,6 +171,8 @@ int main(int argc, char *argv[]) {
   global_variable::nranks  = 1;
 #endif  // MPI_PARALLEL_ENABLED
 
+  // bind ranks to devices and host cores before Kokkos starts its host threads
+  affinity::Bind(argc, argv);
   Kokkos::initialize(argc, argv);
 
   //--- Step 2. --------------------------------------------------------------------------
@@ -223,6 +280,7 @@ int main(int argc, char *argv[]) {
   // Start the wall clock timer. This is done here rather than in the Driver to ensure
   // that the time taken in ProblemGenerator is also captured.
   Kokkos::Timer timer;
+  Kokkos::Timer phase_timer;  // times each phase of startup
 
   //--- Step 3. --------------------------------------------------------------------------
   // Construct ParameterInput object and load data either from restart or input file.
@@ -243,6 +301,13 @@ int main(int argc, char *argv[]) {
     infile.Close();
   }
   pinput->ModifyFromCmdline(argc, argv);
+  bool startup_timing = pinput->GetOrAddBoolean("job","startup_timing",false);
+  StartupPhase(phase_timer, "read input");
+  team_tuner::Initialize(pinput);
+  // roofline first, since its callbacks are not those of a Kokkos Tools library
+  roofline::Initialize(pinput);
+  memory_tracker::Initialize(pinput);
+  transient_pool::Initialize(pinput);
 
   // Dump input parameters and quit if code was run with -n option.
   if (narg_flag) {
@@ -255,6 +320,56 @@ int main(int argc, char *argv[]) {
 #endif
     return(0);
   }
+  // print device and cores chosen for each rank (collective over all ranks)
+  if (pinput->GetOrAddBoolean("job", "affinity_report", true)) {
+    affinity::Report();
+  }
+  affinity::Finalize();
+
+  // With <ensemble>/nmember > 1, run many independent members in this process instead of
+  // a single simulation, see driver/ensemble.hpp
+  if (pinput->GetOrAddInteger("ensemble", "nmember", 1) > 1) {
+    if (res_flag) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Ensembles cannot be restarted, restart each member "
+                << "separately" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    ChangeRunDir(run_dir);
+    Ensemble* pensemble = new Ensemble(pinput, wtlim, &timer);
+    StartupPhase(phase_timer, "ensemble setup");
+    if (startup_timing) {ReportStartupPhases();}
+    memory_tracker::Report("at startup");
+    pensemble->Execute();
+    pensemble->Finalize();
+    roofline::Report();
+    team_tuner::Finalize();
+    transient_pool::Finalize();
+    roofline::Finalize();
+    memory_tracker::Finalize();
+    delete pensemble;
+    delete pinput;
+    Kokkos::finalize();
+#if MPI_PARALLEL_ENABLED
+    MPI_Finalize();
+#endif
+    return(0);
+  }
+
+  // For new runs, look for a snapshot of the initial data written by an earlier run with
+  // the same input.  If found, it is read like a restart file instead of calling the
+  // problem generator, but the run otherwise starts as a new run.
+  std::string id_snapshot;
+  bool snap_flag = false;
+  if (!res_flag) {
+    snap_flag = ProblemGenerator::FindInitialDataSnapshot(pinput, id_snapshot);
+    if (snap_flag) {
+      restartfile.Open(id_snapshot.c_str(), IOWrapper::FileMode::read);
+      // skip parameters stored in snapshot, input file takes precedence
+      ParameterInput snap_pin;
+      snap_pin.LoadFromFile(restartfile);
+    }
+  }
 
   //--- Step 4. --------------------------------------------------------------------------
   // Construct Mesh.  Then build MeshBlockTree and add MeshBlockPack containing MeshBlocks
@@ -262,16 +377,17 @@ int main(int argc, char *argv[]) {
   // pointer to Mesh.
 
   Mesh* pmesh = new Mesh(pinput);
-  if (!res_flag) {
+  if (!res_flag && !snap_flag) {
     pmesh->BuildTreeFromScratch(pinput);
   } else {
     pmesh->BuildTreeFromRestart(pinput, restartfile);
   }
+  StartupPhase(phase_timer, "build MeshBlock tree");
 
   //  If code was run with -m option, write mesh structure to file and quit.
   if (marg_flag) {
     if (global_variable::my_rank == 0) {pmesh->WriteMeshStructure();}
-    if (res_flag) {restartfile.Close();}
+    if (res_flag || snap_flag) {restartfile.Close();}
     delete pmesh;
     delete pinput;
     Kokkos::finalize();
@@ -287,14 +403,19 @@ int main(int argc, char *argv[]) {
   // is fully constructed.
 
   pmesh->AddCoordinatesAndPhysics(pinput);
-  if (!res_flag) {
+  StartupPhase(phase_timer, "coordinates and physics");
+  if (!res_flag && !snap_flag) {
     // set ICs using ProblemGenerator constructor for new runs
     pmesh->pgen = std::make_unique<ProblemGenerator>(pinput, pmesh);
+    if (!id_snapshot.empty()) {
+      pmesh->pgen->WriteInitialDataSnapshot(pinput, id_snapshot);
+    }
   } else {
     // read ICs from restart file using ProblemGenerator constructor for restarts
     pmesh->pgen = std::make_unique<ProblemGenerator>(pinput, pmesh, restartfile);
     restartfile.Close();
   }
+  StartupPhase(phase_timer, "initial conditions");
 
   //--- Step 6. --------------------------------------------------------------------------
   // Construct Driver and Outputs. Actual outputs (including initial conditions) are made
@@ -303,6 +424,7 @@ int main(int argc, char *argv[]) {
   ChangeRunDir(run_dir);
   Driver* pdriver = new Driver(pinput, pmesh, wtlim, &timer);
   Outputs* pout = new Outputs(pinput, pmesh);
+  StartupPhase(phase_timer, "driver and outputs");
 
   //--- Step 7. --------------------------------------------------------------------------
   // Execute Driver.
@@ -311,13 +433,21 @@ int main(int argc, char *argv[]) {
   //    3. Any final analysis or diagnostics run in Driver::Finalize()
 
   pdriver->Initialize(pmesh, pinput, pout, res_flag);
+  StartupPhase(phase_timer, "driver initialize");
+  if (startup_timing) {ReportStartupPhases();}
+  memory_tracker::Report("at startup");
   pdriver->Execute(pmesh, pinput, pout);
   pdriver->Finalize(pmesh, pinput, pout);
+  roofline::Report();
 
   //--- Step 8. -------------------------------------------------------------------------
   // clean up, and terminate
   // Note anything containing a Kokkos::view must be deleted before Kokkos::finalize()
 
+  team_tuner::Finalize();
+  transient_pool::Finalize();
+  roofline::Finalize();
+  memory_tracker::Finalize();
   delete pout;
   delete pdriver;
   delete pmesh;
@@ -10,6 +10,7 @@
 #include <cinttypes>
 #include <limits> // numeric_limits<>
 #include <memory> // make_unique<>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -264,11 +265,17 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
   pmb_pack = new MeshBlockPack(this, mbp_gids, mbp_gide);
   nmb_packs_thisrank = 1;
   pmb_pack->AddMeshBlocks(pin);
-  pmb_pack->pmb->SetNeighbors(ptree, rank_eachmb);
+  plintree = std::make_unique<LinearMeshTree>(this);
+  plintree->Build(lloc_eachmb, nmb_total);
+  pmb_pack->pmb->SetNeighbors(plintree, rank_eachmb);
 
-  // Fix maximum number of MeshBlocks per rank with AMR
+  // Fix maximum number of MeshBlocks per rank with AMR.  If only a memory budget is
+  // given, arrays are first sized for the root grid, and nmb_maxperrank is set from the
+  // memory used per MeshBlock in AddCoordinatesAndPhysics()
   nmb_maxperrank = nmb_thisrank;
+  max_mem_fraction = 0.0;
   if (adaptive) {
+    max_mem_fraction = pin->GetOrAddReal("mesh_refinement", "max_mem_fraction", 0.0);
     if (pin->DoesParameterExist("mesh_refinement", "max_nmb_per_rank")) {
       nmb_maxperrank = pin->GetReal("mesh_refinement", "max_nmb_per_rank");
       if (nmb_maxperrank < nmb_thisrank) {
@@ -278,10 +285,11 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
           << "<mesh_refinement>/max_nmb_per_rank=" << nmb_maxperrank << std::endl;
         std::exit(EXIT_FAILURE);
       }
-    } else {
+    } else if (max_mem_fraction <= 0.0) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
         << std::endl << "With AMR maximum number of MeshBlocks per rank must be "
-        << "specified in input file using <mesh_refinement>/max_nmb_per_rank"
+        << "specified in input file using <mesh_refinement>/max_nmb_per_rank, or "
+        << "derived from a fraction of device memory <mesh_refinement>/max_mem_fraction"
         << std::endl;
       std::exit(EXIT_FAILURE);
     }
@@ -425,9 +433,11 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile) {
   for (int i=0; i<nmb_total; i++) {ptree->AddNodeWithoutRefinement(lloc_eachmb[i]);}
 
   // check the tree structure by making sure total # of MBs counted in tree same as the
-  // number read from the restart file.
+  // number read from the restart file, and MBs are in the same order as in the file
+  // (which is not the case if <loadbalancing>/curve was changed on restart).
   {
     int nnb;
+    std::vector<LogicalLocation> file_lloc(lloc_eachmb, lloc_eachmb + nmb_total);
     ptree->CreateZOrderedLLList(lloc_eachmb, nullptr, nnb);
     if (nnb != nmb_total) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
@@ -435,6 +445,18 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile) {
         << "reconstructed tree=" << nnb << ", number in file=" << nmb_total << std::endl;
       std::exit(EXIT_FAILURE);
     }
+    for (int i=0; i<nmb_total; i++) {
+      if (lloc_eachmb[i].level != file_lloc[i].level ||
+          lloc_eachmb[i].lx1 != file_lloc[i].lx1 ||
+          lloc_eachmb[i].lx2 != file_lloc[i].lx2 ||
+          lloc_eachmb[i].lx3 != file_lloc[i].lx3) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Order of MeshBlocks in reconstructed tree differs from order "
+          << "in restart file. Use the same <loadbalancing>/curve as the run that wrote "
+          << "the restart file." << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
   }
 
 #ifdef MPI_PARALLEL_ENABLED
@@ -456,11 +478,17 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile) {
 
   pmb_pack = new MeshBlockPack(this, mbp_gids, mbp_gide);
   pmb_pack->AddMeshBlocks(pin);
-  pmb_pack->pmb->SetNeighbors(ptree, rank_eachmb);
+  plintree = std::make_unique<LinearMeshTree>(this);
+  plintree->Build(lloc_eachmb, nmb_total);
+  pmb_pack->pmb->SetNeighbors(plintree, rank_eachmb);
 
-  // Fix maximum number of MeshBlocks per rank with AMR
+  // Fix maximum number of MeshBlocks per rank with AMR.  If only a memory budget is
+  // given, arrays are first sized for the root grid, and nmb_maxperrank is set from the
+  // memory used per MeshBlock in AddCoordinatesAndPhysics()
   nmb_maxperrank = nmb_thisrank;
+  max_mem_fraction = 0.0;
   if (adaptive) {
+    max_mem_fraction = pin->GetOrAddReal("mesh_refinement", "max_mem_fraction", 0.0);
     if (pin->DoesParameterExist("mesh_refinement", "max_nmb_per_rank")) {
       nmb_maxperrank = pin->GetReal("mesh_refinement", "max_nmb_per_rank");
       if (nmb_maxperrank < nmb_thisrank) {
@@ -470,10 +498,11 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile) {
           << "<mesh_refinement>/max_nmb_per_rank=" << nmb_maxperrank << std::endl;
         std::exit(EXIT_FAILURE);
       }
-    } else {
+    } else if (max_mem_fraction <= 0.0) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
         << std::endl << "With AMR maximum number of MeshBlocks per rank must be "
-        << "specified in input file using <mesh_refinement>/max_nmb_per_rank"
+        << "specified in input file using <mesh_refinement>/max_nmb_per_rank, or "
+        << "derived from a fraction of device memory <mesh_refinement>/max_mem_fraction"
         << std::endl;
       std::exit(EXIT_FAILURE);
     }
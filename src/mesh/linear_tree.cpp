@@ -0,0 +1,200 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file linear_tree.cpp
+//  \brief implementation of constructor and functions in the LinearMeshTree class
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <numeric>  // iota
+#include <vector>
+
+#include "athena.hpp"
+#include "mesh.hpp"
+#include "linear_tree.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn LinearMeshTree::LinearMeshTree()
+//! \brief constructor, tree is empty until Build() is called
+
+LinearMeshTree::LinearMeshTree(Mesh *pmesh) :
+  pmesh_(pmesh), nmb_(0), depth_(0) {
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool LinearMeshTree::MortonLess()
+//! \brief compares two keys along the Morton curve without forming the interleaved key,
+//! by comparing the coordinate whose bits differ at the most significant position.  Ties
+//! in that position are broken in the order x3,x2,x1, matching the ordering of leafs
+//! (ox1 + 2*ox2 + 4*ox3) in the MeshBlockTree.
+
+bool LinearMeshTree::MortonLess(const Key &a, const Key &b) {
+  auto less_msb = [](std::uint32_t x, std::uint32_t y) {return (x < y && x < (x ^ y));};
+  std::uint32_t d3 = a.x3 ^ b.x3, d2 = a.x2 ^ b.x2, d1 = a.x1 ^ b.x1;
+  if (less_msb(d3, d2)) {
+    if (less_msb(d2, d1)) {return a.x1 < b.x1;}
+    return a.x2 < b.x2;
+  }
+  if (less_msb(d3, d1)) {return a.x1 < b.x1;}
+  return a.x3 < b.x3;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LinearMeshTree::Build()
+//! \brief builds the sorted array of leafs from the list of LogicalLocations of all
+//! MeshBlocks (indexed by GID).  Keys are computed in parallel on the host.  When
+//! MeshBlocks are ordered along the Z-order curve the GID order is already the Morton
+//! order and no sort is needed.
+
+void LinearMeshTree::Build(const LogicalLocation *lloc_list, int nmb) {
+  nmb_ = nmb;
+  using HostRange = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>;
+  int maxlev = 0;
+  Kokkos::parallel_reduce("LinTreeDepth", HostRange(0, nmb),
+  [&](const int n, int &lmax) {
+    lmax = std::max(lmax, static_cast<int>(lloc_list[n].level));
+  }, Kokkos::Max<int>(maxlev));
+  depth_ = maxlev;
+
+  key_.resize(nmb);
+  gid_.resize(nmb);
+  lloc_.resize(nmb);
+  Kokkos::parallel_for("LinTreeKeys", HostRange(0, nmb),
+  [&](const int n) {
+    key_[n] = MakeKey(lloc_list[n]);
+    gid_[n] = n;
+    lloc_[n] = lloc_list[n];
+  });
+
+  if (!std::is_sorted(key_.begin(), key_.end(), MortonLess)) {
+    std::vector<int> perm(nmb);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::sort(perm.begin(), perm.end(),
+              [this](int a, int b) {return MortonLess(key_[a], key_[b]);});
+    std::vector<Key> sorted_key(nmb);
+    Kokkos::parallel_for("LinTreeSort", HostRange(0, nmb),
+    [&](const int n) {
+      sorted_key[n] = key_[perm[n]];
+      gid_[n] = perm[n];
+      lloc_[n] = lloc_list[perm[n]];
+    });
+    key_.swap(sorted_key);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int LinearMeshTree::FindLeaf()
+//! \brief returns index of the leaf that either contains the node tloc or is contained
+//! within it (if tloc has been refined), or -1 if tloc lies outside the Mesh
+
+int LinearMeshTree::FindLeaf(const LogicalLocation &tloc) const {
+  if (tloc.level > depth_) {return -1;}
+  auto it = std::upper_bound(key_.begin(), key_.end(), MakeKey(tloc), MortonLess);
+  if (it == key_.begin()) {return -1;}
+  int n = static_cast<int>(it - key_.begin()) - 1;
+
+  const LogicalLocation &leaf = lloc_[n];
+  if (leaf.level <= tloc.level) {
+    int sh = tloc.level - leaf.level;
+    if ((tloc.lx1 >> sh) == leaf.lx1 && (tloc.lx2 >> sh) == leaf.lx2 &&
+        (tloc.lx3 >> sh) == leaf.lx3) {return n;}
+  } else {
+    int sh = leaf.level - tloc.level;
+    if ((leaf.lx1 >> sh) == tloc.lx1 && (leaf.lx2 >> sh) == tloc.lx2 &&
+        (leaf.lx3 >> sh) == tloc.lx3) {return n;}
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int LinearMeshTree::FindMeshBlock(LogicalLocation tloc)
+//! \brief returns GID of MeshBlock with LogicalLocation tloc, or -1 if it does not exist
+
+int LinearMeshTree::FindMeshBlock(LogicalLocation tloc) const {
+  int n = FindLeaf(tloc);
+  if (n < 0 || lloc_[n].level != tloc.level) {return -1;}
+  return gid_[n];
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn LinearTreeNode LinearMeshTree::FindNeighbor()
+//! \brief find the neighbor offset by (ox1,ox2,ox3) from myloc, with the same conventions
+//! as MeshBlockTree::FindNeighbor(): if it is a coarser or same level leaf, return it,
+//! and if it is refined, return the node at the same level as myloc (whose leafs are
+//! found with GetLeaf()).  Boundary conditions are applied for offsets outside the Mesh.
+
+LinearTreeNode LinearMeshTree::FindNeighbor(LogicalLocation myloc,
+                                            int ox1, int ox2, int ox3) const {
+  LinearTreeNode node;
+  std::int32_t lx = myloc.lx1 + ox1, ly = myloc.lx2 + ox2, lz = myloc.lx3 + ox3;
+  int ll = myloc.level;
+  Mesh *pm = pmesh_;
+
+  std::int32_t num_x1 = pm->nmb_rootx1<<(ll - pm->root_level);
+  if (lx < 0 || lx >= num_x1) {
+    BoundaryFace f = (lx < 0)? BoundaryFace::inner_x1 : BoundaryFace::outer_x1;
+    if (pm->mesh_bcs[f] == BoundaryFlag::periodic ||
+        pm->mesh_bcs[f] == BoundaryFlag::shear_periodic) {
+      lx = (lx < 0)? num_x1 - 1 : 0;
+    } else {
+      return node;
+    }
+  }
+  std::int32_t num_x2 = pm->nmb_rootx2<<(ll - pm->root_level);
+  if (ly < 0 || ly >= num_x2) {
+    BoundaryFace f = (ly < 0)? BoundaryFace::inner_x2 : BoundaryFace::outer_x2;
+    if (pm->mesh_bcs[f] == BoundaryFlag::periodic) {
+      ly = (ly < 0)? num_x2 - 1 : 0;
+    } else {
+      return node;
+    }
+  }
+  std::int32_t num_x3 = pm->nmb_rootx3<<(ll - pm->root_level);
+  if (lz < 0 || lz >= num_x3) {
+    BoundaryFace f = (lz < 0)? BoundaryFace::inner_x3 : BoundaryFace::outer_x3;
+    if (pm->mesh_bcs[f] == BoundaryFlag::periodic) {
+      lz = (lz < 0)? num_x3 - 1 : 0;
+    } else {
+      return node;
+    }
+  }
+
+  node.lloc = LogicalLocation{lx, ly, lz, ll};
+  int n = FindLeaf(node.lloc);
+  if (n < 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Neighbor search failed; LinearMeshTree broken." << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (lloc_[n].level > ll) {
+    node.refined = true;
+  } else {
+    node.gid = gid_[n];
+    node.lloc = lloc_[n];
+  }
+  return node;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn LinearTreeNode LinearMeshTree::GetLeaf()
+//! \brief returns leaf (ox1,ox2,ox3) one level finer than a refined node
+
+LinearTreeNode LinearMeshTree::GetLeaf(const LinearTreeNode &node,
+                                       int ox1, int ox2, int ox3) const {
+  LinearTreeNode leaf;
+  LogicalLocation tloc{(node.lloc.lx1<<1) + ox1, (node.lloc.lx2<<1) + ox2,
+                       (node.lloc.lx3<<1) + ox3, node.lloc.level + 1};
+  int n = FindLeaf(tloc);
+  if (n < 0 || lloc_[n].level != tloc.level) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Neighbor search failed; LinearMeshTree broken." << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  leaf.gid = gid_[n];
+  leaf.lloc = lloc_[n];
+  return leaf;
+}
@@ -0,0 +1,70 @@
+#ifndef MESH_LINEAR_TREE_HPP_
+#define MESH_LINEAR_TREE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file linear_tree.hpp
+//  \brief defines the LinearMeshTree class
+// The LinearMeshTree stores only the leafs (MeshBlocks) of the MeshBlockTree, as an array
+// sorted along the Morton (Z-order) curve by the location of the first cell of each leaf
+// at the finest level in the Mesh.  Since leafs do not overlap, the leaf containing any
+// location is found with a binary search, so that neighbor searches cost O(log nmb)
+// without pointer chasing through the tree.  It is rebuilt from lloc_eachmb (in parallel
+// on the host) each time the Mesh changes, while the pointer-based MeshBlockTree is still
+// used to refine/derefine the Mesh and to order MeshBlocks along the curve.
+
+#include <cstdint>  // uint32_t
+#include <vector>
+
+//----------------------------------------------------------------------------------------
+//! \struct LinearTreeNode
+//! \brief node returned by searches of LinearMeshTree.  If the node is a leaf, gid is the
+//! GID of the MeshBlock.  If the node has been refined, gid=-1 and its leafs are returned
+//! by GetLeaf().  Nodes outside the Mesh have gid=-1 and refined=false.
+
+struct LinearTreeNode {
+  int gid = -1;
+  bool refined = false;
+  LogicalLocation lloc;
+  bool Exists() const {return (gid >= 0 || refined);}
+};
+
+//----------------------------------------------------------------------------------------
+//! \class LinearMeshTree
+
+class LinearMeshTree {
+ public:
+  explicit LinearMeshTree(Mesh *pmesh);
+  ~LinearMeshTree() = default;
+
+  // functions
+  void Build(const LogicalLocation *lloc_list, int nmb);
+  int FindMeshBlock(LogicalLocation tloc) const;
+  LinearTreeNode FindNeighbor(LogicalLocation myloc, int ox1, int ox2, int ox3) const;
+  LinearTreeNode GetLeaf(const LinearTreeNode &node, int ox1, int ox2, int ox3) const;
+
+ private:
+  // location of first cell of a node at finest level, used as key in binary searches
+  struct Key {
+    std::uint32_t x1, x2, x3;
+  };
+  Mesh *pmesh_;
+  int nmb_;                           // number of leafs
+  int depth_;                         // finest level of leafs in tree
+  std::vector<Key> key_;              // keys of leafs, sorted along Morton curve
+  std::vector<int> gid_;              // GIDs of leafs, in same order as keys
+  std::vector<LogicalLocation> lloc_; // LogicalLocations of leafs, in same order as keys
+
+  Key MakeKey(const LogicalLocation &lloc) const {
+    int sh = depth_ - lloc.level;
+    return Key{static_cast<std::uint32_t>(lloc.lx1) << sh,
+               static_cast<std::uint32_t>(lloc.lx2) << sh,
+               static_cast<std::uint32_t>(lloc.lx3) << sh};
+  }
+  static bool MortonLess(const Key &a, const Key &b);
+  int FindLeaf(const LogicalLocation &tloc) const;
+};
+
+#endif // MESH_LINEAR_TREE_HPP_
@@ -11,6 +11,7 @@
 #include <limits> // numeric_limits<>
 #include <algorithm> // max
 #include <utility> // make_pair
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -18,11 +19,52 @@
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "z4c/z4c.hpp"
+#include "bvals/bvals.hpp"
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
 #endif
 
+//----------------------------------------------------------------------------------------
+//! \fn void PartitionByCost()
+//! \brief Cuts MBs [ib,ie] of the cost list into contiguous ranges assigned to parts
+//! [pb,pe], so the cost of each part is proportional to its weight in wlist (all weights
+//! are one if wlist=nullptr).  Parts are filled from the end, so part pb has less load.
+//! Returns the part of each MB in plist.
+
+namespace {
+void PartitionByCost(const float *clist, int ib, int ie, const float *wlist, int pb,
+                     int pe, int *plist) {
+  auto weight = [wlist](int p) {return (wlist == nullptr)? 1.0f : wlist[p];};
+  float totalcost = 0.0;
+  float totalwgt = 0.0;
+  for (int i=ib; i<=ie; i++) {totalcost += clist[i];}
+  for (int p=pb; p<=pe; p++) {totalwgt += weight(p);}
+
+  int j = pe;
+  float targetcost = totalcost*weight(j)/totalwgt;
+  float mycost = 0.0;
+  for (int i=ie; i>=ib; i--) {
+    if (targetcost == 0.0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "There is at least one process which has no MeshBlock"
+                << std::endl << "Decrease the number of processes or use smaller "
+                << "MeshBlocks." << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    mycost += clist[i];
+    plist[i] = j;
+    if (mycost >= targetcost && j>pb) {
+      totalcost -= mycost;
+      totalwgt -= weight(j);
+      j--;
+      mycost = 0.0;
+      targetcost = totalcost*weight(j)/totalwgt;
+    }
+  }
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 //! \fn void Mesh::LoadBalance(double *clist, int *rlist, int *slist, int *nlist, int nb)
 //! \brief Calculate distribution of MeshBlocks across ranks based on input cost list
@@ -33,40 +75,76 @@
 //!         nlist = number of MBs on each rank (array of length nrank)
 //! With multiple ranks in MPI, this function is needed even on a uniform mesh and not
 //! just for SMR/AMR, which is why it is part of the Mesh and not MeshRefinement class.
+//! If <loadbalancing>/node_aware=true, MBs are first divided between compute nodes (in
+//! proportion to number of ranks on each), then between the ranks within each node, so
+//! MBs neighboring along the space-filling curve tend to share a node.
+//! The cost given to each rank is proportional to its speed in speed_eachrank (all ones
+//! unless measured with <loadbalancing>/rank_speed=true), and to each node to the sum of
+//! the speeds of its ranks.
 
 void Mesh::LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb) {
   float min_cost = std::numeric_limits<float>::max();
-  float max_cost = 0.0, totalcost = 0.0;
-  // find min/max and total cost in clist
+  float max_cost = 0.0;
+  // find min/max cost in clist
   for (int i=0; i<nb; i++) {
-    totalcost += clist[i];
     min_cost = std::min(min_cost,clist[i]);
     max_cost = std::max(max_cost,clist[i]);
   }
 
-  int j = (global_variable::nranks) - 1;
-  float targetcost = totalcost/global_variable::nranks;
-  float mycost = 0.0;
-  // create rank list from the end: the master MPI rank should have less load
-  for (int i=nb-1; i>=0; i--) {
-    if (targetcost == 0.0) {
-      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "There is at least one process which has no MeshBlock"
-                << std::endl << "Decrease the number of processes or use smaller "
-                << "MeshBlocks." << std::endl;
-      std::exit(EXIT_FAILURE);
+  // two-level partition requires the ranks on each node to be contiguous.  Fallbacks are
+  // reported only the first time they occur, not on every call with AMR.
+  static bool warned_few_mbs = false, warned_noncontiguous = false;
+  bool two_level = (node_aware_lb && nnodes > 1);
+  for (int r=1; r<global_variable::nranks && two_level; r++) {
+    if (node_eachrank[r] < node_eachrank[r-1]) {two_level = false;}
+  }
+  if (two_level) {
+    std::vector<int> nrank_eachnode(nnodes, 0), rank0_eachnode(nnodes, -1);
+    std::vector<float> speed_eachnode(nnodes, 0.0);
+    for (int r=0; r<global_variable::nranks; r++) {
+      int node = node_eachrank[r];
+      nrank_eachnode[node]++;
+      speed_eachnode[node] += speed_eachrank[r];
+      if (rank0_eachnode[node] < 0) {rank0_eachnode[node] = r;}
     }
-    mycost += clist[i];
-    rlist[i] = j;
-    if (mycost >= targetcost && j>0) {
-      j--;
-      totalcost -= mycost;
-      mycost = 0.0;
-      targetcost = totalcost/(j+1);
+    // divide MBs between nodes, then MBs on each node between its ranks
+    std::vector<int> node_eachmb(nb);
+    PartitionByCost(clist, 0, nb-1, speed_eachnode.data(), 0, nnodes-1,
+                    node_eachmb.data());
+    int ib = 0;
+    for (int node=0; node<nnodes && two_level; node++) {
+      int ie = ib;
+      while (ie < nb && node_eachmb[ie] == node) {ie++;}
+      if ((ie - ib) < nrank_eachnode[node]) {
+        two_level = false;
+      } else {
+        int r0 = rank0_eachnode[node];
+        PartitionByCost(clist, ib, ie-1, speed_eachrank.data(), r0,
+                        r0+nrank_eachnode[node]-1, rlist);
+      }
+      ib = ie;
+    }
+    if (!(two_level) && !(warned_few_mbs) && global_variable::my_rank == 0) {
+      warned_few_mbs = true;
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Too few MeshBlocks for node-aware load balancing, using "
+                << "single-level partition" << std::endl;
     }
+  } else if (node_aware_lb && nnodes > 1 && !(warned_noncontiguous) &&
+             global_variable::my_rank == 0) {
+    warned_noncontiguous = true;
+    std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Ranks on each node are not contiguous, node-aware load balancing "
+              << "disabled" << std::endl;
   }
+  // create rank list from the end: the master MPI rank should have less load
+  if (!(two_level)) {
+    PartitionByCost(clist, 0, nb-1, speed_eachrank.data(), 0, (global_variable::nranks)-1,
+                    rlist);
+  }
+
   slist[0] = 0;
-  j = 0;
+  int j = 0;
   for (int i=1; i<nb; i++) { // make the list of nbstart and nblocks
     if (rlist[i] != rlist[i-1]) {
       nlist[j] = i-slist[j];
@@ -86,6 +164,79 @@ void Mesh::LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb)
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn bool MeshRefinement::IncrementalLoadBalance()
+//! \brief Calculates distribution of new MeshBlocks across ranks (arguments as in
+//! Mesh::LoadBalance) starting from the old distribution mapped onto the new gids, by
+//! repeatedly moving single MBs across the boundary between neighboring ranks from the
+//! more to the less loaded rank, until the largest cost on any rank (divided by its speed
+//! in Mesh::speed_eachrank) is within <loadbalancing>/tolerance of the mean.  Thus the
+//! number of MBs that change rank is proportional to the change in the mesh rather than
+//! to its size.  Returns false if this fails, in which case Mesh::LoadBalance() should be
+//! used instead.
+//! Must be called in RedistAndRefineMeshBlocks() after oldtonew is set, and before
+//! gids_eachrank is updated.
+
+bool MeshRefinement::IncrementalLoadBalance(float *clist, int *rlist, int *slist,
+                                            int *nlist, int nb) {
+  int nranks = global_variable::nranks;
+  if (nb < nranks) {return false;}
+
+  // starting gid on each rank from that of old distribution
+  slist[0] = 0;
+  for (int r=1; r<nranks; r++) {
+    slist[r] = oldtonew[pmy_mesh->gids_eachrank[r]];
+    slist[r] = std::min(std::max(slist[r], slist[r-1] + 1), nb - (nranks - r));
+  }
+  auto end = [&](int r) {return ((r < nranks-1)? slist[r+1] : nb);};
+  auto &speed = pmy_mesh->speed_eachrank;
+  std::vector<float> cost(nranks, 0.0);
+  float totalcost = 0.0, totalspeed = 0.0;
+  for (int r=0; r<nranks; r++) {
+    for (int i=slist[r]; i<end(r); i++) {cost[r] += clist[i];}
+    totalcost += cost[r];
+    totalspeed += speed[r];
+  }
+  // largest time (cost/speed) on any rank, and maximum allowed time
+  auto maxtime = [&]() {
+    float t = 0.0;
+    for (int r=0; r<nranks; r++) {t = std::max(t, cost[r]/speed[r]);}
+    return t;
+  };
+  float tmax = (1.0 + lb_tolerance)*totalcost/totalspeed;
+
+  // Each move reduces the larger time of two neighboring ranks, so iteration
+  // terminates.  Loads diffuse across at most one rank per iteration.
+  for (int iter=0; iter<nb; iter++) {
+    if (maxtime() <= tmax) {break;}
+    bool moved = false;
+    for (int r=0; r<nranks-1; r++) {
+      int b = slist[r+1];
+      if ((cost[r+1] + clist[b-1])/speed[r+1] < cost[r]/speed[r] && (b-1) > slist[r]) {
+        slist[r+1]--;
+        cost[r] -= clist[b-1];
+        cost[r+1] += clist[b-1];
+        moved = true;
+      } else if ((cost[r] + clist[b])/speed[r] < cost[r+1]/speed[r+1] &&
+                 (b+1) < end(r+1)) {
+        slist[r+1]++;
+        cost[r] += clist[b];
+        cost[r+1] -= clist[b];
+        moved = true;
+      }
+    }
+    if (!(moved)) {break;}
+  }
+  if (maxtime() > tmax) {return false;}
+
+  for (int r=0; r<nranks; r++) {
+    nlist[r] = end(r) - slist[r];
+    if (nlist[r] > pmy_mesh->nmb_maxperrank) {return false;}
+    for (int i=slist[r]; i<end(r); i++) {rlist[i] = r;}
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::InitRecvAMR()
 //! \brief Allocates and initializes receive buffers, and posts non-blocking receives,
@@ -124,6 +275,7 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
       }
     }
   }
+  prtcl_recvs.clear();
   if (nmb_recv == 0) return;  // nothing to do
 
   // allocate array of recv buffers
@@ -253,13 +405,16 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
       }
     }
   }
-  // Sync dual array, reallocate receive data array
+  // Sync dual array, reserve space in receive data array
   recvbuf.template modify<HostMemSpace>();
   recvbuf.template sync<DevExeSpace>();
   {
     int ndata = recvbuf.h_view((nmb_recv-1)).offset + recvbuf.h_view((nmb_recv-1)).cnt;
-    Kokkos::realloc(recv_data, ndata);
+    ReserveAMRData(recv_data, ndata);
+    if (pmy_mesh->mpi_host_staging) {ReserveAMRData(recv_data_h, ndata);}
   }
+  // receive into host copy of data if MPI messages are staged through host
+  Real *recv_ptr = (pmy_mesh->mpi_host_staging)? recv_data_h.data() : recv_data.data();
 
   // Step 3. (InitRecvAMR)
   // loop over new MBs on this rank, post non-blocking recvs
@@ -280,30 +435,32 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
           int ox2 = ((lloc.lx2 & 1) == 1);
           int ox3 = ((lloc.lx3 & 1) == 1);
           int vs = recvbuf.h_view(rb_idx).offset;
-          int ve = vs + recvbuf.h_view(rb_idx).cnt + 1;
-          auto pdata = Kokkos::subview(recv_data, std::make_pair(vs,ve));
+          Real *pdata = recv_ptr + vs;
           // create tag using local ID of *receiving* MeshBlock, post receive
           int tag = CreateAMR_MPI_Tag(newm-nmbs, ox1, ox2, ox3);
           // post non-blocking receive
-          int ierr = MPI_Irecv(pdata.data(), recvbuf.h_view(rb_idx).cnt,
+          int ierr = MPI_Irecv(pdata, recvbuf.h_view(rb_idx).cnt,
                      MPI_ATHENA_REAL, pmy_mesh->rank_eachmb[oldm+l], tag, amr_comm,
                      &(recv_req[rb_idx]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          prtcl_recvs.emplace_back(pmy_mesh->rank_eachmb[oldm+l],
+                                   global_variable::my_rank, 0, tag, newm);
           rb_idx++;
         }
       }
     } else if (old_lloc.level == new_lloc.level) {   // old MB at same level
       if (pmy_mesh->rank_eachmb[oldm] != global_variable::my_rank) {
         int vs = recvbuf.h_view(rb_idx).offset;
-        int ve = vs + recvbuf.h_view(rb_idx).cnt + 1;
-        auto pdata = Kokkos::subview(recv_data, std::make_pair(vs,ve));
+        Real *pdata = recv_ptr + vs;
         // create tag using local ID of *receiving* MeshBlock, post receive
         int tag = CreateAMR_MPI_Tag(newm-nmbs, 0, 0, 0);
         // post non-blocking receive
-        int ierr = MPI_Irecv(pdata.data(), recvbuf.h_view(rb_idx).cnt, MPI_ATHENA_REAL,
+        int ierr = MPI_Irecv(pdata, recvbuf.h_view(rb_idx).cnt, MPI_ATHENA_REAL,
                    pmy_mesh->rank_eachmb[oldm], tag, amr_comm,
                    &(recv_req[rb_idx]));
         if (ierr != MPI_SUCCESS) {no_errors=false;}
+        prtcl_recvs.emplace_back(pmy_mesh->rank_eachmb[oldm], global_variable::my_rank,
+                                 0, tag, newm);
         rb_idx++;
       }
     } else {                                        // old MB was refined
@@ -311,15 +468,16 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
       if ((new_rank_eachmb[oldtonew[oldm]] != global_variable::my_rank) ||
           (pmy_mesh->rank_eachmb[oldm] != global_variable::my_rank)) {
         int vs = recvbuf.h_view(rb_idx).offset;
-        int ve = vs + recvbuf.h_view(rb_idx).cnt + 1;
-        auto pdata = Kokkos::subview(recv_data, std::make_pair(vs,ve));
+        Real *pdata = recv_ptr + vs;
         // create tag using local ID of *receiving* MeshBlock, post receive
         int tag = CreateAMR_MPI_Tag(newm-nmbs, 0, 0, 0);
         // post non-blocking receive
-        int ierr = MPI_Irecv(pdata.data(), recvbuf.h_view(rb_idx).cnt, MPI_ATHENA_REAL,
+        int ierr = MPI_Irecv(pdata, recvbuf.h_view(rb_idx).cnt, MPI_ATHENA_REAL,
                    pmy_mesh->rank_eachmb[oldm], tag, amr_comm,
                    &(recv_req[rb_idx]));
         if (ierr != MPI_SUCCESS) {no_errors=false;}
+        prtcl_recvs.emplace_back(pmy_mesh->rank_eachmb[oldm], global_variable::my_rank,
+                                 0, tag, newm);
         rb_idx++;
       }
     }
@@ -374,6 +532,7 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
     }
   }
 
+  prtcl_sends.clear();
   if (nmb_send == 0) return;  // nothing to do
 
   // allocate array of send buffers
@@ -505,13 +664,12 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
       }
     }
   }
-  // Sync dual array, reallocate send data array
+  // Sync dual array, reserve space in send data array
   sendbuf.template modify<HostMemSpace>();
   sendbuf.template sync<DevExeSpace>();
-  {
-    int ndata = sendbuf.h_view((nmb_send-1)).offset + sendbuf.h_view((nmb_send-1)).cnt;
-    Kokkos::realloc(send_data, ndata);
-  }
+  int ndata = sendbuf.h_view((nmb_send-1)).offset + sendbuf.h_view((nmb_send-1)).cnt;
+  ReserveAMRData(send_data, ndata);
+  if (pmy_mesh->mpi_host_staging) {ReserveAMRData(send_data_h, ndata);}
 
   // Step 3. (PackAndSendAMR)
   // Pack data into send buffers in parallel
@@ -538,6 +696,14 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
   // Step 4. (PackAndSendAMR)
   // loop over old MBs on this rank, send data using MPI non-blocking sends
   // Send requests will only be accessed on host, so no need to sync after this step.
+  // If MPI messages are staged through host, first copy packed data to host.
+  Real *send_ptr = send_data.data();
+  if (pmy_mesh->mpi_host_staging) {
+    auto range = std::make_pair(0, ndata);
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(send_data_h, range),
+                      Kokkos::subview(send_data, range));
+    send_ptr = send_data_h.data();
+  }
   Kokkos::fence();
   bool no_errors=true;
   sb_idx = 0;     // send buffer index
@@ -551,16 +717,17 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
         if ((new_rank_eachmb[newm] != global_variable::my_rank) ||
             (new_rank_eachmb[newm + l] != global_variable::my_rank)) {
           int vs = sendbuf.h_view(sb_idx).offset;
-          int ve = vs + sendbuf.h_view(sb_idx).cnt + 1;
-          auto pdata = Kokkos::subview(send_data, std::make_pair(vs,ve));
+          Real *pdata = send_ptr + vs;
           // create tag using local ID of *receiving* MeshBlock
           int lid = (newm + l) - new_gids_eachrank[new_rank_eachmb[newm+l]];
           int tag = CreateAMR_MPI_Tag(lid, 0, 0, 0);
           // post non-blocking send
-          int ierr = MPI_Isend(pdata.data(), sendbuf.h_view(sb_idx).cnt, MPI_ATHENA_REAL,
+          int ierr = MPI_Isend(pdata, sendbuf.h_view(sb_idx).cnt, MPI_ATHENA_REAL,
                      new_rank_eachmb[newm+l], tag, amr_comm,
                      &(send_req[sb_idx]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          prtcl_sends.emplace_back(global_variable::my_rank, new_rank_eachmb[newm+l], 0,
+                                   tag, newm+l);
           sb_idx++;
         }
       }
@@ -568,16 +735,17 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
       if (old_lloc.level == new_lloc.level) {   // old MB at same level
         if (new_rank_eachmb[newm] != global_variable::my_rank) {
           int vs = sendbuf.h_view(sb_idx).offset;
-          int ve = vs + sendbuf.h_view(sb_idx).cnt + 1;
-          auto pdata = Kokkos::subview(send_data, std::make_pair(vs,ve));
+          Real *pdata = send_ptr + vs;
           // create tag using local ID of *receiving* MeshBlock
           int lid = newm - new_gids_eachrank[new_rank_eachmb[newm]];
           int tag = CreateAMR_MPI_Tag(lid, 0, 0, 0);
           // post non-blocking send
-          int ierr = MPI_Isend(pdata.data(), sendbuf.h_view(sb_idx).cnt, MPI_ATHENA_REAL,
+          int ierr = MPI_Isend(pdata, sendbuf.h_view(sb_idx).cnt, MPI_ATHENA_REAL,
                      new_rank_eachmb[newm], tag, amr_comm,
                      &(send_req[sb_idx]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          prtcl_sends.emplace_back(global_variable::my_rank, new_rank_eachmb[newm], 0,
+                                   tag, newm);
           sb_idx++;
         }
       } else {                                  // old MB was de-refined
@@ -585,8 +753,7 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
         if ((pmy_mesh->rank_eachmb[newtoold[newm]] != global_variable::my_rank) ||
             (new_rank_eachmb[newm] != global_variable::my_rank)) {
           int vs = sendbuf.h_view(sb_idx).offset;
-          int ve = vs + sendbuf.h_view(sb_idx).cnt + 1;
-          auto pdata = Kokkos::subview(send_data, std::make_pair(vs,ve));
+          Real *pdata = send_ptr + vs;
           // create tag using local ID of *receiving* MeshBlock
           int ox1 = ((old_lloc.lx1 & 1) == 1);
           int ox2 = ((old_lloc.lx2 & 1) == 1);
@@ -594,10 +761,12 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
           int lid = newm - new_gids_eachrank[new_rank_eachmb[newm]];
           int tag = CreateAMR_MPI_Tag(lid, ox1, ox2, ox3);
           // post non-blocking send
-          int ierr = MPI_Isend(pdata.data(), sendbuf.h_view(sb_idx).cnt, MPI_ATHENA_REAL,
+          int ierr = MPI_Isend(pdata, sendbuf.h_view(sb_idx).cnt, MPI_ATHENA_REAL,
                      new_rank_eachmb[newm], tag, amr_comm,
                      &(send_req[sb_idx]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          prtcl_sends.emplace_back(global_variable::my_rank, new_rank_eachmb[newm], 0,
+                                   tag, newm);
           sb_idx++;
         }
       }
@@ -797,6 +966,12 @@ void MeshRefinement::ClearRecvAndUnpackAMR() {
     std::exit(EXIT_FAILURE);
   }
   delete [] recv_req;
+  if (pmy_mesh->mpi_host_staging) {
+    auto range = std::make_pair(0, recvbuf.h_view((nmb_recv-1)).offset +
+                                   recvbuf.h_view((nmb_recv-1)).cnt);
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(recv_data, range),
+                      Kokkos::subview(recv_data_h, range));
+  }
 
   // Unpack data
   hydro::Hydro* phydro = pmy_mesh->pmb_pack->phydro;
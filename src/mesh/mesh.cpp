@@ -28,6 +28,7 @@
 #include "particles/particles.hpp"
 #include "srcterms/srcterms.hpp"
 #include "outputs/io_wrapper.hpp"
+#include "utils/memory_tracker.hpp"
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
@@ -48,6 +49,7 @@ Mesh::Mesh(ParameterInput *pin) :
   three_d(false),
   multi_d(false),
   strictly_periodic(true),
+  ngeneration(0),
   nmb_packs_thisrank(1),
   nprtcl_thisrank(0),
   nprtcl_total(0),
@@ -175,6 +177,67 @@ Mesh::Mesh(ParameterInput *pin) :
   multilevel = (adaptive || pin->GetString("mesh_refinement","refinement") == "static")
     ?  true : false;
 
+  // set how MPI messages access data on device.  With "device" (default), pointers to
+  // device memory are passed directly to MPI, which requires a GPU-aware MPI library.
+  // With "host", messages are staged through pinned host copies of the buffers.  Staging
+  // is never needed when device memory is accessible from host (e.g. CPU builds).
+  {
+    std::string transport = pin->GetOrAddString("mesh", "mpi_transport", "device");
+    if (transport.compare("device") == 0) {
+      mpi_host_staging = false;
+    } else if (transport.compare("host") == 0) {
+      mpi_host_staging = !(Kokkos::SpaceAccessibility<HostMemSpace,
+                                                       DevMemSpace>::accessible);
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mesh>/mpi_transport = '" << transport
+                << "' not supported, must be 'device' or 'host'" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
+  // space-filling curve used to order MBs, and whether MBs are distributed first across
+  // compute nodes and then across the ranks in each node, to reduce inter-node traffic
+  {
+    std::string curve = pin->GetOrAddString("loadbalancing", "curve", "zorder");
+    if (curve.compare("zorder") == 0) {
+      hilbert_order = false;
+    } else if (curve.compare("hilbert") == 0) {
+      hilbert_order = true;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<loadbalancing>/curve = '" << curve
+                << "' not supported, must be 'zorder' or 'hilbert'" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    node_aware_lb = pin->GetOrAddBoolean("loadbalancing", "node_aware", false);
+  }
+
+  // find node of each rank.  Nodes are numbered in order of their lowest rank.
+  nnodes = 1;
+  node_eachrank.assign(global_variable::nranks, 0);
+  speed_eachrank.assign(global_variable::nranks, 1.0);
+#if MPI_PARALLEL_ENABLED
+  {
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, global_variable::my_rank,
+                        MPI_INFO_NULL, &node_comm);
+    int node_root = global_variable::my_rank;
+    MPI_Allreduce(MPI_IN_PLACE, &node_root, 1, MPI_INT, MPI_MIN, node_comm);
+    MPI_Comm_free(&node_comm);
+    MPI_Allgather(&node_root, 1, MPI_INT, node_eachrank.data(), 1, MPI_INT,
+                  MPI_COMM_WORLD);
+    std::vector<int> roots(node_eachrank);
+    std::sort(roots.begin(), roots.end());
+    roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+    nnodes = static_cast<int>(roots.size());
+    for (auto &node : node_eachrank) {
+      node = static_cast<int>(std::lower_bound(roots.begin(), roots.end(), node)
+                              - roots.begin());
+    }
+  }
+#endif
+
   // FIXME: The shearing box is not currently compatible with SMR/AMR
   if (multilevel && pin->DoesBlockExist("shearing_box")) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
@@ -280,6 +343,20 @@ Mesh::Mesh(ParameterInput *pin) :
     std::exit(EXIT_FAILURE);
   }
 
+#if FIXED_MB_NX1 > 0
+  // MeshBlock size compiled into kernels must match input file
+  if (mb_indcs.nx1 != FIXED_MB_NX1 || mb_indcs.nx2 != FIXED_MB_NX2 ||
+      mb_indcs.nx3 != FIXED_MB_NX3 || mesh_indcs.ng != FIXED_MB_NGHOST) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Code was compiled for MeshBlocks of " << FIXED_MB_NX1 << "x"
+              << FIXED_MB_NX2 << "x" << FIXED_MB_NX3 << " cells with nghost="
+              << FIXED_MB_NGHOST << ", but input file specifies " << mb_indcs.nx1 << "x"
+              << mb_indcs.nx2 << "x" << mb_indcs.nx3 << " with nghost=" << mesh_indcs.ng
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+
   // initialize indices for Mesh cells, MeshBlock cells, and MeshBlock coarse cells
   mb_indcs.ng  = mesh_indcs.ng;
   mb_indcs.cnx1 = mb_indcs.nx1/2;
@@ -346,6 +423,32 @@ Mesh::~Mesh() {
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void EventCounters::AddDeviceCounters()
+//  \brief Copies the counters accumulated on the device to host in a single transfer,
+//  adds them into the host counters (taking the maximum for maxit_c2p), and resets them.
+
+void EventCounters::AddDeviceCounters() {
+  dcounts.template modify<DevExeSpace>();
+  dcounts.template sync<HostMemSpace>();
+  auto &h = dcounts.h_view;
+  nfofc += h(ifofc);
+  neos_dfloor += h(idfloor);
+  neos_efloor += h(iefloor);
+  neos_tfloor += h(itfloor);
+  neos_vceil += h(ivceil);
+  neos_fail += h(ifail);
+  maxit_c2p = (h(imaxit) > maxit_c2p)? h(imaxit) : maxit_c2p;
+  nrad_fail += h(iradfail);
+  ncompton_fail += h(icompfail);
+  ncompton_equil += h(icompequil);
+  for (int n=0; n<nc2p_hist; ++n) {
+    c2p_hist[n] += h(ic2p_hist + n);
+  }
+  Kokkos::deep_copy(dcounts.d_view, 0);
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Mesh::PrintMeshDiagnostics()
 //  \brief prints information about mesh structure, always called at start of every
@@ -421,6 +524,42 @@ void Mesh::PrintMeshDiagnostics() {
 //  '-m' option is given on command line.
 
 void Mesh::WriteMeshStructure() {
+  // Report edge cut of the partition, i.e. the number of faces between face-neighboring
+  // MBs that are shared by MBs on different ranks, and on different nodes.
+  {
+    int nface = 0, ncut_rank = 0, ncut_node = 0;
+    auto tally = [&](int gid1, int gid2) {
+      int r1 = rank_eachmb[gid1], r2 = rank_eachmb[gid2];
+      nface++;
+      if (r1 != r2) {ncut_rank++;}
+      if (node_eachrank[r1] != node_eachrank[r2]) {ncut_node++;}
+    };
+    for (int j=0; j<nmb_total; j++) {
+      for (int dir=0; dir<3; dir++) {
+        if ((dir == 1 && !(multi_d)) || (dir == 2 && !(three_d))) {continue;}
+        for (int side=-1; side<=1; side+=2) {
+          int ox[3] = {0, 0, 0};
+          ox[dir] = side;
+          MeshBlockTree *nt = ptree->FindNeighbor(lloc_eachmb[j], ox[0], ox[1], ox[2]);
+          if (nt == nullptr) {continue;}
+          if (nt->pleaf_ == nullptr) {
+            tally(j, nt->gid_);
+          } else {
+            // neighbors are finer: count leafs of parent adjacent to this face
+            for (int n=0; n<MeshBlockTree::nleaf_; n++) {
+              int on = (n >> dir) & 1;
+              if (on == ((side < 0)? 1 : 0)) {tally(j, nt->pleaf_[n]->gid_);}
+            }
+          }
+        }
+      }
+    }
+    // each face counted from both sides
+    std::cout << "Partition edge cut: " << nface/2 << " MeshBlock faces, " << ncut_rank/2
+              << " between ranks, " << ncut_node/2 << " between nodes (" << nnodes
+              << " nodes)" << std::endl;
+  }
+
   if (one_d) {
     std::cout << "WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
               << "Mesh only 1D, so no 'mesh_structure.dat' file produced" << std::endl;
@@ -563,6 +702,9 @@ std::string Mesh::GetBoundaryString(BoundaryFlag input_flag) {
 
 //----------------------------------------------------------------------------------------
 // \fn Mesh::NewTimeStep()
+// \brief Sets new timestep as minimum over all physics and MeshBlocks on all ranks.  If
+// a non-blocking reduction was started by StartNewTimeStep() and the Mesh has not been
+// changed by AMR since then, its result is used.  Otherwise a blocking reduction is used.
 
 void Mesh::NewTimeStep(const Real tlim) {
   // save old timestep
@@ -571,65 +713,144 @@ void Mesh::NewTimeStep(const Real tlim) {
     dtold = 0.;
   }
 
+  bool reduced = false;
+  if (dt_pending_) {
+#if MPI_PARALLEL_ENABLED
+    MPI_Wait(&dt_req_, MPI_STATUS_IGNORE);
+#endif
+    dt_pending_ = false;
+    if (dt_generation_ == ngeneration) {
+      dt = dt_global_;
+      reduced = true;
+    }
+  }
+
+  if (!(reduced)) {
+    dt = LocalNewTimeStep();
+#if MPI_PARALLEL_ENABLED
+    // get minimum dt over all MPI ranks
+    MPI_Allreduce(MPI_IN_PLACE, &dt, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
+#endif
+  }
+
+  // limit last time step to stop at tlim *exactly*
+  if ( (time < tlim) && ((time + dt) > tlim) ) {dt = tlim - time;}
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+// \fn Mesh::StartNewTimeStep()
+// \brief Starts non-blocking reduction of new timestep over all ranks, completed in
+// NewTimeStep().  Called by Driver after the last stage (when timesteps of all physics
+// are known) so that the reduction overlaps with remaining tasks, outputs, and AMR.
+
+void Mesh::StartNewTimeStep() {
+  if (dt_pending_) {return;}
+  dt_local_ = LocalNewTimeStep();
+  dt_generation_ = ngeneration;
+#if MPI_PARALLEL_ENABLED
+  MPI_Iallreduce(&dt_local_, &dt_global_, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD,
+                 &dt_req_);
+#else
+  dt_global_ = dt_local_;
+#endif
+  dt_pending_ = true;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+// \fn Mesh::LocalNewTimeStep()
+// \brief Returns minimum timestep over all physics in MeshBlocks on this rank.
+
+Real Mesh::LocalNewTimeStep() {
   // cycle over all MeshBlocks on this rank and find minimum dt
   // Requires at least ONE of the physics modules to be defined.
   // limit increase in timestep to 2x old value
-  dt = 2.0*dt;
+  Real dtmin = 2.0*dt;
 
   // Hydro timestep
   if (pmb_pack->phydro != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->dtnew) );
-    // viscosity timestep
-    if (pmb_pack->phydro->pvisc != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->pvisc->dtnew) );
+    dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->phydro->dtnew) );
+    // viscosity timestep (not limiting with super-time-stepping)
+    bool sts = pmb_pack->phydro->use_sts;
+    if ((pmb_pack->phydro->pvisc != nullptr) && !(sts)) {
+      dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->phydro->pvisc->dtnew) );
     }
     // thermal conduction timestep
-    if (pmb_pack->phydro->pcond != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->pcond->dtnew) );
+    if ((pmb_pack->phydro->pcond != nullptr) && !(sts)) {
+      dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->phydro->pcond->dtnew) );
     }
     // source terms timestep
-    dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->psrc->dtnew) );
+    dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->phydro->psrc->dtnew) );
   }
   // MHD timestep
   if (pmb_pack->pmhd != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->dtnew) );
-    // viscosity timestep
-    if (pmb_pack->pmhd->pvisc != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->pvisc->dtnew) );
+    dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->pmhd->dtnew) );
+    // viscosity timestep (not limiting with super-time-stepping)
+    bool sts = pmb_pack->pmhd->use_sts;
+    if ((pmb_pack->pmhd->pvisc != nullptr) && !(sts)) {
+      dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->pmhd->pvisc->dtnew) );
     }
     // resistivity timestep
-    if (pmb_pack->pmhd->presist != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->presist->dtnew) );
+    if ((pmb_pack->pmhd->presist != nullptr) && !(sts)) {
+      dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->pmhd->presist->dtnew) );
     }
     // thermal conduction timestep
-    if (pmb_pack->pmhd->pcond != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->pcond->dtnew) );
+    if ((pmb_pack->pmhd->pcond != nullptr) && !(sts)) {
+      dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->pmhd->pcond->dtnew) );
     }
     // source terms timestep
-    dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->psrc->dtnew) );
+    dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->pmhd->psrc->dtnew) );
   }
   // z4c timestep
   if (pmb_pack->pz4c != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->pz4c->dtnew) );
+    dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->pz4c->dtnew) );
   }
   // Radiation timestep
   if (pmb_pack->prad != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->prad->dtnew) );
+    dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->prad->dtnew) );
   }
   // Particles timestep
   if (pmb_pack->ppart != nullptr) {
-    dt = std::min(dt, (pmb_pack->ppart->dtnew) );
+    dtmin = std::min(dtmin, (pmb_pack->ppart->dtnew) );
   }
 
+  return dtmin;
+}
+
+//----------------------------------------------------------------------------------------
+// \fn Mesh::DiffusionTimeStep()
+// \brief Returns minimum explicit timestep over all ranks of the diffusion processes
+// integrated with super-time-stepping, which sets the number of stages of each STS step.
+
+Real Mesh::DiffusionTimeStep() {
+  Real dtmin = static_cast<Real>(std::numeric_limits<float>::max());
+
+  if ((pmb_pack->phydro != nullptr) && (pmb_pack->phydro->use_sts)) {
+    if (pmb_pack->phydro->pvisc != nullptr) {
+      dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->phydro->pvisc->dtnew) );
+    }
+    if (pmb_pack->phydro->pcond != nullptr) {
+      dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->phydro->pcond->dtnew) );
+    }
+  }
+  if ((pmb_pack->pmhd != nullptr) && (pmb_pack->pmhd->use_sts)) {
+    if (pmb_pack->pmhd->pvisc != nullptr) {
+      dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->pmhd->pvisc->dtnew) );
+    }
+    if (pmb_pack->pmhd->presist != nullptr) {
+      dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->pmhd->presist->dtnew) );
+    }
+    if (pmb_pack->pmhd->pcond != nullptr) {
+      dtmin = std::min(dtmin, (cfl_no)*(pmb_pack->pmhd->pcond->dtnew) );
+    }
+  }
 #if MPI_PARALLEL_ENABLED
-  // get minimum dt over all MPI ranks
-  MPI_Allreduce(MPI_IN_PLACE, &dt, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &dtmin, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
 #endif
 
-  // limit last time step to stop at tlim *exactly*
-  if ( (time < tlim) && ((time + dt) > tlim) ) {dt = tlim - time;}
-
-  return;
+  return dtmin;
 }
 
 //----------------------------------------------------------------------------------------
@@ -637,10 +858,17 @@ void Mesh::NewTimeStep(const Real tlim) {
 
 void Mesh::AddCoordinatesAndPhysics(ParameterInput *pinput) {
   // cycle over MeshBlockPacks on this rank and add Coordinates and Physics
+  std::int64_t bytes0 = memory_tracker::DeviceBytes();
   for (int n=0; n<nmb_packs_thisrank; ++n) {
-    pmb_pack->AddCoordinates(pinput);
+    {
+      memory_tracker::Scope scope(memory_tracker::Owner::mesh);
+      pmb_pack->AddCoordinates(pinput);
+    }
     pmb_pack->AddPhysics(pinput);
   }
+  if (adaptive && (max_mem_fraction > 0.0)) {
+    SetMaxMeshBlocksFromMemory(pinput, memory_tracker::DeviceBytes() - bytes0);
+  }
 
   // Determine total number of particles across all ranks
   particles::Particles *ppart = pmb_pack->ppart;
@@ -664,3 +892,77 @@ void Mesh::AddCoordinatesAndPhysics(ParameterInput *pinput) {
     }
   }
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::SetMaxMeshBlocksFromMemory()
+//! \brief With AMR, derives the maximum number of MeshBlocks per rank that fit in the
+//! fraction <mesh_refinement>/max_mem_fraction of device memory.  The memory needed per
+//! MeshBlock is the memory allocated by Coordinates and physics modules (pack_bytes)
+//! divided by the number of MeshBlocks their arrays are sized for.  The scratch buffer
+//! used to move MeshBlocks within a rank (at most MeshRefinement::nmb_move_batch
+//! MeshBlocks of one array) is reserved too.  Other memory allocated later (outputs,
+//! AMR load balancing buffers) is not included, so the fraction should leave room for
+//! it.  If <mesh_refinement>/max_nmb_per_rank is not given, the
+//! MeshBlockPack (which was sized for the root grid) is rebuilt with the derived limit.
+
+void Mesh::SetMaxMeshBlocksFromMemory(ParameterInput *pin, std::int64_t pack_bytes) {
+  bool max_nmb_set = pin->DoesParameterExist("mesh_refinement", "max_nmb_per_rank");
+  if (!(memory_tracker::enabled)) {
+    if (!(max_nmb_set)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<mesh_refinement>/max_mem_fraction requires memory tracking, "
+        << "set <memory_tracker>/enable=true or specify max_nmb_per_rank" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    return;
+  }
+  int nmb_alloc = std::max(nmb_thisrank, nmb_maxperrank);
+  double bytes_per_mb = static_cast<double>(pack_bytes)/static_cast<double>(nmb_alloc);
+  double other_bytes = static_cast<double>(memory_tracker::DeviceBytes() - pack_bytes);
+  double move_bytes = MeshRefinement::nmb_move_batch*bytes_per_mb;
+  double budget = max_mem_fraction*static_cast<double>(memory_tracker::DeviceCapacity())
+                  - other_bytes - move_bytes;
+  int nmb_budget = (bytes_per_mb > 0.0)? static_cast<int>(budget/bytes_per_mb) : 0;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &nmb_budget, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  nmb_budget = std::min(nmb_budget, (1 << (NUM_BITS_LID)));
+#endif
+  if (global_variable::my_rank == 0) {
+    std::cout << "Device memory per MeshBlock = " << bytes_per_mb/1048576.0 << " MiB, "
+              << "<mesh_refinement>/max_mem_fraction=" << max_mem_fraction
+              << " allows " << nmb_budget << " MeshBlocks per rank" << std::endl;
+  }
+
+  // limit given in input file takes precedence
+  if (max_nmb_set) {
+    if ((nmb_maxperrank > nmb_budget) && (global_variable::my_rank == 0)) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+        << "<mesh_refinement>/max_nmb_per_rank=" << nmb_maxperrank << " exceeds "
+        << "the memory budget, AMR may run out of device memory" << std::endl;
+    }
+    return;
+  }
+  if (nmb_budget < nmb_thisrank) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "On rank=" << global_variable::my_rank << " Root grid requires "
+      << "more MeshBlocks (nmb_thisrank=" << nmb_thisrank << ") than fit in "
+      << "<mesh_refinement>/max_mem_fraction=" << max_mem_fraction << " of device memory"
+      << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (nmb_budget == nmb_maxperrank) {return;}
+
+  // rebuild MeshBlockPack, so that arrays are sized for nmb_budget MeshBlocks
+  nmb_maxperrank = nmb_budget;
+  int gids = pmb_pack->gids, gide = pmb_pack->gide;
+  delete pmb_pack;
+  pmb_pack = new MeshBlockPack(this, gids, gide);
+  pmb_pack->AddMeshBlocks(pin);
+  pmb_pack->pmb->SetNeighbors(plintree, rank_eachmb);
+  {
+    memory_tracker::Scope scope(memory_tracker::Owner::mesh);
+    pmb_pack->AddCoordinates(pin);
+  }
+  pmb_pack->AddPhysics(pin);
+  return;
+}
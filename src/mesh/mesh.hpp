@@ -14,9 +14,14 @@
 #include <cstdint>  // int32_t
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
 // Define following structure before other "include" files to resolve declarations
 //----------------------------------------------------------------------------------------
 //! \struct RegionSize
@@ -40,6 +45,39 @@ struct RegionIndcs {
   int cis,cie,cjs,cje,cks,cke;  // indices of ACTIVE coarse cells
 };
 
+//----------------------------------------------------------------------------------------
+//! \struct KernelIndcs
+//! \brief Cell indices of a MeshBlock for use inside kernels.  When the MeshBlock size is
+//! fixed at compile time (with -D Athena_MESHBLOCK_NX1=... etc.) all members are
+//! constexpr, so that loop bounds and scratch array strides computed from them are known
+//! to the compiler.  Otherwise they are copied from the RegionIndcs set at runtime.
+
+#if FIXED_MB_NX1 > 0
+struct KernelIndcs {
+  static constexpr int ng = FIXED_MB_NGHOST;
+  static constexpr int nx1 = FIXED_MB_NX1, nx2 = FIXED_MB_NX2, nx3 = FIXED_MB_NX3;
+  static constexpr int is = ng, ie = ng + nx1 - 1;
+  static constexpr int js = (nx2 > 1)? ng : 0, je = (nx2 > 1)? ng + nx2 - 1 : 0;
+  static constexpr int ks = (nx3 > 1)? ng : 0, ke = (nx3 > 1)? ng + nx3 - 1 : 0;
+  static constexpr int ncells1 = nx1 + 2*ng;
+  static constexpr int ncells2 = (nx2 > 1)? nx2 + 2*ng : 1;
+  static constexpr int ncells3 = (nx3 > 1)? nx3 + 2*ng : 1;
+  explicit KernelIndcs(const RegionIndcs &) {}
+};
+#else
+struct KernelIndcs {
+  int ng, nx1, nx2, nx3;
+  int is, ie, js, je, ks, ke;
+  int ncells1, ncells2, ncells3;
+  explicit KernelIndcs(const RegionIndcs &indcs) :
+    ng(indcs.ng), nx1(indcs.nx1), nx2(indcs.nx2), nx3(indcs.nx3),
+    is(indcs.is), ie(indcs.ie), js(indcs.js), je(indcs.je), ks(indcs.ks), ke(indcs.ke),
+    ncells1(indcs.nx1 + 2*indcs.ng),
+    ncells2((indcs.nx2 > 1)? indcs.nx2 + 2*indcs.ng : 1),
+    ncells3((indcs.nx3 > 1)? indcs.nx3 + 2*indcs.ng : 1) {}
+};
+#endif
+
 //----------------------------------------------------------------------------------------
 //! \struct NeighborBlock
 //! \brief Information about neighboring MeshBlocks stored as 2D DualArray in MeshBlock
@@ -69,20 +107,43 @@ struct LogicalLocation {
 
 struct EventCounters {
   int nfofc, neos_dfloor, neos_efloor, neos_tfloor, neos_vceil, neos_fail, maxit_c2p;
+  // histogram of number of cells in which c2p used n iterations (last bin is n>=nbin-1)
+  static constexpr int nc2p_hist = 32;
+  bool c2p_hist_used;
+  int c2p_hist[nc2p_hist];
+  // cells in which the implicit radiation source term failed to find the gas temperature
+  // (absorption/emission and Compton updates), or skipped the Compton update because gas
+  // and radiation were in equilibrium
+  bool rad_counters_used;
+  int nrad_fail, ncompton_fail, ncompton_equil;
+  // all of the above counted on the device, with atomics inside the kernels in which the
+  // events occur, at the indices below (the c2p histogram starting at ic2p_hist).  They
+  // are added into the host counters only when the event log is output, by
+  // AddDeviceCounters(), so kernels never wait on a reduction to the host.
+  enum DeviceIndex {ifofc, idfloor, iefloor, itfloor, ivceil, ifail, imaxit, iradfail,
+                    icompfail, icompequil, ic2p_hist, ndevice = ic2p_hist + nc2p_hist};
+  DualArray1D<int> dcounts;
   EventCounters() : nfofc(0), neos_dfloor(0), neos_efloor(0), neos_tfloor(0),
-                    neos_vceil(0), neos_fail(0), maxit_c2p(0) {}
+                    neos_vceil(0), neos_fail(0), maxit_c2p(0), c2p_hist_used(false),
+                    rad_counters_used(false), nrad_fail(0), ncompton_fail(0),
+                    ncompton_equil(0), dcounts("ecounter_dcounts", ndevice) {
+    for (int n=0; n<nc2p_hist; ++n) {c2p_hist[n] = 0;}
+  }
+  void AddDeviceCounters();
 };
 
 // Forward declarations required due to recursive definitions amongst mesh classes
 class MeshBlock;
 class MeshBlockPack;
 class MeshBlockTree;
+class LinearMeshTree;
 class Mesh;
 
 #include "parameter_input.hpp"
 #include "meshblock.hpp"
 #include "meshblock_pack.hpp"
 #include "meshblock_tree.hpp"
+#include "linear_tree.hpp"
 #include "mesh_refinement.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -96,7 +157,7 @@ class Mesh {
   friend class MeshBlockPack;
   friend class MeshBlockTree;
   friend class MeshRefinement;
-  // needs to access tree to find target MB offset by shear
+  // needs to access trees to find target MB offset by shear
   friend class ShearingBoxBoundary;
 
  public:
@@ -114,15 +175,24 @@ class Mesh {
   bool multi_d;               // flag to indicate 2D and 3D calculations
   bool multilevel;            // true for SMR and AMR
   bool adaptive;              // true only for AMR
+  bool mpi_host_staging;      // true if MPI messages staged through pinned host memory
+  bool count_mb_work = false; // true if work on each MB is counted for load balancing
+  bool hilbert_order;         // true if MBs ordered along Hilbert (not Z-order) curve
+  bool node_aware_lb;         // true if MBs divided between nodes, then ranks in node
 
   int nmb_rootx1, nmb_rootx2, nmb_rootx3; // # of MeshBlocks at root level in each dir
   int nmb_total;           // total number of MeshBlocks across all levels/ranks
   int nmb_thisrank;        // number of MeshBlocks on this MPI rank (local)
   int nmb_maxperrank;      // max allowed number of MBs per device (memory limit for AMR)
+  Real max_mem_fraction;   // fraction of device memory used to set nmb_maxperrank (AMR)
 
   int root_level; // logical level of root (physical) grid (e.g. Fig. 3 of method paper)
   int max_level;  // logical level of maximum refinement grid in Mesh
 
+  int nnodes;                    // number of compute (shared-memory) nodes
+  std::vector<int> node_eachrank; // node index of each MPI rank
+  std::vector<float> speed_eachrank; // relative speed of each MPI rank (mean of one)
+
   int nprtcl_thisrank;     // number of particles this rank
   int nprtcl_total;        // total number of particles across all ranks
 
@@ -139,6 +209,8 @@ class Mesh {
 
   Real time, dt, dtold, cfl_no;
   int ncycle;
+  int ngeneration;  // incremented each time AMR changes Mesh; used to invalidate any
+                    // data cached across cycles that depends on MeshBlocks/neighbors
   EventCounters ecounter;
 
   int nmb_packs_thisrank;                  // number of MBPacks on this rank
@@ -152,7 +224,10 @@ class Mesh {
   void PrintMeshDiagnostics();
   void WriteMeshStructure();
   void NewTimeStep(const Real tlim);
+  void StartNewTimeStep();
+  Real DiffusionTimeStep();
   void AddCoordinatesAndPhysics(ParameterInput *pinput);
+  void SetMaxMeshBlocksFromMemory(ParameterInput *pinput, std::int64_t pack_bytes);
   BoundaryFlag GetBoundaryFlag(const std::string& input_string);
   std::string GetBoundaryString(BoundaryFlag input_flag);
 
@@ -163,10 +238,9 @@ class Mesh {
 
   // accessors
   int FindMeshBlockIndex(int tgid) {
-    for (int m=0; m<pmb_pack->nmb_thispack; ++m) {
-      if (pmb_pack->pmb->mb_gid.h_view(m) == tgid) return m;
-    }
-    return -1;
+    // GIDs of MeshBlocks in pack are contiguous, starting at gids
+    int m = tgid - pmb_pack->gids;
+    return (m >= 0 && m < pmb_pack->nmb_thispack)? m : -1;
   }
   int NumberOfMeshBlockCells() const {
     return (mb_indcs.nx1)*(mb_indcs.nx2)*(mb_indcs.nx3);
@@ -174,6 +248,16 @@ class Mesh {
 
  private:
   std::unique_ptr<MeshBlockTree> ptree;  // pointer to root node in binary/quad/oct-tree
+  std::unique_ptr<LinearMeshTree> plintree;  // sorted array of leafs for fast searches
   void LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb);
+  Real LocalNewTimeStep();
+
+  // data for non-blocking reduction of timestep started by StartNewTimeStep()
+  bool dt_pending_ = false;     // reduction started but not yet completed
+  int dt_generation_ = 0;       // value of ngeneration when reduction started
+  Real dt_local_, dt_global_;   // send and receive buffers of reduction
+#if MPI_PARALLEL_ENABLED
+  MPI_Request dt_req_;
+#endif
 };
 #endif  // MESH_MESH_HPP_
@@ -10,10 +10,15 @@
 //! are used both here for AMR and in the BVals class at fine/coarse boundaries).
 
 #include <cstdint>   // int32_t
+#include <cstdlib>
 #include <iostream>
 #include <cmath>     // abs
 #include <algorithm> // sort
+#include <iterator>  // back_inserter
+#include <memory>    // make_unique
+#include <string>
 #include <utility>   // pair
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -24,11 +29,15 @@
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "radiation/radiation.hpp"
+#include "particles/particles.hpp"
+#include "bvals/bvals.hpp"
 #include "coordinates/adm.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/z4c_amr.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
 #include "prolongation.hpp"
 #include "restriction.hpp"
+#include "utils/memory_tracker.hpp"
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
@@ -45,18 +54,34 @@ MeshRefinement::MeshRefinement(Mesh *pm, ParameterInput *pin) :
   nmb_created(0),
   nmb_deleted(0),
   nmb_sent_thisrank(0),
+  nref_deferred(0),
+  amr_time(0.0),
   ncyc_check_amr(1),
   refinement_interval(5),
   prolong_prims(false),
+  lb_automatic(false),
+  lb_incremental(false),
+  lb_interval(10),
+  lb_tolerance(0.1),
+  lb_c2p_cost(0.05),
+  lb_prtcl_cost(0.5),
+  lb_rank_speed(false),
+  nmb_move(0),
   d_threshold_(0.0),
   dd_threshold_(0.0),
   dp_threshold_(0.0),
   dv_threshold_(0.0),
-  check_cons_(false) {
+  check_cons_(false),
+  nbuffer_(0),
+  ncyc_work_(0),
+  busy_time0_(0.0) {
   if (pin->DoesBlockExist("mesh_refinement")) {
     // read interval (in cycles) between check of AMR and derefinement
     ncyc_check_amr = pin->GetOrAddReal("mesh_refinement", "ncycle_check", 1);
     refinement_interval = pin->GetOrAddReal("mesh_refinement", "refinement_interval", 5);
+    // read width of buffer of MBs refined around those flagged, which anticipates
+    // refinement needed over the next few checks so the mesh is rebuilt less often
+    nbuffer_ = pin->GetOrAddInteger("mesh_refinement", "refine_buffer", 0);
     // read prolongate primitives flag
     if (pin->DoesParameterExist("mesh_refinement", "prolong_primitives")) {
       prolong_prims = pin->GetBoolean("mesh_refinement", "prolong_primitives");
@@ -80,6 +105,52 @@ MeshRefinement::MeshRefinement(Mesh *pm, ParameterInput *pin) :
     }
   }
 
+  // read load balancing parameters.  With balancer=automatic, the cost of each MeshBlock
+  // is measured from the work counted on it, and MeshBlocks are redistributed whenever
+  // the load imbalance across ranks exceeds tolerance (checked every interval cycles).
+  // With incremental=true, MeshBlocks are redistributed by shifting the old boundaries
+  // between ranks until the imbalance is below tolerance.  With rank_speed=true, the
+  // speed of each rank is measured as well, and faster ranks are given more cost.
+  if (pin->DoesBlockExist("loadbalancing")) {
+    std::string balancer = pin->GetOrAddString("loadbalancing", "balancer", "default");
+    if (balancer == "automatic") {
+      lb_automatic = true;
+    } else if (balancer != "default") {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<loadbalancing>/balancer = '" << balancer
+                << "' not implemented, must be 'default' or 'automatic'" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    lb_interval = pin->GetOrAddInteger("loadbalancing", "interval", 10);
+    lb_tolerance = pin->GetOrAddReal("loadbalancing", "tolerance", 0.1);
+    lb_c2p_cost = pin->GetOrAddReal("loadbalancing", "c2p_iteration_cost", 0.05);
+    lb_prtcl_cost = pin->GetOrAddReal("loadbalancing", "prtcl_cost", 0.5);
+    lb_incremental = pin->GetOrAddBoolean("loadbalancing", "incremental", false);
+    lb_rank_speed = pin->GetOrAddBoolean("loadbalancing", "rank_speed", false);
+    if (lb_rank_speed && !(lb_automatic)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<loadbalancing>/rank_speed = true requires "
+                << "<loadbalancing>/balancer = automatic" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    // speed of ranks is measured from the time of Tasks, including their device work
+    if (lb_rank_speed && (!(pin->GetOrAddBoolean("tasks", "profile", true)) ||
+                          !(pin->GetOrAddBoolean("tasks", "profile_fence", true)))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<loadbalancing>/rank_speed = true requires "
+                << "<tasks>/profile = true and <tasks>/profile_fence = true" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (lb_automatic && !(pm->adaptive)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<loadbalancing>/balancer = automatic requires "
+                << "<mesh_refinement>/refinement = adaptive" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (lb_interval < 1) {lb_interval = 1;}
+    pm->count_mb_work = lb_automatic;
+  }
+
   if (pm->adaptive) {  // allocate arrays for AMR
     nref_eachrank = new int[global_variable::nranks];
     nderef_eachrank = new int[global_variable::nranks];
@@ -121,6 +192,7 @@ MeshRefinement::~MeshRefinement() {
 //! \brief Simple driver function for adaptive mesh refinement
 
 void MeshRefinement::AdaptiveMeshRefinement(Driver *pdriver, ParameterInput *pin) {
+  ncyc_work_++;
   // first check refinement criteria
   CheckForRefinement(pmy_mesh->pmb_pack);
 
@@ -128,9 +200,25 @@ void MeshRefinement::AdaptiveMeshRefinement(Driver *pdriver, ParameterInput *pin
   int nnew = 0, ndel = 0;
   UpdateMeshBlockTree(nnew, ndel);
 
+  // With measured costs, update cost of each MeshBlock before it is redistributed, and
+  // every lb_interval cycles redistribute MeshBlocks if load is too imbalanced
+  bool rebalance = false;
+  if (lb_automatic) {
+    if (nnew != 0 || ndel != 0) {
+      MeasureCost();
+    } else if ((pmy_mesh->ncycle % lb_interval) == 0) {
+      rebalance = CheckLoadImbalance();
+    }
+  }
+
   // Refine/derefine mesh and evolved data, set boundary conditions/timestep on new mesh
-  if (nnew != 0 || ndel != 0) { // at least one (de)refinement flagged
+  if (nnew != 0 || ndel != 0 || rebalance) { // at least one (de)refinement flagged
     RedistAndRefineMeshBlocks(pin, nnew, ndel);
+    ncyc_work_ = 0;  // work is counted from zero on new MeshBlocks
+    if (lb_rank_speed) {busy_time0_ = BusyTime();}
+    // increment generation before new boundary values are set, so that any data cached
+    // for the old Mesh is rebuilt
+    pmy_mesh->ngeneration++;
     pdriver->InitBoundaryValuesAndPrimitives(pmy_mesh);
 
     MeshBlockPack* pmbp = pmy_mesh->pmb_pack;
@@ -140,15 +228,18 @@ void MeshRefinement::AdaptiveMeshRefinement(Driver *pdriver, ParameterInput *pin
     if (pmbp->pmhd != nullptr) {
       (void) pmbp->pmhd->NewTimeStep(pdriver, pdriver->nexp_stages);
     }
+#if RADIATION_ENABLED
     if (pmbp->prad != nullptr) {
       (void) pmbp->prad->NewTimeStep(pdriver, pdriver->nexp_stages);
     }
+#endif
     if (pmbp->pz4c != nullptr) {
       (void) pmbp->pz4c->NewTimeStep(pdriver, pdriver->nexp_stages);
     }
 
     nmb_created += nnew;
     nmb_deleted += ndel;
+    memory_tracker::Report("after AMR at cycle " + std::to_string(pmy_mesh->ncycle));
   }
   return;
 }
@@ -286,12 +377,9 @@ void MeshRefinement::CheckForRefinement(MeshBlockPack* pmbp) {
   for (int m=0; m<nmb; ++m) {
     if (ncyc_since_ref(m+mbs) < refinement_interval) {refine_flag.h_view(m+mbs) = 0;}
   }
-#if MPI_PARALLEL_ENABLED
-  // Pass refine_flag between all ranks
-    MPI_Allgatherv(MPI_IN_PLACE, pmy_mesh->nmb_eachrank[global_variable::my_rank],
-                   MPI_INT, refine_flag.h_view.data(), pmy_mesh->nmb_eachrank,
-                   pmy_mesh->gids_eachrank, MPI_INT, MPI_COMM_WORLD);
-#endif
+  // Flags are only set for MBs on this rank.  They are not passed between ranks, since
+  // UpdateMeshBlockTree() only exchanges the locations of flagged MBs, and the flags of
+  // all MBs are reset consistently on every rank in RedistAndRefineMeshBlocks().
   // sync host array with device
   refine_flag.template modify<HostMemSpace>();
   refine_flag.template sync<DevExeSpace>();
@@ -381,46 +469,76 @@ void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel) {
   MPI_Type_free(&lloc_type);
 #endif
 
+  // Refinement is deferred if the new MeshBlocks would not fit within nmb_maxperrank (the
+  // memory limit) when distributed evenly over ranks, rather than running out of device
+  // memory.  Derefinement is still allowed, and refinement is retried at the next check.
+  auto fits = [this](int nmb) {
+    int nranks = global_variable::nranks;
+    return ((nmb + nranks - 1)/nranks <= pmy_mesh->nmb_maxperrank);
+  };
+  auto defer = [this, mbs](int nmb_new) {
+    if ((nref_deferred == 0) && (global_variable::my_rank == 0)) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Refinement at cycle " << pmy_mesh->ncycle << " deferred, "
+        << "since " << nmb_new << " MeshBlocks would exceed "
+        << "<mesh_refinement>/max_nmb_per_rank=" << pmy_mesh->nmb_maxperrank
+        << " on some ranks (further deferrals are not reported)" << std::endl;
+    }
+    nref_deferred++;
+    for (int i=0; i<(pmy_mesh->nmb_thisrank); ++i) {
+      if (refine_flag.h_view(i+mbs) == 1) {refine_flag.h_view(i+mbs) = 0;}
+    }
+    refine_flag.template modify<HostMemSpace>();
+    refine_flag.template sync<DevExeSpace>();
+    for (int n=0; n<global_variable::nranks; n++) {nref_eachrank[n] = 0;}
+  };
+
+  // First estimate counts the MBs flagged for refinement and those in the buffer around
+  // them (found before the tree is changed).  MBs refined to keep the 2:1 level ratio are
+  // only known once the tree is refined, so the total is checked again below.
+  std::vector<LogicalLocation> llbuf;
+  if (nbuffer_ > 0 && tnref > 0) {llbuf = RefinementBuffer(llref, tnref);}
+  if (tnref > 0) {
+    int nmb_new = pmy_mesh->nmb_total +
+                  (tnref + static_cast<int>(llbuf.size()))*(nleaf - 1);
+    if (!(fits(nmb_new))) {
+      defer(nmb_new);
+      delete [] llref;
+      llbuf.clear();
+      tnref = 0;
+    }
+  }
+
   // Each rank now has a complete list of the LLs of MBs refined/derefined on other ranks
-  // calculate the list of the newly derefined blocks
+  // calculate the list of the newly derefined blocks.  Flagged MBs are sorted by their
+  // parent so that siblings are adjacent in the list whatever the order of the MBs along
+  // the space-filling curve, and parents with all nleaf leafs flagged are derefined.
   int ctnd = 0;
   if (tnderef >= nleaf) {
-    int lk = 0, lj = 0;
-    if (pmy_mesh->multi_d) lj = 1;
-    if (pmy_mesh->three_d) lk = 1;
-    for (int n=0; n<tnderef; n++) {
-      if ((llderef[n].lx1 & 1) == 0 &&
-          (llderef[n].lx2 & 1) == 0 &&
-          (llderef[n].lx3 & 1) == 0) {
-        int r = n, rr = 0;
-        for (std::int32_t k=0; k<=lk; k++) {
-          for (std::int32_t j=0; j<=lj; j++) {
-            for (std::int32_t i=0; i<=1; i++) {
-              if (r < tnderef) {
-                if ((llderef[n].lx1+i) == llderef[r].lx1 &&
-                    (llderef[n].lx2+j) == llderef[r].lx2 &&
-                    (llderef[n].lx3+k) == llderef[r].lx3 &&
-                     llderef[n].level  == llderef[r].level) {
-                  rr++;
-                }
-                r++;
-              }
-            }
-          }
-        }
-        if (rr == nleaf) {
-          cllderef[ctnd].lx1   = llderef[n].lx1 >> 1;
-          cllderef[ctnd].lx2   = llderef[n].lx2 >> 1;
-          cllderef[ctnd].lx3   = llderef[n].lx3 >> 1;
-          cllderef[ctnd].level = llderef[n].level - 1;
-          ctnd++;
-        }
+    auto parent_less = [](const LogicalLocation &a, const LogicalLocation &b) {
+      if (a.level != b.level) {return a.level < b.level;}
+      if ((a.lx3 >> 1) != (b.lx3 >> 1)) {return (a.lx3 >> 1) < (b.lx3 >> 1);}
+      if ((a.lx2 >> 1) != (b.lx2 >> 1)) {return (a.lx2 >> 1) < (b.lx2 >> 1);}
+      return (a.lx1 >> 1) < (b.lx1 >> 1);
+    };
+    std::sort(llderef, llderef + tnderef, parent_less);
+    int n = 0;
+    while (n < tnderef) {
+      int r = n + 1;
+      while (r < tnderef && !(parent_less(llderef[n], llderef[r]))) {r++;}
+      if ((r - n) == nleaf) {
+        cllderef[ctnd].lx1   = llderef[n].lx1 >> 1;
+        cllderef[ctnd].lx2   = llderef[n].lx2 >> 1;
+        cllderef[ctnd].lx3   = llderef[n].lx3 >> 1;
+        cllderef[ctnd].level = llderef[n].level - 1;
+        ctnd++;
       }
+      n = r;
     }
   }
   // sort the lists by level
   if (ctnd > 1) {
-    std::sort(cllderef, &(cllderef[ctnd-1]), Mesh::GreaterLevel);
+    std::sort(cllderef, cllderef + ctnd, Mesh::GreaterLevel);
   }
 
   if (tnderef >= nleaf) {
@@ -430,14 +548,34 @@ void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel) {
   // Now the lists of the blocks to be refined and derefined are completed
   // Start tree manipulation.  Note all ranks manipulate entire tree, so each rank has
   // a complete and updated copy of the entire tree.
-  // Step 1. perform refinement
+  // Step 1. perform refinement, including buffer around MBs flagged for refinement
   for (int n=0; n<tnref; n++) {
     MeshBlockTree *bt = pmy_mesh->ptree->FindMeshBlock(llref[n]);
     bt->Refine(nnew);
   }
+  for (auto &lloc : llbuf) {
+    MeshBlockTree *bt = pmy_mesh->ptree->FindMeshBlock(lloc);
+    bt->Refine(nnew);  // returns if MB already refined to satisfy 2:1 level ratio
+  }
   if (tnref != 0) {
     delete [] llref;
   }
+  // If MBs refined to keep the 2:1 level ratio take the total over the limit, roll back
+  // by rebuilding the tree from the locations of the old MBs.  These are in the order
+  // of the old gids, so the gids stored in the rebuilt tree are unchanged.
+  if (nnew > 0 && !(fits(pmy_mesh->nmb_total + nnew))) {
+    defer(pmy_mesh->nmb_total + nnew);
+    auto &ptree = pmy_mesh->ptree;
+    ptree = std::make_unique<MeshBlockTree>(pmy_mesh);
+    ptree->CreateRootGrid();
+    for (int i=0; i<(pmy_mesh->nmb_total); i++) {
+      ptree->AddNodeWithoutRefinement(pmy_mesh->lloc_eachmb[i]);
+    }
+    std::vector<LogicalLocation> lloc_tree(pmy_mesh->nmb_total);
+    int nmb_tree;
+    ptree->CreateZOrderedLLList(lloc_tree.data(), nullptr, nmb_tree);
+    nnew = 0;
+  }
 
   // Step 2. perform derefinement
   for (int n=0; n<ctnd; n++) {
@@ -452,6 +590,65 @@ void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel) {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn std::vector<LogicalLocation> MeshRefinement::RefinementBuffer()
+//! \brief Returns the LogicalLocations of all MBs within nbuffer_ MBs of the nref MBs in
+//! llref (which are flagged for refinement), that are at the same level, are not already
+//! in llref, and are below the maximum level.  Refining these MBs along with those in
+//! llref means features moving across the mesh stay in refined MBs for longer, so fewer
+//! rebuilds of the mesh are needed at the cost of some extra refined MBs.  Must be called
+//! before the tree is changed.  The list is sorted so it is identical on all ranks.
+
+std::vector<LogicalLocation> MeshRefinement::RefinementBuffer(LogicalLocation *llref,
+                                                              int nref) {
+  Mesh *pm = pmy_mesh;
+  int ox2max = (pm->multi_d)? 1 : 0;
+  int ox3max = (pm->three_d)? 1 : 0;
+
+  std::vector<MeshBlockTree*> all, front, next;
+  for (int n=0; n<nref; n++) {front.push_back(pm->ptree->FindMeshBlock(llref[n]));}
+  all = front;
+  std::sort(all.begin(), all.end());
+  std::vector<LogicalLocation> llbuf;
+  for (int layer=0; layer<nbuffer_ && !(front.empty()); layer++) {
+    // find same-level leaf neighbors (including edges and corners) of MBs in front
+    next.clear();
+    for (auto *bt : front) {
+      for (int ox3=-ox3max; ox3<=ox3max; ox3++) {
+        for (int ox2=-ox2max; ox2<=ox2max; ox2++) {
+          for (int ox1=-1; ox1<=1; ox1++) {
+            if (ox1 == 0 && ox2 == 0 && ox3 == 0) {continue;}
+            MeshBlockTree *nt = pm->ptree->FindNeighbor(bt->lloc_, ox1, ox2, ox3);
+            if ((nt != nullptr) && (nt->pleaf_ == nullptr) &&
+                (nt->lloc_.level == bt->lloc_.level) &&
+                (nt->lloc_.level < pm->max_level)) {
+              next.push_back(nt);
+            }
+          }
+        }
+      }
+    }
+    // remove duplicates and MBs already in list, then add new MBs to list
+    std::sort(next.begin(), next.end());
+    next.erase(std::unique(next.begin(), next.end()), next.end());
+    front.clear();
+    std::set_difference(next.begin(), next.end(), all.begin(), all.end(),
+                        std::back_inserter(front));
+    for (auto *bt : front) {llbuf.push_back(bt->lloc_);}
+    all.insert(all.end(), front.begin(), front.end());
+    std::sort(all.begin(), all.end());
+  }
+
+  std::sort(llbuf.begin(), llbuf.end(),
+    [](const LogicalLocation &a, const LogicalLocation &b) {
+      if (a.level != b.level) {return a.level < b.level;}
+      if (a.lx3 != b.lx3) {return a.lx3 < b.lx3;}
+      if (a.lx2 != b.lx2) {return a.lx2 < b.lx2;}
+      return a.lx1 < b.lx1;
+    });
+  return llbuf;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::RedistAndRefineMeshBlocks()
 //! \brief redistribute MeshBlocks according to the new load balance
@@ -506,17 +703,44 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   }
 
   // Step 3.
-  // Calculate new load balance. Initialize new cost array with the simplest estimate
-  // possible: all the blocks are equal
-  // TODO(@user): implement variable cost per MeshBlock as needed
+  // Calculate new load balance. Cost of each new MB is that of the old MB it was created
+  // from, or the mean over the old leaves of derefined MBs.  Costs are all equal unless
+  // they are measured (<loadbalancing>/balancer=automatic).
   new_cost_eachmb = new float[new_nmb];
   new_rank_eachmb = new int[new_nmb];
   new_gids_eachrank = new int[global_variable::nranks];
   new_nmb_eachrank = new int[global_variable::nranks];
 
-  for (int i=0; i<new_nmb; i++) {new_cost_eachmb[i] = 1.0;}
-  pm->LoadBalance(new_cost_eachmb, new_rank_eachmb, new_gids_eachrank, new_nmb_eachrank,
-                  new_nmb_total);
+  for (int i=0; i<new_nmb; i++) {
+    int oldm = newtoold[i];
+    if (pm->lloc_eachmb[oldm].level > new_lloc_eachmb[i].level) {  // derefined
+      float cost = 0.0;
+      for (int l=0; l<nleaf; l++) {cost += pm->cost_eachmb[oldm+l];}
+      new_cost_eachmb[i] = cost/static_cast<float>(nleaf);
+    } else {
+      new_cost_eachmb[i] = pm->cost_eachmb[oldm];
+    }
+  }
+  if (!(lb_incremental) ||
+      !(IncrementalLoadBalance(new_cost_eachmb, new_rank_eachmb, new_gids_eachrank,
+                               new_nmb_eachrank, new_nmb_total))) {
+    pm->LoadBalance(new_cost_eachmb, new_rank_eachmb, new_gids_eachrank, new_nmb_eachrank,
+                    new_nmb_total);
+  }
+  // UpdateMeshBlockTree() ensures the new MBs fit within nmb_maxperrank when distributed
+  // evenly, but unequal costs can put more MBs on some ranks.  In that case the MBs are
+  // distributed with equal costs instead (same on all ranks, since all have every count).
+  {
+    int nmb_maxrank = 0;
+    for (int n=0; n<global_variable::nranks; n++) {
+      nmb_maxrank = std::max(nmb_maxrank, new_nmb_eachrank[n]);
+    }
+    if (nmb_maxrank > pm->nmb_maxperrank) {
+      std::vector<float> equal_cost(new_nmb, 1.0);
+      pm->LoadBalance(equal_cost.data(), new_rank_eachmb, new_gids_eachrank,
+                      new_nmb_eachrank, new_nmb_total);
+    }
+  }
   if (new_nmb_eachrank[global_variable::my_rank] > pm->nmb_maxperrank) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
         << "Number of MeshBlocks in this rank on new tree = "
@@ -545,13 +769,25 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   refine_flag.template modify<HostMemSpace>();
   refine_flag.template sync<DevExeSpace>();
 
+  // Set GIDs of particles in new Mesh (while sizes of old MeshBlocks are still stored),
+  // and list particles moving to other ranks with their MeshBlocks
+  particles::Particles *ppart = pm->pmb_pack->ppart;
+  if (ppart != nullptr) {
+    ppart->pbval_part->SetNewMeshPrtclGID(oldtonew, new_rank_eachmb, new_nmb_total,
+                                          refine_flag);
+  }
+
   // Step 4.
   // Allocate send/recv buffers for load balancing, post receives.
-  // Pack send buffers for load blancing and send data
+  // Pack send buffers for load blancing and send data.  Particles are sent along with
+  // the messages carrying their MeshBlocks.
 #if MPI_PARALLEL_ENABLED
   InitRecvAMR(nleaf);
   PackAndSendAMR(nleaf);
   nmb_sent_thisrank += nmb_send;
+  if (ppart != nullptr) {
+    ppart->pbval_part->PackAndSendPrtclsAMR(prtcl_sends);
+  }
 #endif
 
   // Step 5.
@@ -579,6 +815,7 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   // Step 6.
   // Copy evolved physics variables to new MB index within View for MeshBlocks that stay
   // within this rank
+  SetMoveList();
   if (phydro != nullptr) {
     CopyCC(phydro->u0);
   }
@@ -612,6 +849,10 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
 #if MPI_PARALLEL_ENABLED
   if (nmb_send > 0) {ClearSendAMR();}
   if (nmb_recv > 0) {ClearRecvAndUnpackAMR();}
+  if (ppart != nullptr) {
+    ppart->pbval_part->RecvAndUnpackPrtclsAMR(prtcl_recvs);
+    (void) ppart->pbval_part->ClearPrtclSend();
+  }
 #endif
 
   // copy newtoold array to DualView so that it can be accessed in kernel
@@ -667,6 +908,16 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   pm->nmb_total = new_nmb_total;
   pm->nmb_thisrank = pm->nmb_eachrank[global_variable::my_rank];
 
+  // save neighbors of old MeshBlocks, so that only those MeshBlocks whose neighborhood
+  // has changed need to search the new tree for neighbors
+  PrevNeighbors prev;
+  prev.nghbr = pm->pmb_pack->pmb->nghbr;
+  prev.gids = pm->pmb_pack->gids;
+  prev.gide = pm->pmb_pack->gide;
+  prev.oldtonew = oldtonew;
+  prev.newtoold = newtoold;
+  prev.refine_flag = refine_flag.h_view.data();
+
   pm->pmb_pack->gids = pm->gids_eachrank[global_variable::my_rank];
   pm->pmb_pack->gide = pm->pmb_pack->gids + pm->nmb_eachrank[global_variable::my_rank]-1;
   pm->pmb_pack->nmb_thispack = pm->pmb_pack->gide - pm->pmb_pack->gids + 1;
@@ -675,7 +926,8 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   delete (pm->pmb_pack->pcoord);
   pm->pmb_pack->AddMeshBlocks(pin);
   pm->pmb_pack->AddCoordinates(pin);
-  pm->pmb_pack->pmb->SetNeighbors(pm->ptree, pm->rank_eachmb);
+  pm->plintree->Build(pm->lloc_eachmb, pm->nmb_total);
+  pm->pmb_pack->pmb->SetNeighbors(pm->plintree, pm->rank_eachmb, &prev);
 
   // clean-up and return
   delete [] newtoold;
@@ -686,10 +938,133 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   if ((pz4c == nullptr) && (padm != nullptr) && (nnew > 0 || ndel > 0)) {
     padm->SetADMVariables(pm->pmb_pack);
   }
+  if ((padm != nullptr) && (nnew > 0 || ndel > 0)) {
+    padm->metric_version++;
+  }
+  if ((pm->pmb_pack->pdyngr != nullptr) && (nnew > 0 || ndel > 0)) {
+    pm->pmb_pack->pdyngr->tmunu_stale = true;
+  }
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::MeasureCost()
+//! \brief Sets Mesh::cost_eachmb from the work counted on each MeshBlock (currently c2p
+//! iterations) since MeshBlocks were last redistributed, and the number of particles in
+//! each MeshBlock (each weighted by <loadbalancing>/prtcl_cost).  Costs are in units of
+//! the cost of updating every cell of a MeshBlock once, so MeshBlocks with no extra work
+//! have a cost of one.  With <loadbalancing>/rank_speed=true, also sets
+//! Mesh::speed_eachrank to the cost updated per second of Task time (excluding time
+//! waiting for communication) on each rank over the same cycles, normalized to a mean of
+//! one.  Collective over all ranks.
+
+void MeshRefinement::MeasureCost() {
+  Mesh *pm = pmy_mesh;
+  auto &mb_work = pm->pmb_pack->pmb->mb_work;
+  mb_work.template modify<DevExeSpace>();
+  mb_work.template sync<HostMemSpace>();
+
+  // count particles in each MeshBlock on device
+  int nmbs = pm->gids_eachrank[global_variable::my_rank];
+  DualArray1D<int> nprtcl_mb("nprtcl_mb", pm->nmb_thisrank);
+  Kokkos::deep_copy(nprtcl_mb.d_view, 0);
+  auto ppart = pm->pmb_pack->ppart;
+  if (ppart != nullptr) {
+    auto &pi = ppart->prtcl_idata;
+    auto &npmb = nprtcl_mb;
+    par_for("prtcl_cost",DevExeSpace(),0,(ppart->nprtcl_thispack-1),
+    KOKKOS_LAMBDA(const int p) {
+      Kokkos::atomic_increment(&npmb.d_view(pi(PGID,p) - nmbs));
+    });
+  }
+  nprtcl_mb.template modify<DevExeSpace>();
+  nprtcl_mb.template sync<HostMemSpace>();
+
+  Real ncells = static_cast<Real>(pm->NumberOfMeshBlockCells());
+  Real norm = ncells*std::max(ncyc_work_, 1);
+  for (int m=0; m<(pm->nmb_thisrank); ++m) {
+    Real cost = 1.0 + lb_c2p_cost*mb_work.h_view(m)/norm
+                    + lb_prtcl_cost*nprtcl_mb.h_view(m)/ncells;
+    pm->cost_eachmb[nmbs+m] = static_cast<float>(cost);
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allgatherv(MPI_IN_PLACE, pm->nmb_thisrank, MPI_FLOAT, pm->cost_eachmb,
+                 pm->nmb_eachrank, pm->gids_eachrank, MPI_FLOAT, MPI_COMM_WORLD);
+#endif
 
+  if (lb_rank_speed && ncyc_work_ > 0) {
+    int nranks = global_variable::nranks;
+    double work = 0.0;
+    for (int m=0; m<(pm->nmb_thisrank); ++m) {work += pm->cost_eachmb[nmbs+m];}
+    double busy = BusyTime() - busy_time0_;
+    std::vector<float> speed(nranks, 0.0);
+    speed[global_variable::my_rank] = (busy > 0.0)? work*ncyc_work_/busy : 0.0;
+#if MPI_PARALLEL_ENABLED
+    MPI_Allgather(MPI_IN_PLACE, 1, MPI_FLOAT, speed.data(), 1, MPI_FLOAT, MPI_COMM_WORLD);
+#endif
+    // keep previous speeds unless every rank has been timed
+    float total = 0.0;
+    bool timed = true;
+    for (int r=0; r<nranks; r++) {
+      total += speed[r];
+      if (!(speed[r] > 0.0)) {timed = false;}
+    }
+    if (timed) {
+      for (int r=0; r<nranks; r++) {pm->speed_eachrank[r] = nranks*speed[r]/total;}
+    }
+  }
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn double MeshRefinement::BusyTime()
+//! \brief Returns the total time (dvce_time) of all Tasks on this rank, minus the time
+//! spent in calls waiting for communication
+
+double MeshRefinement::BusyTime() {
+  double time = 0.0;
+  for (auto &it : pmy_mesh->pmb_pack->tl_map) {
+    for (auto &task : it.second->GetTasks()) {
+      time += task.dvce_time - task.wait_time;
+    }
+  }
+  return time;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool MeshRefinement::CheckLoadImbalance()
+//! \brief Measures cost of each MeshBlock, and returns true if the largest total cost on
+//! any rank exceeds the mean by more than <loadbalancing>/tolerance, and redistributing
+//! MeshBlocks with Mesh::LoadBalance() would reduce it.
+
+bool MeshRefinement::CheckLoadImbalance() {
+  Mesh *pm = pmy_mesh;
+  int nranks = global_variable::nranks;
+  if (nranks == 1) {return false;}
+  MeasureCost();
+
+  // largest total cost on any rank (divided by its speed) with current and with new
+  // distribution of MBs
+  std::vector<int> rlist(pm->nmb_total), slist(nranks), nlist(nranks);
+  pm->LoadBalance(pm->cost_eachmb, rlist.data(), slist.data(), nlist.data(),
+                  pm->nmb_total);
+  std::vector<float> cost_old(nranks, 0.0), cost_new(nranks, 0.0);
+  float total = 0.0;
+  for (int m=0; m<(pm->nmb_total); ++m) {
+    int r = pm->rank_eachmb[m];
+    cost_old[r] += pm->cost_eachmb[m]/pm->speed_eachrank[r];
+    cost_new[rlist[m]] += pm->cost_eachmb[m]/pm->speed_eachrank[rlist[m]];
+    total += pm->cost_eachmb[m];
+  }
+  float max_old = *std::max_element(cost_old.begin(), cost_old.end());
+  float max_new = *std::max_element(cost_new.begin(), cost_new.end());
+  int nmb_new = *std::max_element(nlist.begin(), nlist.end());
+
+  return ((max_old > (1.0 + lb_tolerance)*total/nranks) && (max_new < max_old) &&
+          (nmb_new <= pm->nmb_maxperrank));
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::DerefineCCSameRank
 //! \brief For any MeshBlock m flagged for derefinment (refine_flag = -nleaf), copies
@@ -812,45 +1187,79 @@ void MeshRefinement::DerefineFCSameRank(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Re
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void MeshRefinement::CopyCC
-//! \brief Copy cell-centered variables to new MB index within View for MeshBlocks that
-//! stay within this rank
-
-void MeshRefinement::CopyCC(DvceArray5D<Real> &a) {
+//! \fn void MeshRefinement::SetMoveList
+//! \brief Sets list of (old, new) index in Views of MeshBlocks that stay on this rank,
+//! but are moved to a new index.  Of the leafs of a de-refined MB, only the first (which
+//! stores the de-refined data) is moved.  MBs that change rank are communicated with MPI.
+//!
+//! Old and new indices both increase along the list, so an MB moved to a lower index
+//! never overwrites the old index of an MB moved to a higher one, and vice versa.  MBs
+//! moved down are listed in increasing order, followed by MBs moved up in decreasing
+//! order, so that the list can be moved in consecutive batches (see CopyCC()) without
+//! overwriting data of later batches.
+
+void MeshRefinement::SetMoveList() {
   int ombs = pmy_mesh->gids_eachrank[global_variable::my_rank];
   int ombe = ombs + pmy_mesh->nmb_eachrank[global_variable::my_rank] - 1;
+  int nmbs = new_gids_eachrank[global_variable::my_rank];
 
-  // Copy MBs for which (new gid) < (old gid) [Move L]
-  // loop over old MBs (note m=mbs cannot be moved)
-  for (int oldm=ombs+1; oldm<=ombe; ++oldm) {
-    int newm  = oldtonew[oldm];
-    int newm1 = oldtonew[oldm-1];
+  std::vector<std::pair<int,int>> moves;
+  for (int oldm=ombs; oldm<=ombe; ++oldm) {
+    int newm = oldtonew[oldm];
     // only move data if target array on this rank
     if (new_rank_eachmb[newm] != global_variable::my_rank) continue;
+    if ((oldm > ombs) && (newm == oldtonew[oldm-1])) continue;
     int msrc = oldm - ombs;
-    int mdst = newm - new_gids_eachrank[global_variable::my_rank];
-    // Only move MBs whose location in View moves L (mdst < msrc)
-    // Do not move MBs that have been de-refined (for which new[m] = new[m-1]).
-    if ( ((mdst - msrc) < 0) && (newm != newm1) ) {
-      auto src = Kokkos::subview(a,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst = Kokkos::subview(a,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst, src);
-    }
+    int mdst = newm - nmbs;
+    if (mdst != msrc) {moves.push_back(std::make_pair(msrc, mdst));}
+  }
+  auto up = std::stable_partition(moves.begin(), moves.end(),
+                     [](const std::pair<int,int> &mv) {return mv.second < mv.first;});
+  std::reverse(up, moves.end());
+  nmb_move = static_cast<int>(moves.size());
+  if (nmb_move == 0) return;
+
+  if (static_cast<int>(move_list.extent(0)) < nmb_move) {
+    Kokkos::realloc(move_list, nmb_move, 2);
   }
+  for (int l=0; l<nmb_move; ++l) {
+    move_list.h_view(l,0) = moves[l].first;
+    move_list.h_view(l,1) = moves[l].second;
+  }
+  move_list.template modify<HostMemSpace>();
+  move_list.template sync<DevExeSpace>();
+  return;
+}
 
-  // Copy MBs for which (new gid) > (old gid) [Move R]
-  for (int oldm=ombe; oldm>=ombs; --oldm) {
-    int newm  = oldtonew[oldm];
-    // only move data if target array on this rank
-    if (new_rank_eachmb[newm] != global_variable::my_rank) continue;
-    int msrc = oldm - ombs;
-    int mdst = newm - new_gids_eachrank[global_variable::my_rank];
-    // Only move MBs whose location in View moves R (mdst > msrc)
-    if ((mdst - msrc) > 0) {
-      auto src = Kokkos::subview(a,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst = Kokkos::subview(a,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst, src);
-    }
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::CopyCC
+//! \brief Copy cell-centered variables to new MB index within View for MeshBlocks that
+//! stay within this rank.  MBs in move_list are moved in batches of nmb_move_batch: the
+//! data of each batch is first gathered into a scratch array and then scattered to the
+//! new index, so MBs are moved without overwriting data yet to be moved (see
+//! SetMoveList()), while the scratch array holds at most nmb_move_batch MBs.
+
+void MeshRefinement::CopyCC(DvceArray5D<Real> &a) {
+  if (nmb_move == 0) return;
+  int nvar = a.extent_int(1);
+  int n3 = a.extent_int(2), n2 = a.extent_int(3), n1 = a.extent_int(4);
+  std::size_t nmb_data = static_cast<std::size_t>(nvar)*n3*n2*n1;
+  ReserveAMRData(move_data, std::min(nmb_move, nmb_move_batch)*nmb_data);
+  auto &mlist = move_list;
+  auto &mdata = move_data;
+
+  for (int l0=0; l0<nmb_move; l0+=nmb_move_batch) {
+    int nmov = std::min(nmb_move_batch, nmb_move - l0);
+    par_for("amr_gather_cc", DevExeSpace(), 0, nmov-1, 0, nvar-1,
+            0, n3-1, 0, n2-1, 0, n1-1,
+    KOKKOS_LAMBDA(const int l, const int n, const int k, const int j, const int i) {
+      mdata(l*nmb_data + ((n*n3 + k)*n2 + j)*n1 + i) = a(mlist.d_view(l0+l,0),n,k,j,i);
+    });
+    par_for("amr_scatter_cc", DevExeSpace(), 0, nmov-1, 0, nvar-1,
+            0, n3-1, 0, n2-1, 0, n1-1,
+    KOKKOS_LAMBDA(const int l, const int n, const int k, const int j, const int i) {
+      a(mlist.d_view(l0+l,1),n,k,j,i) = mdata(l*nmb_data + ((n*n3 + k)*n2 + j)*n1 + i);
+    });
   }
   return;
 }
@@ -858,54 +1267,29 @@ void MeshRefinement::CopyCC(DvceArray5D<Real> &a) {
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::CopyFC
 //! \brief Copy face-centered variables to new MB index within View for MeshBlocks that
-//! stay within this rank
+//! stay within this rank.  Moves each component as in CopyCC().
 
 void MeshRefinement::CopyFC(DvceFaceFld4D<Real> &b) {
-  int ombs = pmy_mesh->gids_eachrank[global_variable::my_rank];
-  int ombe = ombs + pmy_mesh->nmb_eachrank[global_variable::my_rank] - 1;
-
-  // Copy MBs for which (new gid) < (old gid) [Move L]
-  // loop over old MBs (note m=mbs cannot be moved)
-  for (int oldm=ombs+1; oldm<=ombe; ++oldm) {
-    int newm  = oldtonew[oldm];
-    int newm1 = oldtonew[oldm-1];
-    // only move data if target array on this rank
-    if (new_rank_eachmb[newm] != global_variable::my_rank) continue;
-    int msrc = oldm - ombs;
-    int mdst = newm - new_gids_eachrank[global_variable::my_rank];
-    // Only move MBs whose location in View moves L (mdst < msrc)
-    // Do not move MBs that have been de-refined (for which new[m] = new[m-1]).
-    if ( ((mdst - msrc) < 0) && (newm != newm1) ) {
-      auto src1 = Kokkos::subview(b.x1f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst1 = Kokkos::subview(b.x1f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst1, src1);
-      auto src2 = Kokkos::subview(b.x2f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst2 = Kokkos::subview(b.x2f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst2, src2);
-      auto src3 = Kokkos::subview(b.x3f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst3 = Kokkos::subview(b.x3f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst3, src3);
-    }
-  }
-
-  // Copy MBs for which (new gid) > (old gid) [Move R]
-  for (int oldm=ombe; oldm>=ombs; --oldm) {
-    int newm  = oldtonew[oldm];
-    // only move data if target array on this rank
-    if (new_rank_eachmb[newm] != global_variable::my_rank) continue;
-    int msrc = oldm - ombs;
-    int mdst = newm - new_gids_eachrank[global_variable::my_rank];
-    // Only move MBs whose location in View moves R (mdst > msrc)
-    if ((mdst - msrc) > 0) {
-      auto src1 = Kokkos::subview(b.x1f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst1 = Kokkos::subview(b.x1f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst1, src1);
-      auto src2 = Kokkos::subview(b.x2f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst2 = Kokkos::subview(b.x2f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst2, src2);
-      auto src3 = Kokkos::subview(b.x3f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst3 = Kokkos::subview(b.x3f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst3, src3);
+  if (nmb_move == 0) return;
+  auto &mlist = move_list;
+  DvceArray4D<Real> *pf[3] = {&(b.x1f), &(b.x2f), &(b.x3f)};
+  for (int dir=0; dir<3; ++dir) {
+    auto f = *(pf[dir]);
+    int n3 = f.extent_int(1), n2 = f.extent_int(2), n1 = f.extent_int(3);
+    std::size_t nmb_data = static_cast<std::size_t>(n3)*n2*n1;
+    ReserveAMRData(move_data, std::min(nmb_move, nmb_move_batch)*nmb_data);
+    auto &mdata = move_data;
+
+    for (int l0=0; l0<nmb_move; l0+=nmb_move_batch) {
+      int nmov = std::min(nmb_move_batch, nmb_move - l0);
+      par_for("amr_gather_fc", DevExeSpace(), 0, nmov-1, 0, n3-1, 0, n2-1, 0, n1-1,
+      KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+        mdata(l*nmb_data + (k*n2 + j)*n1 + i) = f(mlist.d_view(l0+l,0),k,j,i);
+      });
+      par_for("amr_scatter_fc", DevExeSpace(), 0, nmov-1, 0, n3-1, 0, n2-1, 0, n1-1,
+      KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+        f(mlist.d_view(l0+l,1),k,j,i) = mdata(l*nmb_data + (k*n2 + j)*n1 + i);
+      });
     }
   }
   return;
@@ -1104,7 +1488,9 @@ void MeshRefinement::RefineCC(DualArray1D<int> &n2o, DvceArray5D<Real> &a,
 
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::RefineFC
-//! \brief Same as RefineCC, except for face-centered arrays
+//! \brief Same as RefineCC, except for face-centered arrays.  All three components at
+//! shared faces and the internal faces of every new MeshBlock are prolongated in a single
+//! kernel, with one team per MeshBlock so internal faces can be computed after a barrier.
 
 void MeshRefinement::RefineFC(DualArray1D<int> &n2o, DvceFaceFld4D<Real> &b,
                               DvceFaceFld4D<Real> &cb) {
@@ -1117,54 +1503,57 @@ void MeshRefinement::RefineFC(DualArray1D<int> &n2o, DvceFaceFld4D<Real> &b,
   auto &cjs = indcs.cjs, &cje = indcs.cje;
   auto &cks = indcs.cks, &cke = indcs.cke;
 
-  // First prolongate face-centered fields at shared faces betwen fine and coarse cells
   auto &refine_flag_ = refine_flag;
+  bool &one_d = pmy_mesh->one_d;
   bool &multi_d = pmy_mesh->multi_d;
   bool &three_d = pmy_mesh->three_d;
   auto &ngids_ = new_gids_eachrank[global_variable::my_rank];
-
-  // Prolongate x1f
-  par_for("RefineFC1",DevExeSpace(), 0,(new_nmb-1), cks,cke, cjs,cje, cis,cie+1,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    if (refine_flag_.d_view(n2o.d_view(m+ngids_)) > 0) {
-      // fine indices refer to target array
-      int fi = (i - cis)*2 + is;                   // fine i
-      int fj = (multi_d)? ((j - cjs)*2 + js) : j;  // fine j
-      int fk = (three_d)? ((k - cks)*2 + ks) : k;  // fine k
-      ProlongFCSharedX1Face(m,k,j,i,fk,fj,fi,multi_d,three_d,cb.x1f,b.x1f);
-    }
-  });
-
-  // Prolongate x2f
-  par_for("RefineFC2",DevExeSpace(), 0,(new_nmb-1), cks,cke, cjs,cje+1, cis,cie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    if (refine_flag_.d_view(n2o.d_view(m+ngids_)) > 0) {
-      // fine indices refer to target array
-      int fi = (i - cis)*2 + is;                   // fine i
-      int fj = (multi_d)? ((j - cjs)*2 + js) : j;  // fine j
-      int fk = (three_d)? ((k - cks)*2 + ks) : k;  // fine k
-      ProlongFCSharedX2Face(m,k,j,i,fk,fj,fi,three_d,cb.x2f,b.x2f);
-    }
-  });
-
-  // Prolongate x3f
-  par_for("RefineFC3",DevExeSpace(), 0,(new_nmb-1), cks,cke+1, cjs,cje, cis,cie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    if (refine_flag_.d_view(n2o.d_view(m+ngids_)) > 0) {
+  // Outer loop over # of new MeshBlocks
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), new_nmb, Kokkos::AUTO);
+  Kokkos::parallel_for("RefineFC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int m = tmember.league_rank();
+    if (refine_flag_.d_view(n2o.d_view(m+ngids_)) <= 0) return;
+
+    // First prolongate face-centered fields at shared faces betwen fine and coarse cells.
+    // Loop covers faces of all three components, each guarded by its own range.
+    const int ni = cie - cis + 2;
+    const int nj = cje - cjs + 2;
+    const int nk = cke - cks + 2;
+    const int nkji = nk*nj*ni;
+    const int nji  = nj*ni;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkji), [&](const int idx) {
+      int k = (idx)/nji;
+      int j = (idx - k*nji)/ni;
+      int i = (idx - k*nji - j*ni) + cis;
+      k += cks;
+      j += cjs;
       // fine indices refer to target array
       int fi = (i - cis)*2 + is;                   // fine i
       int fj = (multi_d)? ((j - cjs)*2 + js) : j;  // fine j
       int fk = (three_d)? ((k - cks)*2 + ks) : k;  // fine k
-      ProlongFCSharedX3Face(m,k,j,i,fk,fj,fi,multi_d,cb.x3f,b.x3f);
-    }
-  });
-
-  // Second prolongate face-centered fields at internal faces of fine cells using
-  // divergence-preserving operator of Toth & Roe (2002)
-  bool &one_d = pmy_mesh->one_d;
-  par_for("RefineFC-int",DevExeSpace(), 0,(new_nmb-1), cks,cke, cjs,cje, cis,cie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    if (refine_flag_.d_view(n2o.d_view(m+ngids_)) > 0) {
+      if (j <= cje && k <= cke) {
+        ProlongFCSharedX1Face(m,k,j,i,fk,fj,fi,multi_d,three_d,cb.x1f,b.x1f);
+      }
+      if (i <= cie && k <= cke) {
+        ProlongFCSharedX2Face(m,k,j,i,fk,fj,fi,three_d,cb.x2f,b.x2f);
+      }
+      if (i <= cie && j <= cje) {
+        ProlongFCSharedX3Face(m,k,j,i,fk,fj,fi,multi_d,cb.x3f,b.x3f);
+      }
+    });
+    tmember.team_barrier();
+
+    // Second prolongate face-centered fields at internal faces of fine cells using
+    // divergence-preserving operator of Toth & Roe (2002)
+    const int nci = cie - cis + 1;
+    const int ncji = (cje - cjs + 1)*nci;
+    const int nckji = (cke - cks + 1)*ncji;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nckji), [&](const int idx) {
+      int k = (idx)/ncji;
+      int j = (idx - k*ncji)/nci;
+      int i = (idx - k*ncji - j*nci) + cis;
+      k += cks;
+      j += cjs;
       // fine indices refer to target array
       int fi = (i - cis)*2 + is;   // fine i
       int fj = (j - cjs)*2 + js;   // fine j
@@ -1177,7 +1566,7 @@ void MeshRefinement::RefineFC(DualArray1D<int> &n2o, DvceFaceFld4D<Real> &b,
         // in multi-D call inlined prolongation operator for FC fields at internal faces
         ProlongFCInternal(m,fk,fj,fi,three_d,b);
       }
-    }
+    });
   });
 
   return;
@@ -1207,7 +1596,7 @@ void MeshRefinement::RestrictCC(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
     par_for("restrictCC-1D",DevExeSpace(), 0,nmb-1, 0,nvar-1, cis,cie,
     KOKKOS_LAMBDA(const int m, const int n, const int i) {
       int finei = 2*i - cis;  // correct when cis=is
-      cu(m,n,cks,cjs,i) = 0.5*(u(m,n,cks,cjs,finei) + u(m,n,cks,cjs,finei+1));
+      cu(m,n,cks,cjs,i) = RestrictAverage(m,n,cks,cjs,finei,0,0,1,u);
     });
   // restrict in 2D
   } else if (pmy_mesh->two_d) {
@@ -1215,8 +1604,7 @@ void MeshRefinement::RestrictCC(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
     KOKKOS_LAMBDA(const int m, const int n, const int j, const int i) {
       int finei = 2*i - cis;  // correct when cis=is
       int finej = 2*j - cjs;  // correct when cjs=js
-      cu(m,n,cks,j,i) = 0.25*(u(m,n,cks,finej  ,finei) + u(m,n,cks,finej  ,finei+1)
-                            + u(m,n,cks,finej+1,finei) + u(m,n,cks,finej+1,finei+1));
+      cu(m,n,cks,j,i) = RestrictAverage(m,n,cks,finej,finei,0,1,1,u);
     });
 
   // restrict in 3D
@@ -1227,11 +1615,7 @@ void MeshRefinement::RestrictCC(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
       int finej = 2*j - cjs;  // correct when cjs=js
       int finek = 2*k - cks;  // correct when cks=ks
       if (!is_z4c) {
-        cu(m,n,k,j,i) =
-            0.125*(u(m,n,finek  ,finej  ,finei) + u(m,n,finek  ,finej  ,finei+1)
-                + u(m,n,finek  ,finej+1,finei) + u(m,n,finek  ,finej+1,finei+1)
-                + u(m,n,finek+1,finej,  finei) + u(m,n,finek+1,finej,  finei+1)
-                + u(m,n,finek+1,finej+1,finei) + u(m,n,finek+1,finej+1,finei+1));
+        cu(m,n,k,j,i) = RestrictAverage(m,n,finek,finej,finei,1,1,1,u);
       } else {
         switch (indcs.ng) {
           case 2: cu(m,n,k,j,i) = RestrictInterpolation<2>(m,n,finek,finej,finei,
@@ -18,6 +18,25 @@ static int CreateAMR_MPI_Tag(int lid, int ox1, int ox2, int ox3) {
   return (ox1<<(NUM_BITS_LID+2)) | (ox2<<(NUM_BITS_LID+1))| (ox3<<(NUM_BITS_LID)) | lid;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void ReserveAMRData(ViewType &v, std::size_t n)
+//! \brief Ensures the 1D data buffer v holds at least n elements. Buffers grow
+//! geometrically, and only shrink when much larger than needed, so that allocations are
+//! reused over successive AMR steps rather than freed and reallocated every step.
+
+template <typename ViewType>
+inline void ReserveAMRData(ViewType &v, std::size_t n) {
+  std::size_t cap = v.extent(0);
+  if (n > cap) {
+    Kokkos::realloc(v, std::max(n, cap + cap/2));
+  } else if (n < cap/4) {
+    Kokkos::realloc(v, n + n/2);
+  }
+}
+
+// Forward declarations
+struct ParticleMessageData;
+
 //----------------------------------------------------------------------------------------
 //! \struct AMRBuffer
 //! \brief container for index ranges, storage, and flags for AMR buffers used with load
@@ -47,10 +66,21 @@ class MeshRefinement {
   int nmb_created;           // # of MeshBlocks created via AMR across all ranks
   int nmb_deleted;           // # of MeshBlocks deleted via AMR across all ranks
   int nmb_sent_thisrank;     // # of MeshBlocks sent during load balancing on this rank
+  int nref_deferred;         // # of times refinement deferred by max MeshBlocks per rank
+  double amr_time;           // wall time in AdaptiveMeshRefinement() on this rank (s)
   int ncyc_check_amr;        // # of cycles between checking mesh for ref/derefinement
   int refinement_interval;   // # of cycles between allowing successive ref/derefinement
   bool prolong_prims;        // flag to enable prolongation of primitive vars
 
+  // load balancing parameters, read from <loadbalancing> block
+  bool lb_automatic;         // use measured (rather than uniform) cost of each MeshBlock
+  bool lb_incremental;       // shift old rank boundaries rather than repartition MBs
+  int lb_interval;           // # of cycles between checks of load imbalance
+  Real lb_tolerance;         // maximum fractional load imbalance before redistributing
+  Real lb_c2p_cost;          // cost of one c2p iteration relative to one cell update
+  Real lb_prtcl_cost;        // cost of pushing one particle relative to one cell update
+  bool lb_rank_speed;        // weight cost given to each rank by its measured speed
+
   // following 2x Views are dimensioned [nmb_total]
   DualArray1D<int> refine_flag;    // refinement flag for each MeshBlock
   HostArray1D<int> ncyc_since_ref; // # of cycles since MB last refined/derefined
@@ -73,6 +103,13 @@ class MeshRefinement {
   int *new_gids_eachrank;      // starting global ID of MeshBlocks in each rank
   int *new_nmb_eachrank;       // number of MeshBlocks on each rank
 
+  // (old,new) index in Views of MBs that stay on this rank but move to a new index, and
+  // scratch data used to move them, at most nmb_move_batch MBs of one array at a time
+  static constexpr int nmb_move_batch = 16;
+  int nmb_move;
+  DualArray2D<int> move_list;
+  DvceArray1D<Real> move_data;
+
   // Lagrange Interpolation weights for prolongation and restriction operators
   // naming convention: {prolong/restrict}_{order of interpolation}_{optional index}
   struct InterpWeight {
@@ -90,17 +127,25 @@ class MeshRefinement {
   DualArray1D<AMRBuffer> sendbuf, recvbuf; // send/recv buffers
   MPI_Request *send_req, *recv_req;
   DvceArray1D<Real> send_data, recv_data;    // send/recv device data
+  PinnedArray1D<Real> send_data_h, recv_data_h;  // host copies (mpi_host_staging only)
+  // MeshBlock messages sent/received, with which particles are also sent
+  std::vector<ParticleMessageData> prtcl_sends, prtcl_recvs;
 #endif
 
   // functions
   void CheckForRefinement(MeshBlockPack* pmbp);
   void AdaptiveMeshRefinement(Driver *pdrive, ParameterInput *pin);
   void UpdateMeshBlockTree(int &nnew, int &ndel);
+  std::vector<LogicalLocation> RefinementBuffer(LogicalLocation *llref, int nref);
   void RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, int ndel);
+  void MeasureCost();
+  bool CheckLoadImbalance();
+  bool IncrementalLoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb);
 
   void DerefineCCSameRank(DvceArray5D<Real> &a, DvceArray5D<Real> &ca);
   void DerefineFCSameRank(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
 
+  void SetMoveList();
   void CopyCC(DvceArray5D<Real> &a);
   void CopyFC(DvceFaceFld4D<Real> &b);
 
@@ -133,5 +178,9 @@ class MeshRefinement {
   Mesh *pmy_mesh;
   Real d_threshold_, dd_threshold_, dp_threshold_, dv_threshold_, chi_threshold_;
   bool check_cons_;
+  int nbuffer_;     // width (in MeshBlocks) of buffer refined around flagged MeshBlocks
+  int ncyc_work_;   // # of cycles over which work on each MeshBlock has been counted
+  double busy_time0_;  // value of BusyTime() when work counting started
+  double BusyTime();
 };
 #endif // MESH_MESH_REFINEMENT_HPP_
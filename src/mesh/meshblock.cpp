@@ -27,7 +27,10 @@ MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb) :
   mb_gid("mb_gid",nmb),
   mb_lev("mb_lev",nmb),
   mb_size("mbsize",nmb),
-  mb_bcs("mbbcs",nmb,6) {
+  mb_bcs("mbbcs",nmb,6),
+  mb_work("mb_work",nmb),
+  bc_mblist("bc_mblist",3,nmb),
+  bc_facelist("bc_facelist",6*nmb) {
   Mesh* pm = pmy_pack->pmesh;
   auto &ms = pm->mesh_size;
 
@@ -118,16 +121,52 @@ MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb) :
                             static_cast<Real>(pm->mb_indcs.nx3);
   }
 
+  // lists of MeshBlocks with physical BCs in each direction.  Faces shared with other
+  // MeshBlocks, or with periodic/shearing-periodic/user BCs, need no physical BC kernel.
+  for (int dir=0; dir<3; ++dir) {
+    nbc_mb[dir] = 0;
+    for (int m=0; m<nmb; ++m) {
+      bool physical = false;
+      for (int f=2*dir; f<2*dir+2; ++f) {
+        BoundaryFlag bc = mb_bcs.h_view(m,f);
+        if (bc != BoundaryFlag::block && bc != BoundaryFlag::periodic &&
+            bc != BoundaryFlag::shear_periodic && bc != BoundaryFlag::user &&
+            bc != BoundaryFlag::undef) {
+          physical = true;
+        }
+      }
+      if (physical) {
+        bc_mblist.h_view(dir,nbc_mb[dir]) = m;
+        nbc_mb[dir]++;
+      }
+    }
+  }
+  nbc_face = 0;
+  for (int m=0; m<nmb; ++m) {
+    for (int f=0; f<6; ++f) {
+      BoundaryFlag bc = mb_bcs.h_view(m,f);
+      if (bc != BoundaryFlag::block && bc != BoundaryFlag::periodic &&
+          bc != BoundaryFlag::shear_periodic && bc != BoundaryFlag::undef) {
+        bc_facelist.h_view(nbc_face) = 6*m + f;
+        nbc_face++;
+      }
+    }
+  }
+
   // For each DualArray: mark host views as modified, and then sync to device array
   mb_gid.template modify<HostMemSpace>();
   mb_lev.template modify<HostMemSpace>();
   mb_size.template modify<HostMemSpace>();
   mb_bcs.template modify<HostMemSpace>();
+  bc_mblist.template modify<HostMemSpace>();
+  bc_facelist.template modify<HostMemSpace>();
 
   mb_gid.template sync<DevExeSpace>();
   mb_lev.template sync<DevExeSpace>();
   mb_size.template sync<DevExeSpace>();
   mb_bcs.template sync<DevExeSpace>();
+  bc_mblist.template sync<DevExeSpace>();
+  bc_facelist.template sync<DevExeSpace>();
 }
 
 //----------------------------------------------------------------------------------------
@@ -138,8 +177,12 @@ MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb) :
 // Information about Neighbors are stored in a 2D Dual view of NeighborBlock structs
 // Indices of the view are (m,n) = (no. of MBs, no. of neighbors)
 // Based on SearchAndSetNeighbors() function in /src/bvals/bvals_base.cpp in C++ version
+// Neighbors are found with binary searches of the LinearMeshTree.
+// After AMR, neighbors of the old MeshBlocks can be passed in pprev, in which case the
+// tree is only searched for MeshBlocks whose neighborhood was changed.
 
-void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklist) {
+void MeshBlock::SetNeighbors(std::unique_ptr<LinearMeshTree> &plt, int *ranklist,
+                             const PrevNeighbors *pprev) {
   // min number of array elements needed to store MeshBlock neighbors withe SMR/AMR
   // Note not all buffers will be allocated for all nghbrs
   if (pmy_pack->pmesh->one_d) {nnghbr = 8;}
@@ -168,8 +211,12 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
     if (pmy_pack->pmesh->three_d) nfz = 2;
   }
 
-  // Search MeshBlock tree and find neighbors
-  for (int b=0; b<nmb; ++b) {
+  // Search MeshBlock tree and find neighbors.  Each MeshBlock only writes its own row of
+  // nghbr, and searches of the tree are read-only, so MeshBlocks are processed in
+  // parallel on the host.
+  using HostRange = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>;
+  Kokkos::parallel_for("SetNeighbors", HostRange(0, nmb), [&](const int b) {
+    if ((pprev != nullptr) && CopyPrevNeighbors(b, ranklist, *pprev)) {return;}
     LogicalLocation lloc = pmy_pack->pmesh->lloc_eachmb[mb_gid.h_view(b)];
 
     // find location of this MeshBlock relative to XXXX
@@ -183,32 +230,32 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
 
     // neighbors on x1face
     for (int n=-1; n<=1; n+=2) {
-      MeshBlockTree* nt = ptree->FindNeighbor(lloc, n, 0, 0);
-      if (nt != nullptr) {
-        if (nt->pleaf_ != nullptr) {  // neighbor at finer level -- requires subblocks
+      LinearTreeNode nt = plt->FindNeighbor(lloc, n, 0, 0);
+      if (nt.Exists()) {
+        if (nt.refined) {  // neighbor at finer level -- requires subblocks
           int ffx = 1 - (n + 1)/2; // 0 for BoundaryFace::outer_x1, 1 for inner_x1
           for (int fz=0; fz<nfz; fz++) {
             for (int fy = 0; fy<nfy; fy++) {
-              MeshBlockTree* nf = nt->GetLeaf(ffx, fy, fz);
+              LinearTreeNode nf = plt->GetLeaf(nt, ffx, fy, fz);
               int inghbr = NeighborIndex(n,0,0,fy,fz);
-              nghbr.h_view(b,inghbr).gid = nf->gid_;
-              nghbr.h_view(b,inghbr).lev = nf->lloc_.level;
-              nghbr.h_view(b,inghbr).rank = ranklist[nf->gid_];
+              nghbr.h_view(b,inghbr).gid = nf.gid;
+              nghbr.h_view(b,inghbr).lev = nf.lloc.level;
+              nghbr.h_view(b,inghbr).rank = ranklist[nf.gid];
               nghbr.h_view(b,inghbr).dest = NeighborIndex(-n,0,0,fy,fz);
             }
           }
         } else {   // neighbor at same or coarser level
           int idest, inghbr;
-          if (nt->lloc_.level == lloc.level) { // neighbor at same level -- no subblocks
+          if (nt.lloc.level == lloc.level) { // neighbor at same level -- no subblocks
             inghbr = NeighborIndex(n,0,0,0,0);
             idest = NeighborIndex(-n,0,0,0,0);
           } else { // neighbor at coarser level, set index/destn to appropriate subblock
             inghbr = NeighborIndex(n,0,0,myfx2,myfx3);
             idest = NeighborIndex(-n,0,0,myfx2,myfx3);
           }
-          nghbr.h_view(b,inghbr).gid = nt->gid_;
-          nghbr.h_view(b,inghbr).lev = nt->lloc_.level;
-          nghbr.h_view(b,inghbr).rank = ranklist[nt->gid_];
+          nghbr.h_view(b,inghbr).gid = nt.gid;
+          nghbr.h_view(b,inghbr).lev = nt.lloc.level;
+          nghbr.h_view(b,inghbr).rank = ranklist[nt.gid];
           nghbr.h_view(b,inghbr).dest = idest;
         }
       }
@@ -217,32 +264,32 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
     // neighbors on x2face
     if (pmy_pack->pmesh->multi_d) {
       for (int m=-1; m<=1; m+=2) {
-        MeshBlockTree* nt = ptree->FindNeighbor(lloc, 0, m, 0);
-        if (nt != nullptr) {
-          if (nt->pleaf_ != nullptr) {  // neighbor at finer level -- requires subblocks
+        LinearTreeNode nt = plt->FindNeighbor(lloc, 0, m, 0);
+        if (nt.Exists()) {
+          if (nt.refined) {  // neighbor at finer level -- requires subblocks
             int ffy = 1 - (m + 1)/2; // 0 for BoundaryFace::outer_x2, 1 for inner_x2
             for (int fz=0; fz<nfz; fz++) {
               for (int fx = 0; fx<nfx; fx++) {
-                MeshBlockTree* nf = nt->GetLeaf(fx, ffy, fz);
+                LinearTreeNode nf = plt->GetLeaf(nt, fx, ffy, fz);
                 int inghbr = NeighborIndex(0,m,0,fx,fz);
-                nghbr.h_view(b,inghbr).gid = nf->gid_;
-                nghbr.h_view(b,inghbr).lev = nf->lloc_.level;
-                nghbr.h_view(b,inghbr).rank = ranklist[nf->gid_];
+                nghbr.h_view(b,inghbr).gid = nf.gid;
+                nghbr.h_view(b,inghbr).lev = nf.lloc.level;
+                nghbr.h_view(b,inghbr).rank = ranklist[nf.gid];
                 nghbr.h_view(b,inghbr).dest = NeighborIndex(0,-m,0,fx,fz);
               }
             }
           } else {   // neighbor at same or coarser level
             int idest,inghbr;
-            if (nt->lloc_.level == lloc.level) { // neighbor at same level -- no subblocks
+            if (nt.lloc.level == lloc.level) { // neighbor at same level -- no subblocks
               inghbr = NeighborIndex(0,m,0,0,0);
               idest = NeighborIndex(0,-m,0,0,0);
             } else { // neighbor at coarser level, set index/destn to appropriate subblock
               inghbr = NeighborIndex(0,m,0,myfx1,myfx3);
               idest = NeighborIndex(0,-m,0,myfx1,myfx3);
             }
-            nghbr.h_view(b,inghbr).gid = nt->gid_;
-            nghbr.h_view(b,inghbr).lev = nt->lloc_.level;
-            nghbr.h_view(b,inghbr).rank = ranklist[nt->gid_];
+            nghbr.h_view(b,inghbr).gid = nt.gid;
+            nghbr.h_view(b,inghbr).lev = nt.lloc.level;
+            nghbr.h_view(b,inghbr).rank = ranklist[nt.gid];
             nghbr.h_view(b,inghbr).dest = idest;
           }
         }
@@ -251,22 +298,22 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
       // neighbors on x1x2 edges
       for (int m=-1; m<=1; m+=2) {
         for (int n=-1; n<=1; n+=2) {
-          MeshBlockTree* nt = ptree->FindNeighbor(lloc, n, m, 0);
-          if (nt != nullptr) {
-            if (nt->pleaf_ != nullptr) {  // neighbor at finer level -- requires subblocks
+          LinearTreeNode nt = plt->FindNeighbor(lloc, n, m, 0);
+          if (nt.Exists()) {
+            if (nt.refined) {  // neighbor at finer level -- requires subblocks
               int ffx = 1 - (n + 1)/2; // 0 for BoundaryFace::outer_x1, 1 for inner_x1
               int ffy = 1 - (m + 1)/2; // 0 for BoundaryFace::outer_x2, 1 for inner_x2
               for (int fz=0; fz<nfz; fz++) {
-                MeshBlockTree* nf = nt->GetLeaf(ffx, ffy, fz);
+                LinearTreeNode nf = plt->GetLeaf(nt, ffx, ffy, fz);
                 int inghbr = NeighborIndex(n,m,0,fz,0);
-                nghbr.h_view(b,inghbr).gid = nf->gid_;
-                nghbr.h_view(b,inghbr).lev = nf->lloc_.level;
-                nghbr.h_view(b,inghbr).rank = ranklist[nf->gid_];
+                nghbr.h_view(b,inghbr).gid = nf.gid;
+                nghbr.h_view(b,inghbr).lev = nf.lloc.level;
+                nghbr.h_view(b,inghbr).rank = ranklist[nf.gid];
                 nghbr.h_view(b,inghbr).dest = NeighborIndex(-n,-m,0,fz,0);
               }
             } else {   // neighbor at same or coarser level
               int idest,inghbr;
-              if (nt->lloc_.level == lloc.level) { // same level -- no subblocks
+              if (nt.lloc.level == lloc.level) { // same level -- no subblocks
                 inghbr = NeighborIndex(n,m,0,0,0);
                 idest = NeighborIndex(-n,-m,0,0,0);
               } else { // neighbor at coarser level, set indx/dest to appropriate subblock
@@ -274,10 +321,10 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
                 idest = NeighborIndex(-n,-m,0,myfx3,0);
               }
               // only set neighbor for exterior edges of coarser face
-              if (nt->lloc_.level >= lloc.level || (myox1 == n && myox2 == m)) {
-                nghbr.h_view(b,inghbr).gid = nt->gid_;
-                nghbr.h_view(b,inghbr).lev = nt->lloc_.level;
-                nghbr.h_view(b,inghbr).rank = ranklist[nt->gid_];
+              if (nt.lloc.level >= lloc.level || (myox1 == n && myox2 == m)) {
+                nghbr.h_view(b,inghbr).gid = nt.gid;
+                nghbr.h_view(b,inghbr).lev = nt.lloc.level;
+                nghbr.h_view(b,inghbr).rank = ranklist[nt.gid];
                 nghbr.h_view(b,inghbr).dest = idest;
               }
             }
@@ -289,32 +336,32 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
     // neighbors on x3face
     if (pmy_pack->pmesh->three_d) {
       for (int l=-1; l<=1; l+=2) {
-        MeshBlockTree* nt = ptree->FindNeighbor(lloc, 0, 0, l);
-        if (nt != nullptr) {
-          if (nt->pleaf_ != nullptr) {  // neighbor at finer level -- requires subblocks
+        LinearTreeNode nt = plt->FindNeighbor(lloc, 0, 0, l);
+        if (nt.Exists()) {
+          if (nt.refined) {  // neighbor at finer level -- requires subblocks
             int ffz = 1 - (l + 1)/2; // 0 for BoundaryFace::outer_x3, 1 for inner_x3
             for (int fy=0; fy<nfy; fy++) {
               for (int fx = 0; fx<nfx; fx++) {
-                MeshBlockTree* nf = nt->GetLeaf(fx, fy, ffz);
+                LinearTreeNode nf = plt->GetLeaf(nt, fx, fy, ffz);
                 int inghbr = NeighborIndex(0,0,l,fx,fy);
-                nghbr.h_view(b,inghbr).gid = nf->gid_;
-                nghbr.h_view(b,inghbr).lev = nf->lloc_.level;
-                nghbr.h_view(b,inghbr).rank = ranklist[nf->gid_];
+                nghbr.h_view(b,inghbr).gid = nf.gid;
+                nghbr.h_view(b,inghbr).lev = nf.lloc.level;
+                nghbr.h_view(b,inghbr).rank = ranklist[nf.gid];
                 nghbr.h_view(b,inghbr).dest = NeighborIndex(0,0,-l,fx,fy);
               }
             }
           } else {   // neighbor at same or coarser level -- no subblocks
             int idest,inghbr;
-            if (nt->lloc_.level == lloc.level) { // neighbor at same level
+            if (nt.lloc.level == lloc.level) { // neighbor at same level
               inghbr = NeighborIndex(0,0,l,0,0);
               idest = NeighborIndex(0,0,-l,0,0);
             } else { // neighbor at coarser level, set index/destn to appropriate subblock
               inghbr = NeighborIndex(0,0,l,myfx1,myfx2);
               idest = NeighborIndex(0,0,-l,myfx1,myfx2);
             }
-            nghbr.h_view(b,inghbr).gid = nt->gid_;
-            nghbr.h_view(b,inghbr).lev = nt->lloc_.level;
-            nghbr.h_view(b,inghbr).rank = ranklist[nt->gid_];
+            nghbr.h_view(b,inghbr).gid = nt.gid;
+            nghbr.h_view(b,inghbr).lev = nt.lloc.level;
+            nghbr.h_view(b,inghbr).rank = ranklist[nt.gid];
             nghbr.h_view(b,inghbr).dest = idest;
           }
         }
@@ -323,22 +370,22 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
       // neighbors on x3x1 edges
       for (int l=-1; l<=1; l+=2) {
         for (int n=-1; n<=1; n+=2) {
-          MeshBlockTree* nt = ptree->FindNeighbor(lloc, n, 0, l);
-          if (nt != nullptr) {
-            if (nt->pleaf_ != nullptr) {  // neighbor at finer level -- requires subblocks
+          LinearTreeNode nt = plt->FindNeighbor(lloc, n, 0, l);
+          if (nt.Exists()) {
+            if (nt.refined) {  // neighbor at finer level -- requires subblocks
               int ffx = 1 - (n + 1)/2; // 0 for BoundaryFace::outer_x1, 1 for inner_x1
               int ffz = 1 - (l + 1)/2; // 0 for BoundaryFace::outer_x3, 1 for inner_x3
               for (int fy=0; fy<nfy; fy++) {
-                MeshBlockTree* nf = nt->GetLeaf(ffx, fy, ffz);
+                LinearTreeNode nf = plt->GetLeaf(nt, ffx, fy, ffz);
                 int inghbr = NeighborIndex(n,0,l,fy,0);
-                nghbr.h_view(b,inghbr).gid = nf->gid_;
-                nghbr.h_view(b,inghbr).lev = nf->lloc_.level;
-                nghbr.h_view(b,inghbr).rank = ranklist[nf->gid_];
+                nghbr.h_view(b,inghbr).gid = nf.gid;
+                nghbr.h_view(b,inghbr).lev = nf.lloc.level;
+                nghbr.h_view(b,inghbr).rank = ranklist[nf.gid];
                 nghbr.h_view(b,inghbr).dest = NeighborIndex(-n,0,-l,fy,0);
               }
             } else {   // neighbor at same or coarser level -- no subblocks
               int idest,inghbr;
-              if (nt->lloc_.level == lloc.level) { // neighbor at same level
+              if (nt.lloc.level == lloc.level) { // neighbor at same level
                 inghbr = NeighborIndex(n,0,l,0,0);
                 idest = NeighborIndex(-n,0,-l,0,0);
               } else { // neighbor at coarser level, set indx/dest to appropriate subblock
@@ -346,10 +393,10 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
                 idest = NeighborIndex(-n,0,-l,myfx2,0);
               }
               // only set neighbor for exterior edges of coarser face
-              if (nt->lloc_.level >= lloc.level || (myox1 == n && myox3 == l)) {
-                nghbr.h_view(b,inghbr).gid = nt->gid_;
-                nghbr.h_view(b,inghbr).lev = nt->lloc_.level;
-                nghbr.h_view(b,inghbr).rank = ranklist[nt->gid_];
+              if (nt.lloc.level >= lloc.level || (myox1 == n && myox3 == l)) {
+                nghbr.h_view(b,inghbr).gid = nt.gid;
+                nghbr.h_view(b,inghbr).lev = nt.lloc.level;
+                nghbr.h_view(b,inghbr).rank = ranklist[nt.gid];
                 nghbr.h_view(b,inghbr).dest = idest;
               }
             }
@@ -360,22 +407,22 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
       // neighbors on x2x3 edges
       for (int l=-1; l<=1; l+=2) {
         for (int m=-1; m<=1; m+=2) {
-          MeshBlockTree* nt = ptree->FindNeighbor(lloc, 0, m, l);
-          if (nt != nullptr) {
-            if (nt->pleaf_ != nullptr) {  // neighbor at finer level -- requires subblocks
+          LinearTreeNode nt = plt->FindNeighbor(lloc, 0, m, l);
+          if (nt.Exists()) {
+            if (nt.refined) {  // neighbor at finer level -- requires subblocks
               int ffy = 1 - (m + 1)/2; // 0 for BoundaryFace::outer_x2, 1 for inner_x2
               int ffz = 1 - (l + 1)/2; // 0 for BoundaryFace::outer_x3, 1 for inner_x3
               for (int fx=0; fx<nfy; fx++) {
-                MeshBlockTree* nf = nt->GetLeaf(fx, ffy, ffz);
+                LinearTreeNode nf = plt->GetLeaf(nt, fx, ffy, ffz);
                 int inghbr = NeighborIndex(0,m,l,fx,0);
-                nghbr.h_view(b,inghbr).gid = nf->gid_;
-                nghbr.h_view(b,inghbr).lev = nf->lloc_.level;
-                nghbr.h_view(b,inghbr).rank = ranklist[nf->gid_];
+                nghbr.h_view(b,inghbr).gid = nf.gid;
+                nghbr.h_view(b,inghbr).lev = nf.lloc.level;
+                nghbr.h_view(b,inghbr).rank = ranklist[nf.gid];
                 nghbr.h_view(b,inghbr).dest = NeighborIndex(0,-m,-l,fx,0);
               }
             } else {   // neighbor at same or coarser level -- no subblocks
               int idest,inghbr;
-              if (nt->lloc_.level == lloc.level) { // neighbor at same level
+              if (nt.lloc.level == lloc.level) { // neighbor at same level
                 inghbr = NeighborIndex(0,m,l,0,0);
                 idest = NeighborIndex(0,-m,-l,0,0);
               } else { // neighbor at coarser level, set indx/dest to appropriate subblock
@@ -383,10 +430,10 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
                 idest = NeighborIndex(0,-m,-l,myfx1,0);
               }
               // only set neighbor for exterior edges of coarser face
-              if (nt->lloc_.level >= lloc.level || (myox2 == m && myox3 == l)) {
-                nghbr.h_view(b,inghbr).gid = nt->gid_;
-                nghbr.h_view(b,inghbr).lev = nt->lloc_.level;
-                nghbr.h_view(b,inghbr).rank = ranklist[nt->gid_];
+              if (nt.lloc.level >= lloc.level || (myox2 == m && myox3 == l)) {
+                nghbr.h_view(b,inghbr).gid = nt.gid;
+                nghbr.h_view(b,inghbr).lev = nt.lloc.level;
+                nghbr.h_view(b,inghbr).rank = ranklist[nt.gid];
                 nghbr.h_view(b,inghbr).dest = idest;
               }
             }
@@ -398,21 +445,21 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
       for (int l=-1; l<=1; l+=2) {
         for (int m=-1; m<=1; m+=2) {
           for (int n=-1; n<=1; n+=2) {
-            MeshBlockTree* nt = ptree->FindNeighbor(lloc, n, m, l);
-            if (nt != nullptr) {
-              if (nt->pleaf_ != nullptr) {  // neighbor at finer level
+            LinearTreeNode nt = plt->FindNeighbor(lloc, n, m, l);
+            if (nt.Exists()) {
+              if (nt.refined) {  // neighbor at finer level
                 int ffx = 1 - (n + 1)/2; // 0 for BoundaryFace::outer_x1, 1 for inner_x1
                 int ffy = 1 - (m + 1)/2; // 0 for BoundaryFace::outer_x2, 1 for inner_x2
                 int ffz = 1 - (l + 1)/2; // 0 for BoundaryFace::outer_x3, 1 for inner_x3
-                nt = nt->GetLeaf(ffx, ffy, ffz);
+                nt = plt->GetLeaf(nt, ffx, ffy, ffz);
               }
-              int nlevel = nt->lloc_.level;
+              int nlevel = nt.lloc.level;
               // only set neighbor for exterior corners of coarser face
               if (nlevel >= lloc.level || (myox1 == n && myox2 == m && myox3 == l)) {
                 int inghbr = NeighborIndex(n,m,l,0,0);
-                nghbr.h_view(b,inghbr).gid = nt->gid_;
-                nghbr.h_view(b,inghbr).lev = nt->lloc_.level;
-                nghbr.h_view(b,inghbr).rank = ranklist[nt->gid_];
+                nghbr.h_view(b,inghbr).gid = nt.gid;
+                nghbr.h_view(b,inghbr).lev = nt.lloc.level;
+                nghbr.h_view(b,inghbr).rank = ranklist[nt.gid];
                 nghbr.h_view(b,inghbr).dest = NeighborIndex(-n,-m,-l,0,0);
               }
             }
@@ -420,7 +467,7 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
         }
       }
     }  // end loop over three_d
-  }    // end loop over all MeshBlocks
+  });  // end loop over all MeshBlocks
 
   // For each DualArray: mark host views as modified, and then sync to device array
   nghbr.template modify<HostMemSpace>();
@@ -428,3 +475,31 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
 
   return;
 }
+
+//----------------------------------------------------------------------------------------
+// \!fn bool MeshBlock::CopyPrevNeighbors()
+// \brief If MeshBlock b was on this rank before AMR and neither it nor any of its
+// neighbors were refined or derefined, the levels and buffer indices of its neighbors are
+// unchanged.  In that case copies its old neighbors with gids and ranks updated for the
+// new Mesh, and returns true.  Otherwise returns false and the tree must be searched.
+
+bool MeshBlock::CopyPrevNeighbors(int b, int *ranklist, const PrevNeighbors &prev) {
+  int oldgid = prev.newtoold[mb_gid.h_view(b)];
+  if ((oldgid < prev.gids) || (oldgid > prev.gide) || (prev.refine_flag[oldgid] != 0)) {
+    return false;
+  }
+  int oldm = oldgid - prev.gids;
+  for (int n=0; n<nnghbr; ++n) {
+    int ngid = prev.nghbr.h_view(oldm,n).gid;
+    if ((ngid >= 0) && (prev.refine_flag[ngid] != 0)) {return false;}
+  }
+
+  for (int n=0; n<nnghbr; ++n) {
+    nghbr.h_view(b,n) = prev.nghbr.h_view(oldm,n);
+    if (nghbr.h_view(b,n).gid >= 0) {
+      nghbr.h_view(b,n).gid = prev.oldtonew[nghbr.h_view(b,n).gid];
+      nghbr.h_view(b,n).rank = ranklist[nghbr.h_view(b,n).gid];
+    }
+  }
+  return true;
+}
@@ -17,6 +17,19 @@
 #include "bvals/bvals.hpp"
 #include "meshblock_pack.hpp"
 
+//----------------------------------------------------------------------------------------
+//! \struct PrevNeighbors
+//! \brief neighbors of the MeshBlocks on this rank before the Mesh was refined, and the
+//! maps between old and new gids.  Passed to SetNeighbors() after AMR so that MeshBlocks
+//! whose neighborhood was not changed can be updated without searching the tree.
+
+struct PrevNeighbors {
+  DualArray2D<NeighborBlock> nghbr;  // neighbors of old MeshBlocks on this rank
+  int gids, gide;                    // old gids of first/last MeshBlock on this rank
+  int *oldtonew, *newtoold;          // maps between old and new gids
+  int *refine_flag;                  // refinement flags of all old MeshBlocks
+};
+
 //----------------------------------------------------------------------------------------
 //! \class MeshBlock
 //! \brief data/functions associated with each MeshBlock
@@ -41,12 +54,28 @@ class MeshBlock {
   DualArray1D<RegionSize> mb_size;   // physical size of each MeshBlock
   DualArray2D<BoundaryFlag> mb_bcs;  // boundary conditions at 6 faces of each MeshBlock
   DualArray2D<NeighborBlock> nghbr;  // data on all (up to 56) neighbors for each MB
+  DualArray1D<Real> mb_work;         // work counted on each MB (for load balancing)
+
+  // indices m of MeshBlocks with a physical boundary at either face in each direction,
+  // stored in bc_mblist(dir,0:nbc_mb[dir]-1), so that kernels applying physical BCs are
+  // only launched over MeshBlocks at the edge of the domain.  Rebuilt with MeshBlocks.
+  DualArray2D<int> bc_mblist;
+  int nbc_mb[3];
+  // faces of MeshBlocks at the edge of the domain (any BC other than periodic or
+  // shearing-periodic, including user BCs), stored as 6*m+face in
+  // bc_facelist(0:nbc_face-1), for kernels applied on the outer boundary faces.
+  DualArray1D<int> bc_facelist;
+  int nbc_face;
 
   // function to set data describing neighbors
-  void SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklist);
+  void SetNeighbors(std::unique_ptr<LinearMeshTree> &plt, int *ranklist,
+                    const PrevNeighbors *pprev=nullptr);
 
  private:
   // data
   MeshBlockPack* pmy_pack;
+
+  // functions
+  bool CopyPrevNeighbors(int b, int *ranklist, const PrevNeighbors &prev);
 };
 #endif // MESH_MESHBLOCK_HPP_
@@ -6,18 +6,21 @@
 //! \file meshblock_pack.cpp
 //  \brief implementation of constructor and functions in MeshBlockPack class
 
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <utility>
 #include <memory>
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh.hpp"
 #include "driver/driver.hpp"
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "ion-neutral/ion-neutral.hpp"
+#include "gravity/gravity.hpp"
 #include "coordinates/adm.hpp"
 #include "z4c/tmunu.hpp"
 #include "tasklist/numerical_relativity.hpp"
@@ -30,6 +33,9 @@
 #include "srcterms/turb_driver.hpp"
 #include "particles/particles.hpp"
 #include "units/units.hpp"
+#include "utils/mb_locator.hpp"
+#include "utils/interp_service.hpp"
+#include "utils/memory_tracker.hpp"
 #include "meshblock_pack.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -39,13 +45,18 @@ MeshBlockPack::MeshBlockPack(Mesh *pm, int igids, int igide) :
   pmesh(pm),
   gids(igids),
   gide(igide),
-  nmb_thispack(igide - igids + 1) {
+  nmb_thispack(igide - igids + 1),
+  plocator(new MeshBlockLocator(this)),
+  pinterp(new InterpolationService(this)) {
   // create map for task lists
   tl_map.insert(std::make_pair("before_timeintegrator",std::make_shared<TaskList>()));
   tl_map.insert(std::make_pair("after_timeintegrator",std::make_shared<TaskList>()));
   tl_map.insert(std::make_pair("before_stagen",std::make_shared<TaskList>()));
   tl_map.insert(std::make_pair("stagen",std::make_shared<TaskList>()));
   tl_map.insert(std::make_pair("after_stagen",std::make_shared<TaskList>()));
+  tl_map.insert(std::make_pair("before_sts",std::make_shared<TaskList>()));
+  tl_map.insert(std::make_pair("sts",std::make_shared<TaskList>()));
+  tl_map.insert(std::make_pair("after_sts",std::make_shared<TaskList>()));
 }
 
 //----------------------------------------------------------------------------------------
@@ -53,14 +64,19 @@ MeshBlockPack::MeshBlockPack(Mesh *pm, int igids, int igide) :
 
 MeshBlockPack::~MeshBlockPack() {
   delete pcoord;
+  delete plocator;
+  delete pinterp;
   if (phydro != nullptr) {delete phydro;}
   if (pmhd   != nullptr) {delete pmhd;}
   if (padm   != nullptr) {delete padm;}
   if (ptmunu != nullptr) {delete ptmunu;}
+#if RADIATION_ENABLED
   if (prad   != nullptr) {delete prad;}
+#endif
   if (pdyngr != nullptr) {delete pdyngr;}
   if (pnr    != nullptr) {delete pnr;}
   if (pturb  != nullptr) {delete pturb;}
+  if (pgrav  != nullptr) {delete pgrav;}
   if (punit  != nullptr) {delete punit;}
   if (pz4c   != nullptr) {
     delete pz4c;
@@ -115,7 +131,10 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // Create Hydro physics module.  Create TaskLists only for single-fluid hydro
   // (Note TaskLists stored in MeshBlockPack)
   if (pin->DoesBlockExist("hydro")) {
-    phydro = new hydro::Hydro(this, pin);
+    {
+      memory_tracker::Scope scope(memory_tracker::Owner::hydro);
+      phydro = new hydro::Hydro(this, pin);
+    }
     nphysics++;
     if (!(pin->DoesBlockExist("mhd")) && !(pin->DoesBlockExist("radiation")) &&
         !(pin->DoesBlockExist("adm")) && !(pin->DoesBlockExist("z4c")) ) {
@@ -128,7 +147,10 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // (3) MHD
   // Create MHD physics module.  Create TaskLists only for single-fluid MHD
   if (pin->DoesBlockExist("mhd")) {
-    pmhd = new mhd::MHD(this, pin);
+    {
+      memory_tracker::Scope scope(memory_tracker::Owner::mhd);
+      pmhd = new mhd::MHD(this, pin);
+    }
     nphysics++;
     if (!(pin->DoesBlockExist("hydro")) && !(pin->DoesBlockExist("radiation")) &&
         !(pin->DoesBlockExist("adm")) && !(pin->DoesBlockExist("z4c")) ) {
@@ -142,6 +164,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // Create Ion-Neutral physics module and TaskLists. Error if <hydro> and <mhd> are not
   // both defined as well.
   if (pin->DoesBlockExist("ion-neutral")) {
+#if ION_NEUTRAL_ENABLED
     pionn = new ion_neutral::IonNeutral(this, pin);   // construct new MHD object
     if (pin->DoesBlockExist("hydro") && pin->DoesBlockExist("mhd") &&
         !(pin->DoesBlockExist("adm")) && !(pin->DoesBlockExist("z4c")) ) {
@@ -153,6 +176,12 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
                 << " <hydro> or <mhd> block missing" << std::endl;
       std::exit(EXIT_FAILURE);
     }
+#else
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<ion-neutral> block detected in input file, but code was compiled "
+              << "with Athena_ENABLE_ION_NEUTRAL=OFF" << std::endl;
+    std::exit(EXIT_FAILURE);
+#endif
   } else {
     // Error if both <hydro> and <mhd> defined, but not <ion-neutral>
     if (pin->DoesBlockExist("hydro") && pin->DoesBlockExist("mhd")) {
@@ -164,12 +193,40 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
     pionn = nullptr;
   }
 
+  // Super-time-stepping of diffusion is operator split, so its TaskLists are assembled
+  // whichever module assembled the TaskLists of the time-integrator
+  if ((phydro != nullptr) && (phydro->use_sts)) {
+    phydro->AssembleSTSTasks(tl_map);
+  }
+  if ((pmhd != nullptr) && (pmhd->use_sts)) {
+    pmhd->AssembleSTSTasks(tl_map);
+  }
+
+  // Self-gravity of the Hydro and/or MHD fluid.  The Poisson solve is added to the
+  // "before_stagen" list, while its source terms are added by the fluid modules.
+  if (pin->DoesBlockExist("gravity")) {
+    pgrav = new gravity::Gravity(this, pin);
+    pgrav->AssembleGravityTasks(tl_map);
+  } else {
+    pgrav = nullptr;
+  }
+
   // (5) RADIATION
   // Create radiation physics module.  Create tasklist.
   if (pin->DoesBlockExist("radiation")) {
-    prad = new radiation::Radiation(this, pin);
+#if RADIATION_ENABLED
+    {
+      memory_tracker::Scope scope(memory_tracker::Owner::radiation);
+      prad = new radiation::Radiation(this, pin);
+    }
     nphysics++;
     prad->AssembleRadTasks(tl_map);
+#else
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<radiation> block detected in input file, but code was compiled "
+              << "with Athena_ENABLE_RADIATION=OFF" << std::endl;
+    std::exit(EXIT_FAILURE);
+#endif
   } else {
     prad = nullptr;
   }
@@ -191,8 +248,14 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // (7) Z4c and ADM
   // Create Z4c and ADM physics module.
   if (pin->DoesBlockExist("z4c")) {
-    pz4c = new z4c::Z4c(this, pin);
-    padm = new adm::ADM(this, pin);
+    {
+      memory_tracker::Scope scope(memory_tracker::Owner::z4c);
+      pz4c = new z4c::Z4c(this, pin);
+    }
+    {
+      memory_tracker::Scope scope(memory_tracker::Owner::adm);
+      padm = new adm::ADM(this, pin);
+    }
     ptmunu = nullptr;
     // init cce dump
     pz4c_cce.reserve(0);
@@ -206,6 +269,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   } else {
     pz4c = nullptr;
     if (pin->DoesBlockExist("adm")) {
+      memory_tracker::Scope scope(memory_tracker::Owner::adm);
       padm = new adm::ADM(this, pin);
     } else {
       padm = nullptr;
@@ -240,6 +304,16 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
     ppart = nullptr;
   }
 
+  // In lean memory mode, arrays of different modules that are never live at the same
+  // time share the same device memory.
+  if (pin->GetOrAddBoolean("mesh","lean_memory",false)) {
+    std::int64_t saved = ShareFluidFluxMemory();
+    if (global_variable::my_rank == 0) {
+      std::cout << "<mesh>/lean_memory: " << static_cast<double>(saved)/1048576.0
+                << " MiB of device memory per rank shared between modules" << std::endl;
+    }
+  }
+
   // Check that at least ONE is requested and initialized.
   // Error if there are no physics blocks in the input file.
   if (nphysics == 0) {
@@ -250,3 +324,84 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
 
   return;
 }
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn V CarveView()
+//! \brief Returns a View of type V with extents n... stored in the memory of pool
+//! starting at element offset (which is then advanced past the new View), or an empty
+//! View if pool is too small.  The returned View does not own its memory.
+
+template <typename V, typename P, typename... Ns>
+V CarveView(const P &pool, std::size_t &offset, Ns... n) {
+  std::size_t len = 1;
+  for (std::size_t e : {static_cast<std::size_t>(n)...}) {len *= e;}
+  if (offset + len > pool.span()) {return V();}
+  V v(pool.data() + offset, n...);
+  offset += len;
+  return v;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn V SameShape()
+//! \brief Carves a View with the same extents as (the 4D or 5D) View a out of pool.
+
+template <typename P>
+DvceArray4D<Real> SameShape(const P &pool, std::size_t &offset,
+                            const DvceArray4D<Real> &a) {
+  return CarveView<DvceArray4D<Real>>(pool, offset, a.extent(0), a.extent(1),
+                                      a.extent(2), a.extent(3));
+}
+template <typename P>
+DvceArray5D<Real> SameShape(const P &pool, std::size_t &offset,
+                            const DvceArray5D<Real> &a) {
+  return CarveView<DvceArray5D<Real>>(pool, offset, a.extent(0), a.extent(1),
+                                      a.extent(2), a.extent(3), a.extent(4));
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn MeshBlockPack::ShareFluidFluxMemory()
+//! \brief With radiation, the intensity fluxes (iflx) are only live from
+//! Radiation::CalculateFluxes() to Radiation::RKUpdate(), which the radiation task list
+//! completes before the Hydro/MHD fluxes are computed in each stage.  The fluid fluxes
+//! (uflx), and for MHD the scratch arrays for face-centered E used in CornerE(), are
+//! dead by the time the next stage starts.  So in lean memory mode the fluid arrays are
+//! stored in the memory of iflx, and their own allocations are freed.  Each array is
+//! only shared if it fits in the remaining space of the iflx component for the same
+//! direction.  Returns the number of device bytes freed.
+
+std::int64_t MeshBlockPack::ShareFluidFluxMemory() {
+  if (prad == nullptr || ppart != nullptr) {return 0;}
+  auto &pool = prad->iflx;
+  if (pool.x1f.span() <= 1) {return 0;}  // iflx not allocated with fused update
+  std::int64_t nshared = 0;
+
+  // replaces array a with a View of the same shape in pool, if it fits
+  auto share = [&nshared](const DvceArray5D<Real> &p, std::size_t &offset, auto &a) {
+    if (a.span() <= 1) {return;}
+    auto v = SameShape(p, offset, a);
+    if (v.data() == nullptr) {return;}
+    nshared += a.span();
+    a = v;
+  };
+
+  std::size_t o1 = 0, o2 = 0, o3 = 0;
+  if (phydro != nullptr && !(phydro->use_fused) && !(phydro->use_split_fluxes)) {
+    share(pool.x1f, o1, phydro->uflx.x1f);
+    share(pool.x2f, o2, phydro->uflx.x2f);
+    share(pool.x3f, o3, phydro->uflx.x3f);
+  }
+  if (pmhd != nullptr && !(pmhd->use_split_fluxes)) {
+    share(pool.x1f, o1, pmhd->uflx.x1f);
+    share(pool.x2f, o2, pmhd->uflx.x2f);
+    share(pool.x3f, o3, pmhd->uflx.x3f);
+    share(pool.x1f, o1, pmhd->e3x1);
+    share(pool.x1f, o1, pmhd->e2x1);
+    share(pool.x2f, o2, pmhd->e1x2);
+    share(pool.x2f, o2, pmhd->e3x2);
+    share(pool.x3f, o3, pmhd->e2x3);
+    share(pool.x3f, o3, pmhd->e1x3);
+  }
+  return nshared*static_cast<std::int64_t>(sizeof(Real));
+}
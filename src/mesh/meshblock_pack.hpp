@@ -8,6 +8,7 @@
 //! \file meshblock_pack.hpp
 //  \brief defines MeshBlockPack class, a container for MeshBlocks
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -22,9 +23,12 @@
 class MeshBlock;
 class ADM;
 class Tmunu;
+class MeshBlockLocator;
+class InterpolationService;
 namespace hydro {class Hydro;}
 namespace mhd {class MHD;}
 namespace ion_neutral {class IonNeutral;}
+namespace gravity {class Gravity;}
 namespace radiation {class Radiation;}
 namespace dyngr {class DynGRMHD;}
 namespace numrel {class NumericalRelativity;}
@@ -61,6 +65,11 @@ class MeshBlockPack {
   MeshBlock* pmb;         // MeshBlocks in this MeshBlockPack
   Coordinates* pcoord;
 
+  // index for finding the MeshBlock containing a point, shared by interpolation grids
+  MeshBlockLocator *plocator;
+  // batched interpolation to points, shared by diagnostics
+  InterpolationService *pinterp;
+
   // physics (controlled by AddPhysics() function in meshblock_pack.cpp)
   hydro::Hydro *phydro=nullptr;
   mhd::MHD *pmhd=nullptr;
@@ -71,6 +80,7 @@ class MeshBlockPack {
   numrel::NumericalRelativity *pnr=nullptr;
   ion_neutral::IonNeutral *pionn=nullptr;
   TurbulenceDriver *pturb=nullptr;
+  gravity::Gravity *pgrav=nullptr;
   radiation::Radiation *prad=nullptr;
   std::vector<z4c::CCE *> pz4c_cce;
   particles::Particles *ppart=nullptr;
@@ -91,6 +101,7 @@ class MeshBlockPack {
 
   // functions
   void SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklist);
+  std::int64_t ShareFluidFluxMemory();
 };
 
 #endif // MESH_MESHBLOCK_PACK_HPP_
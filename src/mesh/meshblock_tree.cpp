@@ -6,6 +6,7 @@
 //! \file meshblock_tree.cpp
 //  \brief implementation of constructor and functions in the MeshBlockTree class
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <sstream>
@@ -295,7 +296,10 @@ void MeshBlockTree::Derefine(int &ndel) {
     }
   }
 
-  gid_ = pleaf_[0]->gid_; // now this is a leaf; inherit the first leaf's GID
+  // now this is a leaf; inherit the smallest GID of its leafs, which is the GID of the
+  // first leaf along the space-filling curve used to order the tree
+  gid_ = pleaf_[0]->gid_;
+  for (int n=1; n<nleaf_; n++) {gid_ = std::min(gid_, pleaf_[n]->gid_);}
   for (int n=0; n<nleaf_; n++) {
     delete pleaf_[n];
   }
@@ -322,9 +326,55 @@ void MeshBlockTree::CountMeshBlocks(int& count) {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn std::uint64_t HilbertKey(const LogicalLocation &lloc, int ndim)
+//! \brief Returns position of the MB at lloc along a Hilbert curve through the 2D/3D
+//! logical root block, computed at a fixed resolution of nbits bits per dimension using
+//! the "transpose" algorithm of J. Skilling (2004, AIP Conf. Proc. 707, 381).  MBs at
+//! levels <= nbits have distinct keys.
+
+namespace {
+std::uint64_t HilbertKey(const LogicalLocation &lloc, int ndim, int nbits) {
+  std::uint32_t x[3] = {static_cast<std::uint32_t>(lloc.lx1),
+                        static_cast<std::uint32_t>(lloc.lx2),
+                        static_cast<std::uint32_t>(lloc.lx3)};
+  for (int i=0; i<ndim; i++) {x[i] <<= (nbits - lloc.level);}
+
+  // inverse undo of excess work
+  std::uint32_t m = 1u << (nbits-1);
+  for (std::uint32_t q=m; q>1; q>>=1) {
+    std::uint32_t p = q - 1;
+    for (int i=0; i<ndim; i++) {
+      if (x[i] & q) {
+        x[0] ^= p;
+      } else {
+        std::uint32_t t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  // Gray encode
+  for (int i=1; i<ndim; i++) {x[i] ^= x[i-1];}
+  std::uint32_t t = 0;
+  for (std::uint32_t q=m; q>1; q>>=1) {
+    if (x[ndim-1] & q) {t ^= q - 1;}
+  }
+  for (int i=0; i<ndim; i++) {x[i] ^= t;}
+
+  // interleave bits of transposed index into key
+  std::uint64_t key = 0;
+  for (int b=nbits-1; b>=0; b--) {
+    for (int i=0; i<ndim; i++) {key = (key << 1) | ((x[i] >> b) & 1u);}
+  }
+  return key;
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBlockTree::CreateZOrderedLLList(LogicalLocation *list, int *pg, int& cnt)
-//! \brief Creates the Location list for tree sorted by Z-ordering, and creates new MB ids
+//! \brief Creates the Location list for tree sorted by Z-ordering (or by Hilbert ordering
+//! if <loadbalancing>/curve=hilbert), and creates new MB ids
 //! based on this order.  Should be called from root of tree. Called in BuildTreeXXX()
 //! functions when tree is constructed for first time, in which case second argument is
 //! 'nullptr' and this function creates gids for all MBs based on Z-ordering. Also called
@@ -342,7 +392,22 @@ void MeshBlockTree::CreateZOrderedLLList(LogicalLocation *list, int *pglist, int
     gid_=count;
     count++;
   } else {
-    for (int n=0; n<nleaf_; n++) {
+    // Z-ordering visits leafs in order of their index.  Along a Hilbert curve each leaf
+    // covers a contiguous range of keys, so leafs are visited in order of their keys.
+    int order[8];
+    for (int n=0; n<nleaf_; n++) {order[n] = n;}
+    int ndim = (nleaf_ == 8)? 3 : 2;
+    int nbits = (ndim == 3)? 21 : 31;
+    if (pmesh_->hilbert_order && nleaf_ > 2 && lloc_.level < nbits) {
+      std::uint64_t key[8];
+      for (int n=0; n<nleaf_; n++) {
+        if (pleaf_[n] != nullptr) {key[n] = HilbertKey(pleaf_[n]->lloc_, ndim, nbits);}
+        else {key[n] = 0;}
+      }
+      std::sort(order, order+nleaf_, [&key](int a, int b) {return key[a] < key[b];});
+    }
+    for (int i=0; i<nleaf_; i++) {
+      int n = order[i];
       if (pleaf_[n] != nullptr) {pleaf_[n]->CreateZOrderedLLList(list, pglist, count);}
     }
   }
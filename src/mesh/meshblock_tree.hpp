@@ -26,6 +26,7 @@ class MeshBlockTree {
   friend class Mesh;
   friend class MeshBlock;
   friend class MeshBlockPack;
+  friend class MeshRefinement;
 
  public:
   explicit MeshBlockTree(Mesh *pmesh);
@@ -92,4 +92,24 @@ Real RestrictInterpolation(const int m, const int v, const int fk, const int fj,
   }
   return ivals;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn Real RestrictAverage()
+//! \brief volume average of the fine cells (fk:fk+dk, fj:fj+dj, fi:fi+di) of a, where
+//! dk,dj,di are 1 in restricted directions and 0 otherwise
+
+KOKKOS_INLINE_FUNCTION
+Real RestrictAverage(const int m, const int v, const int fk, const int fj, const int fi,
+                     const int dk, const int dj, const int di,
+                     const DvceArray5D<Real> &a) {
+  Real sum = 0.0;
+  for (int kk=0; kk<=dk; ++kk) {
+    for (int jj=0; jj<=dj; ++jj) {
+      for (int ii=0; ii<=di; ++ii) {
+        sum += a(m,v,fk+kk,fj+jj,fi+ii);
+      }
+    }
+  }
+  return sum/static_cast<Real>((1+dk)*(1+dj)*(1+di));
+}
 #endif // MESH_RESTRICTION_HPP_
@@ -37,6 +37,10 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
     coarse_b0("cB_fc",1,1,1,1),
     u1("cons1",1,1,1,1,1),
     b1("B_fc1",1,1,1,1),
+    u_sts0("u_sts0",1,1,1,1,1),
+    du_sts0("du_sts0",1,1,1,1,1),
+    b_sts0("b_sts0",1,1,1,1),
+    db_sts0("db_sts0",1,1,1,1),
     uflx("uflx",1,1,1,1,1),
     efld("efld",1,1,1,1),
     wsaved("wsaved",1,1,1,1,1),
@@ -52,7 +56,10 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
     e3_cc("e3_cc",1,1,1,1),
     utest("utest",1,1,1,1,1),
     bcctest("bcctest",1,1,1,1,1),
-    fofc("fofc",1,1,1,1) {
+    fofc("fofc",1,1,1,1),
+    fofc_list("fofc_list",1),
+    fofc_nlist("fofc_nlist",1),
+    divb_max("divb_max",1) {
   // Total number of MeshBlocks on this rank to be used in array dimensioning
   int nmb = std::max((ppack->nmb_thispack), (ppack->pmesh->nmb_maxperrank));
 
@@ -107,7 +114,8 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
 
   // Thermal conduction (only constructed if needed)
   if (pin->DoesParameterExist("mhd","conductivity") ||
-      pin->DoesParameterExist("mhd","tdep_conductivity")) {
+      pin->DoesParameterExist("mhd","tdep_conductivity") ||
+      pin->DoesParameterExist("mhd","aniso_conductivity")) {
     pcond = new Conduction("mhd", ppack, pin);
   } else {
     pcond = nullptr;
@@ -138,14 +146,17 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
     Kokkos::realloc(b0.x3f, nmb, ncells3+1, ncells2, ncells1);
   }
 
-  // allocate memory for conserved variables on coarse mesh
+  // allocate memory for conserved variables on coarse mesh.  Primitive variables on the
+  // coarse mesh are only used when primitives are prolongated.
   if (ppack->pmesh->multilevel) {
     auto &indcs = pmy_pack->pmesh->mb_indcs;
     int n_ccells1 = indcs.cnx1 + 2*(indcs.ng);
     int n_ccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
     int n_ccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
     Kokkos::realloc(coarse_u0, nmb, (nmhd+nscalars), n_ccells3, n_ccells2, n_ccells1);
-    Kokkos::realloc(coarse_w0, nmb, (nmhd+nscalars), n_ccells3, n_ccells2, n_ccells1);
+    if (ppack->pmesh->pmr->prolong_prims) {
+      Kokkos::realloc(coarse_w0, nmb, (nmhd+nscalars), n_ccells3, n_ccells2, n_ccells1);
+    }
     Kokkos::realloc(coarse_b0.x1f, nmb, n_ccells3, n_ccells2, n_ccells1+1);
     Kokkos::realloc(coarse_b0.x2f, nmb, n_ccells3, n_ccells2+1, n_ccells1);
     Kokkos::realloc(coarse_b0.x3f, nmb, n_ccells3+1, n_ccells2, n_ccells1);
@@ -154,8 +165,21 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
   // allocate boundary buffers for conserved (cell-centered) and face-centered variables
   pbval_u = new MeshBoundaryValuesCC(ppack, pin, false);
   pbval_u->InitializeBuffers((nmhd+nscalars));
+  pbval_u->SetHaloPrecision(pin, "mhd");
   pbval_b = new MeshBoundaryValuesFC(ppack, pin);
   pbval_b->InitializeBuffers(3);
+  pbval_b->SetHaloPrecision(pin, "mhd");
+  // optionally exchange U and B together in the buffers of pbval_b
+  combined_ub = pin->GetOrAddBoolean("mhd", "combined_ub", false);
+  if (combined_ub) {
+    if (psrc->shearing_box) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mhd>/combined_ub=true cannot be used with shearing box"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    pbval_b->CombineWithCC(pbval_u, (nmhd+nscalars));
+  }
 
   // Orbital advection and shearing box BCs (if requested in input file)
   if (pin->DoesBlockExist("shearing_box")) {
@@ -221,6 +245,25 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
       std::exit(EXIT_FAILURE);
     }
 
+    // select reconstruction of passive scalars: "same" as the MHD variables (default),
+    // or lower order in a separate kernel
+    std::string sorder = pin->GetOrAddString("mhd","scalar_reconstruct","same");
+    if (sorder.compare("dc") == 0 || sorder.compare("plm") == 0) {
+      scalar_plm = (sorder.compare("plm") == 0);
+      use_scalar_fluxes = (nscalars > 0);
+      if (scalar_plm && (recon_method == ReconstructionMethod::dc)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<mhd>/scalar_reconstruct=plm requires <mhd>/reconstruct "
+          << "of at least the same order" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    } else if (sorder.compare("same") != 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mhd>/scalar_reconstruct = '" << sorder
+                << "' not implemented" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
     // select Riemann solver (no default).  Test for compatibility of options
     std::string rsolver = pin->GetString("mhd","rsolver");
     // Special relativistic solvers
@@ -297,6 +340,107 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
       }
     }
 
+    // mixed precision L/R states are only implemented for non-relativistic HLLE/HLLD
+    mixed_precision = pin->GetOrAddBoolean("mhd","mixed_precision",false);
+    if (mixed_precision && rsolver_method != MHD_RSolver::hlle &&
+        rsolver_method != MHD_RSolver::hlld) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<mhd>/mixed_precision=true can only be used with "
+        << "<mhd>/rsolver=hlle or hlld" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // select specialisation of CalculateFluxes() for this rsolver and reconstruction
+    SelectFluxFunction();
+
+    // determine number of ghost layers of primitives computed every stage.  By default
+    // all ng layers are converted.  Optionally only the layers used by the reconstruction
+    // stencil (plus one with FOFC or excision) are converted, in which case primitives
+    // in the remaining ghost layers are not updated (so should not be used in outputs
+    // or user functions).
+    c2p_ng = pmy_pack->pmesh->mb_indcs.ng;
+    if (pin->GetOrAddBoolean("mhd","c2p_min_ghosts",false)) {
+      bool excise = (pmy_pack->pcoord->is_general_relativistic &&
+                     pmy_pack->pcoord->coord_data.bh_excise);
+      int nb = FluxStencilWidth(recon_method) + ((use_fofc || excise)? 1 : 0);
+      c2p_ng = std::min(c2p_ng, nb);
+    }
+
+    // determine if fluxes are split into interior/boundary passes.  Fluxes for the next
+    // stage are computed at the end of each stage, so they cannot be used with options
+    // that correct the fluxes after the RK update.
+    use_split_fluxes = pin->GetOrAddBoolean("mhd","split_fluxes",false);
+    if (use_split_fluxes) {
+      bool excise = (pmy_pack->pcoord->is_general_relativistic &&
+                     pmy_pack->pcoord->coord_data.bh_excise);
+      if (use_fofc || excise) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<mhd>/split_fluxes=true cannot be used with FOFC or BH "
+          << "excision" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // determine if timestep is reduced in the c2p kernel of the last stage, which saves
+    // a pass over the primitives.  The timestep is the same as computed by NewTimeStep().
+    use_c2p_dt = pin->GetOrAddBoolean("mhd","c2p_dt",false);
+    if (use_c2p_dt) {
+      if (!(peos->eos_data.is_ideal) || pmy_pack->pcoord->is_special_relativistic ||
+          pmy_pack->pcoord->is_general_relativistic ||
+          pmy_pack->pcoord->is_dynamical_relativistic) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<mhd>/c2p_dt=true can only be used for non-relativistic MHD "
+          << "with an ideal gas EOS" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // determine if viscosity, resistivity and conduction are integrated with operator-
+    // split super-time-stepping, in which case they do not limit the timestep.  The
+    // <time>/sts_integrator parameter is error checked in the Driver constructor.
+    std::string sts = pin->GetOrAddString("time","sts_integrator","none");
+    use_sts = (sts.compare("none") != 0) &&
+              ((pvisc != nullptr) || (presist != nullptr) || (pcond != nullptr));
+    if (use_sts && (psrc->shearing_box)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<time>/sts_integrator cannot be used with shearing box"
+        << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // determine if the edge EMFs are computed inside the CT kernel.  Only implemented in
+    // 3D, and cannot be used when the EMFs are modified after CornerE (by resistivity,
+    // unless it is integrated with super-time-stepping).
+    use_fused_ct = pin->GetOrAddBoolean("mhd","fused_ct",false);
+    if (use_fused_ct) {
+      if (!(pmy_pack->pmesh->three_d) || (presist != nullptr && !(use_sts))) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<mhd>/fused_ct=true can only be used in 3D without "
+          << "resistivity (unless <time>/sts_integrator is set)" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // determine if max |div(B)| is accumulated in the CT kernel for history outputs.
+    // Not implemented in the fused CT kernel, in which faces of a cell are updated by
+    // different teams.
+    divb_diag = pin->GetOrAddBoolean("mhd","divb_diagnostic",false);
+    if (divb_diag) {
+      if (use_fused_ct) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<mhd>/divb_diagnostic=true cannot be used with "
+          << "<mhd>/fused_ct=true" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      Kokkos::realloc(divb_max, nmb);
+    }
+
+    // determine if the anisotropic heat flux is computed inside the flux kernels, which
+    // is only possible when all fluxes on active faces are computed by one kernel per
+    // direction every stage (i.e. without split fluxes or super-time-stepping)
+    use_fused_aniso_cond = (pcond != nullptr) && (pcond->kappa_aniso > 0.0) &&
+                           !(use_split_fluxes) && !(use_sts);
+
     // Final memory allocations
     {
       // allocate second registers
@@ -309,6 +453,20 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
       Kokkos::realloc(b1.x2f, nmb, ncells3, ncells2+1, ncells1);
       Kokkos::realloc(b1.x3f, nmb, ncells3+1, ncells2, ncells1);
 
+      // allocate registers used by super-time-stepping
+      if (use_sts) {
+        Kokkos::realloc(u_sts0,     nmb, nmhd, ncells3, ncells2, ncells1);
+        Kokkos::realloc(b_sts0.x1f, nmb, ncells3, ncells2, ncells1+1);
+        Kokkos::realloc(b_sts0.x2f, nmb, ncells3, ncells2+1, ncells1);
+        Kokkos::realloc(b_sts0.x3f, nmb, ncells3+1, ncells2, ncells1);
+        if (sts.compare("rkl2") == 0) {
+          Kokkos::realloc(du_sts0,     nmb, nmhd, ncells3, ncells2, ncells1);
+          Kokkos::realloc(db_sts0.x1f, nmb, ncells3, ncells2, ncells1+1);
+          Kokkos::realloc(db_sts0.x2f, nmb, ncells3, ncells2+1, ncells1);
+          Kokkos::realloc(db_sts0.x3f, nmb, ncells3+1, ncells2, ncells1);
+        }
+      }
+
       // allocate fluxes, electric fields
       Kokkos::realloc(uflx.x1f, nmb, (nmhd+nscalars), ncells3, ncells2, ncells1+1);
       Kokkos::realloc(uflx.x2f, nmb, (nmhd+nscalars), ncells3, ncells2+1, ncells1);
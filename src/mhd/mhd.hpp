@@ -16,6 +16,7 @@
 #include "parameter_input.hpp"
 #include "tasklist/task_list.hpp"
 #include "bvals/bvals.hpp"
+#include "reconstruct/flux_region.hpp"
 
 // forward declarations
 class EquationOfState;
@@ -69,12 +70,14 @@ struct MHDTaskIDs {
   TaskID recvb_oa;
   TaskID restb;
   TaskID sendb;
+  TaskID iflux;
   TaskID recvb;
   TaskID sendb_shr;
   TaskID recvb_shr;
   TaskID bcs;
   TaskID prol;
   TaskID c2p;
+  TaskID bflux;
   TaskID newdt;
   TaskID csend;
   TaskID crecv;
@@ -97,6 +100,10 @@ class MHD {
 
   int nmhd;                // number of mhd variables (5/4 for ideal/isothermal EOS)
   int nscalars;            // number of passive scalars
+  // with <mhd>/scalar_reconstruct=dc/plm, fluxes of scalars are computed in a separate
+  // kernel from the mass flux, see reconstruct/scalar_fluxes.hpp
+  bool use_scalar_fluxes = false;
+  bool scalar_plm = false;  // PLM (otherwise donor cell) upwind states of scalars
   DvceArray5D<Real> u0;    // conserved variables
   DvceArray5D<Real> w0;    // primitive variables
   DvceFaceFld4D<Real> b0;  // face-centered magnetic fields
@@ -142,6 +149,48 @@ class MHD {
   // following used for FOFC algorithm
   DvceArray4D<bool> fofc;  // flag for each cell to indicate if FOFC is needed
   bool use_fofc = false;   // flag to enable FOFC
+  DvceArray1D<int> fofc_list;   // compacted list of cells flagged for FOFC/excision
+  DualArray1D<int> fofc_nlist;  // number of cells in fofc_list
+
+  // split fluxes: fluxes for next stage on interior faces are computed while boundary
+  // values of B are communicated, and on boundary faces after they are received
+  bool use_split_fluxes = false;
+
+  // operator-split super-time-stepping (RKL1/RKL2) of viscosity, resistivity and
+  // conduction
+  bool use_sts = false;
+  DvceArray5D<Real> u_sts0;     // conserved variables at start of STS step
+  DvceArray5D<Real> du_sts0;    // dt*L(U) at start of STS step (only used with RKL2)
+  DvceFaceFld4D<Real> b_sts0;   // face-centered fields at start of STS step
+  DvceFaceFld4D<Real> db_sts0;  // dt*L(B) at start of STS step (only used with RKL2)
+
+  // number of ghost layers converted to primitives in ConToPrim() every stage, which is
+  // reduced to the depth used by the flux stencil when <mhd>/c2p_min_ghosts=true
+  int c2p_ng;
+
+  // mixed precision: reconstruction and HLLE/HLLD Riemann solvers work with L/R states
+  // stored in single precision, while fluxes and all conserved variables remain in Real
+  bool mixed_precision = false;
+
+  // fused CT: edge EMFs in the interior of each MeshBlock are computed in team scratch
+  // inside the CT kernel, while CornerE only stores EMFs on the MeshBlock surface
+  bool use_fused_ct = false;
+
+  // fused anisotropic conduction: heat flux along B is added to the energy flux inside
+  // the flux kernels of CalculateFluxes(), rather than in separate passes over all faces
+  bool use_fused_aniso_cond = false;
+
+  // combined U/B exchange: conserved variables are packed into the boundary buffers of
+  // B and exchanged with them in SendB/RecvB, while SendU/RecvU do nothing
+  bool combined_ub = false;
+
+  // timestep reduced in the c2p kernel of the last stage, see ConsToPrimNewDt()
+  bool use_c2p_dt = false;
+
+  // with <mhd>/divb_diagnostic, max |div(B)| in each MeshBlock is accumulated by the CT
+  // kernel of the last stage, and written to history outputs via DivBMax()
+  bool divb_diag = false;
+  DvceArray1D<Real> divb_max;
 
   // container to hold names of TaskIDs
   MHDTaskIDs id;
@@ -176,20 +225,30 @@ class MHD {
   TaskStatus RecvB_OA(Driver *d, int stage);
   TaskStatus RestrictB(Driver *d, int stage);
   TaskStatus SendB(Driver *d, int stage);
+  TaskStatus InteriorFluxes(Driver *d, int stage);
   TaskStatus RecvB(Driver *d, int stage);
   TaskStatus SendB_Shr(Driver *d, int stage);
   TaskStatus RecvB_Shr(Driver *d, int stage);
   TaskStatus ApplyPhysicalBCs(Driver* pdrive, int stage);
   TaskStatus Prolongate(Driver* pdrive, int stage);
   TaskStatus ConToPrim(Driver *d, int stage);
+  TaskStatus BoundaryFluxes(Driver *d, int stage);
   TaskStatus NewTimeStep(Driver *d, int stage);
   // ...in "after_stagen_tl" task list
   TaskStatus ClearSend(Driver *d, int stage);
   TaskStatus ClearRecv(Driver *d, int stage);  // also in Driver::Initialize
+  // ...in "sts" list (along with many of the functions above)
+  void AssembleSTSTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  TaskStatus STSFluxes(Driver *d, int stage);
+  TaskStatus STSUpdate(Driver *d, int stage);
+  TaskStatus STSCT(Driver *d, int stage);
+  Real DivBMax();
 
-  // CalculateFluxes function templated over Riemann Solvers
-  template <MHD_RSolver T>
-  void CalculateFluxes(Driver *d, int stage);
+  // CalculateFluxes function templated over Riemann Solvers, reconstruction methods, and
+  // type used to store reconstructed states
+  template <MHD_RSolver T, ReconstructionMethod R, typename TF>
+  void CalculateFluxes(Driver *d, int stage, FluxRegion region=FluxRegion::all);
+  using FluxFunction = void (MHD::*)(Driver *d, int stage, FluxRegion region);
 
   // first-order flux correction
   void FOFC(Driver *d, int stage);
@@ -198,6 +257,14 @@ class MHD {
 
  private:
   MeshBlockPack* pmy_pack;   // ptr to MeshBlockPack containing this MHD
+  bool interior_c2p_done_ = false;  // interior W, Bcc computed in InteriorFluxes()
+  bool fluxes_done_ = false;        // fluxes for next stage computed in BoundaryFluxes()
+  bool dt_c2p_ready_ = false;       // dt_c2p_ computed by last-stage ConToPrim()
+  Real dt_c2p_[3];                  // min dx/(|v|+cf) in each direction from c2p
+  void CalculateFluxesInRegion(Driver *d, int stage, FluxRegion region);
+  FluxFunction calc_fluxes_ = nullptr;  // CalculateFluxes() specialisation for this run
+  void SelectFluxFunction();
+  void FusedCT(Driver *d, int stage);  // CornerE+CT kernel used with use_fused_ct
   // temporary variables used to store face-centered electric fields returned by RS
   DvceArray4D<Real> e1_cc, e2_cc, e3_cc;
 };
@@ -13,6 +13,7 @@
 #include "driver/driver.hpp"
 #include "diffusion/resistivity.hpp"
 #include "mhd.hpp"
+#include "mhd_corner_e.hpp"
 
 #include "coordinates/coordinates.hpp"
 #include "coordinates/cartesian_ks.hpp"
@@ -174,29 +175,7 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
       e1(m,ks  ,j,i) = e1x2_(m,ks,j,i);
       e1(m,ke+1,j,i) = e1x2_(m,ks,j,i);
 
-      Real e3_l2, e3_r2, e3_l1, e3_r1;
-      if (flx1(m,IDN,ks,j-1,i) >= 0.0) {
-        e3_l2 = e3x2_(m,ks,j,i-1) - e3cc_(m,ks,j-1,i-1);
-      } else {
-        e3_l2 = e3x2_(m,ks,j,i  ) - e3cc_(m,ks,j-1,i  );
-      }
-      if (flx1(m,IDN,ks,j,i) >= 0.0) {
-        e3_r2 = e3x2_(m,ks,j,i-1) - e3cc_(m,ks,j  ,i-1);
-      } else {
-        e3_r2 = e3x2_(m,ks,j,i  ) - e3cc_(m,ks,j  ,i  );
-      }
-      if (flx2(m,IDN,ks,j,i-1) >= 0.0) {
-        e3_l1 = e3x1_(m,ks,j-1,i) - e3cc_(m,ks,j-1,i-1);
-      } else {
-        e3_l1 = e3x1_(m,ks,j  ,i) - e3cc_(m,ks,j  ,i-1);
-      }
-      if (flx2(m,IDN,ks,j,i) >= 0.0) {
-        e3_r1 = e3x1_(m,ks,j-1,i) - e3cc_(m,ks,j-1,i  );
-      } else {
-        e3_r1 = e3x1_(m,ks,j  ,i) - e3cc_(m,ks,j  ,i  );
-      }
-      e3(m,ks,j,i) = 0.25*(e3_l1 + e3_r1 + e3_l2 + e3_r2 +
-             e3x2_(m,ks,j,i-1) + e3x2_(m,ks,j,i) + e3x1_(m,ks,j-1,i) + e3x1_(m,ks,j,i));
+      e3(m,ks,j,i) = CornerE3(m, ks, j, i, flx1, flx2, e3x1_, e3x2_, e3cc_);
     });
   }
 
@@ -335,87 +314,38 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
     //  Note e1[is:ie,  js:je+1,ks:ke+1]
     //       e2[is:ie+1,js:je,  ks:ke+1]
     //       e3[is:ie+1,js:je+1,ks:ke  ]
-    par_for("emf3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je+1, is, ie+1,
-    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-      // integrate E1 to corner using SG07
-      Real e1_l3, e1_r3, e1_l2, e1_r2;
-      if (flx2(m,IDN,k-1,j,i) >= 0.0) {
-        e1_l3 = e1x3_(m,k,j-1,i) - e1cc_(m,k-1,j-1,i);
-      } else {
-        e1_l3 = e1x3_(m,k,j  ,i) - e1cc_(m,k-1,j  ,i);
-      }
-      if (flx2(m,IDN,k,j,i) >= 0.0) {
-        e1_r3 = e1x3_(m,k,j-1,i) - e1cc_(m,k  ,j-1,i);
-      } else {
-        e1_r3 = e1x3_(m,k,j  ,i) - e1cc_(m,k  ,j  ,i);
-      }
-      if (flx3(m,IDN,k,j-1,i) >= 0.0) {
-        e1_l2 = e1x2_(m,k-1,j,i) - e1cc_(m,k-1,j-1,i);
-      } else {
-        e1_l2 = e1x2_(m,k  ,j,i) - e1cc_(m,k  ,j-1,i);
-      }
-      if (flx3(m,IDN,k,j,i) >= 0.0) {
-        e1_r2 = e1x2_(m,k-1,j,i) - e1cc_(m,k-1,j  ,i);
-      } else {
-        e1_r2 = e1x2_(m,k  ,j,i) - e1cc_(m,k  ,j  ,i);
-      }
-      e1(m,k,j,i) = 0.25*(e1_l3 + e1_r3 + e1_l2 + e1_r2 +
-                e1x2_(m,k-1,j,i) + e1x2_(m,k,j,i) + e1x3_(m,k,j-1,i) + e1x3_(m,k,j,i));
-
-      // integrate E2 to corner using SG07
-      Real e2_l3, e2_r3, e2_l1, e2_r1;
-      if (flx1(m,IDN,k-1,j,i) >= 0.0) {
-        e2_l3 = e2x3_(m,k,j,i-1) - e2cc_(m,k-1,j,i-1);
-      } else {
-        e2_l3 = e2x3_(m,k,j,i  ) - e2cc_(m,k-1,j,i  );
-      }
-      if (flx1(m,IDN,k,j,i) >= 0.0) {
-        e2_r3 = e2x3_(m,k,j,i-1) - e2cc_(m,k  ,j,i-1);
-      } else {
-        e2_r3 = e2x3_(m,k,j,i  ) - e2cc_(m,k  ,j,i  );
-      }
-      if (flx3(m,IDN,k,j,i-1) >= 0.0) {
-        e2_l1 = e2x1_(m,k-1,j,i) - e2cc_(m,k-1,j,i-1);
-      } else {
-        e2_l1 = e2x1_(m,k  ,j,i) - e2cc_(m,k  ,j,i-1);
-      }
-      if (flx3(m,IDN,k,j,i) >= 0.0) {
-        e2_r1 = e2x1_(m,k-1,j,i) - e2cc_(m,k-1,j,i  );
-      } else {
-        e2_r1 = e2x1_(m,k  ,j,i) - e2cc_(m,k  ,j,i  );
-      }
-      e2(m,k,j,i) = 0.25*(e2_l3 + e2_r3 + e2_l1 + e2_r1 +
-                e2x3_(m,k,j,i-1) + e2x3_(m,k,j,i) + e2x1_(m,k-1,j,i) + e2x1_(m,k,j,i));
-
-      // integrate E3 to corner using SG07
-      Real e3_l2, e3_r2, e3_l1, e3_r1;
-      if (flx1(m,IDN,k,j-1,i) >= 0.0) {
-        e3_l2 = e3x2_(m,k,j,i-1) - e3cc_(m,k,j-1,i-1);
-      } else {
-        e3_l2 = e3x2_(m,k,j,i  ) - e3cc_(m,k,j-1,i  );
-      }
-      if (flx1(m,IDN,k,j,i) >= 0.0) {
-        e3_r2 = e3x2_(m,k,j,i-1) - e3cc_(m,k,j  ,i-1);
-      } else {
-        e3_r2 = e3x2_(m,k,j,i  ) - e3cc_(m,k,j  ,i  );
-      }
-      if (flx2(m,IDN,k,j,i-1) >= 0.0) {
-        e3_l1 = e3x1_(m,k,j-1,i) - e3cc_(m,k,j-1,i-1);
-      } else {
-        e3_l1 = e3x1_(m,k,j  ,i) - e3cc_(m,k,j  ,i-1);
-      }
-      if (flx2(m,IDN,k,j,i) >= 0.0) {
-        e3_r1 = e3x1_(m,k,j-1,i) - e3cc_(m,k,j-1,i  );
-      } else {
-        e3_r1 = e3x1_(m,k,j  ,i) - e3cc_(m,k,j  ,i  );
-      }
-      e3(m,k,j,i) = 0.25*(e3_l1 + e3_r1 + e3_l2 + e3_r2 +
-                e3x2_(m,k,j,i-1) + e3x2_(m,k,j,i) + e3x1_(m,k,j-1,i) + e3x1_(m,k,j,i));
-    });
+    if (!(use_fused_ct)) {
+      par_for("emf3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je+1, is, ie+1,
+      KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+        e1(m,k,j,i) = CornerE1(m, k, j, i, flx2, flx3, e1x2_, e1x3_, e1cc_);
+        e2(m,k,j,i) = CornerE2(m, k, j, i, flx1, flx3, e2x1_, e2x3_, e2cc_);
+        e3(m,k,j,i) = CornerE3(m, k, j, i, flx1, flx2, e3x1_, e3x2_, e3cc_);
+      });
+
+    // With the fused CornerE+CT kernel only edges on the surface of each MeshBlock are
+    // stored, since only these are communicated and corrected by SendE/RecvE.  Edges in
+    // the interior are computed in MHD::CT().
+    } else {
+      par_for("emf3_surf", DevExeSpace(), 0, nmb1, ks, ke+1, js, je+1, is, ie+1,
+      KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+        bool x1s = (i == is || i == ie+1);
+        bool x2s = (j == js || j == je+1);
+        bool x3s = (k == ks || k == ke+1);
+        if ((x2s || x3s) && i <= ie) {
+          e1(m,k,j,i) = CornerE1(m, k, j, i, flx2, flx3, e1x2_, e1x3_, e1cc_);
+        }
+        if ((x1s || x3s) && j <= je) {
+          e2(m,k,j,i) = CornerE2(m, k, j, i, flx1, flx3, e2x1_, e2x3_, e2cc_);
+        }
+        if ((x1s || x2s) && k <= ke) {
+          e3(m,k,j,i) = CornerE3(m, k, j, i, flx1, flx2, e3x1_, e3x2_, e3cc_);
+        }
+      });
+    }
   }
 
-  // Add resistive electric field (if needed)
-  if (presist != nullptr) {
+  // Add resistive electric field (if needed, and not integrated with STS)
+  if ((presist != nullptr) && !(use_sts)) {
     if (presist->eta_ohm > 0.0) {
       presist->OhmicEField(b0, efld);
     }
@@ -0,0 +1,119 @@
+#ifndef MHD_MHD_CORNER_E_HPP_
+#define MHD_MHD_CORNER_E_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file mhd_corner_e.hpp
+//! \brief Inline functions that integrate face- and cell-centered electric fields to
+//! cell edges (corners in 2D) using the upwind algorithm of Gardiner & Stone (2005,2008).
+//! Used both by MHD::CornerE() and by the fused CornerE+CT kernel in MHD::CT().
+
+#include "athena.hpp"
+
+namespace mhd {
+//----------------------------------------------------------------------------------------
+//! \fn Real CornerE1()
+//! \brief returns E1 at edge (k,j,i), computed from face-centered E1 on x2/x3-faces
+
+KOKKOS_INLINE_FUNCTION
+Real CornerE1(const int m, const int k, const int j, const int i,
+              const DvceArray5D<Real> &flx2, const DvceArray5D<Real> &flx3,
+              const DvceArray4D<Real> &e1x2, const DvceArray4D<Real> &e1x3,
+              const DvceArray4D<Real> &e1cc) {
+  Real e1_l3, e1_r3, e1_l2, e1_r2;
+  if (flx2(m,IDN,k-1,j,i) >= 0.0) {
+    e1_l3 = e1x3(m,k,j-1,i) - e1cc(m,k-1,j-1,i);
+  } else {
+    e1_l3 = e1x3(m,k,j  ,i) - e1cc(m,k-1,j  ,i);
+  }
+  if (flx2(m,IDN,k,j,i) >= 0.0) {
+    e1_r3 = e1x3(m,k,j-1,i) - e1cc(m,k  ,j-1,i);
+  } else {
+    e1_r3 = e1x3(m,k,j  ,i) - e1cc(m,k  ,j  ,i);
+  }
+  if (flx3(m,IDN,k,j-1,i) >= 0.0) {
+    e1_l2 = e1x2(m,k-1,j,i) - e1cc(m,k-1,j-1,i);
+  } else {
+    e1_l2 = e1x2(m,k  ,j,i) - e1cc(m,k  ,j-1,i);
+  }
+  if (flx3(m,IDN,k,j,i) >= 0.0) {
+    e1_r2 = e1x2(m,k-1,j,i) - e1cc(m,k-1,j  ,i);
+  } else {
+    e1_r2 = e1x2(m,k  ,j,i) - e1cc(m,k  ,j  ,i);
+  }
+  return 0.25*(e1_l3 + e1_r3 + e1_l2 + e1_r2 +
+               e1x2(m,k-1,j,i) + e1x2(m,k,j,i) + e1x3(m,k,j-1,i) + e1x3(m,k,j,i));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real CornerE2()
+//! \brief returns E2 at edge (k,j,i), computed from face-centered E2 on x1/x3-faces
+
+KOKKOS_INLINE_FUNCTION
+Real CornerE2(const int m, const int k, const int j, const int i,
+              const DvceArray5D<Real> &flx1, const DvceArray5D<Real> &flx3,
+              const DvceArray4D<Real> &e2x1, const DvceArray4D<Real> &e2x3,
+              const DvceArray4D<Real> &e2cc) {
+  Real e2_l3, e2_r3, e2_l1, e2_r1;
+  if (flx1(m,IDN,k-1,j,i) >= 0.0) {
+    e2_l3 = e2x3(m,k,j,i-1) - e2cc(m,k-1,j,i-1);
+  } else {
+    e2_l3 = e2x3(m,k,j,i  ) - e2cc(m,k-1,j,i  );
+  }
+  if (flx1(m,IDN,k,j,i) >= 0.0) {
+    e2_r3 = e2x3(m,k,j,i-1) - e2cc(m,k  ,j,i-1);
+  } else {
+    e2_r3 = e2x3(m,k,j,i  ) - e2cc(m,k  ,j,i  );
+  }
+  if (flx3(m,IDN,k,j,i-1) >= 0.0) {
+    e2_l1 = e2x1(m,k-1,j,i) - e2cc(m,k-1,j,i-1);
+  } else {
+    e2_l1 = e2x1(m,k  ,j,i) - e2cc(m,k  ,j,i-1);
+  }
+  if (flx3(m,IDN,k,j,i) >= 0.0) {
+    e2_r1 = e2x1(m,k-1,j,i) - e2cc(m,k-1,j,i  );
+  } else {
+    e2_r1 = e2x1(m,k  ,j,i) - e2cc(m,k  ,j,i  );
+  }
+  return 0.25*(e2_l3 + e2_r3 + e2_l1 + e2_r1 +
+               e2x3(m,k,j,i-1) + e2x3(m,k,j,i) + e2x1(m,k-1,j,i) + e2x1(m,k,j,i));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real CornerE3()
+//! \brief returns E3 at edge (k,j,i), computed from face-centered E3 on x1/x2-faces
+
+KOKKOS_INLINE_FUNCTION
+Real CornerE3(const int m, const int k, const int j, const int i,
+              const DvceArray5D<Real> &flx1, const DvceArray5D<Real> &flx2,
+              const DvceArray4D<Real> &e3x1, const DvceArray4D<Real> &e3x2,
+              const DvceArray4D<Real> &e3cc) {
+  Real e3_l2, e3_r2, e3_l1, e3_r1;
+  if (flx1(m,IDN,k,j-1,i) >= 0.0) {
+    e3_l2 = e3x2(m,k,j,i-1) - e3cc(m,k,j-1,i-1);
+  } else {
+    e3_l2 = e3x2(m,k,j,i  ) - e3cc(m,k,j-1,i  );
+  }
+  if (flx1(m,IDN,k,j,i) >= 0.0) {
+    e3_r2 = e3x2(m,k,j,i-1) - e3cc(m,k,j  ,i-1);
+  } else {
+    e3_r2 = e3x2(m,k,j,i  ) - e3cc(m,k,j  ,i  );
+  }
+  if (flx2(m,IDN,k,j,i-1) >= 0.0) {
+    e3_l1 = e3x1(m,k,j-1,i) - e3cc(m,k,j-1,i-1);
+  } else {
+    e3_l1 = e3x1(m,k,j  ,i) - e3cc(m,k,j  ,i-1);
+  }
+  if (flx2(m,IDN,k,j,i) >= 0.0) {
+    e3_r1 = e3x1(m,k,j-1,i) - e3cc(m,k,j-1,i  );
+  } else {
+    e3_r1 = e3x1(m,k,j  ,i) - e3cc(m,k,j  ,i  );
+  }
+  return 0.25*(e3_l1 + e3_r1 + e3_l2 + e3_r2 +
+               e3x2(m,k,j,i-1) + e3x2(m,k,j,i) + e3x1(m,k,j-1,i) + e3x1(m,k,j,i));
+}
+
+} // namespace mhd
+#endif // MHD_MHD_CORNER_E_HPP_
@@ -12,6 +12,7 @@
 #include "srcterms/srcterms.hpp"
 #include "driver/driver.hpp"
 #include "mhd.hpp"
+#include "mhd_corner_e.hpp"
 
 namespace mhd {
 //----------------------------------------------------------------------------------------
@@ -38,6 +39,12 @@ TaskStatus MHD::CT(Driver *pdriver, int stage) {
   auto e3 = efld.x3e;
   auto &mbsize = pmy_pack->pmb->mb_size;
 
+  //---- fused CornerE+CT: all three components of B updated in one kernel
+  if (use_fused_ct) {
+    FusedCT(pdriver, stage);
+    return TaskStatus::complete;
+  }
+
   //---- update B1 (only for 2D/3D problems)
   if (multi_d) {
     auto bx1f = b0.x1f;
@@ -67,6 +74,40 @@ TaskStatus MHD::CT(Driver *pdriver, int stage) {
   //---- update B3 (curl terms in 1D and 2D/3D problems)
   auto bx3f = b0.x3f;
   auto bx3f_old = b1.x3f;
+  if (divb_diag && (stage == pdriver->nexp_stages)) {
+    // Each thread updates a column of x3-faces, so that div(B) of every cell can be
+    // computed from the new B3 on both of its x3-faces held in registers, together with
+    // B1 and B2 updated by the kernels above.  The max over each MeshBlock is accumulated
+    // in divb_max until it is read by DivBMax().
+    if (divb_max.extent_int(0) != nmb1 + 1) {Kokkos::realloc(divb_max, nmb1 + 1);}
+    auto bx1f_new = b0.x1f;
+    auto &dmax = divb_max;
+    par_for("CT-b3-divb", DevExeSpace(), 0, nmb1, js, je, is, ie,
+    KOKKOS_LAMBDA(int m, int j, int i) {
+      Real b3_km1 = 0.0, mb_max = 0.0;
+      for (int k=ks; k<=ke+1; ++k) {
+        Real b3 = gam0*bx3f(m,k,j,i) + gam1*bx3f_old(m,k,j,i);
+        b3 -= beta_dt*(e2(m,k,j,i+1) - e2(m,k,j,i))/mbsize.d_view(m).dx1;
+        if (multi_d) {
+          b3 += beta_dt*(e1(m,k,j+1,i) - e1(m,k,j,i))/mbsize.d_view(m).dx2;
+        }
+        bx3f(m,k,j,i) = b3;
+        if (k > ks) {
+          Real divb = (bx1f_new(m,k-1,j,i+1) - bx1f_new(m,k-1,j,i))/mbsize.d_view(m).dx1;
+          if (multi_d) {
+            divb += (bx2f(m,k-1,j+1,i) - bx2f(m,k-1,j,i))/mbsize.d_view(m).dx2;
+          }
+          if (three_d) {
+            divb += (b3 - b3_km1)/mbsize.d_view(m).dx3;
+          }
+          mb_max = fmax(mb_max, fabs(divb));
+        }
+        b3_km1 = b3;
+      }
+      if (mb_max > dmax(m)) {Kokkos::atomic_max(&dmax(m), mb_max);}
+    });
+    return TaskStatus::complete;
+  }
   par_for("CT-b3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je, is, ie,
   KOKKOS_LAMBDA(int m, int k, int j, int i) {
     bx3f(m,k,j,i) = gam0*bx3f(m,k,j,i) + gam1*bx3f_old(m,k,j,i);
@@ -78,4 +119,131 @@ TaskStatus MHD::CT(Driver *pdriver, int stage) {
 
   return TaskStatus::complete;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn  Real MHD::DivBMax
+//  \brief Returns max |div(B)| over all MeshBlocks on this rank accumulated by CT() since
+//  the last call, and resets the accumulators.
+
+Real MHD::DivBMax() {
+  auto &dmax = divb_max;
+  Real rank_max = 0.0;
+  Kokkos::parallel_reduce("divb_max", Kokkos::RangePolicy<>(DevExeSpace(), 0,
+                          dmax.extent_int(0)),
+  KOKKOS_LAMBDA(const int m, Real &max_m) {
+    max_m = fmax(max_m, dmax(m));
+  }, Kokkos::Max<Real>(rank_max));
+  Kokkos::deep_copy(divb_max, 0.0);
+  return rank_max;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MHD::FusedCT
+//  \brief CT update in 3D in which edge EMFs are integrated to corners in team scratch
+//  in the same kernel that updates the face-centered fields, avoiding a round trip of
+//  efld through global memory.  Each team updates all faces with lower-left corner at
+//  (k,j), and so computes the rows of E1 at (k,j),(k+1,j),(k,j+1), and of E2 and E3 at
+//  (k,j) and at (k+1,j) and (k,j+1) respectively.  EMFs on the MeshBlock surface are
+//  read from efld, where they were stored by CornerE() and corrected by RecvE().
+
+void MHD::FusedCT(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+
+  // capture class variables for the kernels
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  auto e1 = efld.x1e;
+  auto e2 = efld.x2e;
+  auto e3 = efld.x3e;
+  auto e2x1_ = e2x1;
+  auto e3x1_ = e3x1;
+  auto e1x2_ = e1x2;
+  auto e3x2_ = e3x2;
+  auto e1x3_ = e1x3;
+  auto e2x3_ = e2x3;
+  auto e1cc_ = e1_cc;
+  auto e2cc_ = e2_cc;
+  auto e3cc_ = e3_cc;
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto bx1f = b0.x1f;
+  auto bx2f = b0.x2f;
+  auto bx3f = b0.x3f;
+  auto bx1f_old = b1.x1f;
+  auto bx2f_old = b1.x2f;
+  auto bx3f_old = b1.x3f;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+
+  size_t scr_size = ScrArray2D<Real>::shmem_size(3, ncells1) +
+                    ScrArray2D<Real>::shmem_size(2, ncells1) * 2;
+  int scr_level = 0;
+  par_for_outer("CT-fused", DevExeSpace(), scr_size, scr_level, 0, nmb1,
+                ks, ke+1, js, je+1,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> e1s(member.team_scratch(scr_level), 3, ncells1);
+    ScrArray2D<Real> e2s(member.team_scratch(scr_level), 2, ncells1);
+    ScrArray2D<Real> e3s(member.team_scratch(scr_level), 2, ncells1);
+
+    // EMFs on MeshBlock surface are loaded from efld, all others are computed
+    auto emf1 = [&](const int kk, const int jj, const int i) {
+      if (jj == js || jj == je+1 || kk == ks || kk == ke+1) {return e1(m,kk,jj,i);}
+      return CornerE1(m, kk, jj, i, flx2, flx3, e1x2_, e1x3_, e1cc_);
+    };
+    auto emf2 = [&](const int kk, const int jj, const int i) {
+      if (i == is || i == ie+1 || kk == ks || kk == ke+1) {return e2(m,kk,jj,i);}
+      return CornerE2(m, kk, jj, i, flx1, flx3, e2x1_, e2x3_, e2cc_);
+    };
+    auto emf3 = [&](const int kk, const int jj, const int i) {
+      if (i == is || i == ie+1 || jj == js || jj == je+1) {return e3(m,kk,jj,i);}
+      return CornerE3(m, kk, jj, i, flx1, flx2, e3x1_, e3x2_, e3cc_);
+    };
+
+    par_for_inner(member, is, ie+1, [&](const int i) {
+      if (i <= ie) {
+        e1s(0,i) = emf1(k,j,i);
+        if (k <= ke) {e1s(1,i) = emf1(k+1,j,i);}
+        if (j <= je) {e1s(2,i) = emf1(k,j+1,i);}
+      }
+      if (j <= je) {
+        e2s(0,i) = emf2(k,j,i);
+        if (k <= ke) {e2s(1,i) = emf2(k+1,j,i);}
+      }
+      if (k <= ke) {
+        e3s(0,i) = emf3(k,j,i);
+        if (j <= je) {e3s(1,i) = emf3(k,j+1,i);}
+      }
+    });
+    member.team_barrier();
+
+    par_for_inner(member, is, ie+1, [&](const int i) {
+      // update B1
+      if (k <= ke && j <= je) {
+        bx1f(m,k,j,i) = gam0*bx1f(m,k,j,i) + gam1*bx1f_old(m,k,j,i);
+        bx1f(m,k,j,i) -= beta_dt*(e3s(1,i) - e3s(0,i))/mbsize.d_view(m).dx2;
+        bx1f(m,k,j,i) += beta_dt*(e2s(1,i) - e2s(0,i))/mbsize.d_view(m).dx3;
+      }
+      // update B2
+      if (k <= ke && i <= ie) {
+        bx2f(m,k,j,i) = gam0*bx2f(m,k,j,i) + gam1*bx2f_old(m,k,j,i);
+        bx2f(m,k,j,i) += beta_dt*(e3s(0,i+1) - e3s(0,i))/mbsize.d_view(m).dx1;
+        bx2f(m,k,j,i) -= beta_dt*(e1s(1,i) - e1s(0,i))/mbsize.d_view(m).dx3;
+      }
+      // update B3
+      if (j <= je && i <= ie) {
+        bx3f(m,k,j,i) = gam0*bx3f(m,k,j,i) + gam1*bx3f_old(m,k,j,i);
+        bx3f(m,k,j,i) -= beta_dt*(e2s(0,i+1) - e2s(0,i))/mbsize.d_view(m).dx1;
+        bx3f(m,k,j,i) += beta_dt*(e1s(2,i) - e1s(0,i))/mbsize.d_view(m).dx2;
+      }
+    });
+  });
+
+  return;
+}
 } // namespace mhd
@@ -7,7 +7,8 @@
 //! \brief Calculate fluxes of the conserved variables, and area-averaged electric fields
 //! E = - (v X B) on cell faces for mhd.  Fluxes are stored in face-centered vector
 //! 'uflx', while electric fields are stored in individual arrays: e2x1,e3x1 on x1-faces;
-//! e1x2,e3x2 on x2-faces; e1x3,e2x3 on x3-faces.
+//! e1x2,e3x2 on x2-faces; e1x3,e2x3 on x3-faces.  With use_fused_aniso_cond, the
+//! anisotropic heat flux is added to the energy flux inside the same kernels.
 
 #include <iostream>
 
@@ -15,10 +16,14 @@
 #include "mesh/mesh.hpp"
 #include "mhd.hpp"
 #include "eos/eos.hpp"
+#include "diffusion/conduction.hpp"
+#include "diffusion/aniso_conduction.hpp"
 #include "reconstruct/dc.hpp"
 #include "reconstruct/plm.hpp"
 #include "reconstruct/ppm.hpp"
 #include "reconstruct/wenoz.hpp"
+#include "reconstruct/flux_region.hpp"
+#include "reconstruct/scalar_fluxes.hpp"
 #include "mhd/rsolvers/advect_mhd.hpp"
 #include "mhd/rsolvers/llf_mhd.hpp"
 #include "mhd/rsolvers/hlle_mhd.hpp"
@@ -28,42 +33,86 @@
 #include "mhd/rsolvers/llf_grmhd.hpp"
 #include "mhd/rsolvers/hlle_grmhd.hpp"
 // #include "mhd/rsolvers/roe_mhd.hpp"
+#include "utils/roofline.hpp"
 
 namespace mhd {
+//----------------------------------------------------------------------------------------
+//! \fn Real RSolverFlops()
+//! \brief Rough number of floating point operations of the Riemann solver and EMFs at
+//! one face, used for the estimates in utils/roofline.hpp.
+
+constexpr Real RSolverFlops(MHD_RSolver rs) {
+  switch (rs) {
+    case MHD_RSolver::advect: return 20.0;
+    case MHD_RSolver::llf: return 100.0;
+    case MHD_RSolver::hlle: return 150.0;
+    case MHD_RSolver::hlld: return 300.0;
+    case MHD_RSolver::roe: return 400.0;
+    case MHD_RSolver::llf_sr: case MHD_RSolver::hlle_sr: return 400.0;
+    default: return 600.0;  // GR
+  }
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MHD::CalculateFlux
 //! \brief Calculate fluxes of conserved variables, and face-centered area-averaged EMFs
 //! for evolution of magnetic field
-//! Note this function is templated over RS for better performance on GPUs.
-
-template <MHD_RSolver rsolver_method_>
-void MHD::CalculateFluxes(Driver *pdriver, int stage) {
+//! Note this function is templated over RS and reconstruction method, so that a fully
+//! specialised kernel without branches in the inner loops is compiled for each pair.
+//! The instantiation to use is selected once in SelectFluxFunction().
+//! Reconstructed L/R states are stored in team scratch with type TF, which is float
+//! with <mhd>/mixed_precision=true.  Fluxes (and so u0, b0, the RK update and CT) are
+//! always stored in Real.
+//! With region=interior (boundary) only fluxes on faces which do not (do) depend on
+//! ghost zones are computed, see reconstruct/flux_region.hpp
+
+template <MHD_RSolver rsolver_method_, ReconstructionMethod recon_method_, typename TF>
+void MHD::CalculateFluxes(Driver *pdriver, int stage, FluxRegion region) {
   RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
   int is = indcs_.is, ie = indcs_.ie;
   int js = indcs_.js, je = indcs_.je;
   int ks = indcs_.ks, ke = indcs_.ke;
   int ncells1 = indcs_.nx1 + 2*(indcs_.ng);
+  // indices used inside kernels, constexpr if MeshBlock size is fixed at compile time
+  const KernelIndcs ki(indcs_);
 
   int &nmhd_ = nmhd;
   int nvars = nmhd + nscalars;
+  // number of variables reconstructed here (scalars done later with scalar_reconstruct)
+  int nrecon = (use_scalar_fluxes)? nmhd : nvars;
   int nmb1 = pmy_pack->nmb_thispack - 1;
-  const auto recon_method_ = recon_method;
-  bool extrema = false;
-  if (recon_method == ReconstructionMethod::ppmx) {
-    extrema = true;
-  }
+  constexpr bool extrema = (recon_method_ == ReconstructionMethod::ppmx);
 
   auto &eos_ = peos->eos_data;
   auto &size_ = pmy_pack->pmb->mb_size;
+  pmy_pack->pcoord->UpdateMetricCache();
   auto &coord_ = pmy_pack->pcoord->coord_data;
   auto &w0_ = w0;
   auto &b0_ = bcc0;
+  int nb = FluxStencilWidth(recon_method_);
+
+  // anisotropic heat flux is added on active faces while the rows of W and B adjacent to
+  // each face are in cache (see MHD::use_fused_aniso_cond)
+  bool aniso = use_fused_aniso_cond;
+  Real kappa_aniso = (aniso)? pcond->kappa_aniso : 0.0;
+  bool use_e = eos_.use_e;
+  Real gm1 = eos_.gamma - 1.0;
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+
+  // estimated work per face for roofline analysis: W and B loaded, flux and two EMFs
+  // stored once.  Interior and boundary passes together cover each face once.
+  Real ncells = (region == FluxRegion::boundary)? 0.0 :
+      static_cast<Real>(nmb1 + 1)*indcs_.nx1*indcs_.nx2*indcs_.nx3;
+  Real face_bytes = (2.0*nvars + 5.0)*sizeof(Real);
+  Real face_flops = (nrecon + 2)*roofline::ReconFlops(recon_method_) +
+                    RSolverFlops(rsolver_method_);
 
   //--------------------------------------------------------------------------------------
   // i-direction
 
-  size_t scr_size = (ScrArray2D<Real>::shmem_size(nvars, ncells1) +
-                     ScrArray2D<Real>::shmem_size(3, ncells1)) * 2;
+  size_t scr_size = (ScrArray2D<TF>::shmem_size(nrecon, ncells1) +
+                     ScrArray2D<TF>::shmem_size(3, ncells1)) * 2;
   int scr_level = 0;
   auto &flx1_ = uflx.x1f;
   auto &e31_ = e3x1;
@@ -81,79 +130,95 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
   }
   int il = is, iu = ie+1;
   if (use_fofc) { il = is-1, iu = ie+2; }
+  // rows in transverse ghost zones contain only boundary faces
+  FaceRanges rng1  = FluxFaceRanges(region, nb, false, il, iu, is, ie, 0, 0, 0, 0);
+  FaceRanges rng1g = FluxFaceRanges(region, nb, true,  il, iu, is, ie, 0, 0, 0, 0);
 
+  roofline::AddWork("mhd_flux1", ncells, face_bytes, face_flops);
   par_for_outer("mhd_flux1",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku, jl, ju,
   KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
-    ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
-    ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
-    ScrArray2D<Real> bl(member.team_scratch(scr_level), 3, ncells1);
-    ScrArray2D<Real> br(member.team_scratch(scr_level), 3, ncells1);
-
-    // Reconstruct qR[i] and qL[i+1], for both W and Bcc
-    switch (recon_method_) {
-      case ReconstructionMethod::dc:
-        DonorCellX1(member, m, k, j, il-1, iu, w0_, wl, wr);
-        DonorCellX1(member, m, k, j, il-1, iu, b0_, bl, br);
-        break;
-      case ReconstructionMethod::plm:
-        PiecewiseLinearX1(member, m, k, j, il-1, iu, w0_, wl, wr);
-        PiecewiseLinearX1(member, m, k, j, il-1, iu, b0_, bl, br);
-        break;
-      case ReconstructionMethod::ppm4:
-      case ReconstructionMethod::ppmx:
-        PiecewiseParabolicX1(member,eos_,extrema,true,  m, k, j, il-1, iu, w0_, wl, wr);
-        PiecewiseParabolicX1(member,eos_,extrema,false, m, k, j, il-1, iu, b0_, bl, br);
-        break;
-      case ReconstructionMethod::wenoz:
-        WENOZX1(member, eos_, true,  m, k, j, il-1, iu, w0_, wl, wr);
-        WENOZX1(member, eos_, false, m, k, j, il-1, iu, b0_, bl, br);
-        break;
-      default:
-        break;
-    }
-    // Sync all threads in the team so that scratch memory is consistent
-    member.team_barrier();
-
-    // compute fluxes over [is,ie+1].  MHD RS also computes electric fields, where
-    // (IBY) component of flx = E_{z} = -(v x B)_{z} = -(v1*b2 - v2*b1)
-    // (IBZ) component of flx = E_{y} = -(v x B)_{y} =  (v1*b3 - v3*b1)
-    // NOTE(@pdmullen): Capture variables prior to if constexpr.  Required for cuda 11.6+.
-    auto eos = eos_;
-    auto indcs = indcs_;
-    auto size = size_;
-    auto coord = coord_;
-    auto bx = bx_;
-    auto flx1 = flx1_;
-    auto e31 = e31_;
-    auto e21 = e21_;
-    if constexpr (rsolver_method_ == MHD_RSolver::advect) {
-      Advect(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
-    } else if constexpr (rsolver_method_ == MHD_RSolver::llf) {
-      LLF(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
-    } else if constexpr (rsolver_method_ == MHD_RSolver::hlle) {
-      HLLE(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
-    } else if constexpr (rsolver_method_ == MHD_RSolver::hlld) {
-      HLLD(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
-    } else if constexpr (rsolver_method_ == MHD_RSolver::llf_sr) {
-      LLF_SR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
-    } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_sr) {
-      HLLE_SR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
-    } else if constexpr (rsolver_method_ == MHD_RSolver::llf_gr) {
-      LLF_GR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
-    } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_gr) {
-      HLLE_GR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
-    }
-    member.team_barrier();
-
-    // calculate fluxes of scalars (if any)
-    if (nvars > nmhd_) {
-      for (int n=nmhd_; n<nvars; ++n) {
-        par_for_inner(member, is, ie+1, [&](const int i) {
-          if (flx1_(m,IDN,k,j,i) >= 0.0) {
-            flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wl(n,i);
-          } else {
-            flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wr(n,i);
-          }
+    ScrArray2D<TF> wl(member.team_scratch(scr_level), nrecon, ki.ncells1);
+    ScrArray2D<TF> wr(member.team_scratch(scr_level), nrecon, ki.ncells1);
+    ScrArray2D<TF> bl(member.team_scratch(scr_level), 3, ki.ncells1);
+    ScrArray2D<TF> br(member.team_scratch(scr_level), 3, ki.ncells1);
+    const FaceRanges &rng_ =
+        ((j<ki.js) || (j>ki.je) || (k<ki.ks) || (k>ki.ke))? rng1g : rng1;
+
+    for (int r=0; r<rng_.n; ++r) {
+      int fl = rng_.fl[r], fu = rng_.fu[r];
+      int sl = (fl > ki.is)? fl : ki.is, su = (fu < ki.ie+1)? fu : ki.ie+1;
+
+      // Reconstruct qR[i] and qL[i+1], for both W and Bcc
+      // Capture views prior to if constexpr.
+      auto w = w0_;
+      auto bcc = b0_;
+      if constexpr (recon_method_ == ReconstructionMethod::dc) {
+        DonorCellX1(member, m, k, j, fl-1, fu, w, wl, wr, nrecon);
+        DonorCellX1(member, m, k, j, fl-1, fu, bcc, bl, br);
+      } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+        PiecewiseLinearX1(member, m, k, j, fl-1, fu, w, wl, wr, nrecon);
+        PiecewiseLinearX1(member, m, k, j, fl-1, fu, bcc, bl, br);
+      } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                           recon_method_ == ReconstructionMethod::ppmx) {
+        PiecewiseParabolicX1(member,eos_,extrema,true,  m, k, j, fl-1, fu, w, wl, wr,
+                             nrecon);
+        PiecewiseParabolicX1(member,eos_,extrema,false, m, k, j, fl-1, fu, bcc, bl, br);
+      } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+        WENOZX1(member, eos_, true,  m, k, j, fl-1, fu, w, wl, wr, nrecon);
+        WENOZX1(member, eos_, false, m, k, j, fl-1, fu, bcc, bl, br);
+      }
+      // Sync all threads in the team so that scratch memory is consistent
+      member.team_barrier();
+
+      // compute fluxes over [fl,fu].  MHD RS also computes electric fields, where
+      // (IBY) component of flx = E_{z} = -(v x B)_{z} = -(v1*b2 - v2*b1)
+      // (IBZ) component of flx = E_{y} = -(v x B)_{y} =  (v1*b3 - v3*b1)
+      // NOTE(@pdmullen): Capture variables prior to if constexpr.
+      auto eos = eos_;
+      auto indcs = indcs_;
+      auto size = size_;
+      auto coord = coord_;
+      auto bx = bx_;
+      auto flx1 = flx1_;
+      auto e31 = e31_;
+      auto e21 = e21_;
+      if constexpr (rsolver_method_ == MHD_RSolver::advect) {
+        Advect(member,eos,indcs,size,coord,m,k,j,fl,fu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
+      } else if constexpr (rsolver_method_ == MHD_RSolver::llf) {
+        LLF(member,eos,indcs,size,coord,m,k,j,fl,fu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
+      } else if constexpr (rsolver_method_ == MHD_RSolver::hlle) {
+        HLLE(member,eos,indcs,size,coord,m,k,j,fl,fu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
+      } else if constexpr (rsolver_method_ == MHD_RSolver::hlld) {
+        HLLD(member,eos,indcs,size,coord,m,k,j,fl,fu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
+      } else if constexpr (rsolver_method_ == MHD_RSolver::llf_sr) {
+        LLF_SR(member,eos,indcs,size,coord,m,k,j,fl,fu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
+      } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_sr) {
+        HLLE_SR(member,eos,indcs,size,coord,m,k,j,fl,fu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
+      } else if constexpr (rsolver_method_ == MHD_RSolver::llf_gr) {
+        LLF_GR(member,eos,indcs,size,coord,m,k,j,fl,fu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
+      } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_gr) {
+        HLLE_GR(member,eos,indcs,size,coord,m,k,j,fl,fu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
+      }
+      member.team_barrier();
+
+      // calculate fluxes of scalars (if any)
+      if (nrecon > nmhd_) {
+        for (int n=nmhd_; n<nrecon; ++n) {
+          par_for_inner(member, sl, su, [&](const int i) {
+            if (flx1_(m,IDN,k,j,i) >= 0.0) {
+              flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wl(n,i);
+            } else {
+              flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wr(n,i);
+            }
+          });
+        }
+      }
+
+      // add anisotropic heat flux on active faces
+      if (aniso && (j>=js) && (j<=je) && (k>=ks) && (k<=ke)) {
+        par_for_inner(member, sl, su, [&](const int i) {
+          flx1_(m,IEN,k,j,i) += AnisoHeatFluxX1(m,k,j,i,w0_,b0_,bx_,use_e,gm1,
+                                    size_.d_view(m),multi_d,three_d,kappa_aniso);
         });
       }
     }
@@ -163,8 +228,8 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
   // j-direction
 
   if (pmy_pack->pmesh->multi_d) {
-    scr_size = (ScrArray2D<Real>::shmem_size(nvars, ncells1) +
-                ScrArray2D<Real>::shmem_size(3, ncells1)) * 3;
+    scr_size = (ScrArray2D<TF>::shmem_size(nrecon, ncells1) +
+                ScrArray2D<TF>::shmem_size(3, ncells1)) * 3;
     auto &flx2_ = uflx.x2f;
     auto &by_ = b0.x2f;
     auto &e12_ = e1x2;
@@ -179,108 +244,126 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
     jl = js-1, ju = je+1;
     if (use_fofc) { jl = js-2, ju = je+2; }
 
+    // planes in transverse ghost zones contain only boundary faces
+    FaceRanges rng2  = FluxFaceRanges(region, nb, false, jl+1,ju,js,je,is-1,ie+1,is,ie);
+    FaceRanges rng2g = FluxFaceRanges(region, nb, true,  jl+1,ju,js,je,is-1,ie+1,is,ie);
+
+    roofline::AddWork("mhd_flux2", ncells, face_bytes, face_flops);
     par_for_outer("mhd_flux2",DevExeSpace(),scr_size,scr_level,0,nmb1, kl, ku,
     KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
-      ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
-      ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
-      ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
-      ScrArray2D<Real> scr4(member.team_scratch(scr_level), 3, ncells1);
-      ScrArray2D<Real> scr5(member.team_scratch(scr_level), 3, ncells1);
-      ScrArray2D<Real> scr6(member.team_scratch(scr_level), 3, ncells1);
-
-      for (int j=jl; j<=ju; ++j) {
-        // Permute scratch arrays.
-        auto wl     = scr1;
-        auto wl_jp1 = scr2;
-        auto wr     = scr3;
-        auto bl     = scr4;
-        auto bl_jp1 = scr5;
-        auto br     = scr6;
-        if ((j%2) == 0) {
-          wl     = scr2;
-          wl_jp1 = scr1;
-          bl     = scr5;
-          bl_jp1 = scr4;
-        }
+      ScrArray2D<TF> scr1(member.team_scratch(scr_level), nrecon, ki.ncells1);
+      ScrArray2D<TF> scr2(member.team_scratch(scr_level), nrecon, ki.ncells1);
+      ScrArray2D<TF> scr3(member.team_scratch(scr_level), nrecon, ki.ncells1);
+      ScrArray2D<TF> scr4(member.team_scratch(scr_level), 3, ki.ncells1);
+      ScrArray2D<TF> scr5(member.team_scratch(scr_level), 3, ki.ncells1);
+      ScrArray2D<TF> scr6(member.team_scratch(scr_level), 3, ki.ncells1);
+
+      const FaceRanges &rng_ = ((k<ki.ks) || (k>ki.ke))? rng2g : rng2;
+
+      for (int r=0; r<rng_.n; ++r) {
+        int fl = rng_.fl[r], fu = rng_.fu[r];
+        int tl = rng_.tl[r], tu = rng_.tu[r];
+        int sl = (tl > ki.is)? tl : ki.is, su = (tu < ki.ie)? tu : ki.ie;
+
+        for (int j=fl-1; j<=fu; ++j) {
+          // Permute scratch arrays.
+          auto wl     = scr1;
+          auto wl_jp1 = scr2;
+          auto wr     = scr3;
+          auto bl     = scr4;
+          auto bl_jp1 = scr5;
+          auto br     = scr6;
+          if ((j%2) == 0) {
+            wl     = scr2;
+            wl_jp1 = scr1;
+            bl     = scr5;
+            bl_jp1 = scr4;
+          }
 
-        // Reconstruct qR[j] and qL[j+1], for both W and Bcc
-        switch (recon_method_) {
-          case ReconstructionMethod::dc:
-            DonorCellX2(member, m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
-            DonorCellX2(member, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
-            break;
-          case ReconstructionMethod::plm:
-            PiecewiseLinearX2(member, m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
-            PiecewiseLinearX2(member, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
-            break;
-          case ReconstructionMethod::ppm4:
-          case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX2(member,eos_,extrema,true, m,k,j,is-1,ie+1,w0_,wl_jp1,wr);
-            PiecewiseParabolicX2(member,eos_,extrema,false,m,k,j,is-1,ie+1,b0_,bl_jp1,br);
-            break;
-          case ReconstructionMethod::wenoz:
-            WENOZX2(member, eos_, true,  m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
-            WENOZX2(member, eos_, false, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
-            break;
-          default:
-            break;
-        }
-        member.team_barrier();
-
-        // compute fluxes over [js,je+1].  MHD RS also computes electric fields, where
-        // (IBY) component of flx = E_{x} = -(v x B)_{x} = -(v2*b3 - v3*b2)
-        // (IBZ) component of flx = E_{z} = -(v x B)_{z} =  (v2*b1 - v1*b2)
-        if (j>jl) {
-          // NOTE(@pdmullen): Capture variables prior to if constexpr.
-          auto eos = eos_;
-          auto indcs = indcs_;
-          auto size = size_;
-          auto coord = coord_;
-          auto by = by_;
-          auto flx2 = flx2_;
-          auto e12 = e12_;
-          auto e32 = e32_;
-          if constexpr (rsolver_method_ == MHD_RSolver::advect) {
-            Advect(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::llf) {
-            LLF(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::hlle) {
-            HLLE(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::hlld) {
-            HLLD(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::llf_sr) {
-            LLF_SR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_sr) {
-            HLLE_SR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::llf_gr) {
-            LLF_GR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_gr) {
-            HLLE_GR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+          // Reconstruct qR[j] and qL[j+1], for both W and Bcc
+          // Capture views prior to if constexpr.
+          auto w = w0_;
+          auto bcc = b0_;
+          if constexpr (recon_method_ == ReconstructionMethod::dc) {
+            DonorCellX2(member, m, k, j, tl, tu, w, wl_jp1, wr, nrecon);
+            DonorCellX2(member, m, k, j, tl, tu, bcc, bl_jp1, br);
+          } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+            PiecewiseLinearX2(member, m, k, j, tl, tu, w, wl_jp1, wr, nrecon);
+            PiecewiseLinearX2(member, m, k, j, tl, tu, bcc, bl_jp1, br);
+          } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                               recon_method_ == ReconstructionMethod::ppmx) {
+            PiecewiseParabolicX2(member,eos_,extrema,true, m,k,j,tl,tu,w,wl_jp1,wr,
+                                 nrecon);
+            PiecewiseParabolicX2(member,eos_,extrema,false,m,k,j,tl,tu,bcc,bl_jp1,br);
+          } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+            WENOZX2(member, eos_, true,  m, k, j, tl, tu, w, wl_jp1, wr, nrecon);
+            WENOZX2(member, eos_, false, m, k, j, tl, tu, bcc, bl_jp1, br);
           }
           member.team_barrier();
-        }
 
-        // calculate fluxes of scalars (if any)
-        if (nvars > nmhd_) {
-          for (int n=nmhd_; n<nvars; ++n) {
-            par_for_inner(member, is, ie, [&](const int i) {
-              if (flx2_(m,IDN,k,j,i) >= 0.0) {
-                flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wl(n,i);
-              } else {
-                flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wr(n,i);
-              }
+          // compute fluxes over [fl,fu].  MHD RS also computes electric fields, where
+          // (IBY) component of flx = E_{x} = -(v x B)_{x} = -(v2*b3 - v3*b2)
+          // (IBZ) component of flx = E_{z} = -(v x B)_{z} =  (v2*b1 - v1*b2)
+          if (j>=fl) {
+            // NOTE(@pdmullen): Capture variables prior to if constexpr.
+            auto eos = eos_;
+            auto indcs = indcs_;
+            auto size = size_;
+            auto coord = coord_;
+            auto by = by_;
+            auto flx2 = flx2_;
+            auto e12 = e12_;
+            auto e32 = e32_;
+            if constexpr (rsolver_method_ == MHD_RSolver::advect) {
+              Advect(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::llf) {
+              LLF(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::hlle) {
+              HLLE(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::hlld) {
+              HLLD(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::llf_sr) {
+              LLF_SR(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_sr) {
+              HLLE_SR(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::llf_gr) {
+              LLF_GR(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_gr) {
+              HLLE_GR(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+            }
+            member.team_barrier();
+          }
+
+          // calculate fluxes of scalars (if any)
+          if ((nrecon > nmhd_) && (j>=fl)) {
+            for (int n=nmhd_; n<nrecon; ++n) {
+              par_for_inner(member, sl, su, [&](const int i) {
+                if (flx2_(m,IDN,k,j,i) >= 0.0) {
+                  flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wl(n,i);
+                } else {
+                  flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wr(n,i);
+                }
+              });
+            }
+          }
+
+          // add anisotropic heat flux on active faces
+          if (aniso && (j>=fl) && (j>=js) && (j<=je+1) && (k>=ks) && (k<=ke)) {
+            par_for_inner(member, sl, su, [&](const int i) {
+              flx2_(m,IEN,k,j,i) += AnisoHeatFluxX2(m,k,j,i,w0_,b0_,by_,use_e,gm1,
+                                        size_.d_view(m),three_d,kappa_aniso);
             });
           }
-        }
-      } // end of loop over j
+        } // end of loop over j
+      }
     });
   }
 
@@ -288,8 +371,8 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
   // k-direction. Note order of k,j loops switched
 
   if (pmy_pack->pmesh->three_d) {
-    scr_size = (ScrArray2D<Real>::shmem_size(nvars, ncells1) +
-                ScrArray2D<Real>::shmem_size(3, ncells1)) * 3;
+    scr_size = (ScrArray2D<TF>::shmem_size(nrecon, ncells1) +
+                ScrArray2D<TF>::shmem_size(3, ncells1)) * 3;
     auto &flx3_ = uflx.x3f;
     auto &bz_ = b0.x3f;
     auto &e23_ = e2x3;
@@ -299,122 +382,195 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
     kl = ks-1, ku = ke+1;
     if (use_fofc) { kl = ks-2, ku = ke+2; }
 
+    // planes in transverse ghost zones contain only boundary faces
+    FaceRanges rng3  = FluxFaceRanges(region, nb, false, kl+1,ku,ks,ke,is-1,ie+1,is,ie);
+    FaceRanges rng3g = FluxFaceRanges(region, nb, true,  kl+1,ku,ks,ke,is-1,ie+1,is,ie);
+
+    roofline::AddWork("mhd_flux3", ncells, face_bytes, face_flops);
     par_for_outer("mhd_flux3",DevExeSpace(), scr_size, scr_level, 0, nmb1, js-1, je+1,
     KOKKOS_LAMBDA(TeamMember_t member, const int m, const int j) {
-      ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
-      ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
-      ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
-      ScrArray2D<Real> scr4(member.team_scratch(scr_level), 3, ncells1);
-      ScrArray2D<Real> scr5(member.team_scratch(scr_level), 3, ncells1);
-      ScrArray2D<Real> scr6(member.team_scratch(scr_level), 3, ncells1);
-
-      for (int k=kl; k<=ku; ++k) {
-        // Permute scratch arrays.
-        auto wl     = scr1;
-        auto wl_kp1 = scr2;
-        auto wr     = scr3;
-        auto bl     = scr4;
-        auto bl_kp1 = scr5;
-        auto br     = scr6;
-        if ((k%2) == 0) {
-          wl     = scr2;
-          wl_kp1 = scr1;
-          bl     = scr5;
-          bl_kp1 = scr4;
-        }
+      ScrArray2D<TF> scr1(member.team_scratch(scr_level), nrecon, ki.ncells1);
+      ScrArray2D<TF> scr2(member.team_scratch(scr_level), nrecon, ki.ncells1);
+      ScrArray2D<TF> scr3(member.team_scratch(scr_level), nrecon, ki.ncells1);
+      ScrArray2D<TF> scr4(member.team_scratch(scr_level), 3, ki.ncells1);
+      ScrArray2D<TF> scr5(member.team_scratch(scr_level), 3, ki.ncells1);
+      ScrArray2D<TF> scr6(member.team_scratch(scr_level), 3, ki.ncells1);
+
+      const FaceRanges &rng_ = ((j<ki.js) || (j>ki.je))? rng3g : rng3;
+
+      for (int r=0; r<rng_.n; ++r) {
+        int fl = rng_.fl[r], fu = rng_.fu[r];
+        int tl = rng_.tl[r], tu = rng_.tu[r];
+        int sl = (tl > ki.is)? tl : ki.is, su = (tu < ki.ie)? tu : ki.ie;
+
+        for (int k=fl-1; k<=fu; ++k) {
+          // Permute scratch arrays.
+          auto wl     = scr1;
+          auto wl_kp1 = scr2;
+          auto wr     = scr3;
+          auto bl     = scr4;
+          auto bl_kp1 = scr5;
+          auto br     = scr6;
+          if ((k%2) == 0) {
+            wl     = scr2;
+            wl_kp1 = scr1;
+            bl     = scr5;
+            bl_kp1 = scr4;
+          }
 
-        // Reconstruct qR[k] and qL[k+1], for both W and Bcc
-        switch (recon_method_) {
-          case ReconstructionMethod::dc:
-            DonorCellX3(member, m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
-            DonorCellX3(member, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
-            break;
-          case ReconstructionMethod::plm:
-            PiecewiseLinearX3(member, m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
-            PiecewiseLinearX3(member, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
-            break;
-          case ReconstructionMethod::ppm4:
-          case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX3(member,eos_,extrema,true, m,k,j,is-1,ie+1,w0_,wl_kp1,wr);
-            PiecewiseParabolicX3(member,eos_,extrema,false,m,k,j,is-1,ie+1,b0_,bl_kp1,br);
-            break;
-          case ReconstructionMethod::wenoz:
-            WENOZX3(member, eos_, true,  m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
-            WENOZX3(member, eos_, false, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
-            break;
-          default:
-            break;
-        }
-        member.team_barrier();
-
-        // compute fluxes over [ks,ke+1].  MHD RS also computes electric fields, where
-        // (IBY) component of flx = E_{y} = -(v x B)_{y} = -(v3*b1 - v1*b3)
-        // (IBZ) component of flx = E_{x} = -(v x B)_{x} =  (v3*b2 - v2*b3)
-        if (k>kl) {
-          // NOTE(@pdmullen): Capture variables prior to if constexpr.
-          auto eos = eos_;
-          auto indcs = indcs_;
-          auto size = size_;
-          auto coord = coord_;
-          auto bz = bz_;
-          auto flx3 = flx3_;
-          auto e23 = e23_;
-          auto e13 = e13_;
-          if constexpr (rsolver_method_ == MHD_RSolver::advect) {
-            Advect(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::llf) {
-            LLF(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::hlle) {
-            HLLE(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::hlld) {
-            HLLD(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::llf_sr) {
-            LLF_SR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_sr) {
-            HLLE_SR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::llf_gr) {
-            LLF_GR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
-          } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_gr) {
-            HLLE_GR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+          // Reconstruct qR[k] and qL[k+1], for both W and Bcc
+          // Capture views prior to if constexpr.
+          auto w = w0_;
+          auto bcc = b0_;
+          if constexpr (recon_method_ == ReconstructionMethod::dc) {
+            DonorCellX3(member, m, k, j, tl, tu, w, wl_kp1, wr, nrecon);
+            DonorCellX3(member, m, k, j, tl, tu, bcc, bl_kp1, br);
+          } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+            PiecewiseLinearX3(member, m, k, j, tl, tu, w, wl_kp1, wr, nrecon);
+            PiecewiseLinearX3(member, m, k, j, tl, tu, bcc, bl_kp1, br);
+          } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                               recon_method_ == ReconstructionMethod::ppmx) {
+            PiecewiseParabolicX3(member,eos_,extrema,true, m,k,j,tl,tu,w,wl_kp1,wr,
+                                 nrecon);
+            PiecewiseParabolicX3(member,eos_,extrema,false,m,k,j,tl,tu,bcc,bl_kp1,br);
+          } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+            WENOZX3(member, eos_, true,  m, k, j, tl, tu, w, wl_kp1, wr, nrecon);
+            WENOZX3(member, eos_, false, m, k, j, tl, tu, bcc, bl_kp1, br);
           }
           member.team_barrier();
-        }
 
-        // calculate fluxes of scalars (if any)
-        if (nvars > nmhd_) {
-          for (int n=nmhd_; n<nvars; ++n) {
-            par_for_inner(member, is, ie, [&](const int i) {
-              if (flx3_(m,IDN,k,j,i) >= 0.0) {
-                flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wl(n,i);
-              } else {
-                flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wr(n,i);
-              }
+          // compute fluxes over [fl,fu].  MHD RS also computes electric fields, where
+          // (IBY) component of flx = E_{y} = -(v x B)_{y} = -(v3*b1 - v1*b3)
+          // (IBZ) component of flx = E_{x} = -(v x B)_{x} =  (v3*b2 - v2*b3)
+          if (k>=fl) {
+            // NOTE(@pdmullen): Capture variables prior to if constexpr.
+            auto eos = eos_;
+            auto indcs = indcs_;
+            auto size = size_;
+            auto coord = coord_;
+            auto bz = bz_;
+            auto flx3 = flx3_;
+            auto e23 = e23_;
+            auto e13 = e13_;
+            if constexpr (rsolver_method_ == MHD_RSolver::advect) {
+              Advect(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::llf) {
+              LLF(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::hlle) {
+              HLLE(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::hlld) {
+              HLLD(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::llf_sr) {
+              LLF_SR(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_sr) {
+              HLLE_SR(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::llf_gr) {
+              LLF_GR(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+            } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_gr) {
+              HLLE_GR(member,eos,indcs,size,coord,
+                      m,k,j,tl,tu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+            }
+            member.team_barrier();
+          }
+
+          // calculate fluxes of scalars (if any)
+          if ((nrecon > nmhd_) && (k>=fl)) {
+            for (int n=nmhd_; n<nrecon; ++n) {
+              par_for_inner(member, sl, su, [&](const int i) {
+                if (flx3_(m,IDN,k,j,i) >= 0.0) {
+                  flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wl(n,i);
+                } else {
+                  flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wr(n,i);
+                }
+              });
+            }
+          }
+
+          // add anisotropic heat flux on active faces
+          if (aniso && (k>=fl) && (k>=ks) && (k<=ke+1) && (j>=js) && (j<=je)) {
+            par_for_inner(member, sl, su, [&](const int i) {
+              flx3_(m,IEN,k,j,i) += AnisoHeatFluxX3(m,k,j,i,w0_,b0_,bz_,use_e,gm1,
+                                        size_.d_view(m),kappa_aniso);
             });
           }
-        }
-      } // end loop over k
+        } // end loop over k
+      }
     });
   }
 
+  // fluxes of scalars from the mass flux, over all faces once ghost zones are received
+  if (use_scalar_fluxes && region != FluxRegion::interior) {
+    if (scalar_plm) {
+      ScalarFluxes<true>(pmy_pack, nmhd, nscalars, use_fofc, w0, uflx);
+    } else {
+      ScalarFluxes<false>(pmy_pack, nmhd, nscalars, use_fofc, w0, uflx);
+    }
+  }
   return;
 }
 
-// function definitions for each template parameter
-template void MHD::CalculateFluxes<MHD_RSolver::advect>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::llf>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::hlle>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::hlld>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::llf_sr>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::hlle_sr>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::llf_gr>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::hlle_gr>(Driver *pdriver, int stage);
+//----------------------------------------------------------------------------------------
+//! \fn FluxFunction FluxFunctionForRecon
+//! \brief Returns the instantiation of CalculateFluxes() for Riemann solver T, scratch
+//! type TF and the input reconstruction method.  Taking the address also instantiates
+//! the template.
+
+template <MHD_RSolver T, typename TF>
+MHD::FluxFunction FluxFunctionForRecon(ReconstructionMethod recon) {
+  if (recon == ReconstructionMethod::dc) {
+    return &MHD::CalculateFluxes<T, ReconstructionMethod::dc, TF>;
+  } else if (recon == ReconstructionMethod::plm) {
+    return &MHD::CalculateFluxes<T, ReconstructionMethod::plm, TF>;
+  } else if (recon == ReconstructionMethod::ppm4) {
+    return &MHD::CalculateFluxes<T, ReconstructionMethod::ppm4, TF>;
+  } else if (recon == ReconstructionMethod::ppmx) {
+    return &MHD::CalculateFluxes<T, ReconstructionMethod::ppmx, TF>;
+  } else if (recon == ReconstructionMethod::wenoz) {
+    return &MHD::CalculateFluxes<T, ReconstructionMethod::wenoz, TF>;
+  }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MHD::SelectFluxFunction
+//! \brief Selects specialisation of CalculateFluxes() for the (Riemann solver,
+//! reconstruction method) pair of this run.  Called once in the constructor, so that no
+//! branches on either remain when fluxes are computed.
+
+void MHD::SelectFluxFunction() {
+  if (rsolver_method == MHD_RSolver::advect) {
+    calc_fluxes_ = FluxFunctionForRecon<MHD_RSolver::advect, Real>(recon_method);
+  } else if (rsolver_method == MHD_RSolver::llf) {
+    calc_fluxes_ = FluxFunctionForRecon<MHD_RSolver::llf, Real>(recon_method);
+  } else if (rsolver_method == MHD_RSolver::hlle) {
+    if (mixed_precision) {
+      calc_fluxes_ = FluxFunctionForRecon<MHD_RSolver::hlle, float>(recon_method);
+    } else {
+      calc_fluxes_ = FluxFunctionForRecon<MHD_RSolver::hlle, Real>(recon_method);
+    }
+  } else if (rsolver_method == MHD_RSolver::hlld) {
+    if (mixed_precision) {
+      calc_fluxes_ = FluxFunctionForRecon<MHD_RSolver::hlld, float>(recon_method);
+    } else {
+      calc_fluxes_ = FluxFunctionForRecon<MHD_RSolver::hlld, Real>(recon_method);
+    }
+  } else if (rsolver_method == MHD_RSolver::llf_sr) {
+    calc_fluxes_ = FluxFunctionForRecon<MHD_RSolver::llf_sr, Real>(recon_method);
+  } else if (rsolver_method == MHD_RSolver::hlle_sr) {
+    calc_fluxes_ = FluxFunctionForRecon<MHD_RSolver::hlle_sr, Real>(recon_method);
+  } else if (rsolver_method == MHD_RSolver::llf_gr) {
+    calc_fluxes_ = FluxFunctionForRecon<MHD_RSolver::llf_gr, Real>(recon_method);
+  } else if (rsolver_method == MHD_RSolver::hlle_gr) {
+    calc_fluxes_ = FluxFunctionForRecon<MHD_RSolver::hlle_gr, Real>(recon_method);
+  }
+  return;
+}
 
 } // namespace mhd
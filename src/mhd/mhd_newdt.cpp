@@ -51,7 +51,13 @@ TaskStatus MHD::NewTimeStep(Driver *pdriver, int stage) {
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
 
-  if (pdriver->time_evolution == TimeEvolution::kinematic) {
+  if (use_c2p_dt && dt_c2p_ready_) {
+    // use timestep reduced by the c2p kernel in the last stage
+    dt1 = dt_c2p_[0];
+    dt2 = dt_c2p_[1];
+    dt3 = dt_c2p_[2];
+    dt_c2p_ready_ = false;
+  } else if (pdriver->time_evolution == TimeEvolution::kinematic) {
     // find smallest (dx/v) in each direction for advection problems
     Kokkos::parallel_reduce("MHDNudt1",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
     KOKKOS_LAMBDA(const int &idx, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
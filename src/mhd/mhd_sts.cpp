@@ -0,0 +1,286 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file mhd_sts.cpp
+//! \brief Operator-split super-time-stepping (STS) of viscosity, resistivity and thermal
+//! conduction in MHD, using the RKL1/RKL2 integrators implemented in
+//! Driver::ExecuteSTS().  Each STS stage computes only diffusive fluxes and the resistive
+//! electric field, updates U and B with the weights of the stage, and communicates
+//! boundary values.  See also hydro_sts.cpp.
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "eos/eos.hpp"
+#include "diffusion/viscosity.hpp"
+#include "diffusion/resistivity.hpp"
+#include "diffusion/conduction.hpp"
+#include "mhd/mhd.hpp"
+
+namespace mhd {
+//----------------------------------------------------------------------------------------
+//! \fn  void MHD::AssembleSTSTasks
+//! \brief Adds mhd tasks to the "before_sts", "sts" and "after_sts" task lists executed
+//! for each STS stage.  Called by MeshBlockPack::AddPhysics() when use_sts=true.  Fields
+//! are exchanged every stage (even without resistivity) since receives for B and E are
+//! always posted by InitRecv().
+
+void MHD::AssembleSTSTasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
+  TaskID none(0);
+
+  // assemble "before_sts" task list
+  tl["before_sts"]->AddTask(&MHD::InitRecv, this, none, "MHD_InitRecv");
+
+  // assemble "sts" task list
+  auto flux  = tl["sts"]->AddTask(&MHD::STSFluxes, this, none, "MHD_STSFluxes");
+  auto sendf = tl["sts"]->AddTask(&MHD::SendFlux, this, flux, "MHD_SendFlux");
+  auto recvf = tl["sts"]->AddTask(&MHD::RecvFlux, this, sendf, "MHD_RecvFlux");
+  auto updt  = tl["sts"]->AddTask(&MHD::STSUpdate, this, recvf, "MHD_STSUpdate");
+  auto restu = tl["sts"]->AddTask(&MHD::RestrictU, this, updt, "MHD_RestrictU");
+  auto sendu = tl["sts"]->AddTask(&MHD::SendU, this, restu, "MHD_SendU");
+  auto recvu = tl["sts"]->AddTask(&MHD::RecvU, this, sendu, "MHD_RecvU");
+  auto sende = tl["sts"]->AddTask(&MHD::SendE, this, recvu, "MHD_SendE");
+  auto recve = tl["sts"]->AddTask(&MHD::RecvE, this, sende, "MHD_RecvE");
+  auto ct    = tl["sts"]->AddTask(&MHD::STSCT, this, recve, "MHD_STSCT");
+  auto restb = tl["sts"]->AddTask(&MHD::RestrictB, this, ct, "MHD_RestrictB");
+  auto sendb = tl["sts"]->AddTask(&MHD::SendB, this, restb, "MHD_SendB");
+  auto recvb = tl["sts"]->AddTask(&MHD::RecvB, this, sendb, "MHD_RecvB");
+  auto bcs   = tl["sts"]->AddTask(&MHD::ApplyPhysicalBCs, this, recvb,
+                                  "MHD_ApplyPhysicalBCs");
+  auto prol  = tl["sts"]->AddTask(&MHD::Prolongate, this, bcs, "MHD_Prolongate");
+  tl["sts"]->AddTask(&MHD::ConToPrim, this, prol, "MHD_ConToPrim");
+
+  // assemble "after_sts" task list
+  auto csend = tl["after_sts"]->AddTask(&MHD::ClearSend, this, none, "MHD_ClearSend");
+  tl["after_sts"]->AddTask(&MHD::ClearRecv, this, csend, "MHD_ClearRecv");
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::STSFluxes
+//! \brief Wrapper task list function that computes only the diffusive (viscous, resistive
+//! and heat) fluxes of conserved variables, and the resistive electric field, from the
+//! variables of the previous STS stage
+
+TaskStatus MHD::STSFluxes(Driver *pdrive, int stage) {
+  Kokkos::deep_copy(DevExeSpace(), uflx.x1f, 0.0);
+  if (pmy_pack->pmesh->multi_d) {Kokkos::deep_copy(DevExeSpace(), uflx.x2f, 0.0);}
+  if (pmy_pack->pmesh->three_d) {Kokkos::deep_copy(DevExeSpace(), uflx.x3f, 0.0);}
+  Kokkos::deep_copy(DevExeSpace(), efld.x1e, 0.0);
+  Kokkos::deep_copy(DevExeSpace(), efld.x2e, 0.0);
+  Kokkos::deep_copy(DevExeSpace(), efld.x3e, 0.0);
+
+  if (pvisc != nullptr) {
+    pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
+  }
+  if (presist != nullptr) {
+    if (peos->eos_data.is_ideal) {
+      presist->OhmicEnergyFlux(b0, uflx);
+    }
+    if (presist->eta_ohm > 0.0) {
+      presist->OhmicEField(b0, efld);
+    }
+  }
+  if (pcond != nullptr) {
+    pcond->AddHeatFlux(w0, peos->eos_data, uflx);
+    pcond->AddAnisoHeatFlux(w0, bcc0, b0, peos->eos_data, uflx);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::STSUpdate
+//! \brief Update of conserved variables in each stage of the RKL1/RKL2 integrators (see
+//! Driver::ExecuteSTS()).  On entry u0 holds U^{j-1} and u1 holds U^{j-2}; on exit u0
+//! holds U^{j} and u1 holds U^{j-1}.  Passive scalars do not diffuse and are unchanged.
+
+TaskStatus MHD::STSUpdate(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  // save U^{0} in first stage
+  if (stage == 1) {
+    Kokkos::deep_copy(DevExeSpace(), u_sts0, Kokkos::subview(u0, Kokkos::ALL,
+                      std::make_pair(0, nmhd), Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
+  }
+
+  Real mu = pdrive->sts_mu;
+  Real nu = pdrive->sts_nu;
+  Real mu_tilde_dt = (pdrive->sts_mu_tilde)*(pdrive->sts_dt);
+  Real gam_tilde = pdrive->sts_gam_tilde;
+  bool rkl2 = (pdrive->sts_integrator == "rkl2");
+  bool first_stage = (stage == 1);
+  Real dt = pdrive->sts_dt;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nvar = nmhd;
+  auto u0_ = u0;
+  auto u1_ = u1;
+  auto us0 = u_sts0;
+  auto dus0 = du_sts0;
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+
+  int scr_level = 0;
+  size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1);
+
+  par_for_outer("m_sts_update",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nvar-1,ks,ke,
+                js,je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k, const int j) {
+    ScrArray1D<Real> divf(member.team_scratch(scr_level), ncells1);
+
+    par_for_inner(member, is, ie, [&](const int i) {
+      divf(i) = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
+    });
+    member.team_barrier();
+
+    // Fluxes must be summed in pairs to symmetrize round-off error in each dir
+    if (multi_d) {
+      par_for_inner(member, is, ie, [&](const int i) {
+        divf(i) += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
+      });
+      member.team_barrier();
+    }
+    if (three_d) {
+      par_for_inner(member, is, ie, [&](const int i) {
+        divf(i) += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
+      });
+      member.team_barrier();
+    }
+
+    par_for_inner(member, is, ie, [&](const int i) {
+      // dt*L(U^{0}) is saved in first stage for use in later stages with RKL2
+      Real dul0 = 0.0;
+      if (rkl2) {
+        if (first_stage) {dus0(m,n,k,j,i) = -dt*divf(i);}
+        dul0 = dus0(m,n,k,j,i);
+      }
+      Real uold = u0_(m,n,k,j,i);
+      u0_(m,n,k,j,i) = mu*uold + nu*u1_(m,n,k,j,i) + (1.0 - mu - nu)*us0(m,n,k,j,i)
+                     - mu_tilde_dt*divf(i) + gam_tilde*dul0;
+      u1_(m,n,k,j,i) = uold;
+    });
+  });
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::STSCT
+//! \brief Constrained Transport update of face-centered fields in each stage of the
+//! RKL1/RKL2 integrators, with L(B) = -Curl(E) computed from the resistive electric
+//! field.  Registers b0/b1 are used as u0/u1 in STSUpdate().
+
+TaskStatus MHD::STSCT(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+
+  // save B^{0} in first stage
+  if (stage == 1) {
+    Kokkos::deep_copy(DevExeSpace(), b_sts0.x1f, b0.x1f);
+    Kokkos::deep_copy(DevExeSpace(), b_sts0.x2f, b0.x2f);
+    Kokkos::deep_copy(DevExeSpace(), b_sts0.x3f, b0.x3f);
+  }
+
+  // capture class variables for the kernels
+  Real mu = pdrive->sts_mu;
+  Real nu = pdrive->sts_nu;
+  Real mu_tilde_dt = (pdrive->sts_mu_tilde)*(pdrive->sts_dt);
+  Real gam_tilde = pdrive->sts_gam_tilde;
+  bool rkl2 = (pdrive->sts_integrator == "rkl2");
+  bool first_stage = (stage == 1);
+  Real dt = pdrive->sts_dt;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto e1 = efld.x1e;
+  auto e2 = efld.x2e;
+  auto e3 = efld.x3e;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+
+  //---- update B1 (only for 2D/3D problems)
+  if (multi_d) {
+    auto bx1f = b0.x1f;
+    auto bx1f_old = b1.x1f;
+    auto bx1f_0 = b_sts0.x1f;
+    auto dbx1f_0 = db_sts0.x1f;
+    par_for("STS_CT-b1", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie+1,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      Real dbdt = -(e3(m,k,j+1,i) - e3(m,k,j,i))/mbsize.d_view(m).dx2;
+      if (three_d) {
+        dbdt += (e2(m,k+1,j,i) - e2(m,k,j,i))/mbsize.d_view(m).dx3;
+      }
+      Real dbl0 = 0.0;
+      if (rkl2) {
+        if (first_stage) {dbx1f_0(m,k,j,i) = dt*dbdt;}
+        dbl0 = dbx1f_0(m,k,j,i);
+      }
+      Real bold = bx1f(m,k,j,i);
+      bx1f(m,k,j,i) = mu*bold + nu*bx1f_old(m,k,j,i) + (1.0 - mu - nu)*bx1f_0(m,k,j,i)
+                    + mu_tilde_dt*dbdt + gam_tilde*dbl0;
+      bx1f_old(m,k,j,i) = bold;
+    });
+  }
+
+  //---- update B2 (curl terms in 1D and 3D problems)
+  auto bx2f = b0.x2f;
+  auto bx2f_old = b1.x2f;
+  auto bx2f_0 = b_sts0.x2f;
+  auto dbx2f_0 = db_sts0.x2f;
+  par_for("STS_CT-b2", DevExeSpace(), 0, nmb1, ks, ke, js, je+1, is, ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real dbdt = (e3(m,k,j,i+1) - e3(m,k,j,i))/mbsize.d_view(m).dx1;
+    if (three_d) {
+      dbdt -= (e1(m,k+1,j,i) - e1(m,k,j,i))/mbsize.d_view(m).dx3;
+    }
+    Real dbl0 = 0.0;
+    if (rkl2) {
+      if (first_stage) {dbx2f_0(m,k,j,i) = dt*dbdt;}
+      dbl0 = dbx2f_0(m,k,j,i);
+    }
+    Real bold = bx2f(m,k,j,i);
+    bx2f(m,k,j,i) = mu*bold + nu*bx2f_old(m,k,j,i) + (1.0 - mu - nu)*bx2f_0(m,k,j,i)
+                  + mu_tilde_dt*dbdt + gam_tilde*dbl0;
+    bx2f_old(m,k,j,i) = bold;
+  });
+
+  //---- update B3 (curl terms in 1D and 2D/3D problems)
+  auto bx3f = b0.x3f;
+  auto bx3f_old = b1.x3f;
+  auto bx3f_0 = b_sts0.x3f;
+  auto dbx3f_0 = db_sts0.x3f;
+  par_for("STS_CT-b3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je, is, ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real dbdt = -(e2(m,k,j,i+1) - e2(m,k,j,i))/mbsize.d_view(m).dx1;
+    if (multi_d) {
+      dbdt += (e1(m,k,j+1,i) - e1(m,k,j,i))/mbsize.d_view(m).dx2;
+    }
+    Real dbl0 = 0.0;
+    if (rkl2) {
+      if (first_stage) {dbx3f_0(m,k,j,i) = dt*dbdt;}
+      dbl0 = dbx3f_0(m,k,j,i);
+    }
+    Real bold = bx3f(m,k,j,i);
+    bx3f(m,k,j,i) = mu*bold + nu*bx3f_old(m,k,j,i) + (1.0 - mu - nu)*bx3f_0(m,k,j,i)
+                  + mu_tilde_dt*dbdt + gam_tilde*dbl0;
+    bx3f_old(m,k,j,i) = bold;
+  });
+
+  return TaskStatus::complete;
+}
+} // namespace mhd
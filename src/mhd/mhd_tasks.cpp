@@ -24,6 +24,7 @@
 #include "srcterms/srcterms.hpp"
 #include "bvals/bvals.hpp"
 #include "shearing_box/shearing_box.hpp"
+#include "gravity/gravity.hpp"
 #include "mhd/mhd.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
 
@@ -38,47 +39,69 @@ void MHD::AssembleMHDTasks(std::map<std::string, std::shared_ptr<TaskList>> tl)
   TaskID none(0);
 
   // assemble "before_timeintegrator" task list
-  id.savest = tl["before_timeintegrator"]->AddTask(&MHD::SaveMHDState, this, none);
+  id.savest = tl["before_timeintegrator"]->AddTask(&MHD::SaveMHDState, this, none,
+                                                   "MHD_SaveMHDState");
 
   // assemble "before_stagen" task list
-  id.irecv = tl["before_stagen"]->AddTask(&MHD::InitRecv, this, none);
+  id.irecv = tl["before_stagen"]->AddTask(&MHD::InitRecv, this, none, "MHD_InitRecv");
 
   // assemble "stagen" task list
-  id.copyu     = tl["stagen"]->AddTask(&MHD::CopyCons, this, none);
-  id.flux      = tl["stagen"]->AddTask(&MHD::Fluxes, this, id.copyu);
-  id.sendf     = tl["stagen"]->AddTask(&MHD::SendFlux, this, id.flux);
-  id.recvf     = tl["stagen"]->AddTask(&MHD::RecvFlux, this, id.sendf);
-  id.rkupdt    = tl["stagen"]->AddTask(&MHD::RKUpdate, this, id.recvf);
-  id.srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, this, id.rkupdt);
-  id.sendu_oa  = tl["stagen"]->AddTask(&MHD::SendU_OA, this, id.srctrms);
-  id.recvu_oa  = tl["stagen"]->AddTask(&MHD::RecvU_OA, this, id.sendu_oa);
-  id.restu     = tl["stagen"]->AddTask(&MHD::RestrictU, this, id.recvu_oa);
-  id.sendu     = tl["stagen"]->AddTask(&MHD::SendU, this, id.restu);
-  id.recvu     = tl["stagen"]->AddTask(&MHD::RecvU, this, id.sendu);
-  id.sendu_shr = tl["stagen"]->AddTask(&MHD::SendU_Shr, this, id.recvu);
-  id.recvu_shr = tl["stagen"]->AddTask(&MHD::RecvU_Shr, this, id.sendu_shr);
-  id.efld      = tl["stagen"]->AddTask(&MHD::CornerE, this, id.recvu_shr);
-  id.efldsrc   = tl["stagen"]->AddTask(&MHD::EFieldSrc, this, id.efld);
-  id.sende     = tl["stagen"]->AddTask(&MHD::SendE, this, id.efldsrc);
-  id.recve     = tl["stagen"]->AddTask(&MHD::RecvE, this, id.sende);
-  id.ct        = tl["stagen"]->AddTask(&MHD::CT, this, id.recve);
-  id.sendb_oa  = tl["stagen"]->AddTask(&MHD::SendB_OA, this, id.ct);
-  id.recvb_oa  = tl["stagen"]->AddTask(&MHD::RecvB_OA, this, id.sendb_oa);
-  id.restb     = tl["stagen"]->AddTask(&MHD::RestrictB, this, id.recvb_oa);
-  id.sendb     = tl["stagen"]->AddTask(&MHD::SendB, this, id.restb);
-  id.recvb     = tl["stagen"]->AddTask(&MHD::RecvB, this, id.sendb);
-  id.sendb_shr = tl["stagen"]->AddTask(&MHD::SendB_Shr, this, id.recvb);
-  id.recvb_shr = tl["stagen"]->AddTask(&MHD::RecvB_Shr, this, id.sendb_shr);
-  id.bcs       = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, this, id.recvb_shr);
-  id.prol      = tl["stagen"]->AddTask(&MHD::Prolongate, this, id.bcs);
-  id.c2p       = tl["stagen"]->AddTask(&MHD::ConToPrim, this, id.prol);
-  id.newdt     = tl["stagen"]->AddTask(&MHD::NewTimeStep, this, id.c2p);
+  id.copyu     = tl["stagen"]->AddTask(&MHD::CopyCons, this, none, "MHD_CopyCons");
+  id.flux      = tl["stagen"]->AddTask(&MHD::Fluxes, this, id.copyu, "MHD_Fluxes");
+  id.sendf     = tl["stagen"]->AddTask(&MHD::SendFlux, this, id.flux, "MHD_SendFlux");
+  id.recvf     = tl["stagen"]->AddTask(&MHD::RecvFlux, this, id.sendf, "MHD_RecvFlux");
+  id.rkupdt    = tl["stagen"]->AddTask(&MHD::RKUpdate, this, id.recvf, "MHD_RKUpdate");
+  id.srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, this, id.rkupdt,
+                                       "MHD_MHDSrcTerms");
+  id.sendu_oa  = tl["stagen"]->AddTask(&MHD::SendU_OA, this, id.srctrms, "MHD_SendU_OA");
+  id.recvu_oa  = tl["stagen"]->AddTask(&MHD::RecvU_OA, this, id.sendu_oa, "MHD_RecvU_OA");
+  id.restu     = tl["stagen"]->AddTask(&MHD::RestrictU, this, id.recvu_oa,
+                                       "MHD_RestrictU");
+  id.sendu     = tl["stagen"]->AddTask(&MHD::SendU, this, id.restu, "MHD_SendU");
+  id.recvu     = tl["stagen"]->AddTask(&MHD::RecvU, this, id.sendu, "MHD_RecvU");
+  id.sendu_shr = tl["stagen"]->AddTask(&MHD::SendU_Shr, this, id.recvu, "MHD_SendU_Shr");
+  id.recvu_shr = tl["stagen"]->AddTask(&MHD::RecvU_Shr, this, id.sendu_shr,
+                                       "MHD_RecvU_Shr");
+  id.efld      = tl["stagen"]->AddTask(&MHD::CornerE, this, id.recvu_shr, "MHD_CornerE");
+  id.efldsrc   = tl["stagen"]->AddTask(&MHD::EFieldSrc, this, id.efld, "MHD_EFieldSrc");
+  id.sende     = tl["stagen"]->AddTask(&MHD::SendE, this, id.efldsrc, "MHD_SendE");
+  id.recve     = tl["stagen"]->AddTask(&MHD::RecvE, this, id.sende, "MHD_RecvE");
+  id.ct        = tl["stagen"]->AddTask(&MHD::CT, this, id.recve, "MHD_CT");
+  id.sendb_oa  = tl["stagen"]->AddTask(&MHD::SendB_OA, this, id.ct, "MHD_SendB_OA");
+  id.recvb_oa  = tl["stagen"]->AddTask(&MHD::RecvB_OA, this, id.sendb_oa, "MHD_RecvB_OA");
+  id.restb     = tl["stagen"]->AddTask(&MHD::RestrictB, this, id.recvb_oa,
+                                       "MHD_RestrictB");
+  id.sendb     = tl["stagen"]->AddTask(&MHD::SendB, this, id.restb, "MHD_SendB");
+  if (use_split_fluxes) {
+    id.iflux   = tl["stagen"]->AddTask(&MHD::InteriorFluxes, this, id.sendb,
+                                       "MHD_InteriorFluxes");
+  }
+  id.recvb     = tl["stagen"]->AddTask(&MHD::RecvB, this, id.sendb, "MHD_RecvB");
+  id.sendb_shr = tl["stagen"]->AddTask(&MHD::SendB_Shr, this, id.recvb, "MHD_SendB_Shr");
+  id.recvb_shr = tl["stagen"]->AddTask(&MHD::RecvB_Shr, this, id.sendb_shr,
+                                       "MHD_RecvB_Shr");
+  id.bcs       = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, this, id.recvb_shr,
+                                       "MHD_ApplyPhysicalBCs");
+  id.prol      = tl["stagen"]->AddTask(&MHD::Prolongate, this, id.bcs, "MHD_Prolongate");
+  if (use_split_fluxes) {
+    TaskID dep = id.prol | id.iflux;
+    id.c2p     = tl["stagen"]->AddTask(&MHD::ConToPrim, this, dep, "MHD_ConToPrim");
+  } else {
+    id.c2p     = tl["stagen"]->AddTask(&MHD::ConToPrim, this, id.prol, "MHD_ConToPrim");
+  }
+  id.newdt     = tl["stagen"]->AddTask(&MHD::NewTimeStep, this, id.c2p,
+                                       "MHD_NewTimeStep");
+  if (use_split_fluxes) {
+    id.bflux   = tl["stagen"]->AddTask(&MHD::BoundaryFluxes, this, id.c2p,
+                                       "MHD_BoundaryFluxes");
+  }
 
   // assemble "after_stagen" task list
-  id.csend = tl["after_stagen"]->AddTask(&MHD::ClearSend, this, none);
+  id.csend = tl["after_stagen"]->AddTask(&MHD::ClearSend, this, none, "MHD_ClearSend");
   // although RecvFlux/U/E/B functions check that all recvs complete, add ClearRecv to
   // task list anyways to catch potential bugs in MPI communication logic
-  id.crecv = tl["after_stagen"]->AddTask(&MHD::ClearRecv, this, id.csend);
+  id.crecv = tl["after_stagen"]->AddTask(&MHD::ClearRecv, this, id.csend,
+                                         "MHD_ClearRecv");
 
   return;
 }
@@ -104,9 +127,12 @@ TaskStatus MHD::SaveMHDState(Driver *pdrive, int stage) {
 //! face-centered fields AND their fluxes (with SMR/AMR).
 
 TaskStatus MHD::InitRecv(Driver *pdrive, int stage) {
-  // post receives for U
-  TaskStatus tstat = pbval_u->InitRecv(nmhd+nscalars);
-  if (tstat != TaskStatus::complete) return tstat;
+  // post receives for U (unless exchanged with B)
+  TaskStatus tstat = TaskStatus::complete;
+  if (!(combined_ub)) {
+    tstat = pbval_u->InitRecv(nmhd+nscalars);
+    if (tstat != TaskStatus::complete) return tstat;
+  }
   // post receives for B
   tstat = pbval_b->InitRecv(3);
   if (tstat != TaskStatus::complete) return tstat;
@@ -172,34 +198,26 @@ TaskStatus MHD::CopyCons(Driver *pdrive, int stage) {
 //! of conserved variables
 
 TaskStatus MHD::Fluxes(Driver *pdrive, int stage) {
-  // select which calculate_flux function to call based on rsolver_method
-  if (rsolver_method == MHD_RSolver::advect) {
-    CalculateFluxes<MHD_RSolver::advect>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::llf) {
-    CalculateFluxes<MHD_RSolver::llf>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::hlle) {
-    CalculateFluxes<MHD_RSolver::hlle>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::hlld) {
-    CalculateFluxes<MHD_RSolver::hlld>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::llf_sr) {
-    CalculateFluxes<MHD_RSolver::llf_sr>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::hlle_sr) {
-    CalculateFluxes<MHD_RSolver::hlle_sr>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::llf_gr) {
-    CalculateFluxes<MHD_RSolver::llf_gr>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::hlle_gr) {
-    CalculateFluxes<MHD_RSolver::hlle_gr>(pdrive, stage);
-  }
-
-  // Add viscous, resistive, heat-flux, etc fluxes
-  if (pvisc != nullptr) {
+  // with split fluxes, fluxes for this stage were computed at end of previous stage
+  if (fluxes_done_) {
+    fluxes_done_ = false;
+    return TaskStatus::complete;
+  }
+
+  CalculateFluxesInRegion(pdrive, stage, FluxRegion::all);
+
+  // Add viscous, resistive, heat-flux, etc fluxes (unless integrated with STS)
+  if ((pvisc != nullptr) && !(use_sts)) {
     pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
   }
-  if ((presist != nullptr) && (peos->eos_data.is_ideal)) {
+  if ((presist != nullptr) && (peos->eos_data.is_ideal) && !(use_sts)) {
     presist->OhmicEnergyFlux(b0, uflx);
   }
-  if (pcond != nullptr) {
+  if ((pcond != nullptr) && !(use_sts)) {
     pcond->AddHeatFlux(w0, peos->eos_data, uflx);
+    if (!(use_fused_aniso_cond)) {
+      pcond->AddAnisoHeatFlux(w0, bcc0, b0, peos->eos_data, uflx);
+    }
   }
 
   // call FOFC if necessary
@@ -214,6 +232,16 @@ TaskStatus MHD::Fluxes(Driver *pdrive, int stage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MHD::CalculateFluxesInRegion
+//! \brief Calls the CalculateFluxes function selected by SelectFluxFunction() for the
+//! Riemann solver and reconstruction method of this run
+
+void MHD::CalculateFluxesInRegion(Driver *pdrive, int stage, FluxRegion region) {
+  (this->*calc_fluxes_)(pdrive, stage, region);
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus MHD::SendFlux
 //! \brief Wrapper task list function to pack/send restricted values of fluxes of
@@ -256,6 +284,9 @@ TaskStatus MHD::MHDSrcTerms(Driver *pdrive, int stage) {
   if (psrc->ism_cooling)  psrc->ISMCooling(w0, peos->eos_data, beta_dt, u0);
   if (psrc->rel_cooling)  psrc->RelCooling(w0, peos->eos_data, beta_dt, u0);
   if (psrc->shearing_box) psrc->ShearingBox(w0, bcc0, peos->eos_data, beta_dt, u0);
+  if (pmy_pack->pgrav != nullptr) {
+    pmy_pack->pgrav->AddSrcTerms(w0, beta_dt, peos->eos_data.is_ideal, u0);
+  }
 
   // Add coordinate source terms in GR.  Again, must be computed with only primitives.
   if (pmy_pack->pcoord->is_general_relativistic &&
@@ -266,8 +297,14 @@ TaskStatus MHD::MHDSrcTerms(Driver *pdrive, int stage) {
   }
 
   // Add user source terms
-  if (pmy_pack->pmesh->pgen->user_srcs) {
-    (pmy_pack->pmesh->pgen->user_srcs_func)(pmy_pack->pmesh, beta_dt);
+  auto &pgen = pmy_pack->pmesh->pgen;
+  if (pgen->user_srcs) {
+    if (pgen->user_srcs_kernel) {
+      pgen->user_srcs_kernel(pmy_pack, w0, bcc0, beta_dt, u0);
+    }
+    if (pgen->user_srcs_func != nullptr) {
+      (pgen->user_srcs_func)(pmy_pack->pmesh, beta_dt);
+    }
   }
 
   return TaskStatus::complete;
@@ -316,9 +353,11 @@ TaskStatus MHD::RestrictU(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus MHD::SendU
-//! \brief Wrapper task list function to pack/send cell-centered conserved variables
+//! \brief Wrapper task list function to pack/send cell-centered conserved variables.
+//! With combined_ub, U is sent together with B in SendB() instead.
 
 TaskStatus MHD::SendU(Driver *pdrive, int stage) {
+  if (combined_ub) {return TaskStatus::complete;}
   TaskStatus tstat = pbval_u->PackAndSendCC(u0, coarse_u0);
   return tstat;
 }
@@ -328,6 +367,7 @@ TaskStatus MHD::SendU(Driver *pdrive, int stage) {
 //! \brief Wrapper task list function to receive/unpack cell-centered conserved variables
 
 TaskStatus MHD::RecvU(Driver *pdrive, int stage) {
+  if (combined_ub) {return TaskStatus::complete;}
   TaskStatus tstat = pbval_u->RecvAndUnpackCC(u0, coarse_u0);
   return tstat;
 }
@@ -426,18 +466,40 @@ TaskStatus MHD::RecvB_OA(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus MHD::SendB
-//! \brief Wrapper task list function to pack/send face-centered magnetic fields
+//! \brief Wrapper task list function to pack/send face-centered magnetic fields, and with
+//! combined_ub also the cell-centered conserved variables, in a single kernel
 
 TaskStatus MHD::SendB(Driver *pdrive, int stage) {
+  if (combined_ub) {return pbval_b->PackAndSendUB(u0, coarse_u0, b0, coarse_b0);}
   TaskStatus tstat = pbval_b->PackAndSendFC(b0, coarse_b0);
   return tstat;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::InteriorFluxes
+//! \brief Wrapper task list function used with split fluxes.  Computes primitives and
+//! cell-centered fields in the active zone, and fluxes for the next stage on faces that
+//! do not depend on ghost zones, while boundary values of B are being communicated.
+//! Nothing is done in the last stage, since the fluxes at the start of the next cycle are
+//! computed in Fluxes() after any operator-split updates and mesh refinement.
+
+TaskStatus MHD::InteriorFluxes(Driver *pdrive, int stage) {
+  if (stage == pdrive->nexp_stages) {return TaskStatus::complete;}
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  peos->ConsToPrim(u0, b0, w0, bcc0, false, indcs.is, indcs.ie, indcs.js, indcs.je,
+                   indcs.ks, indcs.ke);
+  interior_c2p_done_ = true;
+  CalculateFluxesInRegion(pdrive, stage, FluxRegion::interior);
+  return TaskStatus::complete;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus MHD::RecvB
-//! \brief Wrapper task list function to recv/unpack face-centered magnetic fields
+//! \brief Wrapper task list function to recv/unpack face-centered magnetic fields (and
+//! with combined_ub also the cell-centered conserved variables)
 
 TaskStatus MHD::RecvB(Driver *pdrive, int stage) {
+  if (combined_ub) {return pbval_b->RecvAndUnpackUB(u0, coarse_u0, b0, coarse_b0);}
   TaskStatus tstat = pbval_b->RecvAndUnpackFC(b0, coarse_b0);
   return tstat;
 }
@@ -513,15 +575,63 @@ TaskStatus MHD::Prolongate(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus MHD::ConToPrim
-//! \brief Wrapper task list function to call ConsToPrim over entire mesh (including gz)
+//! \brief Wrapper task list function to call ConsToPrim over active zone and c2p_ng
+//! layers of ghost zones
 
 TaskStatus MHD::ConToPrim(Driver *pdrive, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
-  int &ng = indcs.ng;
-  int n1m1 = indcs.nx1 + 2*ng - 1;
-  int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
-  int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
-  peos->ConsToPrim(u0, b0, w0, bcc0, false, 0, n1m1, 0, n2m1, 0, n3m1);
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  // convert only c2p_ng ghost layers (all ng layers by default)
+  int il = is - c2p_ng, iu = ie + c2p_ng;
+  int jl = js, ju = je, kl = ks, ku = ke;
+  if (indcs.nx2 > 1) {jl -= c2p_ng; ju += c2p_ng;}
+  if (indcs.nx3 > 1) {kl -= c2p_ng; ku += c2p_ng;}
+  if (interior_c2p_done_) {
+    // active zone already converted in InteriorFluxes(), so only convert ghost zones
+    if (pmy_pack->pmesh->three_d) {
+      peos->ConsToPrim(u0, b0, w0, bcc0, false, il, iu, jl, ju, kl, ks-1);
+      peos->ConsToPrim(u0, b0, w0, bcc0, false, il, iu, jl, ju, ke+1, ku);
+    }
+    if (pmy_pack->pmesh->multi_d) {
+      peos->ConsToPrim(u0, b0, w0, bcc0, false, il, iu, jl, js-1, ks, ke);
+      peos->ConsToPrim(u0, b0, w0, bcc0, false, il, iu, je+1, ju, ks, ke);
+    }
+    peos->ConsToPrim(u0, b0, w0, bcc0, false, il, is-1, js, je, ks, ke);
+    peos->ConsToPrim(u0, b0, w0, bcc0, false, ie+1, iu, js, je, ks, ke);
+    interior_c2p_done_ = false;
+  } else if (use_c2p_dt && (stage == pdrive->nexp_stages) &&
+             (pdrive->time_evolution == TimeEvolution::dynamic)) {
+    // timestep for next cycle computed in same kernel, and used in NewTimeStep()
+    peos->ConsToPrimNewDt(u0, b0, w0, bcc0, il, iu, jl, ju, kl, ku, dt_c2p_);
+    dt_c2p_ready_ = true;
+  } else {
+    peos->ConsToPrim(u0, b0, w0, bcc0, false, il, iu, jl, ju, kl, ku);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::BoundaryFluxes
+//! \brief Wrapper task list function used with split fluxes.  Computes fluxes for the
+//! next stage on faces that depend on ghost zones, once they have been received and
+//! converted to primitives.  Diffusive fluxes are added over all faces.
+
+TaskStatus MHD::BoundaryFluxes(Driver *pdrive, int stage) {
+  if (stage == pdrive->nexp_stages) {return TaskStatus::complete;}
+  CalculateFluxesInRegion(pdrive, stage, FluxRegion::boundary);
+  if ((pvisc != nullptr) && !(use_sts)) {
+    pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
+  }
+  if ((presist != nullptr) && (peos->eos_data.is_ideal) && !(use_sts)) {
+    presist->OhmicEnergyFlux(b0, uflx);
+  }
+  if ((pcond != nullptr) && !(use_sts)) {
+    pcond->AddHeatFlux(w0, peos->eos_data, uflx);
+    pcond->AddAnisoHeatFlux(w0, bcc0, b0, peos->eos_data, uflx);
+  }
+  fluxes_done_ = true;
   return TaskStatus::complete;
 }
 
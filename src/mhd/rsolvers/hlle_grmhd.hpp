@@ -66,29 +66,35 @@ void HLLE_GR(TeamMember_t const &member, const EOS_Data &eos,
     // reference to longitudinal field
     Real &bxi = bx(m,k,j,i);
 
-    // Extract components of metric
-    Real &x1min = size.d_view(m).x1min;
-    Real &x1max = size.d_view(m).x1max;
-    Real &x2min = size.d_view(m).x2min;
-    Real &x2max = size.d_view(m).x2max;
-    Real &x3min = size.d_view(m).x3min;
-    Real &x3max = size.d_view(m).x3max;
-    Real x1v,x2v,x3v;
-    if (ivx == IVX) {
-      x1v = LeftEdgeX  (i-is, indcs.nx1, x1min, x1max);
-      x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
-      x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
-    } else if (ivx == IVY) {
-      x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
-      x2v = LeftEdgeX  (j-js, indcs.nx2, x2min, x2max);
-      x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+    // Extract components of metric, either from the cache or computed at the face
+    Real glower[4][4], gupper[4][4];
+    if (coord.metric_cache) {
+      const auto &ks_face = (ivx == IVX)? coord.ks_x1f :
+                            ((ivx == IVY)? coord.ks_x2f : coord.ks_x3f);
+      CachedMetricAndInverse(ks_face, m, k, j, i, glower, gupper);
     } else {
-      x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
-      x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
-      x3v = LeftEdgeX  (k-ks, indcs.nx3, x3min, x3max);
+      Real &x1min = size.d_view(m).x1min;
+      Real &x1max = size.d_view(m).x1max;
+      Real &x2min = size.d_view(m).x2min;
+      Real &x2max = size.d_view(m).x2max;
+      Real &x3min = size.d_view(m).x3min;
+      Real &x3max = size.d_view(m).x3max;
+      Real x1v,x2v,x3v;
+      if (ivx == IVX) {
+        x1v = LeftEdgeX  (i-is, indcs.nx1, x1min, x1max);
+        x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+        x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+      } else if (ivx == IVY) {
+        x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+        x2v = LeftEdgeX  (j-js, indcs.nx2, x2min, x2max);
+        x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+      } else {
+        x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+        x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+        x3v = LeftEdgeX  (k-ks, indcs.nx3, x3min, x3max);
+      }
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
     }
-    Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
 
     // Calculate 4-velocity in left state (contravariant compt)
     Real q = glower[ivx][ivx] * SQR(wl_ivx) + glower[ivy][ivy] * SQR(wl_ivy) +
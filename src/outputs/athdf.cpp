@@ -0,0 +1,270 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file athdf.cpp
+//! \brief writes mesh data directly in the athdf (HDF5) format read by athena_read.py,
+//! yt and VisIt, i.e. the same files make_athdf.py creates from .bin outputs.  All ranks
+//! write their MeshBlocks to a single file with collective (parallel HDF5) I/O.  Variable
+//! data is chunked by MeshBlock, and the number and buffer size of MPI-IO aggregators
+//! can be tuned with the optional <output> parameters cb_nodes and cb_buffer_size.
+
+#include <sys/stat.h>  // mkdir
+
+#include <algorithm>
+#include <cstdio>      // snprintf()
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+#include "hdf5_utils.hpp"
+
+#if HDF5OUTPUT_ENABLED
+using hdf5_utils::WriteAttribute;
+using hdf5_utils::WriteStringAttribute;
+using hdf5_utils::WriteDataset;
+#endif
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+MeshHDF5Output::MeshHDF5Output(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+#if HDF5OUTPUT_ENABLED
+  // MPI-IO hints for collective buffering; only set if given in the input file
+  cb_nodes = 0;
+  if (pin->DoesParameterExist(op.block_name, "cb_nodes")) {
+    cb_nodes = pin->GetInteger(op.block_name, "cb_nodes");
+  }
+  cb_buffer_size = 0;
+  if (pin->DoesParameterExist(op.block_name, "cb_buffer_size")) {
+    cb_buffer_size = pin->GetInteger(op.block_name, "cb_buffer_size");
+  }
+  // create new directory for this output. Comments in binary.cpp constructor explain why
+  mkdir("athdf",0775);
+#else
+  std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+            << "file_type=hdf5 in <" << op.block_name << "> requires HDF5, so configure "
+            << "with -D Athena_ENABLE_HDF5=ON" << std::endl;
+  std::exit(EXIT_FAILURE);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshHDF5Output::WriteOutputFile(Mesh *pm)
+//  \brief Cycles over all MeshBlocks and writes output data in athdf format.  Each rank
+//  writes the hyperslab of its MeshBlocks in every dataset with one collective call.
+
+void MeshHDF5Output::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+#if HDF5OUTPUT_ENABLED
+  // create filename: "athdf/file_basename" + "." + "file_id" + "." + XXXXX + ".athdf"
+  // where XXXXX = 5-digit file_number
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+  std::string fname;
+  fname.assign("athdf/");
+  fname.append(out_params.file_basename);
+  fname.append(".");
+  fname.append(out_params.file_id);
+  fname.append(".");
+  fname.append(number);
+  fname.append(".athdf");
+
+  // number of cells output in each direction on every MeshBlock (same on all ranks)
+  auto &indcs = pm->mb_indcs;
+  int nout1 = indcs.nx1, nout2 = indcs.nx2, nout3 = indcs.nx3;
+  if (out_params.include_gzs) {
+    nout1 += 2*indcs.ng;
+    if (nout2 > 1) nout2 += 2*indcs.ng;
+    if (nout3 > 1) nout3 += 2*indcs.ng;
+  }
+  if (out_params.slice1) nout1 = 1;
+  if (out_params.slice2) nout2 = 1;
+  if (out_params.slice3) nout3 = 1;
+  int ncells = nout1*nout2*nout3;
+
+  // offset of MeshBlocks of this rank in the datasets, and total number of MeshBlocks
+  int nout_mbs = outmbs.size();
+  hsize_t moff = 0, nmb_total = 0;
+  for (int n=0; n<global_variable::nranks; ++n) {
+    if (n < global_variable::my_rank) moff += noutmbs[n];
+    nmb_total += noutmbs[n];
+  }
+
+  // separate magnetic field (labels containing "bcc") into dataset "B", as in make_athdf
+  std::vector<int> uov_vars, b_vars;
+  for (int n=0; n<static_cast<int>(outvars.size()); ++n) {
+    if (outvars[n].label.find("bcc") != std::string::npos) {
+      b_vars.push_back(n);
+    } else {
+      uov_vars.push_back(n);
+    }
+  }
+
+  // open file with MPI-IO driver, collective metadata operations and aggregation hints
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+#if MPI_PARALLEL_ENABLED
+  MPI_Info info;
+  MPI_Info_create(&info);
+  MPI_Info_set(info, "romio_cb_write", "enable");
+  if (cb_nodes > 0) {
+    MPI_Info_set(info, "cb_nodes", std::to_string(cb_nodes).c_str());
+  }
+  if (cb_buffer_size > 0) {
+    MPI_Info_set(info, "cb_buffer_size", std::to_string(cb_buffer_size).c_str());
+  }
+  H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, info);
+  H5Pset_all_coll_metadata_ops(fapl, true);
+  H5Pset_coll_metadata_write(fapl, true);
+  H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+#endif
+  hid_t file = H5Fcreate(fname.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  if (file < 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Output file '" << fname << "' could not be created"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // attributes describing the Mesh and variables
+  int max_level = 0;
+  for (int m=0; m<nout_mbs; ++m) {
+    max_level = std::max(max_level, pm->lloc_eachmb[outmbs[m].mb_gid].level);
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &max_level, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  max_level = std::max(0, max_level - pm->root_level);
+  double time = pm->time;
+  int ncycle = pm->ncycle;
+  int nmb_attr = static_cast<int>(nmb_total);
+  int mb_size[3] = {nout1, nout2, nout3};
+  int root_size[3] = {pm->mesh_indcs.nx1, pm->mesh_indcs.nx2, pm->mesh_indcs.nx3};
+  double root_x1[3] = {pm->mesh_size.x1min, pm->mesh_size.x1max, 1.0};
+  double root_x2[3] = {pm->mesh_size.x2min, pm->mesh_size.x2max, 1.0};
+  double root_x3[3] = {pm->mesh_size.x3min, pm->mesh_size.x3max, 1.0};
+  std::vector<std::string> dataset_names = {"uov"};
+  std::vector<int> dataset_nvars = {static_cast<int>(uov_vars.size())};
+  if (b_vars.size() > 0) {
+    dataset_names.push_back("B");
+    dataset_nvars.push_back(b_vars.size());
+  }
+  std::vector<std::string> var_names;
+  for (int n : uov_vars) var_names.push_back(outvars[n].label);
+  for (int n : b_vars) var_names.push_back(outvars[n].label);
+
+  WriteAttribute(file, "Time", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, 1, &time);
+  WriteAttribute(file, "NumCycles", H5T_STD_I32LE, H5T_NATIVE_INT, 1, &ncycle);
+  WriteStringAttribute(file, "Coordinates", {"cartesian"}, 11);
+  WriteAttribute(file, "NumMeshBlocks", H5T_STD_I32LE, H5T_NATIVE_INT, 1, &nmb_attr);
+  WriteAttribute(file, "MaxLevel", H5T_STD_I32LE, H5T_NATIVE_INT, 1, &max_level);
+  WriteAttribute(file, "MeshBlockSize", H5T_STD_I32LE, H5T_NATIVE_INT, 3, mb_size);
+  WriteAttribute(file, "RootGridSize", H5T_STD_I32LE, H5T_NATIVE_INT, 3, root_size);
+  WriteAttribute(file, "RootGridX1", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, 3, root_x1);
+  WriteAttribute(file, "RootGridX2", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, 3, root_x2);
+  WriteAttribute(file, "RootGridX3", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, 3, root_x3);
+  WriteStringAttribute(file, "DatasetNames", dataset_names, 21);
+  WriteAttribute(file, "NumVariables", H5T_STD_I32LE, H5T_NATIVE_INT,
+                 dataset_nvars.size(), dataset_nvars.data());
+  WriteStringAttribute(file, "VariableNames", var_names, 21);
+
+  // variable data, converted to floats in (variable, MeshBlock, k, j, i) order
+  for (int d=0; d<static_cast<int>(dataset_names.size()); ++d) {
+    std::vector<int> &vars = (d == 0)? uov_vars : b_vars;
+    int nvars = vars.size();
+    std::vector<float> data(static_cast<std::size_t>(nvars)*nout_mbs*ncells);
+    std::size_t indx = 0;
+    for (int v=0; v<nvars; ++v) {
+      for (int m=0; m<nout_mbs; ++m) {
+        for (int k=0; k<nout3; ++k) {
+          for (int j=0; j<nout2; ++j) {
+            for (int i=0; i<nout1; ++i) {
+              data[indx++] = static_cast<float>(outarray(vars[v],m,k,j,i));
+            }
+          }
+        }
+      }
+    }
+    hsize_t dims[5] = {static_cast<hsize_t>(nvars), nmb_total,
+                       static_cast<hsize_t>(nout3), static_cast<hsize_t>(nout2),
+                       static_cast<hsize_t>(nout1)};
+    WriteDataset(file, dxpl, dataset_names[d].c_str(), H5T_IEEE_F32LE, H5T_NATIVE_FLOAT,
+                 5, dims, 1, moff, nout_mbs, true, data.data());
+  }
+
+  // levels, logical locations and cell coordinates of each MeshBlock
+  std::vector<int> levels(nout_mbs);
+  std::vector<int64_t> llocs(3*nout_mbs);
+  std::vector<Real> x1f(nout_mbs*(nout1+1)), x1v(nout_mbs*nout1);
+  std::vector<Real> x2f(nout_mbs*(nout2+1)), x2v(nout_mbs*nout2);
+  std::vector<Real> x3f(nout_mbs*(nout3+1)), x3v(nout_mbs*nout3);
+  for (int m=0; m<nout_mbs; ++m) {
+    LogicalLocation &lloc = pm->lloc_eachmb[outmbs[m].mb_gid];
+    levels[m] = lloc.level - pm->root_level;
+    llocs[3*m  ] = lloc.lx1;
+    llocs[3*m+1] = lloc.lx2;
+    llocs[3*m+2] = lloc.lx3;
+    OutputMeshBlockInfo &omb = outmbs[m];
+    for (int i=0; i<=nout1; ++i) {
+      int ii = omb.ois + i - indcs.is;
+      x1f[m*(nout1+1) + i] = LeftEdgeX(ii, indcs.nx1, omb.x1min, omb.x1max);
+      if (i < nout1) x1v[m*nout1 + i] = CellCenterX(ii, indcs.nx1, omb.x1min, omb.x1max);
+    }
+    for (int j=0; j<=nout2; ++j) {
+      int jj = omb.ojs + j - indcs.js;
+      x2f[m*(nout2+1) + j] = LeftEdgeX(jj, indcs.nx2, omb.x2min, omb.x2max);
+      if (j < nout2) x2v[m*nout2 + j] = CellCenterX(jj, indcs.nx2, omb.x2min, omb.x2max);
+    }
+    for (int k=0; k<=nout3; ++k) {
+      int kk = omb.oks + k - indcs.ks;
+      x3f[m*(nout3+1) + k] = LeftEdgeX(kk, indcs.nx3, omb.x3min, omb.x3max);
+      if (k < nout3) x3v[m*nout3 + k] = CellCenterX(kk, indcs.nx3, omb.x3min, omb.x3max);
+    }
+  }
+  hid_t real_ftype = (sizeof(Real) == sizeof(double))? H5T_IEEE_F64LE : H5T_IEEE_F32LE;
+  hid_t real_mtype = (sizeof(Real) == sizeof(double))? H5T_NATIVE_DOUBLE
+                                                     : H5T_NATIVE_FLOAT;
+  hsize_t dims[2] = {nmb_total, 3};
+  WriteDataset(file, dxpl, "Levels", H5T_STD_I32BE, H5T_NATIVE_INT, 1, dims, 0, moff,
+               nout_mbs, false, levels.data());
+  WriteDataset(file, dxpl, "LogicalLocations", H5T_STD_I64BE, H5T_NATIVE_INT64, 2, dims,
+               0, moff, nout_mbs, false, llocs.data());
+  const char *coord_names[6] = {"x1f", "x1v", "x2f", "x2v", "x3f", "x3v"};
+  const Real *coord_data[6] = {x1f.data(), x1v.data(), x2f.data(), x2v.data(),
+                               x3f.data(), x3v.data()};
+  int coord_size[6] = {nout1+1, nout1, nout2+1, nout2, nout3+1, nout3};
+  for (int c=0; c<6; ++c) {
+    dims[1] = coord_size[c];
+    WriteDataset(file, dxpl, coord_names[c], real_ftype, real_mtype, 2, dims, 0, moff,
+                 nout_mbs, false, coord_data[c]);
+  }
+
+  H5Fclose(file);
+  H5Pclose(dxpl);
+  H5Pclose(fapl);
+#if MPI_PARALLEL_ENABLED
+  MPI_Info_free(&info);
+#endif
+#endif
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+
+  return;
+}
@@ -33,6 +33,8 @@
 #include <mpi.h>
 #endif
 
+double BaseTypeOutput::io_time = 0.0;
+
 //----------------------------------------------------------------------------------------
 // BaseTypeOutput base class constructor
 // Creates vector of output variable data
@@ -40,7 +42,6 @@
 BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters opar) :
     derived_var("derived-var",1,1,1,1,1),
     outarray("cc_outvar",1,1,1,1,1),
-    outfield("fc_outvar",1,1,1,1),
     out_params(opar) {
   // exit for history, restart, or event log files
   if (out_params.file_type.compare("hst") == 0 ||
@@ -86,6 +87,13 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
        << std::endl << "Input file is likely missing a <forcing> block" << std::endl;
     exit(EXIT_FAILURE);
   }
+  if ((ivar==49) && (pm->pmb_pack->pturb->modal_forcing)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+       << "Output of Force variable requested in <output> block '"
+       << out_params.block_name << "' but force is not stored with "
+       << "<turb_driving>/modal_forcing=true" << std::endl;
+    exit(EXIT_FAILURE);
+  }
   if (ivar==50 && (pm->pmb_pack->prad == nullptr)) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
        << "Output of Radiation moments requested in <output> block '"
@@ -610,12 +618,20 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
         outvars.emplace_back(Tmunu::Tmunu_names[v], v, &(pm->pmb_pack->ptmunu->u_tmunu));
       }
     }
-    // con z4c variables
+    // con z4c variables (converted to Real in derived_var if stored in float)
     for (int v = 0; v < z4c::Z4c::ncon; ++v) {
       if (variable.compare("con") == 0 ||
           variable.compare(z4c::Z4c::Constraint_names[v]) == 0) {
-        outvars.emplace_back(z4c::Z4c::Constraint_names[v], v,
-        &(pm->pmb_pack->pz4c->u_con));
+        if (pm->pmb_pack->pz4c->opt.con_float) {
+          out_params.contains_derived = true;
+          out_params.n_derived += 1;
+          int i_derived = out_params.n_derived - 1;
+          outvars.emplace_back(z4c::Z4c::Constraint_names[v], i_derived,
+                               &(derived_var));
+        } else {
+          outvars.emplace_back(z4c::Z4c::Constraint_names[v], v,
+          &(pm->pmb_pack->pz4c->u_con));
+        }
       }
     }
 
@@ -679,6 +695,15 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
     outvars.emplace_back("pdens",0,&(derived_var));
   }
 
+  // particle moments deposited to mesh
+  if (out_params.variable.compare("prtcl_mom") == 0) {
+    out_params.contains_derived = true;
+    outvars.emplace_back("pn",0,&(derived_var));
+    outvars.emplace_back("pnvx",1,&(derived_var));
+    outvars.emplace_back("pnvy",2,&(derived_var));
+    outvars.emplace_back("pnvz",3,&(derived_var));
+  }
+
   // initialize vector containing number of output MBs per rank
   noutmbs.assign(global_variable::nranks, 0);
 }
@@ -721,6 +746,15 @@ void BaseTypeOutput::LoadOutputData(Mesh *pm) {
       oks = indcs.ks; oke = indcs.ke;
     }
 
+    // skip this MB if it does not overlap the region of interest
+    if (out_params.region &&
+        (size.h_view(m).x1max <= out_params.region_x1min ||
+         size.h_view(m).x1min >= out_params.region_x1max ||
+         size.h_view(m).x2max <= out_params.region_x2min ||
+         size.h_view(m).x2min >= out_params.region_x2max ||
+         size.h_view(m).x3max <= out_params.region_x3min ||
+         size.h_view(m).x3min >= out_params.region_x3max)) { continue; }
+
     // check for slicing in each dimension, adjust start/end indices accordingly
     if (out_params.slice1) {
       // skip this MB if slice is out of range
@@ -782,7 +816,7 @@ void BaseTypeOutput::LoadOutputData(Mesh *pm) {
   int nout_mbs = outmbs.size();
   // note that while ois,oie,etc. can be different on each MB, the number of cells output
   // on each MeshBlock, i.e. (ois-ois+1), etc. is the same.
-  if (nout_mbs > 0) {
+  if (nout_mbs > 0 && copy_to_host) {
     int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
     int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
     int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
@@ -792,33 +826,39 @@ void BaseTypeOutput::LoadOutputData(Mesh *pm) {
 
   // Calculate derived variables, if required
   if (out_params.contains_derived) {
-    ComputeDerivedVariable(out_params.variable, pm);
+    LoadDerivedVariables(pm);
   }
 
-  // Now copy data to host (outarray) over all variables and MeshBlocks
+  // Now gather the output cells (e.g. slices) of all variables and MeshBlocks on the
+  // device, so only the output data is copied to host (outarray), with one copy
+  if (!copy_to_host || nout_mbs == 0) return;
+  int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
+  int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
+  int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
+  if (outarray_dvce.extent_int(0) != nout_vars || outarray_dvce.extent_int(1) != nout_mbs
+      || outarray_dvce.extent_int(2) != nout3 || outarray_dvce.extent_int(3) != nout2
+      || outarray_dvce.extent_int(4) != nout1) {
+    Kokkos::realloc(outarray_dvce, nout_vars, nout_mbs, nout3, nout2, nout1);
+  }
+  // MeshBlock index in pack and output start indices of each output MeshBlock
+  DualArray2D<int> omb("out_mbs", nout_mbs, 4);
+  for (int m=0; m<nout_mbs; ++m) {
+    omb.h_view(m,0) = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
+    omb.h_view(m,1) = outmbs[m].ois;
+    omb.h_view(m,2) = outmbs[m].ojs;
+    omb.h_view(m,3) = outmbs[m].oks;
+  }
+  omb.template modify<HostMemSpace>();
+  omb.template sync<DevExeSpace>();
+  auto &out = outarray_dvce;
   for (int n=0; n<nout_vars; ++n) {
-    for (int m=0; m<nout_mbs; ++m) {
-      int mbi = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
-      std::pair<int,int> irange = std::make_pair(outmbs[m].ois, outmbs[m].oie+1);
-      std::pair<int,int> jrange = std::make_pair(outmbs[m].ojs, outmbs[m].oje+1);
-      std::pair<int,int> krange = std::make_pair(outmbs[m].oks, outmbs[m].oke+1);
-      int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
-      int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
-      int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
-
-      // copy output variable to new device View
-      DvceArray3D<Real> d_output_var("d_out_var",nout3,nout2,nout1);
-      auto d_slice = Kokkos::subview(*(outvars[n].data_ptr), mbi, outvars[n].data_index,
-                                     krange,jrange,irange);
-      Kokkos::deep_copy(d_output_var,d_slice);
-
-      // copy new device View to host mirror View
-      DvceArray3D<Real>::HostMirror h_output_var = Kokkos::create_mirror(d_output_var);
-      Kokkos::deep_copy(h_output_var,d_output_var);
-
-      // copy host mirror to 5D host View containing all output variables
-      auto h_slice = Kokkos::subview(outarray,n,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(h_slice,h_output_var);
-    }
+    auto var = *(outvars[n].data_ptr);
+    int v = outvars[n].data_index;
+    par_for("out_gather",DevExeSpace(),0,(nout_mbs-1),0,(nout3-1),0,(nout2-1),0,(nout1-1),
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      out(n,m,k,j,i) =
+        var(omb.d_view(m,0),v,k+omb.d_view(m,3),j+omb.d_view(m,2),i+omb.d_view(m,1));
+    });
   }
+  Kokkos::deep_copy(outarray, outarray_dvce);
 }
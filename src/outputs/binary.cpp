@@ -18,6 +18,9 @@
 #include <string>
 #include <vector>
 #include <algorithm> // min
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -30,22 +33,151 @@
 
 MeshBinaryOutput::MeshBinaryOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
   BaseTypeOutput(pin, pm, op) {
+  // number of non-blocking writes allowed in flight; 0 means every write blocks
+  async_depth = pin->GetOrAddInteger(op.block_name, "async_depth", 0);
+  if (async_depth < 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "async_depth=" << async_depth << " in <"
+              << op.block_name << "> must be >= 0" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // absolute error bound of lossy compression for all variables ("error_bound") or a
+  // variable with label xxx ("error_bound_xxx").  Variables with bounds <= 0 are stored
+  // uncompressed, and the file is only written in compressed format if any bound is > 0
+  compress = false;
+  Real eps_all = 0.0;
+  if (pin->DoesParameterExist(op.block_name, "error_bound")) {
+    eps_all = pin->GetReal(op.block_name, "error_bound");
+  }
+  for (auto &var : outvars) {
+    Real eps = eps_all;
+    if (pin->DoesParameterExist(op.block_name, "error_bound_" + var.label)) {
+      eps = pin->GetReal(op.block_name, "error_bound_" + var.label);
+    }
+    error_bound.push_back(static_cast<float>(eps));
+    if (eps > 0.0) compress = true;
+  }
   // create directories for outputs
   // useful for mpiio-based outputs because on some supercomputers you may need to
   // set different stripe counts depending on whether mpiio is used in order to
   // achieve the best performance and not to crash the filesystem
   mkdir("bin",0775);
+  // output data is packed on the device by WriteOutputFile(), so outarray is not needed
+  copy_to_host = false;
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor: completes any writes still in flight
+
+MeshBinaryOutput::~MeshBinaryOutput() {
+  CompleteWrites();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBinaryOutput::CompleteOldestWrite()
+//  \brief Waits for the oldest non-blocking write, closes its file and frees its data
+
+void MeshBinaryOutput::CompleteOldestWrite() {
+  pending.front().file.Close();
+  delete [] pending.front().data;
+  pending.pop_front();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBinaryOutput::CompleteWrites()
+//  \brief Completes all non-blocking writes in flight, oldest first
+
+void MeshBinaryOutput::CompleteWrites() {
+  while (!pending.empty()) {
+    CompleteOldestWrite();
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::size_t MeshBinaryOutput::CompressVariable()
+//  \brief Stores the n values in data to out with absolute error at most eps, and returns
+//  the number of bytes stored.  Values are quantized to q = round((x - xmin)/(2 eps)),
+//  and stored as (float xmin, float 2 eps, int32 nbits) followed by q packed into nbits
+//  bits each (little-endian bit order), where nbits is the fewest bits that hold the
+//  largest q.  With eps <= 0 or non-finite values, nbits = -1 and the raw floats follow.
+
+std::size_t MeshBinaryOutput::CompressVariable(const float *data, int n, float eps,
+                                               char *out) {
+  float xmin = data[0], xmax = data[0];
+  bool finite = true;
+  for (int i=0; i<n; ++i) {
+    finite = finite && std::isfinite(data[i]);
+    xmin = std::min(xmin, data[i]);
+    xmax = std::max(xmax, data[i]);
+  }
+  float step = 2.0f*eps;
+  int32_t nbits = -1;
+  std::uint64_t qmax = 0;
+  if (eps > 0.0f && finite) {
+    double range = std::round((static_cast<double>(xmax) - xmin)/step);
+    if (range > 4294967295.0) {
+      // more than 32 bits needed, so use a smaller step (and error) instead
+      step = static_cast<float>((static_cast<double>(xmax) - xmin)/4294967295.0);
+      range = 4294967295.0;
+    }
+    qmax = static_cast<std::uint64_t>(range);
+    nbits = 0;
+    while ((static_cast<std::uint64_t>(1) << nbits) <= qmax) nbits++;
+  }
+
+  char *pout = out;
+  memcpy(pout, &xmin, sizeof(float));
+  pout += sizeof(float);
+  memcpy(pout, &step, sizeof(float));
+  pout += sizeof(float);
+  memcpy(pout, &nbits, sizeof(int32_t));
+  pout += sizeof(int32_t);
+  if (nbits < 0) {
+    memcpy(pout, data, n*sizeof(float));
+    return (pout - out) + n*sizeof(float);
+  }
+
+  std::uint64_t acc = 0;
+  int nacc = 0;
+  for (int i=0; i<n; ++i) {
+    std::uint64_t q = 0;
+    if (nbits > 0) {
+      q = static_cast<std::uint64_t>(std::llround((static_cast<double>(data[i]) - xmin)
+                                                  /step));
+      q = std::min(q, qmax);
+    }
+    acc |= q << nacc;
+    nacc += nbits;
+    while (nacc >= 8) {
+      *pout++ = static_cast<char>(acc & 0xff);
+      acc >>= 8;
+      nacc -= 8;
+    }
+  }
+  if (nacc > 0) {
+    *pout++ = static_cast<char>(acc & 0xff);
+  }
+  return (pout - out);
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBinaryOutput:::WriteOutputFile(Mesh *pm)
 //  \brief Cycles over all MeshBlocks and writes OutputData in binary format
 //   All MeshBlocks are written to the same file.
+//   With async_depth > 0 the collective data write is only started, and the file and
+//   packed data are kept until it completes, so that writing overlaps the next steps of
+//   the calculation.  At most async_depth writes are in flight: older writes are waited
+//   on before packing a new one.
 
 void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   // check if slicing
   bool bin_slice = (out_params.slice1 || out_params.slice2 || out_params.slice3);
 
+  // bound the number of writes (and data buffers) in flight
+  while (async_depth > 0 && pending.size() >= static_cast<std::size_t>(async_depth)) {
+    CompleteOldestWrite();
+  }
+
   // create filename: "bin/file_basename" + "." + "file_id" + "." + XXXXX + ".bin"
   // where XXXXX = 5-digit file_number
   std::string fname;
@@ -71,14 +203,18 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   // 4. Header (input file information)
   {
     std::stringstream msg;
-    msg << "Athena binary output version=1.1" << std::endl
+    // version 1.2 files hold data compressed by CompressVariable()
+    msg << "Athena binary output version=" << ((compress)? "1.2" : "1.1") << std::endl
         // preheader size includes "size of preheader" line up to "number of variables"
-        << "  size of preheader=5" << std::endl
+        << "  size of preheader=" << ((compress)? 6 : 5) << std::endl
         << "  time=" << pm->time << std::endl
         << "  cycle=" << pm->ncycle << std::endl
         << "  size of location=" << sizeof(Real) << std::endl
-        << "  size of variable=" << sizeof(float) << std::endl
-        << "  number of variables=" << outvars.size() << std::endl
+        << "  size of variable=" << sizeof(float) << std::endl;
+    if (compress) {
+      msg << "  compression=quantize" << std::endl;
+    }
+    msg << "  number of variables=" << outvars.size() << std::endl
         << "  variables:  ";
     for (int n=0; n<outvars.size(); n++) {
       msg << outvars[n].label.c_str() << "  ";
@@ -125,102 +261,142 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   int ns_mbs = pm->gids_eachrank[global_variable::my_rank];
   int nb_mbs = pm->nmb_eachrank[global_variable::my_rank];
 
-  // allocate 1D vector of floats used to convert and output data
-  char *data = new char[nb_mbs*data_size];
-  float *single_data = new float[cells];
+  // Output variables are converted to floats and packed on the device into a staging
+  // array laid out exactly as the (uncompressed) file, i.e. each MeshBlock holds a
+  // record of data_size bytes whose leading hdr_size bytes are reserved for the indices,
+  // locations and coordinates, filled in after a single copy to the host
+  std::size_t hdr_size = 10*sizeof(int32_t) + 6*sizeof(Real);
+  std::size_t nstage = (nout_mbs*data_size)/sizeof(float);
+  if (stage.extent(0) < nstage) {
+    Kokkos::realloc(stage, nstage);
+  }
+  if (nout_mbs > 0) {
+    // MeshBlock index in pack and output start indices of each output MeshBlock
+    DualArray2D<int> omb("bin_outmbs", nout_mbs, 4);
+    for (int m=0; m<nout_mbs; ++m) {
+      omb.h_view(m,0) = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
+      omb.h_view(m,1) = outmbs[m].ois;
+      omb.h_view(m,2) = outmbs[m].ojs;
+      omb.h_view(m,3) = outmbs[m].oks;
+    }
+    omb.template modify<HostMemSpace>();
+    omb.template sync<DevExeSpace>();
+
+    int nout1 = outmbs[0].oie - outmbs[0].ois + 1;
+    int nout2 = outmbs[0].oje - outmbs[0].ojs + 1;
+    int nout3 = outmbs[0].oke - outmbs[0].oks + 1;
+    std::size_t rec = data_size/sizeof(float);
+    std::size_t hdr = hdr_size/sizeof(float);
+    auto &stage_ = stage;
+    for (int n=0; n<nout_vars; ++n) {
+      auto var = *(outvars[n].data_ptr);
+      int v = outvars[n].data_index;
+      std::size_t voff = hdr + static_cast<std::size_t>(n)*cells;
+      par_for("bin_pack",DevExeSpace(),0,(nout_mbs-1),0,(nout3-1),0,(nout2-1),0,(nout1-1),
+      KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+        stage_(m*rec + voff + (k*nout2 + j)*nout1 + i) = static_cast<float>(
+          var(omb.d_view(m,0),v,k+omb.d_view(m,3),j+omb.d_view(m,2),i+omb.d_view(m,1)));
+      });
+    }
+  }
 
-  // Loop over MeshBlocks
-  for (int m=0; m<nout_mbs; ++m) {
-    char *pdata=&(data[m*data_size]);
-    LogicalLocation loc = pm->lloc_eachmb[outmbs[m].mb_gid];
-    int &ois = outmbs[m].ois;
-    int &oie = outmbs[m].oie;
-    int &ojs = outmbs[m].ojs;
-    int &oje = outmbs[m].oje;
-    int &oks = outmbs[m].oks;
-    int &oke = outmbs[m].oke;
-
-    // output indexing for MB
-    int32_t nx = (int32_t)(ois);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(oie);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(ojs);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(oje);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(oks);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(oke);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
+  // allocate buffer for output data.  Uncompressed data is copied directly into it, while
+  // compressed variables take at most the size of the raw floats plus their
+  // (xmin, step, nbits) header
+  std::size_t buf_size = data_size;
+  if (compress) {
+    buf_size += nout_vars*(2*sizeof(float) + sizeof(int32_t));
+  }
+  char *data = new char[nb_mbs*buf_size];
+  char *stage_data = data;
+  if (compress) {
+    stage_data = new char[nout_mbs*data_size];
+  }
+  if (nout_mbs > 0) {
+    using HostUnmanaged1D = Kokkos::View<float *, LayoutWrapper, HostMemSpace,
+                                         Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+    HostUnmanaged1D stage_h(reinterpret_cast<float*>(stage_data), nstage);
+    Kokkos::deep_copy(stage_h, Kokkos::subview(stage,
+                      std::make_pair(static_cast<std::size_t>(0), nstage)));
+  }
 
-    // logical location lx1, lx2, lx3
-    nx = (int32_t)(loc.lx1);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(loc.lx2);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(loc.lx3);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
+  // Loop over MeshBlocks in parallel on the host, filling in their headers (and
+  // compressing their data into the slot of each MeshBlock in data)
+  std::vector<std::size_t> mb_bytes(nout_mbs, data_size);
+  using HostRange = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>;
+  Kokkos::parallel_for("BinaryPack", HostRange(0, nout_mbs), [&](const int m) {
+    char *pdata = &(data[m*buf_size]);
+    LogicalLocation loc = pm->lloc_eachmb[outmbs[m].mb_gid];
 
-    // physical refinement level
-    nx = (int32_t)(loc.level-pm->root_level);
-    memcpy(pdata,&(nx),sizeof(nx));
+    // output indexing, logical location lx1, lx2, lx3 and physical refinement level
+    int32_t nx[10] = {outmbs[m].ois, outmbs[m].oie, outmbs[m].ojs, outmbs[m].oje,
+                      outmbs[m].oks, outmbs[m].oke, loc.lx1, loc.lx2, loc.lx3,
+                      loc.level - pm->root_level};
+    memcpy(pdata,nx,sizeof(nx));
     pdata+=sizeof(nx);
 
     // coordinate location
-    Real xv = outmbs[m].x1min;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
-    xv = outmbs[m].x1max;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
-    xv = outmbs[m].x2min;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
-    xv = outmbs[m].x2max;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
-    xv = outmbs[m].x3min;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
-    xv = outmbs[m].x3max;
-    memcpy(pdata,&(xv),sizeof(xv));
+    Real xv[6] = {outmbs[m].x1min, outmbs[m].x1max, outmbs[m].x2min, outmbs[m].x2max,
+                  outmbs[m].x3min, outmbs[m].x3max};
+    memcpy(pdata,xv,sizeof(xv));
     pdata+=sizeof(xv);
 
-    // output variables
-    float tmp_data;
-    for (int n=0; n<nout_vars; n++) {
-      int cnt=0;
-      for (int k=oks; k<=oke; k++) {
-        for (int j=ojs; j<=oje; j++) {
-          for (int i=ois; i<=oie; i++) {
-            tmp_data = static_cast<float>(outarray(n,m,k-oks,j-ojs,i-ois));
-            single_data[cnt] = tmp_data;
-            cnt++;
-          }
-        }
+    // output variables, already in place unless compressed
+    if (compress) {
+      const float *single_data =
+        reinterpret_cast<const float*>(&(stage_data[m*data_size + hdr_size]));
+      for (int n=0; n<nout_vars; n++) {
+        pdata += CompressVariable(single_data + n*cells, cells, error_bound[n], pdata);
       }
-      memcpy(pdata,single_data,cells*sizeof(float));
-      pdata+=cells*sizeof(float);
+      mb_bytes[m] = pdata - &(data[m*buf_size]);
+    }
+  });
+  std::size_t nbytes = nout_mbs*data_size;
+  if (compress) {
+    delete [] stage_data;
+    // compressed MeshBlocks differ in size, so move them together in order
+    nbytes = 0;
+    for (int m=0; m<nout_mbs; ++m) {
+      if (nbytes != m*buf_size) {
+        memmove(&(data[nbytes]), &(data[m*buf_size]), mb_bytes[m]);
+      }
+      nbytes += mb_bytes[m];
     }
   }
 
   // now write binary data
-  if (bin_slice) {
+  bool async = false;
+  if (compress) {
+    // compressed MeshBlocks differ in size, so the offset of each rank is found by a scan
+    IOWrapperSizeT mybytes = nbytes, myoffset = 0;
+#if MPI_PARALLEL_ENABLED
+    MPI_Exscan(&mybytes, &myoffset, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    if (global_variable::my_rank == 0) myoffset = 0;
+#endif
+    myoffset += header_offset;
+    if (nbytes > 2147483647) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "compressed binary data exceeds 2^31 bytes per rank, "
+                << "use more ranks or uncompressed outputs." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (!(bin_slice && noutmbs_min == 0) && async_depth > 0) {
+      binfile.Iwrite_bytes_at_all(data,nbytes,myoffset);
+      async = true;
+    } else if (!(bin_slice && noutmbs_min == 0)) {
+      binfile.Write_any_type_at_all(data,nbytes,myoffset,"byte");
+    } else if (nbytes > 0) {
+      binfile.Write_any_type_at(data,nbytes,myoffset,"byte");
+    }
+  } else if (bin_slice) {
     std::vector<int> rank_offset(global_variable::nranks, 0);
     std::partial_sum(noutmbs.begin(),std::prev(noutmbs.end()),
                      std::next(rank_offset.begin()));
     std::size_t myoffset=header_offset+data_size*rank_offset[global_variable::my_rank];
-    if (noutmbs_min > 0) {
+    if (noutmbs_min > 0 && async_depth > 0) {
+      binfile.Iwrite_bytes_at_all(data,(data_size*nout_mbs),myoffset);
+      async = true;
+    } else if (noutmbs_min > 0) {
       binfile.Write_any_type_at_all(data,(data_size*nout_mbs),myoffset,"byte");
     } else {
       if (nout_mbs > 0) {
@@ -232,7 +408,12 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     if (data_size*nb_mbs<=2147483648) {
       // now write binary data in parallel
       std::size_t myoffset=header_offset+data_size*ns_mbs;
-      binfile.Write_any_type_at_all(data,(data_size*nb_mbs),myoffset,"byte");
+      if (async_depth > 0) {
+        binfile.Iwrite_bytes_at_all(data,(data_size*nb_mbs),myoffset);
+        async = true;
+      } else {
+        binfile.Write_any_type_at_all(data,(data_size*nb_mbs),myoffset,"byte");
+      }
     } else {
       // write data over each MeshBlock sequentially and in parallel
       // calculate max/min number of MeshBlocks across all ranks
@@ -267,10 +448,13 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     }
   }
 
-  // close the output file and clean up ptrs to data
-  binfile.Close();
-  delete [] data;
-  delete [] single_data;
+  // close the output file and clean up ptrs to data, unless the write is still in flight
+  if (async) {
+    pending.push_back({binfile, data});
+  } else {
+    binfile.Close();
+    delete [] data;
+  }
 
   // increment counters
   out_params.file_number++;
@@ -13,19 +13,22 @@
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <numeric>
 #include <sstream>
 #include <string>
 #include <vector>
-#include <utility>
 #include <algorithm>
 
 #include "athena.hpp"
 #include "globals.hpp"
 #include "coordinates/cell_locations.hpp"
 #include "mesh/mesh.hpp"
+#include "mesh/restriction.hpp"
 #include "outputs.hpp"
 
+std::map<std::string, CoarseningCascade> CoarsenedBinaryOutput::cascades;
+
 //----------------------------------------------------------------------------------------
 // Constructor: also calls BaseTypeOutput base class constructor
 
@@ -42,6 +45,15 @@ CoarsenedBinaryOutput::CoarsenedBinaryOutput(ParameterInput *pin, Mesh *pm,
   dir_name.append("_");
   dir_name.append(std::to_string(out_params.coarsen_factor));
   mkdir(dir_name.c_str(),0775);
+
+  // coarsened data is computed by a cascade of restrictions by factors of 2
+  int cf = out_params.coarsen_factor;
+  if (cf < 2 || (cf & (cf - 1)) != 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "coarsen_factor=" << cf << " in " << out_params.block_name
+              << " must be a power of 2" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -136,149 +148,106 @@ void CoarsenedBinaryOutput::LoadOutputData(Mesh *pm) {
   noutmbs_min = *std::min_element(noutmbs.begin(), noutmbs.end());
   noutmbs_max = *std::max_element(noutmbs.begin(), noutmbs.end());
 
-  // get number of output vars and MBs, then realloc outarray (HostArray)
-  int nout_vars_with_moments;
-  if (out_params.compute_moments) {
-    nout_vars_with_moments = outvars.size() * 4;
-  } else {
-    nout_vars_with_moments = outvars.size();
-  }
+  // get number of output vars and MBs
+  int nmom = (out_params.compute_moments)? 4 : 1;
   int nout_vars = outvars.size();
   int nout_mbs = outmbs.size();
-  // note that while ois,oie,etc. can be different on each MB, the number of cells output
-  // on each MeshBlock, i.e. (ois-ois+1), etc. is the same.
-  if (nout_mbs > 0) {
-    int nout1 = ((outmbs[0].oie - outmbs[0].ois + 1)/out_params.coarsen_factor);
-    int nout2 = ((outmbs[0].oje - outmbs[0].ojs + 1)/out_params.coarsen_factor);
-    int nout3 = ((outmbs[0].oke - outmbs[0].oks + 1)/out_params.coarsen_factor);
-    // NB: outarray stores all output data on Host
-    // DBF: outarray is smaller by a factor of coarsen_factor in each dimension
-    Kokkos::realloc(outarray, nout_vars_with_moments, nout_mbs, nout3, nout2, nout1);
-  }
 
   // Calculate derived variables, if required
   if (out_params.contains_derived) {
-    ComputeDerivedVariable(out_params.variable, pm);
+    LoadDerivedVariables(pm);
   }
+  if (nout_mbs == 0) return;
 
-  // Now copy data to host (outarray) over all variables and MeshBlocks
-  for (int n=0; n<nout_vars; ++n) {
-    for (int m=0; m<nout_mbs; ++m) {
-      int mbi = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
-      std::pair<int,int> irange = std::make_pair(outmbs[m].ois, outmbs[m].oie+1);
-      std::pair<int,int> jrange = std::make_pair(outmbs[m].ojs, outmbs[m].oje+1);
-      std::pair<int,int> krange = std::make_pair(outmbs[m].oks, outmbs[m].oke+1);
-      std::pair<int,int> moment_range;
-      if (out_params.compute_moments) {
-        moment_range = std::make_pair(n*4, n*4+4);
-      } else {
-        moment_range = std::make_pair(n, n+1);
-      }
-      int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
-      int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
-      int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
-      int coarsened_nout1 = nout1/out_params.coarsen_factor;
-      int coarsened_nout2 = nout2/out_params.coarsen_factor;
-      int coarsened_nout3 = nout3/out_params.coarsen_factor;
-
-      // copy output variable to new device View
-      DvceArray3D<Real> d_output_var("d_out_var",nout3,nout2,nout1);
-      auto d_slice = Kokkos::subview(*(outvars[n].data_ptr), mbi, outvars[n].data_index,
-                                     krange,jrange,irange);
-      Kokkos::deep_copy(d_output_var,d_slice);
-      Kokkos::fence(); // Ensure complete copy
-
-
-      int number_of_moments = 1;
-      if (out_params.compute_moments) {
-        number_of_moments = 4;
-      }
-      DvceArray4D<Real> d_output_var_coarsened("d_output_var_coarsened",
-        number_of_moments, coarsened_nout3, coarsened_nout2, coarsened_nout1);
-
-      // Coarsen the d_slice and store the result in d_output_var
-      // CoarsenVariable(d_output_var, d_output_var_coarsened, out_params.coarsen_factor);
-      int coarsen_factor = out_params.coarsen_factor;
-      int coarsen_factor_cubed = coarsen_factor * coarsen_factor * coarsen_factor;
-
-      if (nout1 % coarsen_factor != 0 || nout2 % coarsen_factor != 0
-                                      || nout3 % coarsen_factor != 0) {
-          std::cout << "Error: Full data dimensions are not divisible by coarsen_factor"
-          << std::endl;
-          exit(EXIT_FAILURE);
-      }
+  // note that while ois,oie,etc. can be different on each MB, the number of cells output
+  // on each MeshBlock, i.e. (ois-ois+1), etc. is the same.  Only directions with more
+  // than one output cell (i.e. not sliced, and used in 2D/1D) are coarsened.
+  int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
+  int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
+  int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
+  int cf = out_params.coarsen_factor;
+  if ((nout1 > 1 && nout1 % cf != 0) || (nout2 > 1 && nout2 % cf != 0) ||
+      (nout3 > 1 && nout3 % cf != 0)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Output data dimensions are not divisible by coarsen_factor"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  int nlevel = 0;
+  while ((1 << nlevel) < cf) {nlevel++;}
+
+  // Outputs of the same variables and cells at different coarsen_factors in the same
+  // cycle share one cascade, extended as far as the largest factor requested
+  std::string key = out_params.variable + ((out_params.compute_moments)? ",mom" : "")
+                  + ((out_params.include_gzs)? ",gzs" : "")
+                  + ",gid=" + std::to_string(out_params.gid);
+  if (out_params.slice1) {key += ",x1=" + std::to_string(out_params.slice_x1);}
+  if (out_params.slice2) {key += ",x2=" + std::to_string(out_params.slice_x2);}
+  if (out_params.slice3) {key += ",x3=" + std::to_string(out_params.slice_x3);}
+  auto &cascade = cascades[key];
+  if (cascade.ncycle != pm->ncycle || cascade.time != pm->time ||
+      cascade.ngeneration != pm->ngeneration) {
+    cascade.levels.clear();
+    cascade.ncycle = pm->ncycle;
+    cascade.time = pm->time;
+    cascade.ngeneration = pm->ngeneration;
+  }
 
-      int total_iterations = coarsened_nout3
-        * coarsened_nout2 * coarsened_nout1 * coarsen_factor_cubed;
-
-      bool compute_moments = out_params.compute_moments;
-      Kokkos::parallel_for("coarsen_variable",
-       Kokkos::RangePolicy<DevExeSpace>(0, total_iterations),
-      KOKKOS_LAMBDA(const int idx) {
-        // Calculate the 3D indices for the coarsened data
-        int total_coarsened_elements = coarsened_nout1*coarsened_nout2*coarsened_nout3;
-        int k_c = (idx / (coarsened_nout2 * coarsened_nout1)) % coarsened_nout3;
-        int j_c = (idx / coarsened_nout1) % coarsened_nout2;
-        int i_c = idx % coarsened_nout1;
-
-        // Calculate the offset within the coarsen_factor_cubed cube
-        int offset = idx / total_coarsened_elements;
-        int kk = offset / (coarsen_factor * coarsen_factor);
-        int jj = (offset / coarsen_factor) % coarsen_factor;
-        int ii = offset % coarsen_factor;
-
-        // Calculate the corresponding indices in the full data
-        int k = k_c * coarsen_factor + kk;
-        int j = j_c * coarsen_factor + jj;
-        int i = i_c * coarsen_factor + ii;
-
-        // Perform the coarsening operation
-        if(k < nout3 && j < nout2 && i < nout1) {
-          Kokkos::atomic_add(&d_output_var_coarsened(0, k_c, j_c, i_c),
-            d_output_var(k, j, i));
-          if (compute_moments) {
-            Kokkos::atomic_add(&d_output_var_coarsened(1, k_c, j_c, i_c),
-              d_output_var(k, j, i)*d_output_var(k, j, i));
-            Kokkos::atomic_add(&d_output_var_coarsened(2, k_c, j_c, i_c),
-              d_output_var(k, j, i)*d_output_var(k, j, i)*d_output_var(k, j, i));
-            Kokkos::atomic_add(&d_output_var_coarsened(3, k_c, j_c, i_c),
-               d_output_var(k, j, i)*d_output_var(k, j, i)
-              *d_output_var(k, j, i)*d_output_var(k, j, i));
-          }
+  // level 0: gather output cells of all variables (and their powers q^2,q^3,q^4 for
+  // moments) and MeshBlocks on the device
+  if (cascade.levels.empty()) {
+    DvceArray5D<Real> lev0("cbin_lev0", nmom*nout_vars, nout_mbs, nout3, nout2, nout1);
+    // MeshBlock index in pack and output start indices of each output MeshBlock
+    DualArray2D<int> omb("out_mbs", nout_mbs, 4);
+    for (int m=0; m<nout_mbs; ++m) {
+      omb.h_view(m,0) = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
+      omb.h_view(m,1) = outmbs[m].ois;
+      omb.h_view(m,2) = outmbs[m].ojs;
+      omb.h_view(m,3) = outmbs[m].oks;
+    }
+    omb.template modify<HostMemSpace>();
+    omb.template sync<DevExeSpace>();
+    for (int n=0; n<nout_vars; ++n) {
+      auto var = *(outvars[n].data_ptr);
+      int v = outvars[n].data_index;
+      par_for("cbin_gather",DevExeSpace(),0,(nout_mbs-1),0,(nout3-1),0,(nout2-1),
+              0,(nout1-1),
+      KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+        Real q =
+          var(omb.d_view(m,0),v,k+omb.d_view(m,3),j+omb.d_view(m,2),i+omb.d_view(m,1));
+        Real qp = q;
+        for (int p=0; p<nmom; ++p) {
+          lev0(n*nmom+p,m,k,j,i) = qp;
+          qp *= q;
         }
       });
-      // Normalize the coarsened data
-      int normalize_iterations = number_of_moments * coarsened_nout3
-                                * coarsened_nout2 * coarsened_nout1;
-      Kokkos::parallel_for("normalize_coarsened_variable",
-        Kokkos::RangePolicy<DevExeSpace>(0, normalize_iterations),
-      KOKKOS_LAMBDA(const int idx) {
-        int moment_idx = idx / (coarsened_nout3 * coarsened_nout2 * coarsened_nout1);
-        int k = (idx / (coarsened_nout2 * coarsened_nout1)) % coarsened_nout3;
-        int j = (idx / coarsened_nout1) % coarsened_nout2;
-        int i = idx % coarsened_nout1;
-
-        d_output_var_coarsened(moment_idx, k, j, i) /= coarsen_factor_cubed;
-      });
-
-
-      // Now, create a host mirror for the coarsened data.
-      DvceArray4D<Real>::HostMirror h_output_var = Kokkos::create_mirror(
-        d_output_var_coarsened
-      );
-
-      // Copy the coarsened data to the host mirror.
-      Kokkos::deep_copy(h_output_var, d_output_var_coarsened);
-      Kokkos::fence(); // Ensure complete copy before using h_output_var on the host
-
-      // copy host mirror to 5D host View containing all output variables
-      // if (out_params.compute_moments) {
-      auto h_slice = Kokkos::subview(outarray,
-        moment_range,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL
-      );
-      Kokkos::deep_copy(h_slice,h_output_var);
     }
+    cascade.levels.push_back(lev0);
   }
+
+  // restrict by a further factor of 2 per level, reusing the AMR volume average
+  for (int l=static_cast<int>(cascade.levels.size()); l<=nlevel; ++l) {
+    auto fine = cascade.levels[l-1];
+    int dk = (fine.extent_int(2) > 1)? 1 : 0;
+    int dj = (fine.extent_int(3) > 1)? 1 : 0;
+    int di = (fine.extent_int(4) > 1)? 1 : 0;
+    int nc3 = fine.extent_int(2) >> dk;
+    int nc2 = fine.extent_int(3) >> dj;
+    int nc1 = fine.extent_int(4) >> di;
+    DvceArray5D<Real> coarse("cbin_lev", nmom*nout_vars, nout_mbs, nc3, nc2, nc1);
+    par_for("cbin_restrict",DevExeSpace(),0,(nmom*nout_vars-1),0,(nout_mbs-1),
+            0,(nc3-1),0,(nc2-1),0,(nc1-1),
+    KOKKOS_LAMBDA(const int n, const int m, const int k, const int j, const int i) {
+      coarse(n,m,k,j,i) = RestrictAverage(n,m,(k<<dk),(j<<dj),(i<<di),dk,dj,di,fine);
+    });
+    cascade.levels.push_back(coarse);
+  }
+
+  // NB: outarray stores all output data on Host
+  auto &out = cascade.levels[nlevel];
+  Kokkos::realloc(outarray, out.extent_int(0), out.extent_int(1), out.extent_int(2),
+                  out.extent_int(3), out.extent_int(4));
+  Kokkos::deep_copy(outarray, out);
 }
 
 //----------------------------------------------------------------------------------------
@@ -373,9 +342,9 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     nout_vars *= 4;
   }
   int nout_mbs = outmbs.size();
-  int nout1 = ((outmbs[0].oie - outmbs[0].ois + 1)/out_params.coarsen_factor);
-  int nout2 = ((outmbs[0].oje - outmbs[0].ojs + 1)/out_params.coarsen_factor);
-  int nout3 = ((outmbs[0].oke - outmbs[0].oks + 1)/out_params.coarsen_factor);
+  int nout1 = outarray.extent_int(4);
+  int nout2 = outarray.extent_int(3);
+  int nout3 = outarray.extent_int(2);
   int cells = nout1*nout2*nout3;
 
 
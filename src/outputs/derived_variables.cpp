@@ -13,6 +13,7 @@
 //!   - magnitude of current density J^2  [non-relativistic]
 
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>   // std::string, to_string()
 
@@ -28,9 +29,48 @@
 #include "radiation/radiation.hpp"
 #include "radiation/radiation_tetrad.hpp"
 #include "particles/particles.hpp"
+#include "z4c/z4c.hpp"
 #include "outputs.hpp"
 #include "utils/current.hpp"
 
+std::map<std::string, DerivedVariableCache> BaseTypeOutput::derived_cache;
+
+//----------------------------------------------------------------------------------------
+//! \fn void BaseTypeOutput::LoadDerivedVariables()
+//  \brief Computes the derived variables of this output (variable, and variable_2 for 2D
+//  PDFs) into derived_var.  When several outputs request the same variables in one cycle
+//  (e.g. bin, vtk and pdf outputs of current density), only the first computes them, and
+//  the others share its array.  Entries are keyed by the variable names, since these
+//  fix the layout of derived_var, and are only reused at the same cycle, time and Mesh
+//  generation.  Shared arrays are only ever overwritten by a recomputation of the same
+//  variables, i.e. with identical values.
+
+void BaseTypeOutput::LoadDerivedVariables(Mesh *pm) {
+  std::string key = out_params.variable;
+  if (!out_params.variable_2.empty()) {
+    key += "," + out_params.variable_2;
+  }
+  auto &cached = derived_cache[key];
+  if (cached.ncycle == pm->ncycle && cached.time == pm->time &&
+      cached.ngeneration == pm->ngeneration) {
+    derived_var = cached.data;
+    return;
+  }
+
+  // number of MeshBlocks changes with AMR, so reallocate in ComputeDerivedVariable()
+  if (derived_var.extent_int(0) != pm->pmb_pack->nmb_thispack) {
+    derived_var = DvceArray5D<Real>("derived-var",1,1,1,1,1);
+  }
+  ComputeDerivedVariable(out_params.variable, pm);
+  if (!out_params.variable_2.empty()) {
+    ComputeDerivedVariable(out_params.variable_2, pm);
+  }
+  cached.data = derived_var;
+  cached.ncycle = pm->ncycle;
+  cached.time = pm->time;
+  cached.ngeneration = pm->ngeneration;
+}
+
 //----------------------------------------------------------------------------------------
 // BaseTypeOutput::ComputeDerivedVariable()
 
@@ -1207,5 +1247,33 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
       pdens(m,0,kp,jp,ip) += 1.0;
     });
   }
-  i_dv = i_dv % n_dv; // reset derived variable index
+
+  // Particle number density and flux deposited to mesh with TSC weights
+  if (name.compare("prtcl_mom") == 0) {
+    auto ppart = pm->pmb_pack->ppart;
+    ppart->DepositMoments();
+    Kokkos::realloc(derived_var, nmb, 4, n3, n2, n1);
+    Kokkos::deep_copy(derived_var, ppart->moments);
+  }
+
+  // Z4c constraints stored in float (<z4c>/con_precision = float), converted to Real
+  if ((name.compare("con") == 0 || name.compare(0, 4, "con_") == 0) &&
+      (pm->pmb_pack->pz4c != nullptr) && pm->pmb_pack->pz4c->opt.con_float) {
+    if (derived_var.extent(4) <= 1)
+      Kokkos::realloc(derived_var, nmb, n_dv, n3, n2, n1);
+    auto dv = derived_var;
+    auto ucon_f = pm->pmb_pack->pz4c->u_con_f;
+    for (int v = 0; v < z4c::Z4c::ncon; ++v) {
+      if (name.compare("con") != 0 && name.compare(z4c::Z4c::Constraint_names[v]) != 0) {
+        continue;
+      }
+      int iv = i_dv;
+      par_for("con_float", DevExeSpace(), 0, (nmb-1), 0, (n3-1), 0, (n2-1), 0, (n1-1),
+      KOKKOS_LAMBDA(int m, int k, int j, int i) {
+        dv(m,iv,k,j,i) = static_cast<Real>(ucon_f(m,v,k,j,i));
+      });
+      i_dv += 1; // increment derived variable index
+    }
+  }
+  if (n_dv > 0) i_dv = i_dv % n_dv; // reset derived variable index
 }
@@ -7,6 +7,10 @@
 //! \brief writes diagnostic data collected by various event counters implemented
 //! throughout the code to a log file.  Checks whether there is data to be written
 //! every time step, but only writes data if one or more counters are non-zero
+//!
+//! With io_profile=true in the <output> block, every line also holds the number of
+//! outputs made, the time spent loading data and writing files (maximum over ranks), and
+//! MB written (summed over ranks) so far by each output block, and is always written.
 
 #include <cstdio>
 #include <cstdlib>
@@ -26,13 +30,16 @@
 EventLogOutput::EventLogOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
   BaseTypeOutput(pin, pm, op) {
   header_written = false;
+  io_profile = pin->GetOrAddBoolean(op.block_name, "io_profile", false);
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void EventLogOutput::LoadOutputData()
-//! \brief sums event counter data across MPI ranks
+//! \brief adds event counters accumulated on the device to host, then sums event
+//! counter data across MPI ranks
 
 void EventLogOutput::LoadOutputData(Mesh *pm) {
+  pm->ecounter.AddDeviceCounters();
 #if MPI_PARALLEL_ENABLED
   // perform in-place sum or max over all MPI ranks, depending on counter
   int* pdfloor = &(pm->ecounter.neos_dfloor);
@@ -49,6 +56,18 @@ void EventLogOutput::LoadOutputData(Mesh *pm) {
   MPI_Allreduce(MPI_IN_PLACE, pfail,   1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
   MPI_Allreduce(MPI_IN_PLACE, pmaxit,  1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
   MPI_Allreduce(MPI_IN_PLACE, pfofc,   1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  if (pm->ecounter.c2p_hist_used) {
+    MPI_Allreduce(MPI_IN_PLACE, pm->ecounter.c2p_hist, EventCounters::nc2p_hist, MPI_INT,
+                  MPI_SUM, MPI_COMM_WORLD);
+  }
+  if (pm->ecounter.rad_counters_used) {
+    int* pradfail = &(pm->ecounter.nrad_fail);
+    int* pcompfail = &(pm->ecounter.ncompton_fail);
+    int* pcompequil = &(pm->ecounter.ncompton_equil);
+    MPI_Allreduce(MPI_IN_PLACE, pradfail,   1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, pcompfail,  1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, pcompequil, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  }
 #endif
 
   // check if there is any data to be written
@@ -59,9 +78,21 @@ void EventLogOutput::LoadOutputData(Mesh *pm) {
       pm->ecounter.neos_vceil  > 0 ||
       pm->ecounter.neos_fail   > 0 ||
       pm->ecounter.nfofc > 0 ||
-      pm->ecounter.maxit_c2p > 0) {
+      pm->ecounter.maxit_c2p > 0 ||
+      pm->ecounter.nrad_fail > 0 ||
+      pm->ecounter.ncompton_fail > 0 ||
+      pm->ecounter.ncompton_equil > 0) {
     no_output=false;
   }
+  // also write data if any cells were counted in histogram of c2p iterations
+  for (int n=0; n<EventCounters::nc2p_hist; ++n) {
+    if (pm->ecounter.c2p_hist[n] > 0) {no_output=false;}
+  }
+  // timing of all outputs (which must be reduced by all ranks) is always written
+  if (pprofiled != nullptr) {
+    Outputs::ReduceIOProfile(*pprofiled, io_stats);
+    no_output = false;
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -92,6 +123,21 @@ void EventLogOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       std::fprintf(pfile,"# Athena event counter data\n");
       std::fprintf(pfile,"#  cycle eos_dfloor eos_efloor eos_tfloor eos_vceil");
       std::fprintf(pfile," eos_fail c2p_it fofc");
+      if (pm->ecounter.rad_counters_used) {
+        std::fprintf(pfile," rad_fail compt_fail compt_equil");
+      }
+      if (pm->ecounter.c2p_hist_used) {
+        for (int n=0; n<EventCounters::nc2p_hist; ++n) {
+          std::fprintf(pfile," c2p_hist%02d", n);
+        }
+      }
+      if (pprofiled != nullptr) {
+        for (auto pout : *pprofiled) {
+          const char *name = pout->out_params.block_name.c_str();
+          std::fprintf(pfile," %s_calls %s_tload %s_twrite %s_MB",
+                       name, name, name, name);
+        }
+      }
       std::fprintf(pfile,"\n");  // terminate line
       header_written = true;
     }
@@ -106,6 +152,23 @@ void EventLogOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       std::fprintf(pfile, " %8d", pm->ecounter.neos_fail);
       std::fprintf(pfile, " %6d", pm->ecounter.maxit_c2p);
       std::fprintf(pfile, " %8d", pm->ecounter.nfofc);
+      if (pm->ecounter.rad_counters_used) {
+        std::fprintf(pfile, " %8d", pm->ecounter.nrad_fail);
+        std::fprintf(pfile, " %10d", pm->ecounter.ncompton_fail);
+        std::fprintf(pfile, " %11d", pm->ecounter.ncompton_equil);
+      }
+      if (pm->ecounter.c2p_hist_used) {
+        for (int n=0; n<EventCounters::nc2p_hist; ++n) {
+          std::fprintf(pfile, " %11d", pm->ecounter.c2p_hist[n]);
+        }
+      }
+      if (pprofiled != nullptr) {
+        for (std::size_t n=0; n<pprofiled->size(); ++n) {
+          std::fprintf(pfile, " %6d %12.5e %12.5e %12.5e",
+                       static_cast<int>(io_stats[4*n]), io_stats[4*n+1],
+                       io_stats[4*n+2], 1.0e-6*io_stats[4*n+3]);
+        }
+      }
       std::fprintf(pfile,"\n"); // terminate line
     }
     std::fclose(pfile);
@@ -119,6 +182,12 @@ void EventLogOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   pm->ecounter.neos_fail = 0;
   pm->ecounter.maxit_c2p = 0;
   pm->ecounter.nfofc = 0;
+  pm->ecounter.nrad_fail = 0;
+  pm->ecounter.ncompton_fail = 0;
+  pm->ecounter.ncompton_equil = 0;
+  for (int n=0; n<EventCounters::nc2p_hist; ++n) {
+    pm->ecounter.c2p_hist[n] = 0;
+  }
 
   // increment output time, clean up
   if (out_params.last_time < 0.0) {
@@ -0,0 +1,117 @@
+#ifndef OUTPUTS_HDF5_UTILS_HPP_
+#define OUTPUTS_HDF5_UTILS_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hdf5_utils.hpp
+//! \brief helper functions shared by the outputs written with (parallel) HDF5, i.e. the
+//! athdf and VTKHDF outputs.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "io_wrapper.hpp"
+
+#if HDF5OUTPUT_ENABLED
+#include <hdf5.h>
+
+namespace hdf5_utils {
+//----------------------------------------------------------------------------------------
+//! \fn void WriteAttribute()
+//  \brief writes attribute name holding n values of type memtype to group (or file) loc
+
+inline void WriteAttribute(hid_t loc, const char *name, hid_t filetype, hid_t memtype,
+                           hsize_t n, const void *data) {
+  hid_t space = H5Screate_simple(1, &n, nullptr);
+  hid_t attr = H5Acreate2(loc, name, filetype, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(attr, memtype, data);
+  H5Aclose(attr);
+  H5Sclose(space);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WriteStringAttribute()
+//  \brief writes attribute name holding strings of fixed length len (as numpy '|S<len>')
+
+inline void WriteStringAttribute(hid_t loc, const char *name,
+                                 const std::vector<std::string> &strings,
+                                 std::size_t len) {
+  std::vector<char> buf(strings.size()*len, '\0');
+  for (std::size_t n=0; n<strings.size(); ++n) {
+    strings[n].copy(&buf[n*len], std::min(len, strings[n].size()));
+  }
+  hid_t type = H5Tcopy(H5T_C_S1);
+  H5Tset_size(type, len);
+  H5Tset_strpad(type, H5T_STR_NULLPAD);
+  WriteAttribute(loc, name, type, type, strings.size(), buf.data());
+  H5Tclose(type);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WriteScalarStringAttribute()
+//  \brief writes attribute name holding a single (scalar) ASCII string
+
+inline void WriteScalarStringAttribute(hid_t loc, const char *name,
+                                       const std::string &string) {
+  hid_t type = H5Tcopy(H5T_C_S1);
+  H5Tset_size(type, string.size());
+  H5Tset_strpad(type, H5T_STR_NULLPAD);
+  H5Tset_cset(type, H5T_CSET_ASCII);
+  hid_t space = H5Screate(H5S_SCALAR);
+  hid_t attr = H5Acreate2(loc, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(attr, type, string.data());
+  H5Aclose(attr);
+  H5Sclose(space);
+  H5Tclose(type);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WriteDataset()
+//  \brief creates dataset name in group (or file) loc with dimensions dims, whose axis
+//  mbdim indexes MeshBlocks, and collectively writes the nmb MeshBlocks of this rank
+//  starting at MeshBlock moff.  With chunk, the dataset is chunked by MeshBlock (and by
+//  the axes before mbdim).
+
+inline void WriteDataset(hid_t loc, hid_t dxpl, const char *name, hid_t filetype,
+                         hid_t memtype, int ndims, const hsize_t *dims, int mbdim,
+                         hsize_t moff, hsize_t nmb, bool chunk, const void *data) {
+  hsize_t start[5], count[5], cdims[5];
+  for (int d=0; d<ndims; ++d) {
+    start[d] = 0;
+    count[d] = dims[d];
+    cdims[d] = (d <= mbdim)? 1 : dims[d];
+  }
+  start[mbdim] = moff;
+  count[mbdim] = nmb;
+
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  if (chunk && dims[mbdim] > 0) {
+    H5Pset_chunk(dcpl, ndims, cdims);
+  }
+  hid_t fspace = H5Screate_simple(ndims, dims, nullptr);
+  hid_t dset = H5Dcreate2(loc, name, filetype, fspace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+  hid_t mspace = H5Screate_simple(ndims, count, nullptr);
+  if (nmb > 0) {
+    H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+  } else {
+    // ranks without output MeshBlocks still take part in the collective write
+    H5Sselect_none(fspace);
+    H5Sselect_none(mspace);
+  }
+  H5Dwrite(dset, memtype, mspace, fspace, dxpl, data);
+  IOWrapperSizeT nbytes = H5Tget_size(filetype);
+  for (int d=0; d<ndims; ++d) {nbytes *= count[d];}
+  IOWrapper::nbytes_written += (nmb > 0)? nbytes : 0;
+  H5Sclose(mspace);
+  H5Dclose(dset);
+  H5Sclose(fspace);
+  H5Pclose(dcpl);
+}
+} // namespace hdf5_utils
+#endif // HDF5OUTPUT_ENABLED
+
+#endif // OUTPUTS_HDF5_UTILS_HPP_
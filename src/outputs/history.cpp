@@ -13,6 +13,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -48,233 +49,215 @@ HistoryOutput::HistoryOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
   if (pm->pmb_pack->pz4c != nullptr) {
     hist_data.emplace_back(PhysicsModule::SpaceTimeDynamics);
   }
-}
-
-//----------------------------------------------------------------------------------------
-//! \fn void HistoryOutput::LoadOutputData()
-//  \brief Wrapper function that cycles through hist_data vector and calls
-//  appropriate LoadXXXData() function for that physics
 
-void HistoryOutput::LoadOutputData(Mesh *pm) {
+  // number of outputs whose rows are buffered, and then summed over ranks and written
+  // together, e.g. to output history data every cycle without a reduction every cycle
+  buffer_cycles = pin->GetOrAddInteger(op.block_name, "buffer_cycles", 1);
+  if (buffer_cycles < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "buffer_cycles=" << buffer_cycles << " in <"
+              << op.block_name << "> must be >= 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  batch_reducing = false;
+
+  // register the built-in history variables of each physics module, which are all
+  // summed by one kernel into consecutive entries starting at ihydro, imhd and iz4c
+  nhist_builtin = 0;
+  ihydro = -1;
+  imhd = -1;
+  iz4c = -1;
   for (auto &data : hist_data) {
     if (data.physics == PhysicsModule::HydroDynamics) {
-      LoadHydroHistoryData(&data, pm);
+      bool is_ideal = pm->pmb_pack->phydro->peos->eos_data.is_ideal;
+      data.nhist = (is_ideal)? 8 : 7;
+      int nfluid = (is_ideal)? 5 : 4;
+      data.label[IDN] = "mass";
+      data.label[IM1] = "1-mom";
+      data.label[IM2] = "2-mom";
+      data.label[IM3] = "3-mom";
+      if (is_ideal) {
+        data.label[IEN] = "tot-E";
+      }
+      data.label[nfluid  ] = "1-KE";
+      data.label[nfluid+1] = "2-KE";
+      data.label[nfluid+2] = "3-KE";
+      ihydro = nhist_builtin;
+      nhist_builtin += data.nhist;
     } else if (data.physics == PhysicsModule::MagnetoHydroDynamics) {
-      LoadMHDHistoryData(&data, pm);
+      bool is_ideal = pm->pmb_pack->pmhd->peos->eos_data.is_ideal;
+      data.nhist = (is_ideal)? 11 : 10;
+      int nfluid = (is_ideal)? 5 : 4;
+      data.label[IDN] = "mass";
+      data.label[IM1] = "1-mom";
+      data.label[IM2] = "2-mom";
+      data.label[IM3] = "3-mom";
+      if (is_ideal) {
+        data.label[IEN] = "tot-E";
+      }
+      data.label[nfluid  ] = "1-KE";
+      data.label[nfluid+1] = "2-KE";
+      data.label[nfluid+2] = "3-KE";
+      data.label[nfluid+3] = "1-ME";
+      data.label[nfluid+4] = "2-ME";
+      data.label[nfluid+5] = "3-ME";
+      // max |div(B)| since last output, reduced by max over ranks
+      if (pm->pmb_pack->pmhd->divb_diag) {
+        data.label[data.nhist] = "divB-max";
+        data.nhist++;
+        data.nmax = 1;
+      }
+      imhd = nhist_builtin;
+      nhist_builtin += data.nhist;
     } else if (data.physics == PhysicsModule::SpaceTimeDynamics) {
-      LoadZ4cHistoryData(&data, pm);
-    } else if (data.physics == PhysicsModule::UserDefined) {
-      (pm->pgen->user_hist_func)(&data, pm);
+      data.nhist = 8;
+      data.label[0] = "H-norm2";
+      data.label[1] = "M-norm2";
+      data.label[2] = "Mx-norm2";
+      data.label[3] = "My-norm2";
+      data.label[4] = "Mz-norm2";
+      data.label[5] = "Z-norm2";
+      data.label[6] = "Theta-norm2";
+      data.label[7] = "C-norm2";
+      iz4c = nhist_builtin;
+      nhist_builtin += data.nhist;
     }
   }
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void HistoryOutput::LoadHydroHistoryData()
-//  \brief Compute and store history data over all MeshBlocks on this rank
-//  Data is stored in a Real array defined in derived class.
-
-void HistoryOutput::LoadHydroHistoryData(HistoryData *pdata, Mesh *pm) {
-  auto &eos_data = pm->pmb_pack->phydro->peos->eos_data;
-  int &nhydro_ = pm->pmb_pack->phydro->nhydro;
+//! \fn void HistoryOutput::LoadOutputData()
+//  \brief Sums the built-in history variables of all physics modules over all MeshBlocks
+//  on this rank with a single kernel, then calls the user history function (if any).
+//  The data of all modules is buffered on this rank for buffer_cycles outputs, and then
+//  summed over ranks with one non-blocking reduction, completed in WriteOutputFile().
 
-  // set number of and names of history variables for hydro
-  if (eos_data.is_ideal) {
-    pdata->nhist = 8;
-  } else {
-    pdata->nhist = 7;
-  }
-  pdata->label[IDN] = "mass";
-  pdata->label[IM1] = "1-mom";
-  pdata->label[IM2] = "2-mom";
-  pdata->label[IM3] = "3-mom";
-  if (eos_data.is_ideal) {
-    pdata->label[IEN] = "tot-E";
+void HistoryOutput::LoadOutputData(Mesh *pm) {
+  // the reduction array is sized at compile time, so use the smallest that fits
+  if (nhist_builtin > 0) {
+    if (nhist_builtin <= NREDUCTION_VARIABLES) {
+      SumBuiltinHistoryData<NREDUCTION_VARIABLES>(pm);
+    } else {
+      SumBuiltinHistoryData<3*NHISTORY_VARIABLES>(pm);
+    }
   }
-  pdata->label[nhydro_  ] = "1-KE";
-  pdata->label[nhydro_+1] = "2-KE";
-  pdata->label[nhydro_+2] = "3-KE";
-
-  // capture class variables for kernel
-  auto &u0_ = pm->pmb_pack->phydro->u0;
-  auto &size = pm->pmb_pack->pmb->mb_size;
-  int &nhist_ = pdata->nhist;
-
-  // loop over all MeshBlocks in this pack
-  auto &indcs = pm->pmb_pack->pmesh->mb_indcs;
-  int is = indcs.is; int nx1 = indcs.nx1;
-  int js = indcs.js; int nx2 = indcs.nx2;
-  int ks = indcs.ks; int nx3 = indcs.nx3;
-  const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
-  const int nkji = nx3*nx2*nx1;
-  const int nji  = nx2*nx1;
-  array_sum::GlobalSum sum_this_mb;
-  Kokkos::parallel_reduce("HistSums",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
-    // compute n,k,j,i indices of thread
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/nx1;
-    int i = (idx - m*nkji - k*nji - j*nx1) + is;
-    k += ks;
-    j += js;
-
-    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
-
-    // Hydro conserved variables:
-    array_sum::GlobalSum hvars;
-    hvars.the_array[IDN] = vol*u0_(m,IDN,k,j,i);
-    hvars.the_array[IM1] = vol*u0_(m,IM1,k,j,i);
-    hvars.the_array[IM2] = vol*u0_(m,IM2,k,j,i);
-    hvars.the_array[IM3] = vol*u0_(m,IM3,k,j,i);
-    if (eos_data.is_ideal) {
-      hvars.the_array[IEN] = vol*u0_(m,IEN,k,j,i);
+  for (auto &data : hist_data) {
+    if (data.physics == PhysicsModule::UserDefined) {
+      (pm->pgen->user_hist_func)(&data, pm);
     }
-
-    // Hydro KE
-    hvars.the_array[nhydro_  ] = vol*0.5*SQR(u0_(m,IM1,k,j,i))/u0_(m,IDN,k,j,i);
-    hvars.the_array[nhydro_+1] = vol*0.5*SQR(u0_(m,IM2,k,j,i))/u0_(m,IDN,k,j,i);
-    hvars.the_array[nhydro_+2] = vol*0.5*SQR(u0_(m,IM3,k,j,i))/u0_(m,IDN,k,j,i);
-
-    // fill rest of the_array with zeros, if nhist < NHISTORY_VARIABLES
-    for (int n=nhist_; n<NHISTORY_VARIABLES; ++n) {
-      hvars.the_array[n] = 0.0;
+    if (data.physics == PhysicsModule::MagnetoHydroDynamics && data.nmax > 0) {
+      data.hdata[data.nhist-1] = pm->pmb_pack->pmhd->DivBMax();
     }
-
-    // sum into parallel reduce
-    mb_sum += hvars;
-  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_mb));
-
-  // store data into hdata array
-  for (int n=0; n<pdata->nhist; ++n) {
-    pdata->hdata[n] = sum_this_mb.the_array[n];
   }
 
-  return;
+  // append history data of all modules (one row) to the batch, and start the sum over
+  // ranks once the batch holds buffer_cycles rows
+  for (auto &data : hist_data) {
+    int nsum = data.nhist - data.nmax;
+    hist_sums.insert(hist_sums.end(), data.hdata, data.hdata + nsum);
+    hist_maxs.insert(hist_maxs.end(), data.hdata + nsum, data.hdata + data.nhist);
+  }
+  batch_time.push_back(pm->time);
+  batch_dt.push_back(pm->dt);
+  if (static_cast<int>(batch_time.size()) >= buffer_cycles) {
+    ReduceBatch();
+  }
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void HistoryOutput::LoadZ4cHistoryData()
-//  \brief Compute and store history data over all MeshBlocks on this rank
-//  Data is stored in a Real array defined in derived class.
-
-void HistoryOutput::LoadZ4cHistoryData(HistoryData *pdata, Mesh *pm) {
-  // set number of and names of history variables for z4c
-  pdata->nhist = 8;
-  pdata->label[0] = "H-norm2";
-  pdata->label[1] = "M-norm2";
-  pdata->label[2] = "Mx-norm2";
-  pdata->label[3] = "My-norm2";
-  pdata->label[4] = "Mz-norm2";
-  pdata->label[5] = "Z-norm2";
-  pdata->label[6] = "Theta-norm2";
-  pdata->label[7] = "C-norm2";
-
-  // capture class variabels for kernel
-  auto &u0_ = pm->pmb_pack->pz4c->u0;
-  auto &u_con_ = pm->pmb_pack->pz4c->u_con;
-  const int &I_Z4c_Theta_ =  pm->pmb_pack->pz4c->I_Z4C_THETA;
-
-  auto &size = pm->pmb_pack->pmb->mb_size;
-  int &nhist_ = pdata->nhist;
-
-  // loop over all MeshBlocks in this pack
-  auto &indcs = pm->pmb_pack->pmesh->mb_indcs;
-  int is = indcs.is; int nx1 = indcs.nx1;
-  int js = indcs.js; int nx2 = indcs.nx2;
-  int ks = indcs.ks; int nx3 = indcs.nx3;
-  const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
-  const int nkji = nx3*nx2*nx1;
-  const int nji  = nx2*nx1;
-  array_sum::GlobalSum sum_this_mb;
-  Kokkos::parallel_reduce("HistSums",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
-    // compute n,k,j,i indices of thread
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/nx1;
-    int i = (idx - m*nkji - k*nji - j*nx1) + is;
-    k += ks;
-    j += js;
-
-    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+//! \fn void HistoryOutput::ReduceBatch()
+//  \brief Starts the sum over ranks of all rows of history data in the batch
 
-    // Hydro conserved variables:
-    array_sum::GlobalSum hvars;
-    hvars.the_array[0] = vol*SQR(u_con_(m,0,k,j,i)); // ||H||^2
-    hvars.the_array[1] = vol*u_con_(m,1,k,j,i);      // ||M||^2 (comes already squared)
-    hvars.the_array[2] = vol*SQR(u_con_(m,2,k,j,i)); // ||Mx||^2
-    hvars.the_array[3] = vol*SQR(u_con_(m,3,k,j,i)); // ||My||^2
-    hvars.the_array[4] = vol*u_con_(m,4,k,j,i);      // ||Mz||^2
-    hvars.the_array[5] = vol*u_con_(m,5,k,j,i);      // ||Z||^2 (comes already squared)
-    hvars.the_array[6] = vol*SQR(u0_(m,I_Z4c_Theta_,k,j,i)); // ||Theta||^2
-    hvars.the_array[7] = vol*u_con_(m,6,k,j,i);      // ||C||^2 (comes already squared)
-
-    // fill rest of the_array with zeros, if nhist < NHISTORY_VARIABLES
-    for (int n=nhist_; n<NHISTORY_VARIABLES; ++n) {
-      hvars.the_array[n] = 0.0;
+void HistoryOutput::ReduceBatch() {
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Ireduce(MPI_IN_PLACE, hist_sums.data(), hist_sums.size(), MPI_ATHENA_REAL,
+                MPI_SUM, 0, MPI_COMM_WORLD, &hist_req);
+  } else {
+    MPI_Ireduce(hist_sums.data(), nullptr, hist_sums.size(), MPI_ATHENA_REAL,
+                MPI_SUM, 0, MPI_COMM_WORLD, &hist_req);
+  }
+  if (!(hist_maxs.empty())) {
+    if (global_variable::my_rank == 0) {
+      MPI_Ireduce(MPI_IN_PLACE, hist_maxs.data(), hist_maxs.size(), MPI_ATHENA_REAL,
+                  MPI_MAX, 0, MPI_COMM_WORLD, &max_req);
+    } else {
+      MPI_Ireduce(hist_maxs.data(), nullptr, hist_maxs.size(), MPI_ATHENA_REAL,
+                  MPI_MAX, 0, MPI_COMM_WORLD, &max_req);
     }
-
-    // sum into parallel reduce
-    mb_sum += hvars;
-  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_mb));
-
-  // store data into hdata array
-  for (int n=0; n<pdata->nhist; ++n) {
-    pdata->hdata[n] = sum_this_mb.the_array[n];
   }
-
-  return;
+#endif
+  batch_reducing = true;
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void HistoryOutput::LoadMHDHistoryData()
-//  \brief Compute and store history data over all MeshBlocks on this rank
-//  Data is stored in a Real array defined in derived class.
+//! \fn void HistoryOutput::CompleteWrites()
+//  \brief Reduces and writes rows still buffered in a partial batch (at the end of a run)
 
-void HistoryOutput::LoadMHDHistoryData(HistoryData *pdata, Mesh *pm) {
-  auto &eos_data = pm->pmb_pack->pmhd->peos->eos_data;
-  int &nmhd_ = pm->pmb_pack->pmhd->nmhd;
+void HistoryOutput::CompleteWrites() {
+  if (!batch_time.empty()) {
+    if (!batch_reducing) ReduceBatch();
+    WriteBatch();
+  }
+}
 
-  // set number of and names of history variables for mhd
-  if (eos_data.is_ideal) {
-    pdata->nhist = 11;
-  } else {
-    pdata->nhist = 10;
+//----------------------------------------------------------------------------------------
+//! \fn void HistoryOutput::SumBuiltinHistoryData()
+//  \brief Computes the volume integrals of the built-in history variables of hydro, MHD
+//  and Z4c over all MeshBlocks on this rank in one pass, as a reduction over N sums
+//  (N >= nhist_builtin), and stores them in the hdata arrays of the modules.
+
+template <int N>
+void HistoryOutput::SumBuiltinHistoryData(Mesh *pm) {
+  using HistSum = array_sum::array_type<Real,N>;
+  auto pmbp = pm->pmb_pack;
+
+  // capture variables of modules in use for kernel (left empty otherwise)
+  int ihyd_ = ihydro, imhd_ = imhd, iz4c_ = iz4c;
+  bool hyd_ideal = false, mhd_ideal = false;
+  DvceArray5D<Real> hyd_u0, mhd_u0, z4c_u0, z4c_ucon;
+  DvceArray5D<float> z4c_ucon_f;
+  bool con_float = false;
+  DvceArray4D<Real> bx1f, bx2f, bx3f;
+  int I_Z4c_Theta_ = 0;
+  int st = 1;
+  if (ihydro >= 0) {
+    hyd_u0 = pmbp->phydro->u0;
+    hyd_ideal = pmbp->phydro->peos->eos_data.is_ideal;
   }
-  pdata->label[IDN] = "mass";
-  pdata->label[IM1] = "1-mom";
-  pdata->label[IM2] = "2-mom";
-  pdata->label[IM3] = "3-mom";
-  if (eos_data.is_ideal) {
-    pdata->label[IEN] = "tot-E";
+  if (imhd >= 0) {
+    mhd_u0 = pmbp->pmhd->u0;
+    bx1f = pmbp->pmhd->b0.x1f;
+    bx2f = pmbp->pmhd->b0.x2f;
+    bx3f = pmbp->pmhd->b0.x3f;
+    mhd_ideal = pmbp->pmhd->peos->eos_data.is_ideal;
   }
-  pdata->label[nmhd_  ] = "1-KE";
-  pdata->label[nmhd_+1] = "2-KE";
-  pdata->label[nmhd_+2] = "3-KE";
-  pdata->label[nmhd_+3] = "1-ME";
-  pdata->label[nmhd_+4] = "2-ME";
-  pdata->label[nmhd_+5] = "3-ME";
-
-  // capture class variabels for kernel
-  auto &u0_ = pm->pmb_pack->pmhd->u0;
-  auto &bx1f = pm->pmb_pack->pmhd->b0.x1f;
-  auto &bx2f = pm->pmb_pack->pmhd->b0.x2f;
-  auto &bx3f = pm->pmb_pack->pmhd->b0.x3f;
-  auto &size = pm->pmb_pack->pmb->mb_size;
-  int &nhist_ = pdata->nhist;
+  if (iz4c >= 0) {
+    z4c_u0 = pmbp->pz4c->u0;
+    z4c_ucon = pmbp->pz4c->u_con;
+    z4c_ucon_f = pmbp->pz4c->u_con_f;
+    con_float = pmbp->pz4c->opt.con_float;
+    I_Z4c_Theta_ = pmbp->pz4c->I_Z4C_THETA;
+    // constraints are only computed on every con_stride-th cell in each direction
+    st = pmbp->pz4c->opt.con_stride;
+  }
+  auto &size = pmbp->pmb->mb_size;
 
   // loop over all MeshBlocks in this pack
-  auto &indcs = pm->pmb_pack->pmesh->mb_indcs;
+  auto &indcs = pm->mb_indcs;
   int is = indcs.is; int nx1 = indcs.nx1;
   int js = indcs.js; int nx2 = indcs.nx2;
   int ks = indcs.ks; int nx3 = indcs.nx3;
-  const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nmkji = (pmbp->nmb_thispack)*nx3*nx2*nx1;
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
-  array_sum::GlobalSum sum_this_mb;
+  // each sampled constraint stands for the cells of the MeshBlock divided by the number
+  // sampled, (nx-1)/st+1 in each direction (st need not divide nx)
+  Real cfac = static_cast<Real>(nkji)/
+              (((nx1 - 1)/st + 1)*((nx2 - 1)/st + 1)*((nx3 - 1)/st + 1));
+  HistSum sum_this_mb;
   Kokkos::parallel_reduce("HistSums",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
+  KOKKOS_LAMBDA(const int &idx, HistSum &mb_sum) {
     // compute n,k,j,i indices of thread
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
@@ -284,62 +267,99 @@ void HistoryOutput::LoadMHDHistoryData(HistoryData *pdata, Mesh *pm) {
     j += js;
 
     Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
-
-    // MHD conserved variables:
-    array_sum::GlobalSum hvars;
-    hvars.the_array[IDN] = vol*u0_(m,IDN,k,j,i);
-    hvars.the_array[IM1] = vol*u0_(m,IM1,k,j,i);
-    hvars.the_array[IM2] = vol*u0_(m,IM2,k,j,i);
-    hvars.the_array[IM3] = vol*u0_(m,IM3,k,j,i);
-    if (eos_data.is_ideal) {
-      hvars.the_array[IEN] = vol*u0_(m,IEN,k,j,i);
+    HistSum hvars;
+
+    // Hydro conserved variables and KE
+    if (ihyd_ >= 0) {
+      Real *h = &(hvars.the_array[ihyd_]);
+      h[IDN] = vol*hyd_u0(m,IDN,k,j,i);
+      h[IM1] = vol*hyd_u0(m,IM1,k,j,i);
+      h[IM2] = vol*hyd_u0(m,IM2,k,j,i);
+      h[IM3] = vol*hyd_u0(m,IM3,k,j,i);
+      int nf = 4;
+      if (hyd_ideal) {
+        h[IEN] = vol*hyd_u0(m,IEN,k,j,i);
+        nf = 5;
+      }
+      h[nf  ] = vol*0.5*SQR(hyd_u0(m,IM1,k,j,i))/hyd_u0(m,IDN,k,j,i);
+      h[nf+1] = vol*0.5*SQR(hyd_u0(m,IM2,k,j,i))/hyd_u0(m,IDN,k,j,i);
+      h[nf+2] = vol*0.5*SQR(hyd_u0(m,IM3,k,j,i))/hyd_u0(m,IDN,k,j,i);
     }
 
-    // MHD KE
-    hvars.the_array[nmhd_  ] = vol*0.5*SQR(u0_(m,IM1,k,j,i))/u0_(m,IDN,k,j,i);
-    hvars.the_array[nmhd_+1] = vol*0.5*SQR(u0_(m,IM2,k,j,i))/u0_(m,IDN,k,j,i);
-    hvars.the_array[nmhd_+2] = vol*0.5*SQR(u0_(m,IM3,k,j,i))/u0_(m,IDN,k,j,i);
-
-    // MHD ME
-    hvars.the_array[nmhd_+3] = vol*0.25*(SQR(bx1f(m,k,j,i+1)) + SQR(bx1f(m,k,j,i)));
-    hvars.the_array[nmhd_+4] = vol*0.25*(SQR(bx2f(m,k,j+1,i)) + SQR(bx2f(m,k,j,i)));
-    hvars.the_array[nmhd_+5] = vol*0.25*(SQR(bx3f(m,k+1,j,i)) + SQR(bx3f(m,k,j,i)));
+    // MHD conserved variables, KE and ME
+    if (imhd_ >= 0) {
+      Real *h = &(hvars.the_array[imhd_]);
+      h[IDN] = vol*mhd_u0(m,IDN,k,j,i);
+      h[IM1] = vol*mhd_u0(m,IM1,k,j,i);
+      h[IM2] = vol*mhd_u0(m,IM2,k,j,i);
+      h[IM3] = vol*mhd_u0(m,IM3,k,j,i);
+      int nf = 4;
+      if (mhd_ideal) {
+        h[IEN] = vol*mhd_u0(m,IEN,k,j,i);
+        nf = 5;
+      }
+      h[nf  ] = vol*0.5*SQR(mhd_u0(m,IM1,k,j,i))/mhd_u0(m,IDN,k,j,i);
+      h[nf+1] = vol*0.5*SQR(mhd_u0(m,IM2,k,j,i))/mhd_u0(m,IDN,k,j,i);
+      h[nf+2] = vol*0.5*SQR(mhd_u0(m,IM3,k,j,i))/mhd_u0(m,IDN,k,j,i);
+      h[nf+3] = vol*0.25*(SQR(bx1f(m,k,j,i+1)) + SQR(bx1f(m,k,j,i)));
+      h[nf+4] = vol*0.25*(SQR(bx2f(m,k,j+1,i)) + SQR(bx2f(m,k,j,i)));
+      h[nf+5] = vol*0.25*(SQR(bx3f(m,k+1,j,i)) + SQR(bx3f(m,k,j,i)));
+    }
 
-    // fill rest of the_array with zeros, if nhist < NHISTORY_VARIABLES
-    for (int n=nhist_; n<NHISTORY_VARIABLES; ++n) {
-      hvars.the_array[n] = 0.0;
+    // Z4c constraint norms
+    if (iz4c_ >= 0) {
+      Real *h = &(hvars.the_array[iz4c_]);
+      Real cvol = vol*cfac;
+      Real c[7];
+      for (int n=0; n<7; ++n) {
+        c[n] = (con_float)? static_cast<Real>(z4c_ucon_f(m,n,k,j,i)) :
+                            z4c_ucon(m,n,k,j,i);
+      }
+      h[0] = cvol*SQR(c[0]);                           // ||H||^2
+      h[1] = cvol*c[1];                                // ||M||^2 (comes already squared)
+      h[2] = cvol*SQR(c[2]);                           // ||Mx||^2
+      h[3] = cvol*SQR(c[3]);                           // ||My||^2
+      h[4] = cvol*c[4];                                // ||Mz||^2
+      h[5] = cvol*c[5];                                // ||Z||^2 (comes already squared)
+      h[6] = vol*SQR(z4c_u0(m,I_Z4c_Theta_,k,j,i));    // ||Theta||^2
+      h[7] = cvol*c[6];                                // ||C||^2 (comes already squared)
     }
 
     // sum into parallel reduce
     mb_sum += hvars;
-  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_mb));
-  Kokkos::fence();
+  }, Kokkos::Sum<HistSum>(sum_this_mb));
 
-  // store data into hdata array
-  for (int n=0; n<pdata->nhist; ++n) {
-    pdata->hdata[n] = sum_this_mb.the_array[n];
+  // store data into hdata arrays of each module
+  for (auto &data : hist_data) {
+    int ioff = -1;
+    if (data.physics == PhysicsModule::HydroDynamics) ioff = ihydro;
+    if (data.physics == PhysicsModule::MagnetoHydroDynamics) ioff = imhd;
+    if (data.physics == PhysicsModule::SpaceTimeDynamics) ioff = iz4c;
+    if (ioff < 0) continue;
+    for (int n=0; n<data.nhist; ++n) {
+      data.hdata[n] = sum_this_mb.the_array[ioff + n];
+    }
   }
-
-  return;
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void HistoryOutput::WriteOutputFile()
-//  \brief Cycles through hist_data vector and writes history file for each component
+//! \fn void HistoryOutput::WriteBatch()
+//  \brief Completes the sum over ranks started by ReduceBatch(), then cycles through
+//  hist_data vector and appends all rows of the batch to the history file of each
+//  component
 
-void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
-  for (auto &data : hist_data) {
-    // first, perform in-place sum over all MPI ranks
+void HistoryOutput::WriteBatch() {
+  // first, complete sum over all MPI ranks
 #if MPI_PARALLEL_ENABLED
-    if (global_variable::my_rank == 0) {
-      MPI_Reduce(MPI_IN_PLACE, &(data.hdata[0]), data.nhist, MPI_ATHENA_REAL,
-         MPI_SUM, 0, MPI_COMM_WORLD);
-    } else {
-      MPI_Reduce(&(data.hdata[0]), &(data.hdata[0]), data.nhist,
-         MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
-    }
+  MPI_Wait(&hist_req, MPI_STATUS_IGNORE);
+  MPI_Wait(&max_req, MPI_STATUS_IGNORE);
 #endif
+  int nrows = batch_time.size();
+  std::size_t row_size = hist_sums.size()/nrows;
+  std::size_t max_row_size = hist_maxs.size()/nrows;
 
+  std::size_t ioff = 0, moff = 0;
+  for (auto &data : hist_data) {
     // only the master rank writes the file
     if (global_variable::my_rank == 0) {
       // create filename: "file_basename" + ".physics" + ".hst"
@@ -384,16 +404,43 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
         data.header_written = true;
       }
 
-      // write history variables
-      std::fprintf(pfile, out_params.data_format.c_str(), pm->time);
-      std::fprintf(pfile, out_params.data_format.c_str(), pm->dt);
-      for (int n=0; n<data.nhist; ++n)
-        std::fprintf(pfile, out_params.data_format.c_str(), data.hdata[n]);
-      std::fprintf(pfile,"\n"); // terminate line
+      // write history variables of each row
+      int nsum = data.nhist - data.nmax;
+      for (int r=0; r<nrows; ++r) {
+        const Real *row = &(hist_sums[r*row_size + ioff]);
+        std::fprintf(pfile, out_params.data_format.c_str(), batch_time[r]);
+        std::fprintf(pfile, out_params.data_format.c_str(), batch_dt[r]);
+        for (int n=0; n<nsum; ++n)
+          std::fprintf(pfile, out_params.data_format.c_str(), row[n]);
+        for (int n=0; n<data.nmax; ++n)
+          std::fprintf(pfile, out_params.data_format.c_str(),
+                       hist_maxs[r*max_row_size + moff + n]);
+        std::fprintf(pfile,"\n"); // terminate line
+      }
       std::fclose(pfile);
     }
+    ioff += data.nhist - data.nmax;
+    moff += data.nmax;
   } // End loop over hist_data vector
 
+  hist_sums.clear();
+  hist_maxs.clear();
+  batch_time.clear();
+  batch_dt.clear();
+  batch_reducing = false;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HistoryOutput::WriteOutputFile()
+//  \brief Writes the batch of history data once it is being reduced, i.e. every
+//  buffer_cycles outputs.  Buffered rows are lost if the run stops abnormally before
+//  they are written.
+
+void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  if (batch_reducing) {
+    WriteBatch();
+  }
+
   // increment counters, clean up
   if (out_params.last_time < 0.0) {
     out_params.last_time = pm->time;
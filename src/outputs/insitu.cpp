@@ -0,0 +1,212 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file insitu.cpp
+//! \brief in-situ visualization and analysis with Ascent.  On the cadence of the
+//! <output> block, the output variables (any of those of other outputs, e.g. hydro_u,
+//! mhd_w_bcc, rad_coord or z4c) are published to Ascent as a Conduit Blueprint mesh with
+//! one uniform domain per MeshBlock, which then renders images, extracts or reductions as
+//! specified by an actions file, so no raw data is written.
+//!
+//! Fields are passed zero-copy: each points directly into the (device) array holding the
+//! variable, including ghost cells, which are flagged with the standard "ascent_ghosts"
+//! field.  The state of each domain holds the gid, level and logical location of the
+//! MeshBlock.  With device_pointers=false, device arrays are copied to host first (a
+//! no-op for host backends), for Ascent builds without device support.
+//!
+//! Optional parameters in the <output> block:
+//!  - actions_file:    Ascent actions file (default: "ascent_actions.yaml")
+//!  - device_pointers: pass device arrays to Ascent (default: true)
+
+#include <sys/stat.h>  // mkdir
+
+#include <cstdint>
+#include <cstdio>      // snprintf()
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+
+#if INSITU_ENABLED
+#include <ascent.hpp>
+#endif
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+InSituOutput::InSituOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+#if INSITU_ENABLED
+  if (op.slice1 || op.slice2 || op.slice3 || op.region || op.gid >= 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Slices, regions and gid are not supported by insitu "
+              << "output in <" << op.block_name << ">" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  actions_file = pin->GetOrAddString(op.block_name, "actions_file",
+                                     "ascent_actions.yaml");
+  device_pointers = pin->GetOrAddBoolean(op.block_name, "device_pointers", true);
+  // create new directory for images and extracts
+  mkdir("insitu",0775);
+
+  conduit::Node opts;
+#if MPI_PARALLEL_ENABLED
+  opts["mpi_comm"] = MPI_Comm_c2f(MPI_COMM_WORLD);
+#endif
+  opts["actions_file"] = actions_file;
+  opts["default_dir"] = "insitu";
+  pascent = new ascent::Ascent();
+  pascent->open(opts);
+#else
+  std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+            << "file_type=insitu in <" << op.block_name << "> requires Ascent, so "
+            << "configure with -D Athena_ENABLE_ASCENT=ON" << std::endl;
+  std::exit(EXIT_FAILURE);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// destructor: closes Ascent, which must happen before MPI is finalized
+
+InSituOutput::~InSituOutput() {
+#if INSITU_ENABLED
+  pascent->close();
+  delete pascent;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InSituOutput::LoadOutputData()
+//! \brief Computes derived variables, if any, and copies the arrays holding the output
+//! variables to host if device pointers are not passed to Ascent.  Unlike other outputs,
+//! no data is gathered into outarray.
+
+void InSituOutput::LoadOutputData(Mesh *pm) {
+  if (out_params.contains_derived) {
+    LoadDerivedVariables(pm);
+  }
+
+  // flags of ghost cells, the same on every MeshBlock
+  auto &indcs = pm->mb_indcs;
+  int nc1 = indcs.nx1 + 2*indcs.ng;
+  int nc2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*indcs.ng) : 1;
+  int nc3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*indcs.ng) : 1;
+  if (ghosts.extent_int(0) != nc3*nc2*nc1) {
+    ghosts.realloc(nc3*nc2*nc1);
+    int is = indcs.is, ie = indcs.ie, js = indcs.js, je = indcs.je;
+    int ks = indcs.ks, ke = indcs.ke;
+    bool multi_d = pm->multi_d, three_d = pm->three_d;
+    auto &ghosts_ = ghosts;
+    par_for("insitu_ghosts",DevExeSpace(),0,(nc3-1),0,(nc2-1),0,(nc1-1),
+    KOKKOS_LAMBDA(const int k, const int j, const int i) {
+      bool ghost = (i < is || i > ie) || (multi_d && (j < js || j > je)) ||
+                   (three_d && (k < ks || k > ke));
+      ghosts_.d_view(k*nc2*nc1 + j*nc1 + i) = (ghost)? 1 : 0;
+    });
+    ghosts.template modify<DevExeSpace>();
+    ghosts.template sync<HostMemSpace>();
+  }
+
+  if (!(device_pointers)) {
+    for (auto &var : outvars) {
+      auto &h = host_data[var.data_ptr];
+      if (h.size() != var.data_ptr->size() ||
+          h.extent_int(0) != var.data_ptr->extent_int(0)) {
+        h = Kokkos::create_mirror_view(*(var.data_ptr));
+      }
+      Kokkos::deep_copy(h, *(var.data_ptr));
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InSituOutput::WriteOutputFile()
+//! \brief Describes all MeshBlocks of this rank as a Conduit Blueprint multi-domain mesh
+//! pointing at the output variables, and publishes it to Ascent, which executes the
+//! actions of the actions file.
+
+void InSituOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+#if INSITU_ENABLED
+  auto &indcs = pm->mb_indcs;
+  int ng = indcs.ng;
+  int nc1 = indcs.nx1 + 2*ng;
+  int nc2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int nc3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  std::size_t ncells = static_cast<std::size_t>(nc3)*nc2*nc1;
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  int *ghost_ptr = (device_pointers)? ghosts.d_view.data() : ghosts.h_view.data();
+
+  conduit::Node mesh;
+  for (int m=0; m<(pm->pmb_pack->nmb_thispack); ++m) {
+    int gid = pm->pmb_pack->pmb->mb_gid.h_view(m);
+    LogicalLocation &lloc = pm->lloc_eachmb[gid];
+    char name[16];
+    std::snprintf(name, sizeof(name), "domain_%06d", gid);
+    conduit::Node &dom = mesh[name];
+    dom["state/time"] = static_cast<double>(pm->time);
+    dom["state/cycle"] = pm->ncycle;
+    dom["state/domain_id"] = gid;
+    dom["state/level"] = lloc.level - pm->root_level;
+    int64_t loc[3] = {lloc.lx1, lloc.lx2, lloc.lx3};
+    dom["state/logical_location"].set(loc, 3);
+
+    // uniform grid of all cells of MeshBlock, including ghost cells
+    auto &mbs = size.h_view(m);
+    dom["coordsets/coords/type"] = "uniform";
+    dom["coordsets/coords/dims/i"] = nc1 + 1;
+    dom["coordsets/coords/origin/x"] = static_cast<double>(mbs.x1min - ng*mbs.dx1);
+    dom["coordsets/coords/spacing/dx"] = static_cast<double>(mbs.dx1);
+    if (nc2 > 1) {
+      dom["coordsets/coords/dims/j"] = nc2 + 1;
+      dom["coordsets/coords/origin/y"] = static_cast<double>(mbs.x2min - ng*mbs.dx2);
+      dom["coordsets/coords/spacing/dy"] = static_cast<double>(mbs.dx2);
+    }
+    if (nc3 > 1) {
+      dom["coordsets/coords/dims/k"] = nc3 + 1;
+      dom["coordsets/coords/origin/z"] = static_cast<double>(mbs.x3min - ng*mbs.dx3);
+      dom["coordsets/coords/spacing/dz"] = static_cast<double>(mbs.dx3);
+    }
+    dom["topologies/mesh/type"] = "uniform";
+    dom["topologies/mesh/coordset"] = "coords";
+
+    // fields point at variable v of MeshBlock m, which is contiguous in (m,v,k,j,i)
+    for (auto &var : outvars) {
+      Real *data = (device_pointers)? var.data_ptr->data()
+                                    : host_data[var.data_ptr].data();
+      std::size_t offset =
+          (static_cast<std::size_t>(m)*var.data_ptr->extent(1) + var.data_index)*ncells;
+      conduit::Node &field = dom["fields/" + var.label];
+      field["association"] = "element";
+      field["topology"] = "mesh";
+      field["values"].set_external(data + offset, ncells);
+    }
+    conduit::Node &field = dom["fields/ascent_ghosts"];
+    field["association"] = "element";
+    field["topology"] = "mesh";
+    field["values"].set_external(ghost_ptr, ncells);
+  }
+
+  pascent->publish(mesh);
+  conduit::Node actions;   // actions are read from actions_file
+  pascent->execute(actions);
+#endif
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+
+  return;
+}
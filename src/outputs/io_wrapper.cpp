@@ -17,6 +17,8 @@
 #include "athena.hpp"
 #include "io_wrapper.hpp"
 
+IOWrapperSizeT IOWrapper::nbytes_written = 0;
+
 //----------------------------------------------------------------------------------------
 //! \fn int IOWrapper::Open(const char* fname, FileMode rw)
 //! \brief wrapper for {MPI_File_open} versus {std::fopen} including error check
@@ -296,8 +298,10 @@ std::size_t IOWrapper::Write_any_type(const void *buf, IOWrapperSizeT cnt,
     Kokkos::printf("%.*s\n", resultlen, msg);
     return 0;
   }
-  int nwrite;
+  int nwrite, tsize;
   if (MPI_Get_count(&status, mpitype, &nwrite) == MPI_UNDEFINED) {return 0;}
+  MPI_Type_size(mpitype, &tsize);
+  nbytes_written += static_cast<IOWrapperSizeT>(nwrite)*tsize;
   return nwrite;
 #else
   // set appropriate datasize
@@ -318,7 +322,9 @@ std::size_t IOWrapper::Write_any_type(const void *buf, IOWrapperSizeT cnt,
     std::exit(EXIT_FAILURE);
   }
   // Write data using standard C functions
-  return std::fwrite(buf,datasize,cnt,fh_);
+  std::size_t nwrite = std::fwrite(buf,datasize,cnt,fh_);
+  nbytes_written += nwrite*datasize;
+  return nwrite;
 #endif
 }
 
@@ -359,8 +365,10 @@ std::size_t IOWrapper::Write_any_type_at(const void *buf, IOWrapperSizeT cnt,
     Kokkos::printf("%.*s\n", resultlen, msg);
     return 0;
   }
-  int nwrite;
+  int nwrite, tsize;
   if (MPI_Get_count(&status, mpitype, &nwrite) == MPI_UNDEFINED) {return 0;}
+  MPI_Type_size(mpitype, &tsize);
+  nbytes_written += static_cast<IOWrapperSizeT>(nwrite)*tsize;
   return nwrite;
 #else
   // set appropriate datasize
@@ -382,7 +390,9 @@ std::size_t IOWrapper::Write_any_type_at(const void *buf, IOWrapperSizeT cnt,
   }
   // Write data using standard C functions
   std::fseek(fh_, offset, SEEK_SET);
-  return std::fwrite(buf,datasize,cnt,fh_);
+  std::size_t nwrite = std::fwrite(buf,datasize,cnt,fh_);
+  nbytes_written += nwrite*datasize;
+  return nwrite;
 #endif
 }
 
@@ -423,8 +433,10 @@ std::size_t IOWrapper::Write_any_type_at_all(const void *buf, IOWrapperSizeT cnt
     Kokkos::printf("%.*s\n", resultlen, msg);
     return 0;
   }
-  int nwrite;
-  if (MPI_Get_count(&status,mpitype,&nwrite) == MPI_UNDEFINED) {return 0;}
+  int nwrite, tsize;
+  if (MPI_Get_count(&status, mpitype, &nwrite) == MPI_UNDEFINED) {return 0;}
+  MPI_Type_size(mpitype, &tsize);
+  nbytes_written += static_cast<IOWrapperSizeT>(nwrite)*tsize;
   return nwrite;
 #else
   // set appropriate datasize
@@ -446,7 +458,54 @@ std::size_t IOWrapper::Write_any_type_at_all(const void *buf, IOWrapperSizeT cnt
   }
   // Write data using standard C functions
   std::fseek(fh_, offset, SEEK_SET);
-  return std::fwrite(buf,datasize,cnt,fh_);
+  std::size_t nwrite = std::fwrite(buf,datasize,cnt,fh_);
+  nbytes_written += nwrite*datasize;
+  return nwrite;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void IOWrapper::Iwrite_bytes_at_all()
+//! \brief wrapper for {MPI_File_iwrite_at_all} versus {std::fseek+std::fwrite}.  With
+//! MPI the write is only started, and buf must be left untouched until Wait() or Close()
+//! is called.  Without MPI the data is written immediately.
+
+void IOWrapper::Iwrite_bytes_at_all(const void *buf, IOWrapperSizeT cnt,
+                                    IOWrapperSizeT offset) {
+#if MPI_PARALLEL_ENABLED
+  Wait();
+  int errcode = MPI_File_iwrite_at_all(fh_, offset, buf, cnt, MPI_BYTE, &req_);
+  nbytes_written += cnt;
+  if (errcode != MPI_SUCCESS) {
+    char msg[MPI_MAX_ERROR_STRING];
+    int resultlen;
+    MPI_Error_string(errcode, msg, &resultlen);
+    Kokkos::printf("%.*s\n", resultlen, msg);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Non-blocking write could not be started" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#else
+  if (Write_any_type_at(buf, cnt, offset, "byte") != cnt) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Data not written correctly to file" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int IOWrapper::Wait()
+//! \brief wrapper for {MPI_Wait} on the pending non-blocking write (no-op in serial)
+
+int IOWrapper::Wait() {
+#if MPI_PARALLEL_ENABLED
+  if (req_ == MPI_REQUEST_NULL) return MPI_SUCCESS;
+  return MPI_Wait(&req_, MPI_STATUS_IGNORE);
+#else
+  return 0;
 #endif
 }
 
@@ -456,6 +515,7 @@ std::size_t IOWrapper::Write_any_type_at_all(const void *buf, IOWrapperSizeT cnt
 
 int IOWrapper::Close() {
 #if MPI_PARALLEL_ENABLED
+  Wait();
   return MPI_File_close(&fh_);
 #else
   return std::fclose(fh_);
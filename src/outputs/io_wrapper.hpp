@@ -24,7 +24,7 @@ using IOWrapperSizeT = std::uint64_t;
 class IOWrapper {
  public:
 #if MPI_PARALLEL_ENABLED
-  IOWrapper() : fh_(nullptr), comm_(MPI_COMM_WORLD) {}
+  IOWrapper() : fh_(nullptr), comm_(MPI_COMM_WORLD), req_(MPI_REQUEST_NULL) {}
   void SetCommunicator(MPI_Comm scomm) { comm_=scomm;}
 #else
   IOWrapper() {fh_=nullptr;}
@@ -45,6 +45,9 @@ class IOWrapper {
                                 IOWrapperSizeT offset, std::string type);
   std::size_t Write_any_type_at_all(const void *buf, IOWrapperSizeT count,
                                     IOWrapperSizeT offset, std::string type);
+  // non-blocking collective write of bytes; buf must not be modified before Wait()
+  void Iwrite_bytes_at_all(const void *buf, IOWrapperSizeT count, IOWrapperSizeT offset);
+  int Wait();
   std::size_t Read_Reals(void *buf, IOWrapperSizeT count);
   std::size_t Read_Reals_at(void *buf, IOWrapperSizeT count, IOWrapperSizeT offset);
   std::size_t Read_Reals_at_all(void *buf, IOWrapperSizeT count, IOWrapperSizeT offset);
@@ -52,10 +55,14 @@ class IOWrapper {
   int Seek(IOWrapperSizeT offset);
   IOWrapperSizeT GetPosition();
 
+  // bytes written by this rank through any IOWrapper (or HDF5 dataset) over the run
+  static IOWrapperSizeT nbytes_written;
+
  private:
   IOWrapperFile fh_;
 #if MPI_PARALLEL_ENABLED
   MPI_Comm comm_;
+  MPI_Request req_;   // pending non-blocking write, if any
 #endif
 };
 #endif // OUTPUTS_IO_WRAPPER_HPP_
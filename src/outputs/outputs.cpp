@@ -18,7 +18,7 @@
 //! Required parameters that must be specified in an <output[n]> block are:
 //!   - variable  = [list of currently implemented strings for specifing output variables
 //!                  is defined at start of outputs.hpp file]
-//!   - file_type = tab,vtk,hst,bin,rst
+//!   - file_type = tab,vtk,vtkhdf,hst,bin,hdf5,spec,insitu,rst
 //!   - dt        = problem time between outputs
 //!
 //! EXAMPLE of an <output[n]> block for a TAB dump:
@@ -30,6 +30,13 @@
 //!   slice_x2    = 0.0       # slice at x2
 //!   slice_x3    = 0.0       # slice at x3
 //!
+//! Outputs of MeshBlocks (e.g. bin, hdf5, tab) can be restricted to those overlapping a
+//! region of interest with any of region_x1min, region_x1max, ..., region_x3max.
+//!
+//! If outputs use more than the fraction <time>/io_budget of the wall time, outputs with
+//! essential=false (the default except for hst, log and rst outputs) are skipped until
+//! the fraction falls below the budget.  Restart outputs are never skipped.
+//!
 //! Each <output[n]> block will result in a new node being created in a linked list of
 //! BaseTypeOutput stored in the Outputs class.  During a simulation, outputs are made
 //! when the simulation time satisfies the criteria implemented in the Driver class.
@@ -46,16 +53,19 @@
 #include <iostream>
 #include <sstream>
 #include <string>   // std::string, to_string()
+#include <vector>
 
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs.hpp"
+#include "utils/memory_tracker.hpp"
 
 //----------------------------------------------------------------------------------------
 // Outputs constructor
 
 Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
+  memory_tracker::Scope scope(memory_tracker::Owner::outputs);
   // loop over input block names.  Find those that start with "output", read parameters,
   // and add to linked list of BaseTypeOutputs.
 
@@ -161,6 +171,31 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
         opar.slice3 = false;
       }
 
+      // read region of interest, if specified.  Only MeshBlocks that overlap the region
+      // are output, so this is only supported by outputs that store MeshBlocks
+      opar.region = false;
+      const char *region_par[6] = {"region_x1min", "region_x1max", "region_x2min",
+                                   "region_x2max", "region_x3min", "region_x3max"};
+      Real region_def[6] = {pm->mesh_size.x1min, pm->mesh_size.x1max,
+                            pm->mesh_size.x2min, pm->mesh_size.x2max,
+                            pm->mesh_size.x3min, pm->mesh_size.x3max};
+      Real *region_val[6] = {&opar.region_x1min, &opar.region_x1max, &opar.region_x2min,
+                             &opar.region_x2max, &opar.region_x3min, &opar.region_x3max};
+      for (int n=0; n<6; ++n) {
+        *region_val[n] = region_def[n];
+        if (pin->DoesParameterExist(opar.block_name, region_par[n])) {
+          *region_val[n] = pin->GetReal(opar.block_name, region_par[n]);
+          opar.region = true;
+        }
+      }
+      if (opar.region && (opar.file_type.compare("vtk") == 0 ||
+                          opar.file_type.compare("pvtk") == 0)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "Region of interest in output block '" << opar.block_name
+            << "' is not supported by vtk outputs" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+
       // read ghost cell option
       opar.include_gzs = pin->GetOrAddBoolean(opar.block_name, "ghost_zones", false);
 
@@ -218,6 +253,13 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
       opar.data_format = pin->GetOrAddString(opar.block_name, "data_format", "%12.5e");
       opar.data_format.insert(0, " "); // prepend with blank to separate columns
 
+      // set whether output may be skipped when outputs exceed their wall time budget
+      bool essential = (opar.file_type.compare("hst") == 0 ||
+                        opar.file_type.compare("log") == 0 ||
+                        opar.file_type.compare("rst") == 0);
+      opar.essential = pin->GetOrAddBoolean(opar.block_name, "essential", essential);
+      if (opar.file_type.compare("rst") == 0) {opar.essential = true;}
+
       // Construct new BaseTypeOutput according to file format
       // NEW_OUTPUT_TYPES: Add block to construct new types here
       BaseTypeOutput *pnode;
@@ -272,6 +314,18 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
       } else if (opar.file_type.compare("bin") == 0) {
         pnode = new MeshBinaryOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("hdf5") == 0) {
+        pnode = new MeshHDF5Output(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("vtkhdf") == 0) {
+        pnode = new MeshVTKHDFOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("spec") == 0) {
+        pnode = new SpectrumOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("insitu") == 0) {
+        pnode = new InSituOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
       } else if (opar.file_type.compare("rst") == 0) {
       // Add restarts to the tail end of BaseTypeOutput list, so file counters for other
       // output types are up-to-date in restart file
@@ -294,6 +348,12 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
               << "input file" << std::endl;
     exit(EXIT_FAILURE);
   }
+
+  // an event log with io_profile=true reports the timing of all outputs
+  for (BaseTypeOutput* pnode : pout_list) {
+    EventLogOutput *plog = dynamic_cast<EventLogOutput*>(pnode);
+    if (plog != nullptr && plog->io_profile) {plog->pprofiled = &pout_list;}
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -305,4 +365,35 @@ Outputs::~Outputs() {
     delete pnode;
   }
   pout_list.clear();
+  // device arrays must be freed before Kokkos is finalized
+  BaseTypeOutput::derived_cache.clear();
+  CoarsenedBinaryOutput::cascades.clear();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Outputs::ReduceIOProfile()
+//  \brief Stores (calls, load time, write time, bytes) of each output in list into
+//  consecutive elements of stats.  Times are the maximum over MPI ranks (the slowest rank
+//  sets the time of a collective output), bytes are the sum over ranks.  Must be called
+//  by all ranks.
+
+void Outputs::ReduceIOProfile(const std::vector<BaseTypeOutput*> &list,
+                              std::vector<double> &stats) {
+  int nout = list.size();
+  stats.assign(4*nout, 0.0);
+  std::vector<double> nbytes(nout);
+  for (int n=0; n<nout; ++n) {
+    stats[4*n    ] = static_cast<double>(list[n]->ncalls);
+    stats[4*n + 1] = list[n]->load_time;
+    stats[4*n + 2] = list[n]->write_time;
+    nbytes[n] = static_cast<double>(list[n]->nbytes);
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, stats.data(), 4*nout, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, nbytes.data(), nout, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  for (int n=0; n<nout; ++n) {
+    stats[4*n + 3] = nbytes[n];
+  }
+  return;
 }
@@ -8,20 +8,25 @@
 //! \file outputs.hpp
 //  \brief provides classes to handle ALL types of data output
 
+#include <deque>
+#include <map>
 #include <string>
+#include <thread>
 #include <vector>
 
-#include "Kokkos_ScatterView.hpp"
-
 #include "athena.hpp"
 #include "io_wrapper.hpp"
 
+#if INSITU_ENABLED
+namespace ascent {class Ascent;}
+#endif
+
 #define NHISTORY_VARIABLES 12
 #if NHISTORY_VARIABLES > NREDUCTION_VARIABLES
     #error NHISTORY > NREDUCTION in outputs.hpp
 #endif
 
-#define NOUTPUT_CHOICES 152
+#define NOUTPUT_CHOICES 153
 // choices for output variables used in <ouput> blocks in input file
 // TO ADD MORE CHOICES:
 //   - add more strings to array below, change NOUTPUT_CHOICES above appropriately
@@ -95,8 +100,8 @@ static const char *var_choice[NOUTPUT_CHOICES] = {
   "tmunu_Sx", "tmunu_Sy", "tmunu_Sz",
   "tmunu",
 
-  // Particles (150-151)
-  "prtcl_all", "prtcl_d"
+  // Particles (150-152)
+  "prtcl_all", "prtcl_d", "prtcl_mom"
 };
 
 
@@ -123,6 +128,9 @@ struct OutputParameters {
   int gid;
   bool slice1, slice2, slice3;
   Real slice_x1, slice_x2, slice_x3;
+  bool region;                // only output MeshBlocks overlapping a region of interest
+  Real region_x1min, region_x1max, region_x2min, region_x2max;
+  Real region_x3min, region_x3max;
   bool user_hist_only;
   std::string data_format;
   bool contains_derived=false;
@@ -141,6 +149,7 @@ struct OutputParameters {
   int nbin=0, nbin2=0;
   bool logscale=true, logscale2=true;
   bool mass_weighted=false;
+  bool essential=true;  // never skipped when outputs exceed <time>/io_budget
 };
 
 //----------------------------------------------------------------------------------------
@@ -156,6 +165,31 @@ struct OutputVariableInfo {
     label(lab), data_index(indx), data_ptr(ptr) {}
 };
 
+//----------------------------------------------------------------------------------------
+//! \struct DerivedVariableCache
+//  \brief  derived variables computed by an output, with the cycle, time and Mesh
+//  generation at which they were computed, so later outputs in the same cycle reuse them
+
+struct DerivedVariableCache {
+  DvceArray5D<Real> data;   // array holding the derived variables
+  int ncycle = -1;
+  Real time;
+  int ngeneration;
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct CoarseningCascade
+//  \brief  output data restricted by factors 1,2,4,8,... in one cascade of restrictions,
+//  with the cycle, time and Mesh generation at which it was computed, so coarsened
+//  outputs of the same data at several factors in the same cycle share it
+
+struct CoarseningCascade {
+  std::vector<DvceArray5D<Real>> levels;   // levels[l] is coarsened by a factor 2^l
+  int ncycle = -1;
+  Real time;
+  int ngeneration;
+};
+
 //----------------------------------------------------------------------------------------
 //! \struct OutputMeshBlockInfo
 //  \brief  container for various properties of each output MeshBlock
@@ -179,22 +213,25 @@ struct OutputMeshBlockInfo {
 
 struct HistoryData {
   int nhist;
+  int nmax;    // last nmax of the nhist entries are maxima over ranks, rather than sums
   PhysicsModule physics;
   std::string label[NHISTORY_VARIABLES];
   Real hdata[NHISTORY_VARIABLES];
   bool header_written;
   // constructor
-  explicit HistoryData(PhysicsModule name) : physics(name), header_written(false) {}
+  explicit HistoryData(PhysicsModule name) : nmax(0), physics(name),
+    header_written(false) {}
 };
 
 //----------------------------------------------------------------------------------------
 //! \struct TrackedParticleData
-//! \brief data (tag, pos, vel) output for tracked particles
+//! \brief data (tag, pos, vel) output for tracked particles, in the (single precision)
+//! layout of each record in the output file
 
 struct TrackedParticleData {
   int tag;
-  Real x,y,z;
-  Real vx,vy,vz;
+  float x,y,z;
+  float vx,vy,vz;
 };
 
 //----------------------------------------------------------------------------------------
@@ -218,10 +255,27 @@ class BaseTypeOutput {
 
   // function which computes derived output variables like vorticity and current density
   void ComputeDerivedVariable(std::string name, Mesh *pm);
+  // computes all derived variables of this output, or shares them with an output that
+  // already computed them this cycle
+  void LoadDerivedVariables(Mesh *pm);
+  // derived variables computed this cycle, keyed by the names of the variables
+  static std::map<std::string, DerivedVariableCache> derived_cache;
 
   // virtual functions may be over-ridden in derived classes
   virtual void LoadOutputData(Mesh *pm);
   virtual void WriteOutputFile(Mesh *pm, ParameterInput *pin) = 0;
+  // completes any writes still in flight (for asynchronous outputs)
+  virtual void CompleteWrites() {}
+
+  // number of outputs made, time spent in LoadOutputData() (computing and copying data to
+  // host) and in WriteOutputFile() plus CompleteWrites() (I/O), and bytes written to file
+  // by this rank, accumulated over the run by the Driver
+  int ncalls = 0;
+  int nskipped = 0;   // number of outputs skipped to keep within <time>/io_budget
+  double load_time = 0.0, write_time = 0.0;
+  IOWrapperSizeT nbytes = 0;
+  // load plus write time of all outputs on this rank, accumulated over the run
+  static double io_time;
 
   // Functions to detect big endian machine, and to byte-swap 32-bit words.  The vtk
   // legacy format requires data to be stored as big-endian.
@@ -237,12 +291,10 @@ class BaseTypeOutput {
   }
 
  protected:
-  // CC output data on host with dims (n,m,k,j,i) except
-  // for restarts, where dims are (m,n,k,j,i)
+  // CC output data on host with dims (n,m,k,j,i), only filled with copy_to_host
+  bool copy_to_host = true;
   HostArray5D<Real> outarray;
-  HostArray5D<Real> outarray_hyd, outarray_mhd, outarray_rad,
-                    outarray_force, outarray_z4c, outarray_adm;
-  HostFaceFld4D<Real> outfield;  // FC output field on host
+  DvceArray5D<Real> outarray_dvce;   // output data gathered on device before the copy
   std::vector<int> noutmbs;   // with MPI, number of output MBs across all ranks
   int noutmbs_min;            // with MPI, minimum number of output MBs across all ranks
   int noutmbs_max;            // with MPI, maximum number of output MBs across all ranks
@@ -278,10 +330,24 @@ class HistoryOutput : public BaseTypeOutput {
   std::vector<HistoryData> hist_data;
 
   void LoadOutputData(Mesh *pm) override;
-  void LoadHydroHistoryData(HistoryData *pdata, Mesh *pm);
-  void LoadMHDHistoryData(HistoryData *pdata, Mesh *pm);
-  void LoadZ4cHistoryData(HistoryData *pdata, Mesh *pm);
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+  void CompleteWrites() override;
+
+ private:
+  int nhist_builtin;            // number of built-in history variables of all modules
+  int ihydro, imhd, iz4c;       // index of first variable of each module (-1 if unused)
+  int buffer_cycles;            // number of outputs (rows) per batch
+  bool batch_reducing;          // sum over ranks of the batch started
+  std::vector<Real> hist_sums;  // batch of history data of all modules, row by row
+  std::vector<Real> hist_maxs;  // batch of entries reduced by max (HistoryData::nmax)
+  std::vector<Real> batch_time, batch_dt;   // time and dt of each row in batch
+#if MPI_PARALLEL_ENABLED
+  MPI_Request hist_req = MPI_REQUEST_NULL;  // sum over ranks in flight
+  MPI_Request max_req = MPI_REQUEST_NULL;   // max over ranks in flight
+#endif
+  template <int N> void SumBuiltinHistoryData(Mesh *pm);
+  void ReduceBatch();
+  void WriteBatch();
 };
 
 //----------------------------------------------------------------------------------------
@@ -292,11 +358,10 @@ class CoarsenedBinaryOutput : public BaseTypeOutput {
  public:
   CoarsenedBinaryOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
 
-  // void CoarsenVariable(const DvceArray3D<Real>& full_data,
-  //                            DvceArray3D<Real>& coarsen_data,
-  //                            const int coarsen_factor);
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+  // restriction cascades computed this cycle, keyed by the variables and output cells
+  static std::map<std::string, CoarseningCascade> cascades;
 };
 
 //----------------------------------------------------------------------------------------
@@ -315,7 +380,6 @@ struct PDFData {
   bool logscale, logscale2;
 
   DvceArray2D<Real> result_; // resulting histogram
-  Kokkos::Experimental::ScatterView<Real **, LayoutWrapper> scatter_result;
 
   PDFData(int dim, int nbinVal, int nbin2Val)
     : pdf_dimension(dim), nbin(nbinVal), nbin2(nbin2Val),
@@ -370,7 +434,90 @@ class ParticleVTKOutput : public BaseTypeOutput {
 class MeshBinaryOutput : public BaseTypeOutput {
  public:
   MeshBinaryOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~MeshBinaryOutput();
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+  void CompleteWrites() override;
+
+ private:
+  // file and packed data of a non-blocking write, kept alive until it completes
+  struct PendingWrite {
+    IOWrapper file;
+    char *data;
+  };
+  int async_depth;                    // max number of writes in flight (0 = blocking)
+  std::deque<PendingWrite> pending;   // writes in flight, oldest first
+  bool compress;                      // lossy compression of some variables
+  std::vector<float> error_bound;     // absolute error bound of each output variable
+  DvceArray1D<float> stage;           // output data packed on device in file layout
+  void CompleteOldestWrite();
+  std::size_t CompressVariable(const float *data, int n, float eps, char *out);
+};
+
+//----------------------------------------------------------------------------------------
+//! \class MeshHDF5Output
+//  \brief derived BaseTypeOutput class for mesh data in athdf (HDF5) format
+class MeshHDF5Output : public BaseTypeOutput {
+ public:
+  MeshHDF5Output(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  int cb_nodes;         // number of MPI-IO aggregators (0 = MPI-IO default)
+  int cb_buffer_size;   // size of collective buffers of aggregators (0 = default)
+};
+
+//----------------------------------------------------------------------------------------
+//! \class MeshVTKHDFOutput
+//  \brief derived BaseTypeOutput class for mesh data in VTKHDF (OverlappingAMR) format
+class MeshVTKHDFOutput : public BaseTypeOutput {
+ public:
+  MeshVTKHDFOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  std::vector<std::string> series;   // entries of files in the time series index
+  bool series_read = false;          // true once entries of existing index are read
+};
+
+//----------------------------------------------------------------------------------------
+//! \class SpectrumOutput
+//  \brief derived BaseTypeOutput class for power spectra on uniform meshes
+class SpectrumOutput : public BaseTypeOutput {
+ public:
+  SpectrumOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  int kmax;                                   // largest wavenumber in units of 2 pi/L
+  DvceArray3D<Real> ph1_cos, ph1_sin;         // phase factors (m,n,i) in x1, x2, x3
+  DvceArray3D<Real> ph2_cos, ph2_sin;
+  DvceArray3D<Real> ph3_cos, ph3_sin;
+  DvceArray4D<Real> ft1_re, ft1_im;           // transform in x1 on each MeshBlock
+  DvceArray4D<Real> ft2_re, ft2_im;           // transform in x1 and x2
+  DvceArray4D<Real> ft_re, ft_im;             // Fourier coefficients (v,n3,n2,n1)
+  DvceArray4D<Real>::HostMirror ft_re_h, ft_im_h;
+};
+
+//----------------------------------------------------------------------------------------
+//! \class InSituOutput
+//  \brief derived BaseTypeOutput class for in-situ visualization and analysis (Ascent)
+class InSituOutput : public BaseTypeOutput {
+ public:
+  InSituOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~InSituOutput();
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  std::string actions_file;   // Ascent actions file
+  bool device_pointers;       // pass device arrays to Ascent, else host copies
+  DualArray1D<int> ghosts;    // ghost cell flags (ascent_ghosts) of a MeshBlock
+  // host copies of the arrays holding output variables (without device_pointers)
+  std::map<DvceArray5D<Real>*, DvceArray5D<Real>::HostMirror> host_data;
+#if INSITU_ENABLED
+  ascent::Ascent *pascent;
+#endif
 };
 
 //----------------------------------------------------------------------------------------
@@ -380,8 +527,31 @@ class MeshBinaryOutput : public BaseTypeOutput {
 class RestartOutput : public BaseTypeOutput {
  public:
   RestartOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~RestartOutput();
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+  void WriteRestartFile(Mesh *pm, ParameterInput *pin, const std::string &fname);
+  void CompleteWrites() override;
+
+ private:
+  int chunk_mbs;                // max number of MeshBlocks written per collective call
+  std::string local_dir;        // node-local directory for restarts ("" = not used)
+  std::thread drain;            // copies last local restart file to the global file
+  int full_interval;            // every full_interval-th restart is full, others delta
+  int ndelta;                   // number of delta restarts since last full restart
+  int base_number;              // file number of last full restart (-1 if none)
+  int base_generation;          // Mesh::ngeneration at last full restart
+  bool write_delta;             // WriteRestartFile() writes a delta file
+  std::vector<uint64_t> base_hash;  // hash of each MeshBlock at last full restart
+  DvceArray1D<Real> rst_buf;    // data of a chunk of MeshBlocks, packed on device
+  HostArray1D<Real> rst_buf_h;  // host copy of rst_buf, written to file
+  DvceArray1D<uint64_t> rec_hash;   // hashes of MeshBlock records in rst_buf
+  void PackRecords(Mesh *pm, int m0, int nm, IOWrapperSizeT nrec);
+  void HashRecords(int nm, IOWrapperSizeT nrec, uint64_t *hash);
+  void PackChunk(const DvceArray5D<Real> &a, int m0, int nm, IOWrapperSizeT nrec,
+                 IOWrapperSizeT off);
+  void PackChunk(const DvceArray4D<Real> &a, int m0, int nm, IOWrapperSizeT nrec,
+                 IOWrapperSizeT off);
 };
 
 //----------------------------------------------------------------------------------------
@@ -395,6 +565,10 @@ class EventLogOutput : public BaseTypeOutput {
   // various flags to denote output status
   bool header_written=false;
   bool no_output=true;
+  // with io_profile=true, also writes the timing and bandwidth of all other outputs
+  bool io_profile=false;
+  std::vector<BaseTypeOutput*> *pprofiled = nullptr;
+  std::vector<double> io_stats;
 
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
@@ -411,11 +585,11 @@ class TrackedParticleOutput : public BaseTypeOutput {
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
  protected:
   int ntrack;           // total number of tracked particles across all ranks
-  int ntrack_thisrank;  // number of tracked particles this rank (guess)
+  int tag_start;        // tag of first tracked particle
+  int tag_stride;       // stride between tags of tracked particles
   int npout;            // number of tracked particles to be written this rank
-  bool header_written;
-  std::vector<int> npout_eachrank;
-  HostArray1D<TrackedParticleData> outpart;
+  DvceArray1D<TrackedParticleData> outpart_d;  // tracked particles selected on device
+  PinnedArray1D<TrackedParticleData> outpart;  // host copy, written to file
 };
 
 //----------------------------------------------------------------------------------------
@@ -430,6 +604,11 @@ class Outputs {
 
   // use vector of pointers to BaseTypeOutputs since it is an abstract base class
   std::vector<BaseTypeOutput*> pout_list;
+
+  // gathers (calls, load time, write time, bytes) of each output in list into stats,
+  // with times the maximum and bytes the sum over all MPI ranks
+  static void ReduceIOProfile(const std::vector<BaseTypeOutput*> &list,
+                              std::vector<double> &stats);
 };
 
 #endif // OUTPUTS_OUTPUTS_HPP_
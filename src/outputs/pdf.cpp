@@ -36,9 +36,33 @@
 #include "z4c/z4c.hpp"
 #include "outputs.hpp"
 
-// ScatterView is not part of Kokkos core interface
-#include "Kokkos_ScatterView.hpp"
-
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn int FindBin()
+//  \brief returns bin of x, with 0 and nbin+1 for values below and above the bin range.
+//  Logarithmic bins are found by bisection of the bin edges, avoiding a log10 per cell.
+
+KOKKOS_INLINE_FUNCTION
+int FindBin(const Real x, const Kokkos::View<Real*> &bins, const int nbin,
+            const bool logscale, const Real step) {
+  if (x < bins(0)) return 0;
+  if (x >= bins(nbin)) return nbin + 1;
+  if (!(logscale)) {
+    int b = static_cast<int>((x - bins(0))/step) + 1;
+    return (b < nbin) ? b : nbin;
+  }
+  int lo = 0, hi = nbin;   // bins(lo) <= x < bins(hi)
+  while (hi - lo > 1) {
+    int mid = (lo + hi)/2;
+    if (x < bins(mid)) {
+      hi = mid;
+    } else {
+      lo = mid;
+    }
+  }
+  return lo + 1;
+}
+} // namespace
 
 //----------------------------------------------------------------------------------------
 // Constructor: also calls BaseTypeOutput base class constructor
@@ -146,9 +170,6 @@ PDFOutput::PDFOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
   } else if (pdf_data.pdf_dimension == 1) {
     pdf_data.result_ = DvceArray2D<Real>("result", 1, op.nbin+2);
   }
-  pdf_data.scatter_result = Kokkos::Experimental::ScatterView<Real **, LayoutWrapper>(
-    pdf_data.result_
-  );
 }
 
 
@@ -162,11 +183,8 @@ void PDFOutput::LoadOutputData(Mesh *pm) {
   // Calculate derived variables, if required
   // if out_params.variable or out_params.variable_2 not a derived
   // then ComputeDerivedVariable does nothing, so this should be fine
-  // although maybe not optimal -- should probably have a way to
-  // know beforehand which needs to be computed
   if (out_params.contains_derived) {
-    ComputeDerivedVariable(out_params.variable, pm);
-    ComputeDerivedVariable(out_params.variable_2, pm);
+    LoadDerivedVariables(pm);
   }
 
   // Pointer for initial determination
@@ -195,38 +213,23 @@ void PDFOutput::LoadOutputData(Mesh *pm) {
 
   // loop over all MeshBlocks in this pack
   auto &indcs = pm->pmb_pack->pmesh->mb_indcs;
-  int is = indcs.is; int ie = indcs.ie;
-  int js = indcs.js; int je = indcs.je;
+  int is = indcs.is;
+  int js = indcs.js;
   int ks = indcs.ks; int ke = indcs.ke;
-
-  auto result  = pdf_data.result_;
-  auto scatter = pdf_data.scatter_result;
-
+  int nx1 = indcs.nx1;
+  int nji = indcs.nx2*indcs.nx1;
   int nmb = pm->pmb_pack->nmb_thispack;
-  int nx1 = indcs.nx1 + 2*indcs.ng;
-  int nx2 = indcs.nx2 + 2*indcs.ng;
-  int nx3 = indcs.nx3 + 2*indcs.ng;
-
-  // Copy MeshBlock data from host to device
-  DvceArray5D<Real> outvars_device("outvars_device", outvars.size(), nmb, nx3, nx2, nx1);
-  for (std::size_t i = 0; i < outvars.size(); ++i) {
-      auto d_slice = Kokkos::subview(*(outvars[i].data_ptr),
-      Kokkos::ALL(), outvars[i].data_index, Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL());
-      auto d_target_slice = Kokkos::subview(outvars_device, i,
-      Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL());
-      Kokkos::deep_copy(d_target_slice, d_slice);
-  }
-  Kokkos::fence();
 
-  //
+  // variables are binned directly from the arrays they are stored in
+  int pdf_dimension = pdf_data.pdf_dimension;
+  auto var1 = *(outvars[0].data_ptr);
+  int v1 = outvars[0].data_index;
+  auto var2 = (pdf_dimension == 2) ? *(outvars[1].data_ptr) : var1;
+  int v2 = (pdf_dimension == 2) ? outvars[1].data_index : v1;
 
-  // Reset ScatterView from previous output
-  scatter.reset();
-  // Also reset the histogram from previous call.
-  // Currently still required for consistent results between host and device backends, see
-  // https://github.com/kokkos/kokkos/issues/6363
+  // reset the histogram from previous call
+  auto result = pdf_data.result_;
   Kokkos::deep_copy(result, 0);
-  Kokkos::fence();
 
   // Capture the necessary data from pdf_data
   auto bins = pdf_data.bins;
@@ -235,61 +238,65 @@ void PDFOutput::LoadOutputData(Mesh *pm) {
   auto step_size2 = pdf_data.step_size2;
   auto nbin_ = pdf_data.nbin;
   auto nbin2_ = pdf_data.nbin2;
-  int pdf_dimension = pdf_data.pdf_dimension;
   bool logscale = pdf_data.logscale;
   bool logscale2 = pdf_data.logscale2;
   bool mass_weighted = pdf_data.mass_weighted;
 
-  par_for("pdf", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    auto &x_val = outvars_device(0, m, k, j, i);
-    int x_bin = -1;
-    // First handle edge cases explicitly
-    if (x_val < bins(0)) {
-      x_bin = 0;
-    } else if (x_val >= bins(nbin_)) {
-      x_bin = nbin_ + 1;
-    } else {
-      if (logscale == false) {
-        x_bin = static_cast<int>((x_val - bins(0)) / step_size) + 1;
-      } else if (logscale == true) {
-        x_bin = static_cast<int>(std::log10(x_val / bins(0)) / step_size) + 1;
-      }
+  // Each team bins one (MeshBlock, k) slab into its own copy of the histogram in scratch
+  // memory, so atomics only contend within the team, then adds the non-empty bins to the
+  // result.  Histograms too large for scratch memory are binned directly into result.
+  int ncol = nbin_ + 2;
+  int nhist = result.extent_int(0)*ncol;
+  size_t scr_size = ScrArray1D<Real>::shmem_size(nhist);
+  int scr_level = 0;
+  bool private_hist = true;
+  if (scr_size > static_cast<size_t>(Kokkos::TeamPolicy<>::scratch_size_max(0))) {
+    scr_level = 1;
+    if (scr_size > static_cast<size_t>(Kokkos::TeamPolicy<>::scratch_size_max(1))) {
+      private_hist = false;
+      scr_size = 0;
     }
-    // needs to be zero as for the 1D histogram we need 0 as first index of the 2D
-    // result array
-    int y_bin = 0;
-    if (pdf_dimension == 2) {
-      auto &y_val = outvars_device(1, m, k, j, i);
-
-      y_bin = -1; // reset to impossible value
-      // First handle edge cases explicitly
-      if (y_val < bins2(0)) {
-        y_bin = 0;
-      } else if (y_val >= bins2(nbin2_)) {
-        y_bin = nbin2_ + 1;
+  }
+
+  par_for_outer("pdf",DevExeSpace(),scr_size,scr_level,0,(nmb-1),ks,ke,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
+    ScrArray1D<Real> hist(member.team_scratch(scr_level), private_hist ? nhist : 0);
+    if (private_hist) {
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nhist), [&](const int n) {
+        hist(n) = 0.0;
+      });
+      member.team_barrier();
+    }
+
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nji), [&](const int idx) {
+      int j = idx/nx1 + js;
+      int i = idx%nx1 + is;
+      int x_bin = FindBin(var1(m,v1,k,j,i), bins, nbin_, logscale, step_size);
+      // needs to be zero as for the 1D histogram we need 0 as first index of the 2D
+      // result array
+      int y_bin = 0;
+      if (pdf_dimension == 2) {
+        y_bin = FindBin(var2(m,v2,k,j,i), bins2, nbin2_, logscale2, step_size2);
+      }
+      Real weight = mass_weighted ? vol*u0_(m,IDN,k,j,i) : vol;
+      if (private_hist) {
+        Kokkos::atomic_add(&hist(y_bin*ncol + x_bin), weight);
       } else {
-        // for lin and log directly pick index
-        if (logscale2 == false) {
-          y_bin = static_cast<int>((y_val - bins2(0)) / step_size2) + 1;
-        } else if (logscale2 == true) {
-          y_bin = static_cast<int>(std::log10(y_val/bins2(0)) / step_size2) + 1;
-        }
+        Kokkos::atomic_add(&result(y_bin, x_bin), weight);
       }
+    });
+
+    if (private_hist) {
+      member.team_barrier();
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nhist), [&](const int n) {
+        if (hist(n) != 0.0) {
+          Kokkos::atomic_add(&result(n/ncol, n%ncol), hist(n));
+        }
+      });
     }
-    auto res = scatter.access();
-    Real weight = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
-    weight *= mass_weighted == false
-              ? 1.0
-              : u0_(m, IDN, k, j, i);
-    res(y_bin, x_bin) += weight;
   });
-
-  // "reduce" results from scatter view to original view.
-  // May be a no-op depending on backend.
-  Kokkos::Experimental::contribute(result, scatter); //.KokkosView()
-  // Kokkos::Experimental::contribute(result.KokkosView(), scatter);
-  Kokkos::fence(); // May not be required
+  Kokkos::fence();
 
   // Now reduce over ranks
 #if MPI_PARALLEL_ENABLED
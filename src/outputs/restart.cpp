@@ -6,16 +6,21 @@
 //! \file restart.cpp
 //! \brief writes restart files
 
+#include <fcntl.h>     // open
 #include <sys/stat.h>  // mkdir
+#include <unistd.h>    // pwrite, fsync, close
 
 #include <algorithm>
 #include <cstdio>      // fwrite(), fclose(), fopen(), fnprintf(), snprintf()
 #include <cstdlib>
+#include <cstring>     // memcpy, memmove
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility> // make_pair
+#include <vector>
 
 #include "athena.hpp"
 #include "coordinates/cell_locations.hpp"
@@ -31,92 +36,108 @@
 #include "srcterms/turb_driver.hpp"
 //#include "outputs.hpp"
 
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void DrainRestartFile()
+//! \brief Copies the part of a restart file written by this rank to a node-local file
+//! into the global restart file at byte offset base, then deletes the local file.  Run
+//! on a background thread, using POSIX I/O (disjoint byte ranges on each rank).
+
+void DrainRestartFile(std::string local_fname, std::string fname, IOWrapperSizeT base) {
+  std::FILE *in = std::fopen(local_fname.c_str(), "rb");
+  int fd = open(fname.c_str(), O_WRONLY);
+  if (in == nullptr || fd < 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Local restart file '" << local_fname << "' could not be "
+              << "copied to '" << fname << "'" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  std::vector<char> buf(1 << 26);
+  IOWrapperSizeT offset = base;
+  std::size_t nread;
+  while ((nread = std::fread(buf.data(), 1, buf.size(), in)) > 0) {
+    std::size_t nwritten = 0;
+    while (nwritten < nread) {
+      ssize_t n = pwrite(fd, buf.data() + nwritten, nread - nwritten, offset + nwritten);
+      if (n < 0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Restart data not written correctly to '" << fname
+                  << "', restart file is broken." << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      nwritten += n;
+    }
+    offset += nread;
+  }
+  fsync(fd);
+  close(fd);
+  std::fclose(in);
+  std::remove(local_fname.c_str());
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 // ctor: also calls BaseTypeOutput base class constructor
 
 RestartOutput::RestartOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
-  BaseTypeOutput(pin, pm, op) {
+  BaseTypeOutput(pin, pm, op),
+  ndelta(0),
+  base_number(-1),
+  base_generation(-1),
+  write_delta(false),
+  rst_buf("rst_buf",1),
+  rst_buf_h("rst_buf_h",1),
+  rec_hash("rec_hash",1) {
+  // maximum number of MeshBlocks staged on the host and written per collective call
+  chunk_mbs = pin->GetOrAddInteger(op.block_name, "chunk_mbs", 16);
+  if (chunk_mbs < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "chunk_mbs=" << chunk_mbs << " in <" << op.block_name
+              << "> must be >= 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // optional node-local directory (e.g. NVMe or /dev/shm) for burst-buffer restarts
+  if (pin->DoesParameterExist(op.block_name, "local_dir")) {
+    local_dir = pin->GetString(op.block_name, "local_dir");
+    mkdir(local_dir.c_str(),0775);
+  }
+  // every full_interval-th restart is full, those in between are delta files
+  full_interval = pin->GetOrAddInteger(op.block_name, "full_interval", 1);
+  if (full_interval < 1 || (full_interval > 1 && !(local_dir.empty()))) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "full_interval=" << full_interval << " in <"
+              << op.block_name << "> must be >= 1, and 1 if local_dir is set"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
   // create directories for outputs. Comments in binary.cpp constructor explain why
   mkdir("rst",0775);
 }
 
 //----------------------------------------------------------------------------------------
-// RestartOutput::LoadOutputData()
-// overload of standard load data function specific to restarts.  Loads dependent
-// variables, including ghost zones.
+// Destructor: completes the drain of the last burst-buffer restart file, if any
 
-void RestartOutput::LoadOutputData(Mesh *pm) {
-  // get spatial dimensions of arrays, including ghost zones
-  auto &indcs = pm->pmb_pack->pmesh->mb_indcs;
-  int nout1 = indcs.nx1 + 2*(indcs.ng);
-  int nout2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
-  int nout3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-  int nmb = pm->pmb_pack->nmb_thispack;
+RestartOutput::~RestartOutput() {
+  CompleteWrites();
+}
 
-  // calculate total number of CC variables
-  hydro::Hydro* phydro = pm->pmb_pack->phydro;
-  mhd::MHD* pmhd = pm->pmb_pack->pmhd;
-  adm::ADM* padm = pm->pmb_pack->padm;
-  z4c::Z4c* pz4c = pm->pmb_pack->pz4c;
-  radiation::Radiation* prad = pm->pmb_pack->prad;
-  TurbulenceDriver* pturb=pm->pmb_pack->pturb;
-  int nhydro=0, nmhd=0, nrad=0, nforce=3, nadm=0, nz4c=0;
-  if (phydro != nullptr) {
-    nhydro = phydro->nhydro + phydro->nscalars;
-  }
-  if (pmhd != nullptr) {
-    nmhd = pmhd->nmhd + pmhd->nscalars;
-  }
-  if (pz4c != nullptr) {
-    nz4c = pz4c->nz4c;
-  } else if (padm != nullptr) {
-    nadm = padm->nadm;
-  }
-  // if the spacetime is evolved, we do not need to checkpoint/recover the ADM variables
-  if (prad != nullptr) {
-    nrad = prad->prgeo->nangles;
-  }
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::CompleteWrites()
+//  \brief Waits until the last node-local restart file is copied to the global file
 
-  // Note for restarts, outarrays are dimensioned (m,n,k,j,i)
-  if (phydro != nullptr) {
-    Kokkos::realloc(outarray_hyd, nmb, nhydro, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_hyd, Kokkos::subview(phydro->u0, std::make_pair(0,nmb),
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
-  }
-  if (pmhd != nullptr) {
-    Kokkos::realloc(outarray_mhd, nmb, nmhd, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_mhd, Kokkos::subview(pmhd->u0, std::make_pair(0,nmb),
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
-    Kokkos::realloc(outfield.x1f, nmb, nout3, nout2, nout1+1);
-    Kokkos::deep_copy(outfield.x1f, Kokkos::subview(pmhd->b0.x1f, std::make_pair(0,nmb),
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
-    Kokkos::realloc(outfield.x2f, nmb, nout3, nout2+1, nout1);
-    Kokkos::deep_copy(outfield.x2f, Kokkos::subview(pmhd->b0.x2f, std::make_pair(0,nmb),
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
-    Kokkos::realloc(outfield.x3f, nmb, nout3+1, nout2, nout1);
-    Kokkos::deep_copy(outfield.x3f, Kokkos::subview(pmhd->b0.x3f, std::make_pair(0,nmb),
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
-  }
-  if (prad != nullptr) {
-    Kokkos::realloc(outarray_rad, nmb, nrad, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_rad, Kokkos::subview(prad->i0, std::make_pair(0,nmb),
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
-  }
-  if (pturb != nullptr) {
-    Kokkos::realloc(outarray_force, nmb, nforce, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_force, Kokkos::subview(pturb->force, std::make_pair(0,nmb),
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
-  }
-  if (pz4c != nullptr) {
-    Kokkos::realloc(outarray_z4c, nmb, nz4c, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_z4c, Kokkos::subview(pz4c->u0, std::make_pair(0,nmb),
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
-  } else if (padm != nullptr) {
-    Kokkos::realloc(outarray_adm, nmb, nadm, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_adm, Kokkos::subview(padm->u_adm, std::make_pair(0,nmb),
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
+void RestartOutput::CompleteWrites() {
+  if (drain.joinable()) {
+    drain.join();
   }
+}
 
+//----------------------------------------------------------------------------------------
+// RestartOutput::LoadOutputData()
+// overload of standard load data function specific to restarts.  Dependent variables
+// (including ghost zones) are not staged on the host here, but copied and written a
+// chunk of MeshBlocks at a time by WriteRestartFile().
+
+void RestartOutput::LoadOutputData(Mesh *pm) {
   // calculate max/min number of MeshBlocks across all ranks
   noutmbs_max = pm->nmb_eachrank[0];
   noutmbs_min = pm->nmb_eachrank[0];
@@ -128,9 +149,60 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
 
 //----------------------------------------------------------------------------------------
 //! \fn void RestartOutput:::WriteOutputFile(Mesh *pm)
-//  \brief Cycles over all MeshBlocks and writes everything to a single restart file
+//  \brief Sets name of next restart file and updates counters, then writes file
+//  With full_interval > 1, the restarts between full ones are written as delta files
+//  ("*.drst") that only contain MeshBlocks changed since the last full restart, as long
+//  as the Mesh has not changed since then.  A full restart file is rebuilt from the full
+//  and a delta file by vis/python/merge_delta_restart.py.
 
 void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  write_delta = (full_interval > 1 && base_number >= 0 && ndelta < full_interval - 1 &&
+                 base_generation == pm->ngeneration);
+  if (write_delta) {
+    ndelta++;
+  } else {
+    ndelta = 0;
+    base_number = out_params.file_number;
+    base_generation = pm->ngeneration;
+  }
+
+  // create filename: "rst/file_basename" + "." + XXXXX + ".rst" (or ".drst")
+  // where XXXXX = 5-digit file_number
+  std::string fname;
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+
+  fname.assign("rst/");
+  fname.append(out_params.file_basename);
+  fname.append(".");
+  fname.append(number);
+  fname.append((write_delta)? ".drst" : ".rst");
+
+  // increment counters now so values for *next* dump are stored in restart file
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+
+  WriteRestartFile(pm, pin, fname);
+  write_delta = false;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput:::WriteRestartFile()
+//  \brief Writes data loaded by LoadOutputData() to restart file fname.  Also used by
+//  the ProblemGenerator to write snapshots of the initial data.  Cycles over all
+//  MeshBlocks and writes everything to a single restart file.
+//  With local_dir set, each rank instead writes its contiguous part of the file (the
+//  header and the data of its MeshBlocks) to a file in local_dir, which is then copied
+//  to the global file on a background thread.  The previous copy is completed first.
+
+void RestartOutput::WriteRestartFile(Mesh *pm, ParameterInput *pin,
+                                     const std::string &fname) {
   // get spatial dimensions of arrays, including ghost zones
   auto &indcs = pm->pmb_pack->pmesh->mb_indcs;
   int nout1 = indcs.nx1 + 2*(indcs.ng);
@@ -143,6 +215,9 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   z4c::Z4c* pz4c = pm->pmb_pack->pz4c;
   adm::ADM* padm = pm->pmb_pack->padm;
   int nhydro=0, nmhd=0, nrad=0, nforce=3, nz4c=0, nadm=0, nco=0;
+  if ((pturb != nullptr) && (pturb->modal_forcing)) {
+    nforce = 0;
+  }
   if (phydro != nullptr) {
     nhydro = phydro->nhydro + phydro->nscalars;
   }
@@ -158,27 +233,6 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   } else if (padm != nullptr) {
     nadm = padm->nadm;
   }
-  // create filename: "rst/file_basename" + "." + XXXXX + ".rst"
-  // where XXXXX = 5-digit file_number
-  std::string fname;
-  char number[6];
-  std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
-
-  fname.assign("rst/");
-  fname.append(out_params.file_basename);
-  fname.append(".");
-  fname.append(number);
-  fname.append(".rst");
-
-  // increment counters now so values for *next* dump are stored in restart file
-  out_params.file_number++;
-  if (out_params.last_time < 0.0) {
-    out_params.last_time = pm->time;
-  } else {
-    out_params.last_time += out_params.dt;
-  }
-  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
-  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
 
   // create string holding input parameters (copy of input file)
   std::stringstream ost;
@@ -191,7 +245,19 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
 
   // open file and  write the header; this part is serial
   IOWrapper resfile;
-  resfile.Open(fname.c_str(), IOWrapper::FileMode::write);
+  bool burst = !(local_dir.empty());
+  std::string local_fname;
+  if (burst) {
+    CompleteWrites();
+    local_fname = local_dir + "/" + fname.substr(fname.find_last_of('/') + 1) + "." +
+                  std::to_string(global_variable::my_rank);
+#if MPI_PARALLEL_ENABLED
+    resfile.SetCommunicator(MPI_COMM_SELF);
+#endif
+    resfile.Open(local_fname.c_str(), IOWrapper::FileMode::write);
+  } else {
+    resfile.Open(fname.c_str(), IOWrapper::FileMode::write);
+  }
   if (global_variable::my_rank == 0) {
     // output the input parameters (input file)
     resfile.Write_any_type(sbuf.c_str(),sbuf.size(),"byte");
@@ -228,9 +294,15 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
         resfile.Write_any_type(pt->GetPos(), 3*sizeof(Real), "byte");
       }
     }
-    // turbulence driver internal RNG
+    // turbulence driver internal RNG, and mode amplitudes of force with modal forcing
     if (pturb != nullptr) {
       resfile.Write_any_type(&(pturb->rstate), sizeof(RNG_State), "byte");
+      if (pturb->modal_forcing) {
+        pturb->amp_force.template sync<HostMemSpace>();
+        resfile.Write_any_type(pturb->amp_force.h_view.data(),
+                               24*(pturb->mode_count)*sizeof(Real), "byte");
+        resfile.Write_any_type(&(pturb->mean_force[0]), 3*sizeof(Real), "byte");
+      }
     }
   }
 
@@ -272,305 +344,271 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   IOWrapperSizeT step3size = 3*nco*sizeof(Real);
   if (pz4c != nullptr) step3size += sizeof(Real);
   if (pturb != nullptr) step3size += sizeof(RNG_State);
+  if ((pturb != nullptr) && (pturb->modal_forcing)) {
+    step3size += (24*(pturb->mode_count) + 3)*sizeof(Real);
+  }
 
-  // write cell-centered variables in parallel
+  // write variables in parallel, starting at the first MeshBlock of this rank
   IOWrapperSizeT offset_myrank  = step1size + step2size + step3size +
         sizeof(IOWrapperSizeT) + data_size*(pm->gids_eachrank[global_variable::my_rank]);
-  IOWrapperSizeT myoffset = offset_myrank;
-
-  // write cell-centered variables, one MeshBlock at a time (but parallelized over all
-  // ranks). MeshBlocks are written seperately to reduce number of data elements per write
-  // call, to avoid exceeding 2^31 limit for very large grids per MPI rank.
-  if (phydro != nullptr) {
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to write, so write collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_hyd, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at_all(mbptr.data(),mbcnt,myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered hydro data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_hyd, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at(mbptr.data(), mbcnt, myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered hydro data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
+  // offset of the local file within the global file (rank 0 also holds the header)
+  IOWrapperSizeT file_base = (burst && global_variable::my_rank != 0)? offset_myrank : 0;
+
+  // The data of each MeshBlock (in the order hydro u0, mhd u0 and b0, radiation i0,
+  // forcing, z4c u0 or adm u_adm) is contiguous in the file.  A chunk of MeshBlocks is
+  // packed into these records on the device, copied to the host and written with a
+  // single collective call, so only one chunk is staged on the host at a time.  Every
+  // rank makes the same number of collective calls (possibly writing nothing), and
+  // chunks are limited to 2^31 bytes per call.
+  // Delta restart files instead contain one flag per MeshBlock (1 if its record is in
+  // the file), followed by the records of MeshBlocks changed since the last full restart
+  // and a trailer (see WriteOutputFile()).  Changes are detected by hashing the records
+  // on the device.
+  if (data_size > 0) {
+    IOWrapperSizeT nrec = data_size/sizeof(Real);  // Reals per MeshBlock record
+    IOWrapperSizeT max_mbs = std::max(static_cast<IOWrapperSizeT>(1),
+                                      static_cast<IOWrapperSizeT>(2147483647)/data_size);
+    int nchunk_mbs = static_cast<int>(std::min(static_cast<IOWrapperSizeT>(chunk_mbs),
+                                               max_mbs));
+    int nmb = pm->nmb_thisrank;
+    int nbuf_mbs = std::max(1, std::min(nchunk_mbs, nmb));
+    if (rst_buf.extent(0) < nbuf_mbs*nrec) {
+      Kokkos::realloc(rst_buf, nbuf_mbs*nrec);
+      Kokkos::realloc(rst_buf_h, nbuf_mbs*nrec);
     }
-    offset_myrank += nout1*nout2*nout3*nhydro*sizeof(Real); // hydro u0
-    myoffset = offset_myrank;
-  }
-  if (pmhd != nullptr) {
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to write, so write collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_mhd, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at_all(mbptr.data(),mbcnt,myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered mhd data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_mhd, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at(mbptr.data(), mbcnt, myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered mhd data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
+    int nchunks = (noutmbs_max + nchunk_mbs - 1)/nchunk_mbs;
+
+    // hash records to find changed MeshBlocks (delta files), or to store the hashes of
+    // this full restart as the base of later delta files
+    std::vector<char> changed(nmb, 1);
+    if (full_interval > 1) {
+      std::vector<uint64_t> hash(nmb);
+      for (int m0=0; m0<nmb; m0+=nchunk_mbs) {
+        int nm = std::min(nchunk_mbs, nmb - m0);
+        PackRecords(pm, m0, nm, nrec);
+        HashRecords(nm, nrec, &(hash[m0]));
       }
-    }
-    offset_myrank += nout1*nout2*nout3*nmhd*sizeof(Real);   // mhd u0
-    myoffset = offset_myrank;
-
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to write, so write collectively
-      if (m < noutmbs_min) {
-        // get ptr to x1-face field
-        auto x1fptr = Kokkos::subview(outfield.x1f,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-        int fldcnt = x1fptr.size();
-        if (resfile.Write_any_type_at_all(x1fptr.data(),fldcnt,myoffset,"Real")!=fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "b0.x1f data not written correctly to rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x2-face field
-        auto x2fptr = Kokkos::subview(outfield.x2f,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-        fldcnt = x2fptr.size();
-        if (resfile.Write_any_type_at_all(x2fptr.data(),fldcnt,myoffset,"Real")!=fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "b0.x2f data not written correctly to rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x3-face field
-        auto x3fptr = Kokkos::subview(outfield.x3f,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-        fldcnt = x3fptr.size();
-        if (resfile.Write_any_type_at_all(x3fptr.data(),fldcnt,myoffset,"Real")!=fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "b0.x3f data not written correctly to rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        myoffset += data_size-(x1fptr.size()+x2fptr.size()+x3fptr.size())*sizeof(Real);
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to x1-face field
-        auto x1fptr = Kokkos::subview(outfield.x1f,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-        int fldcnt = x1fptr.size();
-        if (resfile.Write_any_type_at(x1fptr.data(),fldcnt,myoffset,"Real") != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "b0.x1f data not written correctly to rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
+      if (write_delta) {
+        for (int m=0; m<nmb; ++m) {
+          changed[m] = (hash[m] != base_hash[m]);
         }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x2-face field
-        auto x2fptr = Kokkos::subview(outfield.x2f,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-        fldcnt = x2fptr.size();
-        if (resfile.Write_any_type_at(x2fptr.data(),fldcnt,myoffset,"Real") != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "b0.x2f data not written correctly to rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x3-face field
-        auto x3fptr = Kokkos::subview(outfield.x3f,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-        fldcnt = x3fptr.size();
-        if (resfile.Write_any_type_at(x3fptr.data(),fldcnt,myoffset,"Real") != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "b0.x3f data not written correctly to rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        myoffset += data_size-(x1fptr.size()+x2fptr.size()+x3fptr.size())*sizeof(Real);
+      } else {
+        base_hash = hash;
       }
     }
-    offset_myrank += (nout1+1)*nout2*nout3*sizeof(Real);    // mhd b0.x1f
-    offset_myrank += nout1*(nout2+1)*nout3*sizeof(Real);    // mhd b0.x2f
-    offset_myrank += nout1*nout2*(nout3+1)*sizeof(Real);    // mhd b0.x3f
-    myoffset = offset_myrank;
-  }
 
-  if (prad != nullptr) {
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to write, so write collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_rad, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at_all(mbptr.data(),mbcnt,myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered rad data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_rad, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at(mbptr.data(),mbcnt,myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered rad data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
+    // number of changed MeshBlocks on this rank, on lower ranks, and in total
+    IOWrapperSizeT nchg_myrank = 0;
+    for (int m=0; m<nmb; ++m) {
+      if (changed[m]) nchg_myrank++;
+    }
+    IOWrapperSizeT nchg_before = 0, nchg_total = nchg_myrank;
+    IOWrapperSizeT flags_offset = step1size + step2size + step3size +
+                                  sizeof(IOWrapperSizeT);
+    if (write_delta) {
+#if MPI_PARALLEL_ENABLED
+      MPI_Exscan(&nchg_myrank, &nchg_before, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+      if (global_variable::my_rank == 0) nchg_before = 0;
+      MPI_Allreduce(&nchg_myrank, &nchg_total, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+#endif
+      IOWrapperSizeT myoffset = flags_offset +
+                                pm->gids_eachrank[global_variable::my_rank];
+      if (resfile.Write_any_type_at_all(changed.data(),nmb,myoffset,"byte") !=
+          static_cast<std::size_t>(nmb)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "MeshBlock flags not written correctly to rst file, "
+                  << "restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
       }
+      offset_myrank = flags_offset + pm->nmb_total + nchg_before*data_size;
     }
-    offset_myrank += nout1*nout2*nout3*nrad*sizeof(Real);   // radiation i0
-    myoffset = offset_myrank;
-  }
 
-  if (pturb != nullptr) {
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to write, so write collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_force, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at_all(mbptr.data(),mbcnt,myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered turb data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_force, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at(mbptr.data(), mbcnt, myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered turb data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
+    IOWrapperSizeT nwritten = 0;
+    for (int c=0; c<nchunks; ++c) {
+      int m0 = c*nchunk_mbs;
+      int nm = std::max(0, std::min(nchunk_mbs, nmb - m0));
+      IOWrapperSizeT ncopy = 0;
+      if (nm > 0) {
+        PackRecords(pm, m0, nm, nrec);
+        auto chunk = std::make_pair(static_cast<IOWrapperSizeT>(0), nm*nrec);
+        Kokkos::deep_copy(Kokkos::subview(rst_buf_h, chunk),
+                          Kokkos::subview(rst_buf, chunk));
+        // keep only records of changed MeshBlocks, in order
+        for (int m=0; m<nm; ++m) {
+          if (changed[m0+m]) {
+            if (ncopy != static_cast<IOWrapperSizeT>(m)) {
+              std::memmove(rst_buf_h.data() + ncopy*nrec, rst_buf_h.data() + m*nrec,
+                           data_size);
+            }
+            ncopy++;
+          }
         }
-        myoffset += data_size;
       }
-    }
-    offset_myrank += nout1*nout2*nout3*nforce*sizeof(Real); // forcing
-    myoffset = offset_myrank;
-  }
 
-  if (pz4c != nullptr) {
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to write, so write collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_z4c, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at_all(mbptr.data(),mbcnt,myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered z4c data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_z4c, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at(mbptr.data(), mbcnt, myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered z4c data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
+      IOWrapperSizeT cnt = ncopy*data_size;
+      IOWrapperSizeT myoffset = offset_myrank + nwritten*data_size - file_base;
+      if (resfile.Write_any_type_at_all(rst_buf_h.data(),cnt,myoffset,"byte") != cnt) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "MeshBlock data not written correctly to rst file, "
+                  << "restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
       }
+      nwritten += ncopy;
     }
-    offset_myrank += nout1*nout2*nout3*nz4c*sizeof(Real); // z4c u0
-    myoffset = offset_myrank;
-  } else if (padm != nullptr) {
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to write, so write collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_adm, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at_all(mbptr.data(),mbcnt,myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered adm data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(outarray_adm, m, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL, Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Write_any_type_at(mbptr.data(), mbcnt, myoffset,"Real") != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "cell-centered adm data not written correctly to rst file, "
-          << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
+
+    // trailer of delta files: header size, number of MeshBlocks, record size, number of
+    // the base (full) restart file, and a magic string
+    if (write_delta && global_variable::my_rank == 0) {
+      IOWrapperSizeT trailer[4] = {flags_offset,
+                                   static_cast<IOWrapperSizeT>(pm->nmb_total), data_size,
+                                   static_cast<IOWrapperSizeT>(base_number)};
+      IOWrapperSizeT myoffset = flags_offset + pm->nmb_total + nchg_total*data_size;
+      resfile.Write_any_type_at(trailer, sizeof(trailer), myoffset, "byte");
+      resfile.Write_any_type_at("ATHDELTA", 8, myoffset + sizeof(trailer), "byte");
     }
-    offset_myrank += nout1*nout2*nout3*nadm*sizeof(Real); // adm u_adm
-    myoffset = offset_myrank;
   }
 
   // close file, clean up
   resfile.Close();
 
+  // with burst-buffer restarts, rank 0 creates the global file before every rank starts
+  // copying its local file into it in the background
+  if (burst) {
+    if (global_variable::my_rank == 0) {
+      int fd = open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Restart file '" << fname << "' could not be opened"
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      close(fd);
+    }
+#if MPI_PARALLEL_ENABLED
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    drain = std::thread(DrainRestartFile, local_fname, fname, file_base);
+  }
+
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::PackChunk()
+//  \brief Packs cell-centered array a of MeshBlocks m0...m0+nm-1 into their records (of
+//  nrec Reals each) in rst_buf, starting at offset off within each record.
+
+void RestartOutput::PackChunk(const DvceArray5D<Real> &a, int m0, int nm,
+                              IOWrapperSizeT nrec, IOWrapperSizeT off) {
+  int nv = a.extent_int(1), nk = a.extent_int(2);
+  int nj = a.extent_int(3), ni = a.extent_int(4);
+  auto &buf = rst_buf;
+  par_for("rst_pack_cc",DevExeSpace(),0,nm-1,0,nv-1,0,nk-1,0,nj-1,0,ni-1,
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    buf(m*nrec + off + ((static_cast<IOWrapperSizeT>(n)*nk + k)*nj + j)*ni + i) =
+        a(m0+m,n,k,j,i);
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::PackChunk()
+//  \brief Packs face-centered field component a of MeshBlocks m0...m0+nm-1 into their
+//  records in rst_buf, starting at offset off within each record.
+
+void RestartOutput::PackChunk(const DvceArray4D<Real> &a, int m0, int nm,
+                              IOWrapperSizeT nrec, IOWrapperSizeT off) {
+  int nk = a.extent_int(1), nj = a.extent_int(2), ni = a.extent_int(3);
+  auto &buf = rst_buf;
+  par_for("rst_pack_fc",DevExeSpace(),0,nm-1,0,nk-1,0,nj-1,0,ni-1,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    buf(m*nrec + off + (static_cast<IOWrapperSizeT>(k)*nj + j)*ni + i) = a(m0+m,k,j,i);
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::PackRecords()
+//  \brief Packs all variables of MeshBlocks m0...m0+nm-1 into their records (of nrec
+//  Reals each) in rst_buf, in the order in which they are stored in restart files.
+
+void RestartOutput::PackRecords(Mesh *pm, int m0, int nm, IOWrapperSizeT nrec) {
+  auto &indcs = pm->mb_indcs;
+  int nout1 = indcs.nx1 + 2*(indcs.ng);
+  int nout2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int nout3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  IOWrapperSizeT ncells = nout1*nout2*nout3;
+  hydro::Hydro* phydro = pm->pmb_pack->phydro;
+  mhd::MHD* pmhd = pm->pmb_pack->pmhd;
+  radiation::Radiation* prad = pm->pmb_pack->prad;
+  TurbulenceDriver* pturb=pm->pmb_pack->pturb;
+  z4c::Z4c* pz4c = pm->pmb_pack->pz4c;
+  adm::ADM* padm = pm->pmb_pack->padm;
+
+  IOWrapperSizeT off = 0;  // offset of each variable within MeshBlock records
+  if (phydro != nullptr) {
+    PackChunk(phydro->u0, m0, nm, nrec, off);
+    off += ncells*phydro->u0.extent(1);
+  }
+  if (pmhd != nullptr) {
+    PackChunk(pmhd->u0, m0, nm, nrec, off);
+    off += ncells*pmhd->u0.extent(1);
+    PackChunk(pmhd->b0.x1f, m0, nm, nrec, off);
+    off += (nout1+1)*nout2*nout3;
+    PackChunk(pmhd->b0.x2f, m0, nm, nrec, off);
+    off += nout1*(nout2+1)*nout3;
+    PackChunk(pmhd->b0.x3f, m0, nm, nrec, off);
+    off += nout1*nout2*(nout3+1);
+  }
+  if (prad != nullptr) {
+    PackChunk(prad->i0, m0, nm, nrec, off);
+    off += ncells*prad->i0.extent(1);
+  }
+  if ((pturb != nullptr) && !(pturb->modal_forcing)) {
+    PackChunk(pturb->force, m0, nm, nrec, off);
+    off += ncells*pturb->force.extent(1);
+  }
+  if (pz4c != nullptr) {
+    PackChunk(pz4c->u0, m0, nm, nrec, off);
+  } else if (padm != nullptr) {
+    PackChunk(padm->u_adm, m0, nm, nrec, off);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::HashRecords()
+//  \brief Computes a 64-bit hash of each of the first nm records (of nrec Reals) in
+//  rst_buf on the device, and returns them in hash[0...nm-1] on the host.  Each word is
+//  mixed with its index by the SplitMix64 finalizer and the results are summed, so any
+//  bitwise change of a record changes its hash with probability ~1-2^-64.
+
+void RestartOutput::HashRecords(int nm, IOWrapperSizeT nrec, uint64_t *hash) {
+  if (rec_hash.extent_int(0) < nm) {
+    Kokkos::realloc(rec_hash, nm);
+  }
+  auto &buf = rst_buf;
+  auto &hash_ = rec_hash;
+  int nr = static_cast<int>(nrec);
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), nm, Kokkos::AUTO);
+  Kokkos::parallel_for("rst_hash", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int m = tmember.league_rank();
+    uint64_t sum = 0;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nr),
+    [&](const int n, uint64_t &hsum) {
+      Real x = buf(m*nrec + n);
+      uint64_t z = 0;
+      memcpy(&z, &x, sizeof(Real));
+      z += (static_cast<uint64_t>(n) + 1)*0x9E3779B97F4A7C15ULL;
+      z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+      hsum += z ^ (z >> 31);
+    }, Kokkos::Sum<uint64_t>(sum));
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {
+      hash_(m) = sum;
+    });
+  });
+  auto hash_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(),
+                                                    Kokkos::subview(rec_hash,
+                                                    std::make_pair(0, nm)));
+  for (int m=0; m<nm; ++m) {
+    hash[m] = hash_h(m);
+  }
+}
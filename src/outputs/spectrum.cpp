@@ -0,0 +1,271 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file spectrum.cpp
+//! \brief writes shell-averaged power spectra of the output variables on uniform meshes,
+//! e.g. of velocity (hydro_w_vx etc.), magnetic field (mhd_bcc) or density, so spectra
+//! of turbulence runs need not be computed from full-volume dumps.
+//!
+//! The Fourier coefficients q(n) = <q exp(-i 2 pi n.x/L)> of all modes with integer
+//! wavenumbers |n_x|,|n_y|,|n_z| <= kmax are computed on the device by a direct transform
+//! separated into one transform per direction, i.e. at a cost per MeshBlock of
+//! O(nx^3 kmax + nx^2 kmax^2 + nx kmax^3), which is practical for modest kmax.  The
+//! coefficients are summed over MeshBlocks and ranks, and the power |q(n)|^2 is binned
+//! into shells of width 1 centered at integer |n| <= kmax, so that summed over all shells
+//! it approximates <q^2> (Parseval).  Only n_x >= 0 is computed, since q(-n) = q(n)*.
+//!
+//! Optional parameters in the <output> block:
+//!  - kmax: largest wavenumber (in units of 2 pi/L) (default: 32, at most nx/2)
+
+#include <sys/stat.h>  // mkdir
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+SpectrumOutput::SpectrumOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+  if (pm->multilevel) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "spec output in <" << op.block_name << "> requires a "
+              << "uniform Mesh" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  int nmin = pm->mesh_indcs.nx1;
+  if (pm->multi_d) {nmin = std::min(nmin, pm->mesh_indcs.nx2);}
+  if (pm->three_d) {nmin = std::min(nmin, pm->mesh_indcs.nx3);}
+  kmax = std::min(pin->GetOrAddInteger(op.block_name, "kmax", 32), nmin/2);
+  // create new directory for this output. Comments in binary.cpp constructor explain why
+  mkdir("spec",0775);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SpectrumOutput::LoadOutputData()
+//! \brief computes the Fourier coefficients of all output variables, transforming first
+//! in x1, then x2 on each MeshBlock, then in x3 while summing over MeshBlocks, and sums
+//! them over all ranks
+
+void SpectrumOutput::LoadOutputData(Mesh *pm) {
+  if (out_params.contains_derived) {
+    LoadDerivedVariables(pm);
+  }
+
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int nmb = pm->pmb_pack->nmb_thispack;
+  int nvar = outvars.size();
+  // modes 0 <= n1 <= k1 and -k2 <= n2 <= k2, -k3 <= n3 <= k3 (only n=0 if unused)
+  int k1 = kmax;
+  int k2 = (pm->multi_d)? kmax : 0;
+  int k3 = (pm->three_d)? kmax : 0;
+  int nk1 = k1 + 1, nk2 = 2*k2 + 1, nk3 = 2*k3 + 1;
+  Real x1min = pm->mesh_size.x1min, l1 = pm->mesh_size.x1max - pm->mesh_size.x1min;
+  Real x2min = pm->mesh_size.x2min, l2 = pm->mesh_size.x2max - pm->mesh_size.x2min;
+  Real x3min = pm->mesh_size.x3min, l3 = pm->mesh_size.x3max - pm->mesh_size.x3min;
+
+  if (ph1_cos.extent_int(0) != nmb || ph1_cos.extent_int(1) != nk1 ||
+      ft1_re.extent_int(0) != nmb*nvar) {
+    Kokkos::realloc(ph1_cos, nmb, nk1, nx1);
+    Kokkos::realloc(ph1_sin, nmb, nk1, nx1);
+    Kokkos::realloc(ph2_cos, nmb, nk2, nx2);
+    Kokkos::realloc(ph2_sin, nmb, nk2, nx2);
+    Kokkos::realloc(ph3_cos, nmb, nk3, nx3);
+    Kokkos::realloc(ph3_sin, nmb, nk3, nx3);
+    Kokkos::realloc(ft1_re, nmb*nvar, nx3, nx2, nk1);
+    Kokkos::realloc(ft1_im, nmb*nvar, nx3, nx2, nk1);
+    Kokkos::realloc(ft2_re, nmb*nvar, nx3, nk2, nk1);
+    Kokkos::realloc(ft2_im, nmb*nvar, nx3, nk2, nk1);
+    Kokkos::realloc(ft_re, nvar, nk3, nk2, nk1);
+    Kokkos::realloc(ft_im, nvar, nk3, nk2, nk1);
+  }
+
+  // phase factors exp(-i 2 pi n (x - xmin)/L) at cell centers of each MeshBlock
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  auto &c1 = ph1_cos, &s1 = ph1_sin;
+  auto &c2 = ph2_cos, &s2 = ph2_sin;
+  auto &c3 = ph3_cos, &s3 = ph3_sin;
+  par_for("spec_ph1",DevExeSpace(),0,(nmb-1),0,(nk1-1),0,(nx1-1),
+  KOKKOS_LAMBDA(const int m, const int n, const int i) {
+    Real x = CellCenterX(i, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real ph = 2.0*M_PI*n*(x - x1min)/l1;
+    c1(m,n,i) = cos(ph);
+    s1(m,n,i) = sin(ph);
+  });
+  par_for("spec_ph2",DevExeSpace(),0,(nmb-1),0,(nk2-1),0,(nx2-1),
+  KOKKOS_LAMBDA(const int m, const int n, const int j) {
+    Real x = CellCenterX(j, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real ph = 2.0*M_PI*(n - k2)*(x - x2min)/l2;
+    c2(m,n,j) = cos(ph);
+    s2(m,n,j) = sin(ph);
+  });
+  par_for("spec_ph3",DevExeSpace(),0,(nmb-1),0,(nk3-1),0,(nx3-1),
+  KOKKOS_LAMBDA(const int m, const int n, const int k) {
+    Real x = CellCenterX(k, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    Real ph = 2.0*M_PI*(n - k3)*(x - x3min)/l3;
+    c3(m,n,k) = cos(ph);
+    s3(m,n,k) = sin(ph);
+  });
+
+  // transform in x1 of each variable on each MeshBlock
+  auto &a_re = ft1_re, &a_im = ft1_im;
+  for (int v=0; v<nvar; ++v) {
+    auto var = *(outvars[v].data_ptr);
+    int iv = outvars[v].data_index;
+    par_for("spec_x1",DevExeSpace(),0,(nmb-1),0,(nx3-1),0,(nx2-1),0,(nk1-1),
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int n) {
+      Real re = 0.0, im = 0.0;
+      for (int i=0; i<nx1; ++i) {
+        Real q = var(m,iv,k+ks,j+js,i+is);
+        re += q*c1(m,n,i);
+        im -= q*s1(m,n,i);
+      }
+      a_re(m*nvar+v,k,j,n) = re;
+      a_im(m*nvar+v,k,j,n) = im;
+    });
+  }
+
+  // transform in x2 on each MeshBlock
+  auto &b_re = ft2_re, &b_im = ft2_im;
+  par_for("spec_x2",DevExeSpace(),0,(nmb*nvar-1),0,(nx3-1),0,(nk2-1),0,(nk1-1),
+  KOKKOS_LAMBDA(const int mv, const int k, const int n2, const int n1) {
+    int m = mv/nvar;
+    Real re = 0.0, im = 0.0;
+    for (int j=0; j<nx2; ++j) {
+      re += a_re(mv,k,j,n1)*c2(m,n2,j) + a_im(mv,k,j,n1)*s2(m,n2,j);
+      im += a_im(mv,k,j,n1)*c2(m,n2,j) - a_re(mv,k,j,n1)*s2(m,n2,j);
+    }
+    b_re(mv,k,n2,n1) = re;
+    b_im(mv,k,n2,n1) = im;
+  });
+
+  // transform in x3, summed over all MeshBlocks
+  auto &f_re = ft_re, &f_im = ft_im;
+  par_for("spec_x3",DevExeSpace(),0,(nvar-1),0,(nk3-1),0,(nk2-1),0,(nk1-1),
+  KOKKOS_LAMBDA(const int v, const int n3, const int n2, const int n1) {
+    Real re = 0.0, im = 0.0;
+    for (int m=0; m<nmb; ++m) {
+      for (int k=0; k<nx3; ++k) {
+        re += b_re(m*nvar+v,k,n2,n1)*c3(m,n3,k) + b_im(m*nvar+v,k,n2,n1)*s3(m,n3,k);
+        im += b_im(m*nvar+v,k,n2,n1)*c3(m,n3,k) - b_re(m*nvar+v,k,n2,n1)*s3(m,n3,k);
+      }
+    }
+    f_re(v,n3,n2,n1) = re;
+    f_im(v,n3,n2,n1) = im;
+  });
+
+  // copy to host and sum over ranks
+  ft_re_h = Kokkos::create_mirror_view(ft_re);
+  ft_im_h = Kokkos::create_mirror_view(ft_im);
+  Kokkos::deep_copy(ft_re_h, ft_re);
+  Kokkos::deep_copy(ft_im_h, ft_im);
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, ft_re_h.data(), ft_re_h.size(), MPI_ATHENA_REAL, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+    MPI_Reduce(MPI_IN_PLACE, ft_im_h.data(), ft_im_h.size(), MPI_ATHENA_REAL, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(ft_re_h.data(), ft_re_h.data(), ft_re_h.size(), MPI_ATHENA_REAL, MPI_SUM,
+               0, MPI_COMM_WORLD);
+    MPI_Reduce(ft_im_h.data(), ft_im_h.data(), ft_im_h.size(), MPI_ATHENA_REAL, MPI_SUM,
+               0, MPI_COMM_WORLD);
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SpectrumOutput::WriteOutputFile()
+//! \brief bins the power of all modes into shells and writes one file per output, with
+//! columns k, number of modes in the shell, and the power of each variable
+
+void SpectrumOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  // only the master rank writes the file
+  if (global_variable::my_rank == 0) {
+    int nvar = outvars.size();
+    int k2 = (pm->multi_d)? kmax : 0;
+    int k3 = (pm->three_d)? kmax : 0;
+    Real ncells = static_cast<Real>(pm->mesh_indcs.nx1)*pm->mesh_indcs.nx2*
+                  pm->mesh_indcs.nx3;
+    std::vector<Real> nmodes(kmax+1, 0.0), power(nvar*(kmax+1), 0.0);
+    for (int n3=0; n3<=2*k3; ++n3) {
+      for (int n2=0; n2<=2*k2; ++n2) {
+        for (int n1=0; n1<=kmax; ++n1) {
+          Real kk = std::sqrt(static_cast<Real>(SQR(n1) + SQR(n2-k2) + SQR(n3-k3)));
+          int s = static_cast<int>(kk + 0.5);
+          if (s > kmax) continue;
+          // modes with n1 > 0 also stand for their complex conjugates at -n
+          Real w = (n1 > 0)? 2.0 : 1.0;
+          nmodes[s] += w;
+          for (int v=0; v<nvar; ++v) {
+            power[v*(kmax+1) + s] += w*(SQR(ft_re_h(v,n3,n2,n1)) +
+                                        SQR(ft_im_h(v,n3,n2,n1)))/SQR(ncells);
+          }
+        }
+      }
+    }
+
+    // create filename: "spec/file_basename" + "." + "file_id" + "." + XXXXX + ".spec"
+    // where XXXXX = 5-digit file_number
+    char number[6];
+    std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+    std::string fname;
+    fname.assign("spec/");
+    fname.append(out_params.file_basename);
+    fname.append(".");
+    fname.append(out_params.file_id);
+    fname.append(".");
+    fname.append(number);
+    fname.append(".spec");
+
+    FILE *pfile;
+    if ((pfile = std::fopen(fname.c_str(),"w")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+      exit(EXIT_FAILURE);
+    }
+    std::fprintf(pfile, "# Athena power spectra at time=");
+    std::fprintf(pfile, out_params.data_format.c_str(), pm->time);
+    std::fprintf(pfile, "  cycle=%d\n", pm->ncycle);
+    std::fprintf(pfile, "# [1]=k [2]=nmodes");
+    for (int v=0; v<nvar; ++v) {
+      std::fprintf(pfile, " [%d]=%s", v+3, outvars[v].label.c_str());
+    }
+    std::fprintf(pfile, "\n");
+    for (int s=0; s<=kmax; ++s) {
+      std::fprintf(pfile, "%4d", s);
+      std::fprintf(pfile, out_params.data_format.c_str(), nmodes[s]);
+      for (int v=0; v<nvar; ++v) {
+        std::fprintf(pfile, out_params.data_format.c_str(), power[v*(kmax+1) + s]);
+      }
+      std::fprintf(pfile, "\n");
+    }
+    std::fclose(pfile);
+  }
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  return;
+}
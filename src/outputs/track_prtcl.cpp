@@ -4,18 +4,24 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file track_prtcl.cpp
-//! \brief writes data for tracked particles in unformatted binary
+//! \brief writes data for tracked particles in unformatted binary.  Tracked particles are
+//! those with tags tag_start + n*tag_stride (n = 0,...,nparticles-1), and are selected
+//! and packed on the device.  All outputs are appended to one file per run, each
+//! consisting of a text header followed by one record (int tag, then position and
+//! velocity as 6 floats) per tracked particle, ordered by rank.  Each rank writes its
+//! records with a single collective write.
 
 #include <sys/stat.h>  // mkdir
-#include <vector>
 
-#include <algorithm>
+#include <algorithm>   // min, max
+#include <cstdint>     // int64_t
 #include <cstdio>      // fwrite(), fclose(), fopen(), fnprintf(), snprintf()
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>     // make_pair
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -28,77 +34,95 @@
 
 TrackedParticleOutput::TrackedParticleOutput(ParameterInput *pin, Mesh *pm,
                                              OutputParameters op) :
-  BaseTypeOutput(pin, pm, op) {
+  BaseTypeOutput(pin, pm, op),
+  npout(0) {
   // create new directory for this output. Comments in binary.cpp constructor explain why
   mkdir("trk",0775);
-  // allocate arrays
-  npout_eachrank.resize(global_variable::nranks);
   ntrack = pin->GetInteger(op.block_name,"nparticles");
-  // TODO(@user) improve guess below?
-  ntrack_thisrank = ntrack;
+  tag_start = pin->GetOrAddInteger(op.block_name,"tag_start",0);
+  tag_stride = pin->GetOrAddInteger(op.block_name,"tag_stride",1);
+  if (tag_stride < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "tag_stride = " << tag_stride << " in block '"
+              << op.block_name << "' must be positive" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
 }
 
 //----------------------------------------------------------------------------------------
 // TrackedParticleOutput::LoadOutputData()
-// Copies data for tracked particles on this rank to host outpart array
+// Selects tracked particles on this rank and packs them on the device (in order of
+// index in particle arrays), then starts an asynchronous copy to the pinned host array
 
 void TrackedParticleOutput::LoadOutputData(Mesh *pm) {
-  // Load data for tracked particles on this rank into new device array
-  DualArray1D<TrackedParticleData> tracked_prtcl("d_trked",ntrack_thisrank);
-  int npart = pm->nprtcl_thisrank;
-  auto &pr = pm->pmb_pack->ppart->prtcl_rdata;
-  auto &pi = pm->pmb_pack->ppart->prtcl_idata;
-  int counter=0;
-  int *pcounter = &counter;
-  par_for("part_update",DevExeSpace(),0,(npart-1), KOKKOS_LAMBDA(const int p) {
-    if (pi(PTAG,p) < ntrack) {
-      int index = Kokkos::atomic_fetch_add(pcounter,1);
-      tracked_prtcl.d_view(index).tag = pi(PTAG,p);
-      tracked_prtcl.d_view(index).x   = pr(IPX,p);
-      tracked_prtcl.d_view(index).y   = pr(IPY,p);
-      tracked_prtcl.d_view(index).z   = pr(IPZ,p);
-      tracked_prtcl.d_view(index).vx  = pr(IPVX,p);
-      tracked_prtcl.d_view(index).vy  = pr(IPVY,p);
-      tracked_prtcl.d_view(index).vz  = pr(IPVZ,p);
+  auto ppart = pm->pmb_pack->ppart;
+  int npart = ppart->nprtcl_thispack;
+  // buffers keep their capacity between outputs, and only grow when needed
+  int nmax = std::max(1, std::min(npart, ntrack));
+  if (outpart_d.extent_int(0) < nmax) {
+    Kokkos::realloc(outpart_d, nmax);
+    Kokkos::realloc(outpart, nmax);
+  }
+
+  auto &pr = ppart->prtcl_rdata;
+  auto &pi = ppart->prtcl_idata;
+  auto &tracked = outpart_d;
+  int tstart = tag_start, tstride = tag_stride;
+  std::int64_t tend = tag_start + static_cast<std::int64_t>(ntrack)*tag_stride;
+  int nsel = 0;
+  Kokkos::parallel_scan("track_sel", Kokkos::RangePolicy<>(DevExeSpace(), 0, npart),
+  KOKKOS_LAMBDA(const int p, int &index, const bool final) {
+    int tag = pi(PTAG,p);
+    if (tag >= tstart && tag < tend && ((tag - tstart) % tstride) == 0) {
+      if (final) {
+        tracked(index).tag = tag;
+        tracked(index).x   = static_cast<float>(pr(IPX,p));
+        tracked(index).y   = static_cast<float>(pr(IPY,p));
+        tracked(index).z   = static_cast<float>(pr(IPZ,p));
+        tracked(index).vx  = static_cast<float>(pr(IPVX,p));
+        tracked(index).vy  = static_cast<float>(pr(IPVY,p));
+        tracked(index).vz  = static_cast<float>(pr(IPVZ,p));
+      }
+      index++;
     }
-  });
-  npout = counter;
-  // share number of tracked particles to be output across all ranks
-  npout_eachrank[global_variable::my_rank] = npout;
-#if MPI_PARALLEL_ENABLED
-  MPI_Allgather(&npout, 1, MPI_INT, npout_eachrank.data(), 1, MPI_INT, MPI_COMM_WORLD);
-#endif
-  tracked_prtcl.resize(npout);
-  // sync tracked particle device array with host
-  tracked_prtcl.template modify<DevExeSpace>();
-  tracked_prtcl.template sync<HostMemSpace>();
-
-  // copy host view into host outpart array
-  Kokkos::realloc(outpart, npout);
-  Kokkos::deep_copy(outpart, tracked_prtcl.h_view);
+  }, nsel);
+  npout = nsel;
+
+  // copy selected particles to host asynchronously; fence before writing file
+  auto range = std::make_pair(0, npout);
+  Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(outpart, range),
+                    Kokkos::subview(outpart_d, range));
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void TrackedParticleOutput:::WriteOutputFile(Mesh *pm)
-//! \brief Cycles over all tracked particles on this rank and writes ouput data
-//! With MPI, all particles are written to the same file.
+//! \brief Writes records of all tracked particles on this rank with one collective
+//! write.  With MPI, all particles are written to the same file, ordered by rank.
 
 void TrackedParticleOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
-  int big_end = IsBigEndian(); // =1 on big endian machine
-
   // create filename: "trk/file_basename".trk
   std::string fname;
   fname.assign("trk/");
   fname.append(out_params.file_basename);
   fname.append(".trk");
 
-  // Root process opens/creates file and appends string
+  // offset of records on this rank (in records), and total number of records
+  std::int64_t nout = npout, myoffset = 0, ntotal = npout;
+#if MPI_PARALLEL_ENABLED
+  MPI_Exscan(&nout, &myoffset, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+  if (global_variable::my_rank == 0) {myoffset = 0;}
+  MPI_Allreduce(&nout, &ntotal, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+  // Root process opens/creates file and appends header
   if (global_variable::my_rank == 0) {
     std::stringstream msg;
     msg << std::endl << "# AthenaK tracked particle data at time= " << pm->time
         << "  nranks= " << global_variable::nranks
         << "  cycle=" << pm->ncycle
-        << "  ntracked_prtcls=" << ntrack << std::endl;
+        << "  ntracked_prtcls=" << ntrack
+        << "  nrecords=" << ntotal
+        << "  record=int(tag),float(x,y,z,vx,vy,vz)" << std::endl;
     FILE *pfile;
     if ((pfile = std::fopen(fname.c_str(),"a")) == nullptr) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
@@ -113,55 +137,23 @@ void TrackedParticleOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   IOWrapper partfile;
   partfile.Open(fname.c_str(), IOWrapper::FileMode::append);
   std::size_t header_offset = partfile.GetPosition();
-//  std::size_t header_offset = 0;
-
-  // allocate 1D vector of floats used to convert and output particle data
-  float *data = new float[6*npout];
-  // Loop over particles, load positions into data[]
-  for (int p=0; p<npout; ++p) {
-    data[ 6*p   ] = static_cast<float>(outpart(p).x);
-    data[(6*p)+1] = static_cast<float>(outpart(p).y);
-    data[(6*p)+2] = static_cast<float>(outpart(p).z);
-    data[(6*p)+3] = static_cast<float>(outpart(p).vx);
-    data[(6*p)+4] = static_cast<float>(outpart(p).vy);
-    data[(6*p)+5] = static_cast<float>(outpart(p).vz);
-  }
-  // calculate local data offset
-  std::vector<int> rank_offset(global_variable::nranks, 0);
-  int npout_min = pm->nprtcl_eachrank[0];
-  for (int n=1; n<global_variable::nranks; ++n) {
-    rank_offset[n] = rank_offset[n-1] + npout_eachrank[n-1];
-    npout_min = std::min(npout_min, npout_eachrank[n]);
-  }
 
-  // Write tracked particle data collectively over minimum shared number of prtcls
-  for (int p=0; p<npout_min; ++p) {
-    // offset computed assuming tags run 0...(ntrack-1) sequentially
-    std::size_t myoffset = header_offset + 6*outpart(p).tag;
-    // Write particle positions collectively for minimum number of particles across ranks
-    if (partfile.Write_any_type_at_all(&(data[0]),6,myoffset,"float") != 6) {
-      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "particle data not written correctly to tracked particle file"
-          << std::endl;
-      exit(EXIT_FAILURE);
-    }
-  }
-  // Write particle positions individually for remaining particles on each rank
-  for (int p=npout_min; p<npout; ++p) {
-    // offset computed assuming tags run 0...(ntrack-1) sequentially
-    std::size_t myoffset = header_offset + 6*outpart(p).tag;
-    // Write particle positions collectively for minimum number of particles across ranks
-    if (partfile.Write_any_type_at(&(data[0]),6,myoffset,"float") != 6) {
-      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "particle data not written correctly to tracked particle file"
-          << std::endl;
-      exit(EXIT_FAILURE);
-    }
+  // wait for copy of particle data to host started in LoadOutputData()
+  Kokkos::fence();
+
+  // Write records of all tracked particles on this rank collectively
+  std::size_t rsize = sizeof(TrackedParticleData);
+  std::size_t nbytes = npout*rsize;
+  std::size_t offset = header_offset + myoffset*rsize;
+  if (partfile.Write_any_type_at_all(outpart.data(), nbytes, offset, "byte") != nbytes) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "particle data not written correctly to tracked particle file"
+        << std::endl;
+    exit(EXIT_FAILURE);
   }
 
   // close the output file and clean up
   partfile.Close();
-  delete[] data;
 
   // increment counters
   if (out_params.last_time < 0.0) {
@@ -153,6 +153,7 @@ void MeshVTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     }
     if (global_variable::my_rank == 0) {
       MPI_File_write(fh, msg.str().c_str(), msg.str().size(), MPI_BYTE,MPI_STATUS_IGNORE);
+      IOWrapper::nbytes_written += msg.str().size();
     }
     size_t header_size = msg.str().size();
 
@@ -188,6 +189,7 @@ void MeshVTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       if (global_variable::my_rank == 0) {
         MPI_File_write(fh, data_msg.str().c_str(), data_msg.str().size(),
                           MPI_BYTE, MPI_STATUS_IGNORE);
+        IOWrapper::nbytes_written += data_msg.str().size();
       }
       header_size += data_msg.str().size();
 
@@ -235,6 +237,7 @@ void MeshVTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
         } else if (m < nout_mbs) {
           MPI_File_write(fh, &(data[0]), 1, block, MPI_STATUS_IGNORE);
         }
+        if (m < nout_mbs) {IOWrapper::nbytes_written += nx1*nx2*nx3*sizeof(float);}
       }  // end loop over MeshBlocks
       MPI_Type_free(&mygrid);
 
@@ -310,6 +313,7 @@ void MeshVTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       std::fwrite(&(data[0]), sizeof(float), nout1*nout2*nout3, pfile);
     }
     // close the output file and clean up
+    IOWrapper::nbytes_written += std::ftell(pfile);
     std::fclose(pfile);
     delete[] data;
   }
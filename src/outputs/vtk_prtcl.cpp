@@ -18,6 +18,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include "athena.hpp"
 #include "coordinates/cell_locations.hpp"
@@ -53,8 +54,12 @@ void ParticleVTKOutput::LoadOutputData(Mesh *pm) {
   auto d_outpart_idata = Kokkos::create_mirror_view(Kokkos::DefaultHostExecutionSpace(),
                                                     outpart_idata);
   // Copy particle positions into device mirrors
-  Kokkos::deep_copy(d_outpart_rdata, pp->prtcl_rdata);
-  Kokkos::deep_copy(d_outpart_idata, pp->prtcl_idata);
+  // (only the first npout_thisrank entries of the particle arrays are valid)
+  auto range = std::make_pair(0, npout_thisrank);
+  Kokkos::deep_copy(d_outpart_rdata,
+                    Kokkos::subview(pp->prtcl_rdata, Kokkos::ALL, range));
+  Kokkos::deep_copy(d_outpart_idata,
+                    Kokkos::subview(pp->prtcl_idata, Kokkos::ALL, range));
   // Copy particle positions from device mirror to host output array
   Kokkos::deep_copy(outpart_rdata, d_outpart_rdata);
   Kokkos::deep_copy(outpart_idata, d_outpart_idata);
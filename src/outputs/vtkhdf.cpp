@@ -0,0 +1,264 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file vtkhdf.cpp
+//! \brief writes mesh data in the VTKHDF format (OverlappingAMR type) read by ParaView
+//! and VTK.  Unlike the legacy vtk output, all ranks write the MeshBlocks of each level
+//! to a single file with one collective (parallel HDF5) write per variable, in
+//! little-endian floats with no byte swapping, and both uniform and SMR/AMR meshes are
+//! supported.
+//! Rank 0 also maintains a ParaView ".series" index file listing the files written and
+//! their times, so the whole time series is opened as one dataset.
+
+#include <sys/stat.h>  // mkdir
+
+#include <algorithm>
+#include <cstdio>      // snprintf()
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+#include "hdf5_utils.hpp"
+
+#if HDF5OUTPUT_ENABLED
+using hdf5_utils::WriteAttribute;
+using hdf5_utils::WriteScalarStringAttribute;
+using hdf5_utils::WriteDataset;
+#endif
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+MeshVTKHDFOutput::MeshVTKHDFOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+#if HDF5OUTPUT_ENABLED
+  // blocks of an OverlappingAMR dataset may only overlap blocks on other levels
+  if (op.include_gzs) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "ghost_zones=true in <" << op.block_name << "> is not "
+              << "supported by vtkhdf outputs" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // create new directory for this output. Comments in binary.cpp constructor explain why
+  mkdir("vtkhdf",0775);
+#else
+  std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+            << "file_type=vtkhdf in <" << op.block_name << "> requires HDF5, so "
+            << "configure with -D Athena_ENABLE_HDF5=ON" << std::endl;
+  std::exit(EXIT_FAILURE);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshVTKHDFOutput::WriteOutputFile(Mesh *pm)
+//! \brief Cycles over all MeshBlocks and writes output data in VTKHDF format.  The file
+//! holds one group per level, containing the cell index box of each MeshBlock on that
+//! level (AMRBox), and a 1D dataset per variable with the cells of those MeshBlocks in
+//! order.  Each rank writes the contiguous range of its MeshBlocks with one collective
+//! call per dataset.
+
+void MeshVTKHDFOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+#if HDF5OUTPUT_ENABLED
+  // create filename: "vtkhdf/file_basename" + "." + "file_id" + "." + XXXXX + ".vtkhdf"
+  // where XXXXX = 5-digit file_number
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+  std::string bname;
+  bname.assign(out_params.file_basename);
+  bname.append(".");
+  bname.append(out_params.file_id);
+  std::string fname = "vtkhdf/" + bname + "." + number + ".vtkhdf";
+
+  // number of cells output in each direction on every MeshBlock (same on all ranks)
+  auto &indcs = pm->mb_indcs;
+  int nout1 = (out_params.slice1)? 1 : indcs.nx1;
+  int nout2 = (out_params.slice2)? 1 : indcs.nx2;
+  int nout3 = (out_params.slice3)? 1 : indcs.nx3;
+  hsize_t ncells = static_cast<hsize_t>(nout1)*nout2*nout3;
+
+  // number of output MeshBlocks of each rank on each level
+  int nout_mbs = outmbs.size();
+  int nlevels = 1;
+  for (int m=0; m<nout_mbs; ++m) {
+    int level = pm->lloc_eachmb[outmbs[m].mb_gid].level - pm->root_level;
+    nlevels = std::max(nlevels, level + 1);
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &nlevels, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  int nranks = global_variable::nranks, my_rank = global_variable::my_rank;
+  std::vector<int> nmb_level(nranks*nlevels, 0);
+  for (int m=0; m<nout_mbs; ++m) {
+    int level = pm->lloc_eachmb[outmbs[m].mb_gid].level - pm->root_level;
+    nmb_level[my_rank*nlevels + level]++;
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, nmb_level.data(), nranks*nlevels, MPI_INT, MPI_SUM,
+                MPI_COMM_WORLD);
+#endif
+
+  // open file with MPI-IO driver and collective metadata operations
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+#if MPI_PARALLEL_ENABLED
+  H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, MPI_INFO_NULL);
+  H5Pset_all_coll_metadata_ops(fapl, true);
+  H5Pset_coll_metadata_write(fapl, true);
+  H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+#endif
+  hid_t file = H5Fcreate(fname.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  if (file < 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Output file '" << fname << "' could not be created"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // root group, and time and cycle as field data
+  hid_t root = H5Gcreate2(file, "VTKHDF", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  int version[2] = {2, 0};
+  double origin[3] = {pm->mesh_size.x1min, pm->mesh_size.x2min, pm->mesh_size.x3min};
+  WriteAttribute(root, "Version", H5T_STD_I32LE, H5T_NATIVE_INT, 2, version);
+  WriteScalarStringAttribute(root, "Type", "OverlappingAMR");
+  WriteScalarStringAttribute(root, "GridDescription", "XYZ");
+  WriteAttribute(root, "Origin", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, 3, origin);
+  hid_t fdata = H5Gcreate2(root, "FieldData", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  double time = pm->time;
+  int ncycle = pm->ncycle;
+  hsize_t one = 1, nroot = (my_rank == 0)? 1 : 0;
+  WriteDataset(fdata, dxpl, "TIME", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, 1, &one, 0, 0,
+               nroot, false, &time);
+  WriteDataset(fdata, dxpl, "CYCLE", H5T_STD_I32LE, H5T_NATIVE_INT, 1, &one, 0, 0,
+               nroot, false, &ncycle);
+  H5Gclose(fdata);
+
+  // MeshBlocks of each level, in the order of outmbs on each rank
+  int nout_vars = outvars.size();
+  std::vector<int> boxes;
+  std::vector<float> data;
+  for (int l=0; l<nlevels; ++l) {
+    hsize_t moff = 0, nmb_total = 0;
+    for (int n=0; n<nranks; ++n) {
+      if (n < my_rank) moff += nmb_level[n*nlevels + l];
+      nmb_total += nmb_level[n*nlevels + l];
+    }
+    std::vector<int> mbs;
+    for (int m=0; m<nout_mbs; ++m) {
+      if (pm->lloc_eachmb[outmbs[m].mb_gid].level - pm->root_level == l) {
+        mbs.push_back(m);
+      }
+    }
+    hsize_t nmb = mbs.size();
+
+    std::string lname = "Level" + std::to_string(l);
+    hid_t lgrp = H5Gcreate2(root, lname.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    double spacing[3] = {pm->mesh_size.dx1/(1 << l), pm->mesh_size.dx2/(1 << l),
+                         pm->mesh_size.dx3/(1 << l)};
+    if (!(pm->multi_d)) {spacing[1] = pm->mesh_size.dx2;}
+    if (!(pm->three_d)) {spacing[2] = pm->mesh_size.dx3;}
+    WriteAttribute(lgrp, "Spacing", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, 3, spacing);
+
+    // cell index box (imin,imax,jmin,jmax,kmin,kmax) of each MeshBlock on this level
+    boxes.resize(6*nmb);
+    for (hsize_t b=0; b<nmb; ++b) {
+      OutputMeshBlockInfo &omb = outmbs[mbs[b]];
+      LogicalLocation &lloc = pm->lloc_eachmb[omb.mb_gid];
+      boxes[6*b  ] = lloc.lx1*indcs.nx1 + (omb.ois - indcs.is);
+      boxes[6*b+1] = boxes[6*b] + nout1 - 1;
+      boxes[6*b+2] = lloc.lx2*indcs.nx2 + (omb.ojs - indcs.js);
+      boxes[6*b+3] = boxes[6*b+2] + nout2 - 1;
+      boxes[6*b+4] = lloc.lx3*indcs.nx3 + (omb.oks - indcs.ks);
+      boxes[6*b+5] = boxes[6*b+4] + nout3 - 1;
+    }
+    hsize_t bdims[2] = {nmb_total, 6};
+    WriteDataset(lgrp, dxpl, "AMRBox", H5T_STD_I32LE, H5T_NATIVE_INT, 2, bdims, 0, moff,
+                 nmb, false, boxes.data());
+
+    // variables, converted to floats, with the cells of each MeshBlock in (k,j,i) order
+    hid_t cgrp = H5Gcreate2(lgrp, "CellData", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    hsize_t cdims = nmb_total*ncells;
+    data.resize(nmb*ncells);
+    for (int n=0; n<nout_vars; ++n) {
+      std::size_t indx = 0;
+      for (hsize_t b=0; b<nmb; ++b) {
+        for (int k=0; k<nout3; ++k) {
+          for (int j=0; j<nout2; ++j) {
+            for (int i=0; i<nout1; ++i) {
+              data[indx++] = static_cast<float>(outarray(n,mbs[b],k,j,i));
+            }
+          }
+        }
+      }
+      WriteDataset(cgrp, dxpl, outvars[n].label.c_str(), H5T_IEEE_F32LE,
+                   H5T_NATIVE_FLOAT, 1, &cdims, 0, moff*ncells, nmb*ncells, false,
+                   data.data());
+    }
+    H5Gclose(cgrp);
+    H5Gclose(lgrp);
+  }
+
+  H5Gclose(root);
+  H5Fclose(file);
+  H5Pclose(dxpl);
+  H5Pclose(fapl);
+
+  // rewrite the index of the time series.  After a restart, entries of files written
+  // before the restart are recovered from the existing index.
+  if (my_rank == 0) {
+    std::string sname = "vtkhdf/" + bname + ".vtkhdf.series";
+    if (!(series_read)) {
+      std::ifstream sfile(sname);
+      std::string line;
+      while (std::getline(sfile, line)) {
+        std::size_t pos = line.find(".vtkhdf\"");
+        if (line.find("\"name\"") == std::string::npos || pos < 5) continue;
+        if (std::atoi(line.substr(pos-5, 5).c_str()) < out_params.file_number) {
+          series.push_back(line.substr(0, line.find_last_not_of(", ") + 1));
+        }
+      }
+      series_read = true;
+    }
+    std::stringstream entry;
+    entry << std::scientific << std::setprecision(std::numeric_limits<Real>::max_digits10)
+          << "    { \"name\" : \"" << bname << "." << number << ".vtkhdf\", \"time\" : "
+          << pm->time << " }";
+    series.push_back(entry.str());
+    std::ofstream sfile(sname, std::ios::trunc);
+    if (!(sfile.is_open())) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Output file '" << sname << "' could not be opened"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    sfile << "{" << std::endl << "  \"file-series-version\" : \"1.0\"," << std::endl
+          << "  \"files\" : [" << std::endl;
+    for (std::size_t n=0; n<series.size(); ++n) {
+      sfile << series[n] << ((n+1 < series.size())? "," : "") << std::endl;
+    }
+    sfile << "  ]" << std::endl << "}" << std::endl;
+  }
+#endif
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+
+  return;
+}
@@ -6,15 +6,19 @@
 //! \file particles.cpp
 //! \brief implementation of Particles class constructor and assorted other functions
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <string>
-#include <algorithm>
+#include <utility>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "bvals/bvals.hpp"
+#include "utils/transient_pool.hpp"
 #include "particles.hpp"
 
 namespace particles {
@@ -58,6 +62,12 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     std::string ppush = pin->GetString("particles","pusher");
     if (ppush.compare("drift") == 0) {
       pusher = ParticlesPusher::drift;
+    } else if (ppush.compare("boris") == 0) {
+      pusher = ParticlesPusher::boris;
+    } else if (ppush.compare("higuera_cary") == 0) {
+      pusher = ParticlesPusher::higuera_cary;
+    } else if (ppush.compare("lagrangian_mc") == 0) {
+      pusher = ParticlesPusher::lagrangian_mc;
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
                 << std::endl << "Particle pusher must be specified in <particles> block"
@@ -66,6 +76,36 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     }
   }
 
+  // Lorentz-force pushers interpolate fields of the MHD fluid
+  if (pusher == ParticlesPusher::boris || pusher == ParticlesPusher::higuera_cary) {
+    if (!(pin->DoesBlockExist("mhd"))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Lorentz-force particle pushers require <mhd> block "
+                << "in input file" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    q_over_m = pin->GetOrAddReal("particles","q_over_m",1.0);
+    speed_of_light = pin->GetOrAddReal("particles","speed_of_light",1.0);
+  }
+
+  // Monte Carlo tracers are moved by the mass fluxes of the fluid stored on cell faces
+  if (pusher == ParticlesPusher::lagrangian_mc) {
+    bool has_hydro = pin->DoesBlockExist("hydro");
+    if (!(has_hydro) && !(pin->DoesBlockExist("mhd"))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Monte Carlo tracer particles require <hydro> or <mhd> "
+                << "block in input file" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (has_hydro && pin->GetOrAddBoolean("hydro","fused",false)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Monte Carlo tracer particles cannot be used with "
+                << "<hydro>/fused=true, since fluxes are not stored" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    mc_seed = pin->GetOrAddInteger("particles","mc_seed",1);
+  }
+
   // set dimensions of particle arrays. Note particles only work in 2D/3D
   if (pmy_pack->pmesh->one_d) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
@@ -76,7 +116,9 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     case ParticleType::cosmic_ray:
       {
         int ndim=4;
-        if (pmy_pack->pmesh->three_d) {ndim+=2;}
+        // Lorentz-force pushers always evolve three velocity components
+        if (pmy_pack->pmesh->three_d || pusher == ParticlesPusher::boris ||
+            pusher == ParticlesPusher::higuera_cary) {ndim+=2;}
         nrdata = ndim;
         nidata = 2;
         break;
@@ -84,17 +126,68 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     default:
       break;
   }
-  Kokkos::realloc(prtcl_rdata, nrdata, nprtcl_thispack);
-  Kokkos::realloc(prtcl_idata, nidata, nprtcl_thispack);
+  // allocate particle arrays with spare capacity, so that particles received from other
+  // ranks usually fit without reallocation
+  capacity_slack = pin->GetOrAddReal("particles","capacity_slack",0.25);
+  int capacity = static_cast<int>((1.0 + capacity_slack)*nprtcl_thispack);
+  Kokkos::realloc(prtcl_rdata, nrdata, capacity);
+  Kokkos::realloc(prtcl_idata, nidata, capacity);
+
+  // Morton rank of each active cell within a MeshBlock, used to sort particles by cell
+  sort_interval = pin->GetOrAddInteger("particles","sort_interval",0);
+  {
+    int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+    std::vector<std::pair<std::uint64_t,int>> morton(ncells);
+    for (int k=0; k<nx3; ++k) {
+      for (int j=0; j<nx2; ++j) {
+        for (int i=0; i<nx1; ++i) {
+          std::uint64_t code = 0;
+          for (int b=0; b<21; ++b) {
+            code |= ((static_cast<std::uint64_t>(i) >> b) & 1) << (3*b);
+            code |= ((static_cast<std::uint64_t>(j) >> b) & 1) << (3*b + 1);
+            code |= ((static_cast<std::uint64_t>(k) >> b) & 1) << (3*b + 2);
+          }
+          int c = i + nx1*(j + nx2*k);
+          morton[c] = std::make_pair(code, c);
+        }
+      }
+    }
+    std::sort(morton.begin(), morton.end());
+    Kokkos::realloc(cell_rank, nx3, nx2, nx1);
+    auto cell_rank_h = Kokkos::create_mirror_view(cell_rank);
+    for (int n=0; n<ncells; ++n) {
+      int c = morton[n].second;
+      cell_rank_h(c/(nx1*nx2), (c/nx1)%nx2, c%nx1) = n;
+    }
+    Kokkos::deep_copy(cell_rank, cell_rank_h);
+  }
 
   // allocate boundary object
   pbval_part = new ParticlesBoundaryValues(this, pin);
+
+  // allocate moments and boundary buffers used to sum them over MeshBlocks
+  if (pin->GetOrAddBoolean("particles","deposit",false)) {
+    if (pmy_pack->pmesh->multilevel) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Deposition of particle moments requires a uniform Mesh"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    int ng = indcs.ng;
+    int n1 = indcs.nx1 + 2*ng;
+    int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+    int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+    Kokkos::realloc(moments, pmy_pack->nmb_thispack, 4, n3, n2, n1);
+    pbval_mom = new MeshBoundaryValuesCC(pmy_pack, pin, false);
+    pbval_mom->InitializeBuffers(4);
+  }
 }
 
 //----------------------------------------------------------------------------------------
 // destructor
 
 Particles::~Particles() {
+  delete pbval_mom;
 }
 
 //----------------------------------------------------------------------------------------
@@ -137,4 +230,91 @@ void Particles::CreateParticleTags(ParameterInput *pin) {
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Particles::ReserveParticles()
+//! \brief Ensures particle arrays can hold npart particles, preserving existing data.
+//! Arrays are grown with spare capacity (capacity_slack) when too small.  With shrink,
+//! they are also shrunk when less than a quarter full.  Since arrays are otherwise never
+//! shrunk, steady-state exchange of particles between ranks performs no reallocations.
+
+void Particles::ReserveParticles(int npart, bool shrink) {
+  int capacity = prtcl_rdata.extent_int(1);
+  if (npart <= capacity && (!shrink || 4*npart >= capacity)) return;
+  int new_capacity = static_cast<int>((1.0 + capacity_slack)*npart);
+  new_capacity = std::max(new_capacity, npart);
+  Kokkos::resize(prtcl_rdata, nrdata, new_capacity);
+  Kokkos::resize(prtcl_idata, nidata, new_capacity);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Particles::SortParticles()
+//! \brief Reorders particle arrays by MeshBlock, and then by Morton index of the cell
+//! containing each particle, with a counting sort on the device.  Particles in the same
+//! cell are then contiguous in memory and neighboring cells are close, which improves
+//! cache use and coalescing of grid lookups by pushers.  Also sets cell_offset.
+
+void Particles::SortParticles() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int ncells = nx1*nx2*nx3;
+  int nmb = pmy_pack->nmb_thispack;
+  int nbins = nmb*ncells;
+  int npart = nprtcl_thispack;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto gids = pmy_pack->gids;
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+  auto &rank = cell_rank;
+
+  // cell containing each particle, and number of particles in each cell
+  auto key = transient_pool::Get<DvceArray1D<int>>("prtcl_key", std::max(1, npart));
+  auto count = transient_pool::Get<DvceArray1D<int>>("prtcl_count", nbins);
+  par_for("psort_key",DevExeSpace(),0,(npart-1), KOKKOS_LAMBDA(const int p) {
+    int m = Kokkos::min(Kokkos::max(pi(PGID,p) - gids, 0), nmb-1);
+    int ip = static_cast<int>((pr(IPX,p) - mbsize.d_view(m).x1min)/mbsize.d_view(m).dx1);
+    ip = Kokkos::min(Kokkos::max(ip, 0), nx1-1);
+    int jp = 0, kp = 0;
+    if (multi_d) {
+      jp = static_cast<int>((pr(IPY,p) - mbsize.d_view(m).x2min)/mbsize.d_view(m).dx2);
+      jp = Kokkos::min(Kokkos::max(jp, 0), nx2-1);
+    }
+    if (three_d) {
+      kp = static_cast<int>((pr(IPZ,p) - mbsize.d_view(m).x3min)/mbsize.d_view(m).dx3);
+      kp = Kokkos::min(Kokkos::max(kp, 0), nx3-1);
+    }
+    key(p) = m*ncells + rank(kp,jp,ip);
+    Kokkos::atomic_increment(&count(key(p)));
+  });
+
+  // offsets of first particle in each cell
+  Kokkos::realloc(cell_offset, nbins+1);
+  auto &offset = cell_offset;
+  Kokkos::parallel_scan("psort_scan", Kokkos::RangePolicy<>(DevExeSpace(), 0, nbins+1),
+  KOKKOS_LAMBDA(const int c, int &sum, const bool final) {
+    if (final) {offset(c) = sum;}
+    if (c < nbins) {sum += count(c);}
+  });
+  if (npart == 0) return;
+
+  // scatter particles into new arrays, then replace old arrays
+  Kokkos::deep_copy(count, 0);
+  DvceArray2D<Real> new_rdata("prtcl_rdata", nrdata, prtcl_rdata.extent_int(1));
+  DvceArray2D<int>  new_idata("prtcl_idata", nidata, prtcl_idata.extent_int(1));
+  int nrdata_ = nrdata, nidata_ = nidata;
+  par_for("psort_move",DevExeSpace(),0,(npart-1), KOKKOS_LAMBDA(const int p) {
+    int c = key(p);
+    int dest = offset(c) + Kokkos::atomic_fetch_add(&count(c), 1);
+    for (int v=0; v<nidata_; ++v) {
+      new_idata(v,dest) = pi(v,p);
+    }
+    for (int v=0; v<nrdata_; ++v) {
+      new_rdata(v,dest) = pr(v,p);
+    }
+  });
+  prtcl_rdata = new_rdata;
+  prtcl_idata = new_idata;
+}
+
 } // namespace particles
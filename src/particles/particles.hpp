@@ -20,7 +20,8 @@
 // forward declarations
 
 // constants that enumerate ParticlesPusher options
-enum class ParticlesPusher {drift, leap_frog, lagrangian_tracer, lagrangian_mc};
+enum class ParticlesPusher {drift, leap_frog, lagrangian_tracer, lagrangian_mc, boris,
+                             higuera_cary};
 
 // constants that enumerate ParticleTypes
 enum class ParticleType {cosmic_ray};
@@ -38,10 +39,28 @@ struct ParticlesTaskIDs {
   TaskID recvp;
   TaskID csend;
   TaskID crecv;
+  TaskID sort;
 };
 
 namespace particles {
 
+//----------------------------------------------------------------------------------------
+//! \fn void TSCWeights()
+//! \brief Triangular-shaped-cloud weights w[0:2] of cells ii-1:ii+1 for a particle at
+//! x, where ii is the index of the cell whose center is nearest to x.
+
+KOKKOS_INLINE_FUNCTION
+void TSCWeights(const Real x, const Real xmin, const Real dx, const int is,
+                int &ii, Real w[3]) {
+  Real xi = (x - xmin)/dx - 0.5;  // position in units of cells from first cell center
+  int i0 = static_cast<int>(Kokkos::floor(xi + 0.5));
+  Real d = xi - static_cast<Real>(i0);
+  w[0] = 0.5*SQR(0.5 - d);
+  w[1] = 0.75 - SQR(d);
+  w[2] = 0.5*SQR(0.5 + d);
+  ii = i0 + is;
+}
+
 //----------------------------------------------------------------------------------------
 //! \class Particles
 
@@ -54,15 +73,35 @@ class Particles {
   // data
   ParticleType particle_type;
   int nprtcl_thispack;             // number of particles this MeshBlockPack
+  Real capacity_slack;             // fractional spare capacity of particle arrays
   int nrdata, nidata;
 //  DvceArray1D<int>  prtcl_gid;     // GID of MeshBlock containing each par
 //  DvceArray2D<Real> prtcl_pos;     // positions
 //  DvceArray2D<Real> prtcl_vel;     // velocities
+  // Particle arrays have capacity (extent in the second index) of at least
+  // nprtcl_thispack.  Only the first nprtcl_thispack entries are valid.
   DvceArray2D<Real> prtcl_rdata;   // real number properties each particle (x,v,etc.)
   DvceArray2D<int>  prtcl_idata;   // integer properties each particle (gid, tag, etc.)
   Real dtnew;
 
+  // Particles are periodically reordered by MeshBlock and then by Morton index of the
+  // cell containing them.  After each sort, particles in cell (k,j,i) of MeshBlock m are
+  // stored at [cell_offset(c), cell_offset(c+1)) with c = m*ncells + cell_rank(k,j,i)
+  int sort_interval;               // cycles between sorts (0 to never sort)
+  DvceArray3D<int> cell_rank;      // Morton rank of each active cell in a MeshBlock
+  DvceArray1D<int> cell_offset;    // start of particles in each cell (nmb*ncells+1)
+
+  // Moments deposited to the Mesh by DepositMoments() with <particles>/deposit=true:
+  // number density and number flux (n, n*vx, n*vy, n*vz), including ghost cells
+  DvceArray5D<Real> moments;
+  MeshBoundaryValuesCC *pbval_mom = nullptr;
+
   ParticlesPusher pusher;
+  // Lorentz-force pushers (boris, higuera_cary) for cosmic rays in MHD fields
+  Real q_over_m;                   // charge-to-mass ratio
+  Real speed_of_light;             // speed of light (only used by higuera_cary)
+  // Monte Carlo tracers (lagrangian_mc) moved between cells according to mass fluxes
+  int mc_seed;                     // seed of counter-based random numbers
 
   // Boundary communication buffers and functions for particles
   ParticlesBoundaryValues *pbval_part;
@@ -72,6 +111,9 @@ class Particles {
 
   // functions...
   void CreateParticleTags(ParameterInput *pin);
+  void SortParticles();
+  void ReserveParticles(int npart, bool shrink = false);
+  void DepositMoments();
   void AssembleTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
   TaskStatus Push(Driver *pdriver, int stage);
   TaskStatus NewGID(Driver *pdriver, int stage);
@@ -81,6 +123,7 @@ class Particles {
   TaskStatus RecvP(Driver *pdriver, int stage);
   TaskStatus ClearSend(Driver *pdriver, int stage);
   TaskStatus ClearRecv(Driver *pdriver, int stage);
+  TaskStatus Sort(Driver *pdriver, int stage);
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Particles
@@ -0,0 +1,116 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file particles_deposit.cpp
+//! \brief deposition of particle moments to the Mesh
+
+#include <cstdlib>
+#include <iostream>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals/bvals.hpp"
+#include "particles.hpp"
+
+namespace particles {
+//----------------------------------------------------------------------------------------
+//! \fn void Particles::DepositMoments()
+//! \brief Deposits number density and number flux of particles to the moments array with
+//! TSC weights.  Particles are first sorted by cell, so that each cell can gather the
+//! contributions of particles in the 3^d cells around it without atomics (and with a
+//! result independent of the order of particles).  Contributions to ghost cells are then
+//! added to the active cells of neighboring MeshBlocks, and ghost cells are refilled.
+
+void Particles::DepositMoments() {
+  if (pbval_mom == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Deposition of particle moments requires <particles>/deposit=true"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // cell_offset is only valid directly after sorting
+  SortParticles();
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells = indcs.nx1*indcs.nx2*indcs.nx3;
+  int nmb = pmy_pack->nmb_thispack;
+  int n1m1 = moments.extent_int(4) - 1;
+  int n2m1 = moments.extent_int(3) - 1;
+  int n3m1 = moments.extent_int(2) - 1;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  bool relativistic = (pusher == ParticlesPusher::higuera_cary);
+  bool has_vz = (nrdata > IPVZ);
+  Real c = speed_of_light;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &pr = prtcl_rdata;
+  auto &rank = cell_rank;
+  auto &offset = cell_offset;
+  auto &mom = moments;
+
+  par_for("pdeposit",DevExeSpace(),0,(nmb-1),0,n3m1,0,n2m1,0,n1m1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real sum[4] = {0.0, 0.0, 0.0, 0.0};
+    int dkl = (three_d)? -1 : 0, dku = -dkl;
+    int djl = (multi_d)? -1 : 0, dju = -djl;
+    for (int dk=dkl; dk<=dku; ++dk) {
+      for (int dj=djl; dj<=dju; ++dj) {
+        for (int di=-1; di<=1; ++di) {
+          // particles in active cell (kk,jj,ii) contribute to (k,j,i)
+          int ii = i + di, jj = j + dj, kk = k + dk;
+          if (ii < is || ii > ie || jj < js || jj > je || kk < ks || kk > ke) continue;
+          int cell = m*ncells + rank(kk-ks,jj-js,ii-is);
+          for (int p=offset(cell); p<offset(cell+1); ++p) {
+            int ip, jp, kp;
+            Real wx[3], wy[3] = {0.0, 1.0, 0.0}, wz[3] = {0.0, 1.0, 0.0};
+            TSCWeights(pr(IPX,p), mbsize.d_view(m).x1min, mbsize.d_view(m).dx1, is, ip,
+                       wx);
+            if (multi_d) {
+              TSCWeights(pr(IPY,p), mbsize.d_view(m).x2min, mbsize.d_view(m).dx2, js, jp,
+                         wy);
+            }
+            if (three_d) {
+              TSCWeights(pr(IPZ,p), mbsize.d_view(m).x3min, mbsize.d_view(m).dx3, ks, kp,
+                         wz);
+            }
+            Real w = wx[1-di]*wy[1-dj]*wz[1-dk];
+            Real v[3] = {pr(IPVX,p), pr(IPVY,p), (has_vz)? pr(IPVZ,p) : 0.0};
+            if (relativistic) {
+              Real gam = sqrt(1.0 + (SQR(v[0]) + SQR(v[1]) + SQR(v[2]))/SQR(c));
+              for (int n=0; n<3; ++n) {v[n] /= gam;}
+            }
+            sum[0] += w;
+            sum[1] += w*v[0];
+            sum[2] += w*v[1];
+            sum[3] += w*v[2];
+          }
+        }
+      }
+    }
+    Real vol = mbsize.d_view(m).dx1*mbsize.d_view(m).dx2*mbsize.d_view(m).dx3;
+    for (int n=0; n<4; ++n) {
+      mom(m,n,k,j,i) = sum[n]/vol;
+    }
+  });
+
+  // add contributions deposited in ghost cells to active cells of neighbors
+  (void) pbval_mom->InitRecv(4);
+  (void) pbval_mom->PackAndSendGhostSumCC(moments);
+  (void) pbval_mom->ClearSend();
+  (void) pbval_mom->ClearRecv();
+  (void) pbval_mom->RecvAndUnpackGhostSumCC(moments);
+
+  // then fill ghost cells with the summed moments of neighbors
+  (void) pbval_mom->InitRecv(4);
+  (void) pbval_mom->PackAndSendCC(moments, moments);
+  (void) pbval_mom->ClearSend();
+  (void) pbval_mom->ClearRecv();
+  (void) pbval_mom->RecvAndUnpackCC(moments, moments);
+}
+
+} // namespace particles
@@ -6,12 +6,51 @@
 //! \file particle_pushers.cpp
 //  \brief
 
+#include <cstdint>  // uint64_t
+
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "utils/random.hpp"
 #include "particles.hpp"
 
 namespace particles {
+//----------------------------------------------------------------------------------------
+//! \fn void InterpolateEB()
+//! \brief TSC interpolation of the cell-centered magnetic field and of the ideal MHD
+//! electric field E = -v x B (computed at each cell) to particle p.
+
+KOKKOS_INLINE_FUNCTION
+void InterpolateEB(const int m, const int ii, const int jj, const int kk,
+                   const Real wx[3], const Real wy[3], const Real wz[3],
+                   const int ny, const int nz, const DvceArray5D<Real> &w0,
+                   const DvceArray5D<Real> &bcc0, Real e[3], Real b[3]) {
+  for (int n=0; n<3; ++n) {
+    e[n] = 0.0;
+    b[n] = 0.0;
+  }
+  for (int c=0; c<nz; ++c) {
+    int k = (nz == 1)? kk : kk - 1 + c;
+    for (int bb=0; bb<ny; ++bb) {
+      int j = (ny == 1)? jj : jj - 1 + bb;
+      for (int a=0; a<3; ++a) {
+        int i = ii - 1 + a;
+        Real wght = wx[a]*((ny == 1)? 1.0 : wy[bb])*((nz == 1)? 1.0 : wz[c]);
+        Real vx = w0(m,IVX,k,j,i), vy = w0(m,IVY,k,j,i), vz = w0(m,IVZ,k,j,i);
+        Real bx = bcc0(m,IBX,k,j,i), by = bcc0(m,IBY,k,j,i), bz = bcc0(m,IBZ,k,j,i);
+        e[0] -= wght*(vy*bz - vz*by);
+        e[1] -= wght*(vz*bx - vx*bz);
+        e[2] -= wght*(vx*by - vy*bx);
+        b[0] += wght*bx;
+        b[1] += wght*by;
+        b[2] += wght*bz;
+      }
+    }
+  }
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn  void Particles::ParticlesPush
 //  \brief
@@ -50,6 +89,150 @@ TaskStatus Particles::Push(Driver *pdriver, int stage) {
       });
 
     break;
+
+    // Monte Carlo tracers move to a neighboring cell with probability equal to the
+    // fraction of the mass of their cell that leaves through each face over dt.  The
+    // tracers in each cell are processed together using the sorted particle layout, so
+    // that the density and face fluxes are read once per cell, and each tracer draws a
+    // counter-based random number from its tag and the cycle.  Since particles are pushed
+    // before the fluid, mass fluxes are those of the last stage of the previous cycle.
+    case ParticlesPusher::lagrangian_mc:
+    {
+      SortParticles();
+      int ie = indcs.ie, je = indcs.je, ke = indcs.ke;
+      int ncells = indcs.nx1*indcs.nx2*indcs.nx3;
+      int nmb = pmy_pack->nmb_thispack;
+      bool use_hydro = (pmy_pack->phydro != nullptr);
+      auto &u0 = (use_hydro)? pmy_pack->phydro->u0 : pmy_pack->pmhd->u0;
+      auto &flx = (use_hydro)? pmy_pack->phydro->uflx : pmy_pack->pmhd->uflx;
+      auto &rank = cell_rank;
+      auto &offset = cell_offset;
+      std::uint64_t seed = static_cast<std::uint64_t>(mc_seed);
+      std::uint64_t cycle = static_cast<std::uint64_t>(pmy_pack->pmesh->ncycle);
+
+      par_for("part_mc",DevExeSpace(),0,(nmb-1),ks,ke,js,je,is,ie,
+      KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+        int cell = m*ncells + rank(k-ks,j-js,i-is);
+        int pstart = offset(cell), pend = offset(cell+1);
+        if (pstart == pend) return;
+
+        // probability of leaving through each face (x1 inner/outer, x2..., x3...)
+        Real dx[3] = {mbsize.d_view(m).dx1, mbsize.d_view(m).dx2, mbsize.d_view(m).dx3};
+        Real dtm = dt_/u0(m,IDN,k,j,i);
+        Real prob[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        prob[0] = fmax(-flx.x1f(m,IDN,k,j,i  ), 0.0)*dtm/dx[0];
+        prob[1] = fmax( flx.x1f(m,IDN,k,j,i+1), 0.0)*dtm/dx[0];
+        if (multi_d) {
+          prob[2] = fmax(-flx.x2f(m,IDN,k,j  ,i), 0.0)*dtm/dx[1];
+          prob[3] = fmax( flx.x2f(m,IDN,k,j+1,i), 0.0)*dtm/dx[1];
+        }
+        if (three_d) {
+          prob[4] = fmax(-flx.x3f(m,IDN,k  ,j,i), 0.0)*dtm/dx[2];
+          prob[5] = fmax( flx.x3f(m,IDN,k+1,j,i), 0.0)*dtm/dx[2];
+        }
+
+        // move each tracer by one cell through the face it is transferred across (if any)
+        int ipos[3] = {IPX, IPY, IPZ};
+        for (int p=pstart; p<pend; ++p) {
+          std::uint64_t tag = static_cast<std::uint32_t>(pi(PTAG,p));
+          Real r = RanCounter(seed, (cycle << 32) | tag);
+          Real sum = 0.0;
+          for (int f=0; f<6; ++f) {
+            sum += prob[f];
+            if (r < sum) {
+              pr(ipos[f/2],p) += ((f%2) == 0)? -dx[f/2] : dx[f/2];
+              break;
+            }
+          }
+        }
+      });
+    }
+    break;
+
+    // Lorentz-force pushers.  E and B are TSC interpolated from the MHD fluid to the
+    // particle position at the start of the step, velocities (four-velocities for
+    // higuera_cary) are kicked over dt, and then positions drift over dt with the new
+    // velocity.  Particles are most efficiently pushed after SortParticles(), since
+    // particles in the same cell then read the same field data.
+    case ParticlesPusher::boris:
+    case ParticlesPusher::higuera_cary:
+    {
+      bool relativistic = (pusher == ParticlesPusher::higuera_cary);
+      auto &w0 = pmy_pack->pmhd->w0;
+      auto &bcc0 = pmy_pack->pmhd->bcc0;
+      int ny = (multi_d)? 3 : 1;
+      int nz = (three_d)? 3 : 1;
+      Real qmdt2 = 0.5*q_over_m*dt_;
+      Real c = speed_of_light;
+      par_for("part_lorentz",DevExeSpace(),0,(nprtcl_thispack-1),
+      KOKKOS_LAMBDA(const int p) {
+        int m = pi(PGID,p) - gids;
+        int ii, jj = js, kk = ks;
+        Real wx[3], wy[3] = {0.0, 1.0, 0.0}, wz[3] = {0.0, 1.0, 0.0};
+        TSCWeights(pr(IPX,p), mbsize.d_view(m).x1min, mbsize.d_view(m).dx1, is, ii, wx);
+        if (multi_d) {
+          TSCWeights(pr(IPY,p), mbsize.d_view(m).x2min, mbsize.d_view(m).dx2, js, jj, wy);
+        }
+        if (three_d) {
+          TSCWeights(pr(IPZ,p), mbsize.d_view(m).x3min, mbsize.d_view(m).dx3, ks, kk, wz);
+        }
+        Real e[3], b[3];
+        InterpolateEB(m, ii, jj, kk, wx, wy, wz, ny, nz, w0, bcc0, e, b);
+
+        // half electric kick
+        Real u[3] = {pr(IPVX,p), pr(IPVY,p), pr(IPVZ,p)};
+        for (int n=0; n<3; ++n) {u[n] += qmdt2*e[n];}
+
+        // magnetic rotation
+        Real t[3] = {qmdt2*b[0], qmdt2*b[1], qmdt2*b[2]};
+        Real t2 = SQR(t[0]) + SQR(t[1]) + SQR(t[2]);
+        Real gam = 1.0;
+        if (relativistic) {
+          // Higuera & Cary (2017): rotation with Lorentz factor that preserves the
+          // E x B drift velocity
+          Real gm2 = 1.0 + (SQR(u[0]) + SQR(u[1]) + SQR(u[2]))/SQR(c);
+          Real ustar = (u[0]*t[0] + u[1]*t[1] + u[2]*t[2])/c;
+          Real sigma = gm2 - t2;
+          gam = sqrt(0.5*(sigma + sqrt(SQR(sigma) + 4.0*(t2 + SQR(ustar)))));
+          for (int n=0; n<3; ++n) {t[n] /= gam;}
+          t2 /= SQR(gam);
+          Real s = 1.0/(1.0 + t2);
+          Real udt = u[0]*t[0] + u[1]*t[1] + u[2]*t[2];
+          Real up[3];
+          up[0] = s*(u[0] + udt*t[0] + (u[1]*t[2] - u[2]*t[1]));
+          up[1] = s*(u[1] + udt*t[1] + (u[2]*t[0] - u[0]*t[2]));
+          up[2] = s*(u[2] + udt*t[2] + (u[0]*t[1] - u[1]*t[0]));
+          u[0] = up[0] + (up[1]*t[2] - up[2]*t[1]);
+          u[1] = up[1] + (up[2]*t[0] - up[0]*t[2]);
+          u[2] = up[2] + (up[0]*t[1] - up[1]*t[0]);
+        } else {
+          // Boris (1970) rotation
+          Real s = 2.0/(1.0 + t2);
+          Real v1[3];
+          v1[0] = u[0] + (u[1]*t[2] - u[2]*t[1]);
+          v1[1] = u[1] + (u[2]*t[0] - u[0]*t[2]);
+          v1[2] = u[2] + (u[0]*t[1] - u[1]*t[0]);
+          u[0] += s*(v1[1]*t[2] - v1[2]*t[1]);
+          u[1] += s*(v1[2]*t[0] - v1[0]*t[2]);
+          u[2] += s*(v1[0]*t[1] - v1[1]*t[0]);
+        }
+
+        // half electric kick
+        for (int n=0; n<3; ++n) {u[n] += qmdt2*e[n];}
+        pr(IPVX,p) = u[0];
+        pr(IPVY,p) = u[1];
+        pr(IPVZ,p) = u[2];
+
+        // drift with three-velocity
+        if (relativistic) {
+          gam = sqrt(1.0 + (SQR(u[0]) + SQR(u[1]) + SQR(u[2]))/SQR(c));
+        }
+        pr(IPX,p) += dt_*u[0]/gam;
+        if (multi_d) {pr(IPY,p) += dt_*u[1]/gam;}
+        if (three_d) {pr(IPZ,p) += dt_*u[2]/gam;}
+      });
+    }
+    break;
   default:
     break;
   }
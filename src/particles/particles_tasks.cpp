@@ -29,14 +29,24 @@ void Particles::AssembleTasks(std::map<std::string, std::shared_ptr<TaskList>> t
   TaskID none(0);
 
   // particle integration done in "before_timeintegrator" task list
-  id.push   = tl["before_timeintegrator"]->AddTask(&Particles::Push, this, none);
-  id.newgid = tl["before_timeintegrator"]->AddTask(&Particles::NewGID, this, id.push);
-  id.count  = tl["before_timeintegrator"]->AddTask(&Particles::SendCnt, this, id.newgid);
-  id.irecv  = tl["before_timeintegrator"]->AddTask(&Particles::InitRecv, this, id.count);
-  id.sendp  = tl["before_timeintegrator"]->AddTask(&Particles::SendP, this, id.irecv);
-  id.recvp  = tl["before_timeintegrator"]->AddTask(&Particles::RecvP, this, id.sendp);
-  id.crecv  = tl["before_timeintegrator"]->AddTask(&Particles::ClearRecv, this, id.recvp);
-  id.csend  = tl["before_timeintegrator"]->AddTask(&Particles::ClearSend, this, id.crecv);
+  id.push   = tl["before_timeintegrator"]->AddTask(&Particles::Push, this, none,
+                                                   "Part_Push");
+  id.newgid = tl["before_timeintegrator"]->AddTask(&Particles::NewGID, this, id.push,
+                                                   "Part_NewGID");
+  id.count  = tl["before_timeintegrator"]->AddTask(&Particles::SendCnt, this, id.newgid,
+                                                   "Part_SendCnt");
+  id.irecv  = tl["before_timeintegrator"]->AddTask(&Particles::InitRecv, this, id.count,
+                                                   "Part_InitRecv");
+  id.sendp  = tl["before_timeintegrator"]->AddTask(&Particles::SendP, this, id.irecv,
+                                                   "Part_SendP");
+  id.recvp  = tl["before_timeintegrator"]->AddTask(&Particles::RecvP, this, id.sendp,
+                                                   "Part_RecvP");
+  id.crecv  = tl["before_timeintegrator"]->AddTask(&Particles::ClearRecv, this, id.recvp,
+                                                   "Part_ClearRecv");
+  id.csend  = tl["before_timeintegrator"]->AddTask(&Particles::ClearSend, this, id.crecv,
+                                                   "Part_ClearSend");
+  id.sort   = tl["before_timeintegrator"]->AddTask(&Particles::Sort, this, id.csend,
+                                                   "Part_Sort");
 
   return;
 }
@@ -110,4 +120,16 @@ TaskStatus Particles::ClearRecv(Driver *pdrive, int stage) {
   return tstat;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Particles::Sort
+//! \brief Wrapper task list function that reorders particles by cell every sort_interval
+//! cycles, once all particles are on their MeshBlock.
+
+TaskStatus Particles::Sort(Driver *pdrive, int stage) {
+  if (sort_interval > 0 && (pmy_pack->pmesh->ncycle % sort_interval) == 0) {
+    SortParticles();
+  }
+  return TaskStatus::complete;
+}
+
 } // namespace particles
@@ -62,43 +62,37 @@ struct tov_pgen {
   int n_r; // Point where pressure goes to zero.
 
   bool isotropic; // Whether or not the TOV uses isotropic coordinates.
+
+  int ntab; // Number of points in resampled table
+  Real dr_tab; // Uniform spacing of table in (isotropic, if enabled) radius
+  DualArray2D<Real> tab; // Resampled rho, P, M, alp, R(Schwarzschild) inside star
 };
 
+// Columns of resampled TOV table
+enum {ITAB_RHO, ITAB_P, ITAB_M, ITAB_ALP, ITAB_R, NTAB_VARS};
+
 // Prototypes for functions used internally in this pgen.
 template<class TOVEOS>
 static void ConstructTOV(tov_pgen& pgen, TOVEOS& eos);
 template<class TOVEOS>
+static void ResampleTOV(tov_pgen& pgen, TOVEOS& eos);
+template<class TOVEOS>
 static void RHS(Real r, Real P, Real m, Real alp, Real R, TOVEOS& eos,
                 tov_pgen& tov, Real& dP, Real& dm, Real& dalp, Real& dR);
 KOKKOS_INLINE_FUNCTION
-static Real FindSchwarzschildR(const tov_pgen& pgen, Real r_iso, Real mass);
-KOKKOS_INLINE_FUNCTION
-static int FindIsotropicIndex(const tov_pgen& pgen, Real r_iso);
-template<class TOVEOS>
-KOKKOS_INLINE_FUNCTION
-static void GetPrimitivesAtPoint(const tov_pgen& pgen, const TOVEOS& eos, Real r,
-                                 Real &rho, Real &p, Real &m, Real &alp);
-template<class TOVEOS>
-KOKKOS_INLINE_FUNCTION
-static void GetPrimitivesAtIsoPoint(const tov_pgen& pgen, const TOVEOS& eos, Real r_iso,
-                                 Real &rho, Real &p, Real &m, Real &alp);
-template<class TOVEOS>
+static Real LookupTable(const tov_pgen& pgen, Real r, int n);
 KOKKOS_INLINE_FUNCTION
-static void GetPandRho(const tov_pgen& pgen, const TOVEOS& eos,
-                       Real r, Real &rho, Real &p);
-template<class TOVEOS>
+static void GetPrimitivesAtPoint(const tov_pgen& pgen, Real r, Real &rho, Real &p,
+                                 Real &m, Real &alp, Real &r_schw);
 KOKKOS_INLINE_FUNCTION
-static void GetPandRhoIso(const tov_pgen& pgen, const TOVEOS& eos,
-                          Real r, Real &rho, Real &p);
+static void GetPandRho(const tov_pgen& pgen, Real r, Real &rho, Real &p);
 KOKKOS_INLINE_FUNCTION
 static Real Interpolate(Real x,
                         const Real x1, const Real x2, const Real y1, const Real y2);
-template<class TOVEOS>
 KOKKOS_INLINE_FUNCTION
-static Real A1(const tov_pgen& pgen, const TOVEOS& eos, Real x1, Real x2, Real x3);
-template<class TOVEOS>
+static Real A1(const tov_pgen& pgen, Real x1, Real x2, Real x3);
 KOKKOS_INLINE_FUNCTION
-static Real A2(const tov_pgen& pgen, const TOVEOS& eos, Real x1, Real x2, Real x3);
+static Real A2(const tov_pgen& pgen, Real x1, Real x2, Real x3);
 
 enum class LocationTag {Host, Device};
 
@@ -355,8 +349,9 @@ void SetupTOV(ParameterInput* pin, Mesh* pmy_mesh_, tov_pgen& tov) {
 
   bool minkowski = pin->GetOrAddBoolean("problem", "minkowski", false);
 
-  // Generate the TOV star
+  // Generate the TOV star, and resample it onto a uniform table for lookups on device
   ConstructTOV(tov, eos);
+  ResampleTOV(tov, eos);
 
   constexpr bool use_ye = std::is_same<TOVEOS, TabulatedEOS>::value;
 
@@ -415,34 +410,17 @@ void SetupTOV(ParameterInput* pin, Mesh* pmy_mesh_, tov_pgen& tov) {
     Real p_pert = 0.;
     Real ye = 0.5;
     auto &use_ye_ = use_ye;
-    //printf("Grabbing primitives!\n");
-    if (!tov.isotropic) {
-      GetPrimitivesAtPoint(tov_, eos_, r, rho, p, mass, alp);
-      if (r <= tov.R_edge) {
-        Real x = r/tov.R_edge;
-        vr = 0.5*tov_.v_pert*(3.0*x - x*x*x);
-        auto rand_gen = rand_pool64.get_state();
-        p_pert = 2.0*tov_.p_pert*(rand_gen.frand() - 0.5);
-        rand_pool64.free_state(rand_gen);
-        if constexpr (use_ye) {
-          ye = eos_.template GetYeFromRho<LocationTag::Device>(rho);
-        }
-      }
-    } else {
-      GetPrimitivesAtIsoPoint(tov_, eos_, r, rho, p, mass, alp);
-      r_schw = FindSchwarzschildR(tov, r, mass);
-      if (r_schw <= tov.R_edge) {
-        Real x = r_schw/tov.R_edge;
-        vr = 0.5*tov_.v_pert*(3.0*x - x*x*x);
-        auto rand_gen = rand_pool64.get_state();
-        p_pert = 2.0*tov_.p_pert*(rand_gen.frand() - 0.5);
-        rand_pool64.free_state(rand_gen);
-        if constexpr (use_ye) {
-          ye = eos_.template GetYeFromRho<LocationTag::Device>(rho);
-        }
+    GetPrimitivesAtPoint(tov_, r, rho, p, mass, alp, r_schw);
+    if (r_schw <= tov.R_edge) {
+      Real x = r_schw/tov.R_edge;
+      vr = 0.5*tov_.v_pert*(3.0*x - x*x*x);
+      auto rand_gen = rand_pool64.get_state();
+      p_pert = 2.0*tov_.p_pert*(rand_gen.frand() - 0.5);
+      rand_pool64.free_state(rand_gen);
+      if constexpr (use_ye) {
+        ye = eos_.template GetYeFromRho<LocationTag::Device>(rho);
       }
     }
-    //printf("Primitives retrieved!\n");
 
 
     // FIXME: assumes ideal gas!
@@ -556,8 +534,8 @@ void SetupTOV(ParameterInput* pin, Mesh* pmy_mesh_, tov_pgen& tov) {
       Real dx2 = size.d_view(m).dx2;
       Real dx3 = size.d_view(m).dx3;
 
-      a1(m,k,j,i) = A1(tov_, eos_, x1v, x2f, x3f);
-      a2(m,k,j,i) = A2(tov_, eos_, x1f, x2v, x3f);
+      a1(m,k,j,i) = A1(tov_, x1v, x2f, x3f);
+      a2(m,k,j,i) = A2(tov_, x1f, x2v, x3f);
       a3(m,k,j,i) = 0.0;
 
       // When neighboring MeshBock is at finer level, compute vector potential as sum of
@@ -591,7 +569,7 @@ void SetupTOV(ParameterInput* pin, Mesh* pmy_mesh_, tov_pgen& tov) {
           (nghbr.d_view(m,47).lev > mblev.d_view(m) && j==je+1 && k==ke+1)) {
         Real xl = x1v + 0.25*dx1;
         Real xr = x1v - 0.25*dx1;
-        a1(m,k,j,i) = 0.5*(A1(tov_, eos_, xl,x2f,x3f) + A1(tov_, eos_, xr,x2f,x3f));
+        a1(m,k,j,i) = 0.5*(A1(tov_, xl,x2f,x3f) + A1(tov_, xr,x2f,x3f));
       }
 
       // Correct A2 at x1-faces, x3-faces, and x1x3-edges
@@ -621,7 +599,7 @@ void SetupTOV(ParameterInput* pin, Mesh* pmy_mesh_, tov_pgen& tov) {
           (nghbr.d_view(m,39).lev > mblev.d_view(m) && i==ie+1 && k==ke+1)) {
         Real xl = x2v + 0.25*dx2;
         Real xr = x2v - 0.25*dx2;
-        a2(m,k,j,i) = 0.5*(A2(tov_, eos_, x1f,xl,x3f) + A2(tov_, eos_, x1f,xr,x3f));
+        a2(m,k,j,i) = 0.5*(A2(tov_, x1f,xl,x3f) + A2(tov_, x1f,xr,x3f));
       }
     });
 
@@ -706,6 +684,7 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   tov.v_pert = pin->GetOrAddReal("problem" , "v_pert", 0.0);
   tov.p_pert = pin->GetOrAddReal("problem", "p_pert", 0.0);
   tov.isotropic = pin->GetOrAddBoolean("problem", "isotropic", false);
+  tov.ntab = pin->GetOrAddInteger("problem", "ntab", tov.npoints);
 
   // Set the history function for a TOV star
   user_hist_func = &TOVHistory;
@@ -926,169 +905,114 @@ static void ConstructTOV(tov_pgen& tov, TOVEOS& eos) {
   tov.P.template sync<DevExeSpace>();
 }
 
+// Resample the TOV solution inside the star onto a table uniformly spaced in the
+// (isotropic, if enabled) radius, so that cells find their index without a search, and
+// density is tabulated rather than inverted from the EOS in every cell.
 template<class TOVEOS>
-KOKKOS_INLINE_FUNCTION
-static void GetPrimitivesAtPoint(const tov_pgen& tov, const TOVEOS& eos, Real r,
-                                 Real &rho, Real &p, Real &m, Real &alp) {
-  // Check if we're past the edge of the star.
-  // If so, we just return atmosphere with Schwarzschild.
-  if (r >= tov.R_edge) {
-    rho = 0.0;
-    p = 0.0;
-    m = tov.M_edge;
-    alp = sqrt(1.0 - 2.0*m/r);
-    return;
-  }
-  // Get the lower index for where our point must be located.
-  int idx = static_cast<int>(r/tov.dr);
-  const auto &R = tov.R.d_view;
-  const auto &Ps = tov.P.d_view;
-  const auto &alps = tov.alp.d_view;
-  const auto &Ms = tov.M.d_view;
-  // Interpolate to get the primitive.
-  p = Interpolate(r, R(idx), R(idx+1), Ps(idx), Ps(idx+1));
-  m = Interpolate(r, R(idx), R(idx+1), Ms(idx), Ms(idx+1));
-  alp = Interpolate(r, R(idx), R(idx+1), alps(idx), alps(idx+1));
-  // FIXME: Assumes ideal gas!
-  //rho = pow(p/tov.kappa, 1.0/tov.gamma);
-  rho = eos.template GetRhoFromP<LocationTag::Device>(p);
-}
-
-KOKKOS_INLINE_FUNCTION
-static int FindIsotropicIndex(const tov_pgen& tov, Real r_iso) {
-  // Perform a bisection search to find the closest index to the requested isotropic
-  // point.
-  const auto &R_iso = tov.R_iso.d_view;
-  int lb = 0;
-  int ub = tov.n_r;
-  int idx = lb;
-  while (R_iso(lb+1) < r_iso) {
-    idx = (lb + ub)/2;
-    if (R_iso(idx) < r_iso) {
-      lb = idx;
-    } else {
-      ub = idx;
+static void ResampleTOV(tov_pgen& tov, TOVEOS& eos) {
+  tov.ntab = std::max(tov.ntab, 2);
+  Kokkos::realloc(tov.tab, tov.ntab, static_cast<int>(NTAB_VARS));
+
+  const auto &R = tov.R.h_view;
+  const auto &R_iso = tov.R_iso.h_view;
+  const auto &Ps = tov.P.h_view;
+  const auto &Ms = tov.M.h_view;
+  const auto &alps = tov.alp.h_view;
+  const auto &coord = (tov.isotropic) ? R_iso : R;
+  Real r_edge = (tov.isotropic) ? tov.R_edge_iso : tov.R_edge;
+  tov.dr_tab = r_edge/static_cast<Real>(tov.ntab - 1);
+
+  // coordinates are monotonic, so a single forward sweep finds all indices
+  int idx = 0;
+  for (int n = 0; n < tov.ntab; n++) {
+    Real r = fmin(n*tov.dr_tab, r_edge);
+    while (idx < tov.n_r - 1 && coord(idx+1) < r) {
+      idx++;
     }
+    Real p = Interpolate(r, coord(idx), coord(idx+1), Ps(idx), Ps(idx+1));
+    tov.tab.h_view(n,ITAB_P) = p;
+    tov.tab.h_view(n,ITAB_M) = Interpolate(r, coord(idx), coord(idx+1),
+                                           Ms(idx), Ms(idx+1));
+    tov.tab.h_view(n,ITAB_ALP) = Interpolate(r, coord(idx), coord(idx+1),
+                                             alps(idx), alps(idx+1));
+    tov.tab.h_view(n,ITAB_R) = Interpolate(r, coord(idx), coord(idx+1),
+                                           R(idx), R(idx+1));
+    tov.tab.h_view(n,ITAB_RHO) =
+        eos.template GetRhoFromP<LocationTag::Host>(fmax(p, tov.pfloor));
   }
-  return lb;
+
+  // Sync the table to the GPU
+  tov.tab.template modify<HostMemSpace>();
+  tov.tab.template sync<DevExeSpace>();
 }
 
+// Linear interpolation of column n of the resampled table at radius r inside the star
 KOKKOS_INLINE_FUNCTION
-static Real FindSchwarzschildR(const tov_pgen& tov, Real r_iso, Real mass) {
-  if (r_iso > tov.R_edge_iso) {
-    Real psi = 1.0 + mass/(2.*r_iso);
-    return r_iso*psi*psi;
-  }
-
-  int idx = FindIsotropicIndex(tov, r_iso);
-  const auto &R_iso = tov.R_iso.d_view;
-  const auto &R = tov.R.d_view;
-  return Interpolate(r_iso, R_iso(idx), R_iso(idx+1), R(idx), R(idx+1));
+static Real LookupTable(const tov_pgen& tov, Real r, int n) {
+  const auto &tab = tov.tab.d_view;
+  Real x = r/tov.dr_tab;
+  int idx = static_cast<int>(x);
+  idx = (idx < tov.ntab - 2) ? idx : tov.ntab - 2;
+  Real f = x - idx;
+  return (1.0 - f)*tab(idx,n) + f*tab(idx+1,n);
 }
 
-template<class TOVEOS>
+// Get the primitives, mass, lapse and Schwarzschild radius at radius r, which is
+// isotropic if enabled.
 KOKKOS_INLINE_FUNCTION
-static void GetPrimitivesAtIsoPoint(const tov_pgen& tov, const TOVEOS& eos, Real r_iso,
-                                    Real &rho, Real &p, Real &m, Real &alp) {
+static void GetPrimitivesAtPoint(const tov_pgen& tov, Real r, Real &rho, Real &p,
+                                 Real &m, Real &alp, Real &r_schw) {
   // Check if we're past the edge of the star.
   // If so, we just return atmosphere with Schwarzschild.
-  if (r_iso >= tov.R_edge_iso) {
+  if (!tov.isotropic && r >= tov.R_edge) {
     rho = 0.0;
     p = 0.0;
     m = tov.M_edge;
-    alp = (1. - m/(2.*r_iso))/(1. + m/(2.*r_iso));
+    alp = sqrt(1.0 - 2.0*m/r);
+    r_schw = r;
     return;
   }
-  // Because the isotropic coordinates are not evenly spaced, we need to search to find
-  // the right index. We can set a lower bound because r_iso <= r, and then we choose the
-  // edge of the star as an upper bound.
-  const auto &R_iso = tov.R_iso.d_view;
-  int idx = FindIsotropicIndex(tov, r_iso);
-  const auto &Ps = tov.P.d_view;
-  const auto &alps = tov.alp.d_view;
-  const auto &Ms = tov.M.d_view;
-  if (idx >= tov.npoints || idx < 0) {
-    Kokkos::printf("There's a problem with the index!\n" // NOLINT
-           " idx = %d\n"
-           " r_iso = %g\n"
-           " dr = %g\n",idx,r_iso,tov.dr);
-  }
-  // Interpolate to get the primitive.
-  p = Interpolate(r_iso, R_iso(idx), R_iso(idx+1), Ps(idx), Ps(idx+1));
-  m = Interpolate(r_iso, R_iso(idx), R_iso(idx+1), Ms(idx), Ms(idx+1));
-  alp = Interpolate(r_iso, R_iso(idx), R_iso(idx+1), alps(idx), alps(idx+1));
-  // FIXME: Assumes ideal gas!
-  //rho = pow(p/tov.kappa, 1.0/tov.gamma);
-  rho = eos.template GetRhoFromP<LocationTag::Device>(fmax(p, tov.pfloor));
-  if (!isfinite(p)) {
-    Kokkos::printf("There's a problem with p!\n"); // NOLINT
-    assert(false);
-  }
-}
-
-template<class TOVEOS>
-KOKKOS_INLINE_FUNCTION
-static void GetPandRho(const tov_pgen& tov, const TOVEOS& eos,
-                       Real r, Real &rho, Real &p) {
-  if (r >= tov.R_edge) {
-    rho = 0.;
-    p   = 0.;
+  if (tov.isotropic && r >= tov.R_edge_iso) {
+    rho = 0.0;
+    p = 0.0;
+    m = tov.M_edge;
+    alp = (1. - m/(2.*r))/(1. + m/(2.*r));
+    Real psi = 1.0 + m/(2.*r);
+    r_schw = r*psi*psi;
     return;
   }
-  // Get the lower index for where our point must be located.
-  int idx = static_cast<int>(r/tov.dr);
-  const auto &R = tov.R.d_view;
-  const auto &Ps = tov.P.d_view;
-  // Interpolate to get the pressure
-  p = Interpolate(r, R(idx), R(idx+1), Ps(idx), Ps(idx+1));
-  // FIXME: Assumes ideal gas!
-  //rho = pow(p/tov.kappa, 1.0/tov.gamma);
-  rho = eos.template GetRhoFromP<LocationTag::Device>(p);
+  rho = LookupTable(tov, r, ITAB_RHO);
+  p = LookupTable(tov, r, ITAB_P);
+  m = LookupTable(tov, r, ITAB_M);
+  alp = LookupTable(tov, r, ITAB_ALP);
+  r_schw = (tov.isotropic) ? LookupTable(tov, r, ITAB_R) : r;
 }
 
-template<class TOVEOS>
 KOKKOS_INLINE_FUNCTION
-static void GetPandRhoIso(const tov_pgen& tov, const TOVEOS& eos,
-                          Real r, Real &rho, Real &p) {
-  if (r >= tov.R_edge_iso) {
+static void GetPandRho(const tov_pgen& tov, Real r, Real &rho, Real &p) {
+  Real r_edge = (tov.isotropic) ? tov.R_edge_iso : tov.R_edge;
+  if (r >= r_edge) {
     rho = 0.;
     p   = 0.;
     return;
   }
-  // We need to search to find the right index because isotropic coordinates aren't
-  // evenly spaced.
-  int idx = FindIsotropicIndex(tov, r);
-  const auto R_iso = tov.R_iso.d_view;
-  const auto &Ps = tov.P.d_view;
-  p = Interpolate(r, R_iso(idx), R_iso(idx+1), Ps(idx), Ps(idx+1));
-  // FIXME: Assumes ideal gas!
-  //rho = pow(p/tov.kappa, 1.0/tov.gamma);
-  rho = eos.template GetRhoFromP<LocationTag::Device>(p);
+  rho = LookupTable(tov, r, ITAB_RHO);
+  p = LookupTable(tov, r, ITAB_P);
 }
 
-template<class TOVEOS>
 KOKKOS_INLINE_FUNCTION
-static Real A1(const tov_pgen& tov, const TOVEOS& eos, Real x1, Real x2, Real x3) {
+static Real A1(const tov_pgen& tov, Real x1, Real x2, Real x3) {
   Real r = sqrt(SQR(x1) + SQR(x2) + SQR(x3));
   Real p, rho;
-  if (!tov.isotropic) {
-    GetPandRho(tov, eos, r, rho, p);
-  } else {
-    GetPandRhoIso(tov, eos, r, rho, p);
-  }
+  GetPandRho(tov, r, rho, p);
   return -x2*tov.b_norm*fmax(p - tov.pcut, 0.0)*pow(1.0 - rho/tov.rhoc,tov.magindex);
 }
 
-template<class TOVEOS>
 KOKKOS_INLINE_FUNCTION
-static Real A2(const tov_pgen& tov, const TOVEOS& eos, Real x1, Real x2, Real x3) {
+static Real A2(const tov_pgen& tov, Real x1, Real x2, Real x3) {
   Real r = sqrt(SQR(x1) + SQR(x2) + SQR(x3));
   Real p, rho;
-  if (!tov.isotropic) {
-    GetPandRho(tov, eos, r, rho, p);
-  } else {
-    GetPandRhoIso(tov, eos, r, rho, p);
-  }
+  GetPandRho(tov, r, rho, p);
   return x1*tov.b_norm*fmax(p - tov.pcut, 0.0)*pow(1.0 - rho/tov.rhoc,tov.magindex);
 }
 
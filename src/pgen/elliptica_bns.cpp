@@ -28,8 +28,26 @@
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
+#include "utils/id_import.hpp"
 #include "elliptica_id_reader_lib.h"
 
+namespace {
+// Fields imported from Elliptica
+enum {
+  i_alpha, i_betax, i_betay, i_betaz,
+  i_gxx, i_gxy, i_gxz, i_gyy, i_gyz, i_gzz,
+  i_Kxx, i_Kxy, i_Kxz, i_Kyy, i_Kyz, i_Kzz,
+  i_rho, i_p, i_vx, i_vy, i_vz,
+  NIDVARS
+};
+const char *idvar_names[NIDVARS] = {
+  "alpha", "betax", "betay", "betaz",
+  "adm_gxx", "adm_gxy", "adm_gxz", "adm_gyy", "adm_gyz", "adm_gzz",
+  "adm_Kxx", "adm_Kxy", "adm_Kxz", "adm_Kyy", "adm_Kyz", "adm_Kzz",
+  "grhd_rho", "grhd_p", "grhd_vx", "grhd_vy", "grhd_vz"
+};
+} // namespace
+
 void EllipticaBNSHistory(HistoryData *pdata, Mesh *pm);
 void EllipticaBNSRefinementCondition(MeshBlockPack *pmbp);
 
@@ -44,7 +62,6 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
   auto &indcs = pmy_mesh_->mb_indcs;
-  auto &size = pmbp->pmb->mb_size;
   int &is = indcs.is; int &ie = indcs.ie;
   int &js = indcs.js; int &je = indcs.je;
   int &ks = indcs.ks; int &ke = indcs.ke;
@@ -58,79 +75,37 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   std::string fname = pin->GetString("problem", "initial_data_file");
 
-  // Initialize the data reader
-  Elliptica_ID_Reader_T *idr = elliptica_id_reader_init(fname.c_str(),"generic");
-
-  // Fields to interpolate
-  idr->ifields = "alpha,betax,betay,betaz,"
-                 "adm_gxx,adm_gxy,adm_gxz,adm_gyy,adm_gyz,adm_gzz,"
-                 "adm_Kxx,adm_Kxy,adm_Kxz,adm_Kyy,adm_Kyz,adm_Kzz,"
-                 "grhd_rho,grhd_p,grhd_vx,grhd_vy,grhd_vz";
-
   int ncells1 = indcs.nx1 + 2*(indcs.ng);
   int ncells2 = indcs.nx2 + 2*(indcs.ng);
   int ncells3 = indcs.nx3 + 2*(indcs.ng);
   int nmb = pmbp->nmb_thispack;
 
-  int width = nmb*ncells1*ncells2*ncells3;
-
-  Real *x_coords = new Real[width];
-  Real *y_coords = new Real[width];
-  Real *z_coords = new Real[width];
-
-  std::cout << "Allocated coordinates of size " << width << std::endl;
-
-  // Populate coordinates for Elliptica
-  // TODO(JMF): Replace with a Kokkos loop on Kokkos::DefaultHostExecutionSpace() to
-  // improve performance.
-  int idx = 0;
-  for (int m = 0; m < nmb; m++) {
-    Real &x1min = size.h_view(m).x1min;
-    Real &x1max = size.h_view(m).x1max;
-    int nx1 = indcs.nx1;
-
-    Real &x2min = size.h_view(m).x2min;
-    Real &x2max = size.h_view(m).x2max;
-    int nx2 = indcs.nx2;
-
-    Real &x3min = size.h_view(m).x3min;
-    Real &x3max = size.h_view(m).x3max;
-    int nx3 = indcs.nx3;
-
-    for (int k = 0; k < ncells3; k++) {
-      Real z = CellCenterX(k - ks, nx3, x3min, x3max);
-      for (int j = 0; j < ncells2; j++) {
-        Real y = CellCenterX(j - js, nx2, x2min, x2max);
-        for (int i = 0; i < ncells1; i++) {
-          Real x = CellCenterX(i - is, nx1, x1min, x1max);
-
-          x_coords[idx] = x;
-          y_coords[idx] = y;
-          z_coords[idx] = z;
-
-          // Increment flat index
-          idx++;
-        }
+  // Evaluate Elliptica on active cells (with ghost cells filled by communication).  The
+  // reader is only initialized if the data is not found in the cache.
+  InitialDataImport idi(pmbp, pin, NIDVARS);
+  idi.Import("elliptica:" + fname,
+  [&](int npts, const Real *x, const Real *y, const Real *z, Real *vals) {
+    Elliptica_ID_Reader_T *idr = elliptica_id_reader_init(fname.c_str(),"generic");
+    std::string ifields = idvar_names[0];
+    for (int n = 1; n < NIDVARS; n++) {
+      ifields += std::string(",") + idvar_names[n];
+    }
+    idr->ifields = ifields.c_str();
+    idr->set_param("ADM_B1I_form","zero",idr);
+    idr->npoints  = npts;
+    idr->x_coords = const_cast<Real*>(x);
+    idr->y_coords = const_cast<Real*>(y);
+    idr->z_coords = const_cast<Real*>(z);
+    elliptica_id_reader_interpolate(idr);
+    for (int n = 0; n < NIDVARS; n++) {
+      const int i_n = idr->indx(idvar_names[n]);
+      for (int p = 0; p < npts; p++) {
+        vals[p*NIDVARS + n] = idr->field[i_n][p];
       }
     }
-  }
-
-  idr->set_param("ADM_B1I_form","zero",idr);
-
-  // Interpolate the data
-  idr->npoints  = width;
-  idr->x_coords = x_coords;
-  idr->y_coords = y_coords;
-  idr->z_coords = z_coords;
-  std::cout << "Coordinates assigned." << std::endl;
-  elliptica_id_reader_interpolate(idr);
-
-  // Free the coordinates, since we'll no longer need them.
-  delete[] x_coords;
-  delete[] y_coords;
-  delete[] z_coords;
-
-  std::cout << "Coordinates freed." << std::endl;
+    elliptica_id_reader_free(idr);
+  }, false);
+  auto &id = idi.u_h;
 
   // Capture variables for kernel; note that when Z4c is enabled, the gauge variables
   // are part of the Z4c class.
@@ -138,12 +113,9 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   auto &adm   = pmbp->padm->adm;
   auto &w0    = pmbp->pmhd->w0;
   auto &u_z4c = pmbp->pz4c->u0;
-  // Because Elliptica only operates on the CPU, we can't construct the data on the GPU.
-  // Instead, we create a mirror guaranteed to be on the CPU, populate the data there,
-  // then move it back to the GPU.
-  // TODO(JMF): This needs to be tested on CPUs to ensure that it functions properly;
-  // In theory, create_mirror_view shouldn't copy the data unless it's in a different
-  // memory space.
+  // Because Elliptica only operates on the CPU, the imported data is on the host.  We
+  // create a mirror guaranteed to be on the CPU, populate the data there, then move it
+  // back to the GPU.
   HostArray5D<Real>::HostMirror host_u_adm = create_mirror_view(u_adm);
   HostArray5D<Real>::HostMirror host_w0 = create_mirror_view(w0);
   HostArray5D<Real>::HostMirror host_u_z4c = create_mirror_view(u_z4c);
@@ -158,68 +130,37 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   std::cout << "Host mirrors created." << std::endl;
 
-  // Save Elliptica field indices for shorthand and a small optimization.
-  const int i_alpha = idr->indx("alpha");
-  const int i_betax = idr->indx("betax");
-  const int i_betay = idr->indx("betay");
-  const int i_betaz = idr->indx("betaz");
-
-  const int i_gxx   = idr->indx("adm_gxx");
-  const int i_gxy   = idr->indx("adm_gxy");
-  const int i_gxz   = idr->indx("adm_gxz");
-  const int i_gyy   = idr->indx("adm_gyy");
-  const int i_gyz   = idr->indx("adm_gyz");
-  const int i_gzz   = idr->indx("adm_gzz");
-
-  const int i_Kxx   = idr->indx("adm_Kxx");
-  const int i_Kxy   = idr->indx("adm_Kxy");
-  const int i_Kxz   = idr->indx("adm_Kxz");
-  const int i_Kyy   = idr->indx("adm_Kyy");
-  const int i_Kyz   = idr->indx("adm_Kyz");
-  const int i_Kzz   = idr->indx("adm_Kzz");
-
-  const int i_rho   = idr->indx("grhd_rho");
-  const int i_p     = idr->indx("grhd_p");
-  const int i_vx    = idr->indx("grhd_vx");
-  const int i_vy    = idr->indx("grhd_vy");
-  const int i_vz    = idr->indx("grhd_vz");
-
-  std::cout << "Label indices saved." << std::endl;
-
-  // TODO(JMF): Replace with a Kokkos loop on Kokkos::DefaultHostExecutionSpace() to
-  // improve performance.
-  idx = 0;
   for (int m = 0; m < nmb; m++) {
     for (int k = 0; k < ncells3; k++) {
       for (int j = 0; j < ncells2; j++) {
         for (int i = 0; i < ncells1; i++) {
           // Extract metric quantities
-          host_adm.alpha(m, k, j, i) = idr->field[i_alpha][idx];
-          host_adm.beta_u(m, 0, k, j, i) = idr->field[i_betax][idx];
-          host_adm.beta_u(m, 1, k, j, i) = idr->field[i_betay][idx];
-          host_adm.beta_u(m, 2, k, j, i) = idr->field[i_betaz][idx];
+          host_adm.alpha(m, k, j, i) = id(m, i_alpha, k, j, i);
+          host_adm.beta_u(m, 0, k, j, i) = id(m, i_betax, k, j, i);
+          host_adm.beta_u(m, 1, k, j, i) = id(m, i_betay, k, j, i);
+          host_adm.beta_u(m, 2, k, j, i) = id(m, i_betaz, k, j, i);
 
           Real g3d[NSPMETRIC];
-          host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = idr->field[i_gxx][idx];
-          host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = idr->field[i_gxy][idx];
-          host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = idr->field[i_gxz][idx];
-          host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = idr->field[i_gyy][idx];
-          host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = idr->field[i_gyz][idx];
-          host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = idr->field[i_gzz][idx];
-
-          host_adm.vK_dd(m, 0, 0, k, j, i) = idr->field[i_Kxx][idx];
-          host_adm.vK_dd(m, 0, 1, k, j, i) = idr->field[i_Kxy][idx];
-          host_adm.vK_dd(m, 0, 2, k, j, i) = idr->field[i_Kxz][idx];
-          host_adm.vK_dd(m, 1, 1, k, j, i) = idr->field[i_Kyy][idx];
-          host_adm.vK_dd(m, 1, 2, k, j, i) = idr->field[i_Kyz][idx];
-          host_adm.vK_dd(m, 2, 2, k, j, i) = idr->field[i_Kzz][idx];
+          host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = id(m, i_gxx, k, j, i);
+          host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = id(m, i_gxy, k, j, i);
+          host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = id(m, i_gxz, k, j, i);
+          host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = id(m, i_gyy, k, j, i);
+          host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = id(m, i_gyz, k, j, i);
+          host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = id(m, i_gzz, k, j, i);
+
+          host_adm.vK_dd(m, 0, 0, k, j, i) = id(m, i_Kxx, k, j, i);
+          host_adm.vK_dd(m, 0, 1, k, j, i) = id(m, i_Kxy, k, j, i);
+          host_adm.vK_dd(m, 0, 2, k, j, i) = id(m, i_Kxz, k, j, i);
+          host_adm.vK_dd(m, 1, 1, k, j, i) = id(m, i_Kyy, k, j, i);
+          host_adm.vK_dd(m, 1, 2, k, j, i) = id(m, i_Kyz, k, j, i);
+          host_adm.vK_dd(m, 2, 2, k, j, i) = id(m, i_Kzz, k, j, i);
 
           // Extract hydro quantities
-          host_w0(m, IDN, k, j, i) = idr->field[i_rho][idx];
-          host_w0(m, IPR, k, j, i) = idr->field[i_p][idx];
-          Real vu[3] = {idr->field[i_vx][idx],
-                        idr->field[i_vy][idx],
-                        idr->field[i_vz][idx]};
+          host_w0(m, IDN, k, j, i) = id(m, i_rho, k, j, i);
+          host_w0(m, IPR, k, j, i) = id(m, i_p, k, j, i);
+          Real vu[3] = {id(m, i_vx, k, j, i),
+                        id(m, i_vy, k, j, i),
+                        id(m, i_vz, k, j, i)};
 
           // Before we store the velocity, we need to make sure it's physical and
           // calculate the Lorentz factor. If the velocity is superluminal, we make a
@@ -240,8 +181,6 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
           host_w0(m, IVX, k, j, i) = W*vu[0];
           host_w0(m, IVY, k, j, i) = W*vu[1];
           host_w0(m, IVZ, k, j, i) = W*vu[2];
-
-          idx++;
         }
       }
     }
@@ -249,11 +188,6 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   std::cout << "Host mirrors filled." << std::endl;
 
-  // Cleanup
-  elliptica_id_reader_free(idr);
-
-  std::cout << "Elliptica freed." << std::endl;
-
   // Copy the data to the GPU.
   Kokkos::deep_copy(u_adm, host_u_adm);
   Kokkos::deep_copy(w0, host_w0);
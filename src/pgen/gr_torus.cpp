@@ -110,6 +110,7 @@ struct torus_pgen {
   Real l_peak;                                // fixed torus parameters
   Real c_param;                               // calculated chakrabarti parameter
   Real n_param;                               // fixed or calculated chakrabarti parameter
+  Real l_edge, u_t_edge;                      // chakrabarti l and u_t at inner edge
   Real log_h_edge, log_h_peak;                // calculated torus parameters
   Real ptot_over_rho_peak, rho_peak;          // more calculated torus parameters
   Real r_outer_edge;                          // even more calculated torus parameters
@@ -358,6 +359,10 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   } else if (torus.chakrabarti_torus) {
     CalculateCN(torus, &torus.c_param, &torus.n_param);
     torus.l_peak = CalculateL(torus, torus.r_peak, 1.0);
+    // values at inner edge are constant, so compute once here rather than in every call
+    // to LogHAux() from the kernels (each needs an iterative root find for l)
+    torus.l_edge = CalculateL(torus, torus.r_edge, 1.0);
+    torus.u_t_edge = CalculateCovariantUT(torus, torus.r_edge, 1.0, torus.l_edge);
   } else {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
               << "Unrecognized torus type in input file" << std::endl;
@@ -891,10 +896,12 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
     }, Kokkos::Max<Real>(bsqmax), Kokkos::Max<Real>(bsqmax_intorus));
 
 #if MPI_PARALLEL_ENABLED
-    // get maximum value of gas pressure and bsq over all MPI ranks
-    MPI_Allreduce(MPI_IN_PLACE, &ptotmax, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, &bsqmax, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, &bsqmax_intorus, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    // get maximum value of gas pressure and bsq over all MPI ranks in one reduction
+    Real maxes[3] = {ptotmax, bsqmax, bsqmax_intorus};
+    MPI_Allreduce(MPI_IN_PLACE, maxes, 3, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+    ptotmax = maxes[0];
+    bsqmax = maxes[1];
+    bsqmax_intorus = maxes[2];
 #endif
 
     // Apply renormalization of magnetic field
@@ -904,7 +911,8 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
       bnorm = sqrt((ptotmax/(0.5*bsqmax_intorus))/torus.potential_beta_min);
     }
 
-    par_for("pgen_normb0", DevExeSpace(), 0,nmb-1,ks,ke,js,je,is,ie,
+    // cell-centered fields are linear in face-centered fields, so scale both in one pass
+    par_for("pgen_normb", DevExeSpace(), 0,nmb-1,ks,ke,js,je,is,ie,
     KOKKOS_LAMBDA(int m, int k, int j, int i) {
       b0.x1f(m,k,j,i) *= bnorm;
       b0.x2f(m,k,j,i) *= bnorm;
@@ -912,18 +920,9 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
       if (i==ie) { b0.x1f(m,k,j,i+1) *= bnorm; }
       if (j==je) { b0.x2f(m,k,j+1,i) *= bnorm; }
       if (k==ke) { b0.x3f(m,k+1,j,i) *= bnorm; }
-    });
-
-    // Recompute cell-centered magnetic field
-    par_for("pgen_normbcc", DevExeSpace(), 0,nmb-1,ks,ke,js,je,is,ie,
-    KOKKOS_LAMBDA(int m, int k, int j, int i) {
-      // cell-centered fields are simple linear average of face-centered fields
-      Real& w_bx = bcc_(m,IBX,k,j,i);
-      Real& w_by = bcc_(m,IBY,k,j,i);
-      Real& w_bz = bcc_(m,IBZ,k,j,i);
-      w_bx = 0.5*(b0.x1f(m,k,j,i) + b0.x1f(m,k,j,i+1));
-      w_by = 0.5*(b0.x2f(m,k,j,i) + b0.x2f(m,k,j+1,i));
-      w_bz = 0.5*(b0.x3f(m,k,j,i) + b0.x3f(m,k+1,j,i));
+      bcc_(m,IBX,k,j,i) *= bnorm;
+      bcc_(m,IBY,k,j,i) *= bnorm;
+      bcc_(m,IBZ,k,j,i) *= bnorm;
     });
   }
 
@@ -1003,9 +1002,8 @@ static Real LogHAux(struct torus_pgen pgen, Real r, Real sin_theta) {
   } else { // Chakrabarti
     Real l = CalculateL(pgen, r, sin_theta);
     Real u_t = CalculateCovariantUT(pgen, r, sin_theta, l);
-    Real l_edge = CalculateL(pgen, pgen.r_edge, 1.0);
-    Real u_t_edge = CalculateCovariantUT(pgen, pgen.r_edge, 1.0, l_edge);
-    Real h = u_t_edge/u_t;
+    Real l_edge = pgen.l_edge;
+    Real h = pgen.u_t_edge/u_t;
     if (pgen.n_param==1.0) {
       h *= pow(l_edge/l, SQR(pgen.c_param)/(SQR(pgen.c_param)-1.0));
     } else {
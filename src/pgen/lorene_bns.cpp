@@ -16,6 +16,7 @@
 #include <sstream>
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -30,11 +31,23 @@
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
+#include "utils/id_import.hpp"
 
 // Lorene
 #include "bin_ns.h"
 #include "unites.h"
 
+namespace {
+// Fields imported from LORENE
+enum {
+  i_nnn, i_betax, i_betay, i_betaz,
+  i_gxx, i_gxy, i_gxz, i_gyy, i_gyz, i_gzz,
+  i_kxx, i_kxy, i_kxz, i_kyy, i_kyz, i_kzz,
+  i_nbar, i_ener, i_ux, i_uy, i_uz,
+  NIDVARS
+};
+} // namespace
+
 // Prototype for user-defined history function
 void BNSHistory(HistoryData *pdata, Mesh *pm);
 void LoreneBNSRefinementCondition(MeshBlockPack *pmbp);
@@ -50,7 +63,6 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
   auto &indcs = pmy_mesh_->mb_indcs;
-  auto &size = pmbp->pmb->mb_size;
   int &is = indcs.is; int &ie = indcs.ie;
   int &js = indcs.js; int &je = indcs.je;
   int &ks = indcs.ks; int &ke = indcs.ke;
@@ -90,76 +102,43 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   int ncells3 = indcs.nx3 + 2*(indcs.ng);
   int nmb = pmbp->nmb_thispack;
 
-  int width = nmb*ncells1*ncells2*ncells3;
-
-  Real *x_coords = new Real[width];
-  Real *y_coords = new Real[width];
-  Real *z_coords = new Real[width];
-
-  std::cout << "Allocated coordinates of size " << width << std::endl;
-
-  // Populate coordinates for LORENE
-  // TODO(JMF): Replace with a Kokkos loop on Kokkos::DefaultHostExecutionSpace() to
-  // improve performance.
-  int idx = 0;
-  for (int m = 0; m < nmb; m++) {
-    Real &x1min = size.h_view(m).x1min;
-    Real &x1max = size.h_view(m).x1max;
-    int nx1 = indcs.nx1;
-
-    Real &x2min = size.h_view(m).x2min;
-    Real &x2max = size.h_view(m).x2max;
-    int nx2 = indcs.nx2;
-
-    Real &x3min = size.h_view(m).x3min;
-    Real &x3max = size.h_view(m).x3max;
-    int nx3 = indcs.nx3;
-
-    for (int k = 0; k < ncells3; k++) {
-      Real z = CellCenterX(k - ks, nx3, x3min, x3max);
-      for (int j = 0; j < ncells2; j++) {
-        Real y = CellCenterX(j - js, nx2, x2min, x2max);
-        for (int i = 0; i < ncells1; i++) {
-          Real x = CellCenterX(i - is, nx1, x1min, x1max);
-
-          x_coords[idx] = coord_unit*x;
-          y_coords[idx] = coord_unit*y;
-          z_coords[idx] = coord_unit*z;
-
-          // Increment flat index
-          idx++;
-        }
+  // Evaluate LORENE on active cells (with ghost cells filled by communication).  The
+  // data file is only read if the data is not found in the cache.
+  InitialDataImport idi(pmbp, pin, NIDVARS);
+  idi.Import("lorene:" + fname,
+  [&](int npts, const Real *x, const Real *y, const Real *z, Real *vals) {
+    std::vector<Real> x_coords(npts), y_coords(npts), z_coords(npts);
+    for (int p = 0; p < npts; p++) {
+      x_coords[p] = coord_unit*x[p];
+      y_coords[p] = coord_unit*y[p];
+      z_coords[p] = coord_unit*z[p];
+    }
+    Lorene::Bin_NS *bns = new Lorene::Bin_NS(npts, x_coords.data(), y_coords.data(),
+                                             z_coords.data(), fname.c_str());
+    const double *fields[NIDVARS] = {
+      bns->nnn, bns->beta_x, bns->beta_y, bns->beta_z,
+      bns->g_xx, bns->g_xy, bns->g_xz, bns->g_yy, bns->g_yz, bns->g_zz,
+      bns->k_xx, bns->k_xy, bns->k_xz, bns->k_yy, bns->k_yz, bns->k_zz,
+      bns->nbar, bns->ener_spec, bns->u_euler_x, bns->u_euler_y, bns->u_euler_z};
+    for (int n = 0; n < NIDVARS; n++) {
+      for (int p = 0; p < npts; p++) {
+        vals[p*NIDVARS + n] = fields[n][p];
       }
     }
-  }
-
-  // Interpolate the data
-  std::cout << "Coordinates assigned." << std::endl;
-  Lorene::Bin_NS *bns = new Lorene::Bin_NS(width, x_coords, y_coords, z_coords,
-                                          fname.c_str());
-
-  // Free the coordinates, since we'll no longer need them.
-  delete[] x_coords;
-  delete[] y_coords;
-  delete[] z_coords;
-
-  std::cout << "Coordinates freed." << std::endl;
+    delete bns;
+  }, false);
+  auto &id = idi.u_h;
 
   // Capture variables for kernel; note that when Z4c is enabled, the gauge variables
   // are part of the Z4c class.
   auto &u_adm = pmbp->padm->u_adm;
   auto &adm   = pmbp->padm->adm;
   auto &w0    = pmbp->pmhd->w0;
-  //auto &u_z4c = pmbp->pz4c->u0;
-  // Because Elliptica only operates on the CPU, we can't construct the data on the GPU.
-  // Instead, we create a mirror guaranteed to be on the CPU, populate the data there,
-  // then move it back to the GPU.
-  // TODO(JMF): This needs to be tested on CPUs to ensure that it functions properly;
-  // In theory, create_mirror_view shouldn't copy the data unless it's in a different
-  // memory space.
+  // Because LORENE only operates on the CPU, the imported data is on the host.  We
+  // create a mirror guaranteed to be on the CPU, populate the data there, then move it
+  // back to the GPU.
   HostArray5D<Real>::HostMirror host_u_adm = create_mirror_view(u_adm);
   HostArray5D<Real>::HostMirror host_w0 = create_mirror_view(w0);
-  //HostArray5D<Real>::HostMirror host_u_z4c = create_mirror_view(u_z4c);
   HostArray5D<Real>::HostMirror host_u_z4c;
   adm::ADM::ADMhost_vars host_adm;
   if (pmbp->pz4c != nullptr) {
@@ -179,61 +158,44 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   std::cout << "Host mirrors created." << std::endl;
 
-  // TODO(JMF): Replace with a Kokkos loop on Kokkos::DefaultHostExecutionSpace() to
-  // improve performance.
-  idx = 0;
   for (int m = 0; m < nmb; m++) {
     for (int k = 0; k < ncells3; k++) {
       for (int j = 0; j < ncells2; j++) {
         for (int i = 0; i < ncells1; i++) {
-  /*const int nn = nmb;
-  const int nk = ncells3;
-  const int nj = ncells2;
-  const int ni = ncells1;
-  const int nnkji = nn * nk * nj * ni;
-  const int nkji = nk * nj * ni;
-  const int nji = nj * ni;
-  Kokkos::parallel_for("pgen_lorene",
-  Kokkos::RangePolicy<>(HostExeSpace(), 0, nnkji),
-  KOKKOS_LAMBDA(const int &idx) {
-          int m = (idx)/nkji;
-          int k = (idx - m*nkji)/nji;
-          int j = (idx - m*nkji - k*nji)/ni;
-          int i = (idx - m*nkji - k*nji - j*ni);*/
           // Extract metric quantities
-          host_adm.alpha(m, k, j, i) = bns->nnn[idx];
-          host_adm.beta_u(m, 0, k, j, i) = bns->beta_x[idx];
-          host_adm.beta_u(m, 1, k, j, i) = bns->beta_y[idx];
-          host_adm.beta_u(m, 2, k, j, i) = bns->beta_z[idx];
+          host_adm.alpha(m, k, j, i) = id(m, i_nnn, k, j, i);
+          host_adm.beta_u(m, 0, k, j, i) = id(m, i_betax, k, j, i);
+          host_adm.beta_u(m, 1, k, j, i) = id(m, i_betay, k, j, i);
+          host_adm.beta_u(m, 2, k, j, i) = id(m, i_betaz, k, j, i);
 
           Real g3d[NSPMETRIC];
-          host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = bns->g_xx[idx];
-          host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = bns->g_xy[idx];
-          host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = bns->g_xz[idx];
-          host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = bns->g_yy[idx];
-          host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = bns->g_yz[idx];
-          host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = bns->g_zz[idx];
-
-          host_adm.vK_dd(m, 0, 0, k, j, i) = coord_unit * bns->k_xx[idx];
-          host_adm.vK_dd(m, 0, 1, k, j, i) = coord_unit * bns->k_xy[idx];
-          host_adm.vK_dd(m, 0, 2, k, j, i) = coord_unit * bns->k_xz[idx];
-          host_adm.vK_dd(m, 1, 1, k, j, i) = coord_unit * bns->k_yy[idx];
-          host_adm.vK_dd(m, 1, 2, k, j, i) = coord_unit * bns->k_yz[idx];
-          host_adm.vK_dd(m, 2, 2, k, j, i) = coord_unit * bns->k_zz[idx];
+          host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = id(m, i_gxx, k, j, i);
+          host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = id(m, i_gxy, k, j, i);
+          host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = id(m, i_gxz, k, j, i);
+          host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = id(m, i_gyy, k, j, i);
+          host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = id(m, i_gyz, k, j, i);
+          host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = id(m, i_gzz, k, j, i);
+
+          host_adm.vK_dd(m, 0, 0, k, j, i) = coord_unit * id(m, i_kxx, k, j, i);
+          host_adm.vK_dd(m, 0, 1, k, j, i) = coord_unit * id(m, i_kxy, k, j, i);
+          host_adm.vK_dd(m, 0, 2, k, j, i) = coord_unit * id(m, i_kxz, k, j, i);
+          host_adm.vK_dd(m, 1, 1, k, j, i) = coord_unit * id(m, i_kyy, k, j, i);
+          host_adm.vK_dd(m, 1, 2, k, j, i) = coord_unit * id(m, i_kyz, k, j, i);
+          host_adm.vK_dd(m, 2, 2, k, j, i) = coord_unit * id(m, i_kzz, k, j, i);
 
           // Extract hydro quantities
-          host_w0(m, IDN, k, j, i) = bns->nbar[idx] / rho_unit;
+          host_w0(m, IDN, k, j, i) = id(m, i_nbar, k, j, i) / rho_unit;
           // Lorene only gives the specific internal energy, but PrimitiveSolver needs
           // pressure. Because PrimitiveSolver is templated, it's difficult to call it
           // directly. Thus, the easiest way is to save the internal energy density, IEN,
           // whose index overlaps the pressure, IPR, move the data to the GPU, then
           // make a call to a virtual DynGRMHD EOS function that will call the appropriate
           // template function.
-          Real egas = host_w0(m, IDN, k, j, i) * bns->ener_spec[idx] / ener_unit;
+          Real egas = host_w0(m, IDN, k, j, i) * id(m, i_ener, k, j, i) / ener_unit;
           host_w0(m, IEN, k, j, i) = egas;
-          Real vu[3] = {bns->u_euler_x[idx] / vel_unit,
-                        bns->u_euler_y[idx] / vel_unit,
-                        bns->u_euler_z[idx] / vel_unit};
+          Real vu[3] = {id(m, i_ux, k, j, i) / vel_unit,
+                        id(m, i_uy, k, j, i) / vel_unit,
+                        id(m, i_uz, k, j, i) / vel_unit};
 
           // Before we store the velocity, we need to make sure it's physical and
           // calculate the Lorentz factor. If the velocity is superluminal, we make a
@@ -254,9 +216,6 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
           host_w0(m, IVX, k, j, i) = W*vu[0];
           host_w0(m, IVY, k, j, i) = W*vu[1];
           host_w0(m, IVZ, k, j, i) = W*vu[2];
-
-          idx++;
-  //});
         }
       }
     }
@@ -264,11 +223,6 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   std::cout << "Host mirrors filled." << std::endl;
 
-  // Cleanup
-  delete bns;
-
-  std::cout << "Lorene freed." << std::endl;
-
   // Copy the data to the GPU.
   Kokkos::deep_copy(u_adm, host_u_adm);
   Kokkos::deep_copy(w0, host_w0);
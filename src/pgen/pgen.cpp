@@ -8,9 +8,15 @@
 //! Default constructor calls problem generator function, while  constructor for restarts
 //! reads data from restart file, as well as re-initializing problem-specific data.
 
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 #include <algorithm>
 
 #include "athena.hpp"
@@ -25,6 +31,7 @@
 #include "z4c/z4c.hpp"
 #include "radiation/radiation.hpp"
 #include "srcterms/turb_driver.hpp"
+#include "outputs/outputs.hpp"
 #include "pgen.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -66,6 +73,8 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm) :
     LinearWave(pin, false);
   } else if (pgen_fun_name.compare("implode") == 0) {
     LWImplode(pin, false);
+  } else if (pgen_fun_name.compare("jeans_wave") == 0) {
+    JeansWave(pin, false);
   } else if (pgen_fun_name.compare("gr_monopole") == 0) {
     Monopole(pin, false);
   } else if (pgen_fun_name.compare("orszag_tang") == 0) {
@@ -80,6 +89,12 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm) :
     SphericalCollapse(pin, false);
   } else if (pgen_fun_name.compare("diffusion") == 0) {
     Diffusion(pin, false);
+  } else if (pgen_fun_name.compare("recon_bench") == 0) {
+    ReconBenchmark(pin, false);
+  } else if (pgen_fun_name.compare("c2p_bench") == 0) {
+    C2PBenchmark(pin, false);
+  } else if (pgen_fun_name.compare("benchmark") == 0) {
+    Benchmark(pin, false);
   // else, name not set on command line or input file, print warning and quit
   } else {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
@@ -104,7 +119,7 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm) :
   }
   // Check that user defined srcterms were enrolled if needed
   if (user_srcs) {
-    if (user_srcs_func == nullptr) {
+    if (user_srcs_func == nullptr && !user_srcs_kernel) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
                 << std::endl << "User SRCs specified in <problem> block, but not "
                 << "enrolled by UserProblem()." << std::endl;
@@ -122,6 +137,39 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm) :
   }
 }
 
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void UnpackRestartChunk()
+//! \brief Unpacks cell-centered array a of MeshBlocks m0...m0+nm-1 from their records
+//! (of nrec Reals each) in buf, starting at offset off within each record.  Inverse of
+//! RestartOutput::PackChunk().
+
+void UnpackRestartChunk(const DvceArray1D<Real> &buf, IOWrapperSizeT nrec,
+                        IOWrapperSizeT off, int m0, int nm, DvceArray5D<Real> &a) {
+  int nv = a.extent_int(1), nk = a.extent_int(2);
+  int nj = a.extent_int(3), ni = a.extent_int(4);
+  par_for("rst_unpack_cc",DevExeSpace(),0,nm-1,0,nv-1,0,nk-1,0,nj-1,0,ni-1,
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    a(m0+m,n,k,j,i) =
+        buf(m*nrec + off + ((static_cast<IOWrapperSizeT>(n)*nk + k)*nj + j)*ni + i);
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void UnpackRestartChunk()
+//! \brief Unpacks face-centered field component a of MeshBlocks m0...m0+nm-1 from their
+//! records in buf, starting at offset off within each record.
+
+void UnpackRestartChunk(const DvceArray1D<Real> &buf, IOWrapperSizeT nrec,
+                        IOWrapperSizeT off, int m0, int nm, DvceArray4D<Real> &a) {
+  int nk = a.extent_int(1), nj = a.extent_int(2), ni = a.extent_int(3);
+  par_for("rst_unpack_fc",DevExeSpace(),0,nm-1,0,nk-1,0,nj-1,0,ni-1,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    a(m0+m,k,j,i) = buf(m*nrec + off + (static_cast<IOWrapperSizeT>(k)*nj + j)*ni + i);
+  });
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 // constructor for restarts
 // When called, data needed to rebuild mesh has been read from restart file by
@@ -158,6 +206,9 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
   radiation::Radiation* prad=pm->pmb_pack->prad;
   TurbulenceDriver* pturb=pm->pmb_pack->pturb;
   int nrad = 0, nhydro = 0, nmhd = 0, nforce = 3, nadm = 0, nz4c = 0;
+  if ((pturb != nullptr) && (pturb->modal_forcing)) {
+    nforce = 0;
+  }
   if (phydro != nullptr) {
     nhydro = phydro->nhydro + phydro->nscalars;
   }
@@ -224,6 +275,34 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     MPI_Bcast(rng_data, sizeof(RNG_State), MPI_CHAR, 0, MPI_COMM_WORLD);
 #endif
     std::memcpy(&(pturb->rstate), &(rng_data[0]), sizeof(RNG_State));
+
+    // with modal forcing, root process reads mode amplitudes and mean of force
+    if (pturb->modal_forcing) {
+      int namp = 24*(pturb->mode_count);
+      std::vector<Real> amp_data(namp + 3);
+      if (global_variable::my_rank == 0) {
+        std::size_t nread = resfile.Read_Reals(amp_data.data(), namp + 3);
+        if (nread != static_cast<std::size_t>(namp + 3)) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                    << std::endl << "Turbulence driver mode data size read from restart "
+                    << "file is incorrect, restart file is broken." << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      }
+#if MPI_PARALLEL_ENABLED
+      MPI_Bcast(amp_data.data(), (namp + 3)*sizeof(Real), MPI_CHAR, 0, MPI_COMM_WORLD);
+#endif
+      for (int n=0; n<(pturb->mode_count); ++n) {
+        for (int c=0; c<24; ++c) {
+          pturb->amp_force.h_view(n,c) = amp_data[24*n + c];
+        }
+      }
+      pturb->amp_force.template modify<HostMemSpace>();
+      pturb->amp_force.template sync<DevExeSpace>();
+      for (int c=0; c<3; ++c) {
+        pturb->mean_force[c] = amp_data[namp + c];
+      }
+    }
   }
 
   // root process reads size of CC and FC data arrays from restart file
@@ -285,343 +364,85 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     exit(EXIT_FAILURE);
   }
 
-  // read CC data into host array
-  int mygids = pm->gids_eachrank[global_variable::my_rank];
-  IOWrapperSizeT offset_myrank = headeroffset + data_size_*mygids;
-  IOWrapperSizeT myoffset = offset_myrank;
-
-  HostArray5D<Real> ccin("rst-cc-in", 1, 1, 1, 1, 1);
-  HostFaceFld4D<Real> fcin("rst-fc-in", 1, 1, 1, 1);
-
-  // calculate max/min number of MeshBlocks across all ranks
-  int noutmbs_max = pm->nmb_eachrank[0];
-  int noutmbs_min = pm->nmb_eachrank[0];
-  for (int i=0; i<(global_variable::nranks); ++i) {
-    noutmbs_max = std::max(noutmbs_max,pm->nmb_eachrank[i]);
-    noutmbs_min = std::min(noutmbs_min,pm->nmb_eachrank[i]);
-  }
-
-  if (phydro != nullptr) {
-    Kokkos::realloc(ccin, nmb, nhydro, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC hydro data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC hydro data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
+  // Read data.  The MeshBlocks of each rank are contiguous in the file (ordered by gid),
+  // whatever the number of ranks that wrote it.  Chunks of MeshBlocks (of at most
+  // 512 MiB) are read with one collective call each into one of two pinned host buffers,
+  // then copied to the device and unpacked there asynchronously, so that the copy and
+  // unpack of each chunk overlap the read of the next.  Every rank makes the same number
+  // of calls.
+  IOWrapperSizeT offset_myrank = headeroffset +
+                                 data_size_*pm->gids_eachrank[global_variable::my_rank];
+  if (data_size > 0) {
+    IOWrapperSizeT nrec = data_size/sizeof(Real);  // Reals per MeshBlock record
+    IOWrapperSizeT max_bytes = static_cast<IOWrapperSizeT>(1) << 29;
+    int nchunk_mbs = static_cast<int>(std::max(static_cast<IOWrapperSizeT>(1),
+                                               max_bytes/data_size));
+    int noutmbs_max = pm->nmb_eachrank[0];
+    for (int i=0; i<(global_variable::nranks); ++i) {
+      noutmbs_max = std::max(noutmbs_max,pm->nmb_eachrank[i]);
     }
-    Kokkos::deep_copy(Kokkos::subview(phydro->u0, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nhydro*sizeof(Real); // hydro u0
-    myoffset = offset_myrank;
-  }
-
-  if (pmhd != nullptr) {
-    Kokkos::realloc(ccin, nmb, nmhd, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                   Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC mhd data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC mhd data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
+    int nbuf_mbs = std::max(1, std::min(nchunk_mbs, nmb));
+    DvceArray1D<Real> rst_buf("rst_buf", nbuf_mbs*nrec);
+    PinnedArray1D<Real> rst_buf_h[2];
+    rst_buf_h[0] = PinnedArray1D<Real>("rst_buf_h0", nbuf_mbs*nrec);
+    rst_buf_h[1] = PinnedArray1D<Real>("rst_buf_h1", nbuf_mbs*nrec);
+
+    int nchunks = (noutmbs_max + nchunk_mbs - 1)/nchunk_mbs;
+    for (int c=0; c<nchunks; ++c) {
+      int m0 = c*nchunk_mbs;
+      int nm = std::max(0, std::min(nchunk_mbs, nmb - m0));
+      IOWrapperSizeT cnt = nm*data_size;
+      IOWrapperSizeT myoffset = offset_myrank + m0*data_size;
+      auto &buf_h = rst_buf_h[c%2];
+      if (resfile.Read_bytes_at_all(buf_h.data(), 1, cnt, myoffset) != cnt) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "MeshBlock data not read correctly from restart file, "
+                  << "restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
       }
-    }
-    Kokkos::deep_copy(Kokkos::subview(pmhd->u0, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nmhd*sizeof(Real);   // mhd u0
-    myoffset = offset_myrank;
-
-    Kokkos::realloc(fcin.x1f, nmb, nout3, nout2, nout1+1);
-    Kokkos::realloc(fcin.x2f, nmb, nout3, nout2+1, nout1);
-    Kokkos::realloc(fcin.x3f, nmb, nout3+1, nout2, nout1);
-    // read FC data into host array, again one MeshBlock at a time
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to write, so write collectively
-      if (m < noutmbs_min) {
-        // get ptr to x1-face field
-        auto x1fptr = Kokkos::subview(fcin.x1f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        int fldcnt = x1fptr.size();
-
-        if (resfile.Read_Reals_at_all(x1fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x1f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x2-face field
-        auto x2fptr = Kokkos::subview(fcin.x2f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x2fptr.size();
-
-        if (resfile.Read_Reals_at_all(x2fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x2f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x3-face field
-        auto x3fptr = Kokkos::subview(fcin.x3f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x3fptr.size();
-
-        if (resfile.Read_Reals_at_all(x3fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x3f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        myoffset += data_size-(x1fptr.size()+x2fptr.size()+x3fptr.size())*sizeof(Real);
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to x1-face field
-        auto x1fptr = Kokkos::subview(fcin.x1f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        int fldcnt = x1fptr.size();
-
-        if (resfile.Read_Reals_at(x1fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x1f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x2-face field
-        auto x2fptr = Kokkos::subview(fcin.x2f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x2fptr.size();
-
-        if (resfile.Read_Reals_at(x2fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x2f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x3-face field
-        auto x3fptr = Kokkos::subview(fcin.x3f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x3fptr.size();
-
-        if (resfile.Read_Reals_at(x3fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x3f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        myoffset += data_size-(x1fptr.size()+x2fptr.size()+x3fptr.size())*sizeof(Real);
+      if (nm == 0) continue;
+      // wait for copy and unpack of previous chunk, which overlapped the read above, so
+      // that rst_buf and the other host buffer can be reused
+      Kokkos::fence();
+      auto chunk = std::make_pair(static_cast<IOWrapperSizeT>(0), nm*nrec);
+      Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(rst_buf, chunk),
+                        Kokkos::subview(buf_h, chunk));
+
+      IOWrapperSizeT off = 0;  // offset of each variable within MeshBlock records
+      if (phydro != nullptr) {
+        UnpackRestartChunk(rst_buf, nrec, off, m0, nm, phydro->u0);
+        off += nout1*nout2*nout3*nhydro;
       }
-    }
-    Kokkos::deep_copy(Kokkos::subview(pmhd->b0.x1f, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL), fcin.x1f);
-    Kokkos::deep_copy(Kokkos::subview(pmhd->b0.x2f, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL), fcin.x2f);
-    Kokkos::deep_copy(Kokkos::subview(pmhd->b0.x3f, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL), fcin.x3f);
-    offset_myrank += (nout1+1)*nout2*nout3*sizeof(Real);    // mhd b0.x1f
-    offset_myrank += nout1*(nout2+1)*nout3*sizeof(Real);    // mhd b0.x2f
-    offset_myrank += nout1*nout2*(nout3+1)*sizeof(Real);    // mhd b0.x3f
-    myoffset = offset_myrank;
-  }
-
-  if (prad != nullptr) {
-    Kokkos::realloc(ccin, nmb, nrad, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC rad data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC rad data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
+      if (pmhd != nullptr) {
+        UnpackRestartChunk(rst_buf, nrec, off, m0, nm, pmhd->u0);
+        off += nout1*nout2*nout3*nmhd;
+        UnpackRestartChunk(rst_buf, nrec, off, m0, nm, pmhd->b0.x1f);
+        off += (nout1+1)*nout2*nout3;
+        UnpackRestartChunk(rst_buf, nrec, off, m0, nm, pmhd->b0.x2f);
+        off += nout1*(nout2+1)*nout3;
+        UnpackRestartChunk(rst_buf, nrec, off, m0, nm, pmhd->b0.x3f);
+        off += nout1*nout2*(nout3+1);
       }
-    }
-    Kokkos::deep_copy(Kokkos::subview(prad->i0, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nrad*sizeof(Real);   // radiation i0
-    myoffset = offset_myrank;
-  }
-
-  if (pturb != nullptr) {
-    Kokkos::realloc(ccin, nmb, nforce, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC turb data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC turb data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
+      if (prad != nullptr) {
+        UnpackRestartChunk(rst_buf, nrec, off, m0, nm, prad->i0);
+        off += nout1*nout2*nout3*nrad;
+      }
+      if ((pturb != nullptr) && !(pturb->modal_forcing)) {
+        UnpackRestartChunk(rst_buf, nrec, off, m0, nm, pturb->force);
+        off += nout1*nout2*nout3*nforce;
+      }
+      if (pz4c != nullptr) {
+        UnpackRestartChunk(rst_buf, nrec, off, m0, nm, pz4c->u0);
+      } else if (padm != nullptr) {
+        UnpackRestartChunk(rst_buf, nrec, off, m0, nm, padm->u_adm);
       }
     }
-    Kokkos::deep_copy(Kokkos::subview(pturb->force, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nforce*sizeof(Real); // forcing
-    myoffset = offset_myrank;
+    Kokkos::fence();
   }
 
+  // We also need to reinitialize the ADM data.
   if (pz4c != nullptr) {
-    Kokkos::realloc(ccin, nmb, nz4c, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC z4c data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC z4c data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
-    Kokkos::deep_copy(Kokkos::subview(pz4c->u0, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nz4c*sizeof(Real);   // z4c u0
-    myoffset = offset_myrank;
-
-    // We also need to reinitialize the ADM data.
     pz4c->Z4cToADM(pmy_mesh_->pmb_pack);
-  } else if (padm != nullptr) {
-    Kokkos::realloc(ccin, nmb, nadm, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC adm data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC adm data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
-    Kokkos::deep_copy(Kokkos::subview(padm->u_adm, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nadm*sizeof(Real);   // adm u_adm
-    myoffset = offset_myrank;
   }
 
   // call problem generator again to re-initialize data, fn ptrs, as needed
@@ -644,6 +465,8 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     LinearWave(pin, true);
   } else if (pgen_fun_name.compare("implode") == 0) {
     LWImplode(pin, true);
+  } else if (pgen_fun_name.compare("jeans_wave") == 0) {
+    JeansWave(pin, true);
   } else if (pgen_fun_name.compare("gr_monopole") == 0) {
     Monopole(pin, true);
   } else if (pgen_fun_name.compare("orszag_tang") == 0) {
@@ -658,6 +481,12 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     SphericalCollapse(pin, true);
   } else if (pgen_fun_name.compare("diffusion") == 0) {
     Diffusion(pin, true);
+  } else if (pgen_fun_name.compare("recon_bench") == 0) {
+    ReconBenchmark(pin, true);
+  } else if (pgen_fun_name.compare("c2p_bench") == 0) {
+    C2PBenchmark(pin, true);
+  } else if (pgen_fun_name.compare("benchmark") == 0) {
+    Benchmark(pin, true);
   } else {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
         << "Problem generator name could not be found in <problem> block in input file"
@@ -681,7 +510,7 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
   }
   // Check that user defined srcterms were enrolled if needed
   if (user_srcs) {
-    if (user_srcs_func == nullptr) {
+    if (user_srcs_func == nullptr && !user_srcs_kernel) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
                 << std::endl << "User SRCs specified in <problem> block, but not "
                 << "enrolled by UserProblem()." << std::endl;
@@ -698,3 +527,90 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     }
   }
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn bool ProblemGenerator::FindInitialDataSnapshot()
+//! \brief Returns name of the snapshot of the initial data for this input in fname, and
+//! true if the snapshot exists.  fname is empty unless <problem>/id_snapshot is true.
+//! Snapshots are restart files written by WriteInitialDataSnapshot() after the problem
+//! generator has run, so expensive initial data (e.g. tori, TOV or BNS readers) can be
+//! loaded by the restart path on later runs with the same input.  The name is an FNV-1a
+//! hash of all input blocks except <job>, <time> and <output*>, so that changing the
+//! problem, Mesh, refinement or physics parameters invalidates the snapshot.  Must be
+//! called before parameters with default values are added to the ParameterInput.
+
+bool ProblemGenerator::FindInitialDataSnapshot(ParameterInput *pin,
+                                               std::string &fname) {
+  fname.clear();
+  if (!pin->GetOrAddBoolean("problem", "id_snapshot", false)) return false;
+  std::string dir = pin->GetOrAddString("problem", "id_snapshot_dir", ".");
+
+  // build key from parameters that determine the initial data.  Parameters starting
+  // with "id_" only control how initial data is computed or cached.
+  std::string key;
+  for (auto &ib : pin->block) {
+    if (ib.block_name.compare("job") == 0 || ib.block_name.compare("time") == 0 ||
+        ib.block_name.compare(0, 6, "output") == 0) {continue;}
+    key += "<" + ib.block_name + ">\n";
+    for (auto &il : ib.line) {
+      if (ib.block_name.compare("problem") == 0 &&
+          il.param_name.compare(0, 3, "id_") == 0) {continue;}
+      key += il.param_name + "=" + il.param_value + "\n";
+    }
+  }
+  std::uint64_t h = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  std::stringstream name;
+  name << dir << "/id_" << std::hex << std::setw(16) << std::setfill('0') << h << ".rst";
+  fname = name.str();
+
+  // root process checks whether snapshot exists
+  int exists = 0;
+  if (global_variable::my_rank == 0) {
+    std::ifstream file(fname, std::ios::binary);
+    exists = file.good() ? 1 : 0;
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Bcast(&exists, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+  return (exists == 1);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::WriteInitialDataSnapshot()
+//! \brief Writes the initial data to snapshot fname in restart format.  The file is
+//! written under a temporary name and then renamed, so interrupted runs never leave a
+//! partial snapshot behind.
+
+void ProblemGenerator::WriteInitialDataSnapshot(ParameterInput *pin,
+                                                const std::string &fname) {
+  OutputParameters op;
+  op.block_name = "problem";
+  op.file_type = "rst";
+  op.file_basename = "id_snapshot";
+  op.file_number = 0;
+  op.last_time = -1.0;
+  op.dt = 0.0;
+  op.dcycle = 0;
+  op.include_gzs = true;
+  RestartOutput snapshot(pin, pmy_mesh_, op);
+  snapshot.LoadOutputData(pmy_mesh_);
+  std::string tmpname = fname + ".tmp";
+  snapshot.WriteRestartFile(pmy_mesh_, pin, tmpname);
+  snapshot.CompleteWrites();
+#if MPI_PARALLEL_ENABLED
+  MPI_Barrier(MPI_COMM_WORLD);
+#endif
+  if (global_variable::my_rank == 0) {
+    if (std::rename(tmpname.c_str(), fname.c_str()) != 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Initial data snapshot '" << fname << "' could not be written"
+                << std::endl;
+    } else {
+      std::cout << "Initial data written to snapshot '" << fname << "'" << std::endl;
+    }
+  }
+}
@@ -10,6 +10,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "geodesic-grid/spherical_grid.hpp"
@@ -20,6 +21,10 @@ using UserBoundaryFnPtr = void (*)(Mesh* pm);
 using UserSrctermFnPtr = void (*)(Mesh* pm, const Real bdt);
 using UserRefinementFnPtr = void (*)(MeshBlockPack* pmbp);
 using UserHistoryFnPtr = void (*)(HistoryData *pdata, Mesh *pm);
+// user source terms enrolled as device functors, see pgen/user_srcterms.hpp
+using UserSrctermKernel = std::function<void(MeshBlockPack *pmbp,
+      const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0, const Real bdt,
+      DvceArray5D<Real> &u0)>;
 
 //----------------------------------------------------------------------------------------
 //! \class ProblemGenerator
@@ -50,6 +55,8 @@ class ProblemGenerator {
   // function pointer for user-enrolled BCs.  Called in ApplyPhysicalBCs in task list
   UserBoundaryFnPtr user_bcs_func=nullptr;
   UserSrctermFnPtr user_srcs_func=nullptr;
+  // per-cell user source functors, fused into one kernel.  Called in Hydro/MHD SrcTerms
+  UserSrctermKernel user_srcs_kernel;
   UserRefinementFnPtr user_ref_func=nullptr;
   UserHistoryFnPtr user_hist_func=nullptr;
 
@@ -59,6 +66,7 @@ class ProblemGenerator {
   void BondiAccretion(ParameterInput *pin, const bool restart);
   void CheckOrthonormalTetrad(ParameterInput *pin, const bool restart);
   void Hohlraum(ParameterInput *pin, const bool restart);
+  void JeansWave(ParameterInput *pin, const bool restart);
   void LinearWave(ParameterInput *pin, const bool restart);
   void LWImplode(ParameterInput *pin, const bool restart);
   void Monopole(ParameterInput *pin, const bool restart);
@@ -68,10 +76,20 @@ class ProblemGenerator {
   void Z4cLinearWave(ParameterInput *pin, const bool restart);
   void SphericalCollapse(ParameterInput *pin, const bool restart);
   void Diffusion(ParameterInput *pin, const bool restart);
+  void ReconBenchmark(ParameterInput *pin, const bool restart);
+  void C2PBenchmark(ParameterInput *pin, const bool restart);
+  void Benchmark(ParameterInput *pin, const bool restart);
+
+  // enrolls per-cell device functors as user source terms (see pgen/user_srcterms.hpp)
+  template <typename... Fs> void EnrollUserSrcTerms(const Fs&... fs);
 
   // template for user-specified problem generator
   void UserProblem(ParameterInput *pin, const bool restart);
 
+  // snapshots of initial data in restart format, keyed on the input parameters
+  static bool FindInitialDataSnapshot(ParameterInput *pin, std::string &fname);
+  void WriteInitialDataSnapshot(ParameterInput *pin, const std::string &fname);
+
  private:
   Mesh* pmy_mesh_;
 };
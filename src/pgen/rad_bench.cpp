@@ -0,0 +1,148 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file rad_bench.cpp
+//! \brief Problem generator for benchmarking the radiation module.  Sets a smooth,
+//! periodic synthetic fluid (density, temperature and velocity perturbed by sinusoids of
+//! relative amplitude amp) and a radiation field that is isotropic in the fluid frame
+//! with energy density arad*T^4*(1+amp*sin), so that the flux, source and communication
+//! parts of the radiation update all do representative work.  Intended to be run for a
+//! fixed number of cycles with <radiation>/fixed_fluid=true and <tasks>/profile=true, in
+//! which case Driver::Finalize() prints the angle-zone-cycles per second of each part.
+//! Block sizes and <radiation>/nlevel can then be varied with the same input file.
+
+// C++ headers
+#include <cmath>      // sin, cos
+#include <iostream>   // endl
+
+// Athena++ headers
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+#include "hydro/hydro.hpp"
+#include "radiation/radiation.hpp"
+#include "pgen.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::UserProblem(ParameterInput *pin)
+//! \brief Sets initial conditions for radiation benchmark
+
+void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (restart) return;
+
+  if (pmbp->prad == nullptr || pmbp->phydro == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Radiation benchmark requires <radiation> and <hydro> blocks in input "
+              << "file" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // capture variables for kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  int &is = indcs.is;
+  int &js = indcs.js;
+  int &ks = indcs.ks;
+  auto &size = pmbp->pmb->mb_size;
+  int nmb1 = (pmbp->nmb_thispack-1);
+  int nang1 = (pmbp->prad->prgeo->nangles-1);
+  Real arad_ = pmbp->prad->arad;
+  Real gm1 = pmbp->phydro->peos->eos_data.gamma - 1.0;
+
+  // get problem parameters
+  Real rho0 = pin->GetOrAddReal("problem", "rho0", 1.0);
+  Real temp0 = pin->GetOrAddReal("problem", "temp0", 1.0);
+  Real v0 = pin->GetOrAddReal("problem", "v0", 0.1);
+  Real amp = pin->GetOrAddReal("problem", "amp", 0.1);
+  Real lx1 = pmy_mesh_->mesh_size.x1max - pmy_mesh_->mesh_size.x1min;
+  Real lx2 = pmy_mesh_->mesh_size.x2max - pmy_mesh_->mesh_size.x2min;
+  Real lx3 = pmy_mesh_->mesh_size.x3max - pmy_mesh_->mesh_size.x3min;
+  Real kx1 = 2.0*M_PI/lx1, kx2 = 2.0*M_PI/lx2, kx3 = 2.0*M_PI/lx3;
+
+  // set primitive variables
+  auto &w0 = pmbp->phydro->w0;
+  par_for("pgen_rad_bench1",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+
+    Real &x2min = size.d_view(m).x2min;
+    Real &x2max = size.d_view(m).x2max;
+    Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+
+    Real &x3min = size.d_view(m).x3min;
+    Real &x3max = size.d_view(m).x3max;
+    Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+
+    Real s1 = sin(kx1*x1v), s2 = sin(kx2*x2v), s3 = sin(kx3*x3v);
+    Real rho = rho0*(1.0 + amp*s1*s2*s3);
+    Real temp = temp0*(1.0 + amp*cos(kx1*x1v)*s2);
+    w0(m,IDN,k,j,i) = rho;
+    w0(m,IVX,k,j,i) = v0*s2;
+    w0(m,IVY,k,j,i) = v0*s3;
+    w0(m,IVZ,k,j,i) = v0*s1;
+    w0(m,IEN,k,j,i) = rho*temp/gm1;
+  });
+
+  // Convert primitives to conserved
+  auto &u0 = pmbp->phydro->u0;
+  pmbp->phydro->peos->PrimToCons(w0, u0, 0, (n1-1), 0, (n2-1), 0, (n3-1));
+
+  auto &norm_to_tet_ = pmbp->prad->norm_to_tet;
+  auto &nh_c_ = pmbp->prad->nh_c;
+  auto &tet_c_ = pmbp->prad->tet_c;
+  auto &tetcov_c_ = pmbp->prad->tetcov_c;
+
+  // set intensity isotropic in fluid frame and in equilibrium with perturbed temperature
+  auto &i0 = pmbp->prad->i0;
+  par_for("pgen_rad_bench2",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+
+    Real &x3min = size.d_view(m).x3min;
+    Real &x3max = size.d_view(m).x3max;
+    Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+
+    // Compute fluid velocity in tetrad frame
+    Real uu1 = w0(m,IVX,k,j,i);
+    Real uu2 = w0(m,IVY,k,j,i);
+    Real uu3 = w0(m,IVZ,k,j,i);
+    Real uu0 = sqrt(1.0 + SQR(uu1) + SQR(uu2) + SQR(uu3));
+
+    Real u_tet_[4];
+    for (int d=0; d<4; ++d) {
+      u_tet_[d] = (norm_to_tet_(m,d,0,k,j,i)*uu0 + norm_to_tet_(m,d,1,k,j,i)*uu1 +
+                   norm_to_tet_(m,d,2,k,j,i)*uu2 + norm_to_tet_(m,d,3,k,j,i)*uu3);
+    }
+
+    Real temp = gm1*w0(m,IEN,k,j,i)/w0(m,IDN,k,j,i);
+    Real erad = arad_*SQR(SQR(temp))*(1.0 + amp*sin(kx1*x1v + kx3*x3v));
+    Real ii_f =  erad/(4.0*M_PI);
+
+    for (int n=0; n<=nang1; ++n) {
+      // Calculate direction in fluid frame
+      Real un_t =  (u_tet_[1]*nh_c_.d_view(n,1) + u_tet_[2]*nh_c_.d_view(n,2) +
+                    u_tet_[3]*nh_c_.d_view(n,3));
+      Real n0_f =  u_tet_[0]*nh_c_.d_view(n,0) - un_t;
+
+      // Calculate intensity in tetrad frame
+      Real n0 = tet_c_(m,0,0,k,j,i); Real n_0 = 0.0;
+      for (int d=0; d<4; ++d) {  n_0 += tetcov_c_(m,d,0,k,j,i)*nh_c_.d_view(n,d);  }
+      i0(m,n,k,j,i) = n0*n_0*ii_f/SQR(SQR(n0_f));
+    }
+  });
+
+  return;
+}
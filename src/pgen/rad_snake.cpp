@@ -20,6 +20,7 @@
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "mesh/mesh.hpp"
 #include "radiation/radiation.hpp"
+#include "radiation/radiation_tetrad.hpp"
 #include "srcterms/srcterms.hpp"
 #include "pgen.hpp"
 
@@ -65,6 +66,8 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   auto &tetcov_c_ = pmbp->prad->tetcov_c;
   auto &unit_flux_ = pmbp->prad->prgeo->unit_flux;
   auto &na_ = pmbp->prad->na;
+  bool &compact = pmbp->prad->compact_tetrad;
+  auto &tet_omega_ = pmbp->prad->tet_omega;
   par_for("tet_c",DevExeSpace(),0,(nmb-1),0,(n3-1),0,(n2-1),0,(n1-1),
   KOKKOS_LAMBDA(int m, int k, int j, int i) {
     Real &x1min = size.d_view(m).x1min;
@@ -93,7 +96,11 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
       }
     }
 
-    // set n^a coordinate components
+    // set n^a coordinate components (or coefficients used to compute them)
+    if (compact) {
+      StoreCompactOmega(omega, tet_omega_, m, k, j, i);
+      return;
+    }
     for (int n=0; n<=nang1; ++n) {
       for (int nb=0; nb<num_neighbors_.d_view(n); ++nb) {
         Real zetaf = acos(nh_f_.d_view(n,nb,3));
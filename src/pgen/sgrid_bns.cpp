@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <iomanip>
 #include <iostream>
 #include <limits>
 #include <sstream>
@@ -27,6 +28,7 @@
 #include "mesh/mesh.hpp"
 #include "mhd/mhd.hpp"
 #include "parameter_input.hpp"
+#include "utils/id_import.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/z4c_amr.hpp"
 
@@ -97,6 +99,32 @@ enum {
                   // used...
 };
 
+// Initial data variables stored by InitialDataImport
+enum {
+  id_alpha,
+  id_betax,
+  id_betay,
+  id_betaz,
+  id_gxx,
+  id_gxy,
+  id_gxz,
+  id_gyy,
+  id_gyz,
+  id_gzz,
+  id_Kxx,
+  id_Kxy,
+  id_Kxz,
+  id_Kyy,
+  id_Kyz,
+  id_Kzz,
+  id_rho,
+  id_press,
+  id_vx,
+  id_vy,
+  id_vz,
+  NIDVARS
+};
+
 namespace {
 // Utilities wrapping various SGRID DNS calls (DNS_*)
 void DNS_init_sgrid(ParameterInput *pin);
@@ -128,7 +156,6 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
   auto &indcs = pmy_mesh_->mb_indcs;
-  auto &size = pmbp->pmb->mb_size;
   int &is = indcs.is;
   int &ie = indcs.ie;
   int &js = indcs.js;
@@ -170,18 +197,106 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   }
   SGRID_DNSdata_Interpolate_ADMvars_to_xyz(NULL, NULL, 1);
 
-  //
   // Capture variables for kernel; note that when Z4c is enabled, the gauge
   // variables are part of the Z4c class.
   auto &u_adm = pmbp->padm->u_adm;
   auto &w0 = pmbp->pmhd->w0;
   auto &u_z4c = pmbp->pz4c->u0;
-  // Because SGRID only operates on the CPU, we can't construct the data on the
-  // GPU. Instead, we create a mirror guaranteed to be on the CPU, populate the
-  // data there, then move it back to the GPU.
-  // TODO(JMF): This needs to be tested on CPUs to ensure that it functions
-  // properly; In theory, create_mirror_view shouldn't copy the data unless it's
-  // in a different memory space.
+
+  // Evaluate SGRID on active cells (with ghost cells filled by communication).
+  // SGRID_DNSdata_Interpolate_ADMvars_to_xyz() is supposed to be threadsafe, so
+  // points are split over <problem>/id_nthreads host threads (set it to 1 if the
+  // SGRID library in use is not).
+  // REMARK: you need to compile SGRID without OpenMP support!
+  std::ostringstream source;
+  source << std::setprecision(17) << "sgrid:" << pin->GetString("problem", "datadir")
+         << ":" << sgrid_x_CM << ":" << rotation180;
+  InitialDataImport idi(pmbp, pin, NIDVARS);
+  idi.Import(source.str(),
+  [&](int npts, const Real *x, const Real *y, const Real *z, Real *vals) {
+    for (int p = 0; p < npts; p++) {
+      Real zb = z[p];
+      Real yb = y[p] * s180; // multiply by -1 if 180 degree rotation
+      Real xb = x[p] * s180;
+      Real xs = xb + sgrid_x_CM; // shift x-coord
+      Real xyz[3] = {xs, yb, zb};
+
+      // Initial data variables at one point
+      // 20 values for the fields at (x_i,y_j,z_k) ordered as:
+      //  alpha DNSdata_Bx DNSdata_By DNSdata_Bz
+      //  gxx gxy gxz gyy gyz gzz
+      //  Kxx Kxy Kxz Kyy Kyz Kzz
+      //  q VRx VRy VRz
+      Real IDvars[idvar_NDATAMAX];
+
+      // Interpolate
+      // This call is supposed to be threadsafe, it contains an OMP Critical
+      SGRID_DNSdata_Interpolate_ADMvars_to_xyz(xyz, IDvars, 0);
+
+      // transform some tensor components, if we have a 180 degree rotation
+      IDvars[idvar_Bx] *= s180;
+      IDvars[idvar_By] *= s180;
+      IDvars[idvar_gxz] *= s180;
+      IDvars[idvar_gyz] *= s180;
+      IDvars[idvar_Kxz] *= s180;
+      IDvars[idvar_Kyz] *= s180;
+      IDvars[idvar_VRx] *= s180;
+      IDvars[idvar_VRy] *= s180;
+
+      // Extract metric quantities
+      Real *v = vals + p*NIDVARS;
+      v[id_alpha] = IDvars[idvar_alpha];
+      v[id_betax] = IDvars[idvar_Bx];
+      v[id_betay] = IDvars[idvar_By];
+      v[id_betaz] = IDvars[idvar_Bz];
+      for (int a = 0; a < 6; a++) {
+        v[id_gxx + a] = IDvars[idvar_gxx + a];
+        v[id_Kxx + a] = IDvars[idvar_Kxx + a];
+      }
+
+      // Extract hydro quantities
+      Real rho = 0;
+      Real press = 0;
+      Real eps = 0;
+      Real v_u_x = 0, v_u_y = 0, v_u_z = 0;
+
+      // if we are in matter region, convert q, VR to rho, press, eps, v^i :
+      if (IDvars[idvar_q] > 0.0) {
+        SGRID_EoS_T0_rho0_P_rhoE_from_hm1(IDvars[idvar_q], &rho, &press,
+                                          &eps);
+
+        // 3-velocity  v^i
+        Real xmax = (xb > 0) ? xmax1 : xmax2;
+
+        // construct KV xi from Omega, ecc, rdot, xmax1-xmax2
+        Real xix = -Omega * yb + xb * rdotor; // CM is at (0,0,0) in bam
+        Real xiy = Omega * (xb - ecc * xmax) + yb * rdotor;
+        Real xiz = zb * rdotor;
+
+        // vI^i = VR^i + xi^i
+        Real vIx = IDvars[idvar_VRx] + xix;
+        Real vIy = IDvars[idvar_VRy] + xiy;
+        Real vIz = IDvars[idvar_VRz] + xiz;
+
+        // Note: vI^i = u^i/u^0 in DNSdata,
+        //       while matter_v^i = u^i/(alpha u^0) + beta^i / alpha
+        //   ==> matter_v^i = (vI^i + beta^i)/alpha
+        v_u_x = (vIx + IDvars[idvar_Bx]) / IDvars[idvar_alpha];
+        v_u_y = (vIy + IDvars[idvar_By]) / IDvars[idvar_alpha];
+        v_u_z = (vIz + IDvars[idvar_Bz]) / IDvars[idvar_alpha];
+      }
+      v[id_rho] = rho;
+      v[id_press] = press;
+      v[id_vx] = v_u_x;
+      v[id_vy] = v_u_y;
+      v[id_vz] = v_u_z;
+    }
+  }, true);
+  auto &id = idi.u_h;
+
+  // Because SGRID only operates on the CPU, the imported data is on the host. We
+  // create a mirror guaranteed to be on the CPU, populate the data there, then move
+  // it back to the GPU.
   HostArray5D<Real>::HostMirror host_u_adm = create_mirror_view(u_adm);
   HostArray5D<Real>::HostMirror host_w0 = create_mirror_view(w0);
   HostArray5D<Real>::HostMirror host_u_z4c = create_mirror_view(u_z4c);
@@ -197,120 +312,41 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   if (verbose)
     std::cout << "Host mirrors created." << std::endl;
 
-  // REMARK: you need to compile SGRID without OpenMP support!
   int ncells1 = indcs.nx1 + 2 * (indcs.ng);
   int ncells2 = indcs.nx2 + 2 * (indcs.ng);
   int ncells3 = indcs.nx3 + 2 * (indcs.ng);
   int nmb = pmbp->nmb_thispack;
 
-  // TODO(DR): Use a Kokkos loop to improve performance
   for (int m = 0; m < nmb; m++)
     for (int k = 0; k < ncells3; k++)
       for (int j = 0; j < ncells2; j++)
         for (int i = 0; i < ncells1; i++) {
-          Real &x1min = size.h_view(m).x1min;
-          // not to be confused by xmax1, which is used by SGRID
-          Real &x1max = size.h_view(m).x1max;
-          int nx1 = indcs.nx1;
-
-          Real &x2min = size.h_view(m).x2min;
-          // not to be confused by xmax2, which is used by SGRID
-          Real &x2max = size.h_view(m).x2max;
-          int nx2 = indcs.nx2;
-
-          Real &x3min = size.h_view(m).x3min;
-          Real &x3max = size.h_view(m).x3max;
-          int nx3 = indcs.nx3;
-
-          const Real z = CellCenterX(k - ks, nx3, x3min, x3max);
-          const Real y = CellCenterX(j - js, nx2, x2min, x2max);
-          const Real x = CellCenterX(i - is, nx1, x1min, x1max);
-
-          Real zb = z;
-          Real yb = y * s180; // multiply by -1 if 180 degree rotation
-          Real xb = x * s180;
-          Real xs = xb + sgrid_x_CM; // shift x-coord
-          Real xyz[3] = {xs, yb, zb};
-
-          // Initial data variables at one point
-          // 20 values for the fields at (x_i,y_j,z_k) ordered as:
-          //  alpha DNSdata_Bx DNSdata_By DNSdata_Bz
-          //  gxx gxy gxz gyy gyz gzz
-          //  Kxx Kxy Kxz Kyy Kyz Kzz
-          //  q VRx VRy VRz
-          Real IDvars[idvar_NDATAMAX];
-
-          // Interpolate
-          // This call is supposed to be threadsafe, it contains an OMP Critical
-          SGRID_DNSdata_Interpolate_ADMvars_to_xyz(xyz, IDvars, 0);
-
-          // transform some tensor components, if we have a 180 degree rotation
-          IDvars[idvar_Bx] *= s180;
-          IDvars[idvar_By] *= s180;
-          IDvars[idvar_gxz] *= s180;
-          IDvars[idvar_gyz] *= s180;
-          IDvars[idvar_Kxz] *= s180;
-          IDvars[idvar_Kyz] *= s180;
-          IDvars[idvar_VRx] *= s180;
-          IDvars[idvar_VRy] *= s180;
-
-          // Extract metric quantities
-          host_adm.alpha(m, k, j, i) = IDvars[idvar_alpha];
-          host_adm.beta_u(m, 0, k, j, i) = IDvars[idvar_Bx];
-          host_adm.beta_u(m, 1, k, j, i) = IDvars[idvar_By];
-          host_adm.beta_u(m, 2, k, j, i) = IDvars[idvar_Bz];
+          // Store metric quantities
+          host_adm.alpha(m, k, j, i) = id(m, id_alpha, k, j, i);
+          host_adm.beta_u(m, 0, k, j, i) = id(m, id_betax, k, j, i);
+          host_adm.beta_u(m, 1, k, j, i) = id(m, id_betay, k, j, i);
+          host_adm.beta_u(m, 2, k, j, i) = id(m, id_betaz, k, j, i);
 
           Real g3d[NSPMETRIC];
-          host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = IDvars[idvar_gxx];
-          host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = IDvars[idvar_gxy];
-          host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = IDvars[idvar_gxz];
-          host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = IDvars[idvar_gyy];
-          host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = IDvars[idvar_gyz];
-          host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = IDvars[idvar_gzz];
-
-          host_adm.vK_dd(m, 0, 0, k, j, i) = IDvars[idvar_Kxx];
-          host_adm.vK_dd(m, 0, 1, k, j, i) = IDvars[idvar_Kxy];
-          host_adm.vK_dd(m, 0, 2, k, j, i) = IDvars[idvar_Kxz];
-          host_adm.vK_dd(m, 1, 1, k, j, i) = IDvars[idvar_Kyy];
-          host_adm.vK_dd(m, 1, 2, k, j, i) = IDvars[idvar_Kyz];
-          host_adm.vK_dd(m, 2, 2, k, j, i) = IDvars[idvar_Kzz];
-
-          // Extract hydro quantities
-          Real rho = 0;
-          Real press = 0;
-          Real eps = 0;
-          Real v_u_x = 0, v_u_y = 0, v_u_z = 0;
-
-          // if we are in matter region, convert q, VR to rho, press, eps, v^i :
-          if (IDvars[idvar_q] > 0.0) {
-            SGRID_EoS_T0_rho0_P_rhoE_from_hm1(IDvars[idvar_q], &rho, &press,
-                                              &eps);
-
-            // 3-velocity  v^i
-            Real xmax = (xb > 0) ? xmax1 : xmax2;
-
-            // construct KV xi from Omega, ecc, rdot, xmax1-xmax2
-            Real xix = -Omega * yb + xb * rdotor; // CM is at (0,0,0) in bam
-            Real xiy = Omega * (xb - ecc * xmax) + yb * rdotor;
-            Real xiz = zb * rdotor;
-
-            // vI^i = VR^i + xi^i
-            Real vIx = IDvars[idvar_VRx] + xix;
-            Real vIy = IDvars[idvar_VRy] + xiy;
-            Real vIz = IDvars[idvar_VRz] + xiz;
-
-            // Note: vI^i = u^i/u^0 in DNSdata,
-            //       while matter_v^i = u^i/(alpha u^0) + beta^i / alpha
-            //   ==> matter_v^i = (vI^i + beta^i)/alpha
-            v_u_x = (vIx + IDvars[idvar_Bx]) / IDvars[idvar_alpha];
-            v_u_y = (vIy + IDvars[idvar_By]) / IDvars[idvar_alpha];
-            v_u_z = (vIz + IDvars[idvar_Bz]) / IDvars[idvar_alpha];
-          }
+          host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = id(m, id_gxx, k, j, i);
+          host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = id(m, id_gxy, k, j, i);
+          host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = id(m, id_gxz, k, j, i);
+          host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = id(m, id_gyy, k, j, i);
+          host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = id(m, id_gyz, k, j, i);
+          host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = id(m, id_gzz, k, j, i);
+
+          host_adm.vK_dd(m, 0, 0, k, j, i) = id(m, id_Kxx, k, j, i);
+          host_adm.vK_dd(m, 0, 1, k, j, i) = id(m, id_Kxy, k, j, i);
+          host_adm.vK_dd(m, 0, 2, k, j, i) = id(m, id_Kxz, k, j, i);
+          host_adm.vK_dd(m, 1, 1, k, j, i) = id(m, id_Kyy, k, j, i);
+          host_adm.vK_dd(m, 1, 2, k, j, i) = id(m, id_Kyz, k, j, i);
+          host_adm.vK_dd(m, 2, 2, k, j, i) = id(m, id_Kzz, k, j, i);
 
           // Store fluid quantities
-          host_w0(m, IDN, k, j, i) = rho;
-          host_w0(m, IPR, k, j, i) = press;
-          Real vu[3] = {v_u_x, v_u_y, v_u_z};
+          host_w0(m, IDN, k, j, i) = id(m, id_rho, k, j, i);
+          host_w0(m, IPR, k, j, i) = id(m, id_press, k, j, i);
+          Real vu[3] = {id(m, id_vx, k, j, i), id(m, id_vy, k, j, i),
+                        id(m, id_vz, k, j, i)};
 
           // Before we store the velocity, we need to make sure it's physical
           // and calculate the Lorentz factor. If the velocity is superluminal,
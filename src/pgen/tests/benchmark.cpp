@@ -0,0 +1,217 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file benchmark.cpp
+//! \brief Problem generator for weak- and strong-scaling benchmarks of Hydro or MHD.
+//!
+//! Initializes a uniform medium (with a uniform magnetic field for MHD) containing a
+//! smooth over-pressured sphere, so that the same setup exercises uniform meshes, SMR
+//! (regions set in <refinement*> blocks) and AMR (refinement triggered by the pressure
+//! jump, e.g. with <mesh_refinement>/dpres_max).  The size of the Mesh and MeshBlocks is
+//! taken from the input file; scripts/run_scaling.sh shows how to scale the Mesh with
+//! the number of ranks for weak scaling.  Run with time/nlim set to the number of cycles.
+//!
+//! At the end of the run a report is written to <basename>.bench, with one row per rank
+//! containing the number of MeshBlocks and cells, and the time spent in computation, in
+//! halo exchange (Send/Recv/Clear Tasks, and the part of that spent waiting on MPI), in
+//! AMR and in outputs, plus the number and size of MPI messages sent.  Task times require
+//! <tasks>/profile=true, which is the default when using this problem generator.
+
+#include <cmath>      // exp(), log(), sqrt()
+#include <cstdint>
+#include <cstdio>     // fopen(), fprintf()
+#include <iostream>   // endl
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "bvals/bvals.hpp"
+#include "outputs/outputs.hpp"
+#include "pgen/pgen.hpp"
+
+// user-defined analysis called at end of run
+void BenchmarkReport(ParameterInput *pin, Mesh *pm);
+
+namespace {
+Kokkos::Timer bench_timer;   // reset at end of problem generator
+
+//----------------------------------------------------------------------------------------
+//! \fn bool IsHaloTask()
+//! \brief Tasks exchanging boundary values or fluxes, identified by the part of their
+//! name after the module prefix (e.g. "Hydro_SendU").
+
+bool IsHaloTask(const std::string &name) {
+  std::string task = name.substr(name.find('_') + 1);
+  return (task.compare(0, 4, "Send") == 0 || task.compare(0, 4, "Recv") == 0 ||
+          task.compare(0, 5, "Clear") == 0 || task.compare(0, 8, "InitRecv") == 0);
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::Benchmark()
+//! \brief Sets initial conditions for scaling benchmark
+
+void ProblemGenerator::Benchmark(ParameterInput *pin, const bool restart) {
+  // times of each Task are needed for the report
+  pin->GetOrAddBoolean("tasks", "profile", true);
+  pin->GetOrAddBoolean("tasks", "profile_fence", true);
+  pgen_final_func = BenchmarkReport;
+  bench_timer.reset();
+  if (restart) return;
+
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->phydro == nullptr && pmbp->pmhd == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Benchmark problem requires a <hydro> or <mhd> block in input file"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  Real d_amb = pin->GetOrAddReal("problem", "d_amb", 1.0);
+  Real p_amb = pin->GetOrAddReal("problem", "p_amb", 1.0);
+  Real prat = pin->GetOrAddReal("problem", "prat", 10.0);
+  Real rout = pin->GetOrAddReal("problem", "radius", 0.1);
+  Real rin = 0.5*rout;
+  Real b_amb = pin->GetOrAddReal("problem", "b_amb", 1.0);
+
+  // capture variables for kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  auto &size = pmbp->pmb->mb_size;
+  bool is_mhd = (pmbp->pmhd != nullptr);
+  EOS_Data &eos = (is_mhd)? pmbp->pmhd->peos->eos_data : pmbp->phydro->peos->eos_data;
+  Real gm1 = eos.gamma - 1.0;
+  auto &w0_ = (is_mhd)? pmbp->pmhd->w0 : pmbp->phydro->w0;
+
+  par_for("pgen_bench1", DevExeSpace(), 0, (pmbp->nmb_thispack-1), ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+
+    Real &x2min = size.d_view(m).x2min;
+    Real &x2max = size.d_view(m).x2max;
+    Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+
+    Real &x3min = size.d_view(m).x3min;
+    Real &x3max = size.d_view(m).x3max;
+    Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+
+    // pressure ramps smoothly from prat*p_amb inside rin to p_amb outside rout
+    Real rad = sqrt(SQR(x1v) + SQR(x2v) + SQR(x3v));
+    Real pres = p_amb;
+    if (rad < rin) {
+      pres = prat*p_amb;
+    } else if (rad < rout) {
+      Real f = (rad - rin)/(rout - rin);
+      pres = exp((1.0 - f)*log(prat*p_amb) + f*log(p_amb));
+    }
+    w0_(m,IDN,k,j,i) = d_amb;
+    w0_(m,IVX,k,j,i) = 0.0;
+    w0_(m,IVY,k,j,i) = 0.0;
+    w0_(m,IVZ,k,j,i) = 0.0;
+    w0_(m,IEN,k,j,i) = pres/gm1;
+  });
+
+  if (!(is_mhd)) {
+    pmbp->phydro->peos->PrimToCons(w0_, pmbp->phydro->u0, is, ie, js, je, ks, ke);
+    return;
+  }
+
+  // uniform magnetic field at 45 degrees in x1-x2 plane
+  Real bx = b_amb/sqrt(2.0), by = b_amb/sqrt(2.0);
+  auto &b0 = pmbp->pmhd->b0;
+  auto &bcc0 = pmbp->pmhd->bcc0;
+  par_for("pgen_bench2", DevExeSpace(), 0, (pmbp->nmb_thispack-1), ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    b0.x1f(m,k,j,i) = bx;
+    b0.x2f(m,k,j,i) = by;
+    b0.x3f(m,k,j,i) = 0.0;
+    if (i==ie) {b0.x1f(m,k,j,i+1) = bx;}
+    if (j==je) {b0.x2f(m,k,j+1,i) = by;}
+    if (k==ke) {b0.x3f(m,k+1,j,i) = 0.0;}
+    bcc0(m,IBX,k,j,i) = bx;
+    bcc0(m,IBY,k,j,i) = by;
+    bcc0(m,IBZ,k,j,i) = 0.0;
+  });
+  pmbp->pmhd->peos->PrimToCons(w0_, bcc0, pmbp->pmhd->u0, is, ie, js, je, ks, ke);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BenchmarkReport()
+//! \brief Gathers the timing breakdown and message counts of every rank on rank 0, and
+//! writes them to <basename>.bench
+
+void BenchmarkReport(ParameterInput *pin, Mesh *pm) {
+  Kokkos::fence();
+  double elapsed = bench_timer.seconds();
+  // time of computational and halo exchange Tasks on this rank
+  double comp = 0.0, halo = 0.0, halo_wait = 0.0;
+  for (auto &it : pm->pmb_pack->tl_map) {
+    for (auto &task : it.second->GetTasks()) {
+      if (IsHaloTask(task.GetName())) {
+        halo += task.dvce_time;
+        halo_wait += task.wait_time;
+      } else {
+        comp += task.dvce_time;
+      }
+    }
+  }
+  constexpr int nval = 10;
+  double amr = (pm->pmr != nullptr)? pm->pmr->amr_time : 0.0;
+  int nmb = pm->pmb_pack->nmb_thispack;
+  double vals[nval] = {static_cast<double>(nmb),
+                       static_cast<double>(nmb)*pm->NumberOfMeshBlockCells(),
+                       elapsed, comp, halo, halo_wait, amr, BaseTypeOutput::io_time,
+                       static_cast<double>(MeshBoundaryValues::nmsg_sent),
+                       static_cast<double>(MeshBoundaryValues::nbytes_sent)};
+  std::vector<double> all(nval*global_variable::nranks);
+#if MPI_PARALLEL_ENABLED
+  MPI_Gather(vals, nval, MPI_DOUBLE, all.data(), nval, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#else
+  for (int n=0; n<nval; ++n) {all[n] = vals[n];}
+#endif
+  if (global_variable::my_rank != 0) return;
+
+  std::string fname;
+  fname.assign(pin->GetString("job","basename"));
+  fname.append(".bench");
+  FILE *pfile;
+  if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Benchmark report file could not be opened" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  auto &mesh = pm->mesh_indcs;
+  auto &mb = pm->mb_indcs;
+  std::fprintf(pfile, "# physics = %s\n", (pm->pmb_pack->pmhd != nullptr)? "mhd":"hydro");
+  std::fprintf(pfile, "# nranks = %d\n", global_variable::nranks);
+  std::fprintf(pfile, "# mesh = %d %d %d\n", mesh.nx1, mesh.nx2, mesh.nx3);
+  std::fprintf(pfile, "# meshblock = %d %d %d\n", mb.nx1, mb.nx2, mb.nx3);
+  std::fprintf(pfile, "# refinement = %s\n",
+               pm->adaptive? "adaptive" : (pm->multilevel? "static" : "none"));
+  std::fprintf(pfile, "# nmb_total = %d\n", pm->nmb_total);
+  std::fprintf(pfile, "# ncycle = %d\n", pm->ncycle);
+  std::fprintf(pfile, "# times in seconds, elapsed includes Driver initialization\n");
+  std::fprintf(pfile, "# rank   nmb        ncells     elapsed     compute        halo"
+                      "   halo_wait         amr          io      nmsg    mbytes\n");
+  for (int r=0; r<global_variable::nranks; ++r) {
+    double *v = &(all[nval*r]);
+    std::fprintf(pfile, "%6d %5d %13.0f %11.4e %11.4e %11.4e %11.4e %11.4e %11.4e %9.0f "
+                 "%9.2f\n", r, static_cast<int>(v[0]), v[1], v[2], v[3], v[4], v[5],
+                 v[6], v[7], v[8], v[9]/1048576.0);
+  }
+  std::fclose(pfile);
+  return;
+}
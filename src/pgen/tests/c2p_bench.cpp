@@ -0,0 +1,133 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file c2p_bench.cpp
+//! \brief Problem generator that benchmarks the conserved-to-primitive inversion used by
+//! dynamical GRMHD.  Initializes the MHD primitives and face-centered fields with random
+//! values in flat space, computes the conserved variables, then times nrep calls to
+//! ConToPrimBC() over the active zones of every MeshBlock in the pack.  The throughput
+//! and the EOS selected by <mhd>/dyn_eos are printed to stdout on rank 0, so that the
+//! cost of each EOS can be compared by running the same input with different EOS.
+//! Should be run with time/nlim=0.
+
+#include <Kokkos_Random.hpp>
+
+#include <cstdio>     // printf()
+#include <iostream>   // endl
+#include <string>     // string
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/adm.hpp"
+#include "mhd/mhd.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
+#include "pgen/pgen.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::C2PBenchmark()
+//! \brief Problem Generator for benchmarking the dynamical GRMHD c2p
+
+void ProblemGenerator::C2PBenchmark(ParameterInput *pin, const bool restart) {
+  if (restart) return;
+
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->pdyngr == nullptr || pmbp->padm == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "c2p benchmark requires dynamical GRMHD (<mhd> and <adm> blocks)"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  int nrep = pin->GetOrAddInteger("problem", "nrep", 10);
+  Real rho0 = pin->GetOrAddReal("problem", "rho0", 1.0e-3);
+  Real pgas0 = pin->GetOrAddReal("problem", "pgas0", 1.0e-5);
+  Real vmax = pin->GetOrAddReal("problem", "vmax", 0.5);
+  Real bmax = pin->GetOrAddReal("problem", "bmax", 1.0e-3);
+  Real ye0 = pin->GetOrAddReal("problem", "ye0", 0.1);
+
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmbp->nmb_thispack - 1;
+  int ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1) ? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1) ? (indcs.nx3 + 2*ng) : 1;
+
+  // Flat metric everywhere
+  auto &adm = pmbp->padm->adm;
+  par_for("pgen_c2p_bench_adm", DevExeSpace(), 0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    adm.alpha(m,k,j,i) = 1.0;
+    adm.psi4(m,k,j,i) = 1.0;
+    for (int a = 0; a < 3; ++a) {
+      adm.beta_u(m,a,k,j,i) = 0.0;
+      for (int b = a; b < 3; ++b) {
+        adm.g_dd(m,a,b,k,j,i) = (a == b) ? 1.0 : 0.0;
+        adm.vK_dd(m,a,b,k,j,i) = 0.0;
+      }
+    }
+  });
+
+  // Random primitives: density and pressure in [1,2] times rho0 and pgas0, velocity
+  // components in [-vmax,vmax]/sqrt(3), and face fields in [-bmax,bmax]
+  auto &w0 = pmbp->pmhd->w0;
+  auto &b0 = pmbp->pmhd->b0;
+  auto &bcc0 = pmbp->pmhd->bcc0;
+  int nmhd = pmbp->pmhd->nmhd;
+  int nscal = pmbp->pmhd->nscalars;
+  Real vfac = vmax/sqrt(3.0);
+  Kokkos::Random_XorShift64_Pool<> rand_pool64(pmbp->gids);
+  par_for("pgen_c2p_bench", DevExeSpace(), 0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    auto rand_gen = rand_pool64.get_state();  // get random number state this thread
+    w0(m,IDN,k,j,i) = rho0*(1.0 + rand_gen.frand());
+    w0(m,IVX,k,j,i) = vfac*(2.0*rand_gen.frand() - 1.0);
+    w0(m,IVY,k,j,i) = vfac*(2.0*rand_gen.frand() - 1.0);
+    w0(m,IVZ,k,j,i) = vfac*(2.0*rand_gen.frand() - 1.0);
+    w0(m,IPR,k,j,i) = pgas0*(1.0 + rand_gen.frand());
+    for (int n = 0; n < nscal; ++n) {
+      w0(m,nmhd+n,k,j,i) = ye0*(1.0 + rand_gen.frand());
+    }
+    b0.x1f(m,k,j,i) = bmax*(2.0*rand_gen.frand() - 1.0);
+    b0.x2f(m,k,j,i) = bmax*(2.0*rand_gen.frand() - 1.0);
+    b0.x3f(m,k,j,i) = bmax*(2.0*rand_gen.frand() - 1.0);
+    if (i==n1-1) {b0.x1f(m,k,j,i+1) = b0.x1f(m,k,j,i);}
+    if (j==n2-1) {b0.x2f(m,k,j+1,i) = b0.x2f(m,k,j,i);}
+    if (k==n3-1) {b0.x3f(m,k+1,j,i) = b0.x3f(m,k,j,i);}
+    rand_pool64.free_state(rand_gen);  // free state for use by other threads
+  });
+  par_for("pgen_c2p_bench_bcc", DevExeSpace(), 0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    bcc0(m,IBX,k,j,i) = 0.5*(b0.x1f(m,k,j,i) + b0.x1f(m,k,j,i+1));
+    bcc0(m,IBY,k,j,i) = 0.5*(b0.x2f(m,k,j,i) + b0.x2f(m,k,j+1,i));
+    bcc0(m,IBZ,k,j,i) = 0.5*(b0.x3f(m,k,j,i) + b0.x3f(m,k+1,j,i));
+  });
+  pmbp->pdyngr->PrimToConInit(0, (n1-1), 0, (n2-1), 0, (n3-1));
+
+  // one untimed call to warm up caches, then nrep timed calls
+  pmbp->pdyngr->ConToPrimBC(is, ie, js, je, ks, ke);
+  Kokkos::fence();
+  Kokkos::Timer timer;
+  for (int r=0; r<nrep; ++r) {
+    pmbp->pdyngr->ConToPrimBC(is, ie, js, je, ks, ke);
+  }
+  Kokkos::fence();
+  Real t_c2p = timer.seconds();
+
+  if (global_variable::my_rank == 0) {
+    std::string eos_string = pin->GetString("mhd", "dyn_eos");
+    Real ncells = static_cast<Real>(nrep)*static_cast<Real>(pmbp->nmb_thispack)*
+                  indcs.nx1*indcs.nx2*indcs.nx3;
+    std::printf("c2p benchmark: dyn_eos=%s  %d calls  %.4e cells/s\n",
+                eos_string.c_str(), nrep, ncells/t_c2p);
+  }
+
+  // c2p of the ghost zones, so the problem can also be evolved
+  pmbp->pdyngr->ConToPrimBC(0, (n1-1), 0, (n2-1), 0, (n3-1));
+  return;
+}
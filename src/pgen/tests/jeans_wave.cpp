@@ -0,0 +1,306 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file jeans_wave.cpp
+//! \brief Problem generator for tests of self-gravity.  Sets up a travelling linear
+//! Jeans wave in a periodic box, with wavevector k = 2pi (1/Lx1, 1/Lx2, 1/Lx3) (only
+//! components in active directions), which propagates with
+//!   omega^2 = cs^2 k^2 - four_pi_G d0
+//! and so must have k larger than the Jeans wavenumber.  Run with nlim=0 it tests the
+//! Poisson solver alone.
+//! This file also contains a function to compute L1 errors in the fluid variables and
+//! the potential, called in Driver::Finalize().
+
+// C++ headers
+#include <cmath>      // sqrt()
+#include <cstdio>     // fopen(), fprintf(), freopen()
+#include <iostream>   // endl
+#include <string>     // c_str()
+
+// Athena++ headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "gravity/gravity.hpp"
+#include "pgen/pgen.hpp"
+
+// function to compute errors in solution at end of run
+void JeansWaveErrors(ParameterInput *pin, Mesh *pm);
+
+namespace {
+// global variable to control computation of initial conditions versus errors
+bool set_initial_conditions = true;
+
+//----------------------------------------------------------------------------------------
+//! \struct JeansWaveVariables
+//! \brief container for variables shared with error function
+
+struct JeansWaveVariables {
+  Real d0, p0, cs2, amp, k1, k2, k3, kmag, omega;
+};
+
+JeansWaveVariables jwv;
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::JeansWave()
+//! \brief Sets initial conditions for Jeans wave test.  Called again at the end of the
+//! run to store the exact solution in u1 (and return the exact potential).
+
+void ProblemGenerator::JeansWave(ParameterInput *pin, const bool restart) {
+  // set Jeans wave errors function
+  pgen_final_func = JeansWaveErrors;
+  if (restart) return;
+
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->phydro == nullptr || pmbp->pgrav == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Jeans wave problem requires <hydro> and <gravity> blocks" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // background state, with sound speed one for both ideal and isothermal EOS
+  EOS_Data &eos = pmbp->phydro->peos->eos_data;
+  jwv.d0 = 1.0;
+  jwv.amp = pin->GetOrAddReal("problem", "amp", 1.0e-6);
+  if (eos.is_ideal) {
+    jwv.p0 = 1.0/eos.gamma;
+    jwv.cs2 = eos.gamma*jwv.p0/jwv.d0;
+  } else {
+    jwv.p0 = 0.0;
+    jwv.cs2 = SQR(eos.iso_cs);
+  }
+
+  // exactly one wavelength along each active direction
+  auto &ms = pmy_mesh_->mesh_size;
+  jwv.k1 = 2.0*M_PI/(ms.x1max - ms.x1min);
+  jwv.k2 = (pmy_mesh_->multi_d)? 2.0*M_PI/(ms.x2max - ms.x2min) : 0.0;
+  jwv.k3 = (pmy_mesh_->three_d)? 2.0*M_PI/(ms.x3max - ms.x3min) : 0.0;
+  jwv.kmag = std::sqrt(SQR(jwv.k1) + SQR(jwv.k2) + SQR(jwv.k3));
+  Real omega2 = jwv.cs2*SQR(jwv.kmag) - (pmbp->pgrav->four_pi_gee)*jwv.d0;
+  if (omega2 <= 0.0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Jeans wave is unstable (omega^2 = " << omega2 << "), reduce "
+              << "<gravity>/four_pi_G" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  jwv.omega = std::sqrt(omega2);
+  if (global_variable::my_rank == 0 && set_initial_conditions) {
+    std::cout << "Jeans wave: k = " << jwv.kmag << ", omega = " << jwv.omega
+              << ", period = " << 2.0*M_PI/jwv.omega << std::endl;
+  }
+
+  // capture variables for kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  auto &size = pmbp->pmb->mb_size;
+  auto jw = jwv;
+  Real gm1 = eos.gamma - 1.0;
+  bool is_ideal = eos.is_ideal;
+  // phase at end of run when computing errors
+  Real wt = (set_initial_conditions)? 0.0 : jwv.omega*(pmy_mesh_->time);
+
+  // compute solution in u1 register. For initial conditions, set u1 -> u0.
+  auto &u1 = (set_initial_conditions)? pmbp->phydro->u0 : pmbp->phydro->u1;
+  par_for("pgen_jeans", DevExeSpace(),0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m,int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+    Real &x2min = size.d_view(m).x2min;
+    Real &x2max = size.d_view(m).x2max;
+    Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+    Real &x3min = size.d_view(m).x3min;
+    Real &x3max = size.d_view(m).x3max;
+    Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+
+    Real sn = std::sin(jw.k1*x1v + jw.k2*x2v + jw.k3*x3v - wt);
+    Real dens = jw.d0*(1.0 + jw.amp*sn);
+    Real vpar = (jw.omega/jw.kmag)*jw.amp*sn;
+    u1(m,IDN,k,j,i) = dens;
+    u1(m,IM1,k,j,i) = dens*vpar*jw.k1/jw.kmag;
+    u1(m,IM2,k,j,i) = dens*vpar*jw.k2/jw.kmag;
+    u1(m,IM3,k,j,i) = dens*vpar*jw.k3/jw.kmag;
+    if (is_ideal) {
+      Real pres = jw.p0 + jw.cs2*jw.d0*jw.amp*sn;
+      u1(m,IEN,k,j,i) = pres/gm1 + 0.5*dens*SQR(vpar);
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void JeansWaveErrors()
+//! \brief Computes L1 errors in the fluid variables by calling the problem generator
+//! again to compute the exact solution at the current time, and in the potential by
+//! solving the Poisson equation for the current density and comparing with the exact
+//! potential -four_pi_G d0 amp sin(k.x - omega t)/k^2 (up to a constant).  Errors are
+//! written to <basename>-errs.dat, with the potential in the last column.
+
+void JeansWaveErrors(ParameterInput *pin, Mesh *pm) {
+  // calculate reference solution by calling pgen again.  Solution stored in second
+  // register u1 when flag is false.
+  set_initial_conditions = false;
+  pm->pgen->JeansWave(pin, false);
+
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  gravity::Gravity *pgrav = pmbp->pgrav;
+  pgrav->SolvePoisson(nullptr, 0);
+
+  Real l1_err[8];
+  Real linfty_err=0.0;
+  int nvars = pmbp->phydro->nhydro;
+
+  // capture class variables for kernel
+  auto &indcs = pm->mb_indcs;
+  int &nx1 = indcs.nx1;
+  int &nx2 = indcs.nx2;
+  int &nx3 = indcs.nx3;
+  int &is = indcs.is;
+  int &js = indcs.js;
+  int &ks = indcs.ks;
+  auto &size = pmbp->pmb->mb_size;
+  auto &u0_ = pmbp->phydro->u0;
+  auto &u1_ = pmbp->phydro->u1;
+  auto &phi_ = pgrav->phi;
+  auto jw = jwv;
+  Real wt = jwv.omega*(pm->time);
+  Real phi_amp = -(pgrav->four_pi_gee)*jwv.d0*jwv.amp/SQR(jwv.kmag);
+
+  const int nmkji = (pmbp->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+
+  // the potential is only defined up to a constant, so first find the mean difference
+  Real phi_diff = 0.0;
+  Kokkos::parallel_reduce("JW-phi",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum) {
+    // compute m,k,j,i indices of thread
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real x1v = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real x2v = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real x3v = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    Real phi_ex = phi_amp*std::sin(jw.k1*x1v + jw.k2*x2v + jw.k3*x3v - wt);
+    sum += vol*(phi_(m,0,k,j,i) - phi_ex);
+  }, Kokkos::Sum<Real>(phi_diff));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &phi_diff, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  Real vol=  (pm->mesh_size.x1max - pm->mesh_size.x1min)
+            *(pm->mesh_size.x2max - pm->mesh_size.x2min)
+            *(pm->mesh_size.x3max - pm->mesh_size.x3min);
+  phi_diff /= vol;
+
+  array_sum::GlobalSum sum_this_mb;
+  Kokkos::parallel_reduce("JW-err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum, Real &max_err) {
+    // compute m,k,j,i indices of thread
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real x1v = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real x2v = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real x3v = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+
+    // conserved variables, and potential
+    array_sum::GlobalSum evars;
+    for (int n=0; n<nvars; ++n) {
+      evars.the_array[n] = vol*fabs(u0_(m,n,k,j,i) - u1_(m,n,k,j,i));
+      max_err = fmax(max_err, evars.the_array[n]);
+    }
+    Real phi_ex = phi_amp*std::sin(jw.k1*x1v + jw.k2*x2v + jw.k3*x3v - wt);
+    evars.the_array[nvars] = vol*fabs(phi_(m,0,k,j,i) - phi_ex - phi_diff);
+
+    // fill rest of the_array with zeros, if narray < NREDUCTION_VARIABLES
+    for (int n=nvars+1; n<NREDUCTION_VARIABLES; ++n) {
+      evars.the_array[n] = 0.0;
+    }
+
+    // sum into parallel reduce
+    mb_sum += evars;
+  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_mb), Kokkos::Max<Real>(linfty_err));
+
+  // store data into l1_err array
+  for (int n=0; n<=nvars; ++n) {
+    l1_err[n] = sum_this_mb.the_array[n];
+  }
+
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &l1_err, nvars+1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &linfty_err, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+  // normalize errors by volume of domain
+  for (int i=0; i<=nvars; ++i) l1_err[i] = l1_err[i]/vol;
+  linfty_err /= vol;
+
+  // compute rms error of fluid variables
+  Real rms_err = 0.0;
+  for (int i=0; i<nvars; ++i) {
+    rms_err += SQR(l1_err[i]);
+  }
+  rms_err = std::sqrt(rms_err);
+
+  // root process opens output file and writes out errors
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(pin->GetString("job","basename"));
+    fname.append("-errs.dat");
+    FILE *pfile;
+
+    // The file exists -- reopen the file in append mode
+    if ((pfile = std::fopen(fname.c_str(), "r")) != nullptr) {
+      if ((pfile = std::freopen(fname.c_str(), "a", pfile)) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+
+    // The file does not exist -- open the file in write mode and add headers
+    } else {
+      if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::fprintf(pfile, "# Nx1  Nx2  Nx3   Ncycle  RMS-L1    L-infty       ");
+      std::fprintf(pfile,"d_L1         M1_L1         M2_L1         M3_L1");
+      if (nvars > 4) {
+        std::fprintf(pfile,"         E_L1");
+      }
+      std::fprintf(pfile,"          Phi_L1\n");
+    }
+
+    // write errors
+    std::fprintf(pfile, "%04d", pm->mesh_indcs.nx1);
+    std::fprintf(pfile, "  %04d", pm->mesh_indcs.nx2);
+    std::fprintf(pfile, "  %04d", pm->mesh_indcs.nx3);
+    std::fprintf(pfile, "  %05d  %e %e", pm->ncycle, rms_err, linfty_err);
+    for (int i=0; i<=nvars; ++i) {
+      std::fprintf(pfile, "  %e", l1_err[i]);
+    }
+    std::fprintf(pfile, "\n");
+    std::fclose(pfile);
+  }
+
+  return;
+}
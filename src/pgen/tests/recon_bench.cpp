@@ -0,0 +1,190 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file recon_bench.cpp
+//! \brief Problem generator that benchmarks the reconstruction functions.  Initializes
+//! the hydro primitives with random values, then times nrep sweeps of reconstruction in
+//! the x1-direction over every MeshBlock in the pack, once with scalar inner loops over
+//! PLM(), PPM4() and WENOZ() and once with the wrapper functions used by the flux
+//! kernels (which call the SIMD versions in builds with Athena_ENABLE_SIMD_RECON=ON).
+//! The throughput of each, and the maximum difference in the L/R states they compute, is
+//! printed to stdout on rank 0.  Should be run with time/nlim=0 and nghost>=3.
+
+#include <Kokkos_Random.hpp>
+
+#include <cstdio>     // printf()
+#include <iostream>   // endl
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "reconstruct/plm.hpp"
+#include "reconstruct/ppm.hpp"
+#include "reconstruct/wenoz.hpp"
+#include "pgen/pgen.hpp"
+
+namespace {
+
+enum class BenchMethod {plm, ppm4, wenoz};
+
+//----------------------------------------------------------------------------------------
+//! \fn Real TimeRecon()
+//! \brief returns wall-clock time for nrep sweeps of reconstruction in x1 using method,
+//! either with scalar inner loops or with the wrapper functions.  The sum of the L/R
+//! states at each face is stored in out so that the two can be compared.
+
+template <BenchMethod method, bool scalar>
+Real TimeRecon(MeshBlockPack *pmbp, const int nrep, DvceArray5D<Real> out) {
+  auto &indcs = pmbp->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int nmb1 = pmbp->nmb_thispack - 1;
+  int nvar = pmbp->phydro->nhydro + pmbp->phydro->nscalars;
+  int il = is-1, iu = ie+1;
+  auto &w0_ = pmbp->phydro->w0;
+  auto &eos_ = pmbp->phydro->peos->eos_data;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvar, ncells1) * 2;
+  int scr_level = 0;
+
+  Kokkos::fence();
+  Kokkos::Timer timer;
+  for (int r=0; r<nrep; ++r) {
+    par_for_outer("recon_bench", DevExeSpace(), scr_size, scr_level, 0, nmb1, ks, ke,
+                  js, je,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray2D<Real> ql(member.team_scratch(scr_level), nvar, ncells1);
+      ScrArray2D<Real> qr(member.team_scratch(scr_level), nvar, ncells1);
+      // Capture variables prior to if constexpr.
+      auto w = w0_;
+      auto eos = eos_;
+      if constexpr (scalar) {
+        for (int n=0; n<nvar; ++n) {
+          par_for_inner(member, il, iu, [&](const int i) {
+            if constexpr (method == BenchMethod::plm) {
+              PLM(w(m,n,k,j,i-1), w(m,n,k,j,i), w(m,n,k,j,i+1), ql(n,i+1), qr(n,i));
+            } else if constexpr (method == BenchMethod::ppm4) {
+              PPM4(w(m,n,k,j,i-2), w(m,n,k,j,i-1), w(m,n,k,j,i), w(m,n,k,j,i+1),
+                   w(m,n,k,j,i+2), ql(n,i+1), qr(n,i));
+            } else {
+              WENOZ(w(m,n,k,j,i-2), w(m,n,k,j,i-1), w(m,n,k,j,i), w(m,n,k,j,i+1),
+                    w(m,n,k,j,i+2), ql(n,i+1), qr(n,i));
+            }
+          });
+        }
+      } else {
+        if constexpr (method == BenchMethod::plm) {
+          PiecewiseLinearX1(member, m, k, j, il, iu, w, ql, qr);
+        } else if constexpr (method == BenchMethod::ppm4) {
+          PiecewiseParabolicX1(member, eos, false, false, m, k, j, il, iu, w, ql, qr);
+        } else {
+          WENOZX1(member, eos, false, m, k, j, il, iu, w, ql, qr);
+        }
+      }
+      member.team_barrier();
+
+      for (int n=0; n<nvar; ++n) {
+        par_for_inner(member, is, ie+1, [&](const int i) {
+          out(m,n,k,j,i) = ql(n,i) + qr(n,i);
+        });
+      }
+    });
+  }
+  Kokkos::fence();
+  return timer.seconds();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RunBenchmark()
+//! \brief times scalar and wrapper versions of one reconstruction method and prints
+//! results
+
+template <BenchMethod method>
+void RunBenchmark(MeshBlockPack *pmbp, const int nrep, const char *name) {
+  auto &indcs = pmbp->pmesh->mb_indcs;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nvar = pmbp->phydro->nhydro + pmbp->phydro->nscalars;
+  DvceArray5D<Real> out_s("out_s", pmbp->nmb_thispack, nvar, ncells3, ncells2, ncells1);
+  DvceArray5D<Real> out_w("out_w", pmbp->nmb_thispack, nvar, ncells3, ncells2, ncells1);
+
+  // one untimed sweep of each to warm up caches
+  TimeRecon<method, true>(pmbp, 1, out_s);
+  TimeRecon<method, false>(pmbp, 1, out_w);
+  Real t_s = TimeRecon<method, true>(pmbp, nrep, out_s);
+  Real t_w = TimeRecon<method, false>(pmbp, nrep, out_w);
+
+  Real maxdiff = 0.0;
+  const Real *ps = out_s.data(), *pw = out_w.data();
+  Kokkos::parallel_reduce("recon_bench_diff",
+  Kokkos::RangePolicy<>(DevExeSpace(), 0, static_cast<int>(out_s.size())),
+  KOKKOS_LAMBDA(const int idx, Real &dmax) {
+    dmax = fmax(dmax, fabs(ps[idx] - pw[idx]));
+  }, Kokkos::Max<Real>(maxdiff));
+
+  if (global_variable::my_rank == 0) {
+    Real ncells = static_cast<Real>(nrep)*static_cast<Real>(pmbp->nmb_thispack)*
+                  static_cast<Real>(nvar)*indcs.nx1*indcs.nx2*indcs.nx3;
+    std::printf("%-6s scalar: %.4e cells/s  wrapper: %.4e cells/s  speedup: %.3f  "
+                "max_diff: %.3e\n", name, ncells/t_s, ncells/t_w, t_s/t_w, maxdiff);
+  }
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::ReconBenchmark()
+//! \brief Problem Generator for benchmarking reconstruction
+
+void ProblemGenerator::ReconBenchmark(ParameterInput *pin, const bool restart) {
+  if (restart) return;
+
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->phydro == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Reconstruction benchmark requires <hydro> block in input file"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  auto &indcs = pmy_mesh_->mb_indcs;
+  if (indcs.ng < 3) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Reconstruction benchmark requires nghost >= 3" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  int nrep = pin->GetOrAddInteger("problem", "nrep", 10);
+
+  // initialize primitives (including ghost zones) with random values in [0.5,1.5], so
+  // that all branches of the limiters are exercised
+  auto &w0 = pmbp->phydro->w0;
+  Kokkos::Random_XorShift64_Pool<> rand_pool64(pmbp->gids);
+  par_for("pgen_recon_bench", DevExeSpace(), 0, (pmbp->nmb_thispack-1),
+          0, (w0.extent_int(1)-1), 0, (w0.extent_int(2)-1), 0, (w0.extent_int(3)-1),
+          0, (w0.extent_int(4)-1),
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    auto rand_gen = rand_pool64.get_state();  // get random number state this thread
+    w0(m,n,k,j,i) = 0.5 + rand_gen.frand();
+    rand_pool64.free_state(rand_gen);  // free state for use by other threads
+  });
+
+  if (global_variable::my_rank == 0) {
+    std::cout << "Reconstruction benchmark: " << nrep << " sweeps in x1, SIMD "
+              << ((SIMD_RECON_ENABLED)? "enabled" : "disabled") << std::endl;
+  }
+  RunBenchmark<BenchMethod::plm>(pmbp, nrep, "plm");
+  RunBenchmark<BenchMethod::ppm4>(pmbp, nrep, "ppm4");
+  RunBenchmark<BenchMethod::wenoz>(pmbp, nrep, "wenoz");
+
+  // set conserved variables so the problem can also be evolved
+  auto &u0 = pmbp->phydro->u0;
+  pmbp->phydro->peos->PrimToCons(w0, u0, indcs.is, indcs.ie, indcs.js, indcs.je,
+                                 indcs.ks, indcs.ke);
+  return;
+}
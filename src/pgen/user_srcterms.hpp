@@ -0,0 +1,65 @@
+#ifndef PGEN_USER_SRCTERMS_HPP_
+#define PGEN_USER_SRCTERMS_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file user_srcterms.hpp
+//! \brief Registration of user source terms as device-callable per-cell functors.  Each
+//! functor must be copyable to the device and provide
+//!
+//!   KOKKOS_INLINE_FUNCTION
+//!   void operator()(const int m, const int k, const int j, const int i,
+//!                   const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
+//!                   const Real bdt, const DvceArray5D<Real> &u0) const;
+//!
+//! which adds the source term over (weighted) timestep bdt to the conserved variables u0
+//! in cell (m,k,j,i), computed from primitives w0 (and cell-centered fields bcc0 in MHD;
+//! bcc0 is an empty View in Hydro).  All functors enrolled by a problem generator with
+//! ProblemGenerator::EnrollUserSrcTerms() are inlined into a single kernel over the
+//! active cells of the MeshBlockPack, launched from the Hydro/MHD source term task.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "pgen/pgen.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void LaunchUserSrcTerms()
+//! \brief Applies the user functors fs to every active cell of the MeshBlockPack in one
+//! kernel, in the order they were enrolled.
+
+template <typename... Fs>
+void LaunchUserSrcTerms(MeshBlockPack *pmbp, const DvceArray5D<Real> &w0,
+                        const DvceArray5D<Real> &bcc0, const Real bdt,
+                        const DvceArray5D<Real> &u0, const Fs&... fs) {
+  auto &indcs = pmbp->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmbp->nmb_thispack - 1;
+  auto w0_ = w0;
+  auto bcc0_ = bcc0;
+  auto u0_ = u0;
+
+  par_for("user_srcs", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    (fs(m, k, j, i, w0_, bcc0_, bdt, u0_), ...);
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::EnrollUserSrcTerms()
+//! \brief Enrolls the per-cell functors fs as user source terms, replacing any functors
+//! enrolled previously.  The functors are copied, so any Views they hold are shared.
+
+template <typename... Fs>
+void ProblemGenerator::EnrollUserSrcTerms(const Fs&... fs) {
+  user_srcs_kernel = [fs...](MeshBlockPack *pmbp, const DvceArray5D<Real> &w0,
+                             const DvceArray5D<Real> &bcc0, const Real bdt,
+                             DvceArray5D<Real> &u0) {
+    LaunchUserSrcTerms(pmbp, w0, bcc0, bdt, u0, fs...);
+  };
+}
+
+#endif // PGEN_USER_SRCTERMS_HPP_
@@ -29,9 +29,11 @@ namespace radiation {
 Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     pmy_pack(ppack),
     i0("i0",1,1,1,1,1),
+    i0_ang("i0_ang",1,1,1,1,1),
     i1("i1",1,1,1,1,1),
     iflx("iflx",1,1,1,1,1),
     divfa("divfa",1,1,1,1,1),
+    inew("inew",1,1,1,1,1),
     nh_c("nh_c",1,1),
     nh_f("nh_f",1,1,1),
     tet_c("tet_c",1,1,1,1,1,1),
@@ -40,6 +42,8 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     tet_d2_x2f("tet_d2_x2f",1,1,1,1,1),
     tet_d3_x3f("tet_d3_x3f",1,1,1,1,1),
     na("na",1,1,1,1,1,1),
+    tet_omega("tet_omega",1,1,1,1,1),
+    op_cache("op_cache",1,1,1,1,1),
     ross_rho("ross_rho",1),
     ross_t("ross_t",1),
     planck_rho("planck_rho",1),
@@ -99,6 +103,12 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
         << std::endl << "Compton requires enabling units" << std::endl;
       std::exit(EXIT_FAILURE);
     }
+    compton_equil_tol = pin->GetOrAddReal("radiation","compton_equil_tol",0.0);
+    // count cells with failed or skipped updates in event log
+    use_source_counters = pin->GetOrAddBoolean("radiation","source_counters",false);
+    if (use_source_counters) {
+      ppack->pmesh->ecounter.rad_counters_used = true;
+    }
     if (are_units_enabled) {
       arad = (pmy_pack->punit->rad_constant_cgs*
               SQR(SQR(pmy_pack->punit->temperature_cgs()))/
@@ -121,7 +131,14 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   rotate_geo = pin->GetOrAddBoolean("radiation","rotate_geo",true);
   angular_fluxes = pin->GetOrAddBoolean("radiation","angular_fluxes",true);
   n_0_floor = pin->GetOrAddReal("radiation","n_0_floor",0.1);
-  prgeo = new GeodesicGrid(nlevel, rotate_geo, angular_fluxes);
+  // store 40 rotation coefficients per cell rather than n^a for every angle and edge
+  compact_tetrad = pin->GetOrAddBoolean("radiation","compact_tetrad",false);
+  // optionally read the angular mesh from (or save it to) a cache file, see GeodesicGrid
+  std::string geo_cache_dir;
+  if (pin->GetOrAddBoolean("radiation","geo_cache",false)) {
+    geo_cache_dir = pin->GetOrAddString("radiation","geo_cache_dir",".");
+  }
+  prgeo = new GeodesicGrid(nlevel, rotate_geo, angular_fluxes, geo_cache_dir);
 
   int nmb = ppack->nmb_thispack;
   auto &indcs = pmy_pack->pmesh->mb_indcs;
@@ -136,7 +153,13 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   Kokkos::realloc(tet_d1_x1f,nmb,4,ncells3,ncells2,ncells1+1);
   Kokkos::realloc(tet_d2_x2f,nmb,4,ncells3,ncells2+1,ncells1);
   Kokkos::realloc(tet_d3_x3f,nmb,4,ncells3+1,ncells2,ncells1);
-  if (angular_fluxes) {Kokkos::realloc(na,nmb,prgeo->nangles,ncells3,ncells2,ncells1,6);}
+  if (angular_fluxes) {
+    if (compact_tetrad) {
+      Kokkos::realloc(tet_omega,nmb,40,ncells3,ncells2,ncells1);
+    } else {
+      Kokkos::realloc(na,nmb,prgeo->nangles,ncells3,ncells2,ncells1,6);
+    }
+  }
   if (is_hydro_enabled || is_mhd_enabled) {
     Kokkos::realloc(norm_to_tet,nmb,4,4,ncells3,ncells2,ncells1);
   }
@@ -155,6 +178,17 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   Kokkos::realloc(i0,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
   }
 
+  // Intensities are transposed so angles are contiguous in the source term, which loops
+  // over all angles in each cell.  Useful on CPUs; on GPUs the default layout, in which
+  // neighboring threads access neighboring cells, is generally faster.
+  angle_innermost = false;
+  if (rad_source) {
+    angle_innermost = pin->GetOrAddBoolean("radiation","angle_innermost",false);
+  }
+  if (angle_innermost) {
+    Kokkos::realloc(i0_ang,nmb,indcs.nx3,indcs.nx2,indcs.nx1,prgeo->nangles);
+  }
+
   // allocate memory for conserved variables on coarse mesh
   if (ppack->pmesh->multilevel) {
     auto &indcs = pmy_pack->pmesh->mb_indcs;
@@ -167,6 +201,7 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   // allocate boundary buffers for conserved (cell-centered) variables
   pbval_i = new MeshBoundaryValuesCC(ppack, pin, false);
   pbval_i->InitializeBuffers(prgeo->nangles);
+  pbval_i->SetHaloPrecision(pin, "radiation");
 
   // for time-evolving problems, continue to construct methods, allocate arrays
   if (evolution_t.compare("stationary") != 0) {
@@ -206,10 +241,18 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
     int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
     Kokkos::realloc(i1,      nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x1f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x2f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x3f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    if (angular_fluxes) {
+    // with fused update, fluxes are only needed on MeshBlock surfaces for flux correction
+    // with SMR/AMR, and the angular flux divergence is never stored
+    use_fused = pin->GetOrAddBoolean("radiation","fused",false);
+    if (use_fused) {
+      Kokkos::realloc(inew,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+    }
+    if (!(use_fused) || ppack->pmesh->multilevel) {
+      Kokkos::realloc(iflx.x1f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+      Kokkos::realloc(iflx.x2f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+      Kokkos::realloc(iflx.x3f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+    }
+    if (angular_fluxes && !(use_fused)) {
       Kokkos::realloc(divfa,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
     }
     if (beam_source) {
@@ -247,10 +290,49 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
       Kokkos::realloc(planck_table, planck_table_len_y,planck_table_len_x);
 
     }
+
+    // optional cache of opacities in each cell, disabled by default
+    op_cache_tol = pin->GetOrAddReal("radiation","opacity_cache_tol",0.0);
+    if (op_cache_tol > 0.0) {
+      int ncells1 = indcs.nx1 + 2*(indcs.ng);
+      int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+      int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+      Kokkos::realloc(op_cache,nmb,6,ncells3,ncells2,ncells1);
+    }
   }
 
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::PrepareOpacityTable()
+//! \brief Checks whether the (log) values along each axis of the opacity tables are
+//! uniformly spaced, in which case table locations are computed in O(1) in
+//! TableOpacity().  Tables are loaded by the problem generator after the Radiation
+//! constructor, so this is called on the first call to AddRadiationSourceTerm().
+
+void Radiation::PrepareOpacityTable() {
+  auto set_axis = [](const DualArray1D<Real> &arr, TableAxis &axis) {
+    int n = arr.extent_int(0);
+    axis.uniform = false;
+    if (n < 2) return;
+    Real x0 = arr.h_view(0);
+    Real dx = (arr.h_view(n-1) - x0)/static_cast<Real>(n-1);
+    if (!(dx > 0.0)) return;
+    for (int i=1; i<n; ++i) {
+      if (fabs(arr.h_view(i) - (x0 + i*dx)) > 1.0e-6*dx) return;
+    }
+    axis.uniform = true;
+    axis.x0 = x0;
+    axis.inv_dx = 1.0/dx;
+  };
+  set_axis(ross_rho, op_axes.ross_rho);
+  set_axis(ross_t, op_axes.ross_t);
+  set_axis(planck_rho, op_axes.planck_rho);
+  set_axis(planck_t, op_axes.planck_t);
+  op_table_prepared = true;
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 // destructor
 
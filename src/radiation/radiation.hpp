@@ -16,6 +16,7 @@
 #include "parameter_input.hpp"
 #include "tasklist/task_list.hpp"
 #include "bvals/bvals.hpp"
+#include "radiation_opacities.hpp"
 
 // forward declarations
 class EquationOfState;
@@ -103,6 +104,8 @@ class Radiation {
   bool table_opacity;       // flag to use opacity table or not
   bool op_table_use_r;       // flag to use t and R for the opacity table
   bool is_compton_enabled;  // flag to enable/disable compton
+  Real compton_equil_tol = 0.0;  // skip Compton update if |T_rad-T_gas| < tol*T_gas
+  bool use_source_counters = false;  // count failed/skipped cells in source term
 
 
   int ross_table_len_x; //length of rossleand mean table: No. of cols
@@ -129,12 +132,18 @@ class Radiation {
   DvceArray5D<Real> tet_d2_x2f;       // tetrad components (subset) at x2f
   DvceArray5D<Real> tet_d3_x3f;       // tetrad components (subset) at x3f
   DvceArray6D<Real> na;               // n^a
+  bool compact_tetrad;                // compute n^a on the fly from tet_omega
+  DvceArray5D<Real> tet_omega;        // rotation coefficients (subset) at cell centers
   DvceArray6D<Real> norm_to_tet;      // used in transform b/w normal frame and tet frame
   void SetOrthonormalTetrad();
 
   // intensity arrays
   DvceArray5D<Real> i0;         // intensities
   DvceArray5D<Real> coarse_i0;  // intensities on 2x coarser grid (for SMR/AMR)
+  // copy of intensities in active cells with angle index fastest, i.e. (m,k,j,i,n), used
+  // by the source term with <radiation>/angle_innermost=true
+  bool angle_innermost;
+  DvceArray5D<Real> i0_ang;
 
   // array to host opacity table
   DualArray1D<Real> ross_rho;
@@ -143,6 +152,14 @@ class Radiation {
   DualArray1D<Real> planck_t;
   DualArray2D<Real> ross_table;
   DualArray2D<Real> planck_table;
+  OpacityTableAxes op_axes;       // spacing of table axes, set on first use of tables
+  bool op_table_prepared = false;
+  void PrepareOpacityTable();
+  // per-cell cache of table opacities (density, temperature, and kappa_a, kappa_s,
+  // kappa_p, kappa_pe per unit density), reused while density and temperature change
+  // by less than op_cache_tol
+  Real op_cache_tol;
+  DvceArray5D<Real> op_cache;
 
   // Boundary communication buffers and functions for i
   MeshBoundaryValuesCC *pbval_i;
@@ -152,6 +169,9 @@ class Radiation {
   DvceFaceFld5D<Real> iflx;     // spatial fluxes on zone faces
   DvceArray5D<Real> divfa;      // angular flux divergence
   DvceArray5D<bool> beam_mask;  // boolean mask used for beam source term
+  // fused flux + update kernel (iflx only stored on MeshBlock surfaces with SMR/AMR)
+  bool use_fused = false;
+  DvceArray5D<Real> inew;       // updated intensities, swapped with i0 after fused update
   Real dtnew;
 
   // reconstruction method
@@ -170,7 +190,12 @@ class Radiation {
   TaskStatus SendFlux(Driver *d, int stage);
   TaskStatus RecvFlux(Driver *d, int stage);
   TaskStatus RKUpdate(Driver *d, int stage);
+  void SurfaceFluxes();                    // used with fused update
+  void FusedUpdate(Driver *d, int stage);  // fused fluxes and RK update
   TaskStatus AddRadiationSourceTerm(Driver *d, int stage);
+  // implicit source term kernel, templated on accessor for intensities in each layout
+  template <typename IntensityArray>
+  void ImplicitSourceTerm(const IntensityArray &i0_, const Real dt_);
   TaskStatus RestrictI(Driver *d, int stage);
   TaskStatus SendI(Driver *d, int stage);
   TaskStatus RecvI(Driver *d, int stage);
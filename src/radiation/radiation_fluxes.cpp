@@ -14,6 +14,7 @@
 #include "eos/eos.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "radiation.hpp"
+#include "radiation_tetrad.hpp"
 #include "reconstruct/dc.hpp"
 #include "reconstruct/plm.hpp"
 #include "reconstruct/ppm.hpp"
@@ -25,6 +26,12 @@ namespace radiation {
 //! \brief Compute radiation fluxes
 
 TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
+  // with fused update, fluxes are computed in RKUpdate(), except on MeshBlock surfaces
+  if (use_fused) {
+    if (pmy_pack->pmesh->multilevel) {SurfaceFluxes();}
+    return TaskStatus::complete;
+  }
+
   RegionIndcs &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &ie = indcs.ie;
   int &js = indcs.js, &je = indcs.je;
@@ -218,15 +225,20 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
 
     auto &na_ = na;
     auto &divfa_ = divfa;
+    bool &compact = compact_tetrad;
+    auto &tet_omega_ = tet_omega;
+    auto &nh_f_ = nh_f;
+    auto &uflux = prgeo->unit_flux;
 
     par_for("rflux_angular",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie,
     KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
       divfa_(m,n,k,j,i) = 0.0;
       for (int nb=0; nb<numn.d_view(n); ++nb) {
-        Real flx_edge = na_(m,n,k,j,i,nb) *
-                        ((na_(m,n,k,j,i,nb) < 0.0) ?
-                         i0_(m,indn.d_view(n,nb),k,j,i)/tet_c_(m,0,0,k,j,i) :
-                         i0_(m,n,k,j,i)/tet_c_(m,0,0,k,j,i));
+        Real na_nb = (compact)? CompactNA(tet_omega_, nh_f_, uflux, m, n, nb, k, j, i) :
+                                na_(m,n,k,j,i,nb);
+        Real flx_edge = na_nb * ((na_nb < 0.0) ?
+                                 i0_(m,indn.d_view(n,nb),k,j,i)/tet_c_(m,0,0,k,j,i) :
+                                 i0_(m,n,k,j,i)/tet_c_(m,0,0,k,j,i));
         divfa_(m,n,k,j,i) += (arcl.d_view(n,nb)*flx_edge/solid_angles_.d_view(n));
       }
     });
@@ -0,0 +1,268 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file radiation_fused.cpp
+//! \brief Fused stage update for Radiation: spatial and angular fluxes, flux divergence
+//! and explicit RK update performed in a single kernel.  Used with
+//! <radiation>/fused=true in place of CalculateFluxes()+RKUpdate(), so that the face
+//! fluxes iflx and angular flux divergence divfa (each as large as the intensities) are
+//! never stored.  Each team updates one (m,n,k,j) pencil: x1-fluxes for the pencil are
+//! kept in team scratch, while x2- and x3-fluxes are computed by each of the two cells
+//! sharing the face (the price paid for not storing them).
+//!
+//! Since the fluxes are computed from i0, the updated intensities are written to a
+//! second array which is then swapped with i0.  With SMR/AMR only the fluxes on the
+//! surfaces of each MeshBlock are stored in iflx by SurfaceFluxes(), so that they can be
+//! corrected at fine/coarse boundaries by SendFlux()/RecvFlux() before the update.
+
+#include <utility>    // swap()
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "coordinates/coordinates.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+#include "radiation.hpp"
+#include "radiation_tetrad.hpp"
+#include "reconstruct/dc.hpp"
+#include "reconstruct/plm.hpp"
+#include "reconstruct/ppm.hpp"
+#include "reconstruct/wenoz.hpp"
+
+namespace radiation {
+//----------------------------------------------------------------------------------------
+//! \fn Real FaceFlux
+//! \brief Returns upwinded flux of angle n through the face at (k,j,i) with normal in the
+//! direction of the unit offset (dk,dj,di), where tfc holds the tetrad components on
+//! those faces.  Same reconstruction as used in the kernels in CalculateFluxes().
+
+KOKKOS_INLINE_FUNCTION
+Real FaceFlux(const ReconstructionMethod recon_method, const DvceArray5D<Real> &i0,
+              const DvceArray6D<Real> &tet_c, const DvceArray5D<Real> &tfc,
+              const DualArray2D<Real> &nh_c, const int m, const int n, const int k,
+              const int j, const int i, const int dk, const int dj, const int di) {
+  // calculate n^d (hence determining upwinding direction)
+  Real nd = tfc(m,0,k,j,i)*nh_c.d_view(n,0) + tfc(m,1,k,j,i)*nh_c.d_view(n,1)
+          + tfc(m,2,k,j,i)*nh_c.d_view(n,2) + tfc(m,3,k,j,i)*nh_c.d_view(n,3);
+
+  // convert to primitive n_0 I, at offset s cells from (k,j,i)
+  auto prim = [&](const int s) {
+    return i0(m,n,k+s*dk,j+s*dj,i+s*di)/tet_c(m,0,0,k+s*dk,j+s*dj,i+s*di);
+  };
+  Real iim1, iicc, iim2, iip1, iim3, iip2;
+  iim1 = prim(-1);
+  iicc = prim(0);
+  if (recon_method > 0) {
+    iim2 = prim(-2);
+    iip1 = prim(1);
+  }
+  if (recon_method > 1) {
+    iim3 = prim(-3);
+    iip2 = prim(2);
+  }
+
+  // reconstruct primitive intensity
+  Real iiu, scr;
+  switch (recon_method) {
+    case ReconstructionMethod::dc:
+      if (nd > 0.0) iiu = iim1;
+      else          iiu = iicc;
+      break;
+    case ReconstructionMethod::plm:
+      if (nd > 0.0) PLM(iim2, iim1, iicc, iiu, scr);
+      else          PLM(iim1, iicc, iip1, scr, iiu);
+      break;
+    case ReconstructionMethod::ppm4:
+      if (nd > 0.0) PPM4(iim3, iim2, iim1, iicc, iip1, iiu, scr);
+      else          PPM4(iim2, iim1, iicc, iip1, iip2, scr, iiu);
+      break;
+    case ReconstructionMethod::ppmx:
+      if (nd > 0.0) PPMX(iim3, iim2, iim1, iicc, iip1, iiu, scr);
+      else          PPMX(iim2, iim1, iicc, iip1, iip2, scr, iiu);
+      break;
+    case ReconstructionMethod::wenoz:
+      if (nd > 0.0) WENOZ(iim3, iim2, iim1, iicc, iip1, iiu, scr);
+      else          WENOZ(iim2, iim1, iicc, iip1, iip2, scr, iiu);
+      break;
+    default:
+      break;
+  }
+  return nd*iiu;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::SurfaceFluxes
+//! \brief Stores fluxes on the faces at the surface of each MeshBlock in iflx.  Used by
+//! the fused update with SMR/AMR so that fluxes can be corrected at fine/coarse
+//! boundaries.  Fluxes in the interior of MeshBlocks are not computed.
+
+void Radiation::SurfaceFluxes() {
+  RegionIndcs &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nang1 = prgeo->nangles - 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+
+  const auto recon_ = recon_method;
+  auto &i0_ = i0;
+  auto &nh_c_ = nh_c;
+  auto &tet_c_ = tet_c;
+
+  auto &t1d1 = tet_d1_x1f;
+  auto &flx1 = iflx.x1f;
+  par_for("rflux_x1_surf",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,0,1,
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int f) {
+    int i = (f == 0)? is : ie+1;
+    flx1(m,n,k,j,i) = FaceFlux(recon_, i0_, tet_c_, t1d1, nh_c_, m, n, k, j, i, 0, 0, 1);
+  });
+
+  if (pmy_pack->pmesh->multi_d) {
+    auto &t2d2 = tet_d2_x2f;
+    auto &flx2 = iflx.x2f;
+    par_for("rflux_x2_surf",DevExeSpace(),0,nmb1,0,nang1,ks,ke,0,1,is,ie,
+    KOKKOS_LAMBDA(int m, int n, int k, int f, int i) {
+      int j = (f == 0)? js : je+1;
+      flx2(m,n,k,j,i) = FaceFlux(recon_, i0_, tet_c_, t2d2, nh_c_, m, n, k, j, i, 0,1,0);
+    });
+  }
+
+  if (pmy_pack->pmesh->three_d) {
+    auto &t3d3 = tet_d3_x3f;
+    auto &flx3 = iflx.x3f;
+    par_for("rflux_x3_surf",DevExeSpace(),0,nmb1,0,nang1,0,1,js,je,is,ie,
+    KOKKOS_LAMBDA(int m, int n, int f, int j, int i) {
+      int k = (f == 0)? ks : ke+1;
+      flx3(m,n,k,j,i) = FaceFlux(recon_, i0_, tet_c_, t3d3, nh_c_, m, n, k, j, i, 1,0,0);
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::FusedUpdate
+//! \brief Explicit RK update of i0 with spatial and angular flux divergence computed in
+//! the same kernel as the fluxes.  Fluxes are differenced and added in the same order as
+//! in CalculateFluxes()+RKUpdate(), so results are identical.
+
+void Radiation::FusedUpdate(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int nang1 = prgeo->nangles - 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+
+  auto &mbsize  = pmy_pack->pmb->mb_size;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  bool &multilevel = pmy_pack->pmesh->multilevel;
+
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+
+  const auto recon_ = recon_method;
+  auto &i0_ = i0;
+  auto &i1_ = i1;
+  auto &inew_ = inew;
+  auto &flx1 = iflx.x1f;
+  auto &flx2 = iflx.x2f;
+  auto &flx3 = iflx.x3f;
+
+  auto &nh_c_ = nh_c;
+  auto &tt = tet_c;
+  auto &tc = tetcov_c;
+  auto &t1d1 = tet_d1_x1f;
+  auto &t2d2 = tet_d2_x2f;
+  auto &t3d3 = tet_d3_x3f;
+
+  auto &angular_fluxes_ = angular_fluxes;
+  auto &numn = prgeo->num_neighbors;
+  auto &indn = prgeo->ind_neighbors;
+  auto &arcl = prgeo->arc_lengths;
+  auto &solid_angles_ = prgeo->solid_angles;
+  auto &na_ = na;
+  bool &compact = compact_tetrad;
+  auto &tet_omega_ = tet_omega;
+  auto &nh_f_ = nh_f;
+  auto &uflux = prgeo->unit_flux;
+
+  auto &excise = pmy_pack->pcoord->coord_data.bh_excise;
+  auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
+  Real &n_0_floor_ = n_0_floor;
+
+  size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1);
+  int scr_level = 0;
+
+  par_for_outer("r_fused",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nang1,ks,ke,js,je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k, const int j) {
+    ScrArray1D<Real> fx1(member.team_scratch(scr_level), ncells1);
+
+    // x1-fluxes over [is,ie+1].  With SMR/AMR, use (corrected) fluxes stored on surfaces
+    par_for_inner(member, is, ie+1, [&](const int i) {
+      if (multilevel && (i == is || i == ie+1)) {
+        fx1(i) = flx1(m,n,k,j,i);
+      } else {
+        fx1(i) = FaceFlux(recon_, i0_, tt, t1d1, nh_c_, m, n, k, j, i, 0, 0, 1);
+      }
+    });
+    member.team_barrier();
+
+    par_for_inner(member, is, ie, [&](const int i) {
+      // spatial fluxes
+      Real divf_s = (fx1(i+1) - fx1(i))/mbsize.d_view(m).dx1;
+      if (multi_d) {
+        Real flo = (multilevel && j == js)? flx2(m,n,k,j,i) :
+                   FaceFlux(recon_, i0_, tt, t2d2, nh_c_, m, n, k, j, i, 0, 1, 0);
+        Real fhi = (multilevel && j == je)? flx2(m,n,k,j+1,i) :
+                   FaceFlux(recon_, i0_, tt, t2d2, nh_c_, m, n, k, j+1, i, 0, 1, 0);
+        divf_s += (fhi - flo)/mbsize.d_view(m).dx2;
+      }
+      if (three_d) {
+        Real flo = (multilevel && k == ks)? flx3(m,n,k,j,i) :
+                   FaceFlux(recon_, i0_, tt, t3d3, nh_c_, m, n, k, j, i, 1, 0, 0);
+        Real fhi = (multilevel && k == ke)? flx3(m,n,k+1,j,i) :
+                   FaceFlux(recon_, i0_, tt, t3d3, nh_c_, m, n, k+1, j, i, 1, 0, 0);
+        divf_s += (fhi - flo)/mbsize.d_view(m).dx3;
+      }
+      Real inew = gam0*i0_(m,n,k,j,i)+gam1*i1_(m,n,k,j,i)-beta_dt*divf_s;
+
+      // angular fluxes
+      if (angular_fluxes_) {
+        Real divfa = 0.0;
+        for (int nb=0; nb<numn.d_view(n); ++nb) {
+          Real na_nb = (compact)? CompactNA(tet_omega_,nh_f_,uflux,m,n,nb,k,j,i) :
+                                  na_(m,n,k,j,i,nb);
+          Real flx_edge = na_nb * ((na_nb < 0.0) ?
+                                   i0_(m,indn.d_view(n,nb),k,j,i)/tt(m,0,0,k,j,i) :
+                                   i0_(m,n,k,j,i)/tt(m,0,0,k,j,i));
+          divfa += (arcl.d_view(n,nb)*flx_edge/solid_angles_.d_view(n));
+        }
+        inew -= beta_dt*divfa;
+      }
+
+      // zero intensity if negative
+      Real n0  = tt(m,0,0,k,j,i);
+      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
+                 tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+      inew = n0*n_0*fmax((inew/(n0*n_0)), 0.0);
+
+      // handle excision (see RKUpdate())
+      if (excise) {
+        if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { inew = 0.0; }
+      }
+      inew_(m,n,k,j,i) = inew;
+    });
+  });
+
+  // updated intensities become i0.  Ghost zones of the new i0 are stale until the
+  // boundary communication later in the stage.
+  std::swap(i0, inew);
+  return;
+}
+
+} // namespace radiation
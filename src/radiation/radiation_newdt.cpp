@@ -52,6 +52,10 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
   bool &angular_fluxes_ = angular_fluxes;
   auto &nh_c_ = nh_c;
   auto &na_ = na;
+  bool &compact = compact_tetrad;
+  auto &tet_omega_ = tet_omega;
+  auto &nh_f_ = nh_f;
+  auto &uflux = prgeo->unit_flux;
   auto &tet_c_ = tet_c;
   auto &excise = pmy_pack->pcoord->coord_data.bh_excise;
   auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
@@ -83,7 +87,9 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
           Real zn = nh_c_.d_view(indn.d_view(n,nb),3);
           // compute timestep limitation
           Real n0 = tet_c_(m,0,0,k,j,i);
-          Real adt = fmin(tmp_min_dta,(acos(x*xn+y*yn+z*zn)/fabs(na_(m,n,k,j,i,nb)/n0)));
+          Real na_nb = (compact)? CompactNA(tet_omega_,nh_f_,uflux,m,n,nb,k,j,i) :
+                                  na_(m,n,k,j,i,nb);
+          Real adt = fmin(tmp_min_dta,(acos(x*xn+y*yn+z*zn)/fabs(na_nb/n0)));
           // set timestep limitation if not excising this cell
           if (excise) {
             if (!(rad_mask_(m,k,j,i))) { tmp_min_dta = adt; }
@@ -12,6 +12,21 @@
 
 #include "athena.hpp"
 
+//----------------------------------------------------------------------------------------
+//! \struct TableAxis
+//! \brief spacing of one axis of an opacity table.  If the (log) values along the axis
+//! are uniformly spaced, the location of a value is computed directly from x0 and inv_dx
+//! rather than by a search.  Set by Radiation::PrepareOpacityTable().
+
+struct TableAxis {
+  bool uniform = false;
+  Real x0 = 0.0, inv_dx = 0.0;
+};
+
+struct OpacityTableAxes {
+  TableAxis ross_rho, ross_t, planck_rho, planck_t;
+};
+
 //----------------------------------------------------------------------------------------
 //! \fn void OpacityFunction
 //! \brief sets sigma_a, sigma_s, sigma_p in the comoving frame
@@ -46,17 +61,31 @@ void OpacityFunction(// density and density scale
 }
 
 
+//----------------------------------------------------------------------------------------
+//! \fn void GetArrayLocation
+//! \brief finds loc_r, the first index with value <= in_arr(loc_r) (or the last index),
+//! and loc_l = loc_r-1.  Values are assumed to increase along the array.  Uniformly
+//! spaced axes are located in O(1), others by a binary search.
+
 KOKKOS_INLINE_FUNCTION
 void GetArrayLocation(const Real value, const DualArray1D<Real> &in_arr,
-                      int &loc_l, int &loc_r){
+                      const TableAxis &axis, int &loc_l, int &loc_r){
   int arr_size = in_arr.extent_int(0) - 1;
 
-  loc_l = 0;
-  loc_r = 0;
-
-
-  while((value > in_arr.d_view(loc_r)) && (loc_r < arr_size)){
-    loc_r++;
+  if (axis.uniform) {
+    Real s = ceil((value - axis.x0)*axis.inv_dx);
+    loc_r = static_cast<int>(fmin(fmax(s, 0.0), static_cast<Real>(arr_size)));
+  } else {
+    int lo = 0, hi = arr_size;
+    while (lo < hi) {
+      int mid = (lo + hi)/2;
+      if (value > in_arr.d_view(mid)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    loc_r = lo;
   }
   loc_l = loc_r-1;
   if(loc_l < 0) loc_l = 0;
@@ -126,7 +155,8 @@ void TableOpacity(const Real dens, const Real density_scale,
                   const DualArray1D<Real> &planck_rho,
                   const DualArray1D<Real> &planck_t,
                   const DualArray2D<Real> &ross_table,
-                  const DualArray2D<Real> &planck_table, const Real k_elec,
+                  const DualArray2D<Real> &planck_table, const OpacityTableAxes &axes,
+                  const Real k_elec,
                   Real& sigma_a, Real& sigma_s, Real& sigma_p, Real& sigma_pe) {
 
   Real log_x = log10(dens * density_scale);
@@ -148,11 +178,11 @@ void TableOpacity(const Real dens, const Real density_scale,
   // rho value should be between [nx_l:nx_r]
   int nx_l = 0;
   int nx_r = 0;
-  GetArrayLocation(log_x, ross_rho, nx_l, nx_r);
+  GetArrayLocation(log_x, ross_rho, axes.ross_rho, nx_l, nx_r);
   // tem should be between [ny_l:ny_r]
   int ny_l = 0;
   int ny_r = 0;
-  GetArrayLocation(log_t, ross_t, ny_l, ny_r);
+  GetArrayLocation(log_t, ross_t, axes.ross_t, ny_l, ny_r);
 
   BilinearInterpolation(log_x, log_t, nx_l, nx_r, ny_l, ny_r,
                         ross_rho, ross_t, ross_table, kappa_ross);
@@ -176,11 +206,11 @@ void TableOpacity(const Real dens, const Real density_scale,
   // rho value should be between [nx_l:nx_r]
   nx_l = 0;
   nx_r = 0;
-  GetArrayLocation(log_x, planck_rho, nx_l, nx_r);
+  GetArrayLocation(log_x, planck_rho, axes.planck_rho, nx_l, nx_r);
   // tem should be between [ny_l:ny_r]
   ny_l = 0;
   ny_r = 0;
-  GetArrayLocation(log_t, planck_t, ny_l, ny_r);
+  GetArrayLocation(log_t, planck_t, axes.planck_t, ny_l, ny_r);
 
   BilinearInterpolation(log_x, log_t, nx_l, nx_r, ny_l, ny_r,
                         planck_rho, planck_t, planck_table, kappa_planck);
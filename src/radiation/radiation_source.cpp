@@ -20,12 +20,51 @@
 
 #include "radiation/radiation_tetrad.hpp"
 #include "radiation/radiation_opacities.hpp"
+#include "utils/roofline.hpp"
+
+// sums over angles computed simultaneously by team reductions in the source term
+namespace radiation {
+using RadSum = array_sum::array_type<Real,8>;
+} // namespace radiation
+
+namespace Kokkos { //reduction identity must be defined in Kokkos namespace
+template<>
+struct reduction_identity< radiation::RadSum > {
+  KOKKOS_FORCEINLINE_FUNCTION static radiation::RadSum sum() {
+    return radiation::RadSum();
+  }
+};
+}
 
 namespace radiation {
 
 KOKKOS_INLINE_FUNCTION
 bool FourthPolyRoot(const Real coef4, const Real tconst, Real &root);
 
+//----------------------------------------------------------------------------------------
+//! \struct IntensityCellOuter, IntensityAngleInner
+//! \brief accessors to intensities indexed as (m,n,k,j,i), either stored in Radiation::i0
+//! (default layout) or in Radiation::i0_ang (angle index fastest, active cells only)
+
+struct IntensityCellOuter {
+  DvceArray5D<Real> a;
+  KOKKOS_INLINE_FUNCTION
+  Real &operator()(const int m, const int n, const int k, const int j,
+                   const int i) const {
+    return a(m,n,k,j,i);
+  }
+};
+
+struct IntensityAngleInner {
+  DvceArray5D<Real> a;
+  int is, js, ks;
+  KOKKOS_INLINE_FUNCTION
+  Real &operator()(const int m, const int n, const int k, const int j,
+                   const int i) const {
+    return a(m,k-ks,j-js,i-is,n);
+  }
+};
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage)
 // \brief Add implicit radiation source term.  Based off of @c-white and @yanfeij's gr_rad
@@ -37,6 +76,73 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     return TaskStatus::complete;
   }
 
+  // Locate table axes once tables have been loaded by the problem generator
+  if (table_opacity && !(op_table_prepared)) {
+    PrepareOpacityTable();
+  }
+
+  // Extract indices and hydro/mhd quantities
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nang1 = prgeo->nangles - 1;
+  DvceArray5D<Real> u0_, w0_;
+  if (is_hydro_enabled) {
+    u0_ = pmy_pack->phydro->u0;
+    w0_ = pmy_pack->phydro->w0;
+  } else if (is_mhd_enabled) {
+    u0_ = pmy_pack->pmhd->u0;
+    w0_ = pmy_pack->pmhd->w0;
+  }
+
+  // Extract timestep
+  Real dt_ = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+
+  // Call ConsToPrim over active zones prior to source term application
+  if (!(fixed_fluid)) {
+    if (is_hydro_enabled) {
+      pmy_pack->phydro->peos->ConsToPrim(u0_,w0_,false,is,ie,js,je,ks,ke);
+    } else if (is_mhd_enabled) {
+      auto &b0_ = pmy_pack->pmhd->b0;
+      auto &bcc0_ = pmy_pack->pmhd->bcc0;
+      pmy_pack->pmhd->peos->ConsToPrim(u0_,b0_,w0_,bcc0_,false,is,ie,js,je,ks,ke);
+    }
+  }
+
+  if (!(angle_innermost)) {
+    ImplicitSourceTerm(IntensityCellOuter{i0}, dt_);
+    return TaskStatus::complete;
+  }
+
+  // Transpose intensities so angles are innermost, apply source term, and transpose
+  // back.  Loops over cells are innermost in both copies, so loads from i0 and stores
+  // to i0 are contiguous.
+  auto &i0_ = i0;
+  auto &i0_ang_ = i0_ang;
+  par_for("rad_i0_to_ang",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    i0_ang_(m,k-ks,j-js,i-is,n) = i0_(m,n,k,j,i);
+  });
+  ImplicitSourceTerm(IntensityAngleInner{i0_ang, is, js, ks}, dt_);
+  par_for("rad_ang_to_i0",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    i0_(m,n,k,j,i) = i0_ang_(m,k-ks,j-js,i-is,n);
+  });
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::ImplicitSourceTerm()
+//! \brief Kernel for the implicit radiation source term over the active cells, called by
+//! AddRadiationSourceTerm() after the fluid primitives are computed.  Templated on the
+//! accessor to the intensities, i0_(m,n,k,j,i), so the same kernel is used for both
+//! layouts.
+
+template <typename IntensityArray>
+void Radiation::ImplicitSourceTerm(const IntensityArray &i0_, const Real dt_) {
   // Extract indices, size data, hydro/mhd/units flags, and coupling flags
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &ie = indcs.ie;
@@ -49,7 +155,9 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
   bool &is_mhd_enabled_ = is_mhd_enabled;
   bool &are_units_enabled_ = are_units_enabled;
   bool &is_compton_enabled_ = is_compton_enabled;
-  bool &fixed_fluid_ = fixed_fluid;
+  Real &compton_equil_tol_ = compton_equil_tol;
+  bool &count_events = use_source_counters;
+  auto &counts_ = pmy_pack->pmesh->ecounter.dcounts;
   bool &affect_fluid_ = affect_fluid;
 
   // Extract coordinate/excision data
@@ -85,7 +193,6 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
   }
 
   // Extract radiation, radiation frame, and radiation angular mesh data
-  auto &i0_ = i0;
   Real &kappa_a_ = kappa_a;
   Real &kappa_s_ = kappa_s;
   Real &kappa_p_ = kappa_p;
@@ -105,6 +212,10 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
   auto planck_table_ = planck_table;
   bool &table_opacity_ = table_opacity;
   bool &op_table_use_r_ = op_table_use_r;
+  auto op_axes_ = op_axes;
+  bool use_op_cache = (table_opacity && op_cache_tol > 0.0);
+  Real op_cache_tol_ = (use_op_cache)? op_cache_tol : 0.0;
+  auto &op_cache_ = op_cache;
 
   // Extract hydro/mhd quantities
   DvceArray5D<Real> u0_, w0_;
@@ -116,26 +227,22 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     w0_ = pmy_pack->pmhd->w0;
   }
 
-  // Extract timestep
-  Real dt_ = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
-
-  // Call ConsToPrim over active zones prior to source term application
-  if (!(fixed_fluid_)) {
-    if (is_hydro_enabled_) {
-      pmy_pack->phydro->peos->ConsToPrim(u0_,w0_,false,is,ie,js,je,ks,ke);
-    } else if (is_mhd_enabled_) {
-      auto &b0_ = pmy_pack->pmhd->b0;
-      auto &bcc0_ = pmy_pack->pmhd->bcc0;
-      pmy_pack->pmhd->peos->ConsToPrim(u0_,b0_,w0_,bcc0_,false,is,ie,js,je,ks,ke);
-    }
-  }
-
-  // compute implicit source term
-  par_for("radiation_source",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    Real &x1min = size.d_view(m).x1min;
-    Real &x1max = size.d_view(m).x1max;
-    Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+  // compute implicit source term.  Each team handles a pencil of cells in x1, one cell
+  // at a time, with the angles distributed over the threads/vector lanes of the team.
+  // Angular sums are computed with team reductions, and the components n_0 and n0_cm of
+  // each angle are saved in scratch for reuse by the later loops over angles.
+  int nang = prgeo->nangles;
+  size_t scr_size = ScrArray1D<Real>::shmem_size(nang) * 2;
+  int scr_level = 0;
+  // estimated work per cell for roofline analysis: intensities loaded and stored once,
+  // plus tetrad, metric and fluid variables, and ~40 flops per angle in the sums
+  roofline::AddWork("radiation_source",
+                    static_cast<Real>(nmb1 + 1)*indcs.nx1*indcs.nx2*indcs.nx3,
+                    (2.0*nang + 47.0)*sizeof(Real), 40.0*nang + 300.0);
+  par_for_outer("radiation_source",DevExeSpace(),scr_size,scr_level,0,nmb1,ks,ke,js,je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray1D<Real> n_0_(member.team_scratch(scr_level), nang);
+    ScrArray1D<Real> n0_cm_(member.team_scratch(scr_level), nang);
 
     Real &x2min = size.d_view(m).x2min;
     Real &x2max = size.d_view(m).x2max;
@@ -145,216 +252,159 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     Real &x3max = size.d_view(m).x3max;
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
-    // compute metric and inverse
-    Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
-    Real alpha = sqrt(-1.0/gupper[0][0]);
-
-    // fluid state
-    Real &wdn = w0_(m,IDN,k,j,i);
-    Real &wvx = w0_(m,IVX,k,j,i);
-    Real &wvy = w0_(m,IVY,k,j,i);
-    Real &wvz = w0_(m,IVZ,k,j,i);
-    Real &wen = w0_(m,IEN,k,j,i);
-
-    // derived quantities
-    Real pgas = gm1*wen;
-    Real tgas = pgas/wdn;
-    Real q = glower[1][1]*wvx*wvx + 2.0*glower[1][2]*wvx*wvy + 2.0*glower[1][3]*wvx*wvz
-           + glower[2][2]*wvy*wvy + 2.0*glower[2][3]*wvy*wvz
-           + glower[3][3]*wvz*wvz;
-    Real gamma = sqrt(1.0 + q);
-    Real u0 = gamma/alpha;
-
-    // set opacities
-    Real sigma_a, sigma_s, sigma_p, sigma_pe;
-    if(table_opacity_){
-      TableOpacity(wdn, density_scale_, tgas, temperature_scale_,
-                  length_scale_, op_table_use_r_, ross_rho_, ross_t_,
-                  planck_rho_, planck_t_, ross_table_, planck_table_, kappa_s_,
-                  sigma_a, sigma_s, sigma_p, sigma_pe);
-
-    }else{
-      OpacityFunction(wdn, density_scale_,
-                    tgas, temperature_scale_,
-                    length_scale_, gm1, mean_mol_weight_,
-                    power_opacity_, rosseland_coef_, planck_minus_rosseland_coef_,
-                    kappa_a_, kappa_s_, kappa_p_,
-                    sigma_a, sigma_s, sigma_p);
-    }
-
-    Real dtcsiga = dt_*sigma_a;
-    Real dtcsigs = dt_*sigma_s;
-    Real dtcsigp = dt_*sigma_p;
-    Real dtcsigpe = dt_*sigma_pe;
-
-    Real dtaucsiga = dtcsiga/u0;
-    Real dtaucsigs = dtcsigs/u0;
-    Real dtaucsigp = dtcsigp/u0;
-    Real dtaucsigpe = dtcsigpe/u0;
-
-    // compute fluid velocity in tetrad frame
-    Real u_tet[4];
-    u_tet[0] = (norm_to_tet_(m,0,0,k,j,i)*gamma + norm_to_tet_(m,0,1,k,j,i)*wvx +
-                norm_to_tet_(m,0,2,k,j,i)*wvy   + norm_to_tet_(m,0,3,k,j,i)*wvz);
-    u_tet[1] = (norm_to_tet_(m,1,0,k,j,i)*gamma + norm_to_tet_(m,1,1,k,j,i)*wvx +
-                norm_to_tet_(m,1,2,k,j,i)*wvy   + norm_to_tet_(m,1,3,k,j,i)*wvz);
-    u_tet[2] = (norm_to_tet_(m,2,0,k,j,i)*gamma + norm_to_tet_(m,2,1,k,j,i)*wvx +
-                norm_to_tet_(m,2,2,k,j,i)*wvy   + norm_to_tet_(m,2,3,k,j,i)*wvz);
-    u_tet[3] = (norm_to_tet_(m,3,0,k,j,i)*gamma + norm_to_tet_(m,3,1,k,j,i)*wvx +
-                norm_to_tet_(m,3,2,k,j,i)*wvy   + norm_to_tet_(m,3,3,k,j,i)*wvz);
-
-    // coordinate component n^0
-    Real n0 = tt(m,0,0,k,j,i);
-
-    // Calculate polynomial coefficients
-    Real wght_sum = 0.0;
-    Real suma1 = 0.0;
-    Real suma2 = 0.0;
-    for (int n=0; n<=nang1; ++n) {
-      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
-                 tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
-      Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
-                    u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
-      Real omega_cm = solid_angles_.d_view(n)/SQR(n0_cm);
-      Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
-      Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
-      Real vncsigma2 = n0_cm*vncsigma;
-      Real ir_weight = intensity_cm*omega_cm;
-      wght_sum += omega_cm;
-      suma1 += omega_cm*vncsigma2;
-      suma2 += ir_weight*n0*vncsigma;
-    }
-    suma1 /= wght_sum;
-    suma2 /= wght_sum;
-    Real suma3 = suma1*(dtcsigs+dtcsiga-dtcsigpe);
-    suma1 *= (dtcsigp);
-
-    // compute coefficients
-    Real coef[2];
-    coef[1] = (dtaucsigp-dtaucsigpe*suma1/(1.0-suma3))*arad_*gm1/wdn;
-    coef[0] = -tgas-dtaucsigpe*suma2*gm1/(wdn*(1.0-suma3));
-
-    // Calculate new gas temperature
-    Real tgasnew = tgas;
-    bool badcell = false;
-    if (fabs(coef[1]) > 1.0e-20) {
-      bool flag = FourthPolyRoot(coef[1], coef[0], tgasnew);
-      if (!(flag) || !(isfinite(tgasnew))) {
-        badcell = true;
-        tgasnew = tgas;
+    for (int i=is; i<=ie; ++i) {
+      Real &x1min = size.d_view(m).x1min;
+      Real &x1max = size.d_view(m).x1max;
+      Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+
+      // compute metric and inverse
+      Real glower[4][4], gupper[4][4];
+      ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+      Real alpha = sqrt(-1.0/gupper[0][0]);
+
+      // fluid state
+      Real &wdn = w0_(m,IDN,k,j,i);
+      Real &wvx = w0_(m,IVX,k,j,i);
+      Real &wvy = w0_(m,IVY,k,j,i);
+      Real &wvz = w0_(m,IVZ,k,j,i);
+      Real &wen = w0_(m,IEN,k,j,i);
+
+      // derived quantities
+      Real pgas = gm1*wen;
+      Real tgas = pgas/wdn;
+      Real q = glower[1][1]*wvx*wvx + 2.0*glower[1][2]*wvx*wvy + 2.0*glower[1][3]*wvx*wvz
+             + glower[2][2]*wvy*wvy + 2.0*glower[2][3]*wvy*wvz
+             + glower[3][3]*wvz*wvz;
+      Real gamma = sqrt(1.0 + q);
+      Real u0 = gamma/alpha;
+
+      // set opacities
+      Real sigma_a, sigma_s, sigma_p, sigma_pe;
+      if(table_opacity_){
+        // reuse cached opacities if density and temperature are nearly unchanged
+        bool hit = false;
+        if (use_op_cache) {
+          hit = (fabs(wdn - op_cache_(m,0,k,j,i)) <= op_cache_tol_*op_cache_(m,0,k,j,i) &&
+                 fabs(tgas - op_cache_(m,1,k,j,i)) <= op_cache_tol_*op_cache_(m,1,k,j,i));
+        }
+        if (hit) {
+          sigma_a  = wdn*op_cache_(m,2,k,j,i);
+          sigma_s  = wdn*op_cache_(m,3,k,j,i);
+          sigma_p  = wdn*op_cache_(m,4,k,j,i);
+          sigma_pe = wdn*op_cache_(m,5,k,j,i);
+        } else {
+          TableOpacity(wdn, density_scale_, tgas, temperature_scale_,
+                      length_scale_, op_table_use_r_, ross_rho_, ross_t_,
+                      planck_rho_, planck_t_, ross_table_, planck_table_, op_axes_,
+                      kappa_s_, sigma_a, sigma_s, sigma_p, sigma_pe);
+        }
+        if (use_op_cache) {
+          // all threads must read the cache before it is overwritten
+          member.team_barrier();
+          if (!(hit)) {
+            Kokkos::single(Kokkos::PerTeam(member), [&]() {
+              op_cache_(m,0,k,j,i) = wdn;
+              op_cache_(m,1,k,j,i) = tgas;
+              op_cache_(m,2,k,j,i) = sigma_a/wdn;
+              op_cache_(m,3,k,j,i) = sigma_s/wdn;
+              op_cache_(m,4,k,j,i) = sigma_p/wdn;
+              op_cache_(m,5,k,j,i) = sigma_pe/wdn;
+            });
+          }
+        }
+      }else{
+        OpacityFunction(wdn, density_scale_,
+                      tgas, temperature_scale_,
+                      length_scale_, gm1, mean_mol_weight_,
+                      power_opacity_, rosseland_coef_, planck_minus_rosseland_coef_,
+                      kappa_a_, kappa_s_, kappa_p_,
+                      sigma_a, sigma_s, sigma_p);
       }
-    } else {
-      tgasnew = -coef[0];
-    }
 
-    // Update the specific intensity
-    if (!(badcell)) {
-      // Calculate emission coefficient and updated jr_cm
-      Real emission = arad_*SQR(SQR(tgasnew));
-      Real jr_cm = (suma1*emission + suma2)/(1.0 - suma3);
-      Real m_old[4] = {0.0}; Real m_new[4] = {0.0};
-      for (int n=0; n<=nang1; ++n) {
-        // compute coordinate normal components
+      Real dtcsiga = dt_*sigma_a;
+      Real dtcsigs = dt_*sigma_s;
+      Real dtcsigp = dt_*sigma_p;
+      Real dtcsigpe = dt_*sigma_pe;
+
+      Real dtaucsiga = dtcsiga/u0;
+      Real dtaucsigs = dtcsigs/u0;
+      Real dtaucsigp = dtcsigp/u0;
+      Real dtaucsigpe = dtcsigpe/u0;
+
+      // compute fluid velocity in tetrad frame
+      Real u_tet[4];
+      u_tet[0] = (norm_to_tet_(m,0,0,k,j,i)*gamma + norm_to_tet_(m,0,1,k,j,i)*wvx +
+                  norm_to_tet_(m,0,2,k,j,i)*wvy   + norm_to_tet_(m,0,3,k,j,i)*wvz);
+      u_tet[1] = (norm_to_tet_(m,1,0,k,j,i)*gamma + norm_to_tet_(m,1,1,k,j,i)*wvx +
+                  norm_to_tet_(m,1,2,k,j,i)*wvy   + norm_to_tet_(m,1,3,k,j,i)*wvz);
+      u_tet[2] = (norm_to_tet_(m,2,0,k,j,i)*gamma + norm_to_tet_(m,2,1,k,j,i)*wvx +
+                  norm_to_tet_(m,2,2,k,j,i)*wvy   + norm_to_tet_(m,2,3,k,j,i)*wvz);
+      u_tet[3] = (norm_to_tet_(m,3,0,k,j,i)*gamma + norm_to_tet_(m,3,1,k,j,i)*wvx +
+                  norm_to_tet_(m,3,2,k,j,i)*wvy   + norm_to_tet_(m,3,3,k,j,i)*wvz);
+
+      // coordinate component n^0
+      Real n0 = tt(m,0,0,k,j,i);
+
+      // Calculate polynomial coefficients
+      RadSum sum;
+      Kokkos::parallel_reduce(Kokkos::TeamVectorRange(member, nang),
+      [&](const int n, RadSum &s) {
         Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)
                  + tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
-        Real n_1 = tc(m,0,1,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,1,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,1,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,1,k,j,i)*nh_c_.d_view(n,3);
-        Real n_2 = tc(m,0,2,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,2,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,2,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,2,k,j,i)*nh_c_.d_view(n,3);
-        Real n_3 = tc(m,0,3,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,3,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,3,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,3,k,j,i)*nh_c_.d_view(n,3);
-
-        // compute moments before coupling
-        m_old[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(n));
-        m_old[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_old[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_old[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-
-        // update intensity
         Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
                       u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
+        n_0_(n) = n_0;
+        n0_cm_(n) = n0_cm;
+        Real omega_cm = solid_angles_.d_view(n)/SQR(n0_cm);
         Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
         Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
         Real vncsigma2 = n0_cm*vncsigma;
-        Real di_cm = ( ((dtcsigs+dtcsiga-dtcsigpe)*jr_cm +
-                        dtcsigp*emission -
-                        (dtcsigs+dtcsiga)*intensity_cm)*vncsigma2 );
-        i0_(m,n,k,j,i) = n0*n_0*fmax(i0_(m,n,k,j,i)/(n0*n_0) +
-                                     di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
-
-        // compute moments after coupling
-        m_new[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(n));
-        m_new[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_new[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_new[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-
-        // handle excision
-        // NOTE(@pdmullen): The below zeroes all intensities within rks <= r_excision and
-        // zeroes intensities within angles where n_0 is about zero. When Compton is
-        // enabled, we delay the n_0_floor excision so that intensites updated via
-        // absorption and scattering inform the Compton update
-        if (excise) {
-          bool apply_excision = (rad_mask_(m,k,j,i) ||
-                                 (!(is_compton_enabled_) && fabs(n_0) < n_0_floor_));
-          if (apply_excision) { i0_(m,n,k,j,i) = 0.0; }
-        }
-      }
-      // update conserved fluid variables
-      if (affect_fluid_) {
-        u0_(m,IEN,k,j,i) += (m_old[0] - m_new[0]);
-        u0_(m,IM1,k,j,i) += (m_old[1] - m_new[1]);
-        u0_(m,IM2,k,j,i) += (m_old[2] - m_new[2]);
-        u0_(m,IM3,k,j,i) += (m_old[3] - m_new[3]);
-      }
-    }
-
-    // compton scattering
-    if (is_compton_enabled_) {
-      // use partially updated gas temperature
-      tgas = tgasnew;
-
-      // compute polynomial coefficients using partially updated gas temp and intensity
-      suma1 = 0.0;
-      Real jr_cm = 0.0;
-      for (int n=0; n<=nang1; ++n) {
-        Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
-                   tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
-        Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
-                      u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
-        Real wght_cm = solid_angles_.d_view(n)/SQR(n0_cm)/wght_sum;
-        Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
-        Real ir_weight = intensity_cm*wght_cm;
-        jr_cm += ir_weight;
-        suma1 += (n0_cm/n0)*4.0*dtcsigs*inv_t_electron_*wght_cm;
-      }
-      suma2 = 4.0*dtaucsigs*inv_t_electron_*gm1/wdn;
-
-      // compute partially updated radiation temperature
-      Real trad = sqrt(sqrt(jr_cm/arad_));
-      const bool temp_equil = (fabs(trad - tgas) < 1.0e-12);
-
-      // Calculate new gas temperature due to Compton
-      Real tradnew = trad;
-      badcell = false;
-      if (!(temp_equil)) {
-        coef[1] = (1.0 + suma2*jr_cm)/(suma1*jr_cm)*arad_;
-        coef[0] = -(1.0 + suma2*jr_cm)/suma1 - tgas;
-        bool flag = FourthPolyRoot(coef[1], coef[0], tradnew);
-        if (!(flag) || !(isfinite(tradnew))) {
+        Real ir_weight = intensity_cm*omega_cm;
+        s.the_array[0] += omega_cm;
+        s.the_array[1] += omega_cm*vncsigma2;
+        s.the_array[2] += ir_weight*n0*vncsigma;
+      }, Kokkos::Sum<RadSum>(sum));
+      member.team_barrier();
+      Real wght_sum = sum.the_array[0];
+      Real suma1 = sum.the_array[1]/wght_sum;
+      Real suma2 = sum.the_array[2]/wght_sum;
+      Real suma3 = suma1*(dtcsigs+dtcsiga-dtcsigpe);
+      suma1 *= (dtcsigp);
+
+      // compute coefficients
+      Real coef[2];
+      coef[1] = (dtaucsigp-dtaucsigpe*suma1/(1.0-suma3))*arad_*gm1/wdn;
+      coef[0] = -tgas-dtaucsigpe*suma2*gm1/(wdn*(1.0-suma3));
+
+      // Calculate new gas temperature
+      Real tgasnew = tgas;
+      bool badcell = false;
+      if (fabs(coef[1]) > 1.0e-20) {
+        bool flag = FourthPolyRoot(coef[1], coef[0], tgasnew);
+        if (!(flag) || !(isfinite(tgasnew))) {
           badcell = true;
+          tgasnew = tgas;
         }
+      } else {
+        tgasnew = -coef[0];
+      }
+      if (count_events && badcell) {
+        Kokkos::single(Kokkos::PerTeam(member), [&]() {
+          Kokkos::atomic_increment(&counts_.d_view(EventCounters::iradfail));
+        });
       }
 
       // Update the specific intensity
-      if (!(badcell) && !(temp_equil)) {
-        // Compute updated gas temperature
-        tgasnew = (arad_*SQR(SQR(tradnew)) - jr_cm)/(suma1*jr_cm) + tradnew;
-        Real m_old[4] = {0.0}; Real m_new[4] = {0.0};
-        for (int n=0; n<=nang1; ++n) {
+      if (!(badcell)) {
+        // Calculate emission coefficient and updated jr_cm
+        Real emission = arad_*SQR(SQR(tgasnew));
+        Real jr_cm = (suma1*emission + suma2)/(1.0 - suma3);
+        // moments before (entries 0-3) and after (entries 4-7) coupling
+        RadSum mom;
+        Kokkos::parallel_reduce(Kokkos::TeamVectorRange(member, nang),
+        [&](const int n, RadSum &s) {
           // compute coordinate normal components
-          Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0)+tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)
-                   + tc(m,2,0,k,j,i)*nh_c_.d_view(n,2)+tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+          Real &n_0 = n_0_(n);
           Real n_1 = tc(m,0,1,k,j,i)*nh_c_.d_view(n,0)+tc(m,1,1,k,j,i)*nh_c_.d_view(n,1)
                    + tc(m,2,1,k,j,i)*nh_c_.d_view(n,2)+tc(m,3,1,k,j,i)*nh_c_.d_view(n,3);
           Real n_2 = tc(m,0,2,k,j,i)*nh_c_.d_view(n,0)+tc(m,1,2,k,j,i)*nh_c_.d_view(n,1)
@@ -363,55 +413,168 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
                    + tc(m,2,3,k,j,i)*nh_c_.d_view(n,2)+tc(m,3,3,k,j,i)*nh_c_.d_view(n,3);
 
           // compute moments before coupling
-          m_old[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(n));
-          m_old[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-          m_old[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-          m_old[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
+          Real &in = i0_(m,n,k,j,i);
+          s.the_array[0] += (    in    *solid_angles_.d_view(n));
+          s.the_array[1] += (n_1*in/n_0*solid_angles_.d_view(n));
+          s.the_array[2] += (n_2*in/n_0*solid_angles_.d_view(n));
+          s.the_array[3] += (n_3*in/n_0*solid_angles_.d_view(n));
 
           // update intensity
-          Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
-                        u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
-          Real di_cm = (n0_cm/n0)*dtcsigs*4.0*jr_cm*inv_t_electron_*(tgasnew - tradnew);
-          i0_(m,n,k,j,i) = n0*n_0*fmax(i0_(m,n,k,j,i)/(n0*n_0) +
-                                       di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
+          Real &n0_cm = n0_cm_(n);
+          Real intensity_cm = 4.0*M_PI*(in/(n0*n_0))*SQR(SQR(n0_cm));
+          Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
+          Real vncsigma2 = n0_cm*vncsigma;
+          Real di_cm = ( ((dtcsigs+dtcsiga-dtcsigpe)*jr_cm +
+                          dtcsigp*emission -
+                          (dtcsigs+dtcsiga)*intensity_cm)*vncsigma2 );
+          in = n0*n_0*fmax(in/(n0*n_0) + di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
 
           // compute moments after coupling
-          m_new[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(n));
-          m_new[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-          m_new[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-          m_new[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-
-          // handle excision (see notes above)
+          s.the_array[4] += (    in    *solid_angles_.d_view(n));
+          s.the_array[5] += (n_1*in/n_0*solid_angles_.d_view(n));
+          s.the_array[6] += (n_2*in/n_0*solid_angles_.d_view(n));
+          s.the_array[7] += (n_3*in/n_0*solid_angles_.d_view(n));
+
+          // handle excision
+          // NOTE(@pdmullen): The below zeroes all intensities within rks <= r_excision
+          // and zeroes intensities within angles where n_0 is about zero. When Compton is
+          // enabled, we delay the n_0_floor excision so that intensites updated via
+          // absorption and scattering inform the Compton update
           if (excise) {
-            if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { i0_(m,n,k,j,i) = 0.0; }
+            bool apply_excision = (rad_mask_(m,k,j,i) ||
+                                   (!(is_compton_enabled_) && fabs(n_0) < n_0_floor_));
+            if (apply_excision) { in = 0.0; }
           }
+        }, Kokkos::Sum<RadSum>(mom));
+        // update conserved fluid variables
+        if (affect_fluid_) {
+          Kokkos::single(Kokkos::PerTeam(member), [&]() {
+            u0_(m,IEN,k,j,i) += (mom.the_array[0] - mom.the_array[4]);
+            u0_(m,IM1,k,j,i) += (mom.the_array[1] - mom.the_array[5]);
+            u0_(m,IM2,k,j,i) += (mom.the_array[2] - mom.the_array[6]);
+            u0_(m,IM3,k,j,i) += (mom.the_array[3] - mom.the_array[7]);
+          });
         }
+      }
 
-        // feedback on fluid
-        if (affect_fluid_) {
-          u0_(m,IEN,k,j,i) += (m_old[0] - m_new[0]);
-          u0_(m,IM1,k,j,i) += (m_old[1] - m_new[1]);
-          u0_(m,IM2,k,j,i) += (m_old[2] - m_new[2]);
-          u0_(m,IM3,k,j,i) += (m_old[3] - m_new[3]);
+      // compton scattering
+      if (is_compton_enabled_) {
+        // use partially updated gas temperature
+        tgas = tgasnew;
+
+        // compute polynomial coefficients using partially updated gas temp and intensity
+        RadSum csum;
+        Kokkos::parallel_reduce(Kokkos::TeamVectorRange(member, nang),
+        [&](const int n, RadSum &s) {
+          Real &n_0 = n_0_(n);
+          Real &n0_cm = n0_cm_(n);
+          Real wght_cm = solid_angles_.d_view(n)/SQR(n0_cm)/wght_sum;
+          Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
+          Real ir_weight = intensity_cm*wght_cm;
+          s.the_array[0] += ir_weight;
+          s.the_array[1] += (n0_cm/n0)*4.0*dtcsigs*inv_t_electron_*wght_cm;
+        }, Kokkos::Sum<RadSum>(csum));
+        Real jr_cm = csum.the_array[0];
+        suma1 = csum.the_array[1];
+        suma2 = 4.0*dtaucsigs*inv_t_electron_*gm1/wdn;
+
+        // compute partially updated radiation temperature
+        Real trad = sqrt(sqrt(jr_cm/arad_));
+        const bool temp_equil = (fabs(trad - tgas) < 1.0e-12 ||
+                                 fabs(trad - tgas) <= compton_equil_tol_*tgas);
+
+        // Calculate new gas temperature due to Compton
+        Real tradnew = trad;
+        badcell = false;
+        if (!(temp_equil)) {
+          coef[1] = (1.0 + suma2*jr_cm)/(suma1*jr_cm)*arad_;
+          coef[0] = -(1.0 + suma2*jr_cm)/suma1 - tgas;
+          bool flag = FourthPolyRoot(coef[1], coef[0], tradnew);
+          if (!(flag) || !(isfinite(tradnew))) {
+            badcell = true;
+          }
         }
-      } else {
-        // NOTE(@pdmullen): At this point, it is possible that excision has not been
-        // entirely applied if Compton is enabled and a badcell or temperature equilibrium
-        // was encountered.. apply excision
-        if (excise) {
-          for (int n=0; n<=nang1; ++n) {
-            Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0)+
-                       tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)+
-                       tc(m,2,0,k,j,i)*nh_c_.d_view(n,2)+
-                       tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
-            if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { i0_(m,n,k,j,i) = 0.0; }
+        if (count_events && (badcell || temp_equil)) {
+          Kokkos::single(Kokkos::PerTeam(member), [&]() {
+            int ic = (badcell)? EventCounters::icompfail : EventCounters::icompequil;
+            Kokkos::atomic_increment(&counts_.d_view(ic));
+          });
+        }
+
+        // Update the specific intensity
+        if (!(badcell) && !(temp_equil)) {
+          // Compute updated gas temperature
+          tgasnew = (arad_*SQR(SQR(tradnew)) - jr_cm)/(suma1*jr_cm) + tradnew;
+          // moments before (entries 0-3) and after (entries 4-7) coupling
+          RadSum mom;
+          Kokkos::parallel_reduce(Kokkos::TeamVectorRange(member, nang),
+          [&](const int n, RadSum &s) {
+            // compute coordinate normal components
+            Real &n_0 = n_0_(n);
+            Real n_1 = tc(m,0,1,k,j,i)*nh_c_.d_view(n,0) +
+                       tc(m,1,1,k,j,i)*nh_c_.d_view(n,1) +
+                       tc(m,2,1,k,j,i)*nh_c_.d_view(n,2) +
+                       tc(m,3,1,k,j,i)*nh_c_.d_view(n,3);
+            Real n_2 = tc(m,0,2,k,j,i)*nh_c_.d_view(n,0) +
+                       tc(m,1,2,k,j,i)*nh_c_.d_view(n,1) +
+                       tc(m,2,2,k,j,i)*nh_c_.d_view(n,2) +
+                       tc(m,3,2,k,j,i)*nh_c_.d_view(n,3);
+            Real n_3 = tc(m,0,3,k,j,i)*nh_c_.d_view(n,0) +
+                       tc(m,1,3,k,j,i)*nh_c_.d_view(n,1) +
+                       tc(m,2,3,k,j,i)*nh_c_.d_view(n,2) +
+                       tc(m,3,3,k,j,i)*nh_c_.d_view(n,3);
+
+            // compute moments before coupling
+            Real &in = i0_(m,n,k,j,i);
+            s.the_array[0] += (    in    *solid_angles_.d_view(n));
+            s.the_array[1] += (n_1*in/n_0*solid_angles_.d_view(n));
+            s.the_array[2] += (n_2*in/n_0*solid_angles_.d_view(n));
+            s.the_array[3] += (n_3*in/n_0*solid_angles_.d_view(n));
+
+            // update intensity
+            Real &n0_cm = n0_cm_(n);
+            Real di_cm = (n0_cm/n0)*dtcsigs*4.0*jr_cm*inv_t_electron_*(tgasnew - tradnew);
+            in = n0*n_0*fmax(in/(n0*n_0) + di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
+
+            // compute moments after coupling
+            s.the_array[4] += (    in    *solid_angles_.d_view(n));
+            s.the_array[5] += (n_1*in/n_0*solid_angles_.d_view(n));
+            s.the_array[6] += (n_2*in/n_0*solid_angles_.d_view(n));
+            s.the_array[7] += (n_3*in/n_0*solid_angles_.d_view(n));
+
+            // handle excision (see notes above)
+            if (excise) {
+              if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { in = 0.0; }
+            }
+          }, Kokkos::Sum<RadSum>(mom));
+
+          // feedback on fluid
+          if (affect_fluid_) {
+            Kokkos::single(Kokkos::PerTeam(member), [&]() {
+              u0_(m,IEN,k,j,i) += (mom.the_array[0] - mom.the_array[4]);
+              u0_(m,IM1,k,j,i) += (mom.the_array[1] - mom.the_array[5]);
+              u0_(m,IM2,k,j,i) += (mom.the_array[2] - mom.the_array[6]);
+              u0_(m,IM3,k,j,i) += (mom.the_array[3] - mom.the_array[7]);
+            });
+          }
+        } else {
+          // NOTE(@pdmullen): At this point, it is possible that excision has not been
+          // entirely applied if Compton is enabled and a badcell or temperature
+          // equilibrium was encountered.. apply excision
+          if (excise) {
+            par_for_inner(member, 0, nang1, [&](const int n) {
+              if (rad_mask_(m,k,j,i) || fabs(n_0_(n)) < n_0_floor_) {
+                i0_(m,n,k,j,i) = 0.0;
+              }
+            });
           }
         }
       }
+      // scratch arrays are overwritten by the next cell
+      member.team_barrier();
     }
   });
-
-  return TaskStatus::complete;
+  return;
 }
 
 //----------------------------------------------------------------------------------------
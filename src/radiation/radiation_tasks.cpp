@@ -37,112 +37,184 @@ void Radiation::AssembleRadTasks(std::map<std::string, std::shared_ptr<TaskList>
   // construct task list depending on enabled physics modules and radiation parameters
   if (pmhd != nullptr && !(fixed_fluid)) {  // radiation magnetohydrodynamics
     // assemble "before_stagen" task list
-    id.rad_irecv = tl["before_stagen"]->AddTask(&Radiation::InitRecv, this, none);
-    id.mhd_irecv = tl["before_stagen"]->AddTask(&mhd::MHD::InitRecv, pmhd, none);
+    id.rad_irecv = tl["before_stagen"]->AddTask(&Radiation::InitRecv, this, none,
+                                                "Rad_InitRecv");
+    id.mhd_irecv = tl["before_stagen"]->AddTask(&mhd::MHD::InitRecv, pmhd, none,
+                                                "MHD_InitRecv");
 
     // assemble "stagen" task list
-    id.copyu     = tl["stagen"]->AddTask(&Radiation::CopyCons, this, none);
-    id.rad_flux  = tl["stagen"]->AddTask(&Radiation::CalculateFluxes, this, id.copyu);
-    id.rad_sendf = tl["stagen"]->AddTask(&Radiation::SendFlux, this, id.rad_flux);
-    id.rad_recvf = tl["stagen"]->AddTask(&Radiation::RecvFlux, this, id.rad_sendf);
-    id.rad_rkupdt= tl["stagen"]->AddTask(&Radiation::RKUpdate, this, id.rad_recvf);
-    id.mhd_flux  = tl["stagen"]->AddTask(&mhd::MHD::Fluxes, pmhd, id.rad_rkupdt);
-    id.mhd_sendf = tl["stagen"]->AddTask(&mhd::MHD::SendFlux, pmhd, id.mhd_flux);
-    id.mhd_recvf = tl["stagen"]->AddTask(&mhd::MHD::RecvFlux, pmhd, id.mhd_sendf);
-    id.mhd_rkupdt= tl["stagen"]->AddTask(&mhd::MHD::RKUpdate, pmhd, id.mhd_recvf);
-    id.mhd_efld  = tl["stagen"]->AddTask(&mhd::MHD::CornerE, pmhd, id.mhd_rkupdt);
-    id.mhd_sende = tl["stagen"]->AddTask(&mhd::MHD::SendE, pmhd, id.mhd_efld);
-    id.mhd_recve = tl["stagen"]->AddTask(&mhd::MHD::RecvE, pmhd, id.mhd_sende);
-    id.mhd_ct    = tl["stagen"]->AddTask(&mhd::MHD::CT, pmhd, id.mhd_recve);
+    id.copyu     = tl["stagen"]->AddTask(&Radiation::CopyCons, this, none,
+                                         "Rad_CopyCons");
+    id.rad_flux  = tl["stagen"]->AddTask(&Radiation::CalculateFluxes, this, id.copyu,
+                                         "Rad_CalculateFluxes");
+    id.rad_sendf = tl["stagen"]->AddTask(&Radiation::SendFlux, this, id.rad_flux,
+                                         "Rad_SendFlux");
+    id.rad_recvf = tl["stagen"]->AddTask(&Radiation::RecvFlux, this, id.rad_sendf,
+                                         "Rad_RecvFlux");
+    id.rad_rkupdt= tl["stagen"]->AddTask(&Radiation::RKUpdate, this, id.rad_recvf,
+                                         "Rad_RKUpdate");
+    id.mhd_flux  = tl["stagen"]->AddTask(&mhd::MHD::Fluxes, pmhd, id.rad_rkupdt,
+                                         "MHD_Fluxes");
+    id.mhd_sendf = tl["stagen"]->AddTask(&mhd::MHD::SendFlux, pmhd, id.mhd_flux,
+                                         "MHD_SendFlux");
+    id.mhd_recvf = tl["stagen"]->AddTask(&mhd::MHD::RecvFlux, pmhd, id.mhd_sendf,
+                                         "MHD_RecvFlux");
+    id.mhd_rkupdt= tl["stagen"]->AddTask(&mhd::MHD::RKUpdate, pmhd, id.mhd_recvf,
+                                         "MHD_RKUpdate");
+    id.mhd_efld  = tl["stagen"]->AddTask(&mhd::MHD::CornerE, pmhd, id.mhd_rkupdt,
+                                         "MHD_CornerE");
+    id.mhd_sende = tl["stagen"]->AddTask(&mhd::MHD::SendE, pmhd, id.mhd_efld,
+                                         "MHD_SendE");
+    id.mhd_recve = tl["stagen"]->AddTask(&mhd::MHD::RecvE, pmhd, id.mhd_sende,
+                                         "MHD_RecvE");
+    id.mhd_ct    = tl["stagen"]->AddTask(&mhd::MHD::CT, pmhd, id.mhd_recve, "MHD_CT");
     id.rad_src   = tl["stagen"]->AddTask(
-                                    &Radiation::AddRadiationSourceTerm,this,id.mhd_ct);
-    id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src);
-    id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
-    id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi);
-    id.mhd_restu = tl["stagen"]->AddTask(&mhd::MHD::RestrictU, pmhd, id.rad_recvi);
-    id.mhd_sendu = tl["stagen"]->AddTask(&mhd::MHD::SendU, pmhd, id.mhd_restu);
-    id.mhd_recvu = tl["stagen"]->AddTask(&mhd::MHD::RecvU, pmhd, id.mhd_sendu);
-    id.mhd_restb = tl["stagen"]->AddTask(&mhd::MHD::RestrictB, pmhd, id.mhd_recvu);
-    id.mhd_sendb = tl["stagen"]->AddTask(&mhd::MHD::SendB, pmhd, id.mhd_restb);
-    id.mhd_recvb = tl["stagen"]->AddTask(&mhd::MHD::RecvB, pmhd, id.mhd_sendb);
+                                    &Radiation::AddRadiationSourceTerm, this, id.mhd_ct,
+                                    "Rad_SourceTerm");
+    id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src,
+                                         "Rad_RestrictI");
+    id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti,
+                                         "Rad_SendI");
+    id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi,
+                                         "Rad_RecvI");
+    id.mhd_restu = tl["stagen"]->AddTask(&mhd::MHD::RestrictU, pmhd, id.rad_recvi,
+                                         "MHD_RestrictU");
+    id.mhd_sendu = tl["stagen"]->AddTask(&mhd::MHD::SendU, pmhd, id.mhd_restu,
+                                         "MHD_SendU");
+    id.mhd_recvu = tl["stagen"]->AddTask(&mhd::MHD::RecvU, pmhd, id.mhd_sendu,
+                                         "MHD_RecvU");
+    id.mhd_restb = tl["stagen"]->AddTask(&mhd::MHD::RestrictB, pmhd, id.mhd_recvu,
+                                         "MHD_RestrictB");
+    id.mhd_sendb = tl["stagen"]->AddTask(&mhd::MHD::SendB, pmhd, id.mhd_restb,
+                                         "MHD_SendB");
+    id.mhd_recvb = tl["stagen"]->AddTask(&mhd::MHD::RecvB, pmhd, id.mhd_sendb,
+                                         "MHD_RecvB");
     id.bcs       = tl["stagen"]->AddTask(
-                                    &Radiation::ApplyPhysicalBCs, this, id.mhd_recvb);
-    id.rad_prol  = tl["stagen"]->AddTask(&Radiation::Prolongate, this, id.bcs);
-    id.mhd_prol  = tl["stagen"]->AddTask(&mhd::MHD::Prolongate, pmhd, id.rad_prol);
-    id.mhd_c2p   = tl["stagen"]->AddTask(&mhd::MHD::ConToPrim, pmhd, id.mhd_prol);
+                                    &Radiation::ApplyPhysicalBCs, this, id.mhd_recvb,
+                                    "Rad_ApplyPhysicalBCs");
+    id.rad_prol  = tl["stagen"]->AddTask(&Radiation::Prolongate, this, id.bcs,
+                                         "Rad_Prolongate");
+    id.mhd_prol  = tl["stagen"]->AddTask(&mhd::MHD::Prolongate, pmhd, id.rad_prol,
+                                         "MHD_Prolongate");
+    id.mhd_c2p   = tl["stagen"]->AddTask(&mhd::MHD::ConToPrim, pmhd, id.mhd_prol,
+                                         "MHD_ConToPrim");
 
     // assemble "after_stagen" task list
-    id.rad_csend = tl["after_stagen"]->AddTask(&Radiation::ClearSend, this, none);
-    id.mhd_csend = tl["after_stagen"]->AddTask(&mhd::MHD::ClearSend, pmhd, none);
+    id.rad_csend = tl["after_stagen"]->AddTask(&Radiation::ClearSend, this, none,
+                                               "Rad_ClearSend");
+    id.mhd_csend = tl["after_stagen"]->AddTask(&mhd::MHD::ClearSend, pmhd, none,
+                                               "MHD_ClearSend");
     // although RecvFlux/U/E/B functions check that all recvs complete, add ClearRecv to
     // task list anyways to catch potential bugs in MPI communication logic
-    id.rad_crecv = tl["after_stagen"]->AddTask(&Radiation::ClearRecv, this, id.rad_csend);
+    id.rad_crecv = tl["after_stagen"]->AddTask(&Radiation::ClearRecv, this, id.rad_csend,
+                                               "Rad_ClearRecv");
     id.mhd_crecv = tl["after_stagen"]->AddTask(
-                                          &mhd::MHD::ClearRecv, pmhd, id.mhd_csend);
+                                          &mhd::MHD::ClearRecv, pmhd, id.mhd_csend,
+                                          "MHD_ClearRecv");
 
   } else if (phyd != nullptr && !(fixed_fluid)) {  // radiation hydrodynamics
     // assemble "before_stagen" task list
-    id.rad_irecv = tl["before_stagen"]->AddTask(&Radiation::InitRecv, this, none);
-    id.hyd_irecv = tl["before_stagen"]->AddTask(&hydro::Hydro::InitRecv, phyd, none);
+    id.rad_irecv = tl["before_stagen"]->AddTask(&Radiation::InitRecv, this, none,
+                                                "Rad_InitRecv");
+    id.hyd_irecv = tl["before_stagen"]->AddTask(&hydro::Hydro::InitRecv, phyd, none,
+                                                "Hydro_InitRecv");
 
     // assemble "stagen" task list
-    id.copyu     = tl["stagen"]->AddTask(&Radiation::CopyCons, this, none);
-    id.rad_flux  = tl["stagen"]->AddTask(&Radiation::CalculateFluxes, this, id.copyu);
-    id.rad_sendf = tl["stagen"]->AddTask(&Radiation::SendFlux, this, id.rad_flux);
-    id.rad_recvf = tl["stagen"]->AddTask(&Radiation::RecvFlux, this, id.rad_sendf);
-    id.rad_rkupdt= tl["stagen"]->AddTask(&Radiation::RKUpdate, this, id.rad_recvf);
-    id.hyd_flux  = tl["stagen"]->AddTask(&hydro::Hydro::Fluxes, phyd, id.rad_rkupdt);
-    id.hyd_sendf = tl["stagen"]->AddTask(&hydro::Hydro::SendFlux, phyd, id.hyd_flux);
-    id.hyd_recvf = tl["stagen"]->AddTask(&hydro::Hydro::RecvFlux, phyd, id.hyd_sendf);
-    id.hyd_rkupdt= tl["stagen"]->AddTask(&hydro::Hydro::RKUpdate,phyd,id.hyd_recvf);
+    id.copyu     = tl["stagen"]->AddTask(&Radiation::CopyCons, this, none,
+                                         "Rad_CopyCons");
+    id.rad_flux  = tl["stagen"]->AddTask(&Radiation::CalculateFluxes, this, id.copyu,
+                                         "Rad_CalculateFluxes");
+    id.rad_sendf = tl["stagen"]->AddTask(&Radiation::SendFlux, this, id.rad_flux,
+                                         "Rad_SendFlux");
+    id.rad_recvf = tl["stagen"]->AddTask(&Radiation::RecvFlux, this, id.rad_sendf,
+                                         "Rad_RecvFlux");
+    id.rad_rkupdt= tl["stagen"]->AddTask(&Radiation::RKUpdate, this, id.rad_recvf,
+                                         "Rad_RKUpdate");
+    id.hyd_flux  = tl["stagen"]->AddTask(&hydro::Hydro::Fluxes, phyd, id.rad_rkupdt,
+                                         "Hydro_Fluxes");
+    id.hyd_sendf = tl["stagen"]->AddTask(&hydro::Hydro::SendFlux, phyd, id.hyd_flux,
+                                         "Hydro_SendFlux");
+    id.hyd_recvf = tl["stagen"]->AddTask(&hydro::Hydro::RecvFlux, phyd, id.hyd_sendf,
+                                         "Hydro_RecvFlux");
+    id.hyd_rkupdt= tl["stagen"]->AddTask(&hydro::Hydro::RKUpdate, phyd, id.hyd_recvf,
+                                         "Hydro_RKUpdate");
     id.rad_src   = tl["stagen"]->AddTask(
-                                   &Radiation::AddRadiationSourceTerm,this,id.hyd_rkupdt);
-    id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src);
-    id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
-    id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi);
-    id.hyd_restu = tl["stagen"]->AddTask(&hydro::Hydro::RestrictU, phyd, id.rad_recvi);
-    id.hyd_sendu = tl["stagen"]->AddTask(&hydro::Hydro::SendU, phyd, id.hyd_restu);
-    id.hyd_recvu = tl["stagen"]->AddTask(&hydro::Hydro::RecvU, phyd, id.hyd_sendu);
+                                   &Radiation::AddRadiationSourceTerm, this,
+                                   id.hyd_rkupdt, "Rad_SourceTerm");
+    id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src,
+                                         "Rad_RestrictI");
+    id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti,
+                                         "Rad_SendI");
+    id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi,
+                                         "Rad_RecvI");
+    id.hyd_restu = tl["stagen"]->AddTask(&hydro::Hydro::RestrictU, phyd, id.rad_recvi,
+                                         "Hydro_RestrictU");
+    id.hyd_sendu = tl["stagen"]->AddTask(&hydro::Hydro::SendU, phyd, id.hyd_restu,
+                                         "Hydro_SendU");
+    id.hyd_recvu = tl["stagen"]->AddTask(&hydro::Hydro::RecvU, phyd, id.hyd_sendu,
+                                         "Hydro_RecvU");
     id.bcs       = tl["stagen"]->AddTask(
-                                    &Radiation::ApplyPhysicalBCs, this, id.hyd_recvu);
-    id.rad_prol  = tl["stagen"]->AddTask(&Radiation::Prolongate, this, id.bcs);
-    id.hyd_prol  = tl["stagen"]->AddTask(&hydro::Hydro::Prolongate, phyd, id.rad_prol);
-    id.hyd_c2p   = tl["stagen"]->AddTask(&hydro::Hydro::ConToPrim, phyd, id.hyd_prol);
+                                    &Radiation::ApplyPhysicalBCs, this, id.hyd_recvu,
+                                    "Rad_ApplyPhysicalBCs");
+    id.rad_prol  = tl["stagen"]->AddTask(&Radiation::Prolongate, this, id.bcs,
+                                         "Rad_Prolongate");
+    id.hyd_prol  = tl["stagen"]->AddTask(&hydro::Hydro::Prolongate, phyd, id.rad_prol,
+                                         "Hydro_Prolongate");
+    id.hyd_c2p   = tl["stagen"]->AddTask(&hydro::Hydro::ConToPrim, phyd, id.hyd_prol,
+                                         "Hydro_ConToPrim");
 
     // assemble "after_stagen" task list
     // assemble end task list
-    id.rad_csend = tl["after_stagen"]->AddTask(&Radiation::ClearSend, this, none);
-    id.hyd_csend = tl["after_stagen"]->AddTask(&hydro::Hydro::ClearSend, phyd, none);
+    id.rad_csend = tl["after_stagen"]->AddTask(&Radiation::ClearSend, this, none,
+                                               "Rad_ClearSend");
+    id.hyd_csend = tl["after_stagen"]->AddTask(&hydro::Hydro::ClearSend, phyd, none,
+                                               "Hydro_ClearSend");
     // although RecvFlux/U/E/B functions check that all recvs complete, add ClearRecv to
     // task list anyways to catch potential bugs in MPI communication logic
-    id.rad_crecv = tl["after_stagen"]->AddTask(&Radiation::ClearRecv, this, id.rad_csend);
+    id.rad_crecv = tl["after_stagen"]->AddTask(&Radiation::ClearRecv, this, id.rad_csend,
+                                               "Rad_ClearRecv");
     id.hyd_crecv = tl["after_stagen"]->AddTask(
-                                       &hydro::Hydro::ClearRecv, phyd, id.hyd_csend);
+                                       &hydro::Hydro::ClearRecv, phyd, id.hyd_csend,
+                                       "Hydro_ClearRecv");
 
   } else {  // radiation transport
     // assemble "before_stagen" task list
-    id.rad_irecv = tl["before_stagen"]->AddTask(&Radiation::InitRecv, this, none);
+    id.rad_irecv = tl["before_stagen"]->AddTask(&Radiation::InitRecv, this, none,
+                                                "Rad_InitRecv");
 
     // assemble "stagen" task list
-    id.copyu     = tl["stagen"]->AddTask(&Radiation::CopyCons, this, none);
-    id.rad_flux  = tl["stagen"]->AddTask(&Radiation::CalculateFluxes, this, id.copyu);
-    id.rad_sendf = tl["stagen"]->AddTask(&Radiation::SendFlux, this, id.rad_flux);
-    id.rad_recvf = tl["stagen"]->AddTask(&Radiation::RecvFlux, this, id.rad_sendf);
-    id.rad_rkupdt= tl["stagen"]->AddTask(&Radiation::RKUpdate, this, id.rad_recvf);
+    id.copyu     = tl["stagen"]->AddTask(&Radiation::CopyCons, this, none,
+                                         "Rad_CopyCons");
+    id.rad_flux  = tl["stagen"]->AddTask(&Radiation::CalculateFluxes, this, id.copyu,
+                                         "Rad_CalculateFluxes");
+    id.rad_sendf = tl["stagen"]->AddTask(&Radiation::SendFlux, this, id.rad_flux,
+                                         "Rad_SendFlux");
+    id.rad_recvf = tl["stagen"]->AddTask(&Radiation::RecvFlux, this, id.rad_sendf,
+                                         "Rad_RecvFlux");
+    id.rad_rkupdt= tl["stagen"]->AddTask(&Radiation::RKUpdate, this, id.rad_recvf,
+                                         "Rad_RKUpdate");
     id.rad_src   = tl["stagen"]->AddTask(
-                                   &Radiation::AddRadiationSourceTerm,this,id.rad_rkupdt);
-    id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src);
-    id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
-    id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi);
+                                   &Radiation::AddRadiationSourceTerm, this,
+                                   id.rad_rkupdt, "Rad_SourceTerm");
+    id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src,
+                                         "Rad_RestrictI");
+    id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti,
+                                         "Rad_SendI");
+    id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi,
+                                         "Rad_RecvI");
     id.bcs       = tl["stagen"]->AddTask(
-                                    &Radiation::ApplyPhysicalBCs, this, id.rad_recvi);
-    id.rad_prol  = tl["stagen"]->AddTask(&Radiation::Prolongate, this, id.bcs);
+                                    &Radiation::ApplyPhysicalBCs, this, id.rad_recvi,
+                                    "Rad_ApplyPhysicalBCs");
+    id.rad_prol  = tl["stagen"]->AddTask(&Radiation::Prolongate, this, id.bcs,
+                                         "Rad_Prolongate");
 
     // assemble "after_stagen" task list
-    id.rad_csend = tl["after_stagen"]->AddTask(&Radiation::ClearSend, this, none);
+    id.rad_csend = tl["after_stagen"]->AddTask(&Radiation::ClearSend, this, none,
+                                               "Rad_ClearSend");
     // although RecvFlux/U/E/B functions check that all recvs complete, add ClearRecv to
     // task list anyways to catch potential bugs in MPI communication logic
-    id.rad_crecv = tl["after_stagen"]->AddTask(&Radiation::ClearRecv, this, id.rad_csend);
+    id.rad_crecv = tl["after_stagen"]->AddTask(&Radiation::ClearRecv, this, id.rad_csend,
+                                               "Rad_ClearRecv");
   }
 
   return;
@@ -175,8 +175,32 @@ void Radiation::SetOrthonormalTetrad() {
     for (int d=0; d<4; ++d) { tet_d3_x3f_(m,d,k,j,i) = e[d][3]; }
   });
 
-  // Calculate n^angle
-  if (angular_fluxes) {
+  // Calculate n^angle (or, with compact_tetrad, the coefficients needed to compute it)
+  if (angular_fluxes && compact_tetrad) {
+    auto tet_omega_ = tet_omega;
+    par_for("tet_omega",DevExeSpace(),0,(nmb-1),0,(n3-1),0,(n2-1),0,(n1-1),
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      Real &x1min = size.d_view(m).x1min;
+      Real &x1max = size.d_view(m).x1max;
+      Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+
+      Real &x2min = size.d_view(m).x2min;
+      Real &x2max = size.d_view(m).x2max;
+      Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+
+      Real &x3min = size.d_view(m).x3min;
+      Real &x3max = size.d_view(m).x3max;
+      Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+
+      Real glower[4][4], gupper[4][4];
+      ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+      Real dgx[4][4], dgy[4][4], dgz[4][4];
+      ComputeMetricDerivatives(x1v,x2v,x3v,flat,spin,dgx,dgy,dgz);
+      Real e[4][4], e_cov[4][4], omega[4][4][4];
+      ComputeTetrad(x1v,x2v,x3v,flat,spin,glower,gupper,dgx,dgy,dgz,e,e_cov,omega);
+      StoreCompactOmega(omega, tet_omega_, m, k, j, i);
+    });
+  } else if (angular_fluxes) {
     auto uflux = prgeo->unit_flux;
     auto nh_f_ = nh_f;
     auto na_ = na;
@@ -180,4 +180,49 @@ void ComputeTetrad(Real x, Real y, Real z, const bool minkowski, const Real a,
   return;
 }
 
+// stores parts of Ricci rotation coefficients omega[a][q][p] symmetric in (q,p), which
+// are all that is needed to compute n^a.  Used with <radiation>/compact_tetrad=true in
+// place of storing n^a for every angle.  Components are packed as 10*a + (q,p) for p>=q.
+KOKKOS_INLINE_FUNCTION
+void StoreCompactOmega(const Real omega[][4][4], const DvceArray5D<Real> &w,
+                       const int m, const int k, const int j, const int i) {
+  for (int a=0; a<4; ++a) {
+    int c = 10*a;
+    for (int q=0; q<4; ++q) {
+      w(m,c,k,j,i) = omega[a][q][q];
+      ++c;
+      for (int p=q+1; p<4; ++p) {
+        w(m,c,k,j,i) = omega[a][q][p] + omega[a][p][q];
+        ++c;
+      }
+    }
+  }
+  return;
+}
+
+// computes n^a at edge nb of angle n from compact rotation coefficients, equivalent to
+// the calculation of n^a in SetOrthonormalTetrad()
+KOKKOS_INLINE_FUNCTION
+Real CompactNA(const DvceArray5D<Real> &w, const DualArray3D<Real> &nh_f,
+               const DualArray3D<Real> &uflux, const int m, const int n, const int nb,
+               const int k, const int j, const int i) {
+  Real nf[4];
+  for (int q=0; q<4; ++q) { nf[q] = nh_f.d_view(n,nb,q); }
+  Real quad[4];
+  for (int a=0; a<4; ++a) {
+    int c = 10*a;
+    quad[a] = 0.0;
+    for (int q=0; q<4; ++q) {
+      for (int p=q; p<4; ++p) {
+        quad[a] += nf[q]*nf[p]*w(m,c,k,j,i);
+        ++c;
+      }
+    }
+  }
+  Real iszetaf = 1.0/sqrt(1.0 - SQR(nf[3]));
+  Real na1 = nf[0]*quad[3] - nf[3]*quad[0];
+  Real na2 = nf[2]*quad[1] - nf[1]*quad[2];
+  return iszetaf*na1*uflux.d_view(n,nb,0) + na2*uflux.d_view(n,nb,1);
+}
+
 #endif // RADIATION_RADIATION_TETRAD_HPP_
@@ -42,6 +42,13 @@ TaskStatus Radiation::RKUpdate(Driver *pdriver, int stage) {
   Real &gam1 = pdriver->gam1[stage-1];
   Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
 
+  // with <radiation>/fused=true, fluxes are computed and differenced by FusedUpdate()
+  if (use_fused) {
+    FusedUpdate(pdriver, stage);
+    if (psrc->beam)  psrc->BeamSource(i0, beta_dt);
+    return TaskStatus::complete;
+  }
+
   auto &i0_ = i0;
   auto &i1_ = i1;
   auto &flx1 = iflx.x1f;
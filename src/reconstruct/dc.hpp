@@ -7,6 +7,7 @@
 //========================================================================================
 //! \file dc.hpp
 //! \brief piecewise constant (donor cell) reconstruction implemented as inline functions
+//! The X1/X2/X3 wrappers reconstruct the first nq variables of q (all if nq=0).
 
 #include "athena.hpp"
 
@@ -16,11 +17,13 @@
 //! Therefore range of indices for which BOTH L/R states returned is il+1 to il-1
 //! This function should be called over [is-1,ie+1] to get BOTH L/R states over [is,ie]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void DonorCellX1(TeamMember_t const &member, const int m, const int k, const int j,
      const int il, const int iu, const DvceArray5D<Real> &q,
-     ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
-  int nvar = q.extent_int(1);
+     ScrArray2D<T> &ql, ScrArray2D<T> &qr,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
   for (int n=0; n<nvar; ++n) {
     par_for_inner(member, il, iu, [&](const int i) {
       ql(n,i+1) = q(m,n,k,j,i);
@@ -35,11 +38,13 @@ void DonorCellX1(TeamMember_t const &member, const int m, const int k, const int
 //! \brief For each cell-centered value q(j), returns ql(j+1) and qr(j) over il to iu.
 //! This function should be called over [js-1,je+1] to get BOTH L/R states over [js,je]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void DonorCellX2(TeamMember_t const &member, const int m, const int k, const int j,
      const int il, const int iu, const DvceArray5D<Real> &q,
-     ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
-  int nvar = q.extent_int(1);
+     ScrArray2D<T> &ql_jp1, ScrArray2D<T> &qr_j,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
   for (int n=0; n<nvar; ++n) {
     par_for_inner(member, il, iu, [&](const int i) {
       ql_jp1(n,i) = q(m,n,k,j,i);
@@ -54,11 +59,13 @@ void DonorCellX2(TeamMember_t const &member, const int m, const int k, const int
 //! \brief For each cell-centered value q(k), returns ql(k+1) and qr(k) over il to iu.
 //! This function should be called over [ks-1,ke+1] to get BOTH L/R states over [ks,ke]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void DonorCellX3(TeamMember_t const &member, const int m, const int k, const int j,
      const int il, const int iu, const DvceArray5D<Real> &q,
-     ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
-  int nvar = q.extent_int(1);
+     ScrArray2D<T> &ql_kp1, ScrArray2D<T> &qr_k,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
   for (int n=0; n<nvar; ++n) {
     par_for_inner(member, il, iu, [&](const int i) {
       ql_kp1(n,i) = q(m,n,k,j,i);
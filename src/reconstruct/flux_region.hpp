@@ -0,0 +1,77 @@
+#ifndef RECONSTRUCT_FLUX_REGION_HPP_
+#define RECONSTRUCT_FLUX_REGION_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file flux_region.hpp
+//! \brief Ranges of cell faces over which fluxes are computed when the flux calculation
+//! is split into a pass over interior faces (whose reconstruction stencil lies entirely
+//! in the active zone, so they can be computed before ghost zones are received) and a
+//! pass over the remaining boundary faces (computed after ghost zones are received).
+
+#include <algorithm>
+#include "athena.hpp"
+
+// constants that specify which faces are computed in CalculateFluxes()
+enum class FluxRegion {all, interior, boundary};
+
+//----------------------------------------------------------------------------------------
+//! \struct FaceRanges
+//! \brief up to four ranges of faces [fl,fu] along the flux direction, each over cells
+//! [tl,tu] in the transverse direction stored in scratch arrays (x1 in the x2/x3 fluxes).
+//! Passed by value into kernels.
+
+struct FaceRanges {
+  int n = 0;
+  int fl[4], fu[4];
+  int tl[4], tu[4];
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn int FluxStencilWidth()
+//! \brief Returns nb such that faces more than nb-1 faces away from the first/last face
+//! of the active zone along the flux direction only depend on active cells.
+
+inline int FluxStencilWidth(ReconstructionMethod recon) {
+  if (recon == ReconstructionMethod::dc) {return 1;}
+  if (recon == ReconstructionMethod::plm) {return 2;}
+  return 3;  // PPM and WENOZ use two cells on each side
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn FaceRanges FluxFaceRanges()
+//! \brief Returns the ranges of faces in region for one line (x1-fluxes) or plane
+//! (x2/x3-fluxes) of the flux calculation.  Faces [fl,fu] over transverse cells [tl,tu]
+//! are those computed with FluxRegion::all, and [s,e] and [ts,te] are the corresponding
+//! active cells.  If tghost=true the line/plane lies in the ghost zones of the outer
+//! transverse direction, so all its faces are boundary faces.  Pass tl=tu=ts=te=0 for
+//! fluxes with no transverse direction stored in scratch (x1-fluxes).
+
+inline FaceRanges FluxFaceRanges(FluxRegion region, int nb, bool tghost, int fl, int fu,
+                                 int s, int e, int tl, int tu, int ts, int te) {
+  FaceRanges r;
+  auto add = [&r](int a, int b, int c, int d) {
+    r.fl[r.n] = a; r.fu[r.n] = b; r.tl[r.n] = c; r.tu[r.n] = d; r.n++;
+  };
+  int ifl = s + nb, ifu = e + 1 - nb;   // interior faces
+  bool interior = (ifl <= ifu) && !(tghost);
+
+  if (region == FluxRegion::all) {
+    add(fl, fu, tl, tu);
+  } else if (region == FluxRegion::interior) {
+    if (interior) {add(ifl, ifu, std::max(tl,ts), std::min(tu,te));}
+  } else if (!(interior)) {
+    add(fl, fu, tl, tu);
+  } else {
+    add(fl, ifl-1, tl, tu);
+    add(ifu+1, fu, tl, tu);
+    // interior faces over transverse ghost cells
+    if (tl < ts) {add(ifl, ifu, tl, ts-1);}
+    if (tu > te) {add(ifl, ifu, te+1, tu);}
+  }
+  return r;
+}
+
+#endif // RECONSTRUCT_FLUX_REGION_HPP_
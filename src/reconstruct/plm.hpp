@@ -8,18 +8,24 @@
 //! \file plm.hpp
 //! \brief  piecewise linear reconstruction implemented as inline functions
 //! This version only works with uniform mesh spacing
+//! The X1/X2/X3 wrappers reconstruct the first nq variables of q (all if nq=0).
 
 #include <math.h>
+#include <type_traits>
 #include "athena.hpp"
+#if SIMD_RECON_ENABLED
+#include "reconstruct/simd_recon.hpp"
+#endif
 
 //----------------------------------------------------------------------------------------
 //! \fn PLM()
 //! \brief Reconstructs linear slope in cell i to compute ql(i+1) and qr(i). Works for
 //! reconstruction in any dimension by passing in the appropriate q_im1, q_i, and q_ip1.
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void PLM(const Real &q_im1, const Real &q_i, const Real &q_ip1,
-         Real &ql_ip1, Real &qr_i) {
+         T &ql_ip1, T &qr_i) {
   // compute L/R slopes
   Real dql = (q_i - q_im1);
   Real dqr = (q_ip1 - q_i);
@@ -36,16 +42,50 @@ void PLM(const Real &q_im1, const Real &q_i, const Real &q_ip1,
   return;
 }
 
+#if SIMD_RECON_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn PLMPencil()
+//! \brief SIMD version of PLM() over a pencil of len cells (see simd_recon.hpp)
+
+KOKKOS_INLINE_FUNCTION
+void PLMPencil(TeamMember_t const &member, const int len, const Real *q_im1,
+               const Real *q_i, const Real *q_ip1, Real *ql_ip1, Real *qr_i) {
+  using simd_recon::Load;
+  using simd_recon::Store;
+  simd_recon::PencilLoop(member, len,
+  [&](const int s) {
+    simd_recon::simd_t ql, qr;
+    simd_recon::PLM(Load(q_im1+s), Load(q_i+s), Load(q_ip1+s), ql, qr);
+    Store(ql, ql_ip1+s);
+    Store(qr, qr_i+s);
+  },
+  [&](const int s) {
+    PLM(q_im1[s], q_i[s], q_ip1[s], ql_ip1[s], qr_i[s]);
+  });
+}
+#endif
+
 //----------------------------------------------------------------------------------------
 //! \fn PiecewiseLinearX1()
 //! \brief Wrapper function for PLM reconstruction in x1-direction.
 //! This function should be called over [is-1,ie+1] to get BOTH L/R states over [is,ie]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseLinearX1(TeamMember_t const &member, const int m, const int k, const int j,
      const int il, const int iu, const DvceArray5D<Real> &q,
-     ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
-  int nvar = q.extent_int(1);
+     ScrArray2D<T> &ql, ScrArray2D<T> &qr,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
+#if SIMD_RECON_ENABLED
+  if constexpr (std::is_same_v<T, Real>) {
+    for (int n=0; n<nvar; ++n) {
+      PLMPencil(member, iu-il+1, &q(m,n,k,j,il-1), &q(m,n,k,j,il), &q(m,n,k,j,il+1),
+                &ql(n,il+1), &qr(n,il));
+    }
+    return;
+  }
+#endif
   for (int n=0; n<nvar; ++n) {
     par_for_inner(member, il, iu, [&](const int i) {
       PLM(q(m,n,k,j,i-1), q(m,n,k,j,i), q(m,n,k,j,i+1), ql(n,i+1), qr(n,i));
@@ -59,11 +99,22 @@ void PiecewiseLinearX1(TeamMember_t const &member, const int m, const int k, con
 //! \brief Wrapper function for PLM reconstruction in x2-direction.
 //! This function should be called over [js-1,je+1] to get BOTH L/R states over [js,je]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseLinearX2(TeamMember_t const &member, const int m, const int k, const int j,
      const int il, const int iu, const DvceArray5D<Real> &q,
-     ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
-  int nvar = q.extent_int(1);
+     ScrArray2D<T> &ql_jp1, ScrArray2D<T> &qr_j,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
+#if SIMD_RECON_ENABLED
+  if constexpr (std::is_same_v<T, Real>) {
+    for (int n=0; n<nvar; ++n) {
+      PLMPencil(member, iu-il+1, &q(m,n,k,j-1,il), &q(m,n,k,j,il), &q(m,n,k,j+1,il),
+                &ql_jp1(n,il), &qr_j(n,il));
+    }
+    return;
+  }
+#endif
   for (int n=0; n<nvar; ++n) {
     par_for_inner(member, il, iu, [&](const int i) {
       PLM(q(m,n,k,j-1,i), q(m,n,k,j,i), q(m,n,k,j+1,i), ql_jp1(n,i), qr_j(n,i));
@@ -77,11 +128,22 @@ void PiecewiseLinearX2(TeamMember_t const &member, const int m, const int k, con
 //! \brief Wrapper function for PLM reconstruction in x3-direction.
 //! This function should be called over [ks-1,ke+1] to get BOTH L/R states over [ks,ke]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseLinearX3(TeamMember_t const &member, const int m, const int k, const int j,
      const int il, const int iu, const DvceArray5D<Real> &q,
-     ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
-  int nvar = q.extent_int(1);
+     ScrArray2D<T> &ql_kp1, ScrArray2D<T> &qr_k,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
+#if SIMD_RECON_ENABLED
+  if constexpr (std::is_same_v<T, Real>) {
+    for (int n=0; n<nvar; ++n) {
+      PLMPencil(member, iu-il+1, &q(m,n,k-1,j,il), &q(m,n,k,j,il), &q(m,n,k+1,j,il),
+                &ql_kp1(n,il), &qr_k(n,il));
+    }
+    return;
+  }
+#endif
   for (int n=0; n<nvar; ++n) {
     par_for_inner(member, il, iu, [&](const int i) {
       PLM(q(m,n,k-1,j,i), q(m,n,k,j,i), q(m,n,k+1,j,i), ql_kp1(n,i), qr_k(n,i));
@@ -10,6 +10,7 @@
 //! (implemented in the PPM4 inline function) and Collela-Sekora (CS) extremum preserving
 //! limiters (implemented in the PPMX inline function) for a Cartesian-like coordinates
 //! with uniform spacing.
+//! The X1/X2/X3 wrappers reconstruct the first nq variables of q (all if nq=0).
 //!
 //! This version does not include the extensions to the CS limiters described by
 //! McCorquodale et al. and as implemented in Athena++ by K. Felker.  This is to keep the
@@ -31,8 +32,12 @@
 
 #include <math.h>
 #include <algorithm>    // max()
+#include <type_traits>
 
 #include "athena.hpp"
+#if SIMD_RECON_ENABLED
+#include "reconstruct/simd_recon.hpp"
+#endif
 
 //----------------------------------------------------------------------------------------
 //! \fn PPM4()
@@ -40,9 +45,10 @@
 //! interpolated values at L/R edges of cell i, that is ql(i+1) and qr(i). Works for
 //! reconstruction in any dimension by passing in the appropriate q_im2,...,q _ip2.
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void PPM4(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_ip1,
-          const Real &q_ip2, Real &ql_ip1, Real &qr_i) {
+          const Real &q_ip2, T &ql_ip1, T &qr_i) {
   //---- Interpolate L/R values (CS eqn 16, PH 3.26 and 3.27) ----
   // qlv = q at left  side of cell-center = q[i-1/2] = a_{j,-} in CS
   // qrv = q at right side of cell-center = q[i+1/2] = a_{j,+} in CS
@@ -76,6 +82,31 @@ void PPM4(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_i
   return;
 }
 
+#if SIMD_RECON_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn PPM4Pencil()
+//! \brief SIMD version of PPM4() over a pencil of len cells (see simd_recon.hpp)
+
+KOKKOS_INLINE_FUNCTION
+void PPM4Pencil(TeamMember_t const &member, const int len, const Real *q_im2,
+                const Real *q_im1, const Real *q_i, const Real *q_ip1, const Real *q_ip2,
+                Real *ql_ip1, Real *qr_i) {
+  using simd_recon::Load;
+  using simd_recon::Store;
+  simd_recon::PencilLoop(member, len,
+  [&](const int s) {
+    simd_recon::simd_t ql, qr;
+    simd_recon::PPM4(Load(q_im2+s), Load(q_im1+s), Load(q_i+s), Load(q_ip1+s),
+                     Load(q_ip2+s), ql, qr);
+    Store(ql, ql_ip1+s);
+    Store(qr, qr_i+s);
+  },
+  [&](const int s) {
+    PPM4(q_im2[s], q_im1[s], q_i[s], q_ip1[s], q_ip2[s], ql_ip1[s], qr_i[s]);
+  });
+}
+#endif
+
 
 //----------------------------------------------------------------------------------------
 //! \fn PPMX()
@@ -83,9 +114,10 @@ void PPM4(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_i
 //! interpolated values at L/R edges of cell i, that is ql(i+1) and qr(i). Works for
 //! reconstruction in any dimension by passing in the appropriate q_im2,...,q _ip2.
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void PPMX(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_ip1,
-          const Real &q_ip2, Real &ql_ip1, Real &qr_i) {
+          const Real &q_ip2, T &ql_ip1, T &qr_i) {
   //---- Compute L/R values (CS eqns 12-15, PH 3.26 and 3.27) ----
   // qlv = q at left  side of cell-center = q[i-1/2] = a_{j,-} in CS
   // qrv = q at right side of cell-center = q[i+1/2] = a_{j,+} in CS
@@ -187,15 +219,17 @@ void PPMX(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_i
 //! \brief Wrapper function for PPM reconstruction in x1-direction.
 //! This function should be called over [is-1,ie+1] to get BOTH L/R states over [is,ie]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseParabolicX1(TeamMember_t const &member,
      const EOS_Data &eos, const bool extremum_preserving, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
-  int nvar = q.extent_int(1);
-  const Real &dfloor_ = eos.dfloor;
+     const DvceArray5D<Real> &q, ScrArray2D<T> &ql, ScrArray2D<T> &qr,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
+  const T dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
-  Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
+  const T efloor_ = eos.pfloor/(eos.gamma - 1.0);
   for (int n=0; n<nvar; ++n) {
     if (extremum_preserving) {
       par_for_inner(member, il, iu, [&](const int i) {
@@ -217,6 +251,13 @@ void PiecewiseParabolicX1(TeamMember_t const &member,
         }
       });
     } else {
+#if SIMD_RECON_ENABLED
+      if constexpr (std::is_same_v<T, Real>) {
+        PPM4Pencil(member, iu-il+1, &q(m,n,k,j,il-2), &q(m,n,k,j,il-1), &q(m,n,k,j,il),
+                   &q(m,n,k,j,il+1), &q(m,n,k,j,il+2), &ql(n,il+1), &qr(n,il));
+        continue;
+      }
+#endif
       par_for_inner(member, il, iu, [&](const int i) {
         Real &qim2 = q(m,n,k,j,i-2);
         Real &qim1 = q(m,n,k,j,i-1);
@@ -235,15 +276,17 @@ void PiecewiseParabolicX1(TeamMember_t const &member,
 //! \brief Wrapper function for PPM reconstruction in x2-direction.
 //! This function should be called over [js-1,je+1] to get BOTH L/R states over [js,je]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseParabolicX2(TeamMember_t const &member,
      const EOS_Data &eos, const bool extremum_preserving, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
-  int nvar = q.extent_int(1);
-  const Real &dfloor_ = eos.dfloor;
+     const DvceArray5D<Real> &q, ScrArray2D<T> &ql_jp1, ScrArray2D<T> &qr_j,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
+  const T dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
-  Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
+  const T efloor_ = eos.pfloor/(eos.gamma - 1.0);
   for (int n=0; n<nvar; ++n) {
     if (extremum_preserving) {
       par_for_inner(member, il, iu, [&](const int i) {
@@ -265,6 +308,13 @@ void PiecewiseParabolicX2(TeamMember_t const &member,
         }
       });
     } else {
+#if SIMD_RECON_ENABLED
+      if constexpr (std::is_same_v<T, Real>) {
+        PPM4Pencil(member, iu-il+1, &q(m,n,k,j-2,il), &q(m,n,k,j-1,il), &q(m,n,k,j,il),
+                   &q(m,n,k,j+1,il), &q(m,n,k,j+2,il), &ql_jp1(n,il), &qr_j(n,il));
+        continue;
+      }
+#endif
       par_for_inner(member, il, iu, [&](const int i) {
         Real &qjm2 = q(m,n,k,j-2,i);
         Real &qjm1 = q(m,n,k,j-1,i);
@@ -283,15 +333,17 @@ void PiecewiseParabolicX2(TeamMember_t const &member,
 //! \brief Wrapper function for PPM reconstruction in x3-direction.
 //! This function should be called over [ks-1,ke+1] to get BOTH L/R states over [ks,ke]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseParabolicX3(TeamMember_t const &member,
      const EOS_Data &eos, const bool extremum_preserving, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
-  int nvar = q.extent_int(1);
-  const Real &dfloor_ = eos.dfloor;
+     const DvceArray5D<Real> &q, ScrArray2D<T> &ql_kp1, ScrArray2D<T> &qr_k,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
+  const T dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
-  Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
+  const T efloor_ = eos.pfloor/(eos.gamma - 1.0);
   for (int n=0; n<nvar; ++n) {
     if (extremum_preserving) {
       par_for_inner(member, il, iu, [&](const int i) {
@@ -313,6 +365,13 @@ void PiecewiseParabolicX3(TeamMember_t const &member,
         }
       });
     } else {
+#if SIMD_RECON_ENABLED
+      if constexpr (std::is_same_v<T, Real>) {
+        PPM4Pencil(member, iu-il+1, &q(m,n,k-2,j,il), &q(m,n,k-1,j,il), &q(m,n,k,j,il),
+                   &q(m,n,k+1,j,il), &q(m,n,k+2,j,il), &ql_kp1(n,il), &qr_k(n,il));
+        continue;
+      }
+#endif
       par_for_inner(member, il, iu, [&](const int i) {
         Real &qkm2 = q(m,n,k-2,j,i);
         Real &qkm1 = q(m,n,k-1,j,i);
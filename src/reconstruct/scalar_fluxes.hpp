@@ -0,0 +1,114 @@
+#ifndef RECONSTRUCT_SCALAR_FLUXES_HPP_
+#define RECONSTRUCT_SCALAR_FLUXES_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file scalar_fluxes.hpp
+//! \brief Fluxes of passive scalars computed from the mass flux in a separate kernel.
+//!
+//! By default passive scalars are reconstructed along with the fluid variables in the
+//! Hydro/MHD flux kernels, with the same (possibly high-order) method.  With many scalars
+//! this dominates the cost of the fluxes.  With <hydro>/scalar_reconstruct (or <mhd>) set
+//! to dc or plm, the flux kernels only reconstruct the fluid variables, and the fluxes
+//! of all scalars are then computed here as the mass flux times the upwind state of each
+//! scalar, using donor cell or PLM reconstruction of only that upwind state.  There is
+//! one flat kernel per direction, with the loop over scalars inside so that the mass
+//! flux is loaded once per face.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "reconstruct/plm.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn Real UpwindPLM()
+//! \brief PLM reconstruction of the upwind state at face i-1/2, given the mass flux
+//! through the face and the scalar in cells i-2...i+1
+
+KOKKOS_INLINE_FUNCTION
+Real UpwindPLM(const Real mflx, const Real &qm2, const Real &qm1, const Real &q0,
+               const Real &qp1) {
+  Real q, dummy;
+  if (mflx >= 0.0) {
+    PLM(qm2, qm1, q0, q, dummy);
+  } else {
+    PLM(qm1, q0, qp1, dummy, q);
+  }
+  return q;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ScalarFluxes()
+//! \brief Computes fluxes of scalars nfluid...nfluid+nscalars-1 in flx from the mass
+//! flux flx(IDN) on the same faces as the Hydro/MHD flux kernels (including the extra
+//! faces used by FOFC), which must have computed flx(IDN) already.
+
+template <bool plm>
+void ScalarFluxes(MeshBlockPack *pmbp, const int nfluid, const int nscalars,
+                  const bool fofc, const DvceArray5D<Real> &w0,
+                  const DvceFaceFld5D<Real> &flx) {
+  auto &indcs = pmbp->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmbp->nmb_thispack - 1;
+  bool multi_d = pmbp->pmesh->multi_d;
+  bool three_d = pmbp->pmesh->three_d;
+  int nl = nfluid, nu = nfluid + nscalars - 1;
+  // cells added around active zone in transverse directions with FOFC
+  int tj = (fofc && multi_d)? 1 : 0;
+  int tk = (fofc && three_d)? 1 : 0;
+  int ti = (fofc)? 1 : 0;
+  auto &w = w0;
+
+  auto &flx1 = flx.x1f;
+  par_for("scalar_flx1", DevExeSpace(), 0, nmb1, ks-tk, ke+tk, js-tj, je+tj,
+          is-ti, ie+1+ti,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real mflx = flx1(m,IDN,k,j,i);
+    for (int n=nl; n<=nu; ++n) {
+      if constexpr (plm) {
+        flx1(m,n,k,j,i) = mflx*UpwindPLM(mflx, w(m,n,k,j,i-2), w(m,n,k,j,i-1),
+                                         w(m,n,k,j,i), w(m,n,k,j,i+1));
+      } else {
+        flx1(m,n,k,j,i) = mflx*((mflx >= 0.0)? w(m,n,k,j,i-1) : w(m,n,k,j,i));
+      }
+    }
+  });
+  if (!(multi_d)) {return;}
+
+  auto &flx2 = flx.x2f;
+  par_for("scalar_flx2", DevExeSpace(), 0, nmb1, ks-tk, ke+tk, js-tj, je+1+tj,
+          is-ti, ie+ti,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real mflx = flx2(m,IDN,k,j,i);
+    for (int n=nl; n<=nu; ++n) {
+      if constexpr (plm) {
+        flx2(m,n,k,j,i) = mflx*UpwindPLM(mflx, w(m,n,k,j-2,i), w(m,n,k,j-1,i),
+                                         w(m,n,k,j,i), w(m,n,k,j+1,i));
+      } else {
+        flx2(m,n,k,j,i) = mflx*((mflx >= 0.0)? w(m,n,k,j-1,i) : w(m,n,k,j,i));
+      }
+    }
+  });
+  if (!(three_d)) {return;}
+
+  auto &flx3 = flx.x3f;
+  par_for("scalar_flx3", DevExeSpace(), 0, nmb1, ks-tk, ke+1+tk, js-tj, je+tj,
+          is-ti, ie+ti,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real mflx = flx3(m,IDN,k,j,i);
+    for (int n=nl; n<=nu; ++n) {
+      if constexpr (plm) {
+        flx3(m,n,k,j,i) = mflx*UpwindPLM(mflx, w(m,n,k-2,j,i), w(m,n,k-1,j,i),
+                                         w(m,n,k,j,i), w(m,n,k+1,j,i));
+      } else {
+        flx3(m,n,k,j,i) = mflx*((mflx >= 0.0)? w(m,n,k-1,j,i) : w(m,n,k,j,i));
+      }
+    }
+  });
+  return;
+}
+
+#endif // RECONSTRUCT_SCALAR_FLUXES_HPP_
@@ -0,0 +1,166 @@
+#ifndef RECONSTRUCT_SIMD_RECON_HPP_
+#define RECONSTRUCT_SIMD_RECON_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file simd_recon.hpp
+//! \brief types and helper functions used by the explicitly vectorized (SIMD) versions of
+//! the reconstruction functions in plm.hpp, ppm.hpp and wenoz.hpp.  Only used by CPU
+//! builds configured with -D Athena_ENABLE_SIMD_RECON=ON.
+//!
+//! The SIMD functions process a contiguous pencil of cells along the x1-index (the
+//! fastest index in LayoutRight arrays) several cells at a time, using the native SIMD
+//! width of the host.  Reconstruction in x2 and x3 uses the neighboring pencils in those
+//! directions as the stencil.  Branches in the limiters are replaced by masked selects,
+//! and the order of operations is the same as in the scalar functions, so results agree
+//! with them to roundoff (differences can only arise from FMA contraction by the
+//! compiler).  Pointers passed to the functions address the first cell of the pencil;
+//! cells left over after the last complete vector are reconstructed with the scalar
+//! functions.
+
+#include <Kokkos_SIMD.hpp>
+#include <type_traits>
+
+#include "athena.hpp"
+
+static_assert(std::is_same_v<LayoutWrapper, Kokkos::LayoutRight>,
+              "SIMD reconstruction requires the x1-index to be contiguous");
+
+namespace simd_recon {
+
+using simd_t = Kokkos::Experimental::native_simd<Real>;
+using mask_t = typename simd_t::mask_type;
+constexpr int simd_width = static_cast<int>(simd_t::size());
+
+KOKKOS_FORCEINLINE_FUNCTION
+simd_t Load(const Real *p) {
+  simd_t v;
+  v.copy_from(p, Kokkos::Experimental::element_aligned_tag());
+  return v;
+}
+
+KOKKOS_FORCEINLINE_FUNCTION
+void Store(const simd_t &v, Real *p) {
+  v.copy_to(p, Kokkos::Experimental::element_aligned_tag());
+}
+
+// min/max/abs written with condition() so only the core simd API is required
+KOKKOS_FORCEINLINE_FUNCTION
+simd_t Max(const simd_t &a, const simd_t &b) {
+  return Kokkos::Experimental::condition(a < b, b, a);
+}
+
+KOKKOS_FORCEINLINE_FUNCTION
+simd_t Min(const simd_t &a, const simd_t &b) {
+  return Kokkos::Experimental::condition(b < a, b, a);
+}
+
+KOKKOS_FORCEINLINE_FUNCTION
+simd_t Abs(const simd_t &a) {
+  return Kokkos::Experimental::condition(a < simd_t(0.0), -a, a);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn PencilLoop()
+//! \brief Splits a pencil of len cells into complete SIMD vectors, which are distributed
+//! over the threads in the team and passed to vec_func(s) as the offset s of the first
+//! cell in the vector, followed by the remaining cells which are passed one at a time to
+//! scalar_func(s).  As with par_for_inner(), the caller must sync the team afterwards.
+
+template <typename VecFunction, typename ScalarFunction>
+KOKKOS_INLINE_FUNCTION
+void PencilLoop(TeamMember_t const &member, const int len, const VecFunction &vec_func,
+                const ScalarFunction &scalar_func) {
+  const int nvec = len/simd_width;
+  Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nvec), [&](const int v) {
+    vec_func(v*simd_width);
+  });
+  Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nvec*simd_width, len),
+                       scalar_func);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn PLM()
+//! \brief SIMD version of PLM() in plm.hpp
+
+KOKKOS_FORCEINLINE_FUNCTION
+void PLM(const simd_t &q_im1, const simd_t &q_i, const simd_t &q_ip1,
+         simd_t &ql_ip1, simd_t &qr_i) {
+  simd_t dql = q_i - q_im1;
+  simd_t dqr = q_ip1 - q_i;
+  simd_t dq2 = dql*dqr;
+  simd_t dqm = Kokkos::Experimental::condition(dq2 <= simd_t(0.0), simd_t(0.0),
+                                               dq2/(dql + dqr));
+  ql_ip1 = q_i + dqm;
+  qr_i   = q_i - dqm;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn PPM4()
+//! \brief SIMD version of PPM4() in ppm.hpp
+
+KOKKOS_FORCEINLINE_FUNCTION
+void PPM4(const simd_t &q_im2, const simd_t &q_im1, const simd_t &q_i,
+          const simd_t &q_ip1, const simd_t &q_ip2, simd_t &ql_ip1, simd_t &qr_i) {
+  const simd_t c7(7.0), c12(12.0), two(2.0);
+  simd_t qlv = (c7*(q_i + q_im1) - (q_im2 + q_ip1))/c12;
+  simd_t qrv = (c7*(q_i + q_ip1) - (q_im1 + q_ip2))/c12;
+
+  qlv = Max(qlv, Min(q_i, q_im1));
+  qlv = Min(qlv, Max(q_i, q_im1));
+  qrv = Max(qrv, Min(q_i, q_ip1));
+  qrv = Min(qrv, Max(q_i, q_ip1));
+
+  simd_t qc = qrv - q_i;
+  simd_t qd = qlv - q_i;
+  mask_t mono = (qc*qd >= simd_t(0.0));
+  qrv = Kokkos::Experimental::condition(Abs(qc) >= two*Abs(qd), q_i - two*qd, qrv);
+  qlv = Kokkos::Experimental::condition(Abs(qd) >= two*Abs(qc), q_i - two*qc, qlv);
+
+  ql_ip1 = Kokkos::Experimental::condition(mono, q_i, qrv);
+  qr_i   = Kokkos::Experimental::condition(mono, q_i, qlv);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn WENOZ()
+//! \brief SIMD version of WENOZ() in wenoz.hpp
+
+KOKKOS_FORCEINLINE_FUNCTION
+void WENOZ(const simd_t &q_im2, const simd_t &q_im1, const simd_t &q_i,
+           const simd_t &q_ip1, const simd_t &q_ip2, simd_t &ql_ip1, simd_t &qr_i) {
+  const simd_t b0(13./12.), b1(0.25), one(1.0), two(2.0), three(3.0), four(4.0);
+  const simd_t five(5.0), seven(7.0), eleven(11.0), six(6.0), epsL(1.0e-42);
+  const simd_t w0(0.1), w1(0.6), w2(0.3);
+
+  simd_t t0 = q_im2 + q_i - two*q_im1, t1 = q_im2 + three*q_i - four*q_im1;
+  simd_t beta0 = b0*(t0*t0) + b1*(t1*t1);
+  t0 = q_im1 + q_ip1 - two*q_i, t1 = q_im1 - q_ip1;
+  simd_t beta1 = b0*(t0*t0) + b1*(t1*t1);
+  t0 = q_ip2 + q_i - two*q_ip1, t1 = q_ip2 + three*q_i - four*q_ip1;
+  simd_t beta2 = b0*(t0*t0) + b1*(t1*t1);
+
+  simd_t tau_5 = Abs(beta0 - beta2);
+  simd_t ind0 = tau_5/(beta0 + epsL);
+  simd_t ind1 = tau_5/(beta1 + epsL);
+  simd_t ind2 = tau_5/(beta2 + epsL);
+
+  simd_t f0 = two*q_im2 - seven*q_im1 + eleven*q_i;
+  simd_t f1 = -q_im1 + five*q_i + two*q_ip1;
+  simd_t f2 = two*q_i + five*q_ip1 - q_ip2;
+  simd_t a0 = w0*(one + ind0*ind0);
+  simd_t a1 = w1*(one + ind1*ind1);
+  simd_t a2 = w2*(one + ind2*ind2);
+  ql_ip1 = (f0*a0 + f1*a1 + f2*a2)/(six*(a0 + a1 + a2));
+
+  f0 = two*q_ip2 - seven*q_ip1 + eleven*q_i;
+  f1 = -q_ip1 + five*q_i + two*q_im1;
+  f2 = two*q_i + five*q_im1 - q_im2;
+  a0 = w0*(one + ind2*ind2);
+  a2 = w2*(one + ind0*ind0);
+  qr_i = (f0*a0 + f1*a1 + f2*a2)/(six*(a0 + a1 + a2));
+}
+
+} // namespace simd_recon
+#endif // RECONSTRUCT_SIMD_RECON_HPP_
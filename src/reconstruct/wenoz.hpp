@@ -7,6 +7,7 @@
 //========================================================================================
 //! \file wenoz.hpp
 //! \brief WENO-Z reconstruction for a Cartesian-like coordinate with uniform spacing.
+//! The X1/X2/X3 wrappers reconstruct the first nq variables of q (all if nq=0).
 //!
 //! REFERENCES:
 //! Borges R., Carmona M., Costa B., Don W.S. , "An improved weighted essentially
@@ -14,17 +15,22 @@
 
 #include <math.h>
 #include <algorithm>    // max()
+#include <type_traits>
 
 #include "athena.hpp"
+#if SIMD_RECON_ENABLED
+#include "reconstruct/simd_recon.hpp"
+#endif
 
 //----------------------------------------------------------------------------------------
 //! \fn WENOZ()
 //! \brief Reconstructs 5th-order polynomial in cell i to compute ql(i+1) and qr(i).
 //! Works for any dimension by passing in the appropriate q_im2,...,q _ip2.
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void WENOZ(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_ip1,
-           const Real &q_ip2, Real &ql_ip1, Real &qr_i) noexcept  {
+           const Real &q_ip2, T &ql_ip1, T &qr_i) noexcept  {
   // Smooth WENO weights: Note that these are from Del Zanna et al. 2007 (A.18)
   const Real beta_coeff[2]{13. / 12., 0.25};
 
@@ -80,20 +86,67 @@ void WENOZ(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_
   return;
 }
 
+#if SIMD_RECON_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn WENOZPencil()
+//! \brief SIMD version of WENOZ() over a pencil of len cells (see simd_recon.hpp).  If
+//! apply_floor is true, L/R states are limited to be no smaller than floor.
+
+KOKKOS_INLINE_FUNCTION
+void WENOZPencil(TeamMember_t const &member, const int len, const Real *q_im2,
+                 const Real *q_im1, const Real *q_i, const Real *q_ip1, const Real *q_ip2,
+                 Real *ql_ip1, Real *qr_i, const bool apply_floor, const Real floor) {
+  using simd_recon::Load;
+  using simd_recon::Store;
+  simd_recon::PencilLoop(member, len,
+  [&](const int s) {
+    simd_recon::simd_t ql, qr;
+    simd_recon::WENOZ(Load(q_im2+s), Load(q_im1+s), Load(q_i+s), Load(q_ip1+s),
+                      Load(q_ip2+s), ql, qr);
+    if (apply_floor) {
+      ql = simd_recon::Max(ql, simd_recon::simd_t(floor));
+      qr = simd_recon::Max(qr, simd_recon::simd_t(floor));
+    }
+    Store(ql, ql_ip1+s);
+    Store(qr, qr_i+s);
+  },
+  [&](const int s) {
+    WENOZ(q_im2[s], q_im1[s], q_i[s], q_ip1[s], q_ip2[s], ql_ip1[s], qr_i[s]);
+    if (apply_floor) {
+      ql_ip1[s] = fmax(ql_ip1[s], floor);
+      qr_i[s] = fmax(qr_i[s], floor);
+    }
+  });
+}
+#endif
+
 
 //----------------------------------------------------------------------------------------
 //! \fn WENOZ
 //! \brief Wrapper function for WENOZ reconstruction in x1-direction.
 //! This function should be called over [is-1,ie+1] to get BOTH L/R states over [is,ie]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void WENOZX1(TeamMember_t const &member, const EOS_Data &eos, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
-  int nvar = q.extent_int(1);
-  const Real &dfloor_ = eos.dfloor;
+     const DvceArray5D<Real> &q, ScrArray2D<T> &ql, ScrArray2D<T> &qr,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
+  const T dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
-  Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
+  const T efloor_ = eos.pfloor/(eos.gamma - 1.0);
+#if SIMD_RECON_ENABLED
+  if constexpr (std::is_same_v<T, Real>) {
+    for (int n=0; n<nvar; ++n) {
+      bool floor_n = apply_floors && (n==IDN || n==IEN);
+      WENOZPencil(member, iu-il+1, &q(m,n,k,j,il-2), &q(m,n,k,j,il-1), &q(m,n,k,j,il),
+                  &q(m,n,k,j,il+1), &q(m,n,k,j,il+2), &ql(n,il+1), &qr(n,il),
+                  floor_n, (n==IDN)? dfloor_ : efloor_);
+    }
+    return;
+  }
+#endif
   for (int n=0; n<nvar; ++n) {
     par_for_inner(member, il, iu, [&](const int i) {
       Real &qim2 = q(m,n,k,j,i-2);
@@ -122,14 +175,27 @@ void WENOZX1(TeamMember_t const &member, const EOS_Data &eos, const bool apply_f
 //! \brief Wrapper function for WENOZ reconstruction in x1-direction.
 //! This function should be called over [js-1,je+1] to get BOTH L/R states over [js,je]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void WENOZX2(TeamMember_t const &member, const EOS_Data &eos, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
-  int nvar = q.extent_int(1);
-  const Real &dfloor_ = eos.dfloor;
+     const DvceArray5D<Real> &q, ScrArray2D<T> &ql_jp1, ScrArray2D<T> &qr_j,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
+  const T dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
-  Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
+  const T efloor_ = eos.pfloor/(eos.gamma - 1.0);
+#if SIMD_RECON_ENABLED
+  if constexpr (std::is_same_v<T, Real>) {
+    for (int n=0; n<nvar; ++n) {
+      bool floor_n = apply_floors && (n==IDN || n==IEN);
+      WENOZPencil(member, iu-il+1, &q(m,n,k,j-2,il), &q(m,n,k,j-1,il), &q(m,n,k,j,il),
+                  &q(m,n,k,j+1,il), &q(m,n,k,j+2,il), &ql_jp1(n,il), &qr_j(n,il),
+                  floor_n, (n==IDN)? dfloor_ : efloor_);
+    }
+    return;
+  }
+#endif
   for (int n=0; n<nvar; ++n) {
     par_for_inner(member, il, iu, [&](const int i) {
       Real &qjm2 = q(m,n,k,j-2,i);
@@ -158,14 +224,27 @@ void WENOZX2(TeamMember_t const &member, const EOS_Data &eos, const bool apply_f
 //! \brief Wrapper function for WENOZ reconstruction in x1-direction.
 //! This function should be called over [ks-1,ke+1] to get BOTH L/R states over [ks,ke]
 
+template <typename T>
 KOKKOS_INLINE_FUNCTION
 void WENOZX3(TeamMember_t const &member, const EOS_Data &eos, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
-  int nvar = q.extent_int(1);
-  const Real &dfloor_ = eos.dfloor;
+     const DvceArray5D<Real> &q, ScrArray2D<T> &ql_kp1, ScrArray2D<T> &qr_k,
+     const int nq = 0) {
+  int nvar = (nq > 0)? nq : q.extent_int(1);
+  const T dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
-  Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
+  const T efloor_ = eos.pfloor/(eos.gamma - 1.0);
+#if SIMD_RECON_ENABLED
+  if constexpr (std::is_same_v<T, Real>) {
+    for (int n=0; n<nvar; ++n) {
+      bool floor_n = apply_floors && (n==IDN || n==IEN);
+      WENOZPencil(member, iu-il+1, &q(m,n,k-2,j,il), &q(m,n,k-1,j,il), &q(m,n,k,j,il),
+                  &q(m,n,k+1,j,il), &q(m,n,k+2,j,il), &ql_kp1(n,il), &qr_k(n,il),
+                  floor_n, (n==IDN)? dfloor_ : efloor_);
+    }
+    return;
+  }
+#endif
   for (int n=0; n<nvar; ++n) {
     par_for_inner(member, il, iu, [&](const int i) {
       Real &qkm2 = q(m,n,k-2,j,i);
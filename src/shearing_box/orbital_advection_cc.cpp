@@ -67,13 +67,13 @@ TaskStatus OrbitalAdvectionCC::PackAndSendCC(DvceArray5D<Real> &a) {
   auto &ng = indcs.ng;
   auto &maxjshift_ = maxjshift;
 
-  // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
-  int nmnv = nmb*2*nvar;  // only consider 2 neighbors (x2-faces)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), nmnv, Kokkos::AUTO);
+  // Outer loop over (# of MeshBlocks)*(# of buffers).  All variables are packed by the
+  // same team, so that each buffer (one message per neighbor) is filled in one pass.
+  int nmn = nmb*2;  // only consider 2 neighbors (x2-faces)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), nmn, Kokkos::AUTO);
   Kokkos::parallel_for("oa-pack", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(2*nvar);
-    const int n = (tmember.league_rank() - m*(2*nvar))/nvar;
-    const int v = (tmember.league_rank() - m*(2*nvar) - n*nvar);
+    const int m = tmember.league_rank()/2;
+    const int n = tmember.league_rank()%2;
 
     // indices of x2-face buffers in nghbr view
     int nnghbr;
@@ -106,11 +106,13 @@ TaskStatus OrbitalAdvectionCC::PackAndSendCC(DvceArray5D<Real> &a) {
       int dm = nghbr.d_view(m,nnghbr).gid - mbgid.d_view(0);
       int dn = (n+1) % 2;
 
-      // Middle loop over k,j,i
-      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkji), [&](const int idx) {
-        int k = (idx)/nji;
-        int j = (idx - k*nji)/ni;
-        int i = (idx - k*nji - j*ni) + il;
+      // Middle loop over v,k,j,i
+      int nvkji = nvar*nkji;
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nvkji), [&](const int idx) {
+        int v = (idx)/nkji;
+        int k = (idx - v*nkji)/nji;
+        int j = (idx - v*nkji - k*nji)/ni;
+        int i = (idx - v*nkji - k*nji - j*ni) + il;
         k += kl;
         j += jl;
 
@@ -229,13 +231,16 @@ TaskStatus OrbitalAdvectionCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
   Real &dt = pmy_pack->pmesh->dt;
   Real ly = (mesh_size.x2max - mesh_size.x2min);
 
-  int scr_lvl=0;
-  size_t scr_size = ScrArray1D<Real>::shmem_size(nfx) * 3;
-  par_for_outer("oa-unpk",DevExeSpace(),scr_size,scr_lvl,0,(nmb-1),0,(nvar-1),ks,ke,is,ie,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k, const int i) {
-    ScrArray1D<Real> a_(member.team_scratch(scr_lvl), nfx); // 1D slice of data
-    ScrArray1D<Real> flx(member.team_scratch(scr_lvl), nfx); // "flux" at faces
-    ScrArray1D<Real> q1_(member.team_scratch(scr_lvl), nfx); // scratch array
+  // All variables in an x2-pencil are remapped by one team, so that the shift and the
+  // reconstruction are computed once per pencil.  The slopes need a second 2D array,
+  // which is moved to level 1 scratch if it would not fit in level 0.
+  bool plm = (rcon == ReconstructionMethod::plm);
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvar, nfx) * 2;
+  int scr_lvl = (scr_size > (1 << 15))? 1 : 0;
+  par_for_outer("oa-unpk",DevExeSpace(),scr_size,scr_lvl,0,(nmb-1),ks,ke,is,ie,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int i) {
+    ScrArray2D<Real> a_(member.team_scratch(scr_lvl), nvar, nfx); // 1D slices of data
+    ScrArray2D<Real> q1_(member.team_scratch(scr_lvl), nvar, nfx); // limited slopes
 
     Real &x1min = mbsize.d_view(m).x1min;
     Real &x1max = mbsize.d_view(m).x1max;
@@ -244,44 +249,46 @@ TaskStatus OrbitalAdvectionCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
 
     Real yshear = -qom*x1v*dt;
     int joffset = static_cast<int>(yshear/(mbsize.d_view(m).dx2));
+    Real epsi = fmod(yshear,(mbsize.d_view(m).dx2))/(mbsize.d_view(m).dx2);
 
-    // Load scratch array with no shift
-    par_for_inner(member, 0, (nfx-1), [&](const int jf) {
+    // Load scratch arrays of all variables with no shift
+    par_for_inner(member, 0, (nvar*nfx-1), [&](const int idx) {
+      int n = idx/nfx;
+      int jf = idx - n*nfx;
       if (jf < jfs) {
         // Load from L boundary buffer
-        a_(jf) = rbuf[0].vars(m,n,(k-ks),jf,(i-is));
+        a_(n,jf) = rbuf[0].vars(m,n,(k-ks),jf,(i-is));
       } else if (jf <= jfe) {
         // Load from conserved variables themselves (addressed with j=jf-jfs+js)
-        a_(jf) = a(m,n,k,jf-jfs+js,i);
+        a_(n,jf) = a(m,n,k,jf-jfs+js,i);
       } else {
         // Load from R boundary buffer
-        a_(jf) = rbuf[1].vars(m,n,(k-ks),jf-(jfe+1),(i-is));
+        a_(n,jf) = rbuf[1].vars(m,n,(k-ks),jf-(jfe+1),(i-is));
       }
     });
     member.team_barrier();
 
-    // Compute "fluxes" at shifted cell faces
-    Real epsi = fmod(yshear,(mbsize.d_view(m).dx2))/(mbsize.d_view(m).dx2);
-    switch (rcon) {
-      case ReconstructionMethod::dc:
-        DCRemapFlx(member, (jfs-joffset), (jfe+1-joffset), epsi, a_, q1_, flx);
-        break;
-      case ReconstructionMethod::plm:
-        PLMRemapFlx(member, (jfs-joffset), (jfe+1-joffset), epsi, a_, q1_, flx);
-        break;
-//      case ReconstructionMethod::ppm4:
-//      case ReconstructionMethod::ppmx:
-//          PPMRemapFlx(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_jp1, wr);
-//        break;
-      default:
-        break;
+    // Compute limited slopes in cells upwind of the shifted cell faces
+    int jl = jfs - joffset - 1;
+    int nj = jfe - jfs + 3;
+    if (plm) {
+      par_for_inner(member, 0, (nvar*nj-1), [&](const int idx) {
+        int n = idx/nj;
+        int jf = idx - n*nj + jl;
+        q1_(n,jf) = PLMRemapSlope(a_, n, jf);
+      });
+      member.team_barrier();
     }
 
     // Update CC variables with both integer shift (from a_) and a conservative remap
-    // for the remaining fraction of a cell using upwind "fluxes"
-    par_for_inner(member, js, je, [&](const int j) {
-      int jf = j-js + jfs;
-      a(m,n,k,j,i) = a_(jf-joffset) - (flx(jf+1-joffset) - flx(jf-joffset));
+    // for the remaining fraction of a cell using upwind "fluxes" at shifted faces
+    int nx2 = jfe - jfs + 1;
+    par_for_inner(member, 0, (nvar*nx2-1), [&](const int idx) {
+      int n = idx/nx2;
+      int jf = idx - n*nx2 + jfs;
+      Real flxl = RemapFlxFace(plm, epsi, a_, q1_, n, jf-joffset);
+      Real flxr = RemapFlxFace(plm, epsi, a_, q1_, n, jf+1-joffset);
+      a(m,n,k,jf-jfs+js,i) = a_(n,jf-joffset) - (flxr - flxl);
     });
   });
 
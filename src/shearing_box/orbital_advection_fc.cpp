@@ -38,6 +38,12 @@ OrbitalAdvectionFC::OrbitalAdvectionFC(MeshBlockPack *pp, ParameterInput *pin) :
     Kokkos::realloc(sendbuf[n].vars,nmb,2,ncells3,ncells2,ncells1);
     Kokkos::realloc(recvbuf[n].vars,nmb,2,ncells3,ncells2,ncells1);
   }
+  // Effective EMFs used to update B with CT in RecvAndUnpackFC()
+  int nmb1 = pp->nmb_thispack;
+  Kokkos::realloc(emf_x1,nmb1,indcs.nx3+2*(indcs.ng),indcs.nx2+2*(indcs.ng),
+                  indcs.nx1+2*(indcs.ng));
+  Kokkos::realloc(emf_x3,nmb1,indcs.nx3+2*(indcs.ng),indcs.nx2+2*(indcs.ng),
+                  indcs.nx1+2*(indcs.ng));
 }
 
 //----------------------------------------------------------------------------------------
@@ -225,101 +231,87 @@ TaskStatus OrbitalAdvectionFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b0,
   Real &dt = pmy_pack->pmesh->dt;
   Real ly = (mesh_size.x2max - mesh_size.x2min);
 
+  // B3 and B1 in an x2-pencil are remapped by one team.  The effective EMFs are stored in
+  // arrays allocated once in the constructor.
+  bool plm = (rcon == ReconstructionMethod::plm);
   int scr_lvl=0;
-  size_t scr_size = ScrArray1D<Real>::shmem_size(nfx) * 3;
-  DvceArray4D<Real> emfx, emfz;
-    int ncells1 = indcs.nx1 + 2*(indcs.ng);
-    int ncells2 = indcs.nx2 + 2*(indcs.ng);
-    int ncells3 = indcs.nx3 + 2*(indcs.ng);
-    Kokkos::realloc(emfx,nmb,ncells3,ncells2,ncells1);
-    Kokkos::realloc(emfz,nmb,ncells3,ncells2,ncells1);
-  par_for_outer("oa-unB",DevExeSpace(),scr_size,scr_lvl,0,(nmb-1),0,1,ks,ke+1,is,ie+1,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int v, const int k, const int i) {
-    ScrArray1D<Real> b0_(member.team_scratch(scr_lvl), nfx); // 1D slice of data
-    ScrArray1D<Real> flx(member.team_scratch(scr_lvl), nfx); // "flux" at faces
-    ScrArray1D<Real> q1_(member.team_scratch(scr_lvl), nfx); // scratch array
+  size_t scr_size = ScrArray2D<Real>::shmem_size(2, nfx) * 2;
+  auto emfx = emf_x1, emfz = emf_x3;
+  par_for_outer("oa-unB",DevExeSpace(),scr_size,scr_lvl,0,(nmb-1),ks,ke+1,is,ie+1,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int i) {
+    ScrArray2D<Real> b0_(member.team_scratch(scr_lvl), 2, nfx); // 1D slices of data
+    ScrArray2D<Real> q1_(member.team_scratch(scr_lvl), 2, nfx); // limited slopes
 
     Real &x1min = mbsize.d_view(m).x1min;
     Real &x1max = mbsize.d_view(m).x1max;
+    Real &dx2 = mbsize.d_view(m).dx2;
     int nx1 = indcs.nx1;
 
-    Real x1;
-    if (v==0) {
-      // B3 located at x1-cell centers
-      x1 = CellCenterX(i-is, nx1, x1min, x1max);
-    } else if (v==1) {
-      // B1 located at x1-cell faces
-      x1 = LeftEdgeX(i-is, nx1, x1min, x1max);
+    // B3 located at x1-cell centers, B1 located at x1-cell faces
+    Real yshear[2];
+    yshear[0] = -qom*CellCenterX(i-is, nx1, x1min, x1max)*dt;
+    yshear[1] = -qom*LeftEdgeX(i-is, nx1, x1min, x1max)*dt;
+    int joffset[2];
+    Real epsi[2];
+    for (int v=0; v<2; ++v) {
+      joffset[v] = static_cast<int>(yshear[v]/dx2);
+      epsi[v] = fmod(yshear[v],dx2)/dx2;
     }
-    Real yshear = -qom*x1*dt;
-    int joffset = static_cast<int>(yshear/(mbsize.d_view(m).dx2));
 
-    // Load scratch array with no shift
-    par_for_inner(member, 0, (nfx-1), [&](const int jf) {
+    // Load scratch arrays with no shift
+    par_for_inner(member, 0, (2*nfx-1), [&](const int idx) {
+      int v = idx/nfx;
+      int jf = idx - v*nfx;
       if (jf < jfs) {
         // Load from L boundary buffer
-        b0_(jf) = rbuf[0].vars(m,v,(k-ks),jf,(i-is));
+        b0_(v,jf) = rbuf[0].vars(m,v,(k-ks),jf,(i-is));
       } else if (jf <= jfe) {
         // Load from array itself (addressed with j=jf-jfs+js)
         if (v==0) {
-          b0_(jf) = b0.x3f(m,k,(jf-jfs+js),i);
-        } else if (v==1) {
-          b0_(jf) = b0.x1f(m,k,(jf-jfs+js),i);
+          b0_(v,jf) = b0.x3f(m,k,(jf-jfs+js),i);
+        } else {
+          b0_(v,jf) = b0.x1f(m,k,(jf-jfs+js),i);
         }
       } else {
         // Load scratch arrays from R boundary buffer
-        b0_(jf) = rbuf[1].vars(m,v,(k-ks),jf-(jfe+1),(i-is));
+        b0_(v,jf) = rbuf[1].vars(m,v,(k-ks),jf-(jfe+1),(i-is));
       }
     });
     member.team_barrier();
 
-    // Compute x2-fluxes at shifted cell faces
-    Real epsi = fmod(yshear,(mbsize.d_view(m).dx2))/(mbsize.d_view(m).dx2);
-    switch (rcon) {
-      case ReconstructionMethod::dc:
-        DCRemapFlx(member, (jfs-joffset), (jfe+1-joffset), epsi, b0_, q1_, flx);
-        break;
-      case ReconstructionMethod::plm:
-        PLMRemapFlx(member, (jfs-joffset), (jfe+1-joffset), epsi, b0_, q1_, flx);
-        break;
-//      case ReconstructionMethod::ppm4:
-//      case ReconstructionMethod::ppmx:
-//          PPMRemapFlx(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_jp1, wr);
-//        break;
-      default:
-        break;
-    }
-
-    // Compute emfx = -VyBz, which is at cell-center in x1-direction
-    if (v==0) {
-      par_for_inner(member, js, je+1, [&](const int j) {
-        int jf = j-js + jfs;
-        emfx(m,k,j,i) = -flx(jf-joffset);
-        // Sum integer offsets into effective EMFs
-        for (int jj=1; jj<=joffset; jj++) {
-          emfx(m,k,j,i) -= b0_(jf-jj);
-        }
-        for (int jj=(joffset+1); jj<=0; jj++) {
-          emfx(m,k,j,i) += b0_(jf-jj);
-        }
-      });
-      member.team_barrier();
-
-    // Compute emfz =  VyBx, which is at cell-face in x1-direction
-    } else if (v==1) {
-      par_for_inner(member, js, je+1, [&](const int j) {
-        int jf = j-js + jfs;
-        emfz(m,k,j,i) = flx(jf-joffset);
-        // Sum integer offsets into effective EMFs
-        for (int jj=1; jj<=joffset; jj++) {
-          emfz(m,k,j,i) += b0_(jf-jj);
-        }
-        for (int jj=(joffset+1); jj<=0; jj++) {
-          emfz(m,k,j,i) -= b0_(jf-jj);
-        }
+    // Compute limited slopes in cells upwind of the shifted cell faces
+    int nj = jfe - jfs + 3;
+    if (plm) {
+      par_for_inner(member, 0, (2*nj-1), [&](const int idx) {
+        int v = idx/nj;
+        int jf = idx - v*nj + jfs - joffset[v] - 1;
+        q1_(v,jf) = PLMRemapSlope(b0_, v, jf);
       });
       member.team_barrier();
     }
+
+    // Compute emfx = -VyBz, which is at cell-center in x1-direction, and
+    // emfz =  VyBx, which is at cell-face in x1-direction, from x2-fluxes at shifted
+    // cell faces plus the sum of the integer offsets
+    int nx2f = jfe - jfs + 2;
+    par_for_inner(member, 0, (2*nx2f-1), [&](const int idx) {
+      int v = idx/nx2f;
+      int jf = idx - v*nx2f + jfs;
+      int j = jf - jfs + js;
+      int jo = joffset[v];
+      Real emf = RemapFlxFace(plm, epsi[v], b0_, q1_, v, jf-jo);
+      for (int jj=1; jj<=jo; jj++) {
+        emf += b0_(v,jf-jj);
+      }
+      for (int jj=(jo+1); jj<=0; jj++) {
+        emf -= b0_(v,jf-jj);
+      }
+      if (v==0) {
+        emfx(m,k,j,i) = -emf;
+      } else {
+        emfz(m,k,j,i) = emf;
+      }
+    });
   });
 
   // Update face-centered fields using CT
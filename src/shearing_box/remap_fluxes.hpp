@@ -62,4 +62,39 @@ void PLMRemapFlx(TeamMember_t const &tmember, const int jl, const int ju, const
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn PLMRemapSlope()
+//! \brief Limited slope of variable n in cell j of a 2D (nvar,nfx) scratch array, as
+//! computed by PLMRemapFlx() for a single variable.
+
+KOKKOS_INLINE_FUNCTION
+Real PLMRemapSlope(const ScrArray2D<Real> &u, const int n, const int j) {
+  Real dql = u(n,j  ) - u(n,j-1);
+  Real dqr = u(n,j+1) - u(n,j  );
+  Real dq2 = dql*dqr;
+  Real q1 = 0.0;
+  if (dq2 > 0.0) q1 = dq2/(dql + dqr);
+  return q1;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn RemapFlxFace()
+//! \brief Upwind "flux" U_star of variable n at face j for the fused remap of all
+//! variables in 2D (nvar,nfx) scratch arrays.  Gives the same result as DCRemapFlx()
+//! (plm=false) or PLMRemapFlx() (plm=true, with slopes q1 from PLMRemapSlope()), but is
+//! evaluated face by face so the fluxes need not be stored, saving one scratch array and
+//! a barrier.
+
+KOKKOS_INLINE_FUNCTION
+Real RemapFlxFace(const bool plm, const Real eps, const ScrArray2D<Real> &u,
+                  const ScrArray2D<Real> &q1, const int n, const int j) {
+  if (eps > 0.0) {
+    if (plm) return eps*(u(n,j-1) + 0.5*(1.0 - eps)*q1(n,j-1));
+    return eps*u(n,j-1);
+  } else {
+    if (plm) return eps*(u(n,j) - 0.5*(1.0 + eps)*q1(n,j));
+    return eps*u(n,j);
+  }
+}
+
 #endif // SHEARING_BOX_REMAP_FLUXES_HPP_
@@ -7,11 +7,15 @@
 //! \brief constructor for ShearingBoxBoundary abstract base class, and utility functions
 
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "shearing_box.hpp"
@@ -57,6 +61,12 @@ ShearingBoxBoundary::ShearingBoxBoundary(MeshBlockPack *ppack, ParameterInput *p
   x1bndry_mbgid.template modify<HostMemSpace>();
   x1bndry_mbgid.template sync<DevExeSpace>();
 
+  // communication schedule is built on first call to InitRecv()
+  persistent_mpi = pin->GetOrAddBoolean("mesh", "persistent_mpi", false);
+  for (int n=0; n<2; ++n) {
+    sched[n].resize(3*nmb_x1bndry(n));
+    sched_joffset[n].assign(nmb_x1bndry(n), std::numeric_limits<int>::min());
+  }
 
 #if MPI_PARALLEL_ENABLED
   // initialize vectors of MPI requests for ix1/ox1 boundaries in fixed length arrays
@@ -65,7 +75,7 @@ ShearingBoxBoundary::ShearingBoxBoundary(MeshBlockPack *ppack, ParameterInput *p
     if (nmb_x1bndry(n) > 0) {
       sendbuf[n].vars_req = new MPI_Request[3*nmb_x1bndry(n)];
       recvbuf[n].vars_req = new MPI_Request[3*nmb_x1bndry(n)];
-      for (int m=0; m<nmb_x1bndry(0); ++m) {
+      for (int m=0; m<nmb_x1bndry(n); ++m) {
         for (int l=0; l<3; ++l) {
           sendbuf[n].vars_req[3*m + l] = MPI_REQUEST_NULL;
           recvbuf[n].vars_req[3*m + l] = MPI_REQUEST_NULL;
@@ -85,6 +95,15 @@ ShearingBoxBoundary::~ShearingBoxBoundary() {
 #if MPI_PARALLEL_ENABLED
   for (int n=0; n<2; ++n) {
     if (nmb_x1bndry(n) > 0) {
+      // free any (inactive) persistent requests
+      for (int l=0; l<3*nmb_x1bndry(n); ++l) {
+        if (sendbuf[n].vars_req[l] != MPI_REQUEST_NULL) {
+          MPI_Request_free(&(sendbuf[n].vars_req[l]));
+        }
+        if (recvbuf[n].vars_req[l] != MPI_REQUEST_NULL) {
+          MPI_Request_free(&(recvbuf[n].vars_req[l]));
+        }
+      }
       delete [] sendbuf[n].vars_req;
       delete [] recvbuf[n].vars_req;
     }
@@ -106,7 +125,168 @@ void ShearingBoxBoundary::FindTargetMB(const int igid, const int jshift, int &gi
   // apply shift by input number of blocks
   lloc.lx2 = static_cast<std::int32_t>((lloc.lx2 + jshift) % nmbx2);
   // find target GID and rank
-  gid = (pm->ptree->FindMeshBlock(lloc))->GetGID();
+  gid = pm->plintree->FindMeshBlock(lloc);
   rank = pm->rank_eachmb[gid];
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void ShearingBoxBoundary::UpdateSchedule()
+//! \brief Builds the schedule of messages sent and received by each MB at the x1
+//! boundaries for the current yshear.  Entries are only rebuilt for MBs whose integer
+//! shift has changed since the last call, so the tree is not searched for target MBs
+//! every stage.  With <mesh>/persistent_mpi=true, persistent MPI requests are (re)created
+//! for the rebuilt entries.  Must only be called when all previous communications for
+//! shearing box boundaries have been cleared.
+//!
+//! Algorithm is broken into three cases:
+//!  * Case1 and case3 are when the integer shift (jr<ng), so that the sending MB
+//!    overlaps the ghost cells of the two neighbors, and so requires copy/send
+//!    to three separate target MBs.
+//!  * Case2 is when the sending MB straddles the boundary between MBs, and so requires
+//!    copy/send to only two target MBs.
+
+void ShearingBoxBoundary::UpdateSchedule() {
+  const auto &indcs = pmy_pack->pmesh->mb_indcs;
+  const int &js = indcs.js, &je = indcs.je;
+  const int &ng = indcs.ng;
+  const int &nx2 = indcs.nx2;
+#if MPI_PARALLEL_ENABLED
+  bool no_errors=true;
+#endif
+  for (int n=0; n<2; ++n) {
+    for (int m=0; m<nmb_x1bndry(n); ++m) {
+      int gid = x1bndry_mbgid.h_view(n,m);
+      int mm = gid - pmy_pack->gids;
+      // Find integer and fractional number of grids over which offset extends.
+      // This assumes every grid has same number of cells in x2-direction!
+      int joffset  = static_cast<int>(yshear/(pmy_pack->pmb->mb_size.h_view(mm).dx2));
+      if (joffset == sched_joffset[n][m]) continue;
+      sched_joffset[n][m] = joffset;
+      int ji = joffset/nx2;
+      int jr = joffset - ji*nx2;
+
+      ShearingBoxMessage *msg = &(sched[n][3*m]);
+      int nmsg;
+      int tshift[3];  // offset of target; source is at minus this offset
+      if (jr < ng) {               //--- CASE 1 (in my nomenclature)
+        nmsg = 3;
+        if (n==0) {
+          msg[0].jsrc = std::make_pair(js,js+ng-jr);
+          msg[1].jsrc = std::make_pair(js,je+1);
+          msg[2].jsrc = std::make_pair(je-(ng-1)-jr,je+1);
+          msg[0].jdst = std::make_pair(je+1+jr,je+ng+1);
+          msg[1].jdst = std::make_pair(js+jr,je+jr+1);
+          msg[2].jdst = std::make_pair(js-ng,js+jr);
+        } else {
+          msg[0].jsrc = std::make_pair(js,js+ng+jr);
+          msg[1].jsrc = std::make_pair(js,je+1);
+          msg[2].jsrc = std::make_pair(je-(ng-1)+jr,je+1);
+          msg[0].jdst = std::make_pair(je+1-jr,je+ng+1);
+          msg[1].jdst = std::make_pair(js-jr,je-jr+1);
+          msg[2].jdst = std::make_pair(js-ng,js-jr);
+        }
+        // ix1 boundary: send to (target-1) through (target+1)
+        // ox1 boundary: send to (target-1) through (target+1)
+        for (int l=0; l<3; ++l) {
+          if (n==0) {tshift[l] = ji+l-1;} else {tshift[l] = l-1-ji;}
+        }
+      } else if (jr < (nx2-ng)) {  //--- CASE 2
+        nmsg = 2;
+        if (n==0) {
+          msg[0].jsrc = std::make_pair(js,je+ng-jr+1);
+          msg[1].jsrc = std::make_pair(je-(ng-1)-jr,je+1);
+          msg[0].jdst = std::make_pair(js+jr,je+ng+1);
+          msg[1].jdst = std::make_pair(js-ng,js+jr);
+        } else {
+          msg[0].jsrc = std::make_pair(js,js+ng+jr);
+          msg[1].jsrc = std::make_pair(js-ng+jr,je+1);
+          msg[0].jdst = std::make_pair(je-jr+1,je+ng+1);
+          msg[1].jdst = std::make_pair(js-ng,je-jr+1);
+        }
+        // ix1 boundary: send to (target  ) through (target+1)
+        // ox1 boundary: send to (target-1) through (target  )
+        for (int l=0; l<2; ++l) {
+          if (n==0) {tshift[l] = ji+l;} else {tshift[l] = l-1-ji;}
+        }
+      } else {                     //--- CASE 3
+        nmsg = 3;
+        if (n==0) {
+          msg[0].jsrc = std::make_pair(js,js+ng+(nx2-jr));
+          msg[1].jsrc = std::make_pair(js,je+1);
+          msg[2].jsrc = std::make_pair(je-(ng-1)+(nx2-jr),je+1);
+          msg[0].jdst = std::make_pair(je+1-(nx2-jr),je+ng+1);
+          msg[1].jdst = std::make_pair(js-(nx2-jr),je-(nx2-jr)+1);
+          msg[2].jdst = std::make_pair(js-ng,js-(nx2-jr));
+        } else {
+          msg[0].jsrc = std::make_pair(js,js+ng-(nx2-jr));
+          msg[1].jsrc = std::make_pair(js,je+1);
+          msg[2].jsrc = std::make_pair(je-(ng-1)-(nx2-jr),je+1);
+          msg[0].jdst = std::make_pair(je+1+(nx2-jr),je+ng+1);
+          msg[1].jdst = std::make_pair(js+(nx2-jr),je+(nx2-jr)+1);
+          msg[2].jdst = std::make_pair(js-ng,js+(nx2-jr));
+        }
+        // ix1 boundary: send to (target  ) through (target+2)
+        // ox1 boundary: send to (target-2) through (target  )
+        for (int l=0; l<3; ++l) {
+          if (n==0) {tshift[l] = ji+l;} else {tshift[l] = l-2-ji;}
+        }
+      }
+
+      for (int l=0; l<3; ++l) {
+        msg[l].active = (l < nmsg);
+        if (!(msg[l].active)) continue;
+        FindTargetMB(gid,tshift[l],msg[l].tgid,msg[l].trank);
+        FindTargetMB(gid,-tshift[l],msg[l].sgid,msg[l].srank);
+        msg[l].tm = -1;
+        if (msg[l].trank == global_variable::my_rank) {
+          msg[l].tm = TargetIndex(n,msg[l].tgid);
+        }
+      }
+
+#if MPI_PARALLEL_ENABLED
+      if (persistent_mpi) {
+        for (int l=0; l<3; ++l) {
+          int ireq = 3*m + l;
+          if (sendbuf[n].vars_req[ireq] != MPI_REQUEST_NULL) {
+            MPI_Request_free(&(sendbuf[n].vars_req[ireq]));
+          }
+          if (recvbuf[n].vars_req[ireq] != MPI_REQUEST_NULL) {
+            MPI_Request_free(&(recvbuf[n].vars_req[ireq]));
+          }
+          if (!(msg[l].active)) continue;
+          using Kokkos::ALL;
+          if (msg[l].srank != global_variable::my_rank) {
+            // create tag using GID of *receiving* MeshBlock
+            int tag = CreateBvals_MPI_Tag(gid, ((n<<2) | l));
+            auto recv_ptr = Kokkos::subview(recvbuf[n].vars,m,msg[l].jdst,ALL,ALL,ALL);
+            int data_size = recv_ptr.size();
+            int ierr = MPI_Recv_init(recv_ptr.data(), data_size, MPI_ATHENA_REAL,
+                                     msg[l].srank, tag, comm_sbox,
+                                     &(recvbuf[n].vars_req[ireq]));
+            if (ierr != MPI_SUCCESS) {no_errors=false;}
+          }
+          if (msg[l].trank != global_variable::my_rank) {
+            int tag = CreateBvals_MPI_Tag(msg[l].tgid, ((n<<2) | l));
+            auto send_ptr = Kokkos::subview(sendbuf[n].vars,m,msg[l].jsrc,ALL,ALL,ALL);
+            int data_size = send_ptr.size();
+            int ierr = MPI_Send_init(send_ptr.data(), data_size, MPI_ATHENA_REAL,
+                                     msg[l].trank, tag, comm_sbox,
+                                     &(sendbuf[n].vars_req[ireq]));
+            if (ierr != MPI_SUCCESS) {no_errors=false;}
+          }
+        }
+      }
+#endif
+    }
+  }
+#if MPI_PARALLEL_ENABLED
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in creating persistent requests" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return;
+}
@@ -10,6 +10,9 @@
 //! Both OrbitalAdvection and ShearingBox are abstract base classes that are used to
 //! define derived classes for CC and FC variables.
 
+#include <utility>
+#include <vector>
+
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "tasklist/task_list.hpp"
@@ -45,6 +48,19 @@ struct ShearingBoxBoundaryBuffer {
 #endif
 };
 
+//----------------------------------------------------------------------------------------
+//! \struct ShearingBoxMessage
+//! \brief one entry in the communication schedule of a MeshBlock at a shearing-periodic
+//! x1-boundary: the x2-ranges of data in the send/recv buffers, and the MeshBlocks that
+//! receive data sent by (target) and send data received by (source) this MeshBlock.
+
+struct ShearingBoxMessage {
+  bool active = false;            // false for unused third message when only 2 needed
+  std::pair<int,int> jsrc, jdst;  // x2-ranges of data in send/recv buffers
+  int tgid, trank, tm;            // GID, rank and x1bndry index (if local) of target
+  int sgid, srank;                // GID and rank of source
+};
+
 //----------------------------------------------------------------------------------------
 //! \class OrbitalAdvection
 //  \brief Abstract base class for orbital advection of CC and FC variables
@@ -95,6 +111,8 @@ class OrbitalAdvectionCC : public OrbitalAdvection {
 class OrbitalAdvectionFC : public OrbitalAdvection {
  public:
   OrbitalAdvectionFC(MeshBlockPack *ppack, ParameterInput *pin);
+  // effective EMFs (x1- and x3-components) including integer and fractional shifts
+  DvceArray4D<Real> emf_x1, emf_x3;
   // functions to communicate FC data with orbital advection
   TaskStatus PackAndSendFC(DvceFaceFld4D<Real> &b);
   TaskStatus RecvAndUnpackFC(DvceFaceFld4D<Real> &b0, ReconstructionMethod rcon, Real qo);
@@ -113,6 +131,13 @@ class ShearingBoxBoundary {
   HostArray1D<int> nmb_x1bndry;    // number of MBs that touch x1 boundaries
   DualArray2D<int> x1bndry_mbgid;  // GIDs of MBs at x1 boundaries
   Real yshear;                     // x2-distance x1-boundaries have sheared
+  bool persistent_mpi;             // use persistent MPI requests built with schedule
+
+  // Communication schedule with up to 3 messages for each MB at ix1/ox1 boundaries.
+  // The schedule depends only on the integer shift of the boundaries, so it is rebuilt
+  // (and the tree searched for target MBs) only when that shift changes.
+  std::vector<ShearingBoxMessage> sched[2];
+  std::vector<int> sched_joffset[2];  // integer shift for which schedule was built
 
   // data buffers for shearing box BCs.  Only two x1-faces get sheared
   // Use seperate variables for ix1/ox1 since number of MBs on each face can be different
@@ -127,6 +152,7 @@ class ShearingBoxBoundary {
   TaskStatus InitRecv(Real qom, Real time);
   TaskStatus ClearRecv();
   TaskStatus ClearSend();
+  void UpdateSchedule();
   // function to find target MB offset by shear.  Returns GID and rank
   void FindTargetMB(const int igid, const int jshift, int &gid, int &rank);
   // function to find index in x1bndry array of MB with input GID
@@ -116,150 +116,38 @@ TaskStatus ShearingBoxBoundaryCC::PackAndSendCC(DvceArray5D<Real> &a,
     });
   }
 
-  // shift data at x1 boundaries by integer number of cells.
-  // Algorithm is broken into three steps: case1/2/3.
-  //  * Case1 and case3 are when the integer shift (jr<ng), so that the sending MB
-  //    overlaps the ghost cells of the two neighbors, and so requires copy/send
-  //    to three separate target MBs.
-  //  * Case2 is when the sending MB straddles the boundary between MBs, and so requires
-  //    copy/send to only two target MBs.
+  // shift data at x1 boundaries by integer number of cells, using the schedule of
+  // messages built in InitRecv() for the current shift (see UpdateSchedule()).
   // Use deep copy if target MB on same rank, or MPI sends if not
   Kokkos::fence();
-  const int &nx2 = indcs.nx2;
   bool no_errors=true;
   for (int n=0; n<2; ++n) {
     for (int m=0; m<nmb_x1bndry(n); ++m) {
-      int gid = x1bndry_mbgid.h_view(n,m);
-      int mm = gid - pmy_pack->gids;
-      // Find integer and fractional number of grids over which offset extends.
-      // This assumes every grid has same number of cells in x2-direction!
-      int joffset  = static_cast<int>(yshear/(mbsize.h_view(mm).dx2));
-      int ji = joffset/nx2;
-      int jr = joffset - ji*nx2;
-
-      if (jr < ng) {               //--- CASE 1 (in my nomenclature)
-        int tgid, trank;
-        std::pair<int,int> jsrc[3],jdst[3];
-        if (n==0) {
-          jsrc[0] = std::make_pair(js,js+ng-jr);
-          jsrc[1] = std::make_pair(js,je+1);
-          jsrc[2] = std::make_pair(je-(ng-1)-jr,je+1);
-          jdst[0] = std::make_pair(je+1+jr,je+ng+1);
-          jdst[1] = std::make_pair(js+jr,je+jr+1);
-          jdst[2] = std::make_pair(js-ng,js+jr);
-        } else {
-          jsrc[0] = std::make_pair(js,js+ng+jr);
-          jsrc[1] = std::make_pair(js,je+1);
-          jsrc[2] = std::make_pair(je-(ng-1)+jr,je+1);
-          jdst[0] = std::make_pair(je+1-jr,je+ng+1);
-          jdst[1] = std::make_pair(js-jr,je-jr+1);
-          jdst[2] = std::make_pair(js-ng,js-jr);
-        }
-        // ix1 boundary: send to (target-1) through (target+1)
-        // ox1 boundary: send to (target-1) through (target+1)
-        for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = ji+l-1;} else {jshift = l-1-ji;} // offset of target
-          FindTargetMB(gid,jshift,tgid,trank);
-          if (trank == global_variable::my_rank) {
-            int tm = TargetIndex(n,tgid);
-            using Kokkos::ALL;
-            auto src = subview(sendbuf[n].vars,m, jsrc[l],ALL,ALL,ALL);
-            auto dst = subview(recvbuf[n].vars,tm,jdst[l],ALL,ALL,ALL);
-            deep_copy(DevExeSpace(), dst, src);
+      for (int l=0; l<3; ++l) {
+        const ShearingBoxMessage &msg = sched[n][3*m + l];
+        if (!(msg.active)) continue;
+        if (msg.trank == global_variable::my_rank) {
+          using Kokkos::ALL;
+          auto src = subview(sendbuf[n].vars,m,     msg.jsrc,ALL,ALL,ALL);
+          auto dst = subview(recvbuf[n].vars,msg.tm,msg.jdst,ALL,ALL,ALL);
+          deep_copy(DevExeSpace(), dst, src);
 #if MPI_PARALLEL_ENABLED
-          } else {
-            using Kokkos::ALL;
-            auto send_ptr = subview(sendbuf[n].vars,m,jsrc[l],ALL,ALL,ALL);
-            // create tag using GID of *receiving* MeshBlock
-            int tag = CreateBvals_MPI_Tag(tgid, ((n<<2) | l));
-            int data_size = send_ptr.size();
-            int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, trank, tag,
-                                 comm_sbox, &(sendbuf[n].vars_req[3*m + l]));
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-#endif
-          }
-        }
-      } else if (jr < (nx2-ng)) {  //--- CASE 2
-        int tgid, trank;
-        std::pair<int,int> jsrc[2],jdst[2];
-        if (n==0) {
-          jsrc[0] = std::make_pair(js,je+ng-jr+1);
-          jsrc[1] = std::make_pair(je-(ng-1)-jr,je+1);
-          jdst[0] = std::make_pair(js+jr,je+ng+1);
-          jdst[1] = std::make_pair(js-ng,js+jr);
         } else {
-          jsrc[0] = std::make_pair(js,js+ng+jr);
-          jsrc[1] = std::make_pair(js-ng+jr,je+1);
-          jdst[0] = std::make_pair(je-jr+1,je+ng+1);
-          jdst[1] = std::make_pair(js-ng,je-jr+1);
-        }
-        // ix1 boundary: send to (target  ) through (target+1)
-        // ox1 boundary: send to (target-1) through (target  )
-        for (int l=0; l<2; ++l) {
-          int jshift;
-          if (n==0) {jshift = ji+l;} else {jshift = l-1-ji;}
-          FindTargetMB(gid,jshift,tgid,trank);
-          if (trank == global_variable::my_rank) {
-            int tm = TargetIndex(n,tgid);
-            using Kokkos::ALL;
-            auto src = subview(sendbuf[n].vars,m, jsrc[l],ALL,ALL,ALL);
-            auto dst = subview(recvbuf[n].vars,tm,jdst[l],ALL,ALL,ALL);
-            deep_copy(DevExeSpace(), dst, src);
-#if MPI_PARALLEL_ENABLED
+          int ierr;
+          if (persistent_mpi) {
+            // persistent request built in UpdateSchedule() with same tag and size
+            ierr = MPI_Start(&(sendbuf[n].vars_req[3*m + l]));
           } else {
             using Kokkos::ALL;
-            auto send_ptr = subview(sendbuf[n].vars,m,jsrc[l],ALL,ALL,ALL);
+            auto send_ptr = subview(sendbuf[n].vars,m,msg.jsrc,ALL,ALL,ALL);
             // create tag using GID of *receiving* MeshBlock
-            int tag = CreateBvals_MPI_Tag(tgid, ((n<<2) | l));
+            int tag = CreateBvals_MPI_Tag(msg.tgid, ((n<<2) | l));
             int data_size = send_ptr.size();
-            int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, trank, tag,
-                                 comm_sbox, &(sendbuf[n].vars_req[3*m + l]));
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-#endif
+            ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, msg.trank, tag,
+                             comm_sbox, &(sendbuf[n].vars_req[3*m + l]));
           }
-        }
-      } else {                     //--- CASE 3
-        int tgid, trank;
-        std::pair<int,int> jsrc[3],jdst[3];
-        if (n==0) {
-          jsrc[0] = std::make_pair(js,js+ng+(nx2-jr));
-          jsrc[1] = std::make_pair(js,je+1);
-          jsrc[2] = std::make_pair(je-(ng-1)+(nx2-jr),je+1);
-          jdst[0] = std::make_pair(je+1-(nx2-jr),je+ng+1);
-          jdst[1] = std::make_pair(js-(nx2-jr),je-(nx2-jr)+1);
-          jdst[2] = std::make_pair(js-ng,js-(nx2-jr));
-        } else {
-          jsrc[0] = std::make_pair(js,js+ng-(nx2-jr));
-          jsrc[1] = std::make_pair(js,je+1);
-          jsrc[2] = std::make_pair(je-(ng-1)-(nx2-jr),je+1);
-          jdst[0] = std::make_pair(je+1+(nx2-jr),je+ng+1);
-          jdst[1] = std::make_pair(js+(nx2-jr),je+(nx2-jr)+1);
-          jdst[2] = std::make_pair(js-ng,js+(nx2-jr));
-        }
-        // ix1 boundary: send to (target  ) through (target+2)
-        // ox1 boundary: send to (target-2) through (target  )
-        for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = ji+l;} else {jshift = l-2-ji;}
-          FindTargetMB(gid,jshift,tgid,trank);
-          if (trank == global_variable::my_rank) {
-            int tm = TargetIndex(n,tgid);
-            using Kokkos::ALL;
-            auto src = subview(sendbuf[n].vars,m, jsrc[l],ALL,ALL,ALL);
-            auto dst = subview(recvbuf[n].vars,tm,jdst[l],ALL,ALL,ALL);
-            deep_copy(DevExeSpace(), dst, src);
-#if MPI_PARALLEL_ENABLED
-          } else {
-            using Kokkos::ALL;
-            auto send_ptr = subview(sendbuf[n].vars,m,jsrc[l],ALL,ALL,ALL);
-            // create tag using GID of *receiving* MeshBlock
-            int tag = CreateBvals_MPI_Tag(tgid, ((n<<2) | l));
-            int data_size = send_ptr.size();
-            int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, trank, tag,
-                                 comm_sbox, &(sendbuf[n].vars_req[3*m + l]));
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
 #endif
-          }
         }
       }
     }
@@ -284,63 +172,17 @@ TaskStatus ShearingBoxBoundaryCC::RecvAndUnpackCC(DvceArray5D<Real> &a) {
   const int &ng = indcs.ng;
 #if MPI_PARALLEL_ENABLED
   //----- STEP 1: check that recv boundary buffer communications have all completed
-  const int &nx2 = indcs.nx2;
   bool bflag = false;
   bool no_errors=true;
   for (int n=0; n<2; ++n) {
     for (int m=0; m<nmb_x1bndry(n); ++m) {
-      int gid = x1bndry_mbgid.h_view(n,m);
-      int mm = gid - pmy_pack->gids;
-      // Find integer and fractional number of grids over which offset extends.
-      // This assumes every grid has same number of cells in x2-direction!
-      int joffset  = static_cast<int>(yshear/(pmy_pack->pmb->mb_size.h_view(mm).dx2));
-      int ji = joffset/nx2;
-      int jr = joffset - ji*nx2;
-
-      if (jr < ng) {               //--- CASE 1 (in my nomenclature)
-        // ix1 boundary: receive from (target+1) through (target-1)
-        // ox1 boundary: receive from (target+1) through (target-1)
-        for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l-1);} else {jshift = -(l-1-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
-          if (srank != global_variable::my_rank) {
-            int test;
-            int ierr = MPI_Test(&(recvbuf[n].vars_req[3*m + l]),&test,MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-            if (!(static_cast<bool>(test))) {bflag = true;}
-          }
-        }
-      } else if (jr < (nx2-ng)) {  //--- CASE 2
-        // ix1 boundary: receive from (target  ) through (target-1)
-        // ox1 boundary: receive from (target+1) through (target  )
-        for (int l=0; l<2; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l);} else {jshift = -(l-1-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
-          if (srank != global_variable::my_rank) {
-            int test;
-            int ierr = MPI_Test(&(recvbuf[n].vars_req[3*m + l]),&test,MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-            if (!(static_cast<bool>(test))) {bflag = true;}
-          }
-        }
-      } else {                     //--- CASE 3
-        // ix1 boundary: send to (target  ) through (target+2)
-        // ox1 boundary: send to (target-2) through (target  )
-        for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l);} else {jshift = -(l-2-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
-          if (srank != global_variable::my_rank) {
-            int test;
-            int ierr = MPI_Test(&(recvbuf[n].vars_req[3*m + l]),&test,MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-            if (!(static_cast<bool>(test))) {bflag = true;}
-          }
+      for (int l=0; l<3; ++l) {
+        const ShearingBoxMessage &msg = sched[n][3*m + l];
+        if (msg.active && (msg.srank != global_variable::my_rank)) {
+          int test;
+          int ierr = MPI_Test(&(recvbuf[n].vars_req[3*m + l]),&test,MPI_STATUS_IGNORE);
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+          if (!(static_cast<bool>(test))) {bflag = true;}
         }
       }
     }
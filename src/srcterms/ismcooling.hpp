@@ -55,4 +55,21 @@ Real ISMCoolFn(Real temp) {
   Real logcool = (lhd[ipps+1]*dx - lhd[ipps]*(dx - 0.04))*25.0;
   return pow(10.0,logcool);
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn Real LogTableFn()
+//! \brief Rate from a table of log10(rate) uniformly spaced in log10(T), with linear
+//! interpolation in log-log space.  Temperatures outside the table use the end values.
+//! Used for cooling and heating rates read from <block>/cooling_table.
+
+KOKKOS_INLINE_FUNCTION
+Real LogTableFn(const DvceArray1D<Real> &ltab, const int n, const Real logt_min,
+                const Real dlogt, const Real temp) {
+  Real x = (log10(temp) - logt_min)/dlogt;
+  x = fmin(fmax(x, 0.0), static_cast<Real>(n-1));
+  int it = static_cast<int>(x);
+  it = (it < n-2)? it : n-2;
+  Real f = x - static_cast<Real>(it);
+  return pow(10.0, (1.0 - f)*ltab(it) + f*ltab(it+1));
+}
 #endif // SRCTERMS_ISMCOOLING_HPP_
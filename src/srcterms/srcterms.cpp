@@ -10,8 +10,12 @@
 
 #include "srcterms.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <string> // string
+#include <vector>
 
 #include "athena.hpp"
 #include "coordinates/cartesian_ks.hpp"
@@ -26,6 +30,7 @@
 #include "radiation/radiation.hpp"
 #include "turb_driver.hpp"
 #include "units/units.hpp"
+#include "utils/tr_table.hpp"
 
 //----------------------------------------------------------------------------------------
 // constructor, parses input file and initializes data structures and parameters
@@ -33,7 +38,17 @@
 
 SourceTerms::SourceTerms(std::string block, MeshBlockPack *pp, ParameterInput *pin) :
   pmy_pack(pp),
-  shearing_box_r_phi(false) {
+  shearing_box_r_phi(false),
+  cool_tab(false),
+  heat_tab(false),
+  ntab(0),
+  logt_min(0.0),
+  dlogt(1.0),
+  cool_subcycle(false),
+  cool_cfl(0.1),
+  cool_nsub_max(1),
+  nbeam(0),
+  beam_generation(-1) {
   // (1) (constant) gravitational acceleration
   const_accel = pin->GetOrAddBoolean(block, "const_accel", false);
   if (const_accel) {
@@ -49,7 +64,22 @@ SourceTerms::SourceTerms(std::string block, MeshBlockPack *pp, ParameterInput *p
   // (2) Optically thin (ISM) cooling
   ism_cooling = pin->GetOrAddBoolean(block, "ism_cooling", false);
   if (ism_cooling) {
-    hrate = pin->GetReal(block, "hrate");
+    // cooling (and optionally heating) rates can be read from a table in place of the
+    // analytic ISM cooling curve.  Heating rate from table replaces hrate.
+    if (pin->DoesParameterExist(block, "cooling_table")) {
+      ReadCoolingTable(pin->GetString(block, "cooling_table"),
+                       pin->GetOrAddInteger(block, "cooling_table_npoints", 1024));
+    }
+    if (heat_tab) {
+      hrate = pin->GetOrAddReal(block, "hrate", 0.0);
+    } else {
+      hrate = pin->GetReal(block, "hrate");
+    }
+    cool_subcycle = pin->GetOrAddBoolean(block, "cooling_subcycle", false);
+    if (cool_subcycle) {
+      cool_cfl = pin->GetOrAddReal(block, "cooling_cfl", 0.1);
+      cool_nsub_max = pin->GetOrAddInteger(block, "cooling_nsub_max", 1000);
+    }
   }
 
   // (3) beam source (radiation)
@@ -107,9 +137,82 @@ void SourceTerms::ConstantAccel(const DvceArray5D<Real> &w0, const EOS_Data &eos
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void SourceTerms::ReadCoolingTable()
+//! \brief Reads cooling (and optionally heating) rates from a 1D table in the format read
+//! by TableReader, with points in temperature T [K] and fields "Lambda" (cooling rate,
+//! erg cm^3/s) and optionally "Gamma" (heating rate, erg/s).  Rates are resampled onto
+//! npoints uniformly spaced in log10(T), so they can be interpolated on the device
+//! without a search.
+
+void SourceTerms::ReadCoolingTable(const std::string &fname, const int npoints) {
+  TableReader::Table table;
+  auto read_result = table.ReadTable(fname);
+  if (read_result.error != TableReader::ReadResult::SUCCESS) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Cooling table '" << fname << "' could not be read: "
+              << read_result.message << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  auto &point_info = table.GetPointInfo();
+  if (table.GetNDimensions() != 1 || !(table.HasField("Lambda")) ||
+      point_info[0].second < 2 || npoints < 2) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Cooling table '" << fname << "' must have one dimension "
+              << "(T) with at least 2 points, and a field 'Lambda'" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  cool_tab = true;
+  heat_tab = table.HasField("Gamma");
+
+  // log10 of input temperatures and rates
+  int nin = static_cast<int>(point_info[0].second);
+  double *tin = table[point_info[0].first];
+  double *lin = table["Lambda"];
+  double *gin = (heat_tab)? table["Gamma"] : nullptr;
+  const Real tiny = std::numeric_limits<float>::min();
+  std::vector<Real> logt_in(nin), logl_in(nin), logg_in(nin, 0.0);
+  for (int n=0; n<nin; ++n) {
+    if (tin[n] <= 0.0 || (n > 0 && tin[n] <= tin[n-1])) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Temperatures in cooling table '" << fname
+                << "' must be positive and increasing" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    logt_in[n] = log10(tin[n]);
+    logl_in[n] = log10(std::max(static_cast<Real>(lin[n]), tiny));
+    if (heat_tab) {logg_in[n] = log10(std::max(static_cast<Real>(gin[n]), tiny));}
+  }
+
+  // resample onto table uniform in log10(T)
+  ntab = npoints;
+  logt_min = logt_in[0];
+  dlogt = (logt_in[nin-1] - logt_min)/static_cast<Real>(ntab-1);
+  Kokkos::realloc(log_lambda, ntab);
+  Kokkos::realloc(log_gamma, (heat_tab)? ntab : 1);
+  auto log_lambda_h = Kokkos::create_mirror_view(log_lambda);
+  auto log_gamma_h = Kokkos::create_mirror_view(log_gamma);
+  int nl = 0;
+  for (int n=0; n<ntab; ++n) {
+    Real logt = logt_min + static_cast<Real>(n)*dlogt;
+    while (nl < nin-2 && logt_in[nl+1] < logt) {nl++;}
+    Real f = (logt - logt_in[nl])/(logt_in[nl+1] - logt_in[nl]);
+    f = std::min(std::max(f, static_cast<Real>(0.0)), static_cast<Real>(1.0));
+    log_lambda_h(n) = (1.0 - f)*logl_in[nl] + f*logl_in[nl+1];
+    if (heat_tab) {log_gamma_h(n) = (1.0 - f)*logg_in[nl] + f*logg_in[nl+1];}
+  }
+  Kokkos::deep_copy(log_lambda, log_lambda_h);
+  Kokkos::deep_copy(log_gamma, log_gamma_h);
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void SourceTerms::ISMCooling()
 //! \brief Add explict ISM cooling and heating source terms in the energy equations.
+//! Rates are given by ISMCoolFn() and hrate, or by <block>/cooling_table.  With
+//! <block>/cooling_subcycle, the internal energy of each cell is integrated over the
+//! (partial) timestep with subcycles limited to cooling_cfl times the cooling time, and
+//! to the temperature floor, so that cooling need not limit the timestep.
 // NOTE source terms must be computed using primitive (w0) and NOT conserved (u0) vars
 
 void SourceTerms::ISMCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos_data,
@@ -122,6 +225,7 @@ void SourceTerms::ISMCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
   Real use_e = eos_data.use_e;
   Real gamma = eos_data.gamma;
   Real gm1 = gamma - 1.0;
+  Real tfloor = eos_data.tfloor;
   Real heating_rate = hrate;
   Real temp_unit = pmy_pack->punit->temperature_cgs();
   Real n_unit = pmy_pack->punit->density_cgs()/pmy_pack->punit->mu()
@@ -130,21 +234,62 @@ void SourceTerms::ISMCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
                       /n_unit/n_unit;
   Real heating_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()/n_unit;
 
+  bool cool_tab_ = cool_tab, heat_tab_ = heat_tab;
+  int ntab_ = ntab;
+  Real logt_min_ = logt_min, dlogt_ = dlogt;
+  auto log_lambda_ = log_lambda;
+  auto log_gamma_ = log_gamma;
+  bool subcycle = cool_subcycle;
+  Real cfl = cool_cfl;
+  int nsub_max = cool_nsub_max;
+
   par_for("cooling", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
   KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    // temperature in cgs unit
-    Real temp = 1.0;
+    Real rho = w0(m,IDN,k,j,i);
+    // net cooling rate per particle (n*Lambda - Gamma) at temperature t in cgs unit
+    auto net_cool = [&](const Real t) {
+      Real lambda_cooling, gamma_heating;
+      if (cool_tab_) {
+        lambda_cooling = LogTableFn(log_lambda_,ntab_,logt_min_,dlogt_,t)/cooling_unit;
+      } else {
+        lambda_cooling = ISMCoolFn(t)/cooling_unit;
+      }
+      if (heat_tab_) {
+        gamma_heating = LogTableFn(log_gamma_,ntab_,logt_min_,dlogt_,t)/heating_unit;
+      } else {
+        gamma_heating = heating_rate/heating_unit;
+      }
+      return (rho*lambda_cooling - gamma_heating);
+    };
+
+    // internal energy, and temperature in cgs unit
+    Real eint, temp;
     if (use_e) {
+      eint = w0(m,IEN,k,j,i);
       temp = temp_unit*w0(m,IEN,k,j,i)/w0(m,IDN,k,j,i)*gm1;
     } else {
+      eint = w0(m,ITM,k,j,i)*rho/gm1;
       temp = temp_unit*w0(m,ITM,k,j,i);
     }
 
-    Real lambda_cooling = ISMCoolFn(temp)/cooling_unit;
-    Real gamma_heating = heating_rate/heating_unit;
+    if (!(subcycle)) {
+      u0(m,IEN,k,j,i) -= bdt * rho * net_cool(temp);
+      return;
+    }
 
-    u0(m,IEN,k,j,i) -= bdt * w0(m,IDN,k,j,i) *
-                        (w0(m,IDN,k,j,i) * lambda_cooling - gamma_heating);
+    // subcycled integration over bdt
+    Real emin = rho*tfloor/gm1;
+    Real e = eint;
+    Real t = 0.0;
+    for (int nsub=0; (nsub < nsub_max) && (t < bdt); ++nsub) {
+      Real de = -rho*net_cool(temp_unit*gm1*e/rho);
+      if (de < 0.0 && e <= emin) break;
+      Real dts = bdt - t;
+      if (nsub < nsub_max-1 && de != 0.0) {dts = fmin(dts, cfl*e/fabs(de));}
+      e = fmax(e + dts*de, emin);
+      t += dts;
+    }
+    u0(m,IEN,k,j,i) += e - eint;
   });
 
   return;
@@ -194,17 +339,57 @@ void SourceTerms::RelCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn SourceTerms::BuildBeamList()
+//! \brief Compacts the entries set in the beam mask over active cells into beam_list, so
+//! that BeamSource() launches over only the cells and angles touched by the beam.
+
+void SourceTerms::BuildBeamList() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int ni = indcs.nx1, nji = indcs.nx2*ni, nkji = indcs.nx3*nji;
+  int nang = pmy_pack->prad->prgeo->nangles;
+  auto &beam_mask_ = pmy_pack->prad->beam_mask;
+  int nmb = std::min(pmy_pack->nmb_thispack, beam_mask_.extent_int(0));
+  std::int64_t ntot = static_cast<std::int64_t>(nmb)*nang*nkji;
+
+  // first pass counts entries, second pass fills list
+  auto &list = beam_list;
+  for (int pass=0; pass<2; ++pass) {
+    if (pass == 1) {Kokkos::realloc(beam_list, std::max(nbeam, 1), 2);}
+    int nsel = 0;
+    Kokkos::parallel_scan("beam_list", Kokkos::RangePolicy<DevExeSpace,
+                          Kokkos::IndexType<std::int64_t>>(DevExeSpace(), 0, ntot),
+    KOKKOS_LAMBDA(const std::int64_t idx, int &index, const bool final) {
+      int mn = static_cast<int>(idx/nkji);
+      int c = static_cast<int>(idx - static_cast<std::int64_t>(mn)*nkji);
+      int m = mn/nang, n = mn - m*nang;
+      int k = c/nji, j = (c - k*nji)/ni, i = c - k*nji - j*ni;
+      if (beam_mask_(m,n,k+ks,j+js,i+is)) {
+        if (final && pass == 1) {
+          list(index,0) = mn;
+          list(index,1) = c;
+        }
+        index++;
+      }
+    }, nsel);
+    nbeam = nsel;
+  }
+  beam_generation = pmy_pack->pmesh->ngeneration;
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn SourceTerms::BeamSource()
-// \brief Add beam of radiation
+// \brief Add beam of radiation to the entries in beam_list
 
 void SourceTerms::BeamSource(DvceArray5D<Real> &i0, const Real bdt) {
+  if (beam_generation != pmy_pack->pmesh->ngeneration) {BuildBeamList();}
+  if (nbeam == 0) {return;}
   auto &indcs = pmy_pack->pmesh->mb_indcs;
-  int is = indcs.is, ie = indcs.ie;
-  int js = indcs.js, je = indcs.je;
-  int ks = indcs.ks, ke = indcs.ke;
-  int nmb1 = (pmy_pack->nmb_thispack-1);
-  int nang1 = (pmy_pack->prad->prgeo->nangles-1);
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int ni = indcs.nx1, nji = indcs.nx2*ni;
+  int nang = pmy_pack->prad->prgeo->nangles;
 
   auto &nh_c_ = pmy_pack->prad->nh_c;
   auto &tt = pmy_pack->prad->tet_c;
@@ -214,22 +399,26 @@ void SourceTerms::BeamSource(DvceArray5D<Real> &i0, const Real bdt) {
   auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
   Real &n_0_floor_ = pmy_pack->prad->n_0_floor;
 
-  auto &beam_mask_ = pmy_pack->prad->beam_mask;
+  auto &list = beam_list;
   Real &dii_dt_ = dii_dt;
-  par_for("beam_source",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-    if (beam_mask_(m,n,k,j,i)) {
-      Real n0 = tt(m,0,0,k,j,i);
-      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)
-               + tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
-      i0(m,n,k,j,i) += n0*n_0*dii_dt_*bdt;
-      // handle excision
-      // NOTE(@pdmullen): exicision criterion are not finalized.  The below zeroes all
-      // intensities within rks <= 1.0 and zeroes intensities within angles where n_0
-      // is about zero.  This needs future attention.
-      if (excise) {
-        if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { i0(m,n,k,j,i) = 0.0; }
-      }
+  par_for("beam_source",DevExeSpace(),0,(nbeam-1),
+  KOKKOS_LAMBDA(int b) {
+    int m = list(b,0)/nang, n = list(b,0) - m*nang;
+    int c = list(b,1);
+    int k = c/nji, j = (c - k*nji)/ni, i = c - k*nji - j*ni;
+    k += ks;
+    j += js;
+    i += is;
+    Real n0 = tt(m,0,0,k,j,i);
+    Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)
+             + tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+    i0(m,n,k,j,i) += n0*n_0*dii_dt_*bdt;
+    // handle excision
+    // NOTE(@pdmullen): exicision criterion are not finalized.  The below zeroes all
+    // intensities within rks <= 1.0 and zeroes intensities within angles where n_0
+    // is about zero.  This needs future attention.
+    if (excise) {
+      if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { i0(m,n,k,j,i) = 0.0; }
     }
   });
 
@@ -50,12 +50,30 @@ class SourceTerms {
   // heating rate used with ISM cooling
   Real hrate;
 
+  // optional cooling (and heating) rates from <block>/cooling_table, resampled onto a
+  // table uniform in log10(T) [K] holding log10 of the rates in cgs units
+  bool cool_tab;
+  bool heat_tab;
+  int ntab;
+  Real logt_min, dlogt;
+  DvceArray1D<Real> log_lambda, log_gamma;
+  // with <block>/cooling_subcycle, cooling is integrated in each cell with subcycles of
+  // at most cooling_cfl times the local cooling time, and does not limit the timestep
+  bool cool_subcycle;
+  Real cool_cfl;
+  int cool_nsub_max;
+
   // cooling rate used with relativistic cooling
   Real crate_rel;
   Real cpower_rel;
 
-  // beam source
+  // beam source, applied only to the (MeshBlock, angle, cell) entries set in the beam
+  // mask, stored as beam_list(b,0) = m*nangles + n and beam_list(b,1) = flat index of
+  // the active cell.  Rebuilt from the mask whenever the Mesh changes.
   Real dii_dt;
+  DvceArray2D<int> beam_list;
+  int nbeam;
+  int beam_generation;   // Mesh::ngeneration when beam_list was built
 
   // shearing box
   Real qshear, omega0;
@@ -79,6 +97,8 @@ class SourceTerms {
 
  private:
   MeshBlockPack *pmy_pack;
+  void ReadCoolingTable(const std::string &fname, const int npoints);
+  void BuildBeamList();
 };
 
 #endif  // SRCTERMS_SRCTERMS_HPP_
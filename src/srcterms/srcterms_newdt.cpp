@@ -32,7 +32,8 @@ void SourceTerms::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_d
   const int nji  = nx2*nx1;
   dtnew = static_cast<Real>(std::numeric_limits<float>::max());
 
-  if (ism_cooling) {
+  // with subcycled cooling, cooling does not limit the timestep
+  if (ism_cooling && !(cool_subcycle)) {
     Real use_e = eos_data.use_e;
     Real gamma = eos_data.gamma;
     Real gm1 = gamma - 1.0;
@@ -44,6 +45,11 @@ void SourceTerms::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_d
                         / n_unit/n_unit;
     Real heating_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()
                         / n_unit;
+    bool cool_tab_ = cool_tab, heat_tab_ = heat_tab;
+    int ntab_ = ntab;
+    Real logt_min_ = logt_min, dlogt_ = dlogt;
+    auto log_lambda_ = log_lambda;
+    auto log_gamma_ = log_gamma;
 
     // find smallest (e/cooling_rate) in each cell
     Kokkos::parallel_reduce("srcterms_cooling_newdt",
@@ -68,8 +74,17 @@ void SourceTerms::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_d
         eint = w0(m,ITM,k,j,i)*w0(m,IDN,k,j,i)/gm1;
       }
 
-      Real lambda_cooling = ISMCoolFn(temp)/cooling_unit;
-      Real gamma_heating = heating_rate/heating_unit;
+      Real lambda_cooling, gamma_heating;
+      if (cool_tab_) {
+        lambda_cooling = LogTableFn(log_lambda_,ntab_,logt_min_,dlogt_,temp)/cooling_unit;
+      } else {
+        lambda_cooling = ISMCoolFn(temp)/cooling_unit;
+      }
+      if (heat_tab_) {
+        gamma_heating = LogTableFn(log_gamma_,ntab_,logt_min_,dlogt_,temp)/heating_unit;
+      } else {
+        gamma_heating = heating_rate/heating_unit;
+      }
 
       // add a tiny number
       Real cooling_heating = FLT_MIN + fabs(w0(m,IDN,k,j,i) *
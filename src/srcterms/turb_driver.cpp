@@ -25,6 +25,105 @@
 #include "eos/ideal_c2p_mhd.hpp"
 #include "turb_driver.hpp"
 
+// number of modes whose coefficients along a pencil are held in scratch at once
+constexpr int nmode_batch = 32;
+// sums over mesh used to remove net momentum of force and normalise it
+using ForceSum = array_sum::array_type<Real,9>;
+
+//----------------------------------------------------------------------------------------
+//! \fn void ForcePencil()
+//! \brief Sums the modes with packed amplitudes amp (see InitializeModes()) along pencil
+//! (m,k,j) of MeshBlock m into frc(n,i).  Along a pencil the y- and z-factors of every
+//! mode are constant, so the 8 amplitudes of each component reduce to the coefficients of
+//! cos(kx*x) and sin(kx*x), which are computed in scratch array coef for batches of
+//! nmode_batch modes and then summed along i using the 1D tables xcos/xsin.  Must be
+//! called by all threads of the team.
+
+KOKKOS_INLINE_FUNCTION
+void ForcePencil(TeamMember_t member, const int m, const int k, const int j,
+                 const int is, const int ie, const int nmodes,
+                 const DualArray2D<Real> &amp, const DvceArray3D<Real> &xcos,
+                 const DvceArray3D<Real> &xsin, const DvceArray3D<Real> &ycos,
+                 const DvceArray3D<Real> &ysin, const DvceArray3D<Real> &zcos,
+                 const DvceArray3D<Real> &zsin, ScrArray2D<Real> &coef,
+                 ScrArray2D<Real> &frc) {
+  par_for_inner(member, is, ie, [&](const int i) {
+    frc(0,i) = 0.0;
+    frc(1,i) = 0.0;
+    frc(2,i) = 0.0;
+  });
+
+  for (int n0=0; n0<nmodes; n0+=nmode_batch) {
+    int nn = (nmodes - n0 < nmode_batch)? (nmodes - n0) : nmode_batch;
+    member.team_barrier();
+    // coef(2*component + sx, b) with sx=0 (sx=1) the coefficient of cos(kx*x) (sin)
+    par_for_inner(member, 0, nn-1, [&](const int b) {
+      int n = n0 + b;
+      Real yz[4];
+      yz[0] = ycos(m,n,j)*zcos(m,n,k);
+      yz[1] = ycos(m,n,j)*zsin(m,n,k);
+      yz[2] = ysin(m,n,j)*zcos(m,n,k);
+      yz[3] = ysin(m,n,j)*zsin(m,n,k);
+      for (int c=0; c<6; ++c) {
+        coef(c,b) = amp.d_view(n,4*c  )*yz[0] + amp.d_view(n,4*c+1)*yz[1]
+                  + amp.d_view(n,4*c+2)*yz[2] + amp.d_view(n,4*c+3)*yz[3];
+      }
+    });
+    member.team_barrier();
+
+    par_for_inner(member, is, ie, [&](const int i) {
+      Real f1 = 0.0, f2 = 0.0, f3 = 0.0;
+      for (int b=0; b<nn; ++b) {
+        Real c = xcos(m,n0+b,i);
+        Real s = xsin(m,n0+b,i);
+        f1 += coef(0,b)*c + coef(1,b)*s;
+        f2 += coef(2,b)*c + coef(3,b)*s;
+        f3 += coef(4,b)*c + coef(5,b)*s;
+      }
+      frc(0,i) += f1;
+      frc(1,i) += f2;
+      frc(2,i) += f3;
+    });
+  }
+  member.team_barrier();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PushForce()
+//! \brief Adds force (v1,v2,v3) in cell (m,k,j,i) over dt to conserved variables
+
+KOKKOS_INLINE_FUNCTION
+void PushForce(const int m, const int k, const int j, const int i, const Real v1,
+               const Real v2, const Real v3, const Real dt, const bool flag_relativistic,
+               const bool flag_twofl, const DvceArray5D<Real> &u0,
+               const DvceArray5D<Real> &u0_, const DvceArray5D<Real> &w0) {
+  Real den = u0(m,IDN,k,j,i);
+  if (flag_relativistic) {
+    // Compute Lorentz factor
+    auto &ux = w0(m,IVX,k,j,i);
+    auto &uy = w0(m,IVY,k,j,i);
+    auto &uz = w0(m,IVZ,k,j,i);
+
+    Real ut = 1. + ux*ux + uy*uy + uz*uz;
+    ut = sqrt(ut);
+    den /= ut;
+
+    Real Fv = (v1*ux + v2*uy + v3*uz)/ut;
+
+    u0(m,IEN,k,j,i) += Fv*den*dt;
+  }
+  u0(m,IM1,k,j,i) += den*v1*dt;
+  u0(m,IM2,k,j,i) += den*v2*dt;
+  u0(m,IM3,k,j,i) += den*v3*dt;
+
+  if (flag_twofl) {
+    den = u0_(m,IDN,k,j,i);
+    u0_(m,IM1,k,j,i) += den*v1*dt;
+    u0_(m,IM2,k,j,i) += den*v2*dt;
+    u0_(m,IM3,k,j,i) += den*v3*dt;
+  }
+}
+
 //----------------------------------------------------------------------------------------
 // constructor, initializes data structures and parameters
 
@@ -40,16 +139,20 @@ TurbulenceDriver::TurbulenceDriver(MeshBlockPack *pp, ParameterInput *pin) :
   zscc("zscc",1),zscs("zscs",1),zssc("zssc",1),zsss("zsss",1),
   kx_mode("kx_mode",1),ky_mode("ky_mode",1),kz_mode("kz_mode",1),
   xcos("xcos",1,1,1),xsin("xsin",1,1,1),ycos("ycos",1,1,1),
-  ysin("ysin",1,1,1),zcos("zcos",1,1,1),zsin("zsin",1,1,1) {
-  // allocate memory for force registers
+  ysin("ysin",1,1,1),zcos("zcos",1,1,1),zsin("zsin",1,1,1),
+  amp_new("amp_new",1,1),amp_force("amp_force",1,1) {
+  // allocate memory for force registers, which are not needed with modal forcing
   int nmb = pmy_pack->nmb_thispack;
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int ncells1 = indcs.nx1 + 2*(indcs.ng);
   int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
   int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
 
-  Kokkos::realloc(force, nmb, 3, ncells3, ncells2, ncells1);
-  Kokkos::realloc(force_tmp, nmb, 3, ncells3, ncells2, ncells1);
+  modal_forcing = pin->GetOrAddBoolean("turb_driving", "modal_forcing", false);
+  if (!(modal_forcing)) {
+    Kokkos::realloc(force, nmb, 3, ncells3, ncells2, ncells1);
+    Kokkos::realloc(force_tmp, nmb, 3, ncells3, ncells2, ncells1);
+  }
 
   // range of modes including, corresponding to kmin and kmax
   nlow = pin->GetOrAddInteger("turb_driving", "nlow", 1);
@@ -134,6 +237,11 @@ TurbulenceDriver::TurbulenceDriver(MeshBlockPack *pp, ParameterInput *pin) :
   Kokkos::realloc(zcos, nmb, mode_count, ncells3);
   Kokkos::realloc(zsin, nmb, mode_count, ncells3);
 
+  Kokkos::realloc(amp_new, mode_count, 24);
+  if (modal_forcing) {
+    Kokkos::realloc(amp_force, mode_count, 24);
+  }
+
   Initialize();
 }
 
@@ -161,12 +269,21 @@ void TurbulenceDriver::Initialize() {
   int &nx2 = indcs.nx2;
   int &nx3 = indcs.nx3;
 
-  auto force_ = force;
-  par_for("force_init_pgen",DevExeSpace(),
-          0,nmb-1,0,2,0,ncells3-1,0,ncells2-1,0,ncells1-1,
-  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-    force_(m,n,k,j,i) = 0.0;
-  });
+  if (modal_forcing) {
+    Kokkos::deep_copy(amp_force.d_view, 0.0);
+    amp_force.template modify<DevExeSpace>();
+    for (int c=0; c<3; ++c) {
+      mean_new[c] = 0.0;
+      mean_force[c] = 0.0;
+    }
+  } else {
+    auto force_ = force;
+    par_for("force_init_pgen",DevExeSpace(),
+            0,nmb-1,0,2,0,ncells3-1,0,ncells2-1,0,ncells1-1,
+    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      force_(m,n,k,j,i) = 0.0;
+    });
+  }
 
   rstate.idum = -1;
 
@@ -282,8 +399,10 @@ void TurbulenceDriver::Initialize() {
 
 void TurbulenceDriver::IncludeInitializeModesTask(std::shared_ptr<TaskList> tl,
                                                   TaskID start) {
-  auto id_init = tl->AddTask(&TurbulenceDriver::InitializeModes, this, start);
-  auto id_add = tl->AddTask(&TurbulenceDriver::AddForcing, this, id_init);
+  auto id_init = tl->AddTask(&TurbulenceDriver::InitializeModes, this, start,
+                             "Turb_InitializeModes");
+  auto id_add = tl->AddTask(&TurbulenceDriver::AddForcing, this, id_init,
+                            "Turb_AddForcing");
   return;
 }
 
@@ -298,15 +417,18 @@ void TurbulenceDriver::IncludeAddForcingTask(std::shared_ptr<TaskList> tl, TaskI
   if (pmy_pack->pionn == nullptr) {
     if (pmy_pack->phydro != nullptr) {
       auto id = tl->InsertTask(&TurbulenceDriver::AddForcing, this,
-                              pmy_pack->phydro->id.flux, pmy_pack->phydro->id.rkupdt);
+                              pmy_pack->phydro->id.flux, pmy_pack->phydro->id.rkupdt,
+                              "Turb_AddForcing");
     }
     if (pmy_pack->pmhd != nullptr) {
       auto id = tl->InsertTask(&TurbulenceDriver::AddForcing, this,
-                              pmy_pack->pmhd->id.flux, pmy_pack->pmhd->id.rkupdt);
+                              pmy_pack->pmhd->id.flux, pmy_pack->pmhd->id.rkupdt,
+                              "Turb_AddForcing");
     }
   } else {
     auto id = tl->InsertTask(&TurbulenceDriver::AddForcing, this,
-                            pmy_pack->pionn->id.n_flux, pmy_pack->pionn->id.n_rkupdt);
+                            pmy_pack->pionn->id.n_flux, pmy_pack->pionn->id.n_rkupdt,
+                            "Turb_AddForcing");
   }
 
   return;
@@ -323,23 +445,14 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
   int ks = indcs.ks, ke = indcs.ke;
-  int &nx1 = indcs.nx1;
-  int &nx2 = indcs.nx2;
-  int &nx3 = indcs.nx3;
   auto &gindcs = pm->mesh_indcs;
   int &gnx1 = gindcs.nx1;
   int &gnx2 = gindcs.nx2;
   int &gnx3 = gindcs.nx3;
 
   // Now compute new force using new random amplitudes and phases
-
-  // Zero out new force array
   auto force_tmp_ = force_tmp;
   int &nmb = pmy_pack->nmb_thispack;
-  par_for("force_init", DevExeSpace(),0,nmb-1,0,2,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-    force_tmp_(m,n,k,j,i) = 0.0;
-  });
 
   int nlow_sqr = SQR(nlow);
   int nhigh_sqr = SQR(nhigh);
@@ -609,95 +722,18 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
     }
   }
 
-  xccc_.template modify<HostMemSpace>();
-  xccc_.template sync<DevExeSpace>();
-  xccs_.template modify<HostMemSpace>();
-  xccs_.template sync<DevExeSpace>();
-  xcsc_.template modify<HostMemSpace>();
-  xcsc_.template sync<DevExeSpace>();
-  xcss_.template modify<HostMemSpace>();
-  xcss_.template sync<DevExeSpace>();
-  xscc_.template modify<HostMemSpace>();
-  xscc_.template sync<DevExeSpace>();
-  xscs_.template modify<HostMemSpace>();
-  xscs_.template sync<DevExeSpace>();
-  xssc_.template modify<HostMemSpace>();
-  xssc_.template sync<DevExeSpace>();
-  xsss_.template modify<HostMemSpace>();
-  xsss_.template sync<DevExeSpace>();
-
-  yccc_.template modify<HostMemSpace>();
-  yccc_.template sync<DevExeSpace>();
-  yccs_.template modify<HostMemSpace>();
-  yccs_.template sync<DevExeSpace>();
-  ycsc_.template modify<HostMemSpace>();
-  ycsc_.template sync<DevExeSpace>();
-  ycss_.template modify<HostMemSpace>();
-  ycss_.template sync<DevExeSpace>();
-  yscc_.template modify<HostMemSpace>();
-  yscc_.template sync<DevExeSpace>();
-  yscs_.template modify<HostMemSpace>();
-  yscs_.template sync<DevExeSpace>();
-  yssc_.template modify<HostMemSpace>();
-  yssc_.template sync<DevExeSpace>();
-  ysss_.template modify<HostMemSpace>();
-  ysss_.template sync<DevExeSpace>();
-
-  zccc_.template modify<HostMemSpace>();
-  zccc_.template sync<DevExeSpace>();
-  zccs_.template modify<HostMemSpace>();
-  zccs_.template sync<DevExeSpace>();
-  zcsc_.template modify<HostMemSpace>();
-  zcsc_.template sync<DevExeSpace>();
-  zcss_.template modify<HostMemSpace>();
-  zcss_.template sync<DevExeSpace>();
-  zscc_.template modify<HostMemSpace>();
-  zscc_.template sync<DevExeSpace>();
-  zscs_.template modify<HostMemSpace>();
-  zscs_.template sync<DevExeSpace>();
-  zssc_.template modify<HostMemSpace>();
-  zssc_.template sync<DevExeSpace>();
-  zsss_.template modify<HostMemSpace>();
-  zsss_.template sync<DevExeSpace>();
-
-  auto xcos_ = xcos;
-  auto xsin_ = xsin;
-  auto ycos_ = ycos;
-  auto ysin_ = ysin;
-  auto zcos_ = zcos;
-  auto zsin_ = zsin;
-
-  for (int n=0; n<mode_count_; n++) {
-    par_for("force_compute", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-    KOKKOS_LAMBDA(int m, int k, int j, int i) {
-      force_tmp_(m,0,k,j,i) += xccc_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xccs_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xcsc_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xcss_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xscc_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xscs_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xssc_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xsss_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-
-      force_tmp_(m,1,k,j,i) += yccc_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yccs_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,1,k,j,i) += ycsc_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += ycss_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yscc_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yscs_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yssc_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += ysss_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-
-      force_tmp_(m,2,k,j,i) += zccc_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zccs_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zcsc_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zcss_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zscc_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zscs_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zssc_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zsss_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-    });
+  // pack amplitudes of new force as (mode, 8*component + 4*sx + 2*sy + sz), where sx=1
+  // (sx=0) denotes sin (cos) in x, etc.  This is the layout used by ForcePencil().
+  DualArray1D<Real> *amp[24] = {&xccc, &xccs, &xcsc, &xcss, &xscc, &xscs, &xssc, &xsss,
+                                &yccc, &yccs, &ycsc, &ycss, &yscc, &yscs, &yssc, &ysss,
+                                &zccc, &zccs, &zcsc, &zcss, &zscc, &zscs, &zssc, &zsss};
+  for (int n=0; n<mode_count_; ++n) {
+    for (int c=0; c<24; ++c) {
+      amp_new.h_view(n,c) = amp[c]->h_view(n);
+    }
   }
+  amp_new.template modify<HostMemSpace>();
+  amp_new.template sync<DevExeSpace>();
 
   DvceArray5D<Real> u0, u0_;
   if (pmy_pack->phydro != nullptr) u0 = (pmy_pack->phydro->u0);
@@ -709,82 +745,88 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
     flag_twofl = true;
   }
 
-  const int nmkji = nmb*nx3*nx2*nx1;
-  const int nkji = nx3*nx2*nx1;
-  const int nji  = nx2*nx1;
-  Real t0 = 0.0, t1 = 0.0, t2 = 0.0, t3 = 0.0;
-
-  Kokkos::parallel_reduce("net_mom_1", Kokkos::RangePolicy<>(DevExeSpace(),0,nmkji),
-  KOKKOS_LAMBDA(const int &idx, Real &sum_t0, Real &sum_t1,
-                                Real &sum_t2, Real &sum_t3) {
-    // compute n,k,j,i indices of thread
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/nx1;
-    int i = (idx - m*nkji - k*nji - j*nx1) + is;
-    k += ks;
-    j += js;
-    Real den = u0(m,IDN,k,j,i);
-    if (flag_twofl) {
-      den += u0_(m,IDN,k,j,i);
-    }
-    sum_t0 += den;
-    sum_t1 += den*force_tmp_(m,0,k,j,i);
-    sum_t2 += den*force_tmp_(m,1,k,j,i);
-    sum_t3 += den*force_tmp_(m,2,k,j,i);
-  }, Kokkos::Sum<Real>(t0), Kokkos::Sum<Real>(t1),
-     Kokkos::Sum<Real>(t2), Kokkos::Sum<Real>(t3));
+  // Evaluate new force along each pencil (m,k,j), and in the same kernel accumulate the
+  // sums over the mesh needed to remove its net momentum and normalise it to the energy
+  // injection rate: rho, rho*f, rho*f^2, M.f and M.  With modal forcing the new force is
+  // only reduced, not stored.
+  auto amp_new_ = amp_new;
+  auto xcos_ = xcos;
+  auto xsin_ = xsin;
+  auto ycos_ = ycos;
+  auto ysin_ = ysin;
+  auto zcos_ = zcos;
+  auto zsin_ = zsin;
+  bool store_force = !(modal_forcing);
+  const int nk = ke - ks + 1;
+  const int nj = je - js + 1;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int scr_level = 0;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(6, nmode_batch) +
+                    ScrArray2D<Real>::shmem_size(3, ncells1);
+  ForceSum sum;
+
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), nmb*nk*nj, Kokkos::AUTO);
+  policy.set_scratch_size(scr_level, Kokkos::PerTeam(scr_size));
+  Kokkos::parallel_reduce("force_compute", policy,
+  KOKKOS_LAMBDA(TeamMember_t member, ForceSum &team_sum) {
+    const int m = (member.league_rank())/(nk*nj);
+    const int k = (member.league_rank() - m*nk*nj)/nj + ks;
+    const int j = (member.league_rank())%nj + js;
+    ScrArray2D<Real> coef(member.team_scratch(scr_level), 6, nmode_batch);
+    ScrArray2D<Real> frc(member.team_scratch(scr_level), 3, ncells1);
+    ForcePencil(member, m, k, j, is, ie, mode_count_, amp_new_, xcos_, xsin_, ycos_,
+                ysin_, zcos_, zsin_, coef, frc);
+
+    ForceSum pencil_sum;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, is, ie+1),
+    [&](const int i, ForceSum &psum) {
+      Real den  = u0(m,IDN,k,j,i);
+      Real mom1 = u0(m,IM1,k,j,i);
+      Real mom2 = u0(m,IM2,k,j,i);
+      Real mom3 = u0(m,IM3,k,j,i);
+      if (flag_twofl) {
+        den  += u0_(m,IDN,k,j,i);
+        mom1 += u0_(m,IM1,k,j,i);
+        mom2 += u0_(m,IM2,k,j,i);
+        mom3 += u0_(m,IM3,k,j,i);
+      }
+      Real v1 = frc(0,i);
+      Real v2 = frc(1,i);
+      Real v3 = frc(2,i);
+      if (store_force) {
+        force_tmp_(m,0,k,j,i) = v1;
+        force_tmp_(m,1,k,j,i) = v2;
+        force_tmp_(m,2,k,j,i) = v3;
+      }
 
+      psum.the_array[0] += den;
+      psum.the_array[1] += den*v1;
+      psum.the_array[2] += den*v2;
+      psum.the_array[3] += den*v3;
+      psum.the_array[4] += den*(v1*v1+v2*v2+v3*v3);
+      psum.the_array[5] += mom1*v1+mom2*v2+mom3*v3;
+      psum.the_array[6] += mom1;
+      psum.the_array[7] += mom2;
+      psum.the_array[8] += mom3;
+    }, Kokkos::Sum<ForceSum>(pencil_sum));
+    Kokkos::single(Kokkos::PerTeam(member), [&]() {
+      team_sum += pencil_sum;
+    });
+  }, Kokkos::Sum<ForceSum>(sum));
 
 #if MPI_PARALLEL_ENABLED
-  Real m[4], gm[4];
-  m[0] = t0; m[1] = t1; m[2] = t2; m[3] = t3;
-  MPI_Allreduce(m, gm, 4, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  t0 = gm[0]; t1 = gm[1]; t2 = gm[2]; t3 = gm[3];
+  MPI_Allreduce(MPI_IN_PLACE, sum.the_array, 9, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
 #endif
 
-  par_for("force_remove_net_mom", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    force_tmp_(m,0,k,j,i) -= t1/t0;
-    force_tmp_(m,1,k,j,i) -= t2/t0;
-    force_tmp_(m,2,k,j,i) -= t3/t0;
-  });
-
-  t0 = 0.0;
-  t1 = 0.0;
-  Kokkos::parallel_reduce("net_mom_2", Kokkos::RangePolicy<>(DevExeSpace(),0,nmkji),
-  KOKKOS_LAMBDA(const int &idx, Real &sum_t0, Real &sum_t1) {
-    // compute n,k,j,i indices of thread
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/nx1;
-    int i = (idx - m*nkji - k*nji - j*nx1) + is;
-    k += ks;
-    j += js;
-
-    Real den  = u0(m,IDN,k,j,i);
-    Real mom1 = u0(m,IM1,k,j,i);
-    Real mom2 = u0(m,IM2,k,j,i);
-    Real mom3 = u0(m,IM3,k,j,i);
-    if (flag_twofl) {
-      den  += u0_(m,IDN,k,j,i);
-      mom1 += u0_(m,IM1,k,j,i);
-      mom2 += u0_(m,IM2,k,j,i);
-      mom3 += u0_(m,IM3,k,j,i);
-    }
-    Real v1 = force_tmp_(m,0,k,j,i);
-    Real v2 = force_tmp_(m,1,k,j,i);
-    Real v3 = force_tmp_(m,2,k,j,i);
-
-    sum_t0 += den*(v1*v1+v2*v2+v3*v3);
-    sum_t1 += mom1*v1+mom2*v2+mom3*v3;
-  }, Kokkos::Sum<Real>(t0), Kokkos::Sum<Real>(t1));
-
-#if MPI_PARALLEL_ENABLED
-  m[0] = t0; m[1] = t1;
-  MPI_Allreduce(m, gm, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  t0 = gm[0]; t1 = gm[1];
-#endif
+  // With <f> = sum rho*f/sum rho, the force with net momentum removed has
+  //   sum rho*(f - <f>)^2 = sum rho*f^2 - |sum rho*f|^2/sum rho
+  //   sum M.(f - <f>)     = sum M.f - <f>.sum M
+  Real *s_ = sum.the_array;
+  Real f1_avg = s_[1]/s_[0];
+  Real f2_avg = s_[2]/s_[0];
+  Real f3_avg = s_[3]/s_[0];
+  Real t0 = s_[4] - (SQR(s_[1]) + SQR(s_[2]) + SQR(s_[3]))/s_[0];
+  Real t1 = s_[5] - (f1_avg*s_[6] + f2_avg*s_[7] + f3_avg*s_[8]);
 
   t0 = std::max(t0, 1.0e-20);
   t1 = std::max(t1, 1.0e-20);
@@ -803,12 +845,24 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   }
   if (m0 == 0.0) s = 0.0;
 
-  par_for("force_norm", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    force_tmp_(m,0,k,j,i) *= s;
-    force_tmp_(m,1,k,j,i) *= s;
-    force_tmp_(m,2,k,j,i) *= s;
-  });
+  if (modal_forcing) {
+    // scale amplitudes of new force; its (constant) mean is stored separately
+    auto amp_n = amp_new.d_view;
+    par_for("force_norm", DevExeSpace(),0,mode_count_-1,0,23,
+    KOKKOS_LAMBDA(int n, int c) {
+      amp_n(n,c) *= s;
+    });
+    mean_new[0] = -s*f1_avg;
+    mean_new[1] = -s*f2_avg;
+    mean_new[2] = -s*f3_avg;
+  } else {
+    par_for("force_norm", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      force_tmp_(m,0,k,j,i) = s*(force_tmp_(m,0,k,j,i) - f1_avg);
+      force_tmp_(m,1,k,j,i) = s*(force_tmp_(m,1,k,j,i) - f2_avg);
+      force_tmp_(m,2,k,j,i) = s*(force_tmp_(m,2,k,j,i) - f3_avg);
+    });
+  }
 
   return TaskStatus::complete;
 }
@@ -860,48 +914,63 @@ TaskStatus TurbulenceDriver::AddForcing(Driver *pdrive, int stage) {
     if (pmy_pack->pmhd != nullptr) w0 = (pmy_pack->pmhd->w0);
   }
 
-  auto force_ = force;
-  auto force_tmp_ = force_tmp;
-
-  par_for("force_OU_process",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    force_(m,0,k,j,i) = fcorr*force_(m,0,k,j,i) + gcorr*force_tmp_(m,0,k,j,i);
-    force_(m,1,k,j,i) = fcorr*force_(m,1,k,j,i) + gcorr*force_tmp_(m,1,k,j,i);
-    force_(m,2,k,j,i) = fcorr*force_(m,2,k,j,i) + gcorr*force_tmp_(m,2,k,j,i);
-  });
-
-  par_for("push",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    Real v1 = force_(m,0,k,j,i);
-    Real v2 = force_(m,1,k,j,i);
-    Real v3 = force_(m,2,k,j,i);
-
-    Real den = u0(m,IDN,k,j,i);
-    if (flag_relativistic) {
-      // Compute Lorentz factor
-      auto &ux = w0(m,IVX,k,j,i);
-      auto &uy = w0(m,IVY,k,j,i);
-      auto &uz = w0(m,IVZ,k,j,i);
+  if (modal_forcing) {
+    // O-U process acts on the mode amplitudes (and mean) of the force, which is then
+    // evaluated along each pencil inside the kernel that adds it to the fluid
+    auto amp_f = amp_force.d_view;
+    auto amp_n = amp_new.d_view;
+    par_for("force_OU_process",DevExeSpace(),0,mode_count-1,0,23,
+    KOKKOS_LAMBDA(int n, int c) {
+      amp_f(n,c) = fcorr*amp_f(n,c) + gcorr*amp_n(n,c);
+    });
+    amp_force.template modify<DevExeSpace>();
+    for (int c=0; c<3; ++c) {
+      mean_force[c] = fcorr*mean_force[c] + gcorr*mean_new[c];
+    }
 
-      Real ut = 1. + ux*ux + uy*uy + uz*uz;
-      ut = sqrt(ut);
-      den /= ut;
+    auto amp_force_ = amp_force;
+    auto xcos_ = xcos;
+    auto xsin_ = xsin;
+    auto ycos_ = ycos;
+    auto ysin_ = ysin;
+    auto zcos_ = zcos;
+    auto zsin_ = zsin;
+    int nmodes = mode_count;
+    Real f1_mean = mean_force[0];
+    Real f2_mean = mean_force[1];
+    Real f3_mean = mean_force[2];
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int scr_level = 0;
+    size_t scr_size = ScrArray2D<Real>::shmem_size(6, nmode_batch) +
+                      ScrArray2D<Real>::shmem_size(3, ncells1);
+    par_for_outer("push",DevExeSpace(),scr_size,scr_level,0,nmb-1,ks,ke,js,je,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray2D<Real> coef(member.team_scratch(scr_level), 6, nmode_batch);
+      ScrArray2D<Real> frc(member.team_scratch(scr_level), 3, ncells1);
+      ForcePencil(member, m, k, j, is, ie, nmodes, amp_force_, xcos_, xsin_, ycos_,
+                  ysin_, zcos_, zsin_, coef, frc);
+      par_for_inner(member, is, ie, [&](const int i) {
+        PushForce(m, k, j, i, frc(0,i) + f1_mean, frc(1,i) + f2_mean,
+                  frc(2,i) + f3_mean, dt, flag_relativistic, flag_twofl, u0, u0_, w0);
+      });
+    });
+  } else {
+    auto force_ = force;
+    auto force_tmp_ = force_tmp;
 
-      Real Fv = (v1*ux + v2*uy + v3*uz)/ut;
+    par_for("force_OU_process",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      force_(m,0,k,j,i) = fcorr*force_(m,0,k,j,i) + gcorr*force_tmp_(m,0,k,j,i);
+      force_(m,1,k,j,i) = fcorr*force_(m,1,k,j,i) + gcorr*force_tmp_(m,1,k,j,i);
+      force_(m,2,k,j,i) = fcorr*force_(m,2,k,j,i) + gcorr*force_tmp_(m,2,k,j,i);
+    });
 
-      u0(m,IEN,k,j,i) += Fv*den*dt;
-    }
-    u0(m,IM1,k,j,i) += den*v1*dt;
-    u0(m,IM2,k,j,i) += den*v2*dt;
-    u0(m,IM3,k,j,i) += den*v3*dt;
-
-    if (flag_twofl) {
-      den = u0_(m,IDN,k,j,i);
-      u0_(m,IM1,k,j,i) += den*v1*dt;
-      u0_(m,IM2,k,j,i) += den*v2*dt;
-      u0_(m,IM3,k,j,i) += den*v3*dt;
-    }
-  });
+    par_for("push",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      PushForce(m, k, j, i, force_(m,0,k,j,i), force_(m,1,k,j,i), force_(m,2,k,j,i),
+                dt, flag_relativistic, flag_twofl, u0, u0_, w0);
+    });
+  }
 
   const int nmkji = nmb*nx3*nx2*nx1;
   const int nkji = nx3*nx2*nx1;
@@ -32,6 +32,16 @@ class TurbulenceDriver {
   DualArray1D<Real> zccc, zccs, zcsc, zcss, zscc, zscs, zssc, zsss;
   DualArray1D<Real> kx_mode, ky_mode, kz_mode;
   DvceArray3D<Real> xcos, xsin, ycos, ysin, zcos, zsin;
+  // amplitudes of new force packed as (mode, 8*component + 4*sx + 2*sy + sz), with
+  // sx=1 (0) denoting sin (cos) in x, etc.
+  DualArray2D<Real> amp_new;
+
+  // With modal forcing, the O-U process evolves the mode amplitudes (amp_force) and mean
+  // of the force, which is evaluated inside the kernel adding it to the fluid, so that
+  // force and force_tmp are never allocated.
+  bool modal_forcing;
+  DualArray2D<Real> amp_force;
+  Real mean_new[3], mean_force[3];
 
   // parameters of driving
   int nlow, nhigh;
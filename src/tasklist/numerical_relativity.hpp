@@ -84,8 +84,10 @@ enum TaskName {
   Z4c_ClearRW,
   Z4c_Wave,
   Z4c_PT,
+  Z4c_PTEvolve,
   Z4c_CCE,
   Z4c_DumpHorizon,
+  Z4c_AHF,
   Z4c_NTASKS
 };
 
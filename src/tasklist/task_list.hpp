@@ -13,70 +13,114 @@
 // This version includes improvements due to Josh Dolence and the Parthenon dev team, and
 // extensions by J.M.Stone.
 
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
-#include <bitset>
+#include <deque>
 #include <functional>
+#include <string>
 #include <vector>
 #include <list>
 #include <iterator>
 
+#include <Kokkos_Core.hpp>
+
 class Driver;
 
-// Maximum size of TL
-#define NUMBER_TASKID_BITS 64
+// Maximum size of TL.  TaskIDs are stored as fixed arrays of 64-bit words, so the limit
+// can be increased by changing NUMBER_TASKID_WORDS without any heap allocations.
+#define NUMBER_TASKID_WORDS 4
+#define NUMBER_TASKID_BITS (64*(NUMBER_TASKID_WORDS))
 
 // constants = return codes for functions working on individual Tasks and TaskList
 enum class TaskStatus {fail, complete, incomplete};
 enum class TaskListStatus {running, stuck, complete, nothing_to_do};
 
+// strategies used by Driver to execute TaskLists
+//   poll  = sweep entire list each pass, checking dependencies of every Task
+//   queue = only execute Tasks in a ready queue built from the dependency graph
+enum class TaskListScheduler {poll, queue};
+
 //----------------------------------------------------------------------------------------
 //! \class TaskID
 //  \brief container class for bit fields (used to encode Task IDs) and access functions
+//  Bits are stored in NUMBER_TASKID_WORDS 64-bit words.  All operations are short,
+//  fixed-length loops over the words that compilers unroll and vectorize.
 
 class TaskID {
  public:
   TaskID() = default;
   // ctor, default id = 0.
   explicit TaskID(unsigned int id) {
-    if (id == 0) {
-      bitfld_.reset();      // set all bits to zero
-    } else {
-      bitfld_.set((--id));  // set [id-1] bit to one
+    if (id > (NUMBER_TASKID_BITS)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Number of Tasks in TaskList exceeds maximum of "
+                << (NUMBER_TASKID_BITS) << ", increase NUMBER_TASKID_WORDS" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    Clear();                // set all bits to zero
+    if (id != 0) {
+      --id;                 // set [id-1] bit to one
+      bitfld_[id/64] = (static_cast<std::uint64_t>(1) << (id%64));
     }
   }
 
   // functions (all implemented here)
-  void Clear() { bitfld_.reset(); }  // set all bits to zero
+  void Clear() { for (int n=0; n<(NUMBER_TASKID_WORDS); ++n) {bitfld_[n] = 0;} }
   // return true if input dependencies are clear
   bool CheckDependencies(const TaskID &dep) const {
-    return ((bitfld_ & dep.bitfld_) == dep.bitfld_);
+    std::uint64_t missing = 0;
+    for (int n=0; n<(NUMBER_TASKID_WORDS); ++n) {
+      missing |= (dep.bitfld_[n] & ~bitfld_[n]);
+    }
+    return (missing == 0);
   }
   // output ID (useful for debugging)
-  void PrintID() {std::cout << "TaskID = " << bitfld_.to_string() << std::endl;}
+  void PrintID() {
+    std::cout << "TaskID = ";
+    for (int n=(NUMBER_TASKID_WORDS)-1; n>=0; --n) {
+      for (int b=63; b>=0; --b) {std::cout << ((bitfld_[n] >> b) & 1);}
+    }
+    std::cout << std::endl;
+  }
   // mark task with input TaskID as complete
-  void SetComplete(const TaskID &rhs) { bitfld_ |= rhs.bitfld_; }
+  void SetComplete(const TaskID &rhs) {
+    for (int n=0; n<(NUMBER_TASKID_WORDS); ++n) {bitfld_[n] |= rhs.bitfld_[n];}
+  }
 
   // overload some operators
-  bool operator== (const TaskID &rhs) const {return (bitfld_ == rhs.bitfld_); }
-  bool operator!= (const TaskID &rhs) const {return (bitfld_ != rhs.bitfld_); }
+  bool operator== (const TaskID &rhs) const {
+    for (int n=0; n<(NUMBER_TASKID_WORDS); ++n) {
+      if (bitfld_[n] != rhs.bitfld_[n]) return false;
+    }
+    return true;
+  }
+  bool operator!= (const TaskID &rhs) const {return !(*this == rhs); }
   TaskID operator| (const TaskID &rhs) const {
     TaskID ret;
-    ret.bitfld_ = (bitfld_ | rhs.bitfld_);
+    for (int n=0; n<(NUMBER_TASKID_WORDS); ++n) {
+      ret.bitfld_[n] = (bitfld_[n] | rhs.bitfld_[n]);
+    }
     return ret;
   }
   TaskID operator^ (const TaskID &rhs) const {
     TaskID ret;
-    ret.bitfld_ = (bitfld_ ^ rhs.bitfld_);
+    for (int n=0; n<(NUMBER_TASKID_WORDS); ++n) {
+      ret.bitfld_[n] = (bitfld_[n] ^ rhs.bitfld_[n]);
+    }
     return ret;
   }
   TaskID operator& (const TaskID &rhs) const {
     TaskID ret;
-    ret.bitfld_ = (bitfld_ & rhs.bitfld_);
+    for (int n=0; n<(NUMBER_TASKID_WORDS); ++n) {
+      ret.bitfld_[n] = (bitfld_[n] & rhs.bitfld_[n]);
+    }
     return ret;
   }
 
  private:
-  std::bitset<NUMBER_TASKID_BITS> bitfld_;
+  std::uint64_t bitfld_[NUMBER_TASKID_WORDS] = {};
 };
 
 //----------------------------------------------------------------------------------------
@@ -86,12 +130,14 @@ class TaskID {
 
 class Task {
  public:
-  Task(TaskID id, TaskID dep, std::function<TaskStatus(Driver*, int)> func) :
-  myid_(id), dep_(dep), func_(func) {}
+  Task(TaskID id, TaskID dep, std::function<TaskStatus(Driver*, int)> func,
+       std::string name="") :
+  myid_(id), dep_(dep), name_(name), func_(func) {}
   // overloaded operator() calls task function
   TaskStatus operator()(Driver *d, int s) {return func_(d,s);}
   TaskID GetID() {return myid_;}
   TaskID GetDependency() {return dep_;}
+  const std::string &GetName() {return name_;}
   void SetComplete() {complete_ = true;}
   void SetIncomplete() {complete_ = false;}
   bool IsComplete() {return complete_;}
@@ -100,10 +146,17 @@ class Task {
     if ((dep_ & id) == id) {dep_ = ((dep_ ^ id) | newdep);}
   }
 
+  // timing statistics accumulated over all calls (only when TaskList profiling is on)
+  double host_time = 0.0;  // host wall time spent inside Task function (s)
+  double dvce_time = 0.0;  // host wall time plus fence of device work launched (s)
+  int ncalls = 0;          // number of calls to Task function
+  int nincomplete = 0;     // number of calls returning incomplete (e.g. MPI waits)
+  double wait_time = 0.0;  // host wall time spent in calls returning incomplete (s)
+
  private:
   TaskID myid_;    // encodes task ID in bitfld_
   TaskID dep_;     // encodes dependencies to other tasks in bitfld_
-  // bool lb_time_;   // flag to include this task in timing for automatic load balancing
+  std::string name_;  // label used in profiling output
   bool complete_ = false;
   std::function<TaskStatus(Driver*, int)> func_;  // ptr to Task function
 };
@@ -129,16 +182,41 @@ class TaskList {
   }
   int Size() {return task_list_.size();}
   bool Empty() {return task_list_.empty();}
+  int NumberReady() {return ready_.size();}
   void MarkTaskComplete(TaskID id) { tasks_completed_.SetComplete(id); }
   TaskID GetIDLastTask() {return task_list_.back().GetID();}
   // output diagnostics (useful for debugging)
   void PrintIDs() { for (auto &it : task_list_) {it.GetID().PrintID();} }
   void PrintDependencies() { for (auto &it : task_list_) {it.GetDependency().PrintID();} }
+  std::list<Task> &GetTasks() {return task_list_;}
+
+  // Timing of each Task.  With fence=true the device is synchronized after every Task,
+  // so that dvce_time includes the kernels launched by the Task (at cost of overlap).
+  void SetProfiling(bool profile, bool fence) {
+    profile_ = profile;
+    profile_fence_ = fence;
+  }
+  // Annotate each Task with a Kokkos Tools region (e.g. NVTX ranges in Nsight Systems).
+  void SetRegions(bool regions) {regions_ = regions;}
+  void ResetProfile() {
+    for (auto &it : task_list_) {
+      it.host_time = 0.0; it.dvce_time = 0.0; it.ncalls = 0; it.nincomplete = 0;
+      it.wait_time = 0.0;
+    }
+  }
 
   //
   void Reset() {
     tasks_completed_.Clear();  // TaskID Clear() fn
     for (auto &it : task_list_) { it.SetIncomplete(); }
+    // reset counters and ready queue used by DoReady()
+    if (!graph_built_) {BuildDependencyGraph();}
+    ready_.clear();
+    ncomplete_ = 0;
+    for (std::size_t n=0; n<task_ptr_.size(); ++n) {
+      nwait_[n] = ndep_[n];
+      if (nwait_[n] == 0) {ready_.push_back(n);}
+    }
   }
 
   // cycle through task list once, do any tasks whose dependencies are clear
@@ -146,7 +224,7 @@ class TaskList {
     for (auto &task : task_list_) {
       auto dep = task.GetDependency();
       if ( tasks_completed_.CheckDependencies(dep) && !(task.IsComplete()) ) {
-        TaskStatus status = task(d,s);  // calls Task function using overloaded operator()
+        TaskStatus status = RunTask(task, d, s);
         if (status == TaskStatus::complete) {
           task.SetComplete();              // set bool flag in task
           MarkTaskComplete(task.GetID());  // add TaskID to tasks_completed_
@@ -157,57 +235,95 @@ class TaskList {
     return TaskListStatus::running;
   }
 
+  // execute Tasks in ready queue until it is empty, or until every Task left in the
+  // queue has returned incomplete since the last Task completed (i.e. all remaining
+  // Tasks are waiting on communications).  Completed Tasks release their dependents
+  // into the queue, so Tasks whose dependencies are not clear are never checked.
+  // Returns stuck if no Task completed during the call.
+  TaskListStatus DoReady(Driver *d, int s) {
+    bool progress = false;
+    std::size_t nstale = 0;
+    while (!(ready_.empty()) && (nstale < ready_.size())) {
+      int n = ready_.front();
+      ready_.pop_front();
+      TaskStatus status = RunTask(*task_ptr_[n], d, s);
+      if (status == TaskStatus::complete) {
+        task_ptr_[n]->SetComplete();
+        MarkTaskComplete(task_ptr_[n]->GetID());
+        ncomplete_++;
+        for (auto &j : dependents_[n]) {
+          if (--nwait_[j] == 0) {ready_.push_back(j);}
+        }
+        nstale = 0;
+        progress = true;
+      } else {
+        ready_.push_back(n);  // re-queue at end, and try again after other ready Tasks
+        nstale++;
+      }
+    }
+    if (ncomplete_ == static_cast<int>(task_ptr_.size())) return TaskListStatus::complete;
+    if (!(progress)) return TaskListStatus::stuck;
+    return TaskListStatus::running;
+  }
+
   // ADD new Task with ID, given dependency, and a pointer to a static or non-member
   // function to the end of task list.  Returns ID of new task. Task function must have
   // arguments (Driver*, int). Usage:
   //     taskid = tl.AddTask(DoSomething, dependency, name);
   template <class F>
-  TaskID AddTask(F func, TaskID &dep) {
+  TaskID AddTask(F func, TaskID &dep, std::string name="") {
     auto size = task_list_.size();
     TaskID id(size+1);
+    graph_built_ = false;
     task_list_.push_back(
-      Task(id, dep, [=](Driver *d, int s) mutable -> TaskStatus {return func(d,s);}));
+      Task(id, dep, [=](Driver *d, int s) mutable -> TaskStatus {return func(d,s);},
+           name));
     return id;
   }
 
   // ADD new Task with ID, given dependency, and a pointer to a member function of
   // class T to the end of task list.  Returns ID of new task. Task function must have
   // arguments (Driver*, int).  Usage:
-  //     taskid = tl.AddTask(&T::DoSomething, T, dependency);
+  //     taskid = tl.AddTask(&T::DoSomething, T, dependency, name);
   template <class F, class T>
-  TaskID AddTask(F func, T *obj, TaskID &dep) {
+  TaskID AddTask(F func, T *obj, TaskID &dep, std::string name="") {
     auto size = task_list_.size();
     TaskID id(size+1);
+    graph_built_ = false;
     task_list_.push_back( Task(id, dep,
-       [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s);}) );
+       [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s);}, name) );
     return id;
   }
 
   // ADD new Task with ID, given dependency, and a std::function to the end of task
   // list. Returns ID of new task. Task function must have arguments (Driver*, int).
   // Usage:
-  //      taskid = tl.AddTask(DoSomething, dependency);
-  TaskID AddTask(std::function<TaskStatus(Driver*, int)> func, TaskID &dep) {
+  //      taskid = tl.AddTask(DoSomething, dependency, name);
+  TaskID AddTask(std::function<TaskStatus(Driver*, int)> func, TaskID &dep,
+                 std::string name="") {
     auto size = task_list_.size();
     TaskID id(size+1);
-    task_list_.push_back(Task(id, dep, func));
+    graph_built_ = false;
+    task_list_.push_back(Task(id, dep, func, name));
     return id;
   }
 
   // INSERT new Task with ID, given dependency, and a pointer to a member function of
   // class T in a position BEFORE the task with ID 'location'.  Returns ID of new task,
   // or taskID(0) if location not found. Usage:
-  //     taskid = tl.InsertTask(&T::DoSomething, T, dependency, location);
+  //     taskid = tl.InsertTask(&T::DoSomething, T, dependency, location, name);
   template <class F, class T>
-  TaskID InsertTask(F func, T *obj, TaskID &dep, TaskID &loc) {
+  TaskID InsertTask(F func, T *obj, TaskID &dep, TaskID &loc, std::string name="") {
     std::list<Task>::iterator it;
     for (it=task_list_.begin(); it!=task_list_.end(); ++it) {
       if (it->GetID() == loc) {
         auto size = task_list_.size();
         TaskID id(size+1);
+        graph_built_ = false;
         auto old_dep = it->GetDependency();
         task_list_.insert(it, Task(id, dep,
-           [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s); }));
+           [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s); },
+           name));
         // now change dependencies for all but this newly added Task
         for (auto it2=task_list_.begin(); it2!=task_list_.end(); ++it2) {
           if (it2->GetID() != id) {
@@ -223,6 +339,68 @@ class TaskList {
  protected:
   std::list<Task> task_list_;
   TaskID tasks_completed_;
+  bool profile_ = false;
+  bool profile_fence_ = false;
+  bool regions_ = false;
+
+  // calls Task function using overloaded operator(), timing call if profiling is on and
+  // wrapping it in a profiling region named after the Task if regions are on
+  TaskStatus RunTask(Task &task, Driver *d, int s) {
+    if (!(profile_) && !(regions_)) {return task(d,s);}
+    if (regions_) {
+      Kokkos::Profiling::pushRegion(task.GetName().empty() ? "Task" : task.GetName());
+    }
+    TaskStatus status = (profile_)? TimeTask(task, d, s) : task(d,s);
+    if (regions_) {Kokkos::Profiling::popRegion();}
+    return status;
+  }
+
+  TaskStatus TimeTask(Task &task, Driver *d, int s) {
+    auto t0 = std::chrono::steady_clock::now();
+    TaskStatus status = task(d,s);
+    auto t1 = std::chrono::steady_clock::now();
+    if (profile_fence_) {Kokkos::fence();}
+    auto t2 = std::chrono::steady_clock::now();
+    task.host_time += std::chrono::duration<double>(t1 - t0).count();
+    task.dvce_time += std::chrono::duration<double>(t2 - t0).count();
+    task.ncalls++;
+    if (status == TaskStatus::incomplete) {
+      task.nincomplete++;
+      task.wait_time += std::chrono::duration<double>(t1 - t0).count();
+    }
+    return status;
+  }
+
+  // dependency graph used by DoReady(), rebuilt whenever Tasks are added or inserted.
+  // Elements of std::list are never moved, so pointers into task_list_ remain valid.
+  bool graph_built_ = false;
+  int ncomplete_ = 0;
+  std::vector<Task*> task_ptr_;               // Tasks in order they appear in list
+  std::vector<std::vector<int>> dependents_;  // indices of Tasks depending on each Task
+  std::vector<int> ndep_;                     // number of dependencies of each Task
+  std::vector<int> nwait_;                    // number of dependencies not yet complete
+  std::deque<int> ready_;                     // Tasks with all dependencies complete
+
+  void BuildDependencyGraph() {
+    task_ptr_.clear();
+    for (auto &it : task_list_) {task_ptr_.push_back(&it);}
+    int ntask = task_ptr_.size();
+    dependents_.assign(ntask, std::vector<int>());
+    ndep_.assign(ntask, 0);
+    nwait_.assign(ntask, 0);
+    TaskID none(0);
+    for (int j=0; j<ntask; ++j) {
+      auto dep = task_ptr_[j]->GetDependency();
+      for (int i=0; i<ntask; ++i) {
+        auto id = task_ptr_[i]->GetID();
+        if ((i != j) && (id != none) && ((dep & id) == id)) {
+          dependents_[i].push_back(j);
+          ndep_[j]++;
+        }
+      }
+    }
+    graph_built_ = true;
+  }
 };
 
 #endif  // TASKLIST_TASK_LIST_HPP_
@@ -0,0 +1,257 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file affinity.cpp
+//! \brief Implementation of functions in affinity namespace
+
+#include <unistd.h>   // gethostname, sysconf
+#if defined(__linux__)
+#include <sched.h>    // sched_getaffinity, sched_setaffinity
+#endif
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "affinity.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+#if defined(KOKKOS_ENABLE_CUDA)
+#include <cuda_runtime.h>
+#elif defined(KOKKOS_ENABLE_HIP)
+#include <hip/hip_runtime.h>
+#endif
+
+namespace affinity {
+namespace {
+int local_rank = 0, local_size = 1, nnodes = 1;
+int ndevices = 0;         // devices visible to this rank
+int device = -1;          // device used by this rank (-1 if none or not yet known)
+bool device_set = false;  // true if device was chosen by Bind()
+bool pinned = false;      // true if host mask was set by Bind()
+std::string cpus = "unknown";
+#if MPI_PARALLEL_ENABLED
+MPI_Comm node_comm = MPI_COMM_NULL;
+#endif
+
+// parses a Linux cpu list, such as "0-11,24-35"
+std::vector<int> ParseCPUList(const std::string &s) {
+  std::vector<int> list;
+  std::size_t pos = 0;
+  while (pos < s.size()) {
+    std::size_t end = s.find(',', pos);
+    if (end == std::string::npos) {end = s.size();}
+    std::string item = s.substr(pos, end - pos);
+    int lo, hi;
+    if (std::sscanf(item.c_str(), "%d-%d", &lo, &hi) == 2) {
+      for (int c=lo; c<=hi; ++c) {list.push_back(c);}
+    } else if (std::sscanf(item.c_str(), "%d", &lo) == 1) {
+      list.push_back(lo);
+    }
+    pos = end + 1;
+  }
+  return list;
+}
+
+// formats a sorted list of cpus as ranges, such as "0-11,24-35"
+std::string FormatCPUList(const std::vector<int> &list) {
+  std::string s;
+  for (std::size_t n=0; n<list.size(); ) {
+    std::size_t m = n;
+    while (m+1 < list.size() && list[m+1] == list[m] + 1) {m++;}
+    if (!(s.empty())) {s += ",";}
+    s += std::to_string(list[n]);
+    if (m > n) {s += "-" + std::to_string(list[m]);}
+    n = m + 1;
+  }
+  return s;
+}
+
+// true if the device was selected on the command line or through the environment
+bool DeviceChosenByUser(int argc, char *argv[]) {
+  const char *opts[] = {"--kokkos-device-id", "--kokkos-map-device-id-by",
+                        "--kokkos-device", "--kokkos-ndevices", "--kokkos-num-devices"};
+  for (int i=1; i<argc; ++i) {
+    for (const char *opt : opts) {
+      if (std::strncmp(argv[i], opt, std::strlen(opt)) == 0) {return true;}
+    }
+  }
+  return (std::getenv("KOKKOS_DEVICE_ID") != nullptr ||
+          std::getenv("KOKKOS_MAP_DEVICE_ID_BY") != nullptr ||
+          std::getenv("KOKKOS_NUM_DEVICES") != nullptr);
+}
+
+// cpus attached to the same NUMA domain as device dev, or empty if not known
+std::vector<int> DeviceCPUs(const int dev) {
+  std::vector<int> list;
+  char busid[64] = {0};
+#if defined(KOKKOS_ENABLE_CUDA)
+  if (cudaDeviceGetPCIBusId(busid, sizeof(busid), dev) != cudaSuccess) {return list;}
+#elif defined(KOKKOS_ENABLE_HIP)
+  if (hipDeviceGetPCIBusId(busid, sizeof(busid), dev) != hipSuccess) {return list;}
+#else
+  (void) dev;
+  return list;
+#endif
+  // sysfs uses lower case and a 4 digit PCI domain, e.g. 0000:3b:00.0
+  std::string id(busid);
+  for (auto &c : id) {c = std::tolower(static_cast<unsigned char>(c));}
+  std::size_t colon = id.find(':');
+  if (colon != std::string::npos && colon > 4) {id = id.substr(colon - 4);}
+  std::ifstream f("/sys/bus/pci/devices/" + id + "/local_cpulist");
+  std::string s;
+  if (f && std::getline(f, s)) {list = ParseCPUList(s);}
+  return list;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void affinity::Bind()
+//! \brief Chooses the device of this rank and pins it to host cores, see affinity.hpp.
+//! Must be called by every rank after MPI is initialized and before Kokkos::initialize().
+
+void Bind(int argc, char *argv[]) {
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, global_variable::my_rank,
+                      MPI_INFO_NULL, &node_comm);
+  MPI_Comm_rank(node_comm, &local_rank);
+  MPI_Comm_size(node_comm, &local_size);
+  int leader = (local_rank == 0)? 1 : 0;
+  MPI_Allreduce(&leader, &nnodes, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+  // assign devices round-robin over the ranks on each node
+#if defined(KOKKOS_ENABLE_CUDA)
+  if (cudaGetDeviceCount(&ndevices) != cudaSuccess) {ndevices = 0;}
+#elif defined(KOKKOS_ENABLE_HIP)
+  if (hipGetDeviceCount(&ndevices) != hipSuccess) {ndevices = 0;}
+#endif
+  if (ndevices > 0 && !(DeviceChosenByUser(argc, argv))) {
+    device = local_rank % ndevices;
+    setenv("KOKKOS_DEVICE_ID", std::to_string(device).c_str(), 1);
+    device_set = true;
+  }
+
+#if defined(__linux__)
+  // cores this rank may use, and whether the launcher has already restricted them
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  std::vector<int> allowed;
+  if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+    for (int c=0; c<CPU_SETSIZE; ++c) {
+      if (CPU_ISSET(c, &mask)) {allowed.push_back(c);}
+    }
+  }
+  bool unbound = (!(allowed.empty()) &&
+                  static_cast<long>(allowed.size()) >= sysconf(_SC_NPROCESSORS_ONLN));
+
+  // candidate cores are those close to the device (if known), otherwise all cores
+  std::vector<int> cand = allowed;
+  if (unbound && device_set) {
+    std::vector<int> near = DeviceCPUs(device), both;
+    for (int c : near) {
+      if (CPU_ISSET(c, &mask)) {both.push_back(c);}
+    }
+    if (!(both.empty())) {cand = both;}
+  }
+
+  // ranks with the same candidate cores share them equally, in order of local rank
+  unsigned long long key = (unbound)? std::hash<std::string>{}(FormatCPUList(cand)) : 0;
+  int nshare = 1, ishare = 0;
+#if MPI_PARALLEL_ENABLED
+  std::vector<unsigned long long> keys(local_size);
+  MPI_Allgather(&key, 1, MPI_UNSIGNED_LONG_LONG, keys.data(), 1, MPI_UNSIGNED_LONG_LONG,
+                node_comm);
+  nshare = 0;
+  for (int r=0; r<local_size; ++r) {
+    if (keys[r] == key) {
+      if (r < local_rank) {ishare++;}
+      nshare++;
+    }
+  }
+#endif
+  if (unbound) {
+    int n = cand.size();
+    std::vector<int> mine(cand.begin() + (ishare*n)/nshare,
+                          cand.begin() + ((ishare+1)*n)/nshare);
+    if (mine.empty()) {mine = cand;}   // more ranks than cores
+    CPU_ZERO(&mask);
+    for (int c : mine) {CPU_SET(c, &mask);}
+    if (sched_setaffinity(0, sizeof(mask), &mask) == 0) {
+      pinned = true;
+      allowed = mine;
+    } else if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Could not set host core affinity" << std::endl;
+    }
+  }
+  cpus = FormatCPUList(allowed);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void affinity::Report()
+//! \brief Prints node, device and host cores of each rank on the first node.  Must be
+//! called once by every rank, after Kokkos::initialize().
+
+void Report() {
+  if (ndevices > 0 && !(device_set)) {
+#if defined(KOKKOS_ENABLE_CUDA)
+    device = Kokkos::Cuda().cuda_device();
+#elif defined(KOKKOS_ENABLE_HIP)
+    device = Kokkos::HIP().hip_device();
+#endif
+  }
+  char host[64] = {0};
+  gethostname(host, sizeof(host) - 1);
+  std::string dev = (device >= 0)? ("device " + std::to_string(device) +
+                                    (device_set? "" : " (user)")) : "no device";
+  const int len = 256;
+  char line[len];
+  std::snprintf(line, len, "  rank %d on %s: local rank %d of %d, %s, cores %s%s",
+                global_variable::my_rank, host, local_rank, local_size, dev.c_str(),
+                cpus.c_str(), (pinned? "" : " (inherited)"));
+
+  std::vector<char> lines(len*local_size);
+#if MPI_PARALLEL_ENABLED
+  MPI_Gather(line, len, MPI_CHAR, lines.data(), len, MPI_CHAR, 0, node_comm);
+#else
+  std::memcpy(lines.data(), line, len);
+#endif
+  if (global_variable::my_rank != 0) {return;}
+  std::cout << std::endl << "Rank binding (" << nnodes << " node(s), " << ndevices
+            << " visible device(s) per rank), ranks on first node:" << std::endl;
+  for (int r=0; r<local_size; ++r) {
+    std::cout << &lines[r*len] << std::endl;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void affinity::Finalize()
+//! \brief Frees the node-local communicator created by Bind().  Must be called once by
+//! every rank after Report() (whether or not the report was printed), before
+//! MPI_Finalize().
+
+void Finalize() {
+#if MPI_PARALLEL_ENABLED
+  if (node_comm != MPI_COMM_NULL) {MPI_Comm_free(&node_comm);}
+#endif
+  return;
+}
+
+} // namespace affinity
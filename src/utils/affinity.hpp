@@ -0,0 +1,32 @@
+#ifndef UTILS_AFFINITY_HPP_
+#define UTILS_AFFINITY_HPP_
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file affinity.hpp
+//! \brief Binding of MPI ranks to devices and host cores at startup.
+//!
+//! affinity::Bind() must be called after MPI is initialized and before Kokkos.  Ranks on
+//! the same node are found with MPI_Comm_split_type.  With CUDA or HIP, node-local rank
+//! l is assigned device (l % ndevices) through KOKKOS_DEVICE_ID, unless a device was
+//! already chosen with --kokkos-device-id, --kokkos-map-device-id-by, or the equivalent
+//! KOKKOS_* environment variables.  Then, if the launcher left the process free to run on
+//! every core of the node, it is pinned to an equal share of the cores close to its
+//! device (read from sysfs on Linux), or of all cores of the node without a device, so
+//! that host threads started by Kokkos inherit that mask.  A mask already restricted by
+//! the launcher (srun --cpu-bind, mpirun --bind-to, ...) is never changed.
+//! affinity::Report() prints the resulting topology of the ranks on the first node,
+//! unless <job>/affinity_report = false.  affinity::Finalize() frees the node-local
+//! communicator and must always be called after it.
+
+namespace affinity {
+
+void Bind(int argc, char *argv[]);
+void Report();
+void Finalize();
+
+} // namespace affinity
+
+#endif // UTILS_AFFINITY_HPP_
@@ -36,6 +36,8 @@ class CartesianGrid {
   bool is_cheby;
 
   // For simplicity, unravell all points into a 1d array
+  DvceArray2D<Real> interp_coord;  // coordinates of points (in the order of interp_vals)
+  int point_set;                   // index of points in pack's InterpolationService
   DualArray3D<Real> interp_vals;   // container for data interpolated to sphere
   void InterpolateToGrid(int nvars, DvceArray5D<Real> &val);  // interpolate to sphere
   void ResetCenter(Real center[3]);  // set indexing for interpolation
@@ -43,10 +45,7 @@ class CartesianGrid {
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
-  DualArray4D<int> interp_indcs;   // indices of MeshBlock and zones therein for interp
-  DualArray5D<Real> interp_wghts;  // weights for interpolation
-  void SetInterpolationIndices();      // set indexing for interpolation
-  void SetInterpolationWeights();      // set weights for interpolation
+  void SetInterpolationCoordinates();  // set coordinates of points for interpolation
 };
 
 #endif // UTILS_CART_GRID_HPP_
@@ -0,0 +1,103 @@
+#ifndef UTILS_FD_TILE_HPP_
+#define UTILS_FD_TILE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file fd_tile.hpp
+//! \brief tiled evaluation of the finite-difference operators in finite_diff.hpp.  A team
+//! loads a block of (tile + 2*NGHOST)^3 cells of every variable into scratch memory once,
+//! after which Dx, Dxx, Dxy, Lx and Diss can be evaluated for every cell of the tile from
+//! scratch by passing FDTile views in place of the DvceArray5D/AthenaTensor arguments.
+//! Each value is then read from global memory once per tile instead of once per stencil
+//! point of every derivative.
+
+#include "athena.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \struct FDTile
+//! \brief view of one scalar, vector or symmetric rank-2 tensor (stored as consecutive
+//! variables starting at n0, in the order of AthenaTensor) of a tile in scratch memory.
+//! Accessed with the global indices (m,[a,[b,]]k,j,i) of the arrays it replaces; m is
+//! ignored since a tile belongs to a single MeshBlock.
+
+struct FDTile {
+  Real *data;           // first element of tile in scratch
+  int n0;               // index of first variable of this view
+  int k0, j0, i0;       // global indices of first cell in tile (including ghosts)
+  int nt2, nt1;         // extent of tile in x2 and x1 (including ghosts)
+  int nt321;            // number of cells in tile (stride between variables)
+
+  KOKKOS_INLINE_FUNCTION
+  int Index(const int n, const int k, const int j, const int i) const {
+    return n*nt321 + ((k - k0)*nt2 + (j - j0))*nt1 + (i - i0);
+  }
+  KOKKOS_INLINE_FUNCTION
+  Real operator()(const int m, const int k, const int j, const int i) const {
+    return data[Index(n0, k, j, i)];
+  }
+  KOKKOS_INLINE_FUNCTION
+  Real operator()(const int m, const int a, const int k, const int j, const int i) const {
+    return data[Index(n0 + a, k, j, i)];
+  }
+  KOKKOS_INLINE_FUNCTION
+  Real operator()(const int m, const int a, const int b,
+                  const int k, const int j, const int i) const {
+    // index of (a,b) in upper triangle of 3x3 symmetric tensor, as in AthenaTensor
+    int lo = (a < b)? a : b, hi = (a < b)? b : a;
+    return data[Index(n0 + lo*(5 - lo)/2 + hi, k, j, i)];
+  }
+  // view of the same tile starting at variable n
+  KOKKOS_INLINE_FUNCTION
+  FDTile Var(const int n) const {
+    FDTile t = *this;
+    t.n0 = n;
+    return t;
+  }
+};
+
+namespace fd_tile {
+
+//----------------------------------------------------------------------------------------
+//! \fn size_t ScratchSize()
+//! \brief bytes of scratch memory needed for a tile of nvar variables with edge tile
+
+inline size_t ScratchSize(const int nvar, const int tile, const int ng) {
+  int nt = tile + 2*ng;
+  return ScrArray1D<Real>::shmem_size(static_cast<size_t>(nvar)*nt*nt*nt);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn FDTile Load()
+//! \brief loads variables [nl,nl+nvar) of cells [k0,k0+nt) x [j0,j0+nt) x [i0,i0+nt) of
+//! MeshBlock m of u into scr, clipped to the extent of u, and returns a view of the tile.
+//! The team must be synchronized with team_barrier() before the tile is read.
+
+KOKKOS_INLINE_FUNCTION
+FDTile Load(TeamMember_t const &member, const DvceArray5D<Real> &u, const int m,
+            const int nl, const int nvar, const int k0, const int j0, const int i0,
+            const int nt, const ScrArray1D<Real> &scr) {
+  FDTile t;
+  t.data = scr.data();
+  t.n0 = 0;
+  t.k0 = k0; t.j0 = j0; t.i0 = i0;
+  t.nt2 = nt; t.nt1 = nt;
+  t.nt321 = nt*nt*nt;
+  const int nk = (k0 + nt <= u.extent_int(2))? nt : u.extent_int(2) - k0;
+  const int nj = (j0 + nt <= u.extent_int(3))? nt : u.extent_int(3) - j0;
+  const int ni = (i0 + nt <= u.extent_int(4))? nt : u.extent_int(4) - i0;
+  Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nvar*nk*nj), [&](const int idx) {
+    int n = idx/(nk*nj);
+    int k = (idx - n*nk*nj)/nj;
+    int j = idx - n*nk*nj - k*nj;
+    Real *row = t.data + t.Index(n, k0 + k, j0 + j, i0);
+    Kokkos::parallel_for(Kokkos::ThreadVectorRange(member, ni), [&](const int i) {
+      row[i] = u(m, nl + n, k0 + k, j0 + j, i0 + i);
+    });
+  });
+  return t;
+}
+
+} // namespace fd_tile
+#endif // UTILS_FD_TILE_HPP_
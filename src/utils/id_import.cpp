@@ -0,0 +1,291 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file id_import.cpp
+//! \brief implements InitialDataImport, evaluation of external initial data on active
+//! cells with ghost cells filled by boundary communication
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Kokkos_Timer.hpp>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "mesh/mesh_refinement.hpp"
+#include "bvals/bvals.hpp"
+#include "id_import.hpp"
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn std::uint64_t HashKey()
+//! \brief 64-bit FNV-1a hash of a string, used to name cache files
+
+std::uint64_t HashKey(const std::string &key) {
+  std::uint64_t h = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// constructor, allocates arrays for the nvar imported fields and boundary buffers
+
+InitialDataImport::InitialDataImport(MeshBlockPack *ppack, ParameterInput *pin,
+                                     int nvar) :
+    nvar(nvar),
+    u("id_u",1,1,1,1,1),
+    pmy_pack(ppack),
+    coarse_u("id_coarse_u",1,1,1,1,1),
+    pbval_u(nullptr) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int nmb = pmy_pack->nmb_thispack;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  Kokkos::realloc(u, nmb, nvar, ncells3, ncells2, ncells1);
+  if (pmy_pack->pmesh->multilevel) {
+    int nccells1 = indcs.cnx1 + 2*(indcs.ng);
+    int nccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
+    int nccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(coarse_u, nmb, nvar, nccells3, nccells2, nccells1);
+  }
+
+  int nhw = static_cast<int>(std::thread::hardware_concurrency());
+  nthreads = pin->GetOrAddInteger("problem", "id_nthreads", std::max(1, nhw));
+  use_cache = pin->GetOrAddBoolean("problem", "id_cache", false);
+  cache_dir = pin->GetOrAddString("problem", "id_cache_dir", ".");
+
+  // boundary buffers; Z4c-type buffers so ghost cells at fine/coarse boundaries are
+  // filled with the same high-order prolongation as the metric during evolution
+  pbval_u = new MeshBoundaryValuesCC(ppack, pin, true);
+  pbval_u->InitializeBuffers(nvar);
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+
+InitialDataImport::~InitialDataImport() {
+  delete pbval_u;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::string InitialDataImport::LayoutKey()
+//! \brief string identifying the source and the MeshBlocks of this rank; cache files are
+//! only reused if their key matches exactly
+
+std::string InitialDataImport::LayoutKey(const std::string &source) const {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &size = pmy_pack->pmb->mb_size;
+  std::ostringstream key;
+  key << std::setprecision(17);
+  key << source << "|nvar=" << nvar << "|ng=" << indcs.ng
+      << "|nx=" << indcs.nx1 << "," << indcs.nx2 << "," << indcs.nx3;
+  for (int m=0; m<pmy_pack->nmb_thispack; ++m) {
+    key << "|" << pmy_pack->gids + m << ":"
+        << size.h_view(m).x1min << "," << size.h_view(m).x1max << ","
+        << size.h_view(m).x2min << "," << size.h_view(m).x2max << ","
+        << size.h_view(m).x3min << "," << size.h_view(m).x3max;
+  }
+  return key.str();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InitialDataImport::Import()
+//! \brief evaluate (or read from cache) the external data on active cells and on ghost
+//! cells outside non-periodic Mesh boundaries, then fill remaining ghost cells
+
+void InitialDataImport::Import(const std::string &source, EvalFunc func,
+                               bool thread_safe) {
+  auto *pmesh = pmy_pack->pmesh;
+  auto &indcs = pmesh->mb_indcs;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &msize = pmesh->mesh_size;
+  int is = indcs.is, ie = indcs.ie, nx1 = indcs.nx1;
+  int js = indcs.js, je = indcs.je, nx2 = indcs.nx2;
+  int ks = indcs.ks, ke = indcs.ke, nx3 = indcs.nx3;
+  int nmb = pmy_pack->nmb_thispack;
+  int ncells1 = u.extent_int(4);
+  int ncells2 = u.extent_int(3);
+  int ncells3 = u.extent_int(2);
+  bool per1 = (pmesh->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::periodic);
+  bool per2 = (pmesh->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::periodic);
+  bool per3 = (pmesh->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic);
+
+  // list cells to be evaluated, as flat indices into (m,k,j,i)
+  std::vector<int> cells;
+  std::vector<Real> x, y, z;
+  for (int m=0; m<nmb; ++m) {
+    for (int k=0; k<ncells3; ++k) {
+      Real x3v = CellCenterX(k-ks, nx3, size.h_view(m).x3min, size.h_view(m).x3max);
+      bool out3 = !per3 && (x3v < msize.x3min || x3v > msize.x3max);
+      for (int j=0; j<ncells2; ++j) {
+        Real x2v = CellCenterX(j-js, nx2, size.h_view(m).x2min, size.h_view(m).x2max);
+        bool out2 = !per2 && (x2v < msize.x2min || x2v > msize.x2max);
+        for (int i=0; i<ncells1; ++i) {
+          Real x1v = CellCenterX(i-is, nx1, size.h_view(m).x1min, size.h_view(m).x1max);
+          bool out1 = !per1 && (x1v < msize.x1min || x1v > msize.x1max);
+          bool active = (i >= is && i <= ie && j >= js && j <= je && k >= ks && k <= ke);
+          if (active || out1 || out2 || out3) {
+            cells.push_back(((m*ncells3 + k)*ncells2 + j)*ncells1 + i);
+            x.push_back(x1v);
+            y.push_back(x2v);
+            z.push_back(x3v);
+          }
+        }
+      }
+    }
+  }
+  int npts = static_cast<int>(cells.size());
+
+  DvceArray1D<int> cell("id_cell", std::max(1, npts));
+  DvceArray2D<Real> vals("id_vals", std::max(1, npts), nvar);
+  auto cell_h = Kokkos::create_mirror_view(cell);
+  auto vals_h = Kokkos::create_mirror_view(vals);
+  for (int p=0; p<npts; ++p) {
+    cell_h(p) = cells[p];
+  }
+
+  // try to read values from the cache file of this rank
+  std::string key = LayoutKey(source);
+  char fname[32];
+  std::snprintf(fname, sizeof(fname), "id_%016llx.%05d.bin",
+                static_cast<unsigned long long>(HashKey(key)),  // NOLINT(runtime/int)
+                global_variable::my_rank);
+  std::string cache_file = cache_dir + "/" + fname;
+  bool cached = false;
+  if (use_cache) {
+    std::ifstream in(cache_file, std::ios::binary);
+    if (in.good()) {
+      std::uint64_t len = 0;
+      std::int64_t npts_in = 0;
+      std::int32_t nvar_in = 0;
+      in.read(reinterpret_cast<char*>(&len), sizeof(len));
+      std::string key_in(len, ' ');
+      in.read(&key_in[0], len);
+      in.read(reinterpret_cast<char*>(&npts_in), sizeof(npts_in));
+      in.read(reinterpret_cast<char*>(&nvar_in), sizeof(nvar_in));
+      if (in.good() && key_in == key && npts_in == npts && nvar_in == nvar) {
+        in.read(reinterpret_cast<char*>(vals_h.data()),
+                static_cast<std::streamsize>(npts)*nvar*sizeof(Real));
+        cached = in.good();
+      }
+    }
+  }
+
+  // otherwise evaluate the external solution, split in chunks over host threads
+  Kokkos::Timer timer{};
+  if (!cached && npts > 0) {
+    int nt = (thread_safe)? std::max(1, std::min(nthreads, npts)) : 1;
+    if (nt == 1) {
+      func(npts, x.data(), y.data(), z.data(), vals_h.data());
+    } else {
+      int chunk = (npts + nt - 1)/nt;
+      std::vector<std::thread> pool;
+      for (int p0=0; p0<npts; p0+=chunk) {
+        int np = std::min(chunk, npts - p0);
+        pool.emplace_back(func, np, x.data() + p0, y.data() + p0, z.data() + p0,
+                          vals_h.data() + static_cast<size_t>(p0)*nvar);
+      }
+      for (auto &t : pool) {
+        t.join();
+      }
+    }
+    if (use_cache) {
+      std::ofstream out(cache_file, std::ios::binary);
+      std::uint64_t len = key.size();
+      std::int64_t npts_out = npts;
+      std::int32_t nvar_out = nvar;
+      out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+      out.write(key.data(), len);
+      out.write(reinterpret_cast<const char*>(&npts_out), sizeof(npts_out));
+      out.write(reinterpret_cast<const char*>(&nvar_out), sizeof(nvar_out));
+      out.write(reinterpret_cast<const char*>(vals_h.data()),
+                static_cast<std::streamsize>(npts)*nvar*sizeof(Real));
+    }
+  }
+  if (global_variable::my_rank == 0) {
+    int ntot = nmb*ncells3*ncells2*ncells1;
+    std::cout << "Initial data: " << npts << " of " << ntot << " cells on rank 0 "
+              << ((cached)? "read from " + cache_file :
+                  "evaluated in " + std::to_string(timer.seconds()) + " s")
+              << std::endl;
+  }
+
+  Kokkos::deep_copy(cell, cell_h);
+  Kokkos::deep_copy(vals, vals_h);
+  ExchangeGhosts(cell, vals, npts);
+  u_h = Kokkos::create_mirror_view(u);
+  Kokkos::deep_copy(u_h, u);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InitialDataImport::ExchangeGhosts()
+//! \brief store evaluated values in u, and fill other ghost cells in the same sequence
+//! as Driver::InitBoundaryValuesAndPrimitives().  The values evaluated outside the Mesh
+//! are stored again at the end, since they are exact.
+
+void InitialDataImport::ExchangeGhosts(const DvceArray1D<int> &cell,
+                                       const DvceArray2D<Real> &vals, int npts) {
+  auto *pmesh = pmy_pack->pmesh;
+  Scatter(cell, vals, npts);
+
+  // following functions return a TaskStatus, but it is ignored so cast to (void)
+  if (pmesh->multilevel) {
+    pmesh->pmr->RestrictCC(u, coarse_u, true);
+  }
+  (void) pbval_u->InitRecv(nvar);
+  (void) pbval_u->PackAndSendCC(u, coarse_u);
+  (void) pbval_u->ClearSend();
+  (void) pbval_u->ClearRecv();
+  (void) pbval_u->RecvAndUnpackCC(u, coarse_u);
+  // extrapolation BCs fill ghost cells of the coarse arrays outside the Mesh, used in
+  // prolongation next to the boundary (they need the Z4c extrapolation order)
+  if (pmy_pack->pz4c != nullptr && !(pmesh->strictly_periodic)) {
+    pbval_u->Z4cBCs(pmy_pack, pbval_u->u_in, u, coarse_u);
+  }
+  if (pmesh->multilevel) {
+    pbval_u->ProlongateCC(u, coarse_u, true);
+  }
+  Scatter(cell, vals, npts);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InitialDataImport::Scatter()
+//! \brief store values of the npts evaluated cells (flat indices cell) in u
+
+void InitialDataImport::Scatter(const DvceArray1D<int> &cell,
+                                const DvceArray2D<Real> &vals, int npts) {
+  int nvar_ = nvar;
+  int ncells1 = u.extent_int(4);
+  int ncells2 = u.extent_int(3);
+  int ncells3 = u.extent_int(2);
+  auto &u_ = u;
+  par_for("id_scatter",DevExeSpace(),0,npts-1,
+  KOKKOS_LAMBDA(const int p) {
+    int c = cell(p);
+    int i = c % ncells1; c /= ncells1;
+    int j = c % ncells2; c /= ncells2;
+    int k = c % ncells3;
+    int m = c/ncells3;
+    for (int n=0; n<nvar_; ++n) {
+      u_(m,n,k,j,i) = vals(p,n);
+    }
+  });
+}
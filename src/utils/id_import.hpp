@@ -0,0 +1,68 @@
+#ifndef UTILS_ID_IMPORT_HPP_
+#define UTILS_ID_IMPORT_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file id_import.hpp
+//! \brief Import of initial data computed by external (host only) solvers such as
+//! Lorene, Elliptica, SGRID or SpECTRE.  The external solution is only evaluated at the
+//! active cells of each MeshBlock, and at ghost cells outside non-periodic boundaries of
+//! the Mesh.  Evaluation may be split over host threads, and the evaluated data can be
+//! cached in a binary file (one per rank) keyed by the source and the MeshBlock layout,
+//! so re-runs with the same Mesh skip evaluation.  All other ghost cells are then filled
+//! by the usual boundary exchange (with prolongation at fine/coarse boundaries).
+//!
+//! Parameters read from the <problem> block:
+//!  - id_nthreads:  number of host threads used by thread-safe readers (default: all)
+//!  - id_cache:     read/write evaluated data from/to cache files (default: false)
+//!  - id_cache_dir: directory of cache files (default: ".")
+
+#include <functional>
+#include <string>
+
+#include "athena.hpp"
+
+// Forward declarations
+class MeshBlockPack;
+class MeshBoundaryValuesCC;
+class ParameterInput;
+
+//----------------------------------------------------------------------------------------
+//! \class InitialDataImport
+
+class InitialDataImport {
+ public:
+  //! Evaluates the imported fields at npts points with coordinates x,y,z, storing field
+  //! n at point p in vals[p*nvar + n]
+  using EvalFunc = std::function<void(int npts, const Real *x, const Real *y,
+                                      const Real *z, Real *vals)>;
+
+  InitialDataImport(MeshBlockPack *ppack, ParameterInput *pin, int nvar);
+  ~InitialDataImport();
+
+  //! Evaluate func (labelled by source, e.g. the data file and reader options, for the
+  //! cache) and fill u and u_h on all cells.  With thread_safe, func may be called
+  //! concurrently on disjoint chunks of points.
+  void Import(const std::string &source, EvalFunc func, bool thread_safe);
+
+  int nvar;                                 // number of imported fields
+  DvceArray5D<Real> u;                      // imported fields (including ghost cells)
+  HostArray5D<Real>::HostMirror u_h;        // host copy of u
+
+ private:
+  MeshBlockPack *pmy_pack;
+  int nthreads;                 // number of host threads for thread-safe readers
+  bool use_cache;
+  std::string cache_dir;
+  DvceArray5D<Real> coarse_u;   // imported fields on coarse mesh (with SMR/AMR)
+  MeshBoundaryValuesCC *pbval_u;
+
+  std::string LayoutKey(const std::string &source) const;
+  void ExchangeGhosts(const DvceArray1D<int> &cell, const DvceArray2D<Real> &vals,
+                      int npts);
+  void Scatter(const DvceArray1D<int> &cell, const DvceArray2D<Real> &vals, int npts);
+};
+
+#endif // UTILS_ID_IMPORT_HPP_
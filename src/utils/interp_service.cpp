@@ -0,0 +1,249 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file interp_service.cpp
+//! \brief implements InterpolationService, batched interpolation to sets of points
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "mb_locator.hpp"
+#include "transient_pool.hpp"
+#include "interp_service.hpp"
+
+//----------------------------------------------------------------------------------------
+// constructor
+
+InterpolationService::InterpolationService(MeshBlockPack *ppack) :
+    pmy_pack(ppack),
+    npts_total(0),
+    stale(true),
+    generation(-1),
+    coord("interp_coord",1,3),
+    indcs("interp_indcs",1,4),
+    wghts("interp_wghts",1,1,3),
+    executed(false),
+    vals("interp_vals",1) {
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int InterpolationService::AddPointSet()
+//! \brief add npts points (with coordinates to be set) to the points of all sets
+
+int InterpolationService::AddPointSet(int npts) {
+  set_start.push_back(npts_total);
+  set_npts.push_back(npts);
+  npts_total += npts;
+  Kokkos::resize(coord, std::max(1, npts_total), 3);
+  stale = true;
+  return static_cast<int>(set_npts.size()) - 1;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InterpolationService::SetPoints()
+//! \brief copy coordinates of points of set s into array of all points
+
+void InterpolationService::SetPoints(int s, const DvceArray2D<Real> &x) {
+  int p0 = set_start[s];
+  auto &coord_ = coord;
+  par_for("interp_setpts",DevExeSpace(),0,set_npts[s]-1,
+  KOKKOS_LAMBDA(const int n) {
+    coord_(p0+n,0) = x(n,0);
+    coord_(p0+n,1) = x(n,1);
+    coord_(p0+n,2) = x(n,2);
+  });
+  stale = true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int InterpolationService::Queue()
+//! \brief add a request to the current batch
+
+int InterpolationService::Queue(int s, const DvceArray5D<Real> &u,
+                                const std::vector<int> &vars) {
+  if (executed) {
+    requests.clear();
+    executed = false;
+  }
+  requests.push_back({s, u, vars, NumValues()});
+  return static_cast<int>(requests.size()) - 1;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int InterpolationService::NumValues()
+//! \brief number of values of all requests of current batch
+
+int InterpolationService::NumValues() const {
+  if (requests.empty()) return 0;
+  auto &r = requests.back();
+  return r.offset + static_cast<int>(r.vars.size())*set_npts[r.set];
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InterpolationService::SetWeights()
+//! \brief locate all points (each on a single rank) and compute their Lagrange weights
+//! in each direction on the device
+
+void InterpolationService::SetWeights() {
+  auto &indcs_mb = pmy_pack->pmesh->mb_indcs;
+  int ng = indcs_mb.ng;
+  int npts = npts_total;
+  Kokkos::realloc(indcs, std::max(1, npts), 4);
+  Kokkos::realloc(wghts, std::max(1, npts), 2*ng, 3);
+  pmy_pack->plocator->Locate(coord, indcs, npts, true);
+
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &coord_ = coord;
+  auto &indcs_ = indcs;
+  auto &wghts_ = wghts;
+  int nx1 = indcs_mb.nx1, nx2 = indcs_mb.nx2, nx3 = indcs_mb.nx3;
+  par_for("interp_wghts",DevExeSpace(),0,npts-1,
+  KOKKOS_LAMBDA(const int n) {
+    int m = indcs_(n,0);
+    if (m == -1) {  // point not on this rank
+      for (int i=0; i<2*ng; ++i) {
+        wghts_(n,i,0) = 0.0;
+        wghts_(n,i,1) = 0.0;
+        wghts_(n,i,2) = 0.0;
+      }
+      return;
+    }
+    Real xmin[3] = {size.d_view(m).x1min, size.d_view(m).x2min, size.d_view(m).x3min};
+    Real xmax[3] = {size.d_view(m).x1max, size.d_view(m).x2max, size.d_view(m).x3max};
+    int nx[3] = {nx1, nx2, nx3};
+    for (int d=0; d<3; ++d) {
+      Real x0 = coord_(n,d);
+      int ii = indcs_(n,d+1);
+      for (int i=0; i<2*ng; ++i) {
+        Real w = 1.0;
+        Real xi = CellCenterX(ii-ng+i+1, nx[d], xmin[d], xmax[d]);
+        for (int j=0; j<2*ng; ++j) {
+          if (j != i) {
+            Real xj = CellCenterX(ii-ng+j+1, nx[d], xmin[d], xmax[d]);
+            w *= (x0 - xj)/(xi - xj);
+          }
+        }
+        wghts_(n,i,d) = w;
+      }
+    }
+  });
+
+  stale = false;
+  generation = pmy_pack->pmesh->ngeneration;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InterpolationService::Execute()
+//! \brief interpolate all requests of current batch.  Requests on the same source array
+//! are interpolated by one kernel over all their (point, variable) pairs.
+
+void InterpolationService::Execute() {
+  if (stale || generation != pmy_pack->pmesh->ngeneration) {
+    SetWeights();
+  }
+
+  int nvals = NumValues();
+  if (vals.extent_int(0) < std::max(1, nvals)) {
+    Kokkos::realloc(vals, std::max(1, nvals));
+  }
+  executed = true;
+  if (nvals == 0) return;
+
+  auto &indcs_mb = pmy_pack->pmesh->mb_indcs;
+  int is = indcs_mb.is, js = indcs_mb.js, ks = indcs_mb.ks;
+  int ng = indcs_mb.ng;
+  auto &indcs_ = indcs;
+  auto &wghts_ = wghts;
+  auto &vals_ = vals;
+
+  // group requests by source array
+  std::vector<bool> done(requests.size(), false);
+  for (size_t r0=0; r0<requests.size(); ++r0) {
+    if (done[r0]) continue;
+    // segments of contiguous values: (first point, number of points, variable, offset)
+    std::vector<int> seg;
+    for (size_t r=r0; r<requests.size(); ++r) {
+      if (done[r] || requests[r].u.data() != requests[r0].u.data()) continue;
+      done[r] = true;
+      int np = set_npts[requests[r].set];
+      for (size_t iv=0; iv<requests[r].vars.size(); ++iv) {
+        seg.insert(seg.end(), {set_start[requests[r].set], np, requests[r].vars[iv],
+                               requests[r].offset + static_cast<int>(iv)*np});
+      }
+    }
+    int nseg = static_cast<int>(seg.size())/4;
+    HostArray2D<int> seg_h("interp_seg_h", nseg, 5);
+    int nq = 0;
+    for (int s=0; s<nseg; ++s) {
+      for (int c=0; c<4; ++c) seg_h(s,c) = seg[4*s + c];
+      seg_h(s,4) = nq;  // index of first (point, variable) pair of segment
+      nq += seg[4*s + 1];
+    }
+    auto seg_d = transient_pool::Get<DvceArray2D<int>>("interp_seg", nseg, 5);
+    Kokkos::deep_copy(seg_d, seg_h);
+
+    auto u = requests[r0].u;
+    par_for("interp_batch",DevExeSpace(),0,nq-1,
+    KOKKOS_LAMBDA(const int q) {
+      // segment containing q
+      int lo = 0, hi = nseg - 1;
+      while (lo < hi) {
+        int mid = (lo + hi + 1)/2;
+        if (seg_d(mid,4) <= q) {lo = mid;} else {hi = mid - 1;}
+      }
+      int n = q - seg_d(lo,4);
+      int p = seg_d(lo,0) + n;
+      int v = seg_d(lo,2);
+      int ii0 = indcs_(p,0);
+      int ii1 = indcs_(p,1);
+      int ii2 = indcs_(p,2);
+      int ii3 = indcs_(p,3);
+      Real int_value = 0.0;
+      if (ii0 != -1) {
+        for (int i=0; i<2*ng; i++) {
+          for (int j=0; j<2*ng; j++) {
+            for (int k=0; k<2*ng; k++) {
+              Real iwght = wghts_(p,i,0)*wghts_(p,j,1)*wghts_(p,k,2);
+              int_value += iwght*u(ii0,v,ii3-(ng-k-ks)+1,ii2-(ng-j-js)+1,ii1-(ng-i-is)+1);
+            }
+          }
+        }
+      }
+      vals_.d_view(seg_d(lo,3) + n) = int_value;
+    });
+  }
+
+  // sync dual arrays
+  vals.template modify<DevExeSpace>();
+  vals.template sync<HostMemSpace>();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InterpolationService::Reduce()
+//! \brief sum results of all requests of the last batch over ranks with one MPI call
+
+void InterpolationService::Reduce(bool to_all) {
+#if MPI_PARALLEL_ENABLED
+  int nvals = NumValues();
+  if (nvals == 0) return;
+  Real *data = vals.h_view.data();
+  if (to_all) {
+    MPI_Allreduce(MPI_IN_PLACE, data, nvals, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+  } else if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, data, nvals, MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(data, data, nvals, MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+  }
+#endif
+}
@@ -0,0 +1,81 @@
+#ifndef UTILS_INTERP_SERVICE_HPP_
+#define UTILS_INTERP_SERVICE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file interp_service.hpp
+//! \brief Batched Lagrange interpolation of cell-centered data to sets of points, shared
+//! by the diagnostics of a MeshBlockPack.  Consumers register persistent point sets,
+//! queue the variables they need, and a single Execute() interpolates every queued
+//! request with one kernel per source array.  MeshBlock indices and weights of all
+//! points are cached on the device and only recomputed when points are moved or the
+//! Mesh changes.  Results of all requests of a batch are summed over ranks with one MPI
+//! call.  Every point belongs to exactly one rank (see MeshBlockLocator), so partial
+//! results may also be post-processed linearly on each rank before reduction.
+
+#include <vector>
+
+#include "athena.hpp"
+
+// Forward declarations
+class MeshBlockPack;
+
+//----------------------------------------------------------------------------------------
+//! \class InterpolationService
+
+class InterpolationService {
+ public:
+  explicit InterpolationService(MeshBlockPack *ppack);
+  ~InterpolationService() = default;
+
+  //! Register a set of npts points and return its index.  Coordinates must be given
+  //! with SetPoints() before the set is used.
+  int AddPointSet(int npts);
+  //! Set coordinates x(n,0:2) of the points of set s (copied on the device)
+  void SetPoints(int s, const DvceArray2D<Real> &x);
+  int NumPoints(int s) const {return set_npts[s];}
+
+  //! Queue interpolation of variables vars of u to the points of set s, and return the
+  //! index of the request.  The first Queue() after Execute() starts a new batch.
+  int Queue(int s, const DvceArray5D<Real> &u, const std::vector<int> &vars);
+  //! Interpolate all queued requests on this rank (points on other ranks get zero)
+  void Execute();
+  //! Sum results of the last batch over ranks, to rank 0 only or to all ranks
+  void Reduce(bool to_all);
+  //! Value of the iv-th variable of request r at point n of its set, on host
+  Real Value(int r, int iv, int n) const {
+    return vals.h_view(requests[r].offset + iv*set_npts[requests[r].set] + n);
+  }
+  //! Device array of all values of the last batch, for consumers that post-process the
+  //! results on the device.  The value returned by Value(r,iv,n) is at index
+  //! Offset(r) + iv*NumPoints(s) + n, where s is the point set of request r.
+  DvceArray1D<Real> DeviceValues() const {return vals.d_view;}
+  int Offset(int r) const {return requests[r].offset;}
+
+ private:
+  struct Request {
+    int set;                 // point set
+    DvceArray5D<Real> u;     // source array
+    std::vector<int> vars;   // variables of source array
+    int offset;              // index of first value in vals
+  };
+
+  MeshBlockPack *pmy_pack;
+  std::vector<int> set_start, set_npts;  // first point and number of points of each set
+  int npts_total;
+  bool stale;                  // points changed since indices and weights computed
+  int generation;              // Mesh::ngeneration when indices and weights computed
+  DvceArray2D<Real> coord;     // coordinates of all points
+  DvceArray2D<int> indcs;      // MeshBlock and cell indices of all points
+  DvceArray3D<Real> wghts;     // Lagrange weights of all points
+  std::vector<Request> requests;
+  bool executed;               // requests of current batch have been interpolated
+  DualArray1D<Real> vals;      // results of all requests of current batch
+
+  int NumValues() const;
+  void SetWeights();
+};
+
+#endif // UTILS_INTERP_SERVICE_HPP_
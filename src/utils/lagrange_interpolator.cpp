@@ -3,184 +3,189 @@
 // Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
-//! \file lagrange_interpolator.hpp
+//! \file lagrange_interpolator.cpp
+//! \brief implements LagrangeInterpolator, device interpolation to a set of points
 
-#include <cmath>
-#include <iostream>
-#include <list>
+#include <algorithm>
+#include <vector>
 
-#include "lagrange_interpolator.hpp"
 #include "athena.hpp"
-#include "athena_tensor.hpp"
 #include "coordinates/cell_locations.hpp"
 #include "mesh/mesh.hpp"
+#include "mb_locator.hpp"
+#include "lagrange_interpolator.hpp"
 
-// calculate indices of the mesh block and xyz coordinate indices for the given
-// point whose coordinate is given by rcoord; results returned in
-// interp_indcs[4]
+//----------------------------------------------------------------------------------------
+// constructor for npts points, whose coordinates must be set before use
+
+LagrangeInterpolator::LagrangeInterpolator(MeshBlockPack *ppack, int npts) :
+    pmy_pack(ppack),
+    npts(npts),
+    stale(true),
+    generation(-1),
+    rcoord("rcoord",std::max(1, npts),3),
+    interp_indcs("interp_indcs",std::max(1, npts),4),
+    interp_wghts("interp_wghts",std::max(1, npts),1,3),
+    ivals("interp_vals",1,std::max(1, npts)) {
+  Kokkos::realloc(interp_wghts, std::max(1, npts), 2*pmy_pack->pmesh->mb_indcs.ng, 3);
+}
 
-LagrangeInterpolator::LagrangeInterpolator(
-  MeshBlockPack *pmy_pack,
-  Real rcoords[3]):
-              pmy_pack(pmy_pack),
-              rcoord("rccord", 1), interp_indcs("interp_indcs", 1),
-              interp_wghts("interp_wghts", 1, 1), point_exist(false) {
-  auto &indcs = pmy_pack->pmesh->mb_indcs;
-  // int &is = indcs.is; int &js = indcs.js; int &ks = indcs.ks;
-  int &ng = indcs.ng;
-  Kokkos::realloc(rcoord, 3);
-  Kokkos::realloc(interp_wghts, 2 * ng, 3);
-  Kokkos::realloc(interp_indcs, 4);
-
-  for (int i = 0; i < 3; ++i) {
-    rcoord(i) = rcoords[i];
+//----------------------------------------------------------------------------------------
+// constructor for a single point at rcoords
+
+LagrangeInterpolator::LagrangeInterpolator(MeshBlockPack *ppack, Real rcoords[3]) :
+    LagrangeInterpolator(ppack, 1) {
+  SetPoint(0, rcoords);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LagrangeInterpolator::SetPoint()
+//! \brief move point n to rcoords
+
+void LagrangeInterpolator::SetPoint(int n, Real rcoords[3]) {
+  Real x0 = rcoords[0], y0 = rcoords[1], z0 = rcoords[2];
+  auto &rcoord_ = rcoord;
+  par_for("lagrange_setpt",DevExeSpace(),n,n,
+  KOKKOS_LAMBDA(const int p) {
+    rcoord_(p,0) = x0;
+    rcoord_(p,1) = y0;
+    rcoord_(p,2) = z0;
+  });
+  stale = true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LagrangeInterpolator::SetPoints()
+//! \brief copy coordinates x(n,0:2) of all points
+
+void LagrangeInterpolator::SetPoints(const DvceArray2D<Real> &x) {
+  auto &rcoord_ = rcoord;
+  par_for("lagrange_setpts",DevExeSpace(),0,npts-1,
+  KOKKOS_LAMBDA(const int n) {
+    rcoord_(n,0) = x(n,0);
+    rcoord_(n,1) = x(n,1);
+    rcoord_(n,2) = x(n,2);
+  });
+  stale = true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool LagrangeInterpolator::PointExists()
+//! \brief true if point n lies in a MeshBlock of this rank
+
+bool LagrangeInterpolator::PointExists(int n) {
+  if (stale || generation != pmy_pack->pmesh->ngeneration) {
+    SetWeights();
   }
-  SetInterpolationIndices();
-  CalculateWeight();
+  return (interp_indcs.h_view(n,0) != -1);
 }
 
-Real LagrangeInterpolator::Interpolate(DvceArray5D<Real> &val, int nvars) {
-  Real ivals    = 0.;
-  int &ng       = pmy_pack->pmesh->mb_indcs.ng;
-  int &ii0      = interp_indcs(0);
-  int &ii1      = interp_indcs(1);
-  int &ii2      = interp_indcs(2);
-  int &ii3      = interp_indcs(3);
-  auto &weights = interp_wghts;
-  auto &indcs   = pmy_pack->pmesh->mb_indcs;
-
-  int &is = indcs.is;
-  int &js = indcs.js;
-  int &ks = indcs.ks;
-
-  if (interp_indcs(0) == -1) { // point not on this rank
-    ivals = 0.0;
-  } else {
-    for (int i = 0; i < 2 * ng; i++) {
-      for (int j = 0; j < 2 * ng; j++) {
-        for (int k = 0; k < 2 * ng; k++) {
-          Real iwght  = weights(i, 0) * weights(j, 1) * weights(k, 2);
-          auto buffer = Kokkos::subview(
-            val,
-            ii0,
-            nvars,
-            ii3 - (ng - k - ks) + 1,
-            ii2 - (ng - j - js) + 1,
-            ii1 - (ng - i - is) + 1);
-          Real scalar;
-          // Deep Copy Scalar View into a scalar
-          Kokkos::deep_copy(scalar, buffer);
-          ivals += iwght * scalar;
+//----------------------------------------------------------------------------------------
+//! \fn void LagrangeInterpolator::SetWeights()
+//! \brief locate all points and compute their Lagrange weights in each direction on the
+//! device
+
+void LagrangeInterpolator::SetWeights() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ng = indcs.ng;
+  pmy_pack->plocator->Locate(rcoord, interp_indcs.d_view, npts, true);
+
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &rcoord_ = rcoord;
+  auto &indcs_ = interp_indcs;
+  auto &wghts_ = interp_wghts;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  par_for("lagrange_wghts",DevExeSpace(),0,npts-1,
+  KOKKOS_LAMBDA(const int n) {
+    int m = indcs_.d_view(n,0);
+    if (m == -1) {  // point not on this rank
+      for (int i=0; i<2*ng; ++i) {
+        wghts_(n,i,0) = 0.0;
+        wghts_(n,i,1) = 0.0;
+        wghts_(n,i,2) = 0.0;
+      }
+      return;
+    }
+    Real xmin[3] = {size.d_view(m).x1min, size.d_view(m).x2min, size.d_view(m).x3min};
+    Real xmax[3] = {size.d_view(m).x1max, size.d_view(m).x2max, size.d_view(m).x3max};
+    int nx[3] = {nx1, nx2, nx3};
+    for (int d=0; d<3; ++d) {
+      Real x0 = rcoord_(n,d);
+      int ii = indcs_.d_view(n,d+1);
+      for (int i=0; i<2*ng; ++i) {
+        Real w = 1.0;
+        Real xi = CellCenterX(ii-ng+i+1, nx[d], xmin[d], xmax[d]);
+        for (int j=0; j<2*ng; ++j) {
+          if (j != i) {
+            Real xj = CellCenterX(ii-ng+j+1, nx[d], xmin[d], xmax[d]);
+            w *= (x0 - xj)/(xi - xj);
+          }
         }
+        wghts_(n,i,d) = w;
       }
     }
-  }
-  return ivals;
-}
+  });
 
-Real LagrangeInterpolator::ResetPointAndInterpolate(
-  DvceArray5D<Real> &val,
-  int nvars,
-  Real rcoords2[3]) {
-  for (int i = 0; i < 3; ++i) {
-    rcoord(i) = rcoords2[i];
-  }
-  SetInterpolationIndices();
-  CalculateWeight();
-  Real ivals = Interpolate(val, nvars);
-  return ivals;
+  // sync dual arrays
+  interp_indcs.template modify<DevExeSpace>();
+  interp_indcs.template sync<HostMemSpace>();
+
+  stale = false;
+  generation = pmy_pack->pmesh->ngeneration;
 }
 
-void LagrangeInterpolator::SetInterpolationIndices() {
-  auto &size = pmy_pack->pmb->mb_size;
-  int nmb1   = pmy_pack->nmb_thispack - 1;
+//----------------------------------------------------------------------------------------
+//! \fn void LagrangeInterpolator::Interpolate()
+//! \brief interpolate variables vars of val to all points, over all (variable, point)
+//! pairs in one kernel
 
-  // indices default to -1 if the point is outside this MeshBlockPack
-  for (int i = 0; i < 4; ++i) {
-    interp_indcs(i) = -1;
+void LagrangeInterpolator::Interpolate(const DvceArray5D<Real> &val,
+                                       const std::vector<int> &vars) {
+  if (stale || generation != pmy_pack->pmesh->ngeneration) {
+    SetWeights();
   }
 
-  for (int m = 0; m <= nmb1; ++m) {
-    // extract MeshBlock bounds
-    Real &x1min = size.h_view(m).x1min;
-    Real &x1max = size.h_view(m).x1max;
-    Real &x2min = size.h_view(m).x2min;
-    Real &x2max = size.h_view(m).x2max;
-    Real &x3min = size.h_view(m).x3min;
-    Real &x3max = size.h_view(m).x3max;
-
-    // extract MeshBlock grid cell spacings
-    Real &dx1 = size.h_view(m).dx1;
-    Real &dx2 = size.h_view(m).dx2;
-    Real &dx3 = size.h_view(m).dx3;
-
-    // save MeshBlock and zone indicies for nearest position to spherical patch
-    // center if this angle position resides in this MeshBlock
-    if (
-      (rcoord(0) >= x1min && rcoord(0) < x1max)
-      && (rcoord(1) >= x2min && rcoord(1) < x2max)
-      && (rcoord(2) >= x3min && rcoord(2) < x3max)) {
-      point_exist     = true;
-      interp_indcs(0) = m;
-      interp_indcs(1) =
-        static_cast<int>(std::floor((rcoord(0) - (x1min + dx1 / 2.0)) / dx1));
-      interp_indcs(2) =
-        static_cast<int>(std::floor((rcoord(1) - (x2min + dx2 / 2.0)) / dx2));
-      interp_indcs(3) =
-        static_cast<int>(std::floor((rcoord(2) - (x3min + dx3 / 2.0)) / dx3));
-
-      break;
-    }
+  int nvars = static_cast<int>(vars.size());
+  if (ivals.extent_int(0) < std::max(1, nvars)) {
+    Kokkos::realloc(ivals, std::max(1, nvars), std::max(1, npts));
   }
-}
+  if (nvars == 0 || npts == 0) return;
+
+  DualArray1D<int> vars_("interp_vars", nvars);
+  for (int iv=0; iv<nvars; ++iv) {
+    vars_.h_view(iv) = vars[iv];
+  }
+  vars_.template modify<HostMemSpace>();
+  vars_.template sync<DevExeSpace>();
 
-void LagrangeInterpolator::CalculateWeight() {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
-  auto &size  = pmy_pack->pmb->mb_size;
-  int &ng     = indcs.ng;
-  int &ii0    = interp_indcs(0);
-  int &ii1    = interp_indcs(1);
-  int &ii2    = interp_indcs(2);
-  int &ii3    = interp_indcs(3);
-
-  // auto &weights = interp_wghts;
-  if (ii0 == -1) { // angle not on this rank
-    for (int i = 0; i < 2 * ng; ++i) {
-      interp_wghts(i, 0) = 0.;
-      interp_wghts(i, 1) = 0.;
-      interp_wghts(i, 2) = 0.;
-    }
-  } else {
-    // extract spherical grid positions
-    Real &x0 = rcoord(0);
-    Real &y0 = rcoord(1);
-    Real &z0 = rcoord(2);
-
-    // extract MeshBlock bounds
-    Real &x1min = size.h_view(ii0).x1min;
-    Real &x1max = size.h_view(ii0).x1max;
-    Real &x2min = size.h_view(ii0).x2min;
-    Real &x2max = size.h_view(ii0).x2max;
-    Real &x3min = size.h_view(ii0).x3min;
-    Real &x3max = size.h_view(ii0).x3max;
-    // set interpolation weights
-    for (int i = 0; i < 2 * ng; ++i) {
-      interp_wghts(i, 0) = 1.;
-      interp_wghts(i, 1) = 1.;
-      interp_wghts(i, 2) = 1.;
-      for (int j = 0; j < 2 * ng; ++j) {
-        if (j != i) {
-          Real x1vpi1 = CellCenterX(ii1 - ng + i + 1, indcs.nx1, x1min, x1max);
-          Real x1vpj1 = CellCenterX(ii1 - ng + j + 1, indcs.nx1, x1min, x1max);
-          interp_wghts(i, 0) *= (x0 - x1vpj1) / (x1vpi1 - x1vpj1);
-          Real x2vpi1 = CellCenterX(ii2 - ng + i + 1, indcs.nx2, x2min, x2max);
-          Real x2vpj1 = CellCenterX(ii2 - ng + j + 1, indcs.nx2, x2min, x2max);
-          interp_wghts(i, 1) *= (y0 - x2vpj1) / (x2vpi1 - x2vpj1);
-          Real x3vpi1 = CellCenterX(ii3 - ng + i + 1, indcs.nx3, x3min, x3max);
-          Real x3vpj1 = CellCenterX(ii3 - ng + j + 1, indcs.nx3, x3min, x3max);
-          interp_wghts(i, 2) *= (z0 - x3vpj1) / (x3vpi1 - x3vpj1);
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int ng = indcs.ng;
+  auto &indcs_ = interp_indcs;
+  auto &wghts_ = interp_wghts;
+  auto &ivals_ = ivals;
+  par_for("lagrange_interp",DevExeSpace(),0,nvars-1,0,npts-1,
+  KOKKOS_LAMBDA(const int iv, const int n) {
+    int v = vars_.d_view(iv);
+    int ii0 = indcs_.d_view(n,0);
+    int ii1 = indcs_.d_view(n,1);
+    int ii2 = indcs_.d_view(n,2);
+    int ii3 = indcs_.d_view(n,3);
+    Real int_value = 0.0;
+    if (ii0 != -1) {
+      for (int i=0; i<2*ng; i++) {
+        for (int j=0; j<2*ng; j++) {
+          for (int k=0; k<2*ng; k++) {
+            Real iwght = wghts_(n,i,0)*wghts_(n,j,1)*wghts_(n,k,2);
+            int_value += iwght*val(ii0,v,ii3-(ng-k-ks)+1,ii2-(ng-j-js)+1,ii1-(ng-i-is)+1);
+          }
         }
       }
     }
-  }
+    ivals_.d_view(iv,n) = int_value;
+  });
+
+  // sync dual arrays
+  ivals.template modify<DevExeSpace>();
+  ivals.template sync<HostMemSpace>();
 }
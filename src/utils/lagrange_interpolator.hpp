@@ -6,39 +6,54 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file lagrange_interpolator.hpp
+//! \brief Lagrange interpolation of cell-centered data to a small set of (possibly
+//! moving) points, e.g. compact object positions or probes sampled by a pgen.  Points,
+//! MeshBlock indices and weights are stored on the device.  Indices and weights are only
+//! recomputed when points are moved or the Mesh changes, and each call to Interpolate()
+//! evaluates all points and all requested variables of an array in one kernel.  Each
+//! point is found on exactly one rank (see MeshBlockLocator); other ranks get zero.
 
-#include <cmath>
-#include <iostream>
-#include <list>
+#include <vector>
 
 #include "athena.hpp"
-#include "athena_tensor.hpp"
-#include "coordinates/cell_locations.hpp"
-#include "mesh/mesh.hpp"
+
+// Forward declarations
+class MeshBlockPack;
+
+//----------------------------------------------------------------------------------------
+//! \class LagrangeInterpolator
 
 class LagrangeInterpolator {
  public:
+  LagrangeInterpolator(MeshBlockPack *pmy_pack, int npts);
   LagrangeInterpolator(MeshBlockPack *pmy_pack, Real rcoords[3]);
   ~LagrangeInterpolator() = default;
 
-  void SetInterpolationIndices();
-  void CalculateWeight();
-  Real Interpolate(DvceArray5D<Real> &val, int nvars);
-  Real InterpolateTensor(
-    AthenaTensor<Real, TensorSymm::NONE, 3, 1> &val, int nvars);
-  Real ResetPointAndInterpolate(
-    DvceArray5D<Real> &val, int nvars, Real rcoords2[3]);
-  bool point_exist; // point exist on this rank (meshblock pack)
+  int NumPoints() const {return npts;}
+  //! Move point n to rcoords
+  void SetPoint(int n, Real rcoords[3]);
+  //! Set coordinates x(n,0:2) of all points (copied on the device)
+  void SetPoints(const DvceArray2D<Real> &x);
+  //! True if point n is located on this rank
+  bool PointExists(int n = 0);
+
+  //! Interpolate variables vars of val to all points with one kernel.  The results are
+  //! returned on the host by Value() until the next call.
+  void Interpolate(const DvceArray5D<Real> &val, const std::vector<int> &vars);
+  //! Value of the iv-th interpolated variable at point n
+  Real Value(int iv, int n = 0) const {return ivals.h_view(iv,n);}
+
  private:
-  HostArray1D<Real> rcoord; // xyz coordinate for interpolated value
-
-  int nvars;               // index of the variable for interpolation
-  MeshBlockPack *pmy_pack; // ptr to MeshBlockPack containing this Hydro
-  int
-    ng; // number of ghost cell, which sets interpolation level automatically
-  HostArray1D<int>
-    interp_indcs; // indices of MeshBlock and zones therein for interp
-  HostArray2D<Real> interp_wghts; // weights for interpolation
+  MeshBlockPack *pmy_pack; // ptr to MeshBlockPack containing the points
+  int npts;                // number of points
+  bool stale;              // points moved since indices and weights computed
+  int generation;          // Mesh::ngeneration when indices and weights computed
+  DvceArray2D<Real> rcoord;        // xyz coordinates of points
+  DualArray2D<int> interp_indcs;   // indices of MeshBlock and zones therein for interp
+  DvceArray3D<Real> interp_wghts;  // weights for interpolation
+  DualArray2D<Real> ivals;         // interpolated values of last call
+
+  void SetWeights();
 };
 
 #endif // UTILS_LAGRANGE_INTERPOLATOR_HPP_
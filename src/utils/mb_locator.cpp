@@ -0,0 +1,214 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file mb_locator.cpp
+//! \brief implements MeshBlockLocator, a uniform-bin index of the MeshBlocks of a pack
+
+#include <algorithm>
+#include <cmath>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "transient_pool.hpp"
+#include "mb_locator.hpp"
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void bin_range()
+//! \brief range of bins [l,u] of width w starting at x0 overlapping [xmin,xmax] (bounds
+//! included), clipped to the nb bins.  Used both to register MeshBlocks and to find the
+//! bin of a point, so that a point in a MeshBlock is always in one of its bins.
+
+KOKKOS_INLINE_FUNCTION
+void bin_range(const Real xmin, const Real xmax, const Real x0, const Real w,
+               const int nb, int &l, int &u) {
+  l = static_cast<int>(floor((xmin - x0)/w));
+  u = static_cast<int>(floor((xmax - x0)/w));
+  l = (l < 0)? 0 : ((l > nb-1)? nb-1 : l);
+  u = (u < 0)? 0 : ((u > nb-1)? nb-1 : u);
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// constructor; the bins are built on first use
+
+MeshBlockLocator::MeshBlockLocator(MeshBlockPack *ppack) :
+    pmy_pack(ppack),
+    generation(-1),
+    nbin1(1), nbin2(1), nbin3(1),
+    bmin1(0.0), bmin2(0.0), bmin3(0.0),
+    wbin1(1.0), wbin2(1.0), wbin3(1.0),
+    bin_start("bin_start",1),
+    bin_mbs("bin_mbs",1) {
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockLocator::Build()
+//! \brief divide bounding box of MeshBlocks in pack into about 2^dim bins per MeshBlock
+//! (but no bins smaller than the smallest MeshBlock), and store the MeshBlocks
+//! overlapping each bin in CSR format.  Counting and filling are done on the device;
+//! only the prefix sum over the (few) bins is done on the host.
+
+void MeshBlockLocator::Build() {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &size = pmy_pack->pmb->mb_size;
+  int nmb = pmy_pack->nmb_thispack;
+
+  // bounding box of MeshBlocks, and extent of smallest MeshBlock
+  Real bmax1 = size.h_view(0).x1max, bmax2 = size.h_view(0).x2max;
+  Real bmax3 = size.h_view(0).x3max;
+  bmin1 = size.h_view(0).x1min; bmin2 = size.h_view(0).x2min;
+  bmin3 = size.h_view(0).x3min;
+  Real wmin1 = bmax1 - bmin1, wmin2 = bmax2 - bmin2, wmin3 = bmax3 - bmin3;
+  for (int m=1; m<nmb; ++m) {
+    bmin1 = std::min(bmin1, size.h_view(m).x1min);
+    bmin2 = std::min(bmin2, size.h_view(m).x2min);
+    bmin3 = std::min(bmin3, size.h_view(m).x3min);
+    bmax1 = std::max(bmax1, size.h_view(m).x1max);
+    bmax2 = std::max(bmax2, size.h_view(m).x2max);
+    bmax3 = std::max(bmax3, size.h_view(m).x3max);
+    wmin1 = std::min(wmin1, size.h_view(m).x1max - size.h_view(m).x1min);
+    wmin2 = std::min(wmin2, size.h_view(m).x2max - size.h_view(m).x2min);
+    wmin3 = std::min(wmin3, size.h_view(m).x3max - size.h_view(m).x3min);
+  }
+  Real len1 = bmax1 - bmin1, len2 = bmax2 - bmin2, len3 = bmax3 - bmin3;
+
+  // width of (cubic) bins giving about 2^dim bins per MeshBlock
+  int ndim = 1;
+  Real vol = len1;
+  if (pm->multi_d) {ndim++; vol *= len2;}
+  if (pm->three_d) {ndim++; vol *= len3;}
+  Real wbin = std::pow(vol/static_cast<Real>(nmb << ndim), 1.0/ndim);
+  auto nbins = [wbin](Real len, Real wmin) {
+    int nfine = static_cast<int>(std::round(len/wmin));
+    return std::max(1, std::min(static_cast<int>(std::ceil(len/wbin)), nfine));
+  };
+  nbin1 = nbins(len1, wmin1);
+  nbin2 = (pm->multi_d)? nbins(len2, wmin2) : 1;
+  nbin3 = (pm->three_d)? nbins(len3, wmin3) : 1;
+  wbin1 = len1/nbin1;
+  wbin2 = len2/nbin2;
+  wbin3 = len3/nbin3;
+  int nbin = nbin1*nbin2*nbin3;
+
+  // count MeshBlocks overlapping each bin
+  Kokkos::realloc(bin_start, nbin+1);
+  Kokkos::deep_copy(bin_start, 0);
+  auto &bstart = bin_start;
+  int nb1 = nbin1, nb2 = nbin2, nb3 = nbin3;
+  Real x1b = bmin1, x2b = bmin2, x3b = bmin3;
+  Real w1 = wbin1, w2 = wbin2, w3 = wbin3;
+  par_for("mbloc_count",DevExeSpace(),0,nmb-1,
+  KOKKOS_LAMBDA(const int m) {
+    int l1, u1, l2, u2, l3, u3;
+    bin_range(size.d_view(m).x1min, size.d_view(m).x1max, x1b, w1, nb1, l1, u1);
+    bin_range(size.d_view(m).x2min, size.d_view(m).x2max, x2b, w2, nb2, l2, u2);
+    bin_range(size.d_view(m).x3min, size.d_view(m).x3max, x3b, w3, nb3, l3, u3);
+    for (int b3=l3; b3<=u3; ++b3) {
+      for (int b2=l2; b2<=u2; ++b2) {
+        for (int b1=l1; b1<=u1; ++b1) {
+          Kokkos::atomic_increment(&bstart((b3*nb2 + b2)*nb1 + b1 + 1));
+        }
+      }
+    }
+  });
+
+  // prefix sum of counts gives start of list of each bin
+  auto bstart_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), bin_start);
+  for (int b=0; b<nbin; ++b) {
+    bstart_h(b+1) += bstart_h(b);
+  }
+  Kokkos::deep_copy(bin_start, bstart_h);
+
+  // fill lists
+  Kokkos::realloc(bin_mbs, std::max(1, bstart_h(nbin)));
+  auto fill = transient_pool::Get<DvceArray1D<int>>("mbloc_fill", nbin);
+  auto &bmbs = bin_mbs;
+  par_for("mbloc_fill",DevExeSpace(),0,nmb-1,
+  KOKKOS_LAMBDA(const int m) {
+    int l1, u1, l2, u2, l3, u3;
+    bin_range(size.d_view(m).x1min, size.d_view(m).x1max, x1b, w1, nb1, l1, u1);
+    bin_range(size.d_view(m).x2min, size.d_view(m).x2max, x2b, w2, nb2, l2, u2);
+    bin_range(size.d_view(m).x3min, size.d_view(m).x3max, x3b, w3, nb3, l3, u3);
+    for (int b3=l3; b3<=u3; ++b3) {
+      for (int b2=l2; b2<=u2; ++b2) {
+        for (int b1=l1; b1<=u1; ++b1) {
+          int b = (b3*nb2 + b2)*nb1 + b1;
+          bmbs(bstart(b) + Kokkos::atomic_fetch_add(&fill(b), 1)) = m;
+        }
+      }
+    }
+  });
+
+  generation = pm->ngeneration;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockLocator::Locate()
+//! \brief find MeshBlock and cell indices of points in parallel on the device
+
+void MeshBlockLocator::Locate(const DvceArray2D<Real> &x, const DvceArray2D<int> &indcs,
+                              int npts, bool half_open) {
+  if (generation != pmy_pack->pmesh->ngeneration) {
+    Build();
+  }
+  if (npts <= 0) return;
+
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &bstart = bin_start;
+  auto &bmbs = bin_mbs;
+  int nb1 = nbin1, nb2 = nbin2, nb3 = nbin3;
+  Real x1b = bmin1, x2b = bmin2, x3b = bmin3;
+  Real w1 = wbin1, w2 = wbin2, w3 = wbin3;
+  auto &mesh_size = pmy_pack->pmesh->mesh_size;
+  Real mx1 = mesh_size.x1max, mx2 = mesh_size.x2max, mx3 = mesh_size.x3max;
+  par_for("mbloc_locate",DevExeSpace(),0,npts-1,
+  KOKKOS_LAMBDA(const int n) {
+    Real x1 = x(n,0), x2 = x(n,1), x3 = x(n,2);
+    indcs(n,0) = -1;
+    indcs(n,1) = -1;
+    indcs(n,2) = -1;
+    indcs(n,3) = -1;
+
+    // bin containing point, clipped as in Build() (points outside the bounding box fail
+    // the test below for every MeshBlock of the bin)
+    int l1, u1, l2, u2, l3, u3;
+    bin_range(x1, x1, x1b, w1, nb1, l1, u1);
+    bin_range(x2, x2, x2b, w2, nb2, l2, u2);
+    bin_range(x3, x3, x3b, w3, nb3, l3, u3);
+
+    // highest-index MeshBlock of bin containing point
+    int b = (l3*nb2 + l2)*nb1 + l1;
+    int mloc = -1;
+    for (int l=bstart(b); l<bstart(b+1); ++l) {
+      int m = bmbs(l);
+      Real &xmax1 = size.d_view(m).x1max;
+      Real &xmax2 = size.d_view(m).x2max;
+      Real &xmax3 = size.d_view(m).x3max;
+      bool in1 = (x1 < xmax1) || (x1 == xmax1 && (!half_open || xmax1 >= mx1));
+      bool in2 = (x2 < xmax2) || (x2 == xmax2 && (!half_open || xmax2 >= mx2));
+      bool in3 = (x3 < xmax3) || (x3 == xmax3 && (!half_open || xmax3 >= mx3));
+      if (m > mloc && in1 && in2 && in3 &&
+          x1 >= size.d_view(m).x1min && x2 >= size.d_view(m).x2min &&
+          x3 >= size.d_view(m).x3min) {
+        mloc = m;
+      }
+    }
+    if (mloc < 0) return;
+
+    Real &x1min = size.d_view(mloc).x1min;
+    Real &x2min = size.d_view(mloc).x2min;
+    Real &x3min = size.d_view(mloc).x3min;
+    Real &dx1 = size.d_view(mloc).dx1;
+    Real &dx2 = size.d_view(mloc).dx2;
+    Real &dx3 = size.d_view(mloc).dx3;
+    indcs(n,0) = mloc;
+    indcs(n,1) = static_cast<int>(floor((x1 - (x1min + dx1/2.0))/dx1));
+    indcs(n,2) = static_cast<int>(floor((x2 - (x2min + dx2/2.0))/dx2));
+    indcs(n,3) = static_cast<int>(floor((x3 - (x3min + dx3/2.0))/dx3));
+  });
+  return;
+}
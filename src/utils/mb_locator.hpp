@@ -0,0 +1,49 @@
+#ifndef UTILS_MB_LOCATOR_HPP_
+#define UTILS_MB_LOCATOR_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file mb_locator.hpp
+//! \brief Device-side index used to find the MeshBlock of a MeshBlockPack containing a
+//! point.  The bounding box of the MeshBlocks in the pack is divided into uniform bins,
+//! and each bin stores the list of MeshBlocks overlapping it.  Points are then located
+//! in parallel on the device by testing only the few MeshBlocks of their bin, instead of
+//! every MeshBlock of the pack.  The bins are rebuilt only when Mesh::ngeneration
+//! changes, so a single index is shared by all interpolation grids of the pack.
+
+#include "athena.hpp"
+
+// Forward declarations
+class MeshBlockPack;
+
+//----------------------------------------------------------------------------------------
+//! \class MeshBlockLocator
+
+class MeshBlockLocator {
+ public:
+  explicit MeshBlockLocator(MeshBlockPack *ppack);
+  ~MeshBlockLocator() = default;
+
+  //! For each of the npts points x(n,0:2), set indcs(n,0) to the MeshBlock of this pack
+  //! containing the point (bounds included, highest index if on a face shared by several
+  //! MeshBlocks, -1 if none) and indcs(n,1:3) to the indices (relative to is,js,ks) of
+  //! the cell center immediately below the point in each direction.  With half_open,
+  //! the upper bounds of MeshBlocks are excluded except on the upper boundaries of the
+  //! Mesh, so that every point of the Mesh is found on exactly one rank.
+  void Locate(const DvceArray2D<Real> &x, const DvceArray2D<int> &indcs, int npts,
+              bool half_open=false);
+
+ private:
+  MeshBlockPack *pmy_pack;
+  int generation;              // Mesh::ngeneration when bins were built (-1 if never)
+  int nbin1, nbin2, nbin3;     // number of bins in each direction
+  Real bmin1, bmin2, bmin3;    // lower corner of bounding box of MeshBlocks
+  Real wbin1, wbin2, wbin3;    // width of bins
+  DvceArray1D<int> bin_start;  // start of list of each bin in bin_mbs (size nbins+1)
+  DvceArray1D<int> bin_mbs;    // MeshBlocks overlapping each bin
+  void Build();
+};
+
+#endif // UTILS_MB_LOCATOR_HPP_
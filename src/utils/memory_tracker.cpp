@@ -0,0 +1,194 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file memory_tracker.cpp
+//! \brief Implementation of functions in memory_tracker namespace
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "memory_tracker.hpp"
+#include "roofline.hpp"
+
+#if defined(KOKKOS_ENABLE_CUDA)
+#include <cuda_runtime.h>
+#elif defined(KOKKOS_ENABLE_HIP)
+#include <hip/hip_runtime.h>
+#endif
+
+namespace memory_tracker {
+bool enabled = false;   // set in Initialize()
+bool report = false;    // print breakdown at startup and after each AMR step
+
+namespace {
+const char *owner_name[nowner] = {"Mesh", "Hydro", "MHD", "Radiation", "Z4c", "ADM",
+                                  "Buffers", "Outputs", "Other"};
+Owner current_owner = Owner::other;
+std::int64_t owner_bytes[nowner] = {0};   // device bytes currently held by each owner
+std::int64_t peak_bytes = 0;              // largest total device bytes during run
+std::int64_t capacity = 0;                // device memory size (0 until first query)
+// owner and size of each live device allocation, so deallocations can be attributed
+std::unordered_map<const void*, std::pair<int, std::int64_t>> live;
+
+//----------------------------------------------------------------------------------------
+//! \fn void AllocateData()
+//! \brief Kokkos Tools callback for every allocation.  Only allocations in the device
+//! memory space are counted (which includes all Views in builds without a device).
+
+void AllocateData(const Kokkos::Profiling::SpaceHandle handle, const char *label,
+                  const void *ptr, const std::uint64_t size) {
+  if (std::strcmp(handle.name, DevMemSpace::name()) != 0) {return;}
+  int o = static_cast<int>(current_owner);
+  live[ptr] = std::make_pair(o, static_cast<std::int64_t>(size));
+  owner_bytes[o] += size;
+  std::int64_t total = DeviceBytes();
+  if (total > peak_bytes) {peak_bytes = total;}
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void DeallocateData()
+//! \brief Kokkos Tools callback for every deallocation.  Bytes are returned to the owner
+//! that allocated them, whatever Scope is active at the time.
+
+void DeallocateData(const Kokkos::Profiling::SpaceHandle handle, const char *label,
+                    const void *ptr, const std::uint64_t size) {
+  auto it = live.find(ptr);
+  if (it == live.end()) {return;}
+  owner_bytes[it->second.first] -= it->second.second;
+  live.erase(it);
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void memory_tracker::Initialize()
+//! \brief Reads <memory_tracker> parameters and registers the Kokkos Tools callbacks.
+//! Must be called after Kokkos::initialize() and before any physics is constructed.
+
+void Initialize(ParameterInput *pin) {
+  enabled = pin->GetOrAddBoolean("memory_tracker", "enable", true);
+  report = pin->GetOrAddBoolean("memory_tracker", "report", true);
+  // optional size of device memory in GiB, overrides the value queried from the device
+  Real gib = pin->GetOrAddReal("memory_tracker", "device_memory", 0.0);
+  if (gib > 0.0) {capacity = static_cast<std::int64_t>(gib*1073741824.0);}
+  if (!(enabled)) {return;}
+  if (Kokkos::Tools::profileLibraryLoaded() && !(roofline::enabled)) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Kokkos Tools library is loaded, so memory tracking is disabled"
+                << std::endl;
+    }
+    enabled = false;
+    return;
+  }
+  Kokkos::Tools::Experimental::set_allocate_data_callback(AllocateData);
+  Kokkos::Tools::Experimental::set_deallocate_data_callback(DeallocateData);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void memory_tracker::Finalize()
+//! \brief Prints peak memory used, and removes callbacks.  Must be called before
+//! Kokkos::finalize().
+
+void Finalize() {
+  if (!(enabled)) {return;}
+  if (report && global_variable::my_rank == 0) {
+    std::cout << std::endl << "Peak device memory tracked on rank 0 = "
+              << static_cast<double>(peak_bytes)/1048576.0 << " MiB" << std::endl;
+  }
+  Kokkos::Tools::Experimental::set_allocate_data_callback(nullptr);
+  Kokkos::Tools::Experimental::set_deallocate_data_callback(nullptr);
+  live.clear();
+  enabled = false;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::int64_t memory_tracker::DeviceBytes()
+//! \brief Returns total bytes allocated by Kokkos in device memory on this rank.
+
+std::int64_t DeviceBytes() {
+  std::int64_t total = 0;
+  for (int o=0; o<nowner; ++o) {total += owner_bytes[o];}
+  return total;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::int64_t memory_tracker::DeviceCapacity()
+//! \brief Returns the size of the device memory, unless set by
+//! <memory_tracker>/device_memory.  Without a GPU the physical memory of the node is
+//! returned.  Note ranks sharing a device (or node) each see the full capacity.
+
+std::int64_t DeviceCapacity() {
+  if (capacity > 0) {return capacity;}
+#if defined(KOKKOS_ENABLE_CUDA)
+  std::size_t free_mem, total_mem;
+  cudaMemGetInfo(&free_mem, &total_mem);
+  capacity = static_cast<std::int64_t>(total_mem);
+#elif defined(KOKKOS_ENABLE_HIP)
+  std::size_t free_mem, total_mem;
+  (void) hipMemGetInfo(&free_mem, &total_mem);
+  capacity = static_cast<std::int64_t>(total_mem);
+#else
+  capacity = static_cast<std::int64_t>(sysconf(_SC_PHYS_PAGES))*
+             static_cast<std::int64_t>(sysconf(_SC_PAGE_SIZE));
+#endif
+  return capacity;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void memory_tracker::Report()
+//! \brief Prints the device memory held by each owner (maximum over all ranks).  With
+//! MPI this must be called by every rank.
+
+void Report(const std::string &when) {
+  if (!(enabled) || !(report)) {return;}
+  long long bytes[nowner+1];  // NOLINT(runtime/int)
+  for (int o=0; o<nowner; ++o) {bytes[o] = owner_bytes[o];}
+  bytes[nowner] = DeviceBytes();
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, bytes, nowner+1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(bytes, bytes, nowner+1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+  }
+#endif
+  if (global_variable::my_rank != 0) {return;}
+
+  std::int64_t cap = DeviceCapacity();
+  std::cout << std::endl << "Device memory " << when << " (MiB, max over ranks):"
+            << std::endl;
+  char buf[64];
+  for (int o=0; o<nowner; ++o) {
+    if (bytes[o] == 0) {continue;}
+    std::snprintf(buf, sizeof(buf), "  %-10s %12.2f", owner_name[o],
+                  static_cast<double>(bytes[o])/1048576.0);
+    std::cout << buf << std::endl;
+  }
+  std::snprintf(buf, sizeof(buf), "  %-10s %12.2f (%.1f%% of device)", "Total",
+                static_cast<double>(bytes[nowner])/1048576.0,
+                100.0*static_cast<double>(bytes[nowner])/static_cast<double>(cap));
+  std::cout << buf << std::endl;
+}
+
+//----------------------------------------------------------------------------------------
+// Scope constructor and destructor
+
+Scope::Scope(Owner o) : prev_owner_(current_owner) {
+  current_owner = o;
+}
+
+Scope::~Scope() {
+  current_owner = prev_owner_;
+}
+
+} // namespace memory_tracker
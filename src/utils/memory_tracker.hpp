@@ -0,0 +1,57 @@
+#ifndef UTILS_MEMORY_TRACKER_HPP_
+#define UTILS_MEMORY_TRACKER_HPP_
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file memory_tracker.hpp
+//! \brief Accounting of the memory allocated by Kokkos in the device memory space.
+//!
+//! When enabled with <memory_tracker>/enable=true (the default), allocation and
+//! deallocation callbacks are registered with the Kokkos Tools interface, and the bytes
+//! of every View allocated in the device memory space are attributed to the module that
+//! owns it.  The owner is set with a memory_tracker::Scope object while a module (e.g.
+//! Hydro) is constructed or, for buffers and outputs, while their data is allocated.
+//! Allocations made outside of any Scope are attributed to Owner::other.  The breakdown
+//! by owner is printed at startup and after each AMR step if <memory_tracker>/report is
+//! true.  Tracking is disabled if a Kokkos Tools library is already loaded, since its
+//! callbacks would be replaced.
+
+#include <cstdint>
+#include <string>
+
+class ParameterInput;
+
+namespace memory_tracker {
+
+enum class Owner {mesh, hydro, mhd, radiation, z4c, adm, buffers, outputs, other};
+constexpr int nowner = 9;
+
+extern bool enabled;
+extern bool report;
+
+void Initialize(ParameterInput *pin);
+void Finalize();
+std::int64_t DeviceBytes();      // bytes currently allocated in device memory
+std::int64_t DeviceCapacity();   // total size of device memory
+void Report(const std::string &when);
+
+//----------------------------------------------------------------------------------------
+//! \class Scope
+//! \brief Attributes all allocations made during its lifetime to owner o.  Scopes may be
+//! nested, in which case the innermost owner is used.
+
+class Scope {
+ public:
+  explicit Scope(Owner o);
+  ~Scope();
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+ private:
+  Owner prev_owner_;
+};
+
+} // namespace memory_tracker
+
+#endif // UTILS_MEMORY_TRACKER_HPP_
@@ -189,4 +189,25 @@ static Real RanGaussian(int64_t *idum) {
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn RanCounter
+//! \brief Counter-based (stateless) random number generator.  Returns a uniform random
+//! deviate between 0.0 and 1.0 (exclusive of the endpoint values) that depends only on
+//! (key, counter), by hashing them with the SplitMix64 finalizer.  Threads can therefore
+//! draw independent deviates without storing or sharing generator state, e.g. with key
+//! a seed and counter built from a particle tag and the cycle number.
+
+KOKKOS_INLINE_FUNCTION
+Real RanCounter(uint64_t key, uint64_t counter) {
+  uint64_t z = key*0x9E3779B97F4A7C15ULL + counter;
+  for (int n=0; n<2; ++n) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+  }
+  // top 53 bits, shifted by half a unit so result is never exactly 0.0 or 1.0
+  return (static_cast<Real>(z >> 11) + 0.5)*(1.0/9007199254740992.0);
+}
+
 #endif // UTILS_RANDOM_HPP_
@@ -0,0 +1,167 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file roofline.cpp
+//! \brief Implementation of functions in roofline namespace
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "roofline.hpp"
+
+namespace roofline {
+bool enabled = false;   // set in Initialize()
+
+namespace {
+// work estimated by AddWork() and time measured by callbacks for each label
+struct KernelStats {
+  double bytes = 0.0, flops = 0.0, time = 0.0;
+  int nlaunch = 0;
+};
+std::vector<std::string> labels;
+std::vector<KernelStats> stats;
+std::map<std::string, int> index;   // position of each label in stats
+Real peak_bw = 0.0, peak_gflops = 0.0;
+Kokkos::Timer kernel_timer;
+
+int Index(const std::string &label) {
+  auto it = index.find(label);
+  if (it != index.end()) {return it->second;}
+  int n = stats.size();
+  index[label] = n;
+  labels.push_back(label);
+  stats.emplace_back();
+  return n;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BeginParallelFor()
+//! \brief Kokkos Tools callback at every parallel_for launch.  Kernels with a registered
+//! label are timed, with the kernel ID set to their index plus one (zero otherwise).
+
+void BeginParallelFor(const char *name, const std::uint32_t devid, std::uint64_t *kid) {
+  auto it = index.find(name);
+  if (it == index.end()) {
+    *kid = 0;
+    return;
+  }
+  *kid = it->second + 1;
+  Kokkos::fence("roofline");
+  kernel_timer.reset();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void EndParallelFor()
+//! \brief Kokkos Tools callback at the end of every parallel_for launch
+
+void EndParallelFor(const std::uint64_t kid) {
+  if (kid == 0) {return;}
+  Kokkos::fence("roofline");
+  stats[kid-1].time += kernel_timer.seconds();
+  stats[kid-1].nlaunch++;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void roofline::Initialize()
+//! \brief Reads <roofline> parameters and registers the Kokkos Tools callbacks.  Must be
+//! called after Kokkos::initialize().
+
+void Initialize(ParameterInput *pin) {
+  enabled = pin->GetOrAddBoolean("roofline", "enable", false);
+  if (!(enabled)) {return;}
+  peak_bw = pin->GetOrAddReal("roofline", "peak_bandwidth", 0.0);
+  peak_gflops = pin->GetOrAddReal("roofline", "peak_gflops", 0.0);
+  if (Kokkos::Tools::profileLibraryLoaded()) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Kokkos Tools library is loaded, so roofline analysis is disabled"
+                << std::endl;
+    }
+    enabled = false;
+    return;
+  }
+  Kokkos::Tools::Experimental::set_begin_parallel_for_callback(BeginParallelFor);
+  Kokkos::Tools::Experimental::set_end_parallel_for_callback(EndParallelFor);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void roofline::Finalize()
+//! \brief Removes callbacks.  Must be called before Kokkos::finalize().
+
+void Finalize() {
+  if (!(enabled)) {return;}
+  Kokkos::Tools::Experimental::set_begin_parallel_for_callback(nullptr);
+  Kokkos::Tools::Experimental::set_end_parallel_for_callback(nullptr);
+  enabled = false;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void roofline::Record()
+//! \brief Adds work of one kernel launch, see AddWork()
+
+void Record(const std::string &label, double ncells, double bytes, double flops) {
+  KernelStats &s = stats[Index(label)];
+  s.bytes += ncells*bytes;
+  s.flops += ncells*flops;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void roofline::Report()
+//! \brief Prints achieved bandwidth and flop rate of each labelled kernel, averaged over
+//! ranks.  With MPI this must be called by every rank, and every rank must have launched
+//! the same labelled kernels (as is the case when all ranks run the same physics).
+
+void Report() {
+  if (!(enabled)) {return;}
+  int n = stats.size();
+  std::vector<double> sum(3*n);
+  for (int i=0; i<n; ++i) {
+    sum[3*i] = stats[i].bytes;
+    sum[3*i + 1] = stats[i].flops;
+    sum[3*i + 2] = stats[i].time;
+  }
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, sum.data(), 3*n, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(sum.data(), nullptr, 3*n, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  }
+#endif
+  if (global_variable::my_rank != 0) {return;}
+
+  std::cout << std::endl << "Roofline analysis (per rank, analytic bytes and flops)"
+            << std::endl;
+  char buf[160];
+  std::snprintf(buf, sizeof(buf), "  %-24s %8s %11s %9s %9s %8s %7s %7s %s", "kernel",
+                "launches", "time(s)", "GB/s", "GFLOP/s", "flop/B", "%bw", "%flop",
+                "bound");
+  std::cout << buf << std::endl;
+  double ridge = (peak_bw > 0.0)? peak_gflops/peak_bw : 0.0;
+  for (int i=0; i<n; ++i) {
+    double t = sum[3*i + 2];
+    if (t <= 0.0) {continue;}
+    double gbs = 1.0e-9*sum[3*i]/t;
+    double gflops = 1.0e-9*sum[3*i + 1]/t;
+    double ai = (sum[3*i] > 0.0)? sum[3*i + 1]/sum[3*i] : 0.0;
+    double pbw = (peak_bw > 0.0)? 100.0*gbs/peak_bw : 0.0;
+    double pfl = (peak_gflops > 0.0)? 100.0*gflops/peak_gflops : 0.0;
+    const char *bound = (ridge <= 0.0)? "-" : ((ai < ridge)? "memory" : "compute");
+    std::snprintf(buf, sizeof(buf), "  %-24s %8d %11.4e %9.2f %9.2f %8.2f %7.1f %7.1f %s",
+                  labels[i].c_str(), stats[i].nlaunch,
+                  t/static_cast<double>(global_variable::nranks), gbs, gflops, ai, pbw,
+                  pfl, bound);
+    std::cout << buf << std::endl;
+  }
+}
+
+} // namespace roofline
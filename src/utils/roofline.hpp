@@ -0,0 +1,61 @@
+#ifndef UTILS_ROOFLINE_HPP_
+#define UTILS_ROOFLINE_HPP_
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file roofline.hpp
+//! \brief Achieved bandwidth and flop rate of labelled kernels, for roofline analysis.
+//!
+//! When enabled with <roofline>/enable=true, the host code launching a kernel calls
+//! roofline::AddWork() with its label, the number of cells it updates, and an analytic
+//! estimate of the DRAM bytes moved and floating point operations per cell (each cell
+//! loaded and stored once, scratch and cache traffic not counted).  Kokkos Tools
+//! callbacks fence and time every launch of a kernel with a registered label.  At the end
+//! of the run Report() prints, for each label, the time, GB/s, GFLOP/s and arithmetic
+//! intensity, and the fraction of the device peaks given by <roofline>/peak_bandwidth
+//! (GB/s) and <roofline>/peak_gflops.  Fencing around every timed kernel removes
+//! overlap, so this mode is for analysis only.  It is disabled if a Kokkos Tools library
+//! is loaded, since its callbacks would be replaced.
+
+#include <string>
+
+#include "athena.hpp"
+
+class ParameterInput;
+
+namespace roofline {
+
+extern bool enabled;
+
+void Initialize(ParameterInput *pin);
+void Finalize();
+void Record(const std::string &label, double ncells, double bytes, double flops);
+void Report();
+
+//----------------------------------------------------------------------------------------
+//! \fn void roofline::AddWork()
+//! \brief Adds the estimated work of one launch of kernel label over ncells cells, with
+//! bytes and flops per cell.  Does nothing unless roofline analysis is enabled.
+
+inline void AddWork(const std::string &label, double ncells, double bytes, double flops) {
+  if (enabled) {Record(label, ncells, bytes, flops);}
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real roofline::ReconFlops()
+//! \brief Rough number of floating point operations per variable to compute the L/R
+//! states at one face.  Added to the RSolverFlops() of each physics module to estimate
+//! the flops of its flux kernels.
+
+inline Real ReconFlops(ReconstructionMethod recon) {
+  if (recon == ReconstructionMethod::dc) {return 0.0;}
+  if (recon == ReconstructionMethod::plm) {return 12.0;}
+  if (recon == ReconstructionMethod::wenoz) {return 80.0;}
+  return 40.0;  // PPM4 and PPMX
+}
+
+} // namespace roofline
+
+#endif // UTILS_ROOFLINE_HPP_
@@ -32,6 +32,20 @@ void ShowConfig() {
 #else
   std::cout<<"  OpenMP parallelism:         OFF" << std::endl;
 #endif
+#if FIXED_MB_NX1 > 0
+  std::cout<<"  MeshBlock size (fixed):     " << FIXED_MB_NX1 << "x" << FIXED_MB_NX2
+           << "x" << FIXED_MB_NX3 << ", nghost=" << FIXED_MB_NGHOST << std::endl;
+#endif
+#if RADIATION_ENABLED
+  std::cout<<"  Radiation module:           ON" << std::endl;
+#else
+  std::cout<<"  Radiation module:           OFF" << std::endl;
+#endif
+#if ION_NEUTRAL_ENABLED
+  std::cout<<"  Ion-neutral module:         ON" << std::endl;
+#else
+  std::cout<<"  Ion-neutral module:         OFF" << std::endl;
+#endif
 
   // std::cout<<"  Compiler:                   " << COMPILED_WITH << std::endl;
   // std::cout<<"  Compilation command:        " << COMPILER_COMMAND
@@ -0,0 +1,112 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file team_tuner.cpp
+//! \brief Implementation of functions in TeamTuneData and team_tuner namespace
+
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "team_tuner.hpp"
+
+namespace team_tuner {
+bool enabled = false;   // set in Initialize()
+int ntrial = 2;         // number of timed calls of each candidate configuration
+std::map<std::string, TeamTuneData> kernels;
+std::map<std::string, std::vector<int>> cache;
+std::string cache_file;
+} // namespace team_tuner
+
+//----------------------------------------------------------------------------------------
+//! \fn void TeamTuneData::AddCandidate()
+//! \brief Adds candidate configuration, if not already in the list
+
+void TeamTuneData::AddCandidate(int ts, int vl) {
+  for (std::size_t n=0; n<team_size.size(); ++n) {
+    if ((team_size[n] == ts) && (vector_length[n] == vl)) {return;}
+  }
+  team_size.push_back(ts);
+  vector_length.push_back(vl);
+  min_time.push_back(std::numeric_limits<double>::max());
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TeamTuneData::RecordTime()
+//! \brief Stores time of call using candidate c.  Once every candidate has been timed
+//! ntrial times, the candidate with the smallest time is selected.
+
+void TeamTuneData::RecordTime(int c, double time, int ntrial) {
+  if (time < min_time[c]) {min_time[c] = time;}
+  ncalls++;
+  if (ncalls >= ntrial*static_cast<int>(team_size.size())) {
+    choice = 0;
+    for (std::size_t n=1; n<min_time.size(); ++n) {
+      if (min_time[n] < min_time[choice]) {choice = n;}
+    }
+  }
+}
+
+namespace team_tuner {
+//----------------------------------------------------------------------------------------
+//! \fn void team_tuner::Initialize()
+//! \brief Reads <team_tuner> parameters, and configurations selected in a previous run
+//! from file (if it exists).  Each line of the file is: team_size vector_length label
+
+void Initialize(ParameterInput *pin) {
+  enabled = pin->GetOrAddBoolean("team_tuner", "enable", false);
+  if (!(enabled)) {return;}
+  ntrial = pin->GetOrAddInteger("team_tuner", "ntrial", 2);
+  cache_file = pin->GetOrAddString("team_tuner", "file", "");
+  if (cache_file.empty()) {return;}
+
+  std::ifstream file(cache_file);
+  if (!(file.is_open())) {return;}  // no file yet, so tune all kernels
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+    int ts, vl;
+    std::string name;
+    if (!(iss >> ts >> vl)) {continue;}
+    std::getline(iss >> std::ws, name);
+    if (!(name.empty())) {cache[name] = {ts, vl};}
+  }
+  if (global_variable::my_rank == 0) {
+    std::cout << "team_tuner: read " << cache.size() << " kernel configurations from "
+              << cache_file << std::endl;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void team_tuner::Finalize()
+//! \brief Writes selected configurations to file (on rank 0 only).  Kernels still being
+//! tuned at end of run are not written.  Kernels read from file but not called in this
+//! run are kept.
+
+void Finalize() {
+  if (!(enabled) || cache_file.empty() || (global_variable::my_rank != 0)) {return;}
+  for (auto &it : kernels) {
+    TeamTuneData &data = it.second;
+    if (data.choice >= 0) {
+      cache[it.first] = {data.team_size[data.choice], data.vector_length[data.choice]};
+    }
+  }
+  std::ofstream file(cache_file);
+  if (!(file.is_open())) {
+    std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "team_tuner: could not open file '" << cache_file << "'" << std::endl;
+    return;
+  }
+  for (auto &it : cache) {
+    file << it.second[0] << " " << it.second[1] << " " << it.first << std::endl;
+  }
+}
+
+} // namespace team_tuner
@@ -0,0 +1,53 @@
+#ifndef UTILS_TEAM_TUNER_HPP_
+#define UTILS_TEAM_TUNER_HPP_
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file team_tuner.hpp
+//! \brief Autotuner for the team size and vector length of par_for_outer kernels.
+//!
+//! When enabled with <team_tuner>/enable=true, the first calls of each labelled
+//! par_for_outer kernel cycle through a set of candidate (team size, vector length)
+//! configurations, each timed <team_tuner>/ntrial times.  The fastest configuration is
+//! then used for the rest of the run.  Every call does the real work of the kernel, so
+//! tuning is spread over the first cycles of the run rather than replaying kernels.
+//! Selected configurations can be read from and written to <team_tuner>/file, so that
+//! subsequent runs on the same hardware and MeshBlock size skip the tuning.
+
+#include <map>
+#include <string>
+#include <vector>
+
+class ParameterInput;
+
+//----------------------------------------------------------------------------------------
+//! \struct TeamTuneData
+//! \brief candidate configurations and timings for one labelled kernel.  A team size or
+//! vector length of 0 means Kokkos::AUTO.
+
+struct TeamTuneData {
+  std::vector<int> team_size, vector_length;  // candidate configurations
+  std::vector<double> min_time;               // fastest time of each candidate
+  int ncalls = 0;                             // number of timed calls so far
+  int choice = -1;                            // selected candidate (-1 while tuning)
+
+  void AddCandidate(int ts, int vl);
+  int NextCandidate() const {
+    return (choice >= 0)? choice : (ncalls % static_cast<int>(team_size.size()));
+  }
+  void RecordTime(int c, double time, int ntrial);
+};
+
+namespace team_tuner {
+extern bool enabled;
+extern int ntrial;
+extern std::map<std::string, TeamTuneData> kernels;   // data for each labelled kernel
+extern std::map<std::string, std::vector<int>> cache; // configurations read from file
+
+void Initialize(ParameterInput *pin);
+void Finalize();
+} // namespace team_tuner
+
+#endif // UTILS_TEAM_TUNER_HPP_
@@ -0,0 +1,101 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file transient_pool.cpp
+//! \brief Implementation of functions in transient_pool namespace
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "memory_tracker.hpp"
+#include "transient_pool.hpp"
+
+namespace transient_pool {
+bool enabled = false;   // set in Initialize()
+
+namespace {
+constexpr std::size_t alignment = 256;      // alignment of every allocation in bytes
+using Buffer = Kokkos::View<char*, DevMemSpace>;
+std::vector<Buffer> buffers;                // buffers in use, newest last
+std::size_t offset = 0;                     // bytes used in newest buffer
+std::size_t used = 0;                       // bytes used in all buffers this cycle
+std::size_t initial_size = 0;               // size of first buffer
+
+//----------------------------------------------------------------------------------------
+//! \fn void AddBuffer()
+//! \brief Appends a new buffer of at least nbytes, and at least as large as all existing
+//! buffers combined, so that the number of buffers stays small within one cycle.
+
+void AddBuffer(std::size_t nbytes) {
+  std::size_t total = 0;
+  for (auto &b : buffers) {total += b.extent(0);}
+  std::size_t size = std::max(std::max(nbytes, total), initial_size);
+  memory_tracker::Scope scope(memory_tracker::Owner::buffers);
+  buffers.push_back(Buffer(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                                              "transient_pool"), size));
+  offset = 0;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void transient_pool::Initialize()
+//! \brief Reads <transient_pool> parameters.  Must be called after Kokkos::initialize().
+
+void Initialize(ParameterInput *pin) {
+  enabled = pin->GetOrAddBoolean("transient_pool", "enable", true);
+  // optional initial size in MiB, the pool otherwise grows to the size needed
+  Real mib = pin->GetOrAddReal("transient_pool", "initial_size", 0.0);
+  initial_size = static_cast<std::size_t>(std::max(mib, 0.0)*1048576.0);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void transient_pool::Finalize()
+//! \brief Frees all buffers.  Must be called before Kokkos::finalize().
+
+void Finalize() {
+  buffers.clear();
+  offset = 0;
+  used = 0;
+  enabled = false;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void transient_pool::Reset()
+//! \brief Releases all allocations made since the last Reset().  If more than one buffer
+//! was needed, they are replaced with a single buffer large enough for all of them.
+
+void Reset() {
+  if (buffers.size() > 1) {
+    std::size_t total = 0;
+    for (auto &b : buffers) {total += b.extent(0);}
+    buffers.clear();
+    AddBuffer(std::max(total, used));
+  }
+  offset = 0;
+  used = 0;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void *transient_pool::Allocate()
+//! \brief Returns a pointer to nbytes of device memory from the pool, valid until the
+//! next Reset().
+
+void *Allocate(std::size_t nbytes) {
+  nbytes = std::max(nbytes, alignment);
+  nbytes = ((nbytes + alignment - 1)/alignment)*alignment;
+  if (buffers.empty() || offset + nbytes > buffers.back().extent(0)) {
+    AddBuffer(nbytes);
+  }
+  void *ptr = buffers.back().data() + offset;
+  offset += nbytes;
+  used += nbytes;
+  return ptr;
+}
+
+} // namespace transient_pool
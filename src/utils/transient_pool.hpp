@@ -0,0 +1,53 @@
+#ifndef UTILS_TRANSIENT_POOL_HPP_
+#define UTILS_TRANSIENT_POOL_HPP_
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file transient_pool.hpp
+//! \brief Arena allocator in device memory for short-lived scratch Views.
+//!
+//! Scratch arrays that only live for the duration of one function call (e.g. sort keys
+//! of particles, or coarsened data in outputs) are carved out of a device buffer owned
+//! by the pool, rather than allocated and freed with every call.  On GPUs each device
+//! allocation and deallocation synchronizes the device, so this removes those stalls.
+//! The pool is reset by the Driver at the end of every cycle, so Views obtained from it
+//! must never be stored in data that outlives the cycle.  If a cycle needs more memory
+//! than the pool holds, another buffer is added, and all buffers are merged into one at
+//! the next Reset(), so that after the first few cycles no further allocations are made.
+//! With <transient_pool>/enable=false, Get() returns ordinary (managed) Views.
+
+#include <cstddef>
+#include <string>
+
+#include "athena.hpp"
+
+class ParameterInput;
+
+namespace transient_pool {
+
+extern bool enabled;
+
+void Initialize(ParameterInput *pin);
+void Finalize();
+void Reset();
+void *Allocate(std::size_t nbytes);
+
+//----------------------------------------------------------------------------------------
+//! \fn V transient_pool::Get()
+//! \brief Returns a View of type V with extents n..., initialized to zero like a newly
+//! allocated View, whose memory is taken from the pool.
+
+template <typename V, typename... Ns>
+V Get(const std::string &label, Ns... n) {
+  if (!(enabled)) {return V(label, n...);}
+  V v(static_cast<typename V::pointer_type>(
+      Allocate(V::required_allocation_size(static_cast<std::size_t>(n)...))), n...);
+  Kokkos::deep_copy(DevExeSpace(), v, typename V::non_const_value_type());
+  return v;
+}
+
+} // namespace transient_pool
+
+#endif // UTILS_TRANSIENT_POOL_HPP_
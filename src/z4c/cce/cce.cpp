@@ -11,10 +11,13 @@
 #include <sstream>
 #include <fstream>
 #include <iomanip>
+#include <iostream>
 #include <memory>
 #include <utility>
 #include <string>
 #include <cstdio>
+#include <thread>
+#include <vector>
 
 #ifdef MPI_PARALLEL
 #include <mpi.h>
@@ -28,8 +31,9 @@
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
 #include "geodesic-grid/gauss_legendre.hpp"
-#include "utils/spherical_harm.hpp"
+#include "utils/interp_service.hpp"
 #include "utils/chebyshev.hpp"
+#include "outputs/hdf5_utils.hpp"
 
 #define BUFFSIZE  (1024)
 #define MAX_RADII (100)
@@ -37,6 +41,33 @@
 
 namespace z4c {
 
+//----------------------------------------------------------------------------------------
+//! \fn void NormalizedLegendre()
+//! \brief Y_lm(theta,0) for 0 <= m <= l <= lmax with the Condon-Shortley phase (i.e. the
+//! real part of SWSphericalHarm with s=0 and phi=0), from the stable recursions of the
+//! normalized associated Legendre functions.  Stored in plm[l*(l+1)/2 + m].
+
+void NormalizedLegendre(int lmax, Real theta, std::vector<Real> &plm) {
+  Real x = cos(theta);
+  Real y = sin(theta);
+  plm.assign((lmax+1)*(lmax+2)/2, 0.0);
+  Real pmm = sqrt(1.0/(4.0*M_PI));
+  for (int m = 0; m < lmax+1; ++m) {
+    if (m > 0) {
+      pmm *= -sqrt((2.0*m + 1.0)/(2.0*m))*y;
+    }
+    plm[m*(m+1)/2 + m] = pmm;
+    if (m < lmax) {
+      plm[(m+1)*(m+2)/2 + m] = sqrt(2.0*m + 3.0)*x*pmm;
+    }
+    for (int l = m+2; l < lmax+1; ++l) {
+      Real a = sqrt((4.0*l*l - 1.0)/(static_cast<Real>(l*l - m*m)));
+      Real b = sqrt((static_cast<Real>((l-1)*(l-1) - m*m))/(4.0*(l-1)*(l-1) - 1.0));
+      plm[l*(l+1)/2 + m] = a*(x*plm[(l-1)*l/2 + m] - b*plm[(l-2)*(l-1)/2 + m]);
+    }
+  }
+}
+
 CCE::CCE(Mesh *const pm, ParameterInput *const pin, int index):
   pm(pm),
   pin(pin),
@@ -61,6 +92,8 @@ CCE::CCE(Mesh *const pm, ParameterInput *const pin, int index):
   for (int k = 0; k < nr; ++k) {
     Real rad = ChebyshevSecondKindCollocationPoints(rin,rout,nr,k);
     grids.push_back(std::make_unique<GaussLegendreGrid>(pmbp, ntheta, rad));
+    grid_sets.push_back(pmbp->pinterp->AddPointSet(grids[k]->nangles));
+    pmbp->pinterp->SetPoints(grid_sets[k], grids[k]->cart_pos.d_view);
   }
 
   variable_to_dump.push_back(std::make_pair(pmbp->pz4c->I_Z4C_ALPHA, true));
@@ -73,103 +106,322 @@ CCE::CCE(Mesh *const pm, ParameterInput *const pin, int index):
   variable_to_dump.push_back(std::make_pair(pmbp->padm->I_ADM_GYY, false));
   variable_to_dump.push_back(std::make_pair(pmbp->padm->I_ADM_GYZ, false));
   variable_to_dump.push_back(std::make_pair(pmbp->padm->I_ADM_GZZ, false));
+
+  // Tables of the spherical harmonic transform.  Gridpoint n of every sphere lies at
+  // theta index n%nth and phi index n/nth, and all spheres share the same angles.
+  int nth = grids[0]->ntheta;
+  int nph = grids[0]->nangles/nth;
+  int nvar = static_cast<int>(variable_to_dump.size());
+  Kokkos::realloc(leg_wghts, num_angular_modes, nth);
+  Kokkos::realloc(phi_cos, num_l_modes+1, nph);
+  Kokkos::realloc(phi_sin, num_l_modes+1, nph);
+  Kokkos::realloc(fm_real, nvar, nr, num_l_modes+1, nth);
+  Kokkos::realloc(fm_imag, nvar, nr, num_l_modes+1, nth);
+  Kokkos::realloc(coeffs, 2*nvar*nr*num_angular_modes);
+  auto leg_h = Kokkos::create_mirror_view(leg_wghts);
+  auto cos_h = Kokkos::create_mirror_view(phi_cos);
+  auto sin_h = Kokkos::create_mirror_view(phi_sin);
+  std::vector<Real> plm;
+  for (int it = 0; it < nth; ++it) {
+    NormalizedLegendre(num_l_modes, grids[0]->polar_pos.h_view(it,0), plm);
+    Real weight = grids[0]->int_weights.h_view(it);
+    for (int l = 0; l < num_l_modes+1; ++l) {
+      for (int m = -l; m < l+1; ++m) {
+        // Y_l,-m = (-1)^m conj(Y_lm)
+        Real sign = (m < 0 && (ABS(m) % 2 == 1)) ? -1.0 : 1.0;
+        leg_h(l*l+l+m, it) = sign*weight*plm[l*(l+1)/2 + ABS(m)];
+      }
+    }
+  }
+  for (int m = 0; m < num_l_modes+1; ++m) {
+    for (int ip = 0; ip < nph; ++ip) {
+      Real phi = grids[0]->polar_pos.h_view(ip*nth,1);
+      cos_h(m,ip) = cos(m*phi);
+      sin_h(m,ip) = sin(m*phi);
+    }
+  }
+  Kokkos::deep_copy(leg_wghts, leg_h);
+  Kokkos::deep_copy(phi_cos, cos_h);
+  Kokkos::deep_copy(phi_sin, sin_h);
+
+  // All extractions of this set of spheres are appended to a single file by rank 0
+  buffer_steps = std::max(1, pin->GetOrAddInteger("cce", "buffer_steps", 64));
+  nbuf = 0;
+  nwbuf = 0;
+  file_created = false;
+#if HDF5OUTPUT_ENABLED
+  filename = "cce/cce_" + std::to_string(index) + ".h5";
+#else
+  filename = "cce/cce_" + std::to_string(index) + ".bin";
+#endif
+  if (0 == global_variable::my_rank) {
+    buf.resize(static_cast<std::size_t>(buffer_steps)*(1 + 2*nvar*nr*num_angular_modes));
+    wbuf.resize(buf.size());
+  }
 }
 
-CCE::~CCE() {}
+// Writes any buffered records before the object is destroyed
+CCE::~CCE() {
+  if (0 == global_variable::my_rank) {
+    Flush();
+    if (writer.joinable()) {writer.join();}
+  }
+}
 
-// Interpolate all fields to Gauss-Legendre Sphere
-void CCE::InterpolateAndDecompose(MeshBlockPack *pmbp) {
-  Real ylmR,ylmI;
+//----------------------------------------------------------------------------------------
+//! \fn void CCE::Flush()
+//! \brief Waits for the previous write to finish, then starts writing the buffered
+//! records in the background while new records are collected in the other buffer.  The
+//! write is done synchronously when HDF5 is not built thread-safe, since other outputs
+//! may call the library at the same time.
 
-  // raveled shape of array & counts for mpi
-  int count = 10*nr*num_angular_modes;
-  // Dynamically allocate memory for the 4D array flattened into 1D
-  Real* data_real = new Real[count];
-  Real* data_imag = new Real[count];
-  for(int nvar=0; nvar<10; nvar++) {
+void CCE::Flush() {
+  if (writer.joinable()) {writer.join();}
+  if (nbuf == 0) {return;}
+  std::swap(buf, wbuf);
+  nwbuf = nbuf;
+  nbuf = 0;
+#if HDF5OUTPUT_ENABLED && !defined(H5_HAVE_THREADSAFE)
+  WriteBuffer();
+#else
+  writer = std::thread(&CCE::WriteBuffer, this);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CCE::WriteBuffer()
+//! \brief Appends the nwbuf records in wbuf to the output file.
+//!
+//! With HDF5 the file holds a group Radius_<k> for each sphere (with its radius as an
+//! attribute), containing one dataset per variable named as in the worldtube files read
+//! by SpECTRE CCE (Lapse.dat, Shrx.dat, ..., gzz.dat).  Each row of a dataset is the
+//! time followed by the real and imaginary parts of the coefficients for l = 0...lmax
+//! and m = -l...l, as described by its Legend attribute.  Otherwise the binary file
+//! starts with nr, num_l_modes (ints), rin and rout, followed by one record per
+//! extraction holding the time, then the real and the imaginary parts of all
+//! coefficients ordered by radius, variable and (l,m).
+
+void CCE::WriteBuffer() {
+  int nvar = static_cast<int>(variable_to_dump.size());
+  int nam = num_angular_modes;
+  int count = nvar*nr*nam;
+  std::size_t nrec = 1 + 2*static_cast<std::size_t>(count);
+#if HDF5OUTPUT_ENABLED
+  // in the order variables are added to variable_to_dump in the constructor
+  const char *var_names[] = {"Lapse", "Shrx", "Shry", "Shrz",
+                             "gxx", "gxy", "gxz", "gyy", "gyz", "gzz"};
+  hsize_t ncol = 1 + 2*nam;
+  hid_t file = (file_created)? H5Fopen(filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT) :
+               H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (file < 0) {
+    std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "CCE output file '" << filename << "' could not be opened, "
+              << nwbuf << " extractions are lost" << std::endl;
+    return;
+  }
+  if (!(file_created)) {
+    double rbnd[2] = {rin, rout};
+    hdf5_utils::WriteAttribute(file, "rin", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, 1,
+                               &rbnd[0]);
+    hdf5_utils::WriteAttribute(file, "rout", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, 1,
+                               &rbnd[1]);
+    hdf5_utils::WriteAttribute(file, "num_l_modes", H5T_STD_I32LE, H5T_NATIVE_INT, 1,
+                               &num_l_modes);
+    std::vector<std::string> legend(1, "time");
+    for (int l = 0; l < num_l_modes+1; ++l) {
+      for (int m = -l; m < l+1; ++m) {
+        std::string lm = std::to_string(l) + "," + std::to_string(m) + ")";
+        legend.push_back("Re(" + lm);
+        legend.push_back("Im(" + lm);
+      }
+    }
+    hsize_t dims[2] = {0, ncol}, maxdims[2] = {H5S_UNLIMITED, ncol};
+    hsize_t cdims[2] = {static_cast<hsize_t>(buffer_steps), ncol};
+    hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(dcpl, 2, cdims);
+    hid_t space = H5Screate_simple(2, dims, maxdims);
     for (int k = 0; k < nr; ++k) {
-      // Interpolate here
-      if (variable_to_dump[nvar].second) {
-        grids[k]->InterpolateToSphere(variable_to_dump[nvar].first,pmbp->pz4c->u0);
-      } else {
-        grids[k]->InterpolateToSphere(variable_to_dump[nvar].first,pmbp->padm->u_adm);
+      std::string gname = "Radius_" + std::to_string(k);
+      hid_t grp = H5Gcreate2(file, gname.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      double rad = grids[k]->radius;
+      hdf5_utils::WriteAttribute(grp, "Radius", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, 1,
+                                 &rad);
+      for (int v = 0; v < nvar; ++v) {
+        std::string dname = std::string(var_names[v]) + ".dat";
+        hid_t dset = H5Dcreate2(grp, dname.c_str(), H5T_IEEE_F64LE, space, H5P_DEFAULT,
+                                dcpl, H5P_DEFAULT);
+        hdf5_utils::WriteStringAttribute(dset, "Legend", legend, 16);
+        H5Dclose(dset);
       }
-      for (int l = 0; l < num_l_modes+1; ++l) {
-        for (int m = -l; m < l+1 ; ++m) {
-          Real psilmR = 0.0;
-          Real psilmI = 0.0;
-          for (int ip = 0; ip < grids[k]->nangles; ++ip) {
-            Real theta = grids[k]->polar_pos.h_view(ip,0);
-            Real phi = grids[k]->polar_pos.h_view(ip,1);
-            Real data = grids[k]->interp_vals.h_view(ip);
-            Real weight = grids[k]->int_weights.h_view(ip);
-            // calculate spherical harmonics
-            SWSphericalHarm(&ylmR,&ylmI, l, m, 0, theta, phi);
-            psilmR += weight*data*ylmR;
-            psilmI += weight*data*ylmI;
-          }
-          data_real[k * 10 * num_angular_modes // first over the different radii
-                    + nvar * num_angular_modes // then over the variables
-                    + l*l+l+m]                 // lastly over the angular harmonic index
-                    = psilmR;
-          data_imag[k * 10 * num_angular_modes // first over the different radii
-                    + nvar * num_angular_modes // then over the variables
-                    + l*l+l+m]                 // lastly over the angular harmonic index
-                    = psilmI;
+      H5Gclose(grp);
+    }
+    H5Sclose(space);
+    H5Pclose(dcpl);
+  }
+
+  // append nwbuf rows to every dataset
+  std::vector<double> rows(nwbuf*ncol);
+  for (int k = 0; k < nr; ++k) {
+    std::string gname = "Radius_" + std::to_string(k);
+    hid_t grp = H5Gopen2(file, gname.c_str(), H5P_DEFAULT);
+    for (int v = 0; v < nvar; ++v) {
+      for (int n = 0; n < nwbuf; ++n) {
+        const Real *rec = &wbuf[n*nrec];
+        double *row = &rows[n*ncol];
+        row[0] = rec[0];
+        for (int lm = 0; lm < nam; ++lm) {
+          int i = k*nvar*nam + v*nam + lm;
+          row[1 + 2*lm] = rec[1 + i];
+          row[2 + 2*lm] = rec[1 + count + i];
         }
       }
+      std::string dname = std::string(var_names[v]) + ".dat";
+      hid_t dset = H5Dopen2(grp, dname.c_str(), H5P_DEFAULT);
+      hid_t fspace = H5Dget_space(dset);
+      hsize_t dims[2];
+      H5Sget_simple_extent_dims(fspace, dims, nullptr);
+      H5Sclose(fspace);
+      hsize_t start[2] = {dims[0], 0}, cnt[2] = {static_cast<hsize_t>(nwbuf), ncol};
+      dims[0] += nwbuf;
+      H5Dset_extent(dset, dims);
+      fspace = H5Dget_space(dset);
+      H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, nullptr, cnt, nullptr);
+      hid_t mspace = H5Screate_simple(2, cnt, nullptr);
+      H5Dwrite(dset, H5T_NATIVE_DOUBLE, mspace, fspace, H5P_DEFAULT, rows.data());
+      H5Sclose(mspace);
+      H5Sclose(fspace);
+      H5Dclose(dset);
     }
+    H5Gclose(grp);
   }
+  H5Fclose(file);
+#else
+  FILE* cce_file = std::fopen(filename.c_str(), (file_created)? "ab" : "wb");
+  if (cce_file == nullptr) {
+    std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "CCE output file '" << filename << "' could not be opened, "
+              << nwbuf << " extractions are lost" << std::endl;
+    return;
+  }
+  if (!(file_created)) {
+    // write number of radius and angular modes for reshaping data, and inner and outer
+    // radial boundary
+    std::fwrite(&nr, sizeof(int), 1, cce_file);
+    std::fwrite(&num_l_modes, sizeof(int), 1, cce_file);
+    std::fwrite(&rin, sizeof(Real), 1, cce_file);
+    std::fwrite(&rout, sizeof(Real), 1, cce_file);
+  }
+  std::size_t nwrite = nwbuf*nrec;
+  if (std::fwrite(wbuf.data(), sizeof(Real), nwrite, cce_file) != nwrite) {
+    perror("Error writing to file");
+  }
+  std::fclose(cce_file);
+#endif
+  file_created = true;
+}
 
-  // Reduction to the master rank for cnlm_real and cnlm_imag
+// Interpolate all fields to Gauss-Legendre Sphere
+void CCE::InterpolateAndDecompose(MeshBlockPack *pmbp) {
+  // raveled shape of array & counts for mpi
+  int nvar = static_cast<int>(variable_to_dump.size());
+  int count = nvar*nr*num_angular_modes;
+
+  // Interpolate all variables on all spheres with one batch of the interpolation service
+  std::vector<int> z4c_vars, adm_vars;
+  for (auto &var : variable_to_dump) {
+    if (var.second) {
+      z4c_vars.push_back(var.first);
+    } else {
+      adm_vars.push_back(var.first);
+    }
+  }
+  auto *pinterp = pmbp->pinterp;
+  std::vector<int> iz4c(nr), iadm(nr);
+  for (int k = 0; k < nr; ++k) {
+    iz4c[k] = pinterp->Queue(grid_sets[k], pmbp->pz4c->u0, z4c_vars);
+    iadm[k] = pinterp->Queue(grid_sets[k], pmbp->padm->u_adm, adm_vars);
+  }
+  pinterp->Execute();
+
+  // offset of each (variable, sphere) in the interpolated values on the device
+  DualArray2D<int> offset("cce_offset", nvar, nr);
+  int nz4c = 0, nadm = 0;
+  for (int v = 0; v < nvar; ++v) {
+    int iv = (variable_to_dump[v].second) ? nz4c++ : nadm++;
+    for (int k = 0; k < nr; ++k) {
+      int r = (variable_to_dump[v].second) ? iz4c[k] : iadm[k];
+      offset.h_view(v,k) = pinterp->Offset(r) + iv*grids[k]->nangles;
+    }
+  }
+  offset.template modify<HostMemSpace>();
+  offset.template sync<DevExeSpace>();
+
+  // Spherical harmonic transform of all variables on all spheres.  First a DFT along
+  // each ring of constant theta for 0 <= m <= lmax...
+  int nth = grids[0]->ntheta;
+  int nph = grids[0]->nangles/nth;
+  int nam = num_angular_modes;
+  auto vals = pinterp->DeviceValues();
+  auto &pcos = phi_cos;
+  auto &psin = phi_sin;
+  auto &fmr = fm_real;
+  auto &fmi = fm_imag;
+  par_for("cce_dft", DevExeSpace(), 0, nvar-1, 0, nr-1, 0, num_l_modes, 0, nth-1,
+  KOKKOS_LAMBDA(const int v, const int k, const int m, const int it) {
+    int n0 = offset.d_view(v,k) + it;
+    Real sum_re = 0.0, sum_im = 0.0;
+    for (int ip = 0; ip < nph; ++ip) {
+      Real data = vals(n0 + ip*nth);
+      sum_re += data*pcos(m,ip);
+      sum_im += data*psin(m,ip);
+    }
+    fmr(v,k,m,it) = sum_re;
+    fmi(v,k,m,it) = sum_im;
+  });
+
+  // ...then Gauss-Legendre quadrature in theta for every (l,m), using
+  // cos(-m phi) = cos(m phi) and sin(-m phi) = -sin(m phi)
+  auto &leg = leg_wghts;
+  auto &coeffs_ = coeffs;
+  par_for("cce_legendre", DevExeSpace(), 0, nvar-1, 0, nr-1, 0, nam-1,
+  KOKKOS_LAMBDA(const int v, const int k, const int lm) {
+    int l = static_cast<int>(sqrt(static_cast<Real>(lm)));
+    while (l*l > lm) {l--;}
+    while ((l+1)*(l+1) <= lm) {l++;}
+    int m = lm - l*l - l;
+    int am = ABS(m);
+    Real sum_re = 0.0, sum_im = 0.0;
+    for (int it = 0; it < nth; ++it) {
+      sum_re += leg(lm,it)*fmr(v,k,am,it);
+      sum_im += leg(lm,it)*fmi(v,k,am,it);
+    }
+    int n = k * nvar * nam  // first over the different radii
+          + v * nam         // then over the variables
+          + lm;             // lastly over the angular harmonic index
+    coeffs_.d_view(n) = sum_re;
+    coeffs_.d_view(count + n) = (m < 0) ? -sum_im : sum_im;
+  });
+  coeffs.template modify<DevExeSpace>();
+  coeffs.template sync<HostMemSpace>();
+  Real* data = coeffs.h_view.data();
+
+  // Reduction to the master rank of cnlm_real and cnlm_imag, which are contiguous
   #if MPI_PARALLEL_ENABLED
   if (0 == global_variable::my_rank) {
-    MPI_Reduce(MPI_IN_PLACE, data_real, count, MPI_ATHENA_REAL,
-              MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(MPI_IN_PLACE, data_imag, count, MPI_ATHENA_REAL,
-              MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(MPI_IN_PLACE, data, 2*count, MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
   } else {
-    MPI_Reduce(data_real, data_real, count, MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(data_imag, data_imag, count, MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(data, nullptr, 2*count, MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
   }
   #endif
 
-  // Then write output file
-  // Open the file in binary write mode
-
+  // Then add a record to the output buffer, which is written once full
   if (0 == global_variable::my_rank) {
-    std::string filename = "cce/cce_";
-    std::stringstream strObj;
-    strObj << std::setfill('0') << std::setw(8) << pmbp->pmesh->time;
-    filename += strObj.str();
-    filename += ".bin";
-
-    FILE* cce_file = fopen(filename.c_str(), "wb");
-    if (cce_file == nullptr) {
-      perror("Error opening file");
-      return;
-    }
-    // write number of radius and angular modes for reshaping data
-    fwrite(&nr, sizeof(int), 1, cce_file);
-    fwrite(&num_l_modes, sizeof(int), 1, cce_file);
-    // write time
-    fwrite(&pmbp->pmesh->time, sizeof(Real), 1, cce_file);
-    // write inner and outer radial boundary
-    fwrite(&rin, sizeof(Real), 1, cce_file);
-    fwrite(&rout, sizeof(Real), 1, cce_file);
-    // Write the 4D array to the binary file
-    size_t elementsWritten = fwrite(data_real, sizeof(Real), count, cce_file);
-    if (elementsWritten != count) {
-      perror("Error writing to file");
-    }
-    elementsWritten = fwrite(data_imag, sizeof(Real), count, cce_file);
-    if (elementsWritten != count) {
-      perror("Error writing to file");
+    Real *rec = &buf[nbuf*(1 + 2*static_cast<std::size_t>(count))];
+    rec[0] = pmbp->pmesh->time;
+    std::copy(data, data + 2*count, rec + 1);
+    if (++nbuf == buffer_steps) {
+      Flush();
     }
-    // Close the file
-    fclose(cce_file);
   }
-  delete[] data_real;
-  delete[] data_imag;
 }
 } // end namespace z4c
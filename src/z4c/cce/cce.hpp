@@ -8,6 +8,7 @@
 #define Z4C_CCE_CCE_HPP_
 
 #include <string>
+#include <thread>
 #include <vector>
 #include <utility>
 #include <memory>
@@ -53,6 +54,27 @@ class CCE {
 
   // sphere for storing the indices, etc.
   std::vector<std::unique_ptr<GaussLegendreGrid>> grids;
+  // sets of points of each sphere in the pack's InterpolationService
+  std::vector<int> grid_sets;
+
+  // spherical harmonic transform, identical on all spheres: DFT in phi followed by
+  // quadrature in theta of normalized associated Legendre functions
+  DvceArray2D<Real> leg_wghts;          // weight*Y_lm(theta,0) indexed (l*l+l+m, theta)
+  DvceArray2D<Real> phi_cos, phi_sin;   // cos(m*phi), sin(m*phi) indexed (m, phi)
+  DvceArray4D<Real> fm_real, fm_imag;   // phi transforms indexed (var, radius, m, theta)
+  DualArray1D<Real> coeffs;             // real then imaginary coefficients of all radii
+
+  // Output is buffered on rank 0: each record holds the time followed by coeffs, and
+  // every buffer_steps records are appended to the file by a background thread.
+  std::string filename;        // single output file of this set of spheres
+  int buffer_steps;            // number of records buffered before each write
+  int nbuf, nwbuf;             // number of records in buf and in wbuf
+  bool file_created;           // file (and its header or datasets) created
+  std::vector<Real> buf;       // records being filled
+  std::vector<Real> wbuf;      // records being written by writer
+  std::thread writer;
+  void Flush();
+  void WriteBuffer();
 
  public:
   CCE(Mesh *const pm, ParameterInput *const pin, int index);
@@ -11,6 +11,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -32,7 +33,7 @@
 //----------------------------------------------------------------------------------------
 CompactObjectTracker::CompactObjectTracker(Mesh *pmesh, ParameterInput *pin, int n):
               owns_compact_object{false}, pos{NAN, NAN, NAN}, vel{NAN, NAN, NAN},
-              pmesh{pmesh}, out_every{1} {
+              vbuf{0.0, 0.0, 0.0, 0.0}, vpending{false}, pmesh{pmesh}, out_every{1} {
   std::string nstr = std::to_string(n);
   std::string ofname = pin->GetString("job", "basename") + ".";
   ofname += pin->GetOrAddString("z4c", "filename", "co_");
@@ -76,37 +77,43 @@ CompactObjectTracker::CompactObjectTracker(Mesh *pmesh, ParameterInput *pin, int
 }
 
 //----------------------------------------------------------------------------------------
-CompactObjectTracker::~CompactObjectTracker() { }
+CompactObjectTracker::~CompactObjectTracker() = default;
 
 //----------------------------------------------------------------------------------------
 void CompactObjectTracker::InterpolateVelocity(MeshBlockPack *pmbp) {
   auto &padm = pmbp->padm;
   auto &pmhd = pmbp->pmhd;
   auto &pz4c = pmbp->pz4c;
-  auto *S    = new LagrangeInterpolator(pmbp, pos);
+  if (pinterp == nullptr) {
+    pinterp = std::make_unique<LagrangeInterpolator>(pmbp, 1);
+  }
+  pinterp->SetPoint(0, pos);
 
-  if (S->point_exist) {
+  if (pinterp->PointExists()) {
     owns_compact_object = true;
 
-    Real betax = S->Interpolate(pz4c->u0, pz4c->I_Z4C_BETAX);
-    Real betay = S->Interpolate(pz4c->u0, pz4c->I_Z4C_BETAY);
-    Real betaz = S->Interpolate(pz4c->u0, pz4c->I_Z4C_BETAZ);
-    vel[0] = - betax;
-    vel[1] = - betay;
-    vel[2] = - betaz;
+    pinterp->Interpolate(pz4c->u0, {pz4c->I_Z4C_BETAX, pz4c->I_Z4C_BETAY,
+                                    pz4c->I_Z4C_BETAZ, pz4c->I_Z4C_ALPHA});
+    vel[0] = - pinterp->Value(0);
+    vel[1] = - pinterp->Value(1);
+    vel[2] = - pinterp->Value(2);
     if (type == NeutronStar) {
-      Real alp = S->Interpolate(pz4c->u0, pz4c->I_Z4C_ALPHA);
-
-      Real zx = S->Interpolate(pmhd->w0, IVX);
-      Real zy = S->Interpolate(pmhd->w0, IVY);
-      Real zz = S->Interpolate(pmhd->w0, IVZ);
-
-      Real gxx = S->Interpolate(padm->u_adm, padm->I_ADM_GXX);
-      Real gxy = S->Interpolate(padm->u_adm, padm->I_ADM_GXY);
-      Real gxz = S->Interpolate(padm->u_adm, padm->I_ADM_GXZ);
-      Real gyy = S->Interpolate(padm->u_adm, padm->I_ADM_GYY);
-      Real gyz = S->Interpolate(padm->u_adm, padm->I_ADM_GYZ);
-      Real gzz = S->Interpolate(padm->u_adm, padm->I_ADM_GZZ);
+      Real alp = pinterp->Value(3);
+
+      pinterp->Interpolate(pmhd->w0, {IVX, IVY, IVZ});
+      Real zx = pinterp->Value(0);
+      Real zy = pinterp->Value(1);
+      Real zz = pinterp->Value(2);
+
+      pinterp->Interpolate(padm->u_adm, {padm->I_ADM_GXX, padm->I_ADM_GXY,
+                                         padm->I_ADM_GXZ, padm->I_ADM_GYY,
+                                         padm->I_ADM_GYZ, padm->I_ADM_GZZ});
+      Real gxx = pinterp->Value(0);
+      Real gxy = pinterp->Value(1);
+      Real gxz = pinterp->Value(2);
+      Real gyy = pinterp->Value(3);
+      Real gyz = pinterp->Value(4);
+      Real gzz = pinterp->Value(5);
 
       Real z_x = gxx*zx + gxy*zy + gxz*zz;
       Real z_y = gxy*zx + gyy*zy + gyz*zz;
@@ -121,49 +128,39 @@ void CompactObjectTracker::InterpolateVelocity(MeshBlockPack *pmbp) {
     owns_compact_object = false;
   }
 
-  delete S;
+  // Only the owning rank contributes to the sum, so every rank receives its velocity.
+  // The position is then advanced identically on all ranks, so only the velocity and the
+  // number of owners are communicated.  With MPI the reduction is non-blocking and is
+  // completed in EvolveTracker(), overlapping it with the tasks in between.
+  for (int a = 0; a < NDIM; ++a) {
+    vbuf[a] = (owns_compact_object)? vel[a] : 0.0;
+  }
+  vbuf[NDIM] = (owns_compact_object)? 1.0 : 0.0;
+#if MPI_PARALLEL_ENABLED
+  MPI_Iallreduce(MPI_IN_PLACE, vbuf, NDIM + 1, MPI_ATHENA_REAL, MPI_SUM,
+                 MPI_COMM_WORLD, &vreq);
+  vpending = true;
+#endif
 }
 
 //----------------------------------------------------------------------------------------
 void CompactObjectTracker::EvolveTracker() {
-  if (owns_compact_object) {
-    for (int a = 0; a < NDIM; ++a) {
-      pos[a] += pmesh->dt * vel[a];
-    }
-#if !(MPI_PARALLEL_ENABLED)
-  } else {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl;
-    std::cout << "couldn't find the compact object!" << std::endl;
-    std::exit(EXIT_FAILURE);
-  }
-#else
-  }
-  Real buf[2 * NDIM + 1] = {0., 0., 0., 0., 0., 0., 0.};
-  if (owns_compact_object) {
-    buf[0] = pos[0];
-    buf[1] = pos[1];
-    buf[2] = pos[2];
-    buf[3] = vel[0];
-    buf[4] = vel[1];
-    buf[5] = vel[2];
-    buf[6] = 1.0;
+#if MPI_PARALLEL_ENABLED
+  if (vpending) {
+    MPI_Wait(&vreq, MPI_STATUS_IGNORE);
+    vpending = false;
   }
-  MPI_Allreduce(
-    MPI_IN_PLACE, buf, 2 * NDIM + 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
-  if (buf[6] < 0.5) {
+#endif
+  if (vbuf[NDIM] < 0.5) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
               << std::endl;
     std::cout << "The compact object has left the grid" << std::endl;
     std::exit(EXIT_FAILURE);
   }
-  pos[0] = buf[0] / buf[6];
-  pos[1] = buf[1] / buf[6];
-  pos[2] = buf[2] / buf[6];
-  vel[0] = buf[3] / buf[6];
-  vel[1] = buf[4] / buf[6];
-  vel[2] = buf[5] / buf[6];
-#endif // MPI_PARALLEL_ENABLED
+  for (int a = 0; a < NDIM; ++a) {
+    vel[a] = vbuf[a] / vbuf[NDIM];
+    pos[a] += pmesh->dt * vel[a];
+  }
 
   // After the compact object has moved it might have changed ownership
   owns_compact_object = false;
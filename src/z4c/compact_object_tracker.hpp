@@ -9,6 +9,7 @@
 
 #include <cstdio>
 #include <fstream>
+#include <memory>
 #include <string>
 
 #include "athena.hpp"
@@ -16,6 +17,7 @@
 #include "z4c_macros.hpp"
 
 // Forward declaration
+class LagrangeInterpolator;
 class Mesh;
 class ParameterInput;
 
@@ -29,9 +31,10 @@ class CompactObjectTracker {
   CompactObjectTracker(Mesh *pmesh, ParameterInput *pin, int n);
   //! Destructor (will close output file)
   ~CompactObjectTracker();
-  //! Interpolate the shift vector to the puncture position
+  //! Interpolate the shift vector to the puncture position on the owning rank, and
+  //! start sending the velocity to all ranks
   void InterpolateVelocity(MeshBlockPack *pmbp);
-  //! Update and broadcast the puncture position
+  //! Receive the velocity and update the puncture position
   void EvolveTracker();
   //! Write data to file
   void WriteTracker();
@@ -60,12 +63,18 @@ class CompactObjectTracker {
   bool owns_compact_object;
   CompactObjectType type;
   Real vel[NDIM];
+  Real vbuf[NDIM+1];    // velocity on owning rank (zero elsewhere), and number of owners
+  bool vpending;        // non-blocking reduction of vbuf started but not completed
+#if MPI_PARALLEL_ENABLED
+  MPI_Request vreq;
+#endif
   int reflevel;         // requested minimum refinement level (-1 for infinity)
   Real radius;          // nominal radius of the object (for the AMR driver)
   Mesh const *pmesh;
   int out_every;
   std::ofstream ofile;
   Real pos[NDIM];
+  std::unique_ptr<LagrangeInterpolator> pinterp;  // weights reused until pos moves
 };
 
 #endif // Z4C_COMPACT_OBJECT_TRACKER_HPP_
@@ -16,6 +16,7 @@
 #include <string>
 #include <cstdio>
 #include <utility>
+#include <vector>
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
@@ -27,6 +28,7 @@
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
 #include "utils/cart_grid.hpp"
+#include "utils/interp_service.hpp"
 #include "coordinates/adm.hpp"
 #include "mhd/mhd.hpp"
 #include "z4c/z4c.hpp"
@@ -96,34 +98,31 @@ void HorizonDump::SetGridAndInterpolate(Real center[NDIM]) {
   // Dynamically allocate memory for the 4D array flattened into 1D
   Real* data_out = new Real[count];
 
-  for(int nvar=0; nvar<16; nvar++) {
-    // Interpolate here
-    if (variable_to_dump[nvar].second) {
-      pcat_grid->InterpolateToGrid(variable_to_dump[nvar].first,pmbp->pz4c->u0);
+  // Interpolate all variables with one batch of the interpolation service, and sum the
+  // values over ranks to the master rank
+  std::vector<int> z4c_vars, adm_vars;
+  for (auto &var : variable_to_dump) {
+    if (var.second) {
+      z4c_vars.push_back(var.first);
     } else {
-      pcat_grid->InterpolateToGrid(variable_to_dump[nvar].first,pmbp->padm->u_adm);
-    }
-    for (int nx = 0; nx < horizon_nx; nx ++)
-    for (int ny = 0; ny < horizon_nx; ny ++)
-    for (int nz = 0; nz < horizon_nx; nz ++) {
-      data_out[nvar * horizon_nx * horizon_nx * horizon_nx +  // Section for nvar
-        nx * horizon_nx * horizon_nx +                 // Slice for nx
-        ny * horizon_nx +                              // Row for ny
-        nz]                                            // Column for nz
-        = pcat_grid->interp_vals.h_view(nx, ny, nz);        // Value being assigned
+      adm_vars.push_back(var.first);
     }
   }
+  auto *pinterp = pmbp->pinterp;
+  int iz4c = pinterp->Queue(pcat_grid->point_set, pmbp->pz4c->u0, z4c_vars);
+  int iadm = pinterp->Queue(pcat_grid->point_set, pmbp->padm->u_adm, adm_vars);
+  pinterp->Execute();
+  pinterp->Reduce(false);
 
-  // MPI reduce here
-  // Reduction to the master rank for data_out
-  #if MPI_PARALLEL_ENABLED
-  if (0 == global_variable::my_rank) {
-    MPI_Reduce(MPI_IN_PLACE, data_out, count,
-              MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
-  } else {
-    MPI_Reduce(data_out, data_out, count, MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+  int npts = horizon_nx * horizon_nx * horizon_nx;
+  int nz4c = 0, nadm = 0;
+  for (int nvar=0; nvar<16; nvar++) {
+    int r = (variable_to_dump[nvar].second) ? iz4c : iadm;
+    int iv = (variable_to_dump[nvar].second) ? nz4c++ : nadm++;
+    for (int n = 0; n < npts; n++) {
+      data_out[nvar * npts + n] = pinterp->Value(r, iv, n);
+    }
   }
-  #endif
   // Then write output file
   // Open the file in binary write mode
   std::string foldername = "horizon_"+std::to_string(horizon_ind)
@@ -0,0 +1,579 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file horizon_finder.cpp
+//! \brief in-situ apparent horizon finder.  Every iteration interpolates the ADM metric,
+//! its first derivatives (by differentiating the Lagrange interpolant) and the extrinsic
+//! curvature to the trial surface on the device, reduces them over all ranks, computes
+//! the expansion Theta on the host and updates the spectral coefficients of the surface
+//! with the fast flow  a_lm -= A/(1 + B l(l+1)) (rho Theta)_lm,  where
+//! A = alpha/(lmax(lmax+1)) + beta and B = beta/alpha.
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+#include "horizon_finder.hpp"
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/adm.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "geodesic-grid/gauss_legendre.hpp"
+
+namespace {
+// values interpolated to each surface point: g_dd (0-5), K_dd (6-11), d_c g_dd
+// (12+3*n+c), and the number of MeshBlocks that own the point
+constexpr int kNVal = 31;
+constexpr int kOwn = 30;
+// index of the symmetric pair (a,b) in g_dd and K_dd
+constexpr int kSym[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+
+//----------------------------------------------------------------------------------------
+//! \fn void RealYlm()
+//! \brief real spherical harmonics Y_lm (stored at lm = l*l+l+m, with cos(m phi) for m>0
+//! and sin(|m| phi) for m<0) and their derivatives d_th, d_ph, d_th d_th, d_th d_ph and
+//! d_ph d_ph at (th,ph), stored in y[6*lm+0..5]
+
+void RealYlm(const int lmax, const Real th, const Real ph, Real *y) {
+  Real x = std::cos(th), s = std::sin(th);
+  int np = lmax + 1;
+  // associated Legendre functions P_l^m(x) without Condon-Shortley phase
+  std::vector<Real> p(np*np, 0.0);
+  Real pmm = 1.0;
+  for (int m=0; m<=lmax; ++m) {
+    if (m > 0) pmm *= (2*m - 1)*s;
+    p[m*np + m] = pmm;
+    if (m < lmax) p[(m + 1)*np + m] = x*(2*m + 1)*pmm;
+    for (int l=m+2; l<=lmax; ++l) {
+      p[l*np + m] = ((2*l - 1)*x*p[(l - 1)*np + m] - (l + m - 1)*p[(l - 2)*np + m])
+                    /(l - m);
+    }
+  }
+  for (int l=0; l<=lmax; ++l) {
+    for (int m=-l; m<=l; ++m) {
+      int am = std::abs(m);
+      Real norm = (2*l + 1)/(4.0*M_PI);
+      for (int k=l-am+1; k<=l+am; ++k) norm /= k;
+      norm = std::sqrt((am > 0)? 2.0*norm : norm);
+      Real plm = p[l*np + am];
+      Real plm1 = (l - 1 >= am)? p[(l - 1)*np + am] : 0.0;
+      // (1-x^2) dP/dx = (l+m) P_{l-1} - l x P_l, and the Legendre equation
+      Real dp = -((l + am)*plm1 - l*x*plm)/s;
+      Real ddp = -(x/s)*dp - (l*(l + 1) - am*am/(s*s))*plm;
+      Real f = (m >= 0)? std::cos(am*ph) : std::sin(am*ph);
+      Real df = (m >= 0)? -am*std::sin(am*ph) : am*std::cos(am*ph);
+      Real ddf = -am*am*f;
+      Real *yy = &y[6*(l*l + l + m)];
+      yy[0] = norm*plm*f;
+      yy[1] = norm*dp*f;
+      yy[2] = norm*plm*df;
+      yy[3] = norm*ddp*f;
+      yy[4] = norm*dp*df;
+      yy[5] = norm*plm*ddf;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Metric()
+//! \brief unpack g_dd and K_dd from the interpolated values v and invert g_dd
+
+void Metric(const Real *v, Real g[3][3], Real kk[3][3], Real gu[3][3]) {
+  for (int a=0; a<3; ++a) {
+    for (int b=0; b<3; ++b) {
+      g[a][b] = v[kSym[a][b]];
+      kk[a][b] = v[6 + kSym[a][b]];
+    }
+  }
+  Real det = g[0][0]*(g[1][1]*g[2][2] - g[1][2]*g[2][1])
+           - g[0][1]*(g[1][0]*g[2][2] - g[1][2]*g[2][0])
+           + g[0][2]*(g[1][0]*g[2][1] - g[1][1]*g[2][0]);
+  gu[0][0] = (g[1][1]*g[2][2] - g[1][2]*g[2][1])/det;
+  gu[0][1] = (g[0][2]*g[2][1] - g[0][1]*g[2][2])/det;
+  gu[0][2] = (g[0][1]*g[1][2] - g[0][2]*g[1][1])/det;
+  gu[1][1] = (g[0][0]*g[2][2] - g[0][2]*g[2][0])/det;
+  gu[1][2] = (g[0][2]*g[1][0] - g[0][0]*g[1][2])/det;
+  gu[2][2] = (g[0][0]*g[1][1] - g[0][1]*g[1][0])/det;
+  gu[1][0] = gu[0][1]; gu[2][0] = gu[0][2]; gu[2][1] = gu[1][2];
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real Expansion()
+//! \brief expansion Theta = D_i s^i + K_ij s^i s^j - K of the surface F = r - h = 0 at
+//! angles (th,ph), where hh = (h, h_th, h_ph, h_thth, h_thph, h_phph) and v holds the
+//! interpolated values.  Also returns the unit normal s^i and the area element per
+//! unit solid angle.
+
+Real Expansion(const Real *v, const Real *hh, const Real th, const Real ph,
+               Real s_u[3], Real *da) {
+  Real ct = std::cos(th), st = std::sin(th), cp = std::cos(ph), sp = std::sin(ph);
+  Real r = hh[0];
+  // Jacobian d(r,th,ph)/dx^i and Hessians d^2 x^k/(du^b du^c) of spherical coordinates
+  const Real jac[3][3] = {{st*cp, st*sp, ct},
+                          {ct*cp/r, ct*sp/r, -st/r},
+                          {-sp/(r*st), cp/(r*st), 0.0}};
+  const Real hes[3][3][3] = {{{0.0, ct*cp, -st*sp},
+                              {ct*cp, -r*st*cp, -r*ct*sp},
+                              {-st*sp, -r*ct*sp, -r*st*cp}},
+                             {{0.0, ct*sp, st*cp},
+                              {ct*sp, -r*st*sp, r*ct*cp},
+                              {st*cp, r*ct*cp, -r*st*sp}},
+                             {{0.0, -st, 0.0},
+                              {-st, -r*ct, 0.0},
+                              {0.0, 0.0, 0.0}}};
+  // derivatives of F with respect to (r,th,ph)
+  const Real df_u[3] = {1.0, -hh[1], -hh[2]};
+  const Real ddf_u[3][3] = {{0.0, 0.0, 0.0},
+                            {0.0, -hh[3], -hh[4]},
+                            {0.0, -hh[4], -hh[5]}};
+
+  // Cartesian derivatives of F, using d_i d_j u^a = -J^a_k H^k_bc J^b_i J^c_j
+  Real df[3], ddf[3][3], gbc[3][3];
+  for (int i=0; i<3; ++i) {
+    df[i] = 0.0;
+    for (int a=0; a<3; ++a) df[i] += df_u[a]*jac[a][i];
+  }
+  for (int b=0; b<3; ++b) {
+    for (int c=0; c<3; ++c) {
+      gbc[b][c] = ddf_u[b][c];
+      for (int k=0; k<3; ++k) gbc[b][c] -= df[k]*hes[k][b][c];
+    }
+  }
+  for (int i=0; i<3; ++i) {
+    for (int j=0; j<3; ++j) {
+      ddf[i][j] = 0.0;
+      for (int b=0; b<3; ++b) {
+        for (int c=0; c<3; ++c) ddf[i][j] += gbc[b][c]*jac[b][i]*jac[c][j];
+      }
+    }
+  }
+
+  // metric, its inverse and Christoffel symbols
+  Real g[3][3], kk[3][3], gu[3][3], dg[3][3][3];
+  Metric(v, g, kk, gu);
+  for (int a=0; a<3; ++a) {
+    for (int b=0; b<3; ++b) {
+      for (int c=0; c<3; ++c) dg[c][a][b] = v[12 + 3*kSym[a][b] + c];
+    }
+  }
+  Real gam[3][3][3];
+  for (int k=0; k<3; ++k) {
+    for (int i=0; i<3; ++i) {
+      for (int j=0; j<3; ++j) {
+        gam[k][i][j] = 0.0;
+        for (int l=0; l<3; ++l) {
+          gam[k][i][j] += 0.5*gu[k][l]*(dg[i][l][j] + dg[j][l][i] - dg[l][i][j]);
+        }
+      }
+    }
+  }
+
+  // unit normal and expansion
+  Real nrm = 0.0;
+  for (int i=0; i<3; ++i) {
+    for (int j=0; j<3; ++j) nrm += gu[i][j]*df[i]*df[j];
+  }
+  nrm = std::sqrt(nrm);
+  for (int i=0; i<3; ++i) {
+    s_u[i] = 0.0;
+    for (int j=0; j<3; ++j) s_u[i] += gu[i][j]*df[j]/nrm;
+  }
+  Real theta = 0.0;
+  for (int i=0; i<3; ++i) {
+    for (int j=0; j<3; ++j) {
+      Real dd = ddf[i][j];
+      for (int k=0; k<3; ++k) dd -= gam[k][i][j]*df[k];
+      theta += (gu[i][j] - s_u[i]*s_u[j])*dd/nrm + kk[i][j]*(s_u[i]*s_u[j] - gu[i][j]);
+    }
+  }
+
+  // induced metric from the tangent vectors e_th and e_ph of the surface
+  const Real nhat[3] = {st*cp, st*sp, ct};
+  const Real dnth[3] = {ct*cp, ct*sp, -st};
+  const Real dnph[3] = {-st*sp, st*cp, 0.0};
+  Real eth[3], eph[3];
+  for (int i=0; i<3; ++i) {
+    eth[i] = hh[1]*nhat[i] + r*dnth[i];
+    eph[i] = hh[2]*nhat[i] + r*dnph[i];
+  }
+  Real qtt = 0.0, qtp = 0.0, qpp = 0.0;
+  for (int i=0; i<3; ++i) {
+    for (int j=0; j<3; ++j) {
+      qtt += g[i][j]*eth[i]*eth[j];
+      qtp += g[i][j]*eth[i]*eph[j];
+      qpp += g[i][j]*eph[i]*eph[j];
+    }
+  }
+  *da = std::sqrt(qtt*qpp - qtp*qtp)/st;
+  return theta;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+HorizonFinder::HorizonFinder(MeshBlockPack *pmbp, ParameterInput *pin, int n):
+              horizon_ind{n}, pos{NAN, NAN, NAN}, found{false}, area{0.0},
+              mass_irr{0.0}, mass{0.0}, spin{0.0, 0.0, 0.0}, rmin{0.0}, rmax{0.0},
+              rmean{0.0}, pmbp{pmbp}, max_theta{0.0},
+              interp_indcs("ahf_indcs",1,1),
+              interp_wghts("ahf_wghts",1,1,1),
+              interp_dwghts("ahf_dwghts",1,1,1),
+              interp_vals("ahf_vals",1,1) {
+  std::string nstr = std::to_string(n);
+  pos[0] = pin->GetOrAddReal("z4c", "co_" + nstr + "_x", 0.0);
+  pos[1] = pin->GetOrAddReal("z4c", "co_" + nstr + "_y", 0.0);
+  pos[2] = pin->GetOrAddReal("z4c", "co_" + nstr + "_z", 0.0);
+  r_guess = pin->GetOrAddReal("z4c", "ahf_" + nstr + "_r_guess", 1.0);
+  ahf_dt = pin->GetOrAddReal("z4c", "ahf_dt", 1.0);
+  int ntheta = pin->GetOrAddInteger("z4c", "ahf_ntheta", 24);
+  lmax = pin->GetOrAddInteger("z4c", "ahf_lmax", 8);
+  maxit = pin->GetOrAddInteger("z4c", "ahf_maxit", 500);
+  tol = pin->GetOrAddReal("z4c", "ahf_tol", 1.0e-8);
+  flow_alpha = pin->GetOrAddReal("z4c", "ahf_flow_alpha", 1.0);
+  flow_beta = pin->GetOrAddReal("z4c", "ahf_flow_beta", 0.5);
+  ahf_last_output_time = -ahf_dt;
+  if (lmax < 1 || 2*lmax >= ntheta) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<z4c>/ahf_lmax must be >= 1 and < ahf_ntheta/2"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  nmodes = (lmax + 1)*(lmax + 1);
+
+  // initial guess is a coordinate sphere
+  a_lm.assign(nmodes, 0.0);
+  a_lm[0] = r_guess*std::sqrt(4.0*M_PI);
+
+  pgl = new GaussLegendreGrid(pmbp, ntheta, r_guess);
+  int npts = pgl->nangles;
+  int &ng = pmbp->pmesh->mb_indcs.ng;
+  Kokkos::realloc(interp_indcs, npts, 4);
+  Kokkos::realloc(interp_wghts, npts, 2*ng, 3);
+  Kokkos::realloc(interp_dwghts, npts, 2*ng, 3);
+  Kokkos::realloc(interp_vals, npts, kNVal);
+  hsurf.resize(6*npts);
+  SetYlm();
+
+  if (0 == global_variable::my_rank) {
+    std::string fname = pin->GetString("job", "basename") + ".ahf_" + nstr;
+    ofile.open((fname + ".txt").c_str());
+    ofile << "# 1:iter 2:time 3:found 4:nflow 5:max|r*Theta| 6:area 7:M_irr 8:M "
+          << "9:Jx 10:Jy 11:Jz 12:rmean 13:rmin 14:rmax 15:x 16:y 17:z\n";
+    ofile << std::flush;
+    ofile << std::setprecision(15);
+    sfile.open((fname + "_shape.txt").c_str());
+    sfile << "# 1:time 2:x 3:y 4:z, then a_lm of r = sum a_lm Y_lm for l=0.." << lmax
+          << ", m=-l..l (real Y_lm: cos(m phi) for m>0, sin(|m| phi) for m<0)\n";
+    sfile << std::flush;
+    sfile << std::setprecision(15);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+HorizonFinder::~HorizonFinder() {
+  delete pgl;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::SetYlm
+//! \brief tabulate the real Y_lm and their derivatives at the (fixed) angles of the grid
+
+void HorizonFinder::SetYlm() {
+  int npts = pgl->nangles;
+  ylm.resize(static_cast<size_t>(6)*nmodes*npts);
+  for (int n=0; n<npts; ++n) {
+    RealYlm(lmax, pgl->polar_pos.h_view(n,0), pgl->polar_pos.h_view(n,1),
+            &ylm[static_cast<size_t>(6)*nmodes*n]);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::SetSurface
+//! \brief evaluate h and its angular derivatives at every point from a_lm
+
+void HorizonFinder::SetSurface() {
+  int npts = pgl->nangles;
+  for (int n=0; n<npts; ++n) {
+    Real *hh = &hsurf[6*n];
+    const Real *y = &ylm[static_cast<size_t>(6)*nmodes*n];
+    for (int k=0; k<6; ++k) hh[k] = 0.0;
+    for (int lm=0; lm<nmodes; ++lm) {
+      for (int k=0; k<6; ++k) hh[k] += a_lm[lm]*y[6*lm + k];
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool HorizonFinder::Interpolate
+//! \brief interpolate g_dd, K_dd and d_k g_dd to the current surface.  Each point is
+//! owned by the MeshBlock whose half-open extent contains it, and the values are summed
+//! over ranks.  Returns false if some point is not on the grid.
+
+bool HorizonFinder::Interpolate() {
+  auto &indcs = pmbp->pmesh->mb_indcs;
+  auto &size = pmbp->pmb->mb_size;
+  int &is = indcs.is; int &js = indcs.js; int &ks = indcs.ks;
+  int &ng = indcs.ng;
+  int nmb = pmbp->nmb_thispack;
+  int npts = pgl->nangles;
+
+  SetSurface();
+  for (int n=0; n<npts; ++n) {
+    if (!(hsurf[6*n] > 0.0)) return false;
+  }
+
+  // indices and (derivative) weights of Lagrange interpolation on host
+  auto &iindcs = interp_indcs;
+  auto &iwghts = interp_wghts;
+  auto &idwghts = interp_dwghts;
+  for (int n=0; n<npts; ++n) {
+    Real th = pgl->polar_pos.h_view(n,0);
+    Real ph = pgl->polar_pos.h_view(n,1);
+    Real x0[3] = {pos[0] + hsurf[6*n]*std::sin(th)*std::cos(ph),
+                  pos[1] + hsurf[6*n]*std::sin(th)*std::sin(ph),
+                  pos[2] + hsurf[6*n]*std::cos(th)};
+    iindcs.h_view(n,0) = -1;
+    for (int m=0; m<nmb; ++m) {
+      Real xmin[3] = {size.h_view(m).x1min, size.h_view(m).x2min, size.h_view(m).x3min};
+      Real xmax[3] = {size.h_view(m).x1max, size.h_view(m).x2max, size.h_view(m).x3max};
+      Real dx[3] = {size.h_view(m).dx1, size.h_view(m).dx2, size.h_view(m).dx3};
+      int nx[3] = {indcs.nx1, indcs.nx2, indcs.nx3};
+      if (x0[0] >= xmin[0] && x0[0] < xmax[0] && x0[1] >= xmin[1] && x0[1] < xmax[1] &&
+          x0[2] >= xmin[2] && x0[2] < xmax[2]) {
+        iindcs.h_view(n,0) = m;
+        for (int d=0; d<3; ++d) {
+          int ii = static_cast<int>(std::floor((x0[d] - (xmin[d] + dx[d]/2.0))/dx[d]));
+          iindcs.h_view(n,d+1) = ii;
+          for (int i=0; i<2*ng; ++i) {
+            Real xi = CellCenterX(ii-ng+i+1, nx[d], xmin[d], xmax[d]);
+            Real w = 1.0, dw = 0.0;
+            for (int j=0; j<2*ng; ++j) {
+              if (j == i) continue;
+              Real xj = CellCenterX(ii-ng+j+1, nx[d], xmin[d], xmax[d]);
+              w *= (x0[d] - xj)/(xi - xj);
+              Real t = 1.0/(xi - xj);
+              for (int k=0; k<2*ng; ++k) {
+                if (k == i || k == j) continue;
+                Real xk = CellCenterX(ii-ng+k+1, nx[d], xmin[d], xmax[d]);
+                t *= (x0[d] - xk)/(xi - xk);
+              }
+              dw += t;
+            }
+            iwghts.h_view(n,i,d) = w;
+            idwghts.h_view(n,i,d) = dw;
+          }
+        }
+        break;
+      }
+    }
+  }
+  interp_indcs.template modify<HostMemSpace>();
+  interp_indcs.template sync<DevExeSpace>();
+  interp_wghts.template modify<HostMemSpace>();
+  interp_wghts.template sync<DevExeSpace>();
+  interp_dwghts.template modify<HostMemSpace>();
+  interp_dwghts.template sync<DevExeSpace>();
+
+  // interpolate on device: value of each of g_dd and K_dd, and gradient of g_dd
+  auto &u_adm = pmbp->padm->u_adm;
+  int ivar0 = pmbp->padm->I_ADM_GXX, kvar0 = pmbp->padm->I_ADM_KXX;
+  auto &ivals = interp_vals;
+  par_for("ahf_interp",DevExeSpace(),0,(npts-1),0,11,
+  KOKKOS_LAMBDA(int n, int v) {
+    int ii0 = iindcs.d_view(n,0);
+    int ii1 = iindcs.d_view(n,1);
+    int ii2 = iindcs.d_view(n,2);
+    int ii3 = iindcs.d_view(n,3);
+    int nv = (v < 6)? (ivar0 + v) : (kvar0 + v - 6);
+    Real val = 0.0, dx = 0.0, dy = 0.0, dz = 0.0;
+    if (ii0 != -1) {
+      for (int i=0; i<2*ng; i++) {
+        for (int j=0; j<2*ng; j++) {
+          for (int k=0; k<2*ng; k++) {
+            Real f = u_adm(ii0,nv,ii3-(ng-k-ks)+1,ii2-(ng-j-js)+1,ii1-(ng-i-is)+1);
+            Real wx = iwghts.d_view(n,i,0);
+            Real wy = iwghts.d_view(n,j,1);
+            Real wz = iwghts.d_view(n,k,2);
+            val += wx*wy*wz*f;
+            dx += idwghts.d_view(n,i,0)*wy*wz*f;
+            dy += wx*idwghts.d_view(n,j,1)*wz*f;
+            dz += wx*wy*idwghts.d_view(n,k,2)*f;
+          }
+        }
+      }
+    }
+    ivals.d_view(n,v) = val;
+    if (v < 6) {
+      ivals.d_view(n,12+3*v) = dx;
+      ivals.d_view(n,12+3*v+1) = dy;
+      ivals.d_view(n,12+3*v+2) = dz;
+    }
+  });
+  interp_vals.template modify<DevExeSpace>();
+  interp_vals.template sync<HostMemSpace>();
+
+  for (int n=0; n<npts; ++n) {
+    interp_vals.h_view(n,kOwn) = (iindcs.h_view(n,0) != -1)? 1.0 : 0.0;
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, interp_vals.h_view.data(), npts*kNVal, MPI_ATHENA_REAL,
+                MPI_SUM, MPI_COMM_WORLD);
+#endif
+  for (int n=0; n<npts; ++n) {
+    Real nown = interp_vals.h_view(n,kOwn);
+    if (nown < 0.5) return false;
+    for (int v=0; v<kOwn; ++v) interp_vals.h_view(n,v) /= nown;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real HorizonFinder::Flow
+//! \brief one step of the fast flow with rho = h^2.  Returns the largest change of h
+//! due to any mode relative to the mean radius, or -1 if Theta is not finite.
+
+Real HorizonFinder::Flow() {
+  int npts = pgl->nangles;
+  std::vector<Real> rho_theta(npts);
+  for (int n=0; n<npts; ++n) {
+    Real v[kNVal], s_u[3], da;
+    for (int i=0; i<kNVal; ++i) v[i] = interp_vals.h_view(n,i);
+    Real theta = Expansion(v, &hsurf[6*n], pgl->polar_pos.h_view(n,0),
+                           pgl->polar_pos.h_view(n,1), s_u, &da);
+    if (!std::isfinite(theta)) return -1.0;
+    rho_theta[n] = SQR(hsurf[6*n])*theta;
+  }
+  Real aa = flow_alpha/(lmax*(lmax + 1)) + flow_beta;
+  Real bb = flow_beta/flow_alpha;
+  Real dmax = 0.0;
+  for (int l=0; l<=lmax; ++l) {
+    for (int m=-l; m<=l; ++m) {
+      int lm = l*l + l + m;
+      Real f = 0.0;
+      for (int n=0; n<npts; ++n) {
+        f += pgl->int_weights.h_view(n)*rho_theta[n]*ylm[6*(nmodes*n + lm)];
+      }
+      Real dlt = aa/(1.0 + bb*l*(l + 1))*f;
+      a_lm[lm] -= dlt;
+      dmax = std::max(dmax, std::abs(dlt));
+    }
+  }
+  return dmax*std::sqrt(4.0*M_PI)/a_lm[0];
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::Diagnostics
+//! \brief area, masses, spin and coordinate radii of the surface.  The spin is computed
+//! with the flat-space rotational vectors about the center, J_i = 1/(8 pi) \oint
+//! (K_jk - K g_jk) phi_i^j s^k dA, which is exact for axisymmetric data in adapted
+//! coordinates and a good approximation in the puncture gauge.
+
+void HorizonFinder::Diagnostics() {
+  int npts = pgl->nangles;
+  area = 0.0;
+  spin[0] = 0.0; spin[1] = 0.0; spin[2] = 0.0;
+  rmin = hsurf[0]; rmax = hsurf[0]; rmean = 0.0;
+  max_theta = 0.0;
+  for (int n=0; n<npts; ++n) {
+    Real v[kNVal], s_u[3], da;
+    for (int i=0; i<kNVal; ++i) v[i] = interp_vals.h_view(n,i);
+    Real th = pgl->polar_pos.h_view(n,0);
+    Real ph = pgl->polar_pos.h_view(n,1);
+    Real r = hsurf[6*n];
+    Real theta = Expansion(v, &hsurf[6*n], th, ph, s_u, &da);
+    Real wda = pgl->int_weights.h_view(n)*da;
+    area += wda;
+    rmin = std::min(rmin, r);
+    rmax = std::max(rmax, r);
+    rmean += pgl->int_weights.h_view(n)*r/(4.0*M_PI);
+    max_theta = std::max(max_theta, std::abs(r*theta));
+
+    Real x = r*std::sin(th)*std::cos(ph);
+    Real y = r*std::sin(th)*std::sin(ph);
+    Real z = r*std::cos(th);
+    const Real phi_u[3][3] = {{0.0, -z, y}, {z, 0.0, -x}, {-y, x, 0.0}};
+    Real g[3][3], kk[3][3], gu[3][3];
+    Metric(v, g, kk, gu);
+    Real trk = 0.0;
+    for (int a=0; a<3; ++a) {
+      for (int b=0; b<3; ++b) trk += gu[a][b]*kk[a][b];
+    }
+    for (int a=0; a<3; ++a) {
+      for (int j=0; j<3; ++j) {
+        for (int k=0; k<3; ++k) {
+          spin[a] += wda*(kk[j][k] - trk*g[j][k])*phi_u[a][j]*s_u[k]/(8.0*M_PI);
+        }
+      }
+    }
+  }
+  mass_irr = std::sqrt(area/(16.0*M_PI));
+  Real j2 = SQR(spin[0]) + SQR(spin[1]) + SQR(spin[2]);
+  mass = std::sqrt(SQR(mass_irr) + j2/(4.0*SQR(mass_irr)));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::Find
+//! \brief relax the surface about center until the fast flow converges
+
+void HorizonFinder::Find(Real center[NDIM]) {
+  // re-expand the last horizon about the new center, to first order in the shift
+  Real c1 = std::sqrt(3.0/(4.0*M_PI));
+  a_lm[3] += (pos[0] - center[0])/c1;
+  a_lm[1] += (pos[1] - center[1])/c1;
+  a_lm[2] += (pos[2] - center[2])/c1;
+  for (int a=0; a<NDIM; ++a) pos[a] = center[a];
+
+  std::vector<Real> a_last = a_lm;
+  found = false;
+  int iter = 0;
+  for (iter=0; iter<maxit; ++iter) {
+    if (!Interpolate()) break;
+    Real dh = Flow();
+    if (!(dh >= 0.0)) break;
+    if (dh < tol) {
+      found = Interpolate();
+      break;
+    }
+  }
+  if (found) {
+    Diagnostics();
+  } else {
+    // start from the last horizon found (or the initial guess) next time
+    a_lm = a_last;
+  }
+  Write(iter);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::Write
+//! \brief write diagnostics and shape of the horizon
+
+void HorizonFinder::Write(int iter) {
+  if (0 == global_variable::my_rank) {
+    ofile << pmbp->pmesh->ncycle << " " << pmbp->pmesh->time << " " << found << " "
+          << iter << " ";
+    if (found) {
+      ofile << max_theta << " " << area << " " << mass_irr << " " << mass << " "
+            << spin[0] << " " << spin[1] << " " << spin[2] << " "
+            << rmean << " " << rmin << " " << rmax << " ";
+    } else {
+      for (int i=0; i<10; ++i) ofile << NAN << " ";
+    }
+    ofile << pos[0] << " " << pos[1] << " " << pos[2] << std::endl << std::flush;
+    if (found) {
+      sfile << pmbp->pmesh->time << " " << pos[0] << " " << pos[1] << " " << pos[2];
+      for (int lm=0; lm<nmodes; ++lm) sfile << " " << a_lm[lm];
+      sfile << std::endl << std::flush;
+    }
+  }
+}
@@ -0,0 +1,76 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+
+#ifndef Z4C_HORIZON_FINDER_HPP_
+#define Z4C_HORIZON_FINDER_HPP_
+
+#include <fstream>
+#include <vector>
+
+#include "athena.hpp"
+#include "z4c_macros.hpp"
+
+// Forward declaration
+class MeshBlockPack;
+class ParameterInput;
+class GaussLegendreGrid;
+
+//! \class HorizonFinder
+//! \brief Finds an apparent horizon in-situ.  The horizon is the surface r = h(theta,phi)
+//! about a center on which the expansion of outgoing null normals vanishes.  h is
+//! expanded in real spherical harmonics up to lmax, evaluated on the points of a
+//! GaussLegendreGrid, and relaxed with the fast flow of Gundlach (gr-qc/9707050).  The
+//! area, irreducible and Christodoulou masses, spin and shape are written each call.
+class HorizonFinder {
+ public:
+  //! Initialize a finder
+  HorizonFinder(MeshBlockPack *pmbp, ParameterInput *pin, int n);
+  //! Destructor (will close output files)
+  ~HorizonFinder();
+
+  //! Find the horizon about center (used when no tracker follows the object) and write
+  //! the result.  The last horizon found is used as initial guess.
+  void Find(Real center[NDIM]);
+
+  int horizon_ind;            // index of this horizon
+  Real ahf_dt;                // time between calls
+  Real ahf_last_output_time;
+  Real pos[NDIM];             // center of the surface
+  bool found;                 // horizon found in last call
+  Real area, mass_irr, mass;  // area, irreducible and Christodoulou mass
+  Real spin[NDIM];            // angular momentum (w.r.t. flat rotational vectors)
+  Real rmin, rmax, rmean;     // coordinate radii of the surface
+
+ private:
+  MeshBlockPack *pmbp;
+  GaussLegendreGrid *pgl;     // angles and quadrature weights of surface points
+  int lmax, nmodes;           // max l and number of modes (lmax+1)^2 of expansion
+  int maxit;                  // max number of flow iterations
+  Real tol;                   // tolerance on the max of r*Theta on the surface
+  Real r_guess;               // radius of initial guess (coordinate sphere)
+  Real flow_alpha, flow_beta; // parameters of the fast flow
+  std::vector<Real> a_lm;     // coefficients of h
+  std::vector<Real> ylm;      // Y_lm and angular derivatives at every point
+  std::vector<Real> hsurf;    // h and its angular derivatives at every point
+  Real max_theta;             // max of |r*Theta| on the last surface found
+
+  DualArray2D<int> interp_indcs;   // indices of MeshBlock and zones therein for interp
+  DualArray3D<Real> interp_wghts;  // weights for interpolation
+  DualArray3D<Real> interp_dwghts; // weights for the derivative of the interpolant
+  DualArray2D<Real> interp_vals;   // g_dd, K_dd and d_k g_dd at surface points
+
+  std::ofstream ofile;        // horizon diagnostics
+  std::ofstream sfile;        // coefficients of h
+
+  void SetYlm();
+  void SetSurface();
+  bool Interpolate();
+  Real Flow();
+  void Diagnostics();
+  void Write(int iter);
+};
+
+#endif // Z4C_HORIZON_FINDER_HPP_
@@ -10,6 +10,7 @@
 #include <sys/stat.h>  // mkdir
 
 #include <iostream>
+#include <limits>
 #include <string>
 #include <algorithm>
 #include <memory>    // make_unique, unique_ptr
@@ -22,6 +23,7 @@
 #include "bvals/bvals.hpp"
 #include "z4c/compact_object_tracker.hpp"
 #include "z4c/horizon_dump.hpp"
+#include "z4c/horizon_finder.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/z4c_amr.hpp"
 #include "coordinates/adm.hpp"
@@ -60,13 +62,16 @@ char const * const Z4c::Constraint_names[Z4c::ncon] = {
 Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   pmy_pack(ppack),
   u_con("u_con",1,1,1,1,1),
+  u_con_f("u_con_f",1,1,1,1,1),
   //u_mat("u_mat",1,1,1,1,1),
   u0("u0 z4c",1,1,1,1,1),
   coarse_u0("coarse u0 z4c",1,1,1,1,1),
   u1("u1 z4c",1,1,1,1,1),
   u_rhs("u_rhs z4c",1,1,1,1,1),
+  u_drv("u_drv z4c",1,1,1,1,1),
   u_weyl("u_weyl",1,1,1,1,1),
   coarse_u_weyl("coarse_u_weyl",1,1,1,1,1),
+  wave_ylm("wave_ylm",1,1,1,1),
   pamr(new Z4c_AMR(pin)) {
   // (1) read time-evolution option [already error checked in driver constructor]
   // Then initialize memory and algorithms for reconstruction and Riemann solvers
@@ -80,7 +85,25 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
   int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
   Kokkos::Profiling::pushRegion("Tensor fields");
-  Kokkos::realloc(u_con, nmb, (ncon), ncells3, ncells2, ncells1);
+  // constraints are diagnostic only, so they may be stored in single precision
+  std::string con_prec = pin->GetOrAddString("z4c", "con_precision", "real");
+  if (con_prec.compare("float") == 0) {
+    opt.con_float = true;
+  } else if (con_prec.compare("real") == 0) {
+    opt.con_float = false;
+  } else {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<z4c>/con_precision = '" << con_prec << "' must be "
+              << "real or float (half precision cannot represent small constraint "
+              << "violations)" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (opt.con_float) {
+    Kokkos::realloc(u_con_f, nmb, (ncon), ncells3, ncells2, ncells1);
+    Kokkos::realloc(u_con, 1, (ncon), 1, 1, 1);   // only so that con can be sliced
+  } else {
+    Kokkos::realloc(u_con, nmb, (ncon), ncells3, ncells2, ncells1);
+  }
   // Matter commented out
   // kokkos::realloc(u_mat, nmb, (N_MAT), ncells3, ncells2, ncells1);
   Kokkos::realloc(u0,    nmb, (nz4c), ncells3, ncells2, ncells1);
@@ -151,7 +174,48 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   opt.extrap_order = fmax(2,fmin(indcs.ng,fmin(4,
       pin->GetOrAddInteger("z4c", "extrap_order", 2))));
 
+  // Adaptive timestep control uses the embedded lower-order solution of rk2 (Euler) or
+  // rk3 (Heun), which are available from the stage registers without extra storage
+  opt.adaptive_dt = pin->GetOrAddBoolean("z4c", "adaptive_dt", false);
+  opt.dt_rtol = pin->GetOrAddReal("z4c", "dt_rtol", 1.0e-6);
+  opt.dt_atol = pin->GetOrAddReal("z4c", "dt_atol", 1.0e-8);
+  opt.dt_safety = pin->GetOrAddReal("z4c", "dt_safety", 0.9);
+  dt_err = 0.0;
+  if (opt.adaptive_dt) {
+    std::string integrator = pin->GetOrAddString("time", "integrator", "rk2");
+    if (integrator != "rk2" && integrator != "rk3") {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<z4c>/adaptive_dt requires <time>/integrator = rk2 or "
+                << "rk3, but integrator = " << integrator << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
   diss = opt.diss*pow(2., -2.*indcs.ng)*(indcs.ng % 2 == 0 ? -1. : 1.);
+
+  // Split RHS stores nrhs_derivs derivatives per cell, so memory is bounded by
+  // evaluating it in chunks of MeshBlocks
+  opt.split_rhs = pin->GetOrAddBoolean("z4c", "split_rhs", false);
+  opt.split_rhs_nmb = pin->GetOrAddInteger("z4c", "split_rhs_nmb", nmb);
+  if (opt.split_rhs) {
+    int nchunk = std::max(1, std::min(opt.split_rhs_nmb, nmb));
+    Kokkos::realloc(u_drv, nchunk, nrhs_derivs, ncells3, ncells2, ncells1);
+  }
+  // Tiles of rhs_tile^3 cells plus ghosts of all nz4c variables are held in scratch, so
+  // the largest tile that fits depends on the scratch memory of the device
+  opt.rhs_tile = pin->GetOrAddInteger("z4c", "rhs_tile", 0);
+  opt.rhs_tile_scr_level = pin->GetOrAddInteger("z4c", "rhs_tile_scr_level", 0);
+  opt.weyl_sphere_only = pin->GetOrAddBoolean("z4c", "weyl_sphere_only", false);
+  opt.con_dt = pin->GetOrAddReal("z4c", "con_dt", 0.0);
+  opt.con_stride = std::max(1, pin->GetOrAddInteger("z4c", "con_stride", 1));
+  con_last_time = -std::numeric_limits<Real>::max();
+  // the "con" refinement criterion reads the constraints on every cell at every AMR check
+  if ((pamr->criteria & Z4c_AMR::Con) && (opt.con_dt > 0.0 || opt.con_stride > 1)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<z4c>/con_dt and <z4c>/con_stride cannot be used with "
+              << "the con criterion in <z4c_amr>/method" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
   }
 
   // allocate memory for conserved variables on coarse mesh
@@ -169,8 +233,10 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   Kokkos::Profiling::pushRegion("Buffers");
   pbval_u = new MeshBoundaryValuesCC(ppack, pin, true);
   pbval_u->InitializeBuffers((nz4c));
+  pbval_u->SetHaloPrecision(pin, "z4c");
   pbval_weyl = new MeshBoundaryValuesCC(ppack, pin, true);
   pbval_weyl->InitializeBuffers((2));
+  pbval_weyl->SetHaloPrecision(pin, "z4c");
   Kokkos::Profiling::popRegion();
 
   // wave extraction spheres
@@ -216,6 +282,16 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
       break;
     }
   }
+  // Construct the in-situ apparent horizon finders
+  n = 0;
+  while (true) {
+    if (pin->GetOrAddBoolean("z4c", "ahf_" + std::to_string(n), false)) {
+      pahf.push_back(std::make_unique<HorizonFinder>(pmy_pack, pin, n));
+      n++;
+    } else {
+      break;
+    }
+  }
   /*
   horizon_dt = pin->GetOrAddReal("z4c", "horizon_dt", 1);
   horizon_last_output_time = 0;
@@ -239,8 +315,10 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
 //! \fn void Z4c::AlgConstr(AthenaArray<Real> & u)
 //! \brief algebraic constraints projection
 //
-// This function operates on all grid points of the MeshBlock
-void Z4c::AlgConstr(MeshBlockPack *pmbp) {
+// This function operates on all grid points of the MeshBlock.  With to_adm=true, the ADM
+// variables are also computed from the projected Z4c variables in the same kernel (as
+// in Z4cToADM()), saving a separate pass over the grid.
+void Z4c::AlgConstr(MeshBlockPack *pmbp, bool to_adm) {
   // capture variables for the kernel
   auto &indcs = pmbp->pmesh->mb_indcs;
   int &is = indcs.is; int &ie = indcs.ie;
@@ -254,6 +332,8 @@ void Z4c::AlgConstr(MeshBlockPack *pmbp) {
   int nmb = pmbp->nmb_thispack;
 
   auto &z4c = pmbp->pz4c->z4c;
+  auto &adm = pmbp->padm->adm;
+  auto &opt = pmbp->pz4c->opt;
   par_for("Alg constr loop",DevExeSpace(),
   0,nmb-1,ksg,keg,jsg,jeg,isg,ieg,
   KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
@@ -284,7 +364,20 @@ void Z4c::AlgConstr(MeshBlockPack *pmbp) {
     for(int b = a; b < 3; ++b) {
       z4c.vA_dd(m,a,b,k,j,i) -= (1.0/3.0) * A * z4c.g_dd(m,a,b,k,j,i);
     }
+
+    if (to_adm) {
+      Real psi4 = pow(z4c.chi(m,k,j,i), 4./opt.chi_psi_power);
+      adm.psi4(m,k,j,i) = psi4;
+      Real kfac = (1./3.) * (z4c.vKhat(m,k,j,i) + 2.*z4c.vTheta(m,k,j,i));
+      for(int a = 0; a < 3; ++a)
+      for(int b = a; b < 3; ++b) {
+        Real g_ab = psi4 * z4c.g_dd(m,a,b,k,j,i);
+        adm.g_dd(m,a,b,k,j,i) = g_ab;
+        adm.vK_dd(m,a,b,k,j,i) = psi4 * z4c.vA_dd(m,a,b,k,j,i) + kfac * g_ab;
+      }
+    }
   });
+  if (to_adm) {pmbp->padm->metric_version++;}
 }
 //----------------------------------------------------------------------------------------
 // destructor
@@ -28,6 +28,7 @@ class Coordinates;
 class Driver;
 class CompactObjectTracker;
 class HorizonDump;
+class HorizonFinder;
 
 namespace z4c {
 class Z4c_AMR;
@@ -75,14 +76,18 @@ class Z4c {
   };
   // Names of matter variables
   static char const * const Matter_names[nmat];*/
+  // Number of derivatives per cell stored by the split RHS kernels
+  static constexpr int nrhs_derivs = 136;
 
   // data
   // flags to denote relativistic dynamics
   DvceArray5D<Real> u_con;     // constraints fields
+  DvceArray5D<float> u_con_f;  // constraints fields stored in float, see opt.con_float
   DvceArray5D<Real> u_mat;
   DvceArray5D<Real> u0;        // z4c solution
   DvceArray5D<Real> u1;        // z4c solution at intermediate timestep
   DvceArray5D<Real> u_rhs;     // z4c rhs storage
+  DvceArray5D<Real> u_drv;     // derivatives used by split rhs kernels
   DvceArray5D<Real> coarse_u0; // coarse representation of z4c solution
   DvceArray5D<Real> u_weyl; // weyl scalars
   DvceArray5D<Real> coarse_u_weyl; // coarse representation of weyl scalars
@@ -174,6 +179,28 @@ class Z4c {
     bool user_Sbc;
     // Boundary extrapolation order
     int extrap_order;
+    // Adaptive timestep from the embedded error estimate of the RK integrator
+    bool adaptive_dt;
+    Real dt_rtol;
+    Real dt_atol;
+    Real dt_safety;
+    // Compute derivatives and algebraic RHS in separate kernels, storing derivatives of
+    // at most split_rhs_nmb MeshBlocks at a time
+    bool split_rhs;
+    int split_rhs_nmb;
+    // Edge of tiles of u0 loaded into scratch for derivatives in the RHS (0 = off)
+    int rhs_tile;
+    int rhs_tile_scr_level;
+    // Compute the Weyl scalars only on MeshBlocks used to interpolate to the extraction
+    // spheres, leaving u_weyl zero elsewhere
+    bool weyl_sphere_only;
+    // Constraints are computed every con_dt in time (0 = every cycle), on every
+    // con_stride-th cell in each direction
+    Real con_dt;
+    int con_stride;
+    // Constraints are stored in u_con_f (float) rather than u_con (Real), which is then
+    // not allocated
+    bool con_float;
   };
   Options opt;
   Real diss;              // Dissipation parameter
@@ -186,15 +213,20 @@ class Z4c {
 
   // following only used for time-evolving flow
   Real dtnew;
+  // weighted max-norm of the embedded error estimate in the last step (adaptive_dt)
+  Real dt_err;
 
   // geodesic grid for wave extr
   std::vector<std::unique_ptr<SphericalGrid>> spherical_grids;
   // array storing waveform at each radii
   Real * psi_out;
+  DvceArray4D<Real> wave_ylm;  // weight*ylm tabulated on extraction spheres
   Real waveform_dt;
   Real last_output_time;
   int nrad; // number of radii to perform wave extraction
 
+  Real con_last_time;  // time constraints were last computed
+
   // CCE
   Real cce_dump_dt;
   Real cce_dump_last_output_time;
@@ -228,9 +260,11 @@ class Z4c {
   TaskStatus RestrictWeyl(Driver *d, int stage);
   TaskStatus CCEDump(Driver *pdrive, int stage);
   TaskStatus TrackCompactObjects(Driver *d, int stage);
+  TaskStatus EvolveCompactObjects(Driver *d, int stage);
   TaskStatus CalcWeylScalar(Driver *d, int stage);
   TaskStatus CalcWaveForm(Driver *d, int stage);
   TaskStatus DumpHorizons(Driver *d, int stage);
+  TaskStatus FindHorizons(Driver *d, int stage);
 
   template <int NGHOST>
   TaskStatus CalcRHS(Driver *d, int stage);
@@ -243,11 +277,12 @@ class Z4c {
   template <int NGHOST>
   void Z4cWeyl(MeshBlockPack *pmbp);
   void WaveExtr(MeshBlockPack *pmbp);
-  void AlgConstr(MeshBlockPack *pmbp);
+  void AlgConstr(MeshBlockPack *pmbp, bool to_adm=false);
 
   Z4c_AMR *pamr;
   std::vector<std::unique_ptr<CompactObjectTracker>> ptracker;
   std::vector<std::unique_ptr<HorizonDump>> phorizon_dump;
+  std::vector<std::unique_ptr<HorizonFinder>> pahf;
 
   /*
   std::list<CartesianGrid> horizon_dump;
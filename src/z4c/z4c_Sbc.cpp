@@ -4,7 +4,7 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file z4c_Sbc.cpp
-//! \brief placeholder for Sommerfeld boundary condition
+//! \brief Sommerfeld (radiative) boundary conditions for the Z4c RHS
 
 #include <algorithm>
 #include <cinttypes>
@@ -123,141 +123,56 @@ static void Z4cSommerfeld(const Z4c::Z4c_vars& z4c, const Z4c::Z4c_vars& rhs,
 
 //---------------------------------------------------------------------------------------
 //! \fn TaskStatus Z4c::Z4cBoundaryRHS
-//! \brief placeholder for the Sommerfield Boundary conditions for z4c
+//! \brief Sommerfeld boundary conditions for z4c.  A single kernel runs over every cell
+//! of the outer boundary faces of the MeshBlocks in the MeshBlockPack (stored in the
+//! list pmb->bc_facelist), and overwrites the RHS of all variables at once in cells on
+//! faces with outflow/diode BCs (or user BCs, if user_Sbc is set).  Edge and corner
+//! cells shared by two or three faces get the same (point-wise) value from each face.
 TaskStatus Z4c::Z4cBoundaryRHS(Driver *pdriver, int stage) {
-  auto &pm = pmy_pack->pmesh;
-  auto &mb_bcs = pmy_pack->pmb->mb_bcs;
-  auto &indcs = pmy_pack->pmesh->mb_indcs;
-  auto &size = pmy_pack->pmb->mb_size;
+  auto &pmb = pmy_pack->pmb;
+  int nface = pmb->nbc_face;
+  if (nface == 0) return TaskStatus::complete;
 
-  int nmb = pmy_pack->nmb_thispack;
-  int is = indcs.is;
-  int ie = indcs.ie;
-  int js = indcs.js;
-  int je = indcs.je;
-  int ks = indcs.ks;
-  int ke = indcs.ke;
+  auto &mb_bcs = pmb->mb_bcs;
+  auto &bc_facelist = pmb->bc_facelist;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &size = pmb->mb_size;
+  int is = indcs.is, ie = indcs.ie, nx1 = indcs.nx1;
+  int js = indcs.js, je = indcs.je, nx2 = indcs.nx2;
+  int ks = indcs.ks, ke = indcs.ke, nx3 = indcs.nx3;
+  int npts = std::max(nx2*nx3, std::max(nx1*nx3, nx1*nx2));
 
   auto &z4c_ = z4c;
   auto &rhs_ = rhs;
-  bool &user_Sbc = opt.user_Sbc;
-
-  // We only need to apply this condition for outflow boundaries
-  if (pm->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::outflow
-      || pm->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::diode
-      || pm->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::user
-      || pm->mesh_bcs[BoundaryFace::outer_x1] == BoundaryFlag::outflow
-      || pm->mesh_bcs[BoundaryFace::outer_x1] == BoundaryFlag::diode
-      || pm->mesh_bcs[BoundaryFace::outer_x1] == BoundaryFlag::user) {
-    par_for("z4crhs_bc_x1", DevExeSpace(), 0, (nmb-1), ks, ke, js, je,
-    KOKKOS_LAMBDA(int m, int k, int j) {
-      // Inner boundary
-      switch(mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, is);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
-              Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, is);
-            }
-          break;
-        default:
-          break;
-      }
-      // Outer boundary
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x1)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, ie);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
-              Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, ie);
-            }
-          break;
-        default:
-          break;
-      }
-    });
-  }
-  if (pm->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::outflow
-      || pm->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::diode
-      || pm->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::user
-      || pm->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::outflow
-      || pm->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::diode
-      || pm->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::user) {
-    par_for("z4crhs_bc_x2", DevExeSpace(), 0, (nmb-1), ks, ke, is, ie,
-    KOKKOS_LAMBDA(int m, int k, int i) {
-      // Inner boundary
-      switch(mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, js, i);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
-              Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, js, i);
-            }
-          break;
-        default:
-          break;
-      }
-      // Outer boundary
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x2)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, je, i);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
-              Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, je, i);
-            }
-          break;
-        default:
-          break;
-      }
-    });
-  }
-  if (pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::outflow
-      || pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::diode
-      || pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::user
-      || pm->mesh_bcs[BoundaryFace::outer_x3] == BoundaryFlag::outflow
-      || pm->mesh_bcs[BoundaryFace::outer_x3] == BoundaryFlag::diode
-      || pm->mesh_bcs[BoundaryFace::outer_x3] == BoundaryFlag::user) {
-    par_for("z4crhs_bc_x3", DevExeSpace(), 0, (nmb-1), js, je, is, ie,
-    KOKKOS_LAMBDA(int m, int j, int i) {
-      // Inner boundary
-      switch(mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, ks, j, i);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
-              Z4cSommerfeld(z4c_, rhs_, indcs, size, m, ks, j, i);
-            }
-          break;
-        default:
-          break;
-      }
-      // Outer boundary
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x3)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, ke, j, i);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
-              Z4cSommerfeld(z4c_, rhs_, indcs, size, m, ke, j, i);
-            }
-          break;
-        default:
-          break;
-      }
-    });
-  }
-
+  bool user_Sbc = opt.user_Sbc;
+
+  par_for("z4crhs_bc", DevExeSpace(), 0, (nface-1), 0, (npts-1),
+  KOKKOS_LAMBDA(int b, int n) {
+    int m = bc_facelist.d_view(b)/6;
+    int f = bc_facelist.d_view(b) - 6*m;
+    BoundaryFlag bc = mb_bcs.d_view(m,f);
+    if (!(bc == BoundaryFlag::outflow || bc == BoundaryFlag::diode ||
+          (bc == BoundaryFlag::user && user_Sbc))) return;
+
+    int k, j, i;
+    if (f < 2) {          // x1-faces, n indexes (k,j)
+      if (n >= nx2*nx3) return;
+      k = ks + n/nx2;
+      j = js + n%nx2;
+      i = (f == BoundaryFace::inner_x1)? is : ie;
+    } else if (f < 4) {   // x2-faces, n indexes (k,i)
+      if (n >= nx1*nx3) return;
+      k = ks + n/nx1;
+      j = (f == BoundaryFace::inner_x2)? js : je;
+      i = is + n%nx1;
+    } else {              // x3-faces, n indexes (j,i)
+      if (n >= nx1*nx2) return;
+      k = (f == BoundaryFace::inner_x3)? ks : ke;
+      j = js + n/nx1;
+      i = is + n%nx1;
+    }
+    Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, i);
+  });
 
   return TaskStatus::complete;
 }
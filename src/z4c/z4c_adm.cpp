@@ -21,6 +21,7 @@
 #include "z4c/z4c.hpp"
 #include "z4c/tmunu.hpp"
 #include "coordinates/cell_locations.hpp"
+#include "utils/transient_pool.hpp"
 
 namespace z4c {
 
@@ -100,7 +101,8 @@ void Z4c::ADMToZ4c(MeshBlockPack *pmbp, ParameterInput *pin) {
   });
   Kokkos::fence();
 
-  DvceArray5D<Real> g_uu("g_uu", nmb, 6, ncells3, ncells2, ncells1);
+  auto g_uu = transient_pool::Get<DvceArray5D<Real>>("g_uu", nmb, 6, ncells3, ncells2,
+                                                     ncells1);
   AthenaTensor<Real, TensorSymm::SYM2, 3, 2> g3u;
   g3u.InitWithShallowSlice(g_uu, 0, 5);
   // GLOOP
@@ -232,6 +234,7 @@ void Z4c::Z4cToADM(MeshBlockPack *pmbp) {
         (1./3.) * (z4c.vKhat(m,k,j,i) + 2.*z4c.vTheta(m,k,j,i)) * adm.g_dd(m,a,b,k,j,i);
     }
   });
+  pmbp->padm->metric_version++;
   return;
 }
 //----------------------------------------------------------------------------------------
@@ -246,7 +249,9 @@ void Z4c::Z4cToADM(MeshBlockPack *pmbp) {
 // https://git.tpi.uni-jena.de/bamdev/adm/blob/master/adm_constraints_N.m
 //
 // The constraints are set only in the MeshBlock interior, because derivatives
-// of the ADM quantities are neded to compute them.
+// of the ADM quantities are neded to compute them.  With <z4c>/con_stride = s > 1 they
+// are only computed on every s-th cell in each direction (and are zero elsewhere), so
+// that monitoring costs 1/s^3 of a full evaluation; the history output accounts for this.
 template <int NGHOST>
 void Z4c::ADMConstraints(MeshBlockPack *pmbp) {
   // capture variables for the kernel
@@ -262,17 +267,28 @@ void Z4c::ADMConstraints(MeshBlockPack *pmbp) {
   auto &z4c = pmbp->pz4c->z4c;
   auto &adm = pmbp->padm->adm;
   auto &u_con = pmbp->pz4c->u_con;
+  auto &u_con_f = pmbp->pz4c->u_con_f;
+  bool con_float = pmbp->pz4c->opt.con_float;
 
   // vacuum or with matter?
   bool is_vacuum = (pmy_pack->ptmunu == nullptr) ? true : false;
   Tmunu::Tmunu_vars tmunu;
   if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
 
-  Kokkos::deep_copy(u_con, 0.);
+  if (con_float) {
+    Kokkos::deep_copy(u_con_f, 0.0f);
+  } else {
+    Kokkos::deep_copy(u_con, 0.);
+  }
   auto &con = pmbp->pz4c->con;
+  int st = pmbp->pz4c->opt.con_stride;
+  int nk = (ke - ks)/st, nj = (je - js)/st, ni = (ie - is)/st;
   par_for("ADM constraints loop",DevExeSpace(),
-  0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+  0,nmb-1,0,nk,0,nj,0,ni,
+  KOKKOS_LAMBDA(const int m, const int kk, const int jj, const int ii) {
+    const int k = ks + st*kk;
+    const int j = js + st*jj;
+    const int i = is + st*ii;
     AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> Gamma_u;
     AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> Gamma_u_z4c;
     AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> M_u;
@@ -475,9 +491,9 @@ void Z4c::ADMConstraints(MeshBlockPack *pmbp) {
     //
     // Hamiltonian constraint
     //
-    con.H(m,k,j,i) = R + SQR(K) - KK;
+    Real H = R + SQR(K) - KK;
     if(!is_vacuum) {
-      con.H(m,k,j,i) -= 16*M_PI * tmunu.E(m,k,j,i);
+      H -= 16*M_PI * tmunu.E(m,k,j,i);
     }
     // Momentum constraint (contravariant)
     //
@@ -495,29 +511,50 @@ void Z4c::ADMConstraints(MeshBlockPack *pmbp) {
     }
 
     // Momentum constraint (covariant)
+    Real M_d[3] = {0.0, 0.0, 0.0};
     for(int a = 0; a < 3; ++a) {
       for(int b = 0; b < 3; ++b) {
-        con.M_d(m,a,k,j,i) += adm.g_dd(m,a,b,k,j,i) * M_u(b);
+        M_d[a] += adm.g_dd(m,a,b,k,j,i) * M_u(b);
       }
     }
 
     // Momentum constraint (norm squared)
+    Real M = 0.0;
     for(int a = 0; a < 3; ++a)
     for(int b = 0; b < 3; ++b) {
-      con.M(m,k,j,i) += adm.g_dd(m,a,b,k,j,i) * M_u(a) * M_u(b);
+      M += adm.g_dd(m,a,b,k,j,i) * M_u(a) * M_u(b);
     }
 
     // Constraint violation Z (norm squared)
+    Real Z = 0.0;
     for(int a = 0; a < 3; ++a)
     for(int b = 0; b < 3; ++b) {
-      con.Z(m,k,j,i) += 0.25*z4c.g_dd(m,a,b,k,j,i)
-                        *(z4c.vGam_u(m,a,k,j,i) - Gamma_u_z4c(a))
-                        *(z4c.vGam_u(m,b,k,j,i) - Gamma_u_z4c(b));
+      Z += 0.25*z4c.g_dd(m,a,b,k,j,i)
+           *(z4c.vGam_u(m,a,k,j,i) - Gamma_u_z4c(a))
+           *(z4c.vGam_u(m,b,k,j,i) - Gamma_u_z4c(b));
     }
 
     // Constraint violation monitor C^2
-    con.C(m,k,j,i) = SQR(con.H(m,k,j,i)) + con.M(m,k,j,i) +
-                     SQR(z4c.vTheta(m,k,j,i)) + 4.0*con.Z(m,k,j,i);
+    Real C = SQR(H) + M + SQR(z4c.vTheta(m,k,j,i)) + 4.0*Z;
+
+    // store constraints, in float if requested
+    if (con_float) {
+      u_con_f(m,I_CON_C,k,j,i) = static_cast<float>(C);
+      u_con_f(m,I_CON_H,k,j,i) = static_cast<float>(H);
+      u_con_f(m,I_CON_M,k,j,i) = static_cast<float>(M);
+      u_con_f(m,I_CON_Z,k,j,i) = static_cast<float>(Z);
+      for(int a = 0; a < 3; ++a) {
+        u_con_f(m,I_CON_MX+a,k,j,i) = static_cast<float>(M_d[a]);
+      }
+    } else {
+      con.C(m,k,j,i) = C;
+      con.H(m,k,j,i) = H;
+      con.M(m,k,j,i) = M;
+      con.Z(m,k,j,i) = Z;
+      for(int a = 0; a < 3; ++a) {
+        con.M_d(m,a,k,j,i) = M_d[a];
+      }
+    }
 });
 }
 template void Z4c::ADMConstraints<2>(MeshBlockPack *pmbp);
@@ -8,6 +8,7 @@
 #include <cstdio>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -19,30 +20,51 @@
 #include "z4c/compact_object_tracker.hpp"
 #include "z4c/z4c.hpp"
 
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
 #define SQ(X) ((X)*(X))
 
 namespace z4c {
 
 // set some parameters
-Z4c_AMR::Z4c_AMR(ParameterInput *pin) {
+Z4c_AMR::Z4c_AMR(ParameterInput *pin) :
+  criteria(0),
+  chi_thresh(0.2),
+  dchi_thresh(0.1),
+  con_thresh(0.0),
+  moving_box(false),
+  last_generation(-1) {
   std::string ref_method = pin->GetOrAddString("z4c_amr", "method", "trivial");
-  if (ref_method == "trivial") {
-    method = Trivial;
-  } else if (ref_method == "tracker") {
-    method = Tracker;
-  } else if (ref_method == "chi") {
-    method = Chi;
-    chi_thresh = pin->GetOrAddReal("z4c_amr", "chi_min", 0.2);
-  } else if (ref_method == "dchi") {
-    method = dChi;
-    dchi_thresh = pin->GetOrAddReal("z4c_amr", "dchi_max", 0.1);
-  } else {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line "
-              << __LINE__ << std::endl;
-    std::cout << "Unknown refinement strategy: " << ref_method << std::endl;
-    std::exit(EXIT_FAILURE);
+  std::stringstream methods(ref_method);
+  std::string m;
+  while (std::getline(methods, m, ',')) {
+    m.erase(0, m.find_first_not_of(" \t"));
+    m.erase(m.find_last_not_of(" \t") + 1);
+    if (m == "trivial") {
+      continue;
+    } else if (m == "tracker") {
+      criteria |= Tracker;
+    } else if (m == "chi" || m == "chi_min") {
+      criteria |= Chi;
+      chi_thresh = pin->GetOrAddReal("z4c_amr", "chi_min", 0.2);
+    } else if (m == "dchi" || m == "dchi_max") {
+      criteria |= dChi;
+      dchi_thresh = pin->GetOrAddReal("z4c_amr", "dchi_max", 0.1);
+    } else if (m == "con" || m == "con_max") {
+      criteria |= Con;
+      con_thresh = pin->GetOrAddReal("z4c_amr", "con_max", 1.0e-4);
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line "
+                << __LINE__ << std::endl;
+      std::cout << "Unknown refinement strategy: " << m << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
   }
 
+  moving_box = pin->GetOrAddBoolean("z4c_amr", "moving_box", false);
+
   for (int nr = 0; nr < 16; ++nr) {
     std::string name = "radius_" + std::to_string(nr) + "_rad";
     if (pin->DoesParameterExist("z4c_amr", name)) {
@@ -56,15 +78,18 @@ Z4c_AMR::Z4c_AMR(ParameterInput *pin) {
 }
 
 // 1: refines, -1: de-refines, 0: does nothing
+// Criteria on fields are evaluated first (in one kernel), then combined with trackers
 void Z4c_AMR::Refine(MeshBlockPack *pmy_pack) {
-  if (method == Tracker) {
+  if (criteria & (Chi | dChi | Con)) {
+    RefineFields(pmy_pack);
+  }
+  if (criteria & Tracker) {
     RefineTracker(pmy_pack);
-  } else if (method == Chi) {
-    RefineChiMin(pmy_pack);
-  } else if (method == dChi) {
-    RefineDchiMax(pmy_pack);
   }
   RefineRadii(pmy_pack);
+  if (moving_box) {
+    SkipUnchangedRegrid(pmy_pack);
+  }
 }
 
 // refine region within a certain distance from each compact object
@@ -120,6 +145,8 @@ void Z4c_AMR::RefineTracker(MeshBlockPack *pmbp) {
         flag.push_back(-1);
       }
     }
+    // combine with flag already set by criteria on fields
+    if (criteria & (Chi | dChi | Con)) {flag.push_back(refine_flag.h_view(m + mbs));}
     refine_flag.h_view(m + mbs) = *std::max_element(flag.begin(), flag.end());
   }
 
@@ -128,54 +155,9 @@ void Z4c_AMR::RefineTracker(MeshBlockPack *pmbp) {
   refine_flag.template sync<DevExeSpace>();
 }
 
-// refine based on min{chi}
-void Z4c_AMR::RefineChiMin(MeshBlockPack *pmbp) {
-  Mesh *pmesh       = pmbp->pmesh;
-  int nmb           = pmbp->nmb_thispack;
-  int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
-  auto &refine_flag = pmesh->pmr->refine_flag;
-  auto &indcs       = pmesh->mb_indcs;
-  int &is = indcs.is, nx1 = indcs.nx1;
-  int &js = indcs.js, nx2 = indcs.nx2;
-  int &ks = indcs.ks, nx3 = indcs.nx3;
-  const int nkji = nx3 * nx2 * nx1;
-  const int nji  = nx2 * nx1;
-  auto &u0       = pmbp->pz4c->u0;
-  int I_Z4C_CHI  = pmbp->pz4c->I_Z4C_CHI;
-  // note: we need this to prevent capture by this in the lambda expr.
-  auto chi_thresh = this->chi_thresh;
-
-  par_for_outer(
-    "Z4c_AMR::ChiMin", DevExeSpace(), 0, 0, 0, (nmb - 1),
-    KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
-      Real team_dmin;
-      Kokkos::parallel_reduce(
-        Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real &dmin) {
-          int k = (idx) / nji;
-          int j = (idx - k * nji) / nx1;
-          int i = (idx - k * nji - j * nx1) + is;
-          j += js;
-          k += ks;
-          dmin = fmin(u0(m, I_Z4C_CHI, k, j, i), dmin);
-        },
-        Kokkos::Min<Real>(team_dmin));
-
-      if (team_dmin < chi_thresh) {
-        refine_flag.d_view(m + mbs) = 1;
-      }
-      if (team_dmin > 1.25 * chi_thresh) {
-        refine_flag.d_view(m + mbs) = -1;
-      }
-    });
-
-  // sync host and device
-  refine_flag.template modify<DevExeSpace>();
-  refine_flag.template sync<HostMemSpace>();
-}
-
-// refine based on max{dchi}
-void Z4c_AMR::RefineDchiMax(MeshBlockPack *pmbp) {
+// refine based on min{chi}, max{dchi} and max{|H|} (Hamiltonian constraint), with all
+// criteria in use evaluated in a single pass over each MeshBlock
+void Z4c_AMR::RefineFields(MeshBlockPack *pmbp) {
   Mesh *pmesh       = pmbp->pmesh;
   int nmb           = pmbp->nmb_thispack;
   int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
@@ -187,35 +169,73 @@ void Z4c_AMR::RefineDchiMax(MeshBlockPack *pmbp) {
   const int nkji = nx3 * nx2 * nx1;
   const int nji  = nx2 * nx1;
   auto &u0       = pmbp->pz4c->u0;
+  auto &u_con    = pmbp->pz4c->u_con;
+  auto &u_con_f  = pmbp->pz4c->u_con_f;
+  bool con_float = pmbp->pz4c->opt.con_float;
   int I_Z4C_CHI  = pmbp->pz4c->I_Z4C_CHI;
+  int I_CON_H    = pmbp->pz4c->I_CON_H;
   // note: we need this to prevent capture by this in the lambda expr.
+  bool use_chi  = (criteria & Chi);
+  bool use_dchi = (criteria & dChi);
+  bool use_con  = (criteria & Con);
+  auto chi_thresh  = this->chi_thresh;
   auto dchi_thresh = this->dchi_thresh;
+  auto con_thresh  = this->con_thresh;
 
   par_for_outer(
-    "Z4c_AMR::ChiMin", DevExeSpace(), 0, 0, 0, (nmb - 1),
+    "Z4c_AMR::Fields", DevExeSpace(), 0, 0, 0, (nmb - 1),
     KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
-      Real team_dmax;
+      RefineFieldMax team_max;
       Kokkos::parallel_reduce(
         Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real &dmax) {
+        [=](const int idx, RefineFieldMax &vmax) {
           int k = (idx) / nji;
           int j = (idx - k * nji) / nx1;
           int i = (idx - k * nji - j * nx1) + is;
           j += js;
           k += ks;
-          Real d2 = SQR(u0(m,I_Z4C_CHI,k,j,i+1) - u0(m,I_Z4C_CHI,k,j,i-1));
-          d2 += SQR(u0(m,I_Z4C_CHI,k,j+1,i) - u0(m,I_Z4C_CHI,k,j-1,i));
-          d2 += SQR(u0(m,I_Z4C_CHI,k+1,j,i) - u0(m,I_Z4C_CHI,k-1,j,i));
-          dmax = fmax((sqrt(d2)), dmax);
+          if (use_chi) {
+            vmax.val[0] = fmax(-u0(m, I_Z4C_CHI, k, j, i), vmax.val[0]);
+          }
+          if (use_dchi) {
+            Real d2 = SQR(u0(m,I_Z4C_CHI,k,j,i+1) - u0(m,I_Z4C_CHI,k,j,i-1));
+            d2 += SQR(u0(m,I_Z4C_CHI,k,j+1,i) - u0(m,I_Z4C_CHI,k,j-1,i));
+            d2 += SQR(u0(m,I_Z4C_CHI,k+1,j,i) - u0(m,I_Z4C_CHI,k-1,j,i));
+            vmax.val[1] = fmax(sqrt(d2), vmax.val[1]);
+          }
+          if (use_con) {
+            Real h = (con_float)? static_cast<Real>(u_con_f(m, I_CON_H, k, j, i)) :
+                                  u_con(m, I_CON_H, k, j, i);
+            vmax.val[2] = fmax(fabs(h), vmax.val[2]);
+          }
         },
-        Kokkos::Max<Real>(team_dmax));
+        Kokkos::Sum<RefineFieldMax>(team_max));
 
-      if (team_dmax > dchi_thresh) {
-        refine_flag.d_view(m + mbs) = 1;
+      // refine if any criterion is met, derefine only if all criteria allow it
+      int flag = -1;
+      if (use_chi) {
+        Real chi_min = -team_max.val[0];
+        if (chi_min < chi_thresh) {
+          flag = 1;
+        } else if (chi_min <= 1.25 * chi_thresh) {
+          flag = (flag > 0)? flag : 0;
+        }
       }
-      if (team_dmax < 0.5 * dchi_thresh) {
-        refine_flag.d_view(m + mbs) = -1;
+      if (use_dchi) {
+        if (team_max.val[1] > dchi_thresh) {
+          flag = 1;
+        } else if (team_max.val[1] >= 0.5 * dchi_thresh) {
+          flag = (flag > 0)? flag : 0;
+        }
+      }
+      if (use_con) {
+        if (team_max.val[2] > con_thresh) {
+          flag = 1;
+        } else if (team_max.val[2] >= 0.25 * con_thresh) {
+          flag = (flag > 0)? flag : 0;
+        }
       }
+      refine_flag.d_view(m + mbs) = flag;
     });
 
   // sync host and device
@@ -271,4 +291,43 @@ void Z4c_AMR::RefineRadii(MeshBlockPack *pmbp) {
   refine_flag.template sync<DevExeSpace>();
 }
 
+// In moving-box mode the refinement regions are rigidly translated with the trackers,
+// so most checks produce the same flags as the previous one.  If the Mesh has not
+// changed since then (so the last tree update was a no-op) and the flags that will
+// survive the checks in MeshRefinement::CheckForRefinement() are the same on every rank,
+// the tree update would again do nothing, and all flags are cleared so that it returns
+// immediately.  Blocks are then only created/destroyed when a region crosses a MeshBlock.
+void Z4c_AMR::SkipUnchangedRegrid(MeshBlockPack *pmbp) {
+  Mesh *pmesh       = pmbp->pmesh;
+  auto &pmr         = pmesh->pmr;
+  auto &refine_flag = pmr->refine_flag;
+  int nmb           = pmbp->nmb_thispack;
+  int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
+
+  // flags after clipping at root/max level and masking recently refined MeshBlocks
+  std::vector<int> flag(nmb);
+  for (int m = 0; m < nmb; ++m) {
+    int f = refine_flag.h_view(m + mbs);
+    int level = pmesh->lloc_eachmb[m + mbs].level;
+    if (level == pmesh->max_level && f > 0) f = 0;
+    if (level == pmesh->root_level && f < 0) f = 0;
+    if (pmr->ncyc_since_ref(m + mbs) < pmr->refinement_interval) f = 0;
+    flag[m] = f;
+  }
+  int unchanged = (pmesh->ngeneration == last_generation && flag == last_flag)? 1 : 0;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &unchanged, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+  if (unchanged) {
+    for (int m = 0; m < nmb; ++m) {
+      refine_flag.h_view(m + mbs) = 0;
+    }
+    refine_flag.template modify<HostMemSpace>();
+    refine_flag.template sync<DevExeSpace>();
+  } else {
+    last_flag = flag;
+    last_generation = pmesh->ngeneration;
+  }
+}
+
 } // namespace z4c
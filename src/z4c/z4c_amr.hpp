@@ -7,6 +7,7 @@
 #ifndef Z4C_Z4C_AMR_HPP_
 #define Z4C_Z4C_AMR_HPP_
 
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -18,10 +19,40 @@ class MeshBlockPack;
 namespace z4c {
 class Z4c;
 
+//----------------------------------------------------------------------------------------
+//! \struct RefineFieldMax
+//! \brief maxima over a MeshBlock of the fields used by the refinement criteria, computed
+//! together in a single reduction (min{chi} is stored as max{-chi}).  Follows the custom
+//! reducer in athena.hpp, with the "sum" of two values taken to be their maximum.
+
+struct RefineFieldMax {
+  Real val[3];  // -chi, |grad chi|, |H|
+  KOKKOS_INLINE_FUNCTION
+  RefineFieldMax() {
+    for (int n=0; n<3; ++n) {val[n] = -(std::numeric_limits<Real>::max());}
+  }
+  KOKKOS_INLINE_FUNCTION
+  RefineFieldMax(const RefineFieldMax &rhs) {
+    for (int n=0; n<3; ++n) {val[n] = rhs.val[n];}
+  }
+  KOKKOS_INLINE_FUNCTION
+  RefineFieldMax& operator += (const RefineFieldMax &src) {
+    for (int n=0; n<3; ++n) {val[n] = fmax(val[n], src.val[n]);}
+    return *this;
+  }
+  KOKKOS_INLINE_FUNCTION
+  void operator += (const volatile RefineFieldMax &src) volatile {
+    for (int n=0; n<3; ++n) {val[n] = fmax(val[n], src.val[n]);}
+  }
+};
+
 //! \class Z4c_AMR
 //  \brief managing AMR for Z4c simulations
 class Z4c_AMR {
-  enum RefinementMethod { Trivial, Tracker, Chi, dChi };
+  // refinement criteria, which can be combined in <z4c_amr>/method as a comma-separated
+  // list (e.g. "tracker,dchi,con").  A MeshBlock is refined if any criterion requests
+  // refinement, and derefined only if all of them request derefinement.
+  enum RefinementCriterion { Tracker=1, Chi=2, dChi=4, Con=8 };
 
  public:
   explicit Z4c_AMR(ParameterInput *pin);
@@ -29,11 +60,11 @@ class Z4c_AMR {
 
   void Refine(MeshBlockPack *pmbp);             // call the AMR method
   void RefineTracker(MeshBlockPack *pmbp);      // Refine based on the trackers
-  void RefineChiMin(MeshBlockPack *pmbp);       // Refine based on min{chi}
-  void RefineDchiMax(MeshBlockPack *pmbp);      // Refine based on max{dchi}
+  void RefineFields(MeshBlockPack *pmbp);       // Refine based on chi, dchi, constraints
   void RefineRadii(MeshBlockPack *pmbp);        // Refine based on the radii
+  void SkipUnchangedRegrid(MeshBlockPack *pmbp);  // Clear flags if regrid is a no-op
 
-  RefinementMethod method;
+  int criteria;        // bitwise OR of the RefinementCriterion in use
 
   // Optinally set the minimum refinement level inside different radial shells
   std::vector<Real> radius;
@@ -41,7 +72,23 @@ class Z4c_AMR {
 
   Real chi_thresh;     // chi threshold for chi refinement method
   Real dchi_thresh;    // dchi threshold for dchi refinement method
+  Real con_thresh;     // Hamiltonian constraint threshold for con refinement method
+
+  // moving-box mode: refinement regions follow the trackers, and the tree update is
+  // skipped while the flags (and hence the result of the last tree update) are unchanged
+  bool moving_box;
+  int last_generation;          // Mesh generation when last_flag was stored
+  std::vector<int> last_flag;   // effective flags of MeshBlocks on this rank
 };
 
 } // namespace z4c
+
+namespace Kokkos { //reduction identity must be defined in Kokkos namespace
+template<>
+struct reduction_identity< z4c::RefineFieldMax > {
+  KOKKOS_FORCEINLINE_FUNCTION static z4c::RefineFieldMax sum() {
+    return z4c::RefineFieldMax();
+  }
+};
+}
 #endif // Z4C_Z4C_AMR_HPP_
@@ -8,8 +8,8 @@
 
 #include <math.h>
 
-//#include <algorithm>
 //#include <cinttypes>
+#include <algorithm>  // min
 #include <iostream>
 //#include <limits>
 
@@ -19,565 +19,764 @@
 #include "z4c/z4c.hpp"
 #include "z4c/tmunu.hpp"
 #include "coordinates/cell_locations.hpp"
+#include "utils/fd_tile.hpp"
+#include "utils/roofline.hpp"
 
 namespace z4c {
 
-template <int NGHOST>
-//! \fn void Z4c::CalcRHS(Driver *pdriver, int stage)
-//! \brief compute rhs of the z4c equations
-TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
-  auto &indcs = pmy_pack->pmesh->mb_indcs;
-  auto &size = pmy_pack->pmb->mb_size;
-  int &is = indcs.is; int &ie = indcs.ie;
-  int &js = indcs.js; int &je = indcs.je;
-  int &ks = indcs.ks; int &ke = indcs.ke;
-
-  int nmb = pmy_pack->nmb_thispack;
+namespace {
+//----------------------------------------------------------------------------------------
+//! \struct RHSDerivatives
+//! \brief first, second and advective (Lie) derivatives of the Z4c variables at a point,
+//! i.e. every finite-difference stencil needed by the RHS.  The advective derivatives of
+//! Lchi, LGam_u, Lg_dd and LA_dd are completed in CalcAlgebraicRHS().
+
+struct RHSDerivatives {
+  // lapse, chi, Khat and Theta 1st drvts
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dalpha_d;
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dchi_d;
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dKhat_d;
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dTheta_d;
+  // shift and Gamma 1st drvts
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 2> dbeta_du;
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 2> dGam_du;
+  // metric 1st drvts
+  AthenaPointTensor<Real, TensorSymm::SYM2,  3, 3> dg_ddd;
+  // lapse and chi 2nd drvts
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> ddalpha_dd;
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> ddchi_dd;
+  // shift 2nd drvts
+  AthenaPointTensor<Real, TensorSymm::ISYM2, 3, 3> ddbeta_ddu;
+  // metric 2nd drvts
+  AthenaPointTensor<Real, TensorSymm::SYM22, 3, 4> ddg_dddd;
+  // Lie derivatives of the lapse, chi, Khat and Theta
+  Real Lalpha, Lchi, LKhat, LTheta;
+  // Lie derivatives of the shift and Gamma
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> Lbeta_u;
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> LGam_u;
+  // Lie derivatives of conf. 3-metric and A
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Lg_dd;
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> LA_dd;
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct Z4cTileVars
+//! \brief views of the Z4c variables in a tile of u0 in scratch memory, with the same
+//! member names as Z4c::Z4c_vars so that either can be passed to CalcDerivatives()
+
+struct Z4cTileVars {
+  FDTile chi, vKhat, vTheta, alpha, vGam_u, beta_u, g_dd, vA_dd;
+
+  KOKKOS_INLINE_FUNCTION
+  explicit Z4cTileVars(const FDTile &t) :
+    chi(t.Var(Z4c::I_Z4C_CHI)),
+    vKhat(t.Var(Z4c::I_Z4C_KHAT)),
+    vTheta(t.Var(Z4c::I_Z4C_THETA)),
+    alpha(t.Var(Z4c::I_Z4C_ALPHA)),
+    vGam_u(t.Var(Z4c::I_Z4C_GAMX)),
+    beta_u(t.Var(Z4c::I_Z4C_BETAX)),
+    g_dd(t.Var(Z4c::I_Z4C_GXX)),
+    vA_dd(t.Var(Z4c::I_Z4C_AXX)) {}
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void ForEachDerivative()
+//! \brief calls f(x) on each of the Z4c::nrhs_derivs independent components x of d,
+//! always in the same order, so derivatives can be stored to and loaded from an array
+
+template <typename F>
+KOKKOS_INLINE_FUNCTION
+void ForEachDerivative(RHSDerivatives &d, const F &f) {
+  for(int a = 0; a < 3; ++a) {
+    f(d.dalpha_d(a)); f(d.dchi_d(a)); f(d.dKhat_d(a)); f(d.dTheta_d(a));
+    f(d.Lbeta_u(a)); f(d.LGam_u(a));
+  }
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    f(d.dbeta_du(a,b)); f(d.dGam_du(a,b));
+  }
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    f(d.ddalpha_dd(a,b)); f(d.ddchi_dd(a,b)); f(d.Lg_dd(a,b)); f(d.LA_dd(a,b));
+    for(int c = 0; c < 3; ++c) {
+      f(d.dg_ddd(c,a,b)); f(d.ddbeta_ddu(a,b,c));
+      for(int e = c; e < 3; ++e) {
+        f(d.ddg_dddd(a,b,c,e));
+      }
+    }
+  }
+  f(d.Lalpha); f(d.Lchi); f(d.LKhat); f(d.LTheta);
+}
 
-  auto &z4c = pmy_pack->pz4c->z4c;
-  auto &rhs = pmy_pack->pz4c->rhs;
-  auto &opt = pmy_pack->pz4c->opt;
+//----------------------------------------------------------------------------------------
+//! \fn void CalcDerivatives()
+//! \brief computes all derivatives of the Z4c variables needed by the RHS at one point,
+//! from either Z4c::Z4c_vars or Z4cTileVars
+
+template <int NGHOST, typename VARS>
+KOKKOS_INLINE_FUNCTION
+void CalcDerivatives(const VARS &z4c, const Real idx[], const int m,
+                     const int k, const int j, const int i, RHSDerivatives &d) {
+  auto &dalpha_d = d.dalpha_d;
+  auto &dchi_d = d.dchi_d;
+  auto &dKhat_d = d.dKhat_d;
+  auto &dTheta_d = d.dTheta_d;
+  auto &dbeta_du = d.dbeta_du;
+  auto &dGam_du = d.dGam_du;
+  auto &dg_ddd = d.dg_ddd;
+  auto &ddalpha_dd = d.ddalpha_dd;
+  auto &ddchi_dd = d.ddchi_dd;
+  auto &ddbeta_ddu = d.ddbeta_ddu;
+  auto &ddg_dddd = d.ddg_dddd;
+  auto &Lalpha = d.Lalpha;
+  auto &Lchi = d.Lchi;
+  auto &LKhat = d.LKhat;
+  auto &LTheta = d.LTheta;
+  auto &Lbeta_u = d.Lbeta_u;
+  auto &LGam_u = d.LGam_u;
+  auto &Lg_dd = d.Lg_dd;
+  auto &LA_dd = d.LA_dd;
+
+  Lalpha = 0.0;
+  Lchi = 0.0;
+  LKhat = 0.0;
+  LTheta = 0.0;
+  Lbeta_u.ZeroClear();
+  LGam_u.ZeroClear();
+  Lg_dd.ZeroClear();
+  LA_dd.ZeroClear();
+
+  // -----------------------------------------------------------------------------------
+  // 1st derivatives
+  //
+  // Scalars
+  for(int a = 0; a < 3; ++a) {
+    dalpha_d(a) = Dx<NGHOST>(a, idx, z4c.alpha, m,k,j,i);
+    dchi_d  (a) = Dx<NGHOST>(a, idx, z4c.chi,   m,k,j,i);
+    dKhat_d (a) = Dx<NGHOST>(a, idx, z4c.vKhat,  m,k,j,i);
+    dTheta_d(a) = Dx<NGHOST>(a, idx, z4c.vTheta, m,k,j,i);
+  }
+
+  // Vectors
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    dbeta_du(b,a) = Dx<NGHOST>(b, idx, z4c.beta_u, m,a,k,j,i);
+    dGam_du(b,a) = Dx<NGHOST>(b, idx, z4c.vGam_u,  m,a,k,j,i);
+  }
+
+  // Tensors
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b)
+  for(int c = 0; c < 3; ++c) {
+    dg_ddd(c,a,b) = Dx<NGHOST>(c, idx, z4c.g_dd, m,a,b,k,j,i);
+  }
+
+  // -----------------------------------------------------------------------------------
+  // 2nd derivatives
+  //
+  // Scalars
+  for(int a = 0; a < 3; ++a) {
+    ddalpha_dd(a,a) = Dxx<NGHOST>(a, idx, z4c.alpha, m,k,j,i);
+    ddchi_dd(a,a) = Dxx<NGHOST>(a, idx, z4c.chi,   m,k,j,i);
+
+    for(int b = a + 1; b < 3; ++b) {
+      ddalpha_dd(a,b) = Dxy<NGHOST>(a, b, idx, z4c.alpha, m,k,j,i);
+      ddchi_dd(a,b) = Dxy<NGHOST>(a, b, idx, z4c.chi,   m,k,j,i);
+    }
+  }
+
+  // Vectors
+  for(int c = 0; c < 3; ++c)
+  for(int a = 0; a < 3; ++a) {
+    ddbeta_ddu(a,a,c) = Dxx<NGHOST>(a, idx, z4c.beta_u, m,c,k,j,i);
+    for(int b = a + 1; b < 3; ++b) {
+      ddbeta_ddu(a,b,c) = Dxy<NGHOST>(a, b, idx, z4c.beta_u, m,c,k,j,i);
+    }
+  }
+
+  // Tensors
+  for(int c = 0; c < 3; ++c)
+  for(int d = c; d < 3; ++d)
+  for(int a = 0; a < 3; ++a) {
+    ddg_dddd(a,a,c,d) = Dxx<NGHOST>(a, idx, z4c.g_dd, m,c,d,k,j,i);
+    for(int b = a + 1; b < 3; ++b) {
+      ddg_dddd(a,b,c,d) = Dxy<NGHOST>(a, b, idx, z4c.g_dd, m,c,d,k,j,i);
+    }
+  }
+
+  // -----------------------------------------------------------------------------------
+  // Advective derivatives
+  //
 
-  bool is_vacuum = (pmy_pack->ptmunu == nullptr) ? true : false;
-  Tmunu::Tmunu_vars tmunu;
-  if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
+  //
+  // Scalars
+  for(int a = 0; a < 3; ++a) {
+    Lalpha += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.alpha, m,a,k,j,i);
+    Lchi   += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.chi,   m,a,k,j,i);
+    LKhat  += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.vKhat,  m,a,k,j,i);
+    LTheta += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.vTheta, m,a,k,j,i);
+  }
 
-  // ===================================================================================
-  // Main RHS calculation
   //
-  par_for("z4c rhs loop",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    // Define scratch arrays to be used in the following calculations
-
-    // Gamma computed from the metric
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> Gamma_u;
-    // Covariant derivative of A
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> DA_u;
-
-    // inverse of conf. metric
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> g_uu;
-    // inverse of A
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> A_uu;
-    // g^cd A_ac A_db
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> AA_dd;
-    // Ricci tensor
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> R_dd;
-    // Ricci tensor, conformal contribution
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Rphi_dd;
-    // 2nd differential of the lapse
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Ddalpha_dd;
-    // 2nd differential of phi
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Ddphi_dd;
-
-    // Christoffel symbols of 1st kind
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_ddd;
-    // Christoffel symbols of 2nd kind
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_udd;
-
-    // auxiliary derivatives
-
-    // lapse 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dalpha_d;
-    // 2nd "divergence" of beta
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> ddbeta_d;
-    // chi 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dchi_d;
-    // phi 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dphi_d;
-    // Khat 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dKhat_d;
-    // Theta 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dTheta_d;
-
-    // lapse 2nd drvts
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> ddalpha_dd;
-    // shift 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 2> dbeta_du;
-    // chi 2nd drvts
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> ddchi_dd;
-    // Gamma 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 2> dGam_du;
-
-    // metric 1st drvts
-    AthenaPointTensor<Real, TensorSymm::SYM2,  3, 3> dg_ddd;
-    // shift 2nd drvts
-    AthenaPointTensor<Real, TensorSymm::ISYM2, 3, 3> ddbeta_ddu;
-
-    // metric 2nd drvts
-    AthenaPointTensor<Real, TensorSymm::SYM22, 3, 4> ddg_dddd;
-
-    // Lie derivative of Gamma
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> LGam_u;
-    // Lie derivative of the shift
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> Lbeta_u;
-
-    // Lie derivative of conf. 3-metric
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Lg_dd;
-    // Lie derivative of A
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> LA_dd;
-
-    Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
-
-    // -----------------------------------------------------------------------------------
-    // Initialize everything to zero
-    //
-    // Scalars
-
-    // auxiliary Lie derivatives along the shift vector
-    // Lie derivative of the lapse
-    Real Lalpha = 0.0;
-    // Lie derivative of chi
-    Real Lchi = 0.0;
-    // Lie derivative of Khat
-    Real LKhat = 0.0;
-    // Lie derivative of Theta
-    Real LTheta = 0.0;
-
-    // determinant of three metric
-    Real detg = 0.0;
-    // bounded version of chi
-    Real chi_guarded = 0.0;
-    // 1/psi4
-    Real oopsi4 = 0.0;
-    // trace of A
-    Real AA = 0.0;
-    // Ricci scalar
-    Real R = 0.0;
-    // tilde H
-    Real Ht = 0.0;
-    // trace of extrinsic curvature
-    Real K = 0.0;
-    // Trace of S_ik
-    Real S = 0.0;
-    // Trace of Ddalpha_dd
-    Real Ddalpha = 0.0;
-
-    // d_a beta^a
-    Real dbeta = 0.0;
-
-    //
-    // Vectors
-    Lbeta_u.ZeroClear();
-    LGam_u.ZeroClear();
-    Gamma_u.ZeroClear();
-    DA_u.ZeroClear();
-    ddbeta_d.ZeroClear();
-
-    //
-    // Symmetric tensors
-    Lg_dd.ZeroClear();
-    LA_dd.ZeroClear();
-    AA_dd.ZeroClear();
-    R_dd.ZeroClear();
-    A_uu.ZeroClear();
-    Gamma_udd.ZeroClear();
-
-    // -----------------------------------------------------------------------------------
-    // 1st derivatives
-    //
-    // Scalars
-    for(int a = 0; a < 3; ++a) {
-      dalpha_d(a) = Dx<NGHOST>(a, idx, z4c.alpha, m,k,j,i);
-      dchi_d  (a) = Dx<NGHOST>(a, idx, z4c.chi,   m,k,j,i);
-      dKhat_d (a) = Dx<NGHOST>(a, idx, z4c.vKhat,  m,k,j,i);
-      dTheta_d(a) = Dx<NGHOST>(a, idx, z4c.vTheta, m,k,j,i);
-    }
+  // Vectors
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    Lbeta_u(b) += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.beta_u, m,a,b,k,j,i);
+    LGam_u(b)  += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.vGam_u,  m,a,b,k,j,i);
+  }
 
-    // Vectors
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      dbeta_du(b,a) = Dx<NGHOST>(b, idx, z4c.beta_u, m,a,k,j,i);
-      dGam_du(b,a) = Dx<NGHOST>(b, idx, z4c.vGam_u,  m,a,k,j,i);
-    }
+  //
+  // Tensors
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b)
+  for(int c = 0; c < 3; ++c) {
+    Lg_dd(a,b) += Lx<NGHOST>(c, idx, z4c.beta_u, z4c.g_dd, m,c,a,b,k,j,i);
+    LA_dd(a,b) += Lx<NGHOST>(c, idx, z4c.beta_u, z4c.vA_dd, m,c,a,b,k,j,i);
+  }
+}
 
-    // Tensors
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
+//----------------------------------------------------------------------------------------
+//! \fn void CalcAlgebraicRHS()
+//! \brief evaluates the RHS of the z4c equations at one point from the variables and
+//! their derivatives d
+
+KOKKOS_INLINE_FUNCTION
+void CalcAlgebraicRHS(const Z4c::Z4c_vars &z4c, const Z4c::Z4c_vars &rhs,
+                      const Z4c::Options &opt, const bool is_vacuum,
+                      const Tmunu::Tmunu_vars &tmunu, RHSDerivatives &d,
+                      const int m, const int k, const int j, const int i) {
+  auto &dalpha_d = d.dalpha_d;
+  auto &dchi_d = d.dchi_d;
+  auto &dKhat_d = d.dKhat_d;
+  auto &dTheta_d = d.dTheta_d;
+  auto &dbeta_du = d.dbeta_du;
+  auto &dGam_du = d.dGam_du;
+  auto &dg_ddd = d.dg_ddd;
+  auto &ddalpha_dd = d.ddalpha_dd;
+  auto &ddchi_dd = d.ddchi_dd;
+  auto &ddbeta_ddu = d.ddbeta_ddu;
+  auto &ddg_dddd = d.ddg_dddd;
+  auto &Lalpha = d.Lalpha;
+  auto &Lchi = d.Lchi;
+  auto &LKhat = d.LKhat;
+  auto &LTheta = d.LTheta;
+  auto &Lbeta_u = d.Lbeta_u;
+  auto &LGam_u = d.LGam_u;
+  auto &Lg_dd = d.Lg_dd;
+  auto &LA_dd = d.LA_dd;
+
+  // Gamma computed from the metric
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> Gamma_u;
+  // Covariant derivative of A
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> DA_u;
+  // 2nd "divergence" of beta
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> ddbeta_d;
+  // phi 1st drvts
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dphi_d;
+
+  // inverse of conf. metric
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> g_uu;
+  // inverse of A
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> A_uu;
+  // g^cd A_ac A_db
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> AA_dd;
+  // Ricci tensor
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> R_dd;
+  // Ricci tensor, conformal contribution
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Rphi_dd;
+  // 2nd differential of the lapse
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Ddalpha_dd;
+  // 2nd differential of phi
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Ddphi_dd;
+
+  // Christoffel symbols of 1st kind
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_ddd;
+  // Christoffel symbols of 2nd kind
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_udd;
+
+  // -------------------------------------------------------------------------------------
+  // Initialize everything to zero
+  //
+  // determinant of three metric
+  Real detg = 0.0;
+  // bounded version of chi
+  Real chi_guarded = 0.0;
+  // 1/psi4
+  Real oopsi4 = 0.0;
+  // trace of A
+  Real AA = 0.0;
+  // Ricci scalar
+  Real R = 0.0;
+  // tilde H
+  Real Ht = 0.0;
+  // trace of extrinsic curvature
+  Real K = 0.0;
+  // Trace of S_ik
+  Real S = 0.0;
+  // Trace of Ddalpha_dd
+  Real Ddalpha = 0.0;
+  // d_a beta^a
+  Real dbeta = 0.0;
+
+  Gamma_u.ZeroClear();
+  DA_u.ZeroClear();
+  ddbeta_d.ZeroClear();
+  AA_dd.ZeroClear();
+  R_dd.ZeroClear();
+  A_uu.ZeroClear();
+  Gamma_udd.ZeroClear();
+
+
+  // -----------------------------------------------------------------------------------
+  // Get K from Khat
+  //
+  K = z4c.vKhat(m,k,j,i) + 2.*z4c.vTheta(m,k,j,i);
+
+  // -----------------------------------------------------------------------------------
+  // Inverse metric
+
+  detg = adm::SpatialDet(z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i),
+                            z4c.g_dd(m,0,2,k,j,i), z4c.g_dd(m,1,1,k,j,i),
+                            z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i));
+  adm::SpatialInv(1.0/detg,
+             z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i), z4c.g_dd(m,0,2,k,j,i),
+             z4c.g_dd(m,1,1,k,j,i), z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i),
+             &g_uu(0,0), &g_uu(0,1), &g_uu(0,2),
+             &g_uu(1,1), &g_uu(1,2), &g_uu(2,2));
+
+  // -----------------------------------------------------------------------------------
+  // Christoffel symbols
+
+  for(int c = 0; c < 3; ++c)
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    Gamma_ddd(c,a,b) = 0.5*(dg_ddd(a,b,c) + dg_ddd(b,a,c) - dg_ddd(c,a,b));
+  }
+  for(int c = 0; c < 3; ++c)
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b)
+  for(int d = 0; d < 3; ++d) {
+    Gamma_udd(c,a,b) += g_uu(c,d)*Gamma_ddd(d,a,b);
+  }
+  // Gamma's computed from the conformal metric (not evolved)
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b)
+  for(int c = 0; c < 3; ++c) {
+    Gamma_u(a) += g_uu(b,c)*Gamma_udd(a,b,c);
+  }
+
+  // -----------------------------------------------------------------------------------
+  // Curvature of conformal metric
+  //
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
     for(int c = 0; c < 3; ++c) {
-      dg_ddd(c,a,b) = Dx<NGHOST>(c, idx, z4c.g_dd, m,a,b,k,j,i);
-    }
-
-    // -----------------------------------------------------------------------------------
-    // 2nd derivatives
-    //
-    // Scalars
-    for(int a = 0; a < 3; ++a) {
-      ddalpha_dd(a,a) = Dxx<NGHOST>(a, idx, z4c.alpha, m,k,j,i);
-      ddchi_dd(a,a) = Dxx<NGHOST>(a, idx, z4c.chi,   m,k,j,i);
-
-      for(int b = a + 1; b < 3; ++b) {
-        ddalpha_dd(a,b) = Dxy<NGHOST>(a, b, idx, z4c.alpha, m,k,j,i);
-        ddchi_dd(a,b) = Dxy<NGHOST>(a, b, idx, z4c.chi,   m,k,j,i);
-      }
+      R_dd(a,b) += 0.5*(z4c.g_dd(m,c,a,k,j,i)*dGam_du(b,c) +
+                        z4c.g_dd(m,c,b,k,j,i)*dGam_du(a,c) +
+                        Gamma_u(c)*(Gamma_ddd(a,b,c) + Gamma_ddd(b,a,c)));
     }
-
-    // Vectors
     for(int c = 0; c < 3; ++c)
-    for(int a = 0; a < 3; ++a) {
-      ddbeta_ddu(a,a,c) = Dxx<NGHOST>(a, idx, z4c.beta_u, m,c,k,j,i);
-      for(int b = a + 1; b < 3; ++b) {
-        ddbeta_ddu(a,b,c) = Dxy<NGHOST>(a, b, idx, z4c.beta_u, m,c,k,j,i);
-      }
+    for(int d = 0; d < 3; ++d) {
+      R_dd(a,b) -= 0.5*g_uu(c,d)*ddg_dddd(c,d,a,b);
     }
-
-    // Tensors
     for(int c = 0; c < 3; ++c)
-    for(int d = c; d < 3; ++d)
-    for(int a = 0; a < 3; ++a) {
-      ddg_dddd(a,a,c,d) = Dxx<NGHOST>(a, idx, z4c.g_dd, m,c,d,k,j,i);
-      for(int b = a + 1; b < 3; ++b) {
-        ddg_dddd(a,b,c,d) = Dxy<NGHOST>(a, b, idx, z4c.g_dd, m,c,d,k,j,i);
-      }
+    for(int d = 0; d < 3; ++d)
+    for(int e = 0; e < 3; ++e) {
+      R_dd(a,b) += g_uu(c,d)*(
+          Gamma_udd(e,c,a)*Gamma_ddd(b,e,d) +
+          Gamma_udd(e,c,b)*Gamma_ddd(a,e,d) +
+          Gamma_udd(e,a,d)*Gamma_ddd(e,c,b));
     }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Advective derivatives
-    //
-
-    //
-    // Scalars
-    for(int a = 0; a < 3; ++a) {
-      Lalpha += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.alpha, m,a,k,j,i);
-      Lchi   += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.chi,   m,a,k,j,i);
-      LKhat  += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.vKhat,  m,a,k,j,i);
-      LTheta += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.vTheta, m,a,k,j,i);
-    }
-
-    //
-    // Vectors
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      Lbeta_u(b) += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.beta_u, m,a,b,k,j,i);
-      LGam_u(b)  += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.vGam_u,  m,a,b,k,j,i);
-    }
-
-    //
-    // Tensors
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
+  // -----------------------------------------------------------------------------------
+  // Derivatives of conformal factor phi
+  //
+  chi_guarded = (z4c.chi(m,k,j,i)>opt.chi_div_floor)
+                  ? z4c.chi(m,k,j,i) : opt.chi_div_floor;
+  oopsi4 = pow(chi_guarded, -4./opt.chi_psi_power);
+  for(int a = 0; a < 3; ++a) {
+    dphi_d(a) = dchi_d(a)/(chi_guarded * opt.chi_psi_power);
+  }
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    Ddphi_dd(a,b) = ddchi_dd(a,b)/(chi_guarded * opt.chi_psi_power) -
+      opt.chi_psi_power * dphi_d(a) * dphi_d(b);
     for(int c = 0; c < 3; ++c) {
-      Lg_dd(a,b) += Lx<NGHOST>(c, idx, z4c.beta_u, z4c.g_dd, m,c,a,b,k,j,i);
-      LA_dd(a,b) += Lx<NGHOST>(c, idx, z4c.beta_u, z4c.vA_dd, m,c,a,b,k,j,i);
+      Ddphi_dd(a,b) -= Gamma_udd(c,a,b)*dphi_d(c);
     }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Get K from Khat
-    //
-    K = z4c.vKhat(m,k,j,i) + 2.*z4c.vTheta(m,k,j,i);
-
-    // -----------------------------------------------------------------------------------
-    // Inverse metric
-
-    detg = adm::SpatialDet(z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i),
-                              z4c.g_dd(m,0,2,k,j,i), z4c.g_dd(m,1,1,k,j,i),
-                              z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i));
-    adm::SpatialInv(1.0/detg,
-               z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i), z4c.g_dd(m,0,2,k,j,i),
-               z4c.g_dd(m,1,1,k,j,i), z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i),
-               &g_uu(0,0), &g_uu(0,1), &g_uu(0,2),
-               &g_uu(1,1), &g_uu(1,2), &g_uu(2,2));
-
-    // -----------------------------------------------------------------------------------
-    // Christoffel symbols
-
-    for(int c = 0; c < 3; ++c)
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      Gamma_ddd(c,a,b) = 0.5*(dg_ddd(a,b,c) + dg_ddd(b,a,c) - dg_ddd(c,a,b));
-    }
+  // -----------------------------------------------------------------------------------
+  // Curvature contribution from conformal factor
+  //
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    Rphi_dd(a,b) = 4.*dphi_d(a)*dphi_d(b) - 2.*Ddphi_dd(a,b);
     for(int c = 0; c < 3; ++c)
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
     for(int d = 0; d < 3; ++d) {
-      Gamma_udd(c,a,b) += g_uu(c,d)*Gamma_ddd(d,a,b);
-    }
-    // Gamma's computed from the conformal metric (not evolved)
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b)
-    for(int c = 0; c < 3; ++c) {
-      Gamma_u(a) += g_uu(b,c)*Gamma_udd(a,b,c);
+      Rphi_dd(a,b) -= 2.*z4c.g_dd(m,a,b,k,j,i) * g_uu(c,d)*(Ddphi_dd(c,d) +
+          2.*dphi_d(c)*dphi_d(d));
     }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Curvature of conformal metric
-    //
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      for(int c = 0; c < 3; ++c) {
-        R_dd(a,b) += 0.5*(z4c.g_dd(m,c,a,k,j,i)*dGam_du(b,c) +
-                          z4c.g_dd(m,c,b,k,j,i)*dGam_du(a,c) +
-                          Gamma_u(c)*(Gamma_ddd(a,b,c) + Gamma_ddd(b,a,c)));
-      }
-      for(int c = 0; c < 3; ++c)
+  // TODO(JMF): Update with Tmunu terms.
+  // -----------------------------------------------------------------------------------
+  // Trace of the matter stress tensor
+  //
+  // Matter commented out
+  //S.ZeroClear();
+  //member.team_barrier();
+  //for(int a = 0; a < 3; ++a)
+  //for(int b = 0; b < 3; ++b) {
+  //  ILOOP1(1) {
+  //    S(1) += oopsi4(1) * g_uu(a,b,i) * mat.S_dd(m,a,b,k,j,i);
+  //  }
+  //}
+  if(!is_vacuum) {
+    for (int a = 0; a < 3; ++a)
+    for (int b = 0; b < 3; ++b) {
+      S += oopsi4 * g_uu(a,b) * tmunu.S_dd(m,a,b,k,j,i);
+    }
+  }
+
+  // -----------------------------------------------------------------------------------
+  // 2nd covariant derivative of the lapse
+  // TODO(JMF): This could potentially be sped up by calculating d_i phi d^i alpha
+  // beforehand.
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    Ddalpha_dd(a,b) = ddalpha_dd(a,b)
+                     - 2.*(dphi_d(a)*dalpha_d(b) + dphi_d(b)*dalpha_d(a));
+    for(int c = 0; c < 3; ++c) {
+      Ddalpha_dd(a,b) -= Gamma_udd(c,a,b)*dalpha_d(c);
       for(int d = 0; d < 3; ++d) {
-        R_dd(a,b) -= 0.5*g_uu(c,d)*ddg_dddd(c,d,a,b);
-      }
-      for(int c = 0; c < 3; ++c)
-      for(int d = 0; d < 3; ++d)
-      for(int e = 0; e < 3; ++e) {
-        R_dd(a,b) += g_uu(c,d)*(
-            Gamma_udd(e,c,a)*Gamma_ddd(b,e,d) +
-            Gamma_udd(e,c,b)*Gamma_ddd(a,e,d) +
-            Gamma_udd(e,a,d)*Gamma_ddd(e,c,b));
+          Ddalpha_dd(a,b) += 2.*z4c.g_dd(m,a,b,k,j,i) * g_uu(c,d)
+          * dphi_d(c) * dalpha_d(d);
       }
     }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Derivatives of conformal factor phi
-    //
-    chi_guarded = (z4c.chi(m,k,j,i)>opt.chi_div_floor)
-                    ? z4c.chi(m,k,j,i) : opt.chi_div_floor;
-    oopsi4 = pow(chi_guarded, -4./opt.chi_psi_power);
-    for(int a = 0; a < 3; ++a) {
-      dphi_d(a) = dchi_d(a)/(chi_guarded * opt.chi_psi_power);
-    }
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      Ddphi_dd(a,b) = ddchi_dd(a,b)/(chi_guarded * opt.chi_psi_power) -
-        opt.chi_psi_power * dphi_d(a) * dphi_d(b);
-      for(int c = 0; c < 3; ++c) {
-        Ddphi_dd(a,b) -= Gamma_udd(c,a,b)*dphi_d(c);
-      }
-    }
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    Ddalpha += oopsi4 * g_uu(a,b) * Ddalpha_dd(a,b);
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Curvature contribution from conformal factor
-    //
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      Rphi_dd(a,b) = 4.*dphi_d(a)*dphi_d(b) - 2.*Ddphi_dd(a,b);
-      for(int c = 0; c < 3; ++c)
-      for(int d = 0; d < 3; ++d) {
-        Rphi_dd(a,b) -= 2.*z4c.g_dd(m,a,b,k,j,i) * g_uu(c,d)*(Ddphi_dd(c,d) +
-            2.*dphi_d(c)*dphi_d(d));
-      }
+  // -----------------------------------------------------------------------------------
+  // Contractions of A_ab, inverse, and derivatives
+  //
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b)
+  for(int c = 0; c < 3; ++c)
+  for(int d = 0; d < 3; ++d) {
+    AA_dd(a,b) += g_uu(c,d) * z4c.vA_dd(m,a,c,k,j,i) * z4c.vA_dd(m,d,b,k,j,i);
+  }
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    AA += g_uu(a,b) * AA_dd(a,b);
+  }
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b)
+  for(int c = 0; c < 3; ++c)
+  for(int d = 0; d < 3; ++d) {
+    A_uu(a,b) += g_uu(a,c) * g_uu(b,d) * z4c.vA_dd(m,c,d,k,j,i);
+  }
+  // TODO(JMF): dchi_d/chi_guarded is opt.chi_psi_power * dphi_d.
+  for(int a = 0; a < 3; ++a) {
+    for(int b = 0; b < 3; ++b) {
+        DA_u(a) -= (3./2.) * A_uu(a,b) * dchi_d(b) / chi_guarded;
+        DA_u(a) -= (1./3.) * g_uu(a,b) * (2.*dKhat_d(b) + dTheta_d(b));
     }
-
-    // TODO(JMF): Update with Tmunu terms.
-    // -----------------------------------------------------------------------------------
-    // Trace of the matter stress tensor
-    //
-    // Matter commented out
-    //S.ZeroClear();
-    //member.team_barrier();
-    //for(int a = 0; a < 3; ++a)
-    //for(int b = 0; b < 3; ++b) {
-    //  ILOOP1(1) {
-    //    S(1) += oopsi4(1) * g_uu(a,b,i) * mat.S_dd(m,a,b,k,j,i);
-    //  }
-    //}
-    if(!is_vacuum) {
-      for (int a = 0; a < 3; ++a)
-      for (int b = 0; b < 3; ++b) {
-        S += oopsi4 * g_uu(a,b) * tmunu.S_dd(m,a,b,k,j,i);
-      }
+    for(int b = 0; b < 3; ++b)
+    for(int c = 0; c < 3; ++c) {
+      DA_u(a) += Gamma_udd(a,b,c) * A_uu(b,c);
     }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // 2nd covariant derivative of the lapse
-    // TODO(JMF): This could potentially be sped up by calculating d_i phi d^i alpha
-    // beforehand.
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      Ddalpha_dd(a,b) = ddalpha_dd(a,b)
-                       - 2.*(dphi_d(a)*dalpha_d(b) + dphi_d(b)*dalpha_d(a));
-      for(int c = 0; c < 3; ++c) {
-        Ddalpha_dd(a,b) -= Gamma_udd(c,a,b)*dalpha_d(c);
-        for(int d = 0; d < 3; ++d) {
-            Ddalpha_dd(a,b) += 2.*z4c.g_dd(m,a,b,k,j,i) * g_uu(c,d)
-            * dphi_d(c) * dalpha_d(d);
-        }
-      }
-    }
+  // -----------------------------------------------------------------------------------
+  // Ricci scalar
+  //
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    R += oopsi4 * g_uu(a,b) * (R_dd(a,b) + Rphi_dd(a,b));
+  }
 
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      Ddalpha += oopsi4 * g_uu(a,b) * Ddalpha_dd(a,b);
-    }
+  // -----------------------------------------------------------------------------------
+  // Hamiltonian constraint
+  //
+  Ht = R + (2./3.)*SQR(K) - AA;// - 16.*M_PI*tmunu.E(m,k,j,i);
 
-    // -----------------------------------------------------------------------------------
-    // Contractions of A_ab, inverse, and derivatives
-    //
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
-    for(int c = 0; c < 3; ++c)
-    for(int d = 0; d < 3; ++d) {
-      AA_dd(a,b) += g_uu(c,d) * z4c.vA_dd(m,a,c,k,j,i) * z4c.vA_dd(m,d,b,k,j,i);
-    }
-    for(int a = 0; a < 3; ++a)
+  // -----------------------------------------------------------------------------------
+  // Finalize advective (Lie) derivatives
+  //
+  // Shift vector contractions
+  for(int a = 0; a < 3; ++a) {
+    dbeta += dbeta_du(a,a);
+  }
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    ddbeta_d(a) += (1./3.) * ddbeta_ddu(a,b,b);
+  }
+
+  // Finalize Lchi
+  Lchi += (1./6.) * opt.chi_psi_power * chi_guarded * dbeta;
+
+  // Finalize LGam_u (note that this is not a real Lie derivative)
+  for(int a = 0; a < 3; ++a) {
+    LGam_u(a) += (2./3.) * Gamma_u(a) * dbeta;
     for(int b = 0; b < 3; ++b) {
-      AA += g_uu(a,b) * AA_dd(a,b);
-    }
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
-    for(int c = 0; c < 3; ++c)
-    for(int d = 0; d < 3; ++d) {
-      A_uu(a,b) += g_uu(a,c) * g_uu(b,d) * z4c.vA_dd(m,c,d,k,j,i);
-    }
-    // TODO(JMF): dchi_d/chi_guarded is opt.chi_psi_power * dphi_d.
-    for(int a = 0; a < 3; ++a) {
-      for(int b = 0; b < 3; ++b) {
-          DA_u(a) -= (3./2.) * A_uu(a,b) * dchi_d(b) / chi_guarded;
-          DA_u(a) -= (1./3.) * g_uu(a,b) * (2.*dKhat_d(b) + dTheta_d(b));
-      }
-      for(int b = 0; b < 3; ++b)
+      LGam_u(a) += g_uu(a,b) * ddbeta_d(b) - Gamma_u(b) * dbeta_du(b,a);
       for(int c = 0; c < 3; ++c) {
-        DA_u(a) += Gamma_udd(a,b,c) * A_uu(b,c);
+        LGam_u(a) += g_uu(b,c) * ddbeta_ddu(b,c,a);
       }
     }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Ricci scalar
-    //
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      R += oopsi4 * g_uu(a,b) * (R_dd(a,b) + Rphi_dd(a,b));
-    }
-
-    // -----------------------------------------------------------------------------------
-    // Hamiltonian constraint
-    //
-    Ht = R + (2./3.)*SQR(K) - AA;// - 16.*M_PI*tmunu.E(m,k,j,i);
-
-    // -----------------------------------------------------------------------------------
-    // Finalize advective (Lie) derivatives
-    //
-    // Shift vector contractions
-    for(int a = 0; a < 3; ++a) {
-      dbeta += dbeta_du(a,a);
-    }
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      ddbeta_d(a) += (1./3.) * ddbeta_ddu(a,b,b);
+  // Finalize Lg_dd and LA_dd
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    Lg_dd(a,b) -= (2./3.) * z4c.g_dd(m,a,b,k,j,i) * dbeta;
+    for(int c = 0; c < 3; ++c) {
+      Lg_dd(a,b) += dbeta_du(a,c) * z4c.g_dd(m,b,c,k,j,i);
+      Lg_dd(a,b) += dbeta_du(b,c) * z4c.g_dd(m,a,c,k,j,i);
     }
-
-    // Finalize Lchi
-    Lchi += (1./6.) * opt.chi_psi_power * chi_guarded * dbeta;
-
-    // Finalize LGam_u (note that this is not a real Lie derivative)
-    for(int a = 0; a < 3; ++a) {
-      LGam_u(a) += (2./3.) * Gamma_u(a) * dbeta;
-      for(int b = 0; b < 3; ++b) {
-        LGam_u(a) += g_uu(a,b) * ddbeta_d(b) - Gamma_u(b) * dbeta_du(b,a);
-        for(int c = 0; c < 3; ++c) {
-          LGam_u(a) += g_uu(b,c) * ddbeta_ddu(b,c,a);
-        }
-      }
+  }
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    LA_dd(a,b) -= (2./3.) * z4c.vA_dd(m,a,b,k,j,i) * dbeta;
+    for(int c = 0; c < 3; ++c) {
+      LA_dd(a,b) += dbeta_du(b,c) * z4c.vA_dd(m,a,c,k,j,i);
+      LA_dd(a,b) += dbeta_du(a,c) * z4c.vA_dd(m,b,c,k,j,i);
     }
+  }
 
-    // Finalize Lg_dd and LA_dd
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      Lg_dd(a,b) -= (2./3.) * z4c.g_dd(m,a,b,k,j,i) * dbeta;
-      for(int c = 0; c < 3; ++c) {
-        Lg_dd(a,b) += dbeta_du(a,c) * z4c.g_dd(m,b,c,k,j,i);
-        Lg_dd(a,b) += dbeta_du(b,c) * z4c.g_dd(m,a,c,k,j,i);
-      }
-    }
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      LA_dd(a,b) -= (2./3.) * z4c.vA_dd(m,a,b,k,j,i) * dbeta;
-      for(int c = 0; c < 3; ++c) {
-        LA_dd(a,b) += dbeta_du(b,c) * z4c.vA_dd(m,a,c,k,j,i);
-        LA_dd(a,b) += dbeta_du(a,c) * z4c.vA_dd(m,b,c,k,j,i);
+  // -----------------------------------------------------------------------------------
+  // Assemble RHS
+  //
+  // Khat, chi, and Theta
+  rhs.vKhat(m,k,j,i) = - Ddalpha + z4c.alpha(m,k,j,i)
+    * (AA + (1./3.)*SQR(K)) +
+    LKhat + opt.damp_kappa1*(1 - opt.damp_kappa2)
+    * z4c.alpha(m,k,j,i) * z4c.vTheta(m,k,j,i);
+  // Matter term
+  if(!is_vacuum) {
+    rhs.vKhat(m,k,j,i) += 4.*M_PI * z4c.alpha(m,k,j,i) * (S + tmunu.E(m,k,j,i));
+  }
+  rhs.chi(m,k,j,i) = Lchi - (1./6.) * opt.chi_psi_power *
+    chi_guarded * z4c.alpha(m,k,j,i) * K;
+  rhs.vTheta(m,k,j,i) = LTheta + z4c.alpha(m,k,j,i) * (
+      0.5*Ht - (2. + opt.damp_kappa2) * opt.damp_kappa1 * z4c.vTheta(m,k,j,i));
+  // Matter term
+  if(!is_vacuum) {
+    rhs.vTheta(m,k,j,i) -= 8.*M_PI * z4c.alpha(m,k,j,i) * tmunu.E(m,k,j,i);
+  }
+  // If BSSN is enabled, theta is disabled.
+  rhs.vTheta(m,k,j,i) *= opt.use_z4c;
+  // Gamma's
+  for(int a = 0; a < 3; ++a) {
+    rhs.vGam_u(m,a,k,j,i) = 2.*z4c.alpha(m,k,j,i)*DA_u(a) + LGam_u(a);
+    rhs.vGam_u(m,a,k,j,i) -= 2.*z4c.alpha(m,k,j,i) * opt.damp_kappa1 *
+        (z4c.vGam_u(m,a,k,j,i) - Gamma_u(a));
+    for(int b = 0; b < 3; ++b) {
+      rhs.vGam_u(m,a,k,j,i) -= 2. * A_uu(a,b) * dalpha_d(b);
+      // Matter term
+      if(!is_vacuum) {
+        rhs.vGam_u(m,a,k,j,i) -= 16.*M_PI * z4c.alpha(m,k,j,i)
+                            * g_uu(a,b) * tmunu.S_d(m,b,k,j,i);
       }
     }
-
-    // -----------------------------------------------------------------------------------
-    // Assemble RHS
-    //
-    // Khat, chi, and Theta
-    rhs.vKhat(m,k,j,i) = - Ddalpha + z4c.alpha(m,k,j,i)
-      * (AA + (1./3.)*SQR(K)) +
-      LKhat + opt.damp_kappa1*(1 - opt.damp_kappa2)
-      * z4c.alpha(m,k,j,i) * z4c.vTheta(m,k,j,i);
-    // Matter term
-    if(!is_vacuum) {
-      rhs.vKhat(m,k,j,i) += 4.*M_PI * z4c.alpha(m,k,j,i) * (S + tmunu.E(m,k,j,i));
-    }
-    rhs.chi(m,k,j,i) = Lchi - (1./6.) * opt.chi_psi_power *
-      chi_guarded * z4c.alpha(m,k,j,i) * K;
-    rhs.vTheta(m,k,j,i) = LTheta + z4c.alpha(m,k,j,i) * (
-        0.5*Ht - (2. + opt.damp_kappa2) * opt.damp_kappa1 * z4c.vTheta(m,k,j,i));
+  }
+
+  // g and A
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    rhs.g_dd(m,a,b,k,j,i) = - 2. * z4c.alpha(m,k,j,i) * z4c.vA_dd(m,a,b,k,j,i)
+                    + Lg_dd(a,b);
+    rhs.vA_dd(m,a,b,k,j,i) = oopsi4 *
+        (-Ddalpha_dd(a,b) + z4c.alpha(m,k,j,i) * (R_dd(a,b) + Rphi_dd(a,b)));
+    rhs.vA_dd(m,a,b,k,j,i) -= (1./3.) * z4c.g_dd(m,a,b,k,j,i)
+                           * (-Ddalpha + z4c.alpha(m,k,j,i)*R);
+    rhs.vA_dd(m,a,b,k,j,i) += z4c.alpha(m,k,j,i) * (K*z4c.vA_dd(m,a,b,k,j,i)
+                           - 2.*AA_dd(a,b));
+    rhs.vA_dd(m,a,b,k,j,i) += LA_dd(a,b);
     // Matter term
     if(!is_vacuum) {
-      rhs.vTheta(m,k,j,i) -= 8.*M_PI * z4c.alpha(m,k,j,i) * tmunu.E(m,k,j,i);
+      rhs.vA_dd(m,a,b,k,j,i) -= 8.*M_PI * z4c.alpha(m,k,j,i) *
+              (oopsi4*tmunu.S_dd(m,a,b,k,j,i) - (1./3.)*S*z4c.g_dd(m,a,b,k,j,i));
+    }
+  }
+  // lapse function
+  Real const f = opt.lapse_oplog * opt.lapse_harmonicf
+               + opt.lapse_harmonic * z4c.alpha(m,k,j,i);
+  rhs.alpha(m,k,j,i) = opt.lapse_advect * Lalpha
+                     - f * z4c.alpha(m,k,j,i) * z4c.vKhat(m,k,j,i);
+
+  // shift vector
+  for(int a = 0; a < 3; ++a) {
+    rhs.beta_u(m,a,k,j,i) = opt.shift_ggamma * z4c.vGam_u(m,a,k,j,i)
+                          + opt.shift_advect * Lbeta_u(a);
+    rhs.beta_u(m,a,k,j,i) -= opt.shift_eta * z4c.beta_u(m,a,k,j,i);
+    // FORCE beta = 0
+    //rhs.beta_u(m,a,k,j,i) = 0;
+  }
+
+  // harmonic gauge terms
+  for(int a = 0; a < 3; ++a) {
+    rhs.beta_u(m,a,k,j,i) += opt.shift_alpha2ggamma *
+                        SQR(z4c.alpha(m,k,j,i)) * z4c.vGam_u(m,a,k,j,i);
+    for(int b = 0; b < 3; ++b) {
+      rhs.beta_u(m,a,k,j,i) += opt.shift_hh * z4c.alpha(m,k,j,i) *
+        chi_guarded * (0.5 * z4c.alpha(m,k,j,i) * dchi_d(b) - dalpha_d(b)) * g_uu(a,b);
     }
-    // If BSSN is enabled, theta is disabled.
-    rhs.vTheta(m,k,j,i) *= opt.use_z4c;
-    // Gamma's
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void AddDissipation()
+//! \brief adds Kreiss-Oliger dissipation of every Z4c variable in u (either u0 or a tile
+//! of it) to u_rhs at one point, so that it is computed in the same pass as the RHS
+
+template <int NGHOST, typename TYPE>
+KOKKOS_INLINE_FUNCTION
+void AddDissipation(const TYPE &u, const DvceArray5D<Real> &u_rhs, const Real idx[],
+                    const Real diss, const int m, const int k, const int j, const int i) {
+  for (int n = 0; n < Z4c::nz4c; ++n) {
+    Real r = u_rhs(m,n,k,j,i);
     for(int a = 0; a < 3; ++a) {
-      rhs.vGam_u(m,a,k,j,i) = 2.*z4c.alpha(m,k,j,i)*DA_u(a) + LGam_u(a);
-      rhs.vGam_u(m,a,k,j,i) -= 2.*z4c.alpha(m,k,j,i) * opt.damp_kappa1 *
-          (z4c.vGam_u(m,a,k,j,i) - Gamma_u(a));
-      for(int b = 0; b < 3; ++b) {
-        rhs.vGam_u(m,a,k,j,i) -= 2. * A_uu(a,b) * dalpha_d(b);
-        // Matter term
-        if(!is_vacuum) {
-          rhs.vGam_u(m,a,k,j,i) -= 16.*M_PI * z4c.alpha(m,k,j,i)
-                              * g_uu(a,b) * tmunu.S_d(m,b,k,j,i);
-        }
-      }
+      r += Diss<NGHOST>(a, idx, u, m, n, k, j, i)*diss;
     }
+    u_rhs(m,n,k,j,i) = r;
+  }
+}
+} // end anonymous namespace
 
-    // g and A
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      rhs.g_dd(m,a,b,k,j,i) = - 2. * z4c.alpha(m,k,j,i) * z4c.vA_dd(m,a,b,k,j,i)
-                      + Lg_dd(a,b);
-      rhs.vA_dd(m,a,b,k,j,i) = oopsi4 *
-          (-Ddalpha_dd(a,b) + z4c.alpha(m,k,j,i) * (R_dd(a,b) + Rphi_dd(a,b)));
-      rhs.vA_dd(m,a,b,k,j,i) -= (1./3.) * z4c.g_dd(m,a,b,k,j,i)
-                             * (-Ddalpha + z4c.alpha(m,k,j,i)*R);
-      rhs.vA_dd(m,a,b,k,j,i) += z4c.alpha(m,k,j,i) * (K*z4c.vA_dd(m,a,b,k,j,i)
-                             - 2.*AA_dd(a,b));
-      rhs.vA_dd(m,a,b,k,j,i) += LA_dd(a,b);
-      // Matter term
-      if(!is_vacuum) {
-        rhs.vA_dd(m,a,b,k,j,i) -= 8.*M_PI * z4c.alpha(m,k,j,i) *
-                (oopsi4*tmunu.S_dd(m,a,b,k,j,i) - (1./3.)*S*z4c.g_dd(m,a,b,k,j,i));
-      }
-    }
-    // lapse function
-    Real const f = opt.lapse_oplog * opt.lapse_harmonicf
-                 + opt.lapse_harmonic * z4c.alpha(m,k,j,i);
-    rhs.alpha(m,k,j,i) = opt.lapse_advect * Lalpha
-                       - f * z4c.alpha(m,k,j,i) * z4c.vKhat(m,k,j,i);
+template <int NGHOST>
+//! \fn void Z4c::CalcRHS(Driver *pdriver, int stage)
+//! \brief compute rhs of the z4c equations.  With <z4c>/split_rhs=true the derivatives
+//! are first computed and stored in u_drv by one kernel, then the algebraic RHS is
+//! evaluated from them by a second, lighter kernel, in chunks of at most split_rhs_nmb
+//! MeshBlocks.  Otherwise both are done in a single kernel.  With <z4c>/rhs_tile > 0 the
+//! derivatives are evaluated from cubic tiles of that edge loaded into scratch memory.
+TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &size = pmy_pack->pmb->mb_size;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
 
-    // shift vector
-    for(int a = 0; a < 3; ++a) {
-      rhs.beta_u(m,a,k,j,i) = opt.shift_ggamma * z4c.vGam_u(m,a,k,j,i)
-                            + opt.shift_advect * Lbeta_u(a);
-      rhs.beta_u(m,a,k,j,i) -= opt.shift_eta * z4c.beta_u(m,a,k,j,i);
-      // FORCE beta = 0
-      //rhs.beta_u(m,a,k,j,i) = 0;
-    }
+  int nmb = pmy_pack->nmb_thispack;
 
-    // harmonic gauge terms
-    for(int a = 0; a < 3; ++a) {
-      rhs.beta_u(m,a,k,j,i) += opt.shift_alpha2ggamma *
-                          SQR(z4c.alpha(m,k,j,i)) * z4c.vGam_u(m,a,k,j,i);
-      for(int b = 0; b < 3; ++b) {
-        rhs.beta_u(m,a,k,j,i) += opt.shift_hh * z4c.alpha(m,k,j,i) *
-          chi_guarded * (0.5 * z4c.alpha(m,k,j,i) * dchi_d(b) - dalpha_d(b)) * g_uu(a,b);
-      }
-    }
-  });
+  auto &z4c = pmy_pack->pz4c->z4c;
+  auto &rhs = pmy_pack->pz4c->rhs;
+  auto &opt = pmy_pack->pz4c->opt;
+
+  bool is_vacuum = (pmy_pack->ptmunu == nullptr) ? true : false;
+  Tmunu::Tmunu_vars tmunu;
+  if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
 
   // ===================================================================================
-  // Add dissipation for stability
+  // Main RHS calculation
   //
-  Real &diss = pmy_pack->pz4c->diss;
+  const bool split = opt.split_rhs;
+  const int nchunk = (split)? u_drv.extent_int(0) : nmb;
+  auto &drv = u_drv;
   auto &u0 = pmy_pack->pz4c->u0;
   auto &u_rhs = pmy_pack->pz4c->u_rhs;
-  par_for("K-O Dissipation",
-  DevExeSpace(),0,nmb-1,0,nz4c-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
-    Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
-    for(int a = 0; a < 3; ++a) {
-      u_rhs(m,n,k,j,i) += Diss<NGHOST>(a, idx, u0, m, n, k, j, i)*diss;
-    }
-  });
+  // Kreiss-Oliger dissipation for stability is added in the pass that evaluates the
+  // algebraic RHS, reusing the stencil of u0 loaded for the derivatives when possible
+  Real &diss = pmy_pack->pz4c->diss;
+
+  // estimated work per cell for roofline analysis: each derivative is a centred stencil
+  // of 2*NGHOST+1 points, the algebraic RHS ~2000 flops, and each u0, u_rhs and u_drv
+  // value (plus Tmunu with matter) is loaded or stored once
+  constexpr Real stencil_flops = 2.0*(2*NGHOST + 1);
+  const Real drv_flops = nrhs_derivs*stencil_flops;
+  const Real alg_flops = 2000.0 + 3.0*nz4c*stencil_flops;
+  const Real u_bytes = (2.0*nz4c + ((is_vacuum)? 0.0 : 10.0))*sizeof(Real);
+  const Real drv_bytes = nrhs_derivs*sizeof(Real);
+  for (int m0 = 0; m0 < nmb; m0 += nchunk) {
+    int m1 = std::min(nmb, m0 + nchunk) - 1;
+    Real ncells = static_cast<Real>(m1 - m0 + 1)*indcs.nx1*indcs.nx2*indcs.nx3;
+    if (opt.rhs_tile > 0) {
+      // derivatives evaluated from tiles of u0 loaded into scratch memory, see
+      // utils/fd_tile.hpp.  Each team handles one tile of a MeshBlock.
+      const int tile = opt.rhs_tile;
+      const int nt = tile + 2*NGHOST;
+      const int ntk = (ke - ks + tile)/tile;
+      const int ntj = (je - js + tile)/tile;
+      const int nti = (ie - is + tile)/tile;
+      size_t scr_size = fd_tile::ScratchSize(nz4c, tile, NGHOST);
+      int scr_level = opt.rhs_tile_scr_level;
+      if (split) {
+        roofline::AddWork("z4c rhs tiled", ncells, nz4c*sizeof(Real) + drv_bytes,
+                          drv_flops);
+      } else {
+        roofline::AddWork("z4c rhs tiled", ncells, u_bytes, drv_flops + alg_flops);
+      }
+      par_for_outer("z4c rhs tiled",DevExeSpace(),scr_size,scr_level,m0,m1,0,(ntk-1),
+                    0,(ntj-1),0,(nti-1),
+      KOKKOS_LAMBDA(TeamMember_t member, const int m, const int tk, const int tj,
+                    const int ti) {
+        ScrArray1D<Real> scr(member.team_scratch(scr_level), nz4c*nt*nt*nt);
+        const int kl = ks + tk*tile, jl = js + tj*tile, il = is + ti*tile;
+        FDTile t = fd_tile::Load(member, u0, m, 0, nz4c, kl-NGHOST, jl-NGHOST,
+                                 il-NGHOST, nt, scr);
+        member.team_barrier();
+        Z4cTileVars tv(t);
+        const int nk = (kl + tile <= ke+1)? tile : ke + 1 - kl;
+        const int nj = (jl + tile <= je+1)? tile : je + 1 - jl;
+        const int ni = (il + tile <= ie+1)? tile : ie + 1 - il;
+        Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
+        Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nk*nj*ni), [&](const int c) {
+          const int k = kl + c/(nj*ni);
+          const int j = jl + (c/ni)%nj;
+          const int i = il + c%ni;
+          RHSDerivatives d;
+          CalcDerivatives<NGHOST>(tv, idx, m, k, j, i, d);
+          if (split) {
+            int n = 0;
+            ForEachDerivative(d, [&](Real &x) {drv(m-m0,n++,k,j,i) = x;});
+          } else {
+            CalcAlgebraicRHS(z4c, rhs, opt, is_vacuum, tmunu, d, m, k, j, i);
+            AddDissipation<NGHOST>(t, u_rhs, idx, diss, m, k, j, i);
+          }
+        });
+      });
+    } else if (split) {
+      roofline::AddWork("z4c rhs derivs", ncells, nz4c*sizeof(Real) + drv_bytes,
+                        drv_flops);
+      par_for("z4c rhs derivs",DevExeSpace(),m0,m1,ks,ke,js,je,is,ie,
+      KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+        Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
+        RHSDerivatives d;
+        CalcDerivatives<NGHOST>(z4c, idx, m, k, j, i, d);
+        int n = 0;
+        ForEachDerivative(d, [&](Real &x) {drv(m-m0,n++,k,j,i) = x;});
+      });
+    } else {
+      roofline::AddWork("z4c rhs loop", ncells, u_bytes, drv_flops + alg_flops);
+      par_for("z4c rhs loop",DevExeSpace(),m0,m1,ks,ke,js,je,is,ie,
+      KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+        Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
+        RHSDerivatives d;
+        CalcDerivatives<NGHOST>(z4c, idx, m, k, j, i, d);
+        CalcAlgebraicRHS(z4c, rhs, opt, is_vacuum, tmunu, d, m, k, j, i);
+        AddDissipation<NGHOST>(u0, u_rhs, idx, diss, m, k, j, i);
+      });
+    }
+    if (split) {
+      roofline::AddWork("z4c rhs algebra", ncells, u_bytes + drv_bytes, alg_flops);
+      par_for("z4c rhs algebra",DevExeSpace(),m0,m1,ks,ke,js,je,is,ie,
+      KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+        Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
+        RHSDerivatives d;
+        int n = 0;
+        ForEachDerivative(d, [&](Real &x) {x = drv(m-m0,n++,k,j,i);});
+        CalcAlgebraicRHS(z4c, rhs, opt, is_vacuum, tmunu, d, m, k, j, i);
+        AddDissipation<NGHOST>(u0, u_rhs, idx, diss, m, k, j, i);
+      });
+    }
+  }
 
   return TaskStatus::complete;
 }
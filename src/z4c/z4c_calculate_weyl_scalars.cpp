@@ -26,7 +26,12 @@ namespace z4c {
 // \!fn void Z4c::Z4cWeyl(MeshBlockPack *pmbp)
 // \brief compute the weyl scalars given the adm variables and matter state
 //
-// This function operates only on the interior points of the MeshBlock
+// This function operates only on the interior points of the MeshBlock.  With
+// <z4c>/weyl_sphere_only, only MeshBlocks whose data enters the interpolation to some
+// extraction sphere are computed: those within (2*NGHOST+1) cells of a sphere point,
+// which covers the interpolation stencil and the neighbours filling its ghost zones,
+// including across a refinement boundary.  The cost then scales with the sphere area,
+// not the volume.
 template <int NGHOST>
 void Z4c::Z4cWeyl(MeshBlockPack *pmbp) {
   // capture variables for the kernel
@@ -42,8 +47,33 @@ void Z4c::Z4cWeyl(MeshBlockPack *pmbp) {
   auto &u_weyl = pmbp->pz4c->u_weyl;
   Kokkos::deep_copy(u_weyl, 0.);
 
-  par_for("z4c_weyl_scalar",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+  // list of MeshBlocks to compute
+  DualArray1D<int> mblist("weyl_mblist", nmb);
+  int nlist = 0;
+  for (int m=0; m<nmb; ++m) {
+    bool used = !(pmbp->pz4c->opt.weyl_sphere_only);
+    Real pad = (2*NGHOST + 1)*std::max(size.h_view(m).dx1,
+                              std::max(size.h_view(m).dx2, size.h_view(m).dx3));
+    for (auto &grid : pmbp->pz4c->spherical_grids) {
+      auto &rcoord = grid->interp_coord;
+      for (int n=0; n<grid->nangles && !used; ++n) {
+        used = (rcoord.h_view(n,0) >= size.h_view(m).x1min - pad &&
+                rcoord.h_view(n,0) <= size.h_view(m).x1max + pad &&
+                rcoord.h_view(n,1) >= size.h_view(m).x2min - pad &&
+                rcoord.h_view(n,1) <= size.h_view(m).x2max + pad &&
+                rcoord.h_view(n,2) >= size.h_view(m).x3min - pad &&
+                rcoord.h_view(n,2) <= size.h_view(m).x3max + pad);
+      }
+    }
+    if (used) mblist.h_view(nlist++) = m;
+  }
+  if (nlist == 0) return;
+  mblist.template modify<HostMemSpace>();
+  mblist.template sync<DevExeSpace>();
+
+  par_for("z4c_weyl_scalar",DevExeSpace(),0,nlist-1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(const int mm, const int k, const int j, const int i) {
+    const int m = mblist.d_view(mm);
     // Simplify constants (2 & sqrt 2 factors) featured in re/im[psi4]
     const Real FR4 = 0.25;
     Real &x1min = size.d_view(m).x1min;
@@ -57,6 +57,18 @@ TaskStatus Z4c::NewTimeStep(Driver *pdriver, int stage) {
   if (pmy_pack->pmesh->multi_d) { dtnew = std::min(dtnew, dt2); }
   if (pmy_pack->pmesh->three_d) { dtnew = std::min(dtnew, dt3); }
 
+  // With adaptive dt, also limit the step by the embedded error estimate of the last
+  // step, using the standard controller dt*safety*(1/err)^(1/(p+1)) with p the order of
+  // the embedded solution and the change limited to [0.2,5].  dtnew is multiplied by
+  // cfl_no in Mesh::NewTimeStep(), so the CFL condition remains an upper bound.
+  auto &pm = pmy_pack->pmesh;
+  if (opt.adaptive_dt && dt_err > 0.0) {
+    Real p_emb = (pdriver->integrator == "rk3")? 2.0 : 1.0;
+    Real fac = opt.dt_safety*std::pow(1.0/dt_err, 1.0/(p_emb + 1.0));
+    fac = std::min(5.0, std::max(0.2, fac));
+    dtnew = std::min(dtnew, fac*(pm->dt)/(pm->cfl_no));
+  }
+
   return TaskStatus::complete;
 }
 } // namespace z4c
@@ -20,6 +20,7 @@
 #include "bvals/bvals.hpp"
 #include "z4c/compact_object_tracker.hpp"
 #include "z4c/horizon_dump.hpp"
+#include "z4c/horizon_finder.hpp"
 #include "z4c/z4c.hpp"
 #include "tasklist/numerical_relativity.hpp"
 #include "z4c/cce/cce.hpp"
@@ -67,16 +68,18 @@ void Z4c::QueueZ4cTasks() {
   pnr->QueueTask(&Z4c::Prolongate, this, Z4c_Prolong, "Z4c_Prolong", Task_Run, {Z4c_BCS});
   pnr->QueueTask(&Z4c::EnforceAlgConstr, this, Z4c_AlgC, "Z4c_AlgC", Task_Run,
                  {Z4c_Prolong});
-  pnr->QueueTask(&Z4c::ConvertZ4cToADM, this, Z4c_Z4c2ADM, "Z4c_Z4c2ADM",
-                 Task_Run, {Z4c_AlgC});
+  // ADM variables are computed in the same kernel as the algebraic constraints
   if (pmy_pack->pdyngr != nullptr) {
     pnr->QueueTask(&Z4c::UpdateExcisionMasks, this, Z4c_Excise, "Z4c_Excise", Task_Run,
-                   {Z4c_Z4c2ADM});
+                   {Z4c_AlgC});
   }
   pnr->QueueTask(&Z4c::NewTimeStep, this, Z4c_Newdt, "Z4c_Newdt", Task_Run,
-                 {Z4c_Z4c2ADM});
+                 {Z4c_AlgC});
 
   // End task list
+  // velocities of compact objects are sent at the start, and received before they are
+  // needed by the horizon tasks, so communication overlaps with the tasks in between
+  pnr->QueueTask(&Z4c::TrackCompactObjects, this, Z4c_PT, "Z4c_PT", Task_End);
   pnr->QueueTask(&Z4c::ClearSend, this, Z4c_ClearS, "Z4c_ClearS", Task_End);
   pnr->QueueTask(&Z4c::ClearRecv, this, Z4c_ClearR, "Z4c_ClearR", Task_End, {Z4c_ClearS});
   /*pnr->QueueTask(&Z4c::Z4cToADM, this, Z4c_Z4c2ADM, "Z4c_Z4c2ADM", Task_End,
@@ -96,10 +99,13 @@ void Z4c::QueueZ4cTasks() {
                  {Z4c_ClearSW});
   pnr->QueueTask(&Z4c::CalcWaveForm, this, Z4c_Wave, "Z4c_Wave", Task_End,
                  {Z4c_ClearRW});
-  pnr->QueueTask(&Z4c::TrackCompactObjects, this, Z4c_PT, "Z4c_PT", Task_End, {Z4c_Wave});
-  pnr->QueueTask(&Z4c::CCEDump, this, Z4c_CCE, "CCEDump", Task_End, {Z4c_PT});
+  pnr->QueueTask(&Z4c::EvolveCompactObjects, this, Z4c_PTEvolve, "Z4c_PTEvolve",
+                 Task_End, {Z4c_Wave, Z4c_PT});
+  pnr->QueueTask(&Z4c::CCEDump, this, Z4c_CCE, "CCEDump", Task_End, {Z4c_PTEvolve});
   pnr->QueueTask(&Z4c::DumpHorizons, this, Z4c_DumpHorizon, "Z4c_DumpHorizon",
                 Task_End, {Z4c_CCE});
+  pnr->QueueTask(&Z4c::FindHorizons, this, Z4c_AHF, "Z4c_AHF", Task_End,
+                 {Z4c_DumpHorizon});
 }
 //----------------------------------------------------------------------------------------
 //! \fn  void Wave::InitRecv
@@ -189,11 +195,11 @@ TaskStatus Z4c::RecvU(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn  void Z4c::EnforceAlgConstr
-//! \brief
+//! \brief enforces algebraic constraints, and sets ADM variables from the result
 
 TaskStatus Z4c::EnforceAlgConstr(Driver *pdrive, int stage) {
   if (pmy_pack->pdyngr != nullptr || stage == pdrive->nexp_stages) {
-    AlgConstr(pmy_pack);
+    AlgConstr(pmy_pack, true);
   }
   return TaskStatus::complete;
 }
@@ -226,7 +232,9 @@ TaskStatus Z4c::UpdateExcisionMasks(Driver *pdrive, int stage) {
 
 TaskStatus Z4c::ADMConstraints_(Driver *pdrive, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
-  if (stage == pdrive->nexp_stages) {
+  Real &time = pmy_pack->pmesh->time;
+  if (stage == pdrive->nexp_stages && time >= con_last_time + opt.con_dt) {
+    con_last_time = time;
     switch (indcs.ng) {
       case 2: ADMConstraints<2>(pmy_pack);
               break;
@@ -286,6 +294,19 @@ TaskStatus Z4c::TrackCompactObjects(Driver *pdrive, int stage) {
   if (stage == pdrive->nexp_stages) {
     for (auto & pt : ptracker) {
       pt->InterpolateVelocity(pmy_pack);
+    }
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Z4c::EvolveCompactObjects
+//! \brief completes communication of velocities started by TrackCompactObjects, and
+//! moves the compact objects
+
+TaskStatus Z4c::EvolveCompactObjects(Driver *pdrive, int stage) {
+  if (stage == pdrive->nexp_stages) {
+    for (auto & pt : ptracker) {
       pt->EvolveTracker();
       pt->WriteTracker();
     }
@@ -501,4 +522,28 @@ TaskStatus Z4c::DumpHorizons(Driver *pdrive, int stage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn  void Z4c::FindHorizons
+//! \brief find apparent horizons in-situ every ahf_dt.  Horizon n is centered on the
+//! compact object tracked by tracker n if there is one.
+
+TaskStatus Z4c::FindHorizons(Driver *pdrive, int stage) {
+  if (pahf.size() == 0 || stage != pdrive->nexp_stages) {
+    return TaskStatus::complete;
+  }
+  float time_32 = static_cast<float>(pmy_pack->pmesh->time);
+  float next_32 = static_cast<float>(pahf[0]->ahf_last_output_time + pahf[0]->ahf_dt);
+  if (time_32 >= next_32) {
+    int n = 0;
+    for (auto & ahf : pahf) {
+      ahf->ahf_last_output_time = time_32;
+      Real *center = (n < static_cast<int>(ptracker.size()))?
+                     ptracker[n]->GetPos() : ahf->pos;
+      ahf->Find(center);
+      n++;
+    }
+  }
+  return TaskStatus::complete;
+}
+
 } // namespace z4c
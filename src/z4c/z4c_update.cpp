@@ -34,11 +34,48 @@ TaskStatus Z4c::ExpRKUpdate(Driver *pdriver, int stage) {
   int nmb1 = pmy_pack->nmb_thispack - 1;
   int nvar = nz4c;
 
-  par_for("z4c RK update",DevExeSpace(),
-      0,nmb1,0,nvar-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
-    u0(m,n,k,j,i) = gam0*u0(m,n,k,j,i) + gam1*u1(m,n,k,j,i) + beta_dt*u_rhs(m,n,k,j,i);
-  });
+  if (!(opt.adaptive_dt) || stage != pdriver->nexp_stages) {
+    par_for("z4c RK update",DevExeSpace(),
+        0,nmb1,0,nvar-1,ks,ke,js,je,is,ie,
+    KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
+      u0(m,n,k,j,i) = gam0*u0(m,n,k,j,i) + gam1*u1(m,n,k,j,i) + beta_dt*u_rhs(m,n,k,j,i);
+    });
+    return TaskStatus::complete;
+  }
+
+  // Last stage with adaptive dt: compare the update with the embedded lower-order
+  // solution, built from the previous stage in u0 and the solution at t^n in u1.
+  // rk2 (Heun) embeds forward Euler, u_emb = u0.  rk3 (SSP) embeds Heun,
+  // u_emb = 2*u0 - u1.
+  Real emb0 = 1.0, emb1 = 0.0;
+  if (pdriver->integrator == "rk3") {
+    emb0 = 2.0;
+    emb1 = -1.0;
+  }
+  Real rtol = opt.dt_rtol, atol = opt.dt_atol;
+  const int nji  = (je-js+1)*(ie-is+1);
+  const int nkji = (ke-ks+1)*nji;
+  const int nmkji = (nmb1+1)*nkji;
+  Real err = 0.0;
+  Kokkos::parallel_reduce("z4c RK update err",
+  Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &max_err) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/(ie-is+1);
+    int i = (idx - m*nkji - k*nji - j*(ie-is+1)) + is;
+    k += ks;
+    j += js;
+    for (int n=0; n<nvar; ++n) {
+      Real u_old = u1(m,n,k,j,i);
+      Real u_emb = emb0*u0(m,n,k,j,i) + emb1*u_old;
+      Real u_new = gam0*u0(m,n,k,j,i) + gam1*u_old + beta_dt*u_rhs(m,n,k,j,i);
+      u0(m,n,k,j,i) = u_new;
+      Real scale = atol + rtol*fmax(fabs(u_new), fabs(u_old));
+      max_err = fmax(max_err, fabs(u_new - u_emb)/scale);
+    }
+  }, Kokkos::Max<Real>(err));
+  dt_err = err;
   return TaskStatus::complete;
 }
 } // namespace z4c
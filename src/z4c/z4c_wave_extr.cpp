@@ -29,6 +29,7 @@
 #include "coordinates/cell_locations.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "geodesic-grid/spherical_grid.hpp"
+#include "utils/transient_pool.hpp"
 
 namespace z4c {
 
@@ -78,38 +79,79 @@ void Z4c::WaveExtr(MeshBlockPack *pmbp) {
   int lmax = 8;
   // bool bitant = false;
 
-  Real ylmR,ylmI;
-  int count = 0;
+  int nmodes = (lmax+1)*(lmax+1) - 4;
+  int nangmax = 0;
   for (int g=0; g<nradii; ++g) {
-    // Interpolate Weyl scalars to the surface
-    grids[g]->InterpolateToSphere(2, u_weyl);
-    for (int l = 2; l < lmax+1; ++l) {
-      for (int m = -l; m < l+1 ; ++m) {
-        Real psilmR = 0.0;
-        Real psilmI = 0.0;
+    nangmax = std::max(nangmax, grids[g]->nangles);
+  }
+
+  // Tabulate solid-angle weights times spin-weighted spherical harmonics once, since the
+  // angular positions of the spheres never change.  Entry (g,0/1,LmIndex(l,m),ip) holds
+  // the real/imaginary part of weight*ylm at point ip of sphere g.
+  auto &wylm = pmbp->pz4c->wave_ylm;
+  if (wylm.extent_int(0) != nradii || wylm.extent_int(3) != nangmax) {
+    Kokkos::realloc(wylm, nradii, 2, nmodes, nangmax);
+    auto wylm_h = Kokkos::create_mirror_view(wylm);
+    Kokkos::deep_copy(wylm_h, 0.0);
+    Real ylmR,ylmI;
+    for (int g=0; g<nradii; ++g) {
+      for (int l = 2; l < lmax+1; ++l) {
+        for (int m = -l; m < l+1 ; ++m) {
           for (int ip = 0; ip < grids[g]->nangles; ++ip) {
             Real theta = grids[g]->polar_pos.h_view(ip,0);
             Real phi = grids[g]->polar_pos.h_view(ip,1);
-            Real datareal = grids[g]->interp_vals.h_view(ip,0);
-            Real dataim = grids[g]->interp_vals.h_view(ip,1);
             Real weight = grids[g]->solid_angles.h_view(ip);
             swsh(&ylmR,&ylmI,l,m,theta,phi);
-            // The spherical harmonics transform as
-            // Y^s_{l m}( Pi-th, ph ) = (-1)^{l+s} Y^s_{l -m}(th, ph)
-            // but the PoisitionPolar function returns theta \in [0,\pi],
-            // so these are correct for bitant.
-            // With bitant, under reflection the imaginary part of
-            // the weyl scalar should pick a - sign,
-            // which is accounted for here.
-            // Real bitant_z_fac = (bitant && theta > M_PI/2) ? -1 : 1;
-            psilmR += weight*(datareal*ylmR + dataim*ylmI);
-            psilmI += weight*(dataim*ylmR - datareal*ylmI);
+            wylm_h(g,0,LmIndex(l,m),ip) = weight*ylmR;
+            wylm_h(g,1,LmIndex(l,m),ip) = weight*ylmI;
           }
-        psi_out[count++] = psilmR;
-        psi_out[count++] = psilmI;
+        }
       }
     }
+    Kokkos::deep_copy(wylm, wylm_h);
+  }
+
+  // Project the Weyl scalar on every sphere onto all modes on the device, one team per
+  // (mode, real/imaginary part), so that only the 2*nmodes coefficients per sphere are
+  // copied to the host.
+  // The spherical harmonics transform as
+  // Y^s_{l m}( Pi-th, ph ) = (-1)^{l+s} Y^s_{l -m}(th, ph)
+  // but the PoisitionPolar function returns theta \in [0,\pi],
+  // so these are correct for bitant.
+  // With bitant, under reflection the imaginary part of
+  // the weyl scalar should pick a - sign,
+  // which is accounted for here.
+  // Real bitant_z_fac = (bitant && theta > M_PI/2) ? -1 : 1;
+  int count = 2*nmodes*nradii;
+  auto psi_d = transient_pool::Get<DvceArray1D<Real>>("psi_lm", count);
+  for (int g=0; g<nradii; ++g) {
+    // Interpolate Weyl scalars to the surface
+    grids[g]->InterpolateToSphere(2, u_weyl);
+    auto &ivals = grids[g]->interp_vals;
+    int nang = grids[g]->nangles;
+    int off = 2*nmodes*g;
+    par_for_outer("wave_extr_swsh",DevExeSpace(),0,0,0,(2*nmodes-1),
+    KOKKOS_LAMBDA(TeamMember_t tmember, const int n) {
+      int lm = n/2;
+      int part = n - 2*lm;
+      Real psilm = 0.0;
+      Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nang),
+      [=](const int ip, Real& sum) {
+        Real datareal = ivals.d_view(ip,0);
+        Real dataim = ivals.d_view(ip,1);
+        if (part == 0) {
+          sum += datareal*wylm(g,0,lm,ip) + dataim*wylm(g,1,lm,ip);
+        } else {
+          sum += dataim*wylm(g,0,lm,ip) - datareal*wylm(g,1,lm,ip);
+        }
+      }, psilm);
+      Kokkos::single(Kokkos::PerTeam(tmember), [&]() {
+        psi_d(off + n) = psilm;
+      });
+    });
   }
+  HostArray1D<Real> psi_h(psi_out, count);
+  Kokkos::deep_copy(psi_h, psi_d);
 
   // write output
   #if MPI_PARALLEL_ENABLED
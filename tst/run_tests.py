@@ -4,6 +4,9 @@
 
 # Usage: From this directory, call this script with python:
 #        python run_tests.py
+#
+#        Performance tests are only run when requested, e.g.
+#        python run_tests.py performance [--machine=<name>] [--update_baseline]
 
 # Notes:
 #   - Requires Python 3+.
@@ -26,6 +29,7 @@ sys.dont_write_bytecode = True
 
 # AthenaK modules
 import scripts.utils.athena as athena  # noqa
+import scripts.utils.performance as performance  # noqa
 
 # AthenaK logger
 logger = logging.getLogger('athena')
@@ -35,10 +39,18 @@ logger = logging.getLogger('athena')
 def main(**kwargs):
     # Make list of tests to run
     tests = kwargs.pop('tests')
+    # Settings for performance tests
+    machine = kwargs.pop('machine')
+    if machine is not None:
+        performance.machine = machine
+    performance.update_baseline = kwargs.pop('update_baseline')
+    performance.tolerance = kwargs.pop('perf_tolerance')
     test_names = []
     if len(tests) == 0:  # run all tests
         for _, directory, ispkg in iter_modules(path=['scripts']):
-            if ispkg and (directory != 'utils' and directory != 'style'):
+            # performance tests are excluded unless explicitly requested
+            if ispkg and (directory != 'utils' and directory != 'style'
+                          and directory != 'performance'):
                 dir_test_names = [name for _, name, _ in
                                   iter_modules(path=['scripts/'
                                                      + directory],
@@ -207,6 +219,21 @@ if __name__ == '__main__':
                         default=None,
                         help='set filename of logfile')
 
+    parser.add_argument('--machine',
+                        type=str,
+                        default=None,
+                        help='name of baselines for performance tests '
+                             '(default: hostname)')
+
+    parser.add_argument('--update_baseline',
+                        action='store_true',
+                        help='store throughput of performance tests as baselines')
+
+    parser.add_argument('--perf_tolerance',
+                        type=float,
+                        default=0.1,
+                        help='allowed fractional slowdown in performance tests')
+
     args = parser.parse_args()
     log_init(args)
 
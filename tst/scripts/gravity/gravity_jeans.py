@@ -0,0 +1,65 @@
+# Regression test of self-gravity: Poisson solver and Jeans wave convergence
+#
+# Solves the Poisson equation for the density of a Jeans wave in 3D (run with
+# nlim=0), and evolves the travelling Jeans wave for one period, at two resolutions
+# each.  Checks the L1 errors of the potential and of the fluid variables (stored in
+# the temporary files gravity_poisson-errs.dat and gravity_jeans-errs.dat) converge
+# at second order and are small.
+
+# Modules
+import logging
+import numpy as np
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_res = [16, 32]
+_min_rate = {'poisson': 1.8, 'jeans': 1.6}
+# maximum errors relative to the amplitude of the potential and of the wave
+_max_err = {'poisson': 3.0e-2, 'jeans': 2.0e-1}
+_amp = 1.0e-6
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for test in ['poisson', 'jeans']:
+        for nx in _res:
+            arguments = ['job/basename=gravity_' + test,
+                         'mesh/nx1=' + repr(nx),
+                         'mesh/nx2=' + repr(nx),
+                         'mesh/nx3=' + repr(nx),
+                         'meshblock/nx1=' + repr(nx//2),
+                         'meshblock/nx2=' + repr(nx//2),
+                         'meshblock/nx3=' + repr(nx//2),
+                         'problem/amp=' + repr(_amp),
+                         'output1/dt=-1.0']
+            if test == 'poisson':
+                arguments += ['time/nlim=0']
+            athena.run('tests/jeans_wave.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    # amplitude of potential is four_pi_G amp/k^2 = amp/2 in tests/jeans_wave.athinput
+    scale = {'poisson': 0.5*_amp, 'jeans': _amp}
+    for test in ['poisson', 'jeans']:
+        data = athena_read.error_dat('build/src/gravity_' + test + '-errs.dat')
+        # potential in last column, RMS of fluid variables in column 4
+        errs = data[:, -1] if test == 'poisson' else data[:, 4]
+        rate = np.log2(errs[0]/errs[1])
+        if rate < _min_rate[test]:
+            logger.warning("{0} test error converges at rate {1:g}, expected at "
+                           "least {2:g}, errors: {3:g} {4:g}".
+                           format(test, rate, _min_rate[test], errs[0], errs[1]))
+            analyze_status = False
+        if errs[-1] > _max_err[test]*scale[test]:
+            logger.warning("{0} test error {1:g} at Nx={2} is too large".
+                           format(test, errs[-1], _res[-1]))
+            analyze_status = False
+
+    return analyze_status
@@ -0,0 +1,76 @@
+# Regression test comparing the fused and unfused hydro flux and update kernels
+#
+# Runs the 3D hydro linear wave problem, once with separate flux and update kernels
+# and once with <hydro>/fused=true, and checks the history and tabular outputs
+# (printed with 17 significant digits) of the two runs are identical.  Two meshes are
+# used: small MeshBlocks, whose rows fit in level 0 team scratch, and MeshBlocks with
+# 256 cells in x1, whose rows exceed the level 0 scratch limit of both host and GPU
+# backends so that FusedUpdate() falls back to level 1 scratch.
+
+# Modules
+import glob
+import logging
+import os
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+# mesh and MeshBlock size in x1, x2 and x3 for each case
+_mesh = {'small': ([32, 16, 16], [8, 8, 8]),
+         'long': ([256, 16, 16], [256, 8, 8])}
+_recon = ['plm', 'ppm4']
+_fused = ['false', 'true']
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for mv, (nx, mbnx) in _mesh.items():
+        for rv in _recon:
+            for fv in _fused:
+                arguments = ['job/basename=fused_' + mv + '_' + rv + '_' + fv,
+                             'time/tlim=0.5',
+                             'time/integrator=rk2',
+                             'mesh/nghost=3',
+                             'mesh/nx1=' + repr(nx[0]),
+                             'mesh/nx2=' + repr(nx[1]),
+                             'mesh/nx3=' + repr(nx[2]),
+                             'meshblock/nx1=' + repr(mbnx[0]),
+                             'meshblock/nx2=' + repr(mbnx[1]),
+                             'meshblock/nx3=' + repr(mbnx[2]),
+                             'hydro/reconstruct=' + rv,
+                             'hydro/rsolver=hllc',
+                             'hydro/fused=' + fv,
+                             'problem/wave_flag=0',
+                             'output1/data_format=%24.16e',
+                             'output1/dt=0.25',
+                             'output2/dt=-1.0',
+                             'output3/data_format=%24.16e',
+                             'output3/dt=0.05']
+                athena.run('tests/linear_wave_hydro.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    for mv in _mesh:
+        for rv in _recon:
+            unfused = 'fused_' + mv + '_' + rv + '_false'
+            fused = 'fused_' + mv + '_' + rv + '_true'
+            files = sorted(glob.glob('build/src/' + unfused + '.*.hst') +
+                           glob.glob('build/src/tab/' + unfused + '.*.tab'))
+            if len(files) == 0:
+                logger.warning('No outputs found for {0} mesh with {1}'.format(mv, rv))
+                analyze_status = False
+            for fu in files:
+                ff = os.path.join(os.path.dirname(fu),
+                                  os.path.basename(fu).replace(unfused, fused, 1))
+                with open(fu, 'r') as f:
+                    data_unfused = f.read()
+                with open(ff, 'r') as f:
+                    data_fused = f.read()
+                if data_unfused != data_fused:
+                    logger.warning("Output {0} with fused kernel differs from "
+                                   "unfused kernels".format(os.path.basename(ff)))
+                    analyze_status = False
+
+    return analyze_status
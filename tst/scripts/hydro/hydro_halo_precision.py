@@ -0,0 +1,91 @@
+# Regression test comparing single and double precision halo exchange in hydro
+#
+# Runs the 3D hydro linear wave problem on 4 MPI ranks with aggregated boundary
+# messages, once with <hydro>/halo_precision=double and once with float and
+# halo_check=true.  Checks the tabular outputs of the two runs agree to within
+# single-precision roundoff, and that the error reported by halo_check is non-zero
+# and no larger than the unit roundoff of single precision.
+# Requires AthenaK to be built with -DAthena_ENABLE_MPI=ON.
+
+# Modules
+import logging
+import numpy as np
+import re
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_nproc = 4
+_prec = ['double', 'float']
+_rel_tol = 1.0e-5             # tolerance of outputs relative to max of each variable
+_unit_roundoff = 2.0**(-24)   # max relative error of rounding to single precision
+_report_re = re.compile(r'Max error in single precision halo exchange of <hydro>: '
+                        r'absolute = (\S+), relative = (\S+)')
+_output = {}
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for pv in _prec:
+        arguments = ['job/basename=halo_' + pv,
+                     'time/tlim=1.0',
+                     'mesh/nghost=2',
+                     'mesh/nx1=32',
+                     'mesh/nx2=16',
+                     'mesh/nx3=16',
+                     'mesh/aggregate_mpi=true',
+                     'meshblock/nx1=8',
+                     'meshblock/nx2=8',
+                     'meshblock/nx3=8',
+                     'hydro/halo_precision=' + pv,
+                     'hydro/halo_check=true',
+                     'problem/amp=1.0e-3',
+                     'output1/data_format=%24.16e',
+                     'output1/dt=0.5',
+                     'output2/dt=-1.0',
+                     'output3/dt=-1.0']
+        _output[pv] = athena.mpirun(_nproc, 'tests/linear_wave_hydro.athinput',
+                                    arguments, capture=True)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+
+    # outputs at end of run agree to within single-precision roundoff
+    for n in ['00001', '00002']:
+        data_d = athena_read.tab('build/src/tab/halo_double.hydro_w.' + n + '.tab')
+        data_f = athena_read.tab('build/src/tab/halo_float.hydro_w.' + n + '.tab')
+        for var in data_d:
+            if var in ['time', 'cycle', 'i', 'x1v']:
+                continue
+            scale = np.max(np.abs(data_d[var]))
+            err = np.max(np.abs(data_f[var] - data_d[var]))/scale
+            if err > _rel_tol:
+                logger.warning("{0} in output {1} with single precision halos "
+                               "differs from double precision by {2:g}".
+                               format(var, n, err))
+                analyze_status = False
+
+    # halo_check reports a non-zero error within the unit roundoff, only for float
+    if _report_re.search(_output['double']) is not None:
+        logger.warning("halo_check reported an error with double precision halos")
+        analyze_status = False
+    match = _report_re.search(_output['float'])
+    if match is None:
+        logger.warning("halo_check did not report the single precision halo error")
+        analyze_status = False
+    else:
+        err_abs = float(match.group(1))
+        err_rel = float(match.group(2))
+        if not (err_abs > 0.0) or not (err_rel <= _unit_roundoff):
+            logger.warning("halo_check reported errors absolute = {0:g}, relative = "
+                           "{1:g}, expected non-zero errors with relative error "
+                           "below {2:g}".format(err_abs, err_rel, _unit_roundoff))
+            analyze_status = False
+
+    return analyze_status
@@ -0,0 +1,56 @@
+# Regression test of super-time-stepping of viscosity with RKL1 and RKL2
+#
+# Runs the 1D viscous diffusion of a Gaussian velocity profile with
+# <time>/sts_integrator=rkl1 and rkl2 at three resolutions, and checks the L1
+# errors against the analytic solution (stored in the temporary file
+# sts_diffusion-errs.dat) converge at first and second order respectively.
+# The timestep is set by the hydrodynamic CFL condition, so it is proportional
+# to the cell size and the order of the operator splitting is measured.
+
+# Modules
+import logging
+import numpy as np
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_sts = ['rkl1', 'rkl2']
+_res = [64, 128, 256]
+_min_rate = {'rkl1': 0.8, 'rkl2': 1.7}
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for sv in _sts:
+        for nx in _res:
+            arguments = ['job/basename=sts_diffusion',
+                         'time/sts_integrator=' + sv,
+                         'mesh/nx1=' + repr(nx),
+                         'meshblock/nx1=' + repr(nx),
+                         'output1/dt=-1.0',
+                         'output2/dt=-1.0']
+            athena.run('tests/viscosity.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    data = athena_read.error_dat('build/src/sts_diffusion-errs.dat')
+    data = data.reshape([len(_sts), len(_res), data.shape[-1]])
+    for si, sv in enumerate(_sts):
+        errs = data[si, :, 4]
+        for ri in range(len(_res)-1):
+            rate = np.log2(errs[ri]/errs[ri+1])
+            if rate < _min_rate[sv]:
+                logger.warning("{0} viscous diffusion error converges at rate "
+                               "{1:g} between Nx1={2} and {3}, expected at "
+                               "least {4:g}, errors: {5:g} {6:g}".
+                               format(sv, rate, _res[ri], _res[ri+1],
+                                      _min_rate[sv], errs[ri], errs[ri+1]))
+                analyze_status = False
+
+    return analyze_status
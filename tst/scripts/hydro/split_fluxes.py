@@ -0,0 +1,75 @@
+# Regression test comparing split and unsplit flux calculations in hydro and MHD
+#
+# Runs the 3D hydro and MHD linear wave problems on several MeshBlocks, once with
+# the fluxes computed in one pass and once with <hydro>/split_fluxes=true (or
+# <mhd>/split_fluxes=true), which computes them in interior and boundary passes,
+# and checks the history and tabular outputs (printed with 17 significant digits)
+# of the two runs are identical.  Reconstruction with PLM and WENOZ checks that the
+# boundary pass covers the full stencil width.
+
+# Modules
+import glob
+import logging
+import os
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+# Riemann solver, and outputs (hst and tab) kept and disabled in the input file
+_phys = {'hydro': ('hllc', [1, 3], [2]), 'mhd': ('hlld', [1, 2, 5], [3, 4])}
+_recon = ['plm', 'wenoz']
+_split = ['false', 'true']
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for pv, (rsolver, outs, no_outs) in _phys.items():
+        for rv in _recon:
+            for sv in _split:
+                arguments = ['job/basename=split_' + pv + '_' + rv + '_' + sv,
+                             'time/tlim=0.5',
+                             'time/integrator=rk3',
+                             'mesh/nghost=3',
+                             'mesh/nx1=32',
+                             'mesh/nx2=16',
+                             'mesh/nx3=16',
+                             'meshblock/nx1=8',
+                             'meshblock/nx2=8',
+                             'meshblock/nx3=8',
+                             pv + '/reconstruct=' + rv,
+                             pv + '/rsolver=' + rsolver,
+                             pv + '/split_fluxes=' + sv,
+                             'problem/wave_flag=0']
+                for n in outs:
+                    arguments += ['output{0}/data_format=%24.16e'.format(n),
+                                  'output{0}/dt=0.25'.format(n)]
+                for n in no_outs:
+                    arguments += ['output{0}/dt=-1.0'.format(n)]
+                athena.run('tests/linear_wave_' + pv + '.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    for pv in _phys:
+        for rv in _recon:
+            unsplit = 'split_' + pv + '_' + rv + '_false'
+            split = 'split_' + pv + '_' + rv + '_true'
+            files = sorted(glob.glob('build/src/' + unsplit + '.*.hst') +
+                           glob.glob('build/src/tab/' + unsplit + '.*.tab'))
+            if len(files) == 0:
+                logger.warning('No outputs found for {0} with {1}'.format(pv, rv))
+                analyze_status = False
+            for fu in files:
+                fs = os.path.join(os.path.dirname(fu),
+                                  os.path.basename(fu).replace(unsplit, split, 1))
+                with open(fu, 'r') as f:
+                    data_unsplit = f.read()
+                with open(fs, 'r') as f:
+                    data_split = f.read()
+                if data_unsplit != data_split:
+                    logger.warning("Output {0} with split fluxes differs from "
+                                   "unsplit fluxes".format(os.path.basename(fs)))
+                    analyze_status = False
+
+    return analyze_status
@@ -0,0 +1,64 @@
+# Regression test comparing combined and separate U/B boundary exchange in MHD
+#
+# Runs the 3D MHD linear wave problem with SMR on 4 MPI ranks, once with separate
+# boundary exchanges of the conserved variables and face-centered fields and once
+# with <mhd>/combined_ub=true, and checks the history and tabular outputs (printed
+# with 17 significant digits, including ghost zones) of the two runs are identical.
+# Requires AthenaK to be built with -DAthena_ENABLE_MPI=ON.
+
+# Modules
+import glob
+import logging
+import os
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_nproc = 4
+_comb = ['false', 'true']
+_wave_flag = [0, 1]
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for cv in _comb:
+        for wf in _wave_flag:
+            arguments = ['job/basename=mhd_comb_ub_' + cv + '_' + repr(wf),
+                         'time/tlim=0.5',
+                         'mhd/combined_ub=' + cv,
+                         'problem/wave_flag=' + repr(wf),
+                         'output1/data_format=%24.16e',
+                         'output1/dt=0.25',
+                         'output2/data_format=%24.16e',
+                         'output2/dt=0.25',
+                         'output3/dt=-1.0',
+                         'output4/dt=-1.0',
+                         'output5/data_format=%24.16e',
+                         'output5/dt=0.05']
+            athena.mpirun(_nproc, 'tests/linear_wave_mhd_smr.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    for wf in _wave_flag:
+        sep = 'mhd_comb_ub_false_' + repr(wf)
+        comb = 'mhd_comb_ub_true_' + repr(wf)
+        files = sorted(glob.glob('build/src/' + sep + '.*.hst') +
+                       glob.glob('build/src/tab/' + sep + '.*.tab'))
+        if len(files) == 0:
+            logger.warning('No outputs found for wave_flag={0}'.format(wf))
+            analyze_status = False
+        for fs in files:
+            fc = os.path.join(os.path.dirname(fs),
+                              os.path.basename(fs).replace(sep, comb, 1))
+            with open(fs, 'r') as f:
+                data_sep = f.read()
+            with open(fc, 'r') as f:
+                data_comb = f.read()
+            if data_sep != data_comb:
+                logger.warning("Output {0} with combined_ub=true differs from "
+                               "separate exchange".format(os.path.basename(fc)))
+                analyze_status = False
+
+    return analyze_status
@@ -0,0 +1,74 @@
+# Regression test comparing mixed-precision and full-precision MHD fluxes
+#
+# Runs the 3D MHD linear wave problem with HLLE and HLLD, once with the L/R
+# states computed in full precision and once with <mhd>/mixed_precision=true,
+# and checks the L1 errors (stored in the temporary file
+# mhd_mixed_prec-errs.dat) of the two agree.  A larger amplitude than in
+# mhd_linwave.py is used so that the errors are well above single-precision
+# roundoff.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_flux = ['hlle', 'hlld']
+_prec = ['false', 'true']
+_wave = ['fast', 'Alfven', 'slow']
+_wave_flag = [0, 1, 2]
+_rel_tol = 0.05
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for fv in _flux:
+        for pv in _prec:
+            for wf in _wave_flag:
+                arguments = ['job/basename=mhd_mixed_prec',
+                             'time/tlim=1.0',
+                             'time/nlim=1000',
+                             'time/integrator=rk2',
+                             'mesh/nghost=2',
+                             'mesh/nx1=32',
+                             'mesh/nx2=16',
+                             'mesh/nx3=16',
+                             'meshblock/nx1=8',
+                             'meshblock/nx2=8',
+                             'meshblock/nx3=8',
+                             'mhd/reconstruct=plm',
+                             'mhd/rsolver=' + fv,
+                             'mhd/mixed_precision=' + pv,
+                             'problem/amp=1.0e-3',
+                             'problem/wave_flag=' + repr(wf),
+                             'problem/vflow=0.0',
+                             'output1/dt=-1.0',
+                             'output2/dt=-1.0',
+                             'output3/dt=-1.0',
+                             'output4/dt=-1.0',
+                             'output5/dt=-1.0']
+                athena.run('tests/linear_wave_mhd.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    data = athena_read.error_dat('build/src/mhd_mixed_prec-errs.dat')
+    data = data.reshape([len(_flux), len(_prec), len(_wave), data.shape[-1]])
+    for fi, fv in enumerate(_flux):
+        for wi, wv in enumerate(_wave):
+            l1_rms_full = data[fi][0][wi][4]
+            l1_rms_mixed = data[fi][1][wi][4]
+            rel_diff = abs(l1_rms_mixed - l1_rms_full)/l1_rms_full
+            if rel_diff > _rel_tol:
+                logger.warning("{0} wave error with mixed precision differs "
+                               "from full precision for {1}, errors: "
+                               "{2:g} {3:g}".
+                               format(wv, fv, l1_rms_mixed, l1_rms_full))
+                analyze_status = False
+
+    return analyze_status
@@ -0,0 +1,38 @@
+# Performance test based on GR Bondi accretion
+#
+# Runs a fixed number of cycles of 3D Bondi accretion in Kerr-Schild coordinates and
+# compares the zone-cycles/cpu_second with the baseline stored for this machine.
+
+# Modules
+import logging
+import scripts.utils.athena as athena  # noqa
+import scripts.utils.performance as performance
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_name = 'gr_bondi'
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=gr_bondi',
+                 'time/tlim=1000.0',
+                 'time/nlim=100',
+                 'time/integrator=rk2',
+                 'time/ndiag=1000',
+                 'mesh/nghost=2',
+                 'mesh/nx1=128',
+                 'mesh/nx2=128',
+                 'mesh/nx3=128',
+                 'meshblock/nx1=64',
+                 'meshblock/nx2=64',
+                 'meshblock/nx3=64',
+                 'hydro/reconstruct=plm',
+                 'hydro/rsolver=hlle',
+                 'output1/dt=-1.0']
+    performance.run(_name, 'tests/bondi.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    return performance.compare([_name])
@@ -0,0 +1,37 @@
+# Performance test based on hydro blast wave with AMR
+#
+# Runs a fixed number of cycles of a 3D blast wave with adaptive mesh refinement, which
+# includes the cost of refinement, load balancing and prolongation, and compares the
+# zone-cycles/cpu_second with the baseline stored for this machine.
+
+# Modules
+import logging
+import scripts.utils.athena as athena  # noqa
+import scripts.utils.performance as performance
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_name = 'hydro_blast_amr'
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=Blast',
+                 'time/tlim=100.0',
+                 'time/nlim=200',
+                 'time/ndiag=1000',
+                 'mesh/nx1=64',
+                 'mesh/nx2=64',
+                 'mesh/nx3=64',
+                 'meshblock/nx1=16',
+                 'meshblock/nx2=16',
+                 'meshblock/nx3=16',
+                 'mesh_refinement/num_levels=3',
+                 'output1/dt=-1.0',
+                 'output2/dt=-1.0']
+    performance.run(_name, 'hydro/blast_hydro_amr.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    return performance.compare([_name])
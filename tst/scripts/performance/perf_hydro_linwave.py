@@ -0,0 +1,42 @@
+# Performance test based on Newtonian hydro linear wave problem
+#
+# Runs a fixed number of cycles of a 3D sound wave on a uniform mesh and compares the
+# zone-cycles/cpu_second with the baseline stored for this machine.
+
+# Modules
+import logging
+import scripts.utils.athena as athena  # noqa
+import scripts.utils.performance as performance
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_name = 'hydro_linwave'
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=hydro_lin_wave',
+                 'time/tlim=100.0',
+                 'time/nlim=100',
+                 'time/integrator=rk2',
+                 'time/ndiag=1000',
+                 'mesh/nghost=3',
+                 'mesh/nx1=128',
+                 'mesh/nx2=128',
+                 'mesh/nx3=128',
+                 'meshblock/nx1=64',
+                 'meshblock/nx2=64',
+                 'meshblock/nx3=64',
+                 'hydro/reconstruct=ppmx',
+                 'hydro/rsolver=hllc',
+                 'problem/wave_flag=0',
+                 'problem/amp=1.0e-6',
+                 'output1/dt=-1.0',
+                 'output2/dt=-1.0',
+                 'output3/dt=-1.0']
+    performance.run(_name, 'tests/linear_wave_hydro.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    return performance.compare([_name])
@@ -0,0 +1,41 @@
+# Performance test based on Z4c linear wave problem
+#
+# Runs a fixed number of cycles of a 3D gravitational wave in vacuum and compares the
+# zone-cycles/cpu_second with the baseline stored for this machine.
+
+# Modules
+import logging
+import scripts.utils.athena as athena  # noqa
+import scripts.utils.performance as performance
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_name = 'z4c_linwave'
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=z4c_lin_wave',
+                 'time/tlim=100.0',
+                 'time/nlim=50',
+                 'time/integrator=rk4',
+                 'time/ndiag=1000',
+                 'mesh/nghost=4',
+                 'mesh/nx1=96',
+                 'mesh/nx2=96',
+                 'mesh/nx3=96',
+                 'meshblock/nx1=48',
+                 'meshblock/nx2=48',
+                 'meshblock/nx3=48',
+                 'z4c/diss=1.0',
+                 'problem/amp=1.0e-6',
+                 'pgen_name=z4c_linear_wave',
+                 'output1/dt=-1.0',
+                 'output2/dt=-1.0',
+                 'output3/dt=-1.0']
+    performance.run(_name, 'tests/linear_wave_z4c.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    return performance.compare([_name])
@@ -60,21 +60,28 @@ def run(input_filename, arguments):
         os.chdir(current_dir)
 
 
-# Function for running AthenaK with MPI
-def mpirun(nproc, input_filename, arguments):
+# Function for running AthenaK with MPI.  With capture=True the standard output is
+# returned (and logged once the run has finished) instead of logged as it is written.
+def mpirun(nproc, input_filename, arguments, capture=False):
     out_log = LogPipe('athena.run', logging.INFO)
+    output = None
     current_dir = os.getcwd()
     exe_dir = current_dir + '/build/src/'
     os.chdir(exe_dir)
     try:
         input_filename_full = '../../' + athena_rel_path + \
                               'inputs/' + input_filename
-        run_command = ['mpiexec -n', str(nproc), './athena', '-i',
+        run_command = ['mpiexec', '-n', str(nproc), './athena', '-i',
                        input_filename_full]
         try:
             cmd = run_command + arguments
             logging.getLogger('athena.run').debug('Executing: '+' '.join(cmd))
-            subprocess.check_call(cmd, stdout=out_log)
+            if capture:
+                output = subprocess.check_output(cmd, universal_newlines=True)
+                for line in output.splitlines():
+                    logging.getLogger('athena.run').info(line)
+            else:
+                subprocess.check_call(cmd, stdout=out_log)
         except subprocess.CalledProcessError as err:
             raise AthenaError('Return code {0} from command \'{1}\''
                               .format(err.returncode, ' '.join(err.cmd)))
@@ -82,6 +89,7 @@ def mpirun(nproc, input_filename, arguments):
     finally:
         out_log.close()
         os.chdir(current_dir)
+    return output
 
 
 # General exception class for these functions
@@ -0,0 +1,102 @@
+# Functions for performance regression tests
+#
+# Performance tests run AthenaK on a problem of fixed size, parse the throughput
+# (zone-cycles/cpu_second) printed by Driver::Finalize(), and compare it with a baseline
+# measured earlier on the same machine.  Baselines are stored in
+# baselines/<machine>.json (relative to tst/) as
+#     {"<test>": {"zcps": <zone-cycles/cpu_second>, "tolerance": <fraction>}, ...}
+# where "tolerance" is optional and overrides the default.  A test fails if the measured
+# throughput is more than tolerance below its baseline.  Tests without a baseline pass
+# with a warning; run with --update_baseline to store the measured values.
+
+# Modules
+import json
+import logging
+import os
+import re
+import socket
+import subprocess
+
+# Global variables, set by run_tests.py
+athena_rel_path = '../'
+machine = socket.gethostname()
+tolerance = 0.1
+update_baseline = False
+baseline_dir = 'baselines'
+
+# throughput measured in this session, by test name
+results = {}
+
+_zcps_re = re.compile(r'zone-cycles/cpu_second\s*=\s*([0-9.eE+-]+)')
+
+
+# Function for running AthenaK and recording its throughput under name
+def run(name, input_filename, arguments):
+    logger = logging.getLogger('athena.run')
+    current_dir = os.getcwd()
+    exe_dir = current_dir + '/build/src/'
+    os.chdir(exe_dir)
+    try:
+        input_filename_full = '../../' + athena_rel_path + \
+                              'inputs/' + input_filename
+        cmd = ['./athena', '-i', input_filename_full] + arguments
+        logger.debug('Executing: ' + ' '.join(cmd))
+        try:
+            output = subprocess.check_output(cmd, universal_newlines=True)
+        except subprocess.CalledProcessError as err:
+            raise PerformanceError('Return code {0} from command \'{1}\''
+                                   .format(err.returncode, ' '.join(err.cmd)))
+    finally:
+        os.chdir(current_dir)
+    for line in output.splitlines():
+        logger.debug(line)
+    match = _zcps_re.findall(output)
+    if not match:
+        raise PerformanceError('No zone-cycles/cpu_second reported by ' + name)
+    results[name] = float(match[-1])
+    logging.getLogger('athena.performance').info(
+        '{0}: {1:.4g} zone-cycles/cpu_second'.format(name, results[name]))
+    return results[name]
+
+
+# Function for comparing throughput of the named tests with the stored baselines
+def compare(names):
+    logger = logging.getLogger('athena.performance')
+    filename = os.path.join(baseline_dir, machine + '.json')
+    baselines = {}
+    if os.path.isfile(filename):
+        with open(filename, 'r') as f:
+            baselines = json.load(f)
+    status = True
+    for name in names:
+        zcps = results[name]
+        if name not in baselines:
+            logger.warning('No baseline for {0} on machine {1}'.format(name, machine))
+        else:
+            base = baselines[name]['zcps']
+            tol = baselines[name].get('tolerance', tolerance)
+            ratio = zcps/base
+            msg = '{0}: {1:.4g} zone-cycles/cpu_second, {2:.1%} of baseline {3:.4g}'
+            msg = msg.format(name, zcps, ratio, base)
+            if ratio < 1.0 - tol:
+                logger.warning('Performance regression in ' + msg)
+                status = False
+            else:
+                logger.info(msg)
+        if update_baseline:
+            entry = baselines.get(name, {})
+            entry['zcps'] = zcps
+            baselines[name] = entry
+    if update_baseline:
+        if not os.path.isdir(baseline_dir):
+            os.makedirs(baseline_dir)
+        with open(filename, 'w') as f:
+            json.dump(baselines, f, indent=2, sort_keys=True)
+            f.write('\n')
+        logger.info('Stored baselines for {0} in {1}'.format(', '.join(names), filename))
+    return status
+
+
+# General exception class for these functions
+class PerformanceError(RuntimeError):
+    pass
@@ -2,6 +2,8 @@
 Functions to:
   (1) convert bin --> Python dictionary
   (2) convert Python dictionary --> athdf(xdmf) files
+  (3) read only selected variables/MeshBlocks/regions of (large) bin files, optionally
+      in parallel with mpi4py, with the memory-mapped BinaryReader
 
 This module contains a collection of helper functions for reading and
 writing athena file data formats. More information is provided in the
@@ -89,29 +91,52 @@ import h5py
 import os
 
 
-def read_binary(filename):
+def read_compressed_variable(fp, ncells):
     """
-    Reads a bin file from filename to dictionary.
-
-    Originally written by Lev Arzamasskiy (leva@ias.edu) on 11/15/2021
-    Updated to support mesh refinement by George Wong (gnwong@ias.edu) on 01/27/2022
+    Reads one variable of a MeshBlock from a compressed (version 1.2) bin file, stored as
+    (float xmin, float step, int32 nbits) followed by ncells integers q of nbits bits each
+    (packed in little-endian bit order), with values xmin + q*step.  If nbits is -1, the
+    values are stored as raw floats instead.
 
     args:
-      filename - string
-          filename of bin file to read
+      fp - file object
+          bin file positioned at the start of the variable
+      ncells - int
+          number of cells of the variable
 
     returns:
-      filedata - dict
-          dictionary of fluid file data
+      data - numpy array
+          values of the variable, of length ncells
     """
 
-    filedata = {}
+    xmin, step, nbits = struct.unpack("=ffi", fp.read(12))
+    if nbits < 0:
+        return np.frombuffer(fp.read(4 * ncells), dtype=np.float32).astype(np.float64)
+    if nbits == 0:
+        return np.full(ncells, xmin, dtype=np.float64)
+    nbytes = (ncells * nbits + 7) // 8
+    bits = np.unpackbits(np.frombuffer(fp.read(nbytes), dtype=np.uint8),
+                         bitorder="little")[:ncells * nbits].reshape(ncells, nbits)
+    q = bits.astype(np.uint64) @ (np.uint64(1) << np.arange(nbits, dtype=np.uint64))
+    return np.float64(xmin) + q.astype(np.float64) * np.float64(step)
 
-    # load file and get size
-    fp = open(filename, "rb")
-    fp.seek(0, 2)
-    filesize = fp.tell()
-    fp.seek(0, 0)
+
+def read_binary_header(fp):
+    """
+    Reads and validates the header of a bin file, leaving fp positioned at the data of
+    the first MeshBlock.
+
+    args:
+      fp - file object
+          bin file opened in binary mode, positioned at the start of the file
+
+    returns:
+      hdr - dict
+          'header', 'time', 'cycle', 'var_names', 'nvars', 'compressed', 'locfmt',
+          'varfmt' (struct format characters), 'locsizebytes', 'varsizebytes', the
+          root grid ('Nx1', 'x1min', ...) and MeshBlock ('nx1', ...) sizes, 'nghost',
+          and 'data_offset' (byte offset of the first MeshBlock)
+    """
 
     # load header information and validate file format
     code_header = fp.readline().split()
@@ -123,7 +148,7 @@ def read_binary(filename):
             + '(should be "Athena")'
         )
     version = code_header[-1].split(b"=")[-1]
-    if version != b"1.1":
+    if version not in [b"1.1", b"1.2"]:
         raise TypeError(f"unsupported file format version {version.decode('utf-8')}")
 
     pheader_count = int(fp.readline().split(b"=")[-1])
@@ -131,27 +156,33 @@ def read_binary(filename):
     for _ in range(pheader_count - 1):
         key, val = [x.strip() for x in fp.readline().decode("utf-8").split("=")]
         pheader[key] = val
-    time = float(pheader["time"])
-    cycle = int(pheader["cycle"])
+    hdr = {}
+    hdr["compressed"] = pheader.get("compression", "none") == "quantize"
+    hdr["time"] = float(pheader["time"])
+    hdr["cycle"] = int(pheader["cycle"])
     locsizebytes = int(pheader["size of location"])
     varsizebytes = int(pheader["size of variable"])
 
-    nvars = int(fp.readline().split(b"=")[-1])
-    var_list = [v.decode("utf-8") for v in fp.readline().split()[1:]]
+    hdr["nvars"] = int(fp.readline().split(b"=")[-1])
+    hdr["var_names"] = [v.decode("utf-8") for v in fp.readline().split()[1:]]
     header_size = int(fp.readline().split(b"=")[-1])
     header = [
         line.decode("utf-8").split("#")[0].strip()
         for line in fp.read(header_size).split(b"\n")
     ]
     header = [line for line in header if len(line) > 0]
+    hdr["header"] = header
+    hdr["data_offset"] = fp.tell()
 
     if locsizebytes not in [4, 8]:
         raise ValueError(f"unsupported location size (in bytes) {locsizebytes}")
     if varsizebytes not in [4, 8]:
         raise ValueError(f"unsupported variable size (in bytes) {varsizebytes}")
 
-    locfmt = "d" if locsizebytes == 8 else "f"
-    varfmt = "d" if varsizebytes == 8 else "f"
+    hdr["locsizebytes"] = locsizebytes
+    hdr["varsizebytes"] = varsizebytes
+    hdr["locfmt"] = "d" if locsizebytes == 8 else "f"
+    hdr["varfmt"] = "d" if varsizebytes == 8 else "f"
 
     # load grid information from header and validate
     def get_from_header(header, blockname, keyname):
@@ -171,21 +202,49 @@ def read_binary(filename):
                 return value
         raise KeyError(f"no parameter called {blockname}/{keyname}")
 
-    Nx1 = int(get_from_header(header, "<mesh>", "nx1"))
-    Nx2 = int(get_from_header(header, "<mesh>", "nx2"))
-    Nx3 = int(get_from_header(header, "<mesh>", "nx3"))
-    nx1 = int(get_from_header(header, "<meshblock>", "nx1"))
-    nx2 = int(get_from_header(header, "<meshblock>", "nx2"))
-    nx3 = int(get_from_header(header, "<meshblock>", "nx3"))
+    for d in ["1", "2", "3"]:
+        hdr["Nx" + d] = int(get_from_header(header, "<mesh>", "nx" + d))
+        hdr["nx" + d] = int(get_from_header(header, "<meshblock>", "nx" + d))
+        hdr["x" + d + "min"] = float(get_from_header(header, "<mesh>", "x" + d + "min"))
+        hdr["x" + d + "max"] = float(get_from_header(header, "<mesh>", "x" + d + "max"))
+    hdr["nghost"] = int(get_from_header(header, "<mesh>", "nghost"))
 
-    nghost = int(get_from_header(header, "<mesh>", "nghost"))
+    return hdr
 
-    x1min = float(get_from_header(header, "<mesh>", "x1min"))
-    x1max = float(get_from_header(header, "<mesh>", "x1max"))
-    x2min = float(get_from_header(header, "<mesh>", "x2min"))
-    x2max = float(get_from_header(header, "<mesh>", "x2max"))
-    x3min = float(get_from_header(header, "<mesh>", "x3min"))
-    x3max = float(get_from_header(header, "<mesh>", "x3max"))
+
+def read_binary(filename):
+    """
+    Reads a bin file from filename to dictionary.
+
+    Originally written by Lev Arzamasskiy (leva@ias.edu) on 11/15/2021
+    Updated to support mesh refinement by George Wong (gnwong@ias.edu) on 01/27/2022
+
+    args:
+      filename - string
+          filename of bin file to read
+
+    returns:
+      filedata - dict
+          dictionary of fluid file data
+    """
+
+    filedata = {}
+
+    # load file and get size
+    fp = open(filename, "rb")
+    fp.seek(0, 2)
+    filesize = fp.tell()
+    fp.seek(0, 0)
+
+    hdr = read_binary_header(fp)
+    compressed = hdr["compressed"]
+    locsizebytes = hdr["locsizebytes"]
+    varsizebytes = hdr["varsizebytes"]
+    locfmt = hdr["locfmt"]
+    varfmt = hdr["varfmt"]
+    var_list = hdr["var_names"]
+    nvars = hdr["nvars"]
+    nghost = hdr["nghost"]
 
     # load data from each meshblock
     n_vars = len(var_list)
@@ -210,12 +269,18 @@ def read_binary(filename):
             np.array(struct.unpack("=6" + locfmt, fp.read(6 * locsizebytes)))
         )
 
-        data = np.array(
-            struct.unpack(
-                f"={nx1_out*nx2_out*nx3_out*n_vars}" + varfmt,
-                fp.read(varsizebytes * nx1_out * nx2_out * nx3_out * n_vars),
+        if compressed:
+            ncells = nx1_out * nx2_out * nx3_out
+            data = np.array(
+                [read_compressed_variable(fp, ncells) for _ in range(n_vars)]
+            )
+        else:
+            data = np.array(
+                struct.unpack(
+                    f"={nx1_out*nx2_out*nx3_out*n_vars}" + varfmt,
+                    fp.read(varsizebytes * nx1_out * nx2_out * nx3_out * n_vars),
+                )
             )
-        )
         data = data.reshape(nvars, nx3_out, nx2_out, nx1_out)
         for vari, var in enumerate(var_list):
             mb_data[var].append(data[vari])
@@ -223,27 +288,14 @@ def read_binary(filename):
 
     fp.close()
 
-    filedata["header"] = header
-    filedata["time"] = time
-    filedata["cycle"] = cycle
-    filedata["var_names"] = var_list
-
-    filedata["Nx1"] = Nx1
-    filedata["Nx2"] = Nx2
-    filedata["Nx3"] = Nx3
-    filedata["nvars"] = nvars
-
-    filedata["x1min"] = x1min
-    filedata["x1max"] = x1max
-    filedata["x2min"] = x2min
-    filedata["x2max"] = x2max
-    filedata["x3min"] = x3min
-    filedata["x3max"] = x3max
+    for key in ["header", "time", "cycle", "var_names", "Nx1", "Nx2", "Nx3", "nvars",
+                "x1min", "x1max", "x2min", "x2max", "x3min", "x3max"]:
+        filedata[key] = hdr[key]
 
     filedata["n_mbs"] = mb_count
-    filedata["nx1_mb"] = nx1
-    filedata["nx2_mb"] = nx2
-    filedata["nx3_mb"] = nx3
+    filedata["nx1_mb"] = hdr["nx1"]
+    filedata["nx2_mb"] = hdr["nx2"]
+    filedata["nx3_mb"] = hdr["nx3"]
     filedata["nx1_out_mb"] = (mb_index[0][1] - mb_index[0][0]) + 1
     filedata["nx2_out_mb"] = (mb_index[0][3] - mb_index[0][2]) + 1
     filedata["nx3_out_mb"] = (mb_index[0][5] - mb_index[0][4]) + 1
@@ -256,6 +308,160 @@ def read_binary(filename):
     return filedata
 
 
+class BinaryReader:
+    """
+    Reader of bin files for post-processing at scale, which only reads the requested
+    variables of the requested MeshBlocks, optionally split over MPI ranks.
+
+    Uncompressed files are memory-mapped as an array of fixed-size MeshBlock records
+    (as written by MeshBinaryOutput), so no data is read until it is accessed.  For
+    compressed (version 1.2) files, only the headers of the variables are read to locate
+    the data of each MeshBlock.  For example, on each rank of an mpi4py job:
+
+        reader = bin_convert.BinaryReader("path/to/file.bin")
+        filedata = reader.read(variables=["dens"], region=[0, 1, 0, 1, 0, 1],
+                               comm=MPI.COMM_WORLD)
+
+    reads the density of a share of the MeshBlocks overlapping the region.
+
+    args:
+      filename - string
+          filename of bin file to read
+    """
+
+    def __init__(self, filename):
+        self.filename = filename
+        with open(filename, "rb") as fp:
+            fp.seek(0, 2)
+            filesize = fp.tell()
+            fp.seek(0, 0)
+            self.hdr = read_binary_header(fp)
+            hdr = self.hdr
+            locdt = np.dtype("=f8") if hdr["locsizebytes"] == 8 else np.dtype("=f4")
+            self.vardt = np.dtype("=f8") if hdr["varsizebytes"] == 8 else np.dtype("=f4")
+            # output extents are the same for all MeshBlocks, so read them from the first
+            index = np.array(struct.unpack("@6i", fp.read(24))) - hdr["nghost"]
+            self.nout = (index[5] - index[4] + 1, index[3] - index[2] + 1,
+                         index[1] - index[0] + 1)
+            ncells = int(np.prod(self.nout))
+            nvars = hdr["nvars"]
+            self.mbdt = np.dtype([("index", "=i4", (6,)), ("logical", "=i4", (4,)),
+                                  ("geometry", locdt, (6,))])
+
+            if not hdr["compressed"]:
+                rec = np.dtype(self.mbdt.descr +
+                               [("data", self.vardt, (nvars,) + self.nout)])
+                nbytes = filesize - hdr["data_offset"]
+                if nbytes % rec.itemsize != 0:
+                    raise ValueError(f"size of {filename} is not a whole number of "
+                                     + "MeshBlocks")
+                self.records = np.memmap(filename, dtype=rec, mode="r",
+                                         offset=hdr["data_offset"],
+                                         shape=(nbytes // rec.itemsize,))
+                self.info = self.records[["index", "logical", "geometry"]]
+            else:
+                # locate the (variable length) data of each variable of each MeshBlock
+                info, offsets = [], []
+                pos = hdr["data_offset"]
+                while pos < filesize:
+                    fp.seek(pos)
+                    info.append(np.frombuffer(fp.read(self.mbdt.itemsize),
+                                              dtype=self.mbdt)[0])
+                    pos += self.mbdt.itemsize
+                    var_offsets = []
+                    for _ in range(nvars):
+                        var_offsets.append(pos)
+                        fp.seek(pos + 8)
+                        nbits = struct.unpack("=i", fp.read(4))[0]
+                        if nbits < 0:
+                            pos += 12 + 4 * ncells
+                        else:
+                            pos += 12 + (ncells * nbits + 7) // 8
+                    offsets.append(var_offsets)
+                self.info = np.array(info, dtype=self.mbdt)
+                self.offsets = np.array(offsets, dtype=np.int64)
+        self.n_mbs = len(self.info)
+
+    def meshblocks(self, region=None):
+        """
+        Returns the ids of the MeshBlocks overlapping region = [x1min, x1max, x2min,
+        x2max, x3min, x3max] (all MeshBlocks if region is None).
+        """
+        ids = np.arange(self.n_mbs)
+        if region is None:
+            return ids
+        geom = np.asarray(self.info["geometry"], dtype=np.float64)
+        overlap = np.ones(self.n_mbs, dtype=bool)
+        for d in range(3):
+            n = self.nout[2 - d]
+            lo = geom[:, d] - 0.5 * geom[:, 3 + d]
+            hi = lo + n * geom[:, 3 + d]
+            overlap &= (hi >= region[2 * d]) & (lo <= region[2 * d + 1])
+        return ids[overlap]
+
+    def read(self, variables=None, meshblocks=None, region=None, comm=None):
+        """
+        Reads the data of the requested MeshBlocks.
+
+        args:
+          variables - list of strings
+              names of the variables to read (default: all)
+          meshblocks - array of ints
+              ids of the MeshBlocks to read (default: those overlapping region)
+          region - list of floats
+              [x1min, x1max, x2min, x2max, x3min, x3max] of the region of interest
+          comm - mpi4py communicator
+              if given, the MeshBlocks are split into contiguous shares, and each rank
+              only reads its own share
+
+        returns:
+          filedata - dict
+              same as returned by read_binary(), restricted to the MeshBlocks and
+              variables read, plus 'mb_ids', the ids of the MeshBlocks read
+        """
+        hdr = self.hdr
+        if variables is None:
+            variables = hdr["var_names"]
+        ivars = [hdr["var_names"].index(v) for v in variables]
+        ids = self.meshblocks(region) if meshblocks is None else np.asarray(meshblocks)
+        if comm is not None:
+            ids = np.array_split(ids, comm.Get_size())[comm.Get_rank()]
+
+        mb_data = {}
+        if not hdr["compressed"]:
+            for v, iv in zip(variables, ivars):
+                mb_data[v] = np.asarray(self.records["data"][ids, iv], dtype=np.float64)
+        else:
+            ncells = int(np.prod(self.nout))
+            with open(self.filename, "rb") as fp:
+                for v, iv in zip(variables, ivars):
+                    data = np.empty((len(ids),) + self.nout)
+                    for n, m in enumerate(ids):
+                        fp.seek(self.offsets[m, iv])
+                        data[n] = read_compressed_variable(fp, ncells).reshape(self.nout)
+                    mb_data[v] = data
+
+        filedata = {}
+        for key in ["header", "time", "cycle", "Nx1", "Nx2", "Nx3", "x1min", "x1max",
+                    "x2min", "x2max", "x3min", "x3max"]:
+            filedata[key] = hdr[key]
+        filedata["var_names"] = list(variables)
+        filedata["nvars"] = len(variables)
+        filedata["n_mbs"] = len(ids)
+        filedata["mb_ids"] = ids
+        for d in ["1", "2", "3"]:
+            filedata["nx" + d + "_mb"] = hdr["nx" + d]
+        filedata["nx1_out_mb"] = self.nout[2]
+        filedata["nx2_out_mb"] = self.nout[1]
+        filedata["nx3_out_mb"] = self.nout[0]
+        info = self.info[ids]
+        filedata["mb_index"] = np.array(info["index"]) - hdr["nghost"]
+        filedata["mb_logical"] = np.array(info["logical"])
+        filedata["mb_geometry"] = np.array(info["geometry"], dtype=np.float64)
+        filedata["mb_data"] = mb_data
+        return filedata
+
+
 def read_coarsened_binary(filename):
     """
     Reads a bin file from filename to dictionary.
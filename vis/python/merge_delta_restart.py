@@ -0,0 +1,68 @@
+#! /usr/bin/env python
+
+# Script for rebuilding a full AthenaK restart file (.rst) from the full restart file a
+# delta restart file (.drst) is based on, and the delta file itself.
+
+# Run "merge_delta_restart.py -h" for help.
+
+# Delta files hold the header of a full restart file, then one byte per MeshBlock (1 if
+# the record of the MeshBlock follows), the records of those MeshBlocks in order, and a
+# trailer of four uint64 (header size, number of MeshBlocks, record size, file number of
+# the base restart file) followed by the string 'ATHDELTA'.
+
+# Python modules
+import argparse
+import os
+import struct
+
+TRAILER_SIZE = 4*8 + 8
+
+
+# Main function
+def main(**kwargs):
+
+    base_file = kwargs['base']
+    delta_file = kwargs['delta']
+    output_file = kwargs['output']
+
+    with open(delta_file, 'rb') as delta:
+        delta.seek(-TRAILER_SIZE, os.SEEK_END)
+        trailer = delta.read(TRAILER_SIZE)
+        if trailer[-8:] != b'ATHDELTA':
+            raise RuntimeError(delta_file + ' is not a delta restart file')
+        header_size, nmb, rec_size, base_number = struct.unpack('<4Q', trailer[:32])
+
+        base_size = os.path.getsize(base_file)
+        base_header_size = base_size - nmb*rec_size
+        if base_header_size <= 0:
+            raise RuntimeError(base_file + ' does not match ' + delta_file)
+        print('rebuilding from base restart file number {0}'.format(base_number))
+
+        with open(base_file, 'rb') as base, open(output_file, 'wb') as out:
+            # header (time, cycle, input parameters, ...) of the delta file
+            delta.seek(0)
+            out.write(delta.read(header_size))
+            flags = delta.read(nmb)
+            nchanged = 0
+            for m in range(nmb):
+                if flags[m]:
+                    out.write(delta.read(rec_size))
+                    nchanged += 1
+                else:
+                    base.seek(base_header_size + m*rec_size)
+                    out.write(base.read(rec_size))
+    print('{0} of {1} MeshBlocks taken from delta file'.format(nchanged, nmb))
+
+
+# Execute main function
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-b', '--base',
+                        help='name of full restart (rst) file the delta file is based on')
+    parser.add_argument('-d', '--delta',
+                        help='name of delta restart (drst) file')
+    parser.add_argument('-o', '--output',
+                        help='name of rebuilt restart (rst) file')
+
+    args = parser.parse_args()
+    main(**vars(args))